@@ -10,6 +10,7 @@
 #include "SkCanvas.h"
 #include "SkPath.h"
 #include "SkRandom.h"
+#include "SkRRect.h"
 #include "SkRegion.h"
 #include "SkString.h"
 
@@ -244,6 +245,38 @@ private:
 
 ////////////////////////////////////////////////////////////////////////////////
 
+////////////////////////////////////////////////////////////////////////////////
+// Clips to the same rounded corners on every save, the way a UI draws a card each frame.
+// The mask built for the clip can be shared through SkResourceCache.
+class RRectClipBench : public Benchmark {
+    SkRRect fClipRRect;
+    SkRect  fDrawRect;
+
+public:
+    RRectClipBench() {
+        fClipRRect.setRectXY(SkRect::MakeLTRB(10.5f, 10.5f, 190.5f, 120.5f), 12, 12);
+        fDrawRect.set(0, 0, 200, 200);
+    }
+
+protected:
+    const char* onGetName() override { return "aaclip_rrect_repeated"; }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        this->setupPaint(&paint);
+
+        for (int i = 0; i < loops; ++i) {
+            canvas->save();
+            canvas->clipRRect(fClipRRect, SkRegion::kIntersect_Op, true);
+            canvas->drawRect(fDrawRect, paint);
+            canvas->restore();
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
 DEF_BENCH(return new AAClipBuilderBench(false, false);)
 DEF_BENCH(return new AAClipBuilderBench(false, true);)
 DEF_BENCH(return new AAClipBuilderBench(true, false);)
@@ -255,3 +288,4 @@ DEF_BENCH(return new AAClipBench(true, false);)
 DEF_BENCH(return new AAClipBench(true, true);)
 DEF_BENCH(return new NestedAAClipBench(false);)
 DEF_BENCH(return new NestedAAClipBench(true);)
+DEF_BENCH(return new RRectClipBench();)
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkCanvas.h"
+#include "SkPath.h"
+#include "SkRandom.h"
+#include "SkScan.h"
+#include "SkString.h"
+#include "SkTArray.h"
+
+// Fills complex anti-aliased paths, supersampled or with analytic coverage (gSkUseAnalyticAA).
+class AnalyticAABench : public Benchmark {
+public:
+    enum Shape { kPolygon, kCurves };
+
+    AnalyticAABench(Shape shape, bool analytic) : fShape(shape), fAnalytic(analytic) {
+        fName.printf("aa_fill_%s_%s", shape == kPolygon ? "polygon" : "curves",
+                                      analytic ? "analytic" : "supersampled");
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kRaster_Backend; }
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        // Something like a map tile: many shapes with lots of edges, at arbitrary subpixel
+        // positions, some of them overlapping.
+        SkRandom rand;
+        for (int i = 0; i < 16; i++) {
+            const SkScalar cx = rand.nextRangeScalar(0, 640),
+                           cy = rand.nextRangeScalar(0, 480);
+            SkPath path;
+            path.moveTo(cx + rand.nextRangeScalar(-60, 60), cy + rand.nextRangeScalar(-60, 60));
+            for (int j = 0; j < 20; j++) {
+                SkPoint p = { cx + rand.nextRangeScalar(-60, 60),
+                              cy + rand.nextRangeScalar(-60, 60) };
+                if (fShape == kPolygon) {
+                    path.lineTo(p);
+                } else {
+                    path.quadTo(cx + rand.nextRangeScalar(-60, 60),
+                                cy + rand.nextRangeScalar(-60, 60), p.fX, p.fY);
+                }
+            }
+            path.close();
+            fPaths.push_back(path);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        const bool prev = gSkUseAnalyticAA;
+        gSkUseAnalyticAA = fAnalytic;
+
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        paint.setColor(0x80336699);
+        while (loops --> 0) {
+            for (const SkPath& path : fPaths) {
+                canvas->drawPath(path, paint);
+            }
+        }
+        gSkUseAnalyticAA = prev;
+    }
+
+private:
+    Shape             fShape;
+    bool              fAnalytic;
+    SkString          fName;
+    SkTArray<SkPath>  fPaths;
+};
+
+DEF_BENCH(return new AnalyticAABench(AnalyticAABench::kPolygon, false);)
+DEF_BENCH(return new AnalyticAABench(AnalyticAABench::kPolygon, true);)
+DEF_BENCH(return new AnalyticAABench(AnalyticAABench::kCurves,  false);)
+DEF_BENCH(return new AnalyticAABench(AnalyticAABench::kCurves,  true);)
@@ -8,6 +8,7 @@
 #include "Benchmark.h"
 #include "SkCanvas.h"
 #include "SkPath.h"
+#include "SkRandom.h"
 #include "sk_tool_utils.h"
 
 enum Align {
@@ -84,3 +85,62 @@ DEF_BENCH( return new BigPathBench(kRight_Align,    false); )
 DEF_BENCH( return new BigPathBench(kLeft_Align,     true); )
 DEF_BENCH( return new BigPathBench(kMiddle_Align,   true); )
 DEF_BENCH( return new BigPathBench(kRight_Align,    true); )
+
+// A contour map: many closed, wobbly rings filled as one path, so the scan converter has tens of
+// thousands of edges to sort.
+class ContourMapBench : public Benchmark {
+    SkPath   fPath;
+    SkString fName;
+    bool     fAA;
+
+public:
+    ContourMapBench(bool aa) : fAA(aa) {
+        fName.printf("bigpath_contourmap%s", aa ? "_aa" : "");
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    SkIPoint onGetSize() override {
+        return SkIPoint::Make(640, 640);
+    }
+
+    void onDelayedSetup() override {
+        const int kRings = 60,
+                  kSteps = 600;
+        SkRandom rand;
+        for (int ring = 1; ring <= kRings; ring++) {
+            const SkScalar radius = ring * 5.0f;
+            for (int step = 0; step < kSteps; step++) {
+                SkScalar theta = step * 2 * SK_ScalarPI / kSteps,
+                         r     = radius + rand.nextRangeScalar(-2, 2);
+                SkPoint p = SkPoint::Make(320 + r * SkScalarCos(theta),
+                                          320 + r * SkScalarSin(theta));
+                if (0 == step) {
+                    fPath.moveTo(p);
+                } else {
+                    fPath.lineTo(p);
+                }
+            }
+            fPath.close();
+        }
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        this->setupPaint(&paint);
+        paint.setAntiAlias(fAA);
+
+        for (int i = 0; i < loops; i++) {
+            canvas->drawPath(fPath, paint);
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new ContourMapBench(false); )
+DEF_BENCH( return new ContourMapBench(true); )
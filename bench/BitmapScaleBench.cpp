@@ -119,9 +119,13 @@ class PixmapScalerBench: public Benchmark {
     SkBitmapScaler::ResizeMethod    fMethod;
     SkString                        fName;
     SkBitmap                        fSrc, fDst;
+    SkISize                         fSrcSize, fDstSize;
 
 public:
-    PixmapScalerBench(SkBitmapScaler::ResizeMethod method, const char suffix[]) : fMethod(method) {
+    PixmapScalerBench(SkBitmapScaler::ResizeMethod method, const char suffix[],
+                      SkISize srcSize = SkISize::Make(640, 480),
+                      SkISize dstSize = SkISize::Make(300, 250))
+        : fMethod(method), fSrcSize(srcSize), fDstSize(dstSize) {
         fName.printf("pixmapscaler_%s", suffix);
     }
 
@@ -137,9 +141,9 @@ protected:
     }
 
     void onDelayedSetup() override {
-        fSrc.allocN32Pixels(640, 480);
+        fSrc.allocN32Pixels(fSrcSize.width(), fSrcSize.height());
         fSrc.eraseColor(SK_ColorWHITE);
-        fDst.allocN32Pixels(300, 250);
+        fDst.allocN32Pixels(fDstSize.width(), fDstSize.height());
     }
 
     void onDraw(int loops, SkCanvas*) override {
@@ -159,3 +163,6 @@ DEF_BENCH( return new PixmapScalerBench(SkBitmapScaler::RESIZE_MITCHELL, "mitche
 DEF_BENCH( return new PixmapScalerBench(SkBitmapScaler::RESIZE_HAMMING,  "hamming");  )
 DEF_BENCH( return new PixmapScalerBench(SkBitmapScaler::RESIZE_TRIANGLE, "triangle"); )
 DEF_BENCH( return new PixmapScalerBench(SkBitmapScaler::RESIZE_BOX,      "box");      )
+// Big enough to be convolved in parallel bands.
+DEF_BENCH( return new PixmapScalerBench(SkBitmapScaler::RESIZE_LANCZOS3, "lanczos_big",
+                                        SkISize::Make(2400, 1800), SkISize::Make(1200, 900)); )
@@ -0,0 +1,144 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkBlitRow.h"
+#include "SkColorPriv.h"
+#include "SkOpts.h"
+#include "SkRandom.h"
+#include "SkString.h"
+
+// Benchmarks SkOpts::blit_row_s32a_opaque() on rows of opaque, transparent, or mixed sources.
+class BlitRowS32AOpaqueBench : public Benchmark {
+public:
+    enum Source { kOpaque, kTransparent, kMixed };
+
+    BlitRowS32AOpaqueBench(Source source) : fSource(source) {
+        static const char* kNames[] = { "opaque", "transparent", "mixed" };
+        fName.printf("SkOpts::blit_row_s32a_opaque_%s", kNames[source]);
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkRandom rand;
+        for (int i = 0; i < K; i++) {
+            switch (fSource) {
+                case kOpaque:      fSrc[i] = rand.nextU() | 0xFF000000;            break;
+                case kTransparent: fSrc[i] = 0;                                    break;
+                case kMixed:       fSrc[i] = SkPreMultiplyColor(rand.nextU());     break;
+            }
+            fDst[i] = SkPreMultiplyColor(rand.nextU());
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops --> 0) {
+            SkOpts::blit_row_s32a_opaque(fDst, fSrc, K, 0xFF);
+        }
+    }
+
+private:
+    static const int K = 1023; // Arbitrary, but nice to be a non-power-of-two to trip up SIMD.
+
+    Source    fSource;
+    SkString  fName;
+    SkPMColor fSrc[K], fDst[K];
+};
+
+// Benchmarks SkOpts::blit_mask_d32_a8(), which draws a colored A8 mask (e.g. a glyph) into 8888.
+class BlitMaskD32A8Bench : public Benchmark {
+public:
+    BlitMaskD32A8Bench(SkColor color) : fColor(color) {
+        fName.printf("SkOpts::blit_mask_d32_a8_%s", SkColorGetA(color) == 0xFF ? "opaque"
+                                                                                : "translucent");
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkRandom rand;
+        for (int i = 0; i < W*H; i++) {
+            fMask[i] = rand.nextU() & 0xFF;
+            fDst[i]  = SkPreMultiplyColor(rand.nextU());
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops --> 0) {
+            SkOpts::blit_mask_d32_a8(fDst, W*sizeof(SkPMColor), fMask, W, fColor, W, H);
+        }
+    }
+
+private:
+    static const int W = 127, H = 32;
+
+    SkColor   fColor;
+    SkString  fName;
+    uint8_t   fMask[W*H];
+    SkPMColor fDst[W*H];
+};
+
+// Benchmarks the SkBlitRow::Factory16() proc for flags, which blits a row of 8888 into 565.
+class BlitRowD565Bench : public Benchmark {
+public:
+    BlitRowD565Bench(unsigned flags) : fFlags(flags) {
+        fName.printf("SkBlitRow::S32%s_D565_%s%s",
+                     flags & SkBlitRow::kSrcPixelAlpha_Flag ? "A" : "",
+                     flags & SkBlitRow::kGlobalAlpha_Flag   ? "Blend" : "Opaque",
+                     flags & SkBlitRow::kDither_Flag        ? "_Dither" : "");
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fProc = SkBlitRow::Factory16(fFlags);
+        SkRandom rand;
+        for (int i = 0; i < K; i++) {
+            fSrc[i] = fFlags & SkBlitRow::kSrcPixelAlpha_Flag
+                    ? SkPreMultiplyColor(rand.nextU())
+                    : rand.nextU() | 0xFF000000;
+            fDst[i] = rand.nextU() & 0xFFFF;
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const U8CPU alpha = fFlags & SkBlitRow::kGlobalAlpha_Flag ? 0x80 : 0xFF;
+        while (loops --> 0) {
+            fProc(fDst, fSrc, K, alpha, 0, 0);
+        }
+    }
+
+private:
+    static const int K = 1023;
+
+    unsigned          fFlags;
+    SkBlitRow::Proc16 fProc;
+    SkString          fName;
+    SkPMColor         fSrc[K];
+    uint16_t          fDst[K];
+};
+
+DEF_BENCH(return new BlitRowS32AOpaqueBench(BlitRowS32AOpaqueBench::kOpaque));
+DEF_BENCH(return new BlitRowS32AOpaqueBench(BlitRowS32AOpaqueBench::kTransparent));
+DEF_BENCH(return new BlitRowS32AOpaqueBench(BlitRowS32AOpaqueBench::kMixed));
+
+DEF_BENCH(return new BlitMaskD32A8Bench(0xFF336699));
+DEF_BENCH(return new BlitMaskD32A8Bench(0x80336699));
+
+DEF_BENCH(return new BlitRowD565Bench(0));
+DEF_BENCH(return new BlitRowD565Bench(SkBlitRow::kGlobalAlpha_Flag));
+DEF_BENCH(return new BlitRowD565Bench(SkBlitRow::kSrcPixelAlpha_Flag));
+DEF_BENCH(return new BlitRowD565Bench(SkBlitRow::kSrcPixelAlpha_Flag | SkBlitRow::kGlobalAlpha_Flag));
+DEF_BENCH(return new BlitRowD565Bench(SkBlitRow::kDither_Flag));
+DEF_BENCH(return new BlitRowD565Bench(SkBlitRow::kDither_Flag | SkBlitRow::kGlobalAlpha_Flag));
+DEF_BENCH(return new BlitRowD565Bench(SkBlitRow::kDither_Flag | SkBlitRow::kSrcPixelAlpha_Flag));
+DEF_BENCH(return new BlitRowD565Bench(SkBlitRow::kDither_Flag | SkBlitRow::kSrcPixelAlpha_Flag |
+                                      SkBlitRow::kGlobalAlpha_Flag));
@@ -18,6 +18,7 @@
 #define REAL    1.5f
 #define BIG     SkIntToScalar(10)
 #define REALBIG 100.5f
+#define GIANT   SkIntToScalar(200)
 
 static const char* gStyleName[] = {
     "normal",
@@ -112,4 +113,7 @@ DEF_BENCH(return new BlurBench(REALBIG, kNormal_SkBlurStyle, SkBlurMaskFilter::k
 
 DEF_BENCH(return new BlurBench(REAL, kNormal_SkBlurStyle, SkBlurMaskFilter::kHighQuality_BlurFlag);)
 
+DEF_BENCH(return new BlurBench(GIANT, kNormal_SkBlurStyle);)
+DEF_BENCH(return new BlurBench(GIANT, kNormal_SkBlurStyle, SkBlurMaskFilter::kHighQuality_BlurFlag);)
+
 DEF_BENCH(return new BlurBench(0, kNormal_SkBlurStyle);)
@@ -8,12 +8,14 @@
 #include "SkCanvas.h"
 #include "SkChecksum.h"
 #include "SkMD5.h"
+#include "SkOpts.h"
 #include "SkRandom.h"
 #include "SkTemplates.h"
 
 enum ChecksumType {
     kMD5_ChecksumType,
     kMurmur3_ChecksumType,
+    kHash_ChecksumType,
 };
 
 class ComputeChecksumBench : public Benchmark {
@@ -41,6 +43,7 @@ protected:
         switch (fType) {
             case kMD5_ChecksumType: return "compute_md5";
             case kMurmur3_ChecksumType: return "compute_murmur3";
+            case kHash_ChecksumType: return "compute_hash";
 
             default: SK_ABORT("Invalid Type"); return "";
         }
@@ -62,6 +65,12 @@ protected:
                     sk_ignore_unused_variable(result);
                 }
             }break;
+            case kHash_ChecksumType: {
+                for (int i = 0; i < loops; i++) {
+                    volatile uint32_t result = SkOpts::hash(fData, sizeof(fData));
+                    sk_ignore_unused_variable(result);
+                }
+            }break;
         }
 
     }
@@ -74,3 +83,4 @@ private:
 
 DEF_BENCH( return new ComputeChecksumBench(kMD5_ChecksumType); )
 DEF_BENCH( return new ComputeChecksumBench(kMurmur3_ChecksumType); )
+DEF_BENCH( return new ComputeChecksumBench(kHash_ChecksumType); )
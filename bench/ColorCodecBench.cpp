@@ -16,6 +16,11 @@ DEFINE_bool(qcms,       false, "Bench qcms color conversion");
 #endif
 DEFINE_bool(xform_only, false, "Only time the color xform, do not include the decode time");
 DEFINE_bool(srgb,       false, "Convert to srgb dst space");
+DEFINE_bool(fused,      false, "Let the codec convert each row as it swizzles it");
+DEFINE_bool(two_pass,   false, "Decode the whole image, then convert the whole image");
+DEFINE_bool(pipeline,   false, "Convert with SkColorSpaceXform::apply() instead of xform_RGB1_8888()");
+DEFINE_bool(f16,        false, "With --pipeline, convert to linear F16");
+DEFINE_bool(premul,     false, "With --pipeline, premultiply the dst");
 
 ColorCodecBench::ColorCodecBench(const char* name, sk_sp<SkData> encoded)
     : fEncoded(std::move(encoded))
@@ -24,6 +29,10 @@ ColorCodecBench::ColorCodecBench(const char* name, sk_sp<SkData> encoded)
 #endif
 {
     fName.appendf("Color%s", FLAGS_xform_only ? "Xform" : "Codec");
+    fName.appendf("%s", FLAGS_fused ? "Fused" : FLAGS_two_pass ? "TwoPass" : "");
+    if (FLAGS_pipeline) {
+        fName.appendf("Pipeline%s%s", FLAGS_f16 ? "F16" : "", FLAGS_premul ? "Premul" : "");
+    }
 #if defined(SK_TEST_QCMS)
     fName.appendf("%s", FLAGS_qcms ? "QCMS" : "");
 #endif
@@ -38,6 +47,22 @@ bool ColorCodecBench::isSuitableFor(Backend backend) {
     return kNonRendering_Backend == backend;
 }
 
+void ColorCodecBench::xformRow(const SkColorSpaceXform* xform, void* dst, const void* src) {
+    if (FLAGS_pipeline) {
+        SkColorSpaceXform::ColorFormat format = FLAGS_f16
+                ? SkColorSpaceXform::kRGBA_F16_ColorFormat
+                : SkColorSpaceXform::kRGBA_8888_ColorFormat;
+        SkAlphaType alphaType = FLAGS_premul ? kPremul_SkAlphaType : kUnpremul_SkAlphaType;
+#ifdef SK_DEBUG
+        const bool applied =
+#endif
+        xform->apply(dst, (const uint32_t*) src, fInfo.width(), format, alphaType);
+        SkASSERT(applied);
+    } else {
+        xform->xform_RGB1_8888((uint32_t*) dst, (const uint32_t*) src, fInfo.width());
+    }
+}
+
 void ColorCodecBench::decodeAndXform() {
     SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(fEncoded.get()));
 #ifdef SK_DEBUG
@@ -61,7 +86,40 @@ void ColorCodecBench::decodeAndXform() {
         codec->getScanlines(fSrc.get(), 1, 0);
         SkASSERT(1 == rows);
 
-        xform->xform_RGB1_8888((uint32_t*) dst, (uint32_t*) fSrc.get(), fInfo.width());
+        this->xformRow(xform.get(), dst, fSrc.get());
+        dst = SkTAddOffset<void>(dst, fDstRowBytes);
+    }
+}
+
+void ColorCodecBench::decodeFused() {
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(fEncoded.get()));
+    const SkImageInfo info = fInfo.makeColorType(kN32_SkColorType).makeColorSpace(fDstSpace);
+#ifdef SK_DEBUG
+    const SkCodec::Result result =
+#endif
+    codec->getPixels(info, fDst.get(), info.minRowBytes());
+    SkASSERT(SkCodec::kSuccess == result);
+}
+
+void ColorCodecBench::decodeThenXform() {
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(fEncoded.get()));
+#ifdef SK_DEBUG
+    const SkCodec::Result result =
+#endif
+    codec->getPixels(fInfo, fDst.get(), fInfo.minRowBytes());
+    SkASSERT(SkCodec::kSuccess == result);
+
+    sk_sp<SkColorSpace> srcSpace = sk_ref_sp(codec->getColorSpace());
+    if (!srcSpace) {
+        srcSpace = SkColorSpace::NewNamed(SkColorSpace::kSRGB_Named);
+    }
+    std::unique_ptr<SkColorSpaceXform> xform = SkColorSpaceXform::New(srcSpace, fDstSpace);
+    SkASSERT(xform);
+
+    void* dst = fDst.get();
+    for (int y = 0; y < fInfo.height(); y++) {
+        // Transform in place, after the whole image has left the cache.
+        xform->xform_RGB1_8888((uint32_t*) dst, (uint32_t*) dst, fInfo.width());
         dst = SkTAddOffset<void>(dst, fInfo.minRowBytes());
     }
 }
@@ -116,8 +174,8 @@ void ColorCodecBench::xformOnly() {
     void* src = fSrc.get();
     for (int y = 0; y < fInfo.height(); y++) {
         // Transform in place
-        xform->xform_RGB1_8888((uint32_t*) dst, (uint32_t*) src, fInfo.width());
-        dst = SkTAddOffset<void>(dst, fInfo.minRowBytes());
+        this->xformRow(xform.get(), dst, src);
+        dst = SkTAddOffset<void>(dst, fDstRowBytes);
         src = SkTAddOffset<void>(src, fInfo.minRowBytes());
     }
 }
@@ -154,7 +212,10 @@ void ColorCodecBench::onDelayedSetup() {
     SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(fEncoded.get()));
     fInfo = codec->getInfo().makeColorType(kRGBA_8888_SkColorType);
 
-    fDst.reset(fInfo.getSafeSize(fInfo.minRowBytes()));
+    // F16 dsts need 8 bytes per pixel.
+    fDstRowBytes = (FLAGS_pipeline && FLAGS_f16) ? fInfo.width() * sizeof(uint64_t)
+                                                 : fInfo.minRowBytes();
+    fDst.reset(fInfo.getSafeSize(fDstRowBytes));
     if (FLAGS_xform_only) {
         fSrc.reset(fInfo.getSafeSize(fInfo.minRowBytes()));
         codec->getPixels(fInfo, fSrc.get(), fInfo.minRowBytes());
@@ -202,6 +263,10 @@ void ColorCodecBench::onDraw(int n, SkCanvas*) {
         {
             if (FLAGS_xform_only) {
                 this->xformOnly();
+            } else if (FLAGS_fused) {
+                this->decodeFused();
+            } else if (FLAGS_two_pass) {
+                this->decodeThenXform();
             } else {
                 this->decodeAndXform();
             }
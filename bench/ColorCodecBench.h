@@ -16,6 +16,8 @@
 #include "qcms.h"
 #endif
 
+class SkColorSpaceXform;
+
 class ColorCodecBench : public Benchmark {
 public:
     ColorCodecBench(const char* name, sk_sp<SkData> encoded);
@@ -27,7 +29,10 @@ protected:
     void onDelayedSetup() override;
 
 private:
+    void xformRow(const SkColorSpaceXform*, void* dst, const void* src);
     void decodeAndXform();
+    void decodeFused();
+    void decodeThenXform();
     void xformOnly();
 #if !defined(GOOGLE3)
     void decodeAndXformQCMS();
@@ -37,6 +42,7 @@ private:
     SkString                                             fName;
     sk_sp<SkData>                                        fEncoded;
     SkImageInfo                                          fInfo;
+    size_t                                               fDstRowBytes;
     SkAutoMalloc                                         fDst;
     SkAutoMalloc                                         fSrc;
     sk_sp<SkColorSpace>                                  fDstSpace;
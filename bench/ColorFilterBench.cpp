@@ -9,6 +9,7 @@
 #include "SkCanvas.h"
 #include "SkColorFilterImageFilter.h"
 #include "SkColorMatrixFilter.h"
+#include "SkSurface.h"
 
 #define FILTER_WIDTH_SMALL  SkIntToScalar(32)
 #define FILTER_HEIGHT_SMALL SkIntToScalar(32)
@@ -25,15 +26,18 @@ static sk_sp<SkImageFilter> make_brightness(float amount, sk_sp<SkImageFilter> i
     return SkColorFilterImageFilter::Make(std::move(filter), std::move(input));
 }
 
-static sk_sp<SkImageFilter> make_grayscale(sk_sp<SkImageFilter> input) {
+static sk_sp<SkColorFilter> make_gray_filter() {
     SkScalar matrix[20];
     memset(matrix, 0, 20 * sizeof(SkScalar));
     matrix[0] = matrix[5] = matrix[10] = 0.2126f;
     matrix[1] = matrix[6] = matrix[11] = 0.7152f;
     matrix[2] = matrix[7] = matrix[12] = 0.0722f;
     matrix[18] = 1.0f;
-    sk_sp<SkColorFilter> filter(SkColorFilter::MakeMatrixFilterRowMajor255(matrix));
-    return SkColorFilterImageFilter::Make(std::move(filter), std::move(input));
+    return SkColorFilter::MakeMatrixFilterRowMajor255(matrix);
+}
+
+static sk_sp<SkImageFilter> make_grayscale(sk_sp<SkImageFilter> input) {
+    return SkColorFilterImageFilter::Make(make_gray_filter(), std::move(input));
 }
 
 static sk_sp<SkImageFilter> make_mode_blue(sk_sp<SkImageFilter> input) {
@@ -261,6 +265,50 @@ private:
     typedef ColorFilterBaseBench INHERITED;
 };
 
+// Draws a translucent sRGB sprite with a color filter on its paint over an sRGB destination.  This
+// runs the filter in the same SkRasterPipeline pass as the load, blend and store, as fused stages
+// for filters that have them (gray, a matrix filter) and through filterSpan4f() for those that
+// don't (blue, a mode filter).
+class ColorFilterSpriteBench : public Benchmark {
+public:
+    ColorFilterSpriteBench(const char* name, sk_sp<SkColorFilter> filter)
+        : fFilter(std::move(filter)) {
+        fName.printf("colorfilter_%s_sprite_srgb", name);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        const SkImageInfo info = SkImageInfo::MakeS32(256, 256, kPremul_SkAlphaType);
+        auto src = SkSurface::MakeRaster(info);
+        SkPaint paint;
+        paint.setColor(0x80FF8040);
+        src->getCanvas()->clear(0x40204080);
+        src->getCanvas()->drawCircle(128, 128, 100, paint);
+        fImage = src->makeImageSnapshot();
+        fDst = SkSurface::MakeRaster(info);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkPaint paint;
+        paint.setColorFilter(fFilter);
+        for (int i = 0; i < loops; i++) {
+            fDst->getCanvas()->drawImage(fImage.get(), 0, 0, &paint);
+        }
+    }
+
+private:
+    SkString             fName;
+    sk_sp<SkColorFilter> fFilter;
+    sk_sp<SkImage>       fImage;
+    sk_sp<SkSurface>     fDst;
+
+    typedef Benchmark INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new ColorFilterDimBrightBench(true); )
@@ -280,3 +328,7 @@ DEF_BENCH( return new ColorFilterBrightBlueBench(false); )
 DEF_BENCH( return new ColorFilterBrightBench(false); )
 DEF_BENCH( return new ColorFilterBlueBench(false); )
 DEF_BENCH( return new ColorFilterGrayBench(false); )
+
+DEF_BENCH( return new ColorFilterSpriteBench("gray", make_gray_filter()); )
+DEF_BENCH( return new ColorFilterSpriteBench("blue",
+                   SkColorFilter::MakeModeFilter(SK_ColorBLUE, SkXfermode::kSrcIn_Mode)); )
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkCanvas.h"
+#include "SkDistanceFieldGen.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkString.h"
+#include "SkTemplates.h"
+
+// Generates the distance field for a glyph-like mask: a dense cluster of strokes, like the
+// CJK glyphs that dominate first-use distance field text costs, at the size they're cached.
+class DistanceFieldBench : public Benchmark {
+public:
+    DistanceFieldBench(int size, bool bw)
+        : fSize(size)
+        , fBW(bw)
+        , fName(SkStringPrintf("distance_field_%s_%d", bw ? "bw" : "a8", size)) {}
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkBitmap bitmap;
+        bitmap.allocPixels(SkImageInfo::MakeA8(fSize, fSize));
+        bitmap.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas canvas(bitmap);
+        canvas.scale(fSize / 16.0f, fSize / 16.0f);
+
+        SkPaint paint;
+        paint.setAntiAlias(!fBW);
+        paint.setStyle(SkPaint::kStroke_Style);
+        paint.setStrokeWidth(1.25f);
+        for (int i = 0; i < 5; i++) {
+            canvas.drawLine(2, 2.5f + 2.75f*i, 14, 2 + 2.75f*i, paint);
+        }
+        canvas.drawLine(8, 1, 8, 15, paint);
+        SkPath path;
+        path.moveTo(2, 14);
+        path.quadTo(6, 10, 7, 4);
+        path.moveTo(14, 14);
+        path.quadTo(10, 11, 9, 5);
+        canvas.drawPath(path, paint);
+        canvas.drawOval(SkRect::MakeLTRB(4.5f, 6.5f, 11.5f, 11.5f), paint);
+
+        if (fBW) {
+            fRowBytes = (fSize + 7) / 8;
+            fImage.reset(fRowBytes * fSize);
+            sk_bzero(fImage.get(), fRowBytes * fSize);
+            for (int y = 0; y < fSize; y++) {
+                for (int x = 0; x < fSize; x++) {
+                    if (*bitmap.getAddr8(x, y) >= 0x80) {
+                        fImage[y * fRowBytes + x / 8] |= 0x80 >> (x & 7);
+                    }
+                }
+            }
+        } else {
+            fRowBytes = fSize;
+            fImage.reset(fRowBytes * fSize);
+            for (int y = 0; y < fSize; y++) {
+                memcpy(&fImage[y * fRowBytes], bitmap.getAddr8(0, y), fSize);
+            }
+        }
+        fDistanceField.reset(SkComputeDistanceFieldSize(fSize, fSize));
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            if (fBW) {
+                SkGenerateDistanceFieldFromBWImage(fDistanceField.get(), fImage.get(),
+                                                   fSize, fSize, fRowBytes);
+            } else {
+                SkGenerateDistanceFieldFromA8Image(fDistanceField.get(), fImage.get(),
+                                                   fSize, fSize, fRowBytes);
+            }
+        }
+    }
+
+private:
+    int                            fSize;
+    bool                           fBW;
+    SkString                       fName;
+    size_t                         fRowBytes;
+    SkAutoTMalloc<unsigned char>   fImage;
+    SkAutoTMalloc<unsigned char>   fDistanceField;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new DistanceFieldBench( 32, false); )
+DEF_BENCH( return new DistanceFieldBench( 72, false); )
+DEF_BENCH( return new DistanceFieldBench(162, false); )
+DEF_BENCH( return new DistanceFieldBench( 72, true); )
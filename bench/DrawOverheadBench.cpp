@@ -0,0 +1,117 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkCanvas.h"
+#include "SkImage.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkString.h"
+#include "SkSurface.h"
+
+// Each loop issues exactly one small draw, so the time reported is the cost of a single draw
+// call.  The draws are tiny and move around a grid, so with the null GL interface
+// (--config nullgpu) nearly all of that time is Skia's own CPU work in the GPU backend: batch
+// creation and merging, clip and state setup, and flushing.
+//
+//   nanobench --config nullgpu --match draw_overhead
+class DrawOverheadBench : public Benchmark {
+public:
+    enum Draw {
+        kRect_Draw,
+        kText_Draw,
+        kImage_Draw,
+        kPath_Draw,
+        kClipChange_Draw,
+    };
+
+    DrawOverheadBench(Draw draw) : fDraw(draw) {
+        static const char* kNames[] = { "rect", "text", "image", "path", "clip_change" };
+        fName.printf("draw_overhead_%s", kNames[draw]);
+    }
+
+    bool isSuitableFor(Backend backend) override { return kGPU_Backend == backend; }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fPath.moveTo(0, 0);
+        fPath.quadTo(kCell, 0, kCell, kCell);
+        fPath.lineTo(kCell / 2, kCell / 3);
+        fPath.close();
+    }
+
+    void onPerCanvasPreDraw(SkCanvas* canvas) override {
+        // Make the image on the canvas' own backend so drawing it never has to upload.
+        auto surface(canvas->makeSurface(SkImageInfo::MakeN32Premul(kCell, kCell)));
+        if (surface) {
+            surface->getCanvas()->clear(SK_ColorBLUE);
+            fImage = surface->makeImageSnapshot();
+        }
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        // Release the image here, before the context that owns its texture goes away.
+        fImage.reset(nullptr);
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        paint.setTextSize(kCell);
+
+        const SkISize size = canvas->getBaseLayerSize();
+        const int columns = SkTMax(size.width() / kCell, 1),
+                  cells   = columns * SkTMax(size.height() / kCell, 1);
+        for (int i = 0; i < loops; i++) {
+            const SkScalar x = SkIntToScalar((i % cells) % columns * kCell),
+                           y = SkIntToScalar((i % cells) / columns * kCell);
+            paint.setColor(0xFF000000 | (i * 0x10204));
+            switch (fDraw) {
+                case kRect_Draw:
+                    canvas->drawRect(SkRect::MakeXYWH(x, y, kCell, kCell), paint);
+                    break;
+                case kText_Draw:
+                    canvas->drawText("Skia", 4, x, y + kCell, paint);
+                    break;
+                case kImage_Draw:
+                    canvas->drawImage(fImage.get(), x, y);
+                    break;
+                case kPath_Draw:
+                    canvas->save();
+                    canvas->translate(x, y);
+                    canvas->drawPath(fPath, paint);
+                    canvas->restore();
+                    break;
+                case kClipChange_Draw:
+                    // A new clip for every draw, which also keeps the draws from merging.
+                    canvas->save();
+                    canvas->clipRect(SkRect::MakeXYWH(x + 1, y + 1, kCell - 2, kCell - 2));
+                    canvas->drawRect(SkRect::MakeXYWH(x, y, kCell, kCell), paint);
+                    canvas->restore();
+                    break;
+            }
+        }
+    }
+
+private:
+    static const int kCell = 16;
+
+    Draw            fDraw;
+    SkString        fName;
+    SkPath          fPath;
+    sk_sp<SkImage>  fImage;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new DrawOverheadBench(DrawOverheadBench::kRect_Draw); )
+DEF_BENCH( return new DrawOverheadBench(DrawOverheadBench::kText_Draw); )
+DEF_BENCH( return new DrawOverheadBench(DrawOverheadBench::kImage_Draw); )
+DEF_BENCH( return new DrawOverheadBench(DrawOverheadBench::kPath_Draw); )
+DEF_BENCH( return new DrawOverheadBench(DrawOverheadBench::kClipChange_Draw); )
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkCanvas.h"
+#include "SkPath.h"
+#include "SkRandom.h"
+#include "SkString.h"
+#include "SkTArray.h"
+
+// Repeatedly fills the same small, curvy anti-aliased paths (think map symbols), either as
+// persistent paths whose edges SkEdgeCache can reuse, or as volatile paths that it skips.
+class EdgeCacheBench : public Benchmark {
+public:
+    EdgeCacheBench(bool cached) : fCached(cached) {
+        fName.printf("edge_cache_%s", cached ? "cached" : "uncached");
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kRaster_Backend; }
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkRandom rand;
+        for (int i = 0; i < 16; i++) {
+            const SkScalar cx = rand.nextRangeScalar(0, 640),
+                           cy = rand.nextRangeScalar(0, 480);
+            SkPath path;
+            path.moveTo(cx, cy);
+            for (int j = 0; j < 32; j++) {
+                path.quadTo(cx + rand.nextRangeScalar(-16, 16), cy + rand.nextRangeScalar(-16, 16),
+                            cx + rand.nextRangeScalar(-16, 16), cy + rand.nextRangeScalar(-16, 16));
+            }
+            path.close();
+            path.setIsVolatile(!fCached);
+            fPaths.push_back(path);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        paint.setColor(0x80336699);
+        while (loops --> 0) {
+            for (const SkPath& path : fPaths) {
+                canvas->drawPath(path, paint);
+            }
+        }
+    }
+
+private:
+    bool              fCached;
+    SkString          fName;
+    SkTArray<SkPath>  fPaths;
+};
+
+DEF_BENCH(return new EdgeCacheBench(false);)
+DEF_BENCH(return new EdgeCacheBench(true);)
@@ -10,6 +10,8 @@
 #include "SkBitmap.h"
 #include "SkData.h"
 #include "SkImageEncoder.h"
+#include "SkPNGEncoder.h"
+#include "SkStream.h"
 
 class EncodeBench : public Benchmark {
 public:
@@ -76,6 +78,44 @@ DEF_BENCH(return new EncodeBench("color_wheel.jpg", SkImageEncoder::kJPEG_Type,
 DEF_BENCH(return new EncodeBench("mandrill_512.png", SkImageEncoder::kPNG_Type, 90));
 DEF_BENCH(return new EncodeBench("color_wheel.jpg", SkImageEncoder::kPNG_Type, 90));
 
+// SkPNGEncoder is only built where libpng does our PNG encoding; see images.gyp.
+#if !defined(SK_BUILD_FOR_MAC) && !defined(SK_BUILD_FOR_WIN) && !defined(SK_BUILD_FOR_IOS) && \
+    defined(SK_HAS_PNG_LIBRARY)
+
+// Compares encoding big PNGs in bands on SkTaskGroup threads with encoding them serially.
+class PNGEncodeBench : public Benchmark {
+public:
+    PNGEncodeBench(const char* filename, bool multiThreaded) : fFilename(filename) {
+        fOptions.fMultiThreaded = multiThreaded;
+        fName.printf("Encode_%s_PNG_%s", filename, multiThreaded ? "banded" : "serial");
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onPreDraw(SkCanvas*) override {
+        SkAssertResult(GetResourceAsBitmap(fFilename, &fBitmap));
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            SkDynamicMemoryWStream stream;
+            SkAssertResult(SkPNGEncoder::Encode(&stream, fBitmap, fOptions));
+        }
+    }
+
+private:
+    const char*           fFilename;
+    SkPNGEncoder::Options fOptions;
+    SkString              fName;
+    SkBitmap              fBitmap;
+};
+
+DEF_BENCH(return new PNGEncodeBench("mandrill_512.png", true));
+DEF_BENCH(return new PNGEncodeBench("mandrill_512.png", false));
+#endif
+
 // TODO: What is the appropriate quality to use to benchmark WEBP encodes?
 DEF_BENCH(return new EncodeBench("mandrill_512.png", SkImageEncoder::kWEBP_Type, 90));
 DEF_BENCH(return new EncodeBench("color_wheel.jpg", SkImageEncoder::kWEBP_Type, 90));
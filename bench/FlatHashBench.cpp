@@ -0,0 +1,193 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkChecksum.h"
+#include "SkRandom.h"
+#include "SkString.h"
+#include "SkTDynamicHash.h"
+#include "SkTFlatHash.h"
+#include "SkTHash.h"
+
+// Compares lookups in SkTHashTable, SkTDynamicHash and SkTFlatHashTable, shaped like their
+// hottest users: SkGlyphCache's glyph map (large entries stored inline, keyed by a packed ID)
+// and GrResourceCache's unique key map (pointers to resources holding their own keys).
+
+namespace {
+
+// About the size of an SkGlyph.
+struct Glyph {
+    uint32_t fID;
+    uint32_t fPayload[9];
+
+    struct Traits {
+        static uint32_t GetKey(const Glyph& g) { return g.fID; }
+        static uint32_t Hash(uint32_t id) { return SkChecksum::CheapMix(id); }
+    };
+};
+
+// Keys are compared through the pointer, as with GrGpuResource and GrUniqueKey.
+struct Resource {
+    uint32_t fKey[6];
+
+    static const Resource& GetKey(const Resource& r) { return r; }
+    static uint32_t Hash(const Resource& r) { return SkChecksum::Murmur3(r.fKey, sizeof(r.fKey)); }
+    bool operator==(const Resource& that) const {
+        return 0 == memcmp(fKey, that.fKey, sizeof(fKey));
+    }
+};
+
+struct ResourcePtrTraits {
+    static const Resource& GetKey(const Resource* r) { return *r; }
+    static uint32_t Hash(const Resource& r) { return Resource::Hash(r); }
+};
+
+}  // namespace
+
+enum HashTableType {
+    kTHash_HashTableType,
+    kDynamic_HashTableType,
+    kFlat_HashTableType,
+};
+
+static const char* table_name(HashTableType type) {
+    switch (type) {
+        case kTHash_HashTableType:   return "thash";
+        case kDynamic_HashTableType: return "dynamic";
+        case kFlat_HashTableType:    return "flat";
+    }
+    return "";
+}
+
+// Looks up kLookups packed glyph IDs, half of them missing, in a table of fCount glyphs.
+class GlyphHashBench : public Benchmark {
+public:
+    GlyphHashBench(HashTableType type, int count)
+        : fType(type)
+        , fCount(count)
+        , fName(SkStringPrintf("hash_glyphs_%s_%d", table_name(type), count)) {}
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+protected:
+    enum { kLookups = 1024 };
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkRandom rand;
+        for (int i = 0; i < fCount; i++) {
+            Glyph g;
+            memset(&g, 0, sizeof(g));
+            g.fID = 2 * i;
+            fTHash.set(g);
+            fFlat.set(g);
+        }
+        for (int i = 0; i < kLookups; i++) {
+            fLookups[i] = rand.nextULessThan(2 * fCount);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        int found = 0;
+        for (int n = 0; n < loops; n++) {
+            for (int i = 0; i < kLookups; i++) {
+                if (kFlat_HashTableType == fType) {
+                    found += SkToBool(fFlat.find(fLookups[i]));
+                } else {
+                    found += SkToBool(fTHash.find(fLookups[i]));
+                }
+            }
+        }
+        fSink = found;
+    }
+
+private:
+    HashTableType fType;
+    int           fCount;
+    SkString      fName;
+    uint32_t      fLookups[kLookups];
+    SkTHashTable    <Glyph, uint32_t, Glyph::Traits> fTHash;
+    SkTFlatHashTable<Glyph, uint32_t, Glyph::Traits> fFlat;
+    volatile int  fSink;
+
+    typedef Benchmark INHERITED;
+};
+
+// Looks up kLookups keys, half of them missing, in a table of fCount resource pointers.
+class ResourceHashBench : public Benchmark {
+public:
+    ResourceHashBench(HashTableType type, int count)
+        : fType(type)
+        , fCount(count)
+        , fName(SkStringPrintf("hash_resources_%s_%d", table_name(type), count)) {}
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+protected:
+    enum { kLookups = 1024 };
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkRandom rand;
+        fResources.reset(fCount);
+        for (int i = 0; i < fCount; i++) {
+            for (uint32_t& k : fResources[i].fKey) {
+                k = rand.nextU();
+            }
+            fDynamic.add(&fResources[i]);
+            fFlat.set(&fResources[i]);
+        }
+        for (int i = 0; i < kLookups; i++) {
+            fLookups[i] = fResources[rand.nextULessThan(fCount)];
+            if (i & 1) {
+                fLookups[i].fKey[0] ^= 1;
+            }
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        int found = 0;
+        for (int n = 0; n < loops; n++) {
+            for (int i = 0; i < kLookups; i++) {
+                if (kFlat_HashTableType == fType) {
+                    found += SkToBool(fFlat.find(fLookups[i]));
+                } else {
+                    found += SkToBool(fDynamic.find(fLookups[i]));
+                }
+            }
+        }
+        fSink = found;
+    }
+
+private:
+    HashTableType             fType;
+    int                       fCount;
+    SkString                  fName;
+    SkAutoTArray<Resource>    fResources;
+    Resource                  fLookups[kLookups];
+    SkTDynamicHash  <Resource,  Resource>                    fDynamic;
+    SkTFlatHashTable<Resource*, Resource, ResourcePtrTraits> fFlat;
+    volatile int              fSink;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new GlyphHashBench(kTHash_HashTableType,   64); )
+DEF_BENCH( return new GlyphHashBench(kFlat_HashTableType,    64); )
+DEF_BENCH( return new GlyphHashBench(kTHash_HashTableType, 4096); )
+DEF_BENCH( return new GlyphHashBench(kFlat_HashTableType,  4096); )
+DEF_BENCH( return new GlyphHashBench(kTHash_HashTableType, 262144); )
+DEF_BENCH( return new GlyphHashBench(kFlat_HashTableType,  262144); )
+
+DEF_BENCH( return new ResourceHashBench(kDynamic_HashTableType,   64); )
+DEF_BENCH( return new ResourceHashBench(kFlat_HashTableType,      64); )
+DEF_BENCH( return new ResourceHashBench(kDynamic_HashTableType, 4096); )
+DEF_BENCH( return new ResourceHashBench(kFlat_HashTableType,    4096); )
+DEF_BENCH( return new ResourceHashBench(kDynamic_HashTableType, 262144); )
+DEF_BENCH( return new ResourceHashBench(kFlat_HashTableType,    262144); )
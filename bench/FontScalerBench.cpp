@@ -7,10 +7,13 @@
 
 #include "Benchmark.h"
 #include "SkCanvas.h"
+#include "SkGlyphCache.h"
 #include "SkGraphics.h"
 #include "SkPaint.h"
 #include "SkRandom.h"
 #include "SkString.h"
+#include "SkTaskGroup.h"
+#include "SkUtils.h"
 
 class FontScalerBench : public Benchmark {
     SkString fName;
@@ -46,7 +49,52 @@ private:
     typedef Benchmark INHERITED;
 };
 
+// Rasterizes the same glyphs as FontScalerBench, but with each text size on its own thread, to
+// see how well the scaler scales across threads.
+class FontScalerThreadedBench : public Benchmark {
+    SkString fName;
+    SkString fText;
+    bool     fDoLCD;
+public:
+    FontScalerThreadedBench(bool doLCD)  {
+        fName.printf("fontscaler_threaded_%s", doLCD ? "lcd" : "aa");
+        fText.set("abcdefghijklmnopqrstuvwxyz01234567890");
+        fDoLCD = doLCD;
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkPaint paint;
+        this->setupPaint(&paint);
+        paint.setLCDRenderText(fDoLCD);
+
+        for (int i = 0; i < loops; i++) {
+            SkGraphics::PurgeFontCache();
+
+            SkTaskGroup().batch(8, [&](int size) {
+                // Every thread keeps a few caches to itself, so purge them too.
+                SkGraphics::PurgeFontCache();
+                SkPaint sizedPaint(paint);
+                sizedPaint.setTextSize(SkIntToScalar(9 + 2 * size));
+                SkAutoGlyphCache cache(sizedPaint, nullptr, nullptr);
+                const char* text = fText.c_str();
+                const char* stop = text + fText.size();
+                while (text < stop) {
+                    cache->findImage(cache->getUnicharMetrics(SkUTF8_NextUnichar(&text)));
+                }
+            });
+        }
+    }
+private:
+    typedef Benchmark INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH(return new FontScalerBench(false);)
 DEF_BENCH(return new FontScalerBench(true);)
+DEF_BENCH(return new FontScalerThreadedBench(false);)
+DEF_BENCH(return new FontScalerThreadedBench(true);)
@@ -16,22 +16,30 @@
 #include "SkTDArray.h"
 #include "SkTemplates.h"
 
+#include <type_traits>
+
 // change this to 0 to compare GrMemoryPool to default new / delete
 #define OVERRIDE_NEW    1
 
-struct A {
+template <typename Pool> static bool is_size_class_pool() {
+    return std::is_same<Pool, GrSizeClassPool>::value;
+}
+
+template <typename Pool> struct A {
     int gStuff[10];
 #if OVERRIDE_NEW
     void* operator new (size_t size) { return gBenchPool.allocate(size); }
     void operator delete (void* mem) { if (mem) { return gBenchPool.release(mem); } }
 #endif
-    static GrMemoryPool gBenchPool;
+    static Pool gBenchPool;
 };
-GrMemoryPool A::gBenchPool(10 * (1 << 10), 10 * (1 << 10));
+template <> GrMemoryPool A<GrMemoryPool>::gBenchPool(10 * (1 << 10), 10 * (1 << 10));
+template <> GrSizeClassPool A<GrSizeClassPool>::gBenchPool(10 * (1 << 10));
 
 /**
  * This benchmark creates and deletes objects in stack order
  */
+template <typename Pool>
 class GrMemoryPoolBenchStack : public Benchmark {
 public:
     bool isSuitableFor(Backend backend) override {
@@ -40,7 +48,7 @@ public:
 
 protected:
     const char* onGetName() override {
-        return "grmemorypool_stack";
+        return is_size_class_pool<Pool>() ? "grsizeclasspool_stack" : "grmemorypool_stack";
     }
 
     void onDraw(int loops, SkCanvas*) override {
@@ -48,7 +56,7 @@ protected:
         enum {
             kMaxObjects = 4 * (1 << 10),
         };
-        A* objects[kMaxObjects];
+        A<Pool>* objects[kMaxObjects];
 
         // We delete if a random number [-1, 1] is < the thresh. Otherwise,
         // we allocate. We start allocate-biased and ping-pong to delete-biased
@@ -68,7 +76,7 @@ protected:
                 delete objects[count-1];
                 --count;
             } else {
-                objects[count] = new A;
+                objects[count] = new A<Pool>;
                 ++count;
             }
         }
@@ -81,19 +89,21 @@ private:
     typedef Benchmark INHERITED;
 };
 
-struct B {
+template <typename Pool> struct B {
     int gStuff[10];
 #if OVERRIDE_NEW
     void* operator new (size_t size) { return gBenchPool.allocate(size); }
     void operator delete (void* mem) { if (mem) { return gBenchPool.release(mem); } }
 #endif
-    static GrMemoryPool gBenchPool;
+    static Pool gBenchPool;
 };
-GrMemoryPool B::gBenchPool(10 * (1 << 10), 10 * (1 << 10));
+template <> GrMemoryPool B<GrMemoryPool>::gBenchPool(10 * (1 << 10), 10 * (1 << 10));
+template <> GrSizeClassPool B<GrSizeClassPool>::gBenchPool(10 * (1 << 10));
 
 /**
  * This benchmark creates objects and deletes them in random order
  */
+template <typename Pool>
 class GrMemoryPoolBenchRandom : public Benchmark {
 public:
     bool isSuitableFor(Backend backend) override {
@@ -102,7 +112,7 @@ public:
 
 protected:
     const char* onGetName() override {
-        return "grmemorypool_random";
+        return is_size_class_pool<Pool>() ? "grsizeclasspool_random" : "grmemorypool_random";
     }
 
     void onDraw(int loops, SkCanvas*) override {
@@ -110,12 +120,12 @@ protected:
         enum {
             kMaxObjects = 4 * (1 << 10),
         };
-        SkAutoTDelete<B> objects[kMaxObjects];
+        SkAutoTDelete<B<Pool>> objects[kMaxObjects];
 
         for (int i = 0; i < loops; i++) {
             uint32_t idx = r.nextRangeU(0, kMaxObjects-1);
             if (nullptr == objects[idx].get()) {
-                objects[idx].reset(new B);
+                objects[idx].reset(new B<Pool>);
             } else {
                 objects[idx].reset();
             }
@@ -126,19 +136,21 @@ private:
     typedef Benchmark INHERITED;
 };
 
-struct C {
+template <typename Pool> struct C {
     int gStuff[10];
 #if OVERRIDE_NEW
     void* operator new (size_t size) { return gBenchPool.allocate(size); }
     void operator delete (void* mem) { if (mem) { return gBenchPool.release(mem); } }
 #endif
-    static GrMemoryPool gBenchPool;
+    static Pool gBenchPool;
 };
-GrMemoryPool C::gBenchPool(10 * (1 << 10), 10 * (1 << 10));
+template <> GrMemoryPool C<GrMemoryPool>::gBenchPool(10 * (1 << 10), 10 * (1 << 10));
+template <> GrSizeClassPool C<GrSizeClassPool>::gBenchPool(10 * (1 << 10));
 
 /**
  * This benchmark creates objects and deletes them in queue order
  */
+template <typename Pool>
 class GrMemoryPoolBenchQueue : public Benchmark {
     enum {
         M = 4 * (1 << 10),
@@ -150,16 +162,16 @@ public:
 
 protected:
     const char* onGetName() override {
-        return "grmemorypool_queue";
+        return is_size_class_pool<Pool>() ? "grsizeclasspool_queue" : "grmemorypool_queue";
     }
 
     void onDraw(int loops, SkCanvas*) override {
         SkRandom r;
-        C* objects[M];
+        C<Pool>* objects[M];
         for (int i = 0; i < loops; i++) {
             uint32_t count = r.nextRangeU(0, M-1);
             for (uint32_t i = 0; i < count; i++) {
-                objects[i] = new C;
+                objects[i] = new C<Pool>;
             }
             for (uint32_t i = 0; i < count; i++) {
                 delete objects[i];
@@ -173,8 +185,11 @@ private:
 
 ///////////////////////////////////////////////////////////////////////////////
 
-DEF_BENCH( return new GrMemoryPoolBenchStack(); )
-DEF_BENCH( return new GrMemoryPoolBenchRandom(); )
-DEF_BENCH( return new GrMemoryPoolBenchQueue(); )
+DEF_BENCH( return new GrMemoryPoolBenchStack<GrMemoryPool>(); )
+DEF_BENCH( return new GrMemoryPoolBenchRandom<GrMemoryPool>(); )
+DEF_BENCH( return new GrMemoryPoolBenchQueue<GrMemoryPool>(); )
+DEF_BENCH( return new GrMemoryPoolBenchStack<GrSizeClassPool>(); )
+DEF_BENCH( return new GrMemoryPoolBenchRandom<GrSizeClassPool>(); )
+DEF_BENCH( return new GrMemoryPoolBenchQueue<GrSizeClassPool>(); )
 
 #endif
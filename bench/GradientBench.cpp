@@ -58,8 +58,9 @@ static sk_sp<SkShader> MakeRadial(const SkPoint pts[2], const GradData& data,
     SkPoint center;
     center.set(SkScalarAve(pts[0].fX, pts[1].fX),
                SkScalarAve(pts[0].fY, pts[1].fY));
+    const uint32_t flags = force4f ? SkLinearGradient::kForce4fContext_PrivateFlag : 0;
     return SkGradientShader::MakeRadial(center, center.fX * scale, data.fColors,
-                                        data.fPos, data.fCount, tm);
+                                        data.fPos, data.fCount, tm, flags, nullptr);
 }
 
 /// Ignores scale
@@ -68,7 +69,9 @@ static sk_sp<SkShader> MakeSweep(const SkPoint pts[2], const GradData& data,
     SkPoint center;
     center.set(SkScalarAve(pts[0].fX, pts[1].fX),
                SkScalarAve(pts[0].fY, pts[1].fY));
-    return SkGradientShader::MakeSweep(center.fX, center.fY, data.fColors, data.fPos, data.fCount);
+    const uint32_t flags = force4f ? SkLinearGradient::kForce4fContext_PrivateFlag : 0;
+    return SkGradientShader::MakeSweep(center.fX, center.fY, data.fColors, data.fPos, data.fCount,
+                                       flags, nullptr);
 }
 
 /// Ignores scale
@@ -79,9 +82,11 @@ static sk_sp<SkShader> MakeConical(const SkPoint pts[2], const GradData& data,
                 SkScalarAve(pts[0].fY, pts[1].fY));
     center1.set(SkScalarInterp(pts[0].fX, pts[1].fX, SkIntToScalar(3)/5),
                 SkScalarInterp(pts[0].fY, pts[1].fY, SkIntToScalar(1)/4));
+    const uint32_t flags = force4f ? SkLinearGradient::kForce4fContext_PrivateFlag : 0;
     return SkGradientShader::MakeTwoPointConical(center1, (pts[1].fX - pts[0].fX) / 7,
                                                  center0, (pts[1].fX - pts[0].fX) / 2,
-                                                 data.fColors, data.fPos, data.fCount, tm);
+                                                 data.fColors, data.fPos, data.fCount, tm,
+                                                 flags, nullptr);
 }
 
 /// Ignores scale
@@ -105,10 +110,11 @@ static sk_sp<SkShader> MakeConicalOutside(const SkPoint pts[2], const GradData&
     SkScalar radius1 = (pts[1].fX - pts[0].fX) / 3;
     center0.set(pts[0].fX + radius0, pts[0].fY + radius0);
     center1.set(pts[1].fX - radius1, pts[1].fY - radius1);
+    const uint32_t flags = force4f ? SkLinearGradient::kForce4fContext_PrivateFlag : 0;
     return SkGradientShader::MakeTwoPointConical(center0, radius0,
                                                  center1, radius1,
                                                  data.fColors, data.fPos,
-                                                 data.fCount, tm);
+                                                 data.fCount, tm, flags, nullptr);
 }
 
 /// Ignores scale
@@ -293,6 +299,20 @@ DEF_BENCH( return new GradientBench(kLinear_GradType, gGradData[1], SkShader::kM
                                     kRect_GeomType, 1, true); )
 DEF_BENCH( return new GradientBench(kLinear_GradType, gGradData[2], SkShader::kMirror_TileMode,
                                     kRect_GeomType, 1, true); )
+DEF_BENCH( return new GradientBench(kRadial_GradType, gGradData[0], SkShader::kClamp_TileMode,
+                                    kRect_GeomType, 1, true); )
+DEF_BENCH( return new GradientBench(kRadial_GradType, gGradData[1], SkShader::kClamp_TileMode,
+                                    kRect_GeomType, 1, true); )
+DEF_BENCH( return new GradientBench(kRadial_GradType, gGradData[0], SkShader::kRepeat_TileMode,
+                                    kRect_GeomType, 1, true); )
+DEF_BENCH( return new GradientBench(kSweep_GradType, gGradData[0], SkShader::kClamp_TileMode,
+                                    kRect_GeomType, 1, true); )
+DEF_BENCH( return new GradientBench(kSweep_GradType, gGradData[1], SkShader::kClamp_TileMode,
+                                    kRect_GeomType, 1, true); )
+DEF_BENCH( return new GradientBench(kConical_GradType, gGradData[0], SkShader::kClamp_TileMode,
+                                    kRect_GeomType, 1, true); )
+DEF_BENCH( return new GradientBench(kConicalOut_GradType, gGradData[0], SkShader::kClamp_TileMode,
+                                    kRect_GeomType, 1, true); )
 
 DEF_BENCH( return new GradientBench(kLinear_GradType, gGradData[0]); )
 DEF_BENCH( return new GradientBench(kLinear_GradType, gGradData[1]); )
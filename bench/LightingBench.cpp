@@ -14,6 +14,8 @@
 #define FILTER_WIDTH_LARGE  SkIntToScalar(256)
 #define FILTER_HEIGHT_LARGE SkIntToScalar(256)
 
+// All but the first and last rows the filter lights are interior rows, whose surface normals
+// SkOpts::lighting_normals() computes four pixels at a time, so these mostly measure that path.
 class LightingBaseBench : public Benchmark {
 public:
     LightingBaseBench(bool small) : fIsSmall(small) { }
@@ -64,3 +64,52 @@ DEF_BENCH(return new LineBench(SK_Scalar1,   false);)
 DEF_BENCH(return new LineBench(0,            true);)
 DEF_BENCH(return new LineBench(SK_Scalar1/2, true);)
 DEF_BENCH(return new LineBench(SK_Scalar1,   true);)
+
+// A long, wandering polyline, like a GPS track: many short segments drawn in one call.
+class PolylineBench : public Benchmark {
+    bool     fDoAA;
+    SkString fName;
+    enum {
+        PTS = 100000,
+    };
+    SkTArray<SkPoint> fPts;
+
+public:
+    PolylineBench(bool doAA) : fDoAA(doAA) {
+        fName.printf("polyline_hairline_%s", doAA ? "AA" : "BW");
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        SkRandom rand;
+        SkPoint p = SkPoint::Make(320, 240);
+        for (int i = 0; i < PTS; ++i) {
+            p.offset(rand.nextRangeScalar(-4, 4), rand.nextRangeScalar(-4, 4));
+            p.set(SkScalarPin(p.fX, 0, 640), SkScalarPin(p.fY, 0, 480));
+            fPts.push_back(p);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        this->setupPaint(&paint);
+
+        paint.setStyle(SkPaint::kStroke_Style);
+        paint.setAntiAlias(fDoAA);
+        paint.setStrokeWidth(0);
+
+        for (int i = 0; i < loops; i++) {
+            canvas->drawPoints(SkCanvas::kPolygon_PointMode, fPts.count(), fPts.begin(), paint);
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH(return new PolylineBench(false);)
+DEF_BENCH(return new PolylineBench(true);)
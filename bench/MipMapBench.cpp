@@ -14,12 +14,15 @@ class MipMapBench: public Benchmark {
     SkString fName;
     const int fW, fH;
     SkSourceGammaTreatment fTreatment;
+    SkMipMap::LevelGeneration fGeneration;
 
 public:
-    MipMapBench(int w, int h, SkSourceGammaTreatment treatment)
-        : fW(w), fH(h), fTreatment(treatment)
+    MipMapBench(int w, int h, SkSourceGammaTreatment treatment,
+                SkMipMap::LevelGeneration generation = SkMipMap::kAllLevels_LevelGeneration)
+        : fW(w), fH(h), fTreatment(treatment), fGeneration(generation)
     {
-        fName.printf("mipmap_build_%dx%d_%d_gamma", w, h, static_cast<int>(treatment));
+        fName.printf("mipmap_build_%dx%d_%d_gamma%s", w, h, static_cast<int>(treatment),
+                     SkMipMap::kOnDemand_LevelGeneration == generation ? "_ondemand" : "");
     }
 
 protected:
@@ -37,7 +40,11 @@ protected:
 
     void onDraw(int loops, SkCanvas*) override {
         for (int i = 0; i < loops * 4; i++) {
-            SkMipMap::Build(fBitmap, fTreatment, nullptr)->unref();
+            SkMipMap* mipmap = SkMipMap::Build(fBitmap, fTreatment, nullptr, fGeneration);
+            // Draw at about a third of full size, like a thumbnail would.
+            SkMipMap::Level level;
+            mipmap->extractLevel(SkSize::Make(0.3f, 0.3f), &level);
+            mipmap->unref();
         }
     }
 
@@ -53,3 +60,7 @@ DEF_BENCH( return new MipMapBench(512, 511, SkSourceGammaTreatment::kIgnore); )
 DEF_BENCH( return new MipMapBench(511, 512, SkSourceGammaTreatment::kIgnore); )
 DEF_BENCH( return new MipMapBench(512, 512, SkSourceGammaTreatment::kIgnore); )
 DEF_BENCH( return new MipMapBench(512, 512, SkSourceGammaTreatment::kRespect); )
+
+DEF_BENCH( return new MipMapBench(512, 512, SkSourceGammaTreatment::kIgnore,
+                                  SkMipMap::kOnDemand_LevelGeneration); )
+DEF_BENCH( return new MipMapBench(2048, 2048, SkSourceGammaTreatment::kIgnore); )
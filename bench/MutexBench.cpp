@@ -10,6 +10,9 @@
 #include "SkSpinlock.h"
 #include "SkString.h"
 
+#include <thread>
+#include <vector>
+
 template <typename Mutex>
 class MutexBench : public Benchmark {
 public:
@@ -59,9 +62,117 @@ private:
     SkSharedMutex fMu;
 };
 
+// kThreads threads all reading through a shared lock at once, as for read-mostly data like the
+// typeface cache.  If writes is set, one in every kWriteEvery acquisitions on the first thread is
+// exclusive instead.
+template <typename Mutex>
+class SharedContendedBench : public Benchmark {
+public:
+    SharedContendedBench(const char* mutexName, bool writes)
+        : fName(SkStringPrintf("%sShared%s_%dthreads", mutexName, writes ? "Writes" : "",
+                               kThreads))
+        , fWrites(writes)
+        , fData(0)
+        , fSink(0) {}
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; t++) {
+            threads.emplace_back([this, loops, t] {
+                int sum = 0;
+                for (int i = 0; i < loops; i++) {
+                    if (fWrites && t == 0 && i % kWriteEvery == 0) {
+                        fMu.acquire();
+                        fData++;
+                        fMu.release();
+                    } else {
+                        fMu.acquireShared();
+                        sum += fData;
+                        fMu.releaseShared();
+                    }
+                }
+                fSink.fetch_add(sum, sk_memory_order_relaxed);
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+
+private:
+    static const int kThreads    = 16;
+    static const int kWriteEvery = 1024;
+
+    typedef Benchmark INHERITED;
+    SkString          fName;
+    const bool        fWrites;
+    int               fData;
+    SkAtomic<int>     fSink;
+    Mutex             fMu;
+};
+
+// kThreads threads taking turns through a short exclusive critical section, as for
+// SkResourceCache or SkTaskGroup's work queue.
+template <typename Mutex>
+class ContendedBench : public Benchmark {
+public:
+    explicit ContendedBench(const char* mutexName)
+        : fName(SkStringPrintf("%sContended_%dthreads", mutexName, kThreads))
+        , fData(0) {}
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; t++) {
+            threads.emplace_back([this, loops] {
+                for (int i = 0; i < loops; i++) {
+                    fMu.acquire();
+                    fData++;
+                    fMu.release();
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+
+private:
+    static const int kThreads = 4;
+
+    typedef Benchmark INHERITED;
+    SkString fName;
+    int      fData;
+    Mutex    fMu;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new MutexBench<SkSharedMutex>(SkString("SkSharedMutex")); )
+DEF_BENCH( return new MutexBench<SkStripedSharedMutex>(SkString("SkStripedSharedMutex")); )
 DEF_BENCH( return new MutexBench<SkMutex>(SkString("SkMutex")); )
 DEF_BENCH( return new MutexBench<SkSpinlock>(SkString("SkSpinlock")); )
 DEF_BENCH( return new SharedBench; )
+DEF_BENCH( return new SharedContendedBench<SkSharedMutex>("SkSharedMutex", false); )
+DEF_BENCH( return new SharedContendedBench<SkSharedMutex>("SkSharedMutex", true); )
+DEF_BENCH( return new SharedContendedBench<SkStripedSharedMutex>("SkStripedSharedMutex", false); )
+DEF_BENCH( return new SharedContendedBench<SkStripedSharedMutex>("SkStripedSharedMutex", true); )
+DEF_BENCH( return new ContendedBench<SkMutex>("SkMutex"); )
+DEF_BENCH( return new ContendedBench<SkSpinlock>("SkSpinlock"); )
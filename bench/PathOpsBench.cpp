@@ -0,0 +1,131 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkPath.h"
+#include "SkPathOps.h"
+#include "SkRandom.h"
+#include "SkString.h"
+#include "SkTArray.h"
+
+// Unions a grid of overlapping L-shaped footprints, the way map generalization merges
+// buildings: either all at once with SkOpBuilder, or one Op() at a time.
+class PathOpsUnionBench : public Benchmark {
+public:
+    PathOpsUnionBench(int count, bool useBuilder) : fUseBuilder(useBuilder) {
+        fName.printf("pathops_union_%d_%s", count, useBuilder ? "builder" : "op");
+
+        SkRandom rand;
+        const int columns = 20;
+        for (int i = 0; i < count; ++i) {
+            SkScalar x = (i % columns) * 10 + rand.nextRangeF(0, 6);
+            SkScalar y = (i / columns) * 10 + rand.nextRangeF(0, 6);
+            SkScalar w = rand.nextRangeF(8, 14);
+            SkScalar h = rand.nextRangeF(8, 14);
+            SkPath& path = fPaths.push_back();
+            path.moveTo(x, y);
+            path.lineTo(x + w, y);
+            path.lineTo(x + w, y + h / 2);
+            path.lineTo(x + w / 2, y + h / 2);
+            path.lineTo(x + w / 2, y + h);
+            path.lineTo(x, y + h);
+            path.close();
+        }
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; ++i) {
+            SkPath result;
+            if (fUseBuilder) {
+                SkOpBuilder builder;
+                for (const SkPath& path : fPaths) {
+                    builder.add(path, kUnion_SkPathOp);
+                }
+                (void) builder.resolve(&result);
+            } else {
+                for (const SkPath& path : fPaths) {
+                    (void) Op(result, path, kUnion_SkPathOp, &result);
+                }
+            }
+        }
+    }
+
+private:
+    SkTArray<SkPath> fPaths;
+    SkString         fName;
+    bool             fUseBuilder;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH(return new PathOpsUnionBench(100, true);)
+DEF_BENCH(return new PathOpsUnionBench(100, false);)
+DEF_BENCH(return new PathOpsUnionBench(1000, true);)
+
+// Simplifies a closed, self-crossing freehand scribble of quads, exactly with Simplify() or
+// flattened to a tolerance with ApproximateSimplify().
+class PathOpsSimplifyBench : public Benchmark {
+public:
+    PathOpsSimplifyBench(SkScalar tolerance) : fTolerance(tolerance) {
+        if (tolerance > 0) {
+            fName.printf("pathops_simplify_approximate_%g", tolerance);
+        } else {
+            fName.set("pathops_simplify_exact");
+        }
+
+        SkRandom rand;
+        SkScalar x = 100;
+        SkScalar y = 100;
+        SkScalar angle = 0;
+        fPath.moveTo(x, y);
+        for (int i = 0; i < 200; ++i) {
+            angle += rand.nextRangeF(-0.6f, 0.6f);
+            SkScalar cx = x + 3 * SkScalarCos(angle);
+            SkScalar cy = y + 3 * SkScalarSin(angle);
+            angle += rand.nextRangeF(-0.6f, 0.6f);
+            x = cx + 3 * SkScalarCos(angle);
+            y = cy + 3 * SkScalarSin(angle);
+            fPath.quadTo(cx, cy, x, y);
+        }
+        fPath.close();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; ++i) {
+            SkPath result;
+            if (fTolerance > 0) {
+                (void) ApproximateSimplify(fPath, fTolerance, &result);
+            } else {
+                (void) Simplify(fPath, &result);
+            }
+        }
+    }
+
+private:
+    SkPath   fPath;
+    SkString fName;
+    SkScalar fTolerance;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH(return new PathOpsSimplifyBench(0);)
+DEF_BENCH(return new PathOpsSimplifyBench(0.25f);)
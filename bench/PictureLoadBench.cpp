@@ -0,0 +1,126 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkCanvas.h"
+#include "SkColorFilter.h"
+#include "SkColorFilterImageFilter.h"
+#include "SkData.h"
+#include "SkFlattenableSerialization.h"
+#include "SkOffsetImageFilter.h"
+#include "SkPath.h"
+#include "SkPictureRecorder.h"
+#include "SkRandom.h"
+#include "SkStream.h"
+#include "SkString.h"
+
+// Deserializes a picture of many rects, paths, and text runs, either through a stream
+// (copying and re-recording) or with MakeFromData() (playing back from the bytes in place).
+// If subPictures, the same draws are split among that many nested pictures, which are
+// re-recorded in parallel.
+class PictureLoadBench : public Benchmark {
+public:
+    explicit PictureLoadBench(bool fromData, int subPictures = 0)
+        : fFromData(fromData)
+        , fSubPictures(subPictures) {
+        fName.printf("picture_load_%s", fromData ? "data" : "stream");
+        if (subPictures) {
+            fName.appendf("_%d_subpictures", subPictures);
+        }
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(1000, 1000);
+        SkRandom rand;
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        const int kDraws = 5000;
+        const int drawsPerPicture = fSubPictures ? kDraws / fSubPictures : kDraws;
+        for (int i = 0; i < kDraws; i += drawsPerPicture) {
+            SkPictureRecorder subRecorder;
+            SkCanvas* subCanvas = fSubPictures ? subRecorder.beginRecording(1000, 1000) : canvas;
+            for (int j = i; j < i + drawsPerPicture; j++) {
+                paint.setColor(rand.nextU() | 0xFF000000);
+                subCanvas->drawRect(SkRect::MakeXYWH(rand.nextRangeScalar(0, 960),
+                                                     rand.nextRangeScalar(0, 960), 40, 40), paint);
+                if (j % 10 == 0) {
+                    SkPath path;
+                    path.addCircle(rand.nextRangeScalar(0, 1000), rand.nextRangeScalar(0, 1000),
+                                   20);
+                    subCanvas->drawPath(path, paint);
+                }
+                subCanvas->drawText("Hamburgefons", 12, rand.nextRangeScalar(0, 1000),
+                                    rand.nextRangeScalar(0, 1000), paint);
+            }
+            if (fSubPictures) {
+                canvas->drawPicture(subRecorder.finishRecordingAsPicture());
+            }
+        }
+        SkDynamicMemoryWStream stream;
+        recorder.finishRecordingAsPicture()->serialize(&stream);
+        fData.reset(stream.copyToData());
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops --> 0) {
+            if (fFromData) {
+                SkPicture::MakeFromData(fData);
+            } else {
+                SkMemoryStream stream(fData);
+                SkPicture::MakeFromStream(&stream);
+            }
+        }
+    }
+
+private:
+    bool          fFromData;
+    int           fSubPictures;
+    SkString      fName;
+    sk_sp<SkData> fData;
+};
+
+DEF_BENCH(return new PictureLoadBench(false);)
+DEF_BENCH(return new PictureLoadBench(true);)
+DEF_BENCH(return new PictureLoadBench(false, 50);)
+
+// Deserializes a long chain of image filters the way they arrive from another process, through
+// SkValidatingReadBuffer. Most of the flattenables name a factory the buffer has already seen.
+class FlattenableLoadBench : public Benchmark {
+public:
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return "flattenable_load_imagefilters"; }
+
+    void onDelayedSetup() override {
+        sk_sp<SkImageFilter> filter;
+        for (int i = 0; i < 500; i++) {
+            if (i % 2) {
+                filter = SkOffsetImageFilter::Make(SkIntToScalar(i % 7), 1, std::move(filter));
+            } else {
+                filter = SkColorFilterImageFilter::Make(
+                        SkColorFilter::MakeModeFilter(0xFF000000 | i, SkXfermode::kSrcIn_Mode),
+                        std::move(filter));
+            }
+        }
+        fData.reset(SkValidatingSerializeFlattenable(filter.get()));
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops --> 0) {
+            sk_sp<SkFlattenable>(SkValidatingDeserializeFlattenable(
+                    fData->data(), fData->size(), SkImageFilter::GetFlattenableType()));
+        }
+    }
+
+private:
+    sk_sp<SkData> fData;
+};
+
+DEF_BENCH(return new FlattenableLoadBench;)
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkCanvas.h"
+#include "SkPath.h"
+#include "SkPictureRecorder.h"
+#include "SkRandom.h"
+#include "SkString.h"
+
+// Plays back pictures with lots of overdraw or lots of small paths, recorded with or without
+// SkPictureRecorder::kOptimizeOverdraw_RecordFlag.
+class PictureOverdrawBench : public Benchmark {
+public:
+    enum Scene { kOverdraw, kPaths };
+
+    PictureOverdrawBench(Scene scene, bool optimize) : fScene(scene), fOptimize(optimize) {
+        fName.printf("picture_overdraw_%s%s", scene == kOverdraw ? "layers" : "paths",
+                     optimize ? "_optimized" : "");
+    }
+
+    const char* onGetName() override { return fName.c_str(); }
+    SkIPoint onGetSize() override { return SkIPoint::Make(kSize, kSize); }
+
+    void onDelayedSetup() override {
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(kSize, kSize, nullptr,
+                fOptimize ? SkPictureRecorder::kOptimizeOverdraw_RecordFlag : 0);
+        SkRandom rand;
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        if (fScene == kOverdraw) {
+            // Like tabs or cards stacked on top of each other, each with an opaque background.
+            for (int i = 0; i < 20; i++) {
+                paint.setColor(rand.nextU() | 0xFF000000);
+                canvas->drawRect(SkRect::MakeXYWH(i, i, kSize - 2*i, kSize - 2*i), paint);
+                for (int j = 0; j < 50; j++) {
+                    paint.setColor(rand.nextU() | 0xFF000000);
+                    SkPath path;
+                    path.addCircle(rand.nextRangeScalar(20, kSize - 20),
+                                   rand.nextRangeScalar(20, kSize - 20), 15);
+                    canvas->drawPath(path, paint);
+                    canvas->drawText("Hamburgefons", 12, rand.nextRangeScalar(20, kSize - 100),
+                                     rand.nextRangeScalar(20, kSize - 20), paint);
+                }
+            }
+        } else {
+            // A grid of dots, all in one color.
+            paint.setColor(SK_ColorBLUE);
+            for (int y = 0; y < kSize; y += 16) {
+                for (int x = 0; x < kSize; x += 16) {
+                    SkPath path;
+                    path.addCircle(x + 8, y + 8, 5);
+                    canvas->drawPath(path, paint);
+                }
+            }
+        }
+        fPicture = recorder.finishRecordingAsPicture();
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        while (loops --> 0) {
+            fPicture->playback(canvas);
+        }
+    }
+
+private:
+    static const int kSize = 512;
+
+    Scene            fScene;
+    bool             fOptimize;
+    SkString         fName;
+    sk_sp<SkPicture> fPicture;
+};
+
+DEF_BENCH(return new PictureOverdrawBench(PictureOverdrawBench::kOverdraw, false);)
+DEF_BENCH(return new PictureOverdrawBench(PictureOverdrawBench::kOverdraw, true);)
+DEF_BENCH(return new PictureOverdrawBench(PictureOverdrawBench::kPaths, false);)
+DEF_BENCH(return new PictureOverdrawBench(PictureOverdrawBench::kPaths, true);)
@@ -217,3 +217,52 @@ DEF_BENCH( return new TiledPlaybackBench(kNone,     kRandom); )
 DEF_BENCH( return new TiledPlaybackBench(kNone,     kTiled ); )
 DEF_BENCH( return new TiledPlaybackBench(kRTree,    kRandom); )
 DEF_BENCH( return new TiledPlaybackBench(kRTree,    kTiled ); )
+
+// Thumbnailing-style replay of a whole large picture into a bitmap, on one thread or in
+// concurrent bands with SkPicture::playbackInBands().
+class BandedPlaybackBench : public Benchmark {
+public:
+    BandedPlaybackBench(int bands) : fBands(bands) {
+        fName.printf("banded_playback_%d", bands);
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkRTreeFactory factory;
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(1024, 1024, &factory);
+            SkRandom rand;
+            for (int i = 0; i < 10000; i++) {
+                SkPaint paint;
+                paint.setAntiAlias(true);
+                paint.setColor(rand.nextU() | 0xFF000000);
+                canvas->drawCircle(rand.nextRangeScalar(0, 1024), rand.nextRangeScalar(0, 1024),
+                                   rand.nextRangeScalar(0, 32), paint);
+            }
+        fPic = recorder.finishRecordingAsPicture();
+        fBitmap.allocN32Pixels(1024, 1024);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            if (fBands == 1) {
+                SkCanvas canvas(fBitmap);
+                fPic->playback(&canvas);
+            } else {
+                fPic->playbackInBands(fBitmap, nullptr, fBands);
+            }
+        }
+    }
+
+private:
+    int                 fBands;
+    SkString            fName;
+    sk_sp<SkPicture>    fPic;
+    SkBitmap            fBitmap;
+};
+
+DEF_BENCH( return new BandedPlaybackBench(1); )
+DEF_BENCH( return new BandedPlaybackBench(8); )
+DEF_BENCH( return new BandedPlaybackBench(32); )
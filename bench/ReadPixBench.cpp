@@ -7,6 +7,11 @@
 
 #include "Benchmark.h"
 #include "SkCanvas.h"
+#include "SkColorPriv.h"
+#include "SkColorTable.h"
+#include "SkRandom.h"
+#include "SkString.h"
+#include "SkTemplates.h"
 
 
 /**
@@ -61,6 +66,109 @@ private:
     typedef Benchmark INHERITED;
 };
 
+/**
+ * Converts a whole raster between two formats with SkPixmap::readPixels, as when reading back or
+ * encoding pixels that aren't in the format the caller wants.
+ */
+class ReadPixFormatBench : public Benchmark {
+public:
+    ReadPixFormatBench(SkColorType srcCT, SkAlphaType srcAT, SkColorType dstCT, SkAlphaType dstAT)
+        : fSrcInfo(SkImageInfo::Make(kSize, kSize, srcCT, srcAT))
+        , fDstInfo(SkImageInfo::Make(kSize, kSize, dstCT, dstAT)) {
+        fName.printf("readpix_%s_%s_to_%s_%s", ct_name(srcCT), at_name(srcAT),
+                     ct_name(dstCT), at_name(dstAT));
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        // Random premultiplied colors, converted to the source format.
+        SkRandom rand;
+        SkAutoTMalloc<SkPMColor> colors(kSize * kSize);
+        for (int i = 0; i < kSize * kSize; i++) {
+            colors[i] = SkPreMultiplyColor(rand.nextU());
+        }
+        SkPixmap pm32(SkImageInfo::MakeN32Premul(kSize, kSize), colors.get(), kSize * 4);
+
+        if (kIndex_8_SkColorType == fSrcInfo.colorType()) {
+            fCTable.reset(new SkColorTable(colors.get(), 256));
+            fSrc.allocPixels(fSrcInfo, nullptr, fCTable.get());
+            for (int y = 0; y < kSize; y++) {
+                for (int x = 0; x < kSize; x++) {
+                    *fSrc.getAddr8(x, y) = rand.nextU() & 0xFF;
+                }
+            }
+        } else {
+            fSrc.allocPixels(fSrcInfo);
+            pm32.readPixels(fSrcInfo, fSrc.getPixels(), fSrc.rowBytes());
+        }
+        fDst.allocPixels(fDstInfo, nullptr, fCTable.get());
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkPixmap src;
+        fSrc.peekPixels(&src);
+        for (int i = 0; i < loops; i++) {
+            src.readPixels(fDstInfo, fDst.getPixels(), fDst.rowBytes());
+        }
+    }
+
+private:
+    static const int kSize = 1024;
+
+    static const char* ct_name(SkColorType ct) {
+        switch (ct) {
+            case kRGB_565_SkColorType:   return "565";
+            case kARGB_4444_SkColorType: return "4444";
+            case kRGBA_8888_SkColorType: return "rgba";
+            case kBGRA_8888_SkColorType: return "bgra";
+            case kIndex_8_SkColorType:   return "index8";
+            case kGray_8_SkColorType:    return "gray8";
+            default:                     return "unknown";
+        }
+    }
+
+    static const char* at_name(SkAlphaType at) {
+        switch (at) {
+            case kOpaque_SkAlphaType:   return "opaque";
+            case kPremul_SkAlphaType:   return "premul";
+            case kUnpremul_SkAlphaType: return "unpremul";
+            default:                    return "unknown";
+        }
+    }
+
+    SkString                   fName;
+    const SkImageInfo          fSrcInfo, fDstInfo;
+    SkAutoTUnref<SkColorTable> fCTable;
+    SkBitmap                   fSrc, fDst;
+
+    typedef Benchmark INHERITED;
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new ReadPixBench(); )
+
+#define READPIX_BENCH(srcCT, srcAT, dstCT, dstAT)                                            \
+    DEF_BENCH( return new ReadPixFormatBench(k##srcCT##_SkColorType, k##srcAT##_SkAlphaType, \
+                                             k##dstCT##_SkColorType, k##dstAT##_SkAlphaType); )
+
+READPIX_BENCH(RGBA_8888, Premul,   BGRA_8888, Premul)
+READPIX_BENCH(RGBA_8888, Premul,   RGBA_8888, Unpremul)
+READPIX_BENCH(RGBA_8888, Premul,   BGRA_8888, Unpremul)
+READPIX_BENCH(RGBA_8888, Unpremul, RGBA_8888, Premul)
+READPIX_BENCH(RGBA_8888, Unpremul, BGRA_8888, Premul)
+READPIX_BENCH(N32,       Premul,   Gray_8,    Opaque)
+READPIX_BENCH(Gray_8,    Opaque,   N32,       Premul)
+READPIX_BENCH(RGB_565,   Opaque,   N32,       Premul)
+READPIX_BENCH(ARGB_4444, Premul,   N32,       Premul)
+READPIX_BENCH(Index_8,   Premul,   N32,       Premul)
+READPIX_BENCH(N32,       Premul,   ARGB_4444, Premul)
+READPIX_BENCH(N32,       Premul,   RGB_565,   Opaque)
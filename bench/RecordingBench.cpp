@@ -8,12 +8,17 @@
 #include "RecordingBench.h"
 
 #include "SkBBHFactory.h"
+#include "SkBigPicture.h"
 #include "SkPictureRecorder.h"
+#include "SkRecord.h"
 
-RecordingBench::RecordingBench(const char* name, const SkPicture* pic, bool useBBH)
+RecordingBench::RecordingBench(const char* name, const SkPicture* pic, bool useBBH,
+                               bool reuseRecorder)
     : fSrc(SkRef(pic))
     , fName(name)
-    , fUseBBH(useBBH) {}
+    , fUseBBH(useBBH)
+    , fReuseRecorder(reuseRecorder)
+    , fMallocsPerRecording(0) {}
 
 const char* RecordingBench::onGetName() {
     return fName.c_str();
@@ -34,9 +39,17 @@ void RecordingBench::onDraw(int loops, SkCanvas*) {
                    h = fSrc->cullRect().height();
 
     uint32_t flags = SkPictureRecorder::kPlaybackDrawPicture_RecordFlag;
+    if (fReuseRecorder) {
+        flags |= SkPictureRecorder::kReuseRecordMemory_RecordFlag;
+    }
+    SkPictureRecorder reused;
     for (int i = 0; i < loops; i++) {
-        SkPictureRecorder recorder;
+        SkPictureRecorder fresh;
+        SkPictureRecorder& recorder = fReuseRecorder ? reused : fresh;
         fSrc->playback(recorder.beginRecording(w, h, fUseBBH ? &factory : nullptr, flags));
-        (void)recorder.finishRecordingAsPicture();
+        sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+        if (const SkBigPicture* big = picture->asSkBigPicture()) {
+            fMallocsPerRecording = big->record()->mallocCount();
+        }
     }
 }
@@ -13,7 +13,10 @@
 
 class RecordingBench : public Benchmark {
 public:
-    RecordingBench(const char* name, const SkPicture*, bool useBBH);
+    RecordingBench(const char* name, const SkPicture*, bool useBBH, bool reuseRecorder);
+
+    // How many times did the last recording malloc space for its ops?
+    int mallocsPerRecording() const { return fMallocsPerRecording; }
 
 protected:
     const char* onGetName() override;
@@ -25,6 +28,8 @@ private:
     SkAutoTUnref<const SkPicture> fSrc;
     SkString fName;
     bool fUseBBH;
+    bool fReuseRecorder;
+    int fMallocsPerRecording;
 
     typedef Benchmark INHERITED;
 };
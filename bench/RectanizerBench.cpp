@@ -24,6 +24,7 @@
  *      random rects (e.g., pull-save-layers forward use case)
  *      random power of two rects
  *      small constant sized power of 2 rects (e.g., glyph cache use case)
+ *      small random rects (e.g., glyphs of mixed sizes)
  */
 class RectanizerBench : public Benchmark {
 public:
@@ -38,7 +39,8 @@ public:
     enum RectType {
         kRand_RectType,
         kRandPow2_RectType,
-        kSmallPow2_RectType
+        kSmallPow2_RectType,
+        kSmallRand_RectType
     };
 
     RectanizerBench(RectanizerType rectanizerType, RectType rectType)
@@ -57,9 +59,11 @@ public:
             fName.append("rand");
         } else if (kRandPow2_RectType == fRectType) {
             fName.append("rand2");
-        } else {
-            SkASSERT(kSmallPow2_RectType == fRectType);
+        } else if (kSmallPow2_RectType == fRectType) {
             fName.append("sm2");
+        } else {
+            SkASSERT(kSmallRand_RectType == fRectType);
+            fName.append("smrand");
         }
     }
 
@@ -95,9 +99,11 @@ protected:
             } else if (kRandPow2_RectType == fRectType) {
                 size = SkISize::Make(GrNextPow2(rand.nextRangeU(1, kWidth / 2)),
                                      GrNextPow2(rand.nextRangeU(1, kHeight / 2)));
-            } else {
-                SkASSERT(kSmallPow2_RectType == fRectType);
+            } else if (kSmallPow2_RectType == fRectType) {
                 size = SkISize::Make(128, 128);
+            } else {
+                SkASSERT(kSmallRand_RectType == fRectType);
+                size = SkISize::Make(rand.nextRangeU(4, 40), rand.nextRangeU(8, 40));
             }
 
             if (!fRectanizer->addRect(size.fWidth, size.fHeight, &loc)) {
@@ -134,5 +140,9 @@ DEF_BENCH(return new RectanizerBench(RectanizerBench::kSkyline_RectanizerType,
                                      RectanizerBench::kRandPow2_RectType);)
 DEF_BENCH(return new RectanizerBench(RectanizerBench::kSkyline_RectanizerType,
                                      RectanizerBench::kSmallPow2_RectType);)
+DEF_BENCH(return new RectanizerBench(RectanizerBench::kPow2_RectanizerType,
+                                     RectanizerBench::kSmallRand_RectType);)
+DEF_BENCH(return new RectanizerBench(RectanizerBench::kSkyline_RectanizerType,
+                                     RectanizerBench::kSmallRand_RectType);)
 
 #endif
@@ -34,6 +34,13 @@ static bool diffrectbig_proc(SkRegion& a, SkRegion& b) {
     return result.op(a, a.getBounds(), SkRegion::kDifference_Op);
 }
 
+static bool sectrect_proc(SkRegion& a, SkRegion& b) {
+    SkIRect r = b.getBounds();
+    r.inset(r.width()/4, r.height()/4);
+    SkRegion result;
+    return result.op(a, r, SkRegion::kIntersect_Op);
+}
+
 static bool containsrect_proc(SkRegion& a, SkRegion& b) {
     SkIRect r = a.getBounds();
     r.inset(r.width()/4, r.height()/4);
@@ -116,6 +123,58 @@ private:
     typedef Benchmark INHERITED;
 };
 
+// Like RegionBench, but keeps writing into the same result, so the ops can reuse its runs.
+class RegionReuseBench : public Benchmark {
+public:
+    RegionReuseBench(int count, SkRegion::Op op, bool useRect, const char name[])
+        : fOp(op)
+        , fUseRect(useRect) {
+        fName.printf("region_reuse_%s_%d", name, count);
+
+        SkRandom rand;
+        for (int i = 0; i < count; i++) {
+            fA.op(RandRect(rand), SkRegion::kXOR_Op);
+            fB.op(RandRect(rand), SkRegion::kXOR_Op);
+        }
+        fRect = fB.getBounds();
+        fRect.inset(fRect.width()/4, fRect.height()/4);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        for (int i = 0; i < loops; ++i) {
+            if (fUseRect) {
+                fResult.op(fA, fRect, fOp);
+            } else {
+                fResult.op(fA, fB, fOp);
+            }
+        }
+    }
+
+private:
+    static SkIRect RandRect(SkRandom& rand) {
+        int x = rand.nextU() % RegionBench::W;
+        int y = rand.nextU() % RegionBench::H;
+        int w = rand.nextU() % RegionBench::W;
+        int h = rand.nextU() % RegionBench::H;
+        return SkIRect::MakeXYWH(x, y, w >> 1, h >> 1);
+    }
+
+    SkRegion     fA, fB, fResult;
+    SkIRect      fRect;
+    SkRegion::Op fOp;
+    bool         fUseRect;
+    SkString     fName;
+
+    typedef Benchmark INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #define SMALL   16
@@ -125,7 +184,11 @@ DEF_BENCH(return new RegionBench(SMALL, sect_proc, "intersect");)
 DEF_BENCH(return new RegionBench(SMALL, diff_proc, "difference");)
 DEF_BENCH(return new RegionBench(SMALL, diffrect_proc, "differencerect");)
 DEF_BENCH(return new RegionBench(SMALL, diffrectbig_proc, "differencerectbig");)
+DEF_BENCH(return new RegionBench(SMALL, sectrect_proc, "intersectrect");)
 DEF_BENCH(return new RegionBench(SMALL, containsrect_proc, "containsrect");)
 DEF_BENCH(return new RegionBench(SMALL, sectsrgn_proc, "intersectsrgn");)
 DEF_BENCH(return new RegionBench(SMALL, sectsrect_proc, "intersectsrect");)
 DEF_BENCH(return new RegionBench(SMALL, containsxy_proc, "containsxy");)
+
+DEF_BENCH(return new RegionReuseBench(SMALL, SkRegion::kUnion_Op, false, "union");)
+DEF_BENCH(return new RegionReuseBench(SMALL, SkRegion::kIntersect_Op, true, "intersectrect");)
@@ -158,10 +158,19 @@ void SKPBench::drawPicture() {
 }
 
 #if SK_SUPPORT_GPU
+#include "GrAuditTrail.h"
+#include "GrCaps.h"
 #include "GrGpu.h"
 static void draw_pic_for_stats(SkCanvas* canvas, GrContext* context, const SkPicture* picture,
                                SkTArray<SkString>* keys, SkTArray<double>* values,
                                const char* tag) {
+    // Time each batch on the GPU too, if we can, to see which ones GPU-bound frames wait on.
+    GrAuditTrail* auditTrail = context->getAuditTrail();
+    bool timeBatches = context->caps()->timerQuerySupport() && !auditTrail->isEnabled();
+    if (timeBatches) {
+        auditTrail->setEnabled(true);
+    }
+
     context->resetGpuStats();
     canvas->drawPicture(picture);
     canvas->flush();
@@ -170,6 +179,16 @@ static void draw_pic_for_stats(SkCanvas* canvas, GrContext* context, const SkPic
     context->dumpGpuStatsKeyValuePairs(keys, values);
     context->dumpCacheStatsKeyValuePairs(keys, values);
 
+    if (timeBatches) {
+        context->collectBatchGpuTimes();
+        for (const GrAuditTrail::BatchGpuTime& time : auditTrail->batchGpuTimes()) {
+            keys->push_back().printf("gpu_ns_%s", time.fName.c_str());
+            values->push_back((double)time.fNanoseconds);
+        }
+        auditTrail->fullReset();
+        auditTrail->setEnabled(false);
+    }
+
     // append tag, but only to new tags
     for (int i = offset; i < keys->count(); i++, offset++) {
         (*keys)[i].appendf("_%s", tag);
@@ -118,8 +118,10 @@ struct SkBitmapFPGeneral final : public CommonBitmapFPBenchmark {
         SkMatrix m,
         bool useBilerp,
         SkShader::TileMode xTile,
-        SkShader::TileMode yTile)
-            : CommonBitmapFPBenchmark(srcSize, isSRGB, m, useBilerp, xTile, yTile) { }
+        SkShader::TileMode yTile,
+        bool allowFusedStages = true)
+            : CommonBitmapFPBenchmark(srcSize, isSRGB, m, useBilerp, xTile, yTile)
+            , fAllowFusedStages{allowFusedStages} { }
 
     SkString BaseName() override {
         SkString name;
@@ -128,6 +130,9 @@ struct SkBitmapFPGeneral final : public CommonBitmapFPBenchmark {
         } else {
             name.set("Linr");
         }
+        if (!fAllowFusedStages) {
+            name.append("Unfused");
+        }
         return name;
     }
 
@@ -147,7 +152,7 @@ struct SkBitmapFPGeneral final : public CommonBitmapFPBenchmark {
         SkPixmap srcPixmap{fInfo, fBitmap.get(), static_cast<size_t>(4 * width)};
 
         SkLinearBitmapPipeline pipeline{
-            fInvert, filterQuality, fXTile, fYTile, SK_ColorBLACK, srcPixmap};
+            fInvert, filterQuality, fXTile, fYTile, SK_ColorBLACK, srcPixmap, fAllowFusedStages};
 
         int count = 100;
 
@@ -155,6 +160,8 @@ struct SkBitmapFPGeneral final : public CommonBitmapFPBenchmark {
             pipeline.shadeSpan4f(3, 6, FPbuffer, count);
         }
     }
+
+    bool fAllowFusedStages;
 };
 
 struct SkBitmapFPOrigShader : public CommonBitmapFPBenchmark {
@@ -291,6 +298,58 @@ DEF_BENCH(return new SkBitmapFPOrigShader(
     srcSize, gLinearRGB, mS, true,
     SkShader::kRepeat_TileMode, SkShader::kRepeat_TileMode);)
 
+static SkMatrix mT = SkMatrix::MakeTrans(-7.75f, 3.25f);
+DEF_BENCH(return new SkBitmapFPGeneral(
+    srcSize, gSRGB, mT, false,
+    SkShader::kClamp_TileMode, SkShader::kClamp_TileMode);)
+
+DEF_BENCH(return new SkBitmapFPGeneral(
+    srcSize, gLinearRGB, mT, false,
+    SkShader::kClamp_TileMode, SkShader::kClamp_TileMode);)
+
+DEF_BENCH(return new SkBitmapFPGeneral(
+    srcSize, gSRGB, mT, true,
+    SkShader::kClamp_TileMode, SkShader::kClamp_TileMode);)
+
+DEF_BENCH(return new SkBitmapFPGeneral(
+    srcSize, gLinearRGB, mT, true,
+    SkShader::kClamp_TileMode, SkShader::kClamp_TileMode);)
+
+// The translate and scale pipelines above are fused; these build the same pipelines from the
+// general stages so we can see what fusing buys.
+const bool gUnfused = false;
+DEF_BENCH(return new SkBitmapFPGeneral(
+    srcSize, gSRGB, mT, false,
+    SkShader::kClamp_TileMode, SkShader::kClamp_TileMode, gUnfused);)
+
+DEF_BENCH(return new SkBitmapFPGeneral(
+    srcSize, gSRGB, mT, true,
+    SkShader::kClamp_TileMode, SkShader::kClamp_TileMode, gUnfused);)
+
+DEF_BENCH(return new SkBitmapFPGeneral(
+    srcSize, gSRGB, mS, false,
+    SkShader::kClamp_TileMode, SkShader::kClamp_TileMode, gUnfused);)
+
+DEF_BENCH(return new SkBitmapFPGeneral(
+    srcSize, gSRGB, mS, true,
+    SkShader::kClamp_TileMode, SkShader::kClamp_TileMode, gUnfused);)
+
+DEF_BENCH(return new SkBitmapFPGeneral(
+    srcSize, gSRGB, mS, false,
+    SkShader::kRepeat_TileMode, SkShader::kRepeat_TileMode, gUnfused);)
+
+DEF_BENCH(return new SkBitmapFPGeneral(
+    srcSize, gSRGB, mS, true,
+    SkShader::kRepeat_TileMode, SkShader::kRepeat_TileMode, gUnfused);)
+
+DEF_BENCH(return new SkBitmapFPGeneral(
+    srcSize, gLinearRGB, mS, false,
+    SkShader::kClamp_TileMode, SkShader::kClamp_TileMode, gUnfused);)
+
+DEF_BENCH(return new SkBitmapFPGeneral(
+    srcSize, gLinearRGB, mS, true,
+    SkShader::kClamp_TileMode, SkShader::kClamp_TileMode, gUnfused);)
+
 static SkMatrix rotate(SkScalar r) {
     SkMatrix m;
     m.setRotate(30);
@@ -8,12 +8,13 @@
 #include "Benchmark.h"
 #include "SkRasterPipeline.h"
 #include "SkSRGB.h"
+#include "SkString.h"
 
-static const int N = 1023;
+static const int kPixels = 1023;
 
-static uint32_t dst[N],
-                src[N];
-static uint8_t mask[N];
+static uint32_t dst[kPixels],
+                src[kPixels];
+static uint8_t mask[kPixels];
 
 // We'll build up a somewhat realistic useful pipeline:
 //   - load srgb src
@@ -22,89 +23,72 @@ static uint8_t mask[N];
 //   - src = srcover(dst, src)
 //   - store src back as srgb
 // Every stage except for srcover interacts with memory, and so will need _tail variants.
+//
+// Each stage is written once for any pipeline width N, so we can compare SkRasterPipeline
+// (4 pixels per call) against the 8-wide SkRasterPipelineN<8>.
+
+#define STAGE(name)                                                                             \
+    template <int N>                                                                            \
+    static void SK_VECTORCALL name(typename SkRasterPipelineN<N>::Stage* st, size_t x,          \
+                                   SkNx<N,float>  r, SkNx<N,float>  g,                          \
+                                   SkNx<N,float>  b, SkNx<N,float>  a,                          \
+                                   SkNx<N,float> dr, SkNx<N,float> dg,                          \
+                                   SkNx<N,float> db, SkNx<N,float> da)
+
+static Sk4f to_srgb(const Sk4f& x) { return sk_linear_to_srgb(x); }
+static Sk8f to_srgb(const Sk8f& x) { return { sk_linear_to_srgb(x.fLo), sk_linear_to_srgb(x.fHi) }; }
+
+template <int N>
+static void from_srgb(const uint32_t* ptr, SkNx<N,float>* r, SkNx<N,float>* g,
+                                           SkNx<N,float>* b, SkNx<N,float>* a) {
+    float R[N], G[N], B[N];
+    for (int i = 0; i < N; i++) {
+        R[i] = sk_linear_from_srgb[(ptr[i] >>  0) & 0xff];
+        G[i] = sk_linear_from_srgb[(ptr[i] >>  8) & 0xff];
+        B[i] = sk_linear_from_srgb[(ptr[i] >> 16) & 0xff];
+    }
+    *r = SkNx<N,float>::Load(R);
+    *g = SkNx<N,float>::Load(G);
+    *b = SkNx<N,float>::Load(B);
+    *a = SkNx_cast<float>((SkNx<N,int>::Load(ptr) >> 24) & 0xff) * (1/255.0f);
+}
 
-static void SK_VECTORCALL load_s_srgb(SkRasterPipeline::Stage* st, size_t x,
-                                      Sk4f  r, Sk4f  g, Sk4f  b, Sk4f  a,
-                                      Sk4f dr, Sk4f dg, Sk4f db, Sk4f da) {
-    auto ptr = st->ctx<const uint32_t*>() + x;
-
-    r = Sk4f{ sk_linear_from_srgb[(ptr[0] >>  0) & 0xff],
-              sk_linear_from_srgb[(ptr[1] >>  0) & 0xff],
-              sk_linear_from_srgb[(ptr[2] >>  0) & 0xff],
-              sk_linear_from_srgb[(ptr[3] >>  0) & 0xff] };
-
-    g = Sk4f{ sk_linear_from_srgb[(ptr[0] >>  8) & 0xff],
-              sk_linear_from_srgb[(ptr[1] >>  8) & 0xff],
-              sk_linear_from_srgb[(ptr[2] >>  8) & 0xff],
-              sk_linear_from_srgb[(ptr[3] >>  8) & 0xff] };
-
-    b = Sk4f{ sk_linear_from_srgb[(ptr[0] >> 16) & 0xff],
-              sk_linear_from_srgb[(ptr[1] >> 16) & 0xff],
-              sk_linear_from_srgb[(ptr[2] >> 16) & 0xff],
-              sk_linear_from_srgb[(ptr[3] >> 16) & 0xff] };
-
-    a = SkNx_cast<float>((Sk4i::Load(ptr) >> 24) & 0xff) * (1/255.0f);
-
+STAGE(load_s_srgb) {
+    from_srgb<N>(st->template ctx<const uint32_t*>() + x, &r,&g,&b,&a);
     st->next(x, r,g,b,a, dr,dg,db,da);
 }
 
-static void SK_VECTORCALL load_s_srgb_tail(SkRasterPipeline::Stage* st, size_t x,
-                                           Sk4f  r, Sk4f  g, Sk4f  b, Sk4f  a,
-                                           Sk4f dr, Sk4f dg, Sk4f db, Sk4f da) {
-    auto ptr = st->ctx<const uint32_t*>() + x;
+STAGE(load_s_srgb_tail) {
+    auto ptr = st->template ctx<const uint32_t*>() + x;
 
-    r = Sk4f{ sk_linear_from_srgb[(*ptr >>  0) & 0xff], 0,0,0 };
-    g = Sk4f{ sk_linear_from_srgb[(*ptr >>  8) & 0xff], 0,0,0 };
-    b = Sk4f{ sk_linear_from_srgb[(*ptr >> 16) & 0xff], 0,0,0 };
-    a = Sk4f{                (*ptr >> 24) * (1/255.0f), 0,0,0 };
+    r = sk_linear_from_srgb[(*ptr >>  0) & 0xff];
+    g = sk_linear_from_srgb[(*ptr >>  8) & 0xff];
+    b = sk_linear_from_srgb[(*ptr >> 16) & 0xff];
+    a =                (*ptr >> 24) * (1/255.0f);
 
     st->next(x, r,g,b,a, dr,dg,db,da);
 }
 
-static void SK_VECTORCALL load_d_srgb(SkRasterPipeline::Stage* st, size_t x,
-                                      Sk4f  r, Sk4f  g, Sk4f  b, Sk4f  a,
-                                      Sk4f dr, Sk4f dg, Sk4f db, Sk4f da) {
-    auto ptr = st->ctx<const uint32_t*>() + x;
-
-    dr = Sk4f{ sk_linear_from_srgb[(ptr[0] >>  0) & 0xff],
-               sk_linear_from_srgb[(ptr[1] >>  0) & 0xff],
-               sk_linear_from_srgb[(ptr[2] >>  0) & 0xff],
-               sk_linear_from_srgb[(ptr[3] >>  0) & 0xff] };
-
-    dg = Sk4f{ sk_linear_from_srgb[(ptr[0] >>  8) & 0xff],
-               sk_linear_from_srgb[(ptr[1] >>  8) & 0xff],
-               sk_linear_from_srgb[(ptr[2] >>  8) & 0xff],
-               sk_linear_from_srgb[(ptr[3] >>  8) & 0xff] };
-
-    db = Sk4f{ sk_linear_from_srgb[(ptr[0] >> 16) & 0xff],
-               sk_linear_from_srgb[(ptr[1] >> 16) & 0xff],
-               sk_linear_from_srgb[(ptr[2] >> 16) & 0xff],
-               sk_linear_from_srgb[(ptr[3] >> 16) & 0xff] };
-
-    da = SkNx_cast<float>((Sk4i::Load(ptr) >> 24) & 0xff) * (1/255.0f);
-
+STAGE(load_d_srgb) {
+    from_srgb<N>(st->template ctx<const uint32_t*>() + x, &dr,&dg,&db,&da);
     st->next(x, r,g,b,a, dr,dg,db,da);
 }
 
-static void SK_VECTORCALL load_d_srgb_tail(SkRasterPipeline::Stage* st, size_t x,
-                                           Sk4f  r, Sk4f  g, Sk4f  b, Sk4f  a,
-                                           Sk4f dr, Sk4f dg, Sk4f db, Sk4f da) {
-    auto ptr = st->ctx<const uint32_t*>() + x;
+STAGE(load_d_srgb_tail) {
+    auto ptr = st->template ctx<const uint32_t*>() + x;
 
-    dr = Sk4f{ sk_linear_from_srgb[(*ptr >>  0) & 0xff], 0,0,0 };
-    dg = Sk4f{ sk_linear_from_srgb[(*ptr >>  8) & 0xff], 0,0,0 };
-    db = Sk4f{ sk_linear_from_srgb[(*ptr >> 16) & 0xff], 0,0,0 };
-    da = Sk4f{                (*ptr >> 24) * (1/255.0f), 0,0,0 };
+    dr = sk_linear_from_srgb[(*ptr >>  0) & 0xff];
+    dg = sk_linear_from_srgb[(*ptr >>  8) & 0xff];
+    db = sk_linear_from_srgb[(*ptr >> 16) & 0xff];
+    da =                (*ptr >> 24) * (1/255.0f);
 
     st->next(x, r,g,b,a, dr,dg,db,da);
 }
 
-static void SK_VECTORCALL scale_u8(SkRasterPipeline::Stage* st, size_t x,
-                                   Sk4f  r, Sk4f  g, Sk4f  b, Sk4f  a,
-                                   Sk4f dr, Sk4f dg, Sk4f db, Sk4f da) {
-    auto ptr = st->ctx<const uint8_t*>() + x;
+STAGE(scale_u8) {
+    auto ptr = st->template ctx<const uint8_t*>() + x;
 
-    auto c = SkNx_cast<float>(Sk4b::Load(ptr)) * (1/255.0f);
+    auto c = SkNx_cast<float>(SkNx<N,uint8_t>::Load(ptr)) * (1/255.0f);
     r *= c;
     g *= c;
     b *= c;
@@ -113,10 +97,8 @@ static void SK_VECTORCALL scale_u8(SkRasterPipeline::Stage* st, size_t x,
     st->next(x, r,g,b,a, dr,dg,db,da);
 }
 
-static void SK_VECTORCALL scale_u8_tail(SkRasterPipeline::Stage* st, size_t x,
-                                        Sk4f  r, Sk4f  g, Sk4f  b, Sk4f  a,
-                                        Sk4f dr, Sk4f dg, Sk4f db, Sk4f da) {
-    auto ptr = st->ctx<const uint8_t*>() + x;
+STAGE(scale_u8_tail) {
+    auto ptr = st->template ctx<const uint8_t*>() + x;
 
     auto c = *ptr * (1/255.0f);
     r *= c;
@@ -127,9 +109,7 @@ static void SK_VECTORCALL scale_u8_tail(SkRasterPipeline::Stage* st, size_t x,
     st->next(x, r,g,b,a, dr,dg,db,da);
 }
 
-static void SK_VECTORCALL srcover(SkRasterPipeline::Stage* st, size_t x,
-                                  Sk4f  r, Sk4f  g, Sk4f  b, Sk4f  a,
-                                  Sk4f dr, Sk4f dg, Sk4f db, Sk4f da) {
+STAGE(srcover) {
     auto A = 1.0f - a;
     r += dr * A;
     g += dg * A;
@@ -139,19 +119,18 @@ static void SK_VECTORCALL srcover(SkRasterPipeline::Stage* st, size_t x,
     st->next(x, r,g,b,a, dr,dg,db,da);
 }
 
-static Sk4f clamp(const Sk4f& x) {
-    return Sk4f::Min(Sk4f::Max(x, 0.0f), 255.0f);
+template <int N>
+static SkNx<N,float> clamp(const SkNx<N,float>& x) {
+    return SkNx<N,float>::Min(SkNx<N,float>::Max(x, 0.0f), 255.0f);
 }
 
-static void SK_VECTORCALL store_srgb(SkRasterPipeline::Stage* st, size_t x,
-                                     Sk4f  r, Sk4f  g, Sk4f  b, Sk4f  a,
-                                     Sk4f dr, Sk4f dg, Sk4f db, Sk4f da) {
-    auto ptr = st->ctx<uint32_t*>() + x;
+STAGE(store_srgb) {
+    auto ptr = st->template ctx<uint32_t*>() + x;
 
-    r = clamp(sk_linear_to_srgb(r));
-    g = clamp(sk_linear_to_srgb(g));
-    b = clamp(sk_linear_to_srgb(b));
-    a = clamp(         255.0f * a );
+    r = clamp(to_srgb(r));
+    g = clamp(to_srgb(g));
+    b = clamp(to_srgb(b));
+    a = clamp(  255.0f * a );
 
     ( SkNx_cast<int>(r)
     | SkNx_cast<int>(g) << 8
@@ -159,10 +138,8 @@ static void SK_VECTORCALL store_srgb(SkRasterPipeline::Stage* st, size_t x,
     | SkNx_cast<int>(a) << 24 ).store(ptr);
 }
 
-static void SK_VECTORCALL store_srgb_tail(SkRasterPipeline::Stage* st, size_t x,
-                                          Sk4f  r, Sk4f  g, Sk4f  b, Sk4f  a,
-                                          Sk4f dr, Sk4f dg, Sk4f db, Sk4f da) {
-    auto ptr = st->ctx<uint32_t*>() + x;
+STAGE(store_srgb_tail) {
+    auto ptr = st->template ctx<uint32_t*>() + x;
 
     auto rgba = sk_linear_to_srgb({r[0], g[0], b[0], 0});
     rgba = {rgba[0], rgba[1], rgba[2], 255.0f*a[0]};
@@ -171,25 +148,74 @@ static void SK_VECTORCALL store_srgb_tail(SkRasterPipeline::Stage* st, size_t x,
     SkNx_cast<uint8_t>(rgba).store(ptr);
 }
 
+template <int N>
 class SkRasterPipelineBench : public Benchmark {
 public:
-    SkRasterPipelineBench() {}
+    SkRasterPipelineBench() { fName.printf("SkRasterPipeline_%d", N); }
 
     bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
-    const char* onGetName() override { return "SkRasterPipelineBench"; }
+    const char* onGetName() override { return fName.c_str(); }
 
     void onDraw(int loops, SkCanvas*) override {
-        SkRasterPipeline p;
-        p.append(load_s_srgb, load_s_srgb_tail,  src);
-        p.append(   scale_u8,    scale_u8_tail, mask);
-        p.append(load_d_srgb, load_d_srgb_tail,  dst);
-        p.append(srcover);
-        p.append( store_srgb,  store_srgb_tail,  dst);
+        SkRasterPipelineN<N> p;
+        p.append(load_s_srgb<N>, load_s_srgb_tail<N>,  src);
+        p.append(   scale_u8<N>,    scale_u8_tail<N>, mask);
+        p.append(load_d_srgb<N>, load_d_srgb_tail<N>,  dst);
+        p.append(srcover<N>);
+        p.append( store_srgb<N>,  store_srgb_tail<N>,  dst);
 
         while (loops --> 0) {
-            p.run(N);
+            p.run(kPixels);
         }
     }
+
+private:
+    SkString fName;
+};
+
+DEF_BENCH( return new SkRasterPipelineBench<4>; )
+DEF_BENCH( return new SkRasterPipelineBench<8>; )
+
+// The same pipeline again, built from SkRasterPipeline's stock stages.  It ends with the
+// load_d_srgb -> srcover -> store_srgb chain, which run() fuses into one stage unless we
+// tack a no-op stage on the end.  Where the CPU has AVX, the 8-wide pipeline of only stock
+// stages runs through SkOpts::compile_pipeline_8() instead; the no-op keeps it off that path too.
+STAGE(noop) {
+    st->next(x, r,g,b,a, dr,dg,db,da);
+}
+
+template <int N>
+class SkRasterPipelineStockBench : public Benchmark {
+public:
+    SkRasterPipelineStockBench(bool fused) : fFused(fused) {
+        fName.printf("SkRasterPipeline_stock_%s_%d", fused ? "fused" : "chained", N);
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkRasterPipelineN<N> p;
+        p.append(SkRasterPipeline::load_s_srgb,  src);
+        p.append(SkRasterPipeline::scale_u8,    mask);
+        p.append(SkRasterPipeline::load_d_srgb,  dst);
+        p.append(SkRasterPipeline::srcover);
+        p.append(SkRasterPipeline::store_srgb,   dst);
+        if (!fFused) {
+            p.append(noop<N>);
+        }
+
+        while (loops --> 0) {
+            p.run(kPixels);
+        }
+    }
+
+private:
+    SkString fName;
+    bool     fFused;
 };
 
-DEF_BENCH( return new SkRasterPipelineBench; )
+DEF_BENCH( return new SkRasterPipelineStockBench<4>(true);  )
+DEF_BENCH( return new SkRasterPipelineStockBench<4>(false); )
+DEF_BENCH( return new SkRasterPipelineStockBench<8>(true);  )
+DEF_BENCH( return new SkRasterPipelineStockBench<8>(false); )
@@ -7,30 +7,32 @@
 
 #include "Benchmark.h"
 #include "SkCanvas.h"
+#include "SkGradientShader.h"
 #include "SkPaint.h"
 #include "SkRandom.h"
 #include "SkShader.h"
 #include "SkString.h"
+#include "SkTDArray.h"
 
 enum VertFlags {
-    kColors_VertFlag,
-    kTexture_VertFlag,
+    kColors_VertFlag  = 1 << 0,
+    kTexture_VertFlag = 1 << 1,
 };
 
+// Draws a W x H grid of ROW x COL cells, two triangles each, with random colors and/or a texture.
 class VertBench : public Benchmark {
     SkString fName;
     enum {
         W = 640,
         H = 480,
-        ROW = 20,
-        COL = 20,
-        PTS = (ROW + 1) * (COL + 1),
-        IDX = ROW * COL * 6,
     };
 
-    SkPoint fPts[PTS];
-    SkColor fColors[PTS];
-    uint16_t fIdx[IDX];
+    int fRows, fCols, fFlags;
+    SkTDArray<SkPoint>  fPts;
+    SkTDArray<SkPoint>  fTexs;
+    SkTDArray<SkColor>  fColors;
+    SkTDArray<uint16_t> fIdx;
+    sk_sp<SkShader>     fShader;
 
     static void load_2_tris(uint16_t idx[], int x, int y, int rb) {
         int n = y * rb + x;
@@ -39,51 +41,60 @@ class VertBench : public Benchmark {
     }
 
 public:
-    VertBench() {
-        const SkScalar dx = SkIntToScalar(W) / COL;
-        const SkScalar dy = SkIntToScalar(H) / COL;
+    VertBench(int flags = kColors_VertFlag, int rows = 20, int cols = 20)
+        : fRows(rows), fCols(cols), fFlags(flags) {
+        // Indices are 16 bit.
+        SkASSERT((rows + 1) * (cols + 1) <= 65536);
 
-        SkPoint* pts = fPts;
-        uint16_t* idx = fIdx;
+        fName.set("verts");
+        if (flags & kColors_VertFlag) {
+            fName.append(flags & kTexture_VertFlag ? "_colors" : "");
+        }
+        if (flags & kTexture_VertFlag) {
+            fName.append("_texture");
+        }
+        if (rows != 20 || cols != 20) {
+            fName.appendf("_%dx%d", cols, rows);
+        }
+    }
+
+protected:
+    void onDelayedSetup() override {
+        const SkScalar dx = SkIntToScalar(W) / fCols;
+        const SkScalar dy = SkIntToScalar(H) / fRows;
 
-        SkScalar yy = 0;
-        for (int y = 0; y <= ROW; y++) {
-            SkScalar xx = 0;
-            for (int x = 0; x <= COL; ++x) {
-                pts->set(xx, yy);
-                pts += 1;
-                xx += dx;
+        SkRandom rand;
+        for (int y = 0; y <= fRows; y++) {
+            for (int x = 0; x <= fCols; ++x) {
+                fPts.append()->set(x * dx, y * dy);
+                fTexs.append()->set(x * 64.0f / fCols, y * 64.0f / fRows);
+                *fColors.append() = rand.nextU() | (0xFF << 24);
 
-                if (x < COL && y < ROW) {
-                    load_2_tris(idx, x, y, COL + 1);
-                    for (int i = 0; i < 6; i++) {
-                        SkASSERT(idx[i] < PTS);
-                    }
-                    idx += 6;
+                if (x < fCols && y < fRows) {
+                    load_2_tris(fIdx.append(6), x, y, fCols + 1);
                 }
             }
-            yy += dy;
-        }
-        SkASSERT(PTS == pts - fPts);
-        SkASSERT(IDX == idx - fIdx);
-
-        SkRandom rand;
-        for (int i = 0; i < PTS; ++i) {
-            fColors[i] = rand.nextU() | (0xFF << 24);
         }
 
-        fName.set("verts");
+        const SkColor colors[] = { SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE };
+        const SkPoint pts[] = { { 0, 0 }, { 64, 64 } };
+        fShader = SkGradientShader::MakeLinear(pts, colors, nullptr, 3,
+                                               SkShader::kMirror_TileMode);
     }
 
-protected:
-    virtual const char* onGetName() { return fName.c_str(); }
-    virtual void onDraw(int loops, SkCanvas* canvas) {
+    const char* onGetName() override { return fName.c_str(); }
+    void onDraw(int loops, SkCanvas* canvas) override {
         SkPaint paint;
         this->setupPaint(&paint);
+        if (fFlags & kTexture_VertFlag) {
+            paint.setShader(fShader);
+        }
+        const SkPoint* texs   = (fFlags & kTexture_VertFlag) ? fTexs.begin()   : nullptr;
+        const SkColor* colors = (fFlags & kColors_VertFlag)  ? fColors.begin() : nullptr;
 
         for (int i = 0; i < loops; i++) {
-            canvas->drawVertices(SkCanvas::kTriangles_VertexMode, PTS,
-                                 fPts, nullptr, fColors, nullptr, fIdx, IDX, paint);
+            canvas->drawVertices(SkCanvas::kTriangles_VertexMode, fPts.count(), fPts.begin(),
+                                 texs, colors, nullptr, fIdx.begin(), fIdx.count(), paint);
         }
     }
 private:
@@ -93,3 +104,8 @@ private:
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH(return new VertBench();)
+DEF_BENCH(return new VertBench(kTexture_VertFlag);)
+DEF_BENCH(return new VertBench(kColors_VertFlag | kTexture_VertFlag);)
+// 50k triangles, most only a few pixels across.
+DEF_BENCH(return new VertBench(kColors_VertFlag, 125, 200);)
+DEF_BENCH(return new VertBench(kTexture_VertFlag, 125, 200);)
@@ -7,6 +7,7 @@
 
 #include "Benchmark.h"
 #include "SkPM4f.h"
+#include "SkRandom.h"
 #include "SkString.h"
 #include "SkXfermode.h"
 
@@ -102,3 +103,74 @@ DEF_BENCH( return new XferD32Bench(SkXfermode::kSrcOver_Mode, "srcover", true,
 DEF_BENCH( return new XferD32Bench(SkXfermode::kSrcOver_Mode, "srcover", true,  F00 | USE_AA); )
 DEF_BENCH( return new XferD32Bench(SkXfermode::kSrcOver_Mode, "srcover", true,  F11 | USE_AA); )
 DEF_BENCH( return new XferD32Bench(SkXfermode::kSrcOver_Mode, "srcover", true,  F01 | USE_AA); )
+
+// Modes other than clear, src, dst and srcover all share one 4-pixels-at-a-time proc.
+#define MODE_BENCHES(mode, name)                                                  \
+    DEF_BENCH( return new XferD32Bench(mode, name, true,  F00 | USE_AA); )        \
+    DEF_BENCH( return new XferD32Bench(mode, name, true,  F10 | USE_AA); )        \
+    DEF_BENCH( return new XferD32Bench(mode, name, false, F00 | USE_AA); )        \
+    DEF_BENCH( return new XferD32Bench(mode, name, false, F10 | USE_AA); )
+
+MODE_BENCHES(SkXfermode::kMultiply_Mode,   "multiply")
+MODE_BENCHES(SkXfermode::kOverlay_Mode,    "overlay")
+MODE_BENCHES(SkXfermode::kColorDodge_Mode, "colordodge")
+MODE_BENCHES(SkXfermode::kHue_Mode,        "hue")
+MODE_BENCHES(SkXfermode::kLuminosity_Mode, "luminosity")
+
+// Benchmark that blends a single color through an LCD16 mask, shaped roughly like text: mostly
+// uncovered, some fully covered, and the rest edges.
+class XferLCD32Bench : public Benchmark {
+public:
+    XferLCD32Bench(uint32_t flags) : fFlags(flags) {
+        fProc = SkXfermode::GetLCD32Proc(flags | SkXfermode::kSrcIsSingle_LCDFlag);
+        fName.printf("xfer4f_lcd_%s_%s_%s",
+                     (flags & SkXfermode::kSrcIsOpaque_LCDFlag) ? "src" : "srcover",
+                     (flags & SkXfermode::kSrcIsOpaque_LCDFlag) ? "opaque" : "alpha",
+                     (flags & SkXfermode::kDstIsSRGB_LCDFlag) ? "srgb" : "linear");
+
+        fSrc = SkColor4f::FromColor((flags & SkXfermode::kSrcIsOpaque_LCDFlag) ? 0xFF204080
+                                                                                : 0x80204080)
+               .premul();
+        SkRandom rand;
+        int kind = 0;
+        for (int i = 0; i < N; ++i) {
+            fDst[i] = 0xFFFFFFFF;
+            // Pick uncovered (3/5), covered (1/5) or edges (1/5) for each run of 8 pixels.
+            if (i % 8 == 0) {
+                kind = rand.nextULessThan(5);
+            }
+            fLCD[i] = kind < 3 ? 0 : kind == 3 ? 0xFFFF : rand.nextU() & 0xFFFF;
+        }
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops * INNER_LOOPS; ++i) {
+            fProc(fDst, &fSrc, N, fLCD);
+        }
+    }
+
+private:
+    SkString             fName;
+    SkXfermode::LCD32Proc fProc;
+    uint32_t             fFlags;
+
+    enum {
+        N = 1000,
+    };
+    SkPM4f      fSrc;
+    SkPMColor   fDst[N];
+    uint16_t    fLCD[N];
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new XferLCD32Bench(0); )
+DEF_BENCH( return new XferLCD32Bench(SkXfermode::kSrcIsOpaque_LCDFlag); )
+DEF_BENCH( return new XferLCD32Bench(SkXfermode::kDstIsSRGB_LCDFlag); )
+DEF_BENCH( return new XferLCD32Bench(SkXfermode::kSrcIsOpaque_LCDFlag |
+                                     SkXfermode::kDstIsSRGB_LCDFlag); )
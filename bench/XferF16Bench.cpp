@@ -93,3 +93,14 @@ DEF_BENCH( return new XferF16Bench(MODE, NAME, false, F00 | USE_AA); )
 DEF_BENCH( return new XferF16Bench(MODE, NAME, false, F01 | USE_AA); )
 DEF_BENCH( return new XferF16Bench(MODE, NAME, false, F00); )
 DEF_BENCH( return new XferF16Bench(MODE, NAME, false, F01); )
+
+// Modes other than clear, src, dst and srcover all share one 4-pixels-at-a-time proc.
+#define MODE_BENCHES(mode, name)                                          \
+    DEF_BENCH( return new XferF16Bench(mode, name, true,  F00 | USE_AA); ) \
+    DEF_BENCH( return new XferF16Bench(mode, name, false, F00 | USE_AA); )
+
+MODE_BENCHES(SkXfermode::kMultiply_Mode,   "multiply")
+MODE_BENCHES(SkXfermode::kOverlay_Mode,    "overlay")
+MODE_BENCHES(SkXfermode::kColorDodge_Mode, "colordodge")
+MODE_BENCHES(SkXfermode::kHue_Mode,        "hue")
+MODE_BENCHES(SkXfermode::kLuminosity_Mode, "luminosity")
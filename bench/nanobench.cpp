@@ -17,6 +17,7 @@
 #include "ColorCodecBench.h"
 #include "CrashHandler.h"
 #include "GMBench.h"
+#include "PerfCounters.h"
 #include "ProcStats.h"
 #include "ResultsWriter.h"
 #include "RecordingBench.h"
@@ -35,11 +36,14 @@
 #include "SkForceLinking.h"
 #include "SkGraphics.h"
 #include "SkLeanWindows.h"
+#include "SkMallocStats.h"
 #include "SkOSFile.h"
 #include "SkPictureRecorder.h"
 #include "SkPictureUtils.h"
+#include "SkRingBufferEventTracer.h"
 #include "SkString.h"
 #include "SkSurface.h"
+#include "SkSemaphore.h"
 #include "SkTaskGroup.h"
 #include "SkThreadUtils.h"
 #include "ThermalManager.h"
@@ -110,12 +114,20 @@ DEFINE_string(scales, "1.0", "Space-separated scales for SKPs.");
 DEFINE_string(zoom, "1.0,0", "Comma-separated zoomMax,zoomPeriodMs factors for a periodic SKP zoom "
                              "function that ping-pongs between 1.0 and zoomMax.");
 DEFINE_bool(bbh, true, "Build a BBH for SKPs?");
+DEFINE_bool(reuseRecorder, false, "Reuse one SkPictureRecorder's memory to record SKPs?");
 DEFINE_bool(mpd, true, "Use MultiPictureDraw for the SKPs?");
 DEFINE_bool(loopSKP, true, "Loop SKPs like we do for micro benches?");
 DEFINE_int32(flushEvery, 10, "Flush --outResultsFile every Nth run.");
 DEFINE_bool(resetGpuContext, true, "Reset the GrContext before running each test.");
 DEFINE_bool(gpuStats, false, "Print GPU stats after each gpu benchmark?");
 DEFINE_bool(gpuStatsDump, false, "Dump GPU states after each benchmark to json");
+DEFINE_bool(perfCounters, false, "Record hardware performance counters for CPU benches to json?");
+DEFINE_string(traceFile, "", "If set, record trace events while benching and write the most "
+                             "recent ones here as Chrome trace JSON.");
+DEFINE_bool(mallocStats, false, "Run each bench once more counting sk_malloc calls, and record "
+                                "them per loop to json?");
+DEFINE_int32(benchThreads, 1, "If >1, also run each CPU micro bench concurrently on this many "
+                              "threads, each with its own canvas, and report its throughput.");
 DEFINE_bool(keepAlive, false, "Print a message every so often so that we don't time out");
 DEFINE_string(useThermalManager, "0,1,10,1000", "enabled,threshold,sleepTimeMs,TimeoutMs for "
                                                 "thermalManager\n");
@@ -222,12 +234,17 @@ struct GPUTarget : public Target {
 
 #endif
 
-static double time(int loops, Benchmark* bench, Target* target) {
+// If counters is non-null, it counts the same span as the timer.
+static double time(int loops, Benchmark* bench, Target* target,
+                   PerfCounters* counters = nullptr) {
     SkCanvas* canvas = target->getCanvas();
     if (canvas) {
         canvas->clear(SK_ColorWHITE);
     }
     bench->preDraw(canvas);
+    if (counters) {
+        counters->start();
+    }
     double start = now_ms();
     canvas = target->beginTiming(canvas);
     bench->draw(loops, canvas);
@@ -236,6 +253,9 @@ static double time(int loops, Benchmark* bench, Target* target) {
     }
     target->endTiming();
     double elapsed = now_ms() - start;
+    if (counters) {
+        counters->stop();
+    }
     bench->postDraw(canvas);
     return elapsed;
 }
@@ -562,6 +582,9 @@ class BenchmarkStream {
 public:
     BenchmarkStream() : fBenches(BenchRegistry::Head())
                       , fGMs(skiagm::GMRegistry::Head())
+                      , fCurrentBenchFactory(nullptr)
+                      , fCurrentGMFactory(nullptr)
+                      , fRecordingBench(nullptr)
                       , fCurrentRecording(0)
                       , fCurrentScale(0)
                       , fCurrentSKP(0)
@@ -656,9 +679,25 @@ public:
         return bench.release();
     }
 
+    // Makes another copy of the current bench, or returns nullptr if it can't.
+    // Only micro benches can be copied.
+    Benchmark* cloneCurrent() const {
+        if (fCurrentBenchFactory) {
+            return fCurrentBenchFactory(nullptr);
+        }
+        if (fCurrentGMFactory) {
+            return new GMBench(fCurrentGMFactory(nullptr));
+        }
+        return nullptr;
+    }
+
     Benchmark* rawNext() {
+        fCurrentBenchFactory = nullptr;
+        fCurrentGMFactory    = nullptr;
+
         if (fBenches) {
-            Benchmark* bench = fBenches->factory()(nullptr);
+            fCurrentBenchFactory = fBenches->factory();
+            Benchmark* bench = fCurrentBenchFactory(nullptr);
             fBenches = fBenches->next();
             fSourceType = "bench";
             fBenchType  = "micro";
@@ -667,12 +706,14 @@ public:
 
         while (fGMs) {
             SkAutoTDelete<skiagm::GM> gm(fGMs->factory()(nullptr));
-            fGMs = fGMs->next();
             if (gm->runAsBench()) {
+                fCurrentGMFactory = fGMs->factory();
+                fGMs = fGMs->next();
                 fSourceType = "gm";
                 fBenchType  = "micro";
                 return new GMBench(gm.release());
             }
+            fGMs = fGMs->next();
         }
 
         // First add all .skps as RecordingBenches.
@@ -687,7 +728,9 @@ public:
             fBenchType  = "recording";
             fSKPBytes = static_cast<double>(SkPictureUtils::ApproximateBytesUsed(pic.get()));
             fSKPOps   = pic->approximateOpCount();
-            return new RecordingBench(name.c_str(), pic.get(), FLAGS_bbh);
+            fRecordingBench = new RecordingBench(name.c_str(), pic.get(), FLAGS_bbh,
+                                                 FLAGS_reuseRecorder);
+            return fRecordingBench;
         }
 
         // Then once each for each scale as SKPBenches (playback).
@@ -973,6 +1016,7 @@ public:
         if (0 == strcmp(fBenchType, "recording")) {
             log->metric("bytes", fSKPBytes);
             log->metric("ops",   fSKPOps);
+            log->metric("mallocs", fRecordingBench->mallocsPerRecording());
         }
     }
 
@@ -991,6 +1035,8 @@ private:
 
     const BenchRegistry* fBenches;
     const skiagm::GMRegistry* fGMs;
+    BenchRegistry::Factory      fCurrentBenchFactory;
+    skiagm::GMRegistry::Factory fCurrentGMFactory;
     SkIRect            fClip;
     SkTArray<SkScalar> fScales;
     SkTArray<SkString> fSKPs;
@@ -1002,6 +1048,7 @@ private:
     double             fZoomPeriodMs;
 
     double fSKPBytes, fSKPOps;
+    RecordingBench* fRecordingBench;  // The current bench, when fBenchType is recording.
 
     const char* fSourceType;  // What we're benching: bench, GM, SKP, ...
     const char* fBenchType;   // How we bench it: micro, recording, playback, ...
@@ -1041,11 +1088,80 @@ static void start_keepalive() {
 }
 
 int nanobench_main();
+struct ThreadedRun {
+    Benchmark*   bench;
+    Target*      target;
+    int          loops;
+    int          samples;
+    SkSemaphore* go;
+};
+
+static void threaded_run(void* ctx) {
+    ThreadedRun* run = static_cast<ThreadedRun*>(ctx);
+    run->go->wait();
+    for (int s = 0; s < run->samples; s++) {
+        time(run->loops, run->bench, run->target);
+    }
+}
+
+// Runs fresh copies of the stream's current bench concurrently on threads threads, each drawing
+// loops*samples times into its own target, and returns how many loops per millisecond they
+// completed together.  Returns -1 if the bench can't be run this way.
+static double threaded_throughput(const BenchmarkStream& stream, const Config& config,
+                                  int threads, int loops, int samples) {
+    SkTArray<SkAutoTDelete<Benchmark>> benches;
+    SkTArray<SkAutoTDelete<Target>> targets;
+    for (int i = 0; i < threads; i++) {
+        Benchmark* bench = stream.cloneCurrent();
+        if (!bench) {
+            return -1;
+        }
+        benches.emplace_back(bench);
+        Target* target = is_enabled(bench, config);
+        if (!target) {
+            return -1;
+        }
+        targets.emplace_back(target);
+        bench->delayedSetup();
+        target->setup();
+        bench->perCanvasPreDraw(target->getCanvas());
+    }
+
+    SkSemaphore go;
+    SkTArray<ThreadedRun> runs;
+    SkTArray<SkAutoTDelete<SkThread>> workers;
+    for (int i = 0; i < threads; i++) {
+        runs.push_back({ benches[i].get(), targets[i].get(), loops, samples, &go });
+    }
+    for (int i = 0; i < threads; i++) {
+        workers.emplace_back(new SkThread(threaded_run, &runs[i]));
+        workers.back()->start();
+    }
+    double start = now_ms();
+    go.signal(threads);
+    for (int i = 0; i < threads; i++) {
+        workers[i]->join();
+    }
+    double elapsed = now_ms() - start;
+
+    for (int i = 0; i < threads; i++) {
+        benches[i]->perCanvasPostDraw(targets[i]->getCanvas());
+    }
+    return (double)threads * loops * samples / elapsed;
+}
+
 int nanobench_main() {
     SetupCrashHandler();
     SkAutoGraphics ag;
     SkTaskGroup::Enabler enabled(FLAGS_threads);
 
+    SkRingBufferEventTracer* tracer = nullptr;
+    if (!FLAGS_traceFile.isEmpty()) {
+        tracer = new SkRingBufferEventTracer(1 << 16);
+        SkEventTracer::SetInstance(tracer);  // Takes ownership.
+        tracer->setEnabled(true);
+    }
+
 #if SK_SUPPORT_GPU
     GrContextOptions grContextOpts;
     gGrFactory.reset(new GrContextFactory(grContextOpts));
@@ -1099,6 +1215,16 @@ int nanobench_main() {
 
     SkTArray<double> samples;
 
+    SkAutoTDelete<PerfCounters> perfCounters;
+    SkTArray<double> counterSamples[PerfCounters::kCounterCount];
+    if (FLAGS_perfCounters) {
+        perfCounters.reset(new PerfCounters);
+        if (!perfCounters->isValid()) {
+            SkDebugf("Hardware performance counters are unavailable; ignoring --perfCounters.\n");
+            perfCounters.reset(nullptr);
+        }
+    }
+
     if (kAutoTuneLoops != FLAGS_loops) {
         SkDebugf("Fixed number of loops; times would only be misleading so we won't print them.\n");
     } else if (FLAGS_quiet) {
@@ -1172,16 +1298,35 @@ int nanobench_main() {
                 ? setup_gpu_bench(target, bench.get(), maxFrameLag)
                 : setup_cpu_bench(overhead, target, bench.get());
 
+            // GPU work is asynchronous, so counters would only see the CPU side of it.
+            PerfCounters* counters = Benchmark::kGPU_Backend == configs[i].backend
+                                   ? nullptr : perfCounters.get();
+            for (int c = 0; c < PerfCounters::kCounterCount; c++) {
+                counterSamples[c].reset();
+            }
+            auto sample = [&]() {
+                double ms = time(loops, bench, target, counters) / loops;
+                if (counters) {
+                    for (int c = 0; c < PerfCounters::kCounterCount; c++) {
+                        double value = counters->value((PerfCounters::Counter)c);
+                        if (value >= 0) {
+                            counterSamples[c].push_back(value / loops);
+                        }
+                    }
+                }
+                return ms;
+            };
+
             if (FLAGS_ms) {
                 samples.reset();
                 auto stop = now_ms() + FLAGS_ms;
                 do {
-                    samples.push_back(time(loops, bench, target) / loops);
+                    samples.push_back(sample());
                 } while (now_ms() < stop);
             } else {
                 samples.reset(FLAGS_samples);
                 for (int s = 0; s < FLAGS_samples; s++) {
-                    samples[s] = time(loops, bench, target) / loops;
+                    samples[s] = sample();
                 }
             }
 
@@ -1211,12 +1356,47 @@ int nanobench_main() {
                 continue;
             }
 
+            SkMallocStats::Counts mallocs = { -1, -1, -1 };
+            if (FLAGS_mallocStats) {
+                // Separate from the timed samples so counting doesn't slow them down.
+                SkMallocStats::Start();
+                time(loops, bench, target);
+                mallocs = SkMallocStats::Stop();
+            }
+
+            double threadedThroughput = -1;
+            if (FLAGS_benchThreads > 1 && Benchmark::kGPU_Backend != configs[i].backend) {
+                threadedThroughput = threaded_throughput(benchStream, configs[i],
+                                                         FLAGS_benchThreads, loops,
+                                                         FLAGS_ms ? samples.count()
+                                                                  : FLAGS_samples);
+            }
+
             Stats stats(samples);
             log->config(config);
             log->configOption("name", bench->getName());
             benchStream.fillCurrentOptions(log.get());
             target->fillOptions(log.get());
             log->metric("min_ms",    stats.min);
+            for (int c = 0; c < PerfCounters::kCounterCount; c++) {
+                if (!counterSamples[c].empty()) {
+                    // Medians, per loop, like the times.
+                    log->metric(PerfCounters::Name((PerfCounters::Counter)c),
+                                Stats(counterSamples[c]).median);
+                }
+            }
+            if (mallocs.fAllocations >= 0) {
+                log->metric("mallocs_per_loop",      (double)mallocs.fAllocations / loops);
+                log->metric("malloc_bytes_per_loop", (double)mallocs.fBytes / loops);
+                log->metric("peak_live_bytes",       (double)mallocs.fPeakLiveBytes);
+            }
+            // Scaling efficiency compares against the single threaded median: 1.0 is perfect.
+            double efficiency = threadedThroughput * stats.median / FLAGS_benchThreads;
+            if (threadedThroughput > 0) {
+                log->metric("threads",               FLAGS_benchThreads);
+                log->metric("threaded_loops_per_ms", threadedThroughput);
+                log->metric("threaded_efficiency",   efficiency);
+            }
 #if SK_SUPPORT_GPU
             if (gpuStatsDump) {
                 // dump to json, only SKPBench currently returns valid keys / values
@@ -1264,6 +1444,10 @@ int nanobench_main() {
                         , bench->getUniqueName()
                         );
             }
+            if (threadedThroughput > 0) {
+                SkDebugf("\t%d threads: %s per loop, %.0f%% scaling efficiency\n",
+                         FLAGS_benchThreads, HUMANIZE(1 / threadedThroughput), 100 * efficiency);
+            }
 
 #if SK_SUPPORT_GPU
             if (FLAGS_gpuStats && Benchmark::kGPU_Backend == configs[i].backend) {
@@ -1285,6 +1469,15 @@ int nanobench_main() {
         }
     }
 
+    if (tracer) {
+        SkFILEWStream trace(FLAGS_traceFile[0]);
+        if (trace.isValid()) {
+            tracer->dumpChromeTraceJSON(&trace);
+        } else {
+            SkDebugf("Could not write trace to %s.\n", FLAGS_traceFile[0]);
+        }
+    }
+
     log->bench("memory_usage", 0,0);
     log->config("meta");
     log->metric("max_rss_mb", sk_tools::getMaxResidentSetSizeMB());
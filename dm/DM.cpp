@@ -23,10 +23,12 @@
 #include "SkGraphics.h"
 #include "SkHalf.h"
 #include "SkLeanWindows.h"
+#include "SkMallocStats.h"
 #include "SkMD5.h"
 #include "SkMutex.h"
 #include "SkOSFile.h"
 #include "SkPM4fPriv.h"
+#include "SkScan.h"
 #include "SkSpinlock.h"
 #include "SkTHash.h"
 #include "SkTaskGroup.h"
@@ -42,6 +44,7 @@ extern void SkPDFImageDumpStats();
 
 #include "png.h"
 
+#include <atomic>
 #include <stdlib.h>
 
 #ifndef SK_BUILD_FOR_WIN32
@@ -57,6 +60,7 @@ DEFINE_string(matrix, "1 0 0 1",
               "2x2 scale+skew matrix to apply or upright when using "
               "'matrix' or 'upright' in config.");
 DEFINE_bool(gpu_threading, false, "Allow GPU work to run on multiple threads?");
+DEFINE_bool(analyticAA, false, "Anti-alias path fills with analytic coverage, not supersampling?");
 
 DEFINE_string(blacklist, "",
         "Space-separated config/src/srcOptions/name quadruples to blacklist.  '_' matches anything.  E.g. \n"
@@ -74,6 +78,17 @@ DEFINE_int32(shard,  0, "Which shard do I run?");
 
 DEFINE_string(mskps, "", "Directory to read mskps from, or a single mskp file.");
 
+DEFINE_string(resultCache, "",
+        "File of results from earlier runs.  Tasks whose source, sink and --resultCacheRevision "
+        "match a cached result report it without drawing, and new results are added to it.");
+DEFINE_string(resultCacheRevision, "",
+        "The Skia revision being tested; --resultCache is only used when this is set.");
+
+DEFINE_int32(gpuThreads, 1, "Run GPU tasks on this many threads, each with its own contexts.");
+
+DEFINE_bool(mallocStats, false, "Count sk_malloc calls while drawing each source and record them "
+                                "in dm.json.  Implies --threads 0.");
+
 using namespace DM;
 using sk_gpu_test::GrContextFactory;
 using sk_gpu_test::GLTestContext;
@@ -300,6 +315,65 @@ static void gather_uninteresting_hashes() {
 
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 
+// Results of earlier runs, keyed by a hash of everything that determines the result: the Skia
+// revision, the sink, the src, and the contents of the file the src draws, if any.
+struct CachedResult {
+    SkString md5;
+    SkString ext;
+    bool     gammaCorrect;
+};
+static SkMutex gResultCacheMutex;
+static SkTHashMap<SkString, CachedResult> gResultCache;
+static int gResultCacheHits = 0;
+
+static bool use_result_cache() {
+    return !FLAGS_resultCache.isEmpty() && !FLAGS_resultCacheRevision.isEmpty();
+}
+
+static void gather_result_cache() {
+    if (FLAGS_resultCache.isEmpty()) {
+        return;
+    }
+    if (FLAGS_resultCacheRevision.isEmpty()) {
+        info("WARNING: ignoring --resultCache without --resultCacheRevision\n");
+        return;
+    }
+    SkAutoTUnref<SkData> data(SkData::NewFromFileName(FLAGS_resultCache[0]));
+    if (!data) {
+        return;  // No results yet.
+    }
+    SkString contents((const char*)data->data(), data->size());
+    SkTArray<SkString> lines;
+    SkStrSplit(contents.c_str(), kNewline, &lines);
+    for (const SkString& line : lines) {
+        // key md5 ext gammaCorrect
+        SkTArray<SkString> fields;
+        SkStrSplit(line.c_str(), " ", &fields);
+        if (fields.count() == 4) {
+            gResultCache.set(fields[0], { fields[1], fields[2], fields[3].equals("1") });
+        }
+    }
+    info("FYI: loaded %d cached results\n", gResultCache.count());
+}
+
+static void write_result_cache() {
+    if (!use_result_cache()) {
+        return;
+    }
+    SkFILEWStream file(FLAGS_resultCache[0]);
+    if (!file.isValid()) {
+        info("WARNING: unable to write cached results to %s\n", FLAGS_resultCache[0]);
+        return;
+    }
+    gResultCache.foreach([&](const SkString& key, CachedResult* result) {
+        file.writeText(SkStringPrintf("%s %s %s %d%s", key.c_str(), result->md5.c_str(),
+                                      result->ext.c_str(), result->gammaCorrect, kNewline).c_str());
+    });
+    info("FYI: %d of %d cached results were used\n", gResultCacheHits, gResultCache.count());
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
 struct TaggedSrc : public SkAutoTDelete<Src> {
     SkString tag;
     SkString options;
@@ -1010,11 +1084,50 @@ struct Task {
 
         SkString log;
         if (!FLAGS_dryRun) {
+            SkString cacheKey;
+            if (use_result_cache()) {
+                cacheKey = CacheKey(task, name);
+                CachedResult cached;
+                bool hit = false;
+                {
+                    SkAutoMutexAcquire lock(gResultCacheMutex);
+                    if (CachedResult* found = gResultCache.find(cacheKey)) {
+                        cached = *found;
+                        hit = true;
+                        gResultCacheHits++;
+                    }
+                }
+                if (hit) {
+                    CheckGold(task, name, cached.md5);
+                    if (!FLAGS_writePath.isEmpty()) {
+                        JsonWriter::AddBitmapResult(
+                                MakeResult(task, cached.md5, cached.ext.c_str(),
+                                           cached.gammaCorrect));
+                    }
+                    done(task.sink.tag.c_str(), task.src.tag.c_str(),
+                         task.src.options.c_str(), name.c_str());
+                    return;
+                }
+            }
+
             SkBitmap bitmap;
             SkDynamicMemoryWStream stream;
             start(task.sink.tag.c_str(), task.src.tag.c_str(),
                   task.src.options.c_str(), name.c_str());
+            if (FLAGS_mallocStats) {
+                SkMallocStats::Start();
+            }
             Error err = task.sink->draw(*task.src, &bitmap, &stream, &log);
+            if (FLAGS_mallocStats) {
+                SkMallocStats::Counts counts = SkMallocStats::Stop();
+                JsonWriter::MallocStatsResult result;
+                result.name          = name;
+                result.config        = task.sink.tag;
+                result.sourceType    = task.src.tag;
+                result.sourceOptions = task.src.options;
+                result.counts        = counts;
+                JsonWriter::AddMallocStatsResult(result);
+            }
             if (!log.isEmpty()) {
                 info("%s %s %s %s:\n%s\n", task.sink.tag.c_str()
                                          , task.src.tag.c_str()
@@ -1039,14 +1152,15 @@ struct Task {
 
             // We're likely switching threads here, so we must capture by value, [=] or [foo,bar].
             SkStreamAsset* data = stream.detachAsStream();
-            gDefinitelyThreadSafeWork.add([task,name,bitmap,data]{
+            gDefinitelyThreadSafeWork.add([task,name,bitmap,data,cacheKey]{
                 SkAutoTDelete<SkStreamAsset> ownedData(data);
 
                 // Why doesn't the copy constructor do this when we have pre-locked pixels?
                 bitmap.lockPixels();
 
                 SkString md5;
-                if (!FLAGS_writePath.isEmpty() || !FLAGS_readPath.isEmpty()) {
+                if (!FLAGS_writePath.isEmpty() || !FLAGS_readPath.isEmpty() ||
+                    !cacheKey.isEmpty()) {
                     SkMD5 hash;
                     if (data->getLength()) {
                         hash.writeStream(data, data->getLength());
@@ -1064,23 +1178,17 @@ struct Task {
                             hash.write(bitmap.getPixels(), bitmap.getSize());
                         }
                     }
-                    SkMD5::Digest digest;
-                    hash.finish(digest);
-                    for (int i = 0; i < 16; i++) {
-                        md5.appendf("%02x", digest.data[i]);
-                    }
+                    md5 = Hex(&hash);
                 }
 
-                if (!FLAGS_readPath.isEmpty() &&
-                    !gGold.contains(Gold(task.sink.tag, task.src.tag,
-                                         task.src.options, name, md5))) {
-                    fail(SkStringPrintf("%s not found for %s %s %s %s in %s",
-                                        md5.c_str(),
-                                        task.sink.tag.c_str(),
-                                        task.src.tag.c_str(),
-                                        task.src.options.c_str(),
-                                        name.c_str(),
-                                        FLAGS_readPath[0]));
+                CheckGold(task, name, md5);
+
+                if (!cacheKey.isEmpty()) {
+                    bool gammaCorrect = !bitmap.drawsNothing() &&
+                                        SkImageInfoIsGammaCorrect(bitmap.info());
+                    SkAutoMutexAcquire lock(gResultCacheMutex);
+                    gResultCache.set(cacheKey, { md5, SkString(task.sink->fileExtension()),
+                                                 gammaCorrect });
                 }
 
                 if (!FLAGS_writePath.isEmpty()) {
@@ -1097,16 +1205,53 @@ struct Task {
         done(task.sink.tag.c_str(), task.src.tag.c_str(), task.src.options.c_str(), name.c_str());
     }
 
-    static void WriteToDisk(const Task& task,
-                            SkString md5,
-                            const char* ext,
-                            SkStream* data, size_t len,
-                            const SkBitmap* bitmap) {
-        bool gammaCorrect = false;
-        if (bitmap) {
-            gammaCorrect = SkImageInfoIsGammaCorrect(bitmap->info());
+    static SkString Hex(SkMD5* hash) {
+        SkMD5::Digest digest;
+        hash->finish(digest);
+        SkString hex;
+        for (int i = 0; i < 16; i++) {
+            hex.appendf("%02x", digest.data[i]);
+        }
+        return hex;
+    }
+
+    static SkString CacheKey(const Task& task, const SkString& name) {
+        SkMD5 hash;
+        auto write = [&hash](const char* str) { hash.write(str, strlen(str) + 1); };
+        write(FLAGS_resultCacheRevision[0]);
+        write(task.sink.tag.c_str());
+        write(task.src.tag.c_str());
+        write(task.src.options.c_str());
+        write(name.c_str());
+
+        SkString path = task.src->path();
+        if (!path.isEmpty()) {
+            SkFILEStream file(path.c_str());
+            if (file.isValid()) {
+                hash.writeStream(&file, file.getLength());
+            }
         }
+        return Hex(&hash);
+    }
+
+    static void CheckGold(const Task& task, const SkString& name, const SkString& md5) {
+        if (!FLAGS_readPath.isEmpty() &&
+            !gGold.contains(Gold(task.sink.tag, task.src.tag,
+                                 task.src.options, name, md5))) {
+            fail(SkStringPrintf("%s not found for %s %s %s %s in %s",
+                                md5.c_str(),
+                                task.sink.tag.c_str(),
+                                task.src.tag.c_str(),
+                                task.src.options.c_str(),
+                                name.c_str(),
+                                FLAGS_readPath[0]));
+        }
+    }
 
+    static JsonWriter::BitmapResult MakeResult(const Task& task,
+                                               const SkString& md5,
+                                               const char* ext,
+                                               bool gammaCorrect) {
         JsonWriter::BitmapResult result;
         result.name          = task.src->name();
         result.config        = task.sink.tag;
@@ -1115,6 +1260,20 @@ struct Task {
         result.ext           = ext;
         result.gammaCorrect  = gammaCorrect;
         result.md5           = md5;
+        return result;
+    }
+
+    static void WriteToDisk(const Task& task,
+                            SkString md5,
+                            const char* ext,
+                            SkStream* data, size_t len,
+                            const SkBitmap* bitmap) {
+        bool gammaCorrect = false;
+        if (bitmap) {
+            gammaCorrect = SkImageInfoIsGammaCorrect(bitmap->info());
+        }
+
+        JsonWriter::BitmapResult result = MakeResult(task, md5, ext, gammaCorrect);
         JsonWriter::AddBitmapResult(result);
 
         // If an MD5 is uninteresting, we want it noted in the JSON file,
@@ -1170,6 +1329,21 @@ struct Task {
     }
 };
 
+// Tasks for GPU sinks, shared by the --gpuThreads threads that run them.
+struct GPUTaskQueue {
+    explicit GPUTaskQueue(const SkTArray<Task>* tasks) : fTasks(tasks), fNext(0) {}
+
+    static void Run(void* queue) {
+        GPUTaskQueue* self = (GPUTaskQueue*)queue;
+        for (int i = self->fNext++; i < self->fTasks->count(); i = self->fNext++) {
+            Task::Run((*self->fTasks)[i]);
+        }
+    }
+
+    const SkTArray<Task>* fTasks;
+    std::atomic<int>      fNext;
+};
+
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 
 // Unit tests don't fit so well into the Src/Sink model, so we give them special treatment.
@@ -1265,6 +1439,11 @@ int dm_main() {
 
     JsonWriter::DumpJson();  // It's handy for the bots to assume this is ~never missing.
     SkAutoGraphics ag;
+    gSkUseAnalyticAA = FLAGS_analyticAA;
+    if (FLAGS_mallocStats) {
+        // The counts are process-wide, so each source must draw alone to be measured alone.
+        FLAGS_threads = 0;
+    }
     SkTaskGroup::Enabler enabled(FLAGS_threads);
     gCreateTypefaceDelegate = &create_from_name;
 
@@ -1277,6 +1456,7 @@ int dm_main() {
     }
     gather_gold();
     gather_uninteresting_hashes();
+    gather_result_cache();
 
     if (!gather_srcs()) {
         return 1;
@@ -1292,7 +1472,7 @@ int dm_main() {
 
     // Kick off as much parallel work as we can, making note of any serial work we'll need to do.
     SkTaskGroup parallel;
-    SkTArray<Task> serial;
+    SkTArray<Task> serial, gpu;
 
     for (auto& sink : gSinks)
     for (auto&  src : gSrcs) {
@@ -1305,7 +1485,12 @@ int dm_main() {
         }
 
         Task task(src, sink);
-        if (src->serial() || sink->serial()) {
+        if (FLAGS_gpuThreads > 1 && !src->serial() && sink->serial() &&
+                sink->flags().type == SinkFlags::kGPU) {
+            // Each GPU task makes its own contexts, so they only need to stay off the threads
+            // running CPU work, not off each other.
+            gpu.push_back(task);
+        } else if (src->serial() || sink->serial()) {
             serial.push_back(task);
         } else {
             parallel.add([task] { Task::Run(task); });
@@ -1315,16 +1500,29 @@ int dm_main() {
         parallel.add([test] { run_test(test); });
     }
 
+    // GPU tasks get their own threads, each taking the next task until none are left.
+    GPUTaskQueue gpuQueue(&gpu);
+    SkTDArray<SkThread*> gpuThreads;
+    for (int i = 0; i < SkTMin(FLAGS_gpuThreads, gpu.count()); i++) {
+        *gpuThreads.append() = new SkThread(GPUTaskQueue::Run, &gpuQueue);
+        gpuThreads.top()->start();
+    }
+
     // With the parallel work running, run serial tasks and tests here on main thread.
     for (auto task : serial) { Task::Run(task); }
     for (auto test : gSerialTests) { run_test(test); }
 
     // Wait for any remaining parallel work to complete (including any spun off of serial tasks).
+    for (SkThread* thread : gpuThreads) {
+        thread->join();
+    }
+    gpuThreads.deleteAll();
     parallel.wait();
     gDefinitelyThreadSafeWork.wait();
 
     // We'd better have run everything.
     SkASSERT(gPending == 0);
+    write_result_cache();
     // Make sure we've flushed all our results to disk.
     JsonWriter::DumpJson();
 
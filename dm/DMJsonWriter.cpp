@@ -26,6 +26,14 @@ void JsonWriter::AddBitmapResult(const BitmapResult& result) {
     gBitmapResults.push_back(result);
 }
 
+SkTArray<JsonWriter::MallocStatsResult> gMallocStatsResults;
+SK_DECLARE_STATIC_MUTEX(gMallocStatsResultLock);
+
+void JsonWriter::AddMallocStatsResult(const MallocStatsResult& result) {
+    SkAutoMutexAcquire lock(gMallocStatsResultLock);
+    gMallocStatsResults.push_back(result);
+}
+
 SkTArray<skiatest::Failure> gFailures;
 SK_DECLARE_STATIC_MUTEX(gFailureLock);
 
@@ -69,6 +77,25 @@ void JsonWriter::DumpJson() {
         }
     }
 
+    {
+        SkAutoMutexAcquire lock(gMallocStatsResultLock);
+        for (int i = 0; i < gMallocStatsResults.count(); i++) {
+            const MallocStatsResult& r = gMallocStatsResults[i];
+            Json::Value result;
+            result["key"]["name"]        = r.name.c_str();
+            result["key"]["config"]      = r.config.c_str();
+            result["key"]["source_type"] = r.sourceType.c_str();
+            if (!r.sourceOptions.isEmpty()) {
+                result["key"]["source_options"] = r.sourceOptions.c_str();
+            }
+            result["mallocs"]         = (Json::Int64)r.counts.fAllocations;
+            result["malloc_bytes"]    = (Json::Int64)r.counts.fBytes;
+            result["peak_live_bytes"] = (Json::Int64)r.counts.fPeakLiveBytes;
+
+            root["malloc_stats"].append(result);
+        }
+    }
+
     {
         SkAutoMutexAcquire lock(gFailureLock);
         for (int i = 0; i < gFailures.count(); i++) {
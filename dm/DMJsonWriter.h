@@ -8,6 +8,7 @@
 #ifndef DMJsonWriter_DEFINED
 #define DMJsonWriter_DEFINED
 
+#include "SkMallocStats.h"
 #include "SkString.h"
 #include "Test.h"
 
@@ -37,6 +38,22 @@ public:
      */
     static void AddBitmapResult(const BitmapResult&);
 
+    /**
+     *  sk_malloc counts from drawing a single source into a single sink.
+     */
+    struct MallocStatsResult {
+        SkString name;
+        SkString config;
+        SkString sourceType;
+        SkString sourceOptions;
+        SkMallocStats::Counts counts;
+    };
+
+    /**
+     *  Add sk_malloc counts to the end of the list of results.
+     */
+    static void AddMallocStatsResult(const MallocStatsResult&);
+
     /**
      *  Add a Failure from a Test.
      */
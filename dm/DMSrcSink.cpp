@@ -1024,8 +1024,8 @@ SkISize MSKPSrc::size(int i) const { return fReader.pageSize(i).toCeil(); }
 
 Error MSKPSrc::draw(SkCanvas* c) const { return this->draw(0, c); }
 Error MSKPSrc::draw(int i, SkCanvas* canvas) const {
-    std::unique_ptr<SkStreamAsset> stream(SkStream::NewFromFile(fPath.c_str()));
-    if (!stream) {
+    sk_sp<SkData> data(SkData::MakeFromFileName(fPath.c_str()));
+    if (!data) {
         return SkStringPrintf("Unable to open file: %s", fPath.c_str());
     }
     if (fReader.pageCount() == 0) {
@@ -1034,7 +1034,7 @@ Error MSKPSrc::draw(int i, SkCanvas* canvas) const {
     if (i >= fReader.pageCount()) {
         return SkStringPrintf("MultiPictureDocument page number out of range: %d", i);
     }
-    sk_sp<SkPicture> page = fReader.readPage(stream.get(), i);
+    sk_sp<SkPicture> page = fReader.readPage(data, i);
     if (!page) {
         return SkStringPrintf("SkMultiPictureDocumentReader failed on page %d: %s",
                               i, fPath.c_str());
@@ -74,6 +74,8 @@ struct Src {
     virtual SkISize size(int) const { return this->size(); }
     // Force Tasks using this Src to run on the main thread?
     virtual bool serial() const { return false; }
+    // The file this Src draws, if any.  Its contents are part of the key for cached results.
+    virtual Path path() const { return Path(); }
 };
 
 struct Sink {
@@ -130,6 +132,7 @@ public:
     Error draw(SkCanvas*) const override;
     SkISize size() const override;
     Name name() const override;
+    Path path() const override { return fPath; }
     bool veto(SinkFlags) const override;
     bool serial() const override { return fRunSerially; }
 private:
@@ -148,6 +151,7 @@ public:
     Error draw(SkCanvas*) const override;
     SkISize size() const override;
     Name name() const override;
+    Path path() const override { return fPath; }
     bool veto(SinkFlags) const override;
     bool serial() const override { return fRunSerially; }
 private:
@@ -176,6 +180,7 @@ public:
     Error draw(SkCanvas*) const override;
     SkISize size() const override;
     Name name() const override;
+    Path path() const override { return fPath; }
     bool veto(SinkFlags) const override;
 private:
     Path                                     fPath;
@@ -195,6 +200,7 @@ public:
     Error draw(SkCanvas*) const override;
     SkISize size() const override;
     Name name() const override;
+    Path path() const override { return fPath; }
     bool veto(SinkFlags) const override;
     bool serial() const override { return fRunSerially; }
 private:
@@ -230,6 +236,7 @@ public:
     Error draw(SkCanvas*) const override;
     SkISize size() const override;
     Name name() const override;
+    Path path() const override { return fPath; }
     bool veto(SinkFlags) const override;
 private:
     Path                    fPath;
@@ -243,6 +250,7 @@ public:
     Error draw(SkCanvas*) const override;
     SkISize size() const override;
     Name name() const override;
+    Path path() const override { return fPath; }
 private:
     Path fPath;
 };
@@ -259,6 +267,7 @@ public:
     SkISize size() const override;
     SkISize size(int) const override;
     Name name() const override;
+    Path path() const override { return fPath; }
 
 private:
     Path fPath;
@@ -116,7 +116,7 @@ protected:
                 grPaint.setXPFactory(GrPorterDuffXPFactory::Make(SkXfermode::kSrc_Mode));
                 sk_sp<GrFragmentProcessor> fp(GrYUVEffect::MakeYUVToRGB(
                     texture[indices[i][0]], texture[indices[i][1]], texture[indices[i][2]], sizes,
-                    static_cast<SkYUVColorSpace>(space), false));
+                    static_cast<SkYUVColorSpace>(space), GrYUVEffect::PlaneLayout::kYUV));
                 if (fp) {
                     SkMatrix viewMatrix;
                     viewMatrix.setTranslate(x, y);
@@ -141,15 +141,16 @@ DEF_GM(return new YUVtoRGBEffect;)
 
 //////////////////////////////////////////////////////////////////////////////
 
+// With nv21, the same UV plane is read as VU, so the result should differ from the nv12 GM.
 class YUVNV12toRGBEffect : public GM {
 public:
-    YUVNV12toRGBEffect() {
+    YUVNV12toRGBEffect(bool nv21) : fNV21(nv21) {
         this->setBGColor(0xFFFFFFFF);
     }
 
 protected:
     SkString onShortName() override {
-        return SkString("yuv_nv12_to_rgb_effect");
+        return SkString(fNV21 ? "yuv_nv21_to_rgb_effect" : "yuv_nv12_to_rgb_effect");
     }
 
     SkISize onISize() override {
@@ -228,7 +229,9 @@ protected:
             grPaint.setXPFactory(GrPorterDuffXPFactory::Make(SkXfermode::kSrc_Mode));
             sk_sp<GrFragmentProcessor> fp(
                 GrYUVEffect::MakeYUVToRGB(texture[0], texture[1], texture[2], sizes,
-                                          static_cast<SkYUVColorSpace>(space), true));
+                                          static_cast<SkYUVColorSpace>(space),
+                                          fNV21 ? GrYUVEffect::PlaneLayout::kNV21
+                                                : GrYUVEffect::PlaneLayout::kNV12));
             if (fp) {
                 SkMatrix viewMatrix;
                 viewMatrix.setTranslate(x, y);
@@ -242,11 +245,13 @@ protected:
 
 private:
     SkBitmap fBmp[2];
+    bool     fNV21;
 
     typedef GM INHERITED;
 };
 
-DEF_GM(return new YUVNV12toRGBEffect;)
+DEF_GM(return new YUVNV12toRGBEffect(false);)
+DEF_GM(return new YUVNV12toRGBEffect(true);)
 }
 
 #endif
@@ -27,6 +27,7 @@
         'jsoncpp.gyp:jsoncpp',
         'skia_lib.gyp:skia_lib',
         'tools.gyp:crash_handler',
+        'tools.gyp:perf_counters',
         'tools.gyp:proc_stats',
         'tools.gyp:thermal_manager',
         'tools.gyp:timer',
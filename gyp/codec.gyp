@@ -18,9 +18,11 @@
       'dependencies': [
         'core.gyp:*',
         'giflib.gyp:giflib',
+        'ktx.gyp:libSkKTX',
         'libjpeg-turbo-selector.gyp:libjpeg-turbo-selector',
         'libpng.gyp:libpng',
         'libwebp.gyp:libwebp',
+        'utils.gyp:utils',
       ],
       'cflags':[   
         # FIXME: This gets around a warning: "Argument might be clobbered by longjmp". 
@@ -32,6 +34,7 @@
         '../include/private',
         '../src/codec',
         '../src/core',
+        '../src/gpu',
         '../src/utils',
       ],
       'sources': [
@@ -46,6 +49,7 @@
         '../src/codec/SkJpegCodec.cpp',
         '../src/codec/SkJpegDecoderMgr.cpp',
         '../src/codec/SkJpegUtility.cpp',
+        '../src/codec/SkKTXCodec.cpp',
         '../src/codec/SkMaskSwizzler.cpp',
         '../src/codec/SkMasks.cpp',
         '../src/codec/SkPngCodec.cpp',
@@ -28,6 +28,7 @@
         '../src/core',
         '../src/sfnt',
         '../src/image',
+        '../src/lazy',
         '../src/opts',
         '../src/utils',
       ],
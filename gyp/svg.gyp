@@ -37,6 +37,7 @@
       'type': 'static_library',
       'standalone_static_library': 1,
       'dependencies': [
+        'animator.gyp:animator',
         'skia_lib.gyp:skia_lib',
         'xml.gyp:*',
       ],
@@ -48,6 +49,7 @@
         '../include/svg/parser/SkSVGBase.h',
         '../include/svg/parser/SkSVGPaintState.h',
         '../include/svg/parser/SkSVGParser.h',
+        '../include/svg/parser/SkSVGPicture.h',
         '../include/svg/parser/SkSVGTypes.h',
 
         '../src/svg/parser/SkSVGCircle.cpp',
@@ -84,6 +86,7 @@
         '../src/svg/parser/SkSVGParser.cpp',
         '../src/svg/parser/SkSVGPath.cpp',
         '../src/svg/parser/SkSVGPath.h',
+        '../src/svg/parser/SkSVGPicture.cpp',
         '../src/svg/parser/SkSVGPolygon.cpp',
         '../src/svg/parser/SkSVGPolygon.h',
         '../src/svg/parser/SkSVGPolyline.cpp',
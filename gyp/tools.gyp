@@ -31,6 +31,7 @@
         'skhello',
         'skpinfo',
         'skpmaker',
+        'skpreplay',
         'test_public_includes',
         'using_skia_and_harfbuzz',
         'visualize_color_gamut',
@@ -256,6 +257,26 @@
         '../tools/skhello.cpp',
       ],
     },
+    {
+      'target_name': 'skpreplay',
+      'type': 'executable',
+      'sources': [
+        '../tools/skpreplay.cpp',
+      ],
+      'include_dirs': [
+        '../include/private',
+      ],
+      'dependencies': [
+        'flags.gyp:flags',
+        'jsoncpp.gyp:jsoncpp',
+        'skia_lib.gyp:skia_lib',
+      ],
+      'conditions': [
+        ['skia_gpu == 1', {
+          'dependencies': [ 'gputest.gyp:skgputest' ],
+        }],
+      ],
+    },
     {
       'target_name': 'skpinfo',
       'type': 'executable',
@@ -464,6 +485,10 @@
         '../tools/using_skia_and_harfbuzz.cpp',
         '../tools/SkShaper.cpp',
       ],
+      'include_dirs': [
+        '../include/private',
+        '../src/core',
+      ],
       'dependencies': [
         'skia_lib.gyp:skia_lib',
         'pdf.gyp:pdf',
@@ -513,6 +538,20 @@
         'include_dirs': [ '../tools', ],
       },
     },
+    {
+      'target_name': 'perf_counters',
+      'type': 'static_library',
+      'sources': [
+        '../tools/PerfCounters.h',
+        '../tools/PerfCounters.cpp',
+      ],
+      'dependencies': [
+        'skia_lib.gyp:skia_lib',
+      ],
+      'direct_dependent_settings': {
+        'include_dirs': [ '../tools', ],
+      },
+    },
     {
       'target_name': 'test_public_includes',
       'type': 'static_library',
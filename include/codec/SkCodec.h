@@ -18,7 +18,10 @@
 #include "SkTypes.h"
 #include "SkYUVSizeInfo.h"
 
+#include <vector>
+
 class SkColorSpace;
+class SkColorSpaceXform;
 class SkData;
 class SkPngChunkReader;
 class SkSampler;
@@ -250,6 +253,8 @@ public:
         Options()
             : fZeroInitialized(kNo_ZeroInitialized)
             , fSubset(NULL)
+            , fFrameIndex(0)
+            , fHasPriorFrame(false)
         {}
 
         ZeroInitialized fZeroInitialized;
@@ -271,6 +276,22 @@ public:
          *  to getScanlines().
          */
         SkIRect*        fSubset;
+
+        /**
+         *  The frame to decode.  Only meaningful for multi-frame images, and
+         *  only supported by getPixels().
+         */
+        size_t          fFrameIndex;
+
+        /**
+         *  If true, the caller promises that the pixels already hold the
+         *  frame's fRequiredFrame (see getFrameInfo()), as it was decoded,
+         *  and only fFrameIndex itself will be decoded on top of them.
+         *
+         *  If false, the codec first decodes the required frame, and its own
+         *  required frame, and so on back to one that needs no other.
+         */
+        bool            fHasPriorFrame;
     };
 
     /**
@@ -303,6 +324,10 @@ public:
      *  If a scanline decode is in progress, scanline mode will end, requiring the client to call
      *  startScanlineDecode() in order to return to decoding scanlines.
      *
+     *  If info is opaque kN32 with a color space other than getColorSpace(), codecs that
+     *  support it (currently PNG and JPEG) convert each row to that color space as they
+     *  decode it.  Otherwise the color space of info is ignored.
+     *
      *  @return Result kSuccess, or another value explaining the type of failure.
      */
     Result getPixels(const SkImageInfo& info, void* pixels, size_t rowBytes, const Options*,
@@ -320,8 +345,9 @@ public:
      *
      *  @param sizeInfo   Output parameter indicating the sizes and required
      *                    allocation widths of the Y, U, and V planes.
-     *  @param colorSpace Output parameter.  If non-NULL this is set to kJPEG,
-     *                    otherwise this is ignored.
+     *  @param colorSpace Output parameter.  If non-NULL this is set to the
+     *                    planes' color space (kJPEG for JPEG, kRec601 for
+     *                    WebP), otherwise this is ignored.
      */
     bool queryYUV8(SkYUVSizeInfo* sizeInfo, SkYUVColorSpace* colorSpace) const {
         if (nullptr == sizeInfo) {
@@ -354,6 +380,45 @@ public:
         return this->onGetYUV8Planes(sizeInfo, planes);
     }
 
+    /**
+     *  Value for FrameInfo::fRequiredFrame when a frame needs no other.
+     */
+    static const size_t kNone = static_cast<size_t>(-1);
+
+    /**
+     *  Information about one frame of a multi-frame image.
+     */
+    struct FrameInfo {
+        /**
+         *  The frame that must be drawn before this one, because this frame
+         *  is blended onto it, or kNone if this frame can be decoded by itself.
+         */
+        size_t fRequiredFrame;
+
+        /**
+         *  Number of milliseconds to show this frame.
+         */
+        size_t fDuration;
+    };
+
+    /**
+     *  Returns information about each frame of the image, or an empty vector
+     *  for formats that cannot hold more than one.
+     *
+     *  The first call may read through the whole stream to find the frames,
+     *  so the next decode will need to rewind.
+     */
+    std::vector<FrameInfo> getFrameInfo() {
+        return this->onGetFrameInfo();
+    }
+
+    /**
+     *  Returns the number of frames, which is 1 for a still image.
+     */
+    size_t getFrameCount() {
+        return this->onGetFrameCount();
+    }
+
     /**
      * The remaining functions revolve around decoding scanlines.
      */
@@ -562,6 +627,15 @@ protected:
         return kUnimplemented;
     }
 
+    virtual std::vector<FrameInfo> onGetFrameInfo() {
+        // By default, images have a single frame.
+        return std::vector<FrameInfo>();
+    }
+
+    virtual size_t onGetFrameCount() {
+        return 1;
+    }
+
     virtual bool onGetValidSubset(SkIRect* /*desiredSubset*/) const {
         // By default, subsets are not supported.
         return false;
@@ -642,6 +716,12 @@ protected:
 
     const SkCodec::Options& options() const { return fOptions; }
 
+    /**
+     *  The conversion to the color space of the current decode's dst, to be applied
+     *  to each row as it is decoded, or nullptr if there is none.
+     */
+    const SkColorSpaceXform* colorXform() const { return fColorXform.get(); }
+
     /**
      *  Returns the number of scanlines that have been decoded so far.
      *  This is unaffected by the SkScanlineOrder.
@@ -670,6 +750,13 @@ private:
     SkCodec::Options            fOptions;
     int                         fCurrScanline;
 
+    std::unique_ptr<SkColorSpaceXform> fColorXform;
+
+    /**
+     *  Sets up fColorXform for a decode to dstInfo.
+     */
+    void initializeColorXform(const SkImageInfo& dstInfo);
+
     /**
      *  Return whether these dimensions are supported as a scale.
      *
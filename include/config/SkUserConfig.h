@@ -93,6 +93,13 @@
  */
 //#define SK_DEFAULT_IMAGE_CACHE_LIMIT (1024 * 1024)
 
+/*
+ *  To specify the most unused saveLayer() pixel memory the raster backend keeps
+ *  around for reuse, define this (in bytes). If this is undefined, a built-in
+ *  value will be used.
+ */
+//#define SK_DEFAULT_LAYER_POOL_LIMIT (1024 * 1024)
+
 /*  Define this to provide font subsetter in PDF generation.
  */
 //#define SK_SFNTLY_SUBSETTER "sfntly/subsetter/font_subsetter.h"
@@ -16,6 +16,7 @@
 class GrContext;
 class GrFragmentProcessor;
 class SkBitmap;
+template <int> class SkRasterPipelineN;
 
 /**
  *  ColorFilters are optional objects in the drawing pipeline. When present in
@@ -70,6 +71,15 @@ public:
 
     virtual void filterSpan4f(const SkPM4f src[], int count, SkPM4f result[]) const;
 
+    /**
+     *  If this filter can be expressed as SkRasterPipeline stages, append them to the pipeline,
+     *  where they will filter the premultiplied source color in the same pass as the stages that
+     *  load, blend and store around them, and return true.  Otherwise return false, appending
+     *  nothing; the caller will use filterSpan4f() instead.
+     */
+    virtual bool appendStages(SkRasterPipelineN<4>*) const { return false; }
+    virtual bool appendStages(SkRasterPipelineN<8>*) const { return false; }
+
     enum Flags {
         /** If set the filter methods will not change the alpha channel of the colors.
         */
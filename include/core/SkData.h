@@ -141,6 +141,26 @@ public:
      */
     static sk_sp<SkData> MakeFromFD(int fd);
 
+    /**
+     *  Create a new, zero-initialized dataref of the given length in shared memory, and set fd
+     *  to a file descriptor for that memory.  Another process that is sent the descriptor can
+     *  wrap the same memory, without a copy, with MakeFromSharedFD().  Until the data is
+     *  shared, it may be written through writable_data().
+     *  The caller owns the file descriptor, and must close it.
+     *  Returns NULL if shared memory is not available.
+     */
+    static sk_sp<SkData> MakeShared(size_t length, int* fd);
+
+    /**
+     *  Create a new dataref from shared memory made by MakeShared(), possibly in another
+     *  process.  It sees any later writes to that memory, so the sender should not write to
+     *  the memory after sharing it.
+     *  This does not take ownership of the file descriptor, nor close it.
+     *  The caller is free to close the file descriptor at its convenience.
+     *  Returns NULL on failure.
+     */
+    static sk_sp<SkData> MakeFromSharedFD(int fd);
+
     /**
      *  Attempt to read size bytes into a SkData. If the read succeeds, return the data,
      *  else return NULL. Either way the stream's cursor may have been changed as a result
@@ -47,6 +47,8 @@ public:
      *  Optional metadata to be passed into the PDF factory function.
      */
     struct PDFMetadata {
+        PDFMetadata()
+            : fCompressionLevel(-1), fDeduplicateImages(false), fJpegQuality(-1) {}
         /**
          * The document’s title.
          */
@@ -84,6 +86,26 @@ public:
          * The date and time the document was most recently modified.
          */
         OptionalTimestamp fModified;
+        /**
+         * The zlib compression level for page contents and images: 0 is
+         * no compression, 1 is best speed, and 9 is best compression.
+         * The default, -1, is zlib's Z_DEFAULT_COMPRESSION level.
+         */
+        int fCompressionLevel;
+        /**
+         * If true, images with identical contents are embedded only once,
+         * even if they are different SkImages (e.g. the same logo decoded
+         * anew for each page).  This costs a hash of each image's encoded
+         * data or pixels.
+         */
+        bool fDeduplicateImages;
+        /**
+         * If between 0 and 100, opaque images that look like photographs
+         * and are not already JPEGs are encoded as JPEGs of this quality,
+         * rather than deflated.  The default, -1, never does this.  A
+         * SkPixelSerializer passed to MakePDF() takes precedence.
+         */
+        int fJpegQuality;
     };
 
     /**
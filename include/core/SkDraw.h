@@ -25,6 +25,7 @@ class SkRegion;
 class SkRasterClip;
 struct SkDrawProcs;
 struct SkRect;
+struct SkScanPathID;
 class SkRRect;
 
 class SkDraw {
@@ -130,7 +131,8 @@ private:
 
     void drawLine(const SkPoint[2], const SkPaint&) const;
     void drawDevPath(const SkPath& devPath, const SkPaint& paint, bool drawCoverage,
-                     SkBlitter* customBlitter, bool doFill) const;
+                     SkBlitter* customBlitter, bool doFill,
+                     const SkScanPathID* pathID = nullptr) const;
     /**
      *  Return the current clip bounds, in local coordinates, with slop to account
      *  for antialiasing or hairlines (i.e. device-bounds outset by 1, and then
@@ -113,6 +113,14 @@ public:
     static size_t GetResourceCacheSingleAllocationByteLimit();
     static size_t SetResourceCacheSingleAllocationByteLimit(size_t newLimit);
 
+    /**
+     *  These return how many lookups in the image filter cache shared by raster devices have
+     *  found a saved result, and how many have not, since startup.  Results are found again
+     *  across frames when a layer's content, the CTM, and the filter are unchanged.
+     */
+    static int GetImageFilterCacheHitCount();
+    static int GetImageFilterCacheMissCount();
+
     /**
      *  Dumps memory usage of caches using the SkTraceMemoryDump interface. See SkTraceMemoryDump
      *  for usage of this method.
@@ -127,6 +135,24 @@ public:
      */
     static void PurgeAllCaches();
 
+    enum MemoryPressureLevel {
+        /** Trim caches, keeping the entries that would be most expensive to rebuild. */
+        kModerate_MemoryPressureLevel,
+        /** Free as much cached memory as possible. */
+        kCritical_MemoryPressureLevel,
+    };
+
+    /**
+     *  Call when the system is running low on memory.  Under moderate pressure the image filter
+     *  cache is emptied, the resource cache is trimmed to half its size and the font cache to
+     *  three quarters, so drawing can carry on without rebuilding everything.  Under critical
+     *  pressure all of these, and unused typefaces, are purged.
+     *
+     *  Every GrContext trims its resource cache the same way (keeping half of it, or none of it),
+     *  but on its own thread, the next time it's used.
+     */
+    static void OnMemoryPressure(MemoryPressureLevel);
+
     /**
      *  Applications with command line options may pass optional state, such
      *  as cache sizes, here, for instance:
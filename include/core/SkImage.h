@@ -147,6 +147,14 @@ public:
                                                    const GrBackendObject nv12TextureHandles[2],
                                                    const SkISize nv12Sizes[2], GrSurfaceOrigin);
 
+    /**
+     *  Like MakeFromNV12TexturesCopy, but the second texture holds V in its red channel and U in
+     *  its green, as NV21 camera frames do.
+     */
+    static sk_sp<SkImage> MakeFromNV21TexturesCopy(GrContext*, SkYUVColorSpace,
+                                                   const GrBackendObject nv21TextureHandles[2],
+                                                   const SkISize nv21Sizes[2], GrSurfaceOrigin);
+
     static sk_sp<SkImage> MakeFromPicture(sk_sp<SkPicture>, const SkISize& dimensions,
                                           const SkMatrix*, const SkPaint*);
 
@@ -214,6 +222,19 @@ public:
      */
     void preroll(GrContext* = nullptr) const;
 
+    /**
+     *  Like preroll(nullptr), but the work is done on another thread, and this returns right
+     *  away.  Drawing the image while that work is in flight waits for it to finish, rather
+     *  than decoding the image a second time.
+     *
+     *  If drawSize is not null, this also prepares the scaled form of the image used to draw it
+     *  at that size with kMedium or kHigh filter quality: mip levels to draw it smaller, or a
+     *  high quality upscale to draw it larger.
+     *
+     *  If there are no worker threads (see SkTaskGroup), the work is done before this returns.
+     */
+    void prerollAsync(const SkISize* drawSize = nullptr) const;
+
     // DEPRECATED - currently used by Canvas2DLayerBridge in Chromium.
     GrTexture* getTexture() const;
 
@@ -110,6 +110,20 @@ public:
      */
     sk_sp<SkSpecialImage> filterImage(SkSpecialImage* src, const Context&, SkIPoint* offset) const;
 
+    /**
+     *  Like filterImage(), but for large raster sources splits the clip bounds into tiles and
+     *  filters them in parallel on an SkTaskGroup.  Each tile pulls only the part of the source
+     *  it needs back through the DAG, so no node's intermediate result is ever much bigger than
+     *  a tile.  GPU sources, small clips, and DAGs that need too wide a margin around each tile
+     *  are filtered whole.
+     *
+     *  Raster results are cached by the source's ID and subset when that ID is stable, as an
+     *  image's is.  Sources without one, like layers, are cached by their content instead, so
+     *  results are found again when a later frame filters an identical layer.
+     */
+    sk_sp<SkSpecialImage> filterImageTiled(SkSpecialImage* src, const Context&,
+                                           SkIPoint* offset) const;
+
     enum MapDirection {
         kForward_MapDirection,
         kReverse_MapDirection
@@ -329,6 +343,17 @@ protected:
                                       const Context&, 
                                       SkIPoint* offset) const;
 
+    // Like filterInput(), but if that input is a color filter node (see isColorFilterNode())
+    // that leaves transparent black alone, this evaluates the node's own input instead and
+    // returns its color filter in "colorFilter", for the caller to apply as it draws the
+    // result. That fuses the per-pixel node into the caller's pass, saving an intermediate
+    // image. Otherwise "colorFilter" is set to null.
+    sk_sp<SkSpecialImage> filterInputFusingColorFilter(int index,
+                                                       SkSpecialImage* src,
+                                                       const Context&,
+                                                       SkIPoint* offset,
+                                                       sk_sp<SkColorFilter>* colorFilter) const;
+
     /**
      *  Return true (and return a ref'd colorfilter) if this node in the DAG is just a
      *  colorfilter w/o CropRect constraints.
@@ -377,6 +402,13 @@ private:
     friend class SkGraphics;
     static void PurgeCache();
 
+    // filterImageTiled(), less its caching.
+    sk_sp<SkSpecialImage> filterTiles(SkSpecialImage* src, const Context&, SkIPoint* offset) const;
+    // filterTiles(), with its result cached under key.
+    sk_sp<SkSpecialImage> filterTilesCached(SkSpecialImage* src, const Context&,
+                                            const SkImageFilterCacheKey& key,
+                                            SkIPoint* offset) const;
+
     void init(sk_sp<SkImageFilter>* inputs, int inputCount, const CropRect* cropRect);
 
     bool usesSrcInput() const { return fUsesSrcInput; }
@@ -0,0 +1,35 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkImageReferenceResolver_DEFINED
+#define SkImageReferenceResolver_DEFINED
+
+#include "SkRefCnt.h"
+
+class SkImage;
+
+/**
+ *  Interface for finding the images that were serialized as references (see
+ *  SkPixelSerializer::refImageReference()), e.g. in a cache shared with the writer,
+ *  when reading an SkPicture.
+ */
+class SkImageReferenceResolver : public SkRefCnt {
+public:
+    virtual ~SkImageReferenceResolver() {}
+
+    /**
+     *  Returns the image the reference names, or null if it can't be found. The reader uses a
+     *  blank placeholder of the right size in that case.
+     */
+    sk_sp<SkImage> resolve(const void* reference, size_t length) {
+        return this->onResolve(reference, length);
+    }
+
+protected:
+    virtual sk_sp<SkImage> onResolve(const void* reference, size_t length) = 0;
+};
+#endif // SkImageReferenceResolver_DEFINED
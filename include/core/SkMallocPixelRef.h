@@ -83,6 +83,20 @@ public:
                                          SkColorTable* ctable,
                                          SkData* data);
 
+    /**
+     *  Identical to NewZeroed, except the pixels are in shared memory, and fd
+     *  is set to a file descriptor for them (which the caller must close).
+     *  Another process that is sent the descriptor can wrap the same pixels,
+     *  without a copy, with
+     *      NewWithData(info, rowBytes, ctable, SkData::MakeFromSharedFD(fd).get())
+     *  The pixels should not be changed once they are shared.
+     *
+     *  Returns NULL on failure, or if shared memory is not available.
+     */
+    static SkMallocPixelRef* NewShared(const SkImageInfo& info,
+                                       size_t rowBytes, SkColorTable*,
+                                       int* fd);
+
     void* getAddr() const { return fStorage; }
 
     class PRFactory : public SkPixelRefFactory {
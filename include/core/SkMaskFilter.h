@@ -28,6 +28,7 @@ class SkMatrix;
 class SkPath;
 class SkRasterClip;
 class SkRRect;
+struct SkScanPathID;
 
 /** \class SkMaskFilter
 
@@ -223,10 +224,11 @@ private:
     /** Helper method that, given a path in device space, will rasterize it into a kA8_Format mask
      and then call filterMask(). If this returns true, the specified blitter will be called
      to render that mask. Returns false if filterMask() returned false.
+     If pathID names the path, blurs of it are cached.
      This method is not exported to java.
      */
     bool filterPath(const SkPath& devPath, const SkMatrix& ctm, const SkRasterClip&, SkBlitter*,
-                    SkStrokeRec::InitStyle) const;
+                    SkStrokeRec::InitStyle, const SkScanPathID* pathID = nullptr) const;
 
     /** Helper method that, given a roundRect in device space, will rasterize it into a kA8_Format
      mask and then call filterMask(). If this returns true, the specified blitter will be called
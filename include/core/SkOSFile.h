@@ -72,6 +72,20 @@ bool    sk_fidentical(FILE* a, FILE* b);
  */
 int     sk_fileno(FILE* f);
 
+/** Creates length bytes of zeroed, anonymous shared memory (memfd on Linux, ashmem on Android)
+ *  and maps it read-write.  Returns the address and sets fd to a file descriptor for the memory
+ *  on success, NULL otherwise.  The descriptor can be passed to another process, e.g. over a
+ *  Unix domain socket, and mapped there with sk_shmmap().
+ *  The caller must close the descriptor, and free the mapping with sk_fmunmap.
+ */
+void*   sk_shm_create(size_t length, int* fd);
+
+/** Maps all of the shared memory from sk_shm_create() behind fd into memory, shared with every
+ *  other mapping of it.  Returns the address and length on success, NULL otherwise.
+ *  When finished with the mapping, free the returned pointer with sk_fmunmap.
+ */
+void*   sk_shmmap(int fd, bool writable, size_t* length);
+
 /** Returns true if something (file, directory, ???) exists at this path,
  *  and has the specified access flags.
  */
@@ -1046,6 +1046,17 @@ public:
             return (Verb) fRawIter.next(pts);
         }
 
+        /** Return the verb of the next run of segments sharing it, pointing pts at the run's
+            points in place rather than copying them. See SkPathRef::Iter::nextRun().
+
+            @param  pts   Set to the run's points. This must not be NULL.
+            @param  count Set to the number of segments in the run. This must not be NULL.
+            @return The verb shared by the run's segments
+        */
+        Verb nextRun(const SkPoint** pts, int* count) {
+            return (Verb) fRawIter.nextRun(pts, count);
+        }
+
         /** Return what the next verb will be, but do not visit the next segment.
 
             @return The verb for the next segment
@@ -10,6 +10,7 @@
 
 #include "../private/SkTDArray.h"
 #include "SkPath.h"
+#include "SkRefCnt.h"
 
 struct SkConic;
 
@@ -47,6 +48,16 @@ public:
     bool SK_WARN_UNUSED_RESULT getPosTan(SkScalar distance, SkPoint* position,
                                          SkVector* tangent);
 
+    /** Computes the position and tangent for each of count distances along the current
+        contour, walking its segments once. The distances are expected in increasing order;
+        an out-of-order distance is still handled, but costs a search. Each distance is pinned
+        as in getPosTan(). Either positions or tangents may be null.
+        Returns false if there is no path, or a zero-length path was specified, in which case
+        positions and tangents are unchanged.
+    */
+    bool SK_WARN_UNUSED_RESULT getPosTan(const SkScalar distances[], int count,
+                                         SkPoint positions[], SkVector tangents[]);
+
     enum MatrixFlags {
         kGetPosition_MatrixFlag     = 0x01,
         kGetTangent_MatrixFlag      = 0x02,
@@ -83,6 +94,9 @@ public:
 #endif
 
 private:
+    struct Segment;
+    struct Contours;
+
     SkPath::Iter    fIter;
     const SkPath*   fPath;
     SkScalar        fTolerance;
@@ -90,6 +104,16 @@ private:
     int             fFirstPtIndex;      // relative to the current contour
     bool            fIsClosed;          // relative to the current contour
     bool            fForceClosed;
+    int             fContourIndex;      // next contour to take from fContours
+
+    // Segments and points of the current contour, pointing into either our own arrays
+    // or the shared fContours tables.
+    const Segment*  fSegs;
+    int             fSegCount;
+    const SkPoint*  fSegPts;
+
+    // Immutable tables for every contour of the path, shared through SkResourceCache.
+    sk_sp<const Contours> fContours;
 
     struct Segment {
         SkScalar    fDistance;  // total distance up to this point
@@ -104,7 +128,9 @@ private:
 
     static const Segment* NextSegment(const Segment*);
 
-    void     buildSegments();
+    bool     buildSegments();
+    void     nextContourSegments();
+    const Segment* segmentForIndex(int index, SkScalar distance, SkScalar* t) const;
     SkScalar compute_quad_segs(const SkPoint pts[3], SkScalar distance,
                                 int mint, int maxt, int ptIndex);
     SkScalar compute_conic_segs(const SkConic&, SkScalar distance,
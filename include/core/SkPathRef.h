@@ -131,6 +131,18 @@ public:
         uint8_t next(SkPoint pts[4]);
         uint8_t peek() const;
 
+        /** Return the verb of the next run of consecutive segments that share it, without
+            copying their points. Line, quad and cubic runs share end points, so the run's
+            points are the previous segment's end point followed by 1, 2 or 3 points per
+            segment. Moves, conics and closes come one at a time; a move has its one point
+            and a close has none.
+
+            @param  pts   Set to the run's points. This must not be NULL.
+            @param  count Set to the number of segments in the run. This must not be NULL.
+            @return The verb shared by the run's segments
+        */
+        uint8_t nextRun(const SkPoint** pts, int* count);
+
         SkScalar conicWeight() const { return *fConicWeights; }
 
     private:
@@ -16,6 +16,9 @@ class GrContext;
 class SkBigPicture;
 class SkBitmap;
 class SkCanvas;
+class SkData;
+class SkImageReferenceResolver;
+class SkMatrix;
 class SkPath;
 class SkPictureData;
 class SkPixelSerializer;
@@ -26,6 +29,7 @@ class SkTypefacePlayback;
 class SkWStream;
 class SkWriteBuffer;
 struct SkPictInfo;
+struct SkPictureCost;
 
 /** \class SkPicture
 
@@ -71,6 +75,41 @@ public:
      */
     static sk_sp<SkPicture> MakeFromStream(SkStream*);
 
+    /**
+     *  Recreate a picture that was serialized into a stream, as above, using resolver to find
+     *  the images that were serialized as references (see
+     *  SkPixelSerializer::refImageReference()).
+     */
+    static sk_sp<SkPicture> MakeFromStream(SkStream*, InstallPixelRefProc proc,
+                                           SkImageReferenceResolver* resolver);
+
+    /**
+     *  Recreate a picture that was serialized into data, e.g. a file mapped into memory by
+     *  SkData::MakeFromFileName().  Unlike MakeFromStream(), the picture's ops are not copied
+     *  or re-recorded: the picture keeps a ref on data and plays back directly from it.
+     *  @param SkData Serialized picture data.
+     *  @param proc Function pointer for installing pixelrefs on SkBitmaps representing the
+     *              encoded bitmap data from the stream.
+     *  @return A new SkPicture representing the serialized data, or NULL if the data is
+     *          invalid.
+     */
+    static sk_sp<SkPicture> MakeFromData(sk_sp<SkData>, InstallPixelRefProc proc);
+
+    /**
+     *  Recreate a picture that was serialized into data, as above.
+     *
+     *  Any serialized images in the data will be passed to
+     *  SkImageGenerator::NewFromEncoded.
+     */
+    static sk_sp<SkPicture> MakeFromData(sk_sp<SkData>);
+
+    /**
+     *  Recreate a picture that was serialized into data, as above, using resolver to find the
+     *  images that were serialized as references.
+     */
+    static sk_sp<SkPicture> MakeFromData(sk_sp<SkData>, InstallPixelRefProc proc,
+                                         SkImageReferenceResolver* resolver);
+
     /**
      *  Recreate a picture that was serialized into a buffer. If the creation requires bitmap
      *  decoding, the decoder must be set on the SkReadBuffer parameter by calling
@@ -107,6 +146,19 @@ public:
     */
     virtual void playback(SkCanvas*, AbortCallback* = NULL) const = 0;
 
+    /** Replays the drawing commands into the pixels of dst, split into horizontal bands that are
+        drawn concurrently on SkTaskGroup threads.  Each band gets its own canvas over its own
+        rows of dst, so the result is the same as playback() into an SkCanvas wrapping dst,
+        give or take antialiasing rounding where paths and filters meet a band's edges.
+        Bands use this picture's bounding box hierarchy to skip ops that can't touch them, so
+        this is much more effective for pictures recorded with an SkBBHFactory.
+        @param dst the raster destination.  Its pixels must not be accessed until this returns.
+        @param matrix if not NULL, concatenated onto each band's canvas before drawing.
+        @param bandCount how many bands to split dst into; <= 0 picks one band per 128 rows.
+    */
+    void playbackInBands(const SkBitmap& dst, const SkMatrix* matrix = NULL,
+                         int bandCount = 0) const;
+
     /** Return a cull rect for this picture.
         Ops recorded into this picture that attempt to draw outside the cull might not be drawn.
      */
@@ -185,15 +237,28 @@ private:
     SkPicture();
     friend class SkBigPicture;
     friend class SkEmptyPicture;
+    friend class SkPlaybackPicture;
+    friend class SkMiniOpsPicture;
     template <typename> friend class SkMiniPicture;
 
     void serialize(SkWStream*, SkPixelSerializer*, SkRefCntSet* typefaces) const;
-    static sk_sp<SkPicture> MakeFromStream(SkStream*, InstallPixelRefProc, SkTypefacePlayback*);
+    static sk_sp<SkPicture> MakeFromStream(SkStream*, InstallPixelRefProc,
+                                           SkImageReferenceResolver*, SkTypefacePlayback*);
+    // The first half of MakeFromStream(): reads the picture's header and data, leaving the
+    // playback into a new picture to Forwardport().
+    static SkPictureData* ReadFromStream(SkStream*, InstallPixelRefProc,
+                                         SkImageReferenceResolver*, SkTypefacePlayback*,
+                                         SkPictInfo*);
     friend class SkPictureData;
+    friend class SkPictureStreamReader;
+    friend class SkPictureStreamWriter;
 
     virtual int numSlowPaths() const = 0;
+    // Estimates of how much work this picture is to draw.  Cached, unless cheap to compute.
+    virtual SkPictureCost cost() const = 0;
     friend class SkPictureGpuAnalyzer;
     friend struct SkPathCounter;
+    friend struct SkPictureCostCounter;
 
     // V35: Store SkRect (rather then width & height) in header
     // V36: Remove (obsolete) alphatype from SkColorTable
@@ -207,10 +272,12 @@ private:
     // V44: Move annotations from paint to drawAnnotation
     // V45: Add invNormRotation to SkLightingShader.
     // V46: Add drawTextRSXform
+    // V47: Pad the bool after the header to 4 bytes, so top-level op data is aligned in memory.
+    // V48: Images may be serialized as references to be resolved by the reader.
 
     // Only SKPs within the min/current picture version range (inclusive) can be read.
     static const uint32_t     MIN_PICTURE_VERSION = 35;     // Produced by Chrome M39.
-    static const uint32_t CURRENT_PICTURE_VERSION = 46;
+    static const uint32_t CURRENT_PICTURE_VERSION = 48;
 
     static_assert(MIN_PICTURE_VERSION <= 41,
                   "Remove kFontFileName and related code from SkFontDescriptor.cpp.");
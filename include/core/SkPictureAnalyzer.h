@@ -54,8 +54,23 @@ public:
      */
     uint32_t numSlowGpuCommands() { return fNumSlowPaths; }
 
+    /**
+     *  Rough measures of how much work the analyzed pictures are to draw, e.g. for choosing
+     *  between raster and GPU rasterization tile by tile.  Nested pictures are included, and
+     *  each picture works these out only once, however many times it's analyzed.
+     *    numPathVerbs()  -- verbs in all the paths drawn or clipped to;
+     *    numLayers()     -- saveLayer()s, each drawn offscreen then composited;
+     *    pixelCoverage() -- the sum of the areas drawn, in picture space, so overdraw counts.
+     */
+    uint32_t numPathVerbs() const { return fNumPathVerbs; }
+    uint32_t numLayers() const { return fNumLayers; }
+    double pixelCoverage() const { return fPixelCoverage; }
+
 private:
     uint32_t fNumSlowPaths;
+    uint32_t fNumPathVerbs;
+    uint32_t fNumLayers;
+    double   fPixelCoverage;
 
     typedef SkNoncopyable INHERITED;
 };
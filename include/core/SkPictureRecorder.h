@@ -34,6 +34,15 @@ public:
         // If you call drawPicture() or drawDrawable() on the recording canvas, this flag forces
         // that object to playback its contents immediately rather than reffing the object.
         kPlaybackDrawPicture_RecordFlag     = 1 << 0,
+        // Spend more time when recording finishes to remove draws hidden by later opaque draws,
+        // simplify clips, and merge paths.  This assumes the picture is not played back scaled
+        // down much below the size it was recorded at: it may then draw slightly differently.
+        kOptimizeOverdraw_RecordFlag        = 1 << 1,
+        // For recorders used again and again, e.g. once per frame: record into the memory used by
+        // this recorder's last picture or drawable if that's since been destroyed, or else make
+        // room for as much again up front.  This keeps that last recording's contents alive until
+        // the next beginRecording(), or until this recorder is destroyed.
+        kReuseRecordMemory_RecordFlag       = 1 << 2,
     };
 
     enum FinishFlags {
@@ -129,6 +138,7 @@ private:
     SkAutoTUnref<SkBBoxHierarchy> fBBH;
     SkAutoTUnref<SkRecorder>      fRecorder;
     SkAutoTUnref<SkRecord>        fRecord;
+    SkAutoTUnref<SkRecord>        fLastRecord;  // See kReuseRecordMemory_RecordFlag.
     SkMiniRecorder                fMiniRecorder;
 
     typedef SkNoncopyable INHERITED;
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPictureStream_DEFINED
+#define SkPictureStream_DEFINED
+
+#include "../private/SkTemplates.h"
+#include "SkPicture.h"
+#include "SkRect.h"
+#include "SkRefCnt.h"
+
+class SkCanvas;
+class SkRecord;
+class SkRecorder;
+class SkStream;
+class SkWStream;
+
+/** \class SkPictureStreamWriter
+
+    Records drawing commands like SkPictureRecorder, but rather than holding them all in memory
+    until recording finishes, writes them out to a stream in chunks of a fixed number of commands.
+    Memory use is bounded by the chunk size, however much is drawn.
+
+    Any pictures or drawables drawn into the recording canvas are played back into it right away,
+    so they are streamed out just like the rest of the commands.  The stream can only be played
+    back with SkPictureStreamReader.
+*/
+class SK_API SkPictureStreamWriter : SkNoncopyable {
+public:
+    static const int kDefaultChunkOpCount = 4096;
+
+    /**
+     *  Begin recording.  The stream must outlive the writer; ownership is unchanged.
+     *  @param bounds the cull rect used when recording, as in SkPictureRecorder::beginRecording().
+     *  @param chunkOpCount how many drawing commands to buffer before writing them out.
+     */
+    SkPictureStreamWriter(SkWStream*, const SkRect& bounds,
+                          int chunkOpCount = kDefaultChunkOpCount);
+
+    /** Calls finish() if it hasn't been called yet. */
+    ~SkPictureStreamWriter();
+
+    /** Returns the canvas that records the drawing commands, or NULL once finished. */
+    SkCanvas* getRecordingCanvas();
+
+    /**
+     *  Write out any remaining drawing commands and end the stream.  This invalidates the canvas
+     *  returned by getRecordingCanvas().
+     */
+    void finish();
+
+private:
+    class ChunkFlusher;
+
+    SkRecord* writeChunk(SkRecord*);
+
+    SkWStream*                 fStream;
+    SkRect                     fCullRect;
+    int                        fDepth;      // Save count of the recording canvas, less one.
+    SkAutoTUnref<SkRecord>     fRecord;
+    SkAutoTUnref<SkRecorder>   fRecorder;
+    SkAutoTDelete<ChunkFlusher> fFlusher;
+
+    typedef SkNoncopyable INHERITED;
+};
+
+/** \class SkPictureStreamReader
+
+    Plays back a stream written by SkPictureStreamWriter, reading and drawing one chunk at a time.
+*/
+class SK_API SkPictureStreamReader : SkNoncopyable {
+public:
+    /**
+     *  Reads the stream's header.  The stream must outlive the reader; ownership is unchanged.
+     *  @param proc Function pointer for installing pixelrefs on SkBitmaps representing the
+     *              encoded bitmap data from the stream, or NULL to use
+     *              SkImageGenerator::NewFromEncoded.
+     */
+    explicit SkPictureStreamReader(SkStream*, SkPicture::InstallPixelRefProc proc = NULL);
+
+    /** Returns false if the stream does not start with a valid header. */
+    bool isValid() const { return fValid; }
+
+    /** The bounds passed to SkPictureStreamWriter. */
+    const SkRect& cullRect() const { return fCullRect; }
+
+    /**
+     *  Reads the rest of the stream, drawing each chunk into the canvas as it is read, and then
+     *  restores the canvas to its save count on entry.  Only one chunk is in memory at a time.
+     *  This consumes the stream, so may only be called once.
+     *  @return false if the stream is invalid or truncated.  Any chunks read before the problem
+     *          was found will have been drawn.
+     */
+    bool playback(SkCanvas*);
+
+private:
+    SkStream*                      fStream;
+    SkPicture::InstallPixelRefProc fProc;
+    SkRect                         fCullRect;
+    uint32_t                       fVersion;
+    uint32_t                       fFlags;
+    bool                           fValid;
+
+    typedef SkNoncopyable INHERITED;
+};
+
+#endif
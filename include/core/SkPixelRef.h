@@ -391,6 +391,7 @@ private:
     void setTemporarilyImmutable();
     void restoreMutability();
     friend class SkSurface_Raster;   // For the two methods above.
+    friend class SkSurface_ThreadedRaster;
 
     bool isPreLocked() const { return fPreLocked; }
     friend class SkImage_Raster;
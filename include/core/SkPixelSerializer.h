@@ -12,6 +12,7 @@
 #include "SkPixmap.h"
 
 class SkData;
+class SkImage;
 
 /**
  *  Interface for serializing pixels, e.g. SkBitmaps in an SkPicture.
@@ -34,6 +35,13 @@ public:
      */
     SkData* encode(const SkPixmap& pixmap) { return this->onEncode(pixmap); }
 
+    /**
+     *  Call to let the client keep the image itself (e.g. in a cache shared with the reader)
+     *  and serialize only a reference to it, to be found again by an SkImageReferenceResolver.
+     *  If it returns NULL, serialize the image's pixels as usual.
+     */
+    SkData* refImageReference(const SkImage* image) { return this->onRefImageReference(image); }
+
 protected:
     /**
      *  Return true if you want to serialize the encoded data, false if you want
@@ -46,5 +54,11 @@ protected:
      *  Return null if you want to serialize the raw pixels.
      */
     virtual SkData* onEncode(const SkPixmap&) = 0;
+
+    /**
+     *  If you keep this image yourself, return the data that names it (e.g. a URL or a hash of
+     *  its encoded data). Return null to serialize the image's pixels.
+     */
+    virtual SkData* onRefImageReference(const SkImage*) { return nullptr; }
 };
 #endif // SkPixelSerializer_DEFINED
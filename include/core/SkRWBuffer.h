@@ -75,12 +75,24 @@ private:
  */
 class SK_API SkRWBuffer {
 public:
+    /**
+     *  If initialCapacity is not zero, that much storage is allocated up front, so appends that
+     *  fit in it never allocate, and a stream snapshot of it can hand its memory straight to
+     *  readers like SkCodec (see SkStream::getMemoryBase()).
+     */
     SkRWBuffer(size_t initialCapacity = 0);
     ~SkRWBuffer();
 
     size_t size() const { return fTotalUsed; }
     void append(const void* buffer, size_t length);
 
+    /**
+     *  Forget everything appended so far, e.g. to receive the next image on a connection.
+     *  Existing snapshots are unaffected. If there are none left, the storage is kept and
+     *  appended into again rather than freed.
+     */
+    void reset();
+
     SkROBuffer* newRBufferSnapshot() const;
     SkStreamAsset* newStreamSnapshot() const;
 
@@ -79,6 +79,19 @@ public:
         return MakeRaster(SkImageInfo::MakeN32Premul(width, height), props);
     }
 
+    /**
+     *  Return a new raster surface whose canvas records draws instead of rasterizing them
+     *  immediately. When the pixels are needed (snapshot, peekPixels, readPixels, draw, or
+     *  prepareForExternalIO) the recorded ops are binned into tileSize x tileSize tiles and each
+     *  tile is rasterized on an SkTaskGroup worker, so large surfaces scale across cores.
+     *
+     *  Without an SkTaskGroup::Enabler the tiles are rasterized serially on the calling thread.
+     *  Pixels are zero-initialized. writePixels() on this surface's canvas is not supported.
+     *  Antialiased edges may differ very slightly from MakeRaster() where they cross tile edges.
+     */
+    static sk_sp<SkSurface> MakeRasterThreaded(const SkImageInfo&, int tileSize = 256,
+                                               const SkSurfaceProps* = nullptr);
+
     /**
      *  Return a new surface using the specified render target.
      */
@@ -157,6 +157,17 @@ public:
      */
     const RunBuffer& allocRunPos(const SkPaint& font, int count, const SkRect* bounds = NULL);
 
+    /**
+     *  Makes room for runCount more runs holding glyphCount glyphs between them, so that
+     *  allocating those runs doesn't grow the builder's storage again. Callers that can count
+     *  their runs and glyphs up front end up with a single allocation per blob.
+     *
+     *  @param runCount     Number of runs to be allocated.
+     *  @param glyphCount   Total number of glyphs in those runs.
+     *  @param positioning  The widest positioning mode used by those runs.
+     */
+    void reserveRuns(int runCount, int glyphCount, SkTextBlob::GlyphPositioning positioning);
+
 private:
     void reserve(size_t size);
     void allocInternal(const SkPaint& font, SkTextBlob::GlyphPositioning positioning,
@@ -120,6 +120,16 @@ public:
         return MakeSweep(cx, cy, colors, pos, count, 0, NULL);
     }
 
+    /** Gradients that can't be drawn from their colors alone (more than two colors, or three
+        asymmetric ones) are drawn from a 256 entry color table, shared by every gradient with
+        the same colors, positions and flags. These return, and set (returning the previous
+        value), how many of those tables are kept around. Each costs 1K of memory. On the GPU
+        this is also how many rows each gradient ramp atlas texture has, so that many distinct
+        gradients can be drawn without uploading their tables again. The default is 256.
+    */
+    static int GetTableCacheCountLimit();
+    static int SetTableCacheCountLimit(int count);
+
 #ifdef SK_SUPPORT_LEGACY_CREATESHADER_PTR
     static SkShader* CreateLinear(const SkPoint pts[2],
                                   const SkColor colors[], const SkScalar pos[], int count,
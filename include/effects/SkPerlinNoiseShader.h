@@ -10,6 +10,8 @@
 
 #include "SkShader.h"
 
+class SkCachedData;
+
 /** \class SkPerlinNoiseShader
 
     SkPerlinNoiseShader creates an image using the Perlin turbulence function.
@@ -89,14 +91,14 @@ public:
 
     private:
         SkPMColor shade(const SkPoint& point, StitchData& stitchData) const;
-        SkScalar calculateTurbulenceValueForPoint(
-            int channel,
-            StitchData& stitchData, const SkPoint& point) const;
-        SkScalar noise2D(int channel,
-                         const StitchData& stitchData, const SkPoint& noiseVector) const;
+        SkPMColor calculateTurbulenceColorForPoint(StitchData& stitchData,
+                                                   const SkPoint& point) const;
+        void findOrMakeTile();
 
         SkMatrix fMatrix;
         PaintingData* fPaintingData;
+        // When stitching, the colors of the noise tile, shared through SkResourceCache.
+        SkCachedData* fTile;
 
         typedef SkShader::Context INHERITED;
     };
@@ -61,8 +61,10 @@ protected:
     sk_sp<SkSpecialImage> filterImageGPU(SkSpecialImage* source,
                                          sk_sp<SkSpecialImage> background,
                                          const SkIPoint& backgroundOffset,
+                                         SkColorFilter* backgroundCF,
                                          sk_sp<SkSpecialImage> foreground,
                                          const SkIPoint& foregroundOffset,
+                                         SkColorFilter* foregroundCF,
                                          const SkIRect& bounds) const;
 #endif
 
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrAsyncReadback_DEFINED
+#define GrAsyncReadback_DEFINED
+
+#include "GrBuffer.h"
+#include "GrTypes.h"
+#include "GrTypesPriv.h"
+#include "SkRefCnt.h"
+#include "SkSize.h"
+#include "../private/SkTArray.h"
+
+class GrContext;
+
+/**
+ * A readback of pixels from the GPU that was started without waiting for the GPU to catch up. The
+ * pixels are copied into a transfer buffer and a fence is placed behind the copy; once the fence
+ * passes the pixels can be read without stalling. See GrContext::readSurfacePixelsAsync() and
+ * GrContext::readTextureYUVPlanesAsync().
+ *
+ * A readback holds one plane of pixels, or three planes for a YUV readback. It must only be used
+ * on the thread that owns its GrContext.
+ */
+class SK_API GrAsyncReadback : public SkRefCnt {
+public:
+    /**
+     * Called once when the readback finishes or fails. GrContext calls it while flushing or from
+     * GrContext::checkAsyncReadbacks(); isFinished() and readPixels() may also call it when they
+     * notice that the readback is done.
+     */
+    typedef void (*FinishedProc)(void* finishedContext, GrAsyncReadback*);
+
+    ~GrAsyncReadback() override;
+
+    int numPlanes() const { return fPlanes.count(); }
+    const SkISize& planeSize(int plane) const { return fPlanes[plane].fSize; }
+    GrPixelConfig planeConfig(int plane) const { return fPlanes[plane].fConfig; }
+
+    /**
+     * Polls the readback without blocking. Returns true once the pixels have landed or the
+     * readback has failed.
+     */
+    bool isFinished();
+
+    /** Returns true if the readback finished without its pixels, e.g. if the context was lost. */
+    bool failed() const { return fFailed; }
+
+    /**
+     * Copies a plane into client memory, blocking until the readback finishes if it hasn't yet.
+     * A rowBytes of zero means rows are tightly packed. Returns false if the readback failed.
+     */
+    bool readPixels(int plane, void* dst, size_t rowBytes);
+
+private:
+    struct Plane {
+        SkISize       fSize;
+        GrPixelConfig fConfig;
+        size_t        fOffset;
+        size_t        fRowBytes;
+    };
+
+    GrAsyncReadback(GrContext*, GrBuffer*, FinishedProc, void* finishedContext);
+
+    void addPlane(const SkISize& size, GrPixelConfig config, size_t offset, size_t rowBytes);
+
+    // Called by GrContext once every plane has been read into the buffer.
+    void setFence(GrFence fence) { fFence = fence; }
+
+    // Waits up to 'timeout' nanoseconds for the fence and finishes the readback if it passed.
+    bool checkFence(uint64_t timeout);
+    // Marks the readback finished and calls the FinishedProc. If the context was lost the fence
+    // is forgotten rather than deleted.
+    void finish(bool failed, bool contextLost = false);
+
+    // Only set while the readback is pending. GrContext fails every pending readback before it
+    // goes away.
+    GrContext*              fContext;
+    SkAutoTUnref<GrBuffer>  fBuffer;
+    GrFence                 fFence;
+    bool                    fFinished;
+    bool                    fFailed;
+    FinishedProc            fFinishedProc;
+    void*                   fFinishedContext;
+    SkSTArray<3, Plane>     fPlanes;
+
+    friend class GrContext; // to create, fence, and finish readbacks
+
+    typedef SkRefCnt INHERITED;
+};
+
+#endif
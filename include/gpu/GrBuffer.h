@@ -27,6 +27,7 @@ public:
     static void ComputeScratchKeyForDynamicVBO(size_t size, GrBufferType, GrScratchKey*);
 
     GrAccessPattern accessPattern() const { return fAccessPattern; }
+    GrBufferType intendedType() const { return fIntendedType; }
     size_t sizeInBytes() const { return fSizeInBytes; }
 
     /**
@@ -123,6 +124,7 @@ private:
     virtual bool onUpdateData(const void* src, size_t srcSizeInBytes);
 
     size_t onGpuMemorySize() const override { return fSizeInBytes; } // TODO: zero for cpu backed?
+    MemoryCategory onGetMemoryCategory() const override { return kBuffer_MemoryCategory; }
     void computeScratchKey(GrScratchKey* key) const override;
 
     size_t            fSizeInBytes;
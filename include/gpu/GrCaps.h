@@ -157,10 +157,22 @@ public:
     bool compressedTexSubImageSupport() const { return fCompressedTexSubImageSupport; }
     bool oversizedStencilSupport() const { return fOversizedStencilSupport; }
     bool textureBarrierSupport() const { return fTextureBarrierSupport; }
+    /**
+     * Can GrGpu insert fences into the command stream and poll or wait for them on the CPU.
+     */
+    bool fenceSyncSupport() const { return fFenceSyncSupport; }
+    /**
+     * Can GrGpu time spans of commands on the GPU with timer queries.
+     */
+    bool timerQuerySupport() const { return fTimerQuerySupport; }
     bool sampleLocationsSupport() const { return fSampleLocationsSupport; }
     bool multisampleDisableSupport() const { return fMultisampleDisableSupport; }
     bool usesMixedSamples() const { return fUsesMixedSamples; }
     bool preferClientSideDynamicBuffers() const { return fPreferClientSideDynamicBuffers; }
+    /**
+     * Can GrGpu::transferPixels() upload texture data from a kXferCpuToGpu_GrBufferType buffer.
+     */
+    bool transferBufferSupport() const { return fTransferBufferSupport; }
 
     bool useDrawInsteadOfClear() const { return fUseDrawInsteadOfClear; }
     bool useDrawInsteadOfPartialRenderTargetWrite() const {
@@ -257,6 +269,10 @@ public:
 
     bool immediateFlush() const { return fImmediateFlush; }
 
+    bool compressUploadedImages() const { return fCompressUploadedImages; }
+
+    bool coverageCountingPathsEnabled() const { return fEnableCoverageCountingPaths; }
+
     size_t bufferMapThreshold() const {
         SkASSERT(fBufferMapThreshold >= 0);
         return fBufferMapThreshold;
@@ -295,10 +311,13 @@ protected:
     bool fCompressedTexSubImageSupport               : 1;
     bool fOversizedStencilSupport                    : 1;
     bool fTextureBarrierSupport                      : 1;
+    bool fFenceSyncSupport                           : 1;
+    bool fTimerQuerySupport                          : 1;
     bool fSampleLocationsSupport                     : 1;
     bool fMultisampleDisableSupport                  : 1;
     bool fUsesMixedSamples                           : 1;
     bool fPreferClientSideDynamicBuffers             : 1;
+    bool fTransferBufferSupport                      : 1;
     bool fSupportsInstancedDraws                     : 1;
     bool fFullClearIsFree                            : 1;
     bool fMustClearUploadedBufferData                : 1;
@@ -333,6 +352,8 @@ private:
 
     bool fSuppressPrints : 1;
     bool fImmediateFlush: 1;
+    bool fCompressUploadedImages : 1;
+    bool fEnableCoverageCountingPaths : 1;
 
     typedef SkRefCnt INHERITED;
 };
@@ -8,12 +8,14 @@
 #ifndef GrContext_DEFINED
 #define GrContext_DEFINED
 
+#include "GrAsyncReadback.h"
 #include "GrCaps.h"
 #include "GrClip.h"
 #include "GrColor.h"
 #include "GrPaint.h"
 #include "GrRenderTarget.h"
 #include "GrTextureProvider.h"
+#include "SkImageInfo.h"
 #include "SkMatrix.h"
 #include "SkPathEffect.h"
 #include "SkTypes.h"
@@ -147,6 +149,13 @@ public:
      */
     void setResourceCacheLimits(int maxResources, size_t maxResourceBytes);
 
+    /**
+     *  Specify how many flushes an unlocked resource may go unused before it is purged, even when
+     *  the cache is under budget. The count is rounded up to a power of two. Passing 0, or a count
+     *  too large to track, turns this purging off.
+     */
+    void setResourceCacheMaxUnusedFlushes(int maxUnusedFlushes);
+
     GrTextureProvider* textureProvider() { return fTextureProvider; }
     const GrTextureProvider* textureProvider() const { return fTextureProvider; }
 
@@ -163,6 +172,14 @@ public:
      */
     void purgeAllUnlockedResources();
 
+    /**
+     * Purges unlocked resources, least recently used first, until the cache holds no more than
+     * maxResourceBytes. The cache limits are unchanged, so the cache can grow back afterwards.
+     * This is meant for memory pressure notifications, which must be forwarded to the thread
+     * that owns the context.
+     */
+    void purgeUnlockedResourcesToBytes(size_t maxResourceBytes);
+
     /** Access the context capabilities */
     const GrCaps* caps() const { return fCaps; }
 
@@ -271,6 +288,50 @@ public:
                            size_t rowBytes = 0,
                            uint32_t pixelOpsFlags = 0);
 
+    /**
+     * Starts reading a rectangle of pixels from a surface without waiting for the GPU. Any pending
+     * writes to the surface are flushed and the pixels are copied into a transfer buffer; the
+     * returned readback finishes once that copy has completed on the GPU.
+     *
+     * Returns nullptr if the read can't be done asynchronously, e.g. if the backend lacks fences
+     * or mappable transfer buffers, or the config can't be read from the surface without a CPU
+     * conversion. Callers should fall back to readSurfacePixels().
+     *
+     * @param surface          the surface to read from.
+     * @param left             left edge of the rectangle to read (inclusive)
+     * @param top              top edge of the rectangle to read (inclusive)
+     * @param width            width of rectangle to read in pixels.
+     * @param height           height of rectangle to read in pixels.
+     * @param config           the pixel config of the single plane of the readback
+     * @param finishedProc     optional, called once the readback finishes or fails
+     * @param finishedContext  passed to finishedProc
+     */
+    sk_sp<GrAsyncReadback> readSurfacePixelsAsync(
+                                GrSurface* surface,
+                                int left, int top, int width, int height,
+                                GrPixelConfig config,
+                                GrAsyncReadback::FinishedProc finishedProc = nullptr,
+                                void* finishedContext = nullptr);
+
+    /**
+     * Like readSurfacePixelsAsync() but converts the whole texture to Y, U, and V planes on the
+     * GPU first, scaling each to its size (e.g. the U and V planes of 4:2:0 are half the Y size),
+     * so only about half the bytes of RGBA are downloaded. The readback has three
+     * kAlpha_8_GrPixelConfig planes.
+     */
+    sk_sp<GrAsyncReadback> readTextureYUVPlanesAsync(
+                                GrTexture* texture,
+                                const SkISize sizes[3],
+                                SkYUVColorSpace,
+                                GrAsyncReadback::FinishedProc finishedProc = nullptr,
+                                void* finishedContext = nullptr);
+
+    /**
+     * Polls the pending async readbacks, calling the FinishedProc of each that has finished. This
+     * is also done at the end of every flush.
+     */
+    void checkAsyncReadbacks();
+
     /**
      * Writes a rectangle of pixels to a surface.
      * @param surface       the surface to write to.
@@ -383,6 +444,10 @@ public:
 
     GrAuditTrail* getAuditTrail() { return &fAuditTrail; }
 
+    /** Waits for the GPU times of the batches flushed while the audit trail was enabled, and adds
+        them to the audit trail. Times are only measured if GrCaps::timerQuerySupport(). */
+    void collectBatchGpuTimes();
+
     /** This is only useful for debug purposes */
     SkDEBUGCODE(GrSingleOwner* debugSingleOwner() const { return &fSingleOwner; } )
 
@@ -432,6 +497,9 @@ private:
 
     SkTDArray<CleanUpData>                  fCleanUpData;
 
+    // Readbacks waiting on their fences. Each holds a ref.
+    SkTDArray<GrAsyncReadback*>             fPendingReadbacks;
+
     const uint32_t                          fUniqueID;
 
     SkAutoTDelete<GrDrawingManager>         fDrawingManager;
@@ -449,6 +517,22 @@ private:
     void initMockContext();
     void initCommon(const GrContextOptions&);
 
+    /**
+     * Copies a rectangle of a surface into a transfer buffer at 'offset', drawing it to a
+     * temporary first if the GrGpu can't read the surface straight into the buffer. The rectangle
+     * must lie within the surface.
+     */
+    bool readSurfaceToBuffer(GrSurface*, const SkIRect&, GrPixelConfig, GrBuffer*, size_t offset);
+
+    /** Fences the readback's reads and starts tracking it. */
+    sk_sp<GrAsyncReadback> startAsyncReadback(sk_sp<GrAsyncReadback>);
+
+    /**
+     * Finishes every pending readback as failed. If the 3D context is lost the fences are
+     * forgotten rather than deleted.
+     */
+    void failAsyncReadbacks(bool contextLost);
+
     /**
      * These functions create premul <-> unpremul effects if it is possible to generate a pair
      * of effects that make a readToUPM->writeToPM->readToUPM cycle invariant. Otherwise, they
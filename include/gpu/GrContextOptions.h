@@ -8,9 +8,27 @@
 #ifndef GrContextOptions_DEFINED
 #define GrContextOptions_DEFINED
 
+#include "SkData.h"
 #include "SkTypes.h"
 
 struct GrContextOptions {
+    /**
+     * Abstract storage the client provides for data Skia wants to keep between sessions, such as
+     * compiled GPU programs.  Keys and data are opaque blobs.  Clients must discard everything
+     * stored when the GPU driver or Skia itself changes; Skia tries to reject stale data, but
+     * can't promise to.
+     */
+    class PersistentCache {
+    public:
+        virtual ~PersistentCache() {}
+
+        /** Returns the data stored under key, or null if there is none. */
+        virtual sk_sp<SkData> load(const SkData& key) = 0;
+
+        /** Stores data under key, replacing anything already there. */
+        virtual void store(const SkData& key, const SkData& data) = 0;
+    };
+
     GrContextOptions()
         : fSuppressPrints(false)
         , fMaxTextureSizeOverride(SK_MaxS32)
@@ -24,7 +42,12 @@ struct GrContextOptions {
         , fMaxBatchLookback(-1)
         , fMaxBatchLookahead(-1)
         , fUseShaderSwizzling(false)
-        , fDoManualMipmapping(false) {}
+        , fDoManualMipmapping(false)
+        , fPersistentCache(nullptr)
+        , fParallelShaderCompile(false)
+        , fCompressUploadedImages(false)
+        , fCompileGLShadersWithSkSL(false)
+        , fEnableCoverageCountingPaths(false) {}
 
     // Suppress prints for the GrContext.
     bool fSuppressPrints;
@@ -60,8 +83,8 @@ struct GrContextOptions {
         of their dev bounds. */
     bool fDrawBatchBounds;
 
-    /** For debugging, override the default maximum look-back or look-ahead window for GrBatch
-        combining. */
+    /** For debugging, override the default maximum number of earlier or later batches of the
+        same class that a GrBatch tries to combine with. */
     int fMaxBatchLookback;
     int fMaxBatchLookahead;
 
@@ -73,6 +96,32 @@ struct GrContextOptions {
         the driver's implementation (glGenerateMipmap) contains bugs. This requires mipmap
         level and LOD control (ie desktop or ES3). */
     bool fDoManualMipmapping;
+
+    /** If non-null, program binaries are loaded from and stored to this cache, so programs don't
+        have to be compiled again each time the app starts.  It's not owned by the GrContext and
+        must outlive it. */
+    PersistentCache* fPersistentCache;
+
+    /** Where the driver can compile shaders on its own threads (KHR_parallel_shader_compile),
+        let it use as many as it likes, and don't wait on a shader's compile status before
+        linking it into a program. */
+    bool fParallelShaderCompile;
+
+    /** Compress opaque raster images to ETC1 on the CPU as they're uploaded, where the GPU
+        supports ETC1 textures and the image's dimensions are multiples of 4.  The textures take
+        an eighth of the memory (a quarter for 565), so more fit in the resource cache budget,
+        at some cost in quality and upload time. */
+    bool fCompressUploadedImages;
+
+    /** Run GL vertex and fragment shaders through the SkSL compiler, which folds constants,
+        drops dead code and inlines small functions before the driver sees them.  Only used with
+        GLSL 1.40+ or GLSL ES 3.00+; shaders SkSL can't handle are passed through unchanged. */
+    bool fCompileGLShadersWithSkSL;
+
+    /** Draw small antialiased path fills by counting their coverage into a shared floating point
+        atlas (GrCoverageCountingPathRenderer), where half float targets are renderable.  Still
+        experimental, so it's off unless asked for. */
+    bool fEnableCoverageCountingPaths;
 };
 
 #endif
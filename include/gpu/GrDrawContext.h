@@ -29,6 +29,7 @@ class GrDrawTarget;
 class GrPaint;
 class GrPathProcessor;
 class GrPipelineBuilder;
+class GrReducedClipCache;
 class GrRenderTarget;
 class GrStyle;
 class GrSurface;
@@ -126,6 +127,17 @@ public:
                                  const SkRect& rect,
                                  const SkMatrix& localMatrix);
 
+    /**
+     * Fills a round rect with a paint and a localMatrix. This is only possible with instanced
+     * rendering; returns false, without drawing anything, if the draw couldn't be recorded that
+     * way.
+     */
+    bool fillRRectWithLocalMatrix(const GrClip& clip,
+                                  const GrPaint& paint,
+                                  const SkMatrix& viewMatrix,
+                                  const SkRRect& rrect,
+                                  const SkMatrix& localMatrix);
+
     /**
      *  Draw a roundrect using a paint.
      *
@@ -307,6 +319,7 @@ private:
     // All the path renderers currently make their own batches
     friend class GrSoftwarePathRenderer;         // for access to drawBatch
     friend class GrAAConvexPathRenderer;         // for access to drawBatch
+    friend class GrCoverageCountingPathRenderer; // for access to drawBatch
     friend class GrDashLinePathRenderer;         // for access to drawBatch
     friend class GrAAHairLinePathRenderer;       // for access to drawBatch
     friend class GrAALinearizingConvexPathRenderer;  // for access to drawBatch
@@ -362,6 +375,9 @@ private:
     SkSurfaceProps                    fSurfaceProps;
     GrAuditTrail*                     fAuditTrail;
 
+    // Made on first use by GrClipMaskManager.
+    SkAutoTDelete<GrReducedClipCache> fReducedClipCache;
+
     // In debug builds we guard against improper thread handling
     SkDEBUGCODE(mutable GrSingleOwner* fSingleOwner;)
 };
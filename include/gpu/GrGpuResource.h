@@ -201,6 +201,26 @@ public:
      */
     const SkData* getCustomData() const { return fData.get(); }
 
+    /**
+     * The groups that GrContext::dumpMemoryStatistics totals the resources' memory by.
+     */
+    enum MemoryCategory {
+        kTexture_MemoryCategory,
+        kAtlas_MemoryCategory,
+        kBuffer_MemoryCategory,
+        kRenderTarget_MemoryCategory,
+        // Render targets that are recycled through their scratch key rather than found by a unique
+        // key.
+        kScratchRenderTarget_MemoryCategory,
+        kOther_MemoryCategory,
+
+        kLast_MemoryCategory = kOther_MemoryCategory
+    };
+    static const int kMemoryCategoryCount = kLast_MemoryCategory + 1;
+
+    /** Returns the category this resource's memory is accounted under. */
+    MemoryCategory memoryCategory() const;
+
     /**
      * Internal-only helper class used for manipulations of the resource by the cache.
      */
@@ -266,6 +286,12 @@ protected:
      **/
     virtual void setMemoryBacking(SkTraceMemoryDump*, const SkString&) const {}
 
+    /**
+     * Subclasses override this to give the category their memory falls under by default. Users of
+     * a resource can further mark it as an atlas through ResourcePriv.
+     */
+    virtual MemoryCategory onGetMemoryCategory() const { return kOther_MemoryCategory; }
+
 private:
     /**
      * Called by the registerWithCache if the resource is available to be used as scratch.
@@ -315,6 +341,7 @@ private:
 
     SkBudgeted                  fBudgeted;
     bool                        fRefsWrappedObjects;
+    bool                        fIsAtlas;
     const uint32_t              fUniqueID;
 
     SkAutoTUnref<const SkData>  fData;
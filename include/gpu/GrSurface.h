@@ -163,6 +163,10 @@ protected:
     void onRelease() override;
     void onAbandon() override;
 
+    MemoryCategory onGetMemoryCategory() const override {
+        return this->asRenderTarget() ? kRenderTarget_MemoryCategory : kTexture_MemoryCategory;
+    }
+
 private:
     void invokeReleaseProc() {
         if (fReleaseProc) {
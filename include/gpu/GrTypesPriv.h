@@ -479,6 +479,16 @@ enum GrAccessPattern {
 #define GrCapsDebugf(caps, ...)
 #endif
 
+/**
+ * A marker a GrGpu inserts into its command stream. Zero is never a valid fence.
+ */
+typedef uint64_t GrFence;
+
+/**
+ * A query a GrGpu uses to time a span of commands on the GPU. Zero is never a valid query.
+ */
+typedef uint64_t GrTimerQuery;
+
 /**
  * Specifies if the holder owns the backend, OpenGL or Vulkan, object.
  */
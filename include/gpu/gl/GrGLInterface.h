@@ -128,6 +128,7 @@ public:
         GrGLFunction<GrGLClearProc> fClear;
         GrGLFunction<GrGLClearColorProc> fClearColor;
         GrGLFunction<GrGLClearStencilProc> fClearStencil;
+        GrGLFunction<GrGLClientWaitSyncProc> fClientWaitSync;
         GrGLFunction<GrGLColorMaskProc> fColorMask;
         GrGLFunction<GrGLCompileShaderProc> fCompileShader;
         GrGLFunction<GrGLCompressedTexImage2DProc> fCompressedTexImage2D;
@@ -142,6 +143,7 @@ public:
         GrGLFunction<GrGLDeleteQueriesProc> fDeleteQueries;
         GrGLFunction<GrGLDeleteRenderbuffersProc> fDeleteRenderbuffers;
         GrGLFunction<GrGLDeleteShaderProc> fDeleteShader;
+        GrGLFunction<GrGLDeleteSyncProc> fDeleteSync;
         GrGLFunction<GrGLDeleteTexturesProc> fDeleteTextures;
         GrGLFunction<GrGLDeleteVertexArraysProc> fDeleteVertexArrays;
         GrGLFunction<GrGLDepthMaskProc> fDepthMask;
@@ -158,6 +160,7 @@ public:
         GrGLFunction<GrGLEnableProc> fEnable;
         GrGLFunction<GrGLEnableVertexAttribArrayProc> fEnableVertexAttribArray;
         GrGLFunction<GrGLEndQueryProc> fEndQuery;
+        GrGLFunction<GrGLFenceSyncProc> fFenceSync;
         GrGLFunction<GrGLFinishProc> fFinish;
         GrGLFunction<GrGLFlushProc> fFlush;
         GrGLFunction<GrGLFlushMappedBufferRangeProc> fFlushMappedBufferRange;
@@ -182,6 +185,7 @@ public:
         GrGLFunction<GrGLGetQueryObjectui64vProc> fGetQueryObjectui64v;
         GrGLFunction<GrGLGetQueryObjectuivProc> fGetQueryObjectuiv;
         GrGLFunction<GrGLGetQueryivProc> fGetQueryiv;
+        GrGLFunction<GrGLGetProgramBinaryProc> fGetProgramBinary;
         GrGLFunction<GrGLGetProgramInfoLogProc> fGetProgramInfoLog;
         GrGLFunction<GrGLGetProgramivProc> fGetProgramiv;
         GrGLFunction<GrGLGetRenderbufferParameterivProc> fGetRenderbufferParameteriv;
@@ -206,10 +210,13 @@ public:
         GrGLFunction<GrGLMapBufferRangeProc> fMapBufferRange;
         GrGLFunction<GrGLMapBufferSubDataProc> fMapBufferSubData;
         GrGLFunction<GrGLMapTexSubImage2DProc> fMapTexSubImage2D;
+        GrGLFunction<GrGLMaxShaderCompilerThreadsProc> fMaxShaderCompilerThreads;
         GrGLFunction<GrGLMultiDrawArraysIndirectProc> fMultiDrawArraysIndirect;
         GrGLFunction<GrGLMultiDrawElementsIndirectProc> fMultiDrawElementsIndirect;
         GrGLFunction<GrGLPixelStoreiProc> fPixelStorei;
         GrGLFunction<GrGLPopGroupMarkerProc> fPopGroupMarker;
+        GrGLFunction<GrGLProgramBinaryProc> fProgramBinary;
+        GrGLFunction<GrGLProgramParameteriProc> fProgramParameteri;
         GrGLFunction<GrGLPushGroupMarkerProc> fPushGroupMarker;
         GrGLFunction<GrGLQueryCounterProc> fQueryCounter;
         GrGLFunction<GrGLRasterSamplesProc> fRasterSamples;
@@ -58,6 +58,7 @@ typedef signed long int GrGLintptr;
 typedef signed long int GrGLsizeiptr;
 #endif
 typedef void* GrGLeglImage;
+typedef struct __GLsync* GrGLsync;
 
 struct GrGLDrawArraysIndirectCommand {
     GrGLuint fCount;
@@ -0,0 +1,56 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPNGEncoder_DEFINED
+#define SkPNGEncoder_DEFINED
+
+#include "SkTypes.h"
+
+class SkBitmap;
+class SkPixmap;
+class SkWStream;
+
+namespace SkPNGEncoder {
+
+enum Strategy {
+    kAuto_Strategy,         // Filtered for filtered rows, default for palette images.
+    kDefault_Strategy,
+    kFiltered_Strategy,
+    kHuffmanOnly_Strategy,
+    kRLE_Strategy,
+};
+
+struct Options {
+    Options() : fZLibLevel(6), fStrategy(kAuto_Strategy), fMultiThreaded(true) {}
+
+    /** zlib compression level, from 0 (store only) to 9 (smallest). */
+    int      fZLibLevel;
+    Strategy fStrategy;
+    /**
+     *  If true, large images are filtered and compressed in bands of rows on SkTaskGroup
+     *  threads.  Each band starts a new deflate block primed with the previous band's data,
+     *  so the output stays close in size to a serial encode.
+     */
+    bool     fMultiThreaded;
+};
+
+/**
+ *  Encode the bitmap as a PNG, the way SkImageEncoder::kPNG_Type does, but with these
+ *  options rather than the defaults.  Only available where PNGs are encoded with libpng,
+ *  i.e. not on Mac, iOS or Windows.
+ */
+SK_API bool Encode(SkWStream*, const SkBitmap&, const Options&);
+
+/**
+ *  Encode the pixels directly.  Every color type but F16 is converted to what PNG expects a
+ *  row at a time (unpremultiplying and swizzling as needed), so no copy of the image is made.
+ */
+SK_API bool Encode(SkWStream*, const SkPixmap&, const Options&);
+
+}
+
+#endif  // SkPNGEncoder_DEFINED
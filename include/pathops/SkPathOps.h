@@ -10,6 +10,7 @@
 #include "../private/SkTArray.h"
 #include "../private/SkTDArray.h"
 #include "SkPreConfig.h"
+#include "SkScalar.h"
 
 class SkPath;
 struct SkRect;
@@ -59,6 +60,21 @@ bool SK_API Op(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result
   */
 bool SK_API Simplify(const SkPath& path, SkPath* result);
 
+/** Like Simplify(), but for paths that will only be drawn. Curves are replaced by lines, and
+    all points are snapped to a grid with tolerance spacing, so the result may be off by about
+    tolerance from the exact one, and only contains lines. This is usually several times faster
+    than Simplify(), and its integer arithmetic is not thrown off by nearly coincident edges.
+
+    Returns true if operation was able to produce a result;
+    otherwise, result is unmodified.
+
+    @param path The path to simplify.
+    @param tolerance The grid spacing, e.g. 1/4 of a device pixel. Must be greater than zero.
+    @param result The simplified path. The result may be the input.
+    @return True if simplification succeeded.
+  */
+bool SK_API ApproximateSimplify(const SkPath& path, SkScalar tolerance, SkPath* result);
+
 /** Set the resulting rectangle to the tight bounds of the path.
 
     @param path The path measured.
@@ -80,7 +96,8 @@ public:
     void add(const SkPath& path, SkPathOp _operator);
 
     /** Computes the sum of all paths and operands, and resets the builder to its
-        initial state.
+        initial state. If every operand is a union, all of the paths are combined in a
+        single pass instead of one operation at a time.
  
         @param result The product of the operands.
         @return True if the operation succeeded.
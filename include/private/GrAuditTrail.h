@@ -86,7 +86,10 @@ public:
 
     void addBatch(const GrBatch* batch);
 
-    void batchingResultCombined(const GrBatch* consumer, const GrBatch* consumed);
+    // 'forward' is true when an earlier batch is combined into a later one as the batches are
+    // closed, rather than a new batch into an earlier one as it's recorded.
+    void batchingResultCombined(const GrBatch* consumer, const GrBatch* consumed,
+                                bool forward = false);
 
     // Because batching is heavily dependent on sequence of draw calls, these calls will only
     // produce valid information for the given draw sequence which preceeded them.
@@ -116,6 +119,32 @@ public:
         SkTArray<Batch> fBatches;
     };
 
+    // How many batches have been added since the last fullReset(), and how many of those were
+    // then combined into another batch, so callers can measure how many draws batching saves.
+    struct CombineStats {
+        CombineStats() : fBatchesAdded(0), fCombinedBackward(0), fCombinedForward(0) {}
+        int fBatchesAdded;
+        int fCombinedBackward;
+        int fCombinedForward;
+
+        int combined() const { return fCombinedBackward + fCombinedForward; }
+        float combineRate() const {
+            return fBatchesAdded ? (float)this->combined() / fBatchesAdded : 0;
+        }
+    };
+    const CombineStats& combineStats() const { return fCombineStats; }
+
+    // Adds the time a batch took to execute on the GPU, as measured by GrBatchTimer. Times are
+    // summed per batch class, and also recorded on the batch's node if it's still in the log.
+    void addBatchGpuTime(uint32_t batchUniqueID, const char* name, uint64_t nanoseconds);
+
+    struct BatchGpuTime {
+        SkString fName;
+        int fCount;
+        uint64_t fNanoseconds;
+    };
+    const SkTArray<BatchGpuTime>& batchGpuTimes() const { return fBatchGpuTimes; }
+
     void getBoundsByClientID(SkTArray<BatchInfo>* outInfo, int clientID);
     void getBoundsByBatchListID(BatchInfo* outInfo, int batchListID);
 
@@ -143,6 +172,8 @@ private:
         SkRect fBounds;
         Batches fChildren;
         uint32_t fRenderTargetUniqueID;
+        bool fHasGpuTime;
+        uint64_t fGpuNanoseconds;
     };
     typedef SkTArray<SkAutoTDelete<BatchNode>, true> BatchList;
 
@@ -157,6 +188,8 @@ private:
     SkTHashMap<int, Batches*> fClientIDLookup;
     BatchList fBatchList;
     SkTArray<SkString> fCurrentStackTrace;
+    CombineStats fCombineStats;
+    SkTArray<BatchGpuTime> fBatchGpuTimes;
 
     // The client cas pass in an optional client ID which we will use to mark the batches
     int fClientID;
@@ -180,6 +213,9 @@ private:
 #define GR_AUDIT_TRAIL_BATCHING_RESULT_COMBINED(audit_trail, combineWith, batch) \
     GR_AUDIT_TRAIL_INVOKE_GUARD(audit_trail, batchingResultCombined, combineWith, batch);
 
+#define GR_AUDIT_TRAIL_BATCHING_RESULT_COMBINED_FORWARD(audit_trail, combineWith, batch) \
+    GR_AUDIT_TRAIL_INVOKE_GUARD(audit_trail, batchingResultCombined, combineWith, batch, true);
+
 #define GR_AUDIT_TRAIL_BATCHING_RESULT_NEW(audit_trail, batch) \
     // Doesn't do anything now, one day... 
 
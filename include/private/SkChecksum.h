@@ -50,6 +50,10 @@ public:
      *  @param size Size of the data block in bytes.
      *  @param seed Initial hash seed. (optional)
      *  @return hash result
+     *
+     *  Murmur3 is the same on every CPU, so its results may be stored or sent elsewhere.
+     *  Hash tables and caches that only live in memory should prefer SkOpts::hash(), which
+     *  can use faster CPU-specific instructions.
      */
     static uint32_t Murmur3(const void* data, size_t bytes, uint32_t seed=0);
 };
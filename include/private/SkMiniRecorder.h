@@ -14,15 +14,21 @@
 class SkCanvas;
 
 // Records small pictures, but only a limited subset of the canvas API, and may fail.
+// Up to kMaxOps draws are held inline, so these pictures never need an SkRecord.
 class SkMiniRecorder : SkNoncopyable {
 public:
     SkMiniRecorder();
     ~SkMiniRecorder();
 
+    // The most ops we'll record.  Pictures any bigger are better off as SkBigPictures.
+    static const int kMaxOps = 8;
+
     // Try to record an op.  Returns false on failure.
     bool drawBitmapRect(const SkBitmap&, const SkRect* src, const SkRect& dst,
                         const SkPaint*, SkCanvas::SrcRectConstraint);
+    bool drawOval(const SkRect&, const SkPaint&);
     bool drawPath(const SkPath&, const SkPaint&);
+    bool drawRRect(const SkRRect&, const SkPaint&);
     bool drawRect(const SkRect&, const SkPaint&);
     bool drawTextBlob(const SkTextBlob*, SkScalar x, SkScalar y, const SkPaint&);
 
@@ -36,25 +42,40 @@ public:
     void flushAndReset(SkCanvas*);
 
 private:
-    enum class State {
-        kEmpty,
+    friend class SkMiniOpsPicture;
+
+    enum class Type : uint8_t {
         kDrawBitmapRectFixedSize,
+        kDrawOval,
         kDrawPath,
+        kDrawRRect,
         kDrawRect,
         kDrawTextBlob,
     };
 
-    State fState;
+    // Calls fn(op) with op cast to the real type, returning the size of that type.
+    template <typename Fn>
+    static size_t Visit(Type, void* op, Fn&);
 
     template <size_t A, size_t B>
     struct Max { static const size_t val = A > B ? A : B; };
 
     static const size_t kInlineStorage =
         Max<sizeof(SkRecords::DrawBitmapRectFixedSize),
+        Max<sizeof(SkRecords::DrawOval),
         Max<sizeof(SkRecords::DrawPath),
+        Max<sizeof(SkRecords::DrawRRect),
         Max<sizeof(SkRecords::DrawRect),
-            sizeof(SkRecords::DrawTextBlob)>::val>::val>::val;
-    SkAlignedSStorage<kInlineStorage> fBuffer;
+            sizeof(SkRecords::DrawTextBlob)>::val>::val>::val>::val>::val;
+
+    struct Slot {
+        Type    fType;
+        SkPaint fPaint;  // The paint of the op in fBuffer, which points to it.
+        SkAlignedSStorage<kInlineStorage> fBuffer;
+    };
+
+    int  fCount;
+    Slot fSlots[kMaxOps];
 };
 
 #endif//SkMiniRecorder_DEFINED
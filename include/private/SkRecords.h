@@ -210,7 +210,7 @@ RECORD(Save, 0);
 
 RECORD(SaveLayer, 0,
        Optional<SkRect> bounds;
-       Optional<SkPaint> paint;
+       const SkPaint* paint;
        RefBox<const SkImageFilter> backdrop;
        SkCanvas::SaveLayerFlags saveLayerFlags);
 
@@ -246,35 +246,40 @@ RECORD(ClipRegion, 0,
         SkRegion region;
         SkRegion::Op op);
 
+// Paints live in the SkRecord's paint table (see SkRecord::internPaint()), and ops just point at
+// them, so identical paints are stored once and aren't ref'd and unref'd for every op that uses
+// them.  They're shared, so never mutate one in place: intern a modified copy instead.
+// A null paint means the call was made with no paint.  Only ops with an optional paint have one.
+//
 // While not strictly required, if you have an SkPaint, it's fastest to put it first.
 RECORD(DrawBitmap, kDraw_Tag|kHasImage_Tag,
-        Optional<SkPaint> paint;
+        const SkPaint* paint;
         ImmutableBitmap bitmap;
         SkScalar left;
         SkScalar top);
 RECORD(DrawBitmapNine, kDraw_Tag|kHasImage_Tag,
-        Optional<SkPaint> paint;
+        const SkPaint* paint;
         ImmutableBitmap bitmap;
         SkIRect center;
         SkRect dst);
 RECORD(DrawBitmapRect, kDraw_Tag|kHasImage_Tag,
-        Optional<SkPaint> paint;
+        const SkPaint* paint;
         ImmutableBitmap bitmap;
         Optional<SkRect> src;
         SkRect dst);
 RECORD(DrawBitmapRectFast, kDraw_Tag|kHasImage_Tag,
-        Optional<SkPaint> paint;
+        const SkPaint* paint;
         ImmutableBitmap bitmap;
         Optional<SkRect> src;
         SkRect dst);
 RECORD(DrawBitmapRectFixedSize, kDraw_Tag|kHasImage_Tag,
-        SkPaint paint;
+        const SkPaint* paint;
         ImmutableBitmap bitmap;
         SkRect src;
         SkRect dst;
         SkCanvas::SrcRectConstraint constraint);
 RECORD(DrawDRRect, kDraw_Tag,
-        SkPaint paint;
+        const SkPaint* paint;
         SkRRect outer;
         SkRRect inner);
 RECORD(DrawDrawable, kDraw_Tag,
@@ -282,86 +287,86 @@ RECORD(DrawDrawable, kDraw_Tag,
         SkRect worstCaseBounds;
         int32_t index);
 RECORD(DrawImage, kDraw_Tag|kHasImage_Tag,
-        Optional<SkPaint> paint;
+        const SkPaint* paint;
         RefBox<const SkImage> image;
         SkScalar left;
         SkScalar top);
 RECORD(DrawImageRect, kDraw_Tag|kHasImage_Tag,
-        Optional<SkPaint> paint;
+        const SkPaint* paint;
         RefBox<const SkImage> image;
         Optional<SkRect> src;
         SkRect dst;
         SkCanvas::SrcRectConstraint constraint);
 RECORD(DrawImageNine, kDraw_Tag|kHasImage_Tag,
-        Optional<SkPaint> paint;
+        const SkPaint* paint;
         RefBox<const SkImage> image;
         SkIRect center;
         SkRect dst);
 RECORD(DrawOval, kDraw_Tag,
-        SkPaint paint;
+        const SkPaint* paint;
         SkRect oval);
 RECORD(DrawPaint, kDraw_Tag,
-        SkPaint paint);
+        const SkPaint* paint);
 RECORD(DrawPath, kDraw_Tag,
-        SkPaint paint;
+        const SkPaint* paint;
         PreCachedPath path);
 RECORD(DrawPicture, kDraw_Tag,
-        Optional<SkPaint> paint;
+        const SkPaint* paint;
         RefBox<const SkPicture> picture;
         TypedMatrix matrix);
 RECORD(DrawPoints, kDraw_Tag,
-        SkPaint paint;
+        const SkPaint* paint;
         SkCanvas::PointMode mode;
         unsigned count;
         SkPoint* pts);
 RECORD(DrawPosText, kDraw_Tag|kHasText_Tag,
-        SkPaint paint;
+        const SkPaint* paint;
         PODArray<char> text;
         size_t byteLength;
         PODArray<SkPoint> pos);
 RECORD(DrawPosTextH, kDraw_Tag|kHasText_Tag,
-        SkPaint paint;
+        const SkPaint* paint;
         PODArray<char> text;
         unsigned byteLength;
         SkScalar y;
         PODArray<SkScalar> xpos);
 RECORD(DrawRRect, kDraw_Tag,
-        SkPaint paint;
+        const SkPaint* paint;
         SkRRect rrect);
 RECORD(DrawRect, kDraw_Tag,
-        SkPaint paint;
+        const SkPaint* paint;
         SkRect rect);
 RECORD(DrawText, kDraw_Tag|kHasText_Tag,
-        SkPaint paint;
+        const SkPaint* paint;
         PODArray<char> text;
         size_t byteLength;
         SkScalar x;
         SkScalar y);
 RECORD(DrawTextBlob, kDraw_Tag|kHasText_Tag,
-        SkPaint paint;
+        const SkPaint* paint;
         RefBox<const SkTextBlob> blob;
         SkScalar x;
         SkScalar y);
 RECORD(DrawTextOnPath, kDraw_Tag|kHasText_Tag,
-        SkPaint paint;
+        const SkPaint* paint;
         PODArray<char> text;
         size_t byteLength;
         PreCachedPath path;
         TypedMatrix matrix);
 RECORD(DrawTextRSXform, kDraw_Tag|kHasText_Tag,
-        SkPaint paint;
+        const SkPaint* paint;
         PODArray<char> text;
         size_t byteLength;
         PODArray<SkRSXform> xforms;
         Optional<SkRect> cull);
 RECORD(DrawPatch, kDraw_Tag,
-        SkPaint paint;
+        const SkPaint* paint;
         PODArray<SkPoint> cubics;
         PODArray<SkColor> colors;
         PODArray<SkPoint> texCoords;
         RefBox<SkXfermode> xmode);
 RECORD(DrawAtlas, kDraw_Tag|kHasImage_Tag,
-        Optional<SkPaint> paint;
+        const SkPaint* paint;
         RefBox<const SkImage> atlas;
         PODArray<SkRSXform> xforms;
         PODArray<SkRect> texs;
@@ -370,7 +375,7 @@ RECORD(DrawAtlas, kDraw_Tag|kHasImage_Tag,
         SkXfermode::Mode mode;
         Optional<SkRect> cull);
 RECORD(DrawVertices, kDraw_Tag,
-        SkPaint paint;
+        const SkPaint* paint;
         SkCanvas::VertexMode vmode;
         int vertexCount;
         PODArray<SkPoint> vertices;
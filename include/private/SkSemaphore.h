@@ -15,7 +15,7 @@
 class SkBaseSemaphore {
 public:
     constexpr SkBaseSemaphore(int count = 0)
-        : fCount(count), fOSSemaphore(nullptr) {}
+        : fCount(count), fSpinEstimate(0), fOSSemaphore(nullptr) {}
 
     // Increment the counter n times.
     // Generally it's better to call signal(n) instead of signal() n times.
@@ -25,6 +25,9 @@ public:
     // then if the counter is <= 0, sleep this thread until the counter is > 0.
     void wait();
 
+    // If the counter is > 0, decrement it by 1 and return true.  Otherwise return false.
+    bool try_wait();
+
     // SkBaseSemaphore has no destructor.  Call this to clean it up.
     void cleanup();
 
@@ -38,12 +41,18 @@ private:
     // We wrap an OS-provided semaphore with a user-space atomic counter that
     // lets us avoid interacting with the OS semaphore unless strictly required:
     // moving the count from >0 to <=0 or vice-versa, i.e. sleeping or waking threads.
+    //
+    // Before committing to sleep, wait() spins for a while retrying try_wait().  Most of our
+    // critical sections are short, so the holder usually signals before a syscall would return.
+    // How long we spin adapts to how long spinning has recently taken to succeed.
     struct OSSemaphore;
 
+    void waitSlow();
     void osSignal(int n);
     void osWait();
 
     std::atomic<int> fCount;
+    std::atomic<int> fSpinEstimate;
     SkOnce           fOSSemaphoreOnce;
     OSSemaphore*     fOSSemaphore;
 };
@@ -72,11 +81,15 @@ inline void SkBaseSemaphore::signal(int n) {
     }
 }
 
+inline bool SkBaseSemaphore::try_wait() {
+    int count = fCount.load(std::memory_order_relaxed);
+    return count > 0 &&
+           fCount.compare_exchange_strong(count, count-1, std::memory_order_acquire);
+}
+
 inline void SkBaseSemaphore::wait() {
-    // Since this fetches the value before the subtract, zero and below means that there are no
-    // resources left, so the thread needs to wait.
-    if (fCount.fetch_sub(1, std::memory_order_acquire) <= 0) {
-        this->osWait();
+    if (!this->try_wait()) {
+        this->waitSlow();
     }
 }
 
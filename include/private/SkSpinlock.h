@@ -23,6 +23,11 @@ public:
         }
     }
 
+    // Returns true if we took the lock, false if someone else holds it.
+    bool tryAcquire() {
+        return !fLocked.exchange(true, std::memory_order_acquire);
+    }
+
     void release() {
         // To act as a mutex, we need a release barrier when we release the lock.
         fLocked.store(false, std::memory_order_release);
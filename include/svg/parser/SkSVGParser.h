@@ -11,6 +11,7 @@
 #define SkSVGParser_DEFINED
 
 #include "SkMatrix.h"
+#include "SkData.h"
 #include "../private/SkTDict.h"
 #include "SkSVGPaintState.h"
 #include "SkSVGTypes.h"
@@ -34,7 +35,9 @@ public:
         fXMLWriter.addAttributeLen(attrName, attrValue, len); }
     void _endElement() { fXMLWriter.endElement(); }
     int findAttribute(SkSVGBase* , const char* attrValue, size_t len, bool isPaint);
-//    const char* getFinal();
+    // Returns the parsed document translated for SkAnimator.  Consumes the parsed elements, so it
+    // may only be called once.
+    sk_sp<SkData> getFinal();
     SkTDict<SkSVGElement*>& getIDs() { return fIDs; }
     SkString& getPaintLast(SkSVGPaint::Field field);
     void _startElement(const char name[]) { fXMLWriter.startElement(name); }
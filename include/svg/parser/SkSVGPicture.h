@@ -0,0 +1,61 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkSVGPicture_DEFINED
+#define SkSVGPicture_DEFINED
+
+#include "SkPicture.h"
+#include "SkRect.h"
+#include "SkRefCnt.h"
+
+#include <memory>
+
+class SkAnimator;
+class SkCanvas;
+class SkStream;
+
+/**
+ *  An SVG document, parsed and translated for drawing once, and recorded into a picture the
+ *  first time it is drawn.  Styles, units and references are resolved by the translation, so
+ *  drawing it again -- at any size -- just plays back the picture.
+ */
+class SkSVGPicture : SkNoncopyable {
+public:
+    /**
+     *  Parse the SVG in stream.  size is the size of the document's drawing, which draw() scales
+     *  to fit its destination.  Returns nullptr if the document cannot be parsed.
+     */
+    static std::unique_ptr<SkSVGPicture> Make(SkStream* stream, const SkSize& size);
+
+    ~SkSVGPicture();
+
+    const SkSize& size() const { return fSize; }
+
+    /**
+     *  Returns the document recorded into a picture, with a bounding box hierarchy.  The picture
+     *  is kept, and recorded again only after an attribute changes.
+     */
+    sk_sp<SkPicture> picture();
+
+    /** Draw the document scaled to fill dst. */
+    void draw(SkCanvas* canvas, const SkRect& dst);
+
+    /**
+     *  Set the attribute of the element with the given id, in the translated document, to value.
+     *  Returns false, leaving the document unchanged, if there is no such element or attribute.
+     */
+    bool setAttribute(const char elementID[], const char attribute[], const char value[]);
+
+private:
+    SkSVGPicture(std::unique_ptr<SkAnimator>, const SkSize&);
+
+    std::unique_ptr<SkAnimator> fAnimator;
+    SkSize                      fSize;
+    sk_sp<SkPicture>            fPicture;
+};
+
+#endif
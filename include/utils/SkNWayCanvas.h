@@ -12,6 +12,11 @@
 #include "../private/SkTDArray.h"
 #include "SkCanvas.h"
 
+#include <memory>
+
+class SkRecord;
+class SkRecorder;
+
 class SK_API SkNWayCanvas : public SkCanvas {
 public:
     SkNWayCanvas(int width, int height);
@@ -21,6 +26,19 @@ public:
     virtual void removeCanvas(SkCanvas*);
     virtual void removeAll();
 
+    /**
+     *  In parallel mode, calls are recorded rather than forwarded to the canvases as they are
+     *  made.  flush() then plays the recording back into all of them at once, one task per
+     *  canvas, so drawing to several canvases costs about as much as drawing to the slowest one
+     *  rather than to each in turn.  Playback also happens when the recording grows large, when
+     *  canvases are added or removed, when parallel mode is turned off, and on destruction.
+     *
+     *  The canvases must be safe to draw to from any thread (e.g. raster and PDF canvases), and
+     *  should not be used directly until flush() returns.
+     */
+    void setParallel(bool parallel);
+    bool isParallel() const { return fRecorder != nullptr; }
+
     ///////////////////////////////////////////////////////////////////////////
     // These are forwarded to the N canvases we're referencing
 
@@ -31,6 +49,11 @@ public:
 protected:
     SkTDArray<SkCanvas*> fList;
 
+    // The canvases calls are forwarded to: fList, or just the recorder in parallel mode.
+    const SkTDArray<SkCanvas*>& targets() const { return fRecorder ? fRecorderList : fList; }
+
+    void onFlush() override;
+
     void willSave() override;
     SaveLayerStrategy getSaveLayerStrategy(const SaveLayerRec&) override;
     void willRestore() override;
@@ -86,6 +109,16 @@ protected:
     class Iter;
 
 private:
+    class Flusher;
+
+    // Plays what has been recorded in parallel mode back into the canvases in fList.
+    void playback();
+
+    sk_sp<SkRecord>          fRecord;
+    sk_sp<SkRecorder>        fRecorder;
+    SkTDArray<SkCanvas*>     fRecorderList;
+    std::unique_ptr<Flusher> fFlusher;
+
     typedef SkCanvas INHERITED;
 };
 
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPipe_DEFINED
+#define SkPipe_DEFINED
+
+#include "SkRect.h"
+#include "SkRefCnt.h"
+
+#include <memory>
+
+class SkCanvas;
+class SkPipeCanvas;
+class SkPipePlayer;
+class SkPipeWriter;
+class SkStream;
+class SkWStream;
+
+/**
+ *  Records the draws made to a canvas as a compact stream of commands, one frame at a time, to
+ *  be played back by an SkPipeDeserializer, typically in another process or on another machine.
+ *
+ *  The resources the draws use -- paints, paths, typefaces, images and text blobs -- are sent
+ *  once, the first time a frame uses them, and are referred to by an ID from then on.  Both ends
+ *  keep them across frames, so a frame carries only its commands and the resources that are new
+ *  to it.  Nothing is ever forgotten until resetCache() is called, so a client that keeps making
+ *  new resources (e.g. animating a paint's color) should call it from time to time.
+ */
+class SK_API SkPipeSerializer {
+public:
+    SkPipeSerializer();
+    ~SkPipeSerializer();
+
+    /**
+     *  Start a frame.  Draw it into the returned canvas, which belongs to the serializer and is
+     *  only valid until endWrite().  The frame's commands are written to stream by endWrite().
+     */
+    SkCanvas* beginWrite(const SkRect& cullBounds, SkWStream* stream);
+
+    /** Finish the frame started by beginWrite(), writing it to the stream. */
+    void endWrite();
+
+    /**
+     *  Forget every resource sent so far.  The deserializer forgets them too when it plays the
+     *  next frame, and any still in use are sent again.  Must not be called during a frame.
+     */
+    void resetCache();
+
+private:
+    std::unique_ptr<SkPipeWriter>   fWriter;
+    sk_sp<SkPipeCanvas>             fCanvas;
+    SkWStream*                      fStream;
+};
+
+/**
+ *  Plays back the frames written by an SkPipeSerializer, keeping the resources they send for the
+ *  frames that follow.  The frames must be played in the order they were written.
+ */
+class SK_API SkPipeDeserializer {
+public:
+    SkPipeDeserializer();
+    ~SkPipeDeserializer();
+
+    /**
+     *  Read the next frame from stream and draw it into canvas, leaving canvas' matrix and clip
+     *  as they were.  Returns false if the stream is at its end or the frame is malformed.
+     */
+    bool playback(SkStream* stream, SkCanvas* canvas);
+
+private:
+    std::unique_ptr<SkPipePlayer> fPlayer;
+};
+
+#endif
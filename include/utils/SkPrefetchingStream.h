@@ -0,0 +1,44 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPrefetchingStream_DEFINED
+#define SkPrefetchingStream_DEFINED
+
+#include "SkTypes.h"
+
+class SkStream;
+
+/**
+ *  Specialized stream that reads ahead of its caller on a thread of its own.
+ *  The wrapped stream is read in blocks of blockSize bytes into a fixed pool of
+ *  blockCount blocks, so up to blockCount blocks are read before the caller
+ *  asks for them.  This lets a decoder work on one block while the next ones
+ *  are still coming off a slow disk or network file system.
+ *
+ *  The returned stream can peek within the block it is reading from, which
+ *  is enough for SkCodec::NewFromStream() to identify the image.  It cannot
+ *  rewind.
+ */
+class SK_API SkPrefetchingStream {
+public:
+    static const size_t kDefaultBlockSize  = 64 * 1024;
+    static const int    kDefaultBlockCount = 4;
+
+    /**
+     *  Creates a new stream that wraps an SkStream and reads it ahead.
+     *  @param stream SkStream to read from. If stream is NULL, NULL is
+     *      returned. Otherwise the returned stream owns it, and it should
+     *      no longer be used directly.
+     *  @return A stream that reads ahead of its caller.  If no thread could
+     *      be started for it, this is stream itself.  The caller is required
+     *      to delete it when finished with it.
+     */
+    static SkStream* Create(SkStream* stream, size_t blockSize = kDefaultBlockSize,
+                            int blockCount = kDefaultBlockCount);
+};
+
+#endif
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkRingBufferEventTracer_DEFINED
+#define SkRingBufferEventTracer_DEFINED
+
+#include "SkEventTracer.h"
+#include "SkMutex.h"
+#include "SkTDArray.h"
+
+class SkWStream;
+
+/**
+ *  An SkEventTracer that keeps the most recent trace events of each thread in a fixed size ring
+ *  buffer, cheap enough to leave installed in production:
+ *
+ *      SkRingBufferEventTracer* tracer = new SkRingBufferEventTracer;
+ *      SkEventTracer::SetInstance(tracer);   // Takes ownership.
+ *      tracer->setEnabled(true);
+ *      ...
+ *      tracer->dumpChromeTraceJSON(&stream);  // Load this in chrome://tracing.
+ *
+ *  Recording an event takes no locks: each thread writes only to its own buffer, and a dump
+ *  reads each event under a sequence count, skipping any that are being overwritten.  The only
+ *  lock is taken the first time a thread or a trace category is seen.
+ *
+ *  All categories, including disabled-by-default ones, are recorded while enabled.  String
+ *  arguments are recorded by pointer, so only those with static storage (the common case) are
+ *  kept; copied strings are dropped.
+ */
+class SK_API SkRingBufferEventTracer : public SkEventTracer {
+public:
+    explicit SkRingBufferEventTracer(int eventsPerThread = 4096);
+    ~SkRingBufferEventTracer() override;
+
+    /** Start or stop recording.  Events already recorded are kept. */
+    void setEnabled(bool);
+
+    /** Write all recorded events, oldest first per thread, as Chrome's trace event JSON. */
+    void dumpChromeTraceJSON(SkWStream*) const;
+
+    const uint8_t* getCategoryGroupEnabled(const char* name) override;
+    const char* getCategoryGroupName(const uint8_t* categoryEnabledFlag) override;
+
+    SkEventTracer::Handle addTraceEvent(char phase,
+                                        const uint8_t* categoryEnabledFlag,
+                                        const char* name,
+                                        uint64_t id,
+                                        int32_t numArgs,
+                                        const char** argNames,
+                                        const uint8_t* argTypes,
+                                        const uint64_t* argValues,
+                                        uint8_t flags) override;
+
+    void updateTraceEventDuration(const uint8_t* categoryEnabledFlag,
+                                  const char* name,
+                                  SkEventTracer::Handle) override;
+
+private:
+    struct ThreadBuffer;
+    ThreadBuffer* threadBuffer();
+
+    static const int kMaxCategories = 64;
+
+    const int      fEventsPerThread;
+    const uint32_t fUniqueID;
+
+    mutable SkMutex        fMutex;  // Guards adding categories and threads.
+    SkTDArray<ThreadBuffer*> fThreads;
+    int                    fCategoryCount;
+    const char*            fCategoryNames[kMaxCategories];
+    uint8_t                fCategoryFlags[kMaxCategories];
+    bool                   fEnabled;
+};
+
+#endif//SkRingBufferEventTracer_DEFINED
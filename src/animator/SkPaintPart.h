@@ -62,7 +62,9 @@ class SkDrawTypeface  : public SkPaintPart {
 #ifdef SK_DUMP_ENABLED
     void dump(SkAnimateMaker *) override;
 #endif
-    sk_sp<SkTypeface> getTypeface() { return SkTypeface::MakeFromName(fontName.c_str(), style); }
+    sk_sp<SkTypeface> getTypeface() {
+        return SkTypeface::MakeFromName(fontName.c_str(), SkFontStyle::FromOldStyle(style));
+    }
 protected:
     bool add() override;
     SkString fontName;
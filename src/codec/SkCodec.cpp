@@ -9,15 +9,18 @@
 #include "SkCodec.h"
 #include "SkCodecPriv.h"
 #include "SkColorSpace.h"
+#include "SkColorSpaceXform.h"
 #include "SkData.h"
 #include "SkGifCodec.h"
 #include "SkIcoCodec.h"
 #include "SkJpegCodec.h"
+#include "SkKTXCodec.h"
 #ifdef SK_HAS_PNG_LIBRARY
 #include "SkPngCodec.h"
 #endif
 #include "SkRawCodec.h"
 #include "SkStream.h"
+#include "SkTraceEvent.h"
 #include "SkWbmpCodec.h"
 #include "SkWebpCodec.h"
 
@@ -40,7 +43,8 @@ static const DecoderProc gDecoderProcs[] = {
     { SkIcoCodec::IsIco, SkIcoCodec::NewFromStream },
 #endif
     { SkBmpCodec::IsBmp, SkBmpCodec::NewFromStream },
-    { SkWbmpCodec::IsWbmp, SkWbmpCodec::NewFromStream }
+    { SkWbmpCodec::IsWbmp, SkWbmpCodec::NewFromStream },
+    { SkKTXCodec::IsKTX, SkKTXCodec::NewFromStream }
 };
 
 size_t SkCodec::MinBufferedBytesNeeded() {
@@ -114,6 +118,8 @@ SkCodec* SkCodec::NewFromData(SkData* data, SkPngChunkReader* reader) {
     return NewFromStream(new SkMemoryStream(data), reader);
 }
 
+const size_t SkCodec::kNone;
+
 SkCodec::SkCodec(int width, int height, const SkEncodedInfo& info, SkStream* stream,
         sk_sp<SkColorSpace> colorSpace, Origin origin)
     : fEncodedInfo(info)
@@ -154,8 +160,29 @@ bool SkCodec::rewindIfNeeded() {
     return this->onRewind();
 }
 
+// Spaces with a named gamma are described completely by it and their gamut.  Any others
+// (tables, LUTs) we only treat as the same as themselves.
+static bool same_color_space(const SkColorSpace* a, const SkColorSpace* b) {
+    return a == b || (SkColorSpace::kNonStandard_GammaNamed != a->gammaNamed() &&
+                      a->gammaNamed() == b->gammaNamed() && a->xyz() == b->xyz());
+}
+
+void SkCodec::initializeColorXform(const SkImageInfo& dstInfo) {
+    fColorXform.reset();
+    // SkColorSpaceXform reads opaque RGBA and writes opaque kN32.  Codecs swizzle to RGBA
+    // first when there is a conversion.
+    if (!dstInfo.colorSpace() || !fColorSpace ||
+            same_color_space(dstInfo.colorSpace(), fColorSpace.get()) ||
+            kN32_SkColorType != dstInfo.colorType() ||
+            kOpaque_SkAlphaType != dstInfo.alphaType()) {
+        return;
+    }
+    fColorXform = SkColorSpaceXform::New(fColorSpace, sk_ref_sp(dstInfo.colorSpace()));
+}
+
 SkCodec::Result SkCodec::getPixels(const SkImageInfo& info, void* pixels, size_t rowBytes,
                                    const Options* options, SkPMColor ctable[], int* ctableCount) {
+    TRACE_EVENT0("disabled-by-default-skia", "SkCodec::getPixels()");
     if (kUnknown_SkColorType == info.colorType()) {
         return kInvalidConversion;
     }
@@ -178,6 +205,12 @@ SkCodec::Result SkCodec::getPixels(const SkImageInfo& info, void* pixels, size_t
         ctable = nullptr;
     }
 
+    // Finding the frames may read the whole stream, so do it before we rewind.
+    if (options && options->fFrameIndex > 0 &&
+            options->fFrameIndex >= this->getFrameCount()) {
+        return kInvalidParameters;
+    }
+
     if (!this->rewindIfNeeded()) {
         return kCouldNotRewind;
     }
@@ -195,12 +228,15 @@ SkCodec::Result SkCodec::getPixels(const SkImageInfo& info, void* pixels, size_t
         }
     }
 
-    // FIXME: Support subsets somehow? Note that this works for SkWebpCodec
-    // because it supports arbitrary scaling/subset combinations.
-    if (!this->dimensionsSupported(info.dimensions())) {
+    // A subset may be decoded at its own size.  Scaling it too only works for
+    // SkWebpCodec, which supports arbitrary scaling/subset combinations.
+    const bool subsetSize = options->fSubset && info.dimensions() == options->fSubset->size();
+    if (!subsetSize && !this->dimensionsSupported(info.dimensions())) {
         return kInvalidScale;
     }
 
+    this->initializeColorXform(info);
+
     // On an incomplete decode, the subclass will specify the number of scanlines that it decoded
     // successfully.
     int rowsDecoded = 0;
@@ -245,6 +281,11 @@ SkCodec::Result SkCodec::startScanlineDecode(const SkImageInfo& dstInfo,
         ctable = nullptr;
     }
 
+    // Only getPixels() decodes frames after the first.
+    if (options && options->fFrameIndex > 0) {
+        return kUnimplemented;
+    }
+
     if (!this->rewindIfNeeded()) {
         return kCouldNotRewind;
     }
@@ -271,6 +312,8 @@ SkCodec::Result SkCodec::startScanlineDecode(const SkImageInfo& dstInfo,
         return kInvalidScale;
     }
 
+    this->initializeColorXform(dstInfo);
+
     const Result result = this->onStartScanlineDecode(dstInfo, *options, ctable, ctableCount);
     if (result != SkCodec::kSuccess) {
         return result;
@@ -64,3 +64,28 @@ bool SkCodecImageGenerator::onGetYUV8Planes(const SkYUVSizeInfo& sizeInfo, void*
             return false;
     }
 }
+
+#if SK_SUPPORT_GPU
+#include "GrContext.h"
+#include "GrTextureProvider.h"
+#include "SkGrPriv.h"
+
+GrTexture* SkCodecImageGenerator::onGenerateTexture(GrContext* ctx, const SkIRect* subset) {
+    const SkImageInfo& info = this->getInfo();
+    if (kKTX_SkEncodedFormat != fCodec->getEncodedFormat() ||
+        (subset && *subset != SkIRect::MakeWH(info.width(), info.height()))) {
+        return nullptr;
+    }
+
+    GrSurfaceDesc desc;
+    desc.fWidth = info.width();
+    desc.fHeight = info.height();
+    const void* rawStart;
+    desc.fConfig = GrIsCompressedTextureDataSupported(ctx, fData, desc.fWidth, desc.fHeight,
+                                                      &rawStart);
+    if (kUnknown_GrPixelConfig == desc.fConfig) {
+        return nullptr;
+    }
+    return ctx->textureProvider()->createTexture(desc, SkBudgeted::kYes, rawStart, 0);
+}
+#endif
@@ -30,6 +30,11 @@ protected:
 
     bool onGetYUV8Planes(const SkYUVSizeInfo&, void* planes[3]) override;
 
+#if SK_SUPPORT_GPU
+    // Uploads compressed texture data (e.g. ETC1 in a KTX file) without decoding it.
+    GrTexture* onGenerateTexture(GrContext*, const SkIRect*) override;
+#endif
+
 private:
     /*
      * Takes ownership of codec
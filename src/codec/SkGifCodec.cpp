@@ -11,6 +11,8 @@
 #include "SkGifCodec.h"
 #include "SkStream.h"
 #include "SkSwizzler.h"
+#include "SkTDArray.h"
+#include "SkTaskGroup.h"
 #include "SkUtils.h"
 
 #include "gif_lib.h"
@@ -58,10 +60,26 @@ static GifFileType* open_gif(SkStream* stream) {
 #endif
 }
 
+// Disposal methods from the graphics control extension, saying what happens to a frame's
+// rect before the next frame is drawn.  0 (unspecified) is treated like kKeep_Disposal.
+enum {
+    kKeep_Disposal       = 1,
+    kBackground_Disposal = 2,
+    kPrevious_Disposal   = 3,
+};
+
 /*
- * Check if a there is an index of the color table for a transparent pixel
+ * Reads the transparent index, disposal method, and delay of a frame from its
+ * graphics control extension, if there is one
  */
-static uint32_t find_trans_index(const SavedImage& image) {
+static void read_graphics_control(const SavedImage& image, uint32_t* transIndex,
+                                  int* disposal, size_t* duration) {
+    // Use maximum unsigned int (surely an invalid index) to indicate that a valid
+    // index was not found.
+    *transIndex = SK_MaxU32;
+    *disposal = kKeep_Disposal;
+    *duration = 0;
+
     // If there is a transparent index specified, it will be contained in an
     // extension block.  We will loop through extension blocks in reverse order
     // to check the most recent extension blocks first.
@@ -80,17 +98,22 @@ static uint32_t find_trans_index(const SavedImage& image) {
             // the first byte of the extension block.
             if (1 == (extBlock.Bytes[0] & 1)) {
                 // Use uint32_t to prevent sign extending
-                return extBlock.Bytes[3];
+                *transIndex = extBlock.Bytes[3];
+            }
+
+            // The disposal method is in bits 2-4 of the first byte, and the
+            // delay, in hundredths of a second, is the little endian short
+            // that follows.
+            int method = (extBlock.Bytes[0] >> 2) & 7;
+            if (kBackground_Disposal == method || kPrevious_Disposal == method) {
+                *disposal = method;
             }
+            *duration = 10 * (extBlock.Bytes[1] | (extBlock.Bytes[2] << 8));
 
             // There should only be one graphics control extension for the image frame
             break;
         }
     }
-
-    // Use maximum unsigned int (surely an invalid index) to indicate that a valid
-    // index was not found.
-    return SK_MaxU32;
 }
 
 inline uint32_t ceil_div(uint32_t a, uint32_t b) {
@@ -122,7 +145,7 @@ inline uint32_t get_output_row_interlaced(uint32_t encodedRow, uint32_t height)
  * This function cleans up the gif object after the decode completes
  * It is used in a SkAutoTCallIProc template
  */
-void SkGifCodec::CloseGif(GifFileType* gif) {
+static void close_gif(GifFileType* gif) {
 #if GIFLIB_MAJOR < 5 || (GIFLIB_MAJOR == 5 && GIFLIB_MINOR == 0)
     DGifCloseFile(gif);
 #else
@@ -130,6 +153,10 @@ void SkGifCodec::CloseGif(GifFileType* gif) {
 #endif
 }
 
+void SkGifCodec::CloseGif(GifFileType* gif) {
+    close_gif(gif);
+}
+
 /*
  * This function free extension data that has been saved to assist the image
  * decoder
@@ -177,7 +204,7 @@ bool SkGifCodec::ReadHeader(SkStream* stream, SkCodec** codecOut, GifFileType**
     // Read through gif extensions to get to the image data.  Set the
     // transparent index based on the extension data.
     uint32_t transIndex;
-    SkCodec::Result result = ReadUpToFirstImage(gif, &transIndex);
+    SkCodec::Result result = ReadUpToNextImage(gif, &transIndex);
     if (kSuccess != result){
         return false;
     }
@@ -253,6 +280,7 @@ SkGifCodec::SkGifCodec(int width, int height, const SkEncodedInfo& info, SkStrea
     , fFrameIsSubset(frameIsSubset)
     , fSwizzler(NULL)
     , fColorTable(NULL)
+    , fFramesIndexed(false)
 {}
 
 bool SkGifCodec::onRewind() {
@@ -266,7 +294,8 @@ bool SkGifCodec::onRewind() {
     return true;
 }
 
-SkCodec::Result SkGifCodec::ReadUpToFirstImage(GifFileType* gif, uint32_t* transIndex) {
+SkCodec::Result SkGifCodec::ReadUpToNextImage(GifFileType* gif, uint32_t* transIndex,
+        int* disposal, size_t* duration) {
     // Use this as a container to hold information about any gif extension
     // blocks.  This generally stores transparency and animation instructions.
     SavedImage saveExt;
@@ -276,9 +305,8 @@ SkCodec::Result SkGifCodec::ReadUpToFirstImage(GifFileType* gif, uint32_t* trans
     GifByteType* extData;
     int32_t extFunction;
 
-    // We will loop over components of gif images until we find an image.  Once
-    // we find an image, we will decode and return it.  While many gif files
-    // contain more than one image, we will simply decode the first image.
+    // We will loop over components of gif images until we find an image.  The
+    // extensions before it describe how that image is to be displayed.
     GifRecordType recordType;
     do {
         // Get the current record type
@@ -287,29 +315,20 @@ SkCodec::Result SkGifCodec::ReadUpToFirstImage(GifFileType* gif, uint32_t* trans
         }
         switch (recordType) {
             case IMAGE_DESC_RECORD_TYPE: {
-                *transIndex = find_trans_index(saveExt);
-
-                // FIXME: Gif files may have multiple images stored in a single
-                //        file.  This is most commonly used to enable
-                //        animations.  Since we are leaving animated gifs as a
-                //        TODO, we will return kSuccess after decoding the
-                //        first image in the file.  This is the same behavior
-                //        as SkImageDecoder_libgif.
-                //
-                //        Most times this works pretty well, but sometimes it
-                //        doesn't.  For example, I have an animated test image
-                //        where the first image in the file is 1x1, but the
-                //        subsequent images are meaningful.  This currently
-                //        displays the 1x1 image, which is not ideal.  Right
-                //        now I am leaving this as an issue that will be
-                //        addressed when we implement animated gifs.
-                //
-                //        It is also possible (not explicitly disallowed in the
-                //        specification) that gif files provide multiple
-                //        images in a single file that are all meant to be
-                //        displayed in the same frame together.  I will
-                //        currently leave this unimplemented until I find a
-                //        test case that expects this behavior.
+                int frameDisposal;
+                size_t frameDuration;
+                read_graphics_control(saveExt, transIndex, &frameDisposal, &frameDuration);
+                if (disposal) {
+                    *disposal = frameDisposal;
+                }
+                if (duration) {
+                    *duration = frameDuration;
+                }
+
+                // It is also possible (not explicitly disallowed in the
+                // specification) that gif files provide multiple images in a
+                // single file that are all meant to be displayed in the same
+                // frame together.  We treat each image as its own frame.
                 return kSuccess;
             }
             // Extensions are used to specify special properties of the image
@@ -385,32 +404,20 @@ bool SkGifCodec::GetDimensions(GifFileType* gif, SkISize* size, SkIRect* frameRe
     return true;
 }
 
-void SkGifCodec::initializeColorTable(const SkImageInfo& dstInfo, SkPMColor* inputColorPtr,
-        int* inputColorCount) {
-    // Set up our own color table
+/*
+ * Fills all 256 entries of colorPtr from colorMap, which may be nullptr, making
+ * the transparent index transparent.  Returns the index of the fill color.
+ */
+static uint32_t fill_color_table(SkPMColor colorPtr[256], const ColorMapObject* colorMap,
+        uint32_t transIndex, uint32_t backgroundIndex, SkColorType colorType) {
     const uint32_t maxColors = 256;
-    SkPMColor colorPtr[256];
-    if (NULL != inputColorCount) {
-        // We set the number of colors to maxColors in order to ensure
-        // safe memory accesses.  Otherwise, an invalid pixel could
-        // access memory outside of our color table array.
-        *inputColorCount = maxColors;
-    }
-
-    // Get local color table
-    ColorMapObject* colorMap = fGif->Image.ColorMap;
-    // If there is no local color table, use the global color table
-    if (NULL == colorMap) {
-        colorMap = fGif->SColorMap;
-    }
-
     uint32_t colorCount = 0;
     if (NULL != colorMap) {
         colorCount = colorMap->ColorCount;
         // giflib guarantees these properties
         SkASSERT(colorCount == (unsigned) (1 << (colorMap->BitsPerPixel)));
         SkASSERT(colorCount <= 256);
-        PackColorProc proc = choose_pack_color_proc(false, dstInfo.colorType());
+        PackColorProc proc = choose_pack_color_proc(false, colorType);
         for (uint32_t i = 0; i < colorCount; i++) {
             colorPtr[i] = proc(0xFF, colorMap->Colors[i].Red,
                     colorMap->Colors[i].Green, colorMap->Colors[i].Blue);
@@ -419,29 +426,51 @@ void SkGifCodec::initializeColorTable(const SkImageInfo& dstInfo, SkPMColor* inp
 
     // Fill in the color table for indices greater than color count.
     // This allows for predictable, safe behavior.
+    uint32_t fillIndex = 0;
     if (colorCount > 0) {
         // Gifs have the option to specify the color at a single index of the color
         // table as transparent.  If the transparent index is greater than the
         // colorCount, we know that there is no valid transparent color in the color
         // table.  If there is not valid transparent index, we will try to use the
         // backgroundIndex as the fill index.  If the backgroundIndex is also not
-        // valid, we will let fFillIndex default to 0 (it is set to zero in the
-        // constructor).  This behavior is not specified but matches
-        // SkImageDecoder_libgif.
-        uint32_t backgroundIndex = fGif->SBackGroundColor;
-        if (fTransIndex < colorCount) {
-            colorPtr[fTransIndex] = SK_ColorTRANSPARENT;
-            fFillIndex = fTransIndex;
+        // valid, we will let the fill index default to 0.  This behavior is not
+        // specified but matches SkImageDecoder_libgif.
+        if (transIndex < colorCount) {
+            colorPtr[transIndex] = SK_ColorTRANSPARENT;
+            fillIndex = transIndex;
         } else if (backgroundIndex < colorCount) {
-            fFillIndex = backgroundIndex;
+            fillIndex = backgroundIndex;
         }
 
         for (uint32_t i = colorCount; i < maxColors; i++) {
-            colorPtr[i] = colorPtr[fFillIndex];
+            colorPtr[i] = colorPtr[fillIndex];
         }
     } else {
         sk_memset32(colorPtr, 0xFF000000, maxColors);
     }
+    return fillIndex;
+}
+
+void SkGifCodec::initializeColorTable(const SkImageInfo& dstInfo, SkPMColor* inputColorPtr,
+        int* inputColorCount) {
+    // Set up our own color table
+    const uint32_t maxColors = 256;
+    SkPMColor colorPtr[256];
+    if (NULL != inputColorCount) {
+        // We set the number of colors to maxColors in order to ensure
+        // safe memory accesses.  Otherwise, an invalid pixel could
+        // access memory outside of our color table array.
+        *inputColorCount = maxColors;
+    }
+
+    // Get local color table
+    ColorMapObject* colorMap = fGif->Image.ColorMap;
+    // If there is no local color table, use the global color table
+    if (NULL == colorMap) {
+        colorMap = fGif->SColorMap;
+    }
+    fFillIndex = fill_color_table(colorPtr, colorMap, fTransIndex, fGif->SBackGroundColor,
+            dstInfo.colorType());
 
     fColorTable.reset(new SkColorTable(colorPtr, maxColors));
     copy_color_table(dstInfo, this->fColorTable, inputColorPtr, inputColorCount);
@@ -483,6 +512,10 @@ SkCodec::Result SkGifCodec::onGetPixels(const SkImageInfo& dstInfo,
                                         SkPMColor* inputColorPtr,
                                         int* inputColorCount,
                                         int* rowsDecoded) {
+    if (opts.fFrameIndex > 0) {
+        return this->decodeFrame(dstInfo, dst, dstRowBytes, opts, rowsDecoded);
+    }
+
     Result result = this->prepareToDecode(dstInfo, inputColorPtr, inputColorCount, opts);
     if (kSuccess != result) {
         return result;
@@ -511,6 +544,387 @@ SkCodec::Result SkGifCodec::onGetPixels(const SkImageInfo& dstInfo,
     return kSuccess;
 }
 
+/*
+ * Reads past the compressed data of the current frame without decoding it
+ */
+static bool skip_image_data(GifFileType* gif) {
+    int codeSize;
+    GifByteType* block;
+    if (GIF_ERROR == DGifGetCode(gif, &codeSize, &block)) {
+        return false;
+    }
+    while (nullptr != block) {
+        if (GIF_ERROR == DGifGetCodeNext(gif, &block)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * The color that fill_color_table() would choose as the fill color
+ */
+static SkColor get_fill_color(const ColorMapObject* colorMap, uint32_t transIndex,
+        uint32_t backgroundIndex) {
+    if (nullptr == colorMap || 0 == colorMap->ColorCount) {
+        return SK_ColorBLACK;
+    }
+    const uint32_t colorCount = colorMap->ColorCount;
+    if (transIndex < colorCount) {
+        return SK_ColorTRANSPARENT;
+    }
+    const GifColorType& color = colorMap->Colors[backgroundIndex < colorCount ? backgroundIndex : 0];
+    return SkColorSetRGB(color.Red, color.Green, color.Blue);
+}
+
+bool SkGifCodec::indexFrames() {
+    if (fFramesIndexed) {
+        return !fFrames.empty();
+    }
+    fFramesIndexed = true;
+
+    // Read through the stream with a gif of our own.  rewindIfNeeded() makes sure
+    // that the next decode starts over.
+    if (!this->rewindIfNeeded() || !this->stream()->rewind()) {
+        return false;
+    }
+    SkAutoTCallVProc<GifFileType, CloseGif> gif(open_gif(this->stream()));
+    if (nullptr == gif) {
+        return false;
+    }
+
+    const SkIRect bounds = SkIRect::MakeSize(this->getInfo().dimensions());
+    while (true) {
+        Frame frame;
+        frame.fStart = this->stream()->hasPosition() ? this->stream()->getPosition() : 0;
+        if (kSuccess != ReadUpToNextImage(gif, &frame.fTransIndex, &frame.fDisposal,
+                                          &frame.fDuration) ||
+                GIF_ERROR == DGifGetImageDesc(gif)) {
+            // Either we have found every frame, or the rest of the stream is bad.
+            break;
+        }
+
+        const GifImageDesc& desc = gif->Image;
+        frame.fRect.setXYWH(desc.Left, desc.Top, desc.Width, desc.Height);
+        const ColorMapObject* colorMap = desc.ColorMap ? desc.ColorMap : gif->SColorMap;
+        if (nullptr == colorMap || frame.fTransIndex >= (uint32_t) colorMap->ColorCount) {
+            frame.fTransIndex = SK_MaxU32;
+        }
+        frame.fFillColor = get_fill_color(colorMap, frame.fTransIndex, gif->SBackGroundColor);
+
+        // Work out which frame this one is drawn on top of.
+        frame.fRequiredFrame = kNone;
+        const bool independent = fFrames.empty() ||
+                (SK_MaxU32 == frame.fTransIndex && frame.fRect.contains(bounds));
+        if (!independent) {
+            // A frame restored to what was there before it leaves behind whatever
+            // it was drawn on.
+            size_t prev = fFrames.count() - 1;
+            while (kNone != prev && kPrevious_Disposal == fFrames[prev].fDisposal) {
+                prev = fFrames[prev].fRequiredFrame;
+            }
+            // A frame cleared away entirely leaves nothing behind.
+            if (kNone != prev && !(kBackground_Disposal == fFrames[prev].fDisposal &&
+                                   fFrames[prev].fRect.contains(bounds))) {
+                frame.fRequiredFrame = prev;
+            }
+        }
+        fFrames.push_back(frame);
+
+        if (!skip_image_data(gif)) {
+            break;
+        }
+    }
+    return !fFrames.empty();
+}
+
+std::vector<SkCodec::FrameInfo> SkGifCodec::onGetFrameInfo() {
+    std::vector<FrameInfo> result;
+    if (this->indexFrames()) {
+        for (const Frame& frame : fFrames) {
+            result.push_back({ frame.fRequiredFrame, frame.fDuration });
+        }
+    }
+    return result;
+}
+
+size_t SkGifCodec::onGetFrameCount() {
+    return this->indexFrames() ? fFrames.count() : 1;
+}
+
+/*
+ * Converts a frame's fill color to a value for SkSampler::Fill()
+ */
+static uint32_t get_fill_value(SkColor color, const SkImageInfo& dstInfo) {
+    if (kOpaque_SkAlphaType == dstInfo.alphaType()) {
+        color = SkColorSetA(color, 0xFF);
+    }
+    SkPMColor pmColor = choose_pack_color_proc(false, dstInfo.colorType())(
+            SkColorGetA(color), SkColorGetR(color), SkColorGetG(color), SkColorGetB(color));
+    return kRGB_565_SkColorType == dstInfo.colorType() ? SkPixel32ToPixel16(pmColor) : pmColor;
+}
+
+/*
+ * Writes the header of a gif holding just the current frame of gif: the frame's
+ * size, no color maps, and no interlacing.  The frame's LZW data can follow it.
+ */
+static void write_frame_header(const GifFileType* gif, SkTDArray<uint8_t>* encoded) {
+    const GifImageDesc& desc = gif->Image;
+    const uint8_t w0 = desc.Width & 0xFF,  w1 = (desc.Width >> 8) & 0xFF,
+                  h0 = desc.Height & 0xFF, h1 = (desc.Height >> 8) & 0xFF;
+    const uint8_t header[] = {
+        'G', 'I', 'F', '8', '9', 'a',
+        // Logical screen descriptor
+        w0, w1, h0, h1, 0, 0, 0,
+        // Image descriptor
+        ',', 0, 0, 0, 0, w0, w1, h0, h1, 0,
+    };
+    encoded->append(sizeof(header), header);
+}
+
+/*
+ * Copies the compressed data of the current frame out of the stream, after its
+ * header, without decoding it.  Returns false if the data ends early, leaving as
+ * much of it as was read.
+ */
+static bool read_image_data(GifFileType* gif, SkTDArray<uint8_t>* encoded) {
+    write_frame_header(gif, encoded);
+
+    int codeSize;
+    GifByteType* block;
+    if (GIF_ERROR == DGifGetCode(gif, &codeSize, &block)) {
+        return false;
+    }
+    *encoded->append() = (uint8_t) codeSize;
+    while (nullptr != block) {
+        // Each block starts with its length.
+        encoded->append(block[0] + 1, block);
+        if (GIF_ERROR == DGifGetCodeNext(gif, &block)) {
+            return false;
+        }
+    }
+    const uint8_t trailer[] = { 0, ';' };
+    encoded->append(sizeof(trailer), trailer);
+    return true;
+}
+
+namespace {
+
+// A frame that decodeFrame() draws.  Its compressed data is read out of the
+// stream first, so that the frames can be decompressed in parallel and then
+// drawn in order.
+struct ChainFrame {
+    SkPMColor              fColors[256];
+    bool                   fInterlaced;
+    SkTDArray<uint8_t>     fEncoded;
+
+    // The part of the frame inside the image, one byte per pixel, by output row.
+    int                    fVisibleWidth;
+    int                    fVisibleHeight;
+    SkAutoTMalloc<uint8_t> fIndices;
+    // How many rows, in encoded order, the LZW data gave us.
+    int                    fRowsDecoded;
+};
+
+}  // namespace
+
+/*
+ * Decompresses the frame's indices from its copied data.  This only touches
+ * the ChainFrame, so different frames can be decompressed on different threads.
+ */
+static void decode_frame_indices(const SkIRect& rect, ChainFrame* frame) {
+    frame->fRowsDecoded = 0;
+    if (frame->fVisibleWidth <= 0 || frame->fVisibleHeight <= 0) {
+        return;
+    }
+
+    SkMemoryStream stream(frame->fEncoded.begin(), frame->fEncoded.count(), false);
+    SkAutoTCallVProc<GifFileType, close_gif> gif(open_gif(&stream));
+    GifRecordType recordType;
+    if (nullptr == gif || GIF_ERROR == DGifGetRecordType(gif, &recordType) ||
+            IMAGE_DESC_RECORD_TYPE != recordType || GIF_ERROR == DGifGetImageDesc(gif)) {
+        return;
+    }
+
+    frame->fIndices.reset(frame->fVisibleWidth * frame->fVisibleHeight);
+    SkAutoTMalloc<uint8_t> src(rect.width());
+    for (int y = 0; y < rect.height(); y++) {
+        if (GIF_ERROR == DGifGetLine(gif, src.get(), rect.width())) {
+            return;
+        }
+        const int row = frame->fInterlaced ? get_output_row_interlaced(y, rect.height()) : y;
+        if (row < frame->fVisibleHeight) {
+            memcpy(&frame->fIndices[row * frame->fVisibleWidth], src.get(),
+                   frame->fVisibleWidth);
+        }
+        frame->fRowsDecoded++;
+    }
+}
+
+/*
+ * Draws the decoded rows of a frame on top of dst, leaving its transparent
+ * pixels alone.
+ */
+static void draw_frame(const SkIRect& rect, uint32_t transIndex, const ChainFrame& frame,
+        const SkImageInfo& dstInfo, void* dst, size_t dstRowBytes) {
+    const int width = frame.fVisibleWidth;
+    for (int y = 0; y < frame.fRowsDecoded; y++) {
+        const int row = frame.fInterlaced ? get_output_row_interlaced(y, rect.height()) : y;
+        if (row >= frame.fVisibleHeight) {
+            continue;
+        }
+
+        const uint8_t* src = &frame.fIndices[row * width];
+        void* dstRow = SkTAddOffset<void>(dst, (rect.top() + row) * dstRowBytes);
+        if (kRGB_565_SkColorType == dstInfo.colorType()) {
+            uint16_t* dst16 = (uint16_t*) dstRow + rect.left();
+            for (int x = 0; x < width; x++) {
+                if (src[x] != transIndex) {
+                    dst16[x] = SkPixel32ToPixel16(frame.fColors[src[x]]);
+                }
+            }
+        } else {
+            uint32_t* dst32 = (uint32_t*) dstRow + rect.left();
+            for (int x = 0; x < width; x++) {
+                if (src[x] != transIndex) {
+                    dst32[x] = frame.fColors[src[x]];
+                }
+            }
+        }
+    }
+}
+
+SkCodec::Result SkGifCodec::decodeFrame(const SkImageInfo& dstInfo, void* dst,
+        size_t dstRowBytes, const Options& opts, int* rowsDecoded) {
+    switch (dstInfo.colorType()) {
+        case kRGBA_8888_SkColorType:
+        case kBGRA_8888_SkColorType:
+        case kRGB_565_SkColorType:
+            break;
+        default:
+            return gif_error("Cannot decode later frames to this color type.\n",
+                    kInvalidConversion);
+    }
+    if (!conversion_possible(dstInfo, this->getInfo())) {
+        return gif_error("Cannot convert input type to output type.\n", kInvalidConversion);
+    }
+    if (dstInfo.dimensions() != this->getInfo().dimensions()) {
+        return gif_error("Scaling not supported.\n", kInvalidScale);
+    }
+    SkASSERT(fFramesIndexed && opts.fFrameIndex < (size_t) fFrames.count());
+
+    // The frames to draw, newest first, back to one that needs nothing under it
+    // (or to the frame the client has already drawn).
+    SkTArray<size_t, true> chain;
+    size_t index = opts.fFrameIndex;
+    chain.push_back(index);
+    while (!opts.fHasPriorFrame && kNone != fFrames[index].fRequiredFrame) {
+        index = fFrames[index].fRequiredFrame;
+        chain.push_back(index);
+    }
+
+    const SkIRect bounds = SkIRect::MakeSize(dstInfo.dimensions());
+    auto fillRect = [&](const SkIRect& rect, SkColor color, ZeroInitialized zeroInit) {
+        SkIRect fill = rect;
+        if (fill.intersect(bounds)) {
+            void* pixels = SkTAddOffset<void>(dst, fill.top() * dstRowBytes +
+                    fill.left() * dstInfo.bytesPerPixel());
+            SkSampler::Fill(dstInfo.makeWH(fill.width(), fill.height()), pixels, dstRowBytes,
+                    get_fill_value(color, dstInfo), zeroInit);
+        }
+    };
+
+    const Frame& oldest = fFrames[chain.back()];
+    if (kNone == oldest.fRequiredFrame) {
+        fillRect(bounds, oldest.fFillColor, opts.fZeroInitialized);
+    } else {
+        // dst already holds the required frame.  Dispose of it as it asks.
+        const Frame& prior = fFrames[oldest.fRequiredFrame];
+        if (kBackground_Disposal == prior.fDisposal) {
+            fillRect(prior.fRect, prior.fFillColor, kNo_ZeroInitialized);
+        }
+    }
+
+    // fGif has just read the descriptor of frame 0.  Where the stream allows it,
+    // seek straight to the oldest frame in the chain.  giflib reads only as much
+    // of the stream as each call needs, so fGif picks up from there.  Then walk
+    // forward, copying out the data of the frames in the chain (oldest first) and
+    // skipping past the rest.
+    size_t first = 0;
+    if (chain.back() > 0 && fFrames[chain.back()].fStart > 0 &&
+            this->stream()->seek(fFrames[chain.back()].fStart)) {
+        first = chain.back();
+    }
+    SkAutoTArray<ChainFrame> frames(chain.count());
+    int framesRead = 0;
+    bool complete = true;
+    for (size_t i = first; i <= opts.fFrameIndex && complete; i++) {
+        if (i > 0) {
+            uint32_t transIndex;
+            if (kSuccess != ReadUpToNextImage(fGif, &transIndex) ||
+                    GIF_ERROR == DGifGetImageDesc(fGif)) {
+                complete = false;
+                break;
+            }
+        }
+        if (chain[chain.count() - 1 - framesRead] != i) {
+            complete = skip_image_data(fGif);
+            continue;
+        }
+
+        const Frame& frame = fFrames[i];
+        ChainFrame& chainFrame = frames[framesRead++];
+        const GifImageDesc& desc = fGif->Image;
+        const ColorMapObject* colorMap = desc.ColorMap ? desc.ColorMap : fGif->SColorMap;
+        fill_color_table(chainFrame.fColors, colorMap, frame.fTransIndex,
+                fGif->SBackGroundColor, dstInfo.colorType());
+        chainFrame.fInterlaced = desc.Interlace;
+        // Parts of later frames may fall outside the image.
+        chainFrame.fVisibleWidth = SkTMin(frame.fRect.width(),
+                                          dstInfo.width() - frame.fRect.left());
+        chainFrame.fVisibleHeight = SkTMin(frame.fRect.height(),
+                                           dstInfo.height() - frame.fRect.top());
+        chainFrame.fRowsDecoded = 0;
+        if (frame.fRect.isEmpty()) {
+            complete = skip_image_data(fGif);
+        } else {
+            complete = read_image_data(fGif, &chainFrame.fEncoded);
+        }
+    }
+
+    // LZW decoding is most of the work, and each frame's data stands alone.  Only
+    // disposing and drawing the frames needs to happen in order.
+    SkTaskGroup().batch(framesRead, [&](int i) {
+        decode_frame_indices(fFrames[chain[chain.count() - 1 - i]].fRect, &frames[i]);
+    });
+
+    for (int i = 0; i < framesRead; i++) {
+        const int link = chain.count() - 1 - i;
+        if (i > 0) {
+            const Frame& prior = fFrames[chain[link + 1]];
+            if (kBackground_Disposal == prior.fDisposal) {
+                fillRect(prior.fRect, prior.fFillColor, kNo_ZeroInitialized);
+            }
+        }
+        const Frame& frame = fFrames[chain[link]];
+        draw_frame(frame.fRect, frame.fTransIndex, frames[i], dstInfo, dst, dstRowBytes);
+
+        const bool drawnFully = frame.fRect.isEmpty() || frames[i].fVisibleWidth <= 0 ||
+                frames[i].fVisibleHeight <= 0 || frames[i].fRowsDecoded == frame.fRect.height();
+        if (!drawnFully) {
+            complete = false;
+            break;
+        }
+    }
+
+    if (!complete || framesRead < chain.count()) {
+        // Whatever we did not get to still shows the frames beneath it.
+        *rowsDecoded = dstInfo.height();
+        return gif_error("Could not decode frame.\n", kIncompleteInput);
+    }
+    return kSuccess;
+}
+
 // FIXME: This is similar to the implementation for bmp and png.  Can we share more code or
 //        possibly make this non-virtual?
 uint32_t SkGifCodec::onGetFillValue(SkColorType colorType) const {
@@ -10,6 +10,7 @@
 #include "SkColorTable.h"
 #include "SkImageInfo.h"
 #include "SkSwizzler.h"
+#include "SkTArray.h"
 
 struct GifFileType;
 struct SavedImage;
@@ -66,6 +67,10 @@ protected:
 
     bool onRewind() override;
 
+    std::vector<FrameInfo> onGetFrameInfo() override;
+
+    size_t onGetFrameCount() override;
+
     uint32_t onGetFillValue(SkColorType) const override;
 
     int onOutputScanline(int inputScanline) const override;
@@ -73,16 +78,18 @@ protected:
 private:
 
     /*
-     * A gif can contain multiple image frames.  We will only decode the first
-     * frame.  This function reads up to the first image frame, processing
-     * transparency and/or animation information that comes before the image
-     * data.
+     * A gif can contain multiple image frames.  This function reads up to the
+     * next image frame, processing transparency and/or animation information
+     * that comes before the image data.
      *
      * @param gif        Pointer to the library type that manages the gif decode
      * @param transIndex This call will set the transparent index based on the
      *                   extension data.
+     * @param disposal   If not nullptr, set to the frame's disposal method.
+     * @param duration   If not nullptr, set to the frame's delay in milliseconds.
      */
-     static Result ReadUpToFirstImage(GifFileType* gif, uint32_t* transIndex);
+     static Result ReadUpToNextImage(GifFileType* gif, uint32_t* transIndex,
+             int* disposal = nullptr, size_t* duration = nullptr);
 
      /*
       * A gif may contain many image frames, all of different sizes.
@@ -166,6 +173,22 @@ private:
 
     SkScanlineOrder onGetScanlineOrder() const override;
 
+    /*
+     * Reads through the whole stream once to find the size, placement, and
+     * timing of each frame, and which frame each one is drawn on top of.
+     *
+     * @return true if at least one frame was found.
+     */
+    bool indexFrames();
+
+    /*
+     * Decodes opts.fFrameIndex, which must be greater than zero, by decoding
+     * the frames it depends on (unless opts.fHasPriorFrame) and compositing
+     * each one on top of the last.  Only supports N32 and 565 at full size.
+     */
+    Result decodeFrame(const SkImageInfo& dstInfo, void* dst, size_t dstRowBytes,
+            const Options& opts, int* rowsDecoded);
+
     /*
      * This function cleans up the gif object after the decode completes
      * It is used in a SkAutoTCallIProc template
@@ -201,5 +224,19 @@ private:
     SkAutoTDelete<SkSwizzler>               fSwizzler;
     SkAutoTUnref<SkColorTable>              fColorTable;
 
+    // What indexFrames() learns about each frame.
+    struct Frame {
+        SkIRect  fRect;           // As encoded, so it may extend past the image.
+        uint32_t fTransIndex;     // SK_MaxU32 if there is no valid transparent index.
+        SkColor  fFillColor;      // What a disposal to the background clears to.
+        int      fDisposal;
+        size_t   fDuration;
+        size_t   fRequiredFrame;
+        size_t   fStart;          // Where the frame's records start in the stream, or 0 if
+                                  // the stream can't tell us.
+    };
+    SkTArray<Frame, true>                   fFrames;
+    bool                                    fFramesIndexed;
+
     typedef SkCodec INHERITED;
 };
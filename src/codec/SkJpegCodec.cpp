@@ -11,7 +11,10 @@
 #include "SkJpegDecoderMgr.h"
 #include "SkCodecPriv.h"
 #include "SkColorPriv.h"
+#include "SkColorSpaceXform.h"
 #include "SkStream.h"
+#include "SkTaskGroup.h"
+#include "SkTDArray.h"
 #include "SkTemplates.h"
 #include "SkTypes.h"
 
@@ -361,8 +364,11 @@ bool SkJpegCodec::setOutputColorSpace(const SkImageInfo& dst) {
     J_COLOR_SPACE colorSpace = fDecoderMgr->dinfo()->jpeg_color_space;
     bool isCMYK = JCS_CMYK == colorSpace || JCS_YCCK == colorSpace;
 
+    // A color conversion reads RGBA, and then writes the dst color type in place.
+    const SkColorType colorType = this->colorXform() ? kRGBA_8888_SkColorType : dst.colorType();
+
     // Check for valid color types and set the output color space
-    switch (dst.colorType()) {
+    switch (colorType) {
         case kRGBA_8888_SkColorType:
             if (isCMYK) {
                 fDecoderMgr->dinfo()->out_color_space = JCS_CMYK;
@@ -452,6 +458,303 @@ bool SkJpegCodec::onDimensionsSupported(const SkISize& size) {
     return true;
 }
 
+/*
+ *  Restart markers split a jpeg's entropy-coded data into segments that can each be decoded
+ *  on their own.  When the segments start on rows of MCUs, we can decode bands of rows in
+ *  parallel, each with its own decompress struct reading a small jpeg made of the original
+ *  header and the segments for that band.
+ */
+namespace {
+
+struct RestartBands {
+    const uint8_t*     fData;
+    SkTDArray<uint8_t> fHeader;         // SOI through SOS, minus markers we do not need.
+    size_t             fHeightOffset;   // Offset of the image height in fHeader's SOF.
+    SkTDArray<size_t>  fSegmentStarts;  // Offsets into fData of each segment's first byte...
+    SkTDArray<size_t>  fSegmentEnds;    // ...and of the marker that ends it.
+    int                fMCUsPerRow;
+    int                fMCUHeight;
+    int                fImageHeight;
+    unsigned int       fRestartInterval;
+};
+
+}  // namespace
+
+/*
+ *  Copies everything but the metadata from SOI through the first SOS into bands->fHeader,
+ *  and sets scanStart to the offset of the scan data that follows.  Fails on anything but a
+ *  baseline or extended sequential, huffman-coded jpeg.
+ */
+static bool copy_header(const uint8_t* data, size_t length, RestartBands* bands,
+                        size_t* scanStart) {
+    bool sawSOF = false;
+    size_t pos = 2;
+    bands->fHeader.append(2, data);
+    while (pos < length) {
+        if (0xFF != data[pos]) {
+            return false;
+        }
+        // Skip any fill bytes before the marker.
+        while (pos < length && 0xFF == data[pos]) {
+            pos++;
+        }
+        const size_t markerStart = pos - 1;
+        if (pos + 3 > length) {
+            return false;
+        }
+        const uint8_t marker = data[pos];
+        const size_t segmentLength = (data[pos + 1] << 8) | data[pos + 2];
+        const size_t segmentEnd = pos + 1 + segmentLength;
+        if (segmentLength < 2 || segmentEnd > length) {
+            return false;
+        }
+
+        switch (marker) {
+            case JPEG_APP0:
+            case JPEG_APP0 + 14:
+            case 0xC4:  // DHT
+            case 0xDB:  // DQT
+            case 0xDD:  // DRI
+                break;
+            case 0xC0:  // SOF0
+            case 0xC1:  // SOF1
+                if (segmentLength < 7) {
+                    return false;
+                }
+                bands->fHeightOffset = bands->fHeader.count() + 5;
+                sawSOF = true;
+                break;
+            case JPEG_COM:
+                pos = segmentEnd;
+                continue;
+            case 0xDA:  // SOS
+                bands->fHeader.append(SkToInt(segmentEnd - markerStart), data + markerStart);
+                *scanStart = segmentEnd;
+                return sawSOF;
+            default:
+                if (marker > JPEG_APP0 && marker <= JPEG_APP0 + 15) {
+                    // Other application markers hold metadata like EXIF and ICC profiles.
+                    pos = segmentEnd;
+                    continue;
+                }
+                return false;
+        }
+        bands->fHeader.append(SkToInt(segmentEnd - markerStart), data + markerStart);
+        pos = segmentEnd;
+    }
+    return false;
+}
+
+/*
+ *  Finds the bounds of each of the count segments of the scan starting at scanStart,
+ *  checking that they are separated by RST0, RST1, ... RST7, RST0, ... in order.
+ */
+static bool find_segments(const uint8_t* data, size_t length, size_t scanStart, int count,
+                          RestartBands* bands) {
+    bands->fSegmentStarts.setReserve(count);
+    bands->fSegmentEnds.setReserve(count);
+    *bands->fSegmentStarts.append() = scanStart;
+
+    size_t pos = scanStart;
+    while (pos < length) {
+        const uint8_t* ff = (const uint8_t*) memchr(data + pos, 0xFF, length - pos);
+        if (!ff) {
+            return false;
+        }
+        const size_t markerStart = ff - data;
+        pos = markerStart + 1;
+        while (pos < length && 0xFF == data[pos]) {
+            pos++;
+        }
+        if (pos == length) {
+            return false;
+        }
+        const uint8_t marker = data[pos++];
+        if (0x00 == marker) {
+            // A stuffed 0xFF in the entropy-coded data.
+            continue;
+        }
+
+        const int segment = bands->fSegmentEnds.count();
+        *bands->fSegmentEnds.append() = markerStart;
+        if (segment == count - 1) {
+            // The last segment ends with some marker other than RSTn, usually EOI.
+            return marker < JPEG_RST0 || marker > JPEG_RST0 + 7;
+        }
+        if (marker != JPEG_RST0 + (segment & 7)) {
+            return false;
+        }
+        *bands->fSegmentStarts.append() = pos;
+    }
+    return false;
+}
+
+/*
+ *  Decodes rows [skipRows, skipRows + rows) of a jpeg made of the MCU rows
+ *  [firstMCURow, endMCURow) of the original image, into dst.
+ */
+static bool decode_band(const RestartBands& bands, const jpeg_decompress_struct& settings,
+                        int firstMCURow, int endMCURow, int skipRows, int rows,
+                        void* dst, size_t dstRowBytes) {
+    const int firstSegment = firstMCURow * bands.fMCUsPerRow / bands.fRestartInterval;
+    const int endSegment = SkTMin(bands.fSegmentEnds.count(),
+            SkToInt((endMCURow * bands.fMCUsPerRow + bands.fRestartInterval - 1) /
+                    bands.fRestartInterval));
+    const size_t dataStart = bands.fSegmentStarts[firstSegment];
+    const size_t dataEnd = bands.fSegmentEnds[endSegment - 1];
+
+    SkTDArray<uint8_t> jpeg;
+    jpeg.setReserve(bands.fHeader.count() + SkToInt(dataEnd - dataStart) + 2);
+    jpeg.append(bands.fHeader.count(), bands.fHeader.begin());
+    jpeg.append(SkToInt(dataEnd - dataStart), bands.fData + dataStart);
+    static const uint8_t kEOI[] = { 0xFF, JPEG_EOI };
+    jpeg.append(sizeof(kEOI), kEOI);
+
+    // Shrink the image to the band, and renumber its restart markers to start from RST0.
+    const int height = SkTMin(endMCURow * bands.fMCUHeight, bands.fImageHeight) -
+                       firstMCURow * bands.fMCUHeight;
+    jpeg[SkToInt(bands.fHeightOffset)]     = height >> 8;
+    jpeg[SkToInt(bands.fHeightOffset) + 1] = height & 0xFF;
+    for (int i = firstSegment + 1; i < endSegment; i++) {
+        const size_t marker = bands.fHeader.count() + bands.fSegmentStarts[i] - 1 - dataStart;
+        jpeg[SkToInt(marker)] = JPEG_RST0 + ((i - firstSegment - 1) & 7);
+    }
+
+    // Enough room for a row of any of the output color spaces we decode bands to.
+    SkAutoTMalloc<JSAMPLE> skipped(skipRows ? settings.image_width * 4 : 0);
+
+    SkMemoryStream stream(jpeg.begin(), jpeg.count(), false);
+    JpegDecoderMgr decoderMgr(&stream);
+    if (setjmp(decoderMgr.getJmpBuf())) {
+        return decoderMgr.returnFalse("decode_band/setjmp");
+    }
+    decoderMgr.init();
+
+    jpeg_decompress_struct* dinfo = decoderMgr.dinfo();
+    if (JPEG_HEADER_OK != jpeg_read_header(dinfo, true)) {
+        return decoderMgr.returnFalse("decode_band/read_header");
+    }
+    dinfo->out_color_space     = settings.out_color_space;
+    dinfo->dither_mode         = settings.dither_mode;
+    dinfo->dct_method          = settings.dct_method;
+    dinfo->do_fancy_upsampling = settings.do_fancy_upsampling;
+    if (!jpeg_start_decompress(dinfo)) {
+        return decoderMgr.returnFalse("decode_band/start_decompress");
+    }
+
+    JSAMPLE* row = skipped.get();
+    for (int y = 0; y < skipRows; y++) {
+        if (1 != jpeg_read_scanlines(dinfo, &row, 1)) {
+            return false;
+        }
+    }
+    row = (JSAMPLE*) dst;
+    for (int y = 0; y < rows; y++) {
+        if (1 != jpeg_read_scanlines(dinfo, &row, 1)) {
+            return false;
+        }
+        sk_msan_mark_initialized(row, row + dstRowBytes, "skbug.com/4550");
+        row = SkTAddOffset<JSAMPLE>(row, dstRowBytes);
+    }
+    return true;
+}
+
+bool SkJpegCodec::decodeRestartBands(const SkImageInfo& dstInfo, void* dst,
+                                     size_t dstRowBytes) {
+    // Bands are at least this many MCU rows, and we split an image into at most this many.
+    static const int kMinMCURowsPerBand = 8;
+    static const int kMaxBands = 32;
+
+    const jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    const J_COLOR_SPACE colorSpace = dinfo->out_color_space;
+    if (0 == dinfo->restart_interval || dinfo->progressive_mode || dinfo->arith_code ||
+            dinfo->comps_in_scan != dinfo->num_components ||
+            JCS_CMYK == colorSpace || JCS_RGB == colorSpace ||
+            dstInfo.width() != (int) dinfo->image_width ||
+            dstInfo.height() != (int) dinfo->image_height) {
+        return false;
+    }
+
+    SkStream* stream = this->stream();
+    const uint8_t* data = (const uint8_t*) stream->getMemoryBase();
+    if (!data || !stream->hasLength() || !IsJpeg(data, stream->getLength())) {
+        return false;
+    }
+    const size_t length = stream->getLength();
+
+    // A scan of one component has one block per MCU, otherwise MCUs are the size of the
+    // most sampled component.
+    RestartBands bands;
+    bands.fData = data;
+    bands.fImageHeight = dinfo->image_height;
+    bands.fRestartInterval = dinfo->restart_interval;
+    const int mcuWidth  = 1 == dinfo->num_components ? DCTSIZE :
+                                                       DCTSIZE * dinfo->max_h_samp_factor;
+    bands.fMCUHeight    = 1 == dinfo->num_components ? DCTSIZE :
+                                                       DCTSIZE * dinfo->max_v_samp_factor;
+    bands.fMCUsPerRow   = (dinfo->image_width + mcuWidth - 1) / mcuWidth;
+    const int mcuRows = (dinfo->image_height + bands.fMCUHeight - 1) / bands.fMCUHeight;
+    const int segments = SkToInt((mcuRows * bands.fMCUsPerRow + bands.fRestartInterval - 1) /
+                                 bands.fRestartInterval);
+
+    // Bands must start on a segment that starts a row, which happens every rowStep rows.
+    unsigned int a = bands.fRestartInterval, b = bands.fMCUsPerRow;
+    while (b) {
+        unsigned int t = a % b;
+        a = b;
+        b = t;
+    }
+    const int rowStep = bands.fRestartInterval / a;
+
+    int rowsPerBand = SkTMax(kMinMCURowsPerBand, (mcuRows + kMaxBands - 1) / kMaxBands);
+    rowsPerBand = (rowsPerBand + rowStep - 1) / rowStep * rowStep;
+    const int bandCount = (mcuRows + rowsPerBand - 1) / rowsPerBand;
+    if (bandCount < 2) {
+        return false;
+    }
+
+    // Fancy upsampling of vertically subsampled components blends each row with its
+    // neighbors, so we decode an extra segment-aligned MCU row above and below each band.
+    int contextRows = 0;
+    for (int i = 0; i < dinfo->num_components; i++) {
+        if (dinfo->do_fancy_upsampling &&
+                dinfo->comp_info[i].v_samp_factor != dinfo->max_v_samp_factor) {
+            contextRows = rowStep;
+        }
+    }
+    if (4 * contextRows > rowsPerBand) {
+        // All that extra decoding would cost more than the bands save.
+        return false;
+    }
+
+    size_t scanStart;
+    if (!copy_header(data, length, &bands, &scanStart) ||
+            !find_segments(data, length, scanStart, segments, &bands)) {
+        return false;
+    }
+
+    SkAutoTMalloc<bool> succeeded(bandCount);
+    SkTaskGroup().batch(bandCount, [&](int i) {
+        const int firstRow = i * rowsPerBand;
+        const int endRow = SkTMin(firstRow + rowsPerBand, mcuRows);
+        const int firstDecodedRow = SkTMax(0, firstRow - contextRows);
+        const int endDecodedRow = SkTMin(mcuRows, endRow + contextRows);
+
+        const int top = firstRow * bands.fMCUHeight;
+        const int bottom = SkTMin(endRow * bands.fMCUHeight, bands.fImageHeight);
+        succeeded[i] = decode_band(bands, *dinfo, firstDecodedRow, endDecodedRow,
+                                   top - firstDecodedRow * bands.fMCUHeight, bottom - top,
+                                   SkTAddOffset<void>(dst, top * dstRowBytes), dstRowBytes);
+    });
+
+    for (int i = 0; i < bandCount; i++) {
+        if (!succeeded[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
 /*
  * Performs the jpeg decode
  */
@@ -477,11 +780,43 @@ SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& dstInfo,
         return fDecoderMgr->returnFailure("conversion_possible", kInvalidConversion);
     }
 
+    // Large images with restart markers may be decoded in parallel bands of rows.
+    if (!this->colorXform() && this->decodeRestartBands(dstInfo, dst, dstRowBytes)) {
+        return kSuccess;
+    }
+
+    // Progressive images are decoded in buffered-image mode. If the data runs out part way
+    // through, we can still output the image as refined by every scan that did arrive, rather
+    // than nothing at all.
+    const bool progressive = dinfo->progressive_mode;
+    if (progressive) {
+        dinfo->buffered_image = TRUE;
+    }
+
     // Now, given valid output dimensions, we can start the decompress
     if (!jpeg_start_decompress(dinfo)) {
         return fDecoderMgr->returnFailure("startDecompress", kInvalidInput);
     }
 
+    bool incomplete = false;
+    if (progressive) {
+        int status;
+        do {
+            status = jpeg_consume_input(dinfo);
+        } while (JPEG_SUSPENDED != status && JPEG_REACHED_EOI != status);
+        incomplete = JPEG_SUSPENDED == status;
+
+        // The scan still arriving can only be output as far as it got, so prefer the last
+        // complete one when there is one.
+        int scan = dinfo->input_scan_number;
+        if (incomplete && scan > 1) {
+            scan--;
+        }
+        if (!jpeg_start_output(dinfo, scan)) {
+            return fDecoderMgr->returnFailure("startOutput", kInvalidInput);
+        }
+    }
+
     // The recommended output buffer height should always be 1 in high quality modes.
     // If it's not, we want to know because it means our strategy is not optimal.
     SkASSERT(1 == dinfo->rec_outbuf_height);
@@ -520,10 +855,16 @@ SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& dstInfo,
             fSwizzler->swizzle(dst, dstRow);
             dst = SkTAddOffset<JSAMPLE>(dst, dstRowBytes);
         } else {
+            this->xformRow(dstRow);
             dstRow = SkTAddOffset<JSAMPLE>(dstRow, dstRowBytes);
         }
     }
 
+    if (incomplete) {
+        // Every row was written, but only at the detail of the scans we had.
+        *rowsDecoded = dstHeight;
+        return fDecoderMgr->returnFailure("Incomplete progressive image data", kIncompleteInput);
+    }
     return kSuccess;
 }
 
@@ -558,13 +899,23 @@ void SkJpegCodec::initializeSwizzler(const SkImageInfo& dstInfo, const Options&
                 fSwizzlerSubset.width() == options.fSubset->width());
         swizzlerOptions.fSubset = &fSwizzlerSubset;
     }
-    fSwizzler.reset(SkSwizzler::CreateSwizzler(swizzlerInfo, nullptr, dstInfo, swizzlerOptions,
-                                               nullptr, preSwizzled));
+    const SkImageInfo swizzlerDstInfo = this->colorXform() ?
+            dstInfo.makeColorType(kRGBA_8888_SkColorType) : dstInfo;
+    fSwizzler.reset(SkSwizzler::CreateSwizzler(swizzlerInfo, nullptr, swizzlerDstInfo,
+                                               swizzlerOptions, nullptr, preSwizzled));
     SkASSERT(fSwizzler);
+    fSwizzler->setColorXform(this->colorXform());
     fStorage.reset(get_row_bytes(fDecoderMgr->dinfo()));
     fSrcRow = fStorage.get();
 }
 
+void SkJpegCodec::xformRow(uint8_t* row) const {
+    if (const SkColorSpaceXform* xform = this->colorXform()) {
+        xform->xform_RGB1_8888((uint32_t*) row, (const uint32_t*) row,
+                               fDecoderMgr->dinfo()->output_width);
+    }
+}
+
 SkSampler* SkJpegCodec::getSampler(bool createIfNecessary) {
     if (!createIfNecessary || fSwizzler) {
         SkASSERT(!fSwizzler || (fSrcRow && fStorage.get() == fSrcRow));
@@ -688,6 +1039,7 @@ int SkJpegCodec::onGetScanlines(void* dst, int count, size_t dstRowBytes) {
             fSwizzler->swizzle(dst, dstRow);
             dst = SkTAddOffset<JSAMPLE>(dst, dstRowBytes);
         } else {
+            this->xformRow(dstRow);
             dstRow = SkTAddOffset<JSAMPLE>(dstRow, dstRowBytes);
         }
     }
@@ -104,6 +104,20 @@ private:
      */
     bool setOutputColorSpace(const SkImageInfo& dst);
 
+    /*
+     * Decodes the whole image as bands of rows in parallel, one band per group of restart
+     * intervals.  Returns false without decoding if the image has no restart markers, is
+     * too small to split, or its encoded data is not in memory.  Returns false if any band
+     * fails, in which case dst must be decoded again serially.
+     */
+    bool decodeRestartBands(const SkImageInfo& dstInfo, void* dst, size_t dstRowBytes);
+
+    /*
+     * Converts a row that libjpeg wrote straight to dst to the dst color space, if the
+     * decode has a color conversion.  Rows that go through fSwizzler are converted there.
+     */
+    void xformRow(uint8_t* row) const;
+
     // scanline decoding
     void initializeSwizzler(const SkImageInfo& dstInfo, const Options& options);
     SkSampler* getSampler(bool createIfNecessary) override;
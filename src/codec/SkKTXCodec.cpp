@@ -0,0 +1,194 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCodecPriv.h"
+#include "SkKTXCodec.h"
+#include "SkOpts.h"
+#include "SkStream.h"
+#include "SkStreamPriv.h"
+#include "SkTemplates.h"
+#include "ktx.h"
+
+using namespace SkTextureCompressor;
+
+// Bytes per pixel that DecompressBufferFromFormat writes.
+static int decompressed_bytes_per_pixel(Format format) {
+    switch (format) {
+        case kLATC_Format:
+        case kR11_EAC_Format:
+            return 1;
+        case kETC1_Format:
+            return 3;
+        default:
+            return 4;
+    }
+}
+
+// Compressed data covers whole blocks, even past the image's edges.
+static int64_t round_up_to_block(int64_t size, int block) {
+    return (size + block - 1) / block * block;
+}
+
+static bool find_compressed_format(const SkKTXFile& ktx, Format* format) {
+    for (int i = 0; i < kFormatCnt; ++i) {
+        if (ktx.isCompressedFormat(static_cast<Format>(i))) {
+            *format = static_cast<Format>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+static SkEncodedInfo encoded_info(int bytesPerPixel) {
+    switch (bytesPerPixel) {
+        case 1:
+            return SkEncodedInfo::Make(SkEncodedInfo::kGray_Color,
+                                       SkEncodedInfo::kOpaque_Alpha, 8);
+        case 3:
+            return SkEncodedInfo::Make(SkEncodedInfo::kRGB_Color,
+                                       SkEncodedInfo::kOpaque_Alpha, 8);
+        default:
+            return SkEncodedInfo::Make(SkEncodedInfo::kRGBA_Color,
+                                       SkEncodedInfo::kUnpremul_Alpha, 8);
+    }
+}
+
+bool SkKTXCodec::IsKTX(const void* buffer, size_t bytesRead) {
+    return SkKTXFile::is_ktx(static_cast<const uint8_t*>(buffer), bytesRead);
+}
+
+SkCodec* SkKTXCodec::NewFromStream(SkStream* stream) {
+    SkAutoTDelete<SkStream> streamDeleter(stream);
+    sk_sp<SkData> data(SkCopyStreamToData(stream));
+    if (!data || !SkKTXFile::is_ktx(data->bytes(), data->size())) {
+        return nullptr;
+    }
+
+    SkAutoTDelete<SkKTXFile> ktx(new SkKTXFile(data.get()));
+    const int width = ktx->width();
+    const int height = ktx->height();
+    if (!ktx->valid() || width <= 0 || height <= 0) {
+        return nullptr;
+    }
+
+    Format format = kETC1_Format;
+    const bool compressed = find_compressed_format(*ktx, &format);
+    if (!compressed && !ktx->isRGBA8()) {
+        SkCodecPrintf("Unsupported KTX format.\n");
+        return nullptr;
+    }
+
+    int blockW = 1, blockH = 1;
+    if (compressed) {
+        GetBlockDimensions(format, &blockW, &blockH, true);
+    }
+    const int64_t paddedW = round_up_to_block(width, blockW);
+    const int64_t paddedH = round_up_to_block(height, blockH);
+    if (paddedW * paddedH * 4 > SK_MaxS32) {
+        SkCodecPrintf("KTX image is too large.\n");
+        return nullptr;
+    }
+
+    const size_t expectedSize = compressed ? GetCompressedDataSize(format, (int)paddedW,
+                                                                   (int)paddedH)
+                                           : width * height * 4;
+    if (ktx->pixelDataSize() < expectedSize) {
+        SkCodecPrintf("KTX pixel data is truncated.\n");
+        return nullptr;
+    }
+
+    const bool premultiplied =
+            ktx->getValueForKey(SkString("KTXPremultipliedAlpha")).equals("True");
+    const SkEncodedInfo info = encoded_info(compressed ? decompressed_bytes_per_pixel(format) : 4);
+    return new SkKTXCodec(width, height, info, streamDeleter.release(), ktx.release(),
+                          compressed, format, premultiplied);
+}
+
+SkKTXCodec::SkKTXCodec(int width, int height, const SkEncodedInfo& info, SkStream* stream,
+                       SkKTXFile* ktx, bool compressed, Format format, bool premultiplied)
+    : INHERITED(width, height, info, stream)
+    , fKTX(ktx)
+    , fCompressed(compressed)
+    , fFormat(format)
+    , fPremultiplied(premultiplied)
+{}
+
+SkKTXCodec::~SkKTXCodec() {}
+
+static void copy_8(uint32_t* dst, const void* src, int count) {
+    memcpy(dst, src, count);
+}
+
+static void copy_8888(uint32_t* dst, const void* src, int count) {
+    memcpy(dst, src, count * 4);
+}
+
+static SkOpts::Swizzle_8888 choose_proc(int srcBytesPerPixel, bool srcPremul,
+                                        const SkImageInfo& dstInfo) {
+    const bool dstBGRA = kBGRA_8888_SkColorType == dstInfo.colorType();
+    switch (srcBytesPerPixel) {
+        case 1:
+            return kGray_8_SkColorType == dstInfo.colorType() ? copy_8 : SkOpts::gray_to_RGB1;
+        case 3:
+            return dstBGRA ? SkOpts::RGB_to_BGR1 : SkOpts::RGB_to_RGB1;
+        default:
+            break;
+    }
+
+    if (kUnpremul_SkAlphaType == dstInfo.alphaType() && srcPremul) {
+        return dstBGRA ? SkOpts::rgbA_to_BGRA : SkOpts::rgbA_to_RGBA;
+    }
+    if (kPremul_SkAlphaType == dstInfo.alphaType() && !srcPremul) {
+        return dstBGRA ? SkOpts::RGBA_to_bgrA : SkOpts::RGBA_to_rgbA;
+    }
+    return dstBGRA ? SkOpts::RGBA_to_BGRA : copy_8888;
+}
+
+SkCodec::Result SkKTXCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst, size_t dstRowBytes,
+                                        const Options& options, SkPMColor*, int*, int*) {
+    if (options.fSubset) {
+        // Subsets are not supported.
+        return kUnimplemented;
+    }
+
+    if (dstInfo.dimensions() != this->getInfo().dimensions()) {
+        return kInvalidScale;
+    }
+
+    // There's no swizzle from decompressed pixels to 565.
+    if (!conversion_possible(dstInfo, this->getInfo()) ||
+            kRGB_565_SkColorType == dstInfo.colorType()) {
+        return kInvalidConversion;
+    }
+
+    const uint8_t* src = fKTX->pixelData();
+    int srcBytesPerPixel = 4;
+    size_t srcRowBytes = dstInfo.width() * 4;
+    SkAutoTMalloc<uint8_t> decompressed;
+    if (fCompressed) {
+        int blockW, blockH;
+        GetBlockDimensions(fFormat, &blockW, &blockH, true);
+        const int paddedW = (int)round_up_to_block(dstInfo.width(), blockW);
+        const int paddedH = (int)round_up_to_block(dstInfo.height(), blockH);
+
+        srcBytesPerPixel = decompressed_bytes_per_pixel(fFormat);
+        srcRowBytes = paddedW * srcBytesPerPixel;
+        decompressed.reset(srcRowBytes * paddedH);
+        if (!DecompressBufferFromFormat(decompressed.get(), (int)srcRowBytes, src,
+                                        paddedW, paddedH, fFormat)) {
+            return kInvalidInput;
+        }
+        src = decompressed.get();
+    }
+
+    SkOpts::Swizzle_8888 proc = choose_proc(srcBytesPerPixel, fPremultiplied, dstInfo);
+    for (int y = 0; y < dstInfo.height(); ++y) {
+        proc(SkTAddOffset<uint32_t>(dst, y * dstRowBytes), src + y * srcRowBytes,
+             dstInfo.width());
+    }
+    return kSuccess;
+}
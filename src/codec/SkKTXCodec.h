@@ -0,0 +1,68 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkKTXCodec_DEFINED
+#define SkKTXCodec_DEFINED
+
+#include "SkCodec.h"
+#include "SkData.h"
+#include "SkTextureCompressor.h"
+
+class SkKTXFile;
+
+/*
+ *  Decodes KTX files holding a single RGBA8 image, or one compressed with a format
+ *  SkTextureCompressor can decompress (ETC1, ETC2 RGBA8, BC1, BC3, LATC, R11 EAC or
+ *  ASTC).  The single channel formats decode to gray.
+ *
+ *  Compressed payloads don't need to be decoded at all on the GPU:
+ *  SkCodecImageGenerator uploads them as compressed textures where GrCaps allows.
+ */
+class SkKTXCodec final : public SkCodec {
+public:
+    static bool IsKTX(const void*, size_t);
+
+    /*
+     * Assumes IsKTX was called and returned true
+     * Creates a KTX codec
+     * Takes ownership of the stream
+     */
+    static SkCodec* NewFromStream(SkStream*);
+
+    ~SkKTXCodec() override;
+
+protected:
+    SkEncodedFormat onGetEncodedFormat() const override {
+        return kKTX_SkEncodedFormat;
+    }
+
+    Result onGetPixels(const SkImageInfo&, void*, size_t,
+                       const Options&, SkPMColor[], int*, int*) override;
+
+    bool onRewind() override {
+        // The whole file was read up front.
+        return true;
+    }
+
+private:
+    /*
+     * Takes ownership of the stream and the ktx file
+     */
+    SkKTXCodec(int width, int height, const SkEncodedInfo&, SkStream*, SkKTXFile*,
+               bool compressed, SkTextureCompressor::Format, bool premultiplied);
+
+    SkAutoTDelete<SkKTXFile>          fKTX;
+    // If fCompressed is false, the pixels are uncompressed RGBA8.
+    const bool                        fCompressed;
+    const SkTextureCompressor::Format fFormat;
+    // True if the RGBA pixels were premultiplied before they were written.
+    const bool                        fPremultiplied;
+
+    typedef SkCodec INHERITED;
+};
+
+#endif  // SkKTXCodec_DEFINED
@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "SkAtomics.h"
 #include "SkBitmap.h"
 #include "SkCodecPriv.h"
 #include "SkColorPriv.h"
@@ -13,12 +14,16 @@
 #include "SkMath.h"
 #include "SkOpts.h"
 #include "SkPngCodec.h"
+#include "SkSemaphore.h"
 #include "SkSize.h"
 #include "SkStream.h"
 #include "SkSwizzler.h"
 #include "SkTemplates.h"
+#include "SkThreadUtils.h"
 #include "SkUtils.h"
 
+#include "zlib.h"
+
 ///////////////////////////////////////////////////////////////////////////////
 // Callback functions
 ///////////////////////////////////////////////////////////////////////////////
@@ -291,6 +296,10 @@ public:
         if (!conversion_possible(dstInfo, this->getInfo())) {
             return kInvalidConversion;
         }
+        if (dstInfo.dimensions() != this->getInfo().dimensions()) {
+            // Only getPixels() scales.
+            return kInvalidScale;
+        }
 
         const Result result = this->initializeSwizzler(dstInfo, options, ctable,
                                                        ctableCount);
@@ -362,6 +371,10 @@ public:
         if (!conversion_possible(dstInfo, this->getInfo())) {
             return kInvalidConversion;
         }
+        if (dstInfo.dimensions() != this->getInfo().dimensions()) {
+            // Only getPixels() scales.
+            return kInvalidScale;
+        }
 
         const Result result = this->initializeSwizzler(dstInfo, options, ctable,
                                                        ctableCount);
@@ -638,6 +651,7 @@ SkPngCodec::SkPngCodec(int width, int height, const SkEncodedInfo& info, SkStrea
     , fInfo_ptr(info_ptr)
     , fNumberPasses(numberPasses)
     , fBitDepth(bitDepth)
+    , fStreamIsInMemory(stream->getMemoryBase() && stream->hasLength() && stream->hasPosition())
 {}
 
 SkPngCodec::~SkPngCodec() {
@@ -654,6 +668,365 @@ void SkPngCodec::destroyReadStruct() {
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Inflating without libpng
+///////////////////////////////////////////////////////////////////////////////
+
+// Non-interlaced, 8-bit pngs that need no transforms from libpng, and whose encoded data is all
+// in memory, can skip libpng for their image data.  Large ones decode on two threads: a second
+// thread inflates the IDAT chunks into a ring of filtered rows, while the calling thread
+// unfilters and swizzles them.  Subsets resume inflating from the nearest checkpoint above them.
+
+namespace {
+
+// Inflates the rows of a png, straight from the IDAT chunks of its encoded data.
+class PngInflater : SkNoncopyable {
+public:
+    // idatStart is the offset of the first IDAT chunk, and rowBytes does not count filter bytes.
+    PngInflater(const uint8_t* data, size_t length, size_t idatStart, size_t rowBytes)
+        : fData(data)
+        , fLength(length)
+        , fNextChunk(idatStart)
+        , fRowBytes(rowBytes + 1)
+    {
+        sk_bzero(&fStream, sizeof(fStream));
+    }
+
+    ~PngInflater() { inflateEnd(&fStream); }
+
+    // Call one of these before inflating any rows: init() to start at the first row, or
+    // resumeFrom() to pick up where another inflater (of the same data) was.
+    bool init() { return Z_OK == inflateInit(&fStream); }
+    bool resumeFrom(PngInflater* that) {
+        fNextChunk = that->fNextChunk;
+        return Z_OK == inflateCopy(&fStream, &that->fStream);
+    }
+
+    // Inflates the next row's filter type byte, followed by the filtered row.
+    bool inflateRow(uint8_t* row) {
+        fStream.next_out = row;
+        fStream.avail_out = SkToU32(fRowBytes);
+        while (fStream.avail_out > 0) {
+            if (0 == fStream.avail_in && !this->nextChunk()) {
+                return false;
+            }
+            int result = ::inflate(&fStream, Z_NO_FLUSH);
+            if (Z_STREAM_END == result) {
+                return 0 == fStream.avail_out;
+            }
+            if (Z_OK != result) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    // Points fStream at the data of the next non-empty IDAT chunk, if there is one.  A chunk cut
+    // short by the end of the data is still used, as far as it goes.
+    bool nextChunk() {
+        while (fNextChunk + 8 <= fLength) {
+            const uint8_t* chunk = fData + fNextChunk;
+            const size_t length = png_get_uint_32(chunk);
+            if (0 != memcmp(chunk + 4, "IDAT", 4)) {
+                return false;
+            }
+
+            const size_t available = fLength - fNextChunk - 8;
+            if (length + 4 <= available) {
+                const uLong crc = crc32(crc32(0, chunk + 4, 4), chunk + 8, SkToU32(length));
+                if (crc != png_get_uint_32(chunk + 8 + length)) {
+                    return false;
+                }
+                fNextChunk += 12 + length;
+            } else {
+                fNextChunk = fLength;
+            }
+
+            fStream.next_in = const_cast<uint8_t*>(chunk + 8);
+            fStream.avail_in = SkToU32(SkTMin(length, available));
+            if (fStream.avail_in > 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const uint8_t* fData;
+    const size_t   fLength;
+    size_t         fNextChunk;
+    const size_t   fRowBytes;
+    z_stream       fStream;
+};
+
+class PngRowPipeline : SkNoncopyable {
+public:
+    PngRowPipeline(const uint8_t* data, size_t length, size_t idatStart, size_t rowBytes,
+                   int height)
+        : fInflater(data, length, idatStart, rowBytes)
+        , fRowBytes(rowBytes + 1)
+        , fHeight(height)
+        , fRing(kRingRows * fRowBytes)
+        , fFree(kRingRows)
+        , fFilled(0)
+        , fCancelled(false)
+        , fThread(&PngRowPipeline::Inflate, this)
+    {}
+
+    bool start() { return fThread.start(); }
+
+    // Waits for row y, and returns its filter type byte followed by the filtered row.
+    // The filter type is kFailed if we could not inflate row y.
+    uint8_t* waitForRow(int y) {
+        fFilled.wait();
+        return this->slot(y);
+    }
+
+    // The caller is done with the oldest row it has waited for.
+    void releaseRow() { fFree.signal(); }
+
+    // Stops inflating and waits for the inflating thread to finish.
+    void finish() {
+        fCancelled.store(true);
+        fFree.signal(kRingRows);
+        fThread.join();
+    }
+
+    static const uint8_t kFailed = 0xFF;
+
+private:
+    // Enough rows that each thread can usually run a while without waiting for the other.
+    static const int kRingRows = 32;
+
+    uint8_t* slot(int y) { return fRing.get() + (y % kRingRows) * fRowBytes; }
+
+    static void Inflate(void* pipeline) { ((PngRowPipeline*)pipeline)->inflate(); }
+
+    void inflate() {
+        bool ok = fInflater.init();
+        for (int y = 0; y < fHeight; y++) {
+            fFree.wait();
+            if (fCancelled.load()) {
+                break;
+            }
+            uint8_t* row = this->slot(y);
+            ok = ok && fInflater.inflateRow(row);
+            if (!ok) {
+                row[0] = kFailed;
+            }
+            fFilled.signal();
+            if (!ok) {
+                break;
+            }
+        }
+    }
+
+    PngInflater            fInflater;   // Only used by the inflating thread.
+    const size_t           fRowBytes;
+    const int              fHeight;
+    SkAutoTMalloc<uint8_t> fRing;
+    SkSemaphore            fFree,       // Slots in fRing ready to inflate into...
+                           fFilled;     // ...and rows inflated, ready to unfilter.
+    SkAtomic<bool>         fCancelled;
+    SkThread               fThread;
+};
+
+// Undoes the row's filter, given the row above it already unfiltered.  Returns false for a bad
+// filter type (including PngRowPipeline::kFailed).
+bool unfilter_row(uint8_t filter, uint8_t* row, const uint8_t* prev, size_t rowBytes, int bpp) {
+    switch (filter) {
+        case PNG_FILTER_VALUE_NONE:
+            return true;
+        case PNG_FILTER_VALUE_SUB:
+            SkOpts::png_unfilter_sub(row, prev, rowBytes, bpp);
+            return true;
+        case PNG_FILTER_VALUE_UP:
+            SkOpts::png_unfilter_up(row, prev, rowBytes, bpp);
+            return true;
+        case PNG_FILTER_VALUE_AVG:
+            SkOpts::png_unfilter_avg(row, prev, rowBytes, bpp);
+            return true;
+        case PNG_FILTER_VALUE_PAETH:
+            SkOpts::png_unfilter_paeth(row, prev, rowBytes, bpp);
+            return true;
+        default:
+            return false;
+    }
+}
+
+}  // namespace
+
+// Everything needed to start inflating again at fRow.
+struct SkPngCodec::Checkpoint {
+    Checkpoint(const uint8_t* data, size_t length, size_t idatStart, size_t rowBytes)
+        : fInflater(data, length, idatStart, rowBytes)
+        , fPrevRow(rowBytes)
+    {}
+
+    int                    fRow;
+    PngInflater            fInflater;
+    SkAutoTMalloc<uint8_t> fPrevRow;    // Row fRow - 1, unfiltered.
+};
+
+bool SkPngCodec::canInflateDirectly() const {
+    // Chunk readers may want to see chunks after the image data, which libpng reads for us.
+    if (!fStreamIsInMemory || !fPng_ptr || 1 != fNumberPasses || 8 != fBitDepth ||
+            fPngChunkReader) {
+        return false;
+    }
+    switch (png_get_color_type(fPng_ptr, fInfo_ptr)) {
+        case PNG_COLOR_TYPE_RGB:
+        case PNG_COLOR_TYPE_GRAY:
+            if (png_get_valid(fPng_ptr, fInfo_ptr, PNG_INFO_tRNS)) {
+                // libpng expands these to add an alpha channel.
+                return false;
+            }
+            break;
+        default:
+            break;
+    }
+    const int bpp = bytes_per_pixel(this->getEncodedInfo().bitsPerPixel());
+    return png_get_rowbytes(fPng_ptr, fInfo_ptr) == this->getInfo().width() * (size_t) bpp;
+}
+
+bool SkPngCodec::findImageData(const uint8_t** data, size_t* length, size_t* idatStart) {
+    if (!this->canInflateDirectly()) {
+        return false;
+    }
+
+    // libpng stops reading the header just after the first IDAT chunk's length and type.
+    SkStream* stream = this->stream();
+    *data = (const uint8_t*) stream->getMemoryBase();
+    *length = stream->getLength();
+    const size_t position = stream->getPosition();
+    if (position < 8 || position > *length || 0 != memcmp(*data + position - 4, "IDAT", 4)) {
+        return false;
+    }
+    *idatStart = position - 8;
+    return true;
+}
+
+SkCodec::Result SkPngCodec::decodePipelined(const SkImageInfo& dstInfo, void* dst,
+                                            size_t dstRowBytes, int* rowsDecoded) {
+    // Smaller images decode quickly enough that another thread would not pay for itself.
+    static const size_t kMinPipelinedBytes = 1 << 18;
+
+    const int height = dstInfo.height();
+    const int bpp = bytes_per_pixel(this->getEncodedInfo().bitsPerPixel());
+    const size_t srcRowBytes = dstInfo.width() * bpp;
+    const uint8_t* data;
+    size_t length, idatStart;
+    if (srcRowBytes * height < kMinPipelinedBytes ||
+            !this->findImageData(&data, &length, &idatStart)) {
+        return kUnimplemented;
+    }
+
+    PngRowPipeline pipeline(data, length, idatStart, srcRowBytes, height);
+    if (!pipeline.start()) {
+        return kUnimplemented;
+    }
+
+    SkAutoTMalloc<uint8_t> zeros(srcRowBytes);
+    sk_bzero(zeros.get(), srcRowBytes);
+    const uint8_t* prev = zeros.get();
+
+    int y = 0;
+    for (; y < height; y++) {
+        uint8_t* row = pipeline.waitForRow(y);
+        const uint8_t filter = *row++;
+        if (!unfilter_row(filter, row, prev, srcRowBytes, bpp)) {
+            break;
+        }
+        fSwizzler->swizzle(dst, row);
+        dst = SkTAddOffset<void>(dst, dstRowBytes);
+
+        // We keep each row until we've unfiltered the next.
+        if (y > 0) {
+            pipeline.releaseRow();
+        }
+        prev = row;
+    }
+    pipeline.finish();
+
+    if (y < height) {
+        *rowsDecoded = y;
+        return kIncompleteInput;
+    }
+    return kSuccess;
+}
+
+SkCodec::Result SkPngCodec::decodeSubset(const SkImageInfo& dstInfo, void* dst,
+                                         size_t dstRowBytes, const SkIRect& subset,
+                                         int* rowsDecoded) {
+    // Each checkpoint holds a copy of zlib's state, including its 32K window, so we keep no
+    // more than about two megabytes of them, however tall the image.
+    static const int kMaxCheckpoints = 64;
+    static const int kMinCheckpointRows = 32;
+
+    const uint8_t* data;
+    size_t length, idatStart;
+    if (!this->findImageData(&data, &length, &idatStart)) {
+        return kUnimplemented;
+    }
+    const int height = this->getInfo().height();
+    const int bpp = bytes_per_pixel(this->getEncodedInfo().bitsPerPixel());
+    const size_t srcRowBytes = this->getInfo().width() * bpp;
+    const int spacing = SkTMax(kMinCheckpointRows,
+                               (height + kMaxCheckpoints - 1) / kMaxCheckpoints);
+
+    // Each buffer holds a row's filter type byte, then the row.
+    SkAutoTMalloc<uint8_t> storage(2 * (srcRowBytes + 1));
+    uint8_t* row  = storage.get();
+    uint8_t* prev = storage.get() + srcRowBytes + 1;
+
+    // Start from the last checkpoint at or above the subset, if we have one.
+    PngInflater inflater(data, length, idatStart, srcRowBytes);
+    int y = 0;
+    const int nearest = SkTMin(subset.top() / spacing, fCheckpoints.count());
+    if (nearest > 0) {
+        Checkpoint* checkpoint = fCheckpoints[nearest - 1].get();
+        if (!inflater.resumeFrom(&checkpoint->fInflater)) {
+            return kInvalidInput;
+        }
+        memcpy(prev + 1, checkpoint->fPrevRow.get(), srcRowBytes);
+        y = checkpoint->fRow;
+    } else {
+        if (!inflater.init()) {
+            return kInvalidInput;
+        }
+        sk_bzero(prev + 1, srcRowBytes);
+    }
+
+    for (; y < subset.bottom(); y++) {
+        // Add the next checkpoint as we pass it.
+        if (y == spacing * (fCheckpoints.count() + 1)) {
+            SkAutoTDelete<Checkpoint> checkpoint(
+                    new Checkpoint(data, length, idatStart, srcRowBytes));
+            if (checkpoint->fInflater.resumeFrom(&inflater)) {
+                checkpoint->fRow = y;
+                memcpy(checkpoint->fPrevRow.get(), prev + 1, srcRowBytes);
+                fCheckpoints.push_back().reset(checkpoint.release());
+            }
+        }
+
+        if (!inflater.inflateRow(row) ||
+                !unfilter_row(row[0], row + 1, prev + 1, srcRowBytes, bpp)) {
+            break;
+        }
+        if (y >= subset.top()) {
+            fSwizzler->swizzle(dst, row + 1);
+            dst = SkTAddOffset<void>(dst, dstRowBytes);
+        }
+        SkTSwap(row, prev);
+    }
+
+    if (y < subset.bottom()) {
+        *rowsDecoded = SkTMax(0, y - subset.top());
+        return kIncompleteInput;
+    }
+    return kSuccess;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Getting the pixels
 ///////////////////////////////////////////////////////////////////////////////
@@ -670,8 +1043,12 @@ SkCodec::Result SkPngCodec::initializeSwizzler(const SkImageInfo& requestedInfo,
     }
     png_read_update_info(fPng_ptr, fInfo_ptr);
 
+    // A color conversion reads RGBA, and then writes the requested color type in place.
+    const SkImageInfo swizzlerInfo = this->colorXform() ?
+            requestedInfo.makeColorType(kRGBA_8888_SkColorType) : requestedInfo;
+
     if (SkEncodedInfo::kPalette_Color == this->getEncodedInfo().color()) {
-        if (!this->createColorTable(requestedInfo.colorType(),
+        if (!this->createColorTable(swizzlerInfo.colorType(),
                 kPremul_SkAlphaType == requestedInfo.alphaType(), ctableCount)) {
             return kInvalidInput;
         }
@@ -682,9 +1059,10 @@ SkCodec::Result SkPngCodec::initializeSwizzler(const SkImageInfo& requestedInfo,
 
     // Create the swizzler.  SkPngCodec retains ownership of the color table.
     const SkPMColor* colors = get_color_ptr(fColorTable.get());
-    fSwizzler.reset(SkSwizzler::CreateSwizzler(this->getEncodedInfo(), colors, requestedInfo,
+    fSwizzler.reset(SkSwizzler::CreateSwizzler(this->getEncodedInfo(), colors, swizzlerInfo,
             options));
     SkASSERT(fSwizzler);
+    fSwizzler->setColorXform(this->colorXform());
 
     return kSuccess;
 }
@@ -716,17 +1094,36 @@ SkCodec::Result SkPngCodec::onGetPixels(const SkImageInfo& requestedInfo, void*
     if (!conversion_possible(requestedInfo, this->getInfo())) {
         return kInvalidConversion;
     }
-    if (options.fSubset) {
-        // Subsets are not supported.
-        return kUnimplemented;
+    if (options.fSubset && requestedInfo.dimensions() != options.fSubset->size()) {
+        // Subsets cannot also be scaled.
+        return kInvalidScale;
     }
 
+    // When scaling, the swizzler still sees every source pixel.
+    const SkISize srcSize = this->getInfo().dimensions();
+    const bool scaling = !options.fSubset && requestedInfo.dimensions() != srcSize;
+    const SkImageInfo swizzlerInfo = options.fSubset ? requestedInfo
+            : requestedInfo.makeWH(srcSize.width(), srcSize.height());
+
     // Note that ctable and ctableCount may be modified if there is a color table
-    const Result result = this->initializeSwizzler(requestedInfo, options, ctable, ctableCount);
+    const Result result = this->initializeSwizzler(swizzlerInfo, options, ctable, ctableCount);
     if (result != kSuccess) {
         return result;
     }
 
+    if (options.fSubset) {
+        return this->decodeSubset(requestedInfo, dst, dstRowBytes, *options.fSubset,
+                                  rowsDecoded);
+    }
+    if (scaling) {
+        return this->decodeScaled(requestedInfo, dst, dstRowBytes, rowsDecoded);
+    }
+
+    const Result pipelined = this->decodePipelined(requestedInfo, dst, dstRowBytes, rowsDecoded);
+    if (kUnimplemented != pipelined) {
+        return pipelined;
+    }
+
     const int width = requestedInfo.width();
     const int height = requestedInfo.height();
     const int bpp = bytes_per_pixel(this->getEncodedInfo().bitsPerPixel());
@@ -795,6 +1192,123 @@ SkCodec::Result SkPngCodec::onGetPixels(const SkImageInfo& requestedInfo, void*
     return kSuccess;
 }
 
+SkCodec::Result SkPngCodec::decodeScaled(const SkImageInfo& dstInfo, void* dst,
+                                         size_t dstRowBytes, int* rowsDecoded) {
+    const int srcWidth = this->getInfo().width();
+    const int srcHeight = this->getInfo().height();
+    const int dstWidth = dstInfo.width();
+    const int dstHeight = dstInfo.height();
+    const int sampleX = srcWidth / dstWidth;
+    const int sampleY = srcHeight / dstHeight;
+    const size_t srcRowBytes = srcWidth * bytes_per_pixel(this->getEncodedInfo().bitsPerPixel());
+
+    // We box filter when we can average the destination's pixels.  Otherwise the swizzler
+    // point samples each row, and we keep every sampleY'th row.
+    SkAutoTDelete<SkBoxSampler> box;
+    SkAutoTMalloc<uint8_t> swizzled;
+    if (SkBoxSampler::IsSupported(dstInfo.colorType())) {
+        box.reset(new SkBoxSampler(dstInfo.colorType(), dstWidth, sampleX, sampleY));
+        swizzled.reset(srcWidth * dstInfo.bytesPerPixel());
+    } else if (fSwizzler->setSampleX(sampleX) != dstWidth) {
+        return kInvalidScale;
+    }
+
+    int y = 0;
+    int dstY = 0;
+    void* dstRow = dst;
+    auto consume = [&](const uint8_t* srcRow) {
+        if (dstY < dstHeight) {
+            if (box) {
+                fSwizzler->swizzle(swizzled.get(), srcRow);
+                if (box->accumulate(swizzled.get(), dstRow)) {
+                    dstRow = SkTAddOffset<void>(dstRow, dstRowBytes);
+                    dstY++;
+                }
+            } else if (is_coord_necessary(y, sampleY, dstHeight)) {
+                fSwizzler->swizzle(dstRow, srcRow);
+                dstRow = SkTAddOffset<void>(dstRow, dstRowBytes);
+                dstY++;
+            }
+        }
+        y++;
+    };
+
+    // This must be declared above the call to setjmp to avoid memory leaks on incomplete images.
+    SkAutoTMalloc<uint8_t> storage;
+    if (setjmp(png_jmpbuf(fPng_ptr))) {
+        if (fNumberPasses > 1) {
+            return (dstY == dstHeight) ? kSuccess : kInvalidInput;
+        }
+        if (box) {
+            // SkCodec fills the rest of the image through the swizzler, which must agree
+            // with us on how wide the rows are.
+            fSwizzler->setSampleX(sampleX);
+        }
+        *rowsDecoded = dstY;
+        return (dstY == dstHeight) ? kSuccess : kIncompleteInput;
+    }
+
+    if (fNumberPasses > 1) {
+        storage.reset(srcHeight * srcRowBytes);
+        uint8_t* const base = storage.get();
+
+        for (int i = 0; i < fNumberPasses; i++) {
+            uint8_t* srcRow = base;
+            for (int row = 0; row < srcHeight; row++) {
+                png_read_row(fPng_ptr, srcRow, nullptr);
+                srcRow += srcRowBytes;
+            }
+        }
+
+        for (int row = 0; row < srcHeight; row++) {
+            consume(base + row * srcRowBytes);
+        }
+    } else {
+        storage.reset(srcRowBytes);
+        uint8_t* srcRow = storage.get();
+        for (int row = 0; row < srcHeight; row++) {
+            png_read_row(fPng_ptr, srcRow, nullptr);
+            consume(srcRow);
+        }
+    }
+
+    png_read_end(fPng_ptr, fInfo_ptr);
+    return kSuccess;
+}
+
+// Returns the range of sample sizes that scale src down to dst, or false if there are none.
+static bool sample_size_range(int src, int dst, int* min, int* max) {
+    if (dst < 1 || dst > src) {
+        return false;
+    }
+    *min = src / (dst + 1) + 1;
+    *max = (1 == dst) ? SK_MaxS32 : src / dst;   // get_scaled_dimension() rounds up to 1.
+    return *min <= *max;
+}
+
+SkISize SkPngCodec::onGetScaledDimensions(float desiredScale) const {
+    const int sampleSize = SkTMax(1, SkScalarRoundToInt(1.0f / desiredScale));
+    const SkISize size = this->getInfo().dimensions();
+    return SkISize::Make(get_scaled_dimension(size.width(), sampleSize),
+                         get_scaled_dimension(size.height(), sampleSize));
+}
+
+bool SkPngCodec::onDimensionsSupported(const SkISize& dim) {
+    // Both dimensions must come from the same sample size.
+    int minX, maxX, minY, maxY;
+    const SkISize size = this->getInfo().dimensions();
+    return sample_size_range(size.width(),  dim.width(),  &minX, &maxX) &&
+           sample_size_range(size.height(), dim.height(), &minY, &maxY) &&
+           SkTMax(minX, minY) <= SkTMin(maxX, maxY);
+}
+
+bool SkPngCodec::onGetValidSubset(SkIRect* desiredSubset) const {
+    // We only decode subsets of image data that we can inflate ourselves, where we can keep
+    // checkpoints in the compressed data.
+    return desiredSubset && this->canInflateDirectly() &&
+           SkIRect::MakeSize(this->getInfo().dimensions()).contains(*desiredSubset);
+}
+
 uint32_t SkPngCodec::onGetFillValue(SkColorType colorType) const {
     const SkPMColor* colorPtr = get_color_ptr(fColorTable.get());
     if (colorPtr) {
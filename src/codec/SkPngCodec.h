@@ -12,6 +12,7 @@
 #include "SkImageInfo.h"
 #include "SkRefCnt.h"
 #include "SkSwizzler.h"
+#include "SkTArray.h"
 
 #include "png.h"
 
@@ -30,6 +31,12 @@ protected:
     Result onGetPixels(const SkImageInfo&, void*, size_t, const Options&, SkPMColor*, int*, int*)
             override;
     SkEncodedFormat onGetEncodedFormat() const override { return kPNG_SkEncodedFormat; }
+    // getPixels() can downscale by whole factors, box filtering when the color type allows.
+    SkISize onGetScaledDimensions(float desiredScale) const override;
+    bool onDimensionsSupported(const SkISize&) override;
+    // getPixels() can decode subsets, without inflating from the top each time, when the
+    // encoded data is in memory and needs no transforms from libpng.
+    bool onGetValidSubset(SkIRect* desiredSubset) const override;
     bool onRewind() override;
     uint32_t onGetFillValue(SkColorType) const override;
 
@@ -59,8 +66,33 @@ private:
 
     const int                       fNumberPasses;
     int                             fBitDepth;
+    const bool                      fStreamIsInMemory;
+
+    // Built up by decodeSubset(), one every so many rows.  These describe the encoded data, so
+    // they survive rewinding.
+    struct Checkpoint;
+    SkTArray<SkAutoTDelete<Checkpoint>, true> fCheckpoints;
 
     bool createColorTable(SkColorType dstColorType, bool premultiply, int* ctableCount);
+
+    // Whether the image data needs nothing from libpng but inflating and unfiltering.
+    bool canInflateDirectly() const;
+    // If we can inflate the image data ourselves, finds the first IDAT chunk in the stream's
+    // memory, which libpng has just reached.
+    bool findImageData(const uint8_t** data, size_t* length, size_t* idatStart);
+    // Decodes the image data without libpng, inflating on a second thread, if the image is large
+    // enough and needs no transforms from libpng.  Otherwise returns kUnimplemented.
+    Result decodePipelined(const SkImageInfo& dstInfo, void* dst, size_t dstRowBytes,
+                           int* rowsDecoded);
+    // Decodes the rows of subset, without libpng, starting from the nearest checkpoint above
+    // them and adding checkpoints along the way.  The swizzler must have been set up for the
+    // subset.
+    Result decodeSubset(const SkImageInfo& dstInfo, void* dst, size_t dstRowBytes,
+                        const SkIRect& subset, int* rowsDecoded);
+    // Decodes to dstInfo's smaller dimensions, a row at a time.  The swizzler must have been
+    // set up for the full size image.
+    Result decodeScaled(const SkImageInfo& dstInfo, void* dst, size_t dstRowBytes,
+                        int* rowsDecoded);
     void destroyReadStruct();
 
     typedef SkCodec INHERITED;
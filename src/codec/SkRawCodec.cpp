@@ -535,6 +535,21 @@ public:
         return fIsXtransImage;
     }
 
+    /*
+     * Creates a codec for the JPEG thumbnail PIEX found embedded in the image, or returns nullptr
+     * if there is none. The thumbnail is copied out, so this does not disturb the stream.
+     */
+    SkCodec* newThumbnailCodec() {
+        if (0 == fThumbnailLength) {
+            return nullptr;
+        }
+        sk_sp<SkData> data(SkData::MakeUninitialized(fThumbnailLength));
+        if (!fStream->read(data->writable_data(), fThumbnailOffset, fThumbnailLength)) {
+            return nullptr;
+        }
+        return SkJpegCodec::NewFromStream(new SkMemoryStream(std::move(data)));
+    }
+
 private:
     // Quick check if the image contains a valid TIFF header as requested by DNG format.
     bool isTiffHeaderValid() const {
@@ -575,6 +590,13 @@ private:
                 return false;
             }
 
+            if (imageData.thumbnail.length > 0 &&
+                imageData.thumbnail.format == ::piex::Image::kJpegCompressed)
+            {
+                fThumbnailOffset = imageData.thumbnail.offset;
+                fThumbnailLength = imageData.thumbnail.length;
+            }
+
             dng_point cfaPatternSize(imageData.cfa_pattern_dim[1], imageData.cfa_pattern_dim[0]);
             this->init(static_cast<int>(imageData.full_width),
                        static_cast<int>(imageData.full_height), cfaPatternSize);
@@ -619,6 +641,8 @@ private:
         : fStream(stream)
         , fEncodedInfo(SkEncodedInfo::Make(SkEncodedInfo::kRGB_Color,
                                            SkEncodedInfo::kOpaque_Alpha, 8))
+        , fThumbnailOffset(0)
+        , fThumbnailLength(0)
     {}
 
     SkDngMemoryAllocator fAllocator;
@@ -633,8 +657,20 @@ private:
     SkEncodedInfo fEncodedInfo;
     bool fIsScalable;
     bool fIsXtransImage;
+    uint32_t fThumbnailOffset;
+    uint32_t fThumbnailLength;
 };
 
+// Whether a thumbnail of size thumb shows the whole image of size full, undistorted.
+static bool is_thumbnail_of(const SkISize& thumb, const SkISize& full) {
+    if (thumb.isEmpty() || thumb.width() >= full.width() || thumb.height() >= full.height()) {
+        return false;
+    }
+    const float aspectRatio = (static_cast<float>(thumb.width()) * full.height()) /
+                              (static_cast<float>(thumb.height()) * full.width());
+    return SkTAbs(aspectRatio - 1.f) < 0.02f;
+}
+
 /*
  * Tries to handle the image with PIEX. If PIEX returns kOk and finds the preview image, create a
  * SkJpegCodec. If PIEX returns kFail, then the file is invalid, return nullptr. In other cases,
@@ -676,7 +712,15 @@ SkCodec* SkRawCodec::NewFromStream(SkStream* stream) {
         return nullptr;
     }
 
-    return new SkRawCodec(dngImage.release());
+    // Thumbnail-sized decodes can use the embedded JPEG thumbnail, in milliseconds, rather than
+    // render the raw image, which can take seconds.
+    SkAutoTDelete<SkCodec> thumbnail(dngImage->newThumbnailCodec());
+    if (thumbnail && !is_thumbnail_of(thumbnail->getInfo().dimensions(),
+                                      SkISize::Make(dngImage->width(), dngImage->height()))) {
+        thumbnail.reset(nullptr);
+    }
+
+    return new SkRawCodec(dngImage.release(), thumbnail.release());
 }
 
 SkCodec::Result SkRawCodec::onGetPixels(const SkImageInfo& requestedInfo, void* dst,
@@ -688,6 +732,13 @@ SkCodec::Result SkRawCodec::onGetPixels(const SkImageInfo& requestedInfo, void*
         return kInvalidConversion;
     }
 
+    if (fThumbnailCodec && requestedInfo.dimensions() == fThumbnailCodec->getInfo().dimensions()) {
+        // The thumbnail codec fills in any rows it fails to decode itself.
+        *rowsDecoded = requestedInfo.height();
+        return fThumbnailCodec->getPixels(requestedInfo, dst, dstRowBytes, &options,
+                                          ctable, ctableCount);
+    }
+
     SkAutoTDelete<SkSwizzler> swizzler(SkSwizzler::CreateSwizzler(
             this->getEncodedInfo(), nullptr, requestedInfo, options));
     SkASSERT(swizzler);
@@ -743,6 +794,16 @@ SkISize SkRawCodec::onGetScaledDimensions(float desiredScale) const {
     const SkISize dim = this->getInfo().dimensions();
     SkASSERT(dim.fWidth != 0 && dim.fHeight != 0);
 
+    // The thumbnail is far cheaper to decode than any rendering of the raw image, so use it
+    // whenever it is at least as large as requested.
+    if (fThumbnailCodec) {
+        const SkISize thumbDim = fThumbnailCodec->getInfo().dimensions();
+        if (thumbDim.fWidth >= desiredScale * dim.fWidth &&
+            thumbDim.fHeight >= desiredScale * dim.fHeight) {
+            return thumbDim;
+        }
+    }
+
     if (!fDngImage->isScalable()) {
         return dim;
     }
@@ -766,6 +827,10 @@ SkISize SkRawCodec::onGetScaledDimensions(float desiredScale) const {
 }
 
 bool SkRawCodec::onDimensionsSupported(const SkISize& dim) {
+    if (fThumbnailCodec && dim == fThumbnailCodec->getInfo().dimensions()) {
+        return true;
+    }
+
     const SkISize fullDim = this->getInfo().dimensions();
     const float fullShortEdge = static_cast<float>(SkTMin(fullDim.fWidth, fullDim.fHeight));
     const float shortEdge = static_cast<float>(SkTMin(dim.fWidth, dim.fHeight));
@@ -777,6 +842,7 @@ bool SkRawCodec::onDimensionsSupported(const SkISize& dim) {
 
 SkRawCodec::~SkRawCodec() {}
 
-SkRawCodec::SkRawCodec(SkDngImage* dngImage)
+SkRawCodec::SkRawCodec(SkDngImage* dngImage, SkCodec* thumbnailCodec)
     : INHERITED(dngImage->width(), dngImage->height(), dngImage->getEncodedInfo(), nullptr)
-    , fDngImage(dngImage) {}
+    , fDngImage(dngImage)
+    , fThumbnailCodec(thumbnailCodec) {}
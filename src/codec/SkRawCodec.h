@@ -49,11 +49,13 @@ private:
 
     /*
      * Creates an instance of the decoder
-     * Called only by NewFromStream, takes ownership of dngImage.
+     * Called only by NewFromStream, takes ownership of dngImage and of thumbnailCodec, a codec
+     * for the image's embedded JPEG thumbnail, which may be null.
      */
-    SkRawCodec(SkDngImage* dngImage);
+    SkRawCodec(SkDngImage* dngImage, SkCodec* thumbnailCodec);
 
     SkAutoTDelete<SkDngImage> fDngImage;
+    SkAutoTDelete<SkCodec>    fThumbnailCodec;
 
     typedef SkCodec INHERITED;
 };
@@ -25,7 +25,9 @@ SkISize SkSampledCodec::accountForNativeScaling(int* sampleSizePtr, int* nativeS
         *nativeSampleSize = 1;
     }
 
-    // Only JPEG supports native downsampling.
+    // Only JPEG supports native downsampling combined with sampling.  Other codecs may downscale
+    // natively too, but only for whole images, which onGetAndroidPixels() hands straight to the
+    // codec.
     if (this->codec()->getEncodedFormat() == kJPEG_SkEncodedFormat) {
         // See if libjpeg supports this scale directly
         switch (sampleSize) {
@@ -89,6 +91,19 @@ SkCodec::Result SkSampledCodec::onGetAndroidPixels(const SkImageInfo& info, void
 
     // We are performing a subset decode.
     int sampleSize = options.fSampleSize;
+    if (1 == sampleSize) {
+        // Some codecs can decode a subset without decoding everything above it.
+        SkIRect validSubset = *subset;
+        if (this->codec()->getValidSubset(&validSubset) && validSubset == *subset) {
+            codecOptions.fSubset = subset;
+            const SkCodec::Result result = this->codec()->getPixels(info, pixels, rowBytes,
+                    &codecOptions, options.fColorPtr, options.fColorCount);
+            if (SkCodec::kUnimplemented != result) {
+                return result;
+            }
+            codecOptions.fSubset = nullptr;
+        }
+    }
     SkISize scaledSize = this->getSampledDimensions(sampleSize);
     if (!this->codec()->dimensionsSupported(scaledSize)) {
         // If the native codec does not support the requested scale, scale by sampling.
@@ -107,6 +122,10 @@ SkCodec::Result SkSampledCodec::onGetAndroidPixels(const SkImageInfo& info, void
     codecOptions.fSubset = &scanlineSubset;
     SkCodec::Result result = this->codec()->startScanlineDecode(info.makeWH(scaledSize.width(),
             scaledSize.height()), &codecOptions, options.fColorPtr, options.fColorCount);
+    if (SkCodec::kInvalidScale == result && 1 != sampleSize) {
+        // Some codecs scale natively in getPixels(), but not in their scanline decoders.
+        return this->sampledDecode(info, pixels, rowBytes, options);
+    }
     if (SkCodec::kSuccess != result) {
         return result;
     }
@@ -101,3 +101,55 @@ void SkSampler::Fill(const SkImageInfo& info, void* dst, size_t rowBytes,
             break;
     }
 }
+
+bool SkBoxSampler::IsSupported(SkColorType colorType) {
+    switch (colorType) {
+        case kRGBA_8888_SkColorType:
+        case kBGRA_8888_SkColorType:
+        case kGray_8_SkColorType:
+            return true;
+        default:
+            return false;
+    }
+}
+
+SkBoxSampler::SkBoxSampler(SkColorType colorType, int dstWidth, int sampleX, int sampleY)
+    : fDstWidth(dstWidth)
+    , fSampleX(sampleX)
+    , fSampleY(sampleY)
+    , fChannels(kGray_8_SkColorType == colorType ? 1 : 4)
+    , fRows(0)
+    , fSums(dstWidth * fChannels)
+{
+    SkASSERT(IsSupported(colorType));
+    SkASSERT(dstWidth > 0 && sampleX > 0 && sampleY > 0);
+    sk_bzero(fSums.get(), dstWidth * fChannels * sizeof(uint64_t));
+}
+
+bool SkBoxSampler::accumulate(const void* srcRow, void* dst) {
+    // Channels are averaged independently, so RGBA and BGRA need no special handling.
+    const uint8_t* src = (const uint8_t*) srcRow;
+    uint64_t* sums = fSums.get();
+    for (int x = 0; x < fDstWidth; x++) {
+        for (int i = 0; i < fSampleX; i++) {
+            for (int c = 0; c < fChannels; c++) {
+                sums[c] += *src++;
+            }
+        }
+        sums += fChannels;
+    }
+
+    if (++fRows < fSampleY) {
+        return false;
+    }
+
+    const uint64_t count = (uint64_t) fSampleX * fSampleY;
+    uint8_t* dstRow = (uint8_t*) dst;
+    sums = fSums.get();
+    for (int i = 0; i < fDstWidth * fChannels; i++) {
+        dstRow[i] = (uint8_t) ((sums[i] + count / 2) / count);
+        sums[i] = 0;
+    }
+    fRows = 0;
+    return true;
+}
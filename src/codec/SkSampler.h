@@ -8,6 +8,7 @@
 #define SkSampler_DEFINED
 
 #include "SkCodec.h"
+#include "SkTemplates.h"
 #include "SkTypes.h"
 
 class SkSampler : public SkNoncopyable {
@@ -60,4 +61,38 @@ private:
     virtual int onSetSampleX(int) = 0;
 };
 
+/**
+ *  Downscales rows by whole factors, averaging each sampleX by sampleY box of source pixels into
+ *  one destination pixel.  Rows are summed as they are decoded, so this only keeps one row of
+ *  sums the width of the destination, not a full size image.
+ */
+class SkBoxSampler : public SkNoncopyable {
+public:
+    /**
+     *  Returns true for the color types whose pixels we can average: kRGBA_8888,
+     *  kBGRA_8888, and kGray_8.  Others must be point sampled.
+     */
+    static bool IsSupported(SkColorType);
+
+    /**
+     *  @param dstWidth Width of the destination rows.  Source rows are at least
+     *                  dstWidth * sampleX pixels wide.  Any pixels past that are ignored.
+     */
+    SkBoxSampler(SkColorType, int dstWidth, int sampleX, int sampleY);
+
+    /**
+     *  Adds a full width source row.  After every sampleY'th row, writes out the averages to
+     *  dst and returns true.  Otherwise dst is left alone and this returns false.
+     */
+    bool accumulate(const void* srcRow, void* dst);
+
+private:
+    const int                   fDstWidth;
+    const int                   fSampleX;
+    const int                   fSampleY;
+    const int                   fChannels;
+    int                         fRows;      // Rows summed since we last wrote out a row.
+    SkAutoTMalloc<uint64_t>     fSums;     // Wide enough for any box, even a whole image.
+};
+
 #endif // SkSampler_DEFINED
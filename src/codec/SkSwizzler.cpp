@@ -7,6 +7,7 @@
 
 #include "SkCodecPriv.h"
 #include "SkColorPriv.h"
+#include "SkColorSpaceXform.h"
 #include "SkOpts.h"
 #include "SkSwizzler.h"
 #include "SkTemplates.h"
@@ -245,6 +246,17 @@ static void swizzle_index_to_n32_skipZ(
     }
 }
 
+static void fast_swizzle_index_to_n32(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::index8_to_8888((uint32_t*) dst, src + offset, width, ctable);
+}
+
 static void swizzle_index_to_565(
       void* SK_RESTRICT dstRow, const uint8_t* SK_RESTRICT src, int dstWidth,
       int bytesPerPixel, int deltaSrc, int offset, const SkPMColor ctable[]) {
@@ -786,6 +798,7 @@ SkSwizzler* SkSwizzler::CreateSwizzler(const SkEncodedInfo& encodedInfo,
                                     proc = &swizzle_index_to_n32_skipZ;
                                 } else {
                                     proc = &swizzle_index_to_n32;
+                                    fastProc = &fast_swizzle_index_to_n32;
                                 }
                                 break;
                             case kRGB_565_SkColorType:
@@ -1004,6 +1017,7 @@ SkSwizzler::SkSwizzler(RowProc fastProc, RowProc proc, const SkPMColor* ctable,
     , fSlowProc(proc)
     , fActualProc(fFastProc ? fFastProc : fSlowProc)
     , fColorTable(ctable)
+    , fColorXform(nullptr)
     , fSrcOffset(srcOffset)
     , fDstOffset(dstOffset)
     , fSrcOffsetUnits(srcOffset * srcBPP)
@@ -1040,6 +1054,10 @@ int SkSwizzler::onSetSampleX(int sampleX) {
 
 void SkSwizzler::swizzle(void* dst, const uint8_t* SK_RESTRICT src) {
     SkASSERT(nullptr != dst && nullptr != src);
-    fActualProc(SkTAddOffset<void>(dst, fDstOffsetBytes), src, fSwizzleWidth, fSrcBPP,
-            fSampleX * fSrcBPP, fSrcOffsetUnits, fColorTable);
+    uint32_t* row = SkTAddOffset<uint32_t>(dst, fDstOffsetBytes);
+    fActualProc(row, src, fSwizzleWidth, fSrcBPP, fSampleX * fSrcBPP, fSrcOffsetUnits,
+            fColorTable);
+    if (fColorXform) {
+        fColorXform->xform_RGB1_8888(row, row, fSwizzleWidth);
+    }
 }
@@ -13,6 +13,8 @@
 #include "SkImageInfo.h"
 #include "SkSampler.h"
 
+class SkColorSpaceXform;
+
 class SkSwizzler : public SkSampler {
 public:
     /**
@@ -53,6 +55,14 @@ public:
      */
     void swizzle(void* dst, const uint8_t* SK_RESTRICT src);
 
+    /**
+     *  Convert each row to another color space right after swizzling it, while it is
+     *  still in cache.  The swizzler must have been created to write kRGBA_8888; the
+     *  conversion then leaves opaque kN32 pixels in place.
+     *  @param xform Unowned, or nullptr to stop converting.
+     */
+    void setColorXform(const SkColorSpaceXform* xform) { fColorXform = xform; }
+
     /**
      * Implement fill using a custom width.
      */
@@ -110,6 +120,7 @@ private:
     RowProc             fActualProc;
 
     const SkPMColor*    fColorTable;      // Unowned pointer
+    const SkColorSpaceXform* fColorXform; // Unowned pointer, may be NULL
 
     // Subset Swizzles
     // There are two types of subset swizzles that we support.  We do not
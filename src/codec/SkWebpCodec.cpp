@@ -248,7 +248,75 @@ SkCodec::Result SkWebpCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst,
     config.output.u.RGBA.size = dstInfo.getSafeSize(rowBytes);
     config.output.is_external_memory = 1;
 
-    SkAutoTCallVProc<WebPIDecoder, WebPIDelete> idec(WebPIDecode(nullptr, 0, &config));
+    return this->decodeStream(&config, rowsDecoded);
+}
+
+bool SkWebpCodec::onQueryYUV8(SkYUVSizeInfo* sizeInfo, SkYUVColorSpace* colorSpace) const {
+    // Lossless images are RGB, and libwebp would have to convert the ones with alpha for us.
+    if (SkEncodedInfo::kYUV_Color != this->getEncodedInfo().color()) {
+        return false;
+    }
+
+    // U and V are subsampled 2x in each direction, rounding up.
+    const int width = this->getInfo().width();
+    const int height = this->getInfo().height();
+    sizeInfo->fSizes[SkYUVSizeInfo::kY].set(width, height);
+    sizeInfo->fSizes[SkYUVSizeInfo::kU].set((width + 1) / 2, (height + 1) / 2);
+    sizeInfo->fSizes[SkYUVSizeInfo::kV].set((width + 1) / 2, (height + 1) / 2);
+    for (int i = 0; i < 3; i++) {
+        sizeInfo->fWidthBytes[i] = SkAlign8(sizeInfo->fSizes[i].width());
+    }
+
+    if (colorSpace) {
+        // VP8 uses Rec. 601 with studio swing.
+        *colorSpace = kRec601_SkYUVColorSpace;
+    }
+
+    return true;
+}
+
+SkCodec::Result SkWebpCodec::onGetYUV8Planes(const SkYUVSizeInfo& sizeInfo, void* planes[3]) {
+    SkYUVSizeInfo defaultInfo;
+    if (!this->onQueryYUV8(&defaultInfo, nullptr)) {
+        return kInvalidInput;
+    }
+    for (int i = 0; i < 3; i++) {
+        if (sizeInfo.fSizes[i] != defaultInfo.fSizes[i] ||
+                sizeInfo.fWidthBytes[i] < defaultInfo.fWidthBytes[i]) {
+            return kInvalidInput;
+        }
+    }
+
+    WebPDecoderConfig config;
+    if (0 == WebPInitDecoderConfig(&config)) {
+        // ABI mismatch.
+        return kInvalidInput;
+    }
+
+    // Free any memory associated with the buffer. Must be called last, so we declare it first.
+    SkAutoTCallVProc<WebPDecBuffer, WebPFreeDecBuffer> autoFree(&(config.output));
+
+    auto plane_size = [&](int i) {
+        return sizeInfo.fWidthBytes[i] * sizeInfo.fSizes[i].height();
+    };
+    WebPYUVABuffer* yuv = &config.output.u.YUVA;
+    config.output.colorspace = MODE_YUV;
+    yuv->y = (uint8_t*) planes[SkYUVSizeInfo::kY];
+    yuv->u = (uint8_t*) planes[SkYUVSizeInfo::kU];
+    yuv->v = (uint8_t*) planes[SkYUVSizeInfo::kV];
+    yuv->y_stride = (int) sizeInfo.fWidthBytes[SkYUVSizeInfo::kY];
+    yuv->u_stride = (int) sizeInfo.fWidthBytes[SkYUVSizeInfo::kU];
+    yuv->v_stride = (int) sizeInfo.fWidthBytes[SkYUVSizeInfo::kV];
+    yuv->y_size = plane_size(SkYUVSizeInfo::kY);
+    yuv->u_size = plane_size(SkYUVSizeInfo::kU);
+    yuv->v_size = plane_size(SkYUVSizeInfo::kV);
+    config.output.is_external_memory = 1;
+
+    return this->decodeStream(&config, nullptr);
+}
+
+SkCodec::Result SkWebpCodec::decodeStream(WebPDecoderConfig* config, int* rowsDecoded) {
+    SkAutoTCallVProc<WebPIDecoder, WebPIDelete> idec(WebPIDecode(nullptr, 0, config));
     if (!idec) {
         return kInvalidInput;
     }
@@ -258,7 +326,9 @@ SkCodec::Result SkWebpCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst,
     while (true) {
         const size_t bytesRead = stream()->read(buffer, BUFFER_SIZE);
         if (0 == bytesRead) {
-            WebPIDecGetRGB(idec, rowsDecoded, NULL, NULL, NULL);
+            if (rowsDecoded) {
+                WebPIDecGetRGB(idec, rowsDecoded, NULL, NULL, NULL);
+            }
             return kIncompleteInput;
         }
 
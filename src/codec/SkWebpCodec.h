@@ -15,6 +15,7 @@
 #include "SkTypes.h"
 
 class SkStream;
+struct WebPDecoderConfig;
 
 static const size_t WEBP_VP8_HEADER_SIZE = 30;
 
@@ -33,9 +34,18 @@ protected:
     bool onDimensionsSupported(const SkISize&) override;
 
     bool onGetValidSubset(SkIRect* /* desiredSubset */) const override;
+
+    // Lossy images without alpha are YUV 4:2:0, and we can hand back the planes as they are.
+    bool onQueryYUV8(SkYUVSizeInfo*, SkYUVColorSpace*) const override;
+
+    Result onGetYUV8Planes(const SkYUVSizeInfo&, void* planes[3]) override;
 private:
     SkWebpCodec(int width, int height, const SkEncodedInfo&, SkStream*);
 
+    // Feeds the stream to libwebp, which decodes into config's output buffer.  If the stream
+    // runs out first, returns kIncompleteInput and, if rowsDecoded is not null, sets it.
+    Result decodeStream(WebPDecoderConfig* config, int* rowsDecoded);
+
     typedef SkCodec INHERITED;
 };
 #endif // SkWebpCodec_DEFINED
@@ -10,6 +10,8 @@
 #include "SkBlitter.h"
 #include "SkColorPriv.h"
 #include "SkPath.h"
+#include "SkRRect.h"
+#include "SkResourceCache.h"
 #include "SkScan.h"
 #include "SkUtils.h"
 
@@ -1407,6 +1409,88 @@ bool SkAAClip::setPath(const SkPath& path, const SkRegion* clip, bool doAA) {
     return builder.finish(this);
 }
 
+SkAAClip::PathID::PathID(const SkPath& src, const SkMatrix& matrix)
+    : fGenID(src.getGenerationID())
+    , fFillType(src.getFillType())
+{
+    matrix.get9(fData);
+    fData[9] = fData[10] = fData[11] = 0;
+}
+
+SkAAClip::PathID::PathID(const SkRRect& devRRect)
+    : fGenID(0)
+    , fFillType(SkPath::kWinding_FillType)
+{
+    static_assert(sizeof(fData) == SkRRect::kSizeInMemory, "rrect_does_not_fit");
+    devRRect.writeToMemory(fData);
+}
+
+namespace {
+static unsigned gAAClipKeyNamespaceLabel;
+
+struct AAClipKey : public SkResourceCache::Key {
+public:
+    AAClipKey(const SkAAClip::PathID& id, const SkIRect& clip, bool doAA)
+        : fID(id)
+        , fClip(clip)
+        , fDoAA(doAA)
+    {
+        this->init(&gAAClipKeyNamespaceLabel, 0,
+                   sizeof(fID) + sizeof(fClip) + sizeof(fDoAA));
+        SkASSERT((char*)&fEndOfStruct - (char*)&fID ==
+                 sizeof(fID) + sizeof(fClip) + sizeof(fDoAA));
+    }
+
+    SkAAClip::PathID fID;
+    SkIRect          fClip;
+    uint32_t         fDoAA;
+
+    SkDEBUGCODE(uint32_t fEndOfStruct;)
+};
+
+struct AAClipRec : public SkResourceCache::Rec {
+    AAClipRec(const AAClipKey& key, const SkAAClip& clip, size_t bytes)
+        : fKey(key)
+        , fClip(clip)
+        , fBytes(bytes)
+    {}
+
+    AAClipKey fKey;
+    SkAAClip  fClip;    // shares its runs with the clip we were built from
+    size_t    fBytes;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fBytes; }
+    const char* getCategory() const override { return "aaclip"; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const AAClipRec& rec = static_cast<const AAClipRec&>(baseRec);
+        *(SkAAClip*)contextData = rec.fClip;
+        return true;
+    }
+};
+} // namespace
+
+bool SkAAClip::setPath(const SkPath& path, const SkRegion* clip, bool doAA, const PathID& id) {
+    // Only a rect clip is fully described by the key.
+    if (!clip || !clip->isRect()) {
+        return this->setPath(path, clip, doAA);
+    }
+
+    AAClipKey key(id, clip->getBounds(), doAA);
+    if (SkResourceCache::Find(key, AAClipRec::Visitor, this)) {
+        return !this->isEmpty();
+    }
+
+    bool nonEmpty = this->setPath(path, clip, doAA);
+    size_t bytes = 0;
+    if (fRunHead) {
+        bytes = sizeof(RunHead) + fRunHead->fRowCount * sizeof(YOffset) + fRunHead->fDataSize;
+    }
+    SkResourceCache::Add(new AAClipRec(key, *this, bytes));
+    return nonEmpty;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 typedef void (*RowProc)(SkAAClip::Builder&, int bottom,
@@ -11,6 +11,13 @@
 #include "SkBlitter.h"
 #include "SkRegion.h"
 
+class SkMatrix;
+class SkRRect;
+
+/**
+ *  Copies of an SkAAClip share its runs, which are never changed once they are built, so
+ *  copying (e.g. on save and restore) is cheap.
+ */
 class SkAAClip {
 public:
     SkAAClip();
@@ -37,6 +44,27 @@ public:
     bool setRect(const SkRect&, bool doAA = true);
     bool setPath(const SkPath&, const SkRegion* clip = nullptr, bool doAA = true);
     bool setRegion(const SkRegion&);
+
+    /**
+     *  Identifies a device-space path by what it was made from, so that the clips built from
+     *  it can be shared through SkResourceCache: either a path's generation ID and the matrix
+     *  that maps it to device space, or a device-space rrect.
+     */
+    struct PathID {
+        PathID(const SkPath& src, const SkMatrix& matrix);
+        explicit PathID(const SkRRect& devRRect);
+
+        uint32_t fGenID;        // 0 for an rrect
+        uint32_t fFillType;
+        SkScalar fData[12];     // the matrix, or the rrect's rect and radii
+    };
+
+    /**
+     *  Same as setPath(), but if clip is a rect, first looks in SkResourceCache for a clip built
+     *  from the same path, and adds this one there if there isn't one. The path must be the one
+     *  that id describes.
+     */
+    bool setPath(const SkPath&, const SkRegion* clip, bool doAA, const PathID& id);
     bool set(const SkAAClip&);
 
     bool op(const SkAAClip&, const SkAAClip&, SkRegion::Op);
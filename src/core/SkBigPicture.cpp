@@ -60,6 +60,22 @@ const SkBigPicture::Analysis& SkBigPicture::analysis() const {
     return fAnalysis;
 }
 
+SkPictureCost SkBigPicture::cost() const {
+    fCostOnce([this] {
+        TRACE_EVENT0("disabled-by-default-skia", "SkBigPicture::cost()");
+        SkAutoTMalloc<SkRect> bounds(fRecord->count());
+        SkRecordFillBounds(fCullRect, *fRecord, bounds);
+
+        SkPictureCostCounter counter(this->drawablePicts(), this->drawableCount());
+        for (int i = 0; i < fRecord->count(); i++) {
+            counter.setBounds(bounds[i]);
+            fRecord->visit(i, counter);
+        }
+        fCost = counter.fCost;
+    });
+    return fCost;
+}
+
 SkRect SkBigPicture::cullRect()            const { return fCullRect; }
 bool   SkBigPicture::willPlayBackBitmaps() const { return this->analysis().fWillPlaybackBitmaps; }
 int    SkBigPicture::numSlowPaths() const { return this->analysis().fNumSlowPathsAndDashEffects; }
@@ -10,6 +10,7 @@
 
 #include "SkOnce.h"
 #include "SkPicture.h"
+#include "SkPictureCommon.h"
 #include "SkRect.h"
 #include "SkTemplates.h"
 
@@ -68,6 +69,7 @@ private:
     };
 
     int numSlowPaths() const override;
+    SkPictureCost cost() const override;
     const Analysis& analysis() const;
     int drawableCount() const;
     SkPicture const* const* drawablePicts() const;
@@ -76,6 +78,9 @@ private:
     const size_t                          fApproxBytesUsedBySubPictures;
     mutable SkOnce                        fAnalysisOnce;
     mutable Analysis                      fAnalysis;
+    // Costing needs each op's bounds, so it's kept apart from the cheaper Analysis.
+    mutable SkOnce                        fCostOnce;
+    mutable SkPictureCost                 fCost;
     SkAutoTUnref<const SkRecord>          fRecord;
     SkAutoTDelete<const SnapshotArray>    fDrawablePicts;
     SkAutoTUnref<const SkBBoxHierarchy>   fBBH;
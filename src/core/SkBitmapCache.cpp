@@ -301,6 +301,8 @@ static SkResourceCache::DiscardableFactory get_fact(SkResourceCache* localCache)
 
 const SkMipMap* SkMipMapCache::AddAndRef(const SkBitmap& src, SkSourceGammaTreatment treatment,
                                          SkResourceCache* localCache) {
+    // Every level is built now.  An on-demand mipmap would hold a ref on src's pixels that the
+    // cache's byte count doesn't see.
     SkMipMap* mipmap = SkMipMap::Build(src, treatment, get_fact(localCache));
     if (mipmap) {
         MipMapRec* rec = new MipMapRec(src, treatment, mipmap);
@@ -9,6 +9,7 @@
 #include "SkConfig8888.h"
 #include "SkDraw.h"
 #include "SkImageFilterCache.h"
+#include "SkLayerPixelPool.h"
 #include "SkMallocPixelRef.h"
 #include "SkMatrix.h"
 #include "SkPaint.h"
@@ -131,6 +132,18 @@ void SkBitmapDevice::replaceBitmapBackendForRasterSurface(const SkBitmap& bm) {
 
 SkBaseDevice* SkBitmapDevice::onCreateDevice(const CreateInfo& cinfo, const SkPaint*) {
     const SkSurfaceProps surfaceProps(this->surfaceProps().flags(), cinfo.fPixelGeometry);
+
+    // Layers are made and thrown away with every saveLayer()/restore(), so we take their pixels
+    // from SkLayerPixelPool, which recycles them, rather than from a fresh allocation each time.
+    SkAlphaType newAT = cinfo.fInfo.alphaType();
+    if (valid_for_bitmap_device(cinfo.fInfo, &newAT) &&
+        kUnknown_SkColorType != cinfo.fInfo.colorType()) {
+        const SkImageInfo info = cinfo.fInfo.makeAlphaType(newAT);
+        SkBitmap bitmap;
+        if (SkLayerPixelPool::AllocPixels(info, !info.isOpaque(), &bitmap)) {
+            return new SkBitmapDevice(bitmap, surfaceProps);
+        }
+    }
     return SkBitmapDevice::Create(cinfo.fInfo, surfaceProps);
 }
 
@@ -205,6 +205,10 @@ void ClampX_ClampY_filter_affine(const SkBitmapProcState& s,
                                  uint32_t xy[], int count, int x, int y);
 void ClampX_ClampY_nofilter_affine(const SkBitmapProcState& s,
                                    uint32_t xy[], int count, int x, int y);
+void ClampX_ClampY_filter_persp(const SkBitmapProcState& s,
+                                uint32_t xy[], int count, int x, int y);
+void ClampX_ClampY_nofilter_persp(const SkBitmapProcState& s,
+                                  uint32_t xy[], int count, int x, int y);
 
 // Helper class for mapping the middle of pixel (x, y) into SkFractionalInt bitmap space.
 // Discussion:
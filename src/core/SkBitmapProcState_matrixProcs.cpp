@@ -83,6 +83,10 @@ void ClampX_ClampY_nofilter_affine(const SkBitmapProcState& s, uint32_t xy[],
                                   int count, int x, int y) {
     return NoFilterProc_Affine<ClampTileProcs>(s, xy, count, x, y);
 }
+void ClampX_ClampY_nofilter_persp(const SkBitmapProcState& s, uint32_t xy[],
+                                  int count, int x, int y) {
+    return NoFilterProc_Persp<ClampTileProcs>(s, xy, count, x, y);
+}
 
 static SkBitmapProcState::MatrixProc ClampX_ClampY_Procs[] = {
     // only clamp lives in the right coord space to check for decal
@@ -90,7 +94,7 @@ static SkBitmapProcState::MatrixProc ClampX_ClampY_Procs[] = {
     ClampX_ClampY_filter_scale,
     ClampX_ClampY_nofilter_affine,
     ClampX_ClampY_filter_affine,
-    NoFilterProc_Persp<ClampTileProcs>,
+    ClampX_ClampY_nofilter_persp,
     ClampX_ClampY_filter_persp
 };
 
@@ -9,15 +9,18 @@
 #include "SkBitmapFilter.h"
 #include "SkConvolver.h"
 #include "SkImageInfo.h"
+#include "SkMutex.h"
 #include "SkPixmap.h"
 #include "SkRect.h"
+#include "SkRefCnt.h"
 #include "SkTArray.h"
+#include "SkTaskGroup.h"
 
 // SkResizeFilter ----------------------------------------------------------------
 
 // Encapsulates computation and storage of the filters required for one complete
-// resize operation.
-class SkResizeFilter {
+// resize operation.  Once built they're never modified, so they may be shared.
+class SkResizeFilter : public SkNVRefCnt<SkResizeFilter> {
 public:
     SkResizeFilter(SkBitmapScaler::ResizeMethod method,
                    int srcFullWidth, int srcFullHeight,
@@ -27,8 +30,8 @@ public:
     ~SkResizeFilter() { delete fBitmapFilter; }
 
     // Returns the filled filter values.
-    const SkConvolutionFilter1D& xFilter() { return fXFilter; }
-    const SkConvolutionFilter1D& yFilter() { return fYFilter; }
+    const SkConvolutionFilter1D& xFilter() const { return fXFilter; }
+    const SkConvolutionFilter1D& yFilter() const { return fYFilter; }
 
 private:
 
@@ -208,6 +211,77 @@ void SkResizeFilter::computeFilters(int srcSize,
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Thumbnailing resizes many images between the same few sizes, so we keep the most recently used
+// filters rather than recompute their weights for every image.
+namespace {
+
+struct ResizeFilterKey {
+    SkBitmapScaler::ResizeMethod fMethod;
+    int fSrcWidth, fSrcHeight;
+    int fDstWidth, fDstHeight;
+
+    bool operator==(const ResizeFilterKey& that) const {
+        return fMethod == that.fMethod &&
+               fSrcWidth == that.fSrcWidth && fSrcHeight == that.fSrcHeight &&
+               fDstWidth == that.fDstWidth && fDstHeight == that.fDstHeight;
+    }
+};
+
+struct CachedResizeFilter {
+    ResizeFilterKey        fKey;
+    sk_sp<SkResizeFilter>  fFilter;
+};
+
+}  // namespace
+
+SK_DECLARE_STATIC_MUTEX(gResizeFilterCacheMutex);
+static const int kResizeFilterCacheCount = 16;
+static CachedResizeFilter* gResizeFilterCache;  // most recently used first
+static int gResizeFilterCacheUsed;
+
+static sk_sp<SkResizeFilter> find_or_make_filter(const ResizeFilterKey& key,
+                                                 const SkConvolutionProcs& convolveProcs) {
+    {
+        SkAutoMutexAcquire lock(gResizeFilterCacheMutex);
+        for (int i = 0; i < gResizeFilterCacheUsed; i++) {
+            if (gResizeFilterCache[i].fKey == key) {
+                CachedResizeFilter hit = std::move(gResizeFilterCache[i]);
+                for (int j = i; j > 0; j--) {
+                    gResizeFilterCache[j] = std::move(gResizeFilterCache[j - 1]);
+                }
+                gResizeFilterCache[0] = std::move(hit);
+                return gResizeFilterCache[0].fFilter;
+            }
+        }
+    }
+
+    // Computing the weights can take a while, so we don't hold the lock for it.  If two threads
+    // race to make the same filter, the cache ends up with both, which is harmless.
+    sk_sp<SkResizeFilter> filter(new SkResizeFilter(key.fMethod, key.fSrcWidth, key.fSrcHeight,
+                                                    key.fDstWidth, key.fDstHeight,
+                                                    SkRect::MakeIWH(key.fDstWidth,
+                                                                    key.fDstHeight),
+                                                    convolveProcs));
+
+    SkAutoMutexAcquire lock(gResizeFilterCacheMutex);
+    if (nullptr == gResizeFilterCache) {
+        gResizeFilterCache = new CachedResizeFilter[kResizeFilterCacheCount];
+    }
+    gResizeFilterCacheUsed = SkTMin(gResizeFilterCacheUsed + 1, kResizeFilterCacheCount);
+    for (int j = gResizeFilterCacheUsed - 1; j > 0; j--) {
+        gResizeFilterCache[j] = std::move(gResizeFilterCache[j - 1]);
+    }
+    gResizeFilterCache[0].fKey = key;
+    gResizeFilterCache[0].fFilter = filter;
+    return filter;
+}
+
+// Outputs at least this big are convolved in parallel bands of at least kMinRowsPerBand rows.
+// Each band convolves the few source rows its vertical filters share with its neighbors' again.
+static const int kMinParallelPixels = 512 * 512;
+static const int kMinRowsPerBand    = 64;
+static const int kPixelsPerBand     = 256 * 256;
+
 static bool valid_for_resize(const SkPixmap& source, int dstW, int dstH) {
     // TODO: Seems like we shouldn't care about the swizzle of source, just that it's 8888
     return source.addr() && source.colorType() == kN32_SkColorType &&
@@ -225,21 +299,42 @@ bool SkBitmapScaler::Resize(const SkPixmap& result, const SkPixmap& source, Resi
     SkConvolutionProcs convolveProcs= { 0, nullptr, nullptr, nullptr, nullptr };
     PlatformConvolutionProcs(&convolveProcs);
 
-    SkRect destSubset = SkRect::MakeIWH(result.width(), result.height());
-
-    SkResizeFilter filter(method, source.width(), source.height(),
-                          result.width(), result.height(), destSubset, convolveProcs);
+    const ResizeFilterKey key = { method, source.width(), source.height(),
+                                  result.width(), result.height() };
+    sk_sp<SkResizeFilter> filter = find_or_make_filter(key, convolveProcs);
 
     // Get a subset encompassing this touched area. We construct the
     // offsets and row strides such that it looks like a new bitmap, while
     // referring to the old data.
     const uint8_t* sourceSubset = reinterpret_cast<const uint8_t*>(source.addr());
 
-    return BGRAConvolve2D(sourceSubset, static_cast<int>(source.rowBytes()),
-                          !source.isOpaque(), filter.xFilter(), filter.yFilter(),
-                          static_cast<int>(result.rowBytes()),
-                          static_cast<unsigned char*>(result.writable_addr()),
-                          convolveProcs, true);
+    auto convolve_rows = [&](int top, int bottom) {
+        return BGRAConvolve2DRows(sourceSubset, static_cast<int>(source.rowBytes()),
+                                  !source.isOpaque(), filter->xFilter(), filter->yFilter(),
+                                  static_cast<int>(result.rowBytes()),
+                                  static_cast<unsigned char*>(result.writable_addr()),
+                                  convolveProcs, true, top, bottom);
+    };
+
+    const int height = result.height();
+    const int64_t pixels = sk_64_mul(result.width(), height);
+    const int bands = pixels < kMinParallelPixels
+            ? 1
+            : (int)SkTMin<int64_t>(height / kMinRowsPerBand, pixels / kPixelsPerBand);
+    if (bands <= 1) {
+        return convolve_rows(0, height);
+    }
+
+    SkAutoTMalloc<bool> succeeded(bands);
+    SkTaskGroup().batch(bands, [&](int i) {
+        succeeded[i] = convolve_rows(i * height / bands, (i + 1) * height / bands);
+    });
+    for (int i = 0; i < bands; i++) {
+        if (!succeeded[i]) {
+            return false;
+        }
+    }
+    return true;
 }
 
 bool SkBitmapScaler::Resize(SkBitmap* resultPtr, const SkPixmap& source, ResizeMethod method,
@@ -145,31 +145,6 @@ bool SkCanvas::Internal_Private_GetTreatSpriteAsBitmap() {
 
 typedef SkTLazy<SkPaint> SkLazyPaint;
 
-void SkCanvas::predrawNotify(bool willOverwritesEntireSurface) {
-    if (fSurfaceBase) {
-        fSurfaceBase->aboutToDraw(willOverwritesEntireSurface
-                                  ? SkSurface::kDiscard_ContentChangeMode
-                                  : SkSurface::kRetain_ContentChangeMode);
-    }
-}
-
-void SkCanvas::predrawNotify(const SkRect* rect, const SkPaint* paint,
-                             ShaderOverrideOpacity overrideOpacity) {
-    if (fSurfaceBase) {
-        SkSurface::ContentChangeMode mode = SkSurface::kRetain_ContentChangeMode;
-        // Since willOverwriteAllPixels() may not be complete free to call, we only do so if
-        // there is an outstanding snapshot, since w/o that, there will be no copy-on-write
-        // and therefore we don't care which mode we're in.
-        //
-        if (fSurfaceBase->outstandingImageSnapshot()) {
-            if (this->wouldOverwriteEntireSurface(rect, paint, overrideOpacity)) {
-                mode = SkSurface::kDiscard_ContentChangeMode;
-            }
-        }
-        fSurfaceBase->aboutToDraw(mode);
-    }
-}
-
 ///////////////////////////////////////////////////////////////////////////////
 
 static uint32_t filter_paint_flags(const SkSurfaceProps& props, uint32_t flags) {
@@ -334,6 +309,33 @@ public:
     }
 };
 
+// Draws never reach past the clip, so its bounds are where the surface's pixels may change.
+void SkCanvas::predrawNotify(bool willOverwritesEntireSurface) {
+    if (fSurfaceBase) {
+        fSurfaceBase->aboutToDraw(willOverwritesEntireSurface
+                                  ? SkSurface::kDiscard_ContentChangeMode
+                                  : SkSurface::kRetain_ContentChangeMode,
+                                  &fMCRec->fRasterClip.getBounds());
+    }
+}
+
+void SkCanvas::predrawNotify(const SkRect* rect, const SkPaint* paint,
+                             ShaderOverrideOpacity overrideOpacity) {
+    if (fSurfaceBase) {
+        SkSurface::ContentChangeMode mode = SkSurface::kRetain_ContentChangeMode;
+        // Since willOverwriteAllPixels() may not be complete free to call, we only do so if
+        // there is an outstanding snapshot, since w/o that, there will be no copy-on-write
+        // and therefore we don't care which mode we're in.
+        //
+        if (fSurfaceBase->outstandingImageSnapshot()) {
+            if (this->wouldOverwriteEntireSurface(rect, paint, overrideOpacity)) {
+                mode = SkSurface::kDiscard_ContentChangeMode;
+            }
+        }
+        fSurfaceBase->aboutToDraw(mode, &fMCRec->fRasterClip.getBounds());
+    }
+}
+
 class SkDrawIter : public SkDraw {
 public:
     SkDrawIter(SkCanvas* canvas, bool skipEmptyClips = true) {
@@ -966,9 +968,14 @@ bool SkCanvas::writePixels(const SkImageInfo& origInfo, const void* pixels, size
     // here x,y are either 0 or negative
     pixels = ((const char*)pixels - y * rowBytes - x * info.bytesPerPixel());
 
-    // Tell our owning surface to bump its generation ID
-    const bool completeOverwrite = info.dimensions() == size;
-    this->predrawNotify(completeOverwrite);
+    // Tell our owning surface to bump its generation ID.  We write past the clip, so we tell it
+    // exactly where rather than going through predrawNotify().
+    if (fSurfaceBase) {
+        const bool completeOverwrite = info.dimensions() == size;
+        fSurfaceBase->aboutToDraw(completeOverwrite ? SkSurface::kDiscard_ContentChangeMode
+                                                    : SkSurface::kRetain_ContentChangeMode,
+                                  &target);
+    }
 
     // The device can assert that the requested area is always contained in its bounds
     return device->writePixels(info, pixels, rowBytes, target.x(), target.y());
@@ -1434,6 +1441,10 @@ bool SkCanvas::onPeekPixels(SkPixmap* pmap) {
 }
 
 void* SkCanvas::accessTopLayerPixels(SkImageInfo* info, size_t* rowBytes, SkIPoint* origin) {
+    if (fSurfaceBase && this->getTopDevice() == this->getDevice()) {
+        // The caller may write to any of the surface's pixels.
+        fSurfaceBase->aboutToDraw(SkSurface::kRetain_ContentChangeMode);
+    }
     SkPixmap pmap;
     if (!this->onAccessTopLayerPixels(&pmap)) {
         return nullptr;
@@ -1733,6 +1744,13 @@ void SkCanvas::onClipPath(const SkPath& path, SkRegion::Op op, ClipEdgeStyle edg
     SkPath devPath;
     path.transform(fMCRec->fMatrix, &devPath);
 
+    // Lets the raster clip share the mask it builds from a path that is clipped to over and
+    // over again (e.g. on every frame) with the same matrix.
+    SkTLazy<SkAAClip::PathID> id;
+    if (!path.isVolatile()) {
+        id.init(path, fMCRec->fMatrix);
+    }
+
     // Check if the transfomation, or the original path itself
     // made us empty. Note this can also happen if we contained NaN
     // values. computing the bounds detects this, and will set our
@@ -1741,6 +1759,7 @@ void SkCanvas::onClipPath(const SkPath& path, SkRegion::Op op, ClipEdgeStyle edg
         // resetting the path will remove any NaN or other wanky values
         // that might upset our scan converter.
         devPath.reset();
+        id.reset();
     }
 
     // if we called path.swap() we could avoid a deep copy of this path
@@ -1753,9 +1772,10 @@ void SkCanvas::onClipPath(const SkPath& path, SkRegion::Op op, ClipEdgeStyle edg
         }
 
         op = SkRegion::kReplace_Op;
+        id.reset();
     }
 
-    fMCRec->fRasterClip.op(devPath, this->getTopLayerBounds(), op, edgeStyle);
+    fMCRec->fRasterClip.op(devPath, this->getTopLayerBounds(), op, edgeStyle, id.getMaybeNull());
 }
 
 void SkCanvas::clipRegion(const SkRegion& rgn, SkRegion::Op op) {
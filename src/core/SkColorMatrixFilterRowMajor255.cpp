@@ -9,6 +9,7 @@
 #include "SkColorPriv.h"
 #include "SkNx.h"
 #include "SkPM4fPriv.h"
+#include "SkRasterPipeline.h"
 #include "SkReadBuffer.h"
 #include "SkRefCnt.h"
 #include "SkString.h"
@@ -31,6 +32,10 @@ static void transpose(float dst[20], const float src[20]) {
 
 void SkColorMatrixFilterRowMajor255::initState() {
     transpose(fTranspose, fMatrix);
+    // The translate vector is in [0, 255].  Bring it to [0,1] once here.
+    for (int i = 16; i < 20; i++) {
+        fTranspose[i] *= 1.0f/255;
+    }
 
     const float* array = fMatrix;
 
@@ -81,13 +86,12 @@ static SkPMColor round(const Sk4f& x) {
 
 template <typename Adaptor, typename T>
 void filter_span(const float array[], const T src[], int count, T dst[]) {
-    // c0-c3 are already in [0,1].
+    // c0-c4 are all already in [0,1].
     const Sk4f c0 = Sk4f::Load(array + 0);
     const Sk4f c1 = Sk4f::Load(array + 4);
     const Sk4f c2 = Sk4f::Load(array + 8);
     const Sk4f c3 = Sk4f::Load(array + 12);
-    // c4 (the translate vector) is in [0, 255].  Bring it back to [0,1].
-    const Sk4f c4 = Sk4f::Load(array + 16)*Sk4f(1.0f/255);
+    const Sk4f c4 = Sk4f::Load(array + 16);
 
     // todo: we could cache this in the constructor...
     T matrix_translate_pmcolor = Adaptor::From4f(premul(clamp_0_1(c4)));
@@ -151,6 +155,24 @@ void SkColorMatrixFilterRowMajor255::filterSpan4f(const SkPM4f src[], int count,
     filter_span<SkPM4fAdaptor>(fTranspose, src, count, dst);
 }
 
+// The same steps as filter_span(), as one fusable chain of stock stages.  A transparent source
+// unpremultiplies to 0, leaving just the translate vector, as in filter_span().
+template <int N>
+static bool append_matrix_stages(SkRasterPipelineN<N>* p, const float matrix[20]) {
+    using Pipeline = SkRasterPipelineN<N>;
+    p->append(Pipeline::unpremul);
+    p->append(Pipeline::matrix_4x5, matrix);
+    p->append(Pipeline::clamp_0_1);
+    p->append(Pipeline::premul);
+    return true;
+}
+bool SkColorMatrixFilterRowMajor255::appendStages(SkRasterPipelineN<4>* p) const {
+    return append_matrix_stages(p, fTranspose);
+}
+bool SkColorMatrixFilterRowMajor255::appendStages(SkRasterPipelineN<8>* p) const {
+    return append_matrix_stages(p, fTranspose);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void SkColorMatrixFilterRowMajor255::flatten(SkWriteBuffer& buffer) const {
@@ -20,6 +20,8 @@ public:
 
     void filterSpan(const SkPMColor src[], int count, SkPMColor[]) const override;
     void filterSpan4f(const SkPM4f src[], int count, SkPM4f[]) const override;
+    bool appendStages(SkRasterPipelineN<4>*) const override;
+    bool appendStages(SkRasterPipelineN<8>*) const override;
     uint32_t getFlags() const override;
     bool asColorMatrix(SkScalar matrix[20]) const override;
     sk_sp<SkColorFilter> makeComposed(sk_sp<SkColorFilter>) const override;
@@ -37,7 +39,7 @@ protected:
 
 private:
     SkScalar        fMatrix[20];
-    float           fTranspose[20]; // for Sk4s
+    float           fTranspose[20]; // for Sk4s and SkRasterPipeline, translate in [0,1]
     uint32_t        fFlags;
 
     void initState();
@@ -8,8 +8,11 @@
 #include "SkColorPriv.h"
 #include "SkColorSpace_Base.h"
 #include "SkColorSpaceXform.h"
+#include "SkMutex.h"
 #include "SkOpts.h"
+#include "SkRasterPipeline.h"
 #include "SkSRGB.h"
+#include "SkTArray.h"
 
 static constexpr float sk_linear_from_2dot2[256] = {
         0.000000000000000000f, 0.000005077051900662f, 0.000023328004666099f, 0.000056921765712193f,
@@ -350,6 +353,51 @@ static void build_table_linear_to_gamma(uint8_t* outTable, int outTableSize, flo
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+namespace {
+
+// An xform, built once, and the color spaces it converts between.  Holding refs on the spaces
+// keeps their addresses from being reused while we key on them.
+struct SharedXform : public SkRefCnt {
+    SharedXform(sk_sp<SkColorSpace> src, sk_sp<SkColorSpace> dst,
+                std::unique_ptr<SkColorSpaceXform> xform)
+        : fSrc(std::move(src)), fDst(std::move(dst)), fXform(std::move(xform)) {}
+
+    sk_sp<SkColorSpace>                fSrc, fDst;
+    std::unique_ptr<SkColorSpaceXform> fXform;
+};
+
+// What New() hands out: a thin forwarder to a SharedXform's tables.
+class SkSharedXform : public SkColorSpaceXform {
+public:
+    explicit SkSharedXform(sk_sp<SharedXform> shared) : fShared(std::move(shared)) {
+        this->initApplyFrom(*fShared->fXform);
+    }
+
+    void xform_RGB1_8888(uint32_t* dst, const uint32_t* src, uint32_t len) const override {
+        fShared->fXform->xform_RGB1_8888(dst, src, len);
+    }
+
+private:
+    sk_sp<SharedXform> fShared;
+};
+
+}  // namespace
+
+static constexpr int kXformCacheSize = 8;
+
+SK_DECLARE_STATIC_MUTEX(gXformCacheMutex);
+
+static SkTArray<sk_sp<SharedXform>>& xform_cache() {
+    static SkTArray<sk_sp<SharedXform>>* gCache = new SkTArray<sk_sp<SharedXform>>;
+    return *gCache;  // Most recently used last.
+}
+
+static void move_to_back(SkTArray<sk_sp<SharedXform>>* cache, int index) {
+    for (int i = index; i < cache->count() - 1; i++) {
+        SkTSwap((*cache)[i], (*cache)[i + 1]);
+    }
+}
+
 std::unique_ptr<SkColorSpaceXform> SkColorSpaceXform::New(const sk_sp<SkColorSpace>& srcSpace,
                                                           const sk_sp<SkColorSpace>& dstSpace) {
     if (!srcSpace || !dstSpace) {
@@ -357,6 +405,42 @@ std::unique_ptr<SkColorSpaceXform> SkColorSpaceXform::New(const sk_sp<SkColorSpa
         return nullptr;
     }
 
+    sk_sp<SharedXform> shared;
+    {
+        SkAutoMutexAcquire lock(gXformCacheMutex);
+        SkTArray<sk_sp<SharedXform>>& cache = xform_cache();
+        for (int i = cache.count() - 1; i >= 0; i--) {
+            if (cache[i]->fSrc == srcSpace && cache[i]->fDst == dstSpace) {
+                move_to_back(&cache, i);
+                shared = cache.back();
+                break;
+            }
+        }
+    }
+
+    if (!shared) {
+        // Build the tables without holding the lock.  Racing threads may both build them; the
+        // cache just keeps whichever finishes last.
+        std::unique_ptr<SkColorSpaceXform> xform = NewUncached(srcSpace, dstSpace);
+        if (!xform) {
+            return nullptr;
+        }
+        shared = sk_make_sp<SharedXform>(srcSpace, dstSpace, std::move(xform));
+
+        SkAutoMutexAcquire lock(gXformCacheMutex);
+        SkTArray<sk_sp<SharedXform>>& cache = xform_cache();
+        if (cache.count() == kXformCacheSize) {
+            move_to_back(&cache, 0);
+            cache.pop_back();
+        }
+        cache.push_back(shared);
+    }
+
+    return std::unique_ptr<SkColorSpaceXform>(new SkSharedXform(std::move(shared)));
+}
+
+std::unique_ptr<SkColorSpaceXform> SkColorSpaceXform::NewUncached(
+        const sk_sp<SkColorSpace>& srcSpace, const sk_sp<SkColorSpace>& dstSpace) {
     if (as_CSB(dstSpace)->colorLUT()) {
         // It would be really weird for a dst profile to have a color LUT.  I don't think
         // we need to support this.
@@ -575,6 +659,8 @@ SkFastXform<Dst>::SkFastXform(const sk_sp<SkColorSpace>& srcSpace, const SkMatri
             }
         }
     }
+
+    this->initApply(fSrcGammaTables, srcToDst, dstSpace, fDstGammaTables);
 }
 
 template <>
@@ -748,6 +834,10 @@ SkDefaultXform::SkDefaultXform(const sk_sp<SkColorSpace>& srcSpace, const SkMatr
             }
         }
     }
+
+    if (!fColorLUT) {
+        this->initApply(fSrcGammaTables, srcToDst, dstSpace, fDstGammaTables);
+    }
 }
 
 static float byte_to_float(uint8_t byte) {
@@ -912,3 +1002,261 @@ void SkDefaultXform::xform_RGB1_8888(uint32_t* dst, const uint32_t* src, uint32_
         src++;
     }
 }
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static void set_parametric(SkColorSpaceXform::DstCurve* curve, float g, float a, float b, float c,
+                           float d, float e, float f) {
+    // See inverse_parametric().
+    curve->fTable      = nullptr;
+    curve->fInterval   = e * d + f;
+    curve->fInvE       = 0.0f != e ? 1.0f / e : 0.0f;
+    curve->fFOverE     = 0.0f != e ? f / e    : 0.0f;
+    curve->fUpperIsOne = 0.0f == a || 0.0f == g;
+    curve->fInvG       = 0.0f != g ? 1.0f / g : 0.0f;
+    curve->fInvA       = 0.0f != a ? 1.0f / a : 0.0f;
+    curve->fBOverA     = 0.0f != a ? b / a    : 0.0f;
+    curve->fC          = c;
+}
+
+static void set_named(SkColorSpaceXform::DstCurve* curve, SkColorSpace::GammaNamed named) {
+    switch (named) {
+        case SkColorSpace::kSRGB_GammaNamed:
+            set_parametric(curve, 2.4f, 1.0f / 1.055f, 0.055f / 1.055f, 0.0f, 0.04045f,
+                           1.0f / 12.92f, 0.0f);
+            break;
+        case SkColorSpace::k2Dot2Curve_GammaNamed:
+            set_parametric(curve, 2.2f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+            break;
+        default:
+            SkASSERT(SkColorSpace::kLinear_GammaNamed == named);
+            set_parametric(curve, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+            break;
+    }
+}
+
+void SkColorSpaceXform::initApply(const float* const srcGammaTables[3], const SkMatrix44& srcToDst,
+                                  const sk_sp<SkColorSpace>& dstSpace,
+                                  const uint8_t* const dstGammaTables[3]) {
+    for (int i = 0; i < 3; i++) {
+        fApplySrcGammaTables[i] = srcGammaTables[i];
+
+        // Each dst channel is a row: dot the src channels with column i, then translate.
+        fApplySrcToDst[4*i + 0] = srcToDst.getFloat(0, i);
+        fApplySrcToDst[4*i + 1] = srcToDst.getFloat(1, i);
+        fApplySrcToDst[4*i + 2] = srcToDst.getFloat(2, i);
+        fApplySrcToDst[4*i + 3] = srcToDst.getFloat(3, i);
+    }
+
+    if (SkColorSpace::kNonStandard_GammaNamed != dstSpace->gammaNamed()) {
+        for (int i = 0; i < 3; i++) {
+            set_named(&fApplyDstCurves[i], dstSpace->gammaNamed());
+        }
+    } else {
+        const SkGammas* gammas = as_CSB(dstSpace)->gammas();
+        SkASSERT(gammas);
+        for (int i = 0; i < 3; i++) {
+            const SkGammaCurve& curve = (*gammas)[i];
+            if (curve.isNamed()) {
+                set_named(&fApplyDstCurves[i], curve.fNamed);
+            } else if (curve.isValue()) {
+                set_parametric(&fApplyDstCurves[i], curve.fValue, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+                               0.0f);
+            } else if (curve.isTable()) {
+                // Inverting a table needs a search, so we use the table already built for that.
+                fApplyDstCurves[i].fTable = dstGammaTables[i];
+            } else {
+                SkASSERT(curve.isParametric());
+                set_parametric(&fApplyDstCurves[i], curve.fG, curve.fA, curve.fB, curve.fC,
+                               curve.fD, curve.fE, curve.fF);
+            }
+        }
+    }
+    fSupportsApply = true;
+}
+
+void SkColorSpaceXform::initApplyFrom(const SkColorSpaceXform& other) {
+    fSupportsApply = other.fSupportsApply;
+    for (int i = 0; i < 3; i++) {
+        fApplySrcGammaTables[i] = other.fApplySrcGammaTables[i];
+        fApplyDstCurves[i]      = other.fApplyDstCurves[i];
+    }
+    memcpy(fApplySrcToDst, other.fApplySrcToDst, sizeof(fApplySrcToDst));
+}
+
+// apply() is an SkRasterPipeline: load and linearize the src, convert to the dst gamut, then
+// either store F16, or encode with the dst transfer function and store 8888.
+namespace {
+
+struct LoadCtx {
+    const uint32_t* fSrc;
+    const float*    fTables[3];
+};
+
+struct EncodeCtx {
+    const SkColorSpaceXform::DstCurve* fCurves;
+    int                                fTableSize;
+};
+
+#define STAGE(name)                                                                   \
+    static void SK_VECTORCALL name(SkRasterPipeline::Stage* st, size_t x,             \
+                                   Sk4f r, Sk4f g, Sk4f b, Sk4f a,                   \
+                                   Sk4f dr, Sk4f dg, Sk4f db, Sk4f da)
+
+// Reinterpret floats as ints and back.  The round trip through memory compiles away.
+static Sk4i bits_of(const Sk4f& v) {
+    float tmp[4];
+    v.store(tmp);
+    return Sk4i::Load(tmp);
+}
+
+static Sk4f float_from_bits(const Sk4i& bits) {
+    int tmp[4];
+    bits.store(tmp);
+    return Sk4f::Load(tmp);
+}
+
+// log2(x) for x > 0, from the float's exponent and a rational fit of its mantissa.
+static Sk4f approx_log2(const Sk4f& x) {
+    Sk4i bits = bits_of(x);
+    Sk4f e = SkNx_cast<float>(bits) * (1.0f / (1 << 23));
+    Sk4f m = float_from_bits((bits & 0x007fffff) | 0x3f000000);
+    return e - 124.225514990f - 1.498030302f * m - 1.725879990f / (0.3520887068f + m);
+}
+
+// 2^x, building the float's exponent from x's integer part and fitting its fractional part.
+static Sk4f approx_pow2(const Sk4f& x) {
+    Sk4f clamped = Sk4f::Max(x, -126.0f),
+         f = clamped - clamped.floor();
+    return float_from_bits(Sk4f_round((1.0f * (1 << 23)) *
+            (clamped + 121.274057500f - 1.490129070f * f + 27.728023300f / (4.84252568f - f))));
+}
+
+// x^p for x >= 0, to within about 1e-4 relative error; plenty to round to 8 bits.
+static Sk4f approx_pow(const Sk4f& x, float p) {
+    return (x == 0.0f).thenElse(0.0f, approx_pow2(approx_log2(x) * p));
+}
+
+static Sk4f encode(const Sk4f& x, const SkColorSpaceXform::DstCurve& curve, int tableSize) {
+    if (curve.fTable) {
+        Sk4i index = Sk4f_round(x * (float)(tableSize - 1));
+        return Sk4f(curve.fTable[index[0]], curve.fTable[index[1]],
+                    curve.fTable[index[2]], curve.fTable[index[3]]) * (1 / 255.0f);
+    }
+    Sk4f upper = 1.0f;
+    if (!curve.fUpperIsOne) {
+        Sk4f base = Sk4f::Max(x - curve.fC, 0.0f);
+        upper = (1.0f == curve.fInvG ? base : approx_pow(base, curve.fInvG)) * curve.fInvA
+              - curve.fBOverA;
+    }
+    Sk4f lower = x * curve.fInvE - curve.fFOverE;
+    return (x < curve.fInterval).thenElse(lower, upper);
+}
+
+static Sk4f clamp_01(const Sk4f& x) {
+    return Sk4f::Min(Sk4f::Max(x, 0.0f), 1.0f);
+}
+
+template <int kN>
+static void load_rgba_8888(const LoadCtx* ctx, size_t x, Sk4f* r, Sk4f* g, Sk4f* b, Sk4f* a) {
+    const uint32_t* src = ctx->fSrc + x;
+    float R[4] = {0}, G[4] = {0}, B[4] = {0}, A[4] = {0};
+    for (int i = 0; i < kN; i++) {
+        R[i] = ctx->fTables[0][(src[i] >>  0) & 0xff];
+        G[i] = ctx->fTables[1][(src[i] >>  8) & 0xff];
+        B[i] = ctx->fTables[2][(src[i] >> 16) & 0xff];
+        A[i] =                 (src[i] >> 24) * (1 / 255.0f);
+    }
+    *r = Sk4f::Load(R);
+    *g = Sk4f::Load(G);
+    *b = Sk4f::Load(B);
+    *a = Sk4f::Load(A);
+}
+
+STAGE(load_linear) {
+    load_rgba_8888<4>(st->ctx<const LoadCtx*>(), x, &r, &g, &b, &a);
+    st->next(x, r,g,b,a, dr,dg,db,da);
+}
+
+STAGE(load_linear_1) {
+    load_rgba_8888<1>(st->ctx<const LoadCtx*>(), x, &r, &g, &b, &a);
+    st->next(x, r,g,b,a, dr,dg,db,da);
+}
+
+STAGE(gamut) {
+    const float* m = st->ctx<const float*>();
+    Sk4f R = r * m[0] + g * m[1] + b * m[ 2] + m[ 3],
+         G = r * m[4] + g * m[5] + b * m[ 6] + m[ 7],
+         B = r * m[8] + g * m[9] + b * m[10] + m[11];
+    st->next(x, clamp_01(R), clamp_01(G), clamp_01(B), a, dr,dg,db,da);
+}
+
+STAGE(encode_dst) {
+    auto ctx = st->ctx<const EncodeCtx*>();
+    r = encode(r, ctx->fCurves[0], ctx->fTableSize);
+    g = encode(g, ctx->fCurves[1], ctx->fTableSize);
+    b = encode(b, ctx->fCurves[2], ctx->fTableSize);
+    st->next(x, r,g,b,a, dr,dg,db,da);
+}
+
+STAGE(premul) {
+    st->next(x, r*a, g*a, b*a, a, dr,dg,db,da);
+}
+
+template <int kN>
+static void store_8888(uint32_t* dst, const Sk4f& r, const Sk4f& g, const Sk4f& b,
+                       const Sk4f& a) {
+    Sk4i px = Sk4f_round(clamp_01(r) * 255.0f)
+            | Sk4f_round(clamp_01(g) * 255.0f) << 8
+            | Sk4f_round(clamp_01(b) * 255.0f) << 16
+            | Sk4f_round(clamp_01(a) * 255.0f) << 24;
+    if (4 == kN) {
+        px.store(dst);
+    } else {
+        *dst = px[0];
+    }
+}
+
+STAGE(store_rgba_8888) {
+    store_8888<4>(st->ctx<uint32_t*>() + x, r, g, b, a);
+}
+
+STAGE(store_rgba_8888_1) {
+    store_8888<1>(st->ctx<uint32_t*>() + x, r, g, b, a);
+}
+
+#undef STAGE
+
+}  // namespace
+
+bool SkColorSpaceXform::apply(void* dst, const uint32_t* src, int len, ColorFormat dstColorFormat,
+                              SkAlphaType dstAlphaType) const {
+    if (!fSupportsApply) {
+        return false;
+    }
+
+    LoadCtx load = { src, { fApplySrcGammaTables[0], fApplySrcGammaTables[1],
+                            fApplySrcGammaTables[2] } };
+    EncodeCtx encode = { fApplyDstCurves, kDstGammaTableSize };
+
+    SkRasterPipeline p;
+    p.append(load_linear, load_linear_1, &load);
+    p.append(gamut, fApplySrcToDst);
+    if (kRGBA_F16_ColorFormat == dstColorFormat) {
+        if (kPremul_SkAlphaType == dstAlphaType) {
+            p.append(premul);
+        }
+        p.append(SkRasterPipeline::store_f16, dst);
+    } else {
+        p.append(encode_dst, &encode);
+        if (kPremul_SkAlphaType == dstAlphaType) {
+            p.append(premul);
+        }
+        if (kBGRA_8888_ColorFormat == dstColorFormat) {
+            p.append(SkRasterPipeline::swap_rb);
+        }
+        p.append(store_rgba_8888, store_rgba_8888_1, dst);
+    }
+    p.run(len);
+    return true;
+}
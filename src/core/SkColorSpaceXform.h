@@ -10,6 +10,7 @@
 
 #include "SkColorSpace.h"
 #include "SkColorSpace_Base.h"
+#include "SkImageInfo.h"
 
 class SkColorSpaceXform : SkNoncopyable {
 public:
@@ -17,6 +18,10 @@ public:
     /**
      *  Create an object to handle color space conversions.
      *
+     *  The tables behind recently created xforms are cached by (srcSpace, dstSpace), so asking
+     *  again for the same pair of color spaces is cheap.  SkColorSpace::NewICC() returns the same
+     *  object for identical profiles, so this holds across images sharing a profile too.
+     *
      *  @param srcSpace The encoded color space.
      *  @param dstSpace The destination color space.
      *
@@ -31,7 +36,55 @@ public:
      */
     virtual void xform_RGB1_8888(uint32_t* dst, const uint32_t* src, uint32_t len) const = 0;
 
+    enum ColorFormat {
+        kRGBA_8888_ColorFormat,
+        kBGRA_8888_ColorFormat,
+        kRGBA_F16_ColorFormat,
+    };
+
+    /**
+     *  Apply the color conversion to a src buffer of unpremultiplied RGBA_8888, which may have
+     *  alpha, storing the output in the dst buffer in dstColorFormat.  8888 dsts are encoded with
+     *  the dst transfer function; F16 dsts are left linear.  If dstAlphaType is kPremul, the
+     *  color channels are multiplied by alpha (after encoding, for 8888).
+     *
+     *  Returns false if the conversion is not supported, as for srcs with a color LUT.
+     */
+    bool apply(void* dst, const uint32_t* src, int len, ColorFormat dstColorFormat,
+               SkAlphaType dstAlphaType) const;
+
     virtual ~SkColorSpaceXform() {}
+
+    // How apply() encodes a linear channel for an 8888 dst: with a table, or by inverting the
+    // parametric curve Y = (aX + b)^g + c for X >= d, Y = eX + f otherwise.
+    struct DstCurve {
+        const uint8_t* fTable;       // If not null, a kDstGammaTableSize table to encode with.
+        float          fInterval;    // e*d + f: linear values below this use the lower segment.
+        float          fInvE, fFOverE;
+        float          fInvG, fInvA, fBOverA, fC;
+        bool           fUpperIsOne;  // The upper segment is constant.
+    };
+
+protected:
+    SkColorSpaceXform() : fSupportsApply(false) {}
+
+    static constexpr int kDstGammaTableSize = 1024;
+
+    // Subclasses that can support apply() call this once their tables are built.
+    void initApply(const float* const srcGammaTables[3], const SkMatrix44& srcToDst,
+                   const sk_sp<SkColorSpace>& dstSpace, const uint8_t* const dstGammaTables[3]);
+
+    // For xforms that share another's tables: apply() as that xform would.
+    void initApplyFrom(const SkColorSpaceXform& other);
+
+private:
+    static std::unique_ptr<SkColorSpaceXform> NewUncached(const sk_sp<SkColorSpace>& srcSpace,
+                                                          const sk_sp<SkColorSpace>& dstSpace);
+
+    bool           fSupportsApply;
+    const float*   fApplySrcGammaTables[3];
+    float          fApplySrcToDst[12];  // Row major 3x4, translate last.
+    DstCurve       fApplyDstCurves[3];
 };
 
 template <SkColorSpace::GammaNamed Dst>
@@ -44,8 +97,6 @@ private:
     SkFastXform(const sk_sp<SkColorSpace>& srcSpace, const SkMatrix44& srcToDst,
                 const sk_sp<SkColorSpace>& dstSpace);
 
-    static constexpr int kDstGammaTableSize = 1024;
-
     // May contain pointers into storage or pointers into precomputed tables.
     const float*         fSrcGammaTables[3];
     float                fSrcGammaTableStorage[3 * 256];
@@ -71,8 +122,6 @@ private:
     SkDefaultXform(const sk_sp<SkColorSpace>& srcSpace, const SkMatrix44& srcToDst,
                    const sk_sp<SkColorSpace>& dstSpace);
 
-    static constexpr int      kDstGammaTableSize = 1024;
-
     sk_sp<SkColorLookUpTable> fColorLUT;
 
     // May contain pointers into storage or pointers into precomputed tables.
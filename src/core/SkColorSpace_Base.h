@@ -171,6 +171,9 @@ private:
 
     static sk_sp<SkColorSpace> NewRGB(GammaNamed gammaNamed, const SkMatrix44& toXYZD50);
 
+    // Parses an ICC profile, skipping the cache of recently parsed profiles in NewICC().
+    static sk_sp<SkColorSpace> ParseICC(sk_sp<SkData> profile);
+
     SkColorSpace_Base(GammaNamed gammaNamed, const SkMatrix44& toXYZ, Named named);
 
     SkColorSpace_Base(sk_sp<SkColorLookUpTable> colorLUT, sk_sp<SkGammas> gammas,
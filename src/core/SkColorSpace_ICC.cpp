@@ -10,6 +10,9 @@
 #include "SkColorSpacePriv.h"
 #include "SkEndian.h"
 #include "SkFixed.h"
+#include "SkMutex.h"
+#include "SkOpts.h"
+#include "SkTArray.h"
 #include "SkTemplates.h"
 
 #define return_if_false(pred, msg)                                   \
@@ -678,16 +681,9 @@ bool load_a2b0(SkColorLookUpTable* colorLUT, SkGammaCurve* gammas, SkMatrix44* t
     return true;
 }
 
-sk_sp<SkColorSpace> SkColorSpace::NewICC(const void* input, size_t len) {
-    if (!input || len < kICCHeaderSize) {
-        return_null("Data is null or not large enough to contain an ICC profile");
-    }
-
-    // Create our own copy of the input.
-    void* memory = sk_malloc_throw(len);
-    memcpy(memory, input, len);
-    sk_sp<SkData> data = SkData::MakeFromMalloc(memory, len);
+sk_sp<SkColorSpace> SkColorSpace_Base::ParseICC(sk_sp<SkData> data) {
     const void* base = data->data();
+    size_t len = data->size();
     const uint8_t* ptr = (const uint8_t*) base;
 
     // Read the ICC profile header and check to make sure that it is valid.
@@ -810,6 +806,65 @@ sk_sp<SkColorSpace> SkColorSpace::NewICC(const void* input, size_t len) {
     return_null("ICC profile contains unsupported colorspace");
 }
 
+// Images from the same camera or app tend to embed identical profiles, so we keep the most
+// recently parsed ones and hand back the same SkColorSpace for the same bytes.  Sharing the
+// SkColorSpace also lets SkColorSpaceXform::New() find a cached xform for it.
+static constexpr int kICCCacheSize = 16;
+
+struct ICCCacheEntry {
+    uint32_t            fHash;
+    sk_sp<SkData>       fProfile;
+    sk_sp<SkColorSpace> fColorSpace;
+};
+
+SK_DECLARE_STATIC_MUTEX(gICCCacheMutex);
+
+static SkTArray<ICCCacheEntry>& icc_cache() {
+    static SkTArray<ICCCacheEntry>* gCache = new SkTArray<ICCCacheEntry>;  // Most recent last.
+    return *gCache;
+}
+
+static void move_to_back(SkTArray<ICCCacheEntry>* cache, int index) {
+    for (int i = index; i < cache->count() - 1; i++) {
+        SkTSwap((*cache)[i], (*cache)[i + 1]);
+    }
+}
+
+sk_sp<SkColorSpace> SkColorSpace::NewICC(const void* input, size_t len) {
+    if (!input || len < kICCHeaderSize) {
+        return_null("Data is null or not large enough to contain an ICC profile");
+    }
+
+    const uint32_t hash = SkOpts::hash(input, len);
+    {
+        SkAutoMutexAcquire lock(gICCCacheMutex);
+        SkTArray<ICCCacheEntry>& cache = icc_cache();
+        for (int i = cache.count() - 1; i >= 0; i--) {
+            if (cache[i].fHash == hash && cache[i].fProfile->size() == len &&
+                0 == memcmp(cache[i].fProfile->data(), input, len)) {
+                move_to_back(&cache, i);
+                return cache.back().fColorSpace;
+            }
+        }
+    }
+
+    // Create our own copy of the input.
+    sk_sp<SkData> data = SkData::MakeWithCopy(input, len);
+    sk_sp<SkColorSpace> colorSpace = SkColorSpace_Base::ParseICC(data);
+    if (!colorSpace) {
+        return nullptr;
+    }
+
+    SkAutoMutexAcquire lock(gICCCacheMutex);
+    SkTArray<ICCCacheEntry>& cache = icc_cache();
+    if (cache.count() == kICCCacheSize) {
+        move_to_back(&cache, 0);
+        cache.pop_back();
+    }
+    cache.push_back(ICCCacheEntry{ hash, std::move(data), colorSpace });
+    return colorSpace;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 // We will write a profile with the minimum nine required tags.
@@ -11,7 +11,8 @@
 #include "SkColorPriv.h"
 #include "SkDither.h"
 #include "SkMathPriv.h"
-#include "SkUnPreMultiply.h"
+#include "SkOpts.h"
+#include "SkTaskGroup.h"
 
 enum AlphaVerb {
     kNothing_AlphaVerb,
@@ -19,36 +20,6 @@ enum AlphaVerb {
     kUnpremul_AlphaVerb,
 };
 
-template <bool doSwapRB, AlphaVerb doAlpha> uint32_t convert32(uint32_t c) {
-    if (doSwapRB) {
-        c = SkSwizzle_RB(c);
-    }
-
-    // Lucky for us, in both RGBA and BGRA, the alpha component is always in the same place, so
-    // we can perform premul or unpremul the same way without knowing the swizzles for RGB.
-    switch (doAlpha) {
-        case kNothing_AlphaVerb:
-            // no change
-            break;
-        case kPremul_AlphaVerb:
-            c = SkPreMultiplyARGB(SkGetPackedA32(c), SkGetPackedR32(c),
-                                  SkGetPackedG32(c), SkGetPackedB32(c));
-            break;
-        case kUnpremul_AlphaVerb:
-            c = SkUnPreMultiply::UnPreMultiplyPreservingByteOrder(c);
-            break;
-    }
-    return c;
-}
-
-template <bool doSwapRB, AlphaVerb doAlpha>
-void convert32_row(uint32_t* dst, const uint32_t* src, int count) {
-    // This has to be correct if src == dst (but not partial overlap)
-    for (int i = 0; i < count; ++i) {
-        dst[i] = convert32<doSwapRB, doAlpha>(src[i]);
-    }
-}
-
 static bool is_32bit_colortype(SkColorType ct) {
     return kRGBA_8888_SkColorType == ct || kBGRA_8888_SkColorType == ct;
 }
@@ -70,8 +41,49 @@ static AlphaVerb compute_AlphaVerb(SkAlphaType src, SkAlphaType dst) {
     }
 }
 
-static void memcpy32_row(uint32_t* dst, const uint32_t* src, int count) {
-    memcpy(dst, src, count * 4);
+// Returns the SkOpts swizzle converting between these 32-bit formats, or nullptr if the pixels
+// are already in the right format.  Lucky for us, in both RGBA and BGRA the alpha component is
+// always in the same place, so we can premul or unpremul without knowing the order of RGB.
+static SkOpts::Swizzle_8888 choose_32_proc(SkColorType srcCT, SkAlphaType srcAT,
+                                           SkColorType dstCT, SkAlphaType dstAT) {
+    const bool doSwapRB = srcCT != dstCT;
+    switch (compute_AlphaVerb(srcAT, dstAT)) {
+        case kNothing_AlphaVerb:   return doSwapRB ? SkOpts::RGBA_to_BGRA : nullptr;
+        case kPremul_AlphaVerb:    return doSwapRB ? SkOpts::RGBA_to_bgrA : SkOpts::RGBA_to_rgbA;
+        case kUnpremul_AlphaVerb:  return doSwapRB ? SkOpts::rgbA_to_BGRA : SkOpts::rgbA_to_RGBA;
+    }
+    return nullptr;
+}
+
+// Every row converts independently of the others, so big conversions are split into bands of
+// rows run on SkTaskGroup's threads.
+static const int kMinParallelPixels = 512 * 512;
+static const int kPixelsPerBand     = 128 * 512;
+
+static void convert_rows(int width, int height, const std::function<void(int)>& convertRow) {
+    const int64_t pixels = sk_64_mul(width, height);
+    if (pixels < kMinParallelPixels || !SkTaskGroup::Enabled()) {
+        for (int y = 0; y < height; ++y) {
+            convertRow(y);
+        }
+        return;
+    }
+    const int bands = (int)SkTMin<int64_t>(height, pixels / kPixelsPerBand);
+    SkTaskGroup().batch(bands, [&](int i) {
+        for (int y = i * height / bands; y < (i + 1) * height / bands; ++y) {
+            convertRow(y);
+        }
+    });
+}
+
+template <typename T>
+static T* row(void* pixels, size_t rowBytes, int y) {
+    return (T*)((char*)pixels + y * rowBytes);
+}
+
+template <typename T>
+static const T* row(const void* pixels, size_t rowBytes, int y) {
+    return (const T*)((const char*)pixels + y * rowBytes);
 }
 
 bool SkSrcPixelInfo::convertPixelsTo(SkDstPixelInfo* dst, int width, int height) const {
@@ -83,87 +95,56 @@ bool SkSrcPixelInfo::convertPixelsTo(SkDstPixelInfo* dst, int width, int height)
         return false;
     }
 
-    void (*proc)(uint32_t* dst, const uint32_t* src, int count);
-    AlphaVerb doAlpha = compute_AlphaVerb(fAlphaType, dst->fAlphaType);
-    bool doSwapRB = fColorType != dst->fColorType;
-
-    switch (doAlpha) {
-        case kNothing_AlphaVerb:
-            if (doSwapRB) {
-                proc = convert32_row<true, kNothing_AlphaVerb>;
-            } else {
-                if (fPixels == dst->fPixels) {
-                    return true;
-                }
-                proc = memcpy32_row;
-            }
-            break;
-        case kPremul_AlphaVerb:
-            if (doSwapRB) {
-                proc = convert32_row<true, kPremul_AlphaVerb>;
-            } else {
-                proc = convert32_row<false, kPremul_AlphaVerb>;
-            }
-            break;
-        case kUnpremul_AlphaVerb:
-            if (doSwapRB) {
-                proc = convert32_row<true, kUnpremul_AlphaVerb>;
-            } else {
-                proc = convert32_row<false, kUnpremul_AlphaVerb>;
-            }
-            break;
+    // The swizzles all work in place, which this must if src == dst (but not partial overlap).
+    SkOpts::Swizzle_8888 proc = choose_32_proc(fColorType, fAlphaType,
+                                               dst->fColorType, dst->fAlphaType);
+    if (!proc && fPixels == dst->fPixels) {
+        return true;
     }
 
-    uint32_t* dstP = static_cast<uint32_t*>(dst->fPixels);
-    const uint32_t* srcP = static_cast<const uint32_t*>(fPixels);
-    size_t srcInc = fRowBytes >> 2;
-    size_t dstInc = dst->fRowBytes >> 2;
-    for (int y = 0; y < height; ++y) {
-        proc(dstP, srcP, width);
-        dstP += dstInc;
-        srcP += srcInc;
-    }
+    convert_rows(width, height, [&](int y) {
+        uint32_t* dstRow = row<uint32_t>(dst->fPixels, dst->fRowBytes, y);
+        const uint32_t* srcRow = row<uint32_t>(fPixels, fRowBytes, y);
+        if (proc) {
+            proc(dstRow, srcRow, width);
+        } else {
+            memcpy(dstRow, srcRow, width * 4);
+        }
+    });
     return true;
 }
 
-static void copy_g8_to_32(void* dst, size_t dstRB, const void* src, size_t srcRB, int w, int h) {
-    uint32_t* dst32 = (uint32_t*)dst;
-    const uint8_t* src8 = (const uint8_t*)src;
-
-    for (int y = 0; y < h; ++y) {
+static void copy_32_to_g8_row(uint8_t* dst8, const uint32_t* src32, int w, bool isBGRA) {
+    if (isBGRA) {
+        // BGRA
         for (int x = 0; x < w; ++x) {
-            dst32[x] = SkPackARGB32(0xFF, src8[x], src8[x], src8[x]);
+            uint32_t s = src32[x];
+            dst8[x] = SkComputeLuminance((s >> 16) & 0xFF, (s >> 8) & 0xFF, s & 0xFF);
+        }
+    } else {
+        // RGBA
+        for (int x = 0; x < w; ++x) {
+            uint32_t s = src32[x];
+            dst8[x] = SkComputeLuminance(s & 0xFF, (s >> 8) & 0xFF, (s >> 16) & 0xFF);
         }
-        dst32 = (uint32_t*)((char*)dst32 + dstRB);
-        src8 += srcRB;
     }
 }
 
-static void copy_32_to_g8(void* dst, size_t dstRB, const void* src, size_t srcRB,
-                          const SkImageInfo& srcInfo) {
-    uint8_t* dst8 = (uint8_t*)dst;
-    const uint32_t* src32 = (const uint32_t*)src;
-
-    const int w = srcInfo.width();
-    const int h = srcInfo.height();
-    const bool isBGRA = (kBGRA_8888_SkColorType == srcInfo.colorType());
-
-    for (int y = 0; y < h; ++y) {
-        if (isBGRA) {
-            // BGRA
-            for (int x = 0; x < w; ++x) {
-                uint32_t s = src32[x];
-                dst8[x] = SkComputeLuminance((s >> 16) & 0xFF, (s >> 8) & 0xFF, s & 0xFF);
-            }
-        } else {
-            // RGBA
-            for (int x = 0; x < w; ++x) {
-                uint32_t s = src32[x];
-                dst8[x] = SkComputeLuminance(s & 0xFF, (s >> 8) & 0xFF, (s >> 16) & 0xFF);
-            }
-        }
-        src32 = (const uint32_t*)((const char*)src32 + srcRB);
-        dst8 += dstRB;
+static void copy_g8_to_32_row(uint32_t* dst32, const uint8_t* src8, int w) {
+    for (int x = 0; x < w; ++x) {
+        dst32[x] = SkPackARGB32(0xFF, src8[x], src8[x], src8[x]);
+    }
+}
+
+static void copy_565_to_32_row(SkPMColor* dst, const uint16_t* src, int w) {
+    for (int x = 0; x < w; ++x) {
+        dst[x] = SkPixel16ToPixel32(src[x]);
+    }
+}
+
+static void copy_4444_to_32_row(SkPMColor* dst, const SkPMColor16* src, int w) {
+    for (int x = 0; x < w; ++x) {
+        dst[x] = SkPixel4444ToPixel32(src[x]);
     }
 }
 
@@ -232,11 +213,18 @@ bool SkPixelInfo::CopyPixels(const SkImageInfo& dstInfo, void* dstPixels, size_t
      */
 
     if (kGray_8_SkColorType == srcInfo.colorType() && 4 == dstInfo.bytesPerPixel()) {
-        copy_g8_to_32(dstPixels, dstRB, srcPixels, srcRB, width, height);
+        convert_rows(width, height, [&](int y) {
+            copy_g8_to_32_row(row<uint32_t>(dstPixels, dstRB, y),
+                              row<uint8_t>(srcPixels, srcRB, y), width);
+        });
         return true;
     }
     if (kGray_8_SkColorType == dstInfo.colorType() && 4 == srcInfo.bytesPerPixel()) {
-        copy_32_to_g8(dstPixels, dstRB, srcPixels, srcRB, srcInfo);
+        const bool isBGRA = (kBGRA_8888_SkColorType == srcInfo.colorType());
+        convert_rows(width, height, [&](int y) {
+            copy_32_to_g8_row(row<uint8_t>(dstPixels, dstRB, y),
+                              row<uint32_t>(srcPixels, srcRB, y), width, isBGRA);
+        });
         return true;
     }
 
@@ -281,6 +269,43 @@ bool SkPixelInfo::CopyPixels(const SkImageInfo& dstInfo, void* dstPixels, size_t
         return false;
     }
 
+    // These are what drawing would produce into N32, without the overhead of a canvas.
+    if (kN32_SkColorType == dstInfo.colorType()) {
+        switch (srcInfo.colorType()) {
+            case kIndex_8_SkColorType: {
+                if (nullptr == ctable) {
+                    return false;
+                }
+                uint32_t table[256];
+                sk_bzero(table, sizeof(table));
+                memcpy(table, ctable->readColors(), ctable->count() * sizeof(SkPMColor));
+                convert_rows(width, height, [&](int y) {
+                    SkOpts::index8_to_8888(row<uint32_t>(dstPixels, dstRB, y),
+                                           row<uint8_t>(srcPixels, srcRB, y),
+                                           width, table);
+                });
+                return true;
+            }
+            case kRGB_565_SkColorType:
+                convert_rows(width, height, [&](int y) {
+                    copy_565_to_32_row(row<SkPMColor>(dstPixels, dstRB, y),
+                                       row<uint16_t>(srcPixels, srcRB, y), width);
+                });
+                return true;
+            case kARGB_4444_SkColorType:
+                if (srcInfo.alphaType() == kUnpremul_SkAlphaType) {
+                    break;
+                }
+                convert_rows(width, height, [&](int y) {
+                    copy_4444_to_32_row(row<SkPMColor>(dstPixels, dstRB, y),
+                                        row<SkPMColor16>(srcPixels, srcRB, y), width);
+                });
+                return true;
+            default:
+                break;
+        }
+    }
+
     // Final fall-back, draw with a canvas
     //
     // Always clear the dest in case one of the blitters accesses it
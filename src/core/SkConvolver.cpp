@@ -349,6 +349,24 @@ bool BGRAConvolve2D(const unsigned char* sourceData,
                     unsigned char* output,
                     const SkConvolutionProcs& convolveProcs,
                     bool useSimdIfPossible) {
+    return BGRAConvolve2DRows(sourceData, sourceByteRowStride, sourceHasAlpha, filterX, filterY,
+                              outputByteRowStride, output, convolveProcs, useSimdIfPossible,
+                              0, filterY.numValues());
+}
+
+bool BGRAConvolve2DRows(const unsigned char* sourceData,
+                        int sourceByteRowStride,
+                        bool sourceHasAlpha,
+                        const SkConvolutionFilter1D& filterX,
+                        const SkConvolutionFilter1D& filterY,
+                        int outputByteRowStride,
+                        unsigned char* output,
+                        const SkConvolutionProcs& convolveProcs,
+                        bool useSimdIfPossible,
+                        int firstOutputRow,
+                        int endOutputRow) {
+    SkASSERT(0 <= firstOutputRow && firstOutputRow < endOutputRow &&
+             endOutputRow <= filterY.numValues());
 
     int maxYFilterSize = filterY.maxFilter();
 
@@ -359,7 +377,7 @@ bool BGRAConvolve2D(const unsigned char* sourceData,
     // row for convolution as the first pixel for the first vertical filter.
     int filterOffset, filterLength;
     const SkConvolutionFilter1D::ConvolutionFixed* filterValues =
-        filterY.FilterForValue(0, &filterOffset, &filterLength);
+        filterY.FilterForValue(firstOutputRow, &filterOffset, &filterLength);
     int nextXRow = filterOffset;
 
     // We loop over each row in the input doing a horizontal convolution. This
@@ -417,7 +435,7 @@ bool BGRAConvolve2D(const unsigned char* sourceData,
     filterY.FilterForValue(numOutputRows - 1, &lastFilterOffset,
                            &lastFilterLength);
 
-    for (int outY = 0; outY < numOutputRows; outY++) {
+    for (int outY = firstOutputRow; outY < endOutputRow; outY++) {
         filterValues = filterY.FilterForValue(outY,
                                               &filterOffset, &filterLength);
 
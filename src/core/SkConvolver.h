@@ -204,4 +204,18 @@ SK_API bool BGRAConvolve2D(const unsigned char* sourceData,
     const SkConvolutionProcs&,
     bool useSimdIfPossible);
 
+// Like BGRAConvolve2D(), but only produces output rows [firstOutputRow, endOutputRow), still
+// writing each to its place in |output|.  Disjoint row ranges may be convolved at the same time.
+SK_API bool BGRAConvolve2DRows(const unsigned char* sourceData,
+    int sourceByteRowStride,
+    bool sourceHasAlpha,
+    const SkConvolutionFilter1D& xfilter,
+    const SkConvolutionFilter1D& yfilter,
+    int outputByteRowStride,
+    unsigned char* output,
+    const SkConvolutionProcs&,
+    bool useSimdIfPossible,
+    int firstOutputRow,
+    int endOutputRow);
+
 #endif  // SK_CONVOLVER_H
@@ -148,6 +148,27 @@ sk_sp<SkData> SkData::MakeFromFD(int fd) {
     return SkData::MakeWithProc(addr, size, sk_mmap_releaseproc, nullptr);
 }
 
+sk_sp<SkData> SkData::MakeShared(size_t length, int* fd) {
+    SkASSERT(fd);
+    void* addr = sk_shm_create(length, fd);
+    if (nullptr == addr) {
+        return nullptr;
+    }
+
+    return SkData::MakeWithProc(addr, length, sk_mmap_releaseproc,
+                                reinterpret_cast<void*>(length));
+}
+
+sk_sp<SkData> SkData::MakeFromSharedFD(int fd) {
+    size_t size;
+    void* addr = sk_shmmap(fd, false, &size);
+    if (nullptr == addr) {
+        return nullptr;
+    }
+
+    return SkData::MakeWithProc(addr, size, sk_mmap_releaseproc, reinterpret_cast<void*>(size));
+}
+
 // assumes context is a SkData
 static void sk_dataref_releaseproc(const void*, void* context) {
     SkData* src = reinterpret_cast<SkData*>(context);
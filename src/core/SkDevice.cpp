@@ -458,7 +458,7 @@ void SkBaseDevice::drawSpriteWithFilter(const SkDraw& draw, const SkBitmap& bitm
         return; // something disastrous happened
     }
 
-    sk_sp<SkSpecialImage> resultImg(filter->filterImage(srcImg.get(), ctx, &offset));
+    sk_sp<SkSpecialImage> resultImg(filter->filterImageTiled(srcImg.get(), ctx, &offset));
     if (resultImg) {
         SkPaint tmpUnfiltered(paint);
         tmpUnfiltered.setImageFilter(nullptr);
@@ -6,100 +6,72 @@
  */
 
 #include "SkDistanceFieldGen.h"
+#include "SkNx.h"
 #include "SkPoint.h"
 
+// Distance field data is kept in separate arrays, so that whole rows can be read four at a time.
 struct DFData {
-    float   fAlpha;      // alpha value of source texel
-    float   fDistSq;     // distance squared to nearest (so far) edge texel
-    SkPoint fDistVector; // distance vector to nearest (so far) edge texel
-};
-
-enum NeighborFlags {
-    kLeft_NeighborFlag        = 0x01,
-    kRight_NeighborFlag       = 0x02,
-    kTopLeft_NeighborFlag     = 0x04,
-    kTop_NeighborFlag         = 0x08,
-    kTopRight_NeighborFlag    = 0x10,
-    kBottomLeft_NeighborFlag  = 0x20,
-    kBottom_NeighborFlag      = 0x40,
-    kBottomRight_NeighborFlag = 0x80,
-    kAll_NeighborFlags        = 0xff,
-
-    kNeighborFlagCount        = 8
+    float*         fAlpha;      // alpha value of source texel
+    float*         fDistSq;     // distance squared to nearest (so far) edge texel
+    float*         fDistX;      // distance vector to nearest (so far) edge texel
+    float*         fDistY;
+    unsigned char* fEdges;      // 255 for edge texels, 0 otherwise
 };
 
 // We treat an "edge" as a place where we cross from >=128 to <128, or vice versa, or
 // where we have two non-zero pixels that are <128.
-// 'neighborFlags' is used to limit the directions in which we test to avoid indexing
-// outside of the image
-static bool found_edge(const unsigned char* imagePtr, int width, int neighborFlags) {
-    // the order of these should match the neighbor flags above
-    const int kNum8ConnectedNeighbors = 8;
-    const int offsets[8] = {-1, 1, -width-1, -width, -width+1, width-1, width, width+1 };
-    SkASSERT(kNum8ConnectedNeighbors == kNeighborFlagCount);
-
-    // search for an edge
-    unsigned char currVal = *imagePtr;
-    unsigned char currCheck = (currVal >> 7);
-    for (int i = 0; i < kNum8ConnectedNeighbors; ++i) {
-        unsigned char neighborVal;
-        if ((1 << i) & neighborFlags) {
-            const unsigned char* checkPtr = imagePtr + offsets[i];
-            neighborVal = *checkPtr;
-        } else {
-            neighborVal = 0;
+// 'image' must have a zero texel beyond each side of the row, and at least 16 readable bytes
+// past its end, so we look at 16 texels' 8-connected neighbors at a time without bounds checks.
+// Comparisons give 0x00 or 0xFF, so saturating adds are ors and mins are ands.
+static void find_edges(unsigned char* edges, const unsigned char* image, int width, int rowBytes) {
+    const Sk16b k127(127), kZero(0), kFF(0xFF);
+    auto inside  = [&](const unsigned char* p) { return k127 < Sk16b::Load(p); };
+    auto nonzero = [&](const unsigned char* p) { return kZero < Sk16b::Load(p); };
+
+    for (int i = 0; i < width; i += 16) {
+        const unsigned char* ptrs[8] = {
+            image - rowBytes - 1, image - rowBytes, image - rowBytes + 1, image - 1,
+            image + 1, image + rowBytes - 1, image + rowBytes, image + rowBytes + 1,
+        };
+        Sk16b anyInside(0), allInside(0xFF), anyNonzero(0);
+        for (const unsigned char* p : ptrs) {
+            anyInside  = anyInside.saturatedAdd(inside(p));
+            allInside  = Sk16b::Min(allInside, inside(p));
+            anyNonzero = anyNonzero.saturatedAdd(nonzero(p));
         }
-        unsigned char neighborCheck = (neighborVal >> 7);
-        SkASSERT(currCheck == 0 || currCheck == 1);
-        SkASSERT(neighborCheck == 0 || neighborCheck == 1);
-        // if sharp transition
-        if (currCheck != neighborCheck ||
-            // or both <128 and >0
-            (!currCheck && !neighborCheck && currVal && neighborVal)) {
-            return true;
+        // Inside texels are edges next to anything else, partially covered ones next to any
+        // coverage, and empty ones next to anything inside.
+        Sk16b edge = inside(image).thenElse(allInside < kFF,
+                                            nonzero(image).thenElse(anyNonzero, anyInside));
+        if (i + 16 <= width) {
+            edge.store(edges);
+        } else {
+            unsigned char tail[16];
+            edge.store(tail);
+            memcpy(edges, tail, width - i);
         }
+        image += 16;
+        edges += 16;
     }
-
-    return false;
 }
 
-static void init_glyph_data(DFData* data, unsigned char* edges, const unsigned char* image,
-                            int dataWidth, int dataHeight,
-                            int imageWidth, int imageHeight,
-                            int pad) {
-    data += pad*dataWidth;
-    data += pad;
-    edges += (pad*dataWidth + pad);
+static void init_glyph_data(DFData* data, const unsigned char* image, int imageRowBytes,
+                            int dataWidth, int imageWidth, int imageHeight, int pad) {
+    float*         alpha = data->fAlpha + pad*dataWidth + pad;
+    unsigned char* edges = data->fEdges + pad*dataWidth + pad;
 
     for (int j = 0; j < imageHeight; ++j) {
         for (int i = 0; i < imageWidth; ++i) {
-            if (255 == *image) {
-                data->fAlpha = 1.0f;
+            if (255 == image[i]) {
+                alpha[i] = 1.0f;
             } else {
-                data->fAlpha = (*image)*0.00392156862f;  // 1/255
-            }
-            int checkMask = kAll_NeighborFlags;
-            if (i == 0) {
-                checkMask &= ~(kLeft_NeighborFlag|kTopLeft_NeighborFlag|kBottomLeft_NeighborFlag);
-            }
-            if (i == imageWidth-1) {
-                checkMask &= ~(kRight_NeighborFlag|kTopRight_NeighborFlag|kBottomRight_NeighborFlag);
-            }
-            if (j == 0) {
-                checkMask &= ~(kTopLeft_NeighborFlag|kTop_NeighborFlag|kTopRight_NeighborFlag);
+                alpha[i] = image[i]*0.00392156862f;  // 1/255
             }
-            if (j == imageHeight-1) {
-                checkMask &= ~(kBottomLeft_NeighborFlag|kBottom_NeighborFlag|kBottomRight_NeighborFlag);
-            }
-            if (found_edge(image, imageWidth, checkMask)) {
-                *edges = 255;  // using 255 makes for convenient debug rendering
-            }
-            ++data;
-            ++image;
-            ++edges;
         }
-        data += 2*pad;
-        edges += 2*pad;
+        find_edges(edges, image, imageWidth, imageRowBytes);
+        alpha += dataWidth;
+        edges += dataWidth;
+        image += imageRowBytes;
     }
 }
 
@@ -145,15 +117,14 @@ static float edge_distance(const SkPoint& direction, float alpha) {
     return distance;
 }
 
-static void init_distances(DFData* data, unsigned char* edges, int width, int height) {
-    // skip one pixel border
-    DFData* currData = data;
-    DFData* prevData = data - width;
-    DFData* nextData = data + width;
-
+static void init_distances(DFData* data, int width, int height) {
     for (int j = 0; j < height; ++j) {
+        const int row = j*width;
+        const float* prevAlpha = data->fAlpha + row - width;
+        const float* currAlpha = data->fAlpha + row;
+        const float* nextAlpha = data->fAlpha + row + width;
         for (int i = 0; i < width; ++i) {
-            if (*edges) {
+            if (data->fEdges[row + i]) {
                 // we should not be in the one-pixel outside band
                 SkASSERT(i > 0 && i < width-1 && j > 0 && j < height-1);
                 // gradient will point from low to high
@@ -161,154 +132,160 @@ static void init_distances(DFData* data, unsigned char* edges, int width, int he
                 // i.e., if you're outside, gradient points towards edge
                 // if you're inside, gradient points away from edge
                 SkPoint currGrad;
-                currGrad.fX = (prevData+1)->fAlpha - (prevData-1)->fAlpha
-                             + SK_ScalarSqrt2*(currData+1)->fAlpha
-                             - SK_ScalarSqrt2*(currData-1)->fAlpha
-                             + (nextData+1)->fAlpha - (nextData-1)->fAlpha;
-                currGrad.fY = (nextData-1)->fAlpha - (prevData-1)->fAlpha
-                             + SK_ScalarSqrt2*nextData->fAlpha
-                             - SK_ScalarSqrt2*prevData->fAlpha
-                             + (nextData+1)->fAlpha - (prevData+1)->fAlpha;
+                currGrad.fX = prevAlpha[i+1] - prevAlpha[i-1]
+                             + SK_ScalarSqrt2*currAlpha[i+1]
+                             - SK_ScalarSqrt2*currAlpha[i-1]
+                             + nextAlpha[i+1] - nextAlpha[i-1];
+                currGrad.fY = nextAlpha[i-1] - prevAlpha[i-1]
+                             + SK_ScalarSqrt2*nextAlpha[i]
+                             - SK_ScalarSqrt2*prevAlpha[i]
+                             + nextAlpha[i+1] - prevAlpha[i+1];
                 currGrad.setLengthFast(1.0f);
 
                 // init squared distance to edge and distance vector
-                float dist = edge_distance(currGrad, currData->fAlpha);
-                currGrad.scale(dist, &currData->fDistVector);
-                currData->fDistSq = dist*dist;
+                float dist = edge_distance(currGrad, currAlpha[i]);
+                data->fDistX[row + i] = currGrad.fX * dist;
+                data->fDistY[row + i] = currGrad.fY * dist;
+                data->fDistSq[row + i] = dist*dist;
             } else {
                 // init distance to "far away"
-                currData->fDistSq = 2000000.f;
-                currData->fDistVector.fX = 1000.f;
-                currData->fDistVector.fY = 1000.f;
+                data->fDistSq[row + i] = 2000000.f;
+                data->fDistX[row + i] = 1000.f;
+                data->fDistY[row + i] = 1000.f;
             }
-            ++currData;
-            ++prevData;
-            ++nextData;
-            ++edges;
         }
     }
 }
 
 // Danielsson's 8SSEDT
-
-// first stage forward pass
-// (forward in Y, forward in X)
-static void F1(DFData* curr, int width) {
-    // upper left
-    DFData* check = curr - width-1;
-    SkPoint distVec = check->fDistVector;
-    float distSq = check->fDistSq - 2.0f*(distVec.fX + distVec.fY - 1.0f);
-    if (distSq < curr->fDistSq) {
-        distVec.fX -= 1.0f;
-        distVec.fY -= 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
-    }
-
-    // up
-    check = curr - width;
-    distVec = check->fDistVector;
-    distSq = check->fDistSq - 2.0f*distVec.fY + 1.0f;
-    if (distSq < curr->fDistSq) {
-        distVec.fY -= 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
-    }
-
-    // upper right
-    check = curr - width+1;
-    distVec = check->fDistVector;
-    distSq = check->fDistSq + 2.0f*(distVec.fX - distVec.fY + 1.0f);
-    if (distSq < curr->fDistSq) {
-        distVec.fX += 1.0f;
-        distVec.fY -= 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
-    }
-
-    // left
-    check = curr - 1;
-    distVec = check->fDistVector;
-    distSq = check->fDistSq - 2.0f*distVec.fX + 1.0f;
-    if (distSq < curr->fDistSq) {
-        distVec.fX -= 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
+//
+// Each row is swept forwards then backwards in x, first going down the image looking at the
+// upper left, upper, upper right and left neighbors, then the right one, and then going up the
+// image looking at the left neighbor, and then the right, lower left, lower and lower right ones.
+// A texel only takes a neighbor's distance if it's strictly closer, so ties go to the earlier.
+//
+// While we sweep a row the row above (or below) is already final, so we first pick the best of
+// those three neighbors for the whole row four texels at a time, leaving only the left and right
+// neighbors to the sequential sweeps.  These all do exactly the same math as testing each
+// neighbor in turn, so the results are too.
+
+// Picks, for texels [1, width-1) of row, the first closest of the three neighbors in the row dy
+// above (-1) or below (+1).  Reads up to 3 floats past the end of the neighboring row, and writes
+// up to 3 past width.
+template <int dy>
+static void best_neighbors_in_row(const DFData& data, int row, int width,
+                                  float* bestSq, float* bestX, float* bestY) {
+    const float* sq = data.fDistSq + row + dy*width;
+    const float*  x = data.fDistX  + row + dy*width;
+    const float*  y = data.fDistY  + row + dy*width;
+    for (int i = 1; i < width-1; i += 4) {
+        Sk4f cx = Sk4f::Load(x + i),
+             cy = Sk4f::Load(y + i);
+        // Below is the mirror image of above, so y adds where it subtracted and vice versa.
+        auto toward = [](const Sk4f& v, const Sk4f& y) { return dy < 0 ? v + y : v - y; };
+        auto away   = [](const Sk4f& v, const Sk4f& y) { return dy < 0 ? v - y : v + y; };
+
+        // diagonal to the left
+        Sk4f lx = Sk4f::Load(x + i-1),
+             ly = Sk4f::Load(y + i-1);
+        Sk4f sqBest = Sk4f::Load(sq + i-1) - 2.0f*(toward(lx, ly) - 1.0f),
+              xBest = lx - 1.0f,
+              yBest = ly + (float)dy;
+
+        // straight up or down
+        Sk4f sqCand = away(Sk4f::Load(sq + i), 2.0f*cy) + 1.0f;
+        Sk4f closer = sqCand < sqBest;
+        sqBest = closer.thenElse(sqCand, sqBest);
+         xBest = closer.thenElse(cx, xBest);
+         yBest = closer.thenElse(cy + (float)dy, yBest);
+
+        // diagonal to the right
+        Sk4f rx = Sk4f::Load(x + i+1),
+             ry = Sk4f::Load(y + i+1);
+        sqCand = Sk4f::Load(sq + i+1) + 2.0f*(away(rx, ry) + 1.0f);
+        closer = sqCand < sqBest;
+        sqBest = closer.thenElse(sqCand, sqBest);
+         xBest = closer.thenElse(rx + 1.0f, xBest);
+         yBest = closer.thenElse(ry + (float)dy, yBest);
+
+        sqBest.store(bestSq + i);
+         xBest.store(bestX + i);
+         yBest.store(bestY + i);
     }
 }
 
-// second stage forward pass
-// (forward in Y, backward in X)
-static void F2(DFData* curr, int width) {
-    // right
-    DFData* check = curr + 1;
-    float distSq = check->fDistSq;
-    SkPoint distVec = check->fDistVector;
-    distSq = check->fDistSq + 2.0f*distVec.fX + 1.0f;
-    if (distSq < curr->fDistSq) {
-        distVec.fX += 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
-    }
-}
+// The distance vector to the nearest (so far) edge texel, and its squared length.
+struct Dist {
+    float fSq, fX, fY;
 
-// first stage backward pass
-// (backward in Y, forward in X)
-static void B1(DFData* curr, int width) {
-    // left
-    DFData* check = curr - 1;
-    SkPoint distVec = check->fDistVector;
-    float distSq = check->fDistSq - 2.0f*distVec.fX + 1.0f;
-    if (distSq < curr->fDistSq) {
-        distVec.fX -= 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
+    void takeIfCloser(float sq, float x, float y) {
+        if (sq < fSq) {
+            fSq = sq;
+            fX = x;
+            fY = y;
+        }
     }
-}
+};
 
-// second stage backward pass
-// (backward in Y, backwards in X)
-static void B2(DFData* curr, int width) {
-    // right
-    DFData* check = curr + 1;
-    SkPoint distVec = check->fDistVector;
-    float distSq = check->fDistSq + 2.0f*distVec.fX + 1.0f;
-    if (distSq < curr->fDistSq) {
-        distVec.fX += 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
-    }
+enum BestNeighbors {
+    kBefore_BestNeighbors,  // check the best of the row above or below before the row neighbor
+    kAfter_BestNeighbors,   // check it after the row neighbor
+    kIgnore_BestNeighbors,
+};
 
-    // bottom left
-    check = curr + width-1;
-    distVec = check->fDistVector;
-    distSq = check->fDistSq - 2.0f*(distVec.fX - distVec.fY - 1.0f);
-    if (distSq < curr->fDistSq) {
-        distVec.fX -= 1.0f;
-        distVec.fY += 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
+// Sweeps texels [1, width-1) of row forwards (dx = +1) checking their left neighbors, or
+// backwards (dx = -1) checking their right ones.  The neighbor's distance is carried along
+// rather than read back from the texel we just wrote.
+template <int dx, BestNeighbors best>
+static void sweep_row(DFData* data, int row, int width,
+                      const float* bestSq, const float* bestX, const float* bestY) {
+    float* sq = data->fDistSq + row;
+    float*  x = data->fDistX  + row;
+    float*  y = data->fDistY  + row;
+    const unsigned char* edges = data->fEdges + row;
+
+    int i = dx > 0 ? 1 : width-2;
+    const int end = dx > 0 ? width-1 : 0;
+    Dist prev = { sq[i-dx], x[i-dx], y[i-dx] };
+    for (; i != end; i += dx) {
+        Dist curr = { sq[i], x[i], y[i] };
+        // don't need to calculate distance for edge pixels
+        if (!edges[i]) {
+            if (kBefore_BestNeighbors == best) {
+                curr.takeIfCloser(bestSq[i], bestX[i], bestY[i]);
+            }
+            if (dx > 0) {
+                curr.takeIfCloser(prev.fSq - 2.0f*prev.fX + 1.0f, prev.fX - 1.0f, prev.fY);
+            } else {
+                curr.takeIfCloser(prev.fSq + 2.0f*prev.fX + 1.0f, prev.fX + 1.0f, prev.fY);
+            }
+            if (kAfter_BestNeighbors == best) {
+                curr.takeIfCloser(bestSq[i], bestX[i], bestY[i]);
+            }
+            sq[i] = curr.fSq;
+             x[i] = curr.fX;
+             y[i] = curr.fY;
+        }
+        prev = curr;
     }
+}
 
-    // bottom
-    check = curr + width;
-    distVec = check->fDistVector;
-    distSq = check->fDistSq + 2.0f*distVec.fY + 1.0f;
-    if (distSq < curr->fDistSq) {
-        distVec.fY += 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
+static void propagate_distances(DFData* data, int width, int height,
+                                float* bestSq, float* bestX, float* bestY) {
+    // forwards in y
+    for (int j = 1; j < height-1; ++j) {
+        const int row = j*width;
+        best_neighbors_in_row<-1>(*data, row, width, bestSq, bestX, bestY);
+        sweep_row<+1, kBefore_BestNeighbors>(data, row, width, bestSq, bestX, bestY);
+        sweep_row<-1, kIgnore_BestNeighbors>(data, row, width, bestSq, bestX, bestY);
     }
 
-    // bottom right
-    check = curr + width+1;
-    distVec = check->fDistVector;
-    distSq = check->fDistSq + 2.0f*(distVec.fX + distVec.fY + 1.0f);
-    if (distSq < curr->fDistSq) {
-        distVec.fX += 1.0f;
-        distVec.fY += 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
+    // backwards in y
+    for (int j = height-2; j > 0; --j) {
+        const int row = j*width;
+        best_neighbors_in_row<+1>(*data, row, width, bestSq, bestX, bestY);
+        sweep_row<+1, kIgnore_BestNeighbors>(data, row, width, bestSq, bestX, bestY);
+        sweep_row<-1, kAfter_BestNeighbors>(data, row, width, bestSq, bestX, bestY);
     }
 }
 
@@ -331,10 +308,23 @@ static unsigned char pack_distance_field_val(float dist) {
     // (which represents zero).
     return (unsigned char)SkScalarRoundToInt(dist / (2 * distanceMagnitude) * 256.0f);
 }
+
+// The same as pack_distance_field_val() for four texels, taking their squared distances and
+// whether they're inside.  The packed values are never negative, so truncating rounds down.
+template <int distanceMagnitude>
+static Sk4b pack_distance_field_vals(const Sk4f& distSq, const Sk4f& inside) {
+    Sk4f dist = distSq.sqrt();
+    Sk4f negDist = inside.thenElse(dist, 0.0f - dist);
+    negDist = Sk4f::Min(Sk4f::Max(negDist, (float)-distanceMagnitude),
+                        distanceMagnitude * 127.0f / 128.0f);
+    negDist = negDist + distanceMagnitude;
+    return SkNx_cast<uint8_t>(negDist / (2 * distanceMagnitude) * 256.0f + 0.5f);
+}
 #endif
 
 // assumes a padded 8-bit image and distance field
 // width and height are the original width and height of the image
+// the image has two zero texels beyond each side, and 16 readable bytes past its end
 static bool generate_distance_field_from_image(unsigned char* distanceField,
                                                const unsigned char* copyPtr,
                                                int width, int height) {
@@ -349,116 +339,78 @@ static bool generate_distance_field_from_image(unsigned char* distanceField,
     int dataWidth = width + 2*pad;
     int dataHeight = height + 2*pad;
 
-    // create zeroed temp DFData+edge storage
-    SkAutoFree storage(sk_calloc_throw(dataWidth*dataHeight*(sizeof(DFData) + 1)));
-    DFData*        dataPtr = (DFData*)storage.get();
-    unsigned char* edgePtr = (unsigned char*)storage.get() + dataWidth*dataHeight*sizeof(DFData);
+    // create zeroed temp DFData+edge storage, and a row of best neighbors,
+    // with room to read or write a few floats past the end of each array
+    const int dataCount = dataWidth*dataHeight + 4;
+    const int bestCount = dataWidth + 4;
+    SkAutoFree storage(sk_calloc_throw((4*dataCount + 3*bestCount)*sizeof(float) + dataCount));
+    DFData data;
+    data.fAlpha  = (float*)storage.get();
+    data.fDistSq = data.fAlpha  + dataCount;
+    data.fDistX  = data.fDistSq + dataCount;
+    data.fDistY  = data.fDistX  + dataCount;
+    float* bestSq = data.fDistY + dataCount;
+    float* bestX  = bestSq + bestCount;
+    float* bestY  = bestX  + bestCount;
+    data.fEdges = (unsigned char*)(bestY + bestCount);
 
     // copy glyph into distance field storage
-    init_glyph_data(dataPtr, edgePtr, copyPtr,
-                    dataWidth, dataHeight,
-                    width+2, height+2, SK_DistanceFieldPad);
+    const int copyRowBytes = width + 4;
+    init_glyph_data(&data, copyPtr + copyRowBytes + 1, copyRowBytes,
+                    dataWidth, width+2, height+2, SK_DistanceFieldPad);
 
     // create initial distance data, particularly at edges
-    init_distances(dataPtr, edgePtr, dataWidth, dataHeight);
+    init_distances(&data, dataWidth, dataHeight);
 
     // now perform Euclidean distance transform to propagate distances
-
-    // forwards in y
-    DFData* currData = dataPtr+dataWidth+1; // skip outer buffer
-    unsigned char* currEdge = edgePtr+dataWidth+1;
-    for (int j = 1; j < dataHeight-1; ++j) {
-        // forwards in x
-        for (int i = 1; i < dataWidth-1; ++i) {
-            // don't need to calculate distance for edge pixels
-            if (!*currEdge) {
-                F1(currData, dataWidth);
-            }
-            ++currData;
-            ++currEdge;
-        }
-
-        // backwards in x
-        --currData; // reset to end
-        --currEdge;
-        for (int i = 1; i < dataWidth-1; ++i) {
-            // don't need to calculate distance for edge pixels
-            if (!*currEdge) {
-                F2(currData, dataWidth);
-            }
-            --currData;
-            --currEdge;
-        }
-
-        currData += dataWidth+1;
-        currEdge += dataWidth+1;
-    }
-
-    // backwards in y
-    currData = dataPtr+dataWidth*(dataHeight-2) - 1; // skip outer buffer
-    currEdge = edgePtr+dataWidth*(dataHeight-2) - 1;
-    for (int j = 1; j < dataHeight-1; ++j) {
-        // forwards in x
-        for (int i = 1; i < dataWidth-1; ++i) {
-            // don't need to calculate distance for edge pixels
-            if (!*currEdge) {
-                B1(currData, dataWidth);
-            }
-            ++currData;
-            ++currEdge;
-        }
-
-        // backwards in x
-        --currData; // reset to end
-        --currEdge;
-        for (int i = 1; i < dataWidth-1; ++i) {
-            // don't need to calculate distance for edge pixels
-            if (!*currEdge) {
-                B2(currData, dataWidth);
-            }
-            --currData;
-            --currEdge;
-        }
-
-        currData -= dataWidth-1;
-        currEdge -= dataWidth-1;
-    }
+    propagate_distances(&data, dataWidth, dataHeight, bestSq, bestX, bestY);
 
     // copy results to final distance field data
-    currData = dataPtr + dataWidth+1;
-    currEdge = edgePtr + dataWidth+1;
     unsigned char *dfPtr = distanceField;
     for (int j = 1; j < dataHeight-1; ++j) {
-        for (int i = 1; i < dataWidth-1; ++i) {
+        const int row = j*dataWidth;
+        int i = 1;
 #if DUMP_EDGE
-            float alpha = currData->fAlpha;
+        for (; i < dataWidth-1; ++i) {
+            float alpha = data.fAlpha[row + i];
             float edge = 0.0f;
-            if (*currEdge) {
+            if (data.fEdges[row + i]) {
                 edge = 0.25f;
             }
             // blend with original image
             float result = alpha + (1.0f-alpha)*edge;
             unsigned char val = sk_float_round2int(255*result);
             *dfPtr++ = val;
+        }
 #else
+        for (; i + 4 <= dataWidth-1; i += 4) {
+            Sk4f inside = Sk4f::Load(data.fAlpha + row + i) > 0.5f;
+            pack_distance_field_vals<SK_DistanceFieldMagnitude>(
+                    Sk4f::Load(data.fDistSq + row + i), inside).store(dfPtr);
+            dfPtr += 4;
+        }
+        for (; i < dataWidth-1; ++i) {
             float dist;
-            if (currData->fAlpha > 0.5f) {
-                dist = -SkScalarSqrt(currData->fDistSq);
+            if (data.fAlpha[row + i] > 0.5f) {
+                dist = -SkScalarSqrt(data.fDistSq[row + i]);
             } else {
-                dist = SkScalarSqrt(currData->fDistSq);
+                dist = SkScalarSqrt(data.fDistSq[row + i]);
             }
             *dfPtr++ = pack_distance_field_val<SK_DistanceFieldMagnitude>(dist);
-#endif
-            ++currData;
-            ++currEdge;
         }
-        currData += 2;
-        currEdge += 2;
+#endif
     }
 
     return true;
 }
 
+// The images we generate from are copied with two zero texels around them: one so we find the
+// edges at the outside of the glyph, and one more so we can look at all of those texels'
+// neighbors without bounds checks.  find_edges() also reads up to 16 bytes past the end.
+static size_t padded_copy_size(int width, int height) {
+    return (width + 4)*(height + 4) + 16;
+}
+
 // assumes an 8-bit image and distance field
 bool SkGenerateDistanceFieldFromA8Image(unsigned char* distanceField,
                                         const unsigned char* image,
@@ -467,22 +419,19 @@ bool SkGenerateDistanceFieldFromA8Image(unsigned char* distanceField,
     SkASSERT(image);
 
     // create temp data
-    SkAutoSMalloc<1024> copyStorage((width+2)*(height+2)*sizeof(char));
+    SkAutoSMalloc<1024> copyStorage(padded_copy_size(width, height));
     unsigned char* copyPtr = (unsigned char*) copyStorage.get();
+    sk_bzero(copyPtr, padded_copy_size(width, height));
 
     // we copy our source image into a padded copy to ensure we catch edge transitions
     // around the outside
     const unsigned char* currSrcScanLine = image;
-    sk_bzero(copyPtr, (width+2)*sizeof(char));
-    unsigned char* currDestPtr = copyPtr + width + 2;
+    unsigned char* currDestPtr = copyPtr + 2*(width + 4) + 2;
     for (int i = 0; i < height; ++i) {
-        *currDestPtr++ = 0;
-        memcpy(currDestPtr, currSrcScanLine, rowBytes);
+        memcpy(currDestPtr, currSrcScanLine, width);
         currSrcScanLine += rowBytes;
-        currDestPtr += width;
-        *currDestPtr++ = 0;
+        currDestPtr += width + 4;
     }
-    sk_bzero(currDestPtr, (width+2)*sizeof(char));
 
     return generate_distance_field_from_image(distanceField, copyPtr, width, height);
 }
@@ -495,16 +444,15 @@ bool SkGenerateDistanceFieldFromBWImage(unsigned char* distanceField,
     SkASSERT(image);
 
     // create temp data
-    SkAutoSMalloc<1024> copyStorage((width+2)*(height+2)*sizeof(char));
+    SkAutoSMalloc<1024> copyStorage(padded_copy_size(width, height));
     unsigned char* copyPtr = (unsigned char*) copyStorage.get();
+    sk_bzero(copyPtr, padded_copy_size(width, height));
 
     // we copy our source image into a padded copy to ensure we catch edge transitions
     // around the outside
     const unsigned char* currSrcScanLine = image;
-    sk_bzero(copyPtr, (width+2)*sizeof(char));
-    unsigned char* currDestPtr = copyPtr + width + 2;
+    unsigned char* currDestPtr = copyPtr + 2*(width + 4) + 2;
     for (int i = 0; i < height; ++i) {
-        *currDestPtr++ = 0;
         int rowWritesLeft = width;
         const unsigned char *maskPtr = currSrcScanLine;
         while (rowWritesLeft > 0) {
@@ -514,9 +462,8 @@ bool SkGenerateDistanceFieldFromBWImage(unsigned char* distanceField,
             }
         }
         currSrcScanLine += rowBytes;
-        *currDestPtr++ = 0;
+        currDestPtr += 4;
     }
-    sk_bzero(currDestPtr, (width+2)*sizeof(char));
 
     return generate_distance_field_from_image(distanceField, copyPtr, width, height);
 }
@@ -1016,7 +1016,8 @@ SkScalar SkDraw::ComputeResScaleForStroking(const SkMatrix& matrix) {
 }
 
 void SkDraw::drawDevPath(const SkPath& devPath, const SkPaint& paint, bool drawCoverage,
-                         SkBlitter* customBlitter, bool doFill) const {
+                         SkBlitter* customBlitter, bool doFill,
+                         const SkScanPathID* pathID) const {
     SkBlitter* blitter = nullptr;
     SkAutoBlitterChoose blitterStorage;
     if (nullptr == customBlitter) {
@@ -1029,11 +1030,16 @@ void SkDraw::drawDevPath(const SkPath& devPath, const SkPaint& paint, bool drawC
     if (paint.getMaskFilter()) {
         SkStrokeRec::InitStyle style = doFill ? SkStrokeRec::kFill_InitStyle
         : SkStrokeRec::kHairline_InitStyle;
-        if (paint.getMaskFilter()->filterPath(devPath, *fMatrix, *fRC, blitter, style)) {
+        if (paint.getMaskFilter()->filterPath(devPath, *fMatrix, *fRC, blitter, style, pathID)) {
             return; // filterPath() called the blitter, so we're done
         }
     }
 
+    if (doFill && paint.isAntiAlias() && pathID) {
+        SkScan::AntiFillPath(devPath, *fRC, blitter, pathID);
+        return;
+    }
+
     void (*proc)(const SkPath&, const SkRasterClip&, SkBlitter*);
     if (doFill) {
         if (paint.isAntiAlias()) {
@@ -1161,13 +1167,23 @@ void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
         return;
     }
 
+    // If we're filling the caller's own persistent path, name it so its edges can be cached.
+    SkScanPathID pathID, *pathIDPtr = nullptr;
+    if (pathPtr == &origSrcPath && !pathIsMutable && !origSrcPath.isVolatile()) {
+        pathID.fGenID  = origSrcPath.getGenerationID();
+        pathID.fMatrix = *matrix;
+        pathID.fFillType = origSrcPath.getFillType();
+        pathID.fPath = &origSrcPath;
+        pathIDPtr = &pathID;
+    }
+
     // avoid possibly allocating a new path in transform if we can
     SkPath* devPathPtr = pathIsMutable ? pathPtr : &tmpPath;
 
     // transform the path into device space
     pathPtr->transform(*matrix, devPathPtr);
 
-    this->drawDevPath(*devPathPtr, *paint, drawCoverage, customBlitter, doFill);
+    this->drawDevPath(*devPathPtr, *paint, drawCoverage, customBlitter, doFill, pathIDPtr);
 }
 
 void SkDraw::drawBitmapAsMask(const SkBitmap& bitmap, const SkPaint& paint) const {
@@ -1719,7 +1735,9 @@ public:
         bool setup(const SkPoint pts[], const SkColor colors[], int, int, int);
 
         SkMatrix    fDstToUnit;
+        SkMatrix    fCTMInv;        // Computed once, used by every triangle.
         SkPMColor   fColors[3];
+        bool fCTMInvertible;
         bool fSetup;
 
         typedef SkShader::Context INHERITED;
@@ -1773,22 +1791,17 @@ bool SkTriColorShader::TriColorShaderContext::setup(const SkPoint pts[], const S
     m.set(3, pts[index1].fY - pts[index0].fY);
     m.set(4, pts[index2].fY - pts[index0].fY);
     m.set(5, pts[index0].fY);
-    if (!m.invert(&im)) {
-        return false;
-    }
-    // We can't call getTotalInverse(), because we explicitly don't want to look at the localmatrix
-    // as our interators are intrinsically tied to the vertices, and nothing else.
-    SkMatrix ctmInv;
-    if (!this->getCTM().invert(&ctmInv)) {
+    if (!fCTMInvertible || !m.invert(&im)) {
         return false;
     }
     // TODO replace INV(m) * INV(ctm) with INV(ctm * m)
-    fDstToUnit.setConcat(im, ctmInv);
+    fDstToUnit.setConcat(im, fCTMInv);
     return true;
 }
 
 #include "SkColorPriv.h"
 #include "SkComposeShader.h"
+#include "SkNx.h"
 
 static int ScalarTo256(SkScalar v) {
     return static_cast<int>(SkScalarPin(v, 0, 1) * 256 + 0.5);
@@ -1801,7 +1814,11 @@ SkTriColorShader::SkTriColorShader()
 SkTriColorShader::TriColorShaderContext::TriColorShaderContext(const SkTriColorShader& shader,
                                                                const ContextRec& rec)
     : INHERITED(shader, rec)
-    , fSetup(false) {}
+    , fSetup(false) {
+    // We can't call getTotalInverse(), because we explicitly don't want to look at the localmatrix
+    // as our interators are intrinsically tied to the vertices, and nothing else.
+    fCTMInvertible = this->getCTM().invert(&fCTMInv);
+}
 
 SkTriColorShader::TriColorShaderContext::~TriColorShaderContext() {}
 
@@ -1823,14 +1840,7 @@ void SkTriColorShader::TriColorShaderContext::shadeSpan(int x, int y, SkPMColor
 
     const int alphaScale = Sk255To256(this->getPaintAlpha());
 
-    SkPoint src;
-
-    for (int i = 0; i < count; i++) {
-        fDstToUnit.mapXY(SkIntToScalar(x), SkIntToScalar(y), &src);
-        x += 1;
-
-        int scale1 = ScalarTo256(src.fX);
-        int scale2 = ScalarTo256(src.fY);
+    auto shade = [&](int i, int scale1, int scale2) {
         int scale0 = 256 - scale1 - scale2;
         if (scale0 < 0) {
             if (scale1 > scale2) {
@@ -1850,6 +1860,40 @@ void SkTriColorShader::TriColorShaderContext::shadeSpan(int x, int y, SkPMColor
         dstC[i] = SkAlphaMulQ(fColors[0], scale0) +
                   SkAlphaMulQ(fColors[1], scale1) +
                   SkAlphaMulQ(fColors[2], scale2);
+    };
+
+    int i = 0;
+    if (!fDstToUnit.hasPerspective()) {
+        // Map 4 pixels at a time, with the same arithmetic as SkMatrix::mapXY().
+        const SkMatrix& m = fDstToUnit;
+        const SkScalar fy = SkIntToScalar(y);
+        const Sk4f sx(m.getScaleX()), rowX(fy * m.getSkewX()  + m.getTranslateX()),
+                   ky(m.getSkewY()),  rowY(fy * m.getScaleY() + m.getTranslateY());
+        // ScalarTo256(), which rounds in double.  Rounding the fraction separately is just as exact.
+        auto to256 = [](const Sk4f& v) {
+            Sk4f scaled = Sk4f::Max(Sk4f::Min(v, 1), 0) * 256,
+                 whole  = SkNx_cast<float>(SkNx_cast<int>(scaled));
+            return SkNx_cast<int>(whole + (scaled - whole >= 0.5f).thenElse(1, 0));
+        };
+
+        Sk4f fx = Sk4f(0, 1, 2, 3) + SkIntToScalar(x);
+        int32_t scale1[4], scale2[4];
+        for (; i + 4 <= count; i += 4) {
+            to256(fx * sx + rowX).store(scale1);
+            to256(fx * ky + rowY).store(scale2);
+            for (int j = 0; j < 4; j++) {
+                shade(i + j, scale1[j], scale2[j]);
+            }
+            fx = fx + 4;
+        }
+        x += i;
+    }
+
+    SkPoint src;
+    for (; i < count; i++) {
+        fDstToUnit.mapXY(SkIntToScalar(x), SkIntToScalar(y), &src);
+        x += 1;
+        shade(i, ScalarTo256(src.fX), ScalarTo256(src.fY));
     }
 }
 
@@ -1932,15 +1976,23 @@ void SkDraw::drawVertices(SkCanvas::VertexMode vmode, int count,
     if (textures || colors) {
         SkTriColorShader::TriColorShaderData verticesSetup = { vertices, colors, &state };
 
+        // Meshes usually map their texture the same way across neighboring triangles (always,
+        // for the two halves of a quad), so we only remake the shader context when it changes.
+        SkMatrix contextM;
+        bool     haveContextM = false;
+
         while (vertProc(&state)) {
             if (textures) {
                 SkMatrix tempM;
-                if (texture_to_matrix(state, vertices, textures, &tempM)) {
+                if (texture_to_matrix(state, vertices, textures, &tempM) &&
+                    !(haveContextM && tempM == contextM)) {
                     SkShader::ContextRec rec(p, *fMatrix, &tempM,
                                              SkBlitter::PreferredShaderDest(fDst.info()));
-                    if (!blitter->resetShaderContext(rec)) {
+                    haveContextM = blitter->resetShaderContext(rec);
+                    if (!haveContextM) {
                         continue;
                     }
+                    contextM = tempM;
                 }
             }
             if (colors) {
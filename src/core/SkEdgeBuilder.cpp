@@ -139,12 +139,53 @@ SkEdgeBuilder::Combine SkEdgeBuilder::checkVertical(const SkEdge* edge, SkEdge**
             CombineVertical(edge, edgePtr[-1]);
 }
 
-int SkEdgeBuilder::buildPoly(const SkPath& path, const SkIRect* iclip, int shiftUp,
-                             bool canCullToTheRight) {
-    SkPath::Iter    iter(path, true);
-    SkPoint         pts[4];
+// Calls addLine() with each line of a line-only path, closing every contour the way
+// SkPath::Iter(path, true) would. The lines are read in runs, straight out of the path.
+template <typename AddLine>
+static void for_each_closed_line(const SkPath& path, AddLine addLine) {
+    SkPath::RawIter iter(path);
+    const SkPoint*  pts;
+    int             count;
     SkPath::Verb    verb;
+    SkPoint         moveTo = SkPoint::Make(0, 0);
+    const SkPoint*  lastPt = nullptr;   // only set once the contour has a line
 
+    auto closeContour = [&]() {
+        // Like SkPath::Iter, skip the closing line if either end is NaN.
+        if (lastPt && *lastPt != moveTo &&
+            !SkScalarIsNaN(lastPt->fX) && !SkScalarIsNaN(lastPt->fY) &&
+            !SkScalarIsNaN(moveTo.fX) && !SkScalarIsNaN(moveTo.fY)) {
+            const SkPoint line[2] = { *lastPt, moveTo };
+            addLine(line);
+        }
+        lastPt = nullptr;
+    };
+
+    while ((verb = iter.nextRun(&pts, &count)) != SkPath::kDone_Verb) {
+        switch (verb) {
+            case SkPath::kMove_Verb:
+                closeContour();
+                moveTo = pts[0];
+                break;
+            case SkPath::kClose_Verb:
+                closeContour();
+                break;
+            case SkPath::kLine_Verb:
+                for (int i = 0; i < count; i++) {
+                    addLine(&pts[i]);
+                }
+                lastPt = &pts[count];
+                break;
+            default:
+                SkDEBUGFAIL("unexpected verb");
+                break;
+        }
+    }
+    closeContour();
+}
+
+int SkEdgeBuilder::buildPoly(const SkPath& path, const SkIRect* iclip, int shiftUp,
+                             bool canCullToTheRight) {
     int maxEdgeCount = path.countPoints();
     if (iclip) {
         // clipping can turn 1 line into (up to) kMaxClippedLineSegments, since
@@ -162,61 +203,33 @@ int SkEdgeBuilder::buildPoly(const SkPath& path, const SkIRect* iclip, int shift
     // Record the beginning of our pointers, so we can return them to the caller
     fEdgeList = edgePtr;
 
+    auto addEdge = [&](const SkPoint& p0, const SkPoint& p1) {
+        if (edge->setLine(p0, p1, shiftUp)) {
+            Combine combine = checkVertical(edge, edgePtr);
+            if (kNo_Combine == combine) {
+                *edgePtr++ = edge++;
+            } else if (kTotal_Combine == combine) {
+                --edgePtr;
+            }
+        }
+    };
+
     if (iclip) {
         SkRect clip;
         setShiftedClip(&clip, *iclip, shiftUp);
 
-        while ((verb = iter.next(pts, false)) != SkPath::kDone_Verb) {
-            switch (verb) {
-                case SkPath::kMove_Verb:
-                case SkPath::kClose_Verb:
-                    // we ignore these, and just get the whole segment from
-                    // the corresponding line/quad/cubic verbs
-                    break;
-                case SkPath::kLine_Verb: {
-                    SkPoint lines[SkLineClipper::kMaxPoints];
-                    int lineCount = SkLineClipper::ClipLine(pts, clip, lines, canCullToTheRight);
-                    SkASSERT(lineCount <= SkLineClipper::kMaxClippedLineSegments);
-                    for (int i = 0; i < lineCount; i++) {
-                        if (edge->setLine(lines[i], lines[i + 1], shiftUp)) {
-                            Combine combine = checkVertical(edge, edgePtr);
-                            if (kNo_Combine == combine) {
-                                *edgePtr++ = edge++;
-                            } else if (kTotal_Combine == combine) {
-                                --edgePtr;
-                            }
-                        }
-                    }
-                    break;
-                }
-                default:
-                    SkDEBUGFAIL("unexpected verb");
-                    break;
+        for_each_closed_line(path, [&](const SkPoint pts[2]) {
+            SkPoint lines[SkLineClipper::kMaxPoints];
+            int lineCount = SkLineClipper::ClipLine(pts, clip, lines, canCullToTheRight);
+            SkASSERT(lineCount <= SkLineClipper::kMaxClippedLineSegments);
+            for (int i = 0; i < lineCount; i++) {
+                addEdge(lines[i], lines[i + 1]);
             }
-        }
+        });
     } else {
-        while ((verb = iter.next(pts, false)) != SkPath::kDone_Verb) {
-            switch (verb) {
-                case SkPath::kMove_Verb:
-                case SkPath::kClose_Verb:
-                    // we ignore these, and just get the whole segment from
-                    // the corresponding line/quad/cubic verbs
-                    break;
-                case SkPath::kLine_Verb:
-                    if (edge->setLine(pts[0], pts[1], shiftUp)) {
-                        Combine combine = checkVertical(edge, edgePtr);
-                        if (kNo_Combine == combine) {
-                            *edgePtr++ = edge++;
-                        } else if (kTotal_Combine == combine) {
-                            --edgePtr;
-                        }
-                    }
-                    break;
-                default:
-                    SkDEBUGFAIL("unexpected verb");
-                    break;
-            }
-        }
+        for_each_closed_line(path, [&](const SkPoint pts[2]) {
+            addEdge(pts[0], pts[1]);
+        });
     }
     SkASSERT((char*)edge <= (char*)fEdgeList);
     SkASSERT(edgePtr - fEdgeList <= maxEdgeCount);
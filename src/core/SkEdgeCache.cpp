@@ -0,0 +1,153 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkEdge.h"
+#include "SkEdgeCache.h"
+#include "SkMutex.h"
+#include "SkPath.h"
+#include "SkPathPriv.h"
+#include "SkResourceCache.h"
+
+#define CHECK_LOCAL(localCache, localName, globalName, ...) \
+    ((localCache) ? localCache->localName(__VA_ARGS__) : SkResourceCache::globalName(__VA_ARGS__))
+
+// Edges are quads or cubics only while they still have curve steps to take.  Once fCurveCount
+// reaches 0 they're walked as lines, so we need not copy (or keep) their curve fields.
+static size_t edge_size(const SkEdge* edge) {
+    if (edge->fCurveCount > 0) {
+        return sizeof(SkQuadraticEdge);
+    }
+    if (edge->fCurveCount < 0) {
+        return sizeof(SkCubicEdge);
+    }
+    return sizeof(SkEdge);
+}
+
+// Edge lists share the generation ID of their path, tagged to keep it apart from bitmaps'.
+static uint64_t shared_id_for_path(uint32_t genID) {
+    uint64_t sharedID = SkSetFourByteTag('p', 'a', 't', 'h');
+    return (sharedID << 32) | genID;
+}
+
+namespace {
+static unsigned gEdgeListKeyNamespaceLabel;
+
+struct EdgeListKey : public SkResourceCache::Key {
+public:
+    EdgeListKey(const SkScanPathID& id, const SkIRect* clip, int shiftUp, bool clipToTheRight)
+        : fGenID(id.fGenID)
+        , fClip(clip ? *clip : SkIRect::MakeEmpty())
+        , fFlags((shiftUp << 2) | (clip ? 2 : 0) | (clipToTheRight ? 1 : 0))
+    {
+        id.fMatrix.get9(fMatrix);
+        this->init(&gEdgeListKeyNamespaceLabel, shared_id_for_path(id.fGenID),
+                   sizeof(fGenID) + sizeof(fMatrix) + sizeof(fClip) + sizeof(fFlags));
+    }
+
+    uint32_t fGenID;
+    SkScalar fMatrix[9];
+    SkIRect  fClip;
+    int32_t  fFlags;
+};
+
+struct EdgeListRec : public SkResourceCache::Rec {
+    EdgeListRec(const EdgeListKey& key, SkEdge* const sorted[], int count)
+        : fKey(key)
+        , fCount(count)
+    {
+        size_t bytes = 0;
+        for (int i = 0; i < count; i++) {
+            bytes += edge_size(sorted[i]);
+        }
+        fBytes = bytes;
+        fStorage.reset(bytes);
+
+        char* dst = fStorage.get();
+        for (int i = 0; i < count; i++) {
+            size_t size = edge_size(sorted[i]);
+            memcpy(dst, sorted[i], size);
+            dst += size;
+        }
+    }
+
+    EdgeListKey         fKey;
+    SkAutoTMalloc<char> fStorage;   // fCount edges, back to back, in sorted order.
+    size_t              fBytes;
+    int                 fCount;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fBytes; }
+    const char* getCategory() const override { return "edge-list"; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const EdgeListRec& rec = static_cast<const EdgeListRec&>(baseRec);
+        SkEdgeCache::Edges* edges = (SkEdgeCache::Edges*)contextData;
+        edges->reset(rec.fStorage.get(), rec.fBytes, rec.fCount);
+        return true;
+    }
+};
+
+// When the path's generation ID changes, purge the edge lists built for it.
+class EdgeListInvalidator : public SkPathRef::GenIDChangeListener {
+public:
+    explicit EdgeListInvalidator(uint32_t genID) : fGenID(genID) {}
+private:
+    uint32_t fGenID;
+
+    void onChange() override {
+        SkResourceCache::PostPurgeSharedID(shared_id_for_path(fGenID));
+    }
+};
+} // namespace
+
+// Threads may fill the same path at once, and SkPathRef doesn't guard its listeners.
+SK_DECLARE_STATIC_MUTEX(gInvalidatorMutex);
+
+void SkEdgeCache::Edges::reset(const void* edges, size_t bytes, int count) {
+    fStorage.reset(bytes);
+    memcpy(fStorage.get(), edges, bytes);
+
+    SkEdge* prev = nullptr;
+    char* ptr = fStorage.get();
+    for (int i = 0; i < count; i++) {
+        SkEdge* edge = (SkEdge*)ptr;
+        edge->fPrev = prev;
+        edge->fNext = nullptr;
+        if (prev) {
+            prev->fNext = edge;
+        } else {
+            fFirst = edge;
+        }
+        prev = edge;
+        ptr += edge_size(edge);
+    }
+    fLast  = prev;
+    fCount = count;
+}
+
+bool SkEdgeCache::ShouldCache(const SkPath& path) {
+    return path.countVerbs() >= kMinVerbs;
+}
+
+bool SkEdgeCache::Find(const SkScanPathID& id, const SkIRect* clip, int shiftUp,
+                       bool clipToTheRight, Edges* edges, SkResourceCache* localCache) {
+    EdgeListKey key(id, clip, shiftUp, clipToTheRight);
+    return CHECK_LOCAL(localCache, find, Find, key, EdgeListRec::Visitor, edges);
+}
+
+void SkEdgeCache::Add(const SkScanPathID& id, const SkIRect* clip, int shiftUp,
+                      bool clipToTheRight, SkEdge* const sorted[], int count,
+                      SkResourceCache* localCache) {
+    SkASSERT(count > 0);
+    EdgeListKey key(id, clip, shiftUp, clipToTheRight);
+    CHECK_LOCAL(localCache, add, Add, new EdgeListRec(key, sorted, count));
+
+    if (id.fPath) {
+        SkAutoMutexAcquire lock(gInvalidatorMutex);
+        SkPathPriv::AddGenIDChangeListener(*id.fPath, new EdgeListInvalidator(id.fGenID));
+    }
+}
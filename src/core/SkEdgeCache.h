@@ -0,0 +1,81 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkEdgeCache_DEFINED
+#define SkEdgeCache_DEFINED
+
+#include "SkRect.h"
+#include "SkScan.h"
+#include "SkTemplates.h"
+
+class SkPath;
+class SkResourceCache;
+struct SkEdge;
+
+/**
+ *  Caches the sorted edge lists SkEdgeBuilder builds for device-space paths, so filling the same
+ *  path under the same matrix and clip again can skip building and sorting its edges.
+ *
+ *  Entries are keyed by the SkScanPathID naming the path, the (shifted) clip rect the edges were
+ *  clipped to (or none), the shift, and whether edges right of the clip were culled.
+ *
+ *  Only fills of paths that pass ShouldCache() use the cache.  When the SkScanPathID names the
+ *  path itself, its edge lists are purged as soon as its generation ID changes.
+ */
+class SkEdgeCache {
+public:
+    /**
+     *  Paths with fewer verbs than this are not cached.  Their edges are built and sorted about as
+     *  fast as they are found and copied out of the cache, and each entry would push other
+     *  resources out of SkResourceCache for no gain.
+     */
+    static const int kMinVerbs = 16;
+
+    /**
+     *  Whether the edges of path, already named by an SkScanPathID, are worth caching: it must
+     *  have at least kMinVerbs verbs.
+     */
+    static bool ShouldCache(const SkPath& path);
+
+    /**
+     *  A private, writable copy of a cached edge list, sorted and linked through fNext/fPrev.
+     *  The edges live as long as this Edges does.
+     */
+    class Edges {
+    public:
+        Edges() : fCount(0), fFirst(nullptr), fLast(nullptr) {}
+
+        int     count() const { return fCount; }
+        SkEdge* first() const { return fFirst; }
+        SkEdge* last()  const { return fLast; }
+
+        /** Copy count edges stored back to back in sorted order, then link the copies. */
+        void reset(const void* edges, size_t bytes, int count);
+
+    private:
+        SkAutoTMalloc<char> fStorage;
+        int                 fCount;
+        SkEdge*             fFirst;
+        SkEdge*             fLast;
+    };
+
+    /**
+     *  On success, copy the cached edges into edges and return true.
+     *  On failure, return false and leave edges untouched.
+     */
+    static bool Find(const SkScanPathID&, const SkIRect* clip, int shiftUp, bool clipToTheRight,
+                     Edges* edges, SkResourceCache* localCache = nullptr);
+
+    /**
+     *  Add a snapshot of count freshly built edges, in sorted order, to the cache.
+     *  Must be called before the edges are walked, as walking modifies them.
+     */
+    static void Add(const SkScanPathID&, const SkIRect* clip, int shiftUp, bool clipToTheRight,
+                    SkEdge* const sorted[], int count, SkResourceCache* localCache = nullptr);
+};
+
+#endif
@@ -58,12 +58,34 @@ struct Entry {
 
 static int gCount = 0;
 static Entry gEntries[MAX_ENTRY_COUNT];
+// Indices into gEntries, sorted by name. Among equal names the latest registered comes first,
+// so that it overrides the earlier ones.
+static uint16_t gNameOrder[MAX_ENTRY_COUNT];
+
+// Returns the first position in gNameOrder whose name is not less than name.
+static int lower_bound_name(const char name[]) {
+    int lo = 0;
+    int hi = gCount;
+    while (lo < hi) {
+        int mid = (lo + hi) >> 1;
+        if (strcmp(gEntries[gNameOrder[mid]].fName, name) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
 
 void SkFlattenable::Register(const char name[], Factory factory, SkFlattenable::Type type) {
     SkASSERT(name);
     SkASSERT(factory);
     SkASSERT(gCount < MAX_ENTRY_COUNT);
 
+    int pos = lower_bound_name(name);
+    memmove(&gNameOrder[pos + 1], &gNameOrder[pos], (gCount - pos) * sizeof(gNameOrder[0]));
+    gNameOrder[pos] = SkToU16(gCount);
+
     gEntries[gCount].fName = name;
     gEntries[gCount].fFactory = factory;
     gEntries[gCount].fType = type;
@@ -80,18 +102,21 @@ static void report_no_entries(const char* functionName) {
 }
 #endif
 
+static const Entry* find_entry(const char name[]) {
+    int pos = lower_bound_name(name);
+    if (pos < gCount && strcmp(gEntries[gNameOrder[pos]].fName, name) == 0) {
+        return &gEntries[gNameOrder[pos]];
+    }
+    return nullptr;
+}
+
 SkFlattenable::Factory SkFlattenable::NameToFactory(const char name[]) {
     InitializeFlattenablesIfNeeded();
 #ifdef SK_DEBUG
     report_no_entries(__FUNCTION__);
 #endif
-    const Entry* entries = gEntries;
-    for (int i = gCount - 1; i >= 0; --i) {
-        if (strcmp(entries[i].fName, name) == 0) {
-            return entries[i].fFactory;
-        }
-    }
-    return nullptr;
+    const Entry* entry = find_entry(name);
+    return entry ? entry->fFactory : nullptr;
 }
 
 bool SkFlattenable::NameToType(const char name[], SkFlattenable::Type* type) {
@@ -100,12 +125,10 @@ bool SkFlattenable::NameToType(const char name[], SkFlattenable::Type* type) {
 #ifdef SK_DEBUG
     report_no_entries(__FUNCTION__);
 #endif
-    const Entry* entries = gEntries;
-    for (int i = gCount - 1; i >= 0; --i) {
-        if (strcmp(entries[i].fName, name) == 0) {
-            *type = entries[i].fType;
-            return true;
-        }
+    const Entry* entry = find_entry(name);
+    if (entry) {
+        *type = entry->fType;
+        return true;
     }
     return false;
 }
@@ -110,6 +110,11 @@ public:
         return ID2Code(fID);
     }
 
+    /** Returns the glyph ID combined with its subpixel position, as the strike keys it. */
+    uint32_t getPackedID() const {
+        return fID;
+    }
+
     unsigned getSubX() const {
         return ID2SubX(fID);
     }
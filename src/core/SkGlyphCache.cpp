@@ -10,7 +10,12 @@
 #include "SkGraphics.h"
 #include "SkOnce.h"
 #include "SkPath.h"
+#include "SkReader32.h"
+#include "SkStream.h"
+#include "SkTLS.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
+#include "SkTime.h"
 #include "SkTraceMemoryDump.h"
 #include "SkTypeface.h"
 
@@ -33,6 +38,113 @@ static SkGlyphCache_Globals& get_globals() {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+namespace {
+
+// Each thread keeps the few caches it used most recently to itself, so drawing text over and over
+// in the same few fonts doesn't touch the global lock at all.  These caches are out of the global
+// list, just like caches that are in use, so they don't count against the global budget.  To keep
+// that honest, we hand them all back every so often, and when the thread exits.
+class ThreadCaches {
+public:
+    static const int kMaxCount = SK_DEFAULT_FONT_CACHE_THREAD_COUNT_LIMIT;
+
+    // How many attach()es between returning everything to the global list.
+    static const int kReturnInterval = 256;
+
+    // The calling thread's ThreadCaches.
+    static ThreadCaches* Get() {
+        ThreadCaches* caches = (ThreadCaches*)SkTLS::Get(Create, Delete);
+        caches->checkPurgeGeneration();
+        return caches;
+    }
+
+    // Frees the calling thread's caches, if it has any.
+    static void PurgeCurrentThread() {
+        if (ThreadCaches* caches = (ThreadCaches*)SkTLS::Find(Create)) {
+            caches->deleteAll();
+        }
+    }
+
+    // Returns our cache matching desc, no longer ours, or nullptr if we have none.
+    SkGlyphCache* detach(const SkDescriptor& desc) {
+        for (int i = fCount - 1; i >= 0; i--) {
+            if (fCaches[i]->getDescriptor() == desc) {
+                SkGlyphCache* cache = fCaches[i];
+                memmove(&fCaches[i], &fCaches[i + 1], (fCount - i - 1) * sizeof(fCaches[0]));
+                fCount -= 1;
+                return cache;
+            }
+        }
+        return nullptr;
+    }
+
+    void attach(SkGlyphCache* cache) {
+        if (fCount == kMaxCount) {
+            // Batch up returns: give back the older half of our caches under one lock.
+            this->returnOldest((kMaxCount + 1) / 2);
+        }
+        fCaches[fCount++] = cache;
+
+        if (++fAttachCount == kReturnInterval) {
+            this->returnOldest(fCount);
+        }
+    }
+
+private:
+    static void* Create() {
+        ThreadCaches* caches = new ThreadCaches;
+        caches->fCount = 0;
+        caches->fAttachCount = 0;
+        caches->fPurgeGeneration = get_globals().fPurgeGeneration.load(sk_memory_order_relaxed);
+        return caches;
+    }
+
+    static void Delete(void* ptr) {
+        ThreadCaches* caches = (ThreadCaches*)ptr;
+        caches->returnOldest(caches->fCount);
+        delete caches;
+    }
+
+    void checkPurgeGeneration() {
+        int32_t generation = get_globals().fPurgeGeneration.load(sk_memory_order_relaxed);
+        if (generation != fPurgeGeneration) {
+            // Someone called purgeAll() since we last looked.
+            this->deleteAll();
+            fPurgeGeneration = generation;
+        }
+    }
+
+    void deleteAll() {
+        SkGlyphCache_Globals::DeleteCaches(fCaches, fCount);
+        fCount = 0;
+    }
+
+    void returnOldest(int n) {
+        SkASSERT(n <= fCount);
+        if (n > 0) {
+            get_globals().attachCachesToHead(fCaches, n);
+            memmove(&fCaches[0], &fCaches[n], (fCount - n) * sizeof(fCaches[0]));
+            fCount -= n;
+        }
+        fAttachCount = 0;
+    }
+
+    // Least recently used first.
+    SkGlyphCache* fCaches[kMaxCount];
+    int           fCount;
+    int           fAttachCount;
+    int32_t       fPurgeGeneration;
+};
+
+}  // namespace
+
+static void purge_all_caches(SkGlyphCache_Globals& globals) {
+    ThreadCaches::PurgeCurrentThread();
+    globals.purgeAll();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 // so we don't grow our arrays a lot
 #define kMinGlyphCount      16
 #define kMinGlyphImageSize  (16*2)
@@ -91,13 +203,14 @@ SkGlyphCache::CharGlyphRec* SkGlyphCache::getCharGlyphRec(PackedUnicharID packed
 uint16_t SkGlyphCache::unicharToGlyph(SkUnichar charCode) {
     VALIDATE();
     PackedUnicharID packedUnicharID = SkGlyph::MakeID(charCode);
-    const CharGlyphRec& rec = *this->getCharGlyphRec(packedUnicharID);
+    CharGlyphRec& rec = *this->getCharGlyphRec(packedUnicharID);
 
-    if (rec.fPackedUnicharID == packedUnicharID) {
-        return SkGlyph::ID2Code(rec.fPackedGlyphID);
-    } else {
-        return fScalerContext->charToGlyphID(charCode);
+    if (rec.fPackedUnicharID != packedUnicharID) {
+        // Remember the mapping; lookupByChar() adds the glyph itself when it needs it.
+        rec.fPackedUnicharID = packedUnicharID;
+        rec.fPackedGlyphID = SkGlyph::MakeID(fScalerContext->charToGlyphID(charCode));
     }
+    return SkGlyph::ID2Code(rec.fPackedGlyphID);
 }
 
 SkUnichar SkGlyphCache::glyphToUnichar(uint16_t glyphID) {
@@ -125,6 +238,21 @@ const SkGlyph& SkGlyphCache::getGlyphIDAdvance(uint16_t glyphID) {
     return *this->lookupByPackedGlyphID(packedGlyphID, kJustAdvance_MetricsType);
 }
 
+void SkGlyphCache::getGlyphIDAdvances(const uint16_t glyphIDs[], int count, bool vertical,
+                                      SkScalar advances[]) {
+    VALIDATE();
+    const int xyIndex = vertical ? 1 : 0;
+    for (int i = 0; i < count; ++i) {
+        if (i > 0 && glyphIDs[i] == glyphIDs[i - 1]) {
+            advances[i] = advances[i - 1];
+            continue;
+        }
+        const SkGlyph* glyph = this->lookupByPackedGlyphID(SkGlyph::MakeID(glyphIDs[i]),
+                                                           kJustAdvance_MetricsType);
+        advances[i] = SkFloatToScalar((&glyph->fAdvanceX)[xyIndex]);
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 const SkGlyph& SkGlyphCache::getUnicharMetrics(SkUnichar charCode) {
@@ -218,6 +346,65 @@ const void* SkGlyphCache::findImage(const SkGlyph& glyph) {
     return glyph.fImage;
 }
 
+void SkGlyphCache::prepareImages(const uint32_t packedIDs[], int count) {
+    // Creating a scaler context costs about as much as rasterizing a handful of glyphs, so each
+    // task should have a fair number of glyphs to work on.
+    static const int kMinGlyphsPerTask = 16;
+
+    // The images are allocated up front, here on the thread that owns the strike. Setting fImage
+    // also weeds out repeated IDs.
+    SkTDArray<SkGlyph*> glyphs;
+    for (int i = 0; i < count; ++i) {
+        SkGlyph* glyph = fGlyphMap.find(packedIDs[i]);
+        if (!glyph || glyph->fImage || glyph->fWidth == 0 || glyph->fWidth >= kMaxGlyphWidth) {
+            continue;
+        }
+        size_t size = glyph->computeImageSize();
+        glyph->fImage = fGlyphAlloc.alloc(size, SkChunkAlloc::kReturnNil_AllocFailType);
+        if (glyph->fImage) {
+            fMemoryUsed += size;
+            *glyphs.append() = glyph;
+        }
+    }
+
+    int taskCount = glyphs.count() / kMinGlyphsPerTask;
+    if (taskCount <= 1) {
+        for (SkGlyph* glyph : glyphs) {
+            fScalerContext->getImage(*glyph);
+        }
+        return;
+    }
+
+    // Scaler contexts aren't thread safe, so every task makes its own from our descriptor. If one
+    // can't be made, its glyphs are left for our own context once the tasks are done.
+    SkTypeface* typeface = fScalerContext->getTypeface();
+    SkScalerContextEffects effects = fScalerContext->getEffects();
+    SkAutoTMalloc<bool> leftOver(taskCount);
+    SkTaskGroup tasks;
+    tasks.batch(taskCount, [&](int task) {
+        int start = glyphs.count() * task / taskCount;
+        int end = glyphs.count() * (task + 1) / taskCount;
+        SkAutoTDelete<SkScalerContext> scaler(typeface->createScalerContext(effects, fDesc, true));
+        leftOver[task] = !scaler;
+        if (scaler) {
+            for (int i = start; i < end; ++i) {
+                scaler->getImage(*glyphs[i]);
+            }
+        }
+    });
+    tasks.wait();
+
+    for (int task = 0; task < taskCount; ++task) {
+        if (leftOver[task]) {
+            int start = glyphs.count() * task / taskCount;
+            int end = glyphs.count() * (task + 1) / taskCount;
+            for (int i = start; i < end; ++i) {
+                fScalerContext->getImage(*glyphs[i]);
+            }
+        }
+    }
+}
+
 const SkPath* SkGlyphCache::findPath(const SkGlyph& glyph) {
     if (glyph.fWidth) {
         if (glyph.fPathData == nullptr) {
@@ -233,6 +420,192 @@ const SkPath* SkGlyphCache::findPath(const SkGlyph& glyph) {
     return glyph.fPathData ? glyph.fPathData->fPath : nullptr;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+// A snapshot is made of 32 bit words:
+//     magic, version, descriptor length, descriptor (with its font ID cleared), glyph count,
+// and then for each glyph
+//     packed ID, advance x and y, width and height, top and left, mask format, rsb and lsb
+//     deltas and forceBW, image size, path size, image, path
+// where the image and path are zero padded to a multiple of 4 bytes.
+static const uint32_t kSnapshotMagic = SkSetFourByteTag('s', 'k', 'g', 's');
+static const uint32_t kSnapshotVersion = 1;
+
+// Copies desc with the font ID in its rec cleared. Font IDs are per process.
+static SkDescriptor* copy_snapshot_descriptor(const SkDescriptor& desc) {
+    SkDescriptor* copy = desc.copy();
+    uint32_t length;
+    SkScalerContext::Rec* rec =
+            (SkScalerContext::Rec*)copy->findEntry(kRec_SkDescriptorTag, &length);
+    if (rec && length == sizeof(SkScalerContext::Rec)) {
+        rec->fFontID = 0;
+    }
+    copy->computeChecksum();
+    return copy;
+}
+
+static void write_padded(SkWStream* stream, const void* data, size_t size) {
+    static const uint32_t kZero = 0;
+    stream->write(data, size);
+    stream->write(&kZero, SkAlign4(size) - size);
+}
+
+void SkGlyphCache::writeSnapshot(SkWStream* stream) const {
+    SkAutoTCallVProc<SkDescriptor, SkDescriptor::Free> desc(copy_snapshot_descriptor(*fDesc));
+    stream->write32(kSnapshotMagic);
+    stream->write32(kSnapshotVersion);
+    stream->write32(desc->getLength());
+    stream->write(desc.get(), desc->getLength());
+    stream->write32(fGlyphMap.count());
+
+    SkAutoMalloc pathStorage;
+    fGlyphMap.foreach([&](const SkGlyph& glyph) {
+        stream->write32(glyph.fID);
+        stream->write(&glyph.fAdvanceX, sizeof(float));
+        stream->write(&glyph.fAdvanceY, sizeof(float));
+        stream->write16(glyph.fWidth);
+        stream->write16(glyph.fHeight);
+        stream->write16(glyph.fTop);
+        stream->write16(glyph.fLeft);
+        stream->write8(glyph.fMaskFormat);
+        stream->write8(glyph.fRsbDelta);
+        stream->write8(glyph.fLsbDelta);
+        stream->write8(glyph.fForceBW);
+
+        size_t imageSize = glyph.fImage ? glyph.computeImageSize() : 0;
+        const SkPath* path = glyph.fPathData ? glyph.fPathData->fPath : nullptr;
+        size_t pathSize = path ? path->writeToMemory(nullptr) : 0;
+        stream->write32(SkToU32(imageSize));
+        stream->write32(SkToU32(pathSize));
+        write_padded(stream, glyph.fImage, imageSize);
+        if (path) {
+            path->writeToMemory(pathStorage.reset(pathSize));
+            write_padded(stream, pathStorage.get(), pathSize);
+        }
+    });
+}
+
+namespace {
+struct SnapshotGlyph {
+    SkGlyph     fGlyph;
+    const void* fImage;
+    const void* fPath;
+    size_t      fPathSize;
+};
+}
+
+// Reads the next glyph of a snapshot, returning false if it's malformed.
+static bool read_snapshot_glyph(SkReader32* reader, SnapshotGlyph* out) {
+    if (!reader->isAvailable(8 * sizeof(uint32_t))) {
+        return false;
+    }
+    SkGlyph& glyph = out->fGlyph;
+    uint32_t id = reader->readU32();
+    if (id == SkGlyph::kImpossibleID) {
+        return false;
+    }
+    glyph.initGlyphFromCombinedID(id);
+    glyph.fAdvanceX = reader->readScalar();
+    glyph.fAdvanceY = reader->readScalar();
+    const uint16_t* size = (const uint16_t*)reader->skip(4);
+    glyph.fWidth = size[0];
+    glyph.fHeight = size[1];
+    const int16_t* topLeft = (const int16_t*)reader->skip(4);
+    glyph.fTop = topLeft[0];
+    glyph.fLeft = topLeft[1];
+    const uint8_t* bytes = (const uint8_t*)reader->skip(4);
+    glyph.fMaskFormat = bytes[0];
+    glyph.fRsbDelta = (int8_t)bytes[1];
+    glyph.fLsbDelta = (int8_t)bytes[2];
+    glyph.fForceBW = (int8_t)bytes[3];
+    size_t imageSize = reader->readU32();
+    out->fPathSize = reader->readU32();
+
+    out->fImage = nullptr;
+    if (imageSize) {
+        if (glyph.fWidth == 0 || glyph.fWidth >= kMaxGlyphWidth ||
+            glyph.fMaskFormat > SkMask::kLCD16_Format ||
+            imageSize != glyph.computeImageSize() ||
+            !reader->isAvailable(SkAlign4(imageSize))) {
+            return false;
+        }
+        out->fImage = reader->skip(SkAlign4(imageSize));
+    }
+    out->fPath = nullptr;
+    if (out->fPathSize) {
+        if (!reader->isAvailable(SkAlign4(out->fPathSize))) {
+            return false;
+        }
+        out->fPath = reader->skip(SkAlign4(out->fPathSize));
+    }
+    return true;
+}
+
+bool SkGlyphCache::loadSnapshot(sk_sp<SkData> data) {
+    VALIDATE();
+    if (!data || !SkIsAlign4((intptr_t)data->data()) || !SkIsAlign4(data->size())) {
+        return false;
+    }
+    SkReader32 reader(data->data(), data->size());
+    if (!reader.isAvailable(3 * sizeof(uint32_t)) ||
+        reader.readU32() != kSnapshotMagic || reader.readU32() != kSnapshotVersion) {
+        return false;
+    }
+    uint32_t descLength = reader.readU32();
+    SkAutoTCallVProc<SkDescriptor, SkDescriptor::Free> desc(copy_snapshot_descriptor(*fDesc));
+    if (descLength != desc->getLength() || !reader.isAvailable(descLength + sizeof(uint32_t)) ||
+        *desc != *(const SkDescriptor*)reader.skip(descLength)) {
+        return false;
+    }
+    int count = reader.readInt();
+    if (count < 0) {
+        return false;
+    }
+
+    // Check the whole snapshot before adding any of it.
+    const size_t glyphsOffset = reader.offset();
+    SnapshotGlyph snapshotGlyph;
+    for (int i = 0; i < count; ++i) {
+        if (!read_snapshot_glyph(&reader, &snapshotGlyph)) {
+            return false;
+        }
+        if (snapshotGlyph.fPath) {
+            SkPath path;
+            if (!path.readFromMemory(snapshotGlyph.fPath, snapshotGlyph.fPathSize)) {
+                return false;
+            }
+        }
+    }
+
+    bool usesData = false;
+    reader.setOffset(glyphsOffset);
+    for (int i = 0; i < count; ++i) {
+        SkAssertResult(read_snapshot_glyph(&reader, &snapshotGlyph));
+        SkGlyph& glyph = snapshotGlyph.fGlyph;
+        if (fGlyphMap.find(glyph.fID)) {
+            continue;
+        }
+        // The snapshot's images are never written to, as glyphs with an image are done.
+        glyph.fImage = const_cast<void*>(snapshotGlyph.fImage);
+        usesData |= SkToBool(glyph.fImage);
+        if (snapshotGlyph.fPath) {
+            SkGlyph::PathData* pathData =
+                    (SkGlyph::PathData*)fGlyphAlloc.allocThrow(sizeof(SkGlyph::PathData));
+            pathData->fIntercept = nullptr;
+            pathData->fPath = new SkPath;
+            pathData->fPath->readFromMemory(snapshotGlyph.fPath, snapshotGlyph.fPathSize);
+            glyph.fPathData = pathData;
+            fMemoryUsed += sizeof(SkPath) + pathData->fPath->countPoints() * sizeof(SkPoint);
+        }
+        fGlyphMap.set(glyph);
+        fMemoryUsed += sizeof(SkGlyph);
+    }
+    if (usesData) {
+        fSnapshots.push_back(std::move(data));
+    }
+    return true;
+}
+
 #include "../pathops/SkPathOpsCubic.h"
 #include "../pathops/SkPathOpsQuad.h"
 
@@ -518,15 +891,31 @@ int SkGlyphCache_Globals::setCacheCountLimit(int newCount) {
 }
 
 void SkGlyphCache_Globals::purgeAll() {
+    fPurgeGeneration.fetch_add(1, sk_memory_order_relaxed);
+
     SkAutoExclusive ac(fLock);
     this->internalPurge(fTotalMemoryUsed);
 }
 
-/*  This guy calls the visitor from within the mutext lock, so the visitor
-    cannot:
-    - take too much time
-    - try to acquire the mutext again
-    - call a fontscaler (which might call into the cache)
+void SkGlyphCache_Globals::purgeToBytes(size_t bytes) {
+    SkAutoExclusive ac(fLock);
+    if (fTotalMemoryUsed > bytes) {
+        this->internalPurge(fTotalMemoryUsed - bytes);
+    }
+}
+
+void SkGlyphCache::PurgeToFraction(float keepFraction) {
+    SkGlyphCache_Globals& globals = get_globals();
+    if (keepFraction <= 0) {
+        purge_all_caches(globals);
+        return;
+    }
+    globals.purgeToBytes((size_t)(globals.getTotalMemoryUsed() * SkTMin(keepFraction, 1.0f)));
+}
+
+/*  The visitor is always called with a cache detached from the global list (and from this
+    thread's caches), so it may do as it likes with it, but it is called as part of every text
+    draw, so it shouldn't take too much time.
 */
 SkGlyphCache* SkGlyphCache::VisitCache(SkTypeface* typeface,
                                        const SkScalerContextEffects& effects,
@@ -549,8 +938,18 @@ SkGlyphCache* SkGlyphCache::VisitCache(SkTypeface* typeface,
     )
 
     SkGlyphCache_Globals& globals = get_globals();
+    ThreadCaches*         threadCaches = ThreadCaches::Get();
     SkGlyphCache*         cache;
 
+    // Try the caches we keep to ourselves first.  We needn't lock anything to look at them.
+    if ((cache = threadCaches->detach(*desc))) {
+        if (!proc(cache, context)) {
+            threadCaches->attach(cache);
+            cache = nullptr;
+        }
+        return cache;
+    }
+
     {
         SkAutoExclusive ac(globals.fLock);
 
@@ -559,14 +958,17 @@ SkGlyphCache* SkGlyphCache::VisitCache(SkTypeface* typeface,
         for (cache = globals.internalGetHead(); cache != nullptr; cache = cache->fNext) {
             if (*cache->fDesc == *desc) {
                 globals.internalDetachCache(cache);
-                if (!proc(cache, context)) {
-                    globals.internalAttachCacheToHead(cache);
-                    cache = nullptr;
-                }
-                return cache;
+                break;
             }
         }
     }
+    if (cache) {
+        if (!proc(cache, context)) {
+            threadCaches->attach(cache);
+            cache = nullptr;
+        }
+        return cache;
+    }
 
     // Check if we can create a scaler-context before creating the glyphcache.
     // If not, we may have exhausted OS/font resources, so try purging the
@@ -576,7 +978,7 @@ SkGlyphCache* SkGlyphCache::VisitCache(SkTypeface* typeface,
         // so we can try the purge.
         SkScalerContext* ctx = typeface->createScalerContext(effects, desc, true);
         if (!ctx) {
-            get_globals().purgeAll();
+            purge_all_caches(globals);
             ctx = typeface->createScalerContext(effects, desc, false);
             SkASSERT(ctx);
         }
@@ -586,7 +988,7 @@ SkGlyphCache* SkGlyphCache::VisitCache(SkTypeface* typeface,
     AutoValidate av(cache);
 
     if (!proc(cache, context)) {   // need to reattach
-        globals.attachCacheToHead(cache);
+        threadCaches->attach(cache);
         cache = nullptr;
     }
     return cache;
@@ -596,7 +998,7 @@ void SkGlyphCache::AttachCache(SkGlyphCache* cache) {
     SkASSERT(cache);
     SkASSERT(cache->fNext == nullptr);
 
-    get_globals().attachCacheToHead(cache);
+    ThreadCaches::Get()->attach(cache);
 }
 
 static void dump_visitor(const SkGlyphCache& cache, void* context) {
@@ -654,6 +1056,14 @@ void SkGlyphCache::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
                            SkGraphics::GetFontCacheCountUsed());
     dump->dumpNumericValue(gGlyphCacheDumpName, "budget_glyph_count", "objects",
                            SkGraphics::GetFontCacheCountLimit());
+    {
+        SkGlyphCache_Globals& globals = get_globals();
+        SkAutoExclusive ac(globals.fLock);
+        dump->dumpNumericValue(gGlyphCacheDumpName, "lock_contended_count", "objects",
+                               globals.fLock.contendedCount());
+        dump->dumpNumericValue(gGlyphCacheDumpName, "lock_wait_time", "nanoseconds",
+                               globals.fLock.waitNanos());
+    }
 
     if (dump->getRequestedDetails() == SkTraceMemoryDump::kLight_LevelOfDetail) {
         dump->setMemoryBacking(gGlyphCacheDumpName, "malloc", nullptr);
@@ -677,13 +1087,34 @@ void SkGlyphCache::VisitAll(Visitor visitor, void* context) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+void SkGlyphCache_Globals::Lock::contendedAcquire() {
+    double start = SkTime::GetNSecs();
+    fLock.acquire();
+    // Now that we hold the lock, we can update our stats without any atomics.
+    fContendedCount += 1;
+    fWaitNanos += (uint64_t)(SkTime::GetNSecs() - start);
+}
+
+void SkGlyphCache_Globals::DeleteCaches(SkGlyphCache* const caches[], int count) {
+    for (int i = 0; i < count; i++) {
+        SkASSERT(nullptr == caches[i]->fPrev && nullptr == caches[i]->fNext);
+        delete caches[i];
+    }
+}
+
 void SkGlyphCache_Globals::attachCacheToHead(SkGlyphCache* cache) {
+    this->attachCachesToHead(&cache, 1);
+}
+
+void SkGlyphCache_Globals::attachCachesToHead(SkGlyphCache* const caches[], int count) {
     SkAutoExclusive ac(fLock);
 
     this->validate();
-    cache->validate();
-
-    this->internalAttachCacheToHead(cache);
+    // Attach in order, so the last cache (the most recently used) ends up at the head.
+    for (int i = 0; i < count; i++) {
+        caches[i]->validate();
+        this->internalAttachCacheToHead(caches[i]);
+    }
     this->internalPurge();
 }
 
@@ -845,7 +1276,7 @@ int SkGraphics::GetFontCacheCountUsed() {
 }
 
 void SkGraphics::PurgeFontCache() {
-    get_globals().purgeAll();
+    purge_all_caches(get_globals());
     SkTypefaceCache::PurgeAll();
 }
 
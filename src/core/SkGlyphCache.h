@@ -9,15 +9,18 @@
 
 #include "SkBitmap.h"
 #include "SkChunkAlloc.h"
+#include "SkData.h"
 #include "SkDescriptor.h"
 #include "SkGlyph.h"
 #include "SkPaint.h"
 #include "SkTHash.h"
 #include "SkScalerContext.h"
+#include "SkTArray.h"
 #include "SkTemplates.h"
 #include "SkTDArray.h"
 
 class SkTraceMemoryDump;
+class SkWStream;
 
 class SkGlyphCache_Globals;
 
@@ -40,6 +43,13 @@ public:
     const SkGlyph& getUnicharAdvance(SkUnichar);
     const SkGlyph& getGlyphIDAdvance(uint16_t);
 
+    /** Writes the advance of each of count glyphs into advances, along the y axis if vertical and
+        along the x axis otherwise. This is the same as calling getGlyphIDAdvance for each glyph,
+        without the call and lookup setup per glyph; runs of one glyph are looked up once.
+    */
+    void getGlyphIDAdvances(const uint16_t glyphIDs[], int count, bool vertical,
+                            SkScalar advances[]);
+
     /** Returns a glyph with all fields valid except fImage and fPath, which may be null. If they
         are null, call findImage or findPath for those. If they are not null, then they are valid.
 
@@ -77,6 +87,13 @@ public:
     */
     const void* findImage(const SkGlyph&);
 
+    /** Generates the images of the glyphs with the given packed IDs (see SkGlyph::getPackedID)
+        that don't have one yet. The glyphs must already be in the strike. When there are enough
+        of them they are rasterized in parallel on SkTaskGroup threads, each with its own scaler
+        context, so that drawing a long run of new glyphs doesn't rasterize them one by one.
+    */
+    void prepareImages(const uint32_t packedIDs[], int count);
+
     /** If the advance axis intersects the glyph's path, append the positions scaled and offset
         to the array (if non-null), and set the count to the updated array length.
     */
@@ -88,6 +105,20 @@ public:
     */
     const SkPath* findPath(const SkGlyph&);
 
+    /** Writes the glyphs this strike has generated so far, with their metrics, images and paths,
+        so that loadSnapshot() can preload them into the same strike in another process. The
+        snapshot leaves out the typeface's font ID, which is only good within a process; it is up
+        to the caller to load it into a strike of the same font.
+    */
+    void writeSnapshot(SkWStream*) const;
+
+    /** Adds the glyphs of a snapshot made by writeSnapshot() that this strike doesn't have yet.
+        Their images are used in place and the strike holds on to the data, so a file mapped with
+        SkData::MakeFromFileName() shares its pages with every process that loads it. Returns
+        false, adding nothing, if the snapshot is malformed or was written for another strike.
+    */
+    bool loadSnapshot(sk_sp<SkData>);
+
     /** Return the vertical metrics for this strike.
     */
     const SkPaint::FontMetrics& getFontMetrics() const {
@@ -153,6 +184,12 @@ public:
 
     static void Dump();
 
+    /** Purges least recently used caches until at most keepFraction of the memory used by the
+        caches shared between threads remains.  Purging everything also frees the caches that
+        threads keep to themselves.
+    */
+    static void PurgeToFraction(float keepFraction);
+
     /** Dump memory usage statistics of all the attaches caches in the process using the
         SkTraceMemoryDump interface.
     */
@@ -267,6 +304,9 @@ private:
 
     SkAutoTArray<CharGlyphRec> fPackedUnicharIDToPackedGlyphID;
 
+    // Snapshots whose glyph images this cache points into.
+    SkTArray<sk_sp<SkData>> fSnapshots;
+
     // used to track (approx) how much ram is tied-up in this cache
     size_t                 fMemoryUsed;
 
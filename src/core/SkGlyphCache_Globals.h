@@ -8,6 +8,7 @@
 #ifndef SkGlyphCache_Globals_DEFINED
 #define SkGlyphCache_Globals_DEFINED
 
+#include "SkAtomics.h"
 #include "SkGlyphCache.h"
 #include "SkMutex.h"
 #include "SkSpinlock.h"
@@ -21,6 +22,11 @@
     #define SK_DEFAULT_FONT_CACHE_LIMIT     (2 * 1024 * 1024)
 #endif
 
+// How many recently used caches each thread keeps to itself, outside the global list.
+#ifndef SK_DEFAULT_FONT_CACHE_THREAD_COUNT_LIMIT
+    #define SK_DEFAULT_FONT_CACHE_THREAD_COUNT_LIMIT   4
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 
 class SkGlyphCache_Globals {
@@ -31,6 +37,7 @@ public:
         fCacheSizeLimit = SK_DEFAULT_FONT_CACHE_LIMIT;
         fCacheCount = 0;
         fCacheCountLimit = SK_DEFAULT_FONT_CACHE_COUNT_LIMIT;
+        fPurgeGeneration.store(0, sk_memory_order_relaxed);
     }
 
     ~SkGlyphCache_Globals() {
@@ -42,7 +49,32 @@ public:
         }
     }
 
-    mutable SkSpinlock     fLock;
+    // A spinlock that keeps track of how often, and for how long, threads wait for it.
+    class Lock {
+    public:
+        void acquire() {
+            if (!fLock.tryAcquire()) {
+                this->contendedAcquire();
+            }
+        }
+        void release() { fLock.release(); }
+
+        // Must hold the lock to call these.
+        uint64_t contendedCount() const { return fContendedCount; }
+        uint64_t waitNanos() const { return fWaitNanos; }
+
+    private:
+        void contendedAcquire();
+
+        SkSpinlock fLock;
+        uint64_t   fContendedCount = 0;
+        uint64_t   fWaitNanos = 0;
+    };
+
+    mutable Lock           fLock;
+
+    // purgeAll() bumps this, telling every thread to let go of the caches it keeps to itself.
+    SkAtomic<int32_t>      fPurgeGeneration;
 
     SkGlyphCache* internalGetHead() const { return fHead; }
     SkGlyphCache* internalGetTail() const;
@@ -62,10 +94,19 @@ public:
     size_t  getCacheSizeLimit() const;
     size_t  setCacheSizeLimit(size_t limit);
 
-    void purgeAll(); // does not change budget
+    // Does not change budget.  Caches threads keep to themselves are freed as each thread
+    // next looks for a cache.
+    void purgeAll();
+    // Purges least recently used caches until no more than bytes are used.
+    void purgeToBytes(size_t bytes);
 
     // call when a glyphcache is available for caching (i.e. not in use)
     void attachCacheToHead(SkGlyphCache*);
+    // Attach several caches under a single lock; the last one ends up at the head.
+    void attachCachesToHead(SkGlyphCache* const caches[], int count);
+
+    // Delete caches that are not in any list.
+    static void DeleteCaches(SkGlyphCache* const caches[], int count);
 
     // can only be called when the mutex is already held
     void internalDetachCache(SkGlyphCache*);
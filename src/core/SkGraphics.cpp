@@ -14,8 +14,11 @@
 #include "SkGeometry.h"
 #include "SkGlyphCache.h"
 #include "SkImageFilter.h"
+#include "SkImageFilterCache.h"
+#include "SkLayerPixelPool.h"
 #include "SkMath.h"
 #include "SkMatrix.h"
+#include "SkMemoryPressure.h"
 #include "SkOpts.h"
 #include "SkPath.h"
 #include "SkPathEffect.h"
@@ -28,6 +31,7 @@
 #include "SkStream.h"
 #include "SkTSearch.h"
 #include "SkTime.h"
+#include "SkTypefaceCache.h"
 #include "SkUtils.h"
 #include "SkXfermode.h"
 
@@ -67,10 +71,40 @@ void SkGraphics::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
   SkGlyphCache::DumpMemoryStatistics(dump);
 }
 
+int SkGraphics::GetImageFilterCacheHitCount() {
+    return SkImageFilterCache::Get()->hitCount();
+}
+
+int SkGraphics::GetImageFilterCacheMissCount() {
+    return SkImageFilterCache::Get()->missCount();
+}
+
 void SkGraphics::PurgeAllCaches() {
     SkGraphics::PurgeFontCache();
     SkGraphics::PurgeResourceCache();
     SkImageFilter::PurgeCache();
+    SkLayerPixelPool::PurgeAll();
+}
+
+DECLARE_SKMESSAGEBUS_MESSAGE(SkMemoryPressureMessage);
+
+void SkGraphics::OnMemoryPressure(MemoryPressureLevel level) {
+    const bool critical = kCritical_MemoryPressureLevel == level;
+
+    // Caches are trimmed in order of how cheaply what they hold is rebuilt for the memory it
+    // frees.  Image filter results are only reused while a layer is unchanged, so they go first.
+    // Decoded and scaled images, and GPU resources, cost a decode or an upload to get back.
+    // Glyphs are small for what they cost to rasterize and nearly every draw needs some.
+    // Typefaces hold little memory but may be slow to recreate.  Unused layer pixels cost nothing
+    // to give back at all.
+    SkLayerPixelPool::PurgeAll();
+    SkImageFilterCache::Get()->purgeToFraction(0);
+    SkResourceCache::PurgeToFraction(critical ? 0 : 0.5f);
+    SkMessageBus<SkMemoryPressureMessage>::Post(SkMemoryPressureMessage(critical ? 0 : 0.5f));
+    SkGlyphCache::PurgeToFraction(critical ? 0 : 0.75f);
+    if (critical) {
+        SkTypefaceCache::PurgeAll();
+    }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
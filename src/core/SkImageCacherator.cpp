@@ -138,6 +138,11 @@ bool SkImageCacherator::tryLockAsBitmap(SkBitmap* bitmap, const SkImage* client,
     if (this->lockAsBitmapOnlyIfAlreadyCached(bitmap)) {
         return true;
     }
+
+    SkAutoMutexAcquire decoding(fMutexForDecode);
+    if (this->lockAsBitmapOnlyIfAlreadyCached(bitmap)) {
+        return true;  // Another thread (perhaps SkImage::prerollAsync()) just decoded it.
+    }
     if (!this->generateBitmap(bitmap)) {
         return false;
     }
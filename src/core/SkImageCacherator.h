@@ -92,6 +92,9 @@ private:
         operator SkImageGenerator*() const { return fCacher->fNotThreadSafeGenerator; }
     };
 
+    // Held while decoding a bitmap to cache, so that other threads wanting it wait for that
+    // decode and then find its result, rather than decoding it again themselves.
+    SkMutex                         fMutexForDecode;
     SkMutex                         fMutexForGenerator;
     SkAutoTDelete<SkImageGenerator> fNotThreadSafeGenerator;
 
@@ -8,14 +8,18 @@
 #include "SkImageFilter.h"
 
 #include "SkCanvas.h"
+#include "SkColorFilter.h"
 #include "SkFuzzLogging.h"
 #include "SkImageFilterCache.h"
 #include "SkLocalMatrixImageFilter.h"
 #include "SkMatrixImageFilter.h"
+#include "SkMD5.h"
 #include "SkReadBuffer.h"
 #include "SkRect.h"
 #include "SkSpecialImage.h"
 #include "SkSpecialSurface.h"
+#include "SkTaskGroup.h"
+#include "SkTArray.h"
 #include "SkValidationUtils.h"
 #include "SkWriteBuffer.h"
 #if SK_SUPPORT_GPU
@@ -229,6 +233,203 @@ sk_sp<SkSpecialImage> SkImageFilter::filterImage(SkSpecialImage* src, const Cont
     return result;
 }
 
+// filterImageTiled() evaluates the DAG in tiles this big, plus a guard band around each.
+static const int kFilterTileSize = 512;
+
+// Digests the pixels of a raster src, so a result filtered from one image can be found again for
+// another with the same content, e.g. the same layer redrawn into a fresh bitmap next frame.
+// Returns false if the pixels can't be read.
+static bool digest_content(SkSpecialImage* src, SkMD5::Digest* digest) {
+    SkBitmap bm;
+    if (!src->getROPixels(&bm)) {
+        return false;
+    }
+    SkAutoLockPixels lock(bm);
+    if (!bm.getPixels()) {
+        return false;
+    }
+    const SkIRect& subset = src->subset();
+    const size_t rowBytes = subset.width() * bm.bytesPerPixel();
+    const uint32_t format[] = {
+        (uint32_t)subset.width(), (uint32_t)subset.height(),
+        (uint32_t)bm.colorType(), (uint32_t)bm.alphaType(),
+    };
+    SkMD5 md5;
+    md5.write(format, sizeof(format));
+    for (int y = subset.fTop; y < subset.fBottom; y++) {
+        md5.write(bm.getAddr(subset.fLeft, y), rowBytes);
+    }
+    md5.finish(*digest);
+    return true;
+}
+
+// True if src's ID always names the same pixels.  An image, or an immutable bitmap, drawn with a
+// filter keeps its ID from frame to frame.  A layer is a bitmap drawn into, so it gets a new ID
+// whenever it's redrawn, even with the same content.
+static bool has_stable_id(SkSpecialImage* src) {
+    SkBitmap bm;
+    return src->getROPixels(&bm) && bm.isImmutable();
+}
+
+// True if every leaf of the DAG is the src, rather than a generator like SkPictureImageFilter.
+static bool only_filters_src(const SkImageFilter* filter) {
+    if (0 == filter->countInputs()) {
+        return false;
+    }
+    for (int i = 0; i < filter->countInputs(); i++) {
+        const SkImageFilter* input = filter->getInput(i);
+        if (input && !only_filters_src(input)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+sk_sp<SkSpecialImage> SkImageFilter::filterImageTiled(SkSpecialImage* src, const Context& context,
+                                                      SkIPoint* offset) const {
+    SkASSERT(src && offset);
+
+    if (src->isTextureBacked() || !context.cache()) {
+        return this->filterTiles(src, context, offset);
+    }
+
+    // A src we don't read, or one whose ID is stable, is keyed by ID and subset, sharing
+    // filterImage()'s cache entry.
+    if (!fUsesSrcInput || has_stable_id(src)) {
+        uint32_t srcGenID = fUsesSrcInput ? src->uniqueID() : 0;
+        const SkIRect srcSubset = fUsesSrcInput ? src->subset() : SkIRect::MakeWH(0, 0);
+        SkImageFilterCacheKey key(fUniqueID, context.ctm(), context.clipBounds(),
+                                  srcGenID, srcSubset);
+        return this->filterTilesCached(src, context, key, offset);
+    }
+
+    // Otherwise key the result by the src's content, so it's found again when a later frame
+    // redraws the same layer.  The CTM is the layer's own, so it doesn't change when the layer
+    // merely moves on the device, but the layer's clip does.  When the whole layer fits in that
+    // clip and nothing lights up transparent black, the clip doesn't change what we compute, and
+    // we key by everything the src could reach instead.
+    SkIRect keyClip = context.clipBounds();
+    if (only_filters_src(this) && this->canComputeFastBounds()) {
+        const SkIRect reach = this->filterBounds(SkIRect::MakeWH(src->width(), src->height()),
+                                                 context.ctm(), kForward_MapDirection);
+        if (keyClip.contains(reach)) {
+            keyClip = reach;
+        }
+    }
+    SkMD5::Digest content;
+    if (!digest_content(src, &content)) {
+        return this->filterTiles(src, context, offset);
+    }
+    SkImageFilterCacheKey key(fUniqueID, context.ctm(), keyClip, 0,
+                              SkIRect::MakeWH(src->width(), src->height()), &content);
+    return this->filterTilesCached(src, context, key, offset);
+}
+
+sk_sp<SkSpecialImage> SkImageFilter::filterTilesCached(SkSpecialImage* src,
+                                                       const Context& context,
+                                                       const SkImageFilterCacheKey& key,
+                                                       SkIPoint* offset) const {
+    if (SkSpecialImage* result = context.cache()->get(key, offset)) {
+        return sk_sp<SkSpecialImage>(SkRef(result));
+    }
+
+    sk_sp<SkSpecialImage> result(this->filterTiles(src, context, offset));
+    if (result) {
+        context.cache()->set(key, result.get(), *offset);
+        SkAutoMutexAcquire mutex(fMutex);
+        fCacheKeys.push_back(key);
+    }
+    return result;
+}
+
+sk_sp<SkSpecialImage> SkImageFilter::filterTiles(SkSpecialImage* src, const Context& context,
+                                                 SkIPoint* offset) const {
+    if (src->isTextureBacked()) {
+        return this->filterImage(src, context, offset);
+    }
+
+    // filterImageTiled() caches our result itself, so we skip filterImage() and its caching.
+    const SkIRect& clip = context.clipBounds();
+    if (clip.width() <= kFilterTileSize && clip.height() <= kFilterTileSize) {
+        return this->onFilterImage(src, context, offset);
+    }
+
+    // Nodes may treat the edges of their clip specially (lighting computes its edge normals
+    // there, for instance), so each tile is evaluated over a guard band wide enough that
+    // nothing downstream of such an edge reaches back into the tile.  If that band would be
+    // as big as a tile, tiling saves nothing.
+    const SkIRect probe = SkIRect::MakeXYWH(clip.x(), clip.y(), kFilterTileSize, kFilterTileSize);
+    const SkIRect needed = this->filterBounds(probe, context.ctm(), kReverse_MapDirection);
+    const int guard = 1 + SkTMax(SkTMax(probe.fLeft - needed.fLeft, needed.fRight - probe.fRight),
+                                 SkTMax(probe.fTop - needed.fTop, needed.fBottom - probe.fBottom));
+    if (guard >= kFilterTileSize) {
+        return this->onFilterImage(src, context, offset);
+    }
+
+    struct Tile {
+        SkIRect               fBounds;
+        sk_sp<SkSpecialImage> fImage;
+        SkIPoint              fOffset;
+    };
+    const int cols = (clip.width()  + kFilterTileSize - 1) / kFilterTileSize,
+              rows = (clip.height() + kFilterTileSize - 1) / kFilterTileSize;
+    SkTArray<Tile> tiles(cols * rows);
+    tiles.push_back_n(cols * rows);
+
+    // onFilterImage() is const and every node's state is immutable, so tiles can run at once.
+    // They skip the cache: their intermediates are keyed by tile and would rarely be reused.
+    SkTaskGroup().batch(cols * rows, [&](int i) {
+        Tile& tile = tiles[i];
+        tile.fBounds = SkIRect::MakeXYWH(clip.x() + (i % cols) * kFilterTileSize,
+                                         clip.y() + (i / cols) * kFilterTileSize,
+                                         kFilterTileSize, kFilterTileSize);
+        SkAssertResult(tile.fBounds.intersect(clip));
+
+        SkIRect tileClip = tile.fBounds.makeOutset(guard, guard);
+        SkAssertResult(tileClip.intersect(clip));
+        tile.fImage = this->filterImage(src, Context(context.ctm(), tileClip, nullptr),
+                                        &tile.fOffset);
+    });
+
+    SkIRect bounds = SkIRect::MakeEmpty();
+    for (Tile& tile : tiles) {
+        if (tile.fImage) {
+            SkIRect r = SkIRect::MakeXYWH(tile.fOffset.x(), tile.fOffset.y(),
+                                          tile.fImage->width(), tile.fImage->height());
+            if (r.intersect(tile.fBounds)) {
+                bounds.join(r);
+            }
+        }
+    }
+    if (bounds.isEmpty()) {
+        return nullptr;
+    }
+
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(bounds.width(), bounds.height());
+    sk_sp<SkSpecialSurface> surf(src->makeSurface(info));
+    if (!surf) {
+        return nullptr;
+    }
+    SkCanvas* canvas = surf->getCanvas();
+    SkASSERT(canvas);
+    canvas->clear(0x0);
+
+    SkPaint paint;
+    paint.setXfermodeMode(SkXfermode::kSrc_Mode);
+    for (Tile& tile : tiles) {
+        if (tile.fImage) {
+            canvas->save();
+            canvas->clipRect(SkRect::Make(tile.fBounds.makeOffset(-bounds.x(), -bounds.y())));
+            tile.fImage->draw(canvas, SkIntToScalar(tile.fOffset.x() - bounds.x()),
+                              SkIntToScalar(tile.fOffset.y() - bounds.y()), &paint);
+            canvas->restore();
+        }
+    }
+
+    *offset = SkIPoint::Make(bounds.x(), bounds.y());
+    return surf->makeImageSnapshot();
+}
+
 SkIRect SkImageFilter::filterBounds(const SkIRect& src, const SkMatrix& ctm,
                                  MapDirection direction) const {
     if (kReverse_MapDirection == direction) {
@@ -443,6 +644,37 @@ sk_sp<SkSpecialImage> SkImageFilter::filterInput(int index,
     return result;
 }
 
+sk_sp<SkSpecialImage> SkImageFilter::filterInputFusingColorFilter(
+                                                    int index,
+                                                    SkSpecialImage* src,
+                                                    const Context& ctx,
+                                                    SkIPoint* offset,
+                                                    sk_sp<SkColorFilter>* colorFilter) const {
+    SkASSERT(colorFilter);
+    colorFilter->reset();
+
+    SkImageFilter* input = this->getInput(index);
+    SkColorFilter* cf;
+    if (input && input->isColorFilterNode(&cf)) {
+        sk_sp<SkColorFilter> fused(cf);
+        // A color filter that affects transparent black fills the whole clip, not just what
+        // its input covers, so it still needs a pass of its own.
+        bool canFuse = !fused->affectsTransparentBlack();
+#if SK_SUPPORT_GPU
+        canFuse = canFuse &&
+                  (!src->isTextureBacked() || fused->asFragmentProcessor(src->getContext()));
+#endif
+        if (canFuse) {
+            sk_sp<SkSpecialImage> result(input->filterInput(0, src, this->mapContext(ctx),
+                                                            offset));
+            *colorFilter = std::move(fused);
+            return result;
+        }
+    }
+
+    return this->filterInput(index, src, ctx, offset);
+}
+
 void SkImageFilter::PurgeCache() {
     SkImageFilterCache::Get()->purge();
 }
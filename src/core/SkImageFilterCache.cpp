@@ -26,7 +26,8 @@ namespace {
 class CacheImpl : public SkImageFilterCache {
 public:
     typedef SkImageFilterCacheKey Key;
-    CacheImpl(size_t maxBytes) : fMaxBytes(maxBytes), fCurrentBytes(0) { }
+    CacheImpl(size_t maxBytes)
+        : fMaxBytes(maxBytes), fCurrentBytes(0), fHitCount(0), fMissCount(0) { }
     ~CacheImpl() override {
         SkTDynamicHash<Value, Key>::Iter iter(&fLookup);
 
@@ -60,8 +61,10 @@ public:
                 fLRU.remove(v);
                 fLRU.addToHead(v);
             }
+            fHitCount++;
             return v->fImage;
         }
+        fMissCount++;
         return nullptr;
     }
 
@@ -93,6 +96,16 @@ public:
         }
     }
 
+    void purgeToFraction(float keepFraction) override {
+        SkAutoMutexAcquire mutex(fMutex);
+        size_t bytes = (size_t)(fCurrentBytes * SkTPin(keepFraction, 0.0f, 1.0f));
+        while (fCurrentBytes > bytes) {
+            Value* tail = fLRU.tail();
+            SkASSERT(tail);
+            this->removeInternal(tail);
+        }
+    }
+
     void purgeByKeys(const Key keys[], int count) override {
         SkAutoMutexAcquire mutex(fMutex);
         for (int i = 0; i < count; i++) {
@@ -102,6 +115,16 @@ public:
         }
     }
 
+    int hitCount() const override {
+        SkAutoMutexAcquire mutex(fMutex);
+        return fHitCount;
+    }
+
+    int missCount() const override {
+        SkAutoMutexAcquire mutex(fMutex);
+        return fMissCount;
+    }
+
     SkDEBUGCODE(int count() const override { return fLookup.count(); })
 private:
     void removeInternal(Value* v) {
@@ -116,6 +139,8 @@ private:
     mutable SkTInternalLList<Value>       fLRU;
     size_t                                fMaxBytes;
     size_t                                fCurrentBytes;
+    mutable int                           fHitCount;
+    mutable int                           fMissCount;
     mutable SkMutex                       fMutex;
 };
 
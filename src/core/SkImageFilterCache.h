@@ -9,6 +9,7 @@
 #define SkImageFilterCache_DEFINED
 
 #include "SkMatrix.h"
+#include "SkMD5.h"
 #include "SkRefCnt.h"
 
 struct SkIPoint;
@@ -16,7 +17,8 @@ class SkSpecialImage;
 
 struct SkImageFilterCacheKey {
     SkImageFilterCacheKey(const uint32_t uniqueID, const SkMatrix& matrix,
-        const SkIRect& clipBounds, uint32_t srcGenID, const SkIRect& srcSubset)
+        const SkIRect& clipBounds, uint32_t srcGenID, const SkIRect& srcSubset,
+        const SkMD5::Digest* srcContent = nullptr)
         : fUniqueID(uniqueID)
         , fMatrix(matrix)
         , fClipBounds(clipBounds)
@@ -24,9 +26,15 @@ struct SkImageFilterCacheKey {
         , fSrcSubset(srcSubset) {
         // Assert that Key is tightly-packed, since it is hashed.
         static_assert(sizeof(SkImageFilterCacheKey) == sizeof(uint32_t) + sizeof(SkMatrix) +
-                                     sizeof(SkIRect) + sizeof(uint32_t) + 4 * sizeof(int32_t),
+                                     sizeof(SkIRect) + sizeof(uint32_t) + 4 * sizeof(int32_t) +
+                                     sizeof(SkMD5::Digest),
                                      "image_filter_key_tight_packing");
         fMatrix.getType();  // force initialization of type, so hashes match
+        if (srcContent) {
+            fSrcContent = *srcContent;
+        } else {
+            memset(&fSrcContent, 0, sizeof(fSrcContent));
+        }
     }
 
     uint32_t fUniqueID;
@@ -34,18 +42,23 @@ struct SkImageFilterCacheKey {
     SkIRect fClipBounds;
     uint32_t fSrcGenID;
     SkIRect fSrcSubset;
+    // Keys made from the src's pixels rather than its identity leave fSrcGenID zero and set
+    // this instead, so results can be shared by different images with the same content.  A
+    // 128-bit digest, so that a collision serving one image's result for another is never seen.
+    SkMD5::Digest fSrcContent;
 
     bool operator==(const SkImageFilterCacheKey& other) const {
         return fUniqueID == other.fUniqueID &&
                fMatrix == other.fMatrix &&
                fClipBounds == other.fClipBounds &&
                fSrcGenID == other.fSrcGenID &&
-               fSrcSubset == other.fSrcSubset;
+               fSrcSubset == other.fSrcSubset &&
+               fSrcContent == other.fSrcContent;
     }
 };
 
-// This cache maps from (filter's unique ID + CTM + clipBounds + src bitmap generation ID) to
-// (result, offset).
+// This cache maps from (filter's unique ID + CTM + clipBounds + src bitmap generation ID or
+// content digest) to (result, offset).
 class SkImageFilterCache : public SkRefCnt {
 public:
     virtual ~SkImageFilterCache() {}
@@ -55,7 +68,12 @@ public:
     virtual void set(const SkImageFilterCacheKey& key, SkSpecialImage* image,
                      const SkIPoint& offset) = 0;
     virtual void purge() = 0;
+    // Purges least recently used results until at most keepFraction of the current bytes remain.
+    virtual void purgeToFraction(float keepFraction) = 0;
     virtual void purgeByKeys(const SkImageFilterCacheKey[], int) = 0;
+    // How many calls to get() have found a result, and how many haven't.
+    virtual int hitCount() const = 0;
+    virtual int missCount() const = 0;
     SkDEBUGCODE(virtual int count() const = 0;)
 };
 
@@ -0,0 +1,131 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkImageInfo.h"
+#include "SkLayerPixelPool.h"
+#include "SkMutex.h"
+
+#ifndef SK_DEFAULT_LAYER_POOL_LIMIT
+    #define SK_DEFAULT_LAYER_POOL_LIMIT     (16 * 1024 * 1024)
+#endif
+
+namespace {
+
+struct Block {
+    void*  fAddr;
+    size_t fSize;
+};
+
+// Few canvases nest more than a handful of layers, and a short list keeps lookups a quick scan.
+static const int kMaxBlocks = 16;
+
+}  // namespace
+
+SK_DECLARE_STATIC_MUTEX(gLayerPoolMutex);
+
+// All guarded by gLayerPoolMutex.  gBlocks is kept least recently freed first.
+static Block  gBlocks[kMaxBlocks];
+static int    gBlockCount = 0;
+static size_t gBytesUsed  = 0;
+static size_t gByteLimit  = SK_DEFAULT_LAYER_POOL_LIMIT;
+
+static void remove_block(int index) {
+    gBytesUsed -= gBlocks[index].fSize;
+    memmove(&gBlocks[index], &gBlocks[index + 1], (gBlockCount - index - 1) * sizeof(Block));
+    gBlockCount--;
+}
+
+// Free the least recently freed blocks until we're at most limit bytes and have room for one more.
+static void purge_to(size_t limit) {
+    while (gBlockCount > 0 && (gBytesUsed > limit || gBlockCount == kMaxBlocks)) {
+        sk_free(gBlocks[0].fAddr);
+        remove_block(0);
+    }
+}
+
+// Take the smallest free block of at least size bytes, so long as it doesn't waste more than it
+// uses.  Returns null if there is none.
+static void* take_block(size_t size, size_t* blockSize) {
+    SkAutoMutexAcquire lock(gLayerPoolMutex);
+    int best = -1;
+    for (int i = 0; i < gBlockCount; i++) {
+        const size_t s = gBlocks[i].fSize;
+        if (s >= size && s / 2 <= size && (best < 0 || s < gBlocks[best].fSize)) {
+            best = i;
+        }
+    }
+    if (best < 0) {
+        return nullptr;
+    }
+    void* addr = gBlocks[best].fAddr;
+    *blockSize = gBlocks[best].fSize;
+    remove_block(best);
+    return addr;
+}
+
+// The pixel ref's release proc.  The block's size rides along as the context.
+static void return_block(void* addr, void* context) {
+    const size_t size = (size_t)(uintptr_t)context;
+    SkAutoMutexAcquire lock(gLayerPoolMutex);
+    if (size > gByteLimit) {
+        sk_free(addr);
+        return;
+    }
+    purge_to(gByteLimit - size);
+    gBlocks[gBlockCount++] = { addr, size };
+    gBytesUsed += size;
+}
+
+bool SkLayerPixelPool::AllocPixels(const SkImageInfo& info, bool zero, SkBitmap* bitmap) {
+    // Same limits as SkMallocPixelRef: 31 bits of rowBytes and of total size.
+    const int64_t rowBytes = (int64_t)info.minRowBytes64();
+    if (info.isEmpty() || !sk_64_isS32(rowBytes) || !sk_64_isS32(info.height() * rowBytes)) {
+        return false;
+    }
+    const size_t size = (size_t)(info.height() * rowBytes);
+
+    size_t blockSize;
+    void* addr = take_block(size, &blockSize);
+    if (addr) {
+        // Only what the layer will use needs clearing, not the whole block.
+        if (zero) {
+            sk_bzero(addr, size);
+        }
+    } else {
+        blockSize = size;
+        addr = zero ? sk_calloc(size) : sk_malloc_flags(size, 0);
+        if (!addr) {
+            return false;
+        }
+    }
+    return bitmap->installPixels(info, addr, (size_t)rowBytes, nullptr,
+                                 return_block, (void*)(uintptr_t)blockSize);
+}
+
+size_t SkLayerPixelPool::GetTotalBytesUsed() {
+    SkAutoMutexAcquire lock(gLayerPoolMutex);
+    return gBytesUsed;
+}
+
+size_t SkLayerPixelPool::GetTotalByteLimit() {
+    SkAutoMutexAcquire lock(gLayerPoolMutex);
+    return gByteLimit;
+}
+
+size_t SkLayerPixelPool::SetTotalByteLimit(size_t newLimit) {
+    SkAutoMutexAcquire lock(gLayerPoolMutex);
+    size_t prevLimit = gByteLimit;
+    gByteLimit = newLimit;
+    purge_to(newLimit);
+    return prevLimit;
+}
+
+void SkLayerPixelPool::PurgeAll() {
+    SkAutoMutexAcquire lock(gLayerPoolMutex);
+    purge_to(0);
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkLayerPixelPool_DEFINED
+#define SkLayerPixelPool_DEFINED
+
+#include "SkTypes.h"
+
+class SkBitmap;
+struct SkImageInfo;
+
+/**
+ *  A global, budgeted pool of pixel memory for the layers saveLayer() makes on the raster backend,
+ *  and for the raster SkSpecialSurfaces image filters draw their intermediate results into.
+ *
+ *  Layers come and go with every saveLayer() and restore(), often at the same sizes frame after
+ *  frame, and so do filter intermediates.  Rather than malloc (and have the OS fault in and zero)
+ *  fresh pixels for each, their memory goes back to this pool when their pixels are freed, to be
+ *  reused by the next one that fits in it.  The pool keeps at most GetTotalByteLimit() bytes of
+ *  unused memory.
+ */
+class SkLayerPixelPool {
+public:
+    /**
+     *  Allocate pixels for info, at info.minRowBytes(), and install them in bitmap.
+     *  If zero is true, the pixels start transparent black; otherwise they're uninitialized.
+     *  Returns false if the pixels could not be allocated.
+     */
+    static bool AllocPixels(const SkImageInfo& info, bool zero, SkBitmap* bitmap);
+
+    /** Returns the bytes of unused pixel memory the pool is holding on to. */
+    static size_t GetTotalBytesUsed();
+
+    static size_t GetTotalByteLimit();
+    /** Set the most unused memory the pool may hold, returning the previous limit. */
+    static size_t SetTotalByteLimit(size_t newLimit);
+
+    /** Free all the unused memory the pool is holding on to. */
+    static void PurgeAll();
+};
+
+#endif
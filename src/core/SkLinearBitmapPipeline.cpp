@@ -756,6 +756,152 @@ static SkLinearBitmapPipeline::BlendProcessorInterface* choose_blender_for_shadi
     return blenderStage->get();
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Fused Stages
+// FusedStages is the same matrix, tile, sampler and blender stages the general pipeline is made
+// of, but each stage's Next is the concrete type of the stage after it instead of its interface.
+// All the stages are final, so each call to the next stage is direct, and usually inlined. Only
+// the call into the fused stage itself is virtual. Each combination costs code size, so only the
+// most common are fused: translate or scale matrices, clamp or repeat tiling in both directions, nearest
+// or bilerp sampling, from N32 premul or opaque sources in linear or sRGB gamma.
+template <typename MatrixStrategy,
+          template <typename, typename, typename> class Tiler,
+          typename XStrategy, typename YStrategy,
+          template <typename, typename> class Sampler,
+          SkGammaType gammaType>
+class FusedStages final : public SkLinearBitmapPipeline::PointProcessorInterface,
+                          public SkLinearBitmapPipeline::DestinationInterface {
+    using Blend  = SrcFPPixel<kPremul_SkAlphaType>;
+    using Sample = Sampler<PixelAccessor<kN32_SkColorType, gammaType>, Blend>;
+    using Tile   = Tiler<XStrategy, YStrategy, Sample>;
+    using Matrix = MatrixStage<MatrixStrategy, Tile>;
+
+public:
+    FusedStages(const MatrixStrategy& matrix, float postAlpha, const SkPixmap& srcPixmap)
+        : fBlend{postAlpha}
+        , fSample{&fBlend, srcPixmap}
+        , fTile{&fSample, srcPixmap.info().dimensions()}
+        , fMatrix{&fTile, matrix} { }
+
+    void SK_VECTORCALL pointListFew(int n, Sk4s xs, Sk4s ys) override {
+        fMatrix.pointListFew(n, xs, ys);
+    }
+
+    void SK_VECTORCALL pointList4(Sk4s xs, Sk4s ys) override {
+        fMatrix.pointList4(xs, ys);
+    }
+
+    void pointSpan(Span span) override {
+        fMatrix.pointSpan(span);
+    }
+
+    void setDestination(void* dst, int count) override {
+        fBlend.setDestination(dst, count);
+    }
+
+private:
+    Blend  fBlend;
+    Sample fSample;
+    Tile   fTile;
+    Matrix fMatrix;
+};
+
+template <typename Fused, typename MatrixStrategy>
+static SkLinearBitmapPipeline::PointProcessorInterface* init_fused_stages(
+    const MatrixStrategy& matrix, float postAlpha, const SkPixmap& srcPixmap,
+    SkLinearBitmapPipeline::FusedStage* fusedStage,
+    SkLinearBitmapPipeline::DestinationInterface** lastStage) {
+    fusedStage->init<Fused>(matrix, postAlpha, srcPixmap);
+    *lastStage = static_cast<Fused*>(fusedStage->get());
+    return fusedStage->get();
+}
+
+template <typename MatrixStrategy, SkGammaType gammaType>
+static SkLinearBitmapPipeline::PointProcessorInterface* choose_fused_tiler_and_sampler(
+    const MatrixStrategy& matrix, SkScalar dx,
+    SkShader::TileMode tileMode, SkFilterQuality filterQuality,
+    float postAlpha, const SkPixmap& srcPixmap,
+    SkLinearBitmapPipeline::FusedStage* fusedStage,
+    SkLinearBitmapPipeline::DestinationInterface** lastStage) {
+    // These must pick the same strategies choose_tiler() does.
+    if (filterQuality == kNone_SkFilterQuality) {
+        if (tileMode == SkShader::kClamp_TileMode) {
+            using F = FusedStages<MatrixStrategy, NearestTileStage, XClampStrategy, YClampStrategy,
+                                  NearestNeighborSampler, gammaType>;
+            return init_fused_stages<F>(matrix, postAlpha, srcPixmap, fusedStage, lastStage);
+        } else if (dx == 1.0f) {
+            using F = FusedStages<MatrixStrategy, NearestTileStage,
+                                  XRepeatUnitScaleStrategy, YRepeatStrategy,
+                                  NearestNeighborSampler, gammaType>;
+            return init_fused_stages<F>(matrix, postAlpha, srcPixmap, fusedStage, lastStage);
+        } else {
+            using F = FusedStages<MatrixStrategy, NearestTileStage, XRepeatStrategy, YRepeatStrategy,
+                                  NearestNeighborSampler, gammaType>;
+            return init_fused_stages<F>(matrix, postAlpha, srcPixmap, fusedStage, lastStage);
+        }
+    } else {
+        if (tileMode == SkShader::kClamp_TileMode) {
+            using F = FusedStages<MatrixStrategy, BilerpTileStage, XClampStrategy, YClampStrategy,
+                                  BilerpSampler, gammaType>;
+            return init_fused_stages<F>(matrix, postAlpha, srcPixmap, fusedStage, lastStage);
+        } else {
+            using F = FusedStages<MatrixStrategy, BilerpTileStage, XRepeatStrategy, YRepeatStrategy,
+                                  BilerpSampler, gammaType>;
+            return init_fused_stages<F>(matrix, postAlpha, srcPixmap, fusedStage, lastStage);
+        }
+    }
+}
+
+template <typename MatrixStrategy>
+static SkLinearBitmapPipeline::PointProcessorInterface* choose_fused_gamma(
+    const MatrixStrategy& matrix, SkScalar dx,
+    SkShader::TileMode tileMode, SkFilterQuality filterQuality,
+    float postAlpha, const SkPixmap& srcPixmap,
+    SkLinearBitmapPipeline::FusedStage* fusedStage,
+    SkLinearBitmapPipeline::DestinationInterface** lastStage) {
+    if (srcPixmap.info().gammaCloseToSRGB()) {
+        return choose_fused_tiler_and_sampler<MatrixStrategy, kSRGB_SkGammaType>(
+            matrix, dx, tileMode, filterQuality, postAlpha, srcPixmap, fusedStage, lastStage);
+    } else {
+        return choose_fused_tiler_and_sampler<MatrixStrategy, kLinear_SkGammaType>(
+            matrix, dx, tileMode, filterQuality, postAlpha, srcPixmap, fusedStage, lastStage);
+    }
+}
+
+// Returns nullptr if there are no fused stages for this pipeline, and the general stages must
+// be used.
+static SkLinearBitmapPipeline::PointProcessorInterface* choose_fused_stages(
+    const SkMatrix& inverse,
+    SkFilterQuality filterQuality,
+    SkShader::TileMode xTile, SkShader::TileMode yTile,
+    SkAlphaType alphaType,
+    float postAlpha,
+    const SkPixmap& srcPixmap,
+    SkLinearBitmapPipeline::FusedStage* fusedStage,
+    SkLinearBitmapPipeline::DestinationInterface** lastStage) {
+    if (srcPixmap.colorType() != kN32_SkColorType || alphaType == kUnpremul_SkAlphaType) {
+        return nullptr;
+    }
+    if (xTile != yTile
+        || (xTile != SkShader::kClamp_TileMode && xTile != SkShader::kRepeat_TileMode)) {
+        return nullptr;
+    }
+    if (inverse.hasPerspective() || inverse.getSkewX() != 0.0f || inverse.getSkewY() != 0.0f) {
+        return nullptr;
+    }
+
+    SkVector offset{inverse.getTranslateX(), inverse.getTranslateY()};
+    SkVector scale{inverse.getScaleX(), inverse.getScaleY()};
+    // The identity is fused as a zero translate, where the general pipeline skips the matrix.
+    if (scale.fX != 1.0f || scale.fY != 1.0f) {
+        return choose_fused_gamma(ScaleMatrixStrategy{offset, scale}, scale.fX,
+                                  xTile, filterQuality, postAlpha, srcPixmap, fusedStage, lastStage);
+    } else {
+        return choose_fused_gamma(TranslateMatrixStrategy{offset}, scale.fX,
+                                  xTile, filterQuality, postAlpha, srcPixmap, fusedStage, lastStage);
+    }
+}
+
 }  // namespace
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -767,7 +913,8 @@ SkLinearBitmapPipeline::SkLinearBitmapPipeline(
     SkFilterQuality filterQuality,
     SkShader::TileMode xTile, SkShader::TileMode yTile,
     SkColor paintColor,
-    const SkPixmap& srcPixmap)
+    const SkPixmap& srcPixmap,
+    bool allowFusedStages)
 {
     SkISize dimensions = srcPixmap.info().dimensions();
     const SkImageInfo& srcImageInfo = srcPixmap.info();
@@ -802,6 +949,17 @@ SkLinearBitmapPipeline::SkLinearBitmapPipeline(
                                      filterQuality, dx, &fTileStage);
     fFirstStage       = choose_matrix(tilerStage, adjustedInverse, &fMatrixStage);
     fLastStage        = blenderStage;
+
+    // The general stages are still needed when there are fused ones, because
+    // ClonePipelineForBlitting copies the matrix and tile stages from them.
+    if (allowFusedStages) {
+        auto fusedStage = choose_fused_stages(adjustedInverse, filterQuality, xTile, yTile,
+                                              alphaType, postAlpha, srcPixmap,
+                                              &fFusedStage, &fLastStage);
+        if (fusedStage != nullptr) {
+            fFirstStage = fusedStage;
+        }
+    }
 }
 
 bool SkLinearBitmapPipeline::ClonePipelineForBlitting(
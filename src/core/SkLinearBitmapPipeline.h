@@ -27,12 +27,16 @@ enum SkGammaType {
 // class SkEmbeddableLinearPipeline below manages these requirements.
 class SkLinearBitmapPipeline {
 public:
+    // The most common pipelines are built as one fused stage, with no virtual calls between its
+    // parts. allowFusedStages = false always builds the general stages; tests and benches use it
+    // to compare the two.
     SkLinearBitmapPipeline(
         const SkMatrix& inverse,
         SkFilterQuality filterQuality,
         SkShader::TileMode xTile, SkShader::TileMode yTile,
         SkColor paintColor,
-        const SkPixmap& srcPixmap);
+        const SkPixmap& srcPixmap,
+        bool allowFusedStages = true);
 
     SkLinearBitmapPipeline(
         const SkLinearBitmapPipeline& pipeline,
@@ -136,6 +140,7 @@ public:
     using SampleStage  = Stage<SampleProcessorInterface,   100, BlendProcessorInterface>;
     using BlenderStage = Stage<BlendProcessorInterface,     40>;
     using Accessor     = PolyMemory<PixelAccessorInterface, 48>;
+    using FusedStage   = PolyMemory<PointProcessorInterface, 336>;
 
 private:
     PointProcessorInterface* fFirstStage;
@@ -145,6 +150,7 @@ private:
     BlenderStage             fBlenderStage;
     DestinationInterface*    fLastStage;
     Accessor                 fAccessor;
+    FusedStage               fFusedStage;
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -346,14 +346,13 @@ static void src_strategy_blend(Span span, Next* next, Strategy* strategy) {
 
 // NearestNeighborSampler - use nearest neighbor filtering to create runs of destination pixels.
 template<typename Accessor, typename Next>
-class NearestNeighborSampler : public SkLinearBitmapPipeline::SampleProcessorInterface {
+class NearestNeighborSampler final : public SkLinearBitmapPipeline::SampleProcessorInterface {
 public:
     template<typename... Args>
-    NearestNeighborSampler(SkLinearBitmapPipeline::BlendProcessorInterface* next, Args&& ... args)
+    NearestNeighborSampler(Next* next, Args&& ... args)
     : fNext{next}, fAccessor{std::forward<Args>(args)...} { }
 
-    NearestNeighborSampler(SkLinearBitmapPipeline::BlendProcessorInterface* next,
-    const NearestNeighborSampler& sampler)
+    NearestNeighborSampler(Next* next, const NearestNeighborSampler& sampler)
     : fNext{next}, fAccessor{sampler.fAccessor} { }
 
     void SK_VECTORCALL pointListFew(int n, Sk4s xs, Sk4s ys) override {
@@ -468,14 +467,13 @@ private:
 // -- BilerpSampler --------------------------------------------------------------------------------
 // BilerpSampler - use a bilerp filter to create runs of destination pixels.
 template<typename Accessor, typename Next>
-class BilerpSampler : public SkLinearBitmapPipeline::SampleProcessorInterface {
+class BilerpSampler final : public SkLinearBitmapPipeline::SampleProcessorInterface {
 public:
     template<typename... Args>
-    BilerpSampler(SkLinearBitmapPipeline::BlendProcessorInterface* next, Args&& ... args)
+    BilerpSampler(Next* next, Args&& ... args)
         : fNext{next}, fAccessor{std::forward<Args>(args)...} { }
 
-    BilerpSampler(SkLinearBitmapPipeline::BlendProcessorInterface* next,
-                   const BilerpSampler& sampler)
+    BilerpSampler(Next* next, const BilerpSampler& sampler)
         : fNext{next}, fAccessor{sampler.fAccessor} { }
 
     Sk4f bilerpNonEdgePixel(SkScalar x, SkScalar y) {
@@ -7,6 +7,7 @@
 
 #include "SkMallocPixelRef.h"
 #include "SkBitmap.h"
+#include "SkData.h"
 #include "SkReadBuffer.h"
 #include "SkWriteBuffer.h"
 
@@ -48,37 +49,48 @@ SkMallocPixelRef* SkMallocPixelRef::NewDirect(const SkImageInfo& info,
 }
 
 
- SkMallocPixelRef* SkMallocPixelRef::NewUsing(void*(*alloc)(size_t),
-                                              const SkImageInfo& info,
-                                              size_t requestedRowBytes,
-                                              SkColorTable* ctable) {
-    if (!is_valid(info, ctable)) {
-        return nullptr;
-    }
-
+// Picks rowBytes (or checks the requested ones) and the size of the pixels for info.
+// Only 31 bits of each are permitted.
+static bool compute_row_bytes_and_size(const SkImageInfo& info, size_t requestedRowBytes,
+                                       int32_t* rowBytes, size_t* size) {
     // only want to permit 31bits of rowBytes
     int64_t minRB = (int64_t)info.minRowBytes64();
     if (minRB < 0 || !sk_64_isS32(minRB)) {
-        return nullptr;    // allocation will be too large
+        return false;    // allocation will be too large
     }
     if (requestedRowBytes > 0 && (int32_t)requestedRowBytes < minRB) {
-        return nullptr;    // cannot meet requested rowbytes
+        return false;    // cannot meet requested rowbytes
     }
 
-    int32_t rowBytes;
     if (requestedRowBytes) {
-        rowBytes = SkToS32(requestedRowBytes);
+        *rowBytes = SkToS32(requestedRowBytes);
     } else {
-        rowBytes = minRB;
+        *rowBytes = minRB;
     }
 
-    int64_t bigSize = (int64_t)info.height() * rowBytes;
+    int64_t bigSize = (int64_t)info.height() * *rowBytes;
     if (!sk_64_isS32(bigSize)) {
+        return false;
+    }
+
+    *size = sk_64_asS32(bigSize);
+    SkASSERT(*size >= info.getSafeSize(*rowBytes));
+    return true;
+}
+
+ SkMallocPixelRef* SkMallocPixelRef::NewUsing(void*(*alloc)(size_t),
+                                              const SkImageInfo& info,
+                                              size_t requestedRowBytes,
+                                              SkColorTable* ctable) {
+    if (!is_valid(info, ctable)) {
         return nullptr;
     }
 
-    size_t size = sk_64_asS32(bigSize);
-    SkASSERT(size >= info.getSafeSize(rowBytes));
+    int32_t rowBytes;
+    size_t size;
+    if (!compute_row_bytes_and_size(info, requestedRowBytes, &rowBytes, &size)) {
+        return nullptr;
+    }
     void* addr = alloc(size);
     if (nullptr == addr) {
         return nullptr;
@@ -116,6 +128,30 @@ static void sk_data_releaseproc(void*, void* dataPtr) {
     (static_cast<SkData*>(dataPtr))->unref();
 }
 
+SkMallocPixelRef* SkMallocPixelRef::NewShared(const SkImageInfo& info,
+                                              size_t requestedRowBytes,
+                                              SkColorTable* ctable,
+                                              int* fd) {
+    if (!is_valid(info, ctable)) {
+        return nullptr;
+    }
+
+    int32_t rowBytes;
+    size_t size;
+    if (!compute_row_bytes_and_size(info, requestedRowBytes, &rowBytes, &size)) {
+        return nullptr;
+    }
+    sk_sp<SkData> data = SkData::MakeShared(size, fd);
+    if (nullptr == data) {
+        return nullptr;
+    }
+
+    // Unlike NewWithData(), these pixels are ours to write to.
+    void* addr = data->writable_data();
+    return new SkMallocPixelRef(info, addr, rowBytes, ctable, sk_data_releaseproc,
+                                data.release());
+}
+
 SkMallocPixelRef* SkMallocPixelRef::NewWithData(const SkImageInfo& info,
                                                 size_t rowBytes,
                                                 SkColorTable* ctable,
@@ -0,0 +1,46 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkMallocStats.h"
+
+std::atomic<bool> SkMallocStats::gEnabled{false};
+
+static std::atomic<int64_t> gAllocations{0},
+                            gBytes{0},
+                            gLiveBytes{0},
+                            gPeakLiveBytes{0};
+
+void SkMallocStats::Start() {
+    gAllocations  .store(0, std::memory_order_relaxed);
+    gBytes        .store(0, std::memory_order_relaxed);
+    gLiveBytes    .store(0, std::memory_order_relaxed);
+    gPeakLiveBytes.store(0, std::memory_order_relaxed);
+    gEnabled.store(true, std::memory_order_release);
+}
+
+SkMallocStats::Counts SkMallocStats::Stop() {
+    gEnabled.store(false, std::memory_order_release);
+    return {
+        gAllocations  .load(std::memory_order_acquire),
+        gBytes        .load(std::memory_order_acquire),
+        gPeakLiveBytes.load(std::memory_order_acquire),
+    };
+}
+
+void SkMallocStats::Allocated(size_t bytes) {
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    gBytes.fetch_add(bytes, std::memory_order_relaxed);
+
+    int64_t live = gLiveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    int64_t peak = gPeakLiveBytes.load(std::memory_order_relaxed);
+    while (live > peak &&
+           !gPeakLiveBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+}
+
+void SkMallocStats::Freed(size_t bytes) {
+    gLiveBytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
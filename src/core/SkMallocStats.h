@@ -0,0 +1,49 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMallocStats_DEFINED
+#define SkMallocStats_DEFINED
+
+#include "SkTypes.h"
+
+#include <atomic>
+
+/**
+ *  Counts the allocations made through sk_malloc and friends, for tools that want to report
+ *  allocation churn.  Counting is off by default and process-wide, so it's only meaningful when
+ *  the work being measured is the only thing allocating.
+ *
+ *  Byte counts come from the allocator's usable size where the port can ask for it, and are 0
+ *  otherwise.  Memory allocated before Start() and freed after it lowers the live byte count, so
+ *  peakLiveBytes is the peak growth since Start(), not an absolute heap size.
+ */
+class SkMallocStats {
+public:
+    struct Counts {
+        int64_t fAllocations;    // sk_malloc, sk_calloc and sk_realloc calls
+        int64_t fBytes;          // total bytes handed out by those calls
+        int64_t fPeakLiveBytes;  // peak of bytes allocated minus bytes freed
+    };
+
+    /** Zero the counters and start counting. */
+    static void Start();
+
+    /** Stop counting and return what was counted since Start(). */
+    static Counts Stop();
+
+    /** Is anyone counting?  The memory ports check this before calling Allocated() or Freed(). */
+    static bool Enabled() { return gEnabled.load(std::memory_order_relaxed); }
+
+    // Called by the memory ports with the size of each block allocated or freed while enabled.
+    static void Allocated(size_t bytes);
+    static void Freed(size_t bytes);
+
+private:
+    static std::atomic<bool> gEnabled;
+};
+
+#endif//SkMallocStats_DEFINED
@@ -6,6 +6,7 @@
  */
 
 #include "SkMaskCache.h"
+#include "SkScan.h"
 
 #define CHECK_LOCAL(localCache, localName, globalName, ...) \
     ((localCache) ? localCache->localName(__VA_ARGS__) : SkResourceCache::globalName(__VA_ARGS__))
@@ -188,3 +189,93 @@ void SkMaskCache::Add(SkScalar sigma, SkBlurStyle style, SkBlurQuality quality,
     RectsBlurKey key(sigma, style, quality, rects, count);
     return CHECK_LOCAL(localCache, add, Add, new RectsBlurRec(key, mask, data));
 }
+
+//////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+static unsigned gPathBlurKeyNamespaceLabel;
+
+struct PathBlurKey : public SkResourceCache::Key {
+public:
+    PathBlurKey(SkScalar sigma, SkBlurStyle style, SkBlurQuality quality,
+                const SkScanPathID& path, SkStrokeRec::InitStyle pathStyle)
+        : fSigma(sigma)
+        , fStyle(0 == sigma ? 0 : style)
+        , fQuality(0 == sigma ? 0 : quality)
+        , fPathStyle(pathStyle)
+        , fGenID(path.fGenID)
+        , fFillType(path.fFillType)
+    {
+        path.fMatrix.get9(fMatrix);
+        this->init(&gPathBlurKeyNamespaceLabel, 0,
+                   sizeof(fSigma) + sizeof(fStyle) + sizeof(fQuality) + sizeof(fPathStyle) +
+                   sizeof(fGenID) + sizeof(fFillType) + sizeof(fMatrix));
+    }
+
+    SkScalar    fSigma;
+    int32_t     fStyle;
+    int32_t     fQuality;
+    int32_t     fPathStyle;
+    uint32_t    fGenID;
+    int32_t     fFillType;
+    SkScalar    fMatrix[9];
+};
+
+struct PathBlurRec : public SkResourceCache::Rec {
+    PathBlurRec(const PathBlurKey& key, const SkMask& mask, SkCachedData* data)
+        : fKey(key)
+    {
+        fValue.fMask = mask;
+        fValue.fData = data;
+        fValue.fData->attachToCacheAndRef();
+    }
+    ~PathBlurRec() {
+        fValue.fData->detachFromCacheAndUnref();
+    }
+
+    PathBlurKey    fKey;
+    MaskValue      fValue;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fValue.fData->size(); }
+    const char* getCategory() const override { return "path-blur"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override {
+        return fValue.fData->diagnostic_only_getDiscardable();
+    }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const PathBlurRec& rec = static_cast<const PathBlurRec&>(baseRec);
+        MaskValue* result = static_cast<MaskValue*>(contextData);
+
+        SkCachedData* tmpData = rec.fValue.fData;
+        tmpData->ref();
+        if (nullptr == tmpData->data()) {
+            tmpData->unref();
+            return false;
+        }
+        *result = rec.fValue;
+        return true;
+    }
+};
+} // namespace
+
+SkCachedData* SkMaskCache::FindAndRef(SkScalar sigma, SkBlurStyle style, SkBlurQuality quality,
+                                      const SkScanPathID& path, SkStrokeRec::InitStyle pathStyle,
+                                      SkMask* mask, SkResourceCache* localCache) {
+    MaskValue result;
+    PathBlurKey key(sigma, style, quality, path, pathStyle);
+    if (!CHECK_LOCAL(localCache, find, Find, key, PathBlurRec::Visitor, &result)) {
+        return nullptr;
+    }
+
+    *mask = result.fMask;
+    mask->fImage = (uint8_t*)(result.fData->data());
+    return result.fData;
+}
+
+void SkMaskCache::Add(SkScalar sigma, SkBlurStyle style, SkBlurQuality quality,
+                      const SkScanPathID& path, SkStrokeRec::InitStyle pathStyle,
+                      const SkMask& mask, SkCachedData* data, SkResourceCache* localCache) {
+    PathBlurKey key(sigma, style, quality, path, pathStyle);
+    return CHECK_LOCAL(localCache, add, Add, new PathBlurRec(key, mask, data));
+}
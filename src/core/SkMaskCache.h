@@ -14,6 +14,9 @@
 #include "SkRect.h"
 #include "SkResourceCache.h"
 #include "SkRRect.h"
+#include "SkStrokeRec.h"
+
+struct SkScanPathID;
 
 class SkMaskCache {
 public:
@@ -30,6 +33,16 @@ public:
                                     const SkRect rects[], int count, SkMask* mask,
                                     SkResourceCache* localCache = nullptr);
 
+    /**
+     *  Masks of a path, named by its SkScanPathID, and filled or hairlined as pathStyle says.  A
+     *  sigma of 0 names the unblurred coverage mask (style and quality are then ignored).  The ID is
+     *  used as is, so callers wanting to share masks between translated draws should leave the
+     *  integer part of the translate out of its matrix, and the mask's bounds with it.
+     */
+    static SkCachedData* FindAndRef(SkScalar sigma, SkBlurStyle style, SkBlurQuality quality,
+                                    const SkScanPathID& path, SkStrokeRec::InitStyle pathStyle,
+                                    SkMask* mask, SkResourceCache* localCache = nullptr);
+
     /**
      * Add a mask and its pixel-data to the cache.
      */
@@ -39,6 +52,9 @@ public:
     static void Add(SkScalar sigma, SkBlurStyle style, SkBlurQuality quality,
                     const SkRect rects[], int count, const SkMask& mask, SkCachedData* data,
                     SkResourceCache* localCache = nullptr);
+    static void Add(SkScalar sigma, SkBlurStyle style, SkBlurQuality quality,
+                    const SkScanPathID& path, SkStrokeRec::InitStyle pathStyle,
+                    const SkMask& mask, SkCachedData* data, SkResourceCache* localCache = nullptr);
 };
 
 #endif
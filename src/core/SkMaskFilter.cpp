@@ -10,9 +10,11 @@
 #include "SkBlitter.h"
 #include "SkDraw.h"
 #include "SkCachedData.h"
+#include "SkMaskCache.h"
 #include "SkPath.h"
 #include "SkRasterClip.h"
 #include "SkRRect.h"
+#include "SkScan.h"
 #include "SkTypes.h"
 
 #if SK_SUPPORT_GPU
@@ -230,9 +232,102 @@ bool SkMaskFilter::filterRRect(const SkRRect& devRRect, const SkMatrix& matrix,
     return true;
 }
 
+// Resolves the clip, and blits the part of mask inside it.
+static void blit_clipped_mask(const SkMask& mask, const SkRasterClip& clip, SkBlitter* blitter) {
+    SkAAClipBlitterWrapper wrapper(clip, blitter);
+    blitter = wrapper.getBlitter();
+
+    SkRegion::Cliperator clipper(wrapper.getRgn(), mask.fBounds);
+
+    if (!clipper.done()) {
+        const SkIRect& cr = clipper.rect();
+        do {
+            blitter->blitMask(mask, cr);
+            clipper.next();
+        } while (!clipper.done());
+    }
+}
+
+// Blurs of a path named by an SkScanPathID are cached, along with the unblurred coverage mask
+// they are made from, by that ID less the integer part of its translate.  The shadows an
+// SkLayerDrawLooper or SkBlurDrawLooper draws under a path differ only in offset, color and blur,
+// so they rasterize the path once and blur it once per sigma, and later frames do neither.
+//
+// Returns a ref to the data holding the blurred mask, set in dstM and placed in device space, or
+// nullptr if the filter isn't a blur or the clip trims the mask, which then can't be reused.
+static SkCachedData* find_or_make_cached_blur(const SkMaskFilter* filter, const SkPath& devPath,
+                                              const SkScanPathID& pathID, const SkMatrix& ctm,
+                                              const SkIRect& clipBounds,
+                                              SkStrokeRec::InitStyle style, SkMask* dstM) {
+    SkMaskFilter::BlurRec rec;
+    if (pathID.fMatrix.hasPerspective() || !filter->asABlur(&rec)) {
+        return nullptr;
+    }
+
+    SkMask clipped, unclipped;
+    if (!SkDraw::DrawToMask(devPath, &clipBounds, filter, &ctm, &clipped,
+                            SkMask::kJustComputeBounds_CreateMode, style) ||
+        !SkDraw::DrawToMask(devPath, nullptr, filter, &ctm, &unclipped,
+                            SkMask::kJustComputeBounds_CreateMode, style) ||
+        clipped.fBounds != unclipped.fBounds) {
+        return nullptr;
+    }
+
+    const int dx = SkScalarFloorToInt(pathID.fMatrix.getTranslateX()),
+              dy = SkScalarFloorToInt(pathID.fMatrix.getTranslateY());
+    SkScanPathID id = pathID;
+    id.fMatrix.postTranslate(SkIntToScalar(-dx), SkIntToScalar(-dy));
+    const SkScalar sigma = ctm.mapRadius(rec.fSigma);
+
+    SkCachedData* data = SkMaskCache::FindAndRef(sigma, rec.fStyle, rec.fQuality, id, style, dstM);
+    if (!data) {
+        SkMask coverage;
+        SkAutoTUnref<SkCachedData> coverageData(
+                SkMaskCache::FindAndRef(0, rec.fStyle, rec.fQuality, id, style, &coverage));
+        if (!coverageData) {
+            coverage = unclipped;
+            coverage.fFormat = SkMask::kA8_Format;
+            coverage.fRowBytes = coverage.fBounds.width();
+            const size_t size = coverage.computeImageSize();
+            if (0 == size) {
+                return nullptr;
+            }
+            coverageData.reset(SkResourceCache::NewCachedData(size));
+            if (!coverageData) {
+                return nullptr;
+            }
+            coverage.fImage = (uint8_t*)coverageData->writable_data();
+            memset(coverage.fImage, 0, size);
+            SkDraw::DrawToMask(devPath, nullptr, nullptr, nullptr, &coverage,
+                               SkMask::kJustRenderImage_CreateMode, style);
+            coverage.fBounds.offset(-dx, -dy);
+            SkMaskCache::Add(0, rec.fStyle, rec.fQuality, id, style, coverage, coverageData);
+        }
+
+        SkMask blurred;
+        if (!filter->filterMask(&blurred, coverage, ctm, nullptr)) {
+            return nullptr;
+        }
+        const size_t size = blurred.computeTotalImageSize();
+        data = SkResourceCache::NewCachedData(size);
+        if (data) {
+            memcpy(data->writable_data(), blurred.fImage, size);
+        }
+        SkMask::FreeImage(blurred.fImage);
+        if (!data) {
+            return nullptr;
+        }
+        blurred.fImage = (uint8_t*)data->data();
+        SkMaskCache::Add(sigma, rec.fStyle, rec.fQuality, id, style, blurred, data);
+        *dstM = blurred;
+    }
+    dstM->fBounds.offset(dx, dy);
+    return data;
+}
+
 bool SkMaskFilter::filterPath(const SkPath& devPath, const SkMatrix& matrix,
                               const SkRasterClip& clip, SkBlitter* blitter,
-                              SkStrokeRec::InitStyle style) const {
+                              SkStrokeRec::InitStyle style, const SkScanPathID* pathID) const {
     SkRect rects[2];
     int rectCount = 0;
     if (SkStrokeRec::kFill_InitStyle == style) {
@@ -258,6 +353,17 @@ bool SkMaskFilter::filterPath(const SkPath& devPath, const SkMatrix& matrix,
         }
     }
 
+    if (pathID) {
+        SkMask cachedM;
+        SkAutoTUnref<SkCachedData> data(find_or_make_cached_blur(this, devPath, *pathID, matrix,
+                                                                 clip.getBounds(), style,
+                                                                 &cachedM));
+        if (data) {
+            blit_clipped_mask(cachedM, clip, blitter);
+            return true;
+        }
+    }
+
     SkMask  srcM, dstM;
 
     if (!SkDraw::DrawToMask(devPath, &clip.getBounds(), this, &matrix, &srcM,
@@ -273,19 +379,7 @@ bool SkMaskFilter::filterPath(const SkPath& devPath, const SkMatrix& matrix,
     SkAutoMaskFreeImage autoDst(dstM.fImage);
 
     // if we get here, we need to (possibly) resolve the clip and blitter
-    SkAAClipBlitterWrapper wrapper(clip, blitter);
-    blitter = wrapper.getBlitter();
-
-    SkRegion::Cliperator clipper(wrapper.getRgn(), dstM.fBounds);
-
-    if (!clipper.done()) {
-        const SkIRect& cr = clipper.rect();
-        do {
-            blitter->blitMask(dstM, cr);
-            clipper.next();
-        } while (!clipper.done());
-    }
-
+    blit_clipped_mask(dstM, clip, blitter);
     return true;
 }
 
@@ -1301,10 +1301,14 @@ int SkPerspIter::next() {
         dy = (fY - y) / n;
     }
 
+    // Step two (x,y) pairs at a time.  An odd n writes one extra pair, which fStorage has room for.
+    Sk4i xy(x, y, x + dx, y + dy),
+         dxy2(2*dx, 2*dy, 2*dx, 2*dy);
     SkFixed* p = fStorage;
-    for (int i = 0; i < n; i++) {
-        *p++ = x; x += dx;
-        *p++ = y; y += dy;
+    for (int i = 0; i < n; i += 2) {
+        xy.store(p);
+        xy = xy + dxy2;
+        p += 4;
     }
 
     fCount -= n;
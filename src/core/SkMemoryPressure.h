@@ -0,0 +1,24 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMemoryPressure_DEFINED
+#define SkMemoryPressure_DEFINED
+
+#include "SkMessageBus.h"
+
+/**
+ *  Posted by SkGraphics::OnMemoryPressure() for caches that can only be trimmed on their own
+ *  thread, like each GrContext's.
+ */
+struct SkMemoryPressureMessage {
+    SkMemoryPressureMessage(float keepFraction) : fKeepFraction(keepFraction) {}
+
+    // The fraction of its purgeable memory a cache should keep, from 0 to 1.
+    float fKeepFraction;
+};
+
+#endif
@@ -6,7 +6,6 @@
  */
 
 #include "SkCanvas.h"
-#include "SkTLazy.h"
 #include "SkMiniRecorder.h"
 #include "SkOnce.h"
 #include "SkPicture.h"
@@ -25,13 +24,58 @@ public:
     SkRect cullRect()             const override { return SkRect::MakeEmpty(); }
     int    numSlowPaths()         const override { return 0; }
     bool   willPlayBackBitmaps()  const override { return false; }
+    SkPictureCost cost()          const override { return SkPictureCost(); }
 };
 
+// Our ops are drawn with no matrix or clip, so their bounds are easy to find for SkPictureCost.
+static SkRect paint_bounds(const SkRect& cull, const SkPaint* paint, SkRect bounds) {
+    bounds.sort();
+    if (paint) {
+        if (!paint->canComputeFastBounds()) {
+            return cull;
+        }
+        SkRect storage;
+        bounds = paint->computeFastBounds(bounds, &storage);
+    }
+    return bounds.intersect(cull) ? bounds : SkRect::MakeEmpty();
+}
+
+static SkRect op_bounds(const SkRect& cull, const DrawBitmapRectFixedSize& op) {
+    return paint_bounds(cull, op.paint, op.dst);
+}
+static SkRect op_bounds(const SkRect& cull, const DrawOval& op) {
+    return paint_bounds(cull, op.paint, op.oval);
+}
+static SkRect op_bounds(const SkRect& cull, const DrawPath& op) {
+    return op.path.isInverseFillType() ? cull : paint_bounds(cull, op.paint, op.path.getBounds());
+}
+static SkRect op_bounds(const SkRect& cull, const DrawRRect& op) {
+    return paint_bounds(cull, op.paint, op.rrect.rect());
+}
+static SkRect op_bounds(const SkRect& cull, const DrawRect& op) {
+    return paint_bounds(cull, op.paint, op.rect);
+}
+static SkRect op_bounds(const SkRect& cull, const DrawTextBlob& op) {
+    return paint_bounds(cull, op.paint, op.blob->bounds().makeOffset(op.x, op.y));
+}
+
+namespace {
+    struct CountCost {
+        SkRect               fCull;
+        SkPictureCostCounter fCounter;
+        template <typename T> void operator()(const T& op) {
+            fCounter.setBounds(op_bounds(fCull, op));
+            fCounter(op);
+        }
+    };
+}
+
 template <typename T>
 class SkMiniPicture final : public SkPicture {
 public:
-    SkMiniPicture(SkRect cull, T* op) : fCull(cull) {
-        memcpy(&fOp, op, sizeof(fOp));  // We take ownership of op's guts.
+    SkMiniPicture(SkRect cull, T* op, SkPaint* paint) : fCull(cull), fPaint(std::move(*paint)) {
+        memcpy(&fOp, op, sizeof(fOp));  // We take ownership of op's guts,
+        fOp.paint = &fPaint;            // and of its paint.
     }
 
     void playback(SkCanvas* c, AbortCallback*) const override {
@@ -47,27 +91,184 @@ public:
         counter(fOp);
         return counter.fNumSlowPathsAndDashEffects;
     }
+    SkPictureCost cost()          const override {
+        CountCost counter = { fCull, SkPictureCostCounter() };
+        counter(fOp);
+        return counter.fCounter.fCost;
+    }
+
+private:
+    SkRect  fCull;
+    SkPaint fPaint;
+    T       fOp;
+};
+
+
+template <typename Fn>
+size_t SkMiniRecorder::Visit(Type type, void* op, Fn& fn) {
+#define CASE(T) case Type::k##T: fn(*static_cast<T*>(op)); return sizeof(T)
+    switch (type) {
+        CASE(DrawBitmapRectFixedSize);
+        CASE(DrawOval);
+        CASE(DrawPath);
+        CASE(DrawRRect);
+        CASE(DrawRect);
+        CASE(DrawTextBlob);
+    }
+#undef CASE
+    SkASSERT(false);
+    return 0;
+}
+
+// Functors for SkMiniRecorder::Visit().
+namespace {
+    struct Nothing {
+        template <typename T> void operator()(const T&) {}
+    };
+
+    struct SetPaint {
+        const SkPaint* fPaint;
+        template <typename T> void operator()(T& op) { op.paint = fPaint; }
+    };
+
+    struct Destroy {
+        template <typename T> void operator()(T& op) { op.~T(); }
+    };
+
+    struct AnyBitmaps {
+        bool fFound;
+        template <typename T> void operator()(const T& op) {
+            fFound = fFound || SkBitmapHunter()(op);
+        }
+    };
+
+    struct MakeMiniPicture {
+        const SkRect&    fCull;
+        SkPaint*         fPaint;
+        sk_sp<SkPicture> fPicture;
+        template <typename T> void operator()(T& op) {
+            fPicture = sk_make_sp<SkMiniPicture<T>>(fCull, &op, fPaint);
+        }
+    };
+
+    struct DrawAndDestroy {
+        SkRecords::Draw* fDraw;
+        template <typename T> void operator()(T& op) {
+            (*fDraw)(op);
+            op.~T();
+        }
+    };
+}
+
+// A picture of a few ops, stored along with their paints in the same allocation as the picture.
+class SkMiniOpsPicture final : public SkPicture {
+public:
+    // Takes ownership of the ops in slots, and of their paints.
+    static sk_sp<SkPicture> Make(const SkRect& cull, SkMiniRecorder::Slot slots[], int count) {
+        Nothing sizeOf;
+        size_t bytes = kHeaderSize + SkAlign8(count * sizeof(SkPaint));
+        for (int i = 0; i < count; i++) {
+            bytes += SkAlign8(SkMiniRecorder::Visit(slots[i].fType, slots[i].fBuffer.get(),
+                                                    sizeOf));
+        }
+
+        SkMiniOpsPicture* pic = new (sk_malloc_throw(bytes)) SkMiniOpsPicture(cull, count, bytes);
+        SkPaint* paints = pic->paints();
+        char* op = pic->ops();
+        for (int i = 0; i < count; i++) {
+            SetPaint setPaint = { new (paints + i) SkPaint(std::move(slots[i].fPaint)) };
+
+            pic->fTypes[i] = slots[i].fType;
+            size_t size = SkMiniRecorder::Visit(slots[i].fType, slots[i].fBuffer.get(), sizeOf);
+            memcpy(op, slots[i].fBuffer.get(), size);  // We take ownership of the op's guts.
+            SkMiniRecorder::Visit(slots[i].fType, op, setPaint);
+            op += SkAlign8(size);
+        }
+        return sk_sp<SkPicture>(pic);
+    }
+
+    ~SkMiniOpsPicture() override {
+        Destroy destroy;
+        this->forEach(destroy);
+        for (int i = 0; i < fCount; i++) {
+            this->paints()[i].~SkPaint();
+        }
+    }
+
+    // We're allocated with sk_malloc_throw() in Make().
+    void operator delete(void* ptr) { sk_free(ptr); }
+
+    void playback(SkCanvas* c, AbortCallback*) const override {
+        SkRecords::Draw draw(c, nullptr, nullptr, 0, nullptr);
+        this->forEach(draw);
+    }
+
+    size_t approximateBytesUsed() const override { return fBytes; }
+    int    approximateOpCount()   const override { return fCount; }
+    SkRect cullRect()             const override { return fCull; }
+    bool   willPlayBackBitmaps()  const override {
+        AnyBitmaps anyBitmaps = { false };
+        this->forEach(anyBitmaps);
+        return anyBitmaps.fFound;
+    }
+    int    numSlowPaths()         const override {
+        SkPathCounter counter;
+        this->forEach(counter);
+        return counter.fNumSlowPathsAndDashEffects;
+    }
+    SkPictureCost cost()          const override {
+        CountCost counter = { fCull, SkPictureCostCounter() };
+        this->forEach(counter);
+        return counter.fCounter.fCost;
+    }
 
 private:
-    SkRect fCull;
-    T      fOp;
+    static const size_t kHeaderSize;
+
+    SkMiniOpsPicture(const SkRect& cull, int count, size_t bytes)
+        : fCull(cull), fBytes(bytes), fCount(count) {}
+
+    SkPaint* paints() const {
+        return (SkPaint*)((char*)this + kHeaderSize);
+    }
+    char* ops() const {
+        return (char*)this + kHeaderSize + SkAlign8(fCount * sizeof(SkPaint));
+    }
+
+    template <typename Fn>
+    void forEach(Fn& fn) const {
+        char* op = this->ops();
+        for (int i = 0; i < fCount; i++) {
+            op += SkAlign8(SkMiniRecorder::Visit(fTypes[i], op, fn));
+        }
+    }
+
+    SkRect                fCull;
+    size_t                fBytes;
+    int                   fCount;
+    SkMiniRecorder::Type  fTypes[SkMiniRecorder::kMaxOps];
+    // The paints then the ops follow, each 8-byte aligned.
 };
 
+const size_t SkMiniOpsPicture::kHeaderSize = SkAlign8(sizeof(SkMiniOpsPicture));
 
-SkMiniRecorder::SkMiniRecorder() : fState(State::kEmpty) {}
+
+SkMiniRecorder::SkMiniRecorder() : fCount(0) {}
 SkMiniRecorder::~SkMiniRecorder() {
-    if (fState != State::kEmpty) {
+    if (fCount > 0) {
         // We have internal state pending.
         // Detaching then deleting a picture is an easy way to clean up.
         (void)this->detachAsPicture(SkRect::MakeEmpty());
     }
-    SkASSERT(fState == State::kEmpty);
+    SkASSERT(fCount == 0);
 }
 
-#define TRY_TO_STORE(Type, ...)                    \
-    if (fState != State::kEmpty) { return false; } \
-    fState = State::k##Type;                       \
-    new (fBuffer.get()) Type{__VA_ARGS__};         \
+#define TRY_TO_STORE(T, paint, ...)                     \
+    if (fCount == kMaxOps) { return false; }             \
+    Slot& slot = fSlots[fCount++];                       \
+    slot.fType = Type::k##T;                             \
+    slot.fPaint = paint;                                 \
+    new (slot.fBuffer.get()) T{&slot.fPaint, __VA_ARGS__}; \
     return true
 
 bool SkMiniRecorder::drawBitmapRect(const SkBitmap& bm, const SkRect* src, const SkRect& dst,
@@ -77,17 +278,21 @@ bool SkMiniRecorder::drawBitmapRect(const SkBitmap& bm, const SkRect* src, const
         bm.getBounds(&bounds);
         src = &bounds;
     }
-    SkTLazy<SkPaint> defaultPaint;
-    if (!p) {
-        p = defaultPaint.init();
-    }
-    TRY_TO_STORE(DrawBitmapRectFixedSize, *p, bm, *src, dst, constraint);
+    TRY_TO_STORE(DrawBitmapRectFixedSize, p ? *p : SkPaint(), bm, *src, dst, constraint);
+}
+
+bool SkMiniRecorder::drawOval(const SkRect& oval, const SkPaint& paint) {
+    TRY_TO_STORE(DrawOval, paint, oval);
 }
 
 bool SkMiniRecorder::drawRect(const SkRect& rect, const SkPaint& paint) {
     TRY_TO_STORE(DrawRect, paint, rect);
 }
 
+bool SkMiniRecorder::drawRRect(const SkRRect& rrect, const SkPaint& paint) {
+    TRY_TO_STORE(DrawRRect, paint, rrect);
+}
+
 bool SkMiniRecorder::drawPath(const SkPath& path, const SkPaint& paint) {
     TRY_TO_STORE(DrawPath, paint, path);
 }
@@ -99,44 +304,34 @@ bool SkMiniRecorder::drawTextBlob(const SkTextBlob* b, SkScalar x, SkScalar y, c
 
 
 sk_sp<SkPicture> SkMiniRecorder::detachAsPicture(const SkRect& cull) {
-#define CASE(Type)              \
-    case State::k##Type:        \
-        fState = State::kEmpty; \
-        return sk_make_sp<SkMiniPicture<Type>>(cull, reinterpret_cast<Type*>(fBuffer.get()))
-
     static SkOnce once;
     static SkPicture* empty;
 
-    switch (fState) {
-        case State::kEmpty:
+    const int count = fCount;
+    fCount = 0;
+    switch (count) {
+        case 0:
             once([]{ empty = new SkEmptyPicture; });
             return sk_ref_sp(empty);
-        CASE(DrawBitmapRectFixedSize);
-        CASE(DrawPath);
-        CASE(DrawRect);
-        CASE(DrawTextBlob);
+        case 1: {
+            // A lone op gets a picture sized just for it.
+            MakeMiniPicture makePicture = { cull, &fSlots[0].fPaint, nullptr };
+            Visit(fSlots[0].fType, fSlots[0].fBuffer.get(), makePicture);
+            return std::move(makePicture.fPicture);
+        }
+        default:
+            return SkMiniOpsPicture::Make(cull, fSlots, count);
     }
-    SkASSERT(false);
-    return nullptr;
-#undef CASE
 }
 
 void SkMiniRecorder::flushAndReset(SkCanvas* canvas) {
-#define CASE(Type)                                                  \
-    case State::k##Type: {                                          \
-        fState = State::kEmpty;                                     \
-        Type* op = reinterpret_cast<Type*>(fBuffer.get());          \
-        SkRecords::Draw(canvas, nullptr, nullptr, 0, nullptr)(*op); \
-        op->~Type();                                                \
-    } return
-
-    switch (fState) {
-        case State::kEmpty: return;
-        CASE(DrawBitmapRectFixedSize);
-        CASE(DrawPath);
-        CASE(DrawRect);
-        CASE(DrawTextBlob);
+    SkRecords::Draw draw(canvas, nullptr, nullptr, 0, nullptr);
+    DrawAndDestroy drawAndDestroy = { &draw };
+
+    const int count = fCount;
+    fCount = 0;
+    for (int i = 0; i < count; i++) {
+        Visit(fSlots[i].fType, fSlots[i].fBuffer.get(), drawAndDestroy);
+        fSlots[i].fPaint.reset();
     }
-    SkASSERT(false);
-#undef CASE
 }
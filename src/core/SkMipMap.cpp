@@ -11,7 +11,9 @@
 #include "SkHalf.h"
 #include "SkMathPriv.h"
 #include "SkNx.h"
+#include "SkOpts.h"
 #include "SkPM4fPriv.h"
+#include "SkTaskGroup.h"
 #include "SkTypes.h"
 
 //
@@ -304,87 +306,81 @@ size_t SkMipMap::AllocLevelsSize(int levelCount, size_t pixelSize) {
     return sk_64_asS32(size);
 }
 
-SkMipMap* SkMipMap::Build(const SkPixmap& src, SkSourceGammaTreatment treatment,
-                          SkDiscardableFactoryProc fact) {
-    typedef void FilterProc(void*, const void* srcPtr, size_t srcRB, int count);
+template <typename F> void SkMipMap::Downsampler::set() {
+    f12 = downsample_1_2<F>;
+    f13 = downsample_1_3<F>;
+    f21 = downsample_2_1<F>;
+    f22 = downsample_2_2<F>;
+    f23 = downsample_2_3<F>;
+    f31 = downsample_3_1<F>;
+    f32 = downsample_3_2<F>;
+    f33 = downsample_3_3<F>;
+}
 
-    FilterProc* proc_1_2 = nullptr;
-    FilterProc* proc_1_3 = nullptr;
-    FilterProc* proc_2_1 = nullptr;
-    FilterProc* proc_2_2 = nullptr;
-    FilterProc* proc_2_3 = nullptr;
-    FilterProc* proc_3_1 = nullptr;
-    FilterProc* proc_3_2 = nullptr;
-    FilterProc* proc_3_3 = nullptr;
+SkMipMap::FilterProc* SkMipMap::Downsampler::choose(int width, int height) const {
+    if (height & 1) {
+        if (height == 1) {        // src-height is 1
+            if (width & 1) {      // src-width is 3
+                return f31;
+            } else {              // src-width is 2
+                return f21;
+            }
+        } else {                  // src-height is 3
+            if (width & 1) {
+                if (width == 1) { // src-width is 1
+                    return f13;
+                } else {          // src-width is 3
+                    return f33;
+                }
+            } else {              // src-width is 2
+                return f23;
+            }
+        }
+    } else {                      // src-height is 2
+        if (width & 1) {
+            if (width == 1) {     // src-width is 1
+                return f12;
+            } else {              // src-width is 3
+                return f32;
+            }
+        } else {                  // src-width is 2
+            return f22;
+        }
+    }
+}
 
+SkMipMap* SkMipMap::Allocate(const SkPixmap& src, SkSourceGammaTreatment treatment,
+                             SkDiscardableFactoryProc fact) {
     const SkColorType ct = src.colorType();
     const SkAlphaType at = src.alphaType();
     const bool srgbGamma = (SkSourceGammaTreatment::kRespect == treatment)
                             && src.info().gammaCloseToSRGB();
 
+    // The even 2x2 case is nearly all of the work, so it gets a wider kernel where we have one.
+    Downsampler downsampler;
     switch (ct) {
         case kRGBA_8888_SkColorType:
         case kBGRA_8888_SkColorType:
             if (srgbGamma) {
-                proc_1_2 = downsample_1_2<ColorTypeFilter_S32>;
-                proc_1_3 = downsample_1_3<ColorTypeFilter_S32>;
-                proc_2_1 = downsample_2_1<ColorTypeFilter_S32>;
-                proc_2_2 = downsample_2_2<ColorTypeFilter_S32>;
-                proc_2_3 = downsample_2_3<ColorTypeFilter_S32>;
-                proc_3_1 = downsample_3_1<ColorTypeFilter_S32>;
-                proc_3_2 = downsample_3_2<ColorTypeFilter_S32>;
-                proc_3_3 = downsample_3_3<ColorTypeFilter_S32>;
+                downsampler.set<ColorTypeFilter_S32>();
             } else {
-                proc_1_2 = downsample_1_2<ColorTypeFilter_8888>;
-                proc_1_3 = downsample_1_3<ColorTypeFilter_8888>;
-                proc_2_1 = downsample_2_1<ColorTypeFilter_8888>;
-                proc_2_2 = downsample_2_2<ColorTypeFilter_8888>;
-                proc_2_3 = downsample_2_3<ColorTypeFilter_8888>;
-                proc_3_1 = downsample_3_1<ColorTypeFilter_8888>;
-                proc_3_2 = downsample_3_2<ColorTypeFilter_8888>;
-                proc_3_3 = downsample_3_3<ColorTypeFilter_8888>;
+                downsampler.set<ColorTypeFilter_8888>();
+                downsampler.f22 = SkOpts::downsample_2_2_8888;
             }
             break;
         case kRGB_565_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_565>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_565>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_565>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_565>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_565>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_565>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_565>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_565>;
+            downsampler.set<ColorTypeFilter_565>();
             break;
         case kARGB_4444_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_4444>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_4444>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_4444>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_4444>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_4444>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_4444>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_4444>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_4444>;
+            downsampler.set<ColorTypeFilter_4444>();
             break;
         case kAlpha_8_SkColorType:
         case kGray_8_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_8>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_8>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_8>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_8>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_8>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_8>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_8>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_8>;
+            downsampler.set<ColorTypeFilter_8>();
+            downsampler.f22 = SkOpts::downsample_2_2_8;
             break;
         case kRGBA_F16_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_F16>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_F16>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_F16>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_F16>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_F16>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_F16>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_F16>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_F16>;
+            downsampler.set<ColorTypeFilter_F16>();
             break;
         default:
             // TODO: We could build miplevels for kIndex8 if the levels were in 8888.
@@ -422,6 +418,7 @@ SkMipMap* SkMipMap::Build(const SkPixmap& src, SkSourceGammaTreatment treatment,
     // init
     mipmap->fCS = sk_ref_sp(src.info().colorSpace());
     mipmap->fCount = countLevels;
+    mipmap->fDownsampler = downsampler;
     mipmap->fLevels = (Level*)mipmap->writable_data();
     SkASSERT(mipmap->fLevels);
 
@@ -431,39 +428,8 @@ SkMipMap* SkMipMap::Build(const SkPixmap& src, SkSourceGammaTreatment treatment,
     int         width = src.width();
     int         height = src.height();
     uint32_t    rowBytes;
-    SkPixmap    srcPM(src);
 
     for (int i = 0; i < countLevels; ++i) {
-        FilterProc* proc;
-        if (height & 1) {
-            if (height == 1) {        // src-height is 1
-                if (width & 1) {      // src-width is 3
-                    proc = proc_3_1;
-                } else {              // src-width is 2
-                    proc = proc_2_1;
-                }
-            } else {                  // src-height is 3
-                if (width & 1) {
-                    if (width == 1) { // src-width is 1
-                        proc = proc_1_3;
-                    } else {          // src-width is 3
-                        proc = proc_3_3;
-                    }
-                } else {              // src-width is 2
-                    proc = proc_2_3;
-                }
-            }
-        } else {                      // src-height is 2
-            if (width & 1) {
-                if (width == 1) {     // src-width is 1
-                    proc = proc_1_2;
-                } else {              // src-width is 3
-                    proc = proc_3_2;
-                }
-            } else {                  // src-width is 2
-                proc = proc_2_2;
-            }
-        }
         width = SkTMax(1, width >> 1);
         height = SkTMax(1, height >> 1);
         rowBytes = SkToU32(SkColorTypeMinRowBytes(ct, width));
@@ -474,26 +440,95 @@ SkMipMap* SkMipMap::Build(const SkPixmap& src, SkSourceGammaTreatment treatment,
         new (&levels[i].fPixmap) SkPixmap(SkImageInfo::Make(width, height, ct, at), addr, rowBytes);
         levels[i].fScale  = SkSize::Make(SkIntToScalar(width)  / src.width(),
                                          SkIntToScalar(height) / src.height());
+        addr += height * rowBytes;
+    }
+    SkASSERT(addr == baseAddr + size);
+    return mipmap;
+}
+
+// Levels at least this big are filtered in bands of about kPixelsPerBand dst pixels at a time.
+static const int kMinParallelPixels = 512 * 512;
+static const int kPixelsPerBand     = 128 * 512;
 
-        const SkPixmap& dstPM = levels[i].fPixmap;
-        const void* srcBasePtr = srcPM.addr();
-        void* dstBasePtr = dstPM.writable_addr();
+void SkMipMap::buildLevel(int index, const SkPixmap& srcPM, bool parallel) const {
+    const SkPixmap& dstPM = fLevels[index].fPixmap;
+    FilterProc* proc = fDownsampler.choose(srcPM.width(), srcPM.height());
 
-        const size_t srcRB = srcPM.rowBytes();
-        for (int y = 0; y < height; y++) {
-            proc(dstBasePtr, srcBasePtr, srcRB, width);
-            srcBasePtr = (char*)srcBasePtr + srcRB * 2; // jump two rows
-            dstBasePtr = (char*)dstBasePtr + dstPM.rowBytes();
+    // Each dst row reads only from src rows 2y to 2y+2, so any set of rows can go at once.
+    auto filter_rows = [&](int top, int bottom) {
+        for (int y = top; y < bottom; y++) {
+            proc(dstPM.writable_addr(0, y), srcPM.addr(0, 2 * y), srcPM.rowBytes(),
+                 dstPM.width());
         }
-        srcPM = dstPM;
-        addr += height * rowBytes;
+    };
+
+    const int64_t pixels = sk_64_mul(dstPM.width(), dstPM.height());
+    if (!parallel || pixels < kMinParallelPixels) {
+        filter_rows(0, dstPM.height());
+        return;
     }
-    SkASSERT(addr == baseAddr + size);
+    const int bands = (int)SkTMin<int64_t>(dstPM.height(), pixels / kPixelsPerBand);
+    SkTaskGroup().batch(bands, [&](int i) {
+        filter_rows(i * dstPM.height() / bands, (i + 1) * dstPM.height() / bands);
+    });
+}
+
+SkMipMap* SkMipMap::Build(const SkPixmap& src, SkSourceGammaTreatment treatment,
+                          SkDiscardableFactoryProc fact) {
+    SkMipMap* mipmap = Allocate(src, treatment, fact);
+    if (nullptr == mipmap) {
+        return nullptr;
+    }
+
+    SkPixmap srcPM(src);
+    for (int i = 0; i < mipmap->fCount; ++i) {
+        mipmap->buildLevel(i, srcPM, true);
+        srcPM = mipmap->fLevels[i].fPixmap;
+    }
+    mipmap->fBuiltCount.store(mipmap->fCount);
 
     SkASSERT(mipmap->fLevels);
     return mipmap;
 }
 
+bool SkMipMap::ensureBuilt(int index) const {
+    if (index < fBuiltCount.load(sk_memory_order_acquire)) {
+        return true;
+    }
+
+    SkAutoMutexAcquire lock(fBuildMutex);
+    int built = fBuiltCount.load(sk_memory_order_relaxed);
+    if (index < built) {
+        return true;     // Someone else got here first.
+    }
+    if (nullptr == fLevels) {
+        return false;
+    }
+
+    SkAutoPixmapUnlock srcUnlocker;
+    SkPixmap srcPM;
+    if (0 == built) {
+        if (!fSrc.requestLock(&srcUnlocker)) {
+            return false;
+        }
+        srcPM = srcUnlocker.pixmap();
+    } else {
+        srcPM = fLevels[built - 1].fPixmap;
+    }
+    // No bands here: waiting on them could run another task that wants this mipmap, and
+    // fBuildMutex is not reentrant.
+    for (; built <= index; built++) {
+        this->buildLevel(built, srcPM, false);
+        srcPM = fLevels[built].fPixmap;
+    }
+    if (built == fCount) {
+        srcUnlocker.unlock();
+        fSrc.reset();
+    }
+    fBuiltCount.store(built, sk_memory_order_release);
+    return true;
+}
+
 int SkMipMap::ComputeLevelCount(int baseWidth, int baseHeight) {
     if (baseWidth < 1 || baseHeight < 1) {
         return 0;
@@ -590,6 +625,9 @@ bool SkMipMap::extractLevel(const SkSize& scaleSize, Level* levelPtr) const {
         level = fCount;
     }
     if (levelPtr) {
+        if (!this->ensureBuilt(level - 1)) {
+            return false;
+        }
         *levelPtr = fLevels[level - 1];
         // need to augment with our colorspace
         levelPtr->fPixmap.setColorSpace(fCS);
@@ -600,7 +638,7 @@ bool SkMipMap::extractLevel(const SkSize& scaleSize, Level* levelPtr) const {
 // Helper which extracts a pixmap from the src bitmap
 //
 SkMipMap* SkMipMap::Build(const SkBitmap& src, SkSourceGammaTreatment treatment,
-                          SkDiscardableFactoryProc fact) {
+                          SkDiscardableFactoryProc fact, LevelGeneration generation) {
     SkAutoPixmapUnlock srcUnlocker;
     if (!src.requestLock(&srcUnlocker)) {
         return nullptr;
@@ -610,7 +648,15 @@ SkMipMap* SkMipMap::Build(const SkBitmap& src, SkSourceGammaTreatment treatment,
     if (nullptr == srcPixmap.addr()) {
         sk_throw();
     }
-    return Build(srcPixmap, treatment, fact);
+    if (kAllLevels_LevelGeneration == generation) {
+        return Build(srcPixmap, treatment, fact);
+    }
+
+    SkMipMap* mipmap = Allocate(srcPixmap, treatment, fact);
+    if (mipmap) {
+        mipmap->fSrc = src;
+    }
+    return mipmap;
 }
 
 int SkMipMap::countLevels() const {
@@ -628,6 +674,9 @@ bool SkMipMap::getLevel(int index, Level* levelPtr) const {
         return false;
     }
     if (levelPtr) {
+        if (!this->ensureBuilt(index)) {
+            return false;
+        }
         *levelPtr = fLevels[index];
     }
     return true;
@@ -8,13 +8,15 @@
 #ifndef SkMipMap_DEFINED
 #define SkMipMap_DEFINED
 
+#include "SkAtomics.h"
+#include "SkBitmap.h"
 #include "SkCachedData.h"
+#include "SkMutex.h"
 #include "SkPixmap.h"
 #include "SkScalar.h"
 #include "SkSize.h"
 #include "SkShader.h"
 
-class SkBitmap;
 class SkDiscardableMemory;
 
 typedef SkDiscardableMemory* (*SkDiscardableFactoryProc)(size_t bytes);
@@ -25,11 +27,22 @@ typedef SkDiscardableMemory* (*SkDiscardableFactoryProc)(size_t bytes);
  * Any function which deals with mipmap levels indices will start with index 0
  * being the first mipmap level which was generated. Said another way, it does
  * not include the base level in its range.
+ *
+ * Levels built from an SkBitmap may be generated lazily: storage for all of them is allocated
+ * up front, but a level's pixels (and those of the larger levels it is filtered from) are only
+ * computed the first time it is extracted.  Until then the mipmap holds a ref on the source,
+ * which its size does not count, so caches that budget by size should build every level.
  */
 class SkMipMap : public SkCachedData {
 public:
+    enum LevelGeneration {
+        kAllLevels_LevelGeneration,     // compute every level in Build()
+        kOnDemand_LevelGeneration,      // compute levels as extractLevel()/getLevel() need them
+    };
+
     static SkMipMap* Build(const SkPixmap& src, SkSourceGammaTreatment, SkDiscardableFactoryProc);
-    static SkMipMap* Build(const SkBitmap& src, SkSourceGammaTreatment, SkDiscardableFactoryProc);
+    static SkMipMap* Build(const SkBitmap& src, SkSourceGammaTreatment, SkDiscardableFactoryProc,
+                           LevelGeneration = kAllLevels_LevelGeneration);
 
     static SkSourceGammaTreatment DeduceTreatment(const SkShader::ContextRec& rec) {
         return (SkShader::ContextRec::kPMColor_DstType == rec.fPreferredDstType) ?
@@ -61,21 +74,56 @@ public:
     // the base level. So index 0 represents mipmap level 1.
     bool getLevel(int index, Level*) const;
 
+    // How many levels have had their pixels computed so far, for testing lazy generation.
+    int testing_only_countBuiltLevels() const { return fBuiltCount.load(); }
+
 protected:
     void onDataChange(void* oldData, void* newData) override {
         fLevels = (Level*)newData; // could be nullptr
     }
 
 private:
+    typedef void FilterProc(void*, const void* srcPtr, size_t srcRB, int count);
+
+    // The filters for each combination of src width (first) and height (second) per dst pixel.
+    struct Downsampler {
+        FilterProc* f12;
+        FilterProc* f13;
+        FilterProc* f21;
+        FilterProc* f22;
+        FilterProc* f23;
+        FilterProc* f31;
+        FilterProc* f32;
+        FilterProc* f33;
+
+        template <typename F> void set();
+        FilterProc* choose(int srcWidth, int srcHeight) const;
+    };
+
     sk_sp<SkColorSpace> fCS;
     Level*              fLevels;    // managed by the baseclass, may be null due to onDataChanged.
     int                 fCount;
+    Downsampler         fDownsampler;
 
-    SkMipMap(void* malloc, size_t size) : INHERITED(malloc, size) {}
-    SkMipMap(size_t size, SkDiscardableMemory* dm) : INHERITED(size, dm) {}
+    // Levels [0, fBuiltCount) hold valid pixels.  The rest are built under fBuildMutex, from
+    // fSrc for level 0, which is released once every level is built.
+    mutable SkAtomic<int> fBuiltCount;
+    mutable SkMutex       fBuildMutex;
+    mutable SkBitmap      fSrc;
 
+    SkMipMap(void* malloc, size_t size) : INHERITED(malloc, size), fBuiltCount(0) {}
+    SkMipMap(size_t size, SkDiscardableMemory* dm) : INHERITED(size, dm), fBuiltCount(0) {}
+
+    static SkMipMap* Allocate(const SkPixmap& src, SkSourceGammaTreatment,
+                              SkDiscardableFactoryProc);
     static size_t AllocLevelsSize(int levelCount, size_t pixelSize);
 
+    // Computes the pixels of fLevels[index] from those of src, the level above it, in parallel
+    // bands if it's big enough and parallel is true.
+    void buildLevel(int index, const SkPixmap& src, bool parallel) const;
+    // Makes sure fLevels[index] and every level above it have been built.
+    bool ensureBuilt(int index) const;
+
     typedef SkCachedData INHERITED;
 };
 
@@ -90,6 +90,7 @@ struct SkNx {
     SkNx saturatedAdd(const SkNx& y) const {
         return { fLo.saturatedAdd(y.fLo), fHi.saturatedAdd(y.fHi) };
     }
+    SkNx mulHi(const SkNx& y) const { return { fLo.mulHi(y.fLo), fHi.mulHi(y.fHi) }; }
     SkNx thenElse(const SkNx& t, const SkNx& e) const {
         return { fLo.thenElse(t.fLo, e.fLo), fHi.thenElse(t.fHi, e.fHi) };
     }
@@ -164,6 +165,12 @@ struct SkNx<1,T> {
         return sum < fVal ? std::numeric_limits<T>::max() : sum;
     }
 
+    // The high 16 bits of the 32-bit product.
+    SkNx mulHi(const SkNx& y) const {
+        static_assert(std::is_same<T, uint16_t>::value, "");
+        return (uint32_t)fVal * y.fVal >> 16;
+    }
+
     SkNx thenElse(const SkNx& t, const SkNx& e) const { return fVal != 0 ? t : e; }
 
 private:
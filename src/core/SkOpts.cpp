@@ -26,9 +26,14 @@
 #include "SkBlitMask_opts.h"
 #include "SkBlitRow_opts.h"
 #include "SkBlurImageFilter_opts.h"
+#include "SkChecksum_opts.h"
 #include "SkColorCubeFilter_opts.h"
 #include "SkColorXform_opts.h"
+#include "SkLightingImageFilter_opts.h"
+#include "SkMatrixConvolutionImageFilter_opts.h"
+#include "SkMipMap_opts.h"
 #include "SkMorphologyImageFilter_opts.h"
+#include "SkPngFilter_opts.h"
 #include "SkSwizzler_opts.h"
 #include "SkTextureCompressor_opts.h"
 #include "SkXfermode_opts.h"
@@ -51,6 +56,9 @@ namespace SkOpts {
     DEFINE_DEFAULT( erode_x);
     DEFINE_DEFAULT( erode_y);
 
+    DEFINE_DEFAULT(matrix_convolve);
+    DEFINE_DEFAULT(lighting_normals);
+
     DEFINE_DEFAULT(texture_compressor);
     DEFINE_DEFAULT(fill_block_dimensions);
 
@@ -69,6 +77,17 @@ namespace SkOpts {
     DEFINE_DEFAULT(grayA_to_rgbA);
     DEFINE_DEFAULT(inverted_CMYK_to_RGB1);
     DEFINE_DEFAULT(inverted_CMYK_to_BGR1);
+    DEFINE_DEFAULT(rgbA_to_RGBA);
+    DEFINE_DEFAULT(rgbA_to_BGRA);
+    DEFINE_DEFAULT(index8_to_8888);
+
+    DEFINE_DEFAULT(png_unfilter_sub);
+    DEFINE_DEFAULT(png_unfilter_up);
+    DEFINE_DEFAULT(png_unfilter_avg);
+    DEFINE_DEFAULT(png_unfilter_paeth);
+
+    DEFINE_DEFAULT(downsample_2_2_8888);
+    DEFINE_DEFAULT(downsample_2_2_8);
 
     DEFINE_DEFAULT(srcover_srgb_srgb);
 
@@ -77,14 +96,27 @@ namespace SkOpts {
     DEFINE_DEFAULT(color_xform_RGB1_to_table);
 #undef DEFINE_DEFAULT
 
+    decltype(compile_pipeline_8) compile_pipeline_8 = nullptr;
+
     // Each Init_foo() is defined in src/opts/SkOpts_foo.cpp.
     void Init_ssse3();
     void Init_sse41();
-    void Init_sse42() {}
+    void Init_sse42();
     void Init_avx();
-    void Init_avx2() {}
+    void Init_avx2();
+
+    // Hashes may be stored in tables, so hash_fn must not change once anything has been hashed.
+    // Until Init() runs, it points here, and the first hash runs Init() to settle it.
+    static uint32_t hash_fn_before_init(const void* data, size_t bytes, uint32_t seed) {
+        Init();
+        return hash_fn(data, bytes, seed);
+    }
+    uint32_t (*hash_fn)(const void*, size_t, uint32_t) = hash_fn_before_init;
 
     static void init() {
+        hash_fn = SK_OPTS_NS::hash_fn;
+
+        SkCpu::CacheRuntimeFeatures();
     #if defined(SK_CPU_X86) && !defined(SK_BUILD_NO_OPTS)
         if (SkCpu::Supports(SkCpu::SSSE3)) { Init_ssse3(); }
         if (SkCpu::Supports(SkCpu::SSE41)) { Init_sse41(); }
@@ -8,9 +8,11 @@
 #ifndef SkOpts_DEFINED
 #define SkOpts_DEFINED
 
+#include "SkRasterPipeline.h"
 #include "SkTextureCompressor.h"
 #include "SkTypes.h"
 #include "SkXfermode.h"
+#include <functional>
 
 struct ProcCoeff;
 
@@ -31,6 +33,20 @@ namespace SkOpts {
     typedef void (*Morph)(const SkPMColor*, SkPMColor*, int, int, int, int, int);
     extern Morph dilate_x, dilate_y, erode_x, erode_y;
 
+    // Convolves count premultiplied pixels with a kernelWidth x kernelHeight kernel, scaling the
+    // sums by gain and adding bias.  src points at the kernel's top-left sample for dst[0].  If
+    // alphaSrc is null alpha is convolved too, otherwise color is premultiplied by alphaSrc's.
+    extern void (*matrix_convolve)(SkPMColor* dst, const SkPMColor* src, size_t srcRowBytes,
+                                   int count, const float* kernel, int kernelWidth,
+                                   int kernelHeight, float gain, float bias,
+                                   const SkPMColor* alphaSrc);
+
+    // Computes the surface normals of count pixels, with a Sobel filter over the alpha of the
+    // rows above, at, and below them.  Each row is read from [-1] to [count].
+    extern void (*lighting_normals)(const SkPMColor* above, const SkPMColor* row,
+                                    const SkPMColor* below, int count, float surfaceScale,
+                                    float* nx, float* ny, float* nz);
+
     typedef bool (*TextureCompressor)(uint8_t* dst, const uint8_t* src,
                                       int width, int height, size_t rowBytes);
     extern TextureCompressor (*texture_compressor)(SkColorType, SkTextureCompressor::Format);
@@ -62,10 +78,44 @@ namespace SkOpts {
                         inverted_CMYK_to_RGB1, // i.e. convert color space
                         inverted_CMYK_to_BGR1; // i.e. convert color space
 
+    // Unpremultiply 8888 pixels, undoing RGBA_to_rgbA or RGBA_to_bgrA.
+    extern Swizzle_8888 rgbA_to_RGBA,          // i.e. just unpremultiply
+                        rgbA_to_BGRA;          // i.e. unpremultiply and swap RB
+
+    // Expand 8-bit indices into 8888 pixels by looking each up in a full 256-entry color table.
+    extern void (*index8_to_8888)(uint32_t* dst, const uint8_t* src, int count,
+                                  const uint32_t table[256]);
+
+    // Undo a PNG row filter in place, given the previous row already unfiltered.
+    typedef void (*PngUnfilter)(uint8_t* row, const uint8_t* prev, size_t rowBytes, int bpp);
+    extern PngUnfilter png_unfilter_sub,
+                       png_unfilter_up,
+                       png_unfilter_avg,
+                       png_unfilter_paeth;
+
+    // Box filter the 2x2 blocks of two src rows srcRB bytes apart down to count dst pixels.
+    typedef void (*MipDownsample)(void* dst, const void* src, size_t srcRB, int count);
+    extern MipDownsample downsample_2_2_8888,  // any 4 bytes per pixel, treated linearly
+                         downsample_2_2_8;     // alpha or gray
+
     // Blend ndst src pixels over dst, where both src and dst point to sRGB pixels (RGBA or BGRA).
     // If nsrc < ndst, we loop over src to create a pattern.
     extern void (*srcover_srgb_srgb)(uint32_t* dst, const uint32_t* src, int ndst, int nsrc);
 
+    // Hashes bytes for in-memory hash tables and caches, using CRC32 instructions where the CPU
+    // has them.  The result depends on the CPU, so never persist it; see SkChecksum::Murmur3().
+    // The first call picks the implementation, which then never changes.
+    extern uint32_t (*hash_fn)(const void*, size_t, uint32_t seed);
+    static inline uint32_t hash(const void* data, size_t bytes, uint32_t seed=0) {
+        return hash_fn(data, bytes, seed);
+    }
+
+    // Builds a function running a pipeline of count stock stages, each with its context, over
+    // [0,n) 8 pixels at a time, with each vector in an AVX register.  It's null unless the CPU
+    // has AVX, and SkRasterPipelineN<8> runs its own stages then.
+    extern std::function<void(size_t n)> (*compile_pipeline_8)(
+            const SkRasterPipelineStockStages::StockStage*, void* const* ctxs, int count);
+
     // Color xform RGB1 pixels into SkPMColor order.
     extern void (*color_xform_RGB1_to_2dot2) (uint32_t* dst, const uint32_t* src, int len,
                                               const float* const srcTables[3],
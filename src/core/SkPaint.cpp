@@ -17,6 +17,8 @@
 #include "SkMaskFilter.h"
 #include "SkMaskGamma.h"
 #include "SkMutex.h"
+#include "SkNx.h"
+#include "SkOpts.h"
 #include "SkReadBuffer.h"
 #include "SkWriteBuffer.h"
 #include "SkPaintDefaults.h"
@@ -762,6 +764,57 @@ static SkScalar advance(const SkGlyph& glyph, int xyIndex) {
     return SkFloatToScalar((&glyph.fAdvanceX)[xyIndex]);
 }
 
+// Plain advances are measured this many glyphs at a time. measureText and breakText share it so
+// that they add up the same batches in the same order and agree exactly on a run's width.
+static const int kAdvanceBatchSize = 64;
+
+// Converts up to max characters of text to glyph IDs, stepping *text past them.
+static int next_glyph_ids(SkGlyphCache* cache, SkPaint::TextEncoding encoding,
+                          const char** text, const char* stop, uint16_t glyphs[], int max) {
+    int count = 0;
+    switch (encoding) {
+        case SkPaint::kUTF8_TextEncoding:
+            for (; count < max && *text < stop; ++count) {
+                glyphs[count] = cache->unicharToGlyph(SkUTF8_NextUnichar(text));
+            }
+            break;
+        case SkPaint::kUTF16_TextEncoding:
+            for (; count < max && *text < stop; ++count) {
+                glyphs[count] = cache->unicharToGlyph(SkUTF16_NextUnichar((const uint16_t**)text));
+            }
+            break;
+        case SkPaint::kUTF32_TextEncoding: {
+            const int32_t* ptr = *(const int32_t**)text;
+            for (; count < max && (const char*)ptr < stop; ++count) {
+                glyphs[count] = cache->unicharToGlyph(*ptr++);
+            }
+            *text = (const char*)ptr;
+            break;
+        }
+        case SkPaint::kGlyphID_TextEncoding: {
+            const uint16_t* ptr = *(const uint16_t**)text;
+            count = SkTMin(max, SkToInt((const uint16_t*)stop - ptr));
+            memcpy(glyphs, ptr, count * sizeof(uint16_t));
+            *text = (const char*)(ptr + count);
+            break;
+        }
+    }
+    return count;
+}
+
+static SkScalar sum_advances(const SkScalar advances[], int count) {
+    Sk4f sum4(0);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        sum4 = sum4 + Sk4f::Load(advances + i);
+    }
+    SkScalar sum = (sum4[0] + sum4[1]) + (sum4[2] + sum4[3]);
+    for (; i < count; ++i) {
+        sum += advances[i];
+    }
+    return sum;
+}
+
 SkScalar SkPaint::measure_text(SkGlyphCache* cache,
                                const char* text, size_t byteLength,
                                int* count, SkRect* bounds) const {
@@ -774,6 +827,25 @@ SkScalar SkPaint::measure_text(SkGlyphCache* cache,
         return 0;
     }
 
+    if (nullptr == bounds && !this->isDevKernText()) {
+        // Only the advances matter, so look them up and add them a batch at a time.
+        const char* stop = text + byteLength;
+        uint16_t glyphs[kAdvanceBatchSize];
+        SkScalar advances[kAdvanceBatchSize];
+        SkScalar width = 0;
+        int n = 0;
+        while (text < stop) {
+            int batch = next_glyph_ids(cache, this->getTextEncoding(), &text, stop, glyphs,
+                                       kAdvanceBatchSize);
+            cache->getGlyphIDAdvances(glyphs, batch, this->isVerticalText(), advances);
+            width += sum_advances(advances, batch);
+            n += batch;
+        }
+        SkASSERT(text == stop);
+        *count = n;
+        return width;
+    }
+
     GlyphCacheProc glyphCacheProc = this->getGlyphCacheProc(nullptr != bounds);
 
     int xyIndex;
@@ -910,13 +982,31 @@ size_t SkPaint::breakText(const void* textD, size_t length, SkScalar maxWidth,
             rsb = g.fRsbDelta;
         }
     } else {
-        while (text < stop) {
-            const char* curr = text;
-            SkScalar x = advance(glyphCacheProc(cache, &text), xyIndex);
-            if ((width += x) > maxWidth) {
-                width -= x;
-                text = curr;
-                break;
+        // Batched as in measure_text, so that a maxWidth from measureText takes the whole run.
+        uint16_t glyphs[kAdvanceBatchSize];
+        SkScalar advances[kAdvanceBatchSize];
+        bool broke = false;
+        while (!broke && text < stop) {
+            const char* batchStart = text;
+            int batch = next_glyph_ids(cache, paint.getTextEncoding(), &text, stop, glyphs,
+                                       kAdvanceBatchSize);
+            cache->getGlyphIDAdvances(glyphs, batch, paint.isVerticalText(), advances);
+            SkScalar batchWidth = sum_advances(advances, batch);
+            if (width + batchWidth <= maxWidth) {
+                width += batchWidth;
+                continue;
+            }
+            // The break is somewhere in this batch, so walk it a glyph at a time.
+            text = batchStart;
+            for (int i = 0; i < batch; ++i) {
+                const char* curr = text;
+                next_glyph_ids(cache, paint.getTextEncoding(), &text, stop, glyphs, 1);
+                if ((width += advances[i]) > maxWidth) {
+                    width -= advances[i];
+                    text = curr;
+                    broke = true;
+                    break;
+                }
             }
         }
     }
@@ -2326,6 +2416,6 @@ uint32_t SkPaint::getHash() const {
     // so fBitfields should be 10 pointers and 6 32-bit values from the start.
     static_assert(offsetof(SkPaint, fBitfields) == 9 * sizeof(void*) + 6 * sizeof(uint32_t),
                   "SkPaint_notPackedTightly");
-    return SkChecksum::Murmur3(reinterpret_cast<const uint32_t*>(this),
-                               offsetof(SkPaint, fBitfields) + sizeof(fBitfields));
+    // This hash is never stored, so we can use SkOpts::hash(), which is faster than Murmur3.
+    return SkOpts::hash(this, offsetof(SkPaint, fBitfields) + sizeof(fBitfields));
 }
@@ -9,6 +9,7 @@
 #include "SkPathMeasure.h"
 #include "SkGeometry.h"
 #include "SkPath.h"
+#include "SkResourceCache.h"
 #include "SkTSearch.h"
 
 // these must be 0,1,2,3 since they are in our 2-bit field
@@ -213,7 +214,8 @@ SkScalar SkPathMeasure::compute_cubic_segs(const SkPoint pts[4],
     return distance;
 }
 
-void SkPathMeasure::buildSegments() {
+// Returns true once the iterator has reached the end of the path.
+bool SkPathMeasure::buildSegments() {
     SkPoint         pts[4];
     int             ptIndex = fFirstPtIndex;
     SkScalar        distance = 0;
@@ -230,6 +232,7 @@ void SkPathMeasure::buildSegments() {
      */
     fSegments.reset();
     bool done = false;
+    bool reachedEnd = false;
     do {
         switch (fIter.next(pts)) {
             case SkPath::kMove_Verb:
@@ -309,6 +312,7 @@ void SkPathMeasure::buildSegments() {
 
             case SkPath::kDone_Verb:
                 done = true;
+                reachedEnd = true;
                 break;
         }
     } while (!done);
@@ -343,6 +347,143 @@ void SkPathMeasure::buildSegments() {
     //  SkDebugf("\n");
     }
 #endif
+    return reachedEnd;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace {
+static unsigned gPathMeasureKeyNamespaceLabel;
+
+// Paths with fewer points than this are quicker to measure again than to look up.
+static const int kMinCachedMeasurePoints = 32;
+}
+
+/*  The segment tables of every contour of a path, built in one pass and never modified
+ *  afterwards, so measures of the same path can share them (and their points).
+ */
+struct SkPathMeasure::Contours : public SkNVRefCnt<Contours> {
+    struct Contour {
+        int         fSegStart;  // index of the contour's first segment in fSegments
+        int         fSegCount;
+        SkScalar    fLength;
+        bool        fIsClosed;
+    };
+
+    SkTDArray<Segment>  fSegments;
+    SkTDArray<SkPoint>  fPts;
+    SkTDArray<Contour>  fContours;
+
+    struct Key : public SkResourceCache::Key {
+    public:
+        Key(const SkPath& path, bool forceClosed, SkScalar tolerance)
+            : fGenID(path.getGenerationID())
+            , fForceClosed(forceClosed)
+            , fTolerance(tolerance) {
+            static const size_t keySize = sizeof(fGenID) + sizeof(fForceClosed) +
+                                          sizeof(fTolerance);
+            // This better be packed.
+            SkASSERT(sizeof(uint32_t) * (&fEndOfStruct - &fGenID) == keySize);
+            this->init(&gPathMeasureKeyNamespaceLabel, 0, keySize);
+        }
+
+    private:
+        uint32_t fGenID;
+        uint32_t fForceClosed;
+        SkScalar fTolerance;
+
+        SkDEBUGCODE(uint32_t fEndOfStruct;)
+    };
+
+    struct Rec : public SkResourceCache::Rec {
+        Rec(const Key& key, const Contours* contours)
+            : fKey(key)
+            , fContours(SkRef(contours)) {}
+
+        Key                   fKey;
+        sk_sp<const Contours> fContours;
+
+        const Key& getKey() const override { return fKey; }
+        size_t bytesUsed() const override {
+            return sizeof(*this) + sizeof(Contours) +
+                   fContours->fSegments.count() * sizeof(Segment) +
+                   fContours->fPts.count() * sizeof(SkPoint) +
+                   fContours->fContours.count() * sizeof(Contour);
+        }
+        const char* getCategory() const override { return "path-measure"; }
+        SkDiscardableMemory* diagnostic_only_getDiscardable() const override { return nullptr; }
+
+        static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextContours) {
+            const Rec& rec = static_cast<const Rec&>(baseRec);
+            *static_cast<sk_sp<const Contours>*>(contextContours) = rec.fContours;
+            return true;
+        }
+    };
+
+    static sk_sp<const Contours> Find(const SkPath& path, bool forceClosed, SkScalar tolerance) {
+        // Non-volatile paths that get measured over and over (e.g. text on a path, or motion
+        // along a path) share one table. Short paths are not worth the lookup.
+        if (path.isVolatile() || path.countPoints() < kMinCachedMeasurePoints) {
+            return nullptr;
+        }
+
+        Key key(path, forceClosed, tolerance);
+        sk_sp<const Contours> contours;
+        if (SkResourceCache::Find(key, Rec::Visitor, &contours)) {
+            return contours;
+        }
+
+        SkPathMeasure meas(path, forceClosed);
+        meas.fTolerance = tolerance;
+
+        Contours* built = new Contours;
+        bool reachedEnd;
+        do {
+            reachedEnd = meas.buildSegments();
+            Contour* contour = built->fContours.append();
+            contour->fSegStart = built->fSegments.count();
+            contour->fSegCount = meas.fSegments.count();
+            contour->fLength = meas.fLength;
+            contour->fIsClosed = meas.fIsClosed;
+            built->fSegments.append(meas.fSegments.count(), meas.fSegments.begin());
+        } while (!reachedEnd);
+        // Segments index the points of the whole path, not just those of their contour.
+        built->fPts.swap(meas.fPts);
+
+        contours.reset(built);
+        SkResourceCache::Add(new Rec(key, built));
+        return contours;
+    }
+};
+
+void SkPathMeasure::nextContourSegments() {
+    if (0 == fContourIndex) {
+        fContours = Contours::Find(*fPath, fForceClosed, fTolerance);
+    }
+
+    if (fContours) {
+        const SkTDArray<Contours::Contour>& contours = fContours->fContours;
+        if (fContourIndex < contours.count()) {
+            const Contours::Contour& contour = contours[fContourIndex];
+            fLength = contour.fLength;
+            fIsClosed = contour.fIsClosed;
+            fSegs = fContours->fSegments.begin() + contour.fSegStart;
+            fSegCount = contour.fSegCount;
+        } else {
+            // Same as buildSegments() once the path is exhausted.
+            fLength = 0;
+            fIsClosed = fForceClosed;
+            fSegs = nullptr;
+            fSegCount = 0;
+        }
+        fSegPts = fContours->fPts.begin();
+    } else {
+        (void)this->buildSegments();
+        fSegs = fSegments.begin();
+        fSegCount = fSegments.count();
+        fSegPts = fPts.begin();
+    }
+    fContourIndex += 1;
 }
 
 static void compute_pos_tan(const SkPoint pts[], int segType,
@@ -480,6 +621,10 @@ SkPathMeasure::SkPathMeasure() {
     fLength = -1;   // signal we need to compute it
     fForceClosed = false;
     fFirstPtIndex = -1;
+    fContourIndex = 0;
+    fSegs = nullptr;
+    fSegCount = 0;
+    fSegPts = nullptr;
 }
 
 SkPathMeasure::SkPathMeasure(const SkPath& path, bool forceClosed, SkScalar resScale) {
@@ -488,6 +633,10 @@ SkPathMeasure::SkPathMeasure(const SkPath& path, bool forceClosed, SkScalar resS
     fLength = -1;   // signal we need to compute it
     fForceClosed = forceClosed;
     fFirstPtIndex = -1;
+    fContourIndex = 0;
+    fSegs = nullptr;
+    fSegCount = 0;
+    fSegPts = nullptr;
 
     fIter.setPath(path, forceClosed);
 }
@@ -501,12 +650,17 @@ void SkPathMeasure::setPath(const SkPath* path, bool forceClosed) {
     fLength = -1;   // signal we need to compute it
     fForceClosed = forceClosed;
     fFirstPtIndex = -1;
+    fContourIndex = 0;
 
     if (path) {
         fIter.setPath(*path, forceClosed);
     }
     fSegments.reset();
     fPts.reset();
+    fContours.reset();
+    fSegs = nullptr;
+    fSegCount = 0;
+    fSegPts = nullptr;
 }
 
 SkScalar SkPathMeasure::getLength() {
@@ -514,7 +668,7 @@ SkScalar SkPathMeasure::getLength() {
         return 0;
     }
     if (fLength < 0) {
-        this->buildSegments();
+        this->nextContourSegments();
     }
     SkASSERT(fLength >= 0);
     return fLength;
@@ -555,13 +709,15 @@ const SkPathMeasure::Segment* SkPathMeasure::distanceToSegment(
     SkDEBUGCODE(SkScalar length = ) this->getLength();
     SkASSERT(distance >= 0 && distance <= length);
 
-    const Segment*  seg = fSegments.begin();
-    int             count = fSegments.count();
-
-    int index = SkTKSearch<Segment, SkScalar>(seg, count, distance);
+    int index = SkTKSearch<Segment, SkScalar>(fSegs, fSegCount, distance);
     // don't care if we hit an exact match or not, so we xor index if it is negative
     index ^= (index >> 31);
-    seg = &seg[index];
+    return this->segmentForIndex(index, distance, t);
+}
+
+const SkPathMeasure::Segment* SkPathMeasure::segmentForIndex(
+                                int index, SkScalar distance, SkScalar* t) const {
+    const Segment* seg = &fSegs[index];
 
     // now interpolate t-values with the prev segment (if possible)
     SkScalar    startT = 0, startD = 0;
@@ -591,7 +747,7 @@ bool SkPathMeasure::getPosTan(SkScalar distance, SkPoint* pos,
     }
 
     SkScalar    length = this->getLength(); // call this to force computing it
-    int         count = fSegments.count();
+    int         count = fSegCount;
 
     if (count == 0 || length == 0) {
         return false;
@@ -607,7 +763,47 @@ bool SkPathMeasure::getPosTan(SkScalar distance, SkPoint* pos,
     SkScalar        t;
     const Segment*  seg = this->distanceToSegment(distance, &t);
 
-    compute_pos_tan(&fPts[seg->fPtIndex], seg->fType, t, pos, tangent);
+    compute_pos_tan(&fSegPts[seg->fPtIndex], seg->fType, t, pos, tangent);
+    return true;
+}
+
+bool SkPathMeasure::getPosTan(const SkScalar distances[], int count,
+                              SkPoint positions[], SkVector tangents[]) {
+    if (nullptr == fPath) {
+        return false;
+    }
+
+    SkScalar    length = this->getLength(); // call this to force computing it
+
+    if (fSegCount == 0 || length == 0) {
+        return false;
+    }
+
+    int         index = 0;
+    SkScalar    prevDistance = 0;
+    for (int i = 0; i < count; ++i) {
+        // pin the distance to a legal range
+        SkScalar distance = SkTPin(distances[i], 0.0f, length);
+
+        if (distance < prevDistance) {
+            // out of order, so fall back to searching
+            index = SkTKSearch<Segment, SkScalar>(fSegs, fSegCount, distance);
+            index ^= (index >> 31);
+        } else {
+            // same segment as the binary search in distanceToSegment() would find
+            while (index < fSegCount - 1 && fSegs[index].fDistance < distance) {
+                index += 1;
+            }
+        }
+        prevDistance = distance;
+
+        SkScalar        t;
+        const Segment*  seg = this->segmentForIndex(index, distance, &t);
+
+        compute_pos_tan(&fSegPts[seg->fPtIndex], seg->fType, t,
+                        positions ? &positions[i] : nullptr,
+                        tangents ? &tangents[i] : nullptr);
+    }
     return true;
 }
 
@@ -651,7 +847,7 @@ bool SkPathMeasure::getSegment(SkScalar startD, SkScalar stopD, SkPath* dst,
     if (startD > stopD) {
         return false;
     }
-    if (!fSegments.count()) {
+    if (!fSegCount) {
         return false;
     }
 
@@ -662,19 +858,19 @@ bool SkPathMeasure::getSegment(SkScalar startD, SkScalar stopD, SkPath* dst,
     SkASSERT(seg <= stopSeg);
 
     if (startWithMoveTo) {
-        compute_pos_tan(&fPts[seg->fPtIndex], seg->fType, startT, &p, nullptr);
+        compute_pos_tan(&fSegPts[seg->fPtIndex], seg->fType, startT, &p, nullptr);
         dst->moveTo(p);
     }
 
     if (seg->fPtIndex == stopSeg->fPtIndex) {
-        seg_to(&fPts[seg->fPtIndex], seg->fType, startT, stopT, dst);
+        seg_to(&fSegPts[seg->fPtIndex], seg->fType, startT, stopT, dst);
     } else {
         do {
-            seg_to(&fPts[seg->fPtIndex], seg->fType, startT, SK_Scalar1, dst);
+            seg_to(&fSegPts[seg->fPtIndex], seg->fType, startT, SK_Scalar1, dst);
             seg = SkPathMeasure::NextSegment(seg);
             startT = 0;
         } while (seg->fPtIndex < stopSeg->fPtIndex);
-        seg_to(&fPts[seg->fPtIndex], seg->fType, 0, stopT, dst);
+        seg_to(&fSegPts[seg->fPtIndex], seg->fType, 0, stopT, dst);
     }
     return true;
 }
@@ -698,10 +894,10 @@ bool SkPathMeasure::nextContour() {
 #ifdef SK_DEBUG
 
 void SkPathMeasure::dump() {
-    SkDebugf("pathmeas: length=%g, segs=%d\n", fLength, fSegments.count());
+    SkDebugf("pathmeas: length=%g, segs=%d\n", fLength, fSegCount);
 
-    for (int i = 0; i < fSegments.count(); i++) {
-        const Segment* seg = &fSegments[i];
+    for (int i = 0; i < fSegCount; i++) {
+        const Segment* seg = &fSegs[i];
         SkDebugf("pathmeas: seg[%d] distance=%g, point=%d, t=%g, type=%d\n",
                 i, seg->fDistance, seg->fPtIndex, seg->getScalarT(),
                  seg->fType);
@@ -668,6 +668,51 @@ uint8_t SkPathRef::Iter::next(SkPoint pts[4]) {
     return (uint8_t) verb;
 }
 
+uint8_t SkPathRef::Iter::nextRun(const SkPoint** pts, int* count) {
+    SkASSERT(pts && count);
+    if (fVerbs == fVerbStop) {
+        *count = 0;
+        return (uint8_t) SkPath::kDone_Verb;
+    }
+
+    // fVerbs points one beyond next verb so decrement first.
+    unsigned verb = *(--fVerbs);
+    int segments = 1;
+    int ptsPerSegment = 0;
+
+    switch (verb) {
+        case SkPath::kMove_Verb:
+            *pts = fPts;
+            fPts += 1;
+            break;
+        case SkPath::kCubic_Verb:
+            ptsPerSegment += 1;
+            // fall-through
+        case SkPath::kQuad_Verb:
+            ptsPerSegment += 1;
+            // fall-through
+        case SkPath::kLine_Verb:
+            ptsPerSegment += 1;
+            while (fVerbs != fVerbStop && fVerbs[-1] == verb) {
+                --fVerbs;
+                ++segments;
+            }
+            *pts = fPts - 1;
+            fPts += segments * ptsPerSegment;
+            break;
+        case SkPath::kConic_Verb:
+            fConicWeights += 1;
+            *pts = fPts - 1;
+            fPts += 2;
+            break;
+        case SkPath::kClose_Verb:
+            *pts = nullptr;
+            break;
+    }
+    *count = segments;
+    return (uint8_t) verb;
+}
+
 uint8_t SkPathRef::Iter::peek() const {
     const uint8_t* next = fVerbs - 1;
     return next <= fVerbStop ? (uint8_t) SkPath::kDone_Verb : *next;
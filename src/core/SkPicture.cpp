@@ -6,6 +6,7 @@
  */
 
 #include "SkAtomics.h"
+#include "SkCanvas.h"
 #include "SkImageGenerator.h"
 #include "SkMessageBus.h"
 #include "SkPicture.h"
@@ -13,6 +14,10 @@
 #include "SkPicturePlayback.h"
 #include "SkPictureRecord.h"
 #include "SkPictureRecorder.h"
+#include "SkPlaybackPicture.h"
+#include "SkReadBuffer.h"
+#include "SkStream.h"
+#include "SkTaskGroup.h"
 
 #if defined(SK_DISALLOW_CROSSPROCESS_PICTUREIMAGEFILTERS) || \
     defined(SK_ENABLE_PICTURE_IO_SECURITY_PRECAUTIONS)
@@ -54,6 +59,34 @@ uint32_t SkPicture::uniqueID() const {
     return id;
 }
 
+void SkPicture::playbackInBands(const SkBitmap& dst, const SkMatrix* matrix,
+                                int bandCount) const {
+    static const int kDefaultBandHeight = 128;
+    const int height = dst.height();
+    if (height <= 0 || dst.width() <= 0) {
+        return;
+    }
+    if (bandCount <= 0) {
+        bandCount = (height + kDefaultBandHeight - 1) / kDefaultBandHeight;
+    }
+    bandCount = SkTMin(bandCount, height);
+
+    SkTaskGroup().batch(bandCount, [&](int i) {
+        const int top    = (int)(sk_64_mul(height, i    ) / bandCount),
+                  bottom = (int)(sk_64_mul(height, i + 1) / bandCount);
+        SkBitmap band;
+        if (!dst.extractSubset(&band, SkIRect::MakeLTRB(0, top, dst.width(), bottom))) {
+            return;
+        }
+        SkCanvas canvas(band);
+        canvas.translate(0, -SkIntToScalar(top));
+        if (matrix) {
+            canvas.concat(*matrix);
+        }
+        this->playback(&canvas);
+    });
+}
+
 static const char kMagic[] = { 's', 'k', 'i', 'a', 'p', 'i', 'c', 't' };
 
 SkPictInfo SkPicture::createHeader() const {
@@ -93,16 +126,22 @@ bool SkPicture::InternalOnly_StreamIsSKP(SkStream* stream, SkPictInfo* pInfo) {
 
     SkPictInfo info;
     SkASSERT(sizeof(kMagic) == sizeof(info.fMagic));
-    if (!stream->read(&info.fMagic, sizeof(kMagic))) {
+    if (stream->read(&info.fMagic, sizeof(kMagic)) != sizeof(kMagic)) {
         return false;
     }
 
-    info.fVersion          = stream->readU32();
-    info.fCullRect.fLeft   = stream->readScalar();
-    info.fCullRect.fTop    = stream->readScalar();
-    info.fCullRect.fRight  = stream->readScalar();
-    info.fCullRect.fBottom = stream->readScalar();
-    info.fFlags            = stream->readU32();
+    // Read the rest in one go, so a truncated stream is rejected rather than read past.
+    struct {
+        uint32_t fVersion;
+        SkRect   fCullRect;
+        uint32_t fFlags;
+    } header;
+    if (stream->read(&header, sizeof(header)) != sizeof(header)) {
+        return false;
+    }
+    info.fVersion  = header.fVersion;
+    info.fCullRect = header.fCullRect;
+    info.fFlags    = header.fFlags;
 
     if (IsValidPictInfo(info)) {
         if (pInfo) { *pInfo = info; }
@@ -129,6 +168,21 @@ bool SkPicture::InternalOnly_BufferIsSKP(SkReadBuffer* buffer, SkPictInfo* pInfo
     return false;
 }
 
+// Since V47 the bool following the header is padded out to 4 bytes, so that a picture
+// serialized to the start of a buffer or file has its op data 4-byte aligned there.
+static const uint8_t kHeaderPadding[3] = { 0, 0, 0 };
+
+static bool read_has_data(SkStream* stream, const SkPictInfo& info) {
+    uint8_t hasData;
+    if (stream->read(&hasData, sizeof(hasData)) != sizeof(hasData) || !hasData) {
+        return false;
+    }
+    if (info.fVersion >= SkReadBuffer::kPaddedPictureHeader_Version) {
+        return stream->skip(sizeof(kHeaderPadding)) == sizeof(kHeaderPadding);
+    }
+    return true;
+}
+
 sk_sp<SkPicture> SkPicture::Forwardport(const SkPictInfo& info,
                                         const SkPictureData* data,
                                         const SkReadBuffer* buffer) {
@@ -148,22 +202,59 @@ static bool default_install(const void* src, size_t length, SkBitmap* dst) {
 }
 
 sk_sp<SkPicture> SkPicture::MakeFromStream(SkStream* stream) {
-    return MakeFromStream(stream, &default_install, nullptr);
+    return MakeFromStream(stream, &default_install, nullptr, nullptr);
 }
 
 sk_sp<SkPicture> SkPicture::MakeFromStream(SkStream* stream, InstallPixelRefProc proc) {
-    return MakeFromStream(stream, proc, nullptr);
+    return MakeFromStream(stream, proc, nullptr, nullptr);
 }
 
 sk_sp<SkPicture> SkPicture::MakeFromStream(SkStream* stream, InstallPixelRefProc proc,
+                                           SkImageReferenceResolver* resolver) {
+    return MakeFromStream(stream, proc, resolver, nullptr);
+}
+
+sk_sp<SkPicture> SkPicture::MakeFromStream(SkStream* stream, InstallPixelRefProc proc,
+                                           SkImageReferenceResolver* resolver,
                                            SkTypefacePlayback* typefaces) {
     SkPictInfo info;
-    if (!InternalOnly_StreamIsSKP(stream, &info) || !stream->readBool()) {
+    SkAutoTDelete<SkPictureData> data(ReadFromStream(stream, proc, resolver, typefaces, &info));
+    return Forwardport(info, data, nullptr);
+}
+
+SkPictureData* SkPicture::ReadFromStream(SkStream* stream, InstallPixelRefProc proc,
+                                         SkImageReferenceResolver* resolver,
+                                         SkTypefacePlayback* typefaces, SkPictInfo* info) {
+    if (!InternalOnly_StreamIsSKP(stream, info) || !read_has_data(stream, *info)) {
         return nullptr;
     }
-    SkAutoTDelete<SkPictureData> data(
-            SkPictureData::CreateFromStream(stream, info, proc, typefaces));
-    return Forwardport(info, data, nullptr);
+    return SkPictureData::CreateFromStream(stream, *info, proc, resolver, typefaces);
+}
+
+sk_sp<SkPicture> SkPicture::MakeFromData(sk_sp<SkData> data) {
+    return MakeFromData(std::move(data), &default_install);
+}
+
+sk_sp<SkPicture> SkPicture::MakeFromData(sk_sp<SkData> data, InstallPixelRefProc proc) {
+    return MakeFromData(std::move(data), proc, nullptr);
+}
+
+sk_sp<SkPicture> SkPicture::MakeFromData(sk_sp<SkData> data, InstallPixelRefProc proc,
+                                         SkImageReferenceResolver* resolver) {
+    if (!data) {
+        return nullptr;
+    }
+    SkMemoryStream stream(data);
+    SkPictInfo info;
+    if (!InternalOnly_StreamIsSKP(&stream, &info) || !read_has_data(&stream, info)) {
+        return nullptr;
+    }
+    SkAutoTDelete<SkPictureData> pictureData(
+            SkPictureData::CreateFromStream(&stream, info, proc, resolver, nullptr, data.get()));
+    if (!pictureData || !pictureData->opData()) {
+        return nullptr;
+    }
+    return sk_make_sp<SkPlaybackPicture>(info, pictureData.release());
 }
 
 sk_sp<SkPicture> SkPicture::MakeFromBuffer(SkReadBuffer& buffer) {
@@ -195,11 +286,10 @@ void SkPicture::serialize(SkWStream* stream,
     SkAutoTDelete<SkPictureData> data(this->backport());
 
     stream->write(&info, sizeof(info));
+    stream->writeBool(data.get() != nullptr);
+    stream->write(kHeaderPadding, sizeof(kHeaderPadding));
     if (data) {
-        stream->writeBool(true);
         data->serialize(stream, pixelSerializer, typefaceSet);
-    } else {
-        stream->writeBool(false);
     }
 }
 
@@ -22,7 +22,10 @@ inline bool veto_predicate(uint32_t numSlowPaths) {
 } // anonymous namespace
 
 SkPictureGpuAnalyzer::SkPictureGpuAnalyzer(sk_sp<GrContextThreadSafeProxy> /* unused ATM */)
-    : fNumSlowPaths(0) { }
+    : fNumSlowPaths(0)
+    , fNumPathVerbs(0)
+    , fNumLayers(0)
+    , fPixelCoverage(0) { }
 
 SkPictureGpuAnalyzer::SkPictureGpuAnalyzer(const sk_sp<SkPicture>& picture,
                                            sk_sp<GrContextThreadSafeProxy> ctx)
@@ -35,7 +38,11 @@ void SkPictureGpuAnalyzer::analyzePicture(const SkPicture* picture) {
         return;
     }
 
-    fNumSlowPaths += picture->numSlowPaths();
+    const SkPictureCost cost = picture->cost();
+    fNumSlowPaths  += cost.fNumSlowPaths;
+    fNumPathVerbs  += cost.fNumPathVerbs;
+    fNumLayers     += cost.fNumLayers;
+    fPixelCoverage += cost.fPixelCoverage;
 }
 
 void SkPictureGpuAnalyzer::analyzeClipPath(const SkPath& path, SkRegion::Op op, bool doAntiAlias) {
@@ -45,13 +52,17 @@ void SkPictureGpuAnalyzer::analyzeClipPath(const SkPath& path, SkRegion::Op op,
         SkRecords::RegionOpAndAA(op, doAntiAlias)
     };
 
-    SkPathCounter counter;
+    SkPictureCostCounter counter;
     counter(clipOp);
-    fNumSlowPaths += counter.fNumSlowPathsAndDashEffects;
+    fNumSlowPaths += counter.fCost.fNumSlowPaths;
+    fNumPathVerbs += counter.fCost.fNumPathVerbs;
 }
 
 void SkPictureGpuAnalyzer::reset() {
-    fNumSlowPaths = 0;
+    fNumSlowPaths  = 0;
+    fNumPathVerbs  = 0;
+    fNumLayers     = 0;
+    fPixelCoverage = 0;
 }
 
 bool SkPictureGpuAnalyzer::suitableForGpuRasterization(const char** whyNot) const {
@@ -5,10 +5,14 @@
  * found in the LICENSE file.
  */
 
+#ifndef SkPictureCommon_DEFINED
+#define SkPictureCommon_DEFINED
+
 // Some shared code used by both SkBigPicture and SkMiniPicture.
-//   SkTextHunter   -- SkRecord visitor that returns true when the op draws text.
-//   SkBitmapHunter -- SkRecord visitor that returns true when the op draws a bitmap or image.
-//   SkPathCounter  -- SkRecord visitor that counts paths that draw slowly on the GPU.
+//   SkTextHunter         -- SkRecord visitor that returns true when the op draws text.
+//   SkBitmapHunter       -- SkRecord visitor that returns true when the op draws a bitmap or image.
+//   SkPathCounter        -- SkRecord visitor that counts paths that draw slowly on the GPU.
+//   SkPictureCostCounter -- SkRecord visitor that estimates how much work the ops are to draw.
 
 #include "SkPathEffect.h"
 #include "SkRecords.h"
@@ -16,10 +20,6 @@
 
 // N.B. This name is slightly historical: hunting season is now open for SkImages too.
 struct SkBitmapHunter {
-    // Some ops have a paint, some have an optional paint.  Either way, get back a pointer.
-    static const SkPaint* AsPtr(const SkPaint& p) { return &p; }
-    static const SkPaint* AsPtr(const SkRecords::Optional<SkPaint>& p) { return p; }
-
     // Main entry for visitor:
     // If the op is a DrawPicture, recurse.
     // If the op has a bitmap or image directly, return true.
@@ -46,12 +46,12 @@ struct SkBitmapHunter {
     // Most draws-type ops have paints.
     template <typename T>
     static SK_WHEN(T::kTags & SkRecords::kDraw_Tag, bool) CheckPaint(const T& op) {
-        return PaintHasBitmap(AsPtr(op.paint));
+        return PaintHasBitmap(op.paint);
     }
 
     // SaveLayers also have a paint to check.
     static bool CheckPaint(const SkRecords::SaveLayer& op) {
-        return PaintHasBitmap(AsPtr(op.paint));
+        return PaintHasBitmap(op.paint);
     }
 
     // Shouldn't be any non-Draw non-SaveLayer ops with paints.
@@ -74,10 +74,6 @@ private:
 
 // TODO: might be nicer to have operator() return an int (the number of slow paths) ?
 struct SkPathCounter {
-    // Some ops have a paint, some have an optional paint.  Either way, get back a pointer.
-    static const SkPaint* AsPtr(const SkPaint& p) { return &p; }
-    static const SkPaint* AsPtr(const SkRecords::Optional<SkPaint>& p) { return p; }
-
     SkPathCounter() : fNumSlowPathsAndDashEffects(0) {}
 
     // Recurse into nested pictures.
@@ -94,12 +90,12 @@ struct SkPathCounter {
     }
 
     void operator()(const SkRecords::DrawPoints& op) {
-        this->checkPaint(&op.paint);
-        const SkPathEffect* effect = op.paint.getPathEffect();
+        this->checkPaint(op.paint);
+        const SkPathEffect* effect = op.paint->getPathEffect();
         if (effect) {
             SkPathEffect::DashInfo info;
             SkPathEffect::DashType dashType = effect->asADash(&info);
-            if (2 == op.count && SkPaint::kRound_Cap != op.paint.getStrokeCap() &&
+            if (2 == op.count && SkPaint::kRound_Cap != op.paint->getStrokeCap() &&
                 SkPathEffect::kDash_DashType == dashType && 2 == info.fCount) {
                 fNumSlowPathsAndDashEffects--;
             }
@@ -107,12 +103,12 @@ struct SkPathCounter {
     }
 
     void operator()(const SkRecords::DrawPath& op) {
-        this->checkPaint(&op.paint);
-        if (op.paint.isAntiAlias() && !op.path.isConvex()) {
-            SkPaint::Style paintStyle = op.paint.getStyle();
+        this->checkPaint(op.paint);
+        if (op.paint->isAntiAlias() && !op.path.isConvex()) {
+            SkPaint::Style paintStyle = op.paint->getStyle();
             const SkRect& pathBounds = op.path.getBounds();
             if (SkPaint::kStroke_Style == paintStyle &&
-                0 == op.paint.getStrokeWidth()) {
+                0 == op.paint->getStrokeWidth()) {
                 // AA hairline concave path is not slow.
             } else if (SkPaint::kFill_Style == paintStyle && pathBounds.width() < 64.f &&
                        pathBounds.height() < 64.f && !op.path.isVolatile()) {
@@ -131,12 +127,12 @@ struct SkPathCounter {
     }
 
     void operator()(const SkRecords::SaveLayer& op) {
-        this->checkPaint(AsPtr(op.paint));
+        this->checkPaint(op.paint);
     }
 
     template <typename T>
     SK_WHEN(T::kTags & SkRecords::kDraw_Tag, void) operator()(const T& op) {
-        this->checkPaint(AsPtr(op.paint));
+        this->checkPaint(op.paint);
     }
 
     template <typename T>
@@ -144,3 +140,100 @@ struct SkPathCounter {
 
     int fNumSlowPathsAndDashEffects;
 };
+
+// Rough estimates of how much work a picture is to draw, as reported by SkPictureGpuAnalyzer.
+struct SkPictureCost {
+    SkPictureCost() : fNumSlowPaths(0), fNumPathVerbs(0), fNumLayers(0), fPixelCoverage(0) {}
+
+    int    fNumSlowPaths;   // Paths and path effects that draw slowly on the GPU.
+    int    fNumPathVerbs;   // Verbs in all the paths drawn or clipped to.
+    int    fNumLayers;      // saveLayer()s, each drawn offscreen then composited.
+    double fPixelCoverage;  // The sum of the areas of all draws, so overdraw counts every time.
+};
+
+// Call setBounds() with each op's bounds in picture space (see SkRecordFillBounds()) before
+// visiting it.  Nested pictures contribute their own, cached, costs.  DrawDrawable ops are played
+// back as the drawablePicts snapshots taken when recording finished, so those cost the same way.
+struct SkPictureCostCounter {
+    explicit SkPictureCostCounter(SkPicture const* const* drawablePicts = nullptr,
+                                  int drawableCount = 0)
+        : fDrawablePicts(drawablePicts)
+        , fDrawableCount(drawableCount)
+        , fNumNestedSlowPaths(0)
+        , fBounds(SkRect::MakeEmpty()) {}
+
+    void setBounds(const SkRect& bounds) { fBounds = bounds; }
+
+    template <typename T>
+    void operator()(const T& op) {
+        fPaths(op);
+        this->count(op);
+        fCost.fNumSlowPaths = fPaths.fNumSlowPathsAndDashEffects + fNumNestedSlowPaths;
+    }
+
+    SkPictureCost fCost;
+
+private:
+    static double Area(const SkRect& r) {
+        return r.isEmpty() ? 0 : (double)r.width() * r.height();
+    }
+
+    // A nested picture's coverage is scaled by how much of its cull rect we end up drawing.
+    // (fPaths already counts its slow paths.)
+    void count(const SkRecords::DrawPicture& op) {
+        this->countNested(op.picture);
+    }
+
+    // A drawable costs what its snapshot does.  Without one we can't know what it draws, so
+    // assume the worst: it covers all of its bounds, and draws as slowly as a slow path.
+    void count(const SkRecords::DrawDrawable& op) {
+        if (op.index >= 0 && op.index < fDrawableCount) {
+            this->countNested(fDrawablePicts[op.index]);
+            fNumNestedSlowPaths += fDrawablePicts[op.index]->numSlowPaths();
+        } else {
+            fNumNestedSlowPaths++;
+            fCost.fPixelCoverage += Area(fBounds);
+        }
+    }
+
+    void countNested(const SkPicture* picture) {
+        const SkPictureCost nested = picture->cost();
+        fCost.fNumPathVerbs += nested.fNumPathVerbs;
+        fCost.fNumLayers    += nested.fNumLayers;
+        const double cullArea = Area(picture->cullRect());
+        if (cullArea > 0) {
+            fCost.fPixelCoverage += Area(fBounds) * (nested.fPixelCoverage / cullArea);
+        }
+    }
+
+    void count(const SkRecords::DrawPath& op) {
+        fCost.fNumPathVerbs  += op.path.countVerbs();
+        fCost.fPixelCoverage += Area(fBounds);
+    }
+    void count(const SkRecords::DrawTextOnPath& op) {
+        fCost.fNumPathVerbs  += op.path.countVerbs();
+        fCost.fPixelCoverage += Area(fBounds);
+    }
+    void count(const SkRecords::ClipPath& op) {
+        fCost.fNumPathVerbs += op.path.countVerbs();
+    }
+    void count(const SkRecords::SaveLayer&) {
+        fCost.fNumLayers++;
+    }
+
+    template <typename T>
+    SK_WHEN(T::kTags & SkRecords::kDraw_Tag, void) count(const T&) {
+        fCost.fPixelCoverage += Area(fBounds);
+    }
+
+    template <typename T>
+    SK_WHEN(!(T::kTags & SkRecords::kDraw_Tag), void) count(const T&) { /* do nothing */ }
+
+    SkPicture const* const* fDrawablePicts;
+    int                     fDrawableCount;
+    int                     fNumNestedSlowPaths;  // From drawables; fPaths counts pictures'.
+    SkPathCounter           fPaths;
+    SkRect                  fBounds;
+};
+
+#endif//SkPictureCommon_DEFINED
@@ -9,6 +9,7 @@
 #include "SkPictureData.h"
 #include "SkPictureRecord.h"
 #include "SkReadBuffer.h"
+#include "SkTaskGroup.h"
 #include "SkTextBlob.h"
 #include "SkTypeface.h"
 #include "SkWriteBuffer.h"
@@ -362,11 +363,27 @@ static uint32_t pictInfoFlagsToReadBufferFlags(uint32_t pictInfoFlags) {
     return rbMask;
 }
 
+// If stream is reading straight out of backing's memory, returns the next size bytes in place,
+// as long as they're aligned well enough for SkReadBuffer.  Otherwise, returns nullptr.
+static const void* peek_backing(SkStream* stream, const SkData* backing, size_t size) {
+    if (!backing || !stream->hasPosition() || stream->getMemoryBase() != backing->data()) {
+        return nullptr;
+    }
+    const size_t offset = stream->getPosition();
+    if (offset > backing->size() || size > backing->size() - offset) {
+        return nullptr;
+    }
+    const uint8_t* bytes = backing->bytes() + offset;
+    return SkIsAlign4((uintptr_t)bytes) ? bytes : nullptr;
+}
+
 bool SkPictureData::parseStreamTag(SkStream* stream,
                                    uint32_t tag,
                                    uint32_t size,
                                    SkPicture::InstallPixelRefProc proc,
-                                   SkTypefacePlayback* topLevelTFPlayback) {
+                                   SkImageReferenceResolver* resolver,
+                                   SkTypefacePlayback* topLevelTFPlayback,
+                                   const SkData* backing) {
     /*
      *  By the time we encounter BUFFER_SIZE_TAG, we need to have already seen
      *  its dependents: FACTORY_TAG and TYPEFACE_TAG. These two are not required
@@ -381,7 +398,13 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
     switch (tag) {
         case SK_PICT_READER_TAG:
             SkASSERT(nullptr == fOpData);
-            fOpData = SkData::MakeFromStream(stream, size);
+            if (const void* ops = peek_backing(stream, backing, size)) {
+                // Share the ops with backing (e.g. a mapped file) instead of copying them.
+                fOpData = SkData::MakeSubset(backing, (const uint8_t*)ops - backing->bytes(), size);
+                stream->skip(size);
+            } else {
+                fOpData = SkData::MakeFromStream(stream, size);
+            }
             if (!fOpData) {
                 return false;
             }
@@ -417,22 +440,51 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
         case SK_PICT_PICTURE_TAG: {
             fPictureCount = 0;
             fPictureRefs = new const SkPicture* [size];
+
+            // Only reading the stream has to be serial. Playing each sub-picture back into a
+            // new picture is most of the work, and they don't depend on each other.
+            SkTArray<SkPictInfo> infos;
+            SkTArray<SkAutoTDelete<SkPictureData>> datas;
             for (uint32_t i = 0; i < size; i++) {
-                fPictureRefs[i] = SkPicture::MakeFromStream(stream, proc, topLevelTFPlayback).release();
-                if (!fPictureRefs[i]) {
+                SkPictInfo& info = infos.push_back();
+                SkPictureData* data = SkPicture::ReadFromStream(stream, proc, resolver,
+                                                                topLevelTFPlayback, &info);
+                if (!data) {
                     return false;
                 }
-                fPictureCount++;
+                datas.push_back().reset(data);
+            }
+            SkTaskGroup().batch(size, [&](int i) {
+                fPictureRefs[i] = SkPicture::Forwardport(infos[i], datas[i], nullptr).release();
+                datas[i].reset(nullptr);
+            });
+
+            bool success = true;
+            for (uint32_t i = 0; i < size; i++) {
+                success &= (nullptr != fPictureRefs[i]);
             }
+            if (!success) {
+                for (uint32_t i = 0; i < size; i++) {
+                    SkSafeUnref(fPictureRefs[i]);
+                }
+                return false;
+            }
+            fPictureCount = size;
         } break;
         case SK_PICT_BUFFER_SIZE_TAG: {
-            SkAutoMalloc storage(size);
-            if (stream->read(storage.get(), size) != size) {
-                return false;
+            SkAutoMalloc storage;
+            const void* bytes = peek_backing(stream, backing, size);
+            if (bytes) {
+                stream->skip(size);
+            } else {
+                bytes = storage.reset(size);
+                if (stream->read(storage.get(), size) != size) {
+                    return false;
+                }
             }
 
             /* Should we use SkValidatingReadBuffer instead? */
-            SkReadBuffer buffer(storage.get(), size);
+            SkReadBuffer buffer(bytes, size);
             buffer.setFlags(pictInfoFlagsToReadBufferFlags(fInfo.fFlags));
             buffer.setVersion(fInfo.fVersion);
 
@@ -441,6 +493,7 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
             }
             fFactoryPlayback->setupBuffer(buffer);
             buffer.setBitmapDecoder(proc);
+            buffer.setImageReferenceResolver(resolver);
 
             if (fTFPlayback.count() > 0) {
                 // .skp files <= v43 have typefaces serialized with each sub picture.
@@ -586,15 +639,18 @@ bool SkPictureData::parseBufferTag(SkReadBuffer& buffer, uint32_t tag, uint32_t
 SkPictureData* SkPictureData::CreateFromStream(SkStream* stream,
                                                const SkPictInfo& info,
                                                SkPicture::InstallPixelRefProc proc,
-                                               SkTypefacePlayback* topLevelTFPlayback) {
+                                               SkImageReferenceResolver* resolver,
+                                               SkTypefacePlayback* topLevelTFPlayback,
+                                               const SkData* backing) {
     SkAutoTDelete<SkPictureData> data(new SkPictureData(info));
     if (!topLevelTFPlayback) {
         topLevelTFPlayback = &data->fTFPlayback;
     }
 
-    if (!data->parseStream(stream, proc, topLevelTFPlayback)) {
+    if (!data->parseStream(stream, proc, resolver, topLevelTFPlayback, backing)) {
         return nullptr;
     }
+    data->initForPlayback();
     return data.release();
 }
 
@@ -611,15 +667,25 @@ SkPictureData* SkPictureData::CreateFromBuffer(SkReadBuffer& buffer,
 
 bool SkPictureData::parseStream(SkStream* stream,
                                 SkPicture::InstallPixelRefProc proc,
-                                SkTypefacePlayback* topLevelTFPlayback) {
+                                SkImageReferenceResolver* resolver,
+                                SkTypefacePlayback* topLevelTFPlayback,
+                                const SkData* backing) {
     for (;;) {
-        uint32_t tag = stream->readU32();
+        // A truncated stream ends before we see SK_PICT_EOF_TAG.
+        uint32_t tag;
+        if (stream->read(&tag, sizeof(tag)) != sizeof(tag)) {
+            return false;
+        }
         if (SK_PICT_EOF_TAG == tag) {
             break;
         }
 
-        uint32_t size = stream->readU32();
-        if (!this->parseStreamTag(stream, tag, size, proc, topLevelTFPlayback)) {
+        uint32_t size;
+        if (stream->read(&size, sizeof(size)) != sizeof(size)) {
+            return false;
+        }
+        if (!this->parseStreamTag(stream, tag, size, proc, resolver, topLevelTFPlayback,
+                                  backing)) {
             return false; // we're invalid
         }
     }
@@ -61,11 +61,14 @@ struct SkPictInfo {
 class SkPictureData {
 public:
     SkPictureData(const SkPictureRecord& record, const SkPictInfo&);
-    // Does not affect ownership of SkStream.
+    // Does not affect ownership of SkStream.  If the stream reads from backing's memory,
+    // the op data is shared with backing rather than copied.
     static SkPictureData* CreateFromStream(SkStream*,
                                            const SkPictInfo&,
                                            SkPicture::InstallPixelRefProc,
-                                           SkTypefacePlayback*);
+                                           SkImageReferenceResolver*,
+                                           SkTypefacePlayback*,
+                                           const SkData* backing = nullptr);
     static SkPictureData* CreateFromBuffer(SkReadBuffer&, const SkPictInfo&);
 
     virtual ~SkPictureData();
@@ -85,7 +88,8 @@ protected:
     explicit SkPictureData(const SkPictInfo& info);
 
     // Does not affect ownership of SkStream.
-    bool parseStream(SkStream*, SkPicture::InstallPixelRefProc, SkTypefacePlayback*);
+    bool parseStream(SkStream*, SkPicture::InstallPixelRefProc, SkImageReferenceResolver*,
+                     SkTypefacePlayback*, const SkData* backing);
     bool parseBuffer(SkReadBuffer& buffer);
 
 public:
@@ -149,7 +153,8 @@ private:
     // these help us with reading/writing
     // Does not affect ownership of SkStream.
     bool parseStreamTag(SkStream*, uint32_t tag, uint32_t size,
-                        SkPicture::InstallPixelRefProc, SkTypefacePlayback*);
+                        SkPicture::InstallPixelRefProc, SkImageReferenceResolver*,
+                        SkTypefacePlayback*, const SkData* backing);
     bool parseBufferTag(SkReadBuffer&, uint32_t tag, uint32_t size);
     void flattenToBuffer(SkWriteBuffer&) const;
 
@@ -139,7 +139,11 @@ GrTexture* SkPictureImageGenerator::onGenerateTexture(GrContext* ctx, const SkIR
     //
     // TODO: respect the usage, by possibly creating a different (pow2) surface
     //
-    sk_sp<SkSurface> surface(SkSurface::MakeRenderTarget(ctx, SkBudgeted::kYes, surfaceInfo));
+    // Render with the same surface props as onGetPixels(), so the texture matches the raster
+    // pixels (no LCD text).  MakeRenderTarget() clears the new surface for us.
+    const SkSurfaceProps props(0, kUnknown_SkPixelGeometry);
+    sk_sp<SkSurface> surface(SkSurface::MakeRenderTarget(ctx, SkBudgeted::kYes, surfaceInfo,
+                                                         0, &props));
     if (!surface) {
         return nullptr;
     }
@@ -148,7 +152,6 @@ GrTexture* SkPictureImageGenerator::onGenerateTexture(GrContext* ctx, const SkIR
     if (subset) {
         matrix.postTranslate(-subset->x(), -subset->y());
     }
-    surface->getCanvas()->clear(0); // does NewRenderTarget promise to do this for us?
     surface->getCanvas()->drawPicture(fPicture, &matrix, fPaint.getMaybeNull());
     sk_sp<SkImage> image(surface->makeImageSnapshot());
     if (!image) {
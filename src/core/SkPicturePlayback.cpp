@@ -118,6 +118,29 @@ void SkPicturePlayback::draw(SkCanvas* canvas,
     }
 }
 
+void SkPicturePlayback::drawRange(SkCanvas* canvas,
+                                  size_t start,
+                                  size_t stop,
+                                  const SkMatrix& initialMatrix) {
+    AutoResetOpID aroi(this);
+    SkASSERT(0 == fCurOffset);
+
+    SkReadBuffer reader(fPictureData->opData()->bytes(), fPictureData->opData()->size());
+    if (!SkIsAlign4(start) || start > reader.size()) {
+        return;
+    }
+    reader.skip(start);
+    fStopOffset = stop;
+
+    while (!reader.eof() && reader.isValid() && reader.offset() < stop) {
+        fCurOffset = reader.offset();
+        uint32_t size;
+        DrawType op = ReadOpAndSize(&reader, &size);
+
+        this->handleOp(&reader, op, size, canvas, initialMatrix);
+    }
+}
+
 void SkPicturePlayback::handleOp(SkReadBuffer* reader,
                                  DrawType op,
                                  uint32_t size,
@@ -136,7 +159,7 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             size_t offsetToRestore = reader->readInt();
             SkASSERT(!offsetToRestore || offsetToRestore >= reader->offset());
             canvas->clipPath(path, regionOp, doAA);
-            if (canvas->isClipEmpty() && offsetToRestore) {
+            if (canvas->isClipEmpty() && offsetToRestore && offsetToRestore < fStopOffset) {
                 reader->skip(offsetToRestore - reader->offset());
             }
         } break;
@@ -148,7 +171,7 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             size_t offsetToRestore = reader->readInt();
             SkASSERT(!offsetToRestore || offsetToRestore >= reader->offset());
             canvas->clipRegion(region, regionOp);
-            if (canvas->isClipEmpty() && offsetToRestore) {
+            if (canvas->isClipEmpty() && offsetToRestore && offsetToRestore < fStopOffset) {
                 reader->skip(offsetToRestore - reader->offset());
             }
         } break;
@@ -161,7 +184,7 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             size_t offsetToRestore = reader->readInt();
             SkASSERT(!offsetToRestore || offsetToRestore >= reader->offset());
             canvas->clipRect(rect, regionOp, doAA);
-            if (canvas->isClipEmpty() && offsetToRestore) {
+            if (canvas->isClipEmpty() && offsetToRestore && offsetToRestore < fStopOffset) {
                 reader->skip(offsetToRestore - reader->offset());
             }
         } break;
@@ -174,7 +197,7 @@ void SkPicturePlayback::handleOp(SkReadBuffer* reader,
             size_t offsetToRestore = reader->readInt();
             SkASSERT(!offsetToRestore || offsetToRestore >= reader->offset());
             canvas->clipRRect(rrect, regionOp, doAA);
-            if (canvas->isClipEmpty() && offsetToRestore) {
+            if (canvas->isClipEmpty() && offsetToRestore && offsetToRestore < fStopOffset) {
                 reader->skip(offsetToRestore - reader->offset());
             }
         } break;
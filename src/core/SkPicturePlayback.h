@@ -20,11 +20,18 @@ class SkPicturePlayback final : SkNoncopyable {
 public:
     SkPicturePlayback(const SkPictureData* data)
         : fPictureData(data)
-        , fCurOffset(0) {
+        , fCurOffset(0)
+        , fStopOffset(SIZE_MAX) {
     }
 
     void draw(SkCanvas* canvas, SkPicture::AbortCallback*, const SkReadBuffer* buffer);
 
+    // Plays back just the ops starting within [start, stop) of the op data.  Unlike draw(), this
+    // leaves any save/clip/matrix state changed by those ops on the canvas, and SetMatrix ops are
+    // relative to initialMatrix rather than the canvas' current matrix.  Used to replay a
+    // picture streamed in pieces (see SkPictureStreamReader).
+    void drawRange(SkCanvas* canvas, size_t start, size_t stop, const SkMatrix& initialMatrix);
+
     // TODO: remove the curOp calls after cleaning up GrGatherDevice
     // Return the ID of the operation currently being executed when playing
     // back. 0 indicates no call is active.
@@ -37,6 +44,10 @@ protected:
     // The offset of the current operation when within the draw method
     size_t fCurOffset;
 
+    // Playback ends before this offset.  An empty clip may only skip ahead to its restore if that
+    // restore is played; otherwise we would skip over saves the restore balances.
+    size_t fStopOffset;
+
     void handleOp(SkReadBuffer* reader,
                   DrawType op,
                   uint32_t size,
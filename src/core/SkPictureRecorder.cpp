@@ -17,6 +17,14 @@
 #include "SkRecorder.h"
 #include "SkTypes.h"
 
+static void optimize(SkRecord* record, uint32_t recordFlags, const SkRect& cullRect) {
+    if (recordFlags & SkPictureRecorder::kOptimizeOverdraw_RecordFlag) {
+        SkRecordOptimizeOverdraw(record, cullRect);
+    } else {
+        SkRecordOptimize(record);
+    }
+}
+
 SkPictureRecorder::SkPictureRecorder() {
     fActivelyRecording = false;
     fRecorder.reset(new SkRecorder(nullptr, SkRect::MakeWH(0, 0), &fMiniRecorder));
@@ -35,6 +43,19 @@ SkCanvas* SkPictureRecorder::beginRecording(const SkRect& cullRect,
         SkASSERT(fBBH.get());
     }
 
+    if (!fRecord && (recordFlags & kReuseRecordMemory_RecordFlag) && fLastRecord) {
+        if (fLastRecord->unique()) {
+            // Whatever we made from fLastRecord is gone, so we can record into its memory again.
+            fLastRecord->reset();
+            fRecord.reset(fLastRecord.release());
+        } else {
+            // It's still in use.  The best we can do is to make room for as much again up front.
+            fRecord.reset(new SkRecord);
+            fRecord->reserve(fLastRecord->count(), fLastRecord->bytesUsed());
+        }
+    }
+    fLastRecord.reset(nullptr);
+
     if (!fRecord) {
         fRecord.reset(new SkRecord);
     }
@@ -62,7 +83,7 @@ sk_sp<SkPicture> SkPictureRecorder::finishRecordingAsPicture(uint32_t finishFlag
     }
 
     // TODO: delay as much of this work until just before first playback?
-    SkRecordOptimize(fRecord);
+    optimize(fRecord, fFlags, fCullRect);
 
     if (fRecord->count() == 0) {
         if (finishFlags & kReturnNullForEmpty_FinishFlag) {
@@ -91,6 +112,9 @@ sk_sp<SkPicture> SkPictureRecorder::finishRecordingAsPicture(uint32_t finishFlag
     for (int i = 0; pictList && i < pictList->count(); i++) {
         subPictureBytes += SkPictureUtils::ApproximateBytesUsed(pictList->begin()[i]);
     }
+    if (fFlags & kReuseRecordMemory_RecordFlag) {
+        fLastRecord.reset(SkRef(fRecord.get()));
+    }
     return sk_make_sp<SkBigPicture>(fCullRect, fRecord.release(), pictList, fBBH.release(),
                                     subPictureBytes);
 }
@@ -122,7 +146,7 @@ sk_sp<SkDrawable> SkPictureRecorder::finishRecordingAsDrawable(uint32_t finishFl
     fRecorder->flushMiniRecorder();
     fRecorder->restoreToCount(1);  // If we were missing any restores, add them now.
 
-    SkRecordOptimize(fRecord);
+    optimize(fRecord, fFlags, fCullRect);
 
     if (fRecord->count() == 0) {
         if (finishFlags & kReturnNullForEmpty_FinishFlag) {
@@ -140,6 +164,9 @@ sk_sp<SkDrawable> SkPictureRecorder::finishRecordingAsDrawable(uint32_t finishFl
          sk_make_sp<SkRecordedDrawable>(fRecord, fBBH, fRecorder->detachDrawableList(), fCullRect);
 
     // release our refs now, so only the drawable will be the owner.
+    if (fFlags & kReuseRecordMemory_RecordFlag) {
+        fLastRecord.reset(fRecord.release());
+    }
     fRecord.reset(nullptr);
     fBBH.reset(nullptr);
 
@@ -99,7 +99,8 @@ SkPictureShader::SkPictureShader(sk_sp<SkPicture> picture, TileMode tmx, TileMod
     , fPicture(std::move(picture))
     , fTile(tile ? *tile : fPicture->cullRect())
     , fTmx(tmx)
-    , fTmy(tmy) {
+    , fTmy(tmy)
+    , fLastScaleBits(0) {
 }
 
 sk_sp<SkShader> SkPictureShader::Make(sk_sp<SkPicture> picture, TileMode tmx, TileMode tmy,
@@ -155,28 +156,10 @@ void SkPictureShader::flatten(SkWriteBuffer& buffer) const {
     }
 }
 
-sk_sp<SkShader> SkPictureShader::refBitmapShader(const SkMatrix& viewMatrix, const SkMatrix* localM,
-                                                 const int maxTextureSize) const {
-    SkASSERT(fPicture && !fPicture->cullRect().isEmpty());
-
-    SkMatrix m;
-    m.setConcat(viewMatrix, this->getLocalMatrix());
-    if (localM) {
-        m.preConcat(*localM);
-    }
-
-    // Use a rotation-invariant scale
-    SkPoint scale;
-    //
-    // TODO: replace this with decomposeScale() -- but beware LayoutTest rebaselines!
-    //
-    if (!SkDecomposeUpper2x2(m, nullptr, &scale, nullptr)) {
-        // Decomposition failed, use an approximation.
-        scale.set(SkScalarSqrt(m.getScaleX() * m.getScaleX() + m.getSkewX() * m.getSkewX()),
-                  SkScalarSqrt(m.getScaleY() * m.getScaleY() + m.getSkewY() * m.getSkewY()));
-    }
-    SkSize scaledSize = SkSize::Make(SkScalarAbs(scale.x() * fTile.width()),
-                                     SkScalarAbs(scale.y() * fTile.height()));
+// Returns the size of the tile to render the picture into when drawing it at scale.
+static SkISize tile_size(const SkRect& tile, const SkPoint& scale, int maxTextureSize) {
+    SkSize scaledSize = SkSize::Make(SkScalarAbs(scale.x() * tile.width()),
+                                     SkScalarAbs(scale.y() * tile.height()));
 
     // Clamp the tile size to about 4M pixels
     static const SkScalar kMaxTileArea = 2048 * 2048;
@@ -198,46 +181,105 @@ sk_sp<SkShader> SkPictureShader::refBitmapShader(const SkMatrix& viewMatrix, con
 #endif
 
 #ifdef SK_SUPPORT_LEGACY_PICTURESHADER_ROUNDING
-    const SkISize tileSize = scaledSize.toRound();
+    return scaledSize.toRound();
 #else
-    const SkISize tileSize = scaledSize.toCeil();
+    return scaledSize.toCeil();
 #endif
-    if (tileSize.isEmpty()) {
-        return SkShader::MakeEmptyShader();
+}
+
+// Rounds |scale| up to the next quarter octave.
+static SkScalar round_up_scale(SkScalar scale) {
+    scale = SkScalarAbs(scale);
+    if (0 == scale) {
+        return 0;
     }
+    return SkScalarPow(2, SkScalarCeilToScalar(4 * SkScalarLog2(scale)) / 4);
+}
 
-    // The actual scale, compensating for rounding & clamping.
-    const SkSize tileScale = SkSize::Make(SkIntToScalar(tileSize.width()) / fTile.width(),
-                                          SkIntToScalar(tileSize.height()) / fTile.height());
+sk_sp<SkShader> SkPictureShader::refBitmapShader(const SkMatrix& viewMatrix, const SkMatrix* localM,
+                                                 SkFilterQuality filterQuality,
+                                                 const int maxTextureSize) const {
+    SkASSERT(fPicture && !fPicture->cullRect().isEmpty());
+
+    SkMatrix m;
+    m.setConcat(viewMatrix, this->getLocalMatrix());
+    if (localM) {
+        m.preConcat(*localM);
+    }
+
+    // Use a rotation-invariant scale
+    SkPoint scale;
+    //
+    // TODO: replace this with decomposeScale() -- but beware LayoutTest rebaselines!
+    //
+    if (!SkDecomposeUpper2x2(m, nullptr, &scale, nullptr)) {
+        // Decomposition failed, use an approximation.
+        scale.set(SkScalarSqrt(m.getScaleX() * m.getScaleX() + m.getSkewX() * m.getSkewX()),
+                  SkScalarSqrt(m.getScaleY() * m.getScaleY() + m.getSkewY() * m.getSkewY()));
+    }
+
+    // While the scale keeps changing from draw to draw (say, during a pinch-zoom), rendering a
+    // tile at each exact scale would re-render the picture every frame.  So when the scale isn't
+    // the one we drew at last time, we use a tile rendered at the scale rounded up to the next
+    // quarter octave, which the draws of a whole range of scales can share.  Downscaling it by at
+    // most 19% looks fine when we're filtering, so we only do this if we are.  Once the scale holds
+    // still we render the exact tile, one draw later.
+    const uint64_t scaleBits = ((uint64_t)SkFloat2Bits(scale.x()) << 32) | SkFloat2Bits(scale.y());
+    const uint64_t lastScaleBits = fLastScaleBits.load(sk_memory_order_relaxed);
+    const bool scaleIsChanging = kNone_SkFilterQuality != filterQuality &&
+                                 0 != lastScaleBits && scaleBits != lastScaleBits;
+    if (scaleBits != lastScaleBits) {
+        fLastScaleBits.store(scaleBits, sk_memory_order_relaxed);
+    }
+
+    SkISize tileSize;
+    SkSize tileScale;
+    auto makeKey = [&](const SkPoint& scale) {
+        tileSize = tile_size(fTile, scale, maxTextureSize);
+
+        // The actual scale, compensating for rounding & clamping.
+        tileScale = SkSize::Make(SkIntToScalar(tileSize.width()) / fTile.width(),
+                                 SkIntToScalar(tileSize.height()) / fTile.height());
+        return BitmapShaderKey(fPicture->uniqueID(),
+                               fTile,
+                               fTmx,
+                               fTmy,
+                               tileScale,
+                               this->getLocalMatrix());
+    };
 
     sk_sp<SkShader> tileShader;
-    BitmapShaderKey key(fPicture->uniqueID(),
-                        fTile,
-                        fTmx,
-                        fTmy,
-                        tileScale,
-                        this->getLocalMatrix());
-
-    if (!SkResourceCache::Find(key, BitmapShaderRec::Visitor, &tileShader)) {
-        SkMatrix tileMatrix;
-        tileMatrix.setRectToRect(fTile, SkRect::MakeIWH(tileSize.width(), tileSize.height()),
-                                 SkMatrix::kFill_ScaleToFit);
-
-        sk_sp<SkImage> tileImage(
-            SkImage::MakeFromPicture(fPicture, tileSize, &tileMatrix, nullptr));
-        if (!tileImage) {
-            return nullptr;
+    BitmapShaderKey key = makeKey(scale);
+    if (tileSize.isEmpty()) {
+        return SkShader::MakeEmptyShader();
+    }
+    if (SkResourceCache::Find(key, BitmapShaderRec::Visitor, &tileShader)) {
+        return tileShader;
+    }
+    if (scaleIsChanging) {
+        key = makeKey(SkPoint::Make(round_up_scale(scale.x()), round_up_scale(scale.y())));
+        if (SkResourceCache::Find(key, BitmapShaderRec::Visitor, &tileShader)) {
+            return tileShader;
         }
+    }
 
-        SkMatrix shaderMatrix = this->getLocalMatrix();
-        shaderMatrix.preScale(1 / tileScale.width(), 1 / tileScale.height());
-        tileShader = tileImage->makeShader(fTmx, fTmy, &shaderMatrix);
+    SkMatrix tileMatrix;
+    tileMatrix.setRectToRect(fTile, SkRect::MakeIWH(tileSize.width(), tileSize.height()),
+                             SkMatrix::kFill_ScaleToFit);
 
-        const SkImageInfo tileInfo = SkImageInfo::MakeN32Premul(tileSize);
-        SkResourceCache::Add(new BitmapShaderRec(key, tileShader.get(),
-                                                 tileInfo.getSafeSize(tileInfo.minRowBytes())));
+    sk_sp<SkImage> tileImage(
+        SkImage::MakeFromPicture(fPicture, tileSize, &tileMatrix, nullptr));
+    if (!tileImage) {
+        return nullptr;
     }
 
+    SkMatrix shaderMatrix = this->getLocalMatrix();
+    shaderMatrix.preScale(1 / tileScale.width(), 1 / tileScale.height());
+    tileShader = tileImage->makeShader(fTmx, fTmy, &shaderMatrix);
+
+    const SkImageInfo tileInfo = SkImageInfo::MakeN32Premul(tileSize);
+    SkResourceCache::Add(new BitmapShaderRec(key, tileShader.get(),
+                                             tileInfo.getSafeSize(tileInfo.minRowBytes())));
     return tileShader;
 }
 
@@ -246,7 +288,8 @@ size_t SkPictureShader::onContextSize(const ContextRec&) const {
 }
 
 SkShader::Context* SkPictureShader::onCreateContext(const ContextRec& rec, void* storage) const {
-    sk_sp<SkShader> bitmapShader(this->refBitmapShader(*rec.fMatrix, rec.fLocalMatrix));
+    sk_sp<SkShader> bitmapShader(this->refBitmapShader(*rec.fMatrix, rec.fLocalMatrix,
+                                                       rec.fPaint->getFilterQuality()));
     if (!bitmapShader) {
         return nullptr;
     }
@@ -327,7 +370,7 @@ sk_sp<GrFragmentProcessor> SkPictureShader::asFragmentProcessor(
     if (context) {
         maxTextureSize = context->caps()->maxTextureSize();
     }
-    sk_sp<SkShader> bitmapShader(this->refBitmapShader(viewM, localMatrix, maxTextureSize));
+    sk_sp<SkShader> bitmapShader(this->refBitmapShader(viewM, localMatrix, fq, maxTextureSize));
     if (!bitmapShader) {
         return nullptr;
     }
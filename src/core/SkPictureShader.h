@@ -8,6 +8,7 @@
 #ifndef SkPictureShader_DEFINED
 #define SkPictureShader_DEFINED
 
+#include "SkAtomics.h"
 #include "SkShader.h"
 
 class SkBitmap;
@@ -45,12 +46,15 @@ private:
     SkPictureShader(sk_sp<SkPicture>, TileMode, TileMode, const SkMatrix*, const SkRect*);
 
     sk_sp<SkShader> refBitmapShader(const SkMatrix&, const SkMatrix* localMatrix,
-                                    const int maxTextureSize = 0) const;
+                                    SkFilterQuality, const int maxTextureSize = 0) const;
 
     sk_sp<SkPicture>    fPicture;
     SkRect              fTile;
     TileMode            fTmx, fTmy;
 
+    // The scale we were last asked to draw at, x and y float bits packed together, or 0 if none.
+    mutable SkAtomic<uint64_t> fLastScaleBits;
+
     class PictureShaderContext : public SkShader::Context {
     public:
         static Context* Create(void* storage, const SkPictureShader&, const ContextRec&,
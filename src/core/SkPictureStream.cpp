@@ -0,0 +1,224 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkImageGenerator.h"
+#include "SkPictureData.h"
+#include "SkPicturePlayback.h"
+#include "SkPictureRecord.h"
+#include "SkPictureStream.h"
+#include "SkRecordDraw.h"
+#include "SkRecorder.h"
+#include "SkStream.h"
+
+// A stream is an SkPictInfo header with its own magic, then any number of chunks, then an EOF
+// tag.  Each chunk is
+//     SK_PICT_STREAM_CHUNK_TAG
+//     uint32_t start, stop      the range of its op data to play back
+//     serialized SkPictureData
+// Chunks are cut at arbitrary points, so their ops may restore saves made in earlier chunks, or
+// leave saves for later chunks to restore.  To make the SkPictureData ops self-consistent, we
+// record a chunk after a save for each level left open by earlier chunks, and let
+// SkPictureRecord restore any left open at the end.  Only the ops in [start, stop) are real.
+static const char kStreamMagic[] = { 's', 'k', 'i', 'a', 's', 't', 'r', 'm' };
+
+#define SK_PICT_STREAM_CHUNK_TAG SkSetFourByteTag('c', 'h', 'n', 'k')
+
+// Streams were introduced in picture version 47.
+static const uint32_t kMinStreamVersion = 47;
+
+namespace {
+
+// Tracks the save count implied by recorded Save, SaveLayer, and Restore ops.
+struct SaveDepth {
+    int fDepth;
+
+    void operator()(const SkRecords::Save&)      { fDepth++; }
+    void operator()(const SkRecords::SaveLayer&) { fDepth++; }
+    void operator()(const SkRecords::Restore&)   { fDepth--; }
+    template <typename T> void operator()(const T&) {}
+};
+
+struct IsSave {
+    bool operator()(const SkRecords::Save&) { return true; }
+    template <typename T> bool operator()(const T&) { return false; }
+};
+
+}  // namespace
+
+class SkPictureStreamWriter::ChunkFlusher final : public SkRecorder::Flusher {
+public:
+    explicit ChunkFlusher(SkPictureStreamWriter* writer) : fWriter(writer) {}
+    SkRecord* flush(SkRecord* record) override { return fWriter->writeChunk(record); }
+
+private:
+    SkPictureStreamWriter* fWriter;
+};
+
+SkPictureStreamWriter::SkPictureStreamWriter(SkWStream* stream, const SkRect& bounds,
+                                             int chunkOpCount)
+    : fStream(stream)
+    , fCullRect(bounds)
+    , fDepth(0)
+    , fRecord(new SkRecord)
+    , fRecorder(new SkRecorder(fRecord, bounds))
+    , fFlusher(new ChunkFlusher(this)) {
+    fRecorder->reset(fRecord, bounds, SkRecorder::Playback_DrawPictureMode);
+    fRecorder->setFlusher(fFlusher, SkTMax(chunkOpCount, 1));
+
+    SkPictInfo info;
+    static_assert(sizeof(kStreamMagic) == sizeof(info.fMagic), "");
+    memcpy(info.fMagic, kStreamMagic, sizeof(kStreamMagic));
+    info.fVersion  = SkPicture::CURRENT_PICTURE_VERSION;
+    info.fCullRect = bounds;
+    info.fFlags    = SkPictInfo::kCrossProcess_Flag | SkPictInfo::kScalarIsFloat_Flag;
+    if (8 == sizeof(void*)) {
+        info.fFlags |= SkPictInfo::kPtrIs64Bit_Flag;
+    }
+    fStream->write(&info, sizeof(info));
+}
+
+SkPictureStreamWriter::~SkPictureStreamWriter() {
+    this->finish();
+}
+
+SkCanvas* SkPictureStreamWriter::getRecordingCanvas() {
+    return fRecorder.get();
+}
+
+void SkPictureStreamWriter::finish() {
+    if (!fRecorder) {
+        return;
+    }
+    if (fRecord->count() > 0) {
+        this->writeChunk(fRecord);
+    }
+    fRecorder.reset(nullptr);
+    fRecord.reset(nullptr);
+    fStream->write32(SK_PICT_EOF_TAG);
+}
+
+SkRecord* SkPictureStreamWriter::writeChunk(SkRecord* record) {
+    int count = record->count();
+
+    // SkPictureRecord defers a save until something changes the canvas state, so a Save that
+    // ends this chunk would never be written.  Hold it back to start the next chunk instead.
+    const bool holdBackSave = count > 0 && record->visit(count - 1, IsSave());
+    if (holdBackSave) {
+        count--;
+    }
+
+    SkPictureRecord rec(SkISize::Make(SkScalarCeilToInt(fCullRect.width()),
+                                      SkScalarCeilToInt(fCullRect.height())), 0/*flags*/);
+    rec.beginRecording();
+    // Layers are never deferred, and SkPictureRecord doesn't really allocate them.
+    for (int i = 0; i < fDepth; i++) {
+        rec.saveLayer(nullptr, nullptr);
+    }
+    const uint32_t start = SkToU32(rec.writeStream().bytesWritten());
+
+    SkRecords::Draw draw(&rec, nullptr, nullptr, 0);
+    SaveDepth depth = { fDepth };
+    for (int i = 0; i < count; i++) {
+        record->visit(i, draw);
+        record->visit(i, depth);
+    }
+    fDepth = depth.fDepth;
+
+    const uint32_t stop = SkToU32(rec.writeStream().bytesWritten());
+    rec.endRecording();
+
+    SkPictInfo info;
+    memcpy(info.fMagic, kStreamMagic, sizeof(kStreamMagic));
+    info.fVersion  = SkPicture::CURRENT_PICTURE_VERSION;
+    info.fCullRect = fCullRect;
+    info.fFlags    = 0;
+    SkPictureData data(rec, info);
+
+    fStream->write32(SK_PICT_STREAM_CHUNK_TAG);
+    fStream->write32(start);
+    fStream->write32(stop);
+    data.serialize(fStream, nullptr, nullptr);
+
+    fRecord.reset(new SkRecord);
+    if (holdBackSave) {
+        new (fRecord->append<SkRecords::Save>()) SkRecords::Save{};
+    }
+    return fRecord.get();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+// Same as SkPicture's default.
+static bool default_install(const void* src, size_t length, SkBitmap* dst) {
+    sk_sp<SkData> encoded(SkData::MakeWithCopy(src, length));
+    return encoded && SkDEPRECATED_InstallDiscardablePixelRef(
+            SkImageGenerator::NewFromEncoded(encoded.get()), dst);
+}
+
+static bool read_u32(SkStream* stream, uint32_t* value) {
+    return stream->read(value, sizeof(*value)) == sizeof(*value);
+}
+
+SkPictureStreamReader::SkPictureStreamReader(SkStream* stream, SkPicture::InstallPixelRefProc proc)
+    : fStream(stream)
+    , fProc(proc ? proc : &default_install)
+    , fCullRect(SkRect::MakeEmpty())
+    , fVersion(0)
+    , fFlags(0)
+    , fValid(false) {
+    SkPictInfo info;
+    if (!stream || stream->read(&info, sizeof(info)) != sizeof(info)) {
+        return;
+    }
+    if (0 != memcmp(info.fMagic, kStreamMagic, sizeof(kStreamMagic)) ||
+        info.fVersion < kMinStreamVersion ||
+        info.fVersion > SkPicture::CURRENT_PICTURE_VERSION) {
+        return;
+    }
+    fCullRect = info.fCullRect;
+    fVersion  = info.fVersion;
+    fFlags    = info.fFlags;
+    fValid    = true;
+}
+
+bool SkPictureStreamReader::playback(SkCanvas* canvas) {
+    if (!fValid) {
+        return false;
+    }
+    fValid = false;   // We're about to consume the stream.
+
+    SkPictInfo info;
+    memcpy(info.fMagic, kStreamMagic, sizeof(kStreamMagic));
+    info.fVersion  = fVersion;
+    info.fCullRect = fCullRect;
+    info.fFlags    = fFlags;
+
+    SkAutoCanvasRestore acr(canvas, false);
+    const SkMatrix initialMatrix = canvas->getTotalMatrix();
+    for (;;) {
+        uint32_t tag, start, stop;
+        if (!read_u32(fStream, &tag)) {
+            return false;
+        }
+        if (SK_PICT_EOF_TAG == tag) {
+            return true;
+        }
+        if (SK_PICT_STREAM_CHUNK_TAG != tag ||
+            !read_u32(fStream, &start) ||
+            !read_u32(fStream, &stop)) {
+            return false;
+        }
+
+        SkAutoTDelete<SkPictureData> data(
+                SkPictureData::CreateFromStream(fStream, info, fProc, nullptr, nullptr));
+        if (!data || !data->opData() || start > stop || stop > data->opData()->size()) {
+            return false;
+        }
+        SkPicturePlayback(data.get()).drawRange(canvas, start, stop, initialMatrix);
+    }
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkPictureRecord.h"
+#include "SkPictureRecorder.h"
+#include "SkPicturePlayback.h"
+#include "SkPlaybackPicture.h"
+#include "SkReader32.h"
+
+// Walks the op stream just reading each op's size, never its arguments.
+static int count_ops(const SkData* ops) {
+    SkReader32 reader(ops->data(), ops->size());
+    int count = 0;
+    while (reader.isAvailable(sizeof(uint32_t))) {
+        const size_t start = reader.offset();
+        uint32_t size = reader.readU32() & MASK_24;
+        if (MASK_24 == size) {
+            if (!reader.isAvailable(sizeof(uint32_t))) {
+                break;
+            }
+            size = reader.readU32();
+        }
+        // A zero size means an old .skp without sizes; we can't walk those, so take what we have.
+        if (0 == size || size > ops->size() - start || SkAlign4(size) != size) {
+            break;
+        }
+        reader.setOffset(start + size);
+        count++;
+    }
+    return count;
+}
+
+SkPlaybackPicture::SkPlaybackPicture(const SkPictInfo& info, SkPictureData* data)
+    : fCullRect(info.fCullRect)
+    , fOpCount(data->opData() ? count_ops(data->opData().get()) : 0)
+    , fData(data)
+{}
+
+void SkPlaybackPicture::playback(SkCanvas* canvas, AbortCallback* callback) const {
+    SkASSERT(canvas);
+    if (!fData->opData()) {
+        return;
+    }
+    // SkPicturePlayback tracks its current op, so each playback gets its own.
+    SkPicturePlayback playback(fData.get());
+    playback.draw(canvas, callback, nullptr);
+}
+
+size_t SkPlaybackPicture::approximateBytesUsed() const {
+    size_t bytes = sizeof(*this) + sizeof(SkPictureData);
+    if (fData->opData()) {
+        bytes += fData->opData()->size();
+    }
+    return bytes;
+}
+
+int SkPlaybackPicture::numSlowPaths() const {
+    return this->cost().fNumSlowPaths;
+}
+
+SkPictureCost SkPlaybackPicture::cost() const {
+    fCostOnce([this] {
+        SkPictureRecorder recorder;
+        this->playback(recorder.beginRecording(fCullRect), nullptr);
+        fCost = recorder.finishRecordingAsPicture()->cost();
+    });
+    return fCost;
+}
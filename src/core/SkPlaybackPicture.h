@@ -0,0 +1,43 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPlaybackPicture_DEFINED
+#define SkPlaybackPicture_DEFINED
+
+#include "SkOnce.h"
+#include "SkPicture.h"
+#include "SkPictureCommon.h"
+#include "SkPictureData.h"
+#include "SkTemplates.h"
+
+// An implementation of SkPicture that plays back straight from deserialized SkPictureData,
+// rather than re-recording it into an SkRecord the way SkPicture::MakeFromStream() does.
+class SkPlaybackPicture final : public SkPicture {
+public:
+    SkPlaybackPicture(const SkPictInfo&, SkPictureData*);  // We take ownership.
+
+// SkPicture overrides
+    void playback(SkCanvas*, AbortCallback*) const override;
+    SkRect cullRect() const override { return fCullRect; }
+    bool willPlayBackBitmaps() const override { return fData->containsBitmaps(); }
+    int approximateOpCount() const override { return fOpCount; }
+    size_t approximateBytesUsed() const override;
+
+private:
+    int numSlowPaths() const override;
+    SkPictureCost cost() const override;
+
+    SkRect                         fCullRect;
+    int                            fOpCount;
+    SkAutoTDelete<SkPictureData>   fData;
+
+    // Only needed by GPU heuristics, so we record ourselves to analyze only when asked.
+    mutable SkOnce                 fCostOnce;
+    mutable SkPictureCost          fCost;
+};
+
+#endif//SkPlaybackPicture_DEFINED
@@ -96,22 +96,30 @@ struct SkBufferHead {
         }
     }
 
+    bool unique() const {
+        return 1 == sk_atomic_load(&fRefCnt, sk_memory_order_acquire);
+    }
+
+    // Blocks past the writer's tail are spares kept by SkRWBuffer::reset(), and are empty.
     void validate(size_t minUsed, const SkBufferBlock* tail = nullptr) const {
 #ifdef SK_DEBUG
         SkASSERT(fRefCnt > 0);
         size_t totalUsed = 0;
         const SkBufferBlock* block = &fBlock;
-        const SkBufferBlock* lastBlock = block;
+        bool pastTail = false;
+        bool foundTail = !tail;
         while (block) {
             block->validate();
+            SkASSERT(!pastTail || 0 == block->fUsed);
             totalUsed += block->fUsed;
-            lastBlock = block;
+            if (block == tail) {
+                foundTail = true;
+                pastTail = true;
+            }
             block = block->fNext;
         }
         SkASSERT(minUsed <= totalUsed);
-        if (tail) {
-            SkASSERT(tail == lastBlock);
-        }
+        SkASSERT(foundTail);
 #endif
     }
 };
@@ -181,7 +189,12 @@ bool SkROBuffer::Iter::next() {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-SkRWBuffer::SkRWBuffer(size_t initialCapacity) : fHead(nullptr), fTail(nullptr), fTotalUsed(0) {}
+SkRWBuffer::SkRWBuffer(size_t initialCapacity) : fHead(nullptr), fTail(nullptr), fTotalUsed(0) {
+    if (initialCapacity) {
+        fHead = SkBufferHead::Alloc(initialCapacity);
+        fTail = &fHead->fBlock;
+    }
+}
 
 SkRWBuffer::~SkRWBuffer() {
     this->validate();
@@ -207,18 +220,37 @@ void SkRWBuffer::append(const void* src, size_t length) {
         fTail = &fHead->fBlock;
     }
 
-    size_t written = fTail->append(src, length);
-    SkASSERT(written <= length);
-    src = (const char*)src + written;
-    length -= written;
+    for (;;) {
+        size_t written = fTail->append(src, length);
+        SkASSERT(written <= length);
+        src = (const char*)src + written;
+        length -= written;
+        if (0 == length) {
+            break;
+        }
+        // Move on to a spare block left by reset(), or allocate one big enough for the rest.
+        if (!fTail->fNext) {
+            fTail->fNext = SkBufferBlock::Alloc(length);
+        }
+        fTail = fTail->fNext;
+    }
+    this->validate();
+}
 
-    if (length) {
-        SkBufferBlock* block = SkBufferBlock::Alloc(length);
-        fTail->fNext = block;
-        fTail = block;
-        written = fTail->append(src, length);
-        SkASSERT(written == length);
+void SkRWBuffer::reset() {
+    this->validate();
+    if (fHead && fHead->unique()) {
+        // No snapshot can see the blocks any more, so keep them to append into again.
+        for (SkBufferBlock* block = &fHead->fBlock; block; block = block->fNext) {
+            block->fUsed = 0;
+        }
+        fTail = &fHead->fBlock;
+    } else if (fHead) {
+        fHead->unref();
+        fHead = nullptr;
+        fTail = nullptr;
     }
+    fTotalUsed = 0;
     this->validate();
 }
 
@@ -234,6 +266,10 @@ void SkRWBuffer::validate() const {
 #endif
 
 SkROBuffer* SkRWBuffer::newRBufferSnapshot() const {
+    if (0 == fTotalUsed) {
+        // fHead may be preallocated or reset, but there is nothing to see in it yet.
+        return new SkROBuffer(nullptr, 0, nullptr);
+    }
     return new SkROBuffer(fHead, fTotalUsed, fTail);
 }
 
@@ -315,6 +351,12 @@ public:
         return fGlobalOffset;
     }
 
+    // When the whole snapshot sits in one block, readers such as SkCodec can use it in place.
+    const void* getMemoryBase() override {
+        SkROBuffer::Iter iter(fBuffer);
+        return iter.size() == fBuffer->size() ? iter.data() : nullptr;
+    }
+
     bool seek(size_t position) override {
         AUTO_VALIDATE
         if (position < fGlobalOffset) {
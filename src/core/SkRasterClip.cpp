@@ -165,7 +165,8 @@ static MutateResult mutate_conservative_op(SkRegion::Op* op, bool inverseFilled)
     return kDoNothing_MutateResult;
 }
 
-bool SkRasterClip::setPath(const SkPath& path, const SkRegion& clip, bool doAA) {
+bool SkRasterClip::setPath(const SkPath& path, const SkRegion& clip, bool doAA,
+                           const SkAAClip::PathID* id) {
     AUTO_RASTERCLIP_VALIDATE(*this);
 
     if (fForceConservativeRects) {
@@ -180,7 +181,11 @@ bool SkRasterClip::setPath(const SkPath& path, const SkRegion& clip, bool doAA)
         if (this->isBW()) {
             this->convertToAA();
         }
-        (void)fAA.setPath(path, &clip, doAA);
+        if (id) {
+            (void)fAA.setPath(path, &clip, doAA, *id);
+        } else {
+            (void)fAA.setPath(path, &clip, doAA);
+        }
     }
     return this->updateCacheAndReturnNonEmpty();
 }
@@ -193,10 +198,13 @@ bool SkRasterClip::op(const SkRRect& rrect, const SkIRect& bounds, SkRegion::Op
     SkPath path;
     path.addRRect(rrect);
 
-    return this->op(path, bounds, op, doAA);
+    // Each path we make here has a new generation ID, so identify it by the rrect instead.
+    SkAAClip::PathID id(rrect);
+    return this->op(path, bounds, op, doAA, &id);
 }
 
-bool SkRasterClip::op(const SkPath& path, const SkIRect& bounds, SkRegion::Op op, bool doAA) {
+bool SkRasterClip::op(const SkPath& path, const SkIRect& bounds, SkRegion::Op op, bool doAA,
+                      const SkAAClip::PathID* id) {
     AUTO_RASTERCLIP_VALIDATE(*this);
 
     if (fForceConservativeRects) {
@@ -226,21 +234,21 @@ bool SkRasterClip::op(const SkPath& path, const SkIRect& bounds, SkRegion::Op op
             // FIXME: we should also be able to do this when this->isBW(),
             // but relaxing the test above triggers GM asserts in
             // SkRgnBuilder::blitH(). We need to investigate what's going on.
-            return this->setPath(path, this->bwRgn(), doAA);
+            return this->setPath(path, this->bwRgn(), doAA, id);
         } else {
             base.setRect(this->getBounds());
             SkRasterClip clip(fForceConservativeRects);
-            clip.setPath(path, base, doAA);
+            clip.setPath(path, base, doAA, id);
             return this->op(clip, op);
         }
     } else {
         base.setRect(bounds);
 
         if (SkRegion::kReplace_Op == op) {
-            return this->setPath(path, base, doAA);
+            return this->setPath(path, base, doAA, id);
         } else {
             SkRasterClip clip(fForceConservativeRects);
-            clip.setPath(path, base, doAA);
+            clip.setPath(path, base, doAA, id);
             return this->op(clip, op);
         }
     }
@@ -64,7 +64,12 @@ public:
     bool op(const SkRegion&, SkRegion::Op);
     bool op(const SkRect&, const SkIRect&, SkRegion::Op, bool doAA);
     bool op(const SkRRect&, const SkIRect&, SkRegion::Op, bool doAA);
-    bool op(const SkPath&, const SkIRect&, SkRegion::Op, bool doAA);
+    /**
+     *  If id is not null it must describe the path; the anti-aliased clip built from it may then
+     *  be shared with other clips built from the same path through SkResourceCache.
+     */
+    bool op(const SkPath&, const SkIRect&, SkRegion::Op, bool doAA,
+            const SkAAClip::PathID* id = nullptr);
 
     void translate(int dx, int dy, SkRasterClip* dst) const;
     void translate(int dx, int dy) {
@@ -127,7 +132,8 @@ private:
 
     void convertToAA();
 
-    bool setPath(const SkPath& path, const SkRegion& clip, bool doAA);
+    bool setPath(const SkPath& path, const SkRegion& clip, bool doAA,
+                 const SkAAClip::PathID* id = nullptr);
     bool setPath(const SkPath& path, const SkIRect& clip, bool doAA);
     bool op(const SkRasterClip&, SkRegion::Op);
     bool setConservativeRect(const SkRect& r, const SkIRect& clipR, bool isInverse);
@@ -5,12 +5,31 @@
  * found in the LICENSE file.
  */
 
+#include "SkOpts.h"
 #include "SkRasterPipeline.h"
 
-SkRasterPipeline::SkRasterPipeline() {}
+// The stock stages' kernels are shared with SkOpts' AVX pipeline, in SkRasterPipeline_opts.h.
+// Here they run on SkNx<N,float>, compiled for whatever our global compile options allow.
+#define SK_OPTS_NS raster_pipeline
+#include "SkRasterPipeline_opts.h"
+
+template <int N>
+SkRasterPipelineN<N>::SkRasterPipelineN() {}
+
+template <int N>
+void SkRasterPipelineN<N>::append(StockStage stage, const void* ctx) {
+    Fn body, tail;
+    SK_OPTS_NS::StockPipeline<Vec>::StockFns(stage, &body, &tail);
+    this->append(body, ctx, tail, ctx);
+    fStock.back() = stage;
+}
+
+template <int N>
+void SkRasterPipelineN<N>::append(Fn body_fn, const void* body_ctx,
+                                  Fn tail_fn, const void* tail_ctx) {
+    // We'll look for a chain to fuse the next time we run().
+    fNeedsFuse = true;
 
-void SkRasterPipeline::append(SkRasterPipeline::Fn body_fn, const void* body_ctx,
-                              SkRasterPipeline::Fn tail_fn, const void* tail_ctx) {
     // Each stage holds its own context and the next function to call.
     // So the pipeline itself has to hold onto the first function that starts the pipeline.
     (fBody.empty() ? fBodyStart : fBody.back().fNext) = body_fn;
@@ -20,24 +39,46 @@ void SkRasterPipeline::append(SkRasterPipeline::Fn body_fn, const void* body_ctx
     // It'll be overwritten by the next call to append().
     fBody.push_back({ &JustReturn, const_cast<void*>(body_ctx) });
     fTail.push_back({ &JustReturn, const_cast<void*>(tail_ctx) });
+    fStock.push_back(kExternal_StockStage);
 }
 
-void SkRasterPipeline::run(size_t n) {
-    // It's fastest to start uninitialized if the compilers all let us.  If not, next fastest is 0.
-    Sk4f v;
+template <int N>
+void SkRasterPipelineN<N>::fuse() {
+    fNeedsFuse = false;
+    fCompiled = nullptr;
+
+    bool allStock = !fStock.empty();
+    for (StockStage stage : fStock) {
+        allStock = allStock && stage != kExternal_StockStage;
+    }
+    if (N == 8 && allStock && SkOpts::compile_pipeline_8) {
+        SkSTArray<10, void*, /*MEM_COPY=*/true> ctxs;
+        for (const Stage& stage : fBody) {
+            ctxs.push_back(stage.fCtx);
+        }
+        fCompiled = SkOpts::compile_pipeline_8(fStock.begin(), ctxs.begin(), fStock.count());
+        return;
+    }
 
-    size_t x = 0;
-    while (n >= 4) {
-        fBodyStart(fBody.begin(), x, v,v,v,v, v,v,v,v);
-        x += 4;
-        n -= 4;
+    SK_OPTS_NS::StockPipeline<Vec>::Fuse(fStock.begin(), fStock.count(),
+                                         fBody.begin(), fTail.begin(), &fBodyStart, &fTailStart);
+}
+
+template <int N>
+void SkRasterPipelineN<N>::run(size_t n) {
+    if (fNeedsFuse) {
+        this->fuse();
     }
-    while (n > 0) {
-        fTailStart(fTail.begin(), x, v,v,v,v, v,v,v,v);
-        x += 1;
-        n -= 1;
+    if (fCompiled) {
+        fCompiled(n);
+        return;
     }
+    SK_OPTS_NS::StockPipeline<Vec>::Run(fBodyStart, fBody.begin(), fTailStart, fTail.begin(), n);
 }
 
-void SK_VECTORCALL SkRasterPipeline::JustReturn(Stage*, size_t, Sk4f,Sk4f,Sk4f,Sk4f,
-                                                                Sk4f,Sk4f,Sk4f,Sk4f) {}
+template <int N>
+void SK_VECTORCALL SkRasterPipelineN<N>::JustReturn(Stage*, size_t, Vec,Vec,Vec,Vec,
+                                                                    Vec,Vec,Vec,Vec) {}
+
+template class SkRasterPipelineN<4>;
+template class SkRasterPipelineN<8>;
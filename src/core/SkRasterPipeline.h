@@ -11,6 +11,7 @@
 #include "SkNx.h"
 #include "SkTArray.h"
 #include "SkTypes.h"
+#include <functional>
 
 /**
  * SkRasterPipeline provides a cheap way to chain together a pixel processing pipeline.
@@ -30,7 +31,7 @@
  *    - The Stage* always represents the current stage, mainly providing access to ctx().
  *    - The size_t is always the destination x coordinate.  If you need y, put it in your context.
  *    - By the time the shader's done, the first four vectors should hold source red,
- *      green, blue, and alpha, up to 4 pixels' worth each.
+ *      green, blue, and alpha, up to N pixels' worth each.
  *
  * ...and sometimes flexible:
  *    - In the shader, the first four vectors can be used for anything, e.g. sample coordinates.
@@ -45,67 +46,132 @@
  *
  * Some obvious stages that typically return are those that write a color to a destination pointer,
  * but any stage can short-circuit the rest of the pipeline by returning instead of calling next().
+ *
+ * N is the number of pixels each body call works on.  SkRasterPipeline is the 4-wide pipeline,
+ * whose vectors are Sk4f.  SkWideRasterPipeline doubles that to 8 pixels (Sk8f) on x86, halving
+ * the calls made per pixel on long spans; on NEON it is the same 4-wide pipeline as
+ * SkRasterPipeline.  Sk8f is a pair of Sk4f, but where the CPU has AVX, an 8-wide pipeline made
+ * only of stock stages runs through SkOpts instead, with each vector in a single AVX register.
  */
 
-class SkRasterPipeline {
-public:
-    struct Stage;
-    using Fn = void(SK_VECTORCALL *)(Stage*, size_t, Sk4f,Sk4f,Sk4f,Sk4f,
-                                                     Sk4f,Sk4f,Sk4f,Sk4f);
-    struct Stage {
-        template <typename T>
-        T ctx() { return static_cast<T>(fCtx); }
-
-        void SK_VECTORCALL next(size_t x, Sk4f v0, Sk4f v1, Sk4f v2, Sk4f v3,
-                                          Sk4f v4, Sk4f v5, Sk4f v6, Sk4f v7) {
-            // Stages are logically a pipeline, and physically are contiguous in an array.
-            // To get to the next stage, we just increment our pointer to the next array element.
-            fNext(this+1, x, v0,v1,v2,v3, v4,v5,v6,v7);
-        }
-
-        // It makes next() a good bit cheaper if we hold the next function to call here,
-        // rather than logically simpler choice of the function implementing this stage.
-        Fn fNext;
-        void* fCtx;
+// A stage of a pipeline whose vectors are Vs.
+template <typename V>
+struct SkRasterPipelineStage {
+    using Fn = void(SK_VECTORCALL *)(SkRasterPipelineStage*, size_t, V,V,V,V,
+                                                                     V,V,V,V);
+    template <typename T>
+    T ctx() { return static_cast<T>(fCtx); }
+
+    void SK_VECTORCALL next(size_t x, V v0, V v1, V v2, V v3,
+                                      V v4, V v5, V v6, V v7) {
+        // Stages are logically a pipeline, and physically are contiguous in an array.
+        // To get to the next stage, we just increment our pointer to the next array element.
+        fNext(this+1, x, v0,v1,v2,v3, v4,v5,v6,v7);
+    }
+
+    // It makes next() a good bit cheaper if we hold the next function to call here,
+    // rather than logically simpler choice of the function implementing this stage.
+    Fn fNext;
+    void* fCtx;
+};
+
+// Stock stages are implemented by SkRasterPipeline itself, for every width.  Pixels are
+// sRGB-encoded RGBA 8888 or linear RGBA half floats, and each context points to the start of the
+// span; stages offset them by x.  BGRA pixels can be loaded and stored with the help of
+// swap_rb(_d).
+struct SkRasterPipelineStockStages {
+    enum StockStage {
+        constant_color,  // const SkPM4f*:    src = color
+        load_s_srgb,     // const uint32_t*:  src = pixels
+        load_d_srgb,     // const uint32_t*:  dst = pixels
+        load_s_f16,      // const uint64_t*:  src = pixels
+        load_d_f16,      // const uint64_t*:  dst = pixels
+        swap_rb,         // (none):           swap src r and b
+        swap_rb_d,       // (none):           swap dst r and b
+        scale_1_float,   // const float*:     src *= scale
+        scale_u8,        // const uint8_t*:   src *= coverage
+        unpremul,        // (none):           src rgb /= sa, or 0 where sa is 0
+        matrix_4x5,      // const float[20]:  src = M * (src, 1), M column-major, translate in [0,1]
+        clamp_0_1,       // (none):           src = clamp(src, 0, 1)
+        premul,          // (none):           src rgb *= sa
+        srcover,         // (none):           src = src + dst*(1-sa)
+        lerp_u8,         // const uint8_t*:   src = lerp(dst, src, coverage)
+        store_srgb,      // uint32_t*:        pixels = src
+        store_f16,       // uint64_t*:        pixels = src
+
+        kExternal_StockStage,  // Used internally to mark stages appended as Fns.
     };
+};
 
+template <int N>
+class SkRasterPipelineN : public SkRasterPipelineStockStages {
+public:
+    using Vec   = SkNx<N, float>;
+    using Stage = SkRasterPipelineStage<Vec>;
+    using Fn    = typename Stage::Fn;
 
-    SkRasterPipeline();
+    SkRasterPipelineN();
 
     // Run the pipeline constructed with append(), walking x through [0,n),
-    // generally in 4 pixel steps, but sometimes 1 pixel at a time.
+    // generally in N pixel steps, but sometimes 1 pixel at a time.
     void run(size_t n);
 
     // Use this append() if your stage is sensitive to the number of pixels you're working with:
-    //   - body will always be called for a full 4 pixels
+    //   - body will always be called for a full N pixels
     //   - tail will always be called for a single pixel
     // Typically this is only an essential distintion for stages that read or write memory.
     void append(Fn body, const void* body_ctx,
                 Fn tail, const void* tail_ctx);
 
-    // Most stages don't actually care if they're working on 4 or 1 pixel.
+    // Most stages don't actually care if they're working on N or 1 pixel.
     void append(Fn fn, const void* ctx = nullptr) {
         this->append(fn, ctx, fn, ctx);
     }
 
-    // Most 4 pixel or 1 pixel variants share the same context pointer.
+    // Most N pixel or 1 pixel variants share the same context pointer.
     void append(Fn body, Fn tail, const void* ctx = nullptr) {
         this->append(body, ctx, tail, ctx);
     }
 
+    // Appends one of the stock stages listed in SkRasterPipelineStockStages.
+    void append(StockStage, const void* ctx = nullptr);
+
 private:
     using Stages = SkSTArray<10, Stage, /*MEM_COPY=*/true>;
 
+    // Wherever the pipeline has one of a few common chains of stock stages, run() calls a single
+    // kernel fusing that whole chain together instead of chaining through each stage.  This finds
+    // such chains and points the stage before each at its fused kernel.  An 8-wide pipeline of
+    // nothing but stock stages goes to SkOpts::compile_pipeline_8() instead, where the CPU has it.
+    void fuse();
+
     // This no-op default makes fBodyStart and fTailStart unconditionally safe to call,
     // and is always the last stage's fNext as a sort of safety net to make sure even a
     // buggy pipeline can't walk off its own end.
-    static void SK_VECTORCALL JustReturn(Stage*, size_t, Sk4f,Sk4f,Sk4f,Sk4f,
-                                                         Sk4f,Sk4f,Sk4f,Sk4f);
+    static void SK_VECTORCALL JustReturn(Stage*, size_t, Vec,Vec,Vec,Vec,
+                                                         Vec,Vec,Vec,Vec);
 
     Stages fBody,
            fTail;
     Fn fBodyStart = &JustReturn,
        fTailStart = &JustReturn;
+
+    SkSTArray<10, StockStage, /*MEM_COPY=*/true> fStock;  // Parallel to fBody and fTail.
+    bool fNeedsFuse = false;
+
+    std::function<void(size_t)> fCompiled;  // When set, run() calls this instead.
 };
 
+// Both widths are instantiated once, in SkRasterPipeline.cpp.
+extern template class SkRasterPipelineN<4>;
+extern template class SkRasterPipelineN<8>;
+
+typedef SkRasterPipelineN<4> SkRasterPipeline;
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    typedef SkRasterPipelineN<8> SkWideRasterPipeline;
+#else
+    typedef SkRasterPipelineN<4> SkWideRasterPipeline;
+#endif
+
 #endif//SkRasterPipeline_DEFINED
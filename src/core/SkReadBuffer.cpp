@@ -9,6 +9,7 @@
 #include "SkErrorInternals.h"
 #include "SkImage.h"
 #include "SkImageGenerator.h"
+#include "SkImageReferenceResolver.h"
 #include "SkReadBuffer.h"
 #include "SkStream.h"
 #include "SkTypeface.h"
@@ -33,6 +34,7 @@ SkReadBuffer::SkReadBuffer() {
     fFactoryArray = nullptr;
     fFactoryCount = 0;
     fBitmapDecoder = nullptr;
+    fImageReferenceResolver = nullptr;
 #ifdef DEBUG_NON_DETERMINISTIC_ASSERT
     fDecodedBitmapIndex = -1;
 #endif // DEBUG_NON_DETERMINISTIC_ASSERT
@@ -50,6 +52,7 @@ SkReadBuffer::SkReadBuffer(const void* data, size_t size) {
     fFactoryArray = nullptr;
     fFactoryCount = 0;
     fBitmapDecoder = nullptr;
+    fImageReferenceResolver = nullptr;
 #ifdef DEBUG_NON_DETERMINISTIC_ASSERT
     fDecodedBitmapIndex = -1;
 #endif // DEBUG_NON_DETERMINISTIC_ASSERT
@@ -69,6 +72,7 @@ SkReadBuffer::SkReadBuffer(SkStream* stream) {
     fFactoryArray = nullptr;
     fFactoryCount = 0;
     fBitmapDecoder = nullptr;
+    fImageReferenceResolver = nullptr;
 #ifdef DEBUG_NON_DETERMINISTIC_ASSERT
     fDecodedBitmapIndex = -1;
 #endif // DEBUG_NON_DETERMINISTIC_ASSERT
@@ -282,6 +286,22 @@ SkImage* SkReadBuffer::readImage() {
     };
 
     uint32_t encoded_size = this->getArrayCount();
+    if (encoded_size == 2 && !this->isVersionLT(kImageReferences_Version)) {
+        // The writer kept the image and gave us only a reference to it.
+        (void)this->readUInt();  // Swallow that encoded_size == 2 sentinel.
+        sk_sp<SkData> reference(this->readByteArrayAsData());
+        if (!this->isValid()) {
+            return nullptr;
+        }
+        if (fImageReferenceResolver) {
+            sk_sp<SkImage> image(fImageReferenceResolver->resolve(reference->data(),
+                                                                  reference->size()));
+            if (image && image->width() == width && image->height() == height) {
+                return image.release();
+            }
+        }
+        return placeholder();
+    }
     if (encoded_size == 0) {
         // The image could not be encoded at serialization time - return an empty placeholder.
         (void)this->readUInt();  // Swallow that encoded_size == 0 sentinel.
@@ -328,6 +348,24 @@ SkTypeface* SkReadBuffer::readTypeface() {
     }
 }
 
+const SkReadBuffer::FlattenableEntry* SkReadBuffer::getFlattenableEntry(uint32_t index) {
+    if (0 == index || index > (uint32_t)fFlattenableDict.count()) {
+        return nullptr;
+    }
+    FlattenableEntry& entry = fFlattenableDict[index - 1];
+    if (!entry.fResolved) {
+        // Check if a custom Factory has been specified for this flattenable. If there is no
+        // custom Factory, check for a default.
+        entry.fFactory = this->getCustomFactory(entry.fName);
+        if (!entry.fFactory) {
+            entry.fFactory = SkFlattenable::NameToFactory(entry.fName.c_str());
+        }
+        entry.fHasType = SkFlattenable::NameToType(entry.fName.c_str(), &entry.fType);
+        entry.fResolved = true;
+    }
+    return &entry;
+}
+
 SkFlattenable* SkReadBuffer::readFlattenable(SkFlattenable::Type ft) {
     //
     // TODO: confirm that ft matches the factory we decide to use
@@ -347,32 +385,28 @@ SkFlattenable* SkReadBuffer::readFlattenable(SkFlattenable::Type ft) {
         }
         factory = fFactoryArray[index];
     } else {
-        SkString name;
+        uint32_t index;
         if (this->peekByte()) {
             // If the first byte is non-zero, the flattenable is specified by a string.
+            SkString name;
             this->readString(&name);
 
             // Add the string to the dictionary.
-            fFlattenableDict.set(fFlattenableDict.count() + 1, name);
+            this->addFlattenableName(name);
+            index = fFlattenableDict.count();
         } else {
             // Read the index.  We are guaranteed that the first byte
             // is zeroed, so we must shift down a byte.
-            uint32_t index = fReader.readU32() >> 8;
+            index = fReader.readU32() >> 8;
             if (0 == index) {
                 return nullptr; // writer failed to give us the flattenable
             }
-
-            SkString* namePtr = fFlattenableDict.find(index);
-            SkASSERT(namePtr);
-            name = *namePtr;
         }
 
-        // Check if a custom Factory has been specified for this flattenable.
-        if (!(factory = this->getCustomFactory(name))) {
-            // If there is no custom Factory, check for a default.
-            if (!(factory = SkFlattenable::NameToFactory(name.c_str()))) {
-                return nullptr; // writer failed to give us the flattenable
-            }
+        const FlattenableEntry* entry = this->getFlattenableEntry(index);
+        SkASSERT(entry);
+        if (!entry || !(factory = entry->fFactory)) {
+            return nullptr; // writer failed to give us the flattenable
         }
     }
 
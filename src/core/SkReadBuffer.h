@@ -21,12 +21,14 @@
 #include "SkReader32.h"
 #include "SkRefCnt.h"
 #include "SkShader.h"
+#include "SkTArray.h"
 #include "SkTHash.h"
 #include "SkWriteBuffer.h"
 #include "SkXfermode.h"
 
 class SkBitmap;
 class SkImage;
+class SkImageReferenceResolver;
 
 #if defined(SK_DEBUG) && defined(SK_BUILD_FOR_MAC)
     #define DEBUG_NON_DETERMINISTIC_ASSERT
@@ -66,6 +68,8 @@ public:
         kHasDrawImageOpCodes_Version       = 43,
         kAnnotationsMovedToCanvas_Version  = 44,
         kLightingShaderWritesInvNormRotation = 45,
+        kPaddedPictureHeader_Version       = 47,
+        kImageReferences_Version           = 48,
     };
 
     /**
@@ -201,6 +205,10 @@ public:
      */
     void setCustomFactory(const SkString& name, SkFlattenable::Factory factory) {
         fCustomFactory.set(name, factory);
+        // Names we've already seen may now resolve differently.
+        for (FlattenableEntry& entry : fFlattenableDict) {
+            entry.fResolved = false;
+        }
     }
 
     /**
@@ -212,6 +220,14 @@ public:
         fBitmapDecoder = bitmapDecoder;
     }
 
+    /**
+     *  Provide the resolver for images that were serialized as references. Without one, such
+     *  images are read as blank placeholders of the right size.
+     */
+    void setImageReferenceResolver(SkImageReferenceResolver* resolver) {
+        fImageReferenceResolver = resolver;
+    }
+
     // Default impelementations don't check anything.
     virtual bool validate(bool isValid) { return isValid; }
     virtual bool isValid() const { return true; }
@@ -237,10 +253,31 @@ protected:
         return factoryPtr ? *factoryPtr : nullptr;
     }
 
+    // Only used if we do not have an fFactoryArray. The flattenable names the writer has spelled
+    // out so far, in the order it numbered them. Each is looked up in the registry only once.
+    struct FlattenableEntry {
+        SkString               fName;
+        SkFlattenable::Factory fFactory;
+        SkFlattenable::Type    fType;
+        bool                   fHasType;
+        bool                   fResolved;
+    };
+
+    void addFlattenableName(const SkString& name) {
+        FlattenableEntry& entry = fFlattenableDict.push_back();
+        entry.fName = name;
+        entry.fResolved = false;
+    }
+
+    /**
+     *  Returns the entry for the writer's 1-based index, with its factory (custom, or else from
+     *  the registry) and type filled in, or nullptr if there is no such entry.
+     */
+    const FlattenableEntry* getFlattenableEntry(uint32_t index);
+
     SkReader32 fReader;
 
-    // Only used if we do not have an fFactoryArray.
-    SkTHashMap<uint32_t, SkString> fFlattenableDict;
+    SkTArray<FlattenableEntry> fFlattenableDict;
 
 private:
     bool readArray(void* value, size_t size, size_t elementSize);
@@ -260,6 +297,7 @@ private:
     SkTHashMap<SkString, SkFlattenable::Factory> fCustomFactory;
 
     SkPicture::InstallPixelRefProc fBitmapDecoder;
+    SkImageReferenceResolver*      fImageReferenceResolver;
 
 #ifdef DEBUG_NON_DETERMINISTIC_ASSERT
     // Debugging counter to keep track of how many bitmaps we
@@ -13,6 +13,54 @@ SkRecord::~SkRecord() {
     for (int i = 0; i < this->count(); i++) {
         this->mutate(i, destroyer);
     }
+    this->destroyPaints();
+}
+
+void SkRecord::reset() {
+    Destroyer destroyer;
+    for (int i = 0; i < this->count(); i++) {
+        this->mutate(i, destroyer);
+    }
+    this->destroyPaints();
+    fCount = 0;
+    fRecordsMallocCount = 0;
+    fAlloc.reset(fInlineAlloc, sizeof(fInlineAlloc));
+}
+
+const SkPaint* SkRecord::internPaint(const SkPaint& paint) {
+    for (const SkPaint* recent : fRecentPaints) {
+        if (recent && *recent == paint) {
+            return recent;
+        }
+    }
+    const InternedPaint key = { &paint, paint.getHash() };
+    const SkPaint* interned;
+    if (const InternedPaint* found = fPaints.find(key)) {
+        interned = found->paint;
+    } else {
+        interned = new (this->alloc<SkPaint>()) SkPaint(paint);
+        fPaints.set({ interned, key.hash });
+    }
+    fRecentPaints[fNextRecentPaint++ % kRecentPaints] = interned;
+    return interned;
+}
+
+void SkRecord::destroyPaints() {
+    // The paints' memory belongs to fAlloc.
+    fPaints.foreach([](InternedPaint* p) { p->paint->~SkPaint(); });
+    fPaints.reset();
+    for (const SkPaint*& recent : fRecentPaints) {
+        recent = nullptr;
+    }
+}
+
+void SkRecord::reserve(int count, size_t bytes) {
+    if (fCount + count > fReserved) {
+        fReserved = fCount + count;
+        fRecords.realloc(fReserved);
+        fRecordsMallocCount++;
+    }
+    fAlloc.reserve(bytes);
 }
 
 void SkRecord::grow() {
@@ -20,10 +68,11 @@ void SkRecord::grow() {
     SkASSERT(fReserved > 0);
     fReserved *= 2;
     fRecords.realloc(fReserved);
+    fRecordsMallocCount++;
 }
 
 size_t SkRecord::bytesUsed() const {
-    size_t bytes = fAlloc.approxBytesAllocated() + sizeof(SkRecord);
+    size_t bytes = fAlloc.approxBytesAllocated() + fPaints.approxBytesUsed() + sizeof(SkRecord);
     // If fReserved <= kInlineRecords, we've already accounted for fRecords with sizeof(SkRecord).
     // When we go over that limit, they're allocated on the heap (and the inline space is wasted).
     if (fReserved > kInlineRecords) {
@@ -9,6 +9,7 @@
 #define SkRecord_DEFINED
 
 #include "SkRecords.h"
+#include "SkTHash.h"
 #include "SkTLogic.h"
 #include "SkTemplates.h"
 #include "SkVarAlloc.h"
@@ -35,10 +36,22 @@ public:
     SkRecord()
         : fCount(0)
         , fReserved(kInlineRecords)
+        , fRecordsMallocCount(0)
+        , fRecentPaints()
+        , fNextRecentPaint(0)
         , fAlloc(kInlineAllocLgBytes+1,  // First malloc'd block is 2x as large as fInlineAlloc.
                  fInlineAlloc, sizeof(fInlineAlloc)) {}
     ~SkRecord();
 
+    // Destroy all canvas commands, but keep (most of) the memory they used to record into again.
+    void reset();
+
+    // Make room for count more canvas commands, taking up about bytes in all, without growing.
+    void reserve(int count, size_t bytes);
+
+    // Returns how many times we've malloc'd space for commands since construction or reset().
+    int mallocCount() const { return fRecordsMallocCount + fAlloc.mallocCount(); }
+
     // Returns the number of canvas commands in this SkRecord.
     int count() const { return fCount; }
 
@@ -67,6 +80,14 @@ public:
         return (T*)fAlloc.alloc(sizeof(T) * count);
     }
 
+    // Returns this SkRecord's copy of paint, to be pointed to by its commands.
+    // Equal paints (see SkPaint's operator==) share one copy, which lives until the SkRecord is
+    // destroyed or reset().  The copy is shared, so don't const_cast it: intern a changed copy.
+    const SkPaint* internPaint(const SkPaint& paint);
+
+    // Returns how many distinct paints have been interned since construction or reset().
+    int paintCount() const { return fPaints.count(); }
+
     // Add a new command of type T to the end of this SkRecord.
     // You are expected to placement new an object of type T onto this pointer.
     template <typename T>
@@ -143,6 +164,7 @@ private:
     SK_WHEN(!std::is_empty<T>::value, T*) allocCommand() { return this->alloc<T>(); }
 
     void grow();
+    void destroyPaints();
 
     // A typed pointer to some bytes in fAlloc.  visit() and mutate() allow polymorphic dispatch.
     struct Record {
@@ -187,8 +209,27 @@ private:
     // fRecords needs to be a data structure that can append fixed length data, and need to
     // support efficient random access and forward iteration.  (It doesn't need to be contiguous.)
     int fCount, fReserved;
+    int fRecordsMallocCount;
     SkAutoSTMalloc<kInlineRecords, Record> fRecords;
 
+    // Every distinct paint our commands use, allocated in fAlloc, with its hash so that we hash
+    // each paint only once.  Most pictures cycle through a few paints, so we check the last few
+    // we interned before hashing at all.
+    struct InternedPaint {
+        const SkPaint* paint;
+        uint32_t       hash;
+
+        bool operator==(const InternedPaint& that) const {
+            return hash == that.hash && *paint == *that.paint;
+        }
+        static const InternedPaint& GetKey(const InternedPaint& p) { return p; }
+        static uint32_t Hash(const InternedPaint& p) { return p.hash; }
+    };
+    SkTHashTable<InternedPaint, InternedPaint> fPaints;
+    static const int kRecentPaints = 4;
+    const SkPaint* fRecentPaints[kRecentPaints];
+    int fNextRecentPaint;
+
     // fAlloc needs to be a data structure which can append variable length data in contiguous
     // chunks, returning a stable handle to that data for later retrieval.
     SkVarAlloc fAlloc;
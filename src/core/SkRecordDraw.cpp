@@ -6,7 +6,9 @@
  */
 
 #include "SkRecordDraw.h"
+#include "SkNx.h"
 #include "SkPatchUtils.h"
+#include "SkTaskGroup.h"
 
 void SkRecordDraw(const SkRecord& record,
                   SkCanvas* canvas,
@@ -97,28 +99,28 @@ DRAW(DrawBitmapRectFast,
         legacy_drawBitmapRect(r.bitmap.shallowCopy(), r.src, r.dst, r.paint,
                        SkCanvas::kFast_SrcRectConstraint));
 DRAW(DrawBitmapRectFixedSize,
-        legacy_drawBitmapRect(r.bitmap.shallowCopy(), &r.src, r.dst, &r.paint, r.constraint));
-DRAW(DrawDRRect, drawDRRect(r.outer, r.inner, r.paint));
+        legacy_drawBitmapRect(r.bitmap.shallowCopy(), &r.src, r.dst, r.paint, r.constraint));
+DRAW(DrawDRRect, drawDRRect(r.outer, r.inner, *r.paint));
 DRAW(DrawImage, drawImage(r.image, r.left, r.top, r.paint));
 DRAW(DrawImageRect, legacy_drawImageRect(r.image, r.src, r.dst, r.paint, r.constraint));
 DRAW(DrawImageNine, drawImageNine(r.image, r.center, r.dst, r.paint));
-DRAW(DrawOval, drawOval(r.oval, r.paint));
-DRAW(DrawPaint, drawPaint(r.paint));
-DRAW(DrawPath, drawPath(r.path, r.paint));
-DRAW(DrawPatch, drawPatch(r.cubics, r.colors, r.texCoords, r.xmode, r.paint));
+DRAW(DrawOval, drawOval(r.oval, *r.paint));
+DRAW(DrawPaint, drawPaint(*r.paint));
+DRAW(DrawPath, drawPath(r.path, *r.paint));
+DRAW(DrawPatch, drawPatch(r.cubics, r.colors, r.texCoords, r.xmode, *r.paint));
 DRAW(DrawPicture, drawPicture(r.picture, &r.matrix, r.paint));
-DRAW(DrawPoints, drawPoints(r.mode, r.count, r.pts, r.paint));
-DRAW(DrawPosText, drawPosText(r.text, r.byteLength, r.pos, r.paint));
-DRAW(DrawPosTextH, drawPosTextH(r.text, r.byteLength, r.xpos, r.y, r.paint));
-DRAW(DrawRRect, drawRRect(r.rrect, r.paint));
-DRAW(DrawRect, drawRect(r.rect, r.paint));
-DRAW(DrawText, drawText(r.text, r.byteLength, r.x, r.y, r.paint));
-DRAW(DrawTextBlob, drawTextBlob(r.blob, r.x, r.y, r.paint));
-DRAW(DrawTextOnPath, drawTextOnPath(r.text, r.byteLength, r.path, &r.matrix, r.paint));
-DRAW(DrawTextRSXform, drawTextRSXform(r.text, r.byteLength, r.xforms, r.cull, r.paint));
+DRAW(DrawPoints, drawPoints(r.mode, r.count, r.pts, *r.paint));
+DRAW(DrawPosText, drawPosText(r.text, r.byteLength, r.pos, *r.paint));
+DRAW(DrawPosTextH, drawPosTextH(r.text, r.byteLength, r.xpos, r.y, *r.paint));
+DRAW(DrawRRect, drawRRect(r.rrect, *r.paint));
+DRAW(DrawRect, drawRect(r.rect, *r.paint));
+DRAW(DrawText, drawText(r.text, r.byteLength, r.x, r.y, *r.paint));
+DRAW(DrawTextBlob, drawTextBlob(r.blob, r.x, r.y, *r.paint));
+DRAW(DrawTextOnPath, drawTextOnPath(r.text, r.byteLength, r.path, &r.matrix, *r.paint));
+DRAW(DrawTextRSXform, drawTextRSXform(r.text, r.byteLength, r.xforms, r.cull, *r.paint));
 DRAW(DrawAtlas, drawAtlas(r.atlas, r.xforms, r.texs, r.colors, r.count, r.mode, r.cull, r.paint));
 DRAW(DrawVertices, drawVertices(r.vmode, r.vertexCount, r.vertices, r.texs, r.colors,
-                                r.xmode, r.indices, r.indexCount, r.paint));
+                                r.xmode, r.indices, r.indexCount, *r.paint));
 DRAW(DrawAnnotation, drawAnnotation(r.rect, r.key.c_str(), r.value));
 #undef DRAW
 
@@ -154,12 +156,20 @@ template <> void Draw::draw(const DrawDrawable& r) {
 class FillBounds : SkNoncopyable {
 public:
     FillBounds(const SkRect& cullRect, const SkRecord& record, SkRect bounds[])
+        : FillBounds(cullRect, record, bounds, SkMatrix::I(), cullRect) {}
+
+    // Starts with the CTM and clip bounds the ops before have left, outside any Save block.
+    FillBounds(const SkRect& cullRect, const SkRecord& record, SkRect bounds[],
+               const SkMatrix& ctm, const SkRect& clipBounds)
         : fNumRecords(record.count())
         , fCullRect(cullRect)
-        , fBounds(bounds) {
-        fCTM = SkMatrix::I();
-        fCurrentClipBounds = fCullRect;
-    }
+        , fBounds(bounds)
+        , fCTM(ctm)
+        , fCurrentClipBounds(clipBounds)
+        , fLastLooper(nullptr)
+        , fLastImageFilter(nullptr)
+        , fLastRasterizer(nullptr)
+        , fLastCanComputeFastBounds(true) {}
 
     void cleanUp() {
         // If we have any lingering unpaired Saves, simulate restores to make
@@ -196,7 +206,7 @@ public:
         rect.sort();
 
         // Adjust the rect for its own paint.
-        if (!AdjustForPaint(paint, &rect)) {
+        if (!this->adjustForPaint(paint, &rect)) {
             // The paint could do anything to our bounds.  The only safe answer is the current clip.
             return fCurrentClipBounds;
         }
@@ -208,7 +218,7 @@ public:
         }
 
         // Map the rect back to identity space.
-        fCTM.mapRect(&rect);
+        MapRect(fCTM, &rect);
 
         // Nothing can draw outside the current clip.
         if (!rect.intersect(fCurrentClipBounds)) {
@@ -224,6 +234,10 @@ private:
         Bounds bounds;         // Bounds of everything in the block.
         const SkPaint* paint;  // Unowned.  If set, adjusts the bounds of all ops in this block.
         SkMatrix ctm;
+        // Only meaningful with a paint: ctm's inverse, and whether the paint can be accounted
+        // for at all.  Every op in the block needs them, so they're worked out once, up front.
+        SkMatrix inverse;
+        bool canAdjust;
     };
 
     // Only Restore, SetMatrix, and Concat change the CTM.
@@ -307,6 +321,7 @@ private:
             PaintMayAffectTransparentBlack(paint) ? fCurrentClipBounds : Bounds::MakeEmpty();
         sb.paint = paint;
         sb.ctm = this->fCTM;
+        sb.canAdjust = !paint || (sb.ctm.invert(&sb.inverse) && this->canComputeFastBounds(*paint));
 
         fSaveStack.push(sb);
         this->pushControl();
@@ -393,13 +408,13 @@ private:
     Bounds bounds(const DrawPaint&) const { return fCurrentClipBounds; }
     Bounds bounds(const NoOp&)  const { return Bounds::MakeEmpty(); }    // NoOps don't draw.
 
-    Bounds bounds(const DrawRect& op) const { return this->adjustAndMap(op.rect, &op.paint); }
-    Bounds bounds(const DrawOval& op) const { return this->adjustAndMap(op.oval, &op.paint); }
+    Bounds bounds(const DrawRect& op) const { return this->adjustAndMap(op.rect, op.paint); }
+    Bounds bounds(const DrawOval& op) const { return this->adjustAndMap(op.oval, op.paint); }
     Bounds bounds(const DrawRRect& op) const {
-        return this->adjustAndMap(op.rrect.rect(), &op.paint);
+        return this->adjustAndMap(op.rrect.rect(), op.paint);
     }
     Bounds bounds(const DrawDRRect& op) const {
-        return this->adjustAndMap(op.outer.rect(), &op.paint);
+        return this->adjustAndMap(op.outer.rect(), op.paint);
     }
     Bounds bounds(const DrawImage& op) const {
         const SkImage* image = op.image;
@@ -420,7 +435,7 @@ private:
         return this->adjustAndMap(op.dst, op.paint);
     }
     Bounds bounds(const DrawBitmapRectFixedSize& op) const {
-        return this->adjustAndMap(op.dst, &op.paint);
+        return this->adjustAndMap(op.dst, op.paint);
     }
     Bounds bounds(const DrawBitmapNine& op) const {
         return this->adjustAndMap(op.dst, op.paint);
@@ -433,27 +448,27 @@ private:
 
     Bounds bounds(const DrawPath& op) const {
         return op.path.isInverseFillType() ? fCurrentClipBounds
-                                           : this->adjustAndMap(op.path.getBounds(), &op.paint);
+                                           : this->adjustAndMap(op.path.getBounds(), op.paint);
     }
     Bounds bounds(const DrawPoints& op) const {
         SkRect dst;
         dst.set(op.pts, op.count);
 
         // Pad the bounding box a little to make sure hairline points' bounds aren't empty.
-        SkScalar stroke = SkMaxScalar(op.paint.getStrokeWidth(), 0.01f);
+        SkScalar stroke = SkMaxScalar(op.paint->getStrokeWidth(), 0.01f);
         dst.outset(stroke/2, stroke/2);
 
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint);
     }
     Bounds bounds(const DrawPatch& op) const {
         SkRect dst;
         dst.set(op.cubics, SkPatchUtils::kNumCtrlPts);
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint);
     }
     Bounds bounds(const DrawVertices& op) const {
         SkRect dst;
         dst.set(op.vertices, op.vertexCount);
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint);
     }
 
     Bounds bounds(const DrawAtlas& op) const {
@@ -473,18 +488,18 @@ private:
     }
 
     Bounds bounds(const DrawPosText& op) const {
-        const int N = op.paint.countText(op.text, op.byteLength);
+        const int N = op.paint->countText(op.text, op.byteLength);
         if (N == 0) {
             return Bounds::MakeEmpty();
         }
 
         SkRect dst;
         dst.set(op.pos, N);
-        AdjustTextForFontMetrics(&dst, op.paint);
-        return this->adjustAndMap(dst, &op.paint);
+        AdjustTextForFontMetrics(&dst, *op.paint);
+        return this->adjustAndMap(dst, op.paint);
     }
     Bounds bounds(const DrawPosTextH& op) const {
-        const int N = op.paint.countText(op.text, op.byteLength);
+        const int N = op.paint->countText(op.text, op.byteLength);
         if (N == 0) {
             return Bounds::MakeEmpty();
         }
@@ -495,15 +510,15 @@ private:
             right = SkMaxScalar(right, op.xpos[i]);
         }
         SkRect dst = { left, op.y, right, op.y };
-        AdjustTextForFontMetrics(&dst, op.paint);
-        return this->adjustAndMap(dst, &op.paint);
+        AdjustTextForFontMetrics(&dst, *op.paint);
+        return this->adjustAndMap(dst, op.paint);
     }
     Bounds bounds(const DrawTextOnPath& op) const {
         SkRect dst = op.path.getBounds();
 
         // Pad all sides by the maximum padding in any direction we'd normally apply.
         SkRect pad = { 0, 0, 0, 0};
-        AdjustTextForFontMetrics(&pad, op.paint);
+        AdjustTextForFontMetrics(&pad, *op.paint);
 
         // That maximum padding happens to always be the right pad today.
         SkASSERT(pad.fLeft == -pad.fRight);
@@ -511,7 +526,7 @@ private:
         SkASSERT(pad.fRight > pad.fBottom);
         dst.outset(pad.fRight, pad.fRight);
 
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint);
     }
 
     Bounds bounds(const DrawTextRSXform& op) const {
@@ -525,7 +540,7 @@ private:
     Bounds bounds(const DrawTextBlob& op) const {
         SkRect dst = op.blob->bounds();
         dst.offset(op.x, op.y);
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint);
     }
 
     Bounds bounds(const DrawDrawable& op) const {
@@ -562,9 +577,9 @@ private:
 
     // Returns true if rect was meaningfully adjusted for the effects of paint,
     // false if the paint could affect the rect in unknown ways.
-    static bool AdjustForPaint(const SkPaint* paint, SkRect* rect) {
+    bool adjustForPaint(const SkPaint* paint, SkRect* rect) const {
         if (paint) {
-            if (paint->canComputeFastBounds()) {
+            if (this->canComputeFastBounds(*paint)) {
                 *rect = paint->computeFastBounds(*rect, rect);
                 return true;
             }
@@ -573,21 +588,69 @@ private:
         return true;
     }
 
+    // SkPaint::canComputeFastBounds() walks draw loopers (drawing them into a scratch canvas) and
+    // image filter DAGs.  Pictures tend to use the same few effects op after op, so we remember
+    // the answer for the last ones we saw.  That answer depends only on these three effects.
+    bool canComputeFastBounds(const SkPaint& paint) const {
+        if (!paint.getLooper() && !paint.getImageFilter()) {
+            return !paint.getRasterizer();
+        }
+        if (paint.getLooper()      != fLastLooper      ||
+            paint.getImageFilter() != fLastImageFilter ||
+            paint.getRasterizer()  != fLastRasterizer) {
+            fLastLooper      = paint.getLooper();
+            fLastImageFilter = paint.getImageFilter();
+            fLastRasterizer  = paint.getRasterizer();
+            fLastCanComputeFastBounds = paint.canComputeFastBounds();
+        }
+        return fLastCanComputeFastBounds;
+    }
+
     bool adjustForSaveLayerPaints(SkRect* rect, int savesToIgnore = 0) const {
         for (int i = fSaveStack.count() - 1 - savesToIgnore; i >= 0; i--) {
-            SkMatrix inverse;
-            if (!fSaveStack[i].ctm.invert(&inverse)) {
-                return false;
+            const SaveBounds& sb = fSaveStack[i];
+            // Without a paint, mapping out of and back into the layer would only loosen rect.
+            if (!sb.paint) {
+                continue;
             }
-            inverse.mapRect(rect);
-            if (!AdjustForPaint(fSaveStack[i].paint, rect)) {
+            if (!sb.canAdjust) {
                 return false;
             }
-            fSaveStack[i].ctm.mapRect(rect);
+            MapRect(sb.inverse, rect);
+            *rect = sb.paint->computeFastBounds(*rect, rect);
+            MapRect(sb.ctm, rect);
         }
         return true;
     }
 
+    // SkMatrix::mapRect(), mapping all four corners of rect at once for affine matrices.
+    static void MapRect(const SkMatrix& matrix, SkRect* rect) {
+        if (matrix.isScaleTranslate() || matrix.hasPerspective()) {
+            matrix.mapRect(rect);
+            return;
+        }
+        const SkScalar sx = matrix.getScaleX(), sy = matrix.getScaleY(),
+                       kx = matrix.getSkewX(),  ky = matrix.getSkewY(),
+                       tx = matrix.getTranslateX(), ty = matrix.getTranslateY();
+        const Sk4f scale(sx, sy, sx, sy),
+                   skew(kx, ky, kx, ky),
+                   trans(tx, ty, tx, ty);
+        // Two corners per Sk4f, as x,y,x,y, mapped just as SkMatrix maps points.
+        Sk4f top(rect->fLeft, rect->fTop,    rect->fRight, rect->fTop),
+             bot(rect->fLeft, rect->fBottom, rect->fRight, rect->fBottom);
+        top = top * scale + SkNx_shuffle<1,0,3,2>(top) * skew + trans;
+        bot = bot * scale + SkNx_shuffle<1,0,3,2>(bot) * skew + trans;
+
+        Sk4f min = Sk4f::Min(top, bot),
+             max = Sk4f::Max(top, bot);
+        min = Sk4f::Min(min, SkNx_shuffle<2,3,0,1>(min));
+        max = Sk4f::Max(max, SkNx_shuffle<2,3,0,1>(max));
+        rect->setLTRB(min[0], min[1], max[0], max[1]);
+        if (!rect->isFinite()) {
+            rect->setEmpty();
+        }
+    }
+
     const int fNumRecords;
 
     // We do not guarantee anything for operations outside of the cull rect
@@ -603,19 +666,115 @@ private:
     SkMatrix fCTM;
     Bounds fCurrentClipBounds;
 
+    // The effects canComputeFastBounds() last looked at, and what it decided.
+    mutable const SkDrawLooper*  fLastLooper;
+    mutable const SkImageFilter* fLastImageFilter;
+    mutable const SkRasterizer*  fLastRasterizer;
+    mutable bool                 fLastCanComputeFastBounds;
+
     // Used to track the bounds of Save/Restore blocks and the control ops inside them.
     SkTDArray<SaveBounds> fSaveStack;
     SkTDArray<int>   fControlIndices;
 };
 
+// Save blocks at the top level of a record don't affect each other's bounds: all FillBounds
+// carries past one is the CTM and clip bounds, and the block's Restore records both.  This visitor
+// tracks the save depth and, outside of any Save block, just that state, so a fresh FillBounds can
+// take over at any op at the top level.
+class TopLevelState : SkNoncopyable {
+public:
+    explicit TopLevelState(const SkRect& cullRect)
+        : fCullRect(cullRect)
+        , fDepth(0)
+        , fCTM(SkMatrix::I())
+        , fClipBounds(cullRect) {}
+
+    template <typename T> void operator()(const T& op) { this->update(op); }
+
+    bool atTopLevel() const { return 0 == fDepth; }
+    const SkMatrix& ctm() const { return fCTM; }
+    const SkRect& clipBounds() const { return fClipBounds; }
+
+private:
+    template <typename T> void update(const T&) {}
+
+    void update(const Save&)      { fDepth++; }
+    void update(const SaveLayer&) { fDepth++; }
+    void update(const Restore& op) {
+        if (0 == --fDepth) {
+            fCTM = op.matrix;
+            this->updateClipBounds(op.devBounds);
+        }
+    }
+
+    void update(const SetMatrix& op) { if (0 == fDepth) { fCTM = op.matrix; } }
+    void update(const Concat& op)    { if (0 == fDepth) { fCTM.preConcat(op.matrix); } }
+
+    void update(const ClipPath&   op) { if (0 == fDepth) { this->updateClipBounds(op.devBounds); } }
+    void update(const ClipRRect&  op) { if (0 == fDepth) { this->updateClipBounds(op.devBounds); } }
+    void update(const ClipRect&   op) { if (0 == fDepth) { this->updateClipBounds(op.devBounds); } }
+    void update(const ClipRegion& op) { if (0 == fDepth) { this->updateClipBounds(op.devBounds); } }
+
+    // FillBounds asks these paths for their bounds, which SkPath computes lazily.  Have that
+    // happen here, before FillBounds runs on several threads.
+    void update(const DrawPath& op)       { op.path.updateBoundsCache(); }
+    void update(const DrawTextOnPath& op) { op.path.updateBoundsCache(); }
+
+    // This is FillBounds::updateClipBoundsForClipOp() with no SaveLayers to adjust for.
+    void updateClipBounds(const SkIRect& devBounds) {
+        fClipBounds = SkRect::Make(devBounds);
+        if (!fClipBounds.intersect(fCullRect)) {
+            fClipBounds = SkRect::MakeEmpty();
+        }
+    }
+
+    const SkRect fCullRect;
+    int fDepth;
+    SkMatrix fCTM;
+    SkRect fClipBounds;
+};
+
 }  // namespace SkRecords
 
+// Records shorter than two spans don't get split up, nor do any without threads to share them.
+static const int kOpsPerSpan = 1024;
+
 void SkRecordFillBounds(const SkRect& cullRect, const SkRecord& record, SkRect bounds[]) {
-    SkRecords::FillBounds visitor(cullRect, record, bounds);
+    auto fill_bounds = [&](int start, int stop, const SkMatrix& ctm, const SkRect& clipBounds) {
+        SkRecords::FillBounds visitor(cullRect, record, bounds, ctm, clipBounds);
+        for (int curOp = start; curOp < stop; curOp++) {
+            visitor.setCurrentOp(curOp);
+            record.visit(curOp, visitor);
+        }
+        visitor.cleanUp();
+    };
+
+    if (record.count() < 2 * kOpsPerSpan || !SkTaskGroup::Enabled()) {
+        fill_bounds(0, record.count(), SkMatrix::I(), cullRect);
+        return;
+    }
+
+    // Split the record into spans of at least kOpsPerSpan ops, each starting at the top level,
+    // and fill in their bounds in parallel.
+    struct Span {
+        int      start;
+        SkMatrix ctm;
+        SkRect   clipBounds;
+    };
+    SkTDArray<Span> spans;
+    spans.push({ 0, SkMatrix::I(), cullRect });
+
+    SkRecords::TopLevelState state(cullRect);
     for (int curOp = 0; curOp < record.count(); curOp++) {
-        visitor.setCurrentOp(curOp);
-        record.visit(curOp, visitor);
+        if (state.atTopLevel() && curOp - spans.top().start >= kOpsPerSpan) {
+            spans.push({ curOp, state.ctm(), state.clipBounds() });
+        }
+        record.visit(curOp, state);
     }
-    visitor.cleanUp();
+
+    SkTaskGroup().batch(spans.count(), [&](int i) {
+        const int stop = i + 1 < spans.count() ? spans[i + 1].start : record.count();
+        fill_bounds(spans[i].start, stop, spans[i].ctm, spans[i].clipBounds);
+    });
 }
 
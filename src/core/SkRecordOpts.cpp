@@ -7,6 +7,8 @@
 
 #include "SkRecordOpts.h"
 
+#include "SkPaintPriv.h"
+#include "SkRecordDraw.h"
 #include "SkRecordPattern.h"
 #include "SkRecords.h"
 #include "SkTDArray.h"
@@ -183,22 +185,25 @@ struct SaveLayerDrawRestoreNooper {
         }
 
         // A SaveLayer's bounds field is just a hint, so we should be free to ignore it.
-        SkPaint* layerPaint = match->first<SaveLayer>()->paint;
+        const SkPaint* layerPaint = match->first<SaveLayer>()->paint;
         if (nullptr == layerPaint) {
             // There wasn't really any point to this SaveLayer at all.
             return KillSaveLayerAndRestore(record, begin);
         }
 
-        SkPaint* drawPaint = match->second<SkPaint>();
-        if (drawPaint == nullptr) {
+        const SkPaint** drawPaint = match->second<const SkPaint*>();
+        if (drawPaint == nullptr || *drawPaint == nullptr) {
             // We can just give the draw the SaveLayer's paint.
             // TODO(mtklein): figure out how to do this clearly
             return false;
         }
 
-        if (!fold_opacity_layer_color_to_paint(*layerPaint, false /*isSaveLayer*/, drawPaint)) {
+        // The draw's paint may be shared with other ops, so we fold into a copy.
+        SkPaint folded(**drawPaint);
+        if (!fold_opacity_layer_color_to_paint(*layerPaint, false /*isSaveLayer*/, &folded)) {
             return false;
         }
+        *drawPaint = record->internPaint(folded);
 
         return KillSaveLayerAndRestore(record, begin);
     }
@@ -234,7 +239,7 @@ struct SvgOpacityAndFilterLayerMergePass {
             return false;
         }
 
-        SkPaint* opacityPaint = match->first<SaveLayer>()->paint;
+        const SkPaint* opacityPaint = match->first<SaveLayer>()->paint;
         if (nullptr == opacityPaint) {
             // There wasn't really any point to this SaveLayer at all.
             return KillSaveLayerAndRestore(record, begin);
@@ -242,17 +247,19 @@ struct SvgOpacityAndFilterLayerMergePass {
 
         // This layer typically contains a filter, but this should work for layers with for other
         // purposes too.
-        SkPaint* filterLayerPaint = match->fourth<SaveLayer>()->paint;
-        if (filterLayerPaint == nullptr) {
+        SaveLayer* filterLayer = match->fourth<SaveLayer>();
+        if (filterLayer->paint == nullptr) {
             // We can just give the inner SaveLayer the paint of the outer SaveLayer.
             // TODO(mtklein): figure out how to do this clearly
             return false;
         }
 
-        if (!fold_opacity_layer_color_to_paint(*opacityPaint, true /*isSaveLayer*/,
-                                               filterLayerPaint)) {
+        // As above, the inner SaveLayer's paint may be shared, so we fold into a copy.
+        SkPaint folded(*filterLayer->paint);
+        if (!fold_opacity_layer_color_to_paint(*opacityPaint, true /*isSaveLayer*/, &folded)) {
             return false;
         }
+        filterLayer->paint = record->internPaint(folded);
 
         return KillSaveLayerAndRestore(record, begin);
     }
@@ -271,6 +278,393 @@ void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord* record) {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+// The passes below aren't pattern-based: they walk the record tracking the matrix and clip.
+// They reason in device pixels, assuming the record is played back without being scaled down.
+
+static SkRect round_in(const SkRect& r) {
+    return SkRect::MakeLTRB(SkScalarCeilToScalar(r.fLeft),  SkScalarCeilToScalar(r.fTop),
+                            SkScalarFloorToScalar(r.fRight), SkScalarFloorToScalar(r.fBottom));
+}
+
+static SkRect map_rect(const SkMatrix& matrix, const SkRect& r) {
+    SkRect mapped;
+    matrix.mapRect(&mapped, r);
+    return mapped;
+}
+
+static SkRect round_out(const SkRect& r) {
+    return SkRect::MakeLTRB(SkScalarFloorToScalar(r.fLeft),  SkScalarFloorToScalar(r.fTop),
+                            SkScalarCeilToScalar(r.fRight),  SkScalarCeilToScalar(r.fBottom));
+}
+
+// Visit each op in order with a ClipTracker to know the CTM and clip before the next op.
+// The device clip always fits within bounds() once rounded out.  exact() means the clip covers
+// at least bounds() intersected with whatever clip we're played back into.
+// Rounding is kept in floats so that huge or infinite rects are safe.
+class ClipTracker {
+public:
+    ClipTracker() {
+        fCTM.reset();
+        fClip.bounds = SkRect::MakeLargest();
+        fClip.exact  = true;
+    }
+
+    const SkMatrix& ctm() const { return fCTM; }
+    const SkRect& bounds() const { return fClip.bounds; }
+    bool exact() const { return fClip.exact; }
+
+    template <typename T> void operator()(const T&) {}
+
+    void operator()(const Save&) { fSaves.push(fClip); }
+    void operator()(const SaveLayer& op) {
+        fSaves.push(fClip);
+        // Layers may replace the clip with its rounded out bounds, which is no problem.
+        // But filtered layers pad those bounds out to make room for the filter.
+        if (op.backdrop || (op.paint && op.paint->getImageFilter())) {
+            fClip.bounds = SkRect::MakeLargest();
+            fClip.exact  = false;
+        }
+    }
+    void operator()(const Restore& op) {
+        fCTM = op.matrix;
+        if (!fSaves.isEmpty()) {
+            fSaves.pop(&fClip);
+        }
+    }
+
+    void operator()(const SetMatrix& op) { fCTM = op.matrix; }
+    void operator()(const Concat& op) { fCTM.preConcat(op.matrix); }
+
+    void operator()(const ClipRect& op) {
+        this->clip(map_rect(fCTM, op.rect), op.opAA.op, fCTM.rectStaysRect());
+    }
+    void operator()(const ClipRRect& op) {
+        this->clip(map_rect(fCTM, op.rrect.getBounds()), op.opAA.op, false);
+    }
+    void operator()(const ClipPath& op) {
+        if (op.path.isInverseFillType()) {
+            this->clip(SkRect::MakeLargest(), SkRegion::kReplace_Op, false);
+        } else {
+            this->clip(map_rect(fCTM, op.path.getBounds()), op.opAA.op, false);
+        }
+    }
+    void operator()(const ClipRegion& op) {
+        // Regions are in device space already.
+        this->clip(SkRect::Make(op.region.getBounds()), op.op, op.region.isRect());
+    }
+
+private:
+    struct Clip {
+        SkRect bounds;
+        bool   exact;
+    };
+
+    void clip(const SkRect& devRect, SkRegion::Op op, bool isRect) {
+        if (op == SkRegion::kIntersect_Op) {
+            this->intersect(devRect, isRect);
+        } else {
+            // Any other op may grow the clip.  We know nothing.
+            fClip.bounds = SkRect::MakeLargest();
+            fClip.exact  = false;
+        }
+    }
+
+    void intersect(const SkRect& devRect, bool isRect) {
+        if (!fClip.bounds.intersect(devRect)) {
+            fClip.bounds.setEmpty();
+        }
+        fClip.exact &= isRect;
+    }
+
+    SkMatrix         fCTM;
+    Clip             fClip;
+    SkTDArray<Clip>  fSaves;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Turns intersecting clips that can't shrink the clip any further into NoOps.  SkCanvas already
+// records clips that are really rects as ClipRects.  Whether a clip is anti-aliased or not, if it
+// contains every pixel the clip so far can touch, it leaves that clip as it is.
+struct ClipSimplifier {
+    ClipSimplifier(SkRecord* record) : fRecord(record) {}
+
+    template <typename T> void operator()(T*) {}
+
+    void operator()(ClipRect* op) {
+        if (op->opAA.op == SkRegion::kIntersect_Op && fClip.ctm().rectStaysRect() &&
+            map_rect(fClip.ctm(), op->rect).contains(round_out(fClip.bounds()))) {
+            fRecord->replace<NoOp>(fIndex);
+        }
+    }
+    void operator()(ClipRRect* op) {
+        SkRRect devRRect;
+        if (op->opAA.op == SkRegion::kIntersect_Op &&
+            op->rrect.transform(fClip.ctm(), &devRRect) &&
+            devRRect.contains(round_out(fClip.bounds()))) {
+            fRecord->replace<NoOp>(fIndex);
+        }
+    }
+    void operator()(ClipPath* op) {
+        SkMatrix inverse;
+        if (op->opAA.op == SkRegion::kIntersect_Op && !op->path.isInverseFillType() &&
+            fClip.ctm().rectStaysRect() && fClip.ctm().invert(&inverse) &&
+            op->path.conservativelyContainsRect(map_rect(inverse, round_out(fClip.bounds())))) {
+            fRecord->replace<NoOp>(fIndex);
+        }
+    }
+
+    SkRecord*   fRecord;
+    ClipTracker fClip;
+    int         fIndex;
+};
+
+void SkRecordSimplifyClips(SkRecord* record) {
+    ClipSimplifier pass(record);
+    for (pass.fIndex = 0; pass.fIndex < record->count(); pass.fIndex++) {
+        record->mutate(pass.fIndex, pass);
+        record->visit(pass.fIndex, pass.fClip);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// How SkRecordNoopOccludedDraws() sees each op on its backward walk.
+enum OcclusionOp {
+    kOther_OcclusionOp,           // Doesn't draw or reads nothing back.  Ignored.
+    kDraw_OcclusionOp,            // Draws within its bounds, and could be a NoOp if occluded.
+    kBarrier_OcclusionOp,         // May read pixels outside its own bounds.
+    kLayer_OcclusionOp,           // A SaveLayer.
+    kBackdropLayer_OcclusionOp,   // A SaveLayer that reads its parent layer back.
+    kRestoreLayer_OcclusionOp,    // The Restore for a SaveLayer.
+};
+
+// On a forward walk, classifies each op and finds the device rects that opaque draws are sure to
+// overwrite.  We only look for occluders among DrawRect and DrawPaint; they're most of them.
+class OccluderFinder {
+public:
+    explicit OccluderFinder(const SkRect& cullRect) : fCullRect(cullRect) {}
+
+    OcclusionOp find(const SkRecord& record, int i, SkRect* occluder) {
+        occluder->setEmpty();
+        fOccluder = occluder;
+        OcclusionOp op = record.visit(i, *this);
+        record.visit(i, fClip);
+        return op;
+    }
+
+    template <typename T>
+    SK_WHEN(T::kTags & kDraw_Tag, OcclusionOp) operator()(const T&) { return kDraw_OcclusionOp; }
+    template <typename T>
+    SK_WHEN(!(T::kTags & kDraw_Tag), OcclusionOp) operator()(const T&) {
+        return kOther_OcclusionOp;
+    }
+
+    // Drawables and pictures may hold layers that read back anything at all.
+    OcclusionOp operator()(const DrawDrawable&) { return kBarrier_OcclusionOp; }
+    OcclusionOp operator()(const DrawPicture&)  { return kBarrier_OcclusionOp; }
+
+    OcclusionOp operator()(const Save&) {
+        fIsLayer.push(false);
+        return kOther_OcclusionOp;
+    }
+    OcclusionOp operator()(const SaveLayer& op) {
+        fIsLayer.push(true);
+        return op.backdrop ? kBackdropLayer_OcclusionOp : kLayer_OcclusionOp;
+    }
+    OcclusionOp operator()(const Restore&) {
+        bool isLayer = false;
+        if (!fIsLayer.isEmpty()) {
+            fIsLayer.pop(&isLayer);
+        }
+        return isLayer ? kRestoreLayer_OcclusionOp : kOther_OcclusionOp;
+    }
+
+    OcclusionOp operator()(const DrawRect& op) {
+        if (fClip.ctm().rectStaysRect()) {
+            this->occlude(map_rect(fClip.ctm(), op.rect), *op.paint);
+        }
+        return kDraw_OcclusionOp;
+    }
+    OcclusionOp operator()(const DrawPaint& op) {
+        this->occlude(fClip.bounds(), *op.paint);
+        return kDraw_OcclusionOp;
+    }
+
+private:
+    void occlude(SkRect devRect, const SkPaint& paint) {
+        if (!fClip.exact()                                 ||
+            paint.getStyle() != SkPaint::kFill_Style       ||
+            paint.getPathEffect() || paint.getMaskFilter() ||
+            paint.getRasterizer() || paint.getLooper()     ||
+            paint.getImageFilter()                         ||
+            !SkPaintPriv::Overwrites(paint)) {
+            return;
+        }
+        // Drawing outside the cull rect is undefined, so we may as well clip to it.
+        // Then only pixels entirely inside the rect are sure to be overwritten.
+        if (devRect.intersect(fClip.bounds()) && devRect.intersect(fCullRect)) {
+            *fOccluder = round_in(devRect);
+        }
+    }
+
+    const SkRect    fCullRect;
+    ClipTracker     fClip;
+    SkTDArray<bool> fIsLayer;
+    SkRect*         fOccluder;
+};
+
+void SkRecordNoopOccludedDraws(SkRecord* record, const SkRect& cullRect) {
+    const int count = record->count();
+    SkAutoTMalloc<SkRect>      bounds(count),
+                               occluders(count);
+    SkAutoTMalloc<OcclusionOp> ops(count);
+
+    SkRecordFillBounds(cullRect, *record, bounds);
+    OccluderFinder finder(cullRect);
+    for (int i = 0; i < count; i++) {
+        ops[i] = finder.find(*record, i, &occluders[i]);
+    }
+
+    // Walk backward remembering the occluders drawn later into each layer that's open.  Layers
+    // are composited into their parent before anything later in the parent draws, so a draw may
+    // be occluded by anything in its own layer or any layer it's nested inside.
+    // We keep only a few of the biggest occluders per layer; most of the win is the first one.
+    static const int kMaxOccludersPerLayer = 8;
+    SkTDArray<SkRect> live;
+    SkTDArray<int>    layerStarts;
+    layerStarts.push(0);
+
+    for (int i = count - 1; i >= 0; i--) {
+        switch (ops[i]) {
+            case kOther_OcclusionOp:
+                break;
+
+            case kBarrier_OcclusionOp:
+                live.rewind();
+                for (int j = 0; j < layerStarts.count(); j++) {
+                    layerStarts[j] = 0;
+                }
+                break;
+
+            case kRestoreLayer_OcclusionOp:
+                layerStarts.push(live.count());
+                break;
+
+            case kBackdropLayer_OcclusionOp:
+                // This layer reads back everything that we'd NoOp beneath it.
+                live.rewind();
+                for (int j = 0; j < layerStarts.count(); j++) {
+                    layerStarts[j] = 0;
+                }
+                // fall through
+            case kLayer_OcclusionOp:
+                if (layerStarts.count() > 1) {
+                    live.setCount(layerStarts.top());
+                    layerStarts.pop();
+                }
+                break;
+
+            case kDraw_OcclusionOp: {
+                // Outset for hairlines and anti-aliasing, which may touch pixels just outside.
+                SkRect drawn = bounds[i].makeOutset(1, 1);
+                bool occluded = false;
+                for (int j = 0; j < live.count() && !occluded; j++) {
+                    occluded = live[j].contains(drawn);
+                }
+                if (occluded) {
+                    record->replace<NoOp>(i);
+                } else if (!occluders[i].isEmpty()) {
+                    const int start = layerStarts.top();
+                    if (live.count() - start < kMaxOccludersPerLayer) {
+                        live.push(occluders[i]);
+                    } else {
+                        int smallest = start;
+                        for (int j = start + 1; j < live.count(); j++) {
+                            if (live[j].width() * live[j].height() <
+                                live[smallest].width() * live[smallest].height()) {
+                                smallest = j;
+                            }
+                        }
+                        if (occluders[i].width() * occluders[i].height() >
+                            live[smallest].width() * live[smallest].height()) {
+                            live[smallest] = occluders[i];
+                        }
+                    }
+                }
+            } break;
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static bool can_merge(const SkPaint& paint) {
+    // Anything that looks beyond a path's own pixels, or draws it more than once, can't merge.
+    return paint.getStyle() == SkPaint::kFill_Style &&
+           !paint.getPathEffect() && !paint.getMaskFilter() && !paint.getRasterizer() &&
+           !paint.getLooper()     && !paint.getImageFilter();
+}
+
+void SkRecordMergeDrawPaths(SkRecord* record) {
+    // Filling paths that touch no common pixels as one path draws just the same.  We only merge
+    // DrawPaths separated by nothing but NoOps, so they share their matrix and clip.
+    static const int kMaxPathsPerMerge = 64;
+    SkRect merged[kMaxPathsPerMerge];
+    int mergedCount = 0;
+    DrawPath* first = nullptr;
+
+    auto finishMerge = [&] {
+        if (first && mergedCount > 1) {
+            first->path.updateBoundsCache();  // PreCachedPath keeps its bounds ready for threads.
+        }
+        first = nullptr;
+        mergedCount = 0;
+    };
+
+    ClipTracker clip;
+    for (int i = 0; i < record->count(); i++) {
+        Is<DrawPath> isDrawPath;
+        Is<NoOp>     isNoOp;
+        if (record->mutate(i, isNoOp)) {
+            continue;
+        }
+        if (!record->mutate(i, isDrawPath)) {
+            finishMerge();
+            record->visit(i, clip);
+            continue;
+        }
+
+        DrawPath* op = isDrawPath.get();
+        if (op->path.isInverseFillType() || !can_merge(*op->paint)) {
+            finishMerge();
+            continue;
+        }
+
+        // Outset to be sure anti-aliased edges don't share pixels.
+        SkRect devBounds = map_rect(clip.ctm(), op->path.getBounds()).makeOutset(1, 1);
+
+        bool merge = first && mergedCount < kMaxPathsPerMerge
+                           && first->path.getFillType() == op->path.getFillType()
+                           && (first->paint == op->paint || *first->paint == *op->paint);
+        for (int j = 0; merge && j < mergedCount; j++) {
+            merge = !SkRect::Intersects(merged[j], devBounds);
+        }
+
+        if (merge) {
+            first->path.addPath(op->path);
+            record->replace<NoOp>(i);
+        } else {
+            finishMerge();
+            first = op;
+        }
+        merged[mergedCount++] = devBounds;
+    }
+    finishMerge();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
 void SkRecordOptimize(SkRecord* record) {
     // This might be useful  as a first pass in the future if we want to weed
     // out junk for other optimization passes.  Right now, nothing needs it,
@@ -292,3 +686,17 @@ void SkRecordOptimize2(SkRecord* record) {
 
     record->defrag();
 }
+
+void SkRecordOptimizeOverdraw(SkRecord* record, const SkRect& cullRect) {
+    multiple_set_matrices(record);
+    SkRecordSimplifyClips(record);
+    SkRecordNoopSaveRestores(record);
+    SkRecordNoopSaveLayerDrawRestores(record);
+    SkRecordMergeSvgOpacityAndFilterLayers(record);
+
+    SkRecordNoopOccludedDraws(record, cullRect);
+    SkRecordNoopSaveRestores(record);  // Occluded draws may leave empty Save blocks behind.
+    SkRecordMergeDrawPaths(record);
+
+    record->defrag();
+}
@@ -24,6 +24,20 @@ void SkRecordNoopSaveLayerDrawRestores(SkRecord*);
 // the alpha of the first SaveLayer to the second SaveLayer.
 void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord*);
 
+// Turns intersecting clips that can't shrink the clip any further into no-ops.
+void SkRecordSimplifyClips(SkRecord*);
+
+// No-ops draws entirely covered by later opaque DrawRects or DrawPaints in the same layer
+// (or a layer they're nested inside).  Anything drawn outside cullRect is ignored.
+void SkRecordNoopOccludedDraws(SkRecord*, const SkRect& cullRect);
+
+// Merges runs of DrawPaths with the same paint that touch no common pixels into one DrawPath.
+void SkRecordMergeDrawPaths(SkRecord*);
+
+// Everything SkRecordOptimize() does, plus the passes above.  These assume the record is played
+// back at roughly the scale it was recorded, so that device pixels stay at least as large.
+void SkRecordOptimizeOverdraw(SkRecord*, const SkRect& cullRect);
+
 // Experimental optimizers
 void SkRecordOptimize2(SkRecord*);
 
@@ -39,17 +39,18 @@ private:
     type* fPtr;
 };
 
-// Matches any command that draws, and stores its paint.
+// Matches any command that draws, and stores where it keeps its paint.  Paints are shared, so
+// to change one, point that slot at a changed copy interned with SkRecord::internPaint().
 class IsDraw {
 public:
     IsDraw() : fPaint(nullptr) {}
 
-    typedef SkPaint type;
+    typedef const SkPaint* type;
     type* get() { return fPaint; }
 
     template <typename T>
     SK_WHEN(T::kTags & kDraw_Tag, bool) operator()(T* draw) {
-        fPaint = AsPtr(draw->paint);
+        fPaint = &draw->paint;
         return true;
     }
 
@@ -66,10 +67,6 @@ public:
     }
 
 private:
-    // Abstracts away whether the paint is always part of the command or optional.
-    template <typename T> static T* AsPtr(SkRecords::Optional<T>& x) { return x; }
-    template <typename T> static T* AsPtr(T& x) { return &x; }
-
     type* fPaint;
 };
 
@@ -42,14 +42,18 @@ SkRecorder::SkRecorder(SkRecord* record, int width, int height, SkMiniRecorder*
     , fDrawPictureMode(Record_DrawPictureMode)
     , fApproxBytesUsedBySubPictures(0)
     , fRecord(record)
-    , fMiniRecorder(mr) {}
+    , fMiniRecorder(mr)
+    , fFlusher(nullptr)
+    , fFlushCount(0) {}
 
 SkRecorder::SkRecorder(SkRecord* record, const SkRect& bounds, SkMiniRecorder* mr)
     : SkCanvas(bounds.roundOut(), SkCanvas::kConservativeRasterClip_InitFlag)
     , fDrawPictureMode(Record_DrawPictureMode)
     , fApproxBytesUsedBySubPictures(0)
     , fRecord(record)
-    , fMiniRecorder(mr) {}
+    , fMiniRecorder(mr)
+    , fFlusher(nullptr)
+    , fFlushCount(0) {}
 
 void SkRecorder::reset(SkRecord* record, const SkRect& bounds,
                        DrawPictureMode dpm, SkMiniRecorder* mr) {
@@ -67,10 +71,18 @@ void SkRecorder::forgetRecord() {
 }
 
 // To make appending to fRecord a little less verbose.
-#define APPEND(T, ...)             \
-    if (fMiniRecorder) {           \
-        this->flushMiniRecorder(); \
-    }                              \
+// Draws also notify any SkSurface we're recording for (see SkSurface::MakeRasterThreaded()),
+// so it can invalidate snapshots just like a canvas that draws directly would.
+#define APPEND(T, ...)                                   \
+    if (fMiniRecorder) {                                 \
+        this->flushMiniRecorder();                       \
+    }                                                    \
+    if (fFlusher && fRecord->count() >= fFlushCount) {   \
+        fRecord = fFlusher->flush(fRecord);              \
+    }                                                    \
+    if (SkRecords::T::kTags & SkRecords::kDraw_Tag) {    \
+        this->predrawNotify();                           \
+    }                                                    \
     new (fRecord->append<SkRecords::T>()) SkRecords::T{__VA_ARGS__}
 
 #define TRY_MINIRECORDER(method, ...)                       \
@@ -89,6 +101,15 @@ T* SkRecorder::copy(const T* src) {
     return new (fRecord->alloc<T>()) T(*src);
 }
 
+// Paints are interned rather than copied, so ops that draw with the same paint share one copy.
+const SkPaint* SkRecorder::copy(const SkPaint& paint) {
+    return fRecord->internPaint(paint);
+}
+
+const SkPaint* SkRecorder::copy(const SkPaint* paint) {
+    return paint ? fRecord->internPaint(*paint) : nullptr;
+}
+
 // This copy() is for arrays.
 // It will work with POD or non-POD, though currently we only use it for POD.
 template <typename T>
@@ -131,31 +152,33 @@ void SkRecorder::flushMiniRecorder() {
 }
 
 void SkRecorder::onDrawPaint(const SkPaint& paint) {
-    APPEND(DrawPaint, paint);
+    APPEND(DrawPaint, this->copy(paint));
 }
 
 void SkRecorder::onDrawPoints(PointMode mode,
                               size_t count,
                               const SkPoint pts[],
                               const SkPaint& paint) {
-    APPEND(DrawPoints, paint, mode, SkToUInt(count), this->copy(pts, count));
+    APPEND(DrawPoints, this->copy(paint), mode, SkToUInt(count), this->copy(pts, count));
 }
 
 void SkRecorder::onDrawRect(const SkRect& rect, const SkPaint& paint) {
     TRY_MINIRECORDER(drawRect, rect, paint);
-    APPEND(DrawRect, paint, rect);
+    APPEND(DrawRect, this->copy(paint), rect);
 }
 
 void SkRecorder::onDrawOval(const SkRect& oval, const SkPaint& paint) {
-    APPEND(DrawOval, paint, oval);
+    TRY_MINIRECORDER(drawOval, oval, paint);
+    APPEND(DrawOval, this->copy(paint), oval);
 }
 
 void SkRecorder::onDrawRRect(const SkRRect& rrect, const SkPaint& paint) {
-    APPEND(DrawRRect, paint, rrect);
+    TRY_MINIRECORDER(drawRRect, rrect, paint);
+    APPEND(DrawRRect, this->copy(paint), rrect);
 }
 
 void SkRecorder::onDrawDRRect(const SkRRect& outer, const SkRRect& inner, const SkPaint& paint) {
-    APPEND(DrawDRRect, paint, outer, inner);
+    APPEND(DrawDRRect, this->copy(paint), outer, inner);
 }
 
 void SkRecorder::onDrawDrawable(SkDrawable* drawable, const SkMatrix* matrix) {
@@ -173,7 +196,7 @@ void SkRecorder::onDrawDrawable(SkDrawable* drawable, const SkMatrix* matrix) {
 
 void SkRecorder::onDrawPath(const SkPath& path, const SkPaint& paint) {
     TRY_MINIRECORDER(drawPath, path, paint);
-    APPEND(DrawPath, paint, path);
+    APPEND(DrawPath, this->copy(paint), path);
 }
 
 void SkRecorder::onDrawBitmap(const SkBitmap& bitmap,
@@ -244,14 +267,14 @@ void SkRecorder::onDrawImageNine(const SkImage* image, const SkIRect& center,
 void SkRecorder::onDrawText(const void* text, size_t byteLength,
                             SkScalar x, SkScalar y, const SkPaint& paint) {
     APPEND(DrawText,
-           paint, this->copy((const char*)text, byteLength), byteLength, x, y);
+           this->copy(paint), this->copy((const char*)text, byteLength), byteLength, x, y);
 }
 
 void SkRecorder::onDrawPosText(const void* text, size_t byteLength,
                                const SkPoint pos[], const SkPaint& paint) {
     const int points = paint.countText(text, byteLength);
     APPEND(DrawPosText,
-           paint,
+           this->copy(paint),
            this->copy((const char*)text, byteLength),
            byteLength,
            this->copy(pos, points));
@@ -261,7 +284,7 @@ void SkRecorder::onDrawPosTextH(const void* text, size_t byteLength,
                                 const SkScalar xpos[], SkScalar constY, const SkPaint& paint) {
     const int points = paint.countText(text, byteLength);
     APPEND(DrawPosTextH,
-           paint,
+           this->copy(paint),
            this->copy((const char*)text, byteLength),
            SkToUInt(byteLength),
            constY,
@@ -271,7 +294,7 @@ void SkRecorder::onDrawPosTextH(const void* text, size_t byteLength,
 void SkRecorder::onDrawTextOnPath(const void* text, size_t byteLength, const SkPath& path,
                                   const SkMatrix* matrix, const SkPaint& paint) {
     APPEND(DrawTextOnPath,
-           paint,
+           this->copy(paint),
            this->copy((const char*)text, byteLength),
            byteLength,
            path,
@@ -281,7 +304,7 @@ void SkRecorder::onDrawTextOnPath(const void* text, size_t byteLength, const SkP
 void SkRecorder::onDrawTextRSXform(const void* text, size_t byteLength, const SkRSXform xform[],
                                    const SkRect* cull, const SkPaint& paint) {
     APPEND(DrawTextRSXform,
-           paint,
+           this->copy(paint),
            this->copy((const char*)text, byteLength),
            byteLength,
            this->copy(xform, paint.countText(text, byteLength)),
@@ -291,7 +314,7 @@ void SkRecorder::onDrawTextRSXform(const void* text, size_t byteLength, const Sk
 void SkRecorder::onDrawTextBlob(const SkTextBlob* blob, SkScalar x, SkScalar y,
                                 const SkPaint& paint) {
     TRY_MINIRECORDER(drawTextBlob, blob, x, y, paint);
-    APPEND(DrawTextBlob, paint, blob, x, y);
+    APPEND(DrawTextBlob, this->copy(paint), blob, x, y);
 }
 
 void SkRecorder::onDrawPicture(const SkPicture* pic, const SkMatrix* matrix, const SkPaint* paint) {
@@ -310,7 +333,7 @@ void SkRecorder::onDrawVertices(VertexMode vmode,
                                 const SkPoint texs[], const SkColor colors[],
                                 SkXfermode* xmode,
                                 const uint16_t indices[], int indexCount, const SkPaint& paint) {
-    APPEND(DrawVertices, paint,
+    APPEND(DrawVertices, this->copy(paint),
                          vmode,
                          vertexCount,
                          this->copy(vertices, vertexCount),
@@ -323,7 +346,7 @@ void SkRecorder::onDrawVertices(VertexMode vmode,
 
 void SkRecorder::onDrawPatch(const SkPoint cubics[12], const SkColor colors[4],
                              const SkPoint texCoords[4], SkXfermode* xmode, const SkPaint& paint) {
-    APPEND(DrawPatch, paint,
+    APPEND(DrawPatch, this->copy(paint),
            cubics ? this->copy(cubics, SkPatchUtils::kNumCtrlPts) : nullptr,
            colors ? this->copy(colors, SkPatchUtils::kNumCorners) : nullptr,
            texCoords ? this->copy(texCoords, SkPatchUtils::kNumCorners) : nullptr,
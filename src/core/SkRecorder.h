@@ -53,6 +53,20 @@ public:
     // Make SkRecorder forget entirely about its SkRecord*; all calls to SkRecorder will fail.
     void forgetRecord();
 
+    // Lets SkRecorder record an unbounded number of ops into a bounded SkRecord.
+    // Once our SkRecord holds flushCount ops, flush() is passed that SkRecord before we append
+    // anything else.  It must return an empty SkRecord for us to carry on recording into.
+    // Unlike reset(), this leaves the canvas' save/clip/matrix state alone.
+    class Flusher {
+    public:
+        virtual ~Flusher() {}
+        virtual SkRecord* flush(SkRecord*) = 0;
+    };
+    void setFlusher(Flusher* flusher, int flushCount) {
+        fFlusher = flusher;
+        fFlushCount = flushCount;
+    }
+
     void willSave() override;
     SaveLayerStrategy getSaveLayerStrategy(const SaveLayerRec&) override;
     void willRestore() override {}
@@ -139,6 +153,9 @@ private:
     template <typename T>
     T* copy(const T[], size_t count);
 
+    const SkPaint* copy(const SkPaint&);
+    const SkPaint* copy(const SkPaint*);
+
     SkIRect devBounds() const {
         SkIRect devBounds;
         this->getClipDeviceBounds(&devBounds);
@@ -151,6 +168,9 @@ private:
     SkAutoTDelete<SkDrawableList> fDrawableList;
 
     SkMiniRecorder* fMiniRecorder;
+
+    Flusher* fFlusher;
+    int      fFlushCount;
 };
 
 #endif//SkRecorder_DEFINED
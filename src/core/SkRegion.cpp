@@ -229,7 +229,10 @@ static bool isRunCountEmpty(int count) {
 }
 
 bool SkRegion::setRuns(RunType runs[], int count) {
-    SkDEBUGCODE(this->validate();)
+    // Oper may have already written the runs over our own
+    SkDEBUGCODE(if (!this->isComplex() || runs != fRunHead->readonly_runs()) {
+        this->validate();
+    })
     SkASSERT(count > 0);
 
     if (isRunCountEmpty(count)) {
@@ -280,15 +283,16 @@ bool SkRegion::setRuns(RunType runs[], int count) {
 
     //  if we get here, we need to become a complex region
 
-    if (!this->isComplex() || fRunHead->fRunCount != count) {
+    // reuse our buffer if we own it and it is big enough
+    if (this->isComplex() && fRunHead->canReuse(count)) {
+        fRunHead->fRunCount = count;
+    } else {
         this->freeRuns();
         this->allocateRuns(count);
     }
 
-    // must call this before we can write directly into runs()
-    // in case we are sharing the buffer with another region (copy on write)
-    fRunHead = fRunHead->ensureWritable();
-    memcpy(fRunHead->writable_runs(), runs, count * sizeof(RunType));
+    // runs may already be in our buffer (see Oper), so they may overlap
+    memmove(fRunHead->writable_runs(), runs, count * sizeof(RunType));
     fRunHead->computeRunBounds(&fBounds);
 
     SkDEBUGCODE(this->validate();)
@@ -926,6 +930,64 @@ static int operate(const SkRegion::RunType a_runs[],
     return oper.flush();
 }
 
+/*  Intersect the runs of a complex region with clip, one scanline at a time, merging
+    scanlines that end up the same. The result is never longer than runs, and dst may
+    be runs, since each scanline is read before anything is written over it.
+    Returns the number of RunTypes written to dst.
+ */
+static int clip_runs(const SkRegion::RunType runs[], const SkIRect& clip,
+                     SkRegion::RunType dst[]) {
+    int top = SkMax32(*runs++, clip.fTop);
+    int prevBot = top;
+    SkRegion::RunType* prev = nullptr;  // the last scanline we kept
+    SkRegion::RunType* out = dst + 1;
+
+    while (runs[0] < SkRegion::kRunTypeSentinel && prevBot < clip.fBottom) {
+        int bot = runs[0];
+        int intervals = runs[1];
+        const SkRegion::RunType* src = runs + 2;
+        runs = src + intervals * 2 + 1;
+        if (bot <= clip.fTop) {
+            continue;
+        }
+        prevBot = bot;
+        bot = SkMin32(bot, clip.fBottom);
+
+        SkRegion::RunType* start = out + 2;
+        SkRegion::RunType* x = start;
+        for (int i = 0; i < intervals; ++i) {
+            int left = SkMax32(src[0], clip.fLeft);
+            int rite = SkMin32(src[1], clip.fRight);
+            src += 2;
+            if (left < rite) {
+                *x++ = (SkRegion::RunType)(left);
+                *x++ = (SkRegion::RunType)(rite);
+            }
+        }
+        *x++ = SkRegion::kRunTypeSentinel;
+        int count = SkToInt((x - start - 1) >> 1);
+
+        if (prev && prev[1] == count &&
+                !memcmp(prev + 2, start, count * 2 * sizeof(SkRegion::RunType))) {
+            prev[0] = (SkRegion::RunType)(bot);  // same as the last one, so extend it
+        } else if (!prev && !count) {
+            top = bot;                           // skip empty scanlines at the top
+        } else {
+            out[0] = (SkRegion::RunType)(bot);
+            out[1] = count;
+            prev = out;
+            out = x;
+        }
+    }
+    // drop an empty scanline at the bottom
+    if (prev && !prev[1]) {
+        out = prev;
+    }
+    dst[0] = (SkRegion::RunType)(top);
+    *out++ = SkRegion::kRunTypeSentinel;
+    return SkToInt(out - dst);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 /*  Given count RunTypes in a complex region, return the worst case number of
@@ -1058,6 +1120,34 @@ bool SkRegion::Oper(const SkRegion& rgnaOrig, const SkRegion& rgnbOrig, Op op,
         return false;
     }
 
+    bool resultIsInput = result == rgna || result == rgnb;
+
+    // Intersecting a complex region with a rect just clips its scanlines, so the result is
+    // no bigger than the region. Clip straight into result's buffer if that does not
+    // overwrite the other input, and otherwise into a new one big enough to be reused.
+    if (kIntersect_Op == op && (a_rect || b_rect)) {
+        const SkRegion* complex = a_rect ? rgnb : rgna;
+        SkASSERT(complex->isComplex());
+        const RunType* runs = complex->fRunHead->readonly_runs();
+        int runCount = complex->fRunHead->fRunCount;
+        if (!result) {
+            SkAutoSTMalloc<256, RunType> array(runCount);
+            return !isRunCountEmpty(clip_runs(runs, bounds, array.get()));
+        }
+        int count;
+        if (result->isComplex() && result->fRunHead->canReuse(runCount)
+                && (!resultIsInput || result == complex)) {
+            count = clip_runs(runs, bounds, result->fRunHead->writable_runs());
+        } else {
+            RunHead* head = RunHead::Alloc(runCount);
+            count = clip_runs(runs, bounds, head->writable_runs());
+            result->freeRuns();
+            result->fRunHead = head;
+        }
+        SkASSERT(count <= runCount);
+        return result->setRuns(result->fRunHead->writable_runs(), count);
+    }
+
     RunType tmpA[kRectRegionRuns];
     RunType tmpB[kRectRegionRuns];
 
@@ -1065,20 +1155,28 @@ bool SkRegion::Oper(const SkRegion& rgnaOrig, const SkRegion& rgnbOrig, Op op,
     const RunType* a_runs = rgna->getRuns(tmpA, &a_intervals);
     const RunType* b_runs = rgnb->getRuns(tmpB, &b_intervals);
 
+    // write straight into result's buffer if it is big enough and not an input
     int dstCount = compute_worst_case_count(a_intervals, b_intervals);
-    SkAutoSTMalloc<256, RunType> array(dstCount);
+    SkAutoSTMalloc<256, RunType> array;
+    RunType* dst;
+    if (result && !resultIsInput && result->isComplex()
+            && result->fRunHead->canReuse(dstCount)) {
+        dst = result->fRunHead->writable_runs();
+    } else {
+        dst = array.reset(dstCount);
+    }
 
 #ifdef SK_DEBUG
 //  Sometimes helpful to seed everything with a known value when debugging
-//  sk_memset32((uint32_t*)array.get(), 0x7FFFFFFF, dstCount);
+//  sk_memset32((uint32_t*)dst, 0x7FFFFFFF, dstCount);
 #endif
 
-    int count = operate(a_runs, b_runs, array.get(), op, nullptr == result);
+    int count = operate(a_runs, b_runs, dst, op, nullptr == result);
     SkASSERT(count <= dstCount);
 
     if (result) {
         SkASSERT(count >= 0);
-        return result->setRuns(array.get(), count);
+        return result->setRuns(dst, count);
     } else {
         return (QUICK_EXIT_TRUE_COUNT == count) || !isRunCountEmpty(count);
     }
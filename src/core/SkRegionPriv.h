@@ -70,6 +70,7 @@ public:
         RunHead* head = (RunHead*)sk_malloc_throw(size);
         head->fRefCnt = 1;
         head->fRunCount = count;
+        head->fCapacity = count;
         // these must be filled in later, otherwise we will be invalid
         head->fYSpanCount = 0;
         head->fIntervalCount = 0;
@@ -86,6 +87,14 @@ public:
         return head;
     }
 
+    /**
+     *  True if we are not shared, and can hold count runs, so a new region
+     *  can be written straight into us.
+     */
+    bool canReuse(int count) const {
+        return 1 == fRefCnt && count <= fCapacity;
+    }
+
     SkRegion::RunType* writable_runs() {
         SkASSERT(fRefCnt == 1);
         return (SkRegion::RunType*)(this + 1);
@@ -230,6 +239,7 @@ public:
 private:
     int32_t fYSpanCount;
     int32_t fIntervalCount;
+    int32_t fCapacity;      // number of runs allocated, at least fRunCount
 };
 
 #endif
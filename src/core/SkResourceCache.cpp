@@ -5,10 +5,12 @@
  * found in the LICENSE file.
  */
 
-#include "SkChecksum.h"
+#include "SkDiscardableMemoryPool.h"
 #include "SkMessageBus.h"
 #include "SkMipMap.h"
 #include "SkMutex.h"
+#include "SkOnce.h"
+#include "SkOpts.h"
 #include "SkPixelRef.h"
 #include "SkResourceCache.h"
 #include "SkTraceMemoryDump.h"
@@ -29,6 +31,11 @@ DECLARE_SKMESSAGEBUS_MESSAGE(SkResourceCache::PurgeSharedIDMessage)
     #define SK_DEFAULT_IMAGE_CACHE_LIMIT     (32 * 1024 * 1024)
 #endif
 
+// Sharded caches, including the global one, are split into this many independently locked shards.
+#ifndef SK_RESOURCE_CACHE_SHARD_COUNT
+    #define SK_RESOURCE_CACHE_SHARD_COUNT    4
+#endif
+
 void SkResourceCache::Key::init(void* nameSpace, uint64_t sharedID, size_t dataSize) {
     SkASSERT(SkAlign4(dataSize) == dataSize);
 
@@ -46,9 +53,9 @@ void SkResourceCache::Key::init(void* nameSpace, uint64_t sharedID, size_t dataS
     fSharedID_lo = (uint32_t)sharedID;
     fSharedID_hi = (uint32_t)(sharedID >> 32);
     fNamespace = nameSpace;
-    // skip unhashed fields when computing the murmur
-    fHash = SkChecksum::Murmur3(this->as32() + kUnhashedLocal32s,
-                                (fCount32 - kUnhashedLocal32s) << 2);
+    // skip unhashed fields when computing the hash
+    fHash = SkOpts::hash(this->as32() + kUnhashedLocal32s,
+                         (fCount32 - kUnhashedLocal32s) << 2);
 }
 
 #include "SkTDynamicHash.h"
@@ -65,6 +72,9 @@ void SkResourceCache::init() {
     fHash = new Hash;
     fTotalBytesUsed = 0;
     fCount = 0;
+    fDiscardableCountLimit = SK_DISCARDABLEMEMORY_SCALEDIMAGECACHE_COUNT_LIMIT;
+    fFindHitCount = 0;
+    fFindMissCount = 0;
     fSingleAllocationByteLimit = 0;
     fAllocator = nullptr;
 
@@ -228,12 +238,13 @@ bool SkResourceCache::find(const Key& key, FindVisitor visitor, void* context) {
     if (rec) {
         if (visitor(*rec, context)) {
             this->moveToHead(rec);  // for our LRU
+            fFindHitCount += 1;
             return true;
         } else {
             this->remove(rec);  // stale
-            return false;
         }
     }
+    fFindMissCount += 1;
     return false;
 }
 
@@ -301,7 +312,7 @@ void SkResourceCache::purgeAsNeeded(bool forcePurge) {
     int    countLimit;
 
     if (fDiscardableFactory) {
-        countLimit = SK_DISCARDABLEMEMORY_SCALEDIMAGECACHE_COUNT_LIMIT;
+        countLimit = fDiscardableCountLimit;
         byteLimit = SK_MaxU32;  // no limit based on bytes
     } else {
         countLimit = SK_MaxS32; // no limit based on count
@@ -320,6 +331,15 @@ void SkResourceCache::purgeAsNeeded(bool forcePurge) {
     }
 }
 
+void SkResourceCache::purgeToBytes(size_t bytes) {
+    Rec* rec = fTail;
+    while (rec && fTotalBytesUsed > bytes) {
+        Rec* prev = rec->fPrev;
+        this->remove(rec);
+        rec = prev;
+    }
+}
+
 //#define SK_TRACK_PURGE_SHAREDID_HITRATE
 
 #ifdef SK_TRACK_PURGE_SHAREDID_HITRATE
@@ -382,6 +402,16 @@ size_t SkResourceCache::setTotalByteLimit(size_t newLimit) {
     return prevLimit;
 }
 
+int SkResourceCache::setDiscardableCountLimit(int newLimit) {
+    SkASSERT(newLimit > 0);
+    int prevLimit = fDiscardableCountLimit;
+    fDiscardableCountLimit = newLimit;
+    if (newLimit < prevLimit) {
+        this->purgeAsNeeded();
+    }
+    return prevLimit;
+}
+
 SkCachedData* SkResourceCache::newCachedData(size_t bytes) {
     this->checkMessages();
 
@@ -542,91 +572,246 @@ void SkResourceCache::checkMessages() {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-SK_DECLARE_STATIC_MUTEX(gMutex);
-static SkResourceCache* gResourceCache = nullptr;
+static_assert(SK_RESOURCE_CACHE_SHARD_COUNT > 0, "need_at_least_one_shard");
+static const int kShardCount = SK_RESOURCE_CACHE_SHARD_COUNT;
+
+// Shard i's part of a budget split evenly across the shards.  The last shard takes the
+// remainder, so the parts always add up to the whole.
+static size_t shard_share(size_t total, int shardIndex) {
+    size_t share = total / kShardCount;
+    return shardIndex == kShardCount - 1 ? total - share * (kShardCount - 1) : share;
+}
+
+// Use the top bits of the hash: SkTDynamicHash indexes by the bottom bits, and we don't want
+// every key in a shard to share those.
+static int shard_index(const SkResourceCache::Key& key) {
+    return (int)(((uint64_t)key.hash() * kShardCount) >> 32);
+}
+
+// Each shard's lock guards its cache.
+struct SkShardedResourceCache::Shard {
+    SkMutex          fMutex;
+    SkResourceCache* fCache = nullptr;
+};
+
+// Locks one shard, exposing its cache.
+class SkShardedResourceCache::AutoShard : SkNoncopyable {
+public:
+    AutoShard(const SkShardedResourceCache& cache, int shardIndex)
+        : fLock(cache.fShards[shardIndex].fMutex)
+        , fCache(cache.fShards[shardIndex].fCache) {}
+
+    SkResourceCache* operator->() const { return fCache; }
+    SkResourceCache& operator*() const { return *fCache; }
+
+private:
+    SkAutoMutexAcquire fLock;
+    SkResourceCache*   fCache;
+};
+
+// Most settings are the same in every shard, so we just ask the first one.
+static const int kFirstShard = 0;
+
+SkShardedResourceCache::SkShardedResourceCache(size_t byteLimit)
+    : fDiscardableFactory(nullptr)
+    , fShards(new Shard[kShardCount]) {
+    for (int i = 0; i < kShardCount; i++) {
+        fShards[i].fCache = new SkResourceCache(shard_share(byteLimit, i));
+    }
+}
+
+SkShardedResourceCache::SkShardedResourceCache(SkResourceCache::DiscardableFactory factory,
+                                               int countLimit)
+    : fDiscardableFactory(factory)
+    , fShards(new Shard[kShardCount]) {
+    for (int i = 0; i < kShardCount; i++) {
+        fShards[i].fCache = new SkResourceCache(factory);
+        fShards[i].fCache->setDiscardableCountLimit(
+                SkTMax(1, (int)shard_share(countLimit, i)));
+    }
+}
+
+SkShardedResourceCache::~SkShardedResourceCache() {
+    for (int i = 0; i < kShardCount; i++) {
+        delete fShards[i].fCache;
+    }
+    delete[] fShards;
+}
+
+size_t SkShardedResourceCache::getTotalBytesUsed() {
+    size_t total = 0;
+    for (int i = 0; i < kShardCount; i++) {
+        total += AutoShard(*this, i)->getTotalBytesUsed();
+    }
+    return total;
+}
+
+size_t SkShardedResourceCache::getTotalByteLimit() {
+    size_t total = 0;
+    for (int i = 0; i < kShardCount; i++) {
+        total += AutoShard(*this, i)->getTotalByteLimit();
+    }
+    return total;
+}
+
+size_t SkShardedResourceCache::setTotalByteLimit(size_t newLimit) {
+    size_t prevLimit = 0;
+    for (int i = 0; i < kShardCount; i++) {
+        prevLimit += AutoShard(*this, i)->setTotalByteLimit(shard_share(newLimit, i));
+    }
+    return prevLimit;
+}
+
+SkBitmap::Allocator* SkShardedResourceCache::allocator() const {
+    // Each shard's allocator is made once, by its constructor, so reading it needs no lock.
+    return fShards[kFirstShard].fCache->allocator();
+}
+
+SkCachedData* SkShardedResourceCache::newCachedData(size_t bytes) {
+    if (fDiscardableFactory) {
+        SkDiscardableMemory* dm = fDiscardableFactory(bytes);
+        return dm ? new SkCachedData(bytes, dm) : nullptr;
+    } else {
+        return new SkCachedData(sk_malloc_throw(bytes), bytes);
+    }
+}
+
+SkCachedData* SkShardedResourceCache::newCachedData(const SkResourceCache::Key& key,
+                                                    size_t bytes) {
+    return AutoShard(*this, shard_index(key))->newCachedData(bytes);
+}
+
+void SkShardedResourceCache::dump() {
+    for (int i = 0; i < kShardCount; i++) {
+        AutoShard(*this, i)->dump();
+    }
+}
+
+size_t SkShardedResourceCache::setSingleAllocationByteLimit(size_t size) {
+    size_t prevLimit = 0;
+    for (int i = 0; i < kShardCount; i++) {
+        prevLimit = AutoShard(*this, i)->setSingleAllocationByteLimit(size);
+    }
+    return prevLimit;
+}
+
+size_t SkShardedResourceCache::getSingleAllocationByteLimit() {
+    return AutoShard(*this, kFirstShard)->getSingleAllocationByteLimit();
+}
+
+size_t SkShardedResourceCache::getEffectiveSingleAllocationByteLimit() {
+    // Any one allocation has to fit in a single shard's budget, so use the smallest.
+    // (The last shard's share is never smaller than the others'.)
+    return AutoShard(*this, kFirstShard)->getEffectiveSingleAllocationByteLimit();
+}
+
+void SkShardedResourceCache::purgeAll() {
+    for (int i = 0; i < kShardCount; i++) {
+        AutoShard(*this, i)->purgeAll();
+    }
+}
+
+void SkShardedResourceCache::purgeToFraction(float keepFraction) {
+    for (int i = 0; i < kShardCount; i++) {
+        AutoShard shard(*this, i);
+        shard->purgeToBytes((size_t)(shard->getTotalBytesUsed() *
+                                     SkTPin(keepFraction, 0.0f, 1.0f)));
+    }
+}
+
+bool SkShardedResourceCache::find(const SkResourceCache::Key& key,
+                                  SkResourceCache::FindVisitor visitor, void* context) {
+    return AutoShard(*this, shard_index(key))->find(key, visitor, context);
+}
+
+void SkShardedResourceCache::add(SkResourceCache::Rec* rec) {
+    AutoShard(*this, shard_index(rec->getKey()))->add(rec);
+}
+
+void SkShardedResourceCache::visitAll(SkResourceCache::Visitor visitor, void* context) {
+    for (int i = 0; i < kShardCount; i++) {
+        AutoShard(*this, i)->visitAll(visitor, context);
+    }
+}
 
-/** Must hold gMutex when calling. */
-static SkResourceCache* get_cache() {
-    // gMutex is always held when this is called, so we don't need to be fancy in here.
-    gMutex.assertHeld();
-    if (nullptr == gResourceCache) {
+///////////////////////////////////////////////////////////////////////////////
+
+static SkShardedResourceCache* global_cache() {
+    static SkOnce once;
+    static SkShardedResourceCache* cache;
+    once([] {
 #ifdef SK_USE_DISCARDABLE_SCALEDIMAGECACHE
-        gResourceCache = new SkResourceCache(SkDiscardableMemory::Create);
+        cache = new SkShardedResourceCache(SkDiscardableMemory::Create,
+                                           SK_DISCARDABLEMEMORY_SCALEDIMAGECACHE_COUNT_LIMIT);
 #else
-        gResourceCache = new SkResourceCache(SK_DEFAULT_IMAGE_CACHE_LIMIT);
+        cache = new SkShardedResourceCache(SK_DEFAULT_IMAGE_CACHE_LIMIT);
 #endif
-    }
-    return gResourceCache;
+    });
+    return cache;
 }
 
 size_t SkResourceCache::GetTotalBytesUsed() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->getTotalBytesUsed();
+    return global_cache()->getTotalBytesUsed();
 }
 
 size_t SkResourceCache::GetTotalByteLimit() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->getTotalByteLimit();
+    return global_cache()->getTotalByteLimit();
 }
 
 size_t SkResourceCache::SetTotalByteLimit(size_t newLimit) {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->setTotalByteLimit(newLimit);
+    return global_cache()->setTotalByteLimit(newLimit);
 }
 
 SkResourceCache::DiscardableFactory SkResourceCache::GetDiscardableFactory() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->discardableFactory();
+    return global_cache()->discardableFactory();
 }
 
 SkBitmap::Allocator* SkResourceCache::GetAllocator() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->allocator();
+    return global_cache()->allocator();
 }
 
 SkCachedData* SkResourceCache::NewCachedData(size_t bytes) {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->newCachedData(bytes);
+    return global_cache()->newCachedData(bytes);
+}
+
+SkCachedData* SkResourceCache::NewCachedData(const Key& key, size_t bytes) {
+    return global_cache()->newCachedData(key, bytes);
 }
 
 void SkResourceCache::Dump() {
-    SkAutoMutexAcquire am(gMutex);
-    get_cache()->dump();
+    global_cache()->dump();
 }
 
 size_t SkResourceCache::SetSingleAllocationByteLimit(size_t size) {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->setSingleAllocationByteLimit(size);
+    return global_cache()->setSingleAllocationByteLimit(size);
 }
 
 size_t SkResourceCache::GetSingleAllocationByteLimit() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->getSingleAllocationByteLimit();
+    return global_cache()->getSingleAllocationByteLimit();
 }
 
 size_t SkResourceCache::GetEffectiveSingleAllocationByteLimit() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->getEffectiveSingleAllocationByteLimit();
+    return global_cache()->getEffectiveSingleAllocationByteLimit();
 }
 
 void SkResourceCache::PurgeAll() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->purgeAll();
+    global_cache()->purgeAll();
+}
+
+void SkResourceCache::PurgeToFraction(float keepFraction) {
+    global_cache()->purgeToFraction(keepFraction);
 }
 
 bool SkResourceCache::Find(const Key& key, FindVisitor visitor, void* context) {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->find(key, visitor, context);
+    return global_cache()->find(key, visitor, context);
 }
 
 void SkResourceCache::Add(Rec* rec) {
-    SkAutoMutexAcquire am(gMutex);
-    get_cache()->add(rec);
+    global_cache()->add(rec);
 }
 
 void SkResourceCache::VisitAll(Visitor visitor, void* context) {
-    SkAutoMutexAcquire am(gMutex);
-    get_cache()->visitAll(visitor, context);
+    global_cache()->visitAll(visitor, context);
 }
 
 void SkResourceCache::PostPurgeSharedID(uint64_t sharedID) {
@@ -692,8 +877,30 @@ static void sk_trace_dump_visitor(const SkResourceCache::Rec& rec, void* context
     }
 }
 
+void SkResourceCache::DumpShardStatistics(int shardIndex, const SkResourceCache& cache,
+                                          SkTraceMemoryDump* dump) {
+    // These don't use the "size" value name, so they don't double count the Recs' bytes.
+    SkString dumpName = SkStringPrintf("skia/sk_resource_cache/shard_%d", shardIndex);
+    dump->dumpNumericValue(dumpName.c_str(), "bytes_used", "bytes", cache.fTotalBytesUsed);
+    dump->dumpNumericValue(dumpName.c_str(), "byte_limit", "bytes", cache.fTotalByteLimit);
+    dump->dumpNumericValue(dumpName.c_str(), "count", "objects", cache.fCount);
+    dump->dumpNumericValue(dumpName.c_str(), "find_hits", "objects", cache.fFindHitCount);
+    dump->dumpNumericValue(dumpName.c_str(), "find_misses", "objects", cache.fFindMissCount);
+}
+
+void SkShardedResourceCache::dumpMemoryStatistics(SkTraceMemoryDump* dump) {
+    for (int i = 0; i < kShardCount; i++) {
+        AutoShard shard(*this, i);
+        SkResourceCache::DumpShardStatistics(i, *shard, dump);
+        // Since resource could be backed by malloc or discardable, the cache always dumps
+        // detailed stats to be accurate.
+        shard->visitAll(sk_trace_dump_visitor, dump);
+    }
+}
+
 void SkResourceCache::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
-    // Since resource could be backed by malloc or discardable, the cache always dumps detailed
-    // stats to be accurate.
-    VisitAll(sk_trace_dump_visitor, dump);
+    global_cache()->dumpMemoryStatistics(dump);
+    // The pool backs the cache's discardable Recs when the platform has no discardable memory of
+    // its own.
+    SkDumpGlobalDiscardableMemoryPoolStatistics(dump);
 }
@@ -25,6 +25,9 @@ class SkTraceMemoryDump;
  *
  *  As a convenience, a global instance is also defined, which can be safely
  *  access across threads via the static methods (e.g. FindAndLock, etc.).
+ *  The global instance is split by Key hash into SK_RESOURCE_CACHE_SHARD_COUNT
+ *  independent caches, each with its own lock, LRU list and share of the budget,
+ *  so lookups from different threads rarely contend.
  */
 class SkResourceCache {
 public:
@@ -154,6 +157,8 @@ public:
     static size_t GetEffectiveSingleAllocationByteLimit();
 
     static void PurgeAll();
+    /** Purges least recently used Recs until at most keepFraction of the bytes used remain. */
+    static void PurgeToFraction(float keepFraction);
 
     static void TestDumpMemoryStatistics();
 
@@ -174,6 +179,8 @@ public:
     static SkBitmap::Allocator* GetAllocator();
 
     static SkCachedData* NewCachedData(size_t bytes);
+    /** Allocates from the part of the global cache that will hold the Rec for key. */
+    static SkCachedData* NewCachedData(const Key& key, size_t bytes);
 
     static void PostPurgeSharedID(uint64_t sharedID);
 
@@ -236,12 +243,21 @@ public:
      */
     size_t setTotalByteLimit(size_t newLimit);
 
+    /**
+     *  Set the maximum number of Recs this cache holds when it allocates from a
+     *  DiscardableFactory (and so has no byte budget). Returns the previous value.
+     */
+    int setDiscardableCountLimit(int newLimit);
+
     void purgeSharedID(uint64_t sharedID);
 
     void purgeAll() {
         this->purgeAsNeeded(true);
     }
 
+    /** Purges least recently used Recs until no more than bytes are used. */
+    void purgeToBytes(size_t bytes);
+
     DiscardableFactory discardableFactory() const { return fDiscardableFactory; }
     SkBitmap::Allocator* allocator() const { return fAllocator; };
 
@@ -267,6 +283,11 @@ private:
     size_t  fTotalByteLimit;
     size_t  fSingleAllocationByteLimit;
     int     fCount;
+    int     fDiscardableCountLimit;  // only respected when we have a fDiscardableFactory
+
+    // for memory usage diagnostics
+    uint64_t fFindHitCount;
+    uint64_t fFindMissCount;
 
     SkMessageBus<PurgeSharedIDMessage>::Inbox fPurgeSharedIDInbox;
 
@@ -281,10 +302,62 @@ private:
 
     void init();    // called by constructors
 
+    static void DumpShardStatistics(int shardIndex, const SkResourceCache&, SkTraceMemoryDump*);
+    friend class SkShardedResourceCache;
+
 #ifdef SK_DEBUG
     void validate() const;
 #else
     void validate() const {}
 #endif
 };
+
+/**
+ *  A cache split into shards, each an SkResourceCache behind its own lock, so threads working with
+ *  different keys rarely wait on each other.  Each Rec lives in the shard its Key's hash picks.
+ *  The static SkResourceCache methods all work on a global one of these.
+ */
+class SkShardedResourceCache : SkNoncopyable {
+public:
+    /** Each shard allocates with malloc, and gets an even share of byteLimit. */
+    explicit SkShardedResourceCache(size_t byteLimit);
+
+    /** Each shard allocates from factory, and holds an even share of countLimit Recs. */
+    SkShardedResourceCache(SkResourceCache::DiscardableFactory factory, int countLimit);
+
+    ~SkShardedResourceCache();
+
+    bool find(const SkResourceCache::Key&, SkResourceCache::FindVisitor, void* context);
+    void add(SkResourceCache::Rec*);
+    void visitAll(SkResourceCache::Visitor, void* context);
+
+    size_t getTotalBytesUsed();
+    size_t getTotalByteLimit();
+    size_t setTotalByteLimit(size_t newLimit);
+
+    size_t setSingleAllocationByteLimit(size_t maximumAllocationSize);
+    size_t getSingleAllocationByteLimit();
+    size_t getEffectiveSingleAllocationByteLimit();
+
+    void purgeAll();
+    void purgeToFraction(float keepFraction);
+
+    // Every shard allocates the same way, so these don't need to lock one.
+    SkResourceCache::DiscardableFactory discardableFactory() const { return fDiscardableFactory; }
+    SkBitmap::Allocator* allocator() const;
+    SkCachedData* newCachedData(size_t bytes);
+
+    /** Allocates from the shard that will hold the Rec for key. */
+    SkCachedData* newCachedData(const SkResourceCache::Key& key, size_t bytes);
+
+    void dump();
+    void dumpMemoryStatistics(SkTraceMemoryDump*);
+
+private:
+    struct Shard;
+    class AutoShard;
+
+    SkResourceCache::DiscardableFactory fDiscardableFactory;
+    Shard*                              fShards;
+};
 #endif
@@ -28,7 +28,9 @@
 
 extern const float sk_linear_from_srgb[256];
 
-static inline Sk4f sk_linear_to_srgb(const Sk4f& x) {
+// sk_linear_to_srgb() for any float vector type F with SkNx's interface, e.g. Sk8f.
+template <typename F>
+static inline F sk_linear_to_srgb_any(const F& x) {
     // Approximation of the sRGB gamma curve (within 1 when scaled to 8-bit pixels).
     // For 0.00000f <= x <  0.00349f,    12.92 * x
     // For 0.00349f <= x <= 1.00000f,    0.679*(x.^0.5) + 0.423*x.^(0.25) - 0.101
@@ -47,4 +49,8 @@ static inline Sk4f sk_linear_to_srgb(const Sk4f& x) {
     return (x < 0.00349f).thenElse(lo, hi);
 }
 
+static inline Sk4f sk_linear_to_srgb(const Sk4f& x) {
+    return sk_linear_to_srgb_any(x);
+}
+
 #endif//SkSRGB_DEFINED
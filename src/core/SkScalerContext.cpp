@@ -22,6 +22,7 @@
 #include "SkRasterClip.h"
 #include "SkStroke.h"
 #include "SkStrokeRec.h"
+#include "SkTraceEvent.h"
 
 #define ComputeBWRowBytes(width)        (((unsigned)(width) + 7) >> 3)
 
@@ -447,6 +448,7 @@ static void extract_alpha(const SkMask& dst,
 }
 
 void SkScalerContext::getImage(const SkGlyph& origGlyph) {
+    TRACE_EVENT0("disabled-by-default-skia", "SkScalerContext::getImage()");
     const SkGlyph*  glyph = &origGlyph;
     SkGlyph         tmpGlyph;
 
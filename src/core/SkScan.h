@@ -10,18 +10,36 @@
 #define SkScan_DEFINED
 
 #include "SkFixed.h"
+#include "SkMatrix.h"
+#include "SkPath.h"
 #include "SkRect.h"
 
 class SkRasterClip;
 class SkRegion;
 class SkBlitter;
-class SkPath;
 
 /** Defines a fixed-point rectangle, identical to the integer SkIRect, but its
     coordinates are treated as SkFixed rather than int32_t.
 */
 typedef SkIRect SkXRect;
 
+// When true, SkScan::AntiFillPath() computes each pixel's coverage analytically in a single pass
+// per row, rather than supersampling 16 times per pixel.  Defaults to false.
+extern bool gSkUseAnalyticAA;
+
+/** Names a device-space path by the generation ID of the (non-volatile) path it was transformed
+    from, and the matrix it was transformed by.  SkScan uses this to cache the edges it builds for
+    that path from one draw to the next.  Copies of a path share its generation ID whatever their
+    fill types, so masks made from the path are keyed by its fill type too.  fPath, if set, is the
+    path itself, so a cache can hear when its generation ID changes and purge what it built.
+*/
+struct SkScanPathID {
+    uint32_t         fGenID;
+    SkMatrix         fMatrix;
+    SkPath::FillType fFillType;
+    const SkPath*    fPath;
+};
+
 class SkScan {
 public:
     /*
@@ -45,6 +63,7 @@ public:
     static void AntiFillXRect(const SkXRect&, const SkRasterClip&, SkBlitter*);
     static void FillPath(const SkPath&, const SkRasterClip&, SkBlitter*);
     static void AntiFillPath(const SkPath&, const SkRasterClip&, SkBlitter*);
+    static void AntiFillPath(const SkPath&, const SkRasterClip&, SkBlitter*, const SkScanPathID*);
     static void FrameRect(const SkRect&, const SkPoint& strokeSize,
                           const SkRasterClip&, SkBlitter*);
     static void AntiFrameRect(const SkRect&, const SkPoint& strokeSize,
@@ -72,7 +91,7 @@ private:
     static void AntiFillXRect(const SkXRect&, const SkRegion*, SkBlitter*);
     static void FillPath(const SkPath&, const SkRegion& clip, SkBlitter*);
     static void AntiFillPath(const SkPath&, const SkRegion& clip, SkBlitter*,
-                             bool forceRLE = false);
+                             bool forceRLE = false, const SkScanPathID* = nullptr);
     static void FillTriangle(const SkPoint pts[], const SkRegion*, SkBlitter*);
 
     static void AntiFrameRect(const SkRect&, const SkPoint& strokeSize,
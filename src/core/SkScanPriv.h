@@ -28,9 +28,15 @@ private:
 };
 
 // clipRect == null means path is entirely inside the clip
+// pathID, if not null, lets us reuse (and cache) the edges built for path, see SkEdgeCache.
 void sk_fill_path(const SkPath& path, const SkIRect* clipRect,
                   SkBlitter* blitter, int start_y, int stop_y, int shiftEdgesUp,
-                  const SkRegion& clipRgn);
+                  const SkRegion& clipRgn, const SkScanPathID* pathID = nullptr);
+
+// Anti-aliased fill of path, whose bounds round out to ir, by computing each pixel's coverage
+// analytically rather than by supersampling.  See gSkUseAnalyticAA.
+void sk_analytic_fill_path(const SkPath& path, const SkIRect& ir, const SkRegion& clip,
+                           SkBlitter* blitter);
 
 // blit the rects above and below avoid, clipped to clip
 void sk_blit_above(SkBlitter*, const SkIRect& avoid, const SkRegion& clip);
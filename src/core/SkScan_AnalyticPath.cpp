@@ -0,0 +1,482 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkScanPriv.h"
+#include "SkGeometry.h"
+#include "SkMask.h"
+#include "SkPath.h"
+#include "SkRegion.h"
+#include "SkTArray.h"
+#include "SkTemplates.h"
+
+bool gSkUseAnalyticAA = false;
+
+/*
+ *  Analytic coverage anti-aliasing.
+ *
+ *  Rather than supersampling, we compute how much of each pixel is covered by the path exactly,
+ *  one row at a time.  The path is flattened into lines.  Each line crossing a row adds the
+ *  signed area it sweeps out to the right of itself into an accumulation buffer: the area of
+ *  the trapezoid between the line and each pixel's right edge lands in that pixel, and whatever
+ *  height the line has left is carried on to every pixel further right.  A running sum across
+ *  the row then gives each pixel's coverage, weighted by winding, to which we apply the fill
+ *  type.  Each output row is computed in one pass, no matter how many samples we'd have taken.
+ *
+ *  This is the same accumulation scheme used by a number of font rasterizers.  It treats the
+ *  fill rule per pixel rather than per point, so where a path overlaps itself within a single
+ *  pixel coverage is approximate; everywhere else it is exact up to float precision and the
+ *  flattening tolerance.
+ */
+
+namespace {
+
+// Curves are flattened until no line is more than this far (in pixels) from the curve.
+static const SkScalar kFlattenTolerance = 1/32.0f;
+static const int      kMaxFlattenSteps  = 128;
+
+// Like MaskSuperBlitter, we draw small paths into a mask and blit that all at once.
+static const int kMaxMaskWidth   = 32,
+                 kMaxMaskStorage = 1024;
+
+class AnalyticRasterizer {
+public:
+    // We compute coverage for the pixels in bounds.  Lines outside bounds are clipped, keeping
+    // their effect on pixels inside.
+    explicit AnalyticRasterizer(const SkIRect& bounds) : fBounds(bounds) {}
+
+    void addPath(const SkPath&);
+
+    template <SkPath::FillType>
+    void blit(SkBlitter*);
+
+private:
+    // A line in bounds-relative coordinates, with fY0 < fY1.
+    struct Line {
+        SkScalar fX0, fY0, fX1, fY1;
+        SkScalar fDxDy;
+        SkScalar fDir;  // +1 if the line originally pointed down, -1 if up.
+    };
+
+    void addLine(SkPoint p0, SkPoint p1);
+    void addClippedLine(SkScalar x0, SkScalar y0, SkScalar x1, SkScalar y1, SkScalar dir);
+    void addQuad(const SkPoint pts[3]);
+    void addCubic(const SkPoint pts[4]);
+
+    // Add this line's contribution to row y into acc, widening [*minX, *maxX] to cover the
+    // entries we touch.
+    static void Accumulate(const Line&, int y, float acc[], int* minX, int* maxX);
+
+    const SkIRect               fBounds;
+    SkSTArray<64, Line, true>   fLines;
+};
+
+void AnalyticRasterizer::addPath(const SkPath& path) {
+    SkPath::Iter iter(path, true);
+    SkPoint pts[4];
+    SkPath::Verb verb;
+    while ((verb = iter.next(pts, false)) != SkPath::kDone_Verb) {
+        switch (verb) {
+            case SkPath::kLine_Verb:
+                this->addLine(pts[0], pts[1]);
+                break;
+            case SkPath::kQuad_Verb:
+                this->addQuad(pts);
+                break;
+            case SkPath::kConic_Verb: {
+                SkAutoConicToQuads quadder;
+                const SkPoint* quads = quadder.computeQuads(pts, iter.conicWeight(),
+                                                            kFlattenTolerance);
+                for (int i = 0; i < quadder.countQuads(); i++) {
+                    this->addQuad(quads + 2*i);
+                }
+            } break;
+            case SkPath::kCubic_Verb:
+                this->addCubic(pts);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+static int flatten_steps(SkScalar deviation) {
+    // Splitting a curve into n lines divides its deviation from a straight line by n^2.
+    SkScalar n = SkScalarCeilToScalar(SkScalarSqrt(deviation / kFlattenTolerance));
+    if (!(n > 1)) {  // Also catches NaN.
+        return 1;
+    }
+    return n < kMaxFlattenSteps ? (int)n : kMaxFlattenSteps;
+}
+
+void AnalyticRasterizer::addQuad(const SkPoint pts[3]) {
+    // A quad strays at most |p0 - 2p1 + p2| / 4 from its chord.
+    const SkVector dd = pts[0] - pts[1] - pts[1] + pts[2];
+    const int n = flatten_steps(dd.length() * 0.25f);
+
+    SkPoint prev = pts[0];
+    for (int i = 1; i < n; i++) {
+        SkScalar t = (SkScalar)i / n, s = 1 - t;
+        SkPoint next = { s*s*pts[0].fX + 2*s*t*pts[1].fX + t*t*pts[2].fX,
+                         s*s*pts[0].fY + 2*s*t*pts[1].fY + t*t*pts[2].fY };
+        this->addLine(prev, next);
+        prev = next;
+    }
+    this->addLine(prev, pts[2]);
+}
+
+void AnalyticRasterizer::addCubic(const SkPoint pts[4]) {
+    // A cubic strays at most 3/4 of its largest second difference from its chord.
+    const SkVector dd0 = pts[0] - pts[1] - pts[1] + pts[2],
+                   dd1 = pts[1] - pts[2] - pts[2] + pts[3];
+    const int n = flatten_steps(SkTMax(dd0.length(), dd1.length()) * 0.75f);
+
+    SkPoint prev = pts[0];
+    for (int i = 1; i < n; i++) {
+        SkScalar t = (SkScalar)i / n, s = 1 - t;
+        SkScalar a = s*s*s, b = 3*s*s*t, c = 3*s*t*t, d = t*t*t;
+        SkPoint next = { a*pts[0].fX + b*pts[1].fX + c*pts[2].fX + d*pts[3].fX,
+                         a*pts[0].fY + b*pts[1].fY + c*pts[2].fY + d*pts[3].fY };
+        this->addLine(prev, next);
+        prev = next;
+    }
+    this->addLine(prev, pts[3]);
+}
+
+void AnalyticRasterizer::addLine(SkPoint p0, SkPoint p1) {
+    SkScalar x0 = p0.fX - fBounds.fLeft, y0 = p0.fY - fBounds.fTop,
+             x1 = p1.fX - fBounds.fLeft, y1 = p1.fY - fBounds.fTop;
+    if (y0 == y1) {
+        return;  // Horizontal lines don't cover anything.
+    }
+    SkScalar dir = 1;
+    if (y0 > y1) {
+        SkTSwap(x0, x1);
+        SkTSwap(y0, y1);
+        dir = -1;
+    }
+    const SkScalar w = SkIntToScalar(fBounds.width()),
+                   h = SkIntToScalar(fBounds.height());
+    if (y1 <= 0 || y0 >= h) {
+        return;
+    }
+
+    // Clip to the top and bottom.  Nothing above or below the bounds matters.
+    const SkScalar dx = x1 - x0,
+                   dy = y1 - y0;
+    if (y0 < 0) {
+        x0 += dx * (-y0 / dy);
+        y0 = 0;
+    }
+    if (y1 > h) {
+        x1 -= dx * ((y1 - h) / dy);
+        y1 = h;
+    }
+
+    // Lines left of the bounds still cover every pixel to their right, exactly as if they ran
+    // along the left edge, and lines right of the bounds cover nothing we care about.  So we
+    // split the line where it crosses the left and right edges and pin the outside parts there.
+    SkPoint pts[4] = {{ x0, y0 }};
+    int count = 1;
+    for (SkScalar edge : { (SkScalar)0, w }) {
+        if ((x0 < edge) != (x1 < edge)) {
+            pts[count++] = { edge, SkTPin(y0 + (y1 - y0) * ((edge - x0) / (x1 - x0)), y0, y1) };
+        }
+    }
+    pts[count++] = { x1, y1 };
+    if (count == 4 && pts[1].fY > pts[2].fY) {
+        SkTSwap(pts[1], pts[2]);
+    }
+
+    for (int i = 1; i < count; i++) {
+        this->addClippedLine(SkTPin(pts[i-1].fX, 0.0f, w), pts[i-1].fY,
+                             SkTPin(pts[i  ].fX, 0.0f, w), pts[i  ].fY, dir);
+    }
+}
+
+void AnalyticRasterizer::addClippedLine(SkScalar x0, SkScalar y0, SkScalar x1, SkScalar y1,
+                                        SkScalar dir) {
+    if (y0 < y1) {
+        fLines.push_back({ x0, y0, x1, y1, (x1 - x0) / (y1 - y0), dir });
+    }
+}
+
+void AnalyticRasterizer::Accumulate(const Line& line, int y, float acc[], int* minX, int* maxX) {
+    const SkScalar top    = SkTMax(line.fY0, SkIntToScalar(y)),
+                   bottom = SkTMin(line.fY1, SkIntToScalar(y + 1));
+    if (top >= bottom) {
+        return;
+    }
+    // Pinning to the line's own x range keeps rounding (and huge slopes) from taking us
+    // outside the bounds.
+    const SkScalar lo = SkTMin(line.fX0, line.fX1),
+                   hi = SkTMax(line.fX0, line.fX1);
+    SkScalar xa = SkTPin(line.fX0 + (top    - line.fY0) * line.fDxDy, lo, hi),
+             xb = SkTPin(line.fX0 + (bottom - line.fY0) * line.fDxDy, lo, hi);
+
+    // d is the signed height of this row the line spans.  It's split between the pixel(s) the
+    // line passes through and the pixels to the right of them, by how far right of the line
+    // each pixel lies.
+    const SkScalar d = (bottom - top) * line.fDir;
+
+    if (xa > xb) {
+        SkTSwap(xa, xb);
+    }
+    const int ia = (int)xa,                  // xa and xb are >= 0, so this is floor().
+              ib = (int)SkScalarCeilToScalar(xb);
+    *minX = SkTMin(*minX, ia);
+    *maxX = SkTMax(*maxX, SkTMax(ia + 1, ib));
+
+    if (ib <= ia + 1) {
+        // The line stays within one pixel.  Its area right of the line is a trapezoid.
+        SkScalar mid = 0.5f*(xa + xb) - ia;
+        acc[ia    ] += d * (1 - mid);
+        acc[ia + 1] += d * mid;
+        return;
+    }
+
+    // The line crosses several pixels.  Coverage right of the line grows linearly in x from
+    // xa to xb, so each pixel takes the area of that ramp within it: a triangle in the first
+    // pixel, strips in between, and whatever is left in the last.
+    const SkScalar s  = 1 / (xb - xa),         // How much height we span per pixel.
+                   fa = xa - ia,
+                   fb = xb - (ib - 1),
+                   a0 = 0.5f * s * (1 - fa) * (1 - fa),   // First pixel's area.
+                   am = 0.5f * s * fb * fb;               // Area past the last pixel's edge.
+    acc[ia] += d * a0;
+    if (ib == ia + 2) {
+        acc[ia + 1] += d * (1 - a0 - am);
+    } else {
+        const SkScalar a1 = s * (1.5f - fa);              // Area up to the second pixel's edge.
+        acc[ia + 1] += d * (a1 - a0);
+        for (int i = ia + 2; i < ib - 1; i++) {
+            acc[i] += d * s;
+        }
+        const SkScalar a2 = a1 + (ib - ia - 3) * s;       // Area up to the last pixel.
+        acc[ib - 1] += d * (1 - a2 - am);
+    }
+    acc[ib] += d * am;
+}
+
+template <SkPath::FillType kFillType>
+static SkAlpha coverage_to_alpha(float winding) {
+    float coverage = SkScalarAbs(winding);
+    switch (kFillType) {
+        case SkPath::kWinding_FillType:
+        case SkPath::kInverseWinding_FillType:
+            coverage = SkTMin(coverage, 1.0f);
+            break;
+        case SkPath::kEvenOdd_FillType:
+        case SkPath::kInverseEvenOdd_FillType:
+            // Coverage 1 means inside, 2 means back outside, 3 inside again...
+            coverage -= 2 * SkScalarFloorToScalar(coverage * 0.5f);
+            if (coverage > 1) {
+                coverage = 2 - coverage;
+            }
+            break;
+    }
+    if (SkPath::IsInverseFillType(kFillType)) {
+        coverage = 1 - coverage;
+    }
+    return (SkAlpha)(coverage * 255 + 0.5f);
+}
+
+template <SkPath::FillType kFillType>
+void AnalyticRasterizer::blit(SkBlitter* blitter) {
+    const int width  = fBounds.width(),
+              height = fBounds.height();
+    const bool inverse = SkPath::IsInverseFillType(kFillType);
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+
+    // Sort the lines by the row they start in.
+    SkAutoSTMalloc<64, int> rowStart(height + 1);
+    sk_bzero(rowStart.get(), (height + 1) * sizeof(int));
+    for (const Line& line : fLines) {
+        rowStart[(int)line.fY0 + 1]++;
+    }
+    for (int y = 1; y <= height; y++) {
+        rowStart[y] += rowStart[y - 1];
+    }
+    SkAutoSTMalloc<64, const Line*> sorted(fLines.count());
+    for (const Line& line : fLines) {
+        sorted[rowStart[(int)line.fY0]++] = &line;
+    }
+
+    // Lines along the right edge touch acc[width] and acc[width+1], just past the pixels we blit.
+    SkAutoSTMalloc<kMaxMaskWidth + 2, float>   acc(width + 2);
+    SkAutoSTMalloc<kMaxMaskWidth + 1, SkAlpha> alpha(width + 1);
+    SkAutoSTMalloc<kMaxMaskWidth + 1, int16_t> runs(width + 1);
+    sk_bzero(acc.get(), (width + 2) * sizeof(float));
+
+    uint8_t maskStorage[kMaxMaskStorage];
+    SkMask mask;
+    mask.fImage = nullptr;
+    if (!inverse && width <= kMaxMaskWidth && width * height <= kMaxMaskStorage) {
+        mask.fImage    = maskStorage;
+        mask.fBounds   = fBounds;
+        mask.fRowBytes = width;
+        mask.fFormat   = SkMask::kA8_Format;
+        sk_bzero(maskStorage, width * height);
+    }
+
+    // Coverage outside the path, i.e. where winding is 0.
+    const SkAlpha outside = coverage_to_alpha<kFillType>(0);
+
+    SkSTArray<32, const Line*, true> active;
+    const Line* const* next = sorted.get();
+    const Line* const* end  = sorted.get() + fLines.count();
+    for (int y = 0; y < height; y++) {
+        if (active.empty() && !inverse) {
+            // Nothing to draw until the next line starts.
+            if (next == end) {
+                break;
+            }
+            y = SkTMax(y, (int)(*next)->fY0);
+        }
+        while (next != end && (*next)->fY0 < y + 1) {
+            active.push_back(*next++);
+        }
+
+        int minX = width, maxX = -1;
+        for (int i = 0; i < active.count(); ) {
+            Accumulate(*active[i], y, acc.get(), &minX, &maxX);
+            if (active[i]->fY1 <= y + 1) {
+                active.removeShuffle(i);
+            } else {
+                i++;
+            }
+        }
+        maxX = SkTMin(maxX, width - 1);
+
+        if (mask.fImage) {
+            // Small enough to just sum up every pixel.
+            uint8_t* row = maskStorage + y * width;
+            float winding = 0;
+            for (int x = minX; x < width; x++) {
+                winding += acc[x];
+                acc[x] = 0;
+                row[x] = coverage_to_alpha<kFillType>(winding);
+            }
+            acc[width] = acc[width + 1] = 0;
+            continue;
+        }
+
+        // Sum across the row to get each pixel's coverage, clearing acc as we go.  Coverage only
+        // changes where a line touched acc, so between those we can extend the current run.
+        // Left of minX winding is 0.  Right of maxX it's whatever we've summed up by then, which
+        // is 0 too unless part of the path lies right of the bounds.
+        int count = 0;  // Runs start at 0,  runs[0], runs[0] + runs[runs[0]], ...
+        int prev  = -1; // Start of the last run, or -1.
+        auto addRun = [&](int x, int n, SkAlpha a) {
+            if (prev >= 0 && alpha[prev] == a) {
+                runs[prev] += n;
+            } else {
+                alpha[x] = a;
+                runs[x]  = n;
+                prev     = x;
+            }
+            count = x + n;
+        };
+        if (minX > 0) {
+            addRun(0, SkTMin(minX, width), outside);
+        }
+        float winding = 0;
+        for (int x = minX; x <= maxX; ) {
+            winding += acc[x];
+            acc[x] = 0;
+            int end = x + 1;
+            while (end <= maxX && acc[end] == 0) {
+                end++;
+            }
+            addRun(x, end - x, coverage_to_alpha<kFillType>(winding));
+            x = end;
+        }
+        if (count < width) {
+            addRun(count, width - count, coverage_to_alpha<kFillType>(winding));
+        }
+        acc[width] = acc[width + 1] = 0;
+
+        // Trim transparent runs from either end.
+        int first = 0;
+        while (first < width && alpha[first] == 0) {
+            first += runs[first];
+        }
+        if (first >= width) {
+            continue;
+        }
+        int last = prev;
+        if (alpha[last] == 0) {
+            // The last run is transparent; find the one before it.
+            int x = first;
+            while (x + runs[x] < last) {
+                x += runs[x];
+            }
+            last = x;
+        }
+        runs[last + runs[last]] = 0;
+        blitter->blitAntiH(fBounds.fLeft + first, fBounds.fTop + y,
+                           alpha.get() + first, runs.get() + first);
+    }
+
+    if (mask.fImage) {
+        blitter->blitMask(mask, fBounds);
+    }
+}
+
+
+}  // namespace
+
+void sk_analytic_fill_path(const SkPath& path, const SkIRect& ir, const SkRegion& clip,
+                           SkBlitter* blitter) {
+    const bool isInverse = path.isInverseFillType();
+
+    SkScanClipper clipper(blitter, &clip, ir);
+    if (clipper.getBlitter() == nullptr) { // clipped out
+        if (isInverse) {
+            blitter->blitRegion(clip);
+        }
+        return;
+    }
+    blitter = clipper.getBlitter();
+
+    // Like the supersampler, we only draw the rows of ir, leaving the rest of an inverse fill
+    // to sk_blit_above() and sk_blit_below().  Inverse fills may cover the whole clip width.
+    SkIRect bounds = ir;
+    if (isInverse) {
+        bounds.fLeft  = clip.getBounds().fLeft;
+        bounds.fRight = clip.getBounds().fRight;
+    }
+    if (!bounds.intersect(clip.getBounds())) {
+        bounds.setEmpty();
+    }
+
+    if (isInverse) {
+        sk_blit_above(blitter, ir, clip);
+    }
+
+    AnalyticRasterizer rasterizer(bounds);
+    rasterizer.addPath(path);
+    switch (path.getFillType()) {
+        case SkPath::kWinding_FillType:
+            rasterizer.blit<SkPath::kWinding_FillType>(blitter);
+            break;
+        case SkPath::kEvenOdd_FillType:
+            rasterizer.blit<SkPath::kEvenOdd_FillType>(blitter);
+            break;
+        case SkPath::kInverseWinding_FillType:
+            rasterizer.blit<SkPath::kInverseWinding_FillType>(blitter);
+            break;
+        case SkPath::kInverseEvenOdd_FillType:
+            rasterizer.blit<SkPath::kInverseEvenOdd_FillType>(blitter);
+            break;
+    }
+
+    if (isInverse) {
+        sk_blit_below(blitter, ir, clip);
+    }
+}
@@ -301,8 +301,19 @@ static int contribution_64(SkFDot6 ordinate) {
     return result;
 }
 
+// One of each kind of SkAntiHairBlitter, and a clipper, made once and shared by every segment
+// of a polyline.
+struct AntiHairBlitters {
+    HLine_SkAntiHairBlitter     hline;
+    Horish_SkAntiHairBlitter    horish;
+    VLine_SkAntiHairBlitter     vline;
+    Vertish_SkAntiHairBlitter   vertish;
+    SkRectClipBlitter           rectClipper;
+};
+
 static void do_anti_hairline(SkFDot6 x0, SkFDot6 y0, SkFDot6 x1, SkFDot6 y1,
-                             const SkIRect* clip, SkBlitter* blitter) {
+                             const SkIRect* clip, SkBlitter* blitter,
+                             AntiHairBlitters* hairBlitters) {
     // check for integer NaN (0x80000000) which we can't handle (can't negate it)
     // It appears typically from a huge float (inf or nan) being converted to int.
     // If we see it, just don't draw.
@@ -326,8 +337,8 @@ static void do_anti_hairline(SkFDot6 x0, SkFDot6 y0, SkFDot6 x1, SkFDot6 y1,
          */
         int hx = (x0 >> 1) + (x1 >> 1);
         int hy = (y0 >> 1) + (y1 >> 1);
-        do_anti_hairline(x0, y0, hx, hy, clip, blitter);
-        do_anti_hairline(hx, hy, x1, y1, clip, blitter);
+        do_anti_hairline(x0, y0, hx, hy, clip, blitter, hairBlitters);
+        do_anti_hairline(hx, hy, x1, y1, clip, blitter, hairBlitters);
         return;
     }
 
@@ -335,10 +346,6 @@ static void do_anti_hairline(SkFDot6 x0, SkFDot6 y0, SkFDot6 x1, SkFDot6 y1,
     int         istart, istop;
     SkFixed     fstart, slope;
 
-    HLine_SkAntiHairBlitter     hline_blitter;
-    Horish_SkAntiHairBlitter    horish_blitter;
-    VLine_SkAntiHairBlitter     vline_blitter;
-    Vertish_SkAntiHairBlitter   vertish_blitter;
     SkAntiHairBlitter*          hairBlitter = nullptr;
 
     if (SkAbs32(x1 - x0) > SkAbs32(y1 - y0)) {   // mostly horizontal
@@ -352,12 +359,12 @@ static void do_anti_hairline(SkFDot6 x0, SkFDot6 y0, SkFDot6 x1, SkFDot6 y1,
         fstart = SkFDot6ToFixed(y0);
         if (y0 == y1) {   // completely horizontal, take fast case
             slope = 0;
-            hairBlitter = &hline_blitter;
+            hairBlitter = &hairBlitters->hline;
         } else {
             slope = fastfixdiv(y1 - y0, x1 - x0);
             SkASSERT(slope >= -SK_Fixed1 && slope <= SK_Fixed1);
             fstart += (slope * (32 - (x0 & 63)) + 32) >> 6;
-            hairBlitter = &horish_blitter;
+            hairBlitter = &hairBlitters->horish;
         }
 
         SkASSERT(istop > istart);
@@ -428,12 +435,12 @@ static void do_anti_hairline(SkFDot6 x0, SkFDot6 y0, SkFDot6 x1, SkFDot6 y1,
                 return;     // nothing to do
             }
             slope = 0;
-            hairBlitter = &vline_blitter;
+            hairBlitter = &hairBlitters->vline;
         } else {
             slope = fastfixdiv(x1 - x0, y1 - y0);
             SkASSERT(slope <= SK_Fixed1 && slope >= -SK_Fixed1);
             fstart += (slope * (32 - (y0 & 63)) + 32) >> 6;
-            hairBlitter = &vertish_blitter;
+            hairBlitter = &hairBlitters->vertish;
         }
 
         SkASSERT(istop > istart);
@@ -492,10 +499,9 @@ static void do_anti_hairline(SkFDot6 x0, SkFDot6 y0, SkFDot6 x1, SkFDot6 y1,
         }
     }
 
-    SkRectClipBlitter   rectClipper;
     if (clip) {
-        rectClipper.init(blitter, *clip);
-        blitter = &rectClipper;
+        hairBlitters->rectClipper.init(blitter, *clip);
+        blitter = &hairBlitters->rectClipper;
     }
 
     SkASSERT(hairBlitter);
@@ -549,12 +555,28 @@ void SkScan::AntiHairLineRgn(const SkPoint array[], int arrayCount, const SkRegi
         clipBounds.outset(SK_Scalar1, SK_Scalar1);
     }
 
+    // Long polylines are mostly many short segments, so decide once for all of them whether
+    // they need to be chopped to fit in SkFixed, or clipped at all.
+    bool needFixedClip = true;
+    SkRect bounds;
+    if (arrayCount > 2 && bounds.setBoundsCheck(array, arrayCount)) {
+        needFixedClip = !fixedBounds.contains(bounds);
+        // Each segment tests its FDot6 bounds outset by a pixel; outset by 2 to cover rounding.
+        if (clip && !needFixedClip && clip->quickContains(bounds.roundOut().makeOutset(2, 2))) {
+            clip = nullptr;
+        }
+    }
+
+    AntiHairBlitters hairBlitters;
     for (int i = 0; i < arrayCount - 1; ++i) {
         SkPoint pts[2];
 
         // We have to pre-clip the line to fit in a SkFixed, so we just chop
         // the line. TODO find a way to actually draw beyond that range.
-        if (!SkLineClipper::IntersectLine(&array[i], fixedBounds, pts)) {
+        if (!needFixedClip) {
+            pts[0] = array[i];
+            pts[1] = array[i + 1];
+        } else if (!SkLineClipper::IntersectLine(&array[i], fixedBounds, pts)) {
             continue;
         }
 
@@ -587,14 +609,14 @@ void SkScan::AntiHairLineRgn(const SkPoint array[], int arrayCount, const SkRegi
                 const SkIRect*       r = &iter.rect();
 
                 while (!iter.done()) {
-                    do_anti_hairline(x0, y0, x1, y1, r, blitter);
+                    do_anti_hairline(x0, y0, x1, y1, r, blitter, &hairBlitters);
                     iter.next();
                 }
                 continue;
             }
             // fall through to no-clip case
         }
-        do_anti_hairline(x0, y0, x1, y1, nullptr, blitter);
+        do_anti_hairline(x0, y0, x1, y1, nullptr, blitter, &hairBlitters);
     }
 }
 
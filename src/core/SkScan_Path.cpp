@@ -9,6 +9,7 @@
 #include "SkBlitter.h"
 #include "SkEdge.h"
 #include "SkEdgeBuilder.h"
+#include "SkEdgeCache.h"
 #include "SkGeometry.h"
 #include "SkPath.h"
 #include "SkQuadClipper.h"
@@ -408,8 +409,57 @@ static bool operator<(const SkEdge& a, const SkEdge& b) {
     return valuea < valueb;
 }
 
+static bool x_less(const SkEdge* a, const SkEdge* b) { return a->fX < b->fX; }
+
+// Sorts by fFirstY with a counting sort, then by fX within each row, which beats SkTQSort for
+// paths with many edges spread over not too many rows.
+static void bucket_sort_edges(SkEdge* list[], int count) {
+    int minY = list[0]->fFirstY,
+        maxY = list[0]->fFirstY;
+    for (int i = 1; i < count; i++) {
+        minY = SkTMin(minY, list[i]->fFirstY);
+        maxY = SkTMax(maxY, list[i]->fFirstY);
+    }
+    // Each row costs as much to sort as an edge, so only bucket when the rows are few enough.
+    const int64_t rows = (int64_t)maxY - minY + 1;
+    if (rows > 4 * (int64_t)count) {
+        SkTQSort(list, list + count - 1);
+        return;
+    }
+
+    SkAutoSTMalloc<256, int> rowStart((int)rows + 1);
+    sk_bzero(rowStart.get(), ((int)rows + 1) * sizeof(int));
+    for (int i = 0; i < count; i++) {
+        rowStart[list[i]->fFirstY - minY + 1]++;
+    }
+    for (int y = 1; y <= rows; y++) {
+        rowStart[y] += rowStart[y - 1];
+    }
+    SkAutoSTMalloc<256, SkEdge*> sorted(count);
+    for (int i = 0; i < count; i++) {
+        sorted[rowStart[list[i]->fFirstY - minY]++] = list[i];
+    }
+    memcpy(list, sorted.get(), count * sizeof(SkEdge*));
+
+    // rowStart[y] is now where row y ends.
+    int start = 0;
+    for (int y = 0; y < rows; y++) {
+        int end = rowStart[y];
+        if (end - start > 1) {
+            SkTQSort(list + start, list + end - 1, x_less);
+        }
+        start = end;
+    }
+}
+
 static SkEdge* sort_edges(SkEdge* list[], int count, SkEdge** last) {
-    SkTQSort(list, list + count - 1);
+    // Below this, SkTQSort's insertion sort is as fast as anything.
+    static const int kMinBucketSortCount = 64;
+    if (count < kMinBucketSortCount) {
+        SkTQSort(list, list + count - 1);
+    } else {
+        bucket_sort_edges(list, count);
+    }
 
     // now make the edges linked in sorted order
     for (int i = 1; i < count; i++) {
@@ -427,18 +477,39 @@ static SkEdge* sort_edges(SkEdge* list[], int count, SkEdge** last) {
 // clipRect (if no null) has already been shifted up
 //
 void sk_fill_path(const SkPath& path, const SkIRect* clipRect, SkBlitter* blitter,
-                  int start_y, int stop_y, int shiftEdgesUp, const SkRegion& clipRgn) {
+                  int start_y, int stop_y, int shiftEdgesUp, const SkRegion& clipRgn,
+                  const SkScanPathID* pathID) {
     SkASSERT(blitter);
 
-    SkEdgeBuilder   builder;
+    SkEdgeBuilder       builder;
+    SkEdgeCache::Edges  cached;
 
     // If we're convex, then we need both edges, even the right edge is past the clip
     const bool canCullToTheRight = !path.isConvex();
 
-    int count = builder.build(path, clipRect, shiftEdgesUp, canCullToTheRight);
-    SkASSERT(count >= 0);
-
-    SkEdge**    list = builder.edgeList();
+    int count;
+    SkEdge* edge = nullptr;
+    SkEdge* last = nullptr;
+    // Simple paths build their edges about as fast as we could find them.
+    if (pathID && !SkEdgeCache::ShouldCache(path)) {
+        pathID = nullptr;
+    }
+    if (pathID && SkEdgeCache::Find(*pathID, clipRect, shiftEdgesUp, canCullToTheRight, &cached)) {
+        count = cached.count();
+        edge  = cached.first();
+        last  = cached.last();
+    } else {
+        count = builder.build(path, clipRect, shiftEdgesUp, canCullToTheRight);
+        SkASSERT(count >= 0);
+        if (count > 0) {
+            SkEdge** list = builder.edgeList();
+            // this returns the first and last edge after they're sorted into a dlink list
+            edge = sort_edges(list, count, &last);
+            if (pathID) {
+                SkEdgeCache::Add(*pathID, clipRect, shiftEdgesUp, canCullToTheRight, list, count);
+            }
+        }
+    }
 
     if (0 == count) {
         if (path.isInverseFillType()) {
@@ -465,9 +536,7 @@ void sk_fill_path(const SkPath& path, const SkIRect* clipRect, SkBlitter* blitte
         return;
     }
 
-    SkEdge headEdge, tailEdge, *last;
-    // this returns the first and last edge after they're sorted into a dlink list
-    SkEdge* edge = sort_edges(list, count, &last);
+    SkEdge headEdge, tailEdge;
 
     headEdge.fPrev = nullptr;
     headEdge.fNext = edge;
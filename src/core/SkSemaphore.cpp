@@ -7,6 +7,11 @@
 
 #include "../private/SkLeanWindows.h"
 #include "../private/SkSemaphore.h"
+#include <thread>
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    #include <emmintrin.h>
+#endif
 
 #if defined(SK_BUILD_FOR_MAC) || defined(SK_BUILD_FOR_IOS)
     #include <mach/mach.h>
@@ -38,6 +43,43 @@
         }
         void wait() { WaitForSingleObject(fSemaphore, INFINITE/*timeout in ms*/); }
     };
+#elif defined(__linux__)
+    // Futexes let us sleep on and wake from a plain int with no kernel object to create,
+    // and wake all n threads with one syscall.
+    #include <linux/futex.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+    struct SkBaseSemaphore::OSSemaphore {
+        std::atomic<int> fWakeups{0};
+        std::atomic<int> fSleepers{0};
+
+        int* futex() { return reinterpret_cast<int*>(&fWakeups); }
+
+        void signal(int n) {
+            fWakeups.fetch_add(n);
+            // Either we see the sleeper here, or its FUTEX_WAIT sees our wakeups and won't sleep.
+            if (fSleepers.load() > 0) {
+                syscall(SYS_futex, this->futex(), FUTEX_WAKE_PRIVATE, n, nullptr, nullptr, 0);
+            }
+        }
+        void wait() {
+            for (;;) {
+                int wakeups = fWakeups.load(std::memory_order_relaxed);
+                if (wakeups > 0) {
+                    if (fWakeups.compare_exchange_weak(wakeups, wakeups-1,
+                                                       std::memory_order_acquire)) {
+                        return;
+                    }
+                    continue;
+                }
+                // Sleeps only if there are still no wakeups.  Interruptions, spurious wakes,
+                // and a signal() sneaking in first all just send us back around the loop.
+                fSleepers.fetch_add(1);
+                syscall(SYS_futex, this->futex(), FUTEX_WAIT_PRIVATE, 0, nullptr, nullptr, 0);
+                fSleepers.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+    };
 #else
     // It's important we test for Mach before this.  This code will compile but not work there.
     #include <errno.h>
@@ -58,6 +100,41 @@
 
 ///////////////////////////////////////////////////////////////////////////////
 
+static inline void spin_pause() {
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    _mm_pause();
+#endif
+}
+
+void SkBaseSemaphore::waitSlow() {
+    // Spinning can't help when there's no other core to run the thread we're waiting on.
+    static const bool gCanSpin = std::thread::hardware_concurrency() > 1;
+
+    if (gCanSpin) {
+        // Spin up to about twice as long as spinning has recently needed to succeed.
+        // Failures halve the estimate, so semaphores held for a long time stop spinning.
+        // fSpinEstimate is only a hint; racing updates to it are harmless.
+        const int kMinSpins = 10,
+                  kMaxSpins = 500;
+        int estimate = fSpinEstimate.load(std::memory_order_relaxed);
+        int maxSpins = SkTMin(kMaxSpins, 2*estimate + kMinSpins);
+        for (int spins = 0; spins < maxSpins; spins++) {
+            if (this->try_wait()) {
+                fSpinEstimate.store(estimate + (spins - estimate) / 8, std::memory_order_relaxed);
+                return;
+            }
+            spin_pause();
+        }
+        fSpinEstimate.store(estimate / 2, std::memory_order_relaxed);
+    }
+
+    // Since this fetches the value before the subtract, zero and below means that there are no
+    // resources left, so the thread needs to sleep.
+    if (fCount.fetch_sub(1, std::memory_order_acquire) <= 0) {
+        this->osWait();
+    }
+}
+
 void SkBaseSemaphore::osSignal(int n) {
     fOSSemaphoreOnce([this] { fOSSemaphore = new OSSemaphore; });
     fOSSemaphore->signal(n);
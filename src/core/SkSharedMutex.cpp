@@ -348,3 +348,76 @@ void AnnotateRWLockReleased(
     }
 
 #endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SkChecksum.h"
+#include "SkThreadID.h"
+
+#include <thread>
+
+SkStripedSharedMutex::SkStripedSharedMutex() : fWriting(false) {
+    for (Stripe& stripe : fStripes) {
+        stripe.fReaders.store(0, sk_memory_order_relaxed);
+    }
+    ANNOTATE_RWLOCK_CREATE(this);
+}
+
+SkStripedSharedMutex::~SkStripedSharedMutex() { ANNOTATE_RWLOCK_DESTROY(this); }
+
+SkStripedSharedMutex::Stripe& SkStripedSharedMutex::stripe() const {
+    uint64_t id = SkGetThreadID();
+    return fStripes[SkChecksum::Mix((uint32_t)(id ^ (id >> 32))) & (kStripes - 1)];
+}
+
+void SkStripedSharedMutex::acquire() {
+    // Writers take turns.
+    fWriterMutex.acquire();
+
+    // This store and the readers' increments are sequentially consistent, so either we see a
+    // reader's count below, or that reader sees fWriting and backs out.
+    fWriting.store(true);
+    for (Stripe& stripe : fStripes) {
+        while (stripe.fReaders.load(sk_memory_order_acquire) > 0) {
+            std::this_thread::yield();
+        }
+    }
+    ANNOTATE_RWLOCK_ACQUIRED(this, 1);
+}
+
+void SkStripedSharedMutex::release() {
+    ANNOTATE_RWLOCK_RELEASED(this, 1);
+    fWriting.store(false, sk_memory_order_release);
+    fWriterMutex.release();
+}
+
+void SkStripedSharedMutex::acquireShared() {
+    SkAtomic<int32_t>& readers = this->stripe().fReaders;
+    for (;;) {
+        readers.fetch_add(1);
+        if (!fWriting.load()) {
+            break;
+        }
+        // There's a writer running or waiting for us to drain.  Get out of its way, then wait
+        // for it to finish by queuing up behind it on its mutex.
+        readers.fetch_sub(1, sk_memory_order_release);
+        fWriterMutex.acquire();
+        fWriterMutex.release();
+    }
+    ANNOTATE_RWLOCK_ACQUIRED(this, 0);
+}
+
+void SkStripedSharedMutex::releaseShared() {
+    ANNOTATE_RWLOCK_RELEASED(this, 0);
+    this->stripe().fReaders.fetch_sub(1, sk_memory_order_release);
+}
+
+#ifdef SK_DEBUG
+void SkStripedSharedMutex::assertHeld() const {
+    SkASSERT(fWriting.load(sk_memory_order_relaxed));
+}
+
+void SkStripedSharedMutex::assertHeldShared() const {
+    SkASSERT(this->stripe().fReaders.load(sk_memory_order_relaxed) > 0);
+}
+#endif  // SK_DEBUG
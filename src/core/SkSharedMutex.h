@@ -12,8 +12,9 @@
 #include "SkSemaphore.h"
 #include "SkTypes.h"
 
+#include "SkMutex.h"
+
 #ifdef SK_DEBUG
-    #include "SkMutex.h"
     #include <memory>
 #endif  // SK_DEBUG
 
@@ -69,6 +70,60 @@ inline void SkSharedMutex::assertHeld() const {};
 inline void SkSharedMutex::assertHeldShared() const {};
 #endif  // SK_DEBUG
 
+// A shared lock for read-mostly data, with the same interface as SkSharedMutex.
+//
+// SkSharedMutex keeps every count in one atomic word, so even readers that never contend with a
+// writer bounce that word's cache line between cores.  Here readers instead count themselves in
+// one of kStripes counters, each on its own cache line, picked by hashing the thread's ID.  A
+// reader that finds no writer touches nothing else.  In return writers are slow: a writer takes
+// an ordinary mutex, announces itself, and waits for every stripe to drain.  Readers that arrive
+// while a writer is announced back out and wait on the writer's mutex.
+//
+// Writers are favored over arriving readers, so a steady stream of writers can starve readers.
+class SkStripedSharedMutex {
+public:
+    SkStripedSharedMutex();
+    ~SkStripedSharedMutex();
+
+    // Acquire lock for exclusive use.
+    void acquire();
+
+    // Release lock for exclusive use.
+    void release();
+
+    // Fail if exclusive is not held.
+    void assertHeld() const;
+
+    // Acquire lock for shared use.  Must be released by the same thread.
+    void acquireShared();
+
+    // Release lock for shared use.
+    void releaseShared();
+
+    // Fail if shared lock not held (by any thread using the same stripe as this one).
+    void assertHeldShared() const;
+
+private:
+    static const int kStripes       = 16;
+    static const int kCacheLineSize = 64;
+
+    struct Stripe {
+        SkAtomic<int32_t> fReaders;
+        char              fPad[kCacheLineSize - sizeof(SkAtomic<int32_t>)];
+    };
+
+    Stripe& stripe() const;
+
+    mutable Stripe    fStripes[kStripes];
+    SkAtomic<bool>    fWriting;
+    SkMutex           fWriterMutex;
+};
+
+#ifndef SK_DEBUG
+inline void SkStripedSharedMutex::assertHeld() const {};
+inline void SkStripedSharedMutex::assertHeldShared() const {};
+#endif  // SK_DEBUG
+
 class SkAutoSharedMutexShared {
 public:
     SkAutoSharedMutexShared(SkSharedMutex& lock) : fLock(lock) { lock.acquireShared(); }
@@ -79,4 +134,16 @@ private:
 
 #define SkAutoSharedMutexShared(...) SK_REQUIRE_LOCAL_VAR(SkAutoSharedMutexShared)
 
+class SkAutoStripedSharedMutexShared {
+public:
+    SkAutoStripedSharedMutexShared(SkStripedSharedMutex& lock) : fLock(lock) {
+        lock.acquireShared();
+    }
+    ~SkAutoStripedSharedMutexShared() { fLock.releaseShared(); }
+private:
+    SkStripedSharedMutex& fLock;
+};
+
+#define SkAutoStripedSharedMutexShared(...) SK_REQUIRE_LOCAL_VAR(SkAutoStripedSharedMutexShared)
+
 #endif // SkSharedLock_DEFINED
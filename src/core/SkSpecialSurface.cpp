@@ -59,7 +59,8 @@ sk_sp<SkSpecialImage> SkSpecialSurface::makeImageSnapshot() {
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-#include "SkMallocPixelRef.h"
+#include "SkLayerPixelPool.h"
+#include "SkPixelRef.h"
 
 class SkSpecialSurface_Raster : public SkSpecialSurface_Base {
 public:
@@ -98,14 +99,16 @@ sk_sp<SkSpecialSurface> SkSpecialSurface::MakeFromBitmap(const SkIRect& subset,
 
 sk_sp<SkSpecialSurface> SkSpecialSurface::MakeRaster(const SkImageInfo& info,
                                                      const SkSurfaceProps* props) {
-    SkAutoTUnref<SkPixelRef> pr(SkMallocPixelRef::NewZeroed(info, 0, nullptr));
-    if (nullptr == pr.get()) {
+    // Filters make and drop intermediates of the same few sizes every time they're drawn, so we
+    // recycle their pixels through the same pool as saveLayer()'s.
+    SkBitmap bitmap;
+    if (!SkLayerPixelPool::AllocPixels(info, true, &bitmap)) {
         return nullptr;
     }
 
-    const SkIRect subset = SkIRect::MakeWH(pr->info().width(), pr->info().height());
+    const SkIRect subset = SkIRect::MakeWH(info.width(), info.height());
 
-    return sk_make_sp<SkSpecialSurface_Raster>(pr, subset, props);
+    return sk_make_sp<SkSpecialSurface_Raster>(bitmap.pixelRef(), subset, props);
 }
 
 #if SK_SUPPORT_GPU
@@ -5,6 +5,9 @@
  * found in the LICENSE file.
  */
 
+#include "SkColorFilter.h"
+#include "SkPM4f.h"
+#include "SkRasterPipeline.h"
 #include "SkSpriteBlitter.h"
 #include "SkSpanProcs.h"
 #include "SkTemplates.h"
@@ -31,6 +34,162 @@ private:
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Runs the color filter in the stage's context over the pixels in r,g,b,a.
+// kCount is N for the body, 1 for the tail.
+template <int N, int kCount>
+static void SK_VECTORCALL color_filter_stage(typename SkRasterPipelineN<N>::Stage* st, size_t x,
+                                             SkNx<N,float>  r, SkNx<N,float>  g,
+                                             SkNx<N,float>  b, SkNx<N,float>  a,
+                                             SkNx<N,float> dr, SkNx<N,float> dg,
+                                             SkNx<N,float> db, SkNx<N,float> da) {
+    float R[N], G[N], B[N], A[N];
+    r.store(R);
+    g.store(G);
+    b.store(B);
+    a.store(A);
+
+    SkPM4f span[N];
+    for (int i = 0; i < kCount; i++) {
+        span[i] = SkPM4f::From4f(Sk4f{R[i], G[i], B[i], A[i]});
+    }
+    st->template ctx<const SkColorFilter*>()->filterSpan4f(span, kCount, span);
+    for (int i = 0; i < kCount; i++) {
+        R[i] = span[i].r();
+        G[i] = span[i].g();
+        B[i] = span[i].b();
+        A[i] = span[i].a();
+    }
+
+    r = SkNx<N,float>::Load(R);
+    g = SkNx<N,float>::Load(G);
+    b = SkNx<N,float>::Load(B);
+    a = SkNx<N,float>::Load(A);
+    st->next(x, r,g,b,a, dr,dg,db,da);
+}
+
+// Filters that can be expressed as stages run right in the pipeline; the rest go through
+// color_filter_stage().
+template <int N>
+static void append_color_filter(SkRasterPipelineN<N>* p, const SkColorFilter* filter) {
+    if (!filter->appendStages(p)) {
+        p->append(&color_filter_stage<N,N>, &color_filter_stage<N,1>, filter);
+    }
+}
+
+// Sprite_RasterPipeline draws Src and SrcOver sprites from sRGB 8888 or F16 sources into sRGB
+// 8888 or F16 destinations.  Each row runs through one SkRasterPipeline, loading, modulating,
+// filtering, blending and storing N pixels at a time, rather than making a pass over an SkPM4f
+// buffer for each of those steps.  8888 to 8888 sprites stay with Sprite_sRGB, which is faster.
+class Sprite_RasterPipeline : public SkSpriteBlitter {
+public:
+    using Pipeline = SkWideRasterPipeline;
+
+    static bool Supports(const SkPixmap& src, const SkPaint& paint) {
+        switch (src.colorType()) {
+            case kN32_SkColorType:
+                if (!src.info().gammaCloseToSRGB()) {
+                    return false;
+                }
+                break;
+            case kRGBA_F16_SkColorType:
+                break;
+            default:
+                return false;
+        }
+        SkXfermode::Mode mode;
+        if (!SkXfermode::AsMode(paint.getXfermode(), &mode)) {
+            return false;
+        }
+        return SkXfermode::kSrc_Mode == mode || SkXfermode::kSrcOver_Mode == mode;
+    }
+
+    Sprite_RasterPipeline(const SkPixmap& src, const SkPaint& paint) : INHERITED(src) {
+        SkASSERT(Supports(src, paint));
+        SkXfermode::Mode mode;
+        SkAssertResult(SkXfermode::AsMode(paint.getXfermode(), &mode));
+
+        fAlpha = paint.getAlpha() * (1.0f/255);
+        fColorFilter = paint.getColorFilter();
+
+        bool staysOpaque = src.isOpaque()
+                        && 0xFF == paint.getAlpha()
+                        && (!fColorFilter ||
+                            (fColorFilter->getFlags() & SkColorFilter::kAlphaUnchanged_Flag));
+        fSrcOver = SkXfermode::kSrcOver_Mode == mode && !staysOpaque;
+    }
+
+    void blitRect(int x, int y, int width, int height) override {
+        SkASSERT(width > 0 && height > 0);
+        SkASSERT(fDst.colorType() == kRGBA_F16_SkColorType ||
+                 (fDst.colorType() == kN32_SkColorType && fDst.info().gammaCloseToSRGB()));
+
+        // Scaling and srcover treat r and b alike, so between two 8888 ends there's nothing
+        // to swap unless a color filter needs to see RGBA.
+        const bool swapRB = fColorFilter || fSource.colorType() != fDst.colorType();
+
+        for (int bottom = y + height; y < bottom; ++y) {
+            // Stock stages' contexts point at the start of the span, so each row gets its own.
+            Pipeline p;
+            if (fSource.colorType() == kRGBA_F16_SkColorType) {
+                p.append(Pipeline::load_s_f16, fSource.addr64(x - fLeft, y - fTop));
+            } else {
+                p.append(Pipeline::load_s_srgb, fSource.addr32(x - fLeft, y - fTop));
+                if (swapRB) {
+                    SwapIfBGRA(&p, Pipeline::swap_rb);
+                }
+            }
+
+            // Like SkFilterSpanProc_Choose(), we scale by the paint's alpha before filtering.
+            if (fAlpha != 1.0f) {
+                p.append(Pipeline::scale_1_float, &fAlpha);
+            }
+            if (fColorFilter) {
+                append_color_filter(&p, fColorFilter);
+            }
+
+            if (fDst.colorType() == kRGBA_F16_SkColorType) {
+                uint64_t* dst = fDst.writable_addr64(x, y);
+                if (fSrcOver) {
+                    p.append(Pipeline::load_d_f16, dst);
+                    p.append(Pipeline::srcover);
+                }
+                p.append(Pipeline::store_f16, dst);
+            } else {
+                uint32_t* dst = fDst.writable_addr32(x, y);
+                if (fSrcOver) {
+                    p.append(Pipeline::load_d_srgb, dst);
+                    if (swapRB) {
+                        SwapIfBGRA(&p, Pipeline::swap_rb_d);
+                    }
+                    p.append(Pipeline::srcover);
+                }
+                if (swapRB) {
+                    SwapIfBGRA(&p, Pipeline::swap_rb);
+                }
+                p.append(Pipeline::store_srgb, dst);
+            }
+
+            p.run(width);
+        }
+    }
+
+private:
+    // The stock 8888 stages work in RGBA order.
+    static void SwapIfBGRA(Pipeline* p, Pipeline::StockStage swap) {
+    #ifdef SK_PMCOLOR_IS_BGRA
+        p->append(swap);
+    #endif
+    }
+
+    float                fAlpha;
+    const SkColorFilter* fColorFilter;
+    bool                 fSrcOver;
+
+    typedef SkSpriteBlitter INHERITED;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
 class Sprite_F16 : public Sprite_4f {
 public:
     Sprite_F16(const SkPixmap& src, const SkPaint& paint) : INHERITED(src, paint) {
@@ -69,6 +228,10 @@ SkSpriteBlitter* SkSpriteBlitter::ChooseF16(const SkPixmap& source, const SkPain
         return nullptr;
     }
 
+    if (Sprite_RasterPipeline::Supports(source, paint)) {
+        return allocator->createT<Sprite_RasterPipeline>(source, paint);
+    }
+
     switch (source.colorType()) {
         case kN32_SkColorType:
         case kRGBA_F16_SkColorType:
@@ -119,6 +282,12 @@ SkSpriteBlitter* SkSpriteBlitter::ChooseS32(const SkPixmap& source, const SkPain
         return nullptr;
     }
 
+    // Sprite_sRGB's approximate sRGB curve is faster for 8888 sources.
+    if (source.colorType() == kRGBA_F16_SkColorType &&
+        Sprite_RasterPipeline::Supports(source, paint)) {
+        return allocator->createT<Sprite_RasterPipeline>(source, paint);
+    }
+
     switch (source.colorType()) {
         case kN32_SkColorType:
         case kRGBA_F16_SkColorType:
@@ -8,6 +8,8 @@
 #include "SkStrokerPriv.h"
 #include "SkGeometry.h"
 #include "SkPathPriv.h"
+#include "SkResourceCache.h"
+#include "SkTLazy.h"
 
 enum {
     kTangent_RecursiveLimit,
@@ -1270,6 +1272,7 @@ SkStroke::SkStroke() {
     fCap        = SkPaint::kDefault_Cap;
     fJoin       = SkPaint::kDefault_Join;
     fDoFill     = false;
+    fResScale   = 1;
 }
 
 SkStroke::SkStroke(const SkPaint& p) {
@@ -1278,6 +1281,7 @@ SkStroke::SkStroke(const SkPaint& p) {
     fCap        = (uint8_t)p.getStrokeCap();
     fJoin       = (uint8_t)p.getStrokeJoin();
     fDoFill     = SkToU8(p.getStyle() == SkPaint::kStrokeAndFill_Style);
+    fResScale   = 1;
 }
 
 SkStroke::SkStroke(const SkPaint& p, SkScalar width) {
@@ -1286,6 +1290,7 @@ SkStroke::SkStroke(const SkPaint& p, SkScalar width) {
     fCap        = (uint8_t)p.getStrokeCap();
     fJoin       = (uint8_t)p.getStrokeJoin();
     fDoFill     = SkToU8(p.getStyle() == SkPaint::kStrokeAndFill_Style);
+    fResScale   = 1;
 }
 
 void SkStroke::setWidth(SkScalar width) {
@@ -1336,6 +1341,65 @@ private:
     bool            fSwapWithSrc;
 };
 
+namespace {
+static unsigned gStrokeKeyNamespaceLabel;
+
+// Paths with fewer points than this are quicker to stroke again than to look up.
+static const int kMinCachedStrokePoints = 32;
+
+struct StrokeKey : public SkResourceCache::Key {
+public:
+    StrokeKey(const SkPath& src, SkScalar width, SkScalar miterLimit, SkScalar resScale,
+              SkPaint::Cap cap, SkPaint::Join join, bool doFill)
+        : fGenID(src.getGenerationID())
+        , fFillType(src.getFillType())
+        , fWidth(width)
+        , fMiterLimit(miterLimit)
+        , fResScale(resScale)
+        , fCapJoinFill((cap << 16) | (join << 8) | doFill) {
+        static const size_t keySize = sizeof(fGenID) + sizeof(fFillType) + sizeof(fWidth) +
+                                      sizeof(fMiterLimit) + sizeof(fResScale) +
+                                      sizeof(fCapJoinFill);
+        // This better be packed.
+        SkASSERT(sizeof(uint32_t) * (&fEndOfStruct - &fGenID) == keySize);
+        this->init(&gStrokeKeyNamespaceLabel, 0, keySize);
+    }
+
+private:
+    uint32_t fGenID;
+    int32_t  fFillType;
+    SkScalar fWidth;
+    SkScalar fMiterLimit;
+    SkScalar fResScale;
+    uint32_t fCapJoinFill;
+
+    SkDEBUGCODE(uint32_t fEndOfStruct;)
+};
+
+struct StrokeRec : public SkResourceCache::Rec {
+    StrokeRec(const StrokeKey& key, const SkPath& stroke)
+        : fKey(key)
+        , fStroke(stroke) {}
+
+    StrokeKey fKey;
+    SkPath    fStroke;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override {
+        return sizeof(*this) + fStroke.countPoints() * sizeof(SkPoint) + fStroke.countVerbs();
+    }
+    const char* getCategory() const override { return "stroke"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override { return nullptr; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextPath) {
+        const StrokeRec& rec = static_cast<const StrokeRec&>(baseRec);
+        // The copy shares the cached path's points and verbs.
+        *static_cast<SkPath*>(contextPath) = rec.fStroke;
+        return true;
+    }
+};
+} // namespace
+
 void SkStroke::strokePath(const SkPath& src, SkPath* dst) const {
     SkASSERT(dst);
 
@@ -1363,6 +1427,17 @@ void SkStroke::strokePath(const SkPath& src, SkPath* dst) const {
         }
     }
 
+    // Long paths that are drawn over and over (e.g. chart series) get their strokes cached.
+    // Volatile paths change too often for that to pay off.
+    const bool cacheable = !src.isVolatile() && src.countPoints() >= kMinCachedStrokePoints;
+    SkTLazy<StrokeKey> key;
+    if (cacheable) {
+        key.init(src, fWidth, fMiterLimit, fResScale, this->getCap(), this->getJoin(), fDoFill);
+        if (SkResourceCache::Find(*key.get(), StrokeRec::Visitor, dst)) {
+            return;
+        }
+    }
+
     SkPathStroker   stroker(src, radius, fMiterLimit, this->getCap(), this->getJoin(), fResScale);
     SkPath::Iter    iter(src, false);
     SkPath::Verb    lastSegment = SkPath::kMove_Verb;
@@ -1450,6 +1525,10 @@ DONE:
         SkASSERT(!dst->isInverseFillType());
         dst->toggleInverseFillType();
     }
+
+    if (cacheable) {
+        SkResourceCache::Add(new StrokeRec(*key.get(), *dst));
+    }
 }
 
 static SkPath::Direction reverse_direction(SkPath::Direction dir) {
@@ -0,0 +1,315 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkTFlatHash_DEFINED
+#define SkTFlatHash_DEFINED
+
+#include "SkMath.h"
+#include "SkTemplates.h"
+#include "SkTypes.h"
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    #include <emmintrin.h>
+#elif defined(SK_ARM_HAS_NEON)
+    #include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+// SkTFlatHashTable is a drop-in alternative to SkTHashTable (same T, K and Traits, same API) that
+// keeps a separate array of one control byte per slot: 7 bits of the entry's hash if the slot is
+// full, or a marker if it's empty or removed.  Lookups compare 16 control bytes at a time with
+// SSE2 or NEON, and only touch the entries whose 7 hash bits match, so a miss usually costs a
+// single 16 byte load no matter how large T is.
+//
+// That makes misses cheaper, but a hit costs an extra load, and for tables that fit in cache
+// SkTHashTable and SkTDynamicHash hit faster.  Use it where lookups mostly miss, and measure
+// (see bench/FlatHashBench.cpp).
+
+namespace SkTFlatHash_priv {
+
+static const int kGroupWidth = 16;
+
+// Control byte values.  Full slots hold 7 bits of hash in [0,127]; the markers have the high bit.
+static const int8_t kEmpty   = -128,   // 0x80
+                    kRemoved = -2;     // 0xFE
+
+static inline int lowest_bit(uint64_t bits) {
+    SkASSERT(bits);
+#if defined(_MSC_VER)
+    unsigned long index;
+    if (_BitScanForward(&index, (uint32_t)bits)) {
+        return (int)index;
+    }
+    _BitScanForward(&index, (uint32_t)(bits >> 32));
+    return (int)index + 32;
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
+// The slots in a group whose control bytes matched, lowest first.
+// Slot i is represented by bit i << kShift.
+class Mask {
+public:
+#if !(SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2) && defined(SK_ARM_HAS_NEON)
+    static const int kShift = 2;    // NEON narrows each byte's comparison to 4 bits.
+#else
+    static const int kShift = 0;
+#endif
+
+    explicit Mask(uint64_t bits) : fBits(bits) {}
+
+    explicit operator bool() const { return fBits != 0; }
+    int  lowest()    const { return lowest_bit(fBits) >> kShift; }
+    void dropLowest()      { fBits &= fBits - 1; }
+
+private:
+    uint64_t fBits;
+};
+
+// kGroupWidth control bytes, loaded together.
+class Group {
+public:
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    explicit Group(const int8_t* ctrl)
+        : fCtrl(_mm_load_si128(reinterpret_cast<const __m128i*>(ctrl))) {}
+
+    Mask match(int8_t h) const {
+        return Mask(_mm_movemask_epi8(_mm_cmpeq_epi8(fCtrl, _mm_set1_epi8(h))));
+    }
+    // Both markers, and only they, have their sign bit set.
+    Mask matchEmptyOrRemoved() const { return Mask(_mm_movemask_epi8(fCtrl)); }
+
+private:
+    __m128i fCtrl;
+#elif defined(SK_ARM_HAS_NEON)
+    explicit Group(const int8_t* ctrl) : fCtrl(vld1q_s8(ctrl)) {}
+
+    Mask match(int8_t h) const { return ToMask(vceqq_s8(fCtrl, vdupq_n_s8(h))); }
+    Mask matchEmptyOrRemoved() const { return ToMask(vcltq_s8(fCtrl, vdupq_n_s8(0))); }
+
+private:
+    // Shift-narrow each 0x00/0xFF byte to a nibble, then keep one bit of each nibble.
+    static Mask ToMask(uint8x16_t eq) {
+        uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(eq), 4);
+        return Mask(vget_lane_u64(vreinterpret_u64_u8(narrowed), 0) & 0x8888888888888888ull);
+    }
+
+    int8x16_t fCtrl;
+#else
+    explicit Group(const int8_t* ctrl) : fCtrl(ctrl) {}
+
+    Mask match(int8_t h) const {
+        uint64_t bits = 0;
+        for (int i = 0; i < kGroupWidth; i++) {
+            bits |= (uint64_t)(fCtrl[i] == h) << i;
+        }
+        return Mask(bits);
+    }
+    Mask matchEmptyOrRemoved() const {
+        uint64_t bits = 0;
+        for (int i = 0; i < kGroupWidth; i++) {
+            bits |= (uint64_t)(fCtrl[i] < 0) << i;
+        }
+        return Mask(bits);
+    }
+
+private:
+    const int8_t* fCtrl;
+#endif
+
+public:
+    Mask matchEmpty() const { return this->match(kEmpty); }
+};
+
+}  // namespace SkTFlatHash_priv
+
+// T and K are treated as ordinary copyable C++ types.
+// Traits must have:
+//   - static K GetKey(T)
+//   - static uint32_t Hash(K)
+// See SkTHashTable for the rules on mutating entries and on how long returned pointers stay valid.
+template <typename T, typename K, typename Traits = T>
+class SkTFlatHashTable : SkNoncopyable {
+public:
+    SkTFlatHashTable() : fCount(0), fRemoved(0), fCapacity(0), fCtrl(nullptr) {}
+
+    // Clear the table.
+    void reset() {
+        this->~SkTFlatHashTable();
+        new (this) SkTFlatHashTable;
+    }
+
+    // How many entries are in the table?
+    int count() const { return fCount; }
+
+    // Approximately how many bytes of memory do we use beyond sizeof(*this)?
+    size_t approxBytesUsed() const { return fCapacity * (sizeof(T) + 1); }
+
+    // Copy val into the hash table, returning a pointer to the copy now in the table.
+    // If there already is an entry in the table with the same key, we overwrite it.
+    T* set(const T& val) {
+        // Keep at least one slot in eight empty so that misses stop early.
+        if (8 * (fCount+fRemoved+1) > 7 * fCapacity) {
+            // If removed entries are most of the load, just clean them out.
+            this->resize(2 * fCount < fCapacity ? fCapacity
+                                                : SkTMax(2 * fCapacity, (int)kGroupWidth));
+        }
+        return this->uncheckedSet(val);
+    }
+
+    // If there is an entry in the table with this key, return a pointer to it.  If not, null.
+    T* find(const K& key) const {
+        int index = this->findIndex(key);
+        return index < 0 ? nullptr : &fSlots[index];
+    }
+
+    // Remove the value with this key from the hash table.
+    void remove(const K& key) {
+        int index = this->findIndex(key);
+        SkASSERT(index >= 0);
+        fCtrl[index] = SkTFlatHash_priv::kRemoved;
+        fSlots[index] = T();
+        fCount--;
+        fRemoved++;
+    }
+
+    // Call fn on every entry in the table.  You may mutate the entries, but be very careful.
+    template <typename Fn>  // f(T*)
+    void foreach(Fn&& fn) {
+        for (int i = 0; i < fCapacity; i++) {
+            if (fCtrl[i] >= 0) {
+                fn(&fSlots[i]);
+            }
+        }
+    }
+
+    // Call fn on every entry in the table.  You may not mutate anything.
+    template <typename Fn>  // f(T) or f(const T&)
+    void foreach(Fn&& fn) const {
+        for (int i = 0; i < fCapacity; i++) {
+            if (fCtrl[i] >= 0) {
+                const T& val = fSlots[i];
+                fn(val);
+            }
+        }
+    }
+
+private:
+    typedef SkTFlatHash_priv::Group Group;
+    typedef SkTFlatHash_priv::Mask  Mask;
+    enum { kGroupWidth = SkTFlatHash_priv::kGroupWidth };
+
+    // The high 25 bits of the hash pick the first group to look in; the low 7 go in fCtrl.
+    static uint32_t GroupHash(uint32_t hash) { return hash >> 7; }
+    static int8_t    CtrlHash(uint32_t hash) { return (int8_t)(hash & 0x7f); }
+
+    int groupMask() const { return fCapacity / kGroupWidth - 1; }
+
+    // Groups are probed quadratically, which visits every group when their count is a power of 2.
+    int firstGroup(uint32_t hash) const { return GroupHash(hash) & this->groupMask(); }
+    int nextGroup(int group, int n) const { return (group + n + 1) & this->groupMask(); }
+
+    int findIndex(const K& key) const {
+        if (0 == fCapacity) {
+            return -1;
+        }
+        const uint32_t hash = Traits::Hash(key);
+        const int8_t h = CtrlHash(hash);
+        int group = this->firstGroup(hash);
+        for (int n = 0; n <= this->groupMask(); n++) {
+            const int base = group * kGroupWidth;
+            Group g(fCtrl + base);
+            for (Mask m = g.match(h); m; m.dropLowest()) {
+                int index = base + m.lowest();
+                if (key == Traits::GetKey(fSlots[index])) {
+                    return index;
+                }
+            }
+            if (g.matchEmpty()) {
+                return -1;
+            }
+            group = this->nextGroup(group, n);
+        }
+        return -1;
+    }
+
+    T* uncheckedSet(const T& val) {
+        const K& key = Traits::GetKey(val);
+        const uint32_t hash = Traits::Hash(key);
+        const int8_t h = CtrlHash(hash);
+
+        int firstFree = -1;
+        int group = this->firstGroup(hash);
+        for (int n = 0; n <= this->groupMask(); n++) {
+            const int base = group * kGroupWidth;
+            Group g(fCtrl + base);
+            for (Mask m = g.match(h); m; m.dropLowest()) {
+                int index = base + m.lowest();
+                if (key == Traits::GetKey(fSlots[index])) {
+                    // Overwrite previous entry.
+                    fSlots[index] = val;
+                    return &fSlots[index];
+                }
+            }
+            if (firstFree < 0) {
+                if (Mask free = g.matchEmptyOrRemoved()) {
+                    firstFree = base + free.lowest();
+                }
+            }
+            if (g.matchEmpty()) {
+                break;  // The key can't be any further along.
+            }
+            group = this->nextGroup(group, n);
+        }
+        SkASSERT(firstFree >= 0);
+
+        // New entry.
+        if (SkTFlatHash_priv::kRemoved == fCtrl[firstFree]) {
+            fRemoved--;
+        }
+        fCtrl[firstFree] = h;
+        fSlots[firstFree] = val;
+        fCount++;
+        return &fSlots[firstFree];
+    }
+
+    void resize(int capacity) {
+        SkASSERT(capacity % kGroupWidth == 0 && SkIsPow2(capacity / kGroupWidth));
+        int oldCapacity = fCapacity;
+        SkDEBUGCODE(int oldCount = fCount);
+
+        fCount = fRemoved = 0;
+        fCapacity = capacity;
+        SkAutoTArray<T> oldSlots(capacity);
+        oldSlots.swap(fSlots);
+        SkAutoTMalloc<int8_t> oldCtrlStorage(fCtrlStorage.release());
+        const int8_t* oldCtrl = fCtrl;
+        fCtrlStorage.reset(capacity + kGroupWidth);
+
+        // Groups are loaded with aligned loads, so we align fCtrl within fCtrlStorage.
+        fCtrl = fCtrlStorage.get() + (-(intptr_t)fCtrlStorage.get() & (kGroupWidth - 1));
+        memset(fCtrl, SkTFlatHash_priv::kEmpty, capacity);
+
+        for (int i = 0; i < oldCapacity; i++) {
+            if (oldCtrl[i] >= 0) {
+                this->uncheckedSet(oldSlots[i]);
+            }
+        }
+        SkASSERT(fCount == oldCount);
+    }
+
+    int fCount, fRemoved, fCapacity;
+    SkAutoTArray<T> fSlots;
+    SkAutoTMalloc<int8_t> fCtrlStorage;
+    int8_t* fCtrl;  // fCapacity control bytes, aligned within fCtrlStorage.
+};
+
+#endif//SkTFlatHash_DEFINED
@@ -9,7 +9,6 @@
 #include "SkOnce.h"
 #include "SkSemaphore.h"
 #include "SkSpinlock.h"
-#include "SkTArray.h"
 #include "SkTDArray.h"
 #include "SkTaskGroup.h"
 #include "SkThreadUtils.h"
@@ -38,13 +37,48 @@ static int num_cores() {
 
 namespace {
 
+// Each thread keeps a few Tasks that have run, so a steady stream of add()s reuses them instead
+// of allocating.  They're freed when the thread exits.
+struct FreeTasks {
+    static const int kMax = 256;
+
+    ~FreeTasks() {
+        while (fHead) {
+            SkTaskGroup::Task* next = fHead->fNext;
+            sk_free(fHead);
+            fHead = next;
+        }
+    }
+
+    SkTaskGroup::Task* fHead  = nullptr;
+    int                fCount = 0;
+};
+thread_local FreeTasks gFreeTasks;
+
+// The index of the ThreadPool worker running on this thread, or -1 if it's not one of ours.
+thread_local int gWorkerIndex = -1;
+
+// ThreadPool is a work-stealing scheduler.  Each worker thread owns a queue of Tasks: it pushes
+// Tasks added from inside its own tasks onto the back of that queue and pops from the back too,
+// so nested tasks run depth-first, close to the data their parents just touched.  Tasks added
+// from threads outside the pool go onto a shared queue.  Idle threads take from the shared queue,
+// then steal from the front of other workers' queues, where the oldest (usually biggest) Task is.
+//
+// Wait() never sleeps: a thread waiting on an SkTaskGroup runs any Task it can find until the
+// group is done, so groups nested inside tasks can't deadlock the pool or leave cores idle.
 class ThreadPool : SkNoncopyable {
 public:
-    static void Add(std::function<void(void)> fn, SkAtomic<int32_t>* pending) {
+    typedef SkTaskGroup::Task Task;
+
+    static bool Enabled() { return gGlobal != nullptr; }
+
+    static void Add(Task* task, SkAtomic<int32_t>* pending) {
         if (!gGlobal) {
-            return fn();
+            task->fRun(task->fStorage.get());
+            Task::Free(task);
+            return;
         }
-        gGlobal->add(fn, pending);
+        gGlobal->add(task, pending);
     }
 
     static void Batch(int N, std::function<void(int)> fn, SkAtomic<int32_t>* pending) {
@@ -52,7 +86,7 @@ public:
             for (int i = 0; i < N; i++) { fn(i); }
             return;
         }
-        gGlobal->batch(N, fn, pending);
+        gGlobal->batch(N, std::move(fn), pending);
     }
 
     static void Wait(SkAtomic<int32_t>* pending) {
@@ -60,27 +94,22 @@ public:
             SkASSERT(pending->load(sk_memory_order_relaxed) == 0);
             return;
         }
+        const int self = gWorkerIndex;
         // Acquire pairs with decrement release here or in Loop.
         while (pending->load(sk_memory_order_acquire) > 0) {
             // Lend a hand until our SkTaskGroup of interest is done.
-            Work work;
-            {
-                // We're stealing work opportunistically,
-                // so we never call fWorkAvailable.wait(), which could sleep us if there's no work.
-                // This means fWorkAvailable is only an upper bound on fWork.count().
-                AutoLock lock(&gGlobal->fWorkLock);
-                if (gGlobal->fWork.empty()) {
-                    // Someone has picked up all the work (including ours).  How nice of them!
-                    // (They may still be working on it, so we can't assert *pending == 0 here.)
-                    continue;
-                }
-                work = gGlobal->fWork.back();
-                gGlobal->fWork.pop_back();
+            // We're stealing work opportunistically,
+            // so we never call fWorkAvailable.wait(), which could sleep us if there's no work.
+            // This means fWorkAvailable is only an upper bound on the Tasks queued.
+            Task* task = gGlobal->findWork(self);
+            if (!task) {
+                // Someone has picked up all the work (including ours).  How nice of them!
+                // (They may still be working on it, so we can't assert *pending == 0 here.)
+                continue;
             }
-            // This Work isn't necessarily part of our SkTaskGroup of interest, but that's fine.
+            // This Task isn't necessarily part of our SkTaskGroup of interest, but that's fine.
             // We threads gotta stick together.  We're always making forward progress.
-            work.fn();
-            work.pending->fetch_add(-1, sk_memory_order_release);  // Pairs with load above.
+            Run(task);
         }
     }
 
@@ -92,88 +121,217 @@ private:
         SkSpinlock* fLock;
     };
 
-    struct Work {
-        std::function<void(void)> fn; // A function to call
-        SkAtomic<int32_t>* pending;   // then decrement pending afterwards.
+    // All the tasks of one batch() share a single copy of its function.
+    struct BatchFn {
+        BatchFn(std::function<void(int)>&& fn, int N) : fn(std::move(fn)), remaining(N) {}
+
+        std::function<void(int)> fn;
+        SkAtomic<int32_t>        remaining;  // The last task to finish deletes the BatchFn.
+    };
+
+    // One task of a batch(): small enough to fit in its Task.
+    struct BatchTask {
+        void operator()() const {
+            batch->fn(index);
+            if (batch->remaining.fetch_add(-1, sk_memory_order_acq_rel) == 1) {
+                delete batch;
+            }
+        }
+
+        BatchFn* batch;
+        int      index;
+    };
+
+    // A double-ended queue of Tasks linked through their fPrev and fNext, guarded by fLock.
+    struct Queue {
+        void pushBack(Task* task) {
+            task->fPrev = fBack;
+            task->fNext = nullptr;
+            (fBack ? fBack->fNext : fFront) = task;
+            fBack = task;
+        }
+
+        // Moves all of chain's Tasks onto our back.
+        void pushBack(Queue* chain) {
+            if (chain->empty()) {
+                return;
+            }
+            chain->fFront->fPrev = fBack;
+            (fBack ? fBack->fNext : fFront) = chain->fFront;
+            fBack = chain->fBack;
+            chain->fFront = chain->fBack = nullptr;
+        }
+
+        Task* popBack() {
+            Task* task = fBack;
+            if (task) {
+                fBack = task->fPrev;
+                (fBack ? fBack->fNext : fFront) = nullptr;
+            }
+            return task;
+        }
+
+        Task* popFront() {
+            Task* task = fFront;
+            if (task) {
+                fFront = task->fNext;
+                (fFront ? fFront->fPrev : fBack) = nullptr;
+            }
+            return task;
+        }
+
+        bool empty() const { return fFront == nullptr; }
+
+        SkSpinlock fLock;
+        Task*      fFront = nullptr;
+        Task*      fBack  = nullptr;
     };
 
     explicit ThreadPool(int threads) {
         if (threads == -1) {
             threads = num_cores();
         }
+        fThreadCount = threads;
+        // One Queue per worker thread, plus one more shared by threads outside the pool.
+        fQueues.reset(threads + 1);
         for (int i = 0; i < threads; i++) {
-            fThreads.push(new SkThread(&ThreadPool::Loop, this));
+            fThreads.push(new SkThread(&ThreadPool::Loop, new LoopArgs{this, i}));
             fThreads.top()->start();
         }
     }
 
     ~ThreadPool() {
-        SkASSERT(fWork.empty());  // All SkTaskGroups should be destroyed by now.
+        SkASSERT(this->allQueuesEmpty());  // All SkTaskGroups should be destroyed by now.
 
-        // Send a poison pill to each thread.
-        SkAtomic<int> dummy(0);
+        // Send a poison pill (a Task with no function) to each thread.
+        SkAtomic<int32_t> dummy(0);
         for (int i = 0; i < fThreads.count(); i++) {
-            this->add(nullptr, &dummy);
+            Task* pill = new (Task::Alloc()) Task;
+            pill->fRun = nullptr;
+            this->add(pill, &dummy);
         }
         // Wait for them all to swallow the pill and die.
         for (int i = 0; i < fThreads.count(); i++) {
             fThreads[i]->join();
         }
-        SkASSERT(fWork.empty());  // Can't hurt to double check.
+        SkASSERT(this->allQueuesEmpty());  // Can't hurt to double check.
         fThreads.deleteAll();
     }
 
-    void add(std::function<void(void)> fn, SkAtomic<int32_t>* pending) {
-        Work work = { fn, pending };
+    bool allQueuesEmpty() {
+        for (int i = 0; i <= fThreadCount; i++) {
+            AutoLock lock(&fQueues[i].fLock);
+            if (!fQueues[i].empty()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // The Queue Tasks added from the calling thread should go on.
+    Queue* queueForCaller() {
+        const int self = gWorkerIndex;
+        return &fQueues[self < 0 ? fThreadCount : self];
+    }
+
+    void add(Task* task, SkAtomic<int32_t>* pending) {
+        task->fPending = pending;
         pending->fetch_add(+1, sk_memory_order_relaxed);  // No barrier needed.
+        Queue* queue = this->queueForCaller();
         {
-            AutoLock lock(&fWorkLock);
-            fWork.push_back(work);
+            AutoLock lock(&queue->fLock);
+            queue->pushBack(task);
         }
         fWorkAvailable.signal(1);
     }
 
-    void batch(int N, std::function<void(int)> fn, SkAtomic<int32_t>* pending) {
+    void batch(int N, std::function<void(int)>&& fn, SkAtomic<int32_t>* pending) {
+        if (N <= 0) {
+            return;
+        }
+        BatchFn* batch = new BatchFn(std::move(fn), N);
+        // Chain in reverse, so popBack() runs the batch in order on this thread,
+        // while thieves take from the other end.
+        Queue chain;
+        for (int i = N - 1; i >= 0; i--) {
+            Task* task = Task::Make(BatchTask{batch, i});
+            task->fPending = pending;
+            chain.pushBack(task);
+        }
         pending->fetch_add(+N, sk_memory_order_relaxed);  // No barrier needed.
+        Queue* queue = this->queueForCaller();
         {
-            AutoLock lock(&fWorkLock);
-            for (int i = 0; i < N; i++) {
-                Work work = { [i, fn]() { fn(i); }, pending };
-                fWork.push_back(work);
-            }
+            AutoLock lock(&queue->fLock);
+            queue->pushBack(&chain);
         }
         fWorkAvailable.signal(N);
     }
 
+    // Find a Task for worker self (-1 if not a worker): our own queue first (newest Task),
+    // then the shared queue, then the oldest Task in anyone else's queue.
+    Task* findWork(int self) {
+        if (self >= 0) {
+            AutoLock lock(&fQueues[self].fLock);
+            if (Task* task = fQueues[self].popBack()) {
+                return task;
+            }
+        }
+        for (int i = 0; i <= fThreadCount; i++) {
+            // Start with the shared queue, then the worker after us, wrapping around.
+            int victim = (fThreadCount + self + 1 + i) % (fThreadCount + 1);
+            if (victim == self) {
+                continue;
+            }
+            AutoLock lock(&fQueues[victim].fLock);
+            if (Task* task = fQueues[victim].popFront()) {
+                return task;
+            }
+        }
+        return nullptr;
+    }
+
+    static void Run(Task* task) {
+        SkAtomic<int32_t>* pending = task->fPending;
+        // Releases anything the function captured before signaling.
+        task->fRun(task->fStorage.get());
+        Task::Free(task);
+        pending->fetch_add(-1, sk_memory_order_release);  // Pairs with load in Wait().
+    }
+
+    struct LoopArgs {
+        ThreadPool* pool;
+        int         index;
+    };
+
     static void Loop(void* arg) {
-        ThreadPool* pool = (ThreadPool*)arg;
-        Work work;
+        ThreadPool* pool = ((LoopArgs*)arg)->pool;
+        const int self   = ((LoopArgs*)arg)->index;
+        delete (LoopArgs*)arg;
+
+        gWorkerIndex = self;
         while (true) {
-            // Sleep until there's work available, and claim one unit of Work as we wake.
+            // Sleep until there's work available, and claim one Task as we wake.
             pool->fWorkAvailable.wait();
-            {
-                AutoLock lock(&pool->fWorkLock);
-                if (pool->fWork.empty()) {
-                    // Someone in Wait() stole our work (fWorkAvailable is an upper bound).
-                    // Well, that's fine, back to sleep for us.
-                    continue;
-                }
-                work = pool->fWork.back();
-                pool->fWork.pop_back();
+            Task* task = pool->findWork(self);
+            if (!task) {
+                // Someone in Wait() stole our work (fWorkAvailable is an upper bound).
+                // Well, that's fine, back to sleep for us.
+                continue;
             }
-            if (!work.fn) {
+            if (!task->fRun) {
+                Task::Free(task);
                 return;  // Poison pill.  Time... to die.
             }
-            work.fn();
-            work.pending->fetch_add(-1, sk_memory_order_release);  // Pairs with load in Wait().
+            Run(task);
         }
     }
 
-    // fWorkLock must be held when reading or modifying fWork.
-    SkSpinlock      fWorkLock;
-    SkTArray<Work>  fWork;
+    // fQueues[i] belongs to worker thread i; fQueues[fThreadCount] is shared by everyone else.
+    // Each Queue's fLock must be held when reading or modifying it.
+    int                 fThreadCount;
+    SkAutoTArray<Queue> fQueues;
 
-    // A thread-safe upper bound for fWork.count().
+    // A thread-safe upper bound for the Tasks in fQueues.
     //
     // We'd have it be an exact count but for the loop in Wait():
     // we never want that to block, so it can't call fWorkAvailable.wait(),
@@ -192,6 +350,25 @@ ThreadPool* ThreadPool::gGlobal = nullptr;
 
 }  // namespace
 
+void* SkTaskGroup::Task::Alloc() {
+    if (Task* task = gFreeTasks.fHead) {
+        gFreeTasks.fHead = task->fNext;
+        gFreeTasks.fCount--;
+        return task;
+    }
+    return sk_malloc_throw(sizeof(Task));
+}
+
+void SkTaskGroup::Task::Free(Task* task) {
+    if (gFreeTasks.fCount == FreeTasks::kMax) {
+        sk_free(task);
+        return;
+    }
+    task->fNext = gFreeTasks.fHead;
+    gFreeTasks.fHead = task;
+    gFreeTasks.fCount++;
+}
+
 SkTaskGroup::Enabler::Enabler(int threads) {
     SkASSERT(ThreadPool::gGlobal == nullptr);
     if (threads != 0) {
@@ -201,10 +378,12 @@ SkTaskGroup::Enabler::Enabler(int threads) {
 
 SkTaskGroup::Enabler::~Enabler() { delete ThreadPool::gGlobal; }
 
+bool SkTaskGroup::Enabled() { return ThreadPool::Enabled(); }
+
 SkTaskGroup::SkTaskGroup() : fPending(0) {}
 
 void SkTaskGroup::wait()                            { ThreadPool::Wait(&fPending); }
-void SkTaskGroup::add(std::function<void(void)> fn) { ThreadPool::Add(fn, &fPending); }
+void SkTaskGroup::addTask(Task* task)               { ThreadPool::Add(task, &fPending); }
 void SkTaskGroup::batch(int N, std::function<void(int)> fn) {
-    ThreadPool::Batch(N, fn, &fPending);
+    ThreadPool::Batch(N, std::move(fn), &fPending);
 }
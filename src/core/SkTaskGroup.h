@@ -9,10 +9,13 @@
 #define SkTaskGroup_DEFINED
 
 #include <functional>
+#include <new>
+#include <utility>
 
 #include "SkTypes.h"
 #include "SkAtomics.h"
 #include "SkTemplates.h"
+#include "SkTLogic.h"
 
 class SkTaskGroup : SkNoncopyable {
 public:
@@ -22,11 +25,17 @@ public:
         ~Enabler();
     };
 
+    // Returns true if an Enabler has given SkTaskGroups threads to run on.  Without one, tasks
+    // run serially on the calling thread, so splitting up work only adds overhead.
+    static bool Enabled();
+
     SkTaskGroup();
     ~SkTaskGroup() { this->wait(); }
 
     // Add a task to this SkTaskGroup.  It will likely run on another thread.
-    void add(std::function<void(void)> fn);
+    // fn may be any function object callable as fn().
+    template <typename Fn>
+    void add(Fn&& fn) { this->addTask(Task::Make(std::forward<Fn>(fn))); }
 
     // Add a batch of N tasks, all calling fn with different arguments.
     void batch(int N, std::function<void(int)> fn);
@@ -35,7 +44,59 @@ public:
     // You may safely reuse this SkTaskGroup after wait() returns.
     void wait();
 
+    // A queued task.  Tasks are fixed-size nodes, which the thread pool links into its queues
+    // and recycles once they've run.  A function that fits is moved into the Task itself;
+    // a bigger one is moved to the heap and the Task points to it.  Only for use by add().
+    struct Task {
+        static const size_t kStorageSize = 32;
+
+        template <typename Fn>
+        static Task* Make(Fn&& fn) {
+            typedef typename std::decay<Fn>::type F;
+            Task* task = new (Alloc()) Task;
+            task->init<F>(std::forward<Fn>(fn),
+                          skstd::bool_constant<sizeof(F) <= kStorageSize &&
+                                               alignof(F) <= alignof(Storage)>());
+            return task;
+        }
+
+        // Returns a Task's worth of uninitialized memory, and takes it back.
+        static void* Alloc();
+        static void Free(Task*);
+
+        typedef SkAlignedSStorage<kStorageSize> Storage;
+
+        void (*fRun)(void*);          // Calls the function in fStorage, then destroys it.
+        SkAtomic<int32_t>* fPending;  // The SkTaskGroup to decrement when it's done.
+        Task* fPrev;                  // Links in a thread pool queue.
+        Task* fNext;
+        Storage fStorage;
+
+    private:
+        template <typename F, typename Fn>
+        void init(Fn&& fn, std::true_type /*fits*/) {
+            new (fStorage.get()) F(std::forward<Fn>(fn));
+            fRun = [](void* storage) {
+                F* fn = static_cast<F*>(storage);
+                (*fn)();
+                fn->~F();
+            };
+        }
+
+        template <typename F, typename Fn>
+        void init(Fn&& fn, std::false_type /*fits*/) {
+            *static_cast<F**>(fStorage.get()) = new F(std::forward<Fn>(fn));
+            fRun = [](void* storage) {
+                F* fn = *static_cast<F**>(storage);
+                (*fn)();
+                delete fn;
+            };
+        }
+    };
+
 private:
+    void addTask(Task*);
+
     SkAtomic<int32_t> fPending;
 };
 
@@ -482,25 +482,48 @@ void SkTextBlobBuilder::updateDeferredBounds() {
 }
 
 void SkTextBlobBuilder::reserve(size_t size) {
-    // We don't currently pre-allocate, but maybe someday...
     if (fStorageUsed + size <= fStorageSize) {
         return;
     }
 
-    if (0 == fRunCount) {
+    if (0 == fStorageUsed) {
         SkASSERT(nullptr == fStorage.get());
         SkASSERT(0 == fStorageSize);
-        SkASSERT(0 == fStorageUsed);
+        SkASSERT(0 == fRunCount);
 
         // the first allocation also includes blob storage
         fStorageUsed += sizeof(SkTextBlob);
     }
 
-    fStorageSize = fStorageUsed + size;
+    // Grow geometrically so blobs with many runs don't realloc for each one. build() trims
+    // whatever is left over.
+    fStorageSize = SkTMax(fStorageUsed + size, fStorageSize + fStorageSize / 2);
     // FYI: This relies on everything we store being relocatable, particularly SkPaint.
     fStorage.realloc(fStorageSize);
 }
 
+void SkTextBlobBuilder::reserveRuns(int runCount, int glyphCount,
+                                    SkTextBlob::GlyphPositioning positioning) {
+    SkASSERT(runCount >= 0 && glyphCount >= 0);
+    if (runCount <= 0) {
+        return;
+    }
+
+    // Laid out as a single run, plus the record and worst case alignment padding of the others.
+    size_t size = SkTextBlob::RunRecord::StorageSize(glyphCount, positioning)
+                + (runCount - 1) * (sizeof(SkTextBlob::RunRecord) + sizeof(uint16_t)
+                                                                  + sizeof(void*));
+    if (fStorageUsed + size <= fStorageSize) {
+        return;
+    }
+
+    if (0 == fStorageUsed) {
+        fStorageUsed = sizeof(SkTextBlob);
+    }
+    fStorageSize = fStorageUsed + size;
+    fStorage.realloc(fStorageSize);
+}
+
 bool SkTextBlobBuilder::mergeRun(const SkPaint &font, SkTextBlob::GlyphPositioning positioning,
                                  int count, SkPoint offset) {
     if (0 == fLastRun) {
@@ -614,14 +637,17 @@ const SkTextBlobBuilder::RunBuffer& SkTextBlobBuilder::allocRunPos(const SkPaint
 }
 
 const SkTextBlob* SkTextBlobBuilder::build() {
-    SkASSERT((fRunCount > 0) == (nullptr != fStorage.get()));
+    SkASSERT(0 == fRunCount || nullptr != fStorage.get());
 
     this->updateDeferredBounds();
 
     if (0 == fRunCount) {
-        SkASSERT(nullptr == fStorage.get());
         fStorageUsed = sizeof(SkTextBlob);
-        fStorage.realloc(fStorageUsed);
+    }
+    if (fStorageUsed != fStorageSize) {
+        // Blobs tend to stick around, so don't let them keep the builder's slack.
+        fStorageSize = fStorageUsed;
+        fStorage.realloc(fStorageSize);
     }
 
     const SkTextBlob* blob = new (fStorage.release()) SkTextBlob(fRunCount, fBounds);
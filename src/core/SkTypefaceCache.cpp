@@ -10,46 +10,114 @@
 #include "SkTypefaceCache.h"
 #include "SkAtomics.h"
 #include "SkMutex.h"
+#include "SkSharedMutex.h"
+#include "SkTSort.h"
 
 #define TYPEFACE_CACHE_LIMIT    1024
 
-SkTypefaceCache::SkTypefaceCache() {}
+SkTypefaceCache::SkTypefaceCache() : fClock(0) {}
 
 void SkTypefaceCache::add(SkTypeface* face) {
-    if (fTypefaces.count() >= TYPEFACE_CACHE_LIMIT) {
+    this->addEntry(face, 0, false);
+}
+
+void SkTypefaceCache::add(SkTypeface* face, uint32_t key) {
+    this->addEntry(face, key, true);
+}
+
+void SkTypefaceCache::addEntry(SkTypeface* face, uint32_t key, bool hasKey) {
+    if (fEntries.count() >= TYPEFACE_CACHE_LIMIT) {
         this->purge(TYPEFACE_CACHE_LIMIT >> 2);
     }
 
-    fTypefaces.emplace_back(SkRef(face));
+    if (hasKey) {
+        SkTDArray<int>* indices = fKeyIndex.find(key);
+        if (!indices) {
+            indices = fKeyIndex.set(key, SkTDArray<int>());
+        }
+        *indices->append() = fEntries.count();
+    }
+    fEntries.push_back(Entry{ sk_ref_sp(face), key, hasKey, ++fClock });
+}
+
+const SkTypefaceCache::Entry* SkTypefaceCache::found(int index) const {
+    // Finds may run concurrently, so they only read fClock, which only add() advances.  That's
+    // still fine-grained enough to purge least recently used first.  Entries found again before
+    // the next add() are left alone, so busy ones aren't written over and over.
+    const Entry& entry = fEntries[index];
+    if (sk_atomic_load(&entry.fLastUse, sk_memory_order_relaxed) != fClock) {
+        sk_atomic_store(&entry.fLastUse, fClock, sk_memory_order_relaxed);
+    }
+    return &entry;
 }
 
 SkTypeface* SkTypefaceCache::findByProcAndRef(FindProc proc, void* ctx) const {
-    for (const sk_sp<SkTypeface>& typeface : fTypefaces) {
-        if (proc(typeface.get(), ctx)) {
-            return SkRef(typeface.get());
+    for (int i = 0; i < fEntries.count(); i++) {
+        if (proc(fEntries[i].fTypeface.get(), ctx)) {
+            return SkRef(this->found(i)->fTypeface.get());
+        }
+    }
+    return nullptr;
+}
+
+SkTypeface* SkTypefaceCache::findByKeyAndRef(uint32_t key, FindProc proc, void* ctx) const {
+    if (const SkTDArray<int>* indices = fKeyIndex.find(key)) {
+        for (int i : *indices) {
+            if (proc(fEntries[i].fTypeface.get(), ctx)) {
+                return SkRef(this->found(i)->fTypeface.get());
+            }
         }
     }
     return nullptr;
 }
 
 void SkTypefaceCache::purge(int numToPurge) {
-    int count = fTypefaces.count();
-    int i = 0;
-    while (i < count) {
-        if (fTypefaces[i]->unique()) {
-            fTypefaces.removeShuffle(i);
-            --count;
-            if (--numToPurge == 0) {
-                return;
+    // Typefaces only we own can go, least recently used first.
+    SkTDArray<int> purgeable;
+    for (int i = 0; i < fEntries.count(); i++) {
+        if (fEntries[i].fTypeface->unique()) {
+            *purgeable.append() = i;
+        }
+    }
+    if (purgeable.isEmpty()) {
+        return;
+    }
+    SkTQSort(purgeable.begin(), purgeable.end() - 1, [this](int a, int b) {
+        return fEntries[a].fLastUse < fEntries[b].fLastUse;
+    });
+    numToPurge = SkTMin(numToPurge, purgeable.count());
+
+    SkAutoTMalloc<bool> doomed(fEntries.count());
+    sk_bzero(doomed.get(), fEntries.count() * sizeof(bool));
+    for (int i = 0; i < numToPurge; i++) {
+        doomed[purgeable[i]] = true;
+    }
+
+    SkTArray<Entry> kept;
+    for (int i = 0; i < fEntries.count(); i++) {
+        if (!doomed[i]) {
+            kept.push_back(std::move(fEntries[i]));
+        }
+    }
+    fEntries.swap(&kept);
+    this->reindex();
+}
+
+void SkTypefaceCache::reindex() {
+    fKeyIndex.reset();
+    for (int i = 0; i < fEntries.count(); i++) {
+        if (fEntries[i].fHasKey) {
+            SkTDArray<int>* indices = fKeyIndex.find(fEntries[i].fKey);
+            if (!indices) {
+                indices = fKeyIndex.set(fEntries[i].fKey, SkTDArray<int>());
             }
-        } else {
-            ++i;
+            *indices->append() = i;
         }
     }
 }
 
 void SkTypefaceCache::purgeAll() {
-    this->purge(fTypefaces.count());
+    this->purge(fEntries.count());
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -64,20 +132,34 @@ SkFontID SkTypefaceCache::NewFontID() {
     return sk_atomic_inc(&gFontID) + 1;
 }
 
-SK_DECLARE_STATIC_MUTEX(gMutex);
+// Nearly every typeface lookup is a find, from any thread, so finds share the lock.
+static SkStripedSharedMutex& global_mutex() {
+    static SkStripedSharedMutex* mutex = new SkStripedSharedMutex;
+    return *mutex;
+}
 
 void SkTypefaceCache::Add(SkTypeface* face) {
-    SkAutoMutexAcquire ama(gMutex);
+    SkAutoExclusive ae(global_mutex());
     Get().add(face);
 }
 
+void SkTypefaceCache::Add(SkTypeface* face, uint32_t key) {
+    SkAutoExclusive ae(global_mutex());
+    Get().add(face, key);
+}
+
 SkTypeface* SkTypefaceCache::FindByProcAndRef(FindProc proc, void* ctx) {
-    SkAutoMutexAcquire ama(gMutex);
+    SkAutoStripedSharedMutexShared shared(global_mutex());
     return Get().findByProcAndRef(proc, ctx);
 }
 
+SkTypeface* SkTypefaceCache::FindByKeyAndRef(uint32_t key, FindProc proc, void* ctx) {
+    SkAutoStripedSharedMutexShared shared(global_mutex());
+    return Get().findByKeyAndRef(key, proc, ctx);
+}
+
 void SkTypefaceCache::PurgeAll() {
-    SkAutoMutexAcquire ama(gMutex);
+    SkAutoExclusive ae(global_mutex());
     Get().purgeAll();
 }
 
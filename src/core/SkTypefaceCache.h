@@ -11,6 +11,8 @@
 #define SkTypefaceCache_DEFINED
 
 #include "SkRefCnt.h"
+#include "SkTDArray.h"
+#include "SkTHash.h"
 #include "SkTypeface.h"
 #include "SkTArray.h"
 
@@ -33,6 +35,13 @@ public:
      */
     void add(SkTypeface*);
 
+    /**
+     *  Add a typeface to the cache under key, a hash of whatever callers will look it up by
+     *  (a font file's ID, a family name and style, a platform font handle...).  It can then
+     *  be found with findByKeyAndRef(), without visiting every other typeface in the cache.
+     */
+    void add(SkTypeface*, uint32_t key);
+
     /**
      *  Iterate through the cache, calling proc(typeface, ctx) with each
      *  typeface. If proc returns true, then we return that typeface (this
@@ -40,6 +49,12 @@ public:
      */
     SkTypeface* findByProcAndRef(FindProc proc, void* ctx) const;
 
+    /**
+     *  Like findByProcAndRef(), but only calls proc(typeface, ctx) for the typefaces that
+     *  were added with this key.  Since keys are hashes, proc still decides what matches.
+     */
+    SkTypeface* findByKeyAndRef(uint32_t key, FindProc proc, void* ctx) const;
+
     /**
      *  This will unref all of the typefaces in the cache for which the cache
      *  is the only owner. Normally this is handled automatically as needed.
@@ -57,7 +72,9 @@ public:
     // These are static wrappers around a global instance of a cache.
 
     static void Add(SkTypeface*);
+    static void Add(SkTypeface*, uint32_t key);
     static SkTypeface* FindByProcAndRef(FindProc proc, void* ctx);
+    static SkTypeface* FindByKeyAndRef(uint32_t key, FindProc proc, void* ctx);
     static void PurgeAll();
 
     /**
@@ -68,9 +85,21 @@ public:
 private:
     static SkTypefaceCache& Get();
 
+    struct Entry {
+        sk_sp<SkTypeface> fTypeface;
+        uint32_t          fKey;
+        bool              fHasKey;
+        mutable uint32_t  fLastUse;  // When it was last found, for purging the least recent.
+    };
+
+    void addEntry(SkTypeface*, uint32_t key, bool hasKey);
+    const Entry* found(int index) const;
     void purge(int count);
+    void reindex();
 
-    SkTArray<sk_sp<SkTypeface>> fTypefaces;
+    SkTArray<Entry>                       fEntries;   // In the order they were added.
+    SkTHashMap<uint32_t, SkTDArray<int>>  fKeyIndex;  // Key -> indices into fEntries.
+    uint32_t                              fClock;    // Advanced by each add().
 };
 
 #endif
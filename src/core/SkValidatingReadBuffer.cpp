@@ -229,50 +229,50 @@ SkFlattenable* SkValidatingReadBuffer::readFlattenable(SkFlattenable::Type type)
         return nullptr;
     }
 
-    SkString name;
+    uint32_t index;
     if (firstByte) {
         // If the first byte is non-zero, the flattenable is specified by a string.
+        SkString name;
         this->readString(&name);
         if (fError) {
             return nullptr;
         }
 
         // Add the string to the dictionary.
-        fFlattenableDict.set(fFlattenableDict.count() + 1, name);
+        this->addFlattenableName(name);
+        index = fFlattenableDict.count();
     } else {
         // Read the index.  We are guaranteed that the first byte
         // is zeroed, so we must shift down a byte.
-        uint32_t index = fReader.readU32() >> 8;
+        index = fReader.readU32() >> 8;
         if (0 == index) {
             return nullptr; // writer failed to give us the flattenable
         }
+    }
 
-        SkString* namePtr = fFlattenableDict.find(index);
-        if (!namePtr) {
-            return nullptr;
-        }
-        name = *namePtr;
+    const FlattenableEntry* entry = this->getFlattenableEntry(index);
+    if (!entry) {
+        return nullptr;
     }
 
     // Is this the type we wanted ?
-    const char* cname = name.c_str();
-    SkFlattenable::Type baseType;
-    if (!SkFlattenable::NameToType(cname, &baseType) || (baseType != type)) {
+    if (!entry->fHasType || (entry->fType != type)) {
         return nullptr;
     }
 
     // Get the factory for this flattenable.
-    SkFlattenable::Factory factory = this->getCustomFactory(name);
+    SkFlattenable::Factory factory = entry->fFactory;
     if (!factory) {
-        factory = SkFlattenable::NameToFactory(cname);
-        if (!factory) {
-            return nullptr; // writer failed to give us the flattenable
-        }
+        return nullptr; // writer failed to give us the flattenable
     }
 
     // If we get here, the factory is non-null.
     sk_sp<SkFlattenable> obj;
     uint32_t sizeRecorded = this->readUInt();
+    // Don't bother unflattening an object that claims more than we have left.
+    if (!this->validateAvailable(sizeRecorded)) {
+        return nullptr;
+    }
     size_t offset = fReader.offset();
     obj = (*factory)(*this);
     // check that we read the amount we expected
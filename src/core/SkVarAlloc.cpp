@@ -9,12 +9,14 @@
 
 struct SkVarAlloc::Block {
     Block* prev;
+    size_t size;  // Including this header.
     char* data() { return (char*)(this + 1); }
 
     static Block* Alloc(Block* prev, size_t size) {
         SkASSERT(size >= sizeof(Block));
         Block* b = (Block*)sk_malloc_throw(size);
         b->prev = prev;
+        b->size = size;
         return b;
     }
 };
@@ -23,14 +25,16 @@ SkVarAlloc::SkVarAlloc(size_t minLgSize)
     : fBytesAllocated(0)
     , fByte(nullptr)
     , fRemaining(0)
-    , fLgSize(minLgSize)
+    , fLgSize(SkToU16(minLgSize))
+    , fMallocCount(0)
     , fBlock(nullptr) {}
 
 SkVarAlloc::SkVarAlloc(size_t minLgSize, char* storage, size_t len)
     : fBytesAllocated(0)
     , fByte(storage)
     , fRemaining(len)
-    , fLgSize(minLgSize)
+    , fLgSize(SkToU16(minLgSize))
+    , fMallocCount(0)
     , fBlock(nullptr) {}
 
 SkVarAlloc::~SkVarAlloc() {
@@ -42,6 +46,35 @@ SkVarAlloc::~SkVarAlloc() {
     }
 }
 
+void SkVarAlloc::reset(char* storage, size_t len) {
+    fMallocCount = 0;
+    if (!fBlock) {
+        fByte = storage;
+        fRemaining = SkToU32(len);
+        return;
+    }
+    // Keep our largest block, and free the rest.
+    Block* largest = fBlock;
+    for (Block* b = fBlock->prev; b; b = b->prev) {
+        if (b->size > largest->size) {
+            largest = b;
+        }
+    }
+    Block* b = fBlock;
+    while (b) {
+        Block* prev = b->prev;
+        if (b != largest) {
+            sk_free(b);
+        }
+        b = prev;
+    }
+    fBlock = largest;
+    fBlock->prev = nullptr;
+    fBytesAllocated = fBlock->size;
+    fByte = fBlock->data();
+    fRemaining = SkToU32(fBlock->size - sizeof(Block));
+}
+
 void SkVarAlloc::makeSpace(size_t bytes) {
     SkASSERT(SkIsAlignPtr(bytes));
 
@@ -50,6 +83,7 @@ void SkVarAlloc::makeSpace(size_t bytes) {
         alloc *= 2;
     }
     fBytesAllocated += alloc;
+    fMallocCount++;
     fBlock = Block::Alloc(fBlock, alloc);
     fByte = fBlock->data();
     fRemaining = alloc - sizeof(Block);
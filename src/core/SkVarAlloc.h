@@ -38,6 +38,22 @@ public:
     // (We may not track this precisely to save space.)
     size_t approxBytesAllocated() const { return fBytesAllocated; }
 
+    // Returns how many blocks we've malloc'd since construction or the last reset().
+    int mallocCount() const { return fMallocCount; }
+
+    // Invalidates everything we've returned from alloc() and starts over, keeping our largest
+    // block to allocate from again and freeing the rest.  If we haven't malloc'd any blocks yet,
+    // we first use up to len bytes from storage, just like the constructor.
+    void reset(char* storage, size_t len);
+
+    // Make sure the next allocations, up to bytes in all, will fit in one block.
+    void reserve(size_t bytes) {
+        bytes = SkAlignPtr(bytes);
+        if (bytes > fRemaining) {
+            this->makeSpace(bytes);
+        }
+    }
+
 private:
     void makeSpace(size_t bytes);
 
@@ -45,7 +61,8 @@ private:
 
     char* fByte;
     unsigned fRemaining;
-    unsigned fLgSize;
+    uint16_t fLgSize;
+    uint16_t fMallocCount;
 
     struct Block;
     Block* fBlock;
@@ -176,8 +176,18 @@ void SkBinaryWriteBuffer::writeImage(const SkImage* image) {
     this->writeInt(image->width());
     this->writeInt(image->height());
 
+    if (fPixelSerializer) {
+        SkAutoTUnref<SkData> reference(fPixelSerializer->refImageReference(image));
+        if (reference) {
+            this->writeUInt(2);  // signal a reference, for the reader to resolve.
+            this->writeDataAsByteArray(reference);
+            return;
+        }
+    }
+
     SkAutoTUnref<SkData> encoded(image->encode(this->getPixelSerializer()));
-    if (encoded && encoded->size() > 0) {
+    // Sizes 0, 1 and 2 are taken to signal the other cases.
+    if (encoded && encoded->size() > 2) {
         write_encoded_bitmap(this, encoded, SkIPoint::Make(0, 0));
         return;
     }
@@ -8,6 +8,7 @@
 #include "SkPM4fPriv.h"
 #include "SkUtils.h"
 #include "SkXfermode.h"
+#include "SkXfermode4x4f.h"
 #include "Sk4x4f.h"
 
 static SkPM4f rgba_to_pmcolor_order(const SkPM4f& x) {
@@ -75,6 +76,31 @@ static void store_4_srgb(void* ptr, const Sk4x4f& p) {
     Sk4x4f{r,g,b,a}.transpose((uint8_t*)ptr);
 }
 
+// The same for linear 8888 pixels, matching Sk4f_fromL32() and Sk4f_toL32().
+static Sk4x4f load_4_linear(const void* ptr) {
+    auto p = Sk4x4f::Transpose((const uint8_t*)ptr);
+    p.r *= 1/255.0f;
+    p.g *= 1/255.0f;
+    p.b *= 1/255.0f;
+    p.a *= 1/255.0f;
+    return p;
+}
+
+static void store_4_linear(void* ptr, const Sk4x4f& p) {
+    Sk4x4f{p.r * 255.0f + 0.5f,
+           p.g * 255.0f + 0.5f,
+           p.b * 255.0f + 0.5f,
+           p.a * 255.0f + 0.5f}.transpose((uint8_t*)ptr);
+}
+
+template <DstType D> Sk4x4f load_4_dst(const void* ptr) {
+    return (D == kSRGB_Dst) ? load_4_srgb(ptr) : load_4_linear(ptr);
+}
+
+template <DstType D> void store_4_dst(void* ptr, const Sk4x4f& p) {
+    (D == kSRGB_Dst) ? store_4_srgb(ptr, p) : store_4_linear(ptr, p);
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 template <DstType D> void general_1(const SkXfermode* xfer, uint32_t dst[],
@@ -127,6 +153,110 @@ const SkXfermode::D32Proc gProcs_General[] = {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+SkXfermodeProc4x4f SkXfermode_GetProc4x4f(SkXfermode::Mode mode) {
+    static const SkXfermodeProc4x4f gProcs[] = {
+        clear_4x4f, src_4x4f, dst_4x4f, srcover_4x4f, dstover_4x4f,
+        srcin_4x4f, dstin_4x4f, srcout_4x4f, dstout_4x4f,
+        srcatop_4x4f, dstatop_4x4f, xor_4x4f, plus_4x4f, modulate_4x4f, screen_4x4f,
+
+        overlay_4x4f, darken_4x4f, lighten_4x4f, colordodge_4x4f, colorburn_4x4f,
+        hardlight_4x4f, softlight_4x4f, difference_4x4f, exclusion_4x4f, multiply_4x4f,
+
+        hue_4x4f<SkLum709_4x4f>, saturation_4x4f<SkLum709_4x4f>,
+        color_4x4f<SkLum709_4x4f>, luminosity_4x4f<SkLum709_4x4f>,
+    };
+    static_assert(SK_ARRAY_COUNT(gProcs) == SkXfermode::kLastMode + 1, "");
+    SkASSERT((unsigned)mode <= SkXfermode::kLastMode);
+    return gProcs[mode];
+}
+
+// dst is in SkPMColor order, and the 4x4f procs want RGBA.
+static void swap_rb_if_bgra(Sk4x4f* p) {
+#ifdef SK_PMCOLOR_IS_BGRA
+    SkTSwap(p->r, p->b);
+#endif
+}
+
+// Blend 4 pixels with proc, then lerp from dst towards the result by their coverage, leaving the
+// pixels with no coverage alone.
+template <DstType D>
+static void mode_4(SkXfermodeProc4x4f proc, uint32_t dst[], const Sk4x4f& s, const SkAlpha aa[]) {
+    if (aa) {
+        uint32_t aa4;
+        memcpy(&aa4, aa, 4);
+        if (0 == aa4) {
+            return;
+        }
+    }
+    auto d = load_4_dst<D>(dst);
+    swap_rb_if_bgra(&d);
+    auto r = proc(s, d);
+    if (aa) {
+        auto c = SkNx_cast<float>(Sk4b::Load(aa)) * (1/255.0f);
+        r = Sk4x4f{d.r + (r.r - d.r) * c,
+                   d.g + (r.g - d.g) * c,
+                   d.b + (r.b - d.b) * c,
+                   d.a + (r.a - d.a) * c};
+    }
+    r = pin_4x4f(r);
+    swap_rb_if_bgra(&r);
+
+    if (!aa) {
+        store_4_dst<D>(dst, r);
+        return;
+    }
+    uint32_t blended[4];
+    store_4_dst<D>(blended, r);
+    for (int i = 0; i < 4; ++i) {
+        if (aa[i]) {
+            dst[i] = blended[i];
+        }
+    }
+}
+
+// Any mode, 4 pixels at a time.  The last 1-3 pixels are blended as 4 from a padded copy.
+template <DstType D, bool kSingleSrc>
+void mode_n(const SkXfermode* xfer, uint32_t dst[], const SkPM4f src[], int count,
+            const SkAlpha aa[]) {
+    SkXfermode::Mode mode;
+    SkAssertResult(xfer->asMode(&mode));
+    const SkXfermodeProc4x4f proc = SkXfermode_GetProc4x4f(mode);
+
+    const Sk4f s4 = Sk4f::Load(src->fVec);
+    const Sk4x4f s1 = {{ s4[0] }, { s4[1] }, { s4[2] }, { s4[3] }};
+    for (; count >= 4; count -= 4) {
+        mode_4<D>(proc, dst, kSingleSrc ? s1 : Sk4x4f::Transpose(src->fVec), aa);
+        dst += 4;
+        src += kSingleSrc ? 0 : 4;
+        aa  += aa ? 4 : 0;
+    }
+    if (count > 0) {
+        uint32_t dstTail[4] = { 0, 0, 0, 0 };
+        SkPM4f   srcTail[4];
+        SkAlpha  aaTail[4] = { 0, 0, 0, 0 };
+        memcpy(dstTail, dst, count * sizeof(uint32_t));
+        if (!kSingleSrc) {
+            sk_bzero(srcTail, sizeof(srcTail));
+            memcpy(srcTail, src, count * sizeof(SkPM4f));
+        }
+        if (aa) {
+            memcpy(aaTail, aa, count * sizeof(SkAlpha));
+        }
+        mode_4<D>(proc, dstTail, kSingleSrc ? s1 : Sk4x4f::Transpose(srcTail->fVec),
+                  aa ? aaTail : nullptr);
+        memcpy(dst, dstTail, count * sizeof(uint32_t));
+    }
+}
+
+const SkXfermode::D32Proc gProcs_Mode[] = {
+    mode_n<kLinear_Dst, false>, mode_n<kLinear_Dst, false>,
+    mode_n<kLinear_Dst, true>,  mode_n<kLinear_Dst, true>,
+    mode_n<kSRGB_Dst, false>,   mode_n<kSRGB_Dst, false>,
+    mode_n<kSRGB_Dst, true>,    mode_n<kSRGB_Dst, true>,
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
 static void clear_linear(const SkXfermode*, uint32_t dst[], const SkPM4f[],
                            int count, const SkAlpha aa[]) {
     if (aa) {
@@ -214,6 +344,34 @@ template <DstType D> void src_1(const SkXfermode*, uint32_t dst[],
             }
         } else {    // kSRGB
             SkPMColor srcColor = store_dst<D>(s4);
+            // 4 pixels at a time, with the same math as the loop below.
+            const Sk4x4f s = {{ s4[0] }, { s4[1] }, { s4[2] }, { s4[3] }};
+            for (; count >= 4; count -= 4, dst += 4, aa += 4) {
+                uint32_t aa4;
+                memcpy(&aa4, aa, 4);
+                if (0 == aa4) {
+                    continue;
+                }
+                if (0xFFFFFFFF == aa4) {
+                    sk_memset32(dst, srcColor, 4);
+                    continue;
+                }
+                auto d = load_4_srgb(dst);
+                auto c = SkNx_cast<float>(Sk4b::Load(aa)) * (1/255.0f);
+
+                uint32_t blended[4];
+                store_4_srgb(blended, Sk4x4f{d.r + (s.r - d.r) * c,
+                                             d.g + (s.g - d.g) * c,
+                                             d.b + (s.b - d.b) * c,
+                                             d.a + (s.a - d.a) * c});
+                for (int i = 0; i < 4; ++i) {
+                    switch (aa[i]) {
+                        case 0xFF: dst[i] = srcColor;   break;
+                        case 0x00:                      break;
+                        default:   dst[i] = blended[i]; break;
+                    }
+                }
+            }
             while (count-- > 0) {
                 SkAlpha cover = *aa++;
                 switch (cover) {
@@ -349,6 +507,36 @@ static void srcover_srgb_dst_1(const SkXfermode*, uint32_t dst[],
     Sk4f dst_scale = Sk4f(1 - get_alpha(s4));
 
     if (aa) {
+        // 4 pixels at a time, with the same math as the loop below.
+        while (count >= 4) {
+            uint32_t aa4;
+            memcpy(&aa4, aa, 4);
+            if (aa4) {
+                auto d = load_4_srgb(dst);
+
+                auto cov = SkNx_cast<float>(Sk4b::Load(aa)) * (1/255.0f);
+                auto s = Sk4x4f{{ s4[0] }, { s4[1] }, { s4[2] }, { s4[3] }};
+                s.r *= cov;
+                s.g *= cov;
+                s.b *= cov;
+                s.a *= cov;
+
+                auto invSA = 1.0f - s.a;
+                uint32_t blended[4];
+                store_4_srgb(blended, Sk4x4f{s.r + d.r * invSA,
+                                             s.g + d.g * invSA,
+                                             s.b + d.b * invSA,
+                                             s.a + d.a * invSA});
+                for (int i = 0; i < 4; ++i) {
+                    if (aa[i]) {
+                        dst[i] = blended[i];
+                    }
+                }
+            }
+            count -= 4;
+            dst += 4;
+            aa += 4;
+        }
         for (int i = 0; i < count; ++i) {
             unsigned a = aa[i];
             if (0 == a) {
@@ -412,7 +600,7 @@ static SkXfermode::D32Proc find_proc(SkXfermode::Mode mode, uint32_t flags) {
         default:
             break;
     }
-    return gProcs_General[flags];
+    return gProcs_Mode[flags];
 }
 
 SkXfermode::D32Proc SkXfermode::onGetD32Proc(uint32_t flags) const {
@@ -439,6 +627,53 @@ static Sk4f lcd16_to_unit_4f(uint16_t rgb) {
     return SkNx_cast<float>(rgbi) * Sk4f(1.0f/31, 1.0f/63, 1.0f/31, 0);
 }
 
+// 4 LCD16 coverages, in the channel order of load_4_srgb() and lcd16_to_unit_4f().
+static Sk4x4f lcd16_to_unit_4x4f(const uint16_t lcd[]) {
+    Sk4i rgb = Sk4i(lcd[0], lcd[1], lcd[2], lcd[3]);
+    Sk4f r = SkNx_cast<float>((rgb >> SK_R16_SHIFT) & SK_R16_MASK) * (1.0f/31),
+         g = SkNx_cast<float>((rgb >> SK_G16_SHIFT) & SK_G16_MASK) * (1.0f/63),
+         b = SkNx_cast<float>((rgb >> SK_B16_SHIFT) & SK_B16_MASK) * (1.0f/31);
+#ifdef SK_PMCOLOR_IS_RGBA
+    return { r, g, b, 0.0f };
+#else
+    return { b, g, r, 0.0f };
+#endif
+}
+
+static bool any_lcd_4(const uint16_t lcd[]) {
+    uint64_t lcd4;
+    memcpy(&lcd4, lcd, 8);
+    return lcd4 != 0;
+}
+
+// Writes the 4 pixels in blended to dst, except those with no LCD coverage.
+static void store_covered_4(uint32_t dst[], const uint32_t blended[], const uint16_t lcd[]) {
+    for (int i = 0; i < 4; ++i) {
+        if (lcd[i]) {
+            dst[i] = blended[i];
+        }
+    }
+}
+
+// Blend 4 pixels with blend(Sk4x4f d) -> Sk4x4f, then lerp from dst towards the result by their
+// LCD coverage, with the same math as the single pixel loops below.
+template <DstType D, typename Fn>
+static void blend_4_lcd(uint32_t dst[], const uint16_t lcd[], Fn&& blend) {
+    if (!any_lcd_4(lcd)) {
+        return;
+    }
+    auto d = load_4_dst<D>(dst);
+    auto r = blend(d);
+    auto c = lcd16_to_unit_4x4f(lcd);
+
+    uint32_t blended[4];
+    store_4_dst<D>(blended, Sk4x4f{d.r + (r.r - d.r) * c.r,
+                                   d.g + (r.g - d.g) * c.g,
+                                   d.b + (r.b - d.b) * c.b,
+                                   1.0f});
+    store_covered_4(dst, blended, lcd);
+}
+
 template <DstType D>
 void src_1_lcd(uint32_t dst[], const SkPM4f* src, int count, const uint16_t lcd[]) {
     const Sk4f s4 = Sk4f::Load(src->fVec);
@@ -446,6 +681,21 @@ void src_1_lcd(uint32_t dst[], const SkPM4f* src, int count, const uint16_t lcd[
     if (D == kLinear_Dst) {
         // operate in bias-255 space for src and dst
         const Sk4f s4bias = s4 * Sk4f(255);
+        const Sk4x4f s = {{ s4bias[0] }, { s4bias[1] }, { s4bias[2] }, { s4bias[3] }};
+        for (; count >= 4; count -= 4, dst += 4, lcd += 4) {
+            if (!any_lcd_4(lcd)) {
+                continue;
+            }
+            auto d = Sk4x4f::Transpose((const uint8_t*)dst);
+            auto c = lcd16_to_unit_4x4f(lcd);
+
+            uint32_t blended[4];
+            Sk4x4f{d.r + (s.r - d.r) * c.r,
+                   d.g + (s.g - d.g) * c.g,
+                   d.b + (s.b - d.b) * c.b,
+                   255.0f}.transpose((uint8_t*)blended);
+            store_covered_4(dst, blended, lcd);
+        }
         for (int i = 0; i < count; ++i) {
             uint16_t rgb = lcd[i];
             if (0 == rgb) {
@@ -455,6 +705,10 @@ void src_1_lcd(uint32_t dst[], const SkPM4f* src, int count, const uint16_t lcd[
             dst[i] = to_4b(lerp(s4bias, d4bias, lcd16_to_unit_4f(rgb))) | (SK_A32_MASK << SK_A32_SHIFT);
         }
     } else {    // kSRGB
+        const Sk4x4f s = {{ s4[0] }, { s4[1] }, { s4[2] }, { s4[3] }};
+        for (; count >= 4; count -= 4, dst += 4, lcd += 4) {
+            blend_4_lcd<D>(dst, lcd, [&](const Sk4x4f&) { return s; });
+        }
         for (int i = 0; i < count; ++i) {
             uint16_t rgb = lcd[i];
             if (0 == rgb) {
@@ -484,6 +738,13 @@ void srcover_1_lcd(uint32_t dst[], const SkPM4f* src, int count, const uint16_t
     const Sk4f s4 = Sk4f::Load(src->fVec);
     Sk4f dst_scale = Sk4f(1 - get_alpha(s4));
 
+    const Sk4x4f s = {{ s4[0] }, { s4[1] }, { s4[2] }, { s4[3] }};
+    const Sk4f invSA = dst_scale[0];
+    for (; count >= 4; count -= 4, dst += 4, lcd += 4) {
+        blend_4_lcd<D>(dst, lcd, [&](const Sk4x4f& d) {
+            return Sk4x4f{s.r + d.r * invSA, s.g + d.g * invSA, s.b + d.b * invSA, s.a};
+        });
+    }
     for (int i = 0; i < count; ++i) {
         uint16_t rgb = lcd[i];
         if (0 == rgb) {
@@ -0,0 +1,221 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkXfermode4x4f_DEFINED
+#define SkXfermode4x4f_DEFINED
+
+#include "Sk4x4f.h"
+#include "SkXfermode.h"
+
+// Every SkXfermode::Mode as a blend of 4 premultiplied pixels at once, one Sk4f per channel, with
+// the channels in RGBA order.  The separable modes use the same formulas as the single pixel float
+// procs in SkXfermode.cpp and the non-separable ones those of the fixed point procs, but with
+// nothing left to do one pixel or one channel at a time, so every mode runs at full vector width.
+
+typedef Sk4x4f (*SkXfermodeProc4x4f)(const Sk4x4f& src, const Sk4x4f& dst);
+
+// Returns mode's blend, using Rec. 709 luminance for the non-separable modes.
+SkXfermodeProc4x4f SkXfermode_GetProc4x4f(SkXfermode::Mode mode);
+
+// Blends each channel of s and d with fn(s, sa, d, da), alpha included.
+template <typename Fn>
+static inline Sk4x4f blend_all_4x4f(const Sk4x4f& s, const Sk4x4f& d, Fn&& fn) {
+    return { fn(s.r, s.a, d.r, d.a), fn(s.g, s.a, d.g, d.a), fn(s.b, s.a, d.b, d.a),
+             fn(s.a, s.a, d.a, d.a) };
+}
+
+// Blends the color channels with fn(s, sa, d, da), and alpha as srcover.
+template <typename Fn>
+static inline Sk4x4f blend_rgb_4x4f(const Sk4x4f& s, const Sk4x4f& d, Fn&& fn) {
+    return { fn(s.r, s.a, d.r, d.a), fn(s.g, s.a, d.g, d.a), fn(s.b, s.a, d.b, d.a),
+             s.a + d.a - s.a * d.a };
+}
+
+#define XFERMODE_ALL(name, ...)                                                                 \
+    static inline Sk4x4f name##_4x4f(const Sk4x4f& src, const Sk4x4f& dst) {                   \
+        return blend_all_4x4f(src, dst, [](const Sk4f& s, const Sk4f& sa,                       \
+                                           const Sk4f& d, const Sk4f& da) { return __VA_ARGS__; });\
+    }
+#define XFERMODE_RGB(name, ...)                                                                 \
+    static inline Sk4x4f name##_4x4f(const Sk4x4f& src, const Sk4x4f& dst) {                   \
+        return blend_rgb_4x4f(src, dst, [](const Sk4f& s, const Sk4f& sa,                       \
+                                           const Sk4f& d, const Sk4f& da) { return __VA_ARGS__; });\
+    }
+
+XFERMODE_ALL(clear,    Sk4f(0))
+XFERMODE_ALL(src,      s)
+XFERMODE_ALL(dst,      d)
+XFERMODE_ALL(srcover,  s + d * (1.0f - sa))
+XFERMODE_ALL(dstover,  d + s * (1.0f - da))
+XFERMODE_ALL(srcin,    s * da)
+XFERMODE_ALL(dstin,    d * sa)
+XFERMODE_ALL(srcout,   s * (1.0f - da))
+XFERMODE_ALL(dstout,   d * (1.0f - sa))
+XFERMODE_ALL(srcatop,  s * da + d * (1.0f - sa))
+XFERMODE_ALL(dstatop,  d * sa + s * (1.0f - da))
+XFERMODE_ALL(xor,      s * (1.0f - da) + d * (1.0f - sa))
+XFERMODE_ALL(plus,     Sk4f::Min(s + d, Sk4f(1)))
+XFERMODE_ALL(modulate, s * d)
+XFERMODE_ALL(screen,   s + d - s * d)
+XFERMODE_ALL(multiply, s * (1.0f - da) + d * (1.0f - sa) + s * d)
+XFERMODE_ALL(darken,   s + d - Sk4f::Max(s * da, d * sa))
+XFERMODE_ALL(lighten,  s + d - Sk4f::Min(s * da, d * sa))
+
+static inline Sk4f overlay_channel_4x4f(const Sk4f& s, const Sk4f& sa,
+                                        const Sk4f& d, const Sk4f& da) {
+    Sk4f rc = (2.0f * d <= da).thenElse(2.0f * s * d, sa * da - 2.0f * (da - d) * (sa - s));
+    return Sk4f::Min(s + d - s * da + rc - d * sa, Sk4f(1));
+}
+
+XFERMODE_RGB(overlay,    overlay_channel_4x4f(s, sa, d, da))
+XFERMODE_RGB(hardlight,  overlay_channel_4x4f(d, da, s, sa))
+XFERMODE_RGB(difference, s + d - 2.0f * Sk4f::Min(s * da, d * sa))
+XFERMODE_RGB(exclusion,  s + d - 2.0f * s * d)
+
+// Order matters in the next two, preferring d==0 over s==sa, and d==da over s==0.
+XFERMODE_RGB(colordodge,
+             (d == Sk4f(0)).thenElse(d + s * (1.0f - da),
+                                     (s == sa).thenElse(s + d * (1.0f - sa),
+                                                        sa * Sk4f::Min(da, (d * sa) / (sa - s))
+                                                           + s * (1.0f - da) + d * (1.0f - sa))))
+XFERMODE_RGB(colorburn,
+             (d == da).thenElse(d + s * (1.0f - da),
+                                (s == Sk4f(0)).thenElse(s + d * (1.0f - sa),
+                                                        sa * (da - Sk4f::Min(da, (da - d) * sa / s))
+                                                           + s * (1.0f - da) + d * (1.0f - sa))))
+
+static inline Sk4f softlight_channel_4x4f(const Sk4f& s, const Sk4f& sa,
+                                          const Sk4f& d, const Sk4f& da) {
+    Sk4f m  = (da > Sk4f(0)).thenElse(d / da, Sk4f(0)),
+         s2 = 2.0f * s,
+         m4 = 4.0f * m;
+
+    // The logic forks three ways:
+    //    1. dark src?
+    //    2. light src, dark dst?
+    //    3. light src, light dst?
+    Sk4f darkSrc = d * (sa + (s2 - sa) * (1.0f - m)),           // Used in case 1.
+         darkDst = (m4 * m4 + m4) * (m - 1.0f) + 7.0f * m,    // Used in case 2.
+         liteDst = m.sqrt() - m,                              // Used in case 3.
+         liteSrc = d * sa + da * (s2 - sa) * (4.0f * d <= da).thenElse(darkDst, liteDst);
+
+    return s * (1.0f - da) + d * (1.0f - sa) + (s2 <= sa).thenElse(darkSrc, liteSrc);
+}
+
+XFERMODE_RGB(softlight, softlight_channel_4x4f(s, sa, d, da))
+
+#undef XFERMODE_ALL
+#undef XFERMODE_RGB
+
+// The non-separable modes, from the CSS compositing spec, done as in the fixed point procs.
+// Which luminance they use is up to the caller: the float pipelines use Rec. 709, and the
+// legacy 8888 pipeline Rec. 601 to match its fixed point procs.
+struct SkLum709_4x4f {
+    static Sk4f Of(const Sk4f& r, const Sk4f& g, const Sk4f& b) {
+        return r * 0.2126f + g * 0.7152f + b * 0.0722f;
+    }
+};
+struct SkLum601_4x4f {
+    static Sk4f Of(const Sk4f& r, const Sk4f& g, const Sk4f& b) {
+        return r * (77/255.0f) + g * (150/255.0f) + b * (28/255.0f);
+    }
+};
+
+static inline Sk4f min3_4x4f(const Sk4f& r, const Sk4f& g, const Sk4f& b) {
+    return Sk4f::Min(r, Sk4f::Min(g, b));
+}
+static inline Sk4f max3_4x4f(const Sk4f& r, const Sk4f& g, const Sk4f& b) {
+    return Sk4f::Max(r, Sk4f::Max(g, b));
+}
+static inline Sk4f sat_4x4f(const Sk4f& r, const Sk4f& g, const Sk4f& b) {
+    return max3_4x4f(r, g, b) - min3_4x4f(r, g, b);
+}
+
+// Gives r,g,b saturation sat, keeping their hue.
+static inline void set_sat_4x4f(Sk4f* r, Sk4f* g, Sk4f* b, const Sk4f& sat) {
+    Sk4f mn = min3_4x4f(*r, *g, *b),
+         mx = max3_4x4f(*r, *g, *b),
+         scale = (mx > mn).thenElse(sat / (mx - mn), Sk4f(0));
+    *r = (*r - mn) * scale;
+    *g = (*g - mn) * scale;
+    *b = (*b - mn) * scale;
+}
+
+// Gives r,g,b luminance lum, then pulls any out of [0,a] back in towards gray.
+template <typename Lum>
+static inline void set_lum_4x4f(Sk4f* r, Sk4f* g, Sk4f* b, const Sk4f& a, const Sk4f& lum) {
+    Sk4f diff = lum - Lum::Of(*r, *g, *b);
+    Sk4f R = *r + diff,
+         G = *g + diff,
+         B = *b + diff;
+
+    Sk4f L  = Lum::Of(R, G, B),
+         mn = min3_4x4f(R, G, B),
+         mx = max3_4x4f(R, G, B);
+    Sk4f lo = (mn < Sk4f(0)).thenElse((L > mn).thenElse(L / (L - mn), Sk4f(1)), Sk4f(1)),
+         hi = (mx >      a).thenElse((mx > L).thenElse((a - L) / (mx - L), Sk4f(1)), Sk4f(1)),
+         scale = lo * hi;
+    *r = L + (R - L) * scale;
+    *g = L + (G - L) * scale;
+    *b = L + (B - L) * scale;
+}
+
+// Combines the blended colors R,G,B (zero unless both alphas are non-zero) with src and dst.
+static inline Sk4x4f nonseparable_4x4f(const Sk4x4f& s, const Sk4x4f& d,
+                                       const Sk4f& R, const Sk4f& G, const Sk4f& B) {
+    Sk4f isa = 1.0f - s.a,
+         ida = 1.0f - d.a;
+    auto both = s.a * d.a > Sk4f(0);
+    return {
+        Sk4f::Max(s.r * ida + d.r * isa + both.thenElse(R, Sk4f(0)), Sk4f(0)),
+        Sk4f::Max(s.g * ida + d.g * isa + both.thenElse(G, Sk4f(0)), Sk4f(0)),
+        Sk4f::Max(s.b * ida + d.b * isa + both.thenElse(B, Sk4f(0)), Sk4f(0)),
+        s.a + d.a - s.a * d.a,
+    };
+}
+
+// The hue of the source with the saturation and luminosity of the destination.
+template <typename Lum>
+static inline Sk4x4f hue_4x4f(const Sk4x4f& s, const Sk4x4f& d) {
+    Sk4f R = s.r, G = s.g, B = s.b;
+    set_sat_4x4f(&R, &G, &B, sat_4x4f(d.r, d.g, d.b) * s.a);
+    set_lum_4x4f<Lum>(&R, &G, &B, s.a * d.a, Lum::Of(d.r, d.g, d.b) * s.a);
+    return nonseparable_4x4f(s, d, R, G, B);
+}
+
+// The saturation of the source with the hue and luminosity of the destination.
+template <typename Lum>
+static inline Sk4x4f saturation_4x4f(const Sk4x4f& s, const Sk4x4f& d) {
+    Sk4f R = d.r, G = d.g, B = d.b;
+    set_sat_4x4f(&R, &G, &B, sat_4x4f(s.r, s.g, s.b) * d.a);
+    set_lum_4x4f<Lum>(&R, &G, &B, s.a * d.a, Lum::Of(d.r, d.g, d.b) * s.a);
+    return nonseparable_4x4f(s, d, R, G, B);
+}
+
+// The hue and saturation of the source with the luminosity of the destination.
+template <typename Lum>
+static inline Sk4x4f color_4x4f(const Sk4x4f& s, const Sk4x4f& d) {
+    Sk4f R = s.r * d.a, G = s.g * d.a, B = s.b * d.a;
+    set_lum_4x4f<Lum>(&R, &G, &B, s.a * d.a, Lum::Of(d.r, d.g, d.b) * s.a);
+    return nonseparable_4x4f(s, d, R, G, B);
+}
+
+// The luminosity of the source with the hue and saturation of the destination.
+template <typename Lum>
+static inline Sk4x4f luminosity_4x4f(const Sk4x4f& s, const Sk4x4f& d) {
+    Sk4f R = d.r * s.a, G = d.g * s.a, B = d.b * s.a;
+    set_lum_4x4f<Lum>(&R, &G, &B, s.a * d.a, Lum::Of(s.r, s.g, s.b) * d.a);
+    return nonseparable_4x4f(s, d, R, G, B);
+}
+
+// Pins each channel of p to [0,1], as the stores from float to 8888 or F16 need.
+static inline Sk4x4f pin_4x4f(const Sk4x4f& p) {
+    auto pin = [](const Sk4f& x) { return Sk4f::Min(Sk4f::Max(x, Sk4f(0)), Sk4f(1)); };
+    return { pin(p.r), pin(p.g), pin(p.b), pin(p.a) };
+}
+
+#endif//SkXfermode4x4f_DEFINED
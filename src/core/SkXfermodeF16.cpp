@@ -9,6 +9,7 @@
 #include "SkPM4fPriv.h"
 #include "SkUtils.h"
 #include "SkXfermode.h"
+#include "SkXfermode4x4f.h"
 
 static Sk4f lerp_by_coverage(const Sk4f& src, const Sk4f& dst, uint8_t srcCoverage) {
     return dst + (src - dst) * Sk4f(srcCoverage * (1/255.0f));
@@ -60,6 +61,75 @@ const SkXfermode::F16Proc gProcs_General[] = { xfer_n, xfer_n, xfer_1, xfer_1 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Blend 4 pixels with proc, then lerp from dst towards the result by their coverage, leaving the
+// pixels with no coverage alone.
+static void mode_4(SkXfermodeProc4x4f proc, uint64_t dst[], const Sk4x4f& s, const SkAlpha aa[]) {
+    if (aa) {
+        uint32_t aa4;
+        memcpy(&aa4, aa, 4);
+        if (0 == aa4) {
+            return;
+        }
+    }
+    auto d = Sk4x4f::Transpose(SkHalfToFloat_01(dst[0]), SkHalfToFloat_01(dst[1]),
+                               SkHalfToFloat_01(dst[2]), SkHalfToFloat_01(dst[3]));
+    auto r = proc(s, d);
+    if (aa) {
+        auto c = SkNx_cast<float>(Sk4b::Load(aa)) * (1/255.0f);
+        r = Sk4x4f{d.r + (r.r - d.r) * c,
+                   d.g + (r.g - d.g) * c,
+                   d.b + (r.b - d.b) * c,
+                   d.a + (r.a - d.a) * c};
+    }
+    Sk4f r4[4];
+    pin_4x4f(r).transpose(r4+0, r4+1, r4+2, r4+3);
+    for (int i = 0; i < 4; ++i) {
+        if (!aa || aa[i]) {
+            dst[i] = SkFloatToHalf_01(r4[i]);
+        }
+    }
+}
+
+// Any mode, 4 pixels at a time.  The last 1-3 pixels are blended as 4 from a padded copy.
+template <bool kSingleSrc>
+void mode_n(const SkXfermode* xfer, uint64_t dst[], const SkPM4f src[], int count,
+            const SkAlpha aa[]) {
+    SkXfermode::Mode mode;
+    SkAssertResult(xfer->asMode(&mode));
+    const SkXfermodeProc4x4f proc = SkXfermode_GetProc4x4f(mode);
+
+    const Sk4f s4 = Sk4f::Load(src->fVec);
+    const Sk4x4f s1 = {{ s4[0] }, { s4[1] }, { s4[2] }, { s4[3] }};
+    for (; count >= 4; count -= 4) {
+        mode_4(proc, dst, kSingleSrc ? s1 : Sk4x4f::Transpose(src->fVec), aa);
+        dst += 4;
+        src += kSingleSrc ? 0 : 4;
+        aa  += aa ? 4 : 0;
+    }
+    if (count > 0) {
+        uint64_t dstTail[4] = { 0, 0, 0, 0 };
+        SkPM4f   srcTail[4];
+        SkAlpha  aaTail[4] = { 0, 0, 0, 0 };
+        memcpy(dstTail, dst, count * sizeof(uint64_t));
+        if (!kSingleSrc) {
+            sk_bzero(srcTail, sizeof(srcTail));
+            memcpy(srcTail, src, count * sizeof(SkPM4f));
+        }
+        if (aa) {
+            memcpy(aaTail, aa, count * sizeof(SkAlpha));
+        }
+        mode_4(proc, dstTail, kSingleSrc ? s1 : Sk4x4f::Transpose(srcTail->fVec),
+               aa ? aaTail : nullptr);
+        memcpy(dst, dstTail, count * sizeof(uint64_t));
+    }
+}
+
+const SkXfermode::F16Proc gProcs_Mode[] = {
+    mode_n<false>, mode_n<false>, mode_n<true>, mode_n<true>,
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
 static void clear(const SkXfermode*, uint64_t dst[], const SkPM4f*, int count, const SkAlpha aa[]) {
     if (aa) {
         for (int i = 0; i < count; ++i) {
@@ -120,13 +190,20 @@ static void srcover_1(const SkXfermode*, uint64_t dst[], const SkPM4f* src, int
                       const SkAlpha aa[]) {
     const Sk4f s4 = Sk4f::Load(src->fVec);
     const Sk4f dst_scale = Sk4f(1 - get_alpha(s4));
-    for (int i = 0; i < count; ++i) {
-        const Sk4f d4 = SkHalfToFloat_01(dst[i]);
-        const Sk4f r4 = s4 + d4 * dst_scale;
-        if (aa) {
+    if (aa) {
+        // Masks (text especially) are mostly uncovered, so skip those pixels entirely.
+        for (int i = 0; i < count; ++i) {
+            if (0 == aa[i]) {
+                continue;
+            }
+            const Sk4f d4 = SkHalfToFloat_01(dst[i]);
+            const Sk4f r4 = s4 + d4 * dst_scale;
             dst[i] = SkFloatToHalf_01(lerp_by_coverage(r4, d4, aa[i]));
-        } else {
-            dst[i] = SkFloatToHalf_01(r4);
+        }
+    } else {
+        for (int i = 0; i < count; ++i) {
+            const Sk4f d4 = SkHalfToFloat_01(dst[i]);
+            dst[i] = SkFloatToHalf_01(s4 + d4 * dst_scale);
         }
     }
 }
@@ -160,7 +237,7 @@ static SkXfermode::F16Proc find_proc(SkXfermode::Mode mode, uint32_t flags) {
         default:
             break;
     }
-    return gProcs_General[flags];
+    return gProcs_Mode[flags];
 }
 
 SkXfermode::F16Proc SkXfermode::onGetF16Proc(uint32_t flags) const {
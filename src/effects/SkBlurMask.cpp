@@ -8,6 +8,7 @@
 
 #include "SkBlurMask.h"
 #include "SkMath.h"
+#include "SkNx.h"
 #include "SkTemplates.h"
 #include "SkEndian.h"
 
@@ -405,6 +406,279 @@ static int boxBlurInterp(const uint8_t* src, int src_y_stride, uint8_t* dst,
     return new_width;
 }
 
+/**
+ * The functions below blur down the columns of an image rather than along its
+ * rows: each output row is a running sum of input rows, so we can work on
+ * sixteen neighboring pixels at a time with Sk16h.  To blur along rows,
+ * BoxBlur() transposes the image first.  The results match boxBlur() and
+ * boxBlurInterp() exactly, quirks and all, just with X and Y swapped.
+ *
+ * The sums are kept in 16 bits, so kernels can be at most kMaxColumnKernel
+ * wide.  The dst rows are width bytes apart.  sums holds width running sums,
+ * and zeros is a row of width zeros to stand in for rows beyond the top and
+ * bottom.
+ */
+static const int kMaxColumnKernel = 0xFFFF / 255;
+
+/**
+ * The scalar code computes (sum * scale + (1 << 23)) >> 24 with a 24-bit
+ * scale.  Splitting scale into its high and low 16 bits, that's
+ * (sum * hi + mulHi(sum, lo) + 128) >> 8, dropping only the low 16 bits of
+ * sum * lo, which can't carry into the result.  None of it overflows 16 bits,
+ * because the result fits in 8.
+ */
+struct ColumnScale {
+    explicit ColumnScale(uint32_t scale) : fHi(scale >> 16), fLo(scale & 0xFFFF) {}
+
+    Sk16h fHi, fLo;
+};
+
+static int boxBlurY(const uint8_t* src, int srcRowBytes, uint8_t* dst,
+                    int topRadius, int bottomRadius, int width, int height,
+                    uint16_t* sums, const uint8_t* zeros) {
+    int diameter = topRadius + bottomRadius;
+    int kernelSize = diameter + 1;
+    SkASSERT(kernelSize <= kMaxColumnKernel);
+    uint32_t scale = (1 << 24) / kernelSize;
+    uint32_t half = 1 << 23;
+    const ColumnScale vscale(scale);
+    int new_height = height + SkMax32(topRadius, bottomRadius) * 2;
+    int offset = SkMax32(0, bottomRadius - topRadius);
+    auto row = [=](int y) { return 0 <= y && y < height ? src + y * srcRowBytes : zeros; };
+
+    sk_bzero(sums, width * sizeof(uint16_t));
+    for (int y = 0; y < new_height; ++y) {
+        // Add the row entering the kernel, and remove the row leaving it.
+        const uint8_t* enter = row(y - offset);
+        const uint8_t* leave = row(y - offset - kernelSize);
+        uint8_t* dptr = dst + y * width;
+        int x = 0;
+        for (; x + 16 <= width; x += 16) {
+            Sk16h sum = Sk16h::Load(sums + x) + SkNx_cast<uint16_t>(Sk16b::Load(enter + x))
+                                              - SkNx_cast<uint16_t>(Sk16b::Load(leave + x));
+            sum.store(sums + x);
+            Sk16h blur = (sum * vscale.fHi + sum.mulHi(vscale.fLo) + Sk16h(128)) >> 8;
+            SkNx_cast<uint8_t>(blur).store(dptr + x);
+        }
+        for (; x < width; ++x) {
+            sums[x] += enter[x] - leave[x];
+            dptr[x] = (sums[x] * scale + half) >> 24;
+        }
+    }
+    return new_height;
+}
+
+static int boxBlurInterpY(const uint8_t* src, int srcRowBytes, uint8_t* dst,
+                          int radius, int width, int height, uint8_t outer_weight,
+                          uint16_t* sums, const uint8_t* zeros) {
+    int diameter = radius * 2;
+    int kernelSize = diameter + 1;
+    SkASSERT(kernelSize <= kMaxColumnKernel);
+    int inner_weight = 255 - outer_weight;
+    outer_weight += outer_weight >> 7;
+    inner_weight += inner_weight >> 7;
+    uint32_t outer_scale = (outer_weight << 16) / kernelSize;
+    uint32_t inner_scale = (inner_weight << 16) / (kernelSize - 2);
+    uint32_t half = 1 << 23;
+    const ColumnScale vouter(outer_scale), vinner(inner_scale);
+    int new_height = height + diameter;
+    auto row = [=](int y) { return 0 <= y && y < height ? src + y * srcRowBytes : zeros; };
+
+    sk_bzero(sums, width * sizeof(uint16_t));
+    for (int y = 0; y < new_height; ++y) {
+        // The outer sum covers rows y - diameter to y, the inner sum all of those but the
+        // two ends.  Past the bottom of a short image, boxBlurInterp() leaves the inner sum
+        // short its last row; we do the same, which is why the inner sum subtracts "last".
+        const uint8_t* enter = row(y);
+        const uint8_t* leave = row(y - kernelSize);
+        const uint8_t* first = row(y - diameter);
+        const uint8_t* last = height <= y && y < diameter ? row(height - 1) : enter;
+        uint8_t* dptr = dst + y * width;
+        int x = 0;
+        for (; x + 16 <= width; x += 16) {
+            Sk16h outer = Sk16h::Load(sums + x) + SkNx_cast<uint16_t>(Sk16b::Load(enter + x))
+                                                - SkNx_cast<uint16_t>(Sk16b::Load(leave + x));
+            Sk16h inner = outer - SkNx_cast<uint16_t>(Sk16b::Load(first + x))
+                                - SkNx_cast<uint16_t>(Sk16b::Load(last + x));
+            outer.store(sums + x);
+            // As in ColumnScale, but the two dropped low halves can carry once between them.
+            Sk16h outerLo = outer * vouter.fLo,
+                  innerLo = inner * vinner.fLo;
+            Sk16h carry = ((outerLo >> 1) + (innerLo >> 1) + (outerLo & innerLo & Sk16h(1))) >> 15;
+            Sk16h blur = (outer * vouter.fHi + outer.mulHi(vouter.fLo) +
+                          inner * vinner.fHi + inner.mulHi(vinner.fLo) + carry + Sk16h(128)) >> 8;
+            SkNx_cast<uint8_t>(blur).store(dptr + x);
+        }
+        for (; x < width; ++x) {
+            sums[x] += enter[x] - leave[x];
+            uint32_t outer_sum = sums[x],
+                     inner_sum = outer_sum - first[x] - last[x];
+            dptr[x] = (outer_sum * outer_scale + inner_sum * inner_scale + half) >> 24;
+        }
+    }
+    return new_height;
+}
+
+// Transposes the 8x8 block of bytes at src into dst.
+static inline void transpose8x8(const uint8_t* src, int srcRowBytes,
+                                uint8_t* dst, int dstRowBytes) {
+#ifdef SK_CPU_BENDIAN
+    // The shuffling below expects byte j of each row in bits 8j to 8j+7.
+    for (int y = 0; y < 8; ++y) {
+        for (int x = 0; x < 8; ++x) {
+            dst[x * dstRowBytes + y] = src[y * srcRowBytes + x];
+        }
+    }
+    return;
+#endif
+    uint64_t r[8];
+    for (int i = 0; i < 8; ++i) {
+        memcpy(&r[i], src + i * srcRowBytes, 8);
+    }
+    // Swap the off-diagonal 4x4 blocks, then the 2x2 blocks within those, then single bytes.
+    // Each step trades the upper half of one row's blocks for the lower half of another's.
+    auto swap = [&r](int i, int j, int bits, uint64_t mask) {
+        uint64_t t = ((r[i] >> bits) ^ r[j]) & mask;
+        r[i] ^= t << bits;
+        r[j] ^= t;
+    };
+    for (int i : { 0, 1, 2, 3 }) { swap(i, i + 4, 32, 0x00000000FFFFFFFFull); }
+    for (int i : { 0, 1, 4, 5 }) { swap(i, i + 2, 16, 0x0000FFFF0000FFFFull); }
+    for (int i : { 0, 2, 4, 6 }) { swap(i, i + 1,  8, 0x00FF00FF00FF00FFull); }
+    for (int i = 0; i < 8; ++i) {
+        memcpy(dst + i * dstRowBytes, &r[i], 8);
+    }
+}
+
+// Writes the width x height image src to dst, which will be height x width.
+static void transpose(const uint8_t* src, int srcRowBytes, uint8_t* dst, int width, int height) {
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        int y = 0;
+        for (; y + 8 <= height; y += 8) {
+            transpose8x8(src + y * srcRowBytes + x, srcRowBytes, dst + x * height + y, height);
+        }
+        for (; y < height; ++y) {
+            for (int i = x; i < x + 8; ++i) {
+                dst[i * height + y] = src[y * srcRowBytes + i];
+            }
+        }
+    }
+    for (; x < width; ++x) {
+        for (int y = 0; y < height; ++y) {
+            dst[x * height + y] = src[y * srcRowBytes + x];
+        }
+    }
+}
+
+/**
+ * For very large sigmas, BoxBlur() shrinks the mask by a power of two, blurs
+ * that with a proportionally smaller sigma, and scales the blur back up.  A
+ * blur that wide has no detail finer than the factor for us to lose.  Below
+ * kMaxDirectSigma the column blurs are faster than the round trip; past it,
+ * the high quality kernels no longer fit their 16-bit sums.
+ */
+static const SkScalar kMaxDirectSigma = 128;
+
+// Averages each 2^shift x 2^shift block of src into one pixel of dst, padding src with zeros.
+static void downsample(const uint8_t* src, int srcRowBytes, int width, int height, int shift,
+                       uint8_t* dst, int dstWidth, int dstHeight) {
+    SkAutoTMalloc<uint32_t> sums(dstWidth);
+    for (int y = 0; y < dstHeight; ++y) {
+        sk_bzero(sums.get(), dstWidth * sizeof(uint32_t));
+        for (int sy = y << shift; sy < SkMin32((y + 1) << shift, height); ++sy) {
+            const uint8_t* sptr = src + sy * srcRowBytes;
+            for (int x = 0; x < width; ++x) {
+                sums[x >> shift] += sptr[x];
+            }
+        }
+        for (int x = 0; x < dstWidth; ++x) {
+            dst[y * dstWidth + x] = (sums[x] + (1 << (2 * shift - 1))) >> (2 * shift);
+        }
+    }
+}
+
+// Finds where pixel x of an image scaled up by 2^shift samples the original, as the
+// original's pixel to the left and the weight (out of 256) of the one to its right.
+static void upsample_coord(int x, int dstPad, int srcPad, int shift, int* left, int* weight) {
+    SkScalar u = (x + 0.5f - dstPad) / (1 << shift) + srcPad - 0.5f;
+    *left = SkScalarFloorToInt(u);
+    *weight = SkScalarRoundToInt((u - *left) * 256);
+}
+
+/**
+ * Bilinearly scales up src, a mask blurred with margins srcPadX and srcPadY,
+ * by 2^shift into dst, which has margins dstPadX and dstPadY.  src is taken
+ * to be zero beyond its edges.
+ */
+static void upsample(const uint8_t* src, int srcWidth, int srcHeight, int srcPadX, int srcPadY,
+                     int shift, uint8_t* dst, int dstWidth, int dstHeight,
+                     int dstPadX, int dstPadY) {
+    // Each dst row first blends two src rows into row, which keeps a zero at each end, so
+    // every dst pixel can read two neighbors there with no further checks.
+    SkAutoTMalloc<uint16_t> row(srcWidth + 3);
+    row[0] = row[srcWidth + 1] = row[srcWidth + 2] = 0;
+    SkAutoTMalloc<int> lefts(dstWidth), weights(dstWidth);
+    for (int x = 0; x < dstWidth; ++x) {
+        int left, weight;
+        upsample_coord(x, dstPadX, srcPadX, shift, &left, &weight);
+        if (left < -1) {
+            left = -1;
+            weight = 0;
+        }
+        lefts[x] = SkMin32(left, srcWidth) + 1;
+        weights[x] = weight;
+    }
+
+    SkAutoTMalloc<uint8_t> zeros(srcWidth);
+    sk_bzero(zeros.get(), srcWidth);
+    auto srcRow = [&](int y) { return 0 <= y && y < srcHeight ? src + y * srcWidth : zeros.get(); };
+
+    for (int y = 0; y < dstHeight; ++y) {
+        int top, wy;
+        upsample_coord(y, dstPadY, srcPadY, shift, &top, &wy);
+        const uint8_t* upper = srcRow(top);
+        const uint8_t* lower = srcRow(top + 1);
+        for (int x = 0; x < srcWidth; ++x) {
+            row[x + 1] = upper[x] * (256 - wy) + lower[x] * wy;
+        }
+        uint8_t* dptr = dst + y * dstWidth;
+        for (int x = 0; x < dstWidth; ++x) {
+            const uint16_t* r = row.get() + lefts[x];
+            uint32_t wx = weights[x];
+            dptr[x] = (r[0] * (256 - wx) + r[1] * wx + (1 << 15)) >> 16;
+        }
+    }
+}
+
+/**
+ * Blurs src into dst by way of a copy shrunk by 2^shift.  dst has the size
+ * and margins that BoxBlur() gave it for the full sigma.
+ */
+static bool blur_downsampled(const SkMask& src, SkScalar sigma, SkBlurQuality quality, int shift,
+                             uint8_t* dst, int dstWidth, int dstHeight, int padX, int padY) {
+    SkMask small;
+    small.fFormat = SkMask::kA8_Format;
+    small.fBounds.set(0, 0, (src.fBounds.width()  + (1 << shift) - 1) >> shift,
+                            (src.fBounds.height() + (1 << shift) - 1) >> shift);
+    small.fRowBytes = small.fBounds.width();
+    small.fImage = SkMask::AllocImage(small.computeImageSize());
+    SkAutoMaskFreeImage autoSmall(small.fImage);
+    downsample(src.fImage, src.fRowBytes, src.fBounds.width(), src.fBounds.height(), shift,
+               small.fImage, small.fBounds.width(), small.fBounds.height());
+
+    SkMask blurred;
+    SkIPoint margin;
+    if (!SkBlurMask::BoxBlur(&blurred, small, sigma / (1 << shift), kNormal_SkBlurStyle,
+                             quality, &margin, true)) {
+        return false;
+    }
+    SkAutoMaskFreeImage autoBlurred(blurred.fImage);
+    upsample(blurred.fImage, blurred.fBounds.width(), blurred.fBounds.height(),
+             margin.fX, margin.fY, shift, dst, dstWidth, dstHeight, padX, padY);
+    return true;
+}
+
 static void get_adjusted_radii(SkScalar passRadius, int *loRadius, int *hiRadius)
 {
     *loRadius = *hiRadius = SkScalarCeilToInt(passRadius);
@@ -548,35 +822,96 @@ bool SkBlurMask::BoxBlur(SkMask* dst, const SkMask& src,
         uint8_t*                tp = tmpBuffer.get();
         int w = sw, h = sh;
 
-        if (outerWeight == 255) {
-            int loRadius, hiRadius;
-            get_adjusted_radii(passRadius, &loRadius, &hiRadius);
-            if (kHigh_SkBlurQuality == quality) {
-                // Do three X blurs, with a transpose on the final one.
-                w = boxBlur(sp, src.fRowBytes, tp, loRadius, hiRadius, w, h, false);
-                w = boxBlur(tp, w,             dp, hiRadius, loRadius, w, h, false);
-                w = boxBlur(dp, w,             tp, hiRadius, hiRadius, w, h, true);
-                // Do three Y blurs, with a transpose on the final one.
-                h = boxBlur(tp, h,             dp, loRadius, hiRadius, h, w, false);
-                h = boxBlur(dp, h,             tp, hiRadius, loRadius, h, w, false);
-                h = boxBlur(tp, h,             dp, hiRadius, hiRadius, h, w, true);
+        if (!force_quality && kHigh_SkBlurQuality == quality &&
+            sigma > kMaxDirectSigma) {
+            int shift = 1;
+            while (sigma > kMaxDirectSigma * (1 << shift)) {
+                ++shift;
+            }
+            if (!blur_downsampled(src, sigma, quality, shift, dp,
+                                  dst->fBounds.width(), dst->fBounds.height(), padx, pady)) {
+                return false;
+            }
+        } else if (2 * SkMax32(rx, ry) + 1 <= kMaxColumnKernel) {
+            // Scratch for the column blurs, which work on the image transposed for the X passes.
+            int maxWidth = SkMax32(dst->fBounds.width(), dst->fBounds.height());
+            SkAutoTMalloc<uint16_t> sums(maxWidth);
+            SkAutoTMalloc<uint8_t> zeros(maxWidth);
+            sk_bzero(zeros.get(), maxWidth);
+
+            // Transposed, the X blurs run down the columns too.
+            transpose(sp, src.fRowBytes, tp, w, h);
+            SkTSwap(w, h);
+            if (outerWeight == 255) {
+                int loRadius, hiRadius;
+                get_adjusted_radii(passRadius, &loRadius, &hiRadius);
+                if (kHigh_SkBlurQuality == quality) {
+                    // Do three X blurs, then transpose back.
+                    h = boxBlurY(tp, w, dp, loRadius, hiRadius, w, h, sums, zeros);
+                    h = boxBlurY(dp, w, tp, hiRadius, loRadius, w, h, sums, zeros);
+                    h = boxBlurY(tp, w, dp, hiRadius, hiRadius, w, h, sums, zeros);
+                    transpose(dp, w, tp, w, h);
+                    SkTSwap(w, h);
+                    // Do three Y blurs.
+                    h = boxBlurY(tp, w, dp, loRadius, hiRadius, w, h, sums, zeros);
+                    h = boxBlurY(dp, w, tp, hiRadius, loRadius, w, h, sums, zeros);
+                    h = boxBlurY(tp, w, dp, hiRadius, hiRadius, w, h, sums, zeros);
+                } else {
+                    h = boxBlurY(tp, w, dp, rx, rx, w, h, sums, zeros);
+                    transpose(dp, w, tp, w, h);
+                    SkTSwap(w, h);
+                    h = boxBlurY(tp, w, dp, ry, ry, w, h, sums, zeros);
+                }
             } else {
-                w = boxBlur(sp, src.fRowBytes, tp, rx, rx, w, h, true);
-                h = boxBlur(tp, h,             dp, ry, ry, h, w, true);
+                if (kHigh_SkBlurQuality == quality) {
+                    // Do three X blurs, then transpose back.
+                    h = boxBlurInterpY(tp, w, dp, rx, w, h, outerWeight, sums, zeros);
+                    h = boxBlurInterpY(dp, w, tp, rx, w, h, outerWeight, sums, zeros);
+                    h = boxBlurInterpY(tp, w, dp, rx, w, h, outerWeight, sums, zeros);
+                    transpose(dp, w, tp, w, h);
+                    SkTSwap(w, h);
+                    // Do three Y blurs.
+                    h = boxBlurInterpY(tp, w, dp, ry, w, h, outerWeight, sums, zeros);
+                    h = boxBlurInterpY(dp, w, tp, ry, w, h, outerWeight, sums, zeros);
+                    h = boxBlurInterpY(tp, w, dp, ry, w, h, outerWeight, sums, zeros);
+                } else {
+                    h = boxBlurInterpY(tp, w, dp, rx, w, h, outerWeight, sums, zeros);
+                    transpose(dp, w, tp, w, h);
+                    SkTSwap(w, h);
+                    h = boxBlurInterpY(tp, w, dp, ry, w, h, outerWeight, sums, zeros);
+                }
             }
         } else {
-            if (kHigh_SkBlurQuality == quality) {
-                // Do three X blurs, with a transpose on the final one.
-                w = boxBlurInterp(sp, src.fRowBytes, tp, rx, w, h, false, outerWeight);
-                w = boxBlurInterp(tp, w,             dp, rx, w, h, false, outerWeight);
-                w = boxBlurInterp(dp, w,             tp, rx, w, h, true, outerWeight);
-                // Do three Y blurs, with a transpose on the final one.
-                h = boxBlurInterp(tp, h,             dp, ry, h, w, false, outerWeight);
-                h = boxBlurInterp(dp, h,             tp, ry, h, w, false, outerWeight);
-                h = boxBlurInterp(tp, h,             dp, ry, h, w, true, outerWeight);
+            if (outerWeight == 255) {
+                int loRadius, hiRadius;
+                get_adjusted_radii(passRadius, &loRadius, &hiRadius);
+                if (kHigh_SkBlurQuality == quality) {
+                    // Do three X blurs, with a transpose on the final one.
+                    w = boxBlur(sp, src.fRowBytes, tp, loRadius, hiRadius, w, h, false);
+                    w = boxBlur(tp, w,             dp, hiRadius, loRadius, w, h, false);
+                    w = boxBlur(dp, w,             tp, hiRadius, hiRadius, w, h, true);
+                    // Do three Y blurs, with a transpose on the final one.
+                    h = boxBlur(tp, h,             dp, loRadius, hiRadius, h, w, false);
+                    h = boxBlur(dp, h,             tp, hiRadius, loRadius, h, w, false);
+                    h = boxBlur(tp, h,             dp, hiRadius, hiRadius, h, w, true);
+                } else {
+                    w = boxBlur(sp, src.fRowBytes, tp, rx, rx, w, h, true);
+                    h = boxBlur(tp, h,             dp, ry, ry, h, w, true);
+                }
             } else {
-                w = boxBlurInterp(sp, src.fRowBytes, tp, rx, w, h, true, outerWeight);
-                h = boxBlurInterp(tp, h,             dp, ry, h, w, true, outerWeight);
+                if (kHigh_SkBlurQuality == quality) {
+                    // Do three X blurs, with a transpose on the final one.
+                    w = boxBlurInterp(sp, src.fRowBytes, tp, rx, w, h, false, outerWeight);
+                    w = boxBlurInterp(tp, w,             dp, rx, w, h, false, outerWeight);
+                    w = boxBlurInterp(dp, w,             tp, rx, w, h, true, outerWeight);
+                    // Do three Y blurs, with a transpose on the final one.
+                    h = boxBlurInterp(tp, h,             dp, ry, h, w, false, outerWeight);
+                    h = boxBlurInterp(dp, h,             tp, ry, h, w, false, outerWeight);
+                    h = boxBlurInterp(tp, h,             dp, ry, h, w, true, outerWeight);
+                } else {
+                    w = boxBlurInterp(sp, src.fRowBytes, tp, rx, w, h, true, outerWeight);
+                    h = boxBlurInterp(tp, h,             dp, ry, h, w, true, outerWeight);
+                }
             }
         }
 
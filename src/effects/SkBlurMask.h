@@ -28,7 +28,8 @@ public:
     // is very small -- this can be used predict the margin bump ahead of time without completely
     // replicating the internal logic.  This permits not only simpler caching of blurred results,
     // but also being able to predict precisely at what pixels the blurred profile of e.g. a
-    // rectangle will lie.
+    // rectangle will lie.  It also keeps BoxBlur from blurring a downsampled copy of the mask when
+    // sigma is very large; that copy only changes the pixels, never the margins.
 
     static bool SK_WARN_UNUSED_RESULT BoxBlur(SkMask* dst, const SkMask& src,
                                               SkScalar sigma, SkBlurStyle style, SkBlurQuality,
@@ -542,6 +542,15 @@ SkBlurMaskFilterImpl::filterRectsToNine(const SkRect rects[], int count,
         SkASSERT(!smallR[1].isEmpty());
     }
 
+    // The mask only depends on where the rects fall within a pixel, so move them next to the
+    // origin before using them as a cache key.  That way every rect with the same blur and
+    // the same fractional edges shares one cached mask, whatever its size or position.
+    const SkScalar tx = SkScalarFloorToScalar(smallR[0].left()),
+                   ty = SkScalarFloorToScalar(smallR[0].top());
+    for (int i = 0; i < count; ++i) {
+        smallR[i].offset(-tx, -ty);
+    }
+
     const SkScalar sigma = this->computeXformedSigma(matrix);
     SkCachedData* cache = find_cached_rects(&patch->fMask, sigma, fBlurStyle,
                                             this->getQuality(), smallR, count);
@@ -8,12 +8,15 @@
 #include "SkLightingImageFilter.h"
 #include "SkBitmap.h"
 #include "SkColorPriv.h"
+#include "SkOpts.h"
 #include "SkPoint3.h"
 #include "SkReadBuffer.h"
 #include "SkSpecialImage.h"
 #include "SkTypes.h"
 #include "SkWriteBuffer.h"
 
+#include <type_traits>
+
 #if SK_SUPPORT_GPU
 #include "GrContext.h"
 #include "GrDrawContext.h"
@@ -245,7 +248,20 @@ void lightBitmap(const LightingType& lightingType,
                                      l->lightColor(surfaceToLight));
     }
 
+    // Without edges to check for, we can find the normals of each row's interior all at once.
+    const bool unchecked = std::is_same<PixelFetcher, UncheckedPixelFetcher>::value;
+    const int interior = SkTMax(right - left - 2, 0);
+    SkAutoSTMalloc<3 * 256, float> normals(unchecked ? 3 * interior : 0);
+    float* nx = normals.get();
+    float* ny = nx + interior;
+    float* nz = ny + interior;
+
     for (++y; y < bottom - 1; ++y) {
+        if (unchecked && interior > 0) {
+            SkOpts::lighting_normals(src.getAddr32(left + 1, y - 1), src.getAddr32(left + 1, y),
+                                     src.getAddr32(left + 1, y + 1), interior, surfaceScale,
+                                     nx, ny, nz);
+        }
         int x = left;
         int m[9];
         m[1] = PixelFetcher::Fetch(src, x,     y - 1, srcBounds);
@@ -257,16 +273,33 @@ void lightBitmap(const LightingType& lightingType,
         SkPoint3 surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
         *dptr++ = lightingType.light(leftNormal(m, surfaceScale), surfaceToLight,
                                      l->lightColor(surfaceToLight));
-        for (++x; x < right - 1; ++x) {
+        if (unchecked && interior > 0) {
+            for (int i = 0; i < interior; ++i) {
+                ++x;
+                surfaceToLight = l->surfaceToLight(x, y, PixelFetcher::Fetch(src, x, y, srcBounds),
+                                                   surfaceScale);
+                *dptr++ = lightingType.light(SkPoint3::Make(nx[i], ny[i], nz[i]), surfaceToLight,
+                                             l->lightColor(surfaceToLight));
+            }
+            ++x;
+            m[0] = PixelFetcher::Fetch(src, x - 1, y - 1, srcBounds);
+            m[1] = PixelFetcher::Fetch(src, x,     y - 1, srcBounds);
+            m[3] = PixelFetcher::Fetch(src, x - 1, y,     srcBounds);
+            m[4] = PixelFetcher::Fetch(src, x,     y,     srcBounds);
+            m[6] = PixelFetcher::Fetch(src, x - 1, y + 1, srcBounds);
+            m[7] = PixelFetcher::Fetch(src, x,     y + 1, srcBounds);
+        } else {
+            for (++x; x < right - 1; ++x) {
+                shiftMatrixLeft(m);
+                m[2] = PixelFetcher::Fetch(src, x + 1, y - 1, srcBounds);
+                m[5] = PixelFetcher::Fetch(src, x + 1, y,     srcBounds);
+                m[8] = PixelFetcher::Fetch(src, x + 1, y + 1, srcBounds);
+                surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
+                *dptr++ = lightingType.light(interiorNormal(m, surfaceScale), surfaceToLight,
+                                             l->lightColor(surfaceToLight));
+            }
             shiftMatrixLeft(m);
-            m[2] = PixelFetcher::Fetch(src, x + 1, y - 1, srcBounds);
-            m[5] = PixelFetcher::Fetch(src, x + 1, y,     srcBounds);
-            m[8] = PixelFetcher::Fetch(src, x + 1, y + 1, srcBounds);
-            surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-            *dptr++ = lightingType.light(interiorNormal(m, surfaceScale), surfaceToLight,
-                                         l->lightColor(surfaceToLight));
         }
-        shiftMatrixLeft(m);
         surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
         *dptr++ = lightingType.light(rightNormal(m, surfaceScale), surfaceToLight,
                                      l->lightColor(surfaceToLight));
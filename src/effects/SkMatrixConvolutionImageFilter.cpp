@@ -8,6 +8,7 @@
 #include "SkMatrixConvolutionImageFilter.h"
 #include "SkBitmap.h"
 #include "SkColorPriv.h"
+#include "SkOpts.h"
 #include "SkReadBuffer.h"
 #include "SkSpecialImage.h"
 #include "SkSpecialSurface.h"
@@ -120,13 +121,6 @@ SkMatrixConvolutionImageFilter::~SkMatrixConvolutionImageFilter() {
     delete[] fKernel;
 }
 
-class UncheckedPixelFetcher {
-public:
-    static inline SkPMColor fetch(const SkBitmap& src, int x, int y, const SkIRect& bounds) {
-        return *src.getAddr32(x, y);
-    }
-};
-
 class ClampPixelFetcher {
 public:
     static inline SkPMColor fetch(const SkBitmap& src, int x, int y, const SkIRect& bounds) {
@@ -220,9 +214,21 @@ void SkMatrixConvolutionImageFilter::filterPixels(const SkBitmap& src,
 
 void SkMatrixConvolutionImageFilter::filterInteriorPixels(const SkBitmap& src,
                                                           SkBitmap* result,
-                                                          const SkIRect& rect,
+                                                          const SkIRect& r,
                                                           const SkIRect& bounds) const {
-    filterPixels<UncheckedPixelFetcher>(src, result, rect, bounds);
+    // Every sample here is in bounds, so there's no tiling to do and we go a row at a time.
+    SkIRect rect(r);
+    if (!rect.intersect(bounds)) {
+        return;
+    }
+    for (int y = rect.fTop; y < rect.fBottom; ++y) {
+        SkOpts::matrix_convolve(result->getAddr32(rect.fLeft - bounds.fLeft, y - bounds.fTop),
+                                src.getAddr32(rect.fLeft - fKernelOffset.fX,
+                                              y - fKernelOffset.fY),
+                                src.rowBytes(), rect.width(),
+                                fKernel, fKernelSize.fWidth, fKernelSize.fHeight, fGain, fBias,
+                                fConvolveAlpha ? nullptr : src.getAddr32(rect.fLeft, y));
+    }
 }
 
 void SkMatrixConvolutionImageFilter::filterBorderPixels(const SkBitmap& src,
@@ -8,6 +8,7 @@
 #include "SkMergeImageFilter.h"
 
 #include "SkCanvas.h"
+#include "SkColorFilter.h"
 #include "SkReadBuffer.h"
 #include "SkSpecialImage.h"
 #include "SkSpecialSurface.h"
@@ -85,11 +86,13 @@ sk_sp<SkSpecialImage> SkMergeImageFilter::onFilterImage(SkSpecialImage* source,
 
     SkAutoTDeleteArray<sk_sp<SkSpecialImage>> inputs(new sk_sp<SkSpecialImage>[inputCount]);
     SkAutoTDeleteArray<SkIPoint> offsets(new SkIPoint[inputCount]);
+    SkAutoTDeleteArray<sk_sp<SkColorFilter>> colorFilters(new sk_sp<SkColorFilter>[inputCount]);
 
-    // Filter all of the inputs.
+    // Filter all of the inputs.  Color filter nodes are applied as we composite below.
     for (int i = 0; i < inputCount; ++i) {
         offsets[i].setZero();
-        inputs[i] = this->filterInput(i, source, ctx, &offsets[i]);
+        inputs[i] = this->filterInputFusingColorFilter(i, source, ctx, &offsets[i],
+                                                       &colorFilters[i]);
         if (!inputs[i]) {
             continue;
         }
@@ -136,6 +139,7 @@ sk_sp<SkSpecialImage> SkMergeImageFilter::onFilterImage(SkSpecialImage* source,
         if (fModes) {
             paint.setXfermodeMode((SkXfermode::Mode)fModes[i]);
         }
+        paint.setColorFilter(colorFilters[i]);
 
         inputs[i]->draw(canvas,
                         SkIntToScalar(offsets[i].x() - x0), SkIntToScalar(offsets[i].y() - y0),
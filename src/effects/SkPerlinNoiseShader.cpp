@@ -6,8 +6,11 @@
  */
 
 #include "SkPerlinNoiseShader.h"
+#include "SkCachedData.h"
 #include "SkColorFilter.h"
+#include "SkNx.h"
 #include "SkReadBuffer.h"
+#include "SkResourceCache.h"
 #include "SkWriteBuffer.h"
 #include "SkShader.h"
 #include "SkUnPreMultiply.h"
@@ -30,6 +33,9 @@ static const int kBlockMask = kBlockSize - 1;
 static const int kPerlinNoise = 4096;
 static const int kRandMaximum = SK_MaxS32; // 2**31 - 1
 
+// Stitched noise tiles up to this many pixels are kept in SkResourceCache.
+static const int kMaxCachedTileArea = 256 * 256;
+
 namespace {
 
 // noiseValue is the color component's value (or color)
@@ -105,7 +111,10 @@ struct SkPerlinNoiseShader::PaintingData {
     int         fSeed;
     uint8_t     fLatticeSelector[kBlockSize];
     uint16_t    fNoise[4][kBlockSize][2];
-    SkPoint     fGradient[4][kBlockSize];
+    // The gradients of the four channels at each lattice point, interleaved so that noise2D()
+    // can compute all four channels at once.
+    float       fGradientX[kBlockSize][4];
+    float       fGradientY[kBlockSize][4];
     SkISize     fTileSize;
     SkVector    fBaseFrequency;
     StitchData  fStitchDataInit;
@@ -186,17 +195,19 @@ private:
         // Compute gradients from permutated noise data
         for (int channel = 0; channel < 4; ++channel) {
             for (int i = 0; i < kBlockSize; ++i) {
-                fGradient[channel][i] = SkPoint::Make(
+                SkPoint gradient = SkPoint::Make(
                     SkScalarMul(SkIntToScalar(fNoise[channel][i][0] - kBlockSize),
                                 gInvBlockSizef),
                     SkScalarMul(SkIntToScalar(fNoise[channel][i][1] - kBlockSize),
                                 gInvBlockSizef));
-                fGradient[channel][i].normalize();
+                gradient.normalize();
+                fGradientX[i][channel] = gradient.fX;
+                fGradientY[i][channel] = gradient.fY;
                 // Put the normalized gradient back into the noise data
                 fNoise[channel][i][0] = SkScalarRoundToInt(SkScalarMul(
-                    fGradient[channel][i].fX + SK_Scalar1, gHalfMax16bits));
+                    gradient.fX + SK_Scalar1, gHalfMax16bits));
                 fNoise[channel][i][1] = SkScalarRoundToInt(SkScalarMul(
-                    fGradient[channel][i].fY + SK_Scalar1, gHalfMax16bits));
+                    gradient.fY + SK_Scalar1, gHalfMax16bits));
             }
         }
     }
@@ -242,6 +253,63 @@ private:
 
 public:
 
+    // The noise of all four channels at noiseVector.  The channels share their lattice points and
+    // differ only in their gradients, so they're computed together.
+    Sk4f noise2D(bool stitchTiles, const StitchData& stitchData, const SkPoint& noiseVector) const {
+        struct Noise {
+            int noisePositionIntegerValue;
+            int nextNoisePositionIntegerValue;
+            SkScalar noisePositionFractionValue;
+            Noise(SkScalar component)
+            {
+                SkScalar position = component + kPerlinNoise;
+                noisePositionIntegerValue = SkScalarFloorToInt(position);
+                noisePositionFractionValue = position - SkIntToScalar(noisePositionIntegerValue);
+                nextNoisePositionIntegerValue = noisePositionIntegerValue + 1;
+            }
+        };
+        Noise noiseX(noiseVector.x());
+        Noise noiseY(noiseVector.y());
+        // If stitching, adjust lattice points accordingly.
+        if (stitchTiles) {
+            noiseX.noisePositionIntegerValue = checkNoise(
+                noiseX.noisePositionIntegerValue, stitchData.fWrapX, stitchData.fWidth);
+            noiseY.noisePositionIntegerValue = checkNoise(
+                noiseY.noisePositionIntegerValue, stitchData.fWrapY, stitchData.fHeight);
+            noiseX.nextNoisePositionIntegerValue = checkNoise(
+                noiseX.nextNoisePositionIntegerValue, stitchData.fWrapX, stitchData.fWidth);
+            noiseY.nextNoisePositionIntegerValue = checkNoise(
+                noiseY.nextNoisePositionIntegerValue, stitchData.fWrapY, stitchData.fHeight);
+        }
+        noiseX.noisePositionIntegerValue &= kBlockMask;
+        noiseY.noisePositionIntegerValue &= kBlockMask;
+        noiseX.nextNoisePositionIntegerValue &= kBlockMask;
+        noiseY.nextNoisePositionIntegerValue &= kBlockMask;
+        int i = fLatticeSelector[noiseX.noisePositionIntegerValue];
+        int j = fLatticeSelector[noiseX.nextNoisePositionIntegerValue];
+        int b00 = (i + noiseY.noisePositionIntegerValue) & kBlockMask;
+        int b10 = (j + noiseY.noisePositionIntegerValue) & kBlockMask;
+        int b01 = (i + noiseY.nextNoisePositionIntegerValue) & kBlockMask;
+        int b11 = (j + noiseY.nextNoisePositionIntegerValue) & kBlockMask;
+        SkScalar sx = smoothCurve(noiseX.noisePositionFractionValue);
+        SkScalar sy = smoothCurve(noiseY.noisePositionFractionValue);
+
+        auto dot = [this](int index, SkScalar x, SkScalar y) {
+            return Sk4f::Load(fGradientX[index]) * x + Sk4f::Load(fGradientY[index]) * y;
+        };
+        // This is taken 1:1 from SVG spec:
+        // http://www.w3.org/TR/SVG11/filters.html#feTurbulenceElement
+        SkScalar fractionX = noiseX.noisePositionFractionValue;
+        SkScalar fractionY = noiseY.noisePositionFractionValue;
+        Sk4f u = dot(b00, fractionX, fractionY);                            // Offset (0,0)
+        Sk4f v = dot(b10, fractionX - SK_Scalar1, fractionY);               // Offset (-1,0)
+        Sk4f a = u + (v - u) * sx;
+        v = dot(b11, fractionX - SK_Scalar1, fractionY - SK_Scalar1);       // Offset (-1,-1)
+        u = dot(b01, fractionX, fractionY - SK_Scalar1);                    // Offset (0,-1)
+        Sk4f b = u + (v - u) * sx;
+        return a + (b - a) * sy;
+    }
+
 #if SK_SUPPORT_GPU
     const SkBitmap& getPermutationsBitmap() const { return fPermutationsBitmap; }
 
@@ -318,79 +386,94 @@ void SkPerlinNoiseShader::flatten(SkWriteBuffer& buffer) const {
     buffer.writeInt(fTileSize.fHeight);
 }
 
-SkScalar SkPerlinNoiseShader::PerlinNoiseShaderContext::noise2D(
-        int channel, const StitchData& stitchData, const SkPoint& noiseVector) const {
-    struct Noise {
-        int noisePositionIntegerValue;
-        int nextNoisePositionIntegerValue;
-        SkScalar noisePositionFractionValue;
-        Noise(SkScalar component)
-        {
-            SkScalar position = component + kPerlinNoise;
-            noisePositionIntegerValue = SkScalarFloorToInt(position);
-            noisePositionFractionValue = position - SkIntToScalar(noisePositionIntegerValue);
-            nextNoisePositionIntegerValue = noisePositionIntegerValue + 1;
+namespace {
+
+static unsigned gPerlinNoiseTileKeyNamespaceLabel;
+
+// Everything the colors of a stitched noise tile depend on.
+struct PerlinNoiseTileKey : public SkResourceCache::Key {
+public:
+    PerlinNoiseTileKey(SkPerlinNoiseShader::Type type, int numOctaves, SkScalar seed,
+                       const SkVector& baseFrequency, const SkISize& tileSize, U8CPU alpha)
+        : fType(type)
+        , fNumOctaves(numOctaves)
+        , fSeed(seed)
+        , fBaseFrequencyX(baseFrequency.fX)
+        , fBaseFrequencyY(baseFrequency.fY)
+        , fTileWidth(tileSize.width())
+        , fTileHeight(tileSize.height())
+        , fAlpha(alpha) {
+        static const size_t keySize = sizeof(fType) + sizeof(fNumOctaves) + sizeof(fSeed) +
+                                      sizeof(fBaseFrequencyX) + sizeof(fBaseFrequencyY) +
+                                      sizeof(fTileWidth) + sizeof(fTileHeight) + sizeof(fAlpha);
+        // This better be packed.
+        SkASSERT(sizeof(uint32_t) * (&fEndOfStruct - (uint32_t*)&fType) == keySize);
+        this->init(&gPerlinNoiseTileKeyNamespaceLabel, 0, keySize);
+    }
+
+private:
+    int32_t  fType;
+    int32_t  fNumOctaves;
+    SkScalar fSeed;
+    SkScalar fBaseFrequencyX;
+    SkScalar fBaseFrequencyY;
+    int32_t  fTileWidth;
+    int32_t  fTileHeight;
+    uint32_t fAlpha;
+
+    SkDEBUGCODE(uint32_t fEndOfStruct;)
+};
+
+struct PerlinNoiseTileRec : public SkResourceCache::Rec {
+    PerlinNoiseTileRec(const PerlinNoiseTileKey& key, SkCachedData* data)
+        : fKey(key)
+        , fData(data) {
+        fData->attachToCacheAndRef();
+    }
+    ~PerlinNoiseTileRec() {
+        fData->detachFromCacheAndUnref();
+    }
+
+    PerlinNoiseTileKey fKey;
+    SkCachedData*      fData;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fData->size(); }
+    const char* getCategory() const override { return "perlin-noise-tile"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override {
+        return fData->diagnostic_only_getDiscardable();
+    }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const PerlinNoiseTileRec& rec = static_cast<const PerlinNoiseTileRec&>(baseRec);
+        SkCachedData* data = rec.fData;
+        data->ref();
+        if (nullptr == data->data()) {
+            data->unref();
+            return false;
         }
-    };
-    Noise noiseX(noiseVector.x());
-    Noise noiseY(noiseVector.y());
-    SkScalar u, v;
-    const SkPerlinNoiseShader& perlinNoiseShader = static_cast<const SkPerlinNoiseShader&>(fShader);
-    // If stitching, adjust lattice points accordingly.
-    if (perlinNoiseShader.fStitchTiles) {
-        noiseX.noisePositionIntegerValue =
-            checkNoise(noiseX.noisePositionIntegerValue, stitchData.fWrapX, stitchData.fWidth);
-        noiseY.noisePositionIntegerValue =
-            checkNoise(noiseY.noisePositionIntegerValue, stitchData.fWrapY, stitchData.fHeight);
-        noiseX.nextNoisePositionIntegerValue =
-            checkNoise(noiseX.nextNoisePositionIntegerValue, stitchData.fWrapX, stitchData.fWidth);
-        noiseY.nextNoisePositionIntegerValue =
-            checkNoise(noiseY.nextNoisePositionIntegerValue, stitchData.fWrapY, stitchData.fHeight);
-    }
-    noiseX.noisePositionIntegerValue &= kBlockMask;
-    noiseY.noisePositionIntegerValue &= kBlockMask;
-    noiseX.nextNoisePositionIntegerValue &= kBlockMask;
-    noiseY.nextNoisePositionIntegerValue &= kBlockMask;
-    int i =
-        fPaintingData->fLatticeSelector[noiseX.noisePositionIntegerValue];
-    int j =
-        fPaintingData->fLatticeSelector[noiseX.nextNoisePositionIntegerValue];
-    int b00 = (i + noiseY.noisePositionIntegerValue) & kBlockMask;
-    int b10 = (j + noiseY.noisePositionIntegerValue) & kBlockMask;
-    int b01 = (i + noiseY.nextNoisePositionIntegerValue) & kBlockMask;
-    int b11 = (j + noiseY.nextNoisePositionIntegerValue) & kBlockMask;
-    SkScalar sx = smoothCurve(noiseX.noisePositionFractionValue);
-    SkScalar sy = smoothCurve(noiseY.noisePositionFractionValue);
-    // This is taken 1:1 from SVG spec: http://www.w3.org/TR/SVG11/filters.html#feTurbulenceElement
-    SkPoint fractionValue = SkPoint::Make(noiseX.noisePositionFractionValue,
-                                          noiseY.noisePositionFractionValue); // Offset (0,0)
-    u = fPaintingData->fGradient[channel][b00].dot(fractionValue);
-    fractionValue.fX -= SK_Scalar1; // Offset (-1,0)
-    v = fPaintingData->fGradient[channel][b10].dot(fractionValue);
-    SkScalar a = SkScalarInterp(u, v, sx);
-    fractionValue.fY -= SK_Scalar1; // Offset (-1,-1)
-    v = fPaintingData->fGradient[channel][b11].dot(fractionValue);
-    fractionValue.fX = noiseX.noisePositionFractionValue; // Offset (0,-1)
-    u = fPaintingData->fGradient[channel][b01].dot(fractionValue);
-    SkScalar b = SkScalarInterp(u, v, sx);
-    return SkScalarInterp(a, b, sy);
-}
+        *static_cast<SkCachedData**>(contextData) = data;
+        return true;
+    }
+};
 
-SkScalar SkPerlinNoiseShader::PerlinNoiseShaderContext::calculateTurbulenceValueForPoint(
-        int channel, StitchData& stitchData, const SkPoint& point) const {
+} // end namespace
+
+SkPMColor SkPerlinNoiseShader::PerlinNoiseShaderContext::calculateTurbulenceColorForPoint(
+        StitchData& stitchData, const SkPoint& point) const {
     const SkPerlinNoiseShader& perlinNoiseShader = static_cast<const SkPerlinNoiseShader&>(fShader);
     if (perlinNoiseShader.fStitchTiles) {
         // Set up TurbulenceInitial stitch values.
         stitchData = fPaintingData->fStitchDataInit;
     }
-    SkScalar turbulenceFunctionResult = 0;
+    Sk4f turbulenceFunctionResult(0);
     SkPoint noiseVector(SkPoint::Make(SkScalarMul(point.x(), fPaintingData->fBaseFrequency.fX),
                                       SkScalarMul(point.y(), fPaintingData->fBaseFrequency.fY)));
     SkScalar ratio = SK_Scalar1;
     for (int octave = 0; octave < perlinNoiseShader.fNumOctaves; ++octave) {
-        SkScalar noise = noise2D(channel, stitchData, noiseVector);
-        SkScalar numer = (perlinNoiseShader.fType == kFractalNoise_Type) ?
-                            noise : SkScalarAbs(noise);
+        Sk4f noise = fPaintingData->noise2D(perlinNoiseShader.fStitchTiles, stitchData,
+                                            noiseVector);
+        Sk4f numer = (perlinNoiseShader.fType == kFractalNoise_Type) ? noise : noise.abs();
         turbulenceFunctionResult += numer / ratio;
         noiseVector.fX *= 2;
         noiseVector.fY *= 2;
@@ -407,16 +490,18 @@ SkScalar SkPerlinNoiseShader::PerlinNoiseShaderContext::calculateTurbulenceValue
     // The value of turbulenceFunctionResult comes from ((turbulenceFunctionResult) + 1) / 2
     // by fractalNoise and (turbulenceFunctionResult) by turbulence.
     if (perlinNoiseShader.fType == kFractalNoise_Type) {
-        turbulenceFunctionResult =
-            SkScalarMul(turbulenceFunctionResult, SK_ScalarHalf) + SK_ScalarHalf;
+        turbulenceFunctionResult = turbulenceFunctionResult * SK_ScalarHalf + SK_ScalarHalf;
     }
 
-    if (channel == 3) { // Scale alpha by paint value
-        turbulenceFunctionResult *= SkIntToScalar(getPaintAlpha()) / 255;
-    }
+    // Scale alpha by paint value
+    turbulenceFunctionResult *= Sk4f(1, 1, 1, SkIntToScalar(getPaintAlpha()) / 255);
 
     // Clamp result
-    return SkScalarPin(turbulenceFunctionResult, 0, SK_Scalar1);
+    turbulenceFunctionResult = Sk4f::Min(Sk4f::Max(turbulenceFunctionResult, 0), SK_Scalar1);
+
+    // The results are in [0, 1], so truncating is flooring.
+    Sk4i rgba = SkNx_cast<int>(turbulenceFunctionResult * 255);
+    return SkPreMultiplyARGB(rgba[3], rgba[0], rgba[1], rgba[2]);
 }
 
 SkPMColor SkPerlinNoiseShader::PerlinNoiseShaderContext::shade(
@@ -426,12 +511,18 @@ SkPMColor SkPerlinNoiseShader::PerlinNoiseShaderContext::shade(
     newPoint.fX = SkScalarRoundToScalar(newPoint.fX);
     newPoint.fY = SkScalarRoundToScalar(newPoint.fY);
 
-    U8CPU rgba[4];
-    for (int channel = 3; channel >= 0; --channel) {
-        rgba[channel] = SkScalarFloorToInt(255 *
-            calculateTurbulenceValueForPoint(channel, stitchData, newPoint));
+    if (fTile) {
+        // The tile holds the points from (1,1), where the noise starts, to the tile size.
+        const SkISize& tileSize = fPaintingData->fTileSize;
+        int x = SkScalarTruncToInt(newPoint.fX) - 1;
+        int y = SkScalarTruncToInt(newPoint.fY) - 1;
+        if ((unsigned)x < (unsigned)tileSize.width() &&
+            (unsigned)y < (unsigned)tileSize.height()) {
+            return static_cast<const SkPMColor*>(fTile->data())[y * tileSize.width() + x];
+        }
     }
-    return SkPreMultiplyARGB(rgba[3], rgba[0], rgba[1], rgba[2]);
+
+    return calculateTurbulenceColorForPoint(stitchData, newPoint);
 }
 
 SkShader::Context* SkPerlinNoiseShader::onCreateContext(const ContextRec& rec,
@@ -457,9 +548,50 @@ SkPerlinNoiseShader::PerlinNoiseShaderContext::PerlinNoiseShaderContext(
     fMatrix.setTranslate(-newMatrix.getTranslateX() + SK_Scalar1, -newMatrix.getTranslateY() + SK_Scalar1);
     fPaintingData = new PaintingData(shader.fTileSize, shader.fSeed, shader.fBaseFrequencyX,
                                      shader.fBaseFrequencyY, newMatrix);
+    fTile = nullptr;
+    if (shader.fStitchTiles) {
+        this->findOrMakeTile();
+    }
 }
 
-SkPerlinNoiseShader::PerlinNoiseShaderContext::~PerlinNoiseShaderContext() { delete fPaintingData; }
+SkPerlinNoiseShader::PerlinNoiseShaderContext::~PerlinNoiseShaderContext() {
+    if (fTile) {
+        fTile->unref();
+    }
+    delete fPaintingData;
+}
+
+void SkPerlinNoiseShader::PerlinNoiseShaderContext::findOrMakeTile() {
+    // A stitched tile is drawn over and over, often by many draws, so it's worth computing its
+    // noise just once.
+    const SkISize& tileSize = fPaintingData->fTileSize;
+    if (tileSize.isEmpty() || (int64_t)tileSize.width() * tileSize.height() > kMaxCachedTileArea) {
+        return;
+    }
+
+    const SkPerlinNoiseShader& shader = static_cast<const SkPerlinNoiseShader&>(fShader);
+    PerlinNoiseTileKey key(shader.fType, shader.fNumOctaves, shader.fSeed,
+                           fPaintingData->fBaseFrequency, tileSize, this->getPaintAlpha());
+    if (SkResourceCache::Find(key, PerlinNoiseTileRec::Visitor, &fTile)) {
+        return;
+    }
+
+    SkCachedData* tile = SkResourceCache::NewCachedData(
+            key, tileSize.width() * tileSize.height() * sizeof(SkPMColor));
+    if (!tile) {
+        return;
+    }
+    SkPMColor* colors = static_cast<SkPMColor*>(tile->writable_data());
+    StitchData stitchData;
+    for (int y = 0; y < tileSize.height(); ++y) {
+        for (int x = 0; x < tileSize.width(); ++x) {
+            *colors++ = this->calculateTurbulenceColorForPoint(
+                    stitchData, SkPoint::Make(SkIntToScalar(x + 1), SkIntToScalar(y + 1)));
+        }
+    }
+    SkResourceCache::Add(new PerlinNoiseTileRec(key, tile));
+    fTile = tile;
+}
 
 void SkPerlinNoiseShader::PerlinNoiseShaderContext::shadeSpan(
         int x, int y, SkPMColor result[], int count) {
@@ -133,27 +133,35 @@ void SkTable_ColorFilter::filterSpan(const SkPMColor src[], int count, SkPMColor
         tableB = table;
     }
 
+    // The four tables are independent, so the lookups are done a byte at a time.  What makes this
+    // cheap instead is that real content is mostly runs of one color: each result is reused for
+    // as long as the source pixel repeats.
     const SkUnPreMultiply::Scale* scaleTable = SkUnPreMultiply::GetScaleTable();
+    auto filter = [=](SkPMColor c) {
+        unsigned a = SkGetPackedA32(c),
+                 r = SkGetPackedR32(c),
+                 g = SkGetPackedG32(c),
+                 b = SkGetPackedB32(c);
+        if (a < 255) {
+            SkUnPreMultiply::Scale scale = scaleTable[a];
+            r = SkUnPreMultiply::ApplyScale(scale, r);
+            g = SkUnPreMultiply::ApplyScale(scale, g);
+            b = SkUnPreMultiply::ApplyScale(scale, b);
+        }
+        return SkPremultiplyARGBInline(tableA[a], tableR[r], tableG[g], tableB[b]);
+    };
+
+    if (count <= 0) {
+        return;
+    }
+    SkPMColor last = src[0],
+              result = filter(last);
     for (int i = 0; i < count; ++i) {
-        SkPMColor c = src[i];
-        unsigned a, r, g, b;
-        if (0 == c) {
-            a = r = g = b = 0;
-        } else {
-            a = SkGetPackedA32(c);
-            r = SkGetPackedR32(c);
-            g = SkGetPackedG32(c);
-            b = SkGetPackedB32(c);
-
-            if (a < 255) {
-                SkUnPreMultiply::Scale scale = scaleTable[a];
-                r = SkUnPreMultiply::ApplyScale(scale, r);
-                g = SkUnPreMultiply::ApplyScale(scale, g);
-                b = SkUnPreMultiply::ApplyScale(scale, b);
-            }
+        if (src[i] != last) {
+            last = src[i];
+            result = filter(last);
         }
-        dst[i] = SkPremultiplyARGBInline(tableA[a], tableR[r],
-                                         tableG[g], tableB[b]);
+        dst[i] = result;
     }
 }
 
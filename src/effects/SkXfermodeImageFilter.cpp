@@ -8,6 +8,7 @@
 #include "SkXfermodeImageFilter.h"
 
 #include "SkCanvas.h"
+#include "SkColorFilter.h"
 #include "SkColorPriv.h"
 #include "SkReadBuffer.h"
 #include "SkSpecialImage.h"
@@ -54,11 +55,18 @@ void SkXfermodeImageFilter::flatten(SkWriteBuffer& buffer) const {
 sk_sp<SkSpecialImage> SkXfermodeImageFilter::onFilterImage(SkSpecialImage* source,
                                                            const Context& ctx,
                                                            SkIPoint* offset) const {
+    // Color filter nodes feeding either input are applied as that input is drawn.
     SkIPoint backgroundOffset = SkIPoint::Make(0, 0);
-    sk_sp<SkSpecialImage> background(this->filterInput(0, source, ctx, &backgroundOffset));
+    sk_sp<SkColorFilter> backgroundCF;
+    sk_sp<SkSpecialImage> background(this->filterInputFusingColorFilter(0, source, ctx,
+                                                                        &backgroundOffset,
+                                                                        &backgroundCF));
 
     SkIPoint foregroundOffset = SkIPoint::Make(0, 0);
-    sk_sp<SkSpecialImage> foreground(this->filterInput(1, source, ctx, &foregroundOffset));
+    sk_sp<SkColorFilter> foregroundCF;
+    sk_sp<SkSpecialImage> foreground(this->filterInputFusingColorFilter(1, source, ctx,
+                                                                        &foregroundOffset,
+                                                                        &foregroundCF));
 
     SkIRect foregroundBounds = SkIRect::EmptyIRect();
     if (foreground) {
@@ -88,8 +96,8 @@ sk_sp<SkSpecialImage> SkXfermodeImageFilter::onFilterImage(SkSpecialImage* sourc
 #if SK_SUPPORT_GPU
     if (source->isTextureBacked()) {
         return this->filterImageGPU(source,
-                                    background, backgroundOffset, 
-                                    foreground, foregroundOffset,
+                                    background, backgroundOffset, backgroundCF.get(),
+                                    foreground, foregroundOffset, foregroundCF.get(),
                                     bounds);
     }
 #endif
@@ -112,6 +120,7 @@ sk_sp<SkSpecialImage> SkXfermodeImageFilter::onFilterImage(SkSpecialImage* sourc
     paint.setXfermodeMode(SkXfermode::kSrc_Mode);
 
     if (background) {
+        paint.setColorFilter(std::move(backgroundCF));
         background->draw(canvas,
                          SkIntToScalar(backgroundOffset.fX), SkIntToScalar(backgroundOffset.fY),
                          &paint);
@@ -120,6 +129,7 @@ sk_sp<SkSpecialImage> SkXfermodeImageFilter::onFilterImage(SkSpecialImage* sourc
     paint.setXfermode(fMode);
 
     if (foreground) {
+        paint.setColorFilter(std::move(foregroundCF));
         foreground->draw(canvas,
                          SkIntToScalar(foregroundOffset.fX), SkIntToScalar(foregroundOffset.fY),
                          &paint);
@@ -127,6 +137,7 @@ sk_sp<SkSpecialImage> SkXfermodeImageFilter::onFilterImage(SkSpecialImage* sourc
 
     canvas->clipRect(SkRect::Make(foregroundBounds), SkRegion::kDifference_Op);
     paint.setColor(SK_ColorTRANSPARENT);
+    paint.setColorFilter(nullptr);
     canvas->drawPaint(paint);
 
     return surf->makeImageSnapshot();
@@ -161,8 +172,10 @@ void SkXfermodeImageFilter::toString(SkString* str) const {
 sk_sp<SkSpecialImage> SkXfermodeImageFilter::filterImageGPU(SkSpecialImage* source,
                                                             sk_sp<SkSpecialImage> background,
                                                             const SkIPoint& backgroundOffset,
+                                                            SkColorFilter* backgroundCF,
                                                             sk_sp<SkSpecialImage> foreground,
                                                             const SkIPoint& foregroundOffset,
+                                                            SkColorFilter* foregroundCF,
                                                             const SkIRect& bounds) const {
     SkASSERT(source->isTextureBacked());
 
@@ -193,6 +206,15 @@ sk_sp<SkSpecialImage> SkXfermodeImageFilter::filterImageGPU(SkSpecialImage* sour
                                                              background->subset()),
                             GrTextureDomain::kDecal_Mode,
                             GrTextureParams::kNone_FilterMode);
+        if (backgroundCF) {
+            sk_sp<GrFragmentProcessor> series[] = {
+                std::move(bgFP), backgroundCF->asFragmentProcessor(context)
+            };
+            if (!series[1]) {
+                return nullptr;
+            }
+            bgFP = GrFragmentProcessor::RunInSeries(series, 2);
+        }
     } else {
         bgFP = GrConstColorProcessor::Make(GrColor_TRANSPARENT_BLACK,
                                              GrConstColorProcessor::kIgnore_InputMode);
@@ -214,6 +236,13 @@ sk_sp<SkSpecialImage> SkXfermodeImageFilter::filterImageGPU(SkSpecialImage* sour
                             GrTextureParams::kNone_FilterMode);
 
         paint.addColorFragmentProcessor(std::move(foregroundFP));
+        if (foregroundCF) {
+            sk_sp<GrFragmentProcessor> cfFP(foregroundCF->asFragmentProcessor(context));
+            if (!cfFP) {
+                return nullptr;
+            }
+            paint.addColorFragmentProcessor(std::move(cfFP));
+        }
 
         // A null fMode is interpreted to mean kSrcOver_Mode (to match raster).
         SkAutoTUnref<SkXfermode> mode(SkSafeRef(fMode.get()));
@@ -328,7 +328,7 @@ GradientShaderBase4fContext::shadeSpanInternal(int x, int y,
         const int n = SkTMin(kBufSize, count);
         this->mapTs(x, y, ts, n);
         for (int i = 0; i < n; ++i) {
-            const Sk4f c = sampler.sample(ts[i]);
+            const Sk4f c = SkScalarIsNaN(ts[i]) ? Sk4f(0) : sampler.sample(ts[i]);
             DstTraits<dstType, premul>::store(c, dst++);
         }
         x += n;
@@ -40,8 +40,14 @@ protected:
         bool     fZeroRamp;
     };
 
+    // A NaN t leaves its pixel transparent, for gradients that don't cover the whole plane.
     virtual void mapTs(int x, int y, SkScalar ts[], int count) const = 0;
 
+    // Helper for mapTs(): maps the centers of count pixels starting at (x, y) into gradient
+    // space, and stores t4(xs, ys) for them four pixels at a time.
+    template <typename T4Proc>
+    void mapTs4(int x, int y, SkScalar ts[], int count, const T4Proc& t4) const;
+
     void buildIntervals(const SkGradientShaderBase&, const ContextRec&, bool reverse);
 
     SkSTArray<8, Interval, true> fIntervals;
@@ -70,4 +76,41 @@ private:
                            int count) const;
 };
 
+template <typename T4Proc>
+void SkGradientShaderBase::
+GradientShaderBase4fContext::mapTs4(int x, int y, SkScalar ts[], int count,
+                                    const T4Proc& t4) const {
+    SkASSERT(count > 0);
+
+    const SkScalar sy = y + SK_ScalarHalf;
+    for (int i = 0; i < count; i += 4) {
+        Sk4f xs, ys;
+        if (fDstToPosClass != kPerspective_MatrixClass) {
+            // Recomputed from the span start each time around, so error doesn't accumulate.
+            SkPoint pt;
+            fDstToPosProc(fDstToPos, x + i + SK_ScalarHalf, sy, &pt);
+            const SkVector step = fDstToPos.fixedStepInX(sy);
+            const Sk4f steps(0, 1, 2, 3);
+            xs = pt.x() + steps * step.x();
+            ys = pt.y() + steps * step.y();
+        } else {
+            SkPoint pts[4];
+            for (int j = 0; j < 4; ++j) {
+                fDstToPosProc(fDstToPos, x + i + j + SK_ScalarHalf, sy, &pts[j]);
+            }
+            xs = Sk4f(pts[0].x(), pts[1].x(), pts[2].x(), pts[3].x());
+            ys = Sk4f(pts[0].y(), pts[1].y(), pts[2].y(), pts[3].y());
+        }
+
+        const Sk4f t = t4(xs, ys);
+        if (count - i >= 4) {
+            t.store(ts + i);
+        } else {
+            SkScalar tail[4];
+            t.store(tail);
+            memcpy(ts + i, tail, (count - i) * sizeof(SkScalar));
+        }
+    }
+}
+
 #endif // Sk4fGradientBase_DEFINED
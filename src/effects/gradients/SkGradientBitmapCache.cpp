@@ -6,6 +6,7 @@
  */
 
 
+#include "SkChecksum.h"
 #include "SkGradientBitmapCache.h"
 
 struct SkGradientBitmapCache::Entry {
@@ -14,11 +15,13 @@ struct SkGradientBitmapCache::Entry {
 
     void*       fBuffer;
     size_t      fSize;
+    uint32_t    fHash;
     SkBitmap    fBitmap;
 
-    Entry(const void* buffer, size_t size, const SkBitmap& bm)
+    Entry(const void* buffer, size_t size, uint32_t hash, const SkBitmap& bm)
             : fPrev(nullptr),
               fNext(nullptr),
+              fHash(hash),
               fBitmap(bm) {
         fBuffer = sk_malloc_throw(size);
         fSize = size;
@@ -27,8 +30,9 @@ struct SkGradientBitmapCache::Entry {
 
     ~Entry() { sk_free(fBuffer); }
 
-    bool equals(const void* buffer, size_t size) const {
-        return (fSize == size) && !memcmp(fBuffer, buffer, size);
+    // The hash lets a long list be walked without touching each entry's key.
+    bool equals(const void* buffer, size_t size, uint32_t hash) const {
+        return fHash == hash && fSize == size && !memcmp(fBuffer, buffer, size);
     }
 };
 
@@ -82,9 +86,10 @@ void SkGradientBitmapCache::attachToHead(Entry* entry) const {
 bool SkGradientBitmapCache::find(const void* buffer, size_t size, SkBitmap* bm) const {
     AutoValidate av(this);
 
+    const uint32_t hash = SkChecksum::Murmur3(buffer, size);
     Entry* entry = fHead;
     while (entry) {
-        if (entry->equals(buffer, size)) {
+        if (entry->equals(buffer, size, hash)) {
             if (bm) {
                 *bm = entry->fBitmap;
             }
@@ -107,11 +112,23 @@ void SkGradientBitmapCache::add(const void* buffer, size_t len, const SkBitmap&
         fEntryCount -= 1;
     }
 
-    Entry* entry = new Entry(buffer, len, bm);
+    Entry* entry = new Entry(buffer, len, SkChecksum::Murmur3(buffer, len), bm);
     this->attachToHead(entry);
     fEntryCount += 1;
 }
 
+void SkGradientBitmapCache::setMaxEntries(int maxEntries) {
+    AutoValidate av(this);
+
+    SkASSERT(maxEntries > 0);
+    fMaxEntries = maxEntries;
+    while (fEntryCount > fMaxEntries) {
+        SkASSERT(fTail);
+        delete this->release(fTail);
+        fEntryCount -= 1;
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #ifdef SK_DEBUG
@@ -19,9 +19,13 @@ public:
     bool find(const void* buffer, size_t len, SkBitmap*) const;
     void add(const void* buffer, size_t len, const SkBitmap&);
 
+    int getMaxEntries() const { return fMaxEntries; }
+    // Purges least recently used entries as needed to fit.
+    void setMaxEntries(int maxEntries);
+
 private:
     int fEntryCount;
-    const int fMaxEntries;
+    int fMaxEntries;
 
     struct Entry;
     mutable Entry*  fHead;
@@ -626,6 +626,25 @@ SkGradientShaderBase::GradientShaderCache* SkGradientShaderBase::refCache(U8CPU
 }
 
 SK_DECLARE_STATIC_MUTEX(gGradientCacheMutex);
+// Each cached table costs 1K of RAM, since each bitmap will be 1x256 at 32bpp.
+static int gGradientCacheCountLimit = 256;
+static SkGradientBitmapCache* gGradientCache;
+
+int SkGradientShader::GetTableCacheCountLimit() {
+    SkAutoMutexAcquire ama(gGradientCacheMutex);
+    return gGradientCacheCountLimit;
+}
+
+int SkGradientShader::SetTableCacheCountLimit(int count) {
+    SkAutoMutexAcquire ama(gGradientCacheMutex);
+    const int prev = gGradientCacheCountLimit;
+    gGradientCacheCountLimit = SkTMax(count, 1);
+    if (gGradientCache) {
+        gGradientCache->setMaxEntries(gGradientCacheCountLimit);
+    }
+    return prev;
+}
+
 /*
  *  Because our caller might rebuild the same (logically the same) gradient
  *  over and over, we'd like to return exactly the same "bitmap" if possible,
@@ -661,23 +680,20 @@ void SkGradientShaderBase::getGradientTableBitmap(SkBitmap* bitmap) const {
 
     ///////////////////////////////////
 
-    static SkGradientBitmapCache* gCache;
-    // each cache cost 1K of RAM, since each bitmap will be 1x256 at 32bpp
-    static const int MAX_NUM_CACHED_GRADIENT_BITMAPS = 32;
     SkAutoMutexAcquire ama(gGradientCacheMutex);
 
-    if (nullptr == gCache) {
-        gCache = new SkGradientBitmapCache(MAX_NUM_CACHED_GRADIENT_BITMAPS);
+    if (nullptr == gGradientCache) {
+        gGradientCache = new SkGradientBitmapCache(gGradientCacheCountLimit);
     }
     size_t size = count * sizeof(int32_t);
 
-    if (!gCache->find(storage.get(), size, bitmap)) {
+    if (!gGradientCache->find(storage.get(), size, bitmap)) {
         // force our cahce32pixelref to be built
         (void)cache->getCache32();
         bitmap->setInfo(SkImageInfo::MakeN32Premul(kCache32Count, 1));
         bitmap->setPixelRef(cache->getCache32PixelRef());
 
-        gCache->add(storage.get(), size, *bitmap);
+        gGradientCache->add(storage.get(), size, *bitmap);
     }
 }
 
@@ -716,6 +732,18 @@ void SkGradientShaderBase::commonAsAGradient(GradientInfo* info, bool flipGrad)
     }
 }
 
+// define to test the 4f gradient path
+// #define FORCE_4F_CONTEXT
+
+bool SkGradientShaderBase::use4fContext(const ContextRec& rec) const {
+#ifdef FORCE_4F_CONTEXT
+    return true;
+#else
+    return rec.fPreferredDstType == ContextRec::kPM4f_DstType
+        || SkToBool(fGradFlags & kForce4fContext_PrivateFlag);
+#endif
+}
+
 #ifndef SK_IGNORE_TO_STRING
 void SkGradientShaderBase::toString(SkString* str) const {
 
@@ -1111,9 +1139,12 @@ GrGradientEffect::GrGradientEffect(GrContext* ctx,
         SkBitmap bitmap;
         shader.getGradientTableBitmap(&bitmap);
 
+        // One atlas row per cached table: a row is keyed by its table's generation ID, so any
+        // more rows than tables could never be found again.
         GrTextureStripAtlas::Desc desc;
         desc.fWidth  = bitmap.width();
-        desc.fHeight = 32;
+        desc.fHeight = SkTMin(SkGradientShader::GetTableCacheCountLimit(),
+                              ctx->caps()->maxTextureSize());
         desc.fRowHeight = bitmap.height();
         desc.fContext = ctx;
         desc.fConfig = SkImageInfo2GrPixelConfig(bitmap.info(), *ctx->caps());
@@ -172,6 +172,11 @@ public:
         typedef SkShader::Context INHERITED;
     };
 
+    enum {
+        // Temp flag for testing the 4f impl.
+        kForce4fContext_PrivateFlag     = 1 << 7,
+    };
+
     bool isOpaque() const override;
 
     void getGradientTableBitmap(SkBitmap*) const;
@@ -231,6 +236,9 @@ protected:
 
     void commonAsAGradient(GradientInfo*, bool flipGrad = false) const;
 
+    // True when rec should be shaded by one of the GradientShaderBase4fContexts.
+    bool use4fContext(const ContextRec& rec) const;
+
     bool onAsLuminanceColor(SkColor*) const override;
 
     /*
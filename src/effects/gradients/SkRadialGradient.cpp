@@ -5,9 +5,12 @@
  * found in the LICENSE file.
  */
 
+#include "Sk4fGradientBase.h"
 #include "SkRadialGradient.h"
 #include "SkNx.h"
 
+#include <float.h>
+
 namespace {
 
 // GCC doesn't like using static functions as template arguments.  So force these to be non-static.
@@ -39,12 +42,36 @@ SkRadialGradient::SkRadialGradient(const SkPoint& center, SkScalar radius, const
     , fRadius(radius) {
 }
 
-size_t SkRadialGradient::onContextSize(const ContextRec&) const {
-    return sizeof(RadialGradientContext);
+class SkRadialGradient::RadialGradient4fContext final : public GradientShaderBase4fContext {
+public:
+    RadialGradient4fContext(const SkRadialGradient& shader, const ContextRec& rec)
+        : INHERITED(shader, rec) {
+        this->buildIntervals(shader, rec, false);
+    }
+
+protected:
+    void mapTs(int x, int y, SkScalar ts[], int count) const override {
+        this->mapTs4(x, y, ts, count, [](const Sk4f& xs, const Sk4f& ys) {
+            // sqrt(r2) as r2 * rsqrt(r2), kept off zero so the center doesn't compute 0 * inf.
+            const Sk4f r2 = Sk4f::Max(xs * xs + ys * ys, FLT_MIN);
+            return r2 * r2.rsqrt();
+        });
+    }
+
+private:
+    using INHERITED = GradientShaderBase4fContext;
+};
+
+size_t SkRadialGradient::onContextSize(const ContextRec& rec) const {
+    return this->use4fContext(rec)
+        ? sizeof(RadialGradient4fContext)
+        : sizeof(RadialGradientContext);
 }
 
 SkShader::Context* SkRadialGradient::onCreateContext(const ContextRec& rec, void* storage) const {
-    return new (storage) RadialGradientContext(*this, rec);
+    return this->use4fContext(rec)
+        ? static_cast<SkShader::Context*>(new (storage) RadialGradient4fContext(*this, rec))
+        : static_cast<SkShader::Context*>(new (storage) RadialGradientContext(*this, rec));
 }
 
 SkRadialGradient::RadialGradientContext::RadialGradientContext(
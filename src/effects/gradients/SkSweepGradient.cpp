@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "Sk4fGradientBase.h"
 #include "SkSweepGradient.h"
 
 static SkMatrix translate(SkScalar dx, SkScalar dy) {
@@ -44,12 +45,52 @@ void SkSweepGradient::flatten(SkWriteBuffer& buffer) const {
     buffer.writePoint(fCenter);
 }
 
-size_t SkSweepGradient::onContextSize(const ContextRec&) const {
-    return sizeof(SweepGradientContext);
+// atan2(y, x) as a fraction of a full turn, in [0..1), 0 for x == y == 0.  A polynomial fit of
+// atan() over [0..1] is good to about 1e-6 turns, well past 8 bits.
+static Sk4f atan2_turns(const Sk4f& y, const Sk4f& x) {
+    const Sk4f ax = x.abs(),
+               ay = y.abs();
+    const Sk4f slope = Sk4f::Min(ax, ay) / Sk4f::Max(ax, ay),
+               s     = slope * slope;
+    Sk4f phi = slope * (0.15912117063999176025390625f + s *
+                       (-5.185396969318389892578125e-2f + s *
+                       (2.476101927459239959716796875e-2f + s *
+                       (-7.0547382347285747528076171875e-3f))));
+    phi = (ax < ay).thenElse(0.25f - phi, phi);
+    phi = (x < 0.0f).thenElse(0.5f - phi, phi);
+    phi = (y < 0.0f).thenElse(1.0f - phi, phi);
+    // NaN (0/0 at the center) and 1 (y a hair below zero) both belong at 0.
+    return (phi < 1.0f).thenElse(phi, 0.0f);
+}
+
+class SkSweepGradient::SweepGradient4fContext final : public GradientShaderBase4fContext {
+public:
+    SweepGradient4fContext(const SkSweepGradient& shader, const ContextRec& rec)
+        : INHERITED(shader, rec) {
+        this->buildIntervals(shader, rec, false);
+    }
+
+protected:
+    void mapTs(int x, int y, SkScalar ts[], int count) const override {
+        this->mapTs4(x, y, ts, count, [](const Sk4f& xs, const Sk4f& ys) {
+            return atan2_turns(ys, xs);
+        });
+    }
+
+private:
+    using INHERITED = GradientShaderBase4fContext;
+};
+
+size_t SkSweepGradient::onContextSize(const ContextRec& rec) const {
+    return this->use4fContext(rec)
+        ? sizeof(SweepGradient4fContext)
+        : sizeof(SweepGradientContext);
 }
 
 SkShader::Context* SkSweepGradient::onCreateContext(const ContextRec& rec, void* storage) const {
-    return new (storage) SweepGradientContext(*this, rec);
+    return this->use4fContext(rec)
+        ? static_cast<SkShader::Context*>(new (storage) SweepGradient4fContext(*this, rec))
+        : static_cast<SkShader::Context*>(new (storage) SweepGradientContext(*this, rec));
 }
 
 SkSweepGradient::SweepGradientContext::SweepGradientContext(
@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "Sk4fGradientBase.h"
 #include "SkTwoPointConicalGradient.h"
 #include "SkTwoPointConicalGradient_gpu.h"
 
@@ -211,13 +212,79 @@ bool SkTwoPointConicalGradient::isOpaque() const {
     return false;
 }
 
-size_t SkTwoPointConicalGradient::onContextSize(const ContextRec&) const {
-    return sizeof(TwoPointConicalGradientContext);
+// TwoPtRadialContext::nextT() for four points at once, as floats rather than SkFixed,
+// and NaN where nothing should be drawn.
+static Sk4f two_point_ts(const TwoPtRadial& rec, const Sk4f& x, const Sk4f& y) {
+    const Sk4f relX = x - rec.fCenterX,
+               relY = y - rec.fCenterY;
+    const Sk4f B = -2.0f * (rec.fDCenterX * relX + rec.fDCenterY * relY + rec.fRDR),
+               C = relX * relX + relY * relY - rec.fRadius2;
+    const Sk4f nan(SK_FloatNaN);
+
+    // The root we prefer, and the one we fall back on when its radius is negative.
+    Sk4f t, fallback;
+    if (0 == rec.fA) {
+        t = fallback = (B == 0.0f).thenElse(nan, (0.0f - C) / B);
+    } else {
+        const Sk4f R = B * B - 4 * rec.fA * C;
+        const Sk4f sqrtR = Sk4f::Max(R, 0.0f).sqrt();
+        const Sk4f Q = -0.5f * (B + (B < 0.0f).thenElse(0.0f - sqrtR, sqrtR));
+        const Sk4f r0 = Q / rec.fA,
+                   r1 = C / Q;
+        t        = rec.fFlipped ? Sk4f::Min(r0, r1) : Sk4f::Max(r0, r1);
+        fallback = rec.fFlipped ? Sk4f::Max(r0, r1) : Sk4f::Min(r0, r1);
+
+        // Q == 0 only with a double root at 0.
+        t        = (Q == 0.0f).thenElse(0.0f, t);
+        fallback = (Q == 0.0f).thenElse(0.0f, fallback);
+        t        = (R < 0.0f).thenElse(nan, t);
+        fallback = (R < 0.0f).thenElse(nan, fallback);
+    }
+
+    t = (rec.fRadius + rec.fDRadius * t < 0.0f).thenElse(fallback, t);
+    t = (rec.fRadius + rec.fDRadius * t < 0.0f).thenElse(nan, t);
+
+    // Near-degenerate roots can run off toward infinity, where tiling stops working.  The
+    // legacy path saturates them to SkFixed's range; these compares let NaN through.
+    t = (t < -32767.0f).thenElse(-32767.0f, t);
+    return (t > 32767.0f).thenElse(32767.0f, t);
+}
+
+class SkTwoPointConicalGradient::TwoPointConical4fContext final
+    : public GradientShaderBase4fContext {
+public:
+    TwoPointConical4fContext(const SkTwoPointConicalGradient& shader, const ContextRec& rec)
+        : INHERITED(shader, rec) {
+        // Like the legacy context, we leave pixels outside the cone alone.
+        fFlags &= ~kOpaqueAlpha_Flag;
+        this->buildIntervals(shader, rec, false);
+    }
+
+protected:
+    void mapTs(int x, int y, SkScalar ts[], int count) const override {
+        const TwoPtRadial& twoPtRadial =
+                static_cast<const SkTwoPointConicalGradient&>(fShader).fRec;
+        this->mapTs4(x, y, ts, count, [&twoPtRadial](const Sk4f& xs, const Sk4f& ys) {
+            return two_point_ts(twoPtRadial, xs, ys);
+        });
+    }
+
+private:
+    using INHERITED = GradientShaderBase4fContext;
+};
+
+size_t SkTwoPointConicalGradient::onContextSize(const ContextRec& rec) const {
+    return this->use4fContext(rec)
+        ? sizeof(TwoPointConical4fContext)
+        : sizeof(TwoPointConicalGradientContext);
 }
 
 SkShader::Context* SkTwoPointConicalGradient::onCreateContext(const ContextRec& rec,
                                                               void* storage) const {
-    return new (storage) TwoPointConicalGradientContext(*this, rec);
+    return this->use4fContext(rec)
+        ? static_cast<SkShader::Context*>(new (storage) TwoPointConical4fContext(*this, rec))
+        : static_cast<SkShader::Context*>(new (storage) TwoPointConicalGradientContext(*this,
+                                                                                      rec));
 }
 
 SkTwoPointConicalGradient::TwoPointConicalGradientContext::TwoPointConicalGradientContext(
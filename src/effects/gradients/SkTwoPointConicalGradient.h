@@ -83,6 +83,8 @@ protected:
     Context* onCreateContext(const ContextRec&, void* storage) const override;
 
 private:
+    class TwoPointConical4fContext;
+
     SkPoint fCenter1;
     SkPoint fCenter2;
     SkScalar fRadius1;
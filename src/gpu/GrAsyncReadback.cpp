@@ -0,0 +1,93 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrAsyncReadback.h"
+
+#include "GrContext.h"
+#include "GrGpu.h"
+#include "SkConfig8888.h"
+
+GrAsyncReadback::GrAsyncReadback(GrContext* context, GrBuffer* buffer,
+                                 FinishedProc finishedProc, void* finishedContext)
+    : fContext(context)
+    , fBuffer(SkRef(buffer))
+    , fFence(0)
+    , fFinished(false)
+    , fFailed(false)
+    , fFinishedProc(finishedProc)
+    , fFinishedContext(finishedContext) {}
+
+GrAsyncReadback::~GrAsyncReadback() {
+    // GrContext holds a ref to a fenced readback until it finishes.
+    SkASSERT(!fFence);
+}
+
+void GrAsyncReadback::addPlane(const SkISize& size, GrPixelConfig config, size_t offset,
+                               size_t rowBytes) {
+    Plane& plane = fPlanes.push_back();
+    plane.fSize = size;
+    plane.fConfig = config;
+    plane.fOffset = offset;
+    plane.fRowBytes = rowBytes;
+}
+
+bool GrAsyncReadback::checkFence(uint64_t timeout) {
+    if (fFinished) {
+        return true;
+    }
+    SkASSERT(fContext && fFence);
+    if (!fContext->getGpu()->waitFence(fFence, timeout)) {
+        return false;
+    }
+    this->finish(false);
+    return true;
+}
+
+void GrAsyncReadback::finish(bool failed, bool contextLost) {
+    SkASSERT(!fFinished);
+    if (fFence && !contextLost) {
+        fContext->getGpu()->deleteFence(fFence);
+    }
+    fFence = 0;
+    fContext = nullptr;
+    fFinished = true;
+    fFailed = failed;
+    if (fFinishedProc) {
+        fFinishedProc(fFinishedContext, this);
+    }
+}
+
+bool GrAsyncReadback::isFinished() {
+    return this->checkFence(0);
+}
+
+bool GrAsyncReadback::readPixels(int plane, void* dst, size_t rowBytes) {
+    SkASSERT(plane >= 0 && plane < fPlanes.count());
+    // We've nothing else to do until the pixels land, so wait as long as it takes.
+    if (!fFinished && !this->checkFence(UINT64_MAX)) {
+        this->finish(true);
+    }
+    if (fFailed) {
+        return false;
+    }
+
+    const Plane& p = fPlanes[plane];
+    size_t tightRowBytes = GrBytesPerPixel(p.fConfig) * p.fSize.width();
+    if (!rowBytes) {
+        rowBytes = tightRowBytes;
+    } else if (rowBytes < tightRowBytes) {
+        return false;
+    }
+    const void* mapped = fBuffer->map();
+    if (!mapped) {
+        return false;
+    }
+    SkRectMemcpy(dst, rowBytes, static_cast<const char*>(mapped) + p.fOffset, p.fRowBytes,
+                 tightRowBytes, p.fSize.height());
+    fBuffer->unmap();
+    return true;
+}
@@ -12,6 +12,7 @@ const int GrAuditTrail::kGrAuditTrailInvalidID = -1;
 
 void GrAuditTrail::addBatch(const GrBatch* batch) {
     SkASSERT(fEnabled);
+    fCombineStats.fBatchesAdded++;
     Batch* auditBatch = new Batch;
     fBatchPool.emplace_back(auditBatch);
     auditBatch->fName = batch->name();
@@ -48,11 +49,20 @@ void GrAuditTrail::addBatch(const GrBatch* batch) {
     BatchNode* batchNode = new BatchNode;
     batchNode->fBounds = batch->bounds();
     batchNode->fRenderTargetUniqueID = batch->renderTargetUniqueID();
+    batchNode->fHasGpuTime = false;
+    batchNode->fGpuNanoseconds = 0;
     batchNode->fChildren.push_back(auditBatch);
     fBatchList.emplace_back(batchNode);
 }
 
-void GrAuditTrail::batchingResultCombined(const GrBatch* consumer, const GrBatch* consumed) {
+void GrAuditTrail::batchingResultCombined(const GrBatch* consumer, const GrBatch* consumed,
+                                          bool forward) {
+    if (forward) {
+        fCombineStats.fCombinedForward++;
+    } else {
+        fCombineStats.fCombinedBackward++;
+    }
+
     // Look up the batch we are going to glom onto
     int* indexPtr = fIDLookup.find(consumer->uniqueID());
     SkASSERT(indexPtr);
@@ -86,6 +96,35 @@ void GrAuditTrail::batchingResultCombined(const GrBatch* consumer, const GrBatch
     fIDLookup.remove(consumed->uniqueID());
 }
 
+void GrAuditTrail::addBatchGpuTime(uint32_t batchUniqueID, const char* name,
+                                   uint64_t nanoseconds) {
+    SkASSERT(fEnabled);
+    BatchGpuTime* time = nullptr;
+    // There are only a few dozen batch classes.
+    for (int i = 0; i < fBatchGpuTimes.count(); ++i) {
+        if (fBatchGpuTimes[i].fName.equals(name)) {
+            time = &fBatchGpuTimes[i];
+            break;
+        }
+    }
+    if (!time) {
+        time = &fBatchGpuTimes.push_back();
+        time->fName.set(name);
+        time->fCount = 0;
+        time->fNanoseconds = 0;
+    }
+    time->fCount++;
+    time->fNanoseconds += nanoseconds;
+
+    // The batch may have been recorded before the log was last reset.
+    if (int* index = fIDLookup.find(batchUniqueID)) {
+        if (BatchNode* batchNode = fBatchList[*index]) {
+            batchNode->fHasGpuTime = true;
+            batchNode->fGpuNanoseconds += nanoseconds;
+        }
+    }
+}
+
 void GrAuditTrail::copyOutFromBatchList(BatchInfo* outBatchInfo, int batchListID) {
     SkASSERT(batchListID < fBatchList.count());
     const BatchNode* bn = fBatchList[batchListID];
@@ -136,6 +175,8 @@ void GrAuditTrail::fullReset() {
     // free all client batches
     fClientIDLookup.foreach([](const int&, Batches** batches) { delete *batches; });
     fClientIDLookup.reset();
+    fCombineStats = CombineStats();
+    fBatchGpuTimes.reset();
     fBatchPool.reset(); // must be last, frees all of the memory
 }
 
@@ -231,6 +272,21 @@ SkString GrAuditTrail::toJson(bool prettyPrint) const {
     SkString json;
     json.append("{");
     JsonifyTArray(&json, "Batches", fBatchList, false);
+    json.appendf("%s\"CombineStats\": {", fBatchList.count() ? "," : "");
+    json.appendf("\"BatchesAdded\": %d,", fCombineStats.fBatchesAdded);
+    json.appendf("\"CombinedBackward\": %d,", fCombineStats.fCombinedBackward);
+    json.appendf("\"CombinedForward\": %d", fCombineStats.fCombinedForward);
+    json.append("}");
+    if (fBatchGpuTimes.count()) {
+        json.append(",\"BatchGpuTimes\": [");
+        for (int i = 0; i < fBatchGpuTimes.count(); i++) {
+            const BatchGpuTime& time = fBatchGpuTimes[i];
+            json.appendf("%s{\"Name\": \"%s\",", i ? "," : "", time.fName.c_str());
+            json.appendf("\"Count\": %d,", time.fCount);
+            json.appendf("\"Nanoseconds\": %llu}", (unsigned long long)time.fNanoseconds);
+        }
+        json.append("]");
+    }
     json.append("}");
 
     if (prettyPrint) {
@@ -291,6 +347,9 @@ SkString GrAuditTrail::BatchNode::toJson() const {
     SkString json;
     json.append("{");
     json.appendf("\"RenderTarget\": \"%u\",", fRenderTargetUniqueID);
+    if (fHasGpuTime) {
+        json.appendf("\"GpuNanoseconds\": %llu,", (unsigned long long)fGpuNanoseconds);
+    }
     skrect_to_json(&json, "Bounds", fBounds);
     JsonifyTArray(&json, "Batches", fChildren, true);
     json.append("}");
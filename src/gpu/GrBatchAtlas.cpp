@@ -7,18 +7,21 @@
 
 #include "GrBatchAtlas.h"
 #include "GrBatchFlushState.h"
+#include "GrGpuResourcePriv.h"
 #include "GrRectanizer.h"
+#include "GrResourceProvider.h"
 #include "GrTracing.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 
-GrBatchAtlas::BatchPlot::BatchPlot(int index, uint64_t genID, int offX, int offY, int width,
-                                   int height, GrPixelConfig config)
+GrBatchAtlas::BatchPlot::BatchPlot(int pageIndex, int index, uint64_t genID, int offX, int offY,
+                                   int width, int height, GrPixelConfig config)
     : fLastUpload(GrBatchDrawToken::AlreadyFlushedToken())
     , fLastUse(GrBatchDrawToken::AlreadyFlushedToken())
+    , fPageIndex(pageIndex)
     , fIndex(index)
     , fGenID(genID)
-    , fID(CreateId(fIndex, fGenID))
+    , fID(CreateId(fPageIndex, fIndex, fGenID))
     , fData(nullptr)
     , fWidth(width)
     , fHeight(height)
@@ -99,7 +102,7 @@ void GrBatchAtlas::BatchPlot::resetRects() {
     }
 
     fGenID++;
-    fID = CreateId(fIndex, fGenID);
+    fID = CreateId(fPageIndex, fIndex, fGenID);
 
     // zero out the plot
     if (fData) {
@@ -112,8 +115,11 @@ void GrBatchAtlas::BatchPlot::resetRects() {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-GrBatchAtlas::GrBatchAtlas(GrTexture* texture, int numPlotsX, int numPlotsY)
-    : fTexture(texture)
+GrBatchAtlas::GrBatchAtlas(GrTexture* texture, int numPlotsX, int numPlotsY, int maxPages)
+    : fNumPlotsX(numPlotsX)
+    , fNumPlotsY(numPlotsY)
+    , fMaxPages(maxPages)
+    , fNumPages(0)
     , fAtlasGeneration(kInvalidAtlasGeneration + 1) {
 
     fPlotWidth = texture->width() / numPlotsX;
@@ -121,32 +127,68 @@ GrBatchAtlas::GrBatchAtlas(GrTexture* texture, int numPlotsX, int numPlotsY)
     SkASSERT(numPlotsX * numPlotsY <= BulkUseTokenUpdater::kMaxPlots);
     SkASSERT(fPlotWidth * numPlotsX == texture->width());
     SkASSERT(fPlotHeight * numPlotsY == texture->height());
+    SkASSERT(maxPages >= 1 && maxPages <= kMaxPages);
 
     SkDEBUGCODE(fNumPlots = numPlotsX * numPlotsY;)
 
     // We currently do not support compressed atlases...
     SkASSERT(!GrPixelConfigIsCompressed(texture->desc().fConfig));
 
+    this->initPage(texture);
+}
+
+void GrBatchAtlas::initPage(GrTexture* texture) {
+    SkASSERT(fNumPages < fMaxPages);
+    SkASSERT(!fNumPages || (texture->width() == fPages[0].fTexture->width() &&
+                            texture->height() == fPages[0].fTexture->height() &&
+                            texture->config() == fPages[0].fTexture->config()));
+    int pageIdx = fNumPages++;
+    Page& page = fPages[pageIdx];
+    page.fTexture = texture;
+    texture->resourcePriv().setIsAtlas(true);
+
     // set up allocated plots
-    fPlotArray = new SkAutoTUnref<BatchPlot>[numPlotsX * numPlotsY];
+    page.fPlotArray.reset(fNumPlotsX * fNumPlotsY);
 
-    SkAutoTUnref<BatchPlot>* currPlot = fPlotArray;
-    for (int y = numPlotsY - 1, r = 0; y >= 0; --y, ++r) {
-        for (int x = numPlotsX - 1, c = 0; x >= 0; --x, ++c) {
-            uint32_t index = r * numPlotsX + c;
-            currPlot->reset(new BatchPlot(index, 1, x, y, fPlotWidth, fPlotHeight,
+    SkAutoTUnref<BatchPlot>* currPlot = page.fPlotArray.get();
+    for (int y = fNumPlotsY - 1, r = 0; y >= 0; --y, ++r) {
+        for (int x = fNumPlotsX - 1, c = 0; x >= 0; --x, ++c) {
+            uint32_t index = r * fNumPlotsX + c;
+            currPlot->reset(new BatchPlot(pageIdx, index, 1, x, y, fPlotWidth, fPlotHeight,
                                           texture->desc().fConfig));
 
             // build LRU list
-            fPlotList.addToHead(currPlot->get());
+            page.fPlotList.addToHead(currPlot->get());
             ++currPlot;
         }
     }
 }
 
+bool GrBatchAtlas::createNewPage(GrDrawBatch::Target* target) {
+    if (fNumPages == fMaxPages) {
+        return false;
+    }
+
+    GrSurfaceDesc desc;
+    desc.fFlags = kNone_GrSurfaceFlags;
+    desc.fWidth = fPages[0].fTexture->width();
+    desc.fHeight = fPages[0].fTexture->height();
+    desc.fConfig = fPages[0].fTexture->config();
+
+    // We're in the middle of preparing a flush, so the new texture mustn't have pending IO
+    GrTexture* texture = target->resourceProvider()->createApproxTexture(
+            desc, GrResourceProvider::kNoPendingIO_Flag);
+    if (!texture) {
+        return false;
+    }
+    this->initPage(texture);
+    return true;
+}
+
 GrBatchAtlas::~GrBatchAtlas() {
-    SkSafeUnref(fTexture);
-    delete[] fPlotArray;
+    for (int i = 0; i < fNumPages; ++i) {
+        SkSafeUnref(fPages[i].fTexture);
+    }
 }
 
 void GrBatchAtlas::processEviction(AtlasID id) {
@@ -164,7 +206,7 @@ inline void GrBatchAtlas::updatePlot(GrDrawBatch::Target* target, AtlasID* id, B
     if (target->hasDrawBeenFlushed(plot->lastUploadToken())) {
         // With c+14 we could move sk_sp into lamba to only ref once.
         sk_sp<BatchPlot> plotsp(SkRef(plot));
-        GrTexture* texture = fTexture;
+        GrTexture* texture = fPages[plot->pageIndex()].fTexture;
         GrBatchDrawToken lastUploadToken = target->addAsapUpload(
             [plotsp, texture] (GrDrawBatch::WritePixelsFn& writePixels) {
                plotsp->uploadToTexture(writePixels, texture);
@@ -177,58 +219,82 @@ inline void GrBatchAtlas::updatePlot(GrDrawBatch::Target* target, AtlasID* id, B
 
 bool GrBatchAtlas::addToAtlas(AtlasID* id, GrDrawBatch::Target* target,
                               int width, int height, const void* image, SkIPoint16* loc) {
-    // We should already have a texture, TODO clean this up
-    SkASSERT(fTexture);
     if (width > fPlotWidth || height > fPlotHeight) {
         return false;
     }
 
-    // now look through all allocated plots for one we can share, in Most Recently Refed order
-    GrBatchPlotList::Iter plotIter;
-    plotIter.init(fPlotList, GrBatchPlotList::Iter::kHead_IterStart);
-    BatchPlot* plot;
-    while ((plot = plotIter.get())) {
-        SkASSERT(GrBytesPerPixel(fTexture->desc().fConfig) == plot->bpp());
-        if (plot->addSubImage(width, height, image, loc)) {
+    // now look through all allocated plots for one we can share, page by page in Most Recently
+    // Refed order
+    for (int pageIdx = 0; pageIdx < fNumPages; ++pageIdx) {
+        GrBatchPlotList::Iter plotIter;
+        plotIter.init(fPages[pageIdx].fPlotList, GrBatchPlotList::Iter::kHead_IterStart);
+        BatchPlot* plot;
+        while ((plot = plotIter.get())) {
+            SkASSERT(GrBytesPerPixel(fPages[pageIdx].fTexture->desc().fConfig) == plot->bpp());
+            if (plot->addSubImage(width, height, image, loc)) {
+                this->updatePlot(target, id, plot);
+                return true;
+            }
+            plotIter.next();
+        }
+    }
+
+    // If the above fails, then see if the least recently refed plot of any page has already been
+    // flushed to the gpu
+    for (int pageIdx = 0; pageIdx < fNumPages; ++pageIdx) {
+        BatchPlot* plot = fPages[pageIdx].fPlotList.tail();
+        SkASSERT(plot);
+        if (target->hasDrawBeenFlushed(plot->lastUseToken())) {
+            this->processEviction(plot->id());
+            plot->resetRects();
+            SkASSERT(GrBytesPerPixel(fPages[pageIdx].fTexture->desc().fConfig) == plot->bpp());
+            SkDEBUGCODE(bool verify = )plot->addSubImage(width, height, image, loc);
+            SkASSERT(verify);
             this->updatePlot(target, id, plot);
+            fAtlasGeneration++;
             return true;
         }
-        plotIter.next();
     }
 
-    // If the above fails, then see if the least recently refed plot has already been flushed to the
-    // gpu
-    plot = fPlotList.tail();
-    SkASSERT(plot);
-    if (target->hasDrawBeenFlushed(plot->lastUseToken())) {
-        this->processEviction(plot->id());
-        plot->resetRects();
-        SkASSERT(GrBytesPerPixel(fTexture->desc().fConfig) == plot->bpp());
+    // Every plot is still in use by draws that haven't executed.  If we're allowed another page
+    // we grow into it rather than evicting anything; nothing is removed, so the generation stays.
+    if (this->createNewPage(target)) {
+        BatchPlot* plot = fPages[fNumPages - 1].fPlotList.head();
+        SkASSERT(plot);
         SkDEBUGCODE(bool verify = )plot->addSubImage(width, height, image, loc);
         SkASSERT(verify);
         this->updatePlot(target, id, plot);
-        fAtlasGeneration++;
         return true;
     }
 
-    // If this plot has been used in a draw that is currently being prepared by a batch, then we
-    // have to fail. This gives the batch a chance to enqueue the draw, and call back into this
-    // function. When that draw is enqueued, the draw token advances, and the subsequent call will
-    // continue past this branch and prepare an inline upload that will occur after the enqueued
-    // draw which references the plot's pre-upload content.
-    if (plot->lastUseToken() == target->nextDrawToken()) {
+    // If a page's LRU plot has been used in a draw that is currently being prepared by a batch,
+    // then we can't replace it. If that is true of every page we have to fail. This gives the
+    // batch a chance to enqueue the draw, and call back into this function. When that draw is
+    // enqueued, the draw token advances, and the subsequent call will continue past this branch
+    // and prepare an inline upload that will occur after the enqueued draw which references the
+    // plot's pre-upload content.
+    BatchPlot* plot = nullptr;
+    for (int pageIdx = 0; pageIdx < fNumPages; ++pageIdx) {
+        BatchPlot* lruPlot = fPages[pageIdx].fPlotList.tail();
+        if (lruPlot->lastUseToken() != target->nextDrawToken()) {
+            plot = lruPlot;
+            break;
+        }
+    }
+    if (!plot) {
         return false;
     }
 
     SkASSERT(!plot->unique());  // The GrPlotUpdater should have a ref too
 
+    int pageIdx = plot->pageIndex();
     this->processEviction(plot->id());
-    fPlotList.remove(plot);
-    SkAutoTUnref<BatchPlot>& newPlot = fPlotArray[plot->index()];
+    fPages[pageIdx].fPlotList.remove(plot);
+    SkAutoTUnref<BatchPlot>& newPlot = fPages[pageIdx].fPlotArray[plot->index()];
     newPlot.reset(plot->clone());
 
-    fPlotList.addToHead(newPlot.get());
-    SkASSERT(GrBytesPerPixel(fTexture->desc().fConfig) == newPlot->bpp());
+    fPages[pageIdx].fPlotList.addToHead(newPlot.get());
+    SkASSERT(GrBytesPerPixel(fPages[pageIdx].fTexture->desc().fConfig) == newPlot->bpp());
     SkDEBUGCODE(bool verify = )newPlot->addSubImage(width, height, image, loc);
     SkASSERT(verify);
 
@@ -236,7 +302,7 @@ bool GrBatchAtlas::addToAtlas(AtlasID* id, GrDrawBatch::Target* target,
     // one it displaced most likely was uploaded asap.
     // With c+14 we could move sk_sp into lamba to only ref once.
     sk_sp<BatchPlot> plotsp(SkRef(newPlot.get()));
-    GrTexture* texture = fTexture;
+    GrTexture* texture = fPages[pageIdx].fTexture;
     GrBatchDrawToken lastUploadToken = target->addInlineUpload(
         [plotsp, texture] (GrDrawBatch::WritePixelsFn& writePixels) {
             plotsp->uploadToTexture(writePixels, texture);
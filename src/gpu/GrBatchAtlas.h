@@ -26,6 +26,8 @@ struct GrBatchAtlasConfig {
     int fLog2Height;
     int fPlotWidth;
     int fPlotHeight;
+    // The atlas starts with one texture and may grow into this many, each the full size above.
+    int fMaxPages;
 };
 
 class GrBatchAtlas {
@@ -41,7 +43,13 @@ public:
     // the eviction
     typedef void (*EvictionFunc)(GrBatchAtlas::AtlasID, void*);
 
-    GrBatchAtlas(GrTexture*, int numPlotsX, int numPlotsY);
+    // The most textures ('pages') a single GrBatchAtlas can spread its plots across.
+    static const int kMaxPages = 4;
+
+    // The atlas takes ownership of the texture, which becomes its first page.  When every plot is
+    // in use by the batch being prepared, the atlas adds pages of the same size and config, up to
+    // maxPages, rather than evicting one of them with an inline upload.
+    GrBatchAtlas(GrTexture*, int numPlotsX, int numPlotsY, int maxPages = 1);
     ~GrBatchAtlas();
 
     // Adds a width x height subimage to the atlas. Upon success it returns
@@ -54,23 +62,33 @@ public:
     bool addToAtlas(AtlasID*, GrDrawBatch::Target*, int width, int height, const void* image,
                     SkIPoint16* loc);
 
-    GrTexture* getTexture() const { return fTexture; }
+    GrTexture* getTexture(int pageIdx = 0) const {
+        SkASSERT(pageIdx < fNumPages);
+        return fPages[pageIdx].fTexture;
+    }
+    int numPages() const { return fNumPages; }
 
     uint64_t atlasGeneration() const { return fAtlasGeneration; }
 
     inline bool hasID(AtlasID id) {
-        uint32_t index = GetIndexFromID(id);
-        SkASSERT(index < fNumPlots);
-        return fPlotArray[index]->genID() == GetGenerationFromID(id);
+        uint32_t pageIdx = GetPageIndexFromID(id);
+        uint32_t plotIdx = GetPlotIndexFromID(id);
+        SkASSERT(pageIdx < (uint32_t)fNumPages);
+        SkASSERT(plotIdx < fNumPlots);
+        return fPages[pageIdx].fPlotArray[plotIdx]->genID() == GetGenerationFromID(id);
     }
 
     // To ensure the atlas does not evict a given entry, the client must set the last use token
     inline void setLastUseToken(AtlasID id, GrBatchDrawToken batchToken) {
         SkASSERT(this->hasID(id));
-        uint32_t index = GetIndexFromID(id);
-        SkASSERT(index < fNumPlots);
-        this->makeMRU(fPlotArray[index]);
-        fPlotArray[index]->setLastUseToken(batchToken);
+        BatchPlot* plot = fPages[GetPageIndexFromID(id)].fPlotArray[GetPlotIndexFromID(id)];
+        this->makeMRU(plot);
+        plot->setLastUseToken(batchToken);
+    }
+
+    // The page of the atlas, i.e. the texture, holding the data for an AtlasID
+    static uint32_t GetPageIndexFromID(AtlasID id) {
+        return (id >> 8) & 0xff;
     }
 
     inline void registerEvictionCallback(EvictionFunc func, void* userData) {
@@ -81,45 +99,55 @@ public:
 
     /*
      * A class which can be handed back to GrBatchAtlas for updating in bulk last use tokens.  The
-     * current max number of plots the GrBatchAtlas can handle is 32, if in the future this is
-     * insufficient then we can move to a 64 bit int
+     * current max number of plots per page the GrBatchAtlas can handle is 32, if in the future
+     * this is insufficient then we can move to a 64 bit int
      */
     class BulkUseTokenUpdater {
     public:
-        BulkUseTokenUpdater() : fPlotAlreadyUpdated(0) {}
+        BulkUseTokenUpdater() {
+            memset(fPlotAlreadyUpdated, 0, sizeof(fPlotAlreadyUpdated));
+        }
         BulkUseTokenUpdater(const BulkUseTokenUpdater& that)
-            : fPlotsToUpdate(that.fPlotsToUpdate)
-            , fPlotAlreadyUpdated(that.fPlotAlreadyUpdated) {
+            : fPlotsToUpdate(that.fPlotsToUpdate) {
+            memcpy(fPlotAlreadyUpdated, that.fPlotAlreadyUpdated, sizeof(fPlotAlreadyUpdated));
         }
 
         void add(AtlasID id) {
-            int index = GrBatchAtlas::GetIndexFromID(id);
-            if (!this->find(index)) {
-                this->set(index);
+            int pageIdx = GrBatchAtlas::GetPageIndexFromID(id);
+            int plotIdx = GrBatchAtlas::GetPlotIndexFromID(id);
+            if (!this->find(pageIdx, plotIdx)) {
+                this->set(pageIdx, plotIdx);
             }
         }
 
         void reset() {
             fPlotsToUpdate.reset();
-            fPlotAlreadyUpdated = 0;
+            memset(fPlotAlreadyUpdated, 0, sizeof(fPlotAlreadyUpdated));
         }
 
+        struct PlotData {
+            PlotData(int pageIdx, int plotIdx) : fPageIndex(pageIdx), fPlotIndex(plotIdx) {}
+            uint32_t fPageIndex;
+            uint32_t fPlotIndex;
+        };
+
     private:
-        bool find(int index) const {
-            SkASSERT(index < kMaxPlots);
-            return (fPlotAlreadyUpdated >> index) & 1;
+        bool find(int pageIdx, int plotIdx) const {
+            SkASSERT(pageIdx < kMaxPages);
+            SkASSERT(plotIdx < kMaxPlots);
+            return (fPlotAlreadyUpdated[pageIdx] >> plotIdx) & 1;
         }
 
-        void set(int index) {
-            SkASSERT(!this->find(index));
-            fPlotAlreadyUpdated = fPlotAlreadyUpdated | (1 << index);
-            fPlotsToUpdate.push_back(index);
+        void set(int pageIdx, int plotIdx) {
+            SkASSERT(!this->find(pageIdx, plotIdx));
+            fPlotAlreadyUpdated[pageIdx] |= (1 << plotIdx);
+            fPlotsToUpdate.push_back(PlotData(pageIdx, plotIdx));
         }
 
         static const int kMinItems = 4;
         static const int kMaxPlots = 32;
-        SkSTArray<kMinItems, int, true> fPlotsToUpdate;
-        uint32_t fPlotAlreadyUpdated;
+        SkSTArray<kMinItems, PlotData, true> fPlotsToUpdate;
+        uint32_t fPlotAlreadyUpdated[kMaxPages];
 
         friend class GrBatchAtlas;
     };
@@ -127,7 +155,9 @@ public:
     void setLastUseTokenBulk(const BulkUseTokenUpdater& updater, GrBatchDrawToken batchToken) {
         int count = updater.fPlotsToUpdate.count();
         for (int i = 0; i < count; i++) {
-            BatchPlot* plot = fPlotArray[updater.fPlotsToUpdate[i]];
+            const BulkUseTokenUpdater::PlotData& pd = updater.fPlotsToUpdate[i];
+            SkASSERT(pd.fPageIndex < (uint32_t)fNumPages);
+            BatchPlot* plot = fPages[pd.fPageIndex].fPlotArray[pd.fPlotIndex];
             this->makeMRU(plot);
             plot->setLastUseToken(batchToken);
         }
@@ -149,9 +179,11 @@ private:
         SK_DECLARE_INTERNAL_LLIST_INTERFACE(BatchPlot);
 
     public:
-        // index() is a unique id for the plot relative to the owning GrAtlas.  genID() is a
-        // monotonically incremented number which is bumped every time this plot is
-        // evicted from the cache (i.e., there is continuity in genID() across atlas spills).
+        // index() is a unique id for the plot relative to its page in the owning GrAtlas.
+        // pageIndex() is the page holding it.  genID() is a monotonically incremented number
+        // which is bumped every time this plot is evicted from the cache (i.e., there is
+        // continuity in genID() across atlas spills).
+        uint32_t pageIndex() const { return fPageIndex; }
         uint32_t index() const { return fIndex; }
         uint64_t genID() const { return fGenID; }
         GrBatchAtlas::AtlasID id() const {
@@ -176,26 +208,29 @@ private:
         void resetRects();
 
     private:
-        BatchPlot(int index, uint64_t genID, int offX, int offY, int width, int height,
-                  GrPixelConfig config);
+        BatchPlot(int pageIndex, int index, uint64_t genID, int offX, int offY, int width,
+                  int height, GrPixelConfig config);
 
         ~BatchPlot() override;
 
         // Create a clone of this plot. The cloned plot will take the place of the
         // current plot in the atlas.
         BatchPlot* clone() const {
-            return new BatchPlot(fIndex, fGenID+1, fX, fY, fWidth, fHeight, fConfig);
+            return new BatchPlot(fPageIndex, fIndex, fGenID+1, fX, fY, fWidth, fHeight, fConfig);
         }
 
-        static GrBatchAtlas::AtlasID CreateId(uint32_t index, uint64_t generation) {
-            SkASSERT(index < (1 << 16));
+        static GrBatchAtlas::AtlasID CreateId(uint32_t pageIdx, uint32_t plotIdx,
+                                              uint64_t generation) {
+            SkASSERT(pageIdx < (1 << 8));
+            SkASSERT(plotIdx < (1 << 8));
             SkASSERT(generation < ((uint64_t)1 << 48));
-            return generation << 16 | index;
+            return generation << 16 | pageIdx << 8 | plotIdx;
         }
 
         GrBatchDrawToken      fLastUpload;
         GrBatchDrawToken      fLastUse;
 
+        const uint32_t        fPageIndex;
         const uint32_t        fIndex;
         uint64_t              fGenID;
         GrBatchAtlas::AtlasID fID;
@@ -218,8 +253,8 @@ private:
 
     typedef SkTInternalLList<BatchPlot> GrBatchPlotList;
 
-    static uint32_t GetIndexFromID(AtlasID id) {
-        return id & 0xffff;
+    static uint32_t GetPlotIndexFromID(AtlasID id) {
+        return id & 0xff;
     }
 
     // top 48 bits are reserved for the generation ID
@@ -230,20 +265,37 @@ private:
     inline void updatePlot(GrDrawBatch::Target*, AtlasID*, BatchPlot*);
 
     inline void makeMRU(BatchPlot* plot) {
-        if (fPlotList.head() == plot) {
+        GrBatchPlotList& plotList = fPages[plot->pageIndex()].fPlotList;
+        if (plotList.head() == plot) {
             return;
         }
 
-        fPlotList.remove(plot);
-        fPlotList.addToHead(plot);
+        plotList.remove(plot);
+        plotList.addToHead(plot);
     }
 
     inline void processEviction(AtlasID);
 
-    GrTexture* fTexture;
+    // Takes ownership of the texture and lays the next page's plots out over it.
+    void initPage(GrTexture*);
+    // Allocates another texture like the first page's and makes it the next page.
+    bool createNewPage(GrDrawBatch::Target*);
+
+    struct Page {
+        GrTexture* fTexture;
+        // allocated array of GrBatchPlots
+        SkAutoTArray<SkAutoTUnref<BatchPlot>> fPlotArray;
+        // LRU list of GrPlots (MRU at head - LRU at tail)
+        GrBatchPlotList fPlotList;
+    };
+
+    int        fNumPlotsX;
+    int        fNumPlotsY;
     int        fPlotWidth;
     int        fPlotHeight;
     SkDEBUGCODE(uint32_t fNumPlots;)
+    int        fMaxPages;
+    int        fNumPages;
 
     uint64_t fAtlasGeneration;
 
@@ -253,10 +305,7 @@ private:
     };
 
     SkTDArray<EvictionData> fEvictionCallbacks;
-    // allocated array of GrBatchPlots
-    SkAutoTUnref<BatchPlot>* fPlotArray;
-    // LRU list of GrPlots (MRU at head - LRU at tail)
-    GrBatchPlotList fPlotList;
+    Page fPages[kMaxPages];
 };
 
 #endif
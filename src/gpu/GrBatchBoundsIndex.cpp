@@ -0,0 +1,103 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrBatchBoundsIndex.h"
+
+#include <algorithm>
+#include <climits>
+
+void GrBatchBoundsIndex::reset() {
+    // We're reset after every flush, so hang on to the memory.
+    for (SkTDArray<int>& cell : fCells) {
+        cell.rewind();
+    }
+    fBounds.rewind();
+}
+
+int GrBatchBoundsIndex::CellCoord(SkScalar v) {
+    // Written so NaNs land in cell 0.
+    if (!(v > 0)) {
+        return 0;
+    }
+    if (v >= kGridSize * kCellSize) {
+        return kGridSize - 1;
+    }
+    return (int)(v * (1.0f / kCellSize));
+}
+
+void GrBatchBoundsIndex::CellRange(const SkRect& bounds, int* l, int* t, int* r, int* b) {
+    *l = CellCoord(bounds.fLeft);
+    *t = CellCoord(bounds.fTop);
+    *r = CellCoord(bounds.fRight);
+    *b = CellCoord(bounds.fBottom);
+}
+
+void GrBatchBoundsIndex::set(int index, const SkRect& bounds) {
+    SkASSERT(index >= 0);
+    while (fBounds.count() <= index) {
+        fBounds.append()->setLargestInverted();
+    }
+    SkRect& joined = fBounds[index];
+    joined.fLeft   = SkTMin(joined.fLeft,   bounds.fLeft);
+    joined.fTop    = SkTMin(joined.fTop,    bounds.fTop);
+    joined.fRight  = SkTMax(joined.fRight,  bounds.fRight);
+    joined.fBottom = SkTMax(joined.fBottom, bounds.fBottom);
+
+    int l, t, r, b;
+    CellRange(joined, &l, &t, &r, &b);
+    for (int y = t; y <= b; ++y) {
+        for (int x = l; x <= r; ++x) {
+            SkTDArray<int>& cell = fCells[y * kGridSize + x];
+            // Batches are almost always set in order, so this is usually an append.
+            if (cell.isEmpty() || cell.top() < index) {
+                *cell.append() = index;
+                continue;
+            }
+            const int* pos = std::lower_bound(cell.begin(), cell.end(), index);
+            if (*pos != index) {
+                *cell.insert(SkToInt(pos - cell.begin())) = index;
+            }
+        }
+    }
+}
+
+int GrBatchBoundsIndex::lastOverlap(const SkRect& bounds) const {
+    int last = -1;
+    int l, t, r, b;
+    CellRange(bounds, &l, &t, &r, &b);
+    for (int y = t; y <= b; ++y) {
+        for (int x = l; x <= r; ++x) {
+            const SkTDArray<int>& cell = fCells[y * kGridSize + x];
+            for (int i = cell.count() - 1; i >= 0 && cell[i] > last; --i) {
+                if (Overlap(fBounds[cell[i]], bounds)) {
+                    last = cell[i];
+                    break;
+                }
+            }
+        }
+    }
+    return last;
+}
+
+int GrBatchBoundsIndex::firstOverlapAfter(int after, const SkRect& bounds) const {
+    int first = INT_MAX;
+    int l, t, r, b;
+    CellRange(bounds, &l, &t, &r, &b);
+    for (int y = t; y <= b; ++y) {
+        for (int x = l; x <= r; ++x) {
+            const SkTDArray<int>& cell = fCells[y * kGridSize + x];
+            for (const int* i = std::upper_bound(cell.begin(), cell.end(), after);
+                 i != cell.end() && *i < first; ++i) {
+                if (Overlap(fBounds[*i], bounds)) {
+                    first = *i;
+                    break;
+                }
+            }
+        }
+    }
+    return first;
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrBatchBoundsIndex_DEFINED
+#define GrBatchBoundsIndex_DEFINED
+
+#include "SkRect.h"
+#include "SkTDArray.h"
+
+/**
+ * Indexes the bounds of a draw target's recorded batches by their position in the batch list, so
+ * that GrDrawTarget can find the nearest batch a new one overlaps without walking every batch in
+ * between.  Bounds are binned into a coarse uniform grid; each cell lists, in increasing order,
+ * the positions of the batches touching it, and queries test the exact bounds of those.
+ *
+ * Two bounds overlap if GrDrawTarget couldn't reorder their batches, i.e. if they share any area.
+ */
+class GrBatchBoundsIndex {
+public:
+    GrBatchBoundsIndex() {}
+
+    /** Forgets every batch. */
+    void reset();
+
+    /**
+     * Sets the bounds of the batch at 'index'.  A batch's bounds may only grow, so setting them
+     * again for an index already in the index joins them with what was there.
+     */
+    void set(int index, const SkRect& bounds);
+
+    /** Returns the largest index whose bounds overlap 'bounds', or -1 if there is none. */
+    int lastOverlap(const SkRect& bounds) const;
+
+    /**
+     * Returns the smallest index greater than 'after' whose bounds overlap 'bounds', or INT_MAX
+     * if there is none.
+     */
+    int firstOverlapAfter(int after, const SkRect& bounds) const;
+
+    static bool Overlap(const SkRect& a, const SkRect& b) {
+        return a.fRight > b.fLeft && a.fBottom > b.fTop &&
+               b.fRight > a.fLeft && b.fBottom > a.fTop;
+    }
+
+private:
+    // 16x16 cells of 256x256 pixels covers most render targets; anything farther out lands in the
+    // edge cells.
+    static const int kGridSize = 16;
+    static const int kCellSize = 256;
+
+    static int CellCoord(SkScalar v);
+    static void CellRange(const SkRect& bounds, int* l, int* t, int* r, int* b);
+
+    SkTDArray<int>    fCells[kGridSize * kGridSize];
+    // The bounds of each batch, by index.  Indices never set are left empty.
+    SkTDArray<SkRect> fBounds;
+};
+
+#endif
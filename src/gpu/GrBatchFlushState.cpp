@@ -9,11 +9,14 @@
 
 #include "GrBatchAtlas.h"
 #include "GrPipeline.h"
+#include "GrResourceProvider.h"
+#include "SkConfig8888.h"
 
 GrBatchFlushState::GrBatchFlushState(GrGpu* gpu, GrResourceProvider* resourceProvider)
     : fGpu(gpu)
     , fResourceProvider(resourceProvider)
     , fCommandBuffer(nullptr)
+    , fBatchTimer(nullptr)
     , fVertexPool(gpu)
     , fIndexPool(gpu)
     , fLastIssuedToken(GrBatchDrawToken::AlreadyFlushedToken())
@@ -28,3 +31,73 @@ uint16_t* GrBatchFlushState::makeIndexSpace(int indexCount,
                                             const GrBuffer** buffer, int* startIndex) {
     return reinterpret_cast<uint16_t*>(fIndexPool.makeSpace(indexCount, buffer, startIndex));
 }
+
+void GrBatchFlushState::doASAPUploads() {
+    int uploadCount = fAsapUploads.count();
+    if (!uploadCount) {
+        return;
+    }
+    if (!this->caps().transferBufferSupport() ||
+        !(this->caps().mapBufferFlags() & GrCaps::kCanMap_MapFlag)) {
+        for (int i = 0; i < uploadCount; i++) {
+            this->doUpload(fAsapUploads[i]);
+        }
+        return;
+    }
+
+    // Record every write first. The pixels they point at stay valid until fAsapUploads is reset.
+    size_t stagingSize = 0;
+    GrDrawBatch::WritePixelsFn stage = [this, &stagingSize] (GrSurface* surface,
+            int left, int top, int width, int height,
+            GrPixelConfig config, const void* buffer,
+            size_t rowBytes) -> bool {
+        StagedWrite& write = fStagedWrites.push_back();
+        write.fSurface = surface;
+        write.fLeft = left;
+        write.fTop = top;
+        write.fWidth = width;
+        write.fHeight = height;
+        write.fConfig = config;
+        write.fPixels = buffer;
+        write.fRowBytes = rowBytes;
+        write.fOffset = SkAlign4(stagingSize);
+        stagingSize = write.fOffset + width * GrBytesPerPixel(config) * height;
+        return true;
+    };
+    for (int i = 0; i < uploadCount; i++) {
+        fAsapUploads[i](stage);
+    }
+
+    // The buffer goes back to the scratch pool when we're done, so later flushes reuse it.
+    SkAutoTUnref<GrBuffer> transferBuffer;
+    char* staging = nullptr;
+    if (stagingSize) {
+        transferBuffer.reset(fResourceProvider->createBuffer(stagingSize,
+                                                             kXferCpuToGpu_GrBufferType,
+                                                             kDynamic_GrAccessPattern,
+                                                             GrResourceProvider::kNoPendingIO_Flag));
+        if (transferBuffer) {
+            staging = static_cast<char*>(transferBuffer->map());
+        }
+    }
+    if (staging) {
+        for (const StagedWrite& write : fStagedWrites) {
+            size_t trimRowBytes = write.fWidth * GrBytesPerPixel(write.fConfig);
+            SkRectMemcpy(staging + write.fOffset, trimRowBytes, write.fPixels, write.fRowBytes,
+                         trimRowBytes, write.fHeight);
+        }
+        transferBuffer->unmap();
+    }
+
+    for (const StagedWrite& write : fStagedWrites) {
+        size_t trimRowBytes = write.fWidth * GrBytesPerPixel(write.fConfig);
+        if (staging && fGpu->transferPixels(write.fSurface, write.fLeft, write.fTop,
+                                            write.fWidth, write.fHeight, write.fConfig,
+                                            transferBuffer, write.fOffset, trimRowBytes)) {
+            continue;
+        }
+        fGpu->writePixels(write.fSurface, write.fLeft, write.fTop, write.fWidth, write.fHeight,
+                          write.fConfig, write.fPixels, write.fRowBytes);
+    }
+    fStagedWrites.reset();
+}
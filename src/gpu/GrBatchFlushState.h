@@ -11,6 +11,7 @@
 #include "GrBufferAllocPool.h"
 #include "batches/GrVertexBatch.h"
 
+class GrBatchTimer;
 class GrGpuCommandBuffer;
 class GrResourceProvider;
 
@@ -62,11 +63,7 @@ public:
     void preIssueDraws() {
         fVertexPool.unmap();
         fIndexPool.unmap();
-        int uploadCount = fAsapUploads.count();
-
-        for (int i = 0; i < uploadCount; i++) {
-            this->doUpload(fAsapUploads[i]);
-        }
+        this->doASAPUploads();
         fAsapUploads.reset();
     }
 
@@ -90,12 +87,32 @@ public:
 
     GrGpu* gpu() { return fGpu; }
 
+    /** Times the batches on the GPU while the audit trail is enabled. May be null. */
+    GrBatchTimer* batchTimer() { return fBatchTimer; }
+    void setBatchTimer(GrBatchTimer* batchTimer) { fBatchTimer = batchTimer; }
+
     void reset() {
         fVertexPool.reset();
         fIndexPool.reset();
     }
 
 private:
+    /** Runs the ASAP uploads. When transfer buffers are supported their pixels are first
+        gathered into one buffer, and each is then copied from it to its texture. */
+    void doASAPUploads();
+
+    // A write made by an ASAP upload, staged at fOffset in the transfer buffer.
+    struct StagedWrite {
+        GrSurface*    fSurface;
+        int           fLeft;
+        int           fTop;
+        int           fWidth;
+        int           fHeight;
+        GrPixelConfig fConfig;
+        const void*   fPixels;
+        size_t        fRowBytes;
+        size_t        fOffset;
+    };
 
     GrGpu*                                              fGpu;
 
@@ -103,10 +120,13 @@ private:
 
     GrGpuCommandBuffer*                                 fCommandBuffer;
 
+    GrBatchTimer*                                       fBatchTimer;
+
     GrVertexBufferAllocPool                             fVertexPool;
     GrIndexBufferAllocPool                              fIndexPool;
 
     SkSTArray<4, GrDrawBatch::DeferredUploadFn>         fAsapUploads;
+    SkSTArray<4, StagedWrite, true>                     fStagedWrites;
 
     GrBatchDrawToken                                    fLastIssuedToken;
 
@@ -0,0 +1,70 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrBatchTimer.h"
+
+#include "GrAuditTrail.h"
+#include "GrCaps.h"
+#include "GrGpu.h"
+#include "GrGpuCommandBuffer.h"
+#include "batches/GrBatch.h"
+
+GrTimerQuery GrBatchTimer::begin(GrGpuCommandBuffer* commandBuffer, const GrBatch* batch) {
+    if (!fAuditTrail->isEnabled() || !fGpu->caps()->timerQuerySupport()) {
+        return 0;
+    }
+    GrTimerQuery query = fGpu->createTimerQuery();
+    if (!query) {
+        return 0;
+    }
+    Pending* pending = fPending.append();
+    pending->fQuery = query;
+    pending->fBatchID = batch->uniqueID();
+    pending->fName = batch->name();
+    commandBuffer->beginTimerQuery(query);
+    return query;
+}
+
+void GrBatchTimer::end(GrGpuCommandBuffer* commandBuffer, GrTimerQuery query) {
+    SkASSERT(query && fPending.count() && query == fPending.top().fQuery);
+    commandBuffer->endTimerQuery(query);
+}
+
+void GrBatchTimer::collect(bool wait) {
+    if (fPending.isEmpty()) {
+        return;
+    }
+    // The GPU finishes batches in order, so once one isn't done neither are those after it.
+    SkSTArray<16, uint64_t, true> times;
+    for (int i = 0; i < fPending.count(); ++i) {
+        uint64_t nanoseconds;
+        if (!fGpu->timerQueryResult(fPending[i].fQuery, wait, &nanoseconds)) {
+            break;
+        }
+        times.push_back(nanoseconds);
+    }
+    if (fGpu->timerQueriesDisjoint()) {
+        // Some of the times in flight are wrong, and we can't tell which.
+        this->reset();
+        return;
+    }
+    for (int i = 0; i < times.count(); ++i) {
+        // Times that land after the audit trail is disabled are no longer wanted.
+        if (fAuditTrail->isEnabled()) {
+            fAuditTrail->addBatchGpuTime(fPending[i].fBatchID, fPending[i].fName, times[i]);
+        }
+        fGpu->deleteTimerQuery(fPending[i].fQuery);
+    }
+    fPending.remove(0, times.count());
+}
+
+void GrBatchTimer::reset() {
+    for (int i = 0; i < fPending.count(); ++i) {
+        fGpu->deleteTimerQuery(fPending[i].fQuery);
+    }
+    fPending.reset();
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrBatchTimer_DEFINED
+#define GrBatchTimer_DEFINED
+
+#include "GrTypesPriv.h"
+#include "SkTDArray.h"
+
+class GrAuditTrail;
+class GrBatch;
+class GrGpu;
+class GrGpuCommandBuffer;
+
+/**
+ * Times how long each batch takes to execute on the GPU while the audit trail is enabled, if the
+ * GPU has timer queries. GrDrawTarget brackets each batch's commands with a query. The results
+ * come back some time after the flush; collect() hands those that are in to the audit trail,
+ * which sums them per batch class.
+ */
+class GrBatchTimer {
+public:
+    GrBatchTimer(GrGpu* gpu, GrAuditTrail* auditTrail) : fGpu(gpu), fAuditTrail(auditTrail) {}
+
+    ~GrBatchTimer() { SkASSERT(fPending.isEmpty()); }
+
+    /**
+     * Starts timing the batch's commands in the command buffer. Returns the query to pass to
+     * end(), or 0 if the batch isn't being timed.
+     */
+    GrTimerQuery begin(GrGpuCommandBuffer*, const GrBatch*);
+    void end(GrGpuCommandBuffer*, GrTimerQuery);
+
+    /**
+     * Adds the times of the batches whose commands have finished to the audit trail. If 'wait' is
+     * set, blocks until every batch's time is in.
+     */
+    void collect(bool wait);
+
+    /** Deletes every pending query, dropping their times. */
+    void reset();
+
+    /** Forgets every pending query without deleting it, for when the 3D API context is lost. */
+    void abandon() { fPending.reset(); }
+
+private:
+    struct Pending {
+        GrTimerQuery fQuery;
+        uint32_t     fBatchID;
+        const char*  fName; // GrBatch::name() returns a string literal.
+    };
+
+    GrGpu*              fGpu;
+    GrAuditTrail*       fAuditTrail;
+    // In the order the batches executed, which is also the order their results arrive.
+    SkTDArray<Pending>  fPending;
+};
+
+#endif
@@ -236,7 +236,7 @@ bool GrClipMaskManager::SetupClipping(GrContext* context,
         return true;
     }
 
-    GrReducedClip::ElementList elements;
+    const GrReducedClip::ElementList* reducedElements = nullptr;
     int32_t genID = 0;
     GrReducedClip::InitialState initialState = GrReducedClip::kAllIn_InitialState;
     SkIRect clipSpaceIBounds;
@@ -256,13 +256,21 @@ bool GrClipMaskManager::SetupClipping(GrContext* context,
         clipSpaceReduceQueryBounds.setXYWH(0, 0, drawContext->width(), drawContext->height());
         clipSpaceReduceQueryBounds.offset(clip.origin());
     }
-    GrReducedClip::ReduceClipStack(*clip.clipStack(),
-                                    clipSpaceReduceQueryBounds,
-                                    &elements,
-                                    &genID,
-                                    &initialState,
-                                    &clipSpaceIBounds,
-                                    &requiresAA);
+    // Many small draws are usually made through the same clip stack, so the draw context
+    // remembers its last few reductions.
+    if (!drawContext->fReducedClipCache) {
+        drawContext->fReducedClipCache.reset(new GrReducedClipCache);
+    }
+    if (!drawContext->fReducedClipCache->reduceClipStack(*clip.clipStack(),
+                                                         clipSpaceReduceQueryBounds,
+                                                         &reducedElements,
+                                                         &genID,
+                                                         &initialState,
+                                                         &clipSpaceIBounds,
+                                                         &requiresAA)) {
+        return false;
+    }
+    const GrReducedClip::ElementList& elements = *reducedElements;
     if (elements.isEmpty()) {
         if (GrReducedClip::kAllOut_InitialState == initialState) {
             return false;
@@ -326,14 +334,12 @@ bool GrClipMaskManager::SetupClipping(GrContext* context,
             // The clip geometry is complex enough that it will be more efficient to create it
             // entirely in software
             result = CreateSoftwareClipMask(context->textureProvider(),
-                                            genID,
                                             initialState,
                                             elements,
                                             clipToMaskOffset,
                                             clipSpaceIBounds);
         } else {
             result = CreateAlphaClipMask(context,
-                                         genID,
                                          initialState,
                                          elements,
                                          clipToMaskOffset,
@@ -443,23 +449,61 @@ static void draw_element(GrDrawContext* dc,
 ////////////////////////////////////////////////////////////////////////////////
 // Create a 8-bit clip mask in alpha
 
-static void GetClipMaskKey(int32_t clipGenID, const SkIRect& bounds, GrUniqueKey* key) {
+// The key describes the mask's content rather than the clip stack it came from: the initial
+// state, the mask's size and each element's geometry relative to the mask's top left. Clips that
+// reduce to the same elements under an integer translation (e.g. a scrolled, re-recorded layer)
+// share a mask. Paths are keyed by generation ID, so they only match at the same position.
+static void GetClipMaskKey(GrReducedClip::InitialState initialState,
+                           const GrReducedClip::ElementList& elements,
+                           const SkIRect& bounds, GrUniqueKey* key) {
+    const SkScalar dx = SkIntToScalar(-bounds.fLeft),
+                   dy = SkIntToScalar(-bounds.fTop);
+    SkTDArray<uint32_t> data;
+    *data.append() = initialState;
+    *data.append() = SkToU16(bounds.width()) | (SkToU16(bounds.height()) << 16);
+    for (GrReducedClip::ElementList::Iter iter(elements.headIter()); iter.get(); iter.next()) {
+        const Element* element = iter.get();
+        *data.append() = element->getType()                 |
+                         (element->getOp()            << 8) |
+                         (element->isAA()             << 16) |
+                         (element->isInverseFilled()  << 17);
+        switch (element->getType()) {
+            case Element::kEmpty_Type:
+                break;
+            case Element::kRect_Type: {
+                SkRect rect = element->getRect().makeOffset(dx, dy);
+                memcpy(data.append(4), &rect, sizeof(rect));
+                break;
+            }
+            case Element::kRRect_Type: {
+                SkRRect rrect = element->getRRect();
+                rrect.offset(dx, dy);
+                rrect.writeToMemory(data.append(SkRRect::kSizeInMemory / sizeof(uint32_t)));
+                break;
+            }
+            case Element::kPath_Type:
+                // The generation ID doesn't change with the fill type, so key that too.
+                *data.append() = element->getPath().getGenerationID();
+                *data.append() = element->getPath().getFillType();
+                *data.append() = bounds.fLeft;
+                *data.append() = bounds.fTop;
+                break;
+        }
+    }
+
     static const GrUniqueKey::Domain kDomain = GrUniqueKey::GenerateDomain();
-    GrUniqueKey::Builder builder(key, kDomain, 3);
-    builder[0] = clipGenID;
-    builder[1] = SkToU16(bounds.fLeft) | (SkToU16(bounds.fRight) << 16);
-    builder[2] = SkToU16(bounds.fTop) | (SkToU16(bounds.fBottom) << 16);
+    GrUniqueKey::Builder builder(key, kDomain, data.count());
+    memcpy(&builder[0], data.begin(), data.count() * sizeof(uint32_t));
 }
 
 sk_sp<GrTexture> GrClipMaskManager::CreateAlphaClipMask(GrContext* context,
-                                                        int32_t elementsGenID,
                                                         GrReducedClip::InitialState initialState,
                                                         const GrReducedClip::ElementList& elements,
                                                         const SkVector& clipToMaskOffset,
                                                         const SkIRect& clipSpaceIBounds) {
     GrResourceProvider* resourceProvider = context->resourceProvider();
     GrUniqueKey key;
-    GetClipMaskKey(elementsGenID, clipSpaceIBounds, &key);
+    GetClipMaskKey(initialState, elements, clipSpaceIBounds, &key);
     if (GrTexture* texture = resourceProvider->findAndRefTextureByUniqueKey(key)) {
         return sk_sp<GrTexture>(texture);
     }
@@ -741,13 +785,12 @@ bool GrClipMaskManager::CreateStencilClipMask(GrContext* context,
 ////////////////////////////////////////////////////////////////////////////////
 sk_sp<GrTexture> GrClipMaskManager::CreateSoftwareClipMask(
                                                     GrTextureProvider* texProvider,
-                                                    int32_t elementsGenID,
                                                     GrReducedClip::InitialState initialState,
                                                     const GrReducedClip::ElementList& elements,
                                                     const SkVector& clipToMaskOffset,
                                                     const SkIRect& clipSpaceIBounds) {
     GrUniqueKey key;
-    GetClipMaskKey(elementsGenID, clipSpaceIBounds, &key);
+    GetClipMaskKey(initialState, elements, clipSpaceIBounds, &key);
     if (GrTexture* texture = texProvider->findAndRefTextureByUniqueKey(key)) {
         return sk_sp<GrTexture>(texture);
     }
@@ -65,9 +65,9 @@ private:
                                       const SkIPoint& clipSpaceToStencilOffset);
 
     // Creates an alpha mask of the clip. The mask is a rasterization of elements through the
-    // rect specified by clipSpaceIBounds.
+    // rect specified by clipSpaceIBounds. Masks are cached by their content, so the same elements
+    // translated by whole pixels reuse the mask.
     static sk_sp<GrTexture> CreateAlphaClipMask(GrContext*,
-                                                int32_t elementsGenID,
                                                 GrReducedClip::InitialState initialState,
                                                 const GrReducedClip::ElementList& elements,
                                                 const SkVector& clipToMaskOffset,
@@ -75,7 +75,6 @@ private:
 
     // Similar to createAlphaClipMask but it rasterizes in SW and uploads to the result texture.
     static sk_sp<GrTexture> CreateSoftwareClipMask(GrTextureProvider*,
-                                                   int32_t elementsGenID,
                                                    GrReducedClip::InitialState initialState,
                                                    const GrReducedClip::ElementList& elements,
                                                    const SkVector& clipToMaskOffset,
@@ -13,6 +13,7 @@
 #include "GrResourceProvider.h"
 #include "GrSoftwarePathRenderer.h"
 #include "GrSurfacePriv.h"
+#include "GrTextureToYUVPlanes.h"
 
 #include "SkConfig8888.h"
 #include "SkGrPriv.h"
@@ -111,6 +112,8 @@ GrContext::~GrContext() {
     }
 
     this->flush();
+    // The transfer buffers are about to be released, so whatever hasn't landed never will.
+    this->failAsyncReadbacks(false);
 
     fDrawingManager->cleanup();
 
@@ -136,6 +139,7 @@ GrContextThreadSafeProxy* GrContext::threadSafeProxy() {
 void GrContext::abandonContext() {
     ASSERT_SINGLE_OWNER
 
+    this->failAsyncReadbacks(true);
     fResourceProvider->abandon();
 
     // Need to abandon the drawing manager first so all the render targets
@@ -155,6 +159,7 @@ void GrContext::abandonContext() {
 void GrContext::releaseResourcesAndAbandonContext() {
     ASSERT_SINGLE_OWNER
 
+    this->failAsyncReadbacks(false);
     fResourceProvider->abandon();
 
     // Need to abandon the drawing manager first so all the render targets
@@ -233,6 +238,13 @@ void GrContext::flush(int flagsBitfield) {
     }
     fResourceCache->notifyFlushOccurred();
     fFlushToReduceCacheSize = false;
+    this->checkAsyncReadbacks();
+}
+
+void GrContext::collectBatchGpuTimes() {
+    ASSERT_SINGLE_OWNER
+    RETURN_IF_ABANDONED
+    fDrawingManager->collectBatchGpuTimes(true);
 }
 
 bool sw_convert_to_premul(GrPixelConfig srcConfig, int width, int height, size_t inRowBytes,
@@ -523,6 +535,200 @@ bool GrContext::readSurfacePixels(GrSurface* src,
     return true;
 }
 
+bool GrContext::readSurfaceToBuffer(GrSurface* src, const SkIRect& rect, GrPixelConfig dstConfig,
+                                    GrBuffer* buffer, size_t offset) {
+    SkASSERT(SkIRect::MakeWH(src->width(), src->height()).contains(rect));
+    int left = rect.fLeft;
+    int top = rect.fTop;
+    int width = rect.width();
+    int height = rect.height();
+    size_t rowBytes = GrBytesPerPixel(dstConfig) * width;
+
+    if (src->surfacePriv().hasPendingWrite()) {
+        this->flush();
+    }
+
+    // GrGpu can't flip rows as it reads them into a buffer, so a bottom-left surface has to be
+    // drawn to a top-left temporary first.
+    GrGpu::DrawPreference drawPreference = GrGpu::kNoDraw_DrawPreference;
+    if (kBottomLeft_GrSurfaceOrigin == src->origin()) {
+        drawPreference = GrGpu::kRequireDraw_DrawPreference;
+    }
+    GrGpu::ReadPixelTempDrawInfo tempDrawInfo;
+    if (!fGpu->getReadPixelsInfo(src, width, height, rowBytes, dstConfig, &drawPreference,
+                                 &tempDrawInfo)) {
+        return false;
+    }
+
+    SkAutoTUnref<GrSurface> surfaceToRead(SkRef(src));
+    GrPixelConfig configToRead = dstConfig;
+    if (GrGpu::kNoDraw_DrawPreference != drawPreference) {
+        // As in readSurfacePixels, only respect this when the entire src is being read.
+        if (width != src->width() || height != src->height()) {
+            tempDrawInfo.fUseExactScratch = false;
+        }
+        SkAutoTUnref<GrTexture> temp;
+        if (tempDrawInfo.fUseExactScratch) {
+            temp.reset(this->textureProvider()->createTexture(tempDrawInfo.fTempSurfaceDesc,
+                                                              SkBudgeted::kYes));
+        } else {
+            temp.reset(this->textureProvider()->createApproxTexture(tempDrawInfo.fTempSurfaceDesc));
+        }
+        sk_sp<GrFragmentProcessor> fp;
+        if (temp) {
+            SkMatrix textureMatrix;
+            textureMatrix.setTranslate(SkIntToScalar(left), SkIntToScalar(top));
+            textureMatrix.postIDiv(src->width(), src->height());
+            fp = GrConfigConversionEffect::Make(src->asTexture(), tempDrawInfo.fSwizzle,
+                                                GrConfigConversionEffect::kNone_PMConversion,
+                                                textureMatrix);
+        }
+        if (fp) {
+            GrPaint paint;
+            paint.addColorFragmentProcessor(std::move(fp));
+            paint.setPorterDuffXPFactory(SkXfermode::kSrc_Mode);
+            paint.setAllowSRGBInputs(true);
+            SkRect drawRect = SkRect::MakeIWH(width, height);
+            sk_sp<GrDrawContext> drawContext(this->drawContext(sk_ref_sp(temp->asRenderTarget())));
+            drawContext->drawRect(GrNoClip(), paint, SkMatrix::I(), drawRect, nullptr);
+            this->flushSurfaceWrites(temp);
+            surfaceToRead.reset(SkRef(temp.get()));
+            left = 0;
+            top = 0;
+            configToRead = tempDrawInfo.fReadConfig;
+        } else if (GrGpu::kRequireDraw_DrawPreference == drawPreference) {
+            return false;
+        }
+    }
+    return fGpu->readPixelsToBuffer(surfaceToRead, left, top, width, height, configToRead,
+                                    buffer, offset, rowBytes);
+}
+
+sk_sp<GrAsyncReadback> GrContext::startAsyncReadback(sk_sp<GrAsyncReadback> readback) {
+    GrFence fence = fGpu->insertFence();
+    if (!fence) {
+        return nullptr;
+    }
+    readback->setFence(fence);
+    *fPendingReadbacks.append() = SkRef(readback.get());
+    return readback;
+}
+
+sk_sp<GrAsyncReadback> GrContext::readSurfacePixelsAsync(GrSurface* src,
+                                                         int left, int top, int width, int height,
+                                                         GrPixelConfig config,
+                                                         GrAsyncReadback::FinishedProc proc,
+                                                         void* finishedContext) {
+    ASSERT_SINGLE_OWNER
+    RETURN_NULL_IF_ABANDONED
+    ASSERT_OWNED_RESOURCE(src);
+    SkASSERT(src);
+    GR_AUDIT_TRAIL_AUTO_FRAME(&fAuditTrail, "GrContext::readSurfacePixelsAsync");
+
+    if (!fCaps->fenceSyncSupport() || !(GrCaps::kCanMap_MapFlag & fCaps->mapBufferFlags()) ||
+        GrPixelConfigIsCompressed(config)) {
+        return nullptr;
+    }
+    // Unlike readSurfacePixels there's no client buffer to trim along with the rectangle, so it
+    // has to lie within the surface.
+    SkIRect rect = SkIRect::MakeXYWH(left, top, width, height);
+    if (rect.isEmpty() || !SkIRect::MakeWH(src->width(), src->height()).contains(rect)) {
+        return nullptr;
+    }
+
+    size_t rowBytes = GrBytesPerPixel(config) * width;
+    SkAutoTUnref<GrBuffer> buffer(fResourceProvider->createBuffer(rowBytes * height,
+                                                                  kXferGpuToCpu_GrBufferType,
+                                                                  kStream_GrAccessPattern, 0));
+    if (!buffer || !this->readSurfaceToBuffer(src, rect, config, buffer, 0)) {
+        return nullptr;
+    }
+    sk_sp<GrAsyncReadback> readback(new GrAsyncReadback(this, buffer, proc, finishedContext));
+    readback->addPlane(rect.size(), config, 0, rowBytes);
+    return this->startAsyncReadback(std::move(readback));
+}
+
+sk_sp<GrAsyncReadback> GrContext::readTextureYUVPlanesAsync(GrTexture* texture,
+                                                            const SkISize sizes[3],
+                                                            SkYUVColorSpace colorSpace,
+                                                            GrAsyncReadback::FinishedProc proc,
+                                                            void* finishedContext) {
+    ASSERT_SINGLE_OWNER
+    RETURN_NULL_IF_ABANDONED
+    ASSERT_OWNED_RESOURCE(texture);
+    SkASSERT(texture);
+    GR_AUDIT_TRAIL_AUTO_FRAME(&fAuditTrail, "GrContext::readTextureYUVPlanesAsync");
+
+    if (!fCaps->fenceSyncSupport() || !(GrCaps::kCanMap_MapFlag & fCaps->mapBufferFlags())) {
+        return nullptr;
+    }
+    for (int i = 0; i < 3; ++i) {
+        if (sizes[i].isEmpty()) {
+            return nullptr;
+        }
+    }
+
+    sk_sp<GrDrawContext> planes[3];
+    if (!GrTextureToYUVDrawContexts(texture, sizes, colorSpace, planes)) {
+        return nullptr;
+    }
+
+    // All three planes share one buffer.
+    size_t offsets[3];
+    size_t bufferSize = 0;
+    for (int i = 0; i < 3; ++i) {
+        offsets[i] = bufferSize;
+        bufferSize += SkAlign4(sizes[i].fWidth * sizes[i].fHeight);
+    }
+    SkAutoTUnref<GrBuffer> buffer(fResourceProvider->createBuffer(bufferSize,
+                                                                  kXferGpuToCpu_GrBufferType,
+                                                                  kStream_GrAccessPattern, 0));
+    if (!buffer) {
+        return nullptr;
+    }
+    sk_sp<GrAsyncReadback> readback(new GrAsyncReadback(this, buffer, proc, finishedContext));
+    for (int i = 0; i < 3; ++i) {
+        sk_sp<GrTexture> planeTex(planes[i]->asTexture());
+        SkASSERT(planeTex);
+        if (!this->readSurfaceToBuffer(planeTex.get(), SkIRect::MakeSize(sizes[i]),
+                                       kAlpha_8_GrPixelConfig, buffer, offsets[i])) {
+            return nullptr;
+        }
+        readback->addPlane(sizes[i], kAlpha_8_GrPixelConfig, offsets[i], sizes[i].fWidth);
+    }
+    return this->startAsyncReadback(std::move(readback));
+}
+
+void GrContext::checkAsyncReadbacks() {
+    ASSERT_SINGLE_OWNER
+    RETURN_IF_ABANDONED
+
+    // Fences pass in the order they were inserted, so stop at the first that hasn't. The readback
+    // leaves the list before its FinishedProc runs in case the proc starts another.
+    while (!fPendingReadbacks.isEmpty()) {
+        GrAsyncReadback* readback = fPendingReadbacks[0];
+        if (!readback->fFinished && !fGpu->waitFence(readback->fFence, 0)) {
+            break;
+        }
+        fPendingReadbacks.remove(0);
+        if (!readback->fFinished) {
+            readback->finish(false);
+        }
+        readback->unref();
+    }
+}
+
+void GrContext::failAsyncReadbacks(bool contextLost) {
+    SkTDArray<GrAsyncReadback*> pending;
+    pending.swap(fPendingReadbacks);
+    for (int i = 0; i < pending.count(); ++i) {
+        if (!pending[i]->fFinished) {
+            pending[i]->finish(true, contextLost);
+        }
+        pending[i]->unref();
+    }
+}
+
 bool GrContext::applyGamma(GrRenderTarget* dst, GrTexture* src, SkScalar gamma){
     ASSERT_SINGLE_OWNER
     RETURN_FALSE_IF_ABANDONED
@@ -756,7 +962,18 @@ void GrContext::getResourceCacheLimits(int* maxTextures, size_t* maxTextureBytes
 
 void GrContext::setResourceCacheLimits(int maxTextures, size_t maxTextureBytes) {
     ASSERT_SINGLE_OWNER
-    fResourceCache->setLimits(maxTextures, maxTextureBytes);
+    fResourceCache->setLimits(maxTextures, maxTextureBytes, fResourceCache->getMaxUnusedFlushes());
+}
+
+void GrContext::setResourceCacheMaxUnusedFlushes(int maxUnusedFlushes) {
+    ASSERT_SINGLE_OWNER
+    fResourceCache->setLimits(fResourceCache->getMaxResourceCount(),
+                              fResourceCache->getMaxResourceBytes(), maxUnusedFlushes);
+}
+
+void GrContext::purgeUnlockedResourcesToBytes(size_t maxResourceBytes) {
+    ASSERT_SINGLE_OWNER
+    fResourceCache->purgeUnlockedToBytes(maxResourceBytes);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -764,4 +981,5 @@ void GrContext::setResourceCacheLimits(int maxTextures, size_t maxTextureBytes)
 void GrContext::dumpMemoryStatistics(SkTraceMemoryDump* traceMemoryDump) const {
     ASSERT_SINGLE_OWNER
     fResourceCache->dumpMemoryStatistics(traceMemoryDump);
+    fGpu->dumpMemoryStatistics(traceMemoryDump);
 }
@@ -12,6 +12,7 @@
 #include "GrDrawingManager.h"
 #include "GrOvalRenderer.h"
 #include "GrPathRenderer.h"
+#include "GrReducedClip.h"
 #include "GrRenderTarget.h"
 #include "GrRenderTargetPriv.h"
 #include "GrResourceProvider.h"
@@ -684,6 +685,34 @@ void GrDrawContext::fillRectWithLocalMatrix(const GrClip& clip,
 
 }
 
+bool GrDrawContext::fillRRectWithLocalMatrix(const GrClip& clip,
+                                             const GrPaint& paint,
+                                             const SkMatrix& viewMatrix,
+                                             const SkRRect& rrect,
+                                             const SkMatrix& localMatrix) {
+    ASSERT_SINGLE_OWNER
+    RETURN_FALSE_IF_ABANDONED
+    SkDEBUGCODE(this->validate();)
+    GR_AUDIT_TRAIL_AUTO_FRAME(fAuditTrail, "GrDrawContext::fillRRectWithLocalMatrix");
+
+    InstancedRendering* ir = this->getDrawTarget()->instancedRendering();
+    if (!ir) {
+        return false;
+    }
+
+    AutoCheckFlush acf(fDrawingManager);
+    bool useHWAA;
+    SkAutoTUnref<GrDrawBatch> batch(ir->recordRRect(rrect, viewMatrix, paint.getColor(),
+                                                    localMatrix, paint.isAntiAlias(),
+                                                    fInstancedPipelineInfo, &useHWAA));
+    if (!batch) {
+        return false;
+    }
+    GrPipelineBuilder pipelineBuilder(paint, useHWAA);
+    this->getDrawTarget()->drawBatch(pipelineBuilder, this, clip, batch);
+    return true;
+}
+
 void GrDrawContext::drawVertices(const GrClip& clip,
                                  const GrPaint& paint,
                                  const SkMatrix& viewMatrix,
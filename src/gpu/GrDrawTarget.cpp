@@ -8,6 +8,7 @@
 #include "GrDrawTarget.h"
 
 #include "GrAuditTrail.h"
+#include "GrBatchTimer.h"
 #include "GrCaps.h"
 #include "GrDrawContext.h"
 #include "GrGpu.h"
@@ -24,6 +25,8 @@
 #include "gl/GrGLRenderTarget.h"
 
 #include "SkStrokeRec.h"
+#include "SkTemplates.h"
+#include "SkTraceEvent.h"
 
 #include "batches/GrClearStencilClipBatch.h"
 #include "batches/GrCopySurfaceBatch.h"
@@ -37,13 +40,16 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 
-// Experimentally we have found that most batching occurs within the first 10 comparisons.
+// Experimentally we have found that most batching occurs within the first 10 comparisons.  We
+// only compare batches of the same class, however far apart they are recorded.
 static const int kDefaultMaxBatchLookback  = 10;
 static const int kDefaultMaxBatchLookahead = 10;
 
 GrDrawTarget::GrDrawTarget(GrRenderTarget* rt, GrGpu* gpu, GrResourceProvider* resourceProvider,
                            GrAuditTrail* auditTrail, const Options& options)
-    : fGpu(SkRef(gpu))
+    : fRunStart(0)
+    , fRunRenderTargetUniqueID(SK_InvalidUniqueID)
+    , fGpu(SkRef(gpu))
     , fResourceProvider(resourceProvider)
     , fAuditTrail(auditTrail)
     , fFlags(0)
@@ -99,6 +105,9 @@ void GrDrawTarget::addDependency(GrSurface* dependedOn) {
             // self-read - presumably for dst reads
         } else {
             this->addDependency(dt);
+            if (dt->fReaders.find(this) < 0) {
+                *dt->fReaders.append() = this;
+            }
 
             // Can't make it closed in the self-read case
             dt->makeClosed();
@@ -215,6 +224,8 @@ void GrDrawTarget::prepareBatches(GrBatchFlushState* flushState) {
 }
 
 void GrDrawTarget::drawBatches(GrBatchFlushState* flushState) {
+    TRACE_EVENT1("disabled-by-default-skia.gpu", "GrDrawTarget::drawBatches()",
+                 "batches", fRecordedBatches.count());
     // Draw all the generated geometry.
     SkRandom random;
     GrRenderTarget* currentRT = nullptr;
@@ -261,7 +272,15 @@ void GrDrawTarget::drawBatches(GrBatchFlushState* flushState) {
                 fGpu->drawDebugWireRect(rt, ibounds, 0xFF000000 | random.nextU());
             }
         }
+        GrTimerQuery query = 0;
+        if (commandBuffer && flushState->batchTimer()) {
+            query = flushState->batchTimer()->begin(commandBuffer,
+                                                    fRecordedBatches[i].fBatch.get());
+        }
         fRecordedBatches[i].fBatch->draw(flushState);
+        if (query) {
+            flushState->batchTimer()->end(commandBuffer, query);
+        }
     }
     if (commandBuffer) {
         commandBuffer->end();
@@ -279,7 +298,12 @@ void GrDrawTarget::drawBatches(GrBatchFlushState* flushState) {
 }
 
 void GrDrawTarget::reset() {
+    fReaders.reset();
     fRecordedBatches.reset();
+    fBoundsIndex.reset();
+    fLastOfClass.reset();
+    fRunStart = 0;
+    fRunRenderTargetUniqueID = SK_InvalidUniqueID;
     if (fInstancedRendering) {
         fInstancedRendering->endFlush();
     }
@@ -476,11 +500,6 @@ bool GrDrawTarget::copySurface(GrSurface* dst,
     return true;
 }
 
-static inline bool can_reorder(const SkRect& a, const SkRect& b) {
-    return a.fRight <= b.fLeft || a.fBottom <= b.fTop ||
-           b.fRight <= a.fLeft || b.fBottom <= a.fTop;
-}
-
 static void join(SkRect* out, const SkRect& a, const SkRect& b) {
     SkASSERT(a.fLeft <= a.fRight && a.fTop <= a.fBottom);
     SkASSERT(b.fLeft <= b.fRight && b.fTop <= b.fBottom);
@@ -494,10 +513,11 @@ void GrDrawTarget::recordBatch(GrBatch* batch, const SkRect& clippedBounds) {
     // A closed drawTarget should never receive new/more batches
     SkASSERT(!this->isClosed());
 
-    // Check if there is a Batch Draw we can batch with by linearly searching back until we either
-    // 1) check every draw
-    // 2) intersect with something
-    // 3) find a 'blocker'
+    // Check if there is a Batch Draw we can batch with by walking back through the batches of the
+    // same class until we either
+    // 1) check every one of them
+    // 2) pass the last batch we intersect with, or a change of render target
+    // 3) hit the limit on how many we may try
     GR_AUDIT_TRAIL_ADDBATCH(fAuditTrail, batch);
     GrBATCH_INFO("Re-Recording (%s, B%u)\n"
         "\tBounds LRTB (%f, %f, %f, %f)\n",
@@ -510,82 +530,103 @@ void GrDrawTarget::recordBatch(GrBatch* batch, const SkRect& clippedBounds) {
                  clippedBounds.fLeft, clippedBounds.fTop, clippedBounds.fRight,
                  clippedBounds.fBottom);
     GrBATCH_INFO("\tOutcome:\n");
-    int maxCandidates = SkTMin(fMaxBatchLookback, fRecordedBatches.count());
-    if (maxCandidates) {
-        int i = 0;
-        while (true) {
-            GrBatch* candidate = fRecordedBatches.fromBack(i).fBatch.get();
-            // We cannot continue to search backwards if the render target changes
-            if (candidate->renderTargetUniqueID() != batch->renderTargetUniqueID()) {
-                GrBATCH_INFO("\t\tBreaking because of (%s, B%u) Rendertarget\n",
-                    candidate->name(), candidate->uniqueID());
+    if (fRecordedBatches.empty()) {
+        GrBATCH_INFO("\t\tFirstBatch\n");
+    }
+    if (batch->renderTargetUniqueID() != fRunRenderTargetUniqueID) {
+        fRunStart = fRecordedBatches.count();
+        fRunRenderTargetUniqueID = batch->renderTargetUniqueID();
+    }
+
+    const int* lastOfClass = fLastOfClass.find(batch->classID());
+    if (lastOfClass) {
+        // Combining with a batch moves us back to it, so nothing recorded after it may intersect
+        // us.  The last batch we intersect is itself fair game.
+        int limit = SkTMax(fRunStart, fBoundsIndex.lastOverlap(clippedBounds));
+        int tries = 0;
+        for (int i = *lastOfClass; i >= limit; i = fRecordedBatches[i].fPrevOfClass) {
+            RecordedBatch& recorded = fRecordedBatches[i];
+            GrBatch* candidate = recorded.fBatch.get();
+            if (!candidate) {
+                continue;  // Already combined forward.
+            }
+            if (tries++ == fMaxBatchLookback) {
+                GrBATCH_INFO("\t\tReached max lookback %d\n", tries);
                 break;
             }
             if (candidate->combineIfPossible(batch, *this->caps())) {
                 GrBATCH_INFO("\t\tCombining with (%s, B%u)\n", candidate->name(),
                     candidate->uniqueID());
                 GR_AUDIT_TRAIL_BATCHING_RESULT_COMBINED(fAuditTrail, candidate, batch);
-                join(&fRecordedBatches.fromBack(i).fClippedBounds,
-                     fRecordedBatches.fromBack(i).fClippedBounds, clippedBounds);
+                join(&recorded.fClippedBounds, recorded.fClippedBounds, clippedBounds);
+                fBoundsIndex.set(i, recorded.fClippedBounds);
                 return;
             }
-            // Stop going backwards if we would cause a painter's order violation.
-            const SkRect& candidateBounds = fRecordedBatches.fromBack(i).fClippedBounds;
-            if (!can_reorder(candidateBounds, clippedBounds)) {
-                GrBATCH_INFO("\t\tIntersects with (%s, B%u)\n", candidate->name(),
-                    candidate->uniqueID());
-                break;
-            }
-            ++i;
-            if (i == maxCandidates) {
-                GrBATCH_INFO("\t\tReached max lookback or beginning of batch array %d\n", i);
-                break;
-            }
         }
-    } else {
-        GrBATCH_INFO("\t\tFirstBatch\n");
     }
     GR_AUDIT_TRAIL_BATCHING_RESULT_NEW(fAuditTrail, batch);
-    fRecordedBatches.emplace_back(RecordedBatch{sk_ref_sp(batch), clippedBounds});
+    int index = fRecordedBatches.count();
+    fRecordedBatches.emplace_back(RecordedBatch{sk_ref_sp(batch), clippedBounds,
+                                                lastOfClass ? *lastOfClass : -1});
+    fLastOfClass.set(batch->classID(), index);
+    fBoundsIndex.set(index, clippedBounds);
 }
 
 void GrDrawTarget::forwardCombine() {
-    for (int i = 0; i < fRecordedBatches.count() - 2; ++i) {
+    const int count = fRecordedBatches.count();
+    if (count < 3) {
+        return;
+    }
+
+    // Turn each class's chain of previous batches around.
+    SkAutoSTMalloc<256, int> nextOfClass(count);
+    for (int i = 0; i < count; ++i) {
+        nextOfClass[i] = -1;
+        if (fRecordedBatches[i].fPrevOfClass >= 0) {
+            nextOfClass[fRecordedBatches[i].fPrevOfClass] = i;
+        }
+    }
+
+    int runEnd = 0;
+    for (int i = 0; i < count - 2; ++i) {
         GrBatch* batch = fRecordedBatches[i].fBatch.get();
+        if (!batch) {
+            continue;
+        }
+        // We cannot continue to search past a change of render target.
+        if (i >= runEnd) {
+            for (runEnd = i + 1; runEnd < count; ++runEnd) {
+                GrBatch* next = fRecordedBatches[runEnd].fBatch.get();
+                if (next && next->renderTargetUniqueID() != batch->renderTargetUniqueID()) {
+                    break;
+                }
+            }
+        }
         const SkRect& batchBounds = fRecordedBatches[i].fClippedBounds;
-        int maxCandidateIdx = SkTMin(i + fMaxBatchLookahead, fRecordedBatches.count() - 1);
-        int j = i + 1;
-        while (true) {
+        // Combining with a batch moves us forward to it, so nothing recorded before it may
+        // intersect us.
+        int limit = SkTMin(runEnd - 1, fBoundsIndex.firstOverlapAfter(i, batchBounds));
+        int tries = 0;
+        for (int j = nextOfClass[i]; j >= 0 && j <= limit; j = nextOfClass[j]) {
             GrBatch* candidate = fRecordedBatches[j].fBatch.get();
-            // We cannot continue to search if the render target changes
-            if (candidate->renderTargetUniqueID() != batch->renderTargetUniqueID()) {
-                GrBATCH_INFO("\t\tBreaking because of (%s, B%u) Rendertarget\n",
-                             candidate->name(), candidate->uniqueID());
-                break;
-            }
-            if (j == i +1) {
+            if (j == i + 1) {
                 // We assume batch would have combined with candidate when the candidate was added
                 // via backwards combining in recordBatch.
                 SkASSERT(!batch->combineIfPossible(candidate, *this->caps()));
-            } else if (batch->combineIfPossible(candidate, *this->caps())) {
+                continue;
+            }
+            if (tries++ == fMaxBatchLookahead) {
+                GrBATCH_INFO("\t\tReached max lookahead %d\n", tries);
+                break;
+            }
+            if (batch->combineIfPossible(candidate, *this->caps())) {
                 GrBATCH_INFO("\t\tCombining with (%s, B%u)\n", candidate->name(),
                              candidate->uniqueID());
-                GR_AUDIT_TRAIL_BATCHING_RESULT_COMBINED(fAuditTrail, batch, candidate);
+                GR_AUDIT_TRAIL_BATCHING_RESULT_COMBINED_FORWARD(fAuditTrail, batch, candidate);
                 fRecordedBatches[j].fBatch = std::move(fRecordedBatches[i].fBatch);
                 join(&fRecordedBatches[j].fClippedBounds, fRecordedBatches[j].fClippedBounds,
                      batchBounds);
-                break;
-            }
-            // Stop going traversing if we would cause a painter's order violation.
-            const SkRect& candidateBounds = fRecordedBatches[j].fClippedBounds;
-            if (!can_reorder(candidateBounds, batchBounds)) {
-                GrBATCH_INFO("\t\tIntersects with (%s, B%u)\n", candidate->name(),
-                             candidate->uniqueID());
-                break;
-            }
-            ++j;
-            if (j > maxCandidateIdx) {
-                GrBATCH_INFO("\t\tReached max lookahead or end of batch array %d\n", i);
+                fBoundsIndex.set(j, fRecordedBatches[j].fClippedBounds);
                 break;
             }
         }
@@ -8,6 +8,7 @@
 #ifndef GrDrawTarget_DEFINED
 #define GrDrawTarget_DEFINED
 
+#include "GrBatchBoundsIndex.h"
 #include "GrClip.h"
 #include "GrContext.h"
 #include "GrPathProcessor.h"
@@ -23,6 +24,7 @@
 #include "SkStringUtils.h"
 #include "SkStrokeRec.h"
 #include "SkTArray.h"
+#include "SkTHash.h"
 #include "SkTLazy.h"
 #include "SkTypes.h"
 #include "SkXfermode.h"
@@ -212,8 +214,19 @@ private:
     struct RecordedBatch {
         sk_sp<GrBatch> fBatch;
         SkRect         fClippedBounds;
+        // The index of the previous recorded batch of the same class, or -1.
+        int            fPrevOfClass;
     };
     SkSTArray<256, RecordedBatch, true>             fRecordedBatches;
+    // Where each recorded batch's fClippedBounds currently reach, for finding painter's order
+    // blockers without walking the batches in between.
+    GrBatchBoundsIndex                              fBoundsIndex;
+    // The last recorded batch of each class, heading its fPrevOfClass chain.
+    SkTHashMap<uint32_t, int>                       fLastOfClass;
+    // Batches can't be reordered across a change of render target, so we remember where the
+    // trailing run of batches for one render target starts.
+    int                                             fRunStart;
+    uint32_t                                        fRunRenderTargetUniqueID;
     // The context is only in service of the clip mask manager, remove once CMM doesn't need this.
     GrContext*                                      fContext;
     GrGpu*                                          fGpu;
@@ -225,6 +238,9 @@ private:
 
     // 'this' drawTarget relies on the output of the drawTargets in 'fDependencies'
     SkTDArray<GrDrawTarget*>                        fDependencies;
+    // The drawTargets in 'fReaders' rely on the output of 'this' one, so they must run before
+    // anything overwrites it
+    SkTDArray<GrDrawTarget*>                        fReaders;
     GrRenderTarget*                                 fRenderTarget;
 
     bool                                            fClipBatchToBounds;
@@ -12,6 +12,7 @@
 #include "GrResourceProvider.h"
 #include "GrSoftwarePathRenderer.h"
 #include "SkTTopoSort.h"
+#include "SkTraceEvent.h"
 
 #include "instanced/InstancedRendering.h"
 
@@ -33,6 +34,8 @@ void GrDrawingManager::cleanup() {
 
     fDrawTargets.reset();
 
+    fBatchTimer.reset();
+
     delete fPathRendererChain;
     fPathRendererChain = nullptr;
     SkSafeSetNull(fSoftwarePathRenderer);
@@ -49,6 +52,7 @@ void GrDrawingManager::abandon() {
             ir->resetGpuResources(InstancedRendering::ResetType::kAbandon);
         }
     }
+    fBatchTimer.abandon();
     this->cleanup();
 }
 
@@ -76,10 +80,16 @@ void GrDrawingManager::flush() {
         return;
     }
     fFlushing = true;
+    TRACE_EVENT0("disabled-by-default-skia.gpu", "GrDrawingManager::flush()");
 
     SkDEBUGCODE(bool result =)
                         SkTTopoSort<GrDrawTarget, GrDrawTarget::TopoSortTraits>(&fDrawTargets);
     SkASSERT(result);
+    this->groupDrawTargetsByRenderTarget();
+
+    if (fSoftwarePathRenderer) {
+        fSoftwarePathRenderer->prepareMaskUploads(&fFlushState);
+    }
 
     for (int i = 0; i < fDrawTargets.count(); ++i) {
         fDrawTargets[i]->prepareBatches(&fFlushState);
@@ -121,9 +131,58 @@ void GrDrawingManager::flush() {
 #endif
 
     fFlushState.reset();
+    // Pick up the times of batches from earlier flushes that the GPU has since finished.
+    fBatchTimer.collect(false);
     fFlushing = false;
 }
 
+// Switching render targets is expensive, especially on tiled GPUs, which must store out the tiles
+// of one target and load in those of the next.  So we reorder the (already topologically sorted)
+// drawTargets: each time, of those whose dependencies have all been placed, we take the first one
+// for the render target we're on, or failing that, the first one.
+void GrDrawingManager::groupDrawTargetsByRenderTarget() {
+    const int count = fDrawTargets.count();
+    if (count < 3) {
+        return;
+    }
+
+    SkTDArray<GrDrawTarget*> result;
+    result.setReserve(count);
+    SkTDArray<GrDrawTarget*> remaining(fDrawTargets);
+
+    auto isReady = [&result](const GrDrawTarget* dt) {
+        for (int i = 0; i < dt->fDependencies.count(); ++i) {
+            if (result.find(dt->fDependencies[i]) < 0) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    const GrRenderTarget* lastRT = nullptr;
+    while (remaining.count()) {
+        int next = -1;
+        for (int i = 0; i < remaining.count(); ++i) {
+            if (isReady(remaining[i])) {
+                if (next < 0) {
+                    next = i;
+                }
+                if (remaining[i]->fRenderTarget == lastRT) {
+                    next = i;
+                    break;
+                }
+            }
+        }
+        // The topological sort guarantees there's no loop, and so always something ready.
+        SkASSERT(next >= 0);
+
+        lastRT = remaining[next]->fRenderTarget;
+        *result.append() = remaining[next];
+        remaining.remove(next);
+    }
+    fDrawTargets.swap(result);
+}
+
 GrDrawTarget* GrDrawingManager::newDrawTarget(GrRenderTarget* rt) {
     SkASSERT(fContext);
 
@@ -139,9 +198,26 @@ GrDrawTarget* GrDrawingManager::newDrawTarget(GrRenderTarget* rt) {
     }
 #endif
 
+    GrDrawTarget* prev = rt->getLastDrawTarget();
+    if (prev && fDrawTargets.find(prev) < 0) {
+        prev = nullptr;     // Already flushed.
+    }
+
     GrDrawTarget* dt = new GrDrawTarget(rt, fContext->getGpu(), fContext->resourceProvider(),
                                         fContext->getAuditTrail(), fOptionsForDrawTargets);
 
+    // The new drawTarget overwrites what rt's previous one drew, so it must run after that one
+    // and after everything that read its results.  Those readers can't take any more batches,
+    // or they might read the new contents too.
+    if (prev) {
+        prev->makeClosed();
+        dt->addDependency(prev);
+        for (int i = 0; i < prev->fReaders.count(); ++i) {
+            prev->fReaders[i]->makeClosed();
+            dt->addDependency(prev->fReaders[i]);
+        }
+    }
+
     *fDrawTargets.append() = dt;
 
     // DrawingManager gets the creation ref - this ref is for the caller
@@ -166,7 +242,7 @@ GrPathRenderer* GrDrawingManager::getPathRenderer(const GrPathRenderer::CanDrawP
     GrPathRenderer* pr = fPathRendererChain->getPathRenderer(args, drawType, stencilSupport);
     if (!pr && allowSW) {
         if (!fSoftwarePathRenderer) {
-            fSoftwarePathRenderer = new GrSoftwarePathRenderer(fContext->textureProvider());
+            fSoftwarePathRenderer = new GrSoftwarePathRenderer(fContext->resourceProvider());
         }
         pr = fSoftwarePathRenderer;
     }
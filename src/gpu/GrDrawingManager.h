@@ -10,6 +10,7 @@
 
 #include "GrDrawTarget.h"
 #include "GrBatchFlushState.h"
+#include "GrBatchTimer.h"
 #include "GrPathRendererChain.h"
 #include "GrPathRenderer.h"
 #include "SkTDArray.h"
@@ -56,7 +57,9 @@ private:
         , fPathRendererChain(nullptr)
         , fSoftwarePathRenderer(nullptr)
         , fFlushState(context->getGpu(), context->resourceProvider())
+        , fBatchTimer(context->getGpu(), context->getAuditTrail())
         , fFlushing(false) {
+        fFlushState.setBatchTimer(&fBatchTimer);
     }
 
     void abandon();
@@ -64,7 +67,13 @@ private:
     void reset();
     void flush();
 
-    friend class GrContext;  // for access to: ctor, abandon, reset & flush
+    // Reorders fDrawTargets, within their dependencies, to run those for one render target together.
+    void groupDrawTargetsByRenderTarget();
+
+    // Adds the GPU times of batches drawn while the audit trail was enabled to the audit trail.
+    void collectBatchGpuTimes(bool wait) { fBatchTimer.collect(wait); }
+
+    friend class GrContext;  // for access to: ctor, abandon, reset, flush & collectBatchGpuTimes
 
     static const int kNumPixelGeometries = 5; // The different pixel geometries
     static const int kNumDFTOptions = 2;      // DFT or no DFT
@@ -82,6 +91,7 @@ private:
     GrSoftwarePathRenderer*     fSoftwarePathRenderer;
 
     GrBatchFlushState           fFlushState;
+    GrBatchTimer                fBatchTimer;
     bool                        fFlushing;
 };
 
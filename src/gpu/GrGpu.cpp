@@ -405,6 +405,27 @@ bool GrGpu::transferPixels(GrSurface* surface,
     return false;
 }
 
+bool GrGpu::readPixelsToBuffer(GrSurface* surface,
+                               int left, int top, int width, int height,
+                               GrPixelConfig config, GrBuffer* transferBuffer,
+                               size_t offset, size_t rowBytes) {
+    SkASSERT(transferBuffer);
+    SkASSERT(kXferGpuToCpu_GrBufferType == transferBuffer->intendedType());
+
+    if (GrPixelConfigIsCompressed(config)) {
+        return false;
+    }
+    // There's no client memory to clip against, so the rectangle must lie within the surface.
+    if (left < 0 || top < 0 || width <= 0 || height <= 0 ||
+        left + width > surface->width() || top + height > surface->height()) {
+        return false;
+    }
+
+    this->handleDirtyContext();
+    return this->onReadPixelsToBuffer(surface, left, top, width, height, config,
+                                      transferBuffer, offset, rowBytes);
+}
+
 void GrGpu::resolveRenderTarget(GrRenderTarget* target) {
     SkASSERT(target);
     this->handleDirtyContext();
@@ -38,6 +38,7 @@ class GrStencilAttachment;
 class GrStencilSettings;
 class GrSurface;
 class GrTexture;
+class SkTraceMemoryDump;
 
 namespace gr_instanced { class InstancedRendering; }
 
@@ -77,6 +78,10 @@ public:
     // before GrContext.
     virtual void disconnect(DisconnectType);
 
+    // Reports backend memory that isn't owned by any one GrGpuResource, like the heaps resources
+    // suballocate from.
+    virtual void dumpMemoryStatistics(SkTraceMemoryDump*) const {}
+
     /**
      * The GrGpu object normally assumes that no outsider is setting state
      * within the underlying 3D API's context/device/whatever. This call informs
@@ -309,6 +314,55 @@ public:
                         GrPixelConfig config, GrBuffer* transferBuffer,
                         size_t offset, size_t rowBytes);
 
+    /**
+     * Starts copying a rectangle of a render target into a buffer without waiting for the GPU to
+     * finish. Unlike readPixels no intermediate draw is performed, so the surface must already
+     * satisfy a straight read: getReadPixelsInfo() must report kNoDraw_DrawPreference for the
+     * rectangle and config. Insert a fence afterwards to learn when the buffer can be mapped.
+     *
+     * @param surface          The surface to read from.
+     * @param left             left edge of the rectangle to read (inclusive)
+     * @param top              top edge of the rectangle to read (inclusive)
+     * @param width            width of rectangle to read in pixels.
+     * @param height           height of rectangle to read in pixels.
+     * @param config           the pixel config of the destination buffer
+     * @param transferBuffer   GrBuffer to write pixels to (type must be "kGpuToCpu")
+     * @param offset           offset from the start of the buffer
+     * @param rowBytes         number of bytes between consecutive rows. Zero
+     *                         means rows are tightly packed.
+     */
+    bool readPixelsToBuffer(GrSurface* surface,
+                            int left, int top, int width, int height,
+                            GrPixelConfig config, GrBuffer* transferBuffer,
+                            size_t offset, size_t rowBytes);
+
+    /**
+     * Fences mark a point in the command stream. They are only supported when
+     * GrCaps::fenceSyncSupport() is true; otherwise insertFence() returns 0.
+     *
+     * waitFence() returns true once every command issued before the fence has completed. A timeout
+     * of zero polls without blocking. Each inserted fence must eventually be deleted.
+     */
+    virtual GrFence SK_WARN_UNUSED_RESULT insertFence() = 0;
+    virtual bool waitFence(GrFence, uint64_t timeout = 0) = 0;
+    virtual void deleteFence(GrFence) = 0;
+
+    /**
+     * Timer queries measure how long the GPU spends on the commands a GrGpuCommandBuffer issues
+     * between its beginTimerQuery() and endTimerQuery(). They are only supported when
+     * GrCaps::timerQuerySupport() is true; otherwise createTimerQuery() returns 0.
+     *
+     * timerQueryResult() returns false until the GPU has finished the timed commands, unless
+     * 'wait' is set, in which case it blocks until they are done. timerQueriesDisjoint() returns
+     * true if the GPU's timing was disrupted since it was last called (e.g. its clock changed
+     * speed), in which case the results of every query in flight are unreliable. Each created query
+     * must eventually be deleted.
+     */
+    virtual GrTimerQuery SK_WARN_UNUSED_RESULT createTimerQuery() = 0;
+    virtual bool timerQueryResult(GrTimerQuery, bool wait, uint64_t* nanoseconds) = 0;
+    virtual bool timerQueriesDisjoint() = 0;
+    virtual void deleteTimerQuery(GrTimerQuery) = 0;
+
     /**
      * This is can be called before allocating a texture to be a dst for copySurface. It will
      * populate the origin, config, and flags fields of the desc such that copySurface can
@@ -384,6 +438,7 @@ public:
         void reset() {
             fRenderTargetBinds = 0;
             fShaderCompilations = 0;
+            fProgramLinkWaits = 0;
             fTextureCreates = 0;
             fTextureUploads = 0;
             fTransfersToTexture = 0;
@@ -396,6 +451,8 @@ public:
         void incRenderTargetBinds() { fRenderTargetBinds++; }
         int shaderCompilations() const { return fShaderCompilations; }
         void incShaderCompilations() { fShaderCompilations++; }
+        int programLinkWaits() const { return fProgramLinkWaits; }
+        void incProgramLinkWaits() { fProgramLinkWaits++; }
         int textureCreates() const { return fTextureCreates; }
         void incTextureCreates() { fTextureCreates++; }
         int textureUploads() const { return fTextureUploads; }
@@ -412,6 +469,7 @@ public:
     private:
         int fRenderTargetBinds;
         int fShaderCompilations;
+        int fProgramLinkWaits;
         int fTextureCreates;
         int fTextureUploads;
         int fTransfersToTexture;
@@ -423,6 +481,7 @@ public:
         void dumpKeyValuePairs(SkTArray<SkString>*, SkTArray<double>*) {}
         void incRenderTargetBinds() {}
         void incShaderCompilations() {}
+        void incProgramLinkWaits() {}
         void incTextureCreates() {}
         void incTextureUploads() {}
         void incTransfersToTexture() {}
@@ -567,6 +626,12 @@ private:
                                   GrPixelConfig config, GrBuffer* transferBuffer,
                                   size_t offset, size_t rowBytes) = 0;
 
+    // overridden by backend-specific derived class to perform the read into a buffer
+    virtual bool onReadPixelsToBuffer(GrSurface*,
+                                      int left, int top, int width, int height,
+                                      GrPixelConfig config, GrBuffer* transferBuffer,
+                                      size_t offset, size_t rowBytes) = 0;
+
     // overridden by backend-specific derived class to perform the resolve
     virtual void onResolveRenderTarget(GrRenderTarget* target) = 0;
 
@@ -9,6 +9,7 @@
 #define GrGpuCommandBuffer_DEFINED
 
 #include "GrColor.h"
+#include "GrTypesPriv.h"
 
 class GrGpu;
 class GrMesh;
@@ -75,6 +76,13 @@ public:
     // TODO: This should be removed in the future to favor using the load and store ops for discard
     virtual void discard(GrRenderTarget* = nullptr) = 0;
 
+    /**
+    * Brackets the commands that follow with a query from GrGpu::createTimerQuery(), timing how
+    * long the GPU takes to execute them. Timer queries may not nest.
+    */
+    virtual void beginTimerQuery(GrTimerQuery) = 0;
+    virtual void endTimerQuery(GrTimerQuery) = 0;
+
 private:
     virtual GrGpu* gpu() = 0;
     virtual void onSubmit(const SkIRect& bounds) = 0;
@@ -24,6 +24,7 @@ GrGpuResource::GrGpuResource(GrGpu* gpu)
     , fGpuMemorySize(kInvalidGpuMemorySize)
     , fBudgeted(SkBudgeted::kNo)
     , fRefsWrappedObjects(false)
+    , fIsAtlas(false)
     , fUniqueID(CreateUniqueID()) {
     SkDEBUGCODE(fCacheArrayIndex = -1);
 }
@@ -105,6 +106,18 @@ GrContext* GrGpuResource::getContext() {
     }
 }
 
+GrGpuResource::MemoryCategory GrGpuResource::memoryCategory() const {
+    if (fIsAtlas) {
+        return kAtlas_MemoryCategory;
+    }
+    MemoryCategory category = this->onGetMemoryCategory();
+    if (kRenderTarget_MemoryCategory == category && fScratchKey.isValid() &&
+        !fUniqueKey.isValid()) {
+        return kScratchRenderTarget_MemoryCategory;
+    }
+    return category;
+}
+
 void GrGpuResource::didChangeGpuMemorySize() const {
     if (this->wasDestroyed()) {
         return;
@@ -67,6 +67,12 @@ public:
      */
     void removeScratchKey() const { fResource->removeScratchKey();  }
 
+    /**
+     * Marks the resource as backing an atlas, for memory accounting. The cache clears the mark
+     * when the resource becomes purgeable, so a texture recycled as scratch isn't still counted.
+     */
+    void setIsAtlas(bool isAtlas) { fResource->fIsAtlas = isAtlas; }
+
 protected:
     ResourcePriv(GrGpuResource* resource) : fResource(resource) {   }
     ResourcePriv(const ResourcePriv& that) : fResource(that.fResource) {}
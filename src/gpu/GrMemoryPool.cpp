@@ -183,3 +183,136 @@ void GrMemoryPool::validate() {
     SkASSERT(fAllocBlockCnt != 0 || fSize == 0);
 #endif
 }
+
+///////////////////////////////////////////////////////////////////////////////
+
+GrSizeClassPool::GrSizeClassPool(size_t slabSize)
+    : fSlabs(nullptr)
+    , fSpareSlabs(nullptr)
+    , fSlabCount(0)
+    , fCurrPtr(0)
+    , fEndPtr(0)
+    , fSlabSize(SkTMax<size_t>(GrSizeAlignUp(slabSize, kAlignment),
+                               kSlabHeaderSize + kPerAllocPad + kMaxSmallSize))
+    , fLiveBytes(0)
+    , fHighWaterBytes(0)
+    , fReservedBytes(0)
+    , fLiveCount(0) {
+    sk_bzero(fFreeLists, sizeof(fFreeLists));
+}
+
+GrSizeClassPool::~GrSizeClassPool() {
+    SkASSERT(0 == fLiveCount);
+    for (Slab* list : { fSlabs, fSpareSlabs }) {
+        while (list) {
+            Slab* next = list->fNext;
+            sk_free(list);
+            list = next;
+        }
+    }
+}
+
+void* GrSizeClassPool::allocate(size_t size) {
+    if (size > kMaxSmallSize) {
+        return this->allocateLarge(size);
+    }
+    int sizeClass = size ? SkToInt((size - 1) / kSizeClassBytes) : 0;
+    size_t bytes = SizeClassBytes(sizeClass);
+
+    void* ptr;
+    if (FreeAlloc* free = fFreeLists[sizeClass]) {
+        fFreeLists[sizeClass] = free->fNext;
+        ptr = free;
+    } else {
+        if (fEndPtr - fCurrPtr < (intptr_t)(kPerAllocPad + bytes)) {
+            // Whatever is left of the current slab is too small, and stays unused.
+            this->addSlab();
+        }
+        AllocHeader* header = reinterpret_cast<AllocHeader*>(fCurrPtr);
+        header->fSizeClass = sizeClass;
+        header->fLargeSize = 0;
+        ptr = reinterpret_cast<void*>(fCurrPtr + kPerAllocPad);
+        fCurrPtr += kPerAllocPad + bytes;
+    }
+
+    fLiveCount++;
+    fLiveBytes += bytes;
+    fHighWaterBytes = SkTMax(fHighWaterBytes, fLiveBytes);
+    return ptr;
+}
+
+void GrSizeClassPool::addSlab() {
+    Slab* slab = fSpareSlabs;
+    if (slab) {
+        fSpareSlabs = slab->fNext;
+    } else {
+        slab = reinterpret_cast<Slab*>(sk_malloc_throw(fSlabSize));
+        // we assume malloc gives us aligned memory
+        SkASSERT(!(reinterpret_cast<intptr_t>(slab) % kAlignment));
+        fSlabCount++;
+        fReservedBytes += fSlabSize;
+    }
+    slab->fNext = fSlabs;
+    fSlabs = slab;
+    fCurrPtr = reinterpret_cast<intptr_t>(slab) + kSlabHeaderSize;
+    fEndPtr = reinterpret_cast<intptr_t>(slab) + fSlabSize;
+}
+
+void GrSizeClassPool::trim() {
+    SkASSERT(0 == fLiveCount);
+    if (fSlabCount <= kMaxRetainedSlabs) {
+        // Keep the free lists, and with them the slabs they point into, as they are.
+        return;
+    }
+    // Nothing is live, so the free lists cover everything we've carved. Forget them, free the
+    // extra slabs, and carve the ones we keep afresh.
+    sk_bzero(fFreeLists, sizeof(fFreeLists));
+    fCurrPtr = fEndPtr = 0;
+    while (fSlabs) {
+        Slab* next = fSlabs->fNext;
+        if (fSlabCount > kMaxRetainedSlabs) {
+            sk_free(fSlabs);
+            fSlabCount--;
+            fReservedBytes -= fSlabSize;
+        } else {
+            fSlabs->fNext = fSpareSlabs;
+            fSpareSlabs = fSlabs;
+        }
+        fSlabs = next;
+    }
+}
+
+void* GrSizeClassPool::allocateLarge(size_t size) {
+    SkASSERT(size <= SK_MaxU32);
+    size = GrSizeAlignUp(size, kAlignment);
+    AllocHeader* header = reinterpret_cast<AllocHeader*>(sk_malloc_throw(kPerAllocPad + size));
+    header->fSizeClass = kLarge_SizeClass;
+    header->fLargeSize = SkToU32(size);
+
+    fLiveCount++;
+    fLiveBytes += size;
+    fHighWaterBytes = SkTMax(fHighWaterBytes, fLiveBytes);
+    fReservedBytes += kPerAllocPad + size;
+    return reinterpret_cast<char*>(header) + kPerAllocPad;
+}
+
+void GrSizeClassPool::release(void* p) {
+    AllocHeader* header = reinterpret_cast<AllocHeader*>(reinterpret_cast<intptr_t>(p) -
+                                                         kPerAllocPad);
+    SkASSERT(fLiveCount > 0);
+    fLiveCount--;
+    if (kLarge_SizeClass == header->fSizeClass) {
+        fLiveBytes -= header->fLargeSize;
+        fReservedBytes -= kPerAllocPad + header->fLargeSize;
+        sk_free(header);
+    } else {
+        SkASSERT(header->fSizeClass < kSizeClassCount);
+        fLiveBytes -= SizeClassBytes(header->fSizeClass);
+        FreeAlloc* free = reinterpret_cast<FreeAlloc*>(p);
+        free->fNext = fFreeLists[header->fSizeClass];
+        fFreeLists[header->fSizeClass] = free;
+    }
+    if (0 == fLiveCount) {
+        this->trim();
+    }
+}
@@ -98,4 +98,107 @@ private:
 #endif
 };
 
+/**
+ * Allocates memory for small objects that are created and destroyed all the time, like batches
+ * and processors. Each request is rounded up to a size class, and released memory goes on its
+ * class's free list, to be handed out again by the next request of that class. So once the pool
+ * has grown to its high-water mark, allocate() and release() are a few pointer operations and
+ * never call malloc or free. Memory is carved out of slabs. Whenever the pool empties, it keeps
+ * at most kMaxRetainedSlabs of them to carve from again and frees the rest, so a burst of
+ * allocations doesn't pin its high-water mark for the life of the pool. Requests too big for any size class go straight to malloc. Allocations will be 8-byte aligned.
+ * Like GrMemoryPool, the interface is designed to implement operator new and delete overrides,
+ * and all allocations are expected to be released before the pool's destructor is called.
+ */
+class GrSizeClassPool {
+public:
+    /**
+     * Slab size is how much memory the pool asks for whenever it runs out.
+     */
+    GrSizeClassPool(size_t slabSize);
+
+    ~GrSizeClassPool();
+
+    /**
+     * Allocates memory. The memory must be freed with release().
+     */
+    void* allocate(size_t size);
+
+    /**
+     * p must have been returned by allocate()
+     */
+    void release(void* p);
+
+    /**
+     * Returns true if there are no unreleased allocations.
+     */
+    bool isEmpty() const { return 0 == fLiveCount; }
+
+    /**
+     * Bytes in unreleased allocations, rounded up to their size classes.
+     */
+    size_t liveBytes() const { return fLiveBytes; }
+
+    /**
+     * The most liveBytes() has ever been.
+     */
+    size_t highWaterBytes() const { return fHighWaterBytes; }
+
+    /**
+     * Bytes the pool holds: its slabs plus any unreleased allocations too big for a size class.
+     */
+    size_t reservedBytes() const { return fReservedBytes; }
+
+private:
+    enum {
+        // We assume this alignment is good enough for everybody.
+        kAlignment      = 8,
+        kSizeClassBytes = 16,
+        kMaxSmallSize   = 2048,
+        kSizeClassCount = kMaxSmallSize / kSizeClassBytes,
+        // The size class of allocations that are too big for the free lists.
+        kLarge_SizeClass = kSizeClassCount,
+        // How many slabs the pool keeps when it empties.
+        kMaxRetainedSlabs = 4,
+    };
+
+    struct AllocHeader {
+        uint32_t fSizeClass;
+        uint32_t fLargeSize;  ///< only used by kLarge_SizeClass allocations
+    };
+
+    struct FreeAlloc {
+        FreeAlloc* fNext;
+    };
+
+    struct Slab {
+        Slab* fNext;
+    };
+
+    enum {
+        kPerAllocPad = GR_CT_ALIGN_UP(sizeof(AllocHeader), kAlignment),
+        kSlabHeaderSize = GR_CT_ALIGN_UP(sizeof(Slab), kAlignment),
+    };
+
+    static size_t SizeClassBytes(int sizeClass) {
+        return (sizeClass + 1) * kSizeClassBytes;
+    }
+
+    void* allocateLarge(size_t size);
+    void  addSlab();
+    // Called when the pool empties. Frees all but kMaxRetainedSlabs slabs.
+    void  trim();
+
+    FreeAlloc* fFreeLists[kSizeClassCount];
+    Slab*      fSlabs;       ///< slabs we've carved from, most recent first
+    Slab*      fSpareSlabs;  ///< retained slabs not carved from since the last trim()
+    int        fSlabCount;   ///< in both lists
+    intptr_t   fCurrPtr;     ///< start of the current slab's unused space
+    intptr_t   fEndPtr;      ///< end of the current slab
+    size_t     fSlabSize;
+    size_t     fLiveBytes;
+    size_t     fHighWaterBytes;
+    size_t     fReservedBytes;
+    int        fLiveCount;
+};
+
 #endif
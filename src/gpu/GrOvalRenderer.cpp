@@ -196,6 +196,9 @@ sk_sp<GrGeometryProcessor> CircleGeometryProcessor::TestCreate(GrProcessorTestDa
  * ellipse, specified as a 2D offset from center, and the reciprocals of the outer and inner radii,
  * in both x and y directions.
  *
+ * When stroking, an inner reciprocal radius of zero marks a filled ellipse that has been batched
+ * with stroked ones, and its inner edge is skipped.
+ *
  * We are using an implicit function of x^2/a^2 + y^2/b^2 - 1 = 0.
  */
 
@@ -275,8 +278,9 @@ public:
             fragBuilder->codeAppend("float invlen = inversesqrt(grad_dot);");
             fragBuilder->codeAppend("float edgeAlpha = clamp(0.5-test*invlen, 0.0, 1.0);");
 
-            // for inner curve
+            // for inner curve, unless this is a filled ellipse batched with stroked ones
             if (egp.fStroke) {
+                fragBuilder->codeAppendf("if (%s.z > 0.0) {", ellipseRadii.fsIn());
                 fragBuilder->codeAppendf("scaledOffset = %s*%s.zw;",
                                          ellipseOffsets.fsIn(), ellipseRadii.fsIn());
                 fragBuilder->codeAppend("test = dot(scaledOffset, scaledOffset) - 1.0;");
@@ -284,6 +288,7 @@ public:
                                          ellipseRadii.fsIn());
                 fragBuilder->codeAppend("invlen = inversesqrt(dot(grad, grad));");
                 fragBuilder->codeAppend("edgeAlpha *= clamp(0.5+test*invlen, 0.0, 1.0);");
+                fragBuilder->codeAppend("}");
             }
 
             fragBuilder->codeAppendf("%s = vec4(edgeAlpha);", args.fOutputCoverage);
@@ -524,14 +529,44 @@ sk_sp<GrGeometryProcessor> DIEllipseGeometryProcessor::TestCreate(GrProcessorTes
 
 ///////////////////////////////////////////////////////////////////////////////
 
-class CircleBatch : public GrVertexBatch {
+static const uint16_t gQuadIndices[] = { 0, 1, 2, 0, 2, 3 };
+
+static const uint16_t gRRectIndices[] = {
+    // corners
+    0, 1, 5, 0, 5, 4,
+    2, 3, 7, 2, 7, 6,
+    8, 9, 13, 8, 13, 12,
+    10, 11, 15, 10, 15, 14,
+
+    // edges
+    1, 2, 6, 1, 6, 5,
+    4, 5, 9, 4, 9, 8,
+    6, 7, 11, 6, 11, 10,
+    9, 10, 14, 9, 14, 13,
+
+    // center
+    // we place this at the end so that we can ignore these indices when rendering stroke-only
+    5, 6, 10, 5, 10, 9
+};
+
+static const int kIndicesPerStrokeRRect = SK_ARRAY_COUNT(gRRectIndices) - 6;
+static const int kIndicesPerRRect = SK_ARRAY_COUNT(gRRectIndices);
+static const int kVertsPerRRect = 16;
+
+/**
+ * Draws any mix of circles, axis-aligned ellipses and simple rrects with circular or elliptical
+ * corners, filled or stroked, in a single draw. Each shape writes its own vertices and indices:
+ * ovals are a single quad and rrects a nine-patch. While every shape is circular the batch uses
+ * the cheaper CircleGeometryProcessor; once an ellipse joins, every shape is drawn with the
+ * EllipseGeometryProcessor, which handles circles too. Likewise once a stroked shape joins, the
+ * inner edge is tested for every shape, and filled shapes encode an inner edge that never clips.
+ */
+class RoundedShapeBatch : public GrVertexBatch {
 public:
     DEFINE_BATCH_CLASS_ID
 
-    CircleBatch(GrColor color, const SkMatrix& viewMatrix, const SkRect& circle,
-                const SkStrokeRec& stroke)
-            : INHERITED(ClassID())
-            , fViewMatrixIfUsingLocalCoords(viewMatrix) {
+    static GrDrawBatch* CreateCircle(GrColor color, const SkMatrix& viewMatrix,
+                                     const SkRect& circle, const SkStrokeRec& stroke) {
         SkPoint center = SkPoint::Make(circle.centerX(), circle.centerY());
         viewMatrix.mapPoints(&center, 1);
         SkScalar radius = viewMatrix.mapRadius(SkScalarHalf(circle.width()));
@@ -544,8 +579,8 @@ public:
 
         SkScalar innerRadius = 0.0f;
         SkScalar outerRadius = radius;
-        SkScalar halfWidth = 0;
         if (hasStroke) {
+            SkScalar halfWidth;
             if (SkScalarNearlyZero(strokeWidth)) {
                 halfWidth = SK_ScalarHalf;
             } else {
@@ -558,163 +593,21 @@ public:
             }
         }
 
-        // The radii are outset for two reasons. First, it allows the shader to simply perform
-        // simpler computation because the computed alpha is zero, rather than 50%, at the radius.
-        // Second, the outer radius is used to compute the verts of the bounding box that is
-        // rendered and the outset ensures the box will cover all partially covered by the circle.
-        outerRadius += SK_ScalarHalf;
-        innerRadius -= SK_ScalarHalf;
-
-        fGeoData.emplace_back(Geometry {
-            color,
-            innerRadius,
-            outerRadius,
-            SkRect::MakeLTRB(center.fX - outerRadius, center.fY - outerRadius,
-                             center.fX + outerRadius, center.fY + outerRadius)
-        });
         // Use the original radius and stroke radius for the bounds so that it does not include the
         // AA bloat.
-        radius += halfWidth;
-        this->setBounds({center.fX - radius, center.fY - radius,
-                         center.fX + radius, center.fY + radius},
-                        HasAABloat::kYes, IsZeroArea::kNo);
-        fStroked = isStrokeOnly && innerRadius > 0;
-    }
-
-    const char* name() const override { return "CircleBatch"; }
-
-    SkString dumpInfo() const override {
-        SkString string;
-        for (int i = 0; i < fGeoData.count(); ++i) {
-            string.appendf("Color: 0x%08x Rect [L: %.2f, T: %.2f, R: %.2f, B: %.2f],"
-                           "InnerRad: %.2f, OuterRad: %.2f\n",
-                           fGeoData[i].fColor,
-                           fGeoData[i].fDevBounds.fLeft, fGeoData[i].fDevBounds.fTop,
-                           fGeoData[i].fDevBounds.fRight, fGeoData[i].fDevBounds.fBottom,
-                           fGeoData[i].fInnerRadius,
-                           fGeoData[i].fOuterRadius);
-        }
-        string.append(INHERITED::dumpInfo());
-        return string;
-    }
-
-    void computePipelineOptimizations(GrInitInvariantOutput* color,
-                                      GrInitInvariantOutput* coverage,
-                                      GrBatchToXPOverrides* overrides) const override {
-        // When this is called on a batch, there is only one geometry bundle
-        color->setKnownFourComponents(fGeoData[0].fColor);
-        coverage->setUnknownSingleComponent();
-    }
-
-private:
-    void initBatchTracker(const GrXPOverridesForBatch& overrides) override {
-        // Handle any overrides that affect our GP.
-        overrides.getOverrideColorIfSet(&fGeoData[0].fColor);
-        if (!overrides.readsLocalCoords()) {
-            fViewMatrixIfUsingLocalCoords.reset();
-        }
-    }
-
-    void onPrepareDraws(Target* target) const override {
-        SkMatrix localMatrix;
-        if (!fViewMatrixIfUsingLocalCoords.invert(&localMatrix)) {
-            return;
-        }
-
-        // Setup geometry processor
-        SkAutoTUnref<GrGeometryProcessor> gp(new CircleGeometryProcessor(fStroked, localMatrix));
-
-        int instanceCount = fGeoData.count();
-        size_t vertexStride = gp->getVertexStride();
-        SkASSERT(vertexStride == sizeof(CircleVertex));
-        QuadHelper helper;
-        CircleVertex* verts = reinterpret_cast<CircleVertex*>(helper.init(target, vertexStride,
-                                                                          instanceCount));
-        if (!verts) {
-            return;
-        }
-
-        for (int i = 0; i < instanceCount; i++) {
-            const Geometry& geom = fGeoData[i];
-
-            GrColor color = geom.fColor;
-            SkScalar innerRadius = geom.fInnerRadius;
-            SkScalar outerRadius = geom.fOuterRadius;
-
-            const SkRect& bounds = geom.fDevBounds;
-
-            // The inner radius in the vertex data must be specified in normalized space.
-            innerRadius = innerRadius / outerRadius;
-            verts[0].fPos = SkPoint::Make(bounds.fLeft,  bounds.fTop);
-            verts[0].fColor = color;
-            verts[0].fOffset = SkPoint::Make(-1, -1);
-            verts[0].fOuterRadius = outerRadius;
-            verts[0].fInnerRadius = innerRadius;
-
-            verts[1].fPos = SkPoint::Make(bounds.fLeft,  bounds.fBottom);
-            verts[1].fColor = color;
-            verts[1].fOffset = SkPoint::Make(-1, 1);
-            verts[1].fOuterRadius = outerRadius;
-            verts[1].fInnerRadius = innerRadius;
-
-            verts[2].fPos = SkPoint::Make(bounds.fRight, bounds.fBottom);
-            verts[2].fColor = color;
-            verts[2].fOffset = SkPoint::Make(1, 1);
-            verts[2].fOuterRadius = outerRadius;
-            verts[2].fInnerRadius = innerRadius;
-
-            verts[3].fPos = SkPoint::Make(bounds.fRight, bounds.fTop);
-            verts[3].fColor = color;
-            verts[3].fOffset = SkPoint::Make(1, -1);
-            verts[3].fOuterRadius = outerRadius;
-            verts[3].fInnerRadius = innerRadius;
-
-            verts += kVerticesPerQuad;
-        }
-        helper.recordDraw(target, gp);
-    }
-
-    bool onCombineIfPossible(GrBatch* t, const GrCaps& caps) override {
-        CircleBatch* that = t->cast<CircleBatch>();
-        if (!GrPipeline::CanCombine(*this->pipeline(), this->bounds(), *that->pipeline(),
-                                    that->bounds(), caps)) {
-            return false;
-        }
-
-        if (this->fStroked != that->fStroked) {
-            return false;
-        }
-
-        if (!fViewMatrixIfUsingLocalCoords.cheapEqualTo(that->fViewMatrixIfUsingLocalCoords)) {
-            return false;
-        }
-
-        fGeoData.push_back_n(that->fGeoData.count(), that->fGeoData.begin());
-        this->joinBounds(*that);
-        return true;
+        SkRect bounds = SkRect::MakeLTRB(center.fX - outerRadius, center.fY - outerRadius,
+                                         center.fX + outerRadius, center.fY + outerRadius);
+        // The circle shader's inner edge is itself outset by half a pixel, so only a hole at least
+        // that wide needs testing.
+        bool stroked = isStrokeOnly && innerRadius > SK_ScalarHalf;
+        return new RoundedShapeBatch(viewMatrix, bounds, Geometry {
+            color, outerRadius, outerRadius, innerRadius, innerRadius,
+            bounds.makeOutset(SK_ScalarHalf, SK_ScalarHalf), false, stroked, true
+        });
     }
 
-    struct Geometry {
-        GrColor fColor;
-        SkScalar fInnerRadius;
-        SkScalar fOuterRadius;
-        SkRect fDevBounds;
-    };
-
-    bool                         fStroked;
-    SkMatrix                     fViewMatrixIfUsingLocalCoords;
-    SkSTArray<1, Geometry, true> fGeoData;
-
-    typedef GrVertexBatch INHERITED;
-};
-
-///////////////////////////////////////////////////////////////////////////////
-
-class EllipseBatch : public GrVertexBatch {
-public:
-    DEFINE_BATCH_CLASS_ID
-    static GrDrawBatch* Create(GrColor color, const SkMatrix& viewMatrix, const SkRect& ellipse,
-                               const SkStrokeRec& stroke) {
+    static GrDrawBatch* CreateEllipse(GrColor color, const SkMatrix& viewMatrix,
+                                      const SkRect& ellipse, const SkStrokeRec& stroke) {
         SkASSERT(viewMatrix.rectStaysRect());
 
         // do any matrix crunching before we reset the draw state for device coords
@@ -771,28 +664,120 @@ public:
             yRadius += scaledStroke.fY;
         }
 
-        EllipseBatch* batch = new EllipseBatch();
-        batch->fGeoData.emplace_back(Geometry {
-            color,
-            xRadius,
-            yRadius,
-            innerXRadius,
-            innerYRadius,
-            SkRect::MakeLTRB(center.fX - xRadius, center.fY - yRadius,
-                             center.fX + xRadius, center.fY + yRadius)
+        SkRect bounds = SkRect::MakeLTRB(center.fX - xRadius, center.fY - yRadius,
+                                         center.fX + xRadius, center.fY + yRadius);
+        bool stroked = isStrokeOnly && innerXRadius > 0 && innerYRadius > 0;
+        return new RoundedShapeBatch(viewMatrix, bounds, Geometry {
+            color, xRadius, yRadius, innerXRadius, innerYRadius,
+            bounds.makeOutset(SK_ScalarHalf, SK_ScalarHalf), false, stroked, false
+        });
+    }
+
+    // A devStrokeWidth <= 0 indicates a fill only. If devStrokeWidth > 0 then strokeOnly indicates
+    // whether the rrect is only stroked or stroked and filled.
+    static GrDrawBatch* CreateCircularRRect(GrColor color, const SkMatrix& viewMatrix,
+                                            const SkRect& devRect, float devRadius,
+                                            float devStrokeWidth, bool strokeOnly) {
+        SkASSERT(!(devStrokeWidth <= 0 && strokeOnly));
+        SkRect bounds = devRect;
+        SkScalar innerRadius = 0.0f;
+        SkScalar outerRadius = devRadius;
+        bool stroked = false;
+        if (devStrokeWidth > 0) {
+            SkScalar halfWidth;
+            if (SkScalarNearlyZero(devStrokeWidth)) {
+                halfWidth = SK_ScalarHalf;
+            } else {
+                halfWidth = SkScalarHalf(devStrokeWidth);
+            }
+
+            if (strokeOnly) {
+                innerRadius = devRadius - halfWidth;
+                stroked = innerRadius >= 0;
+            }
+            outerRadius += halfWidth;
+            bounds.outset(halfWidth, halfWidth);
+        }
+
+        return new RoundedShapeBatch(viewMatrix, bounds, Geometry {
+            color, outerRadius, outerRadius, innerRadius, innerRadius,
+            bounds.makeOutset(SK_ScalarHalf, SK_ScalarHalf), true, stroked, true
         });
+    }
 
-        batch->setBounds(batch->fGeoData.back().fDevBounds, HasAABloat::kYes, IsZeroArea::kNo);
+    // If devStrokeWidths values are <= 0 indicates then fill only. Otherwise, strokeOnly indicates
+    // whether the rrect is only stroked or stroked and filled.
+    static GrDrawBatch* CreateEllipticalRRect(GrColor color, const SkMatrix& viewMatrix,
+                                              const SkRect& devRect, float devXRadius,
+                                              float devYRadius, SkVector devStrokeWidths,
+                                              bool strokeOnly) {
+        SkASSERT(devXRadius > 0.5);
+        SkASSERT(devYRadius > 0.5);
+        SkASSERT((devStrokeWidths.fX > 0) == (devStrokeWidths.fY > 0));
+        SkASSERT(!(strokeOnly && devStrokeWidths.fX <= 0));
+        SkScalar innerXRadius = 0.0f;
+        SkScalar innerYRadius = 0.0f;
+        SkRect bounds = devRect;
+        bool stroked = false;
+        if (devStrokeWidths.fX > 0) {
+            if (SkScalarNearlyZero(devStrokeWidths.length())) {
+                devStrokeWidths.set(SK_ScalarHalf, SK_ScalarHalf);
+            } else {
+                devStrokeWidths.scale(SK_ScalarHalf);
+            }
 
-        // Outset bounds to include half-pixel width antialiasing.
-        batch->fGeoData[0].fDevBounds.outset(SK_ScalarHalf, SK_ScalarHalf);
+            // we only handle thick strokes for near-circular ellipses
+            if (devStrokeWidths.length() > SK_ScalarHalf &&
+                (SK_ScalarHalf*devXRadius > devYRadius || SK_ScalarHalf*devYRadius > devXRadius)) {
+                return nullptr;
+            }
 
-        batch->fStroked = isStrokeOnly && innerXRadius > 0 && innerYRadius > 0;
-        batch->fViewMatrixIfUsingLocalCoords = viewMatrix;
-        return batch;
+            // we don't handle it if curvature of the stroke is less than curvature of the ellipse
+            if (devStrokeWidths.fX*(devYRadius*devYRadius) <
+                (devStrokeWidths.fY*devStrokeWidths.fY)*devXRadius) {
+                return nullptr;
+            }
+            if (devStrokeWidths.fY*(devXRadius*devXRadius) <
+                (devStrokeWidths.fX*devStrokeWidths.fX)*devYRadius) {
+                return nullptr;
+            }
+
+            // this is legit only if scale & translation (which should be the case at the moment)
+            if (strokeOnly) {
+                innerXRadius = devXRadius - devStrokeWidths.fX;
+                innerYRadius = devYRadius - devStrokeWidths.fY;
+                stroked = (innerXRadius >= 0 && innerYRadius >= 0);
+            }
+
+            devXRadius += devStrokeWidths.fX;
+            devYRadius += devStrokeWidths.fY;
+            bounds.outset(devStrokeWidths.fX, devStrokeWidths.fY);
+        }
+
+        return new RoundedShapeBatch(viewMatrix, bounds, Geometry {
+            color, devXRadius, devYRadius, innerXRadius, innerYRadius,
+            bounds.makeOutset(SK_ScalarHalf, SK_ScalarHalf), true, stroked, false
+        });
     }
 
-    const char* name() const override { return "EllipseBatch"; }
+    const char* name() const override { return "RoundedShapeBatch"; }
+
+    SkString dumpInfo() const override {
+        SkString string;
+        for (int i = 0; i < fGeoData.count(); ++i) {
+            const Geometry& geom = fGeoData[i];
+            string.appendf("%s%s Color: 0x%08x Rect [L: %.2f, T: %.2f, R: %.2f, B: %.2f], "
+                           "Rad: [%.2f, %.2f], InnerRad: [%.2f, %.2f]\n",
+                           geom.fIsRRect ? "RRect" : "Oval", geom.fStroked ? " (stroked)" : "",
+                           geom.fColor,
+                           geom.fDevBounds.fLeft, geom.fDevBounds.fTop,
+                           geom.fDevBounds.fRight, geom.fDevBounds.fBottom,
+                           geom.fXRadius, geom.fYRadius,
+                           geom.fInnerXRadius, geom.fInnerYRadius);
+        }
+        string.append(INHERITED::dumpInfo());
+        return string;
+    }
 
     void computePipelineOptimizations(GrInitInvariantOutput* color,
                                       GrInitInvariantOutput* coverage,
@@ -803,13 +788,46 @@ public:
     }
 
 private:
-    EllipseBatch() : INHERITED(ClassID()) {}
+    struct Geometry {
+        GrColor  fColor;
+        // Outer radii, including any stroke but not the AA bloat.
+        SkScalar fXRadius;
+        SkScalar fYRadius;
+        // Inner radii, only used when fStroked.
+        SkScalar fInnerXRadius;
+        SkScalar fInnerYRadius;
+        // Outset by half a pixel for AA.
+        SkRect   fDevBounds;
+        // A nine-patch of kVertsPerRRect vertices rather than a single quad.
+        bool     fIsRRect;
+        // There is a hole to cut out, so the inner edge must be tested.
+        bool     fStroked;
+        // The corners are circular, so the circle shader can draw this shape.
+        bool     fIsCircle;
+    };
+
+    RoundedShapeBatch(const SkMatrix& viewMatrix, const SkRect& bounds, const Geometry& geom)
+            : INHERITED(ClassID())
+            , fViewMatrixIfUsingLocalCoords(viewMatrix) {
+        fGeoData.push_back(geom);
+        fStroked = geom.fStroked;
+        fAllCircles = geom.fIsCircle;
+        fVertCount = geom.fIsRRect ? kVertsPerRRect : kVerticesPerQuad;
+        fIndexCount = IndexCount(geom);
+        this->setBounds(bounds, HasAABloat::kYes, IsZeroArea::kNo);
+    }
+
+    static int IndexCount(const Geometry& geom) {
+        if (!geom.fIsRRect) {
+            return kIndicesPerQuad;
+        }
+        // drop out the middle quad if we're stroked
+        return geom.fStroked ? kIndicesPerStrokeRRect : kIndicesPerRRect;
+    }
 
     void initBatchTracker(const GrXPOverridesForBatch& overrides) override {
         // Handle any overrides that affect our GP.
-        if (!overrides.readsCoverage()) {
-            fGeoData[0].fColor = GrColor_ILLEGAL;
-        }
+        overrides.getOverrideColorIfSet(&fGeoData[0].fColor);
         if (!overrides.readsLocalCoords()) {
             fViewMatrixIfUsingLocalCoords.reset();
         }
@@ -822,76 +840,193 @@ private:
         }
 
         // Setup geometry processor
-        SkAutoTUnref<GrGeometryProcessor> gp(new EllipseGeometryProcessor(fStroked, localMatrix));
+        SkAutoTUnref<GrGeometryProcessor> gp;
+        if (fAllCircles) {
+            gp.reset(new CircleGeometryProcessor(fStroked, localMatrix));
+        } else {
+            gp.reset(new EllipseGeometryProcessor(fStroked, localMatrix));
+        }
 
-        int instanceCount = fGeoData.count();
-        QuadHelper helper;
         size_t vertexStride = gp->getVertexStride();
-        SkASSERT(vertexStride == sizeof(EllipseVertex));
-        EllipseVertex* verts = reinterpret_cast<EllipseVertex*>(
-            helper.init(target, vertexStride, instanceCount));
-        if (!verts) {
+        SkASSERT(vertexStride == (fAllCircles ? sizeof(CircleVertex) : sizeof(EllipseVertex)));
+
+        const GrBuffer* vertexBuffer;
+        int firstVertex;
+        char* verts = reinterpret_cast<char*>(target->makeVertexSpace(vertexStride, fVertCount,
+                                                                      &vertexBuffer,
+                                                                      &firstVertex));
+        const GrBuffer* indexBuffer;
+        int firstIndex;
+        uint16_t* indices = target->makeIndexSpace(fIndexCount, &indexBuffer, &firstIndex);
+        if (!verts || !indices) {
+            SkDebugf("Could not allocate vertices\n");
             return;
         }
 
-        for (int i = 0; i < instanceCount; i++) {
+        int currStartVertex = 0;
+        for (int i = 0; i < fGeoData.count(); ++i) {
             const Geometry& geom = fGeoData[i];
 
-            GrColor color = geom.fColor;
-            SkScalar xRadius = geom.fXRadius;
-            SkScalar yRadius = geom.fYRadius;
+            if (fAllCircles) {
+                WriteCircleVerts(geom, reinterpret_cast<CircleVertex*>(verts));
+            } else {
+                WriteEllipseVerts(geom, reinterpret_cast<EllipseVertex*>(verts));
+            }
 
-            // Compute the reciprocals of the radii here to save time in the shader
-            SkScalar xRadRecip = SkScalarInvert(xRadius);
-            SkScalar yRadRecip = SkScalarInvert(yRadius);
-            SkScalar xInnerRadRecip = SkScalarInvert(geom.fInnerXRadius);
-            SkScalar yInnerRadRecip = SkScalarInvert(geom.fInnerYRadius);
+            const uint16_t* pattern = geom.fIsRRect ? gRRectIndices : gQuadIndices;
+            int indexCount = IndexCount(geom);
+            for (int j = 0; j < indexCount; ++j) {
+                *indices++ = pattern[j] + currStartVertex;
+            }
 
-            const SkRect& bounds = geom.fDevBounds;
+            int vertCount = geom.fIsRRect ? kVertsPerRRect : kVerticesPerQuad;
+            verts += vertCount * vertexStride;
+            currStartVertex += vertCount;
+        }
+        SkASSERT(currStartVertex == fVertCount);
 
-            // fOffsets are expanded from xyRadii to include the half-pixel antialiasing width.
-            SkScalar xMaxOffset = xRadius + SK_ScalarHalf;
-            SkScalar yMaxOffset = yRadius + SK_ScalarHalf;
+        GrMesh mesh;
+        mesh.initIndexed(kTriangles_GrPrimitiveType, vertexBuffer, indexBuffer, firstVertex,
+                         firstIndex, fVertCount, fIndexCount);
+        target->draw(gp.get(), mesh);
+    }
 
-            // The inner radius in the vertex data must be specified in normalized space.
-            verts[0].fPos = SkPoint::Make(bounds.fLeft,  bounds.fTop);
-            verts[0].fColor = color;
-            verts[0].fOffset = SkPoint::Make(-xMaxOffset, -yMaxOffset);
-            verts[0].fOuterRadii = SkPoint::Make(xRadRecip, yRadRecip);
-            verts[0].fInnerRadii = SkPoint::Make(xInnerRadRecip, yInnerRadRecip);
+    static void WriteCircleVerts(const Geometry& geom, CircleVertex* verts) {
+        SkASSERT(geom.fIsCircle);
+        GrColor color = geom.fColor;
+        const SkRect& bounds = geom.fDevBounds;
 
-            verts[1].fPos = SkPoint::Make(bounds.fLeft,  bounds.fBottom);
-            verts[1].fColor = color;
-            verts[1].fOffset = SkPoint::Make(-xMaxOffset, yMaxOffset);
-            verts[1].fOuterRadii = SkPoint::Make(xRadRecip, yRadRecip);
-            verts[1].fInnerRadii = SkPoint::Make(xInnerRadRecip, yInnerRadRecip);
+        // The radii are outset for two reasons. First, it allows the shader to simply perform
+        // simpler computation because the computed alpha is zero, rather than 50%, at the radius.
+        // Second, the outer radius is used to compute the verts of the bounding box that is
+        // rendered and the outset ensures the box will cover all partially covered by the circle.
+        SkScalar outerRadius = geom.fXRadius + SK_ScalarHalf;
 
+        // The inner radius in the vertex data must be specified in normalized space. A filled
+        // shape drawn by a stroking shader puts its inner edge far enough inside the center that
+        // it never reduces coverage.
+        SkScalar innerRadius = geom.fStroked ? (geom.fInnerXRadius - SK_ScalarHalf) / outerRadius
+                                             : -1.0f / outerRadius;
+
+        if (!geom.fIsRRect) {
+            verts[0].fPos = SkPoint::Make(bounds.fLeft,  bounds.fTop);
+            verts[0].fOffset = SkPoint::Make(-1, -1);
+            verts[1].fPos = SkPoint::Make(bounds.fLeft,  bounds.fBottom);
+            verts[1].fOffset = SkPoint::Make(-1, 1);
             verts[2].fPos = SkPoint::Make(bounds.fRight, bounds.fBottom);
-            verts[2].fColor = color;
-            verts[2].fOffset = SkPoint::Make(xMaxOffset, yMaxOffset);
-            verts[2].fOuterRadii = SkPoint::Make(xRadRecip, yRadRecip);
-            verts[2].fInnerRadii = SkPoint::Make(xInnerRadRecip, yInnerRadRecip);
+            verts[2].fOffset = SkPoint::Make(1, 1);
+            verts[3].fPos = SkPoint::Make(bounds.fRight, bounds.fTop);
+            verts[3].fOffset = SkPoint::Make(1, -1);
+            for (int i = 0; i < kVerticesPerQuad; ++i) {
+                verts[i].fColor = color;
+                verts[i].fOuterRadius = outerRadius;
+                verts[i].fInnerRadius = innerRadius;
+            }
+            return;
+        }
+
+        SkScalar xCoords[4] = {
+            bounds.fLeft,
+            bounds.fLeft + outerRadius,
+            bounds.fRight - outerRadius,
+            bounds.fRight
+        };
+        SkScalar yCoords[4] = {
+            bounds.fTop,
+            bounds.fTop + outerRadius,
+            bounds.fBottom - outerRadius,
+            bounds.fBottom
+        };
+        SkScalar outerOffsets[4] = { -1, 0, 0, 1 };
+
+        for (int y = 0; y < 4; ++y) {
+            for (int x = 0; x < 4; ++x) {
+                verts->fPos = SkPoint::Make(xCoords[x], yCoords[y]);
+                verts->fColor = color;
+                verts->fOffset = SkPoint::Make(outerOffsets[x], outerOffsets[y]);
+                verts->fOuterRadius = outerRadius;
+                verts->fInnerRadius = innerRadius;
+                verts++;
+            }
+        }
+    }
+
+    static void WriteEllipseVerts(const Geometry& geom, EllipseVertex* verts) {
+        GrColor color = geom.fColor;
+        const SkRect& bounds = geom.fDevBounds;
+
+        // Compute the reciprocals of the radii here to save time in the shader. A zero inner
+        // reciprocal tells a stroking shader that this shape is filled.
+        SkPoint outerRadii = SkPoint::Make(SkScalarInvert(geom.fXRadius),
+                                           SkScalarInvert(geom.fYRadius));
+        SkPoint innerRadii = SkPoint::Make(0, 0);
+        if (geom.fStroked) {
+            innerRadii.set(SkScalarInvert(geom.fInnerXRadius), SkScalarInvert(geom.fInnerYRadius));
+        }
 
+        // Offsets are expanded from xyRadii to include the half-pixel antialiasing width.
+        SkScalar xOuterRadius = geom.fXRadius + SK_ScalarHalf;
+        SkScalar yOuterRadius = geom.fYRadius + SK_ScalarHalf;
+
+        if (!geom.fIsRRect) {
+            verts[0].fPos = SkPoint::Make(bounds.fLeft,  bounds.fTop);
+            verts[0].fOffset = SkPoint::Make(-xOuterRadius, -yOuterRadius);
+            verts[1].fPos = SkPoint::Make(bounds.fLeft,  bounds.fBottom);
+            verts[1].fOffset = SkPoint::Make(-xOuterRadius, yOuterRadius);
+            verts[2].fPos = SkPoint::Make(bounds.fRight, bounds.fBottom);
+            verts[2].fOffset = SkPoint::Make(xOuterRadius, yOuterRadius);
             verts[3].fPos = SkPoint::Make(bounds.fRight, bounds.fTop);
-            verts[3].fColor = color;
-            verts[3].fOffset = SkPoint::Make(xMaxOffset, -yMaxOffset);
-            verts[3].fOuterRadii = SkPoint::Make(xRadRecip, yRadRecip);
-            verts[3].fInnerRadii = SkPoint::Make(xInnerRadRecip, yInnerRadRecip);
+            verts[3].fOffset = SkPoint::Make(xOuterRadius, -yOuterRadius);
+            for (int i = 0; i < kVerticesPerQuad; ++i) {
+                verts[i].fColor = color;
+                verts[i].fOuterRadii = outerRadii;
+                verts[i].fInnerRadii = innerRadii;
+            }
+            return;
+        }
 
-            verts += kVerticesPerQuad;
+        SkScalar xCoords[4] = {
+            bounds.fLeft,
+            bounds.fLeft + xOuterRadius,
+            bounds.fRight - xOuterRadius,
+            bounds.fRight
+        };
+        SkScalar yCoords[4] = {
+            bounds.fTop,
+            bounds.fTop + yOuterRadius,
+            bounds.fBottom - yOuterRadius,
+            bounds.fBottom
+        };
+        // we're using inversesqrt() in shader, so can't be exactly 0
+        SkScalar xOuterOffsets[4] = {
+            xOuterRadius, SK_ScalarNearlyZero, SK_ScalarNearlyZero, xOuterRadius
+        };
+        SkScalar yOuterOffsets[4] = {
+            yOuterRadius, SK_ScalarNearlyZero, SK_ScalarNearlyZero, yOuterRadius
+        };
+
+        for (int y = 0; y < 4; ++y) {
+            for (int x = 0; x < 4; ++x) {
+                verts->fPos = SkPoint::Make(xCoords[x], yCoords[y]);
+                verts->fColor = color;
+                verts->fOffset = SkPoint::Make(xOuterOffsets[x], yOuterOffsets[y]);
+                verts->fOuterRadii = outerRadii;
+                verts->fInnerRadii = innerRadii;
+                verts++;
+            }
         }
-        helper.recordDraw(target, gp);
     }
 
     bool onCombineIfPossible(GrBatch* t, const GrCaps& caps) override {
-        EllipseBatch* that = t->cast<EllipseBatch>();
+        RoundedShapeBatch* that = t->cast<RoundedShapeBatch>();
 
-        if (!GrPipeline::CanCombine(*this->pipeline(), this->bounds(), *that->pipeline(),
-                                    that->bounds(), caps)) {
+        // Every vertex must stay addressable by our 16 bit indices.
+        if (fVertCount + that->fVertCount > SK_MaxU16 + 1) {
             return false;
         }
 
-        if (fStroked != that->fStroked) {
+        if (!GrPipeline::CanCombine(*this->pipeline(), this->bounds(), *that->pipeline(),
+                                    that->bounds(), caps)) {
             return false;
         }
 
@@ -900,20 +1035,18 @@ private:
         }
 
         fGeoData.push_back_n(that->fGeoData.count(), that->fGeoData.begin());
+        fStroked |= that->fStroked;
+        fAllCircles &= that->fAllCircles;
+        fVertCount += that->fVertCount;
+        fIndexCount += that->fIndexCount;
         this->joinBounds(*that);
         return true;
     }
 
-    struct Geometry {
-        GrColor fColor;
-        SkScalar fXRadius;
-        SkScalar fYRadius;
-        SkScalar fInnerXRadius;
-        SkScalar fInnerYRadius;
-        SkRect fDevBounds;
-    };
-
     bool                         fStroked;
+    bool                         fAllCircles;
+    int                          fVertCount;
+    int                          fIndexCount;
     SkMatrix                     fViewMatrixIfUsingLocalCoords;
     SkSTArray<1, Geometry, true> fGeoData;
 
@@ -1123,442 +1256,6 @@ private:
     typedef GrVertexBatch INHERITED;
 };
 
-///////////////////////////////////////////////////////////////////////////////
-
-static const uint16_t gRRectIndices[] = {
-    // corners
-    0, 1, 5, 0, 5, 4,
-    2, 3, 7, 2, 7, 6,
-    8, 9, 13, 8, 13, 12,
-    10, 11, 15, 10, 15, 14,
-
-    // edges
-    1, 2, 6, 1, 6, 5,
-    4, 5, 9, 4, 9, 8,
-    6, 7, 11, 6, 11, 10,
-    9, 10, 14, 9, 14, 13,
-
-    // center
-    // we place this at the end so that we can ignore these indices when rendering stroke-only
-    5, 6, 10, 5, 10, 9
-};
-
-static const int kIndicesPerStrokeRRect = SK_ARRAY_COUNT(gRRectIndices) - 6;
-static const int kIndicesPerRRect = SK_ARRAY_COUNT(gRRectIndices);
-static const int kVertsPerRRect = 16;
-static const int kNumRRectsInIndexBuffer = 256;
-
-GR_DECLARE_STATIC_UNIQUE_KEY(gStrokeRRectOnlyIndexBufferKey);
-GR_DECLARE_STATIC_UNIQUE_KEY(gRRectOnlyIndexBufferKey);
-static const GrBuffer* ref_rrect_index_buffer(bool strokeOnly,
-                                              GrResourceProvider* resourceProvider) {
-    GR_DEFINE_STATIC_UNIQUE_KEY(gStrokeRRectOnlyIndexBufferKey);
-    GR_DEFINE_STATIC_UNIQUE_KEY(gRRectOnlyIndexBufferKey);
-    if (strokeOnly) {
-        return resourceProvider->findOrCreateInstancedIndexBuffer(
-            gRRectIndices, kIndicesPerStrokeRRect, kNumRRectsInIndexBuffer, kVertsPerRRect,
-            gStrokeRRectOnlyIndexBufferKey);
-    } else {
-        return resourceProvider->findOrCreateInstancedIndexBuffer(
-            gRRectIndices, kIndicesPerRRect, kNumRRectsInIndexBuffer, kVertsPerRRect,
-            gRRectOnlyIndexBufferKey);
-
-    }
-}
-
-///////////////////////////////////////////////////////////////////////////////////////////////////
-
-class RRectCircleRendererBatch : public GrVertexBatch {
-public:
-    DEFINE_BATCH_CLASS_ID
-
-    // A devStrokeWidth <= 0 indicates a fill only. If devStrokeWidth > 0 then strokeOnly indicates
-    // whether the rrect is only stroked or stroked and filled.
-    RRectCircleRendererBatch(GrColor color, const SkMatrix& viewMatrix, const SkRect& devRect,
-                             float devRadius, float devStrokeWidth, bool strokeOnly)
-            : INHERITED(ClassID())
-            , fViewMatrixIfUsingLocalCoords(viewMatrix) {
-        SkRect bounds = devRect;
-        SkASSERT(!(devStrokeWidth <= 0 && strokeOnly));
-        SkScalar innerRadius = 0.0f;
-        SkScalar outerRadius = devRadius;
-        SkScalar halfWidth = 0;
-        fStroked = false;
-        if (devStrokeWidth > 0) {
-            if (SkScalarNearlyZero(devStrokeWidth)) {
-                halfWidth = SK_ScalarHalf;
-            } else {
-                halfWidth = SkScalarHalf(devStrokeWidth);
-            }
-
-            if (strokeOnly) {
-                innerRadius = devRadius - halfWidth;
-                fStroked = innerRadius >= 0;
-            }
-            outerRadius += halfWidth;
-            bounds.outset(halfWidth, halfWidth);
-        }
-
-        // The radii are outset for two reasons. First, it allows the shader to simply perform
-        // simpler computation because the computed alpha is zero, rather than 50%, at the radius.
-        // Second, the outer radius is used to compute the verts of the bounding box that is
-        // rendered and the outset ensures the box will cover all partially covered by the rrect
-        // corners.
-        outerRadius += SK_ScalarHalf;
-        innerRadius -= SK_ScalarHalf;
-
-        this->setBounds(bounds, HasAABloat::kYes, IsZeroArea::kNo);
-
-        // Expand the rect for aa to generate correct vertices.
-        bounds.outset(SK_ScalarHalf, SK_ScalarHalf);
-
-        fGeoData.emplace_back(Geometry { color, innerRadius, outerRadius, bounds });
-    }
-
-    const char* name() const override { return "RRectCircleBatch"; }
-
-    void computePipelineOptimizations(GrInitInvariantOutput* color,
-                                      GrInitInvariantOutput* coverage,
-                                      GrBatchToXPOverrides* overrides) const override {
-        // When this is called on a batch, there is only one geometry bundle
-        color->setKnownFourComponents(fGeoData[0].fColor);
-        coverage->setUnknownSingleComponent();
-    }
-
-private:
-    void initBatchTracker(const GrXPOverridesForBatch& overrides) override {
-        // Handle any overrides that affect our GP.
-        overrides.getOverrideColorIfSet(&fGeoData[0].fColor);
-        if (!overrides.readsLocalCoords()) {
-            fViewMatrixIfUsingLocalCoords.reset();
-        }
-    }
-
-    void onPrepareDraws(Target* target) const override {
-        // Invert the view matrix as a local matrix (if any other processors require coords).
-        SkMatrix localMatrix;
-        if (!fViewMatrixIfUsingLocalCoords.invert(&localMatrix)) {
-            return;
-        }
-
-        // Setup geometry processor
-        SkAutoTUnref<GrGeometryProcessor> gp(new CircleGeometryProcessor(fStroked, localMatrix));
-
-        int instanceCount = fGeoData.count();
-        size_t vertexStride = gp->getVertexStride();
-        SkASSERT(vertexStride == sizeof(CircleVertex));
-
-        // drop out the middle quad if we're stroked
-        int indicesPerInstance = fStroked ? kIndicesPerStrokeRRect : kIndicesPerRRect;
-        SkAutoTUnref<const GrBuffer> indexBuffer(
-            ref_rrect_index_buffer(fStroked, target->resourceProvider()));
-
-        InstancedHelper helper;
-        CircleVertex* verts = reinterpret_cast<CircleVertex*>(helper.init(target,
-            kTriangles_GrPrimitiveType, vertexStride, indexBuffer, kVertsPerRRect,
-            indicesPerInstance, instanceCount));
-        if (!verts || !indexBuffer) {
-            SkDebugf("Could not allocate vertices\n");
-            return;
-        }
-
-        for (int i = 0; i < instanceCount; i++) {
-            const Geometry& args = fGeoData[i];
-
-            GrColor color = args.fColor;
-            SkScalar outerRadius = args.fOuterRadius;
-
-            const SkRect& bounds = args.fDevBounds;
-
-            SkScalar yCoords[4] = {
-                bounds.fTop,
-                bounds.fTop + outerRadius,
-                bounds.fBottom - outerRadius,
-                bounds.fBottom
-            };
-
-            SkScalar yOuterRadii[4] = {-1, 0, 0, 1 };
-            // The inner radius in the vertex data must be specified in normalized space.
-            SkScalar innerRadius = args.fInnerRadius / args.fOuterRadius;
-            for (int i = 0; i < 4; ++i) {
-                verts->fPos = SkPoint::Make(bounds.fLeft, yCoords[i]);
-                verts->fColor = color;
-                verts->fOffset = SkPoint::Make(-1, yOuterRadii[i]);
-                verts->fOuterRadius = outerRadius;
-                verts->fInnerRadius = innerRadius;
-                verts++;
-
-                verts->fPos = SkPoint::Make(bounds.fLeft + outerRadius, yCoords[i]);
-                verts->fColor = color;
-                verts->fOffset = SkPoint::Make(0, yOuterRadii[i]);
-                verts->fOuterRadius = outerRadius;
-                verts->fInnerRadius = innerRadius;
-                verts++;
-
-                verts->fPos = SkPoint::Make(bounds.fRight - outerRadius, yCoords[i]);
-                verts->fColor = color;
-                verts->fOffset = SkPoint::Make(0, yOuterRadii[i]);
-                verts->fOuterRadius = outerRadius;
-                verts->fInnerRadius = innerRadius;
-                verts++;
-
-                verts->fPos = SkPoint::Make(bounds.fRight, yCoords[i]);
-                verts->fColor = color;
-                verts->fOffset = SkPoint::Make(1, yOuterRadii[i]);
-                verts->fOuterRadius = outerRadius;
-                verts->fInnerRadius = innerRadius;
-                verts++;
-            }
-        }
-
-        helper.recordDraw(target, gp);
-    }
-
-    bool onCombineIfPossible(GrBatch* t, const GrCaps& caps) override {
-        RRectCircleRendererBatch* that = t->cast<RRectCircleRendererBatch>();
-        if (!GrPipeline::CanCombine(*this->pipeline(), this->bounds(), *that->pipeline(),
-                                    that->bounds(), caps)) {
-            return false;
-        }
-
-        if (fStroked != that->fStroked) {
-            return false;
-        }
-
-        if (!fViewMatrixIfUsingLocalCoords.cheapEqualTo(that->fViewMatrixIfUsingLocalCoords)) {
-            return false;
-        }
-
-        fGeoData.push_back_n(that->fGeoData.count(), that->fGeoData.begin());
-        this->joinBounds(*that);
-        return true;
-    }
-
-    struct Geometry {
-        GrColor  fColor;
-        SkScalar fInnerRadius;
-        SkScalar fOuterRadius;
-        SkRect fDevBounds;
-    };
-
-    bool                         fStroked;
-    SkMatrix                     fViewMatrixIfUsingLocalCoords;
-    SkSTArray<1, Geometry, true> fGeoData;
-
-    typedef GrVertexBatch INHERITED;
-};
-
-class RRectEllipseRendererBatch : public GrVertexBatch {
-public:
-    DEFINE_BATCH_CLASS_ID
-
-    // If devStrokeWidths values are <= 0 indicates then fill only. Otherwise, strokeOnly indicates
-    // whether the rrect is only stroked or stroked and filled.
-    static GrDrawBatch* Create(GrColor color, const SkMatrix& viewMatrix, const SkRect& devRect,
-                               float devXRadius, float devYRadius, SkVector devStrokeWidths,
-                               bool strokeOnly) {
-        SkASSERT(devXRadius > 0.5);
-        SkASSERT(devYRadius > 0.5);
-        SkASSERT((devStrokeWidths.fX > 0) == (devStrokeWidths.fY > 0));
-        SkASSERT(!(strokeOnly && devStrokeWidths.fX <= 0));
-        SkScalar innerXRadius = 0.0f;
-        SkScalar innerYRadius = 0.0f;
-        SkRect bounds = devRect;
-        bool stroked = false;
-        if (devStrokeWidths.fX > 0) {
-            if (SkScalarNearlyZero(devStrokeWidths.length())) {
-                devStrokeWidths.set(SK_ScalarHalf, SK_ScalarHalf);
-            } else {
-                devStrokeWidths.scale(SK_ScalarHalf);
-            }
-
-            // we only handle thick strokes for near-circular ellipses
-            if (devStrokeWidths.length() > SK_ScalarHalf &&
-                (SK_ScalarHalf*devXRadius > devYRadius || SK_ScalarHalf*devYRadius > devXRadius)) {
-                return nullptr;
-            }
-
-            // we don't handle it if curvature of the stroke is less than curvature of the ellipse
-            if (devStrokeWidths.fX*(devYRadius*devYRadius) <
-                (devStrokeWidths.fY*devStrokeWidths.fY)*devXRadius) {
-                return nullptr;
-            }
-            if (devStrokeWidths.fY*(devXRadius*devXRadius) <
-                (devStrokeWidths.fX*devStrokeWidths.fX)*devYRadius) {
-                return nullptr;
-            }
-
-            // this is legit only if scale & translation (which should be the case at the moment)
-            if (strokeOnly) {
-                innerXRadius = devXRadius - devStrokeWidths.fX;
-                innerYRadius = devYRadius - devStrokeWidths.fY;
-                stroked = (innerXRadius >= 0 && innerYRadius >= 0);
-            }
-
-            devXRadius += devStrokeWidths.fX;
-            devYRadius += devStrokeWidths.fY;
-            bounds.outset(devStrokeWidths.fX, devStrokeWidths.fY);
-        }
-
-        RRectEllipseRendererBatch* batch = new RRectEllipseRendererBatch();
-        batch->fStroked = stroked;
-        batch->fViewMatrixIfUsingLocalCoords = viewMatrix;
-        batch->setBounds(bounds, HasAABloat::kYes, IsZeroArea::kNo);
-        // Expand the rect for aa in order to generate the correct vertices.
-        bounds.outset(SK_ScalarHalf, SK_ScalarHalf);
-        batch->fGeoData.emplace_back(
-            Geometry {color, devXRadius, devYRadius, innerXRadius, innerYRadius, bounds});
-        return batch;
-    }
-
-    const char* name() const override { return "RRectEllipseRendererBatch"; }
-
-    void computePipelineOptimizations(GrInitInvariantOutput* color,
-                                      GrInitInvariantOutput* coverage,
-                                      GrBatchToXPOverrides* overrides) const override {
-        // When this is called on a batch, there is only one geometry bundle
-        color->setKnownFourComponents(fGeoData[0].fColor);
-        coverage->setUnknownSingleComponent();
-    }
-
-private:
-    RRectEllipseRendererBatch() : INHERITED(ClassID()) {}
-
-    void initBatchTracker(const GrXPOverridesForBatch& overrides) override {
-        // Handle overrides that affect our GP.
-        overrides.getOverrideColorIfSet(&fGeoData[0].fColor);
-        if (!overrides.readsLocalCoords()) {
-            fViewMatrixIfUsingLocalCoords.reset();
-        }
-    }
-
-    void onPrepareDraws(Target* target) const override {
-        SkMatrix localMatrix;
-        if (!fViewMatrixIfUsingLocalCoords.invert(&localMatrix)) {
-            return;
-        }
-
-        // Setup geometry processor
-        SkAutoTUnref<GrGeometryProcessor> gp(new EllipseGeometryProcessor(fStroked, localMatrix));
-
-        int instanceCount = fGeoData.count();
-        size_t vertexStride = gp->getVertexStride();
-        SkASSERT(vertexStride == sizeof(EllipseVertex));
-
-        // drop out the middle quad if we're stroked
-        int indicesPerInstance = fStroked ? kIndicesPerStrokeRRect : kIndicesPerRRect;
-        SkAutoTUnref<const GrBuffer> indexBuffer(
-            ref_rrect_index_buffer(fStroked, target->resourceProvider()));
-
-        InstancedHelper helper;
-        EllipseVertex* verts = reinterpret_cast<EllipseVertex*>(
-            helper.init(target, kTriangles_GrPrimitiveType, vertexStride, indexBuffer,
-            kVertsPerRRect, indicesPerInstance, instanceCount));
-        if (!verts || !indexBuffer) {
-            SkDebugf("Could not allocate vertices\n");
-            return;
-        }
-
-        for (int i = 0; i < instanceCount; i++) {
-            const Geometry& args = fGeoData[i];
-
-            GrColor color = args.fColor;
-
-            // Compute the reciprocals of the radii here to save time in the shader
-            SkScalar xRadRecip = SkScalarInvert(args.fXRadius);
-            SkScalar yRadRecip = SkScalarInvert(args.fYRadius);
-            SkScalar xInnerRadRecip = SkScalarInvert(args.fInnerXRadius);
-            SkScalar yInnerRadRecip = SkScalarInvert(args.fInnerYRadius);
-
-            // Extend the radii out half a pixel to antialias.
-            SkScalar xOuterRadius = args.fXRadius + SK_ScalarHalf;
-            SkScalar yOuterRadius = args.fYRadius + SK_ScalarHalf;
-
-            const SkRect& bounds = args.fDevBounds;
-
-            SkScalar yCoords[4] = {
-                bounds.fTop,
-                bounds.fTop + yOuterRadius,
-                bounds.fBottom - yOuterRadius,
-                bounds.fBottom
-            };
-            SkScalar yOuterOffsets[4] = {
-                yOuterRadius,
-                SK_ScalarNearlyZero, // we're using inversesqrt() in shader, so can't be exactly 0
-                SK_ScalarNearlyZero,
-                yOuterRadius
-            };
-
-            for (int i = 0; i < 4; ++i) {
-                verts->fPos = SkPoint::Make(bounds.fLeft, yCoords[i]);
-                verts->fColor = color;
-                verts->fOffset = SkPoint::Make(xOuterRadius, yOuterOffsets[i]);
-                verts->fOuterRadii = SkPoint::Make(xRadRecip, yRadRecip);
-                verts->fInnerRadii = SkPoint::Make(xInnerRadRecip, yInnerRadRecip);
-                verts++;
-
-                verts->fPos = SkPoint::Make(bounds.fLeft + xOuterRadius, yCoords[i]);
-                verts->fColor = color;
-                verts->fOffset = SkPoint::Make(SK_ScalarNearlyZero, yOuterOffsets[i]);
-                verts->fOuterRadii = SkPoint::Make(xRadRecip, yRadRecip);
-                verts->fInnerRadii = SkPoint::Make(xInnerRadRecip, yInnerRadRecip);
-                verts++;
-
-                verts->fPos = SkPoint::Make(bounds.fRight - xOuterRadius, yCoords[i]);
-                verts->fColor = color;
-                verts->fOffset = SkPoint::Make(SK_ScalarNearlyZero, yOuterOffsets[i]);
-                verts->fOuterRadii = SkPoint::Make(xRadRecip, yRadRecip);
-                verts->fInnerRadii = SkPoint::Make(xInnerRadRecip, yInnerRadRecip);
-                verts++;
-
-                verts->fPos = SkPoint::Make(bounds.fRight, yCoords[i]);
-                verts->fColor = color;
-                verts->fOffset = SkPoint::Make(xOuterRadius, yOuterOffsets[i]);
-                verts->fOuterRadii = SkPoint::Make(xRadRecip, yRadRecip);
-                verts->fInnerRadii = SkPoint::Make(xInnerRadRecip, yInnerRadRecip);
-                verts++;
-            }
-        }
-        helper.recordDraw(target, gp);
-    }
-
-    bool onCombineIfPossible(GrBatch* t, const GrCaps& caps) override {
-        RRectEllipseRendererBatch* that = t->cast<RRectEllipseRendererBatch>();
-
-        if (!GrPipeline::CanCombine(*this->pipeline(), this->bounds(), *that->pipeline(),
-                                    that->bounds(), caps)) {
-            return false;
-        }
-
-        if (fStroked != that->fStroked) {
-            return false;
-        }
-
-        if (!fViewMatrixIfUsingLocalCoords.cheapEqualTo(that->fViewMatrixIfUsingLocalCoords)) {
-            return false;
-        }
-
-        fGeoData.push_back_n(that->fGeoData.count(), that->fGeoData.begin());
-        this->joinBounds(*that);
-        return true;
-    }
-
-    struct Geometry {
-        GrColor fColor;
-        SkScalar fXRadius;
-        SkScalar fYRadius;
-        SkScalar fInnerXRadius;
-        SkScalar fInnerYRadius;
-        SkRect fDevBounds;
-    };
-
-    bool                            fStroked;
-    SkMatrix                        fViewMatrixIfUsingLocalCoords;
-    SkSTArray<1, Geometry, true>    fGeoData;
-
-    typedef GrVertexBatch INHERITED;
-};
-
 static GrDrawBatch* create_rrect_batch(GrColor color,
                                        const SkMatrix& viewMatrix,
                                        const SkRRect& rrect,
@@ -1616,12 +1313,12 @@ static GrDrawBatch* create_rrect_batch(GrColor color,
 
     // if the corners are circles, use the circle renderer
     if ((!hasStroke || scaledStroke.fX == scaledStroke.fY) && xRadius == yRadius) {
-        return new RRectCircleRendererBatch(color, viewMatrix, bounds, xRadius, scaledStroke.fX,
-                                            isStrokeOnly);
+        return RoundedShapeBatch::CreateCircularRRect(color, viewMatrix, bounds, xRadius,
+                                                      scaledStroke.fX, isStrokeOnly);
     // otherwise we use the ellipse renderer
     } else {
-        return RRectEllipseRendererBatch::Create(color, viewMatrix, bounds, xRadius, yRadius,
-                                                 scaledStroke, isStrokeOnly);
+        return RoundedShapeBatch::CreateEllipticalRRect(color, viewMatrix, bounds, xRadius,
+                                                        yRadius, scaledStroke, isStrokeOnly);
 
     }
 }
@@ -1651,7 +1348,7 @@ GrDrawBatch* GrOvalRenderer::CreateOvalBatch(GrColor color,
                                              GrShaderCaps* shaderCaps) {
     // we can draw circles
     if (SkScalarNearlyEqual(oval.width(), oval.height()) && circle_stays_circle(viewMatrix)) {
-        return new CircleBatch(color, viewMatrix, oval, stroke);
+        return RoundedShapeBatch::CreateCircle(color, viewMatrix, oval, stroke);
     }
 
     // if we have shader derivative support, render as device-independent
@@ -1661,7 +1358,7 @@ GrDrawBatch* GrOvalRenderer::CreateOvalBatch(GrColor color,
 
     // otherwise axis-aligned ellipses only
     if (viewMatrix.rectStaysRect()) {
-        return EllipseBatch::Create(color, viewMatrix, oval, stroke);
+        return RoundedShapeBatch::CreateEllipse(color, viewMatrix, oval, stroke);
     }
 
     return nullptr;
@@ -1675,14 +1372,16 @@ DRAW_BATCH_TEST_DEFINE(CircleBatch) {
     SkMatrix viewMatrix = GrTest::TestMatrix(random);
     GrColor color = GrRandomColor(random);
     SkRect circle = GrTest::TestSquare(random);
-    return new CircleBatch(color, viewMatrix, circle, GrTest::TestStrokeRec(random));
+    return RoundedShapeBatch::CreateCircle(color, viewMatrix, circle,
+                                           GrTest::TestStrokeRec(random));
 }
 
 DRAW_BATCH_TEST_DEFINE(EllipseBatch) {
     SkMatrix viewMatrix = GrTest::TestMatrixRectStaysRect(random);
     GrColor color = GrRandomColor(random);
     SkRect ellipse = GrTest::TestSquare(random);
-    return EllipseBatch::Create(color, viewMatrix, ellipse, GrTest::TestStrokeRec(random));
+    return RoundedShapeBatch::CreateEllipse(color, viewMatrix, ellipse,
+                                            GrTest::TestStrokeRec(random));
 }
 
 DRAW_BATCH_TEST_DEFINE(DIEllipseBatch) {
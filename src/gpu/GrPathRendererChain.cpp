@@ -18,6 +18,7 @@
 #include "batches/GrAADistanceFieldPathRenderer.h"
 #include "batches/GrAAHairLinePathRenderer.h"
 #include "batches/GrAALinearizingConvexPathRenderer.h"
+#include "batches/GrCoverageCountingPathRenderer.h"
 #include "batches/GrDashLinePathRenderer.h"
 #include "batches/GrDefaultPathRenderer.h"
 #include "batches/GrMSAAPathRenderer.h"
@@ -40,6 +41,9 @@ GrPathRendererChain::GrPathRendererChain(GrContext* context) {
     this->addPathRenderer(new GrAAHairLinePathRenderer)->unref();
     this->addPathRenderer(new GrAAConvexPathRenderer)->unref();
     this->addPathRenderer(new GrAALinearizingConvexPathRenderer)->unref();
+    if (GrPathRenderer* pr = GrCoverageCountingPathRenderer::Create(context)) {
+        this->addPathRenderer(pr)->unref();
+    }
     if (caps.shaderCaps()->plsPathRenderingSupport()) {
         this->addPathRenderer(new GrPLSPathRenderer)->unref();
     }
@@ -8,7 +8,11 @@
 #include "GrPathRendering.h"
 #include "SkDescriptor.h"
 #include "SkGlyph.h"
+#include "SkGlyphCache.h"
+#include "SkMaskFilter.h"
 #include "SkMatrix.h"
+#include "SkPathEffect.h"
+#include "SkRasterizer.h"
 #include "SkTypeface.h"
 #include "GrPathRange.h"
 
@@ -43,41 +47,51 @@ const GrUserStencilSettings& GrPathRendering::GetStencilPassSettings(FillType fi
     }
 }
 
+// Glyph outlines come from the process-wide SkGlyphCache rather than a private scaler context.
+// A path range for the same glyphs in another GrContext, or one recreated after being purged,
+// then reuses the outlines already generated instead of asking the font for them again.
 class GlyphGenerator : public GrPathRange::PathGenerator {
 public:
     GlyphGenerator(const SkTypeface& typeface, const SkScalerContextEffects& effects,
                    const SkDescriptor& desc)
-        : fScalerContext(typeface.createScalerContext(effects, &desc))
-#ifdef SK_DEBUG
+        : fTypeface(SkRef(const_cast<SkTypeface*>(&typeface)))
+        , fPathEffect(SkSafeRef(effects.fPathEffect))
+        , fMaskFilter(SkSafeRef(effects.fMaskFilter))
+        , fRasterizer(SkSafeRef(effects.fRasterizer))
         , fDesc(desc.copy())
-#endif
     {}
 
     virtual ~GlyphGenerator() {
-#ifdef SK_DEBUG
         SkDescriptor::Free(fDesc);
-#endif
     }
 
     int getNumPaths() override {
-        return fScalerContext->getGlyphCount();
+        SkAutoGlyphCache cache(fTypeface.get(), this->effects(), fDesc);
+        return cache->getScalerContext()->getGlyphCount();
     }
 
     void generatePath(int glyphID, SkPath* out) override {
-        SkGlyph skGlyph;
-        skGlyph.initWithGlyphID(glyphID);
-        fScalerContext->getMetrics(&skGlyph);
-
-        fScalerContext->getPath(skGlyph, out);
+        SkAutoGlyphCache cache(fTypeface.get(), this->effects(), fDesc);
+        const SkGlyph& skGlyph = cache->getGlyphIDMetrics(glyphID);
+        if (const SkPath* path = cache->findPath(skGlyph)) {
+            *out = *path;
+        } else {
+            out->reset();
+        }
     }
 #ifdef SK_DEBUG
     bool isEqualTo(const SkDescriptor& desc) const override { return *fDesc == desc; }
 #endif
 private:
-    const SkAutoTDelete<SkScalerContext> fScalerContext;
-#ifdef SK_DEBUG
-    SkDescriptor* const fDesc;
-#endif
+    SkScalerContextEffects effects() const {
+        return SkScalerContextEffects(fPathEffect.get(), fMaskFilter.get(), fRasterizer.get());
+    }
+
+    const sk_sp<SkTypeface>    fTypeface;
+    const sk_sp<SkPathEffect>  fPathEffect;
+    const sk_sp<SkMaskFilter>  fMaskFilter;
+    const sk_sp<SkRasterizer>  fRasterizer;
+    SkDescriptor* const        fDesc;
 };
 
 GrPathRange* GrPathRendering::createGlyphs(const SkTypeface* typeface,
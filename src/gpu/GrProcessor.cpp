@@ -88,8 +88,8 @@ public:
 
     ~MemoryPoolAccessor() { gProcessorSpinlock.release(); }
 
-    GrMemoryPool* pool() const {
-        static GrMemoryPool gPool(4096, 4096);
+    GrSizeClassPool* pool() const {
+        static GrSizeClassPool gPool(16384);
         return &gPool;
     }
 };
@@ -14,6 +14,14 @@ bool GrRectanizerSkyline::addRect(int width, int height, SkIPoint16* loc) {
         return false;
     }
 
+    fMinWidth = SkMin32(fMinWidth, width);
+    fMinHeight = SkMin32(fMinHeight, height);
+
+    if (this->addToFreeRect(width, height, loc)) {
+        fAreaSoFar += width*height;
+        return true;
+    }
+
     // find position for new rectangle
     int bestWidth = this->width() + 1;
     int bestX;
@@ -34,6 +42,7 @@ bool GrRectanizerSkyline::addRect(int width, int height, SkIPoint16* loc) {
 
     // add rectangle to skyline
     if (-1 != bestIndex) {
+        this->addWaste(bestIndex, bestX, bestY, width);
         this->addSkylineLevel(bestIndex, bestX, bestY, width, height);
         loc->fX = bestX;
         loc->fY = bestY;
@@ -70,6 +79,58 @@ bool GrRectanizerSkyline::rectangleFits(int skylineIndex, int width, int height,
     return true;
 }
 
+bool GrRectanizerSkyline::addToFreeRect(int width, int height, SkIPoint16* loc) {
+    // best short side fit: leave the least room along the tighter axis
+    int bestIndex = -1;
+    int bestShortSide = SK_MaxS32;
+    for (int i = 0; i < fFreeRects.count(); ++i) {
+        const SkIRect& r = fFreeRects[i];
+        int leftoverW = r.width() - width;
+        int leftoverH = r.height() - height;
+        if (leftoverW >= 0 && leftoverH >= 0) {
+            int shortSide = SkMin32(leftoverW, leftoverH);
+            if (shortSide < bestShortSide) {
+                bestIndex = i;
+                bestShortSide = shortSide;
+                if (0 == shortSide) {
+                    break;
+                }
+            }
+        }
+    }
+    if (-1 == bestIndex) {
+        return false;
+    }
+
+    SkIRect r = fFreeRects[bestIndex];
+    fFreeRects.removeShuffle(bestIndex);
+    loc->fX = r.fLeft;
+    loc->fY = r.fTop;
+
+    // Split the remainder along the shorter leftover axis, keeping the bigger piece whole.
+    SkIRect right, below;
+    if (r.width() - width < r.height() - height) {
+        right.setLTRB(r.fLeft + width, r.fTop, r.fRight, r.fTop + height);
+        below.setLTRB(r.fLeft, r.fTop + height, r.fRight, r.fBottom);
+    } else {
+        right.setLTRB(r.fLeft + width, r.fTop, r.fRight, r.fBottom);
+        below.setLTRB(r.fLeft, r.fTop + height, r.fLeft + width, r.fBottom);
+    }
+    this->addFreeRect(right);
+    this->addFreeRect(below);
+    return true;
+}
+
+void GrRectanizerSkyline::addWaste(int skylineIndex, int x, int y, int width) {
+    for (int i = skylineIndex; i < fSkyline.count() && fSkyline[i].fX < x + width; ++i) {
+        const SkylineSegment& seg = fSkyline[i];
+        if (seg.fY < y) {
+            this->addFreeRect(SkIRect::MakeLTRB(SkTMax(seg.fX, x), seg.fY,
+                                                SkTMin(seg.fX + seg.fWidth, x + width), y));
+        }
+    }
+}
+
 void GrRectanizerSkyline::addSkylineLevel(int skylineIndex, int x, int y, int width, int height) {
     SkylineSegment newSegment;
     newSegment.fX = x;
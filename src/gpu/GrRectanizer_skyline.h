@@ -9,10 +9,15 @@
 #define GrRectanizer_skyline_DEFINED
 
 #include "GrRectanizer.h"
+#include "SkRect.h"
 #include "SkTDArray.h"
 
 // Pack rectangles and track the current silhouette
 // Based, in part, on Jukka Jylanki's work at http://clb.demon.fi
+//
+// Placing a rect on top of an uneven stretch of skyline leaves holes underneath it that the
+// skyline can never reach again. Those holes are kept in a list of free rects (Jylanki's
+// "waste map") and are filled first, so small rects like glyphs stop raising the skyline.
 class GrRectanizerSkyline : public GrRectanizer {
 public:
     GrRectanizerSkyline(int w, int h) : INHERITED(w, h) {
@@ -23,6 +28,9 @@ public:
 
     void reset() override {
         fAreaSoFar = 0;
+        fFreeRects.reset();
+        fMinWidth = this->width();
+        fMinHeight = this->height();
         fSkyline.reset();
         SkylineSegment* seg = fSkyline.append(1);
         seg->fX = 0;
@@ -44,6 +52,11 @@ private:
     };
 
     SkTDArray<SkylineSegment> fSkyline;
+    // Disjoint, empty holes below the skyline.
+    SkTDArray<SkIRect>        fFreeRects;
+    // The smallest width and height asked for so far; thinner holes aren't worth keeping.
+    int                       fMinWidth;
+    int                       fMinHeight;
 
     int32_t fAreaSoFar;
 
@@ -55,6 +68,16 @@ private:
     // Update the skyline structure to include a width x height rect located
     // at x,y.
     void addSkylineLevel(int skylineIndex, int x, int y, int width, int height);
+    // Try to place a width x height rect in one of fFreeRects, splitting what is left of the
+    // chosen free rect back into the list.
+    bool addToFreeRect(int width, int height, SkIPoint16* loc);
+    // Add the holes that a width x height rect at x,y is about to cover over to fFreeRects.
+    void addWaste(int skylineIndex, int x, int y, int width);
+    void addFreeRect(const SkIRect& r) {
+        if (r.width() >= fMinWidth && r.height() >= fMinHeight) {
+            *fFreeRects.append() = r;
+        }
+    }
 
     typedef GrRectanizer INHERITED;
 };
@@ -418,3 +418,68 @@ void GrReducedClip::ReduceClipStack(const SkClipStack& stack,
     // element.
     SkASSERT(SkClipStack::kInvalidGenID != *resultGenID);
 }
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Query bounds are rounded out to multiples of this many pixels before they key a reduction.
+static const int kQueryBoundsQuantum = 32;
+
+static int32_t quantize_down(int32_t x) {
+    return x & ~(kQueryBoundsQuantum - 1);
+}
+
+static int32_t quantize_up(int32_t x) {
+    return quantize_down(x + (kQueryBoundsQuantum - 1));
+}
+
+bool GrReducedClipCache::reduceClipStack(const SkClipStack& stack,
+                                         const SkIRect& queryBounds,
+                                         const GrReducedClip::ElementList** result,
+                                         int32_t* resultGenID,
+                                         GrReducedClip::InitialState* initialState,
+                                         SkIRect* tighterBounds,
+                                         bool* requiresAA) {
+    const int32_t stackGenID = stack.getTopmostGenID();
+    const SkIRect cacheBounds = SkIRect::MakeLTRB(quantize_down(queryBounds.fLeft),
+                                                  quantize_down(queryBounds.fTop),
+                                                  quantize_up(queryBounds.fRight),
+                                                  quantize_up(queryBounds.fBottom));
+
+    const Entry* entry = nullptr;
+    for (int i = 0; i < kEntryCount; ++i) {
+        if (fEntries[i].fStackGenID == stackGenID && fEntries[i].fQueryBounds == cacheBounds) {
+            entry = &fEntries[i];
+            break;
+        }
+    }
+    if (!entry) {
+        Entry* newEntry = &fEntries[fNextEntry];
+        fNextEntry = (fNextEntry + 1) % kEntryCount;
+        // The bounds must not overflow when rounded out; if they would, don't cache.
+        if (cacheBounds.fLeft > queryBounds.fLeft || cacheBounds.fTop > queryBounds.fTop ||
+            cacheBounds.fRight < queryBounds.fRight || cacheBounds.fBottom < queryBounds.fBottom) {
+            newEntry->fStackGenID = SkClipStack::kInvalidGenID;
+            newEntry->fQueryBounds = queryBounds;
+        } else {
+            newEntry->fStackGenID = stackGenID;
+            newEntry->fQueryBounds = cacheBounds;
+        }
+        newEntry->fTighterBounds = newEntry->fQueryBounds;
+        newEntry->fRequiresAA = false;
+        GrReducedClip::ReduceClipStack(stack, newEntry->fQueryBounds, &newEntry->fElements,
+                                       &newEntry->fResultGenID, &newEntry->fInitialState,
+                                       &newEntry->fTighterBounds, &newEntry->fRequiresAA);
+        entry = newEntry;
+    }
+
+    *result = &entry->fElements;
+    *resultGenID = entry->fResultGenID;
+    *initialState = entry->fInitialState;
+    *requiresAA = entry->fRequiresAA;
+    if (entry->fElements.isEmpty() && GrReducedClip::kAllOut_InitialState == entry->fInitialState) {
+        return false;
+    }
+    // The reduction is good for everything inside the larger bounds, but callers expect the
+    // bounds to be tight around their query.
+    return tighterBounds->intersect(entry->fTighterBounds, queryBounds);
+}
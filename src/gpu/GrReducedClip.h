@@ -41,4 +41,46 @@ public:
                                 bool* requiresAA);
 };
 
+/**
+ * Remembers the last few reductions of clip stacks, so that the many small draws made through
+ * one stack share a walk of it. Reductions are keyed by the stack's generation ID and the query
+ * bounds rounded out to a coarse grid; reducing for those larger bounds is still correct for any
+ * query inside them.
+ */
+class GrReducedClipCache {
+public:
+    GrReducedClipCache() : fNextEntry(0) {}
+
+    /**
+     * Same as GrReducedClip::ReduceClipStack(), except that the elements are owned by the cache
+     * and are only valid until the next call. Returns false if nothing inside queryBounds
+     * passes the clip.
+     */
+    bool reduceClipStack(const SkClipStack& stack,
+                         const SkIRect& queryBounds,
+                         const GrReducedClip::ElementList** result,
+                         int32_t* resultGenID,
+                         GrReducedClip::InitialState* initialState,
+                         SkIRect* tighterBounds,
+                         bool* requiresAA);
+
+private:
+    static const int kEntryCount = 4;
+
+    struct Entry {
+        Entry() : fStackGenID(SkClipStack::kInvalidGenID) {}
+
+        int32_t                     fStackGenID;
+        SkIRect                     fQueryBounds;
+        GrReducedClip::ElementList  fElements;
+        int32_t                     fResultGenID;
+        GrReducedClip::InitialState fInitialState;
+        SkIRect                     fTighterBounds;
+        bool                        fRequiresAA;
+    };
+
+    Entry fEntries[kEntryCount];
+    int   fNextEntry;
+};
+
 #endif
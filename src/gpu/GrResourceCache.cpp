@@ -11,10 +11,11 @@
 #include "GrCaps.h"
 #include "GrGpuResourceCacheAccess.h"
 #include "GrTracing.h"
-#include "SkChecksum.h"
 #include "SkGr.h"
 #include "SkMessageBus.h"
+#include "SkOpts.h"
 #include "SkTSort.h"
+#include "SkTraceMemoryDump.h"
 
 DECLARE_SKMESSAGEBUS_MESSAGE(GrUniqueKeyInvalidatedMessage);
 
@@ -43,7 +44,7 @@ GrUniqueKey::Domain GrUniqueKey::GenerateDomain() {
 }
 
 uint32_t GrResourceKeyHash(const uint32_t* data, size_t size) {
-    return SkChecksum::Murmur3(data, size);
+    return SkOpts::hash(data, size);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -99,6 +100,12 @@ void GrResourceCache::setLimits(int count, size_t bytes, int maxUnusedFlushes) {
 void GrResourceCache::resetFlushTimestamps() {
     delete[] fFlushTimestamps;
 
+    if (fMaxUnusedFlushes <= 0) {
+        fMaxUnusedFlushes = 0;
+        fFlushTimestamps = nullptr;
+        return;
+    }
+
     // We assume this number is a power of two when wrapping indices into the timestamp array.
     fMaxUnusedFlushes = SkNextPow2(fMaxUnusedFlushes);
 
@@ -391,6 +398,8 @@ void GrResourceCache::notifyCntReachedZero(GrGpuResource* resource, uint32_t fla
     SkASSERT(resource->isPurgeable());
     this->removeFromNonpurgeableArray(resource);
     fPurgeableQueue.insert(resource);
+    // Whatever atlas it was backing has let go of it.
+    resource->resourcePriv().setIsAtlas(false);
 
     if (SkBudgeted::kNo == resource->resourcePriv().isBudgeted()) {
         // Check whether this resource could still be used as a scratch resource.
@@ -475,6 +484,17 @@ void GrResourceCache::purgeAsNeeded() {
         this->processInvalidUniqueKeys(invalidKeyMsgs);
     }
 
+    SkTArray<SkMemoryPressureMessage> memoryPressureMsgs;
+    fMemoryPressureInbox.poll(&memoryPressureMsgs);
+    if (memoryPressureMsgs.count()) {
+        // Only the harshest request matters.
+        float keepFraction = 1;
+        for (int i = 0; i < memoryPressureMsgs.count(); ++i) {
+            keepFraction = SkTMin(keepFraction, memoryPressureMsgs[i].fKeepFraction);
+        }
+        this->purgeUnlockedToBytes((size_t)(fBytes * SkTMax(keepFraction, 0.0f)));
+    }
+
     if (fFlushTimestamps) {
         // Assuming kNumFlushesToDeleteUnusedResource is a power of 2.
         SkASSERT(SkIsPow2(fMaxUnusedFlushes));
@@ -522,6 +542,16 @@ void GrResourceCache::purgeAllUnlocked() {
     this->validate();
 }
 
+void GrResourceCache::purgeUnlockedToBytes(size_t bytes) {
+    while (fBytes > bytes && fPurgeableQueue.count()) {
+        GrGpuResource* resource = fPurgeableQueue.peek();
+        SkASSERT(resource->isPurgeable());
+        resource->cacheAccess().release();
+    }
+
+    this->validate();
+}
+
 void GrResourceCache::processInvalidUniqueKeys(
     const SkTArray<GrUniqueKeyInvalidatedMessage>& msgs) {
     for (int i = 0; i < msgs.count(); ++i) {
@@ -633,6 +663,24 @@ void GrResourceCache::notifyFlushOccurred() {
     }
 }
 
+void GrResourceCache::getCategoryUsage(
+        CategoryUsage usage[GrGpuResource::kMemoryCategoryCount]) const {
+    sk_bzero(usage, GrGpuResource::kMemoryCategoryCount * sizeof(CategoryUsage));
+    for (int i = 0; i < fNonpurgeableResources.count(); ++i) {
+        const GrGpuResource* resource = fNonpurgeableResources[i];
+        CategoryUsage& category = usage[resource->memoryCategory()];
+        ++category.fCount;
+        category.fBytes += resource->gpuMemorySize();
+    }
+    for (int i = 0; i < fPurgeableQueue.count(); ++i) {
+        const GrGpuResource* resource = fPurgeableQueue.at(i);
+        CategoryUsage& category = usage[resource->memoryCategory()];
+        ++category.fCount;
+        category.fBytes += resource->gpuMemorySize();
+        category.fPurgeableBytes += resource->gpuMemorySize();
+    }
+}
+
 void GrResourceCache::dumpMemoryStatistics(SkTraceMemoryDump* traceMemoryDump) const {
     for (int i = 0; i < fNonpurgeableResources.count(); ++i) {
         fNonpurgeableResources[i]->dumpMemoryStatistics(traceMemoryDump);
@@ -640,6 +688,31 @@ void GrResourceCache::dumpMemoryStatistics(SkTraceMemoryDump* traceMemoryDump) c
     for (int i = 0; i < fPurgeableQueue.count(); ++i) {
         fPurgeableQueue.at(i)->dumpMemoryStatistics(traceMemoryDump);
     }
+
+    // The totals go outside of "skia/gpu_resources" so that they aren't summed with the resources.
+    static const char* kCategoryDumpNames[] = {
+        "skia/gpu_resource_categories/textures",
+        "skia/gpu_resource_categories/atlases",
+        "skia/gpu_resource_categories/buffers",
+        "skia/gpu_resource_categories/render_targets",
+        "skia/gpu_resource_categories/scratch_render_targets",
+        "skia/gpu_resource_categories/other",
+    };
+    static_assert(SK_ARRAY_COUNT(kCategoryDumpNames) == GrGpuResource::kMemoryCategoryCount,
+                  "category_dump_names_mismatch");
+
+    CategoryUsage usage[GrGpuResource::kMemoryCategoryCount];
+    this->getCategoryUsage(usage);
+    for (int i = 0; i < GrGpuResource::kMemoryCategoryCount; ++i) {
+        if (!usage[i].fCount) {
+            continue;
+        }
+        const char* dumpName = kCategoryDumpNames[i];
+        traceMemoryDump->dumpNumericValue(dumpName, "size", "bytes", usage[i].fBytes);
+        traceMemoryDump->dumpNumericValue(dumpName, "purgeable_size", "bytes",
+                                          usage[i].fPurgeableBytes);
+        traceMemoryDump->dumpNumericValue(dumpName, "object_count", "objects", usage[i].fCount);
+    }
 }
 
 #ifdef SK_DEBUG
@@ -12,6 +12,7 @@
 #include "GrGpuResourceCacheAccess.h"
 #include "GrGpuResourcePriv.h"
 #include "GrResourceKey.h"
+#include "SkMemoryPressure.h"
 #include "SkMessageBus.h"
 #include "SkRefCnt.h"
 #include "SkTArray.h"
@@ -73,6 +74,12 @@ public:
      */
     void setLimits(int count, size_t bytes, int maxUnusedFlushes = kDefaultMaxUnusedFlushes);
 
+    /**
+     * Returns the number of flushes a resource can go unused before it is purged, rounded up to a
+     * power of two. Proactive purging is off if this is 0 or too large to track.
+     */
+    int getMaxUnusedFlushes() const { return fMaxUnusedFlushes; }
+
     /**
      * Returns the number of resources.
      */
@@ -156,13 +163,19 @@ public:
         return SkToBool(fUniqueHash.find(key));
     }
 
-    /** Purges resources to become under budget and processes resources with invalidated unique
-        keys. */
+    /** Purges resources to become under budget, processes resources with invalidated unique
+        keys, and trims the cache if SkGraphics::OnMemoryPressure() has been called. */
     void purgeAsNeeded();
 
     /** Purges all resources that don't have external owners. */
     void purgeAllUnlocked();
 
+    /**
+     * Purges resources that don't have external owners, least recently used first, until the
+     * cache holds no more than 'bytes', or nothing more can be purged. The budget is unchanged.
+     */
+    void purgeUnlockedToBytes(size_t bytes);
+
     /**
      * The callback function used by the cache when it is still over budget after a purge. The
      * passed in 'data' is the same 'data' handed to setOverbudgetCallback.
@@ -225,7 +238,17 @@ public:
     // This function is for unit testing and is only defined in test tools.
     void changeTimestamp(uint32_t newTimestamp);
 
-    // Enumerates all cached resources and dumps their details to traceMemoryDump.
+    struct CategoryUsage {
+        int    fCount;
+        size_t fBytes;
+        size_t fPurgeableBytes;
+    };
+
+    /** Totals the cached resources by GrGpuResource::MemoryCategory. */
+    void getCategoryUsage(CategoryUsage usage[GrGpuResource::kMemoryCategoryCount]) const;
+
+    // Enumerates all cached resources and dumps their details to traceMemoryDump, followed by
+    // their totals for each memory category.
     void dumpMemoryStatistics(SkTraceMemoryDump* traceMemoryDump) const;
 
 private:
@@ -291,6 +314,7 @@ private:
     }
 
     typedef SkMessageBus<GrUniqueKeyInvalidatedMessage>::Inbox InvalidUniqueKeyInbox;
+    typedef SkMessageBus<SkMemoryPressureMessage>::Inbox MemoryPressureInbox;
     typedef SkTDPQueue<GrGpuResource*, CompareTimestamp, AccessResourceIndex> PurgeableQueue;
     typedef SkTDArray<GrGpuResource*> ResourceArray;
 
@@ -335,6 +359,7 @@ private:
     int                                 fLastFlushTimestampIndex;
 
     InvalidUniqueKeyInbox               fInvalidUniqueKeyInbox;
+    MemoryPressureInbox                 fMemoryPressureInbox;
 
     // This resource is allowed to be in the nonpurgeable array for the sake of validate() because
     // we're in the midst of converting it to purgeable status.
@@ -137,7 +137,8 @@ GrBuffer* GrResourceProvider::createBuffer(size_t size, GrBufferType intendedTyp
 GrBatchAtlas* GrResourceProvider::createAtlas(GrPixelConfig config,
                                               int width, int height,
                                               int numPlotsX, int numPlotsY,
-                                              GrBatchAtlas::EvictionFunc func, void* data) {
+                                              GrBatchAtlas::EvictionFunc func, void* data,
+                                              int maxPages) {
     GrSurfaceDesc desc;
     desc.fFlags = kNone_GrSurfaceFlags;
     desc.fWidth = width;
@@ -152,7 +153,7 @@ GrBatchAtlas* GrResourceProvider::createAtlas(GrPixelConfig config,
     if (!texture) {
         return nullptr;
     }
-    GrBatchAtlas* atlas = new GrBatchAtlas(texture, numPlotsX, numPlotsY);
+    GrBatchAtlas* atlas = new GrBatchAtlas(texture, numPlotsX, numPlotsY, maxPages);
     atlas->registerEvictionCallback(func, data);
     return atlas;
 }
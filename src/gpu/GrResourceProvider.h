@@ -140,11 +140,13 @@ public:
      *                           evict data
      *   @param data             User supplied data which will be passed into func whenver an
      *                           eviction occurs
+     *   @param maxPages         The number of width x height textures the atlas may grow into
+     *                           while a flush is being prepared
      *
      *   @return                 An initialized GrBatchAtlas, or nullptr if creation fails
      */
     GrBatchAtlas* createAtlas(GrPixelConfig, int width, int height, int numPlotsX, int numPlotsY,
-                              GrBatchAtlas::EvictionFunc func, void* data);
+                              GrBatchAtlas::EvictionFunc func, void* data, int maxPages = 1);
 
     /**
      * If passed in render target already has a stencil buffer, return it. Otherwise attempt to
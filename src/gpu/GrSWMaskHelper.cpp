@@ -121,6 +121,13 @@ void GrSWMaskHelper::toTexture(GrTexture *texture) {
 
 }
 
+void GrSWMaskHelper::toTexture(GrTexture* texture, GrDrawBatch::WritePixelsFn& writePixels) {
+    SkASSERT(!texture->asRenderTarget());
+
+    writePixels(texture, 0, 0, fPixels.width(), fPixels.height(), texture->config(),
+                fPixels.addr(), fPixels.rowBytes());
+}
+
 /**
  * Convert mask generation results to a signed distance field
  */
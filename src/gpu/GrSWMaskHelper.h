@@ -16,6 +16,7 @@
 #include "SkRasterClip.h"
 #include "SkRegion.h"
 #include "SkTypes.h"
+#include "batches/GrDrawBatch.h"
 
 class GrClip;
 class GrPaint;
@@ -58,6 +59,9 @@ public:
     // Move the mask generation results from the internal bitmap to the gpu.
     void toTexture(GrTexture* texture);
 
+    // Same as above, but from a deferred upload while a flush is being prepared.
+    void toTexture(GrTexture* texture, GrDrawBatch::WritePixelsFn& writePixels);
+
     // Convert mask generation results to a signed distance field
     void toSDF(unsigned char* sdf);
 
@@ -7,16 +7,54 @@
 
 #include "GrSoftwarePathRenderer.h"
 #include "GrAuditTrail.h"
+#include "GrBatchFlushState.h"
 #include "GrClip.h"
+#include "GrResourceProvider.h"
 #include "GrSWMaskHelper.h"
-#include "GrTextureProvider.h"
 #include "batches/GrRectBatchFactory.h"
 
+////////////////////////////////////////////////////////////////////////////////
+// A mask whose draw has been recorded but whose pixels may still be being rasterized. Only the
+// task drawing it touches fHelper until prepareMaskUploads() has waited for that task.
+struct GrSoftwarePathRenderer::DeferredMask : public SkNVRefCnt<DeferredMask> {
+    DeferredMask(const GrShape& shape, bool antiAlias, GrTexture* texture)
+        : fShape(shape)
+        , fAntiAlias(antiAlias)
+        , fHelper(nullptr)
+        , fTexture(texture) {}
+
+    GrShape           fShape;
+    bool              fAntiAlias;
+    GrSWMaskHelper    fHelper;
+    sk_sp<GrTexture>  fTexture;
+};
+
+GrSoftwarePathRenderer::GrSoftwarePathRenderer(GrResourceProvider* resourceProvider)
+    : fResourceProvider(resourceProvider) {}
+
+GrSoftwarePathRenderer::~GrSoftwarePathRenderer() {
+    // The tasks point at the masks, so they must finish first.
+    fMaskTasks.wait();
+}
+
+void GrSoftwarePathRenderer::prepareMaskUploads(GrBatchFlushState* flushState) {
+    if (fDeferredMasks.empty()) {
+        return;
+    }
+    fMaskTasks.wait();
+    for (const sk_sp<DeferredMask>& mask : fDeferredMasks) {
+        flushState->addASAPUpload([mask] (GrDrawBatch::WritePixelsFn& writePixels) {
+            mask->fHelper.toTexture(mask->fTexture.get(), writePixels);
+        });
+    }
+    fDeferredMasks.reset();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool GrSoftwarePathRenderer::onCanDrawPath(const CanDrawPathArgs& args) const {
     // Pass on any style that applies. The caller will apply the style if a suitable renderer is
     // not found and try again with the new GrShape.
-    return !args.fShape->style().applies() && SkToBool(fTexProvider);
+    return !args.fShape->style().applies() && SkToBool(fResourceProvider);
 }
 
 namespace {
@@ -122,7 +160,7 @@ void GrSoftwarePathRenderer::DrawAroundInvPath(GrDrawContext* drawContext,
 bool GrSoftwarePathRenderer::onDrawPath(const DrawPathArgs& args) {
     GR_AUDIT_TRAIL_AUTO_FRAME(args.fDrawContext->auditTrail(),
                               "GrSoftwarePathRenderer::onDrawPath");
-    if (!fTexProvider) {
+    if (!fResourceProvider) {
         return false;
     }
 
@@ -145,12 +183,33 @@ bool GrSoftwarePathRenderer::onDrawPath(const DrawPathArgs& args) {
         return true;
     }
 
-    SkAutoTUnref<GrTexture> texture(
-            GrSWMaskHelper::DrawShapeMaskToTexture(fTexProvider, *args.fShape, devShapeBounds,
-                                                   args.fAntiAlias, args.fViewMatrix));
+    // The mask is uploaded at the start of the flush, so its texture must not be one that draws
+    // before it in the same flush still read.
+    GrSurfaceDesc desc;
+    desc.fWidth = devShapeBounds.width();
+    desc.fHeight = devShapeBounds.height();
+    desc.fConfig = kAlpha_8_GrPixelConfig;
+    GrTexture* texture = fResourceProvider->createApproxTexture(
+            desc, GrResourceProvider::kNoPendingIO_Flag);
     if (nullptr == texture) {
         return false;
     }
+    sk_sp<DeferredMask> mask(new DeferredMask(*args.fShape, args.fAntiAlias, texture));
+    if (!mask->fHelper.init(devShapeBounds, args.fViewMatrix)) {
+        return false;
+    }
+    // The task's copy of the path shares its SkPathRef with ours. Compute the bounds it caches
+    // lazily now, so that the task only ever reads it.
+    SkPath path;
+    mask->fShape.asPath(&path);
+    path.updateBoundsCache();
+
+    DeferredMask* rawMask = mask.get();
+    fMaskTasks.add([rawMask] {
+        rawMask->fHelper.drawShape(rawMask->fShape, SkRegion::kReplace_Op, rawMask->fAntiAlias,
+                                   0xFF);
+    });
+    fDeferredMasks.push_back(std::move(mask));
 
     GrSWMaskHelper::DrawToTargetWithShapeMask(texture, args.fDrawContext, *args.fPaint,
                                               args.fUserStencilSettings,
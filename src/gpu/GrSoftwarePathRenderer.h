@@ -9,16 +9,25 @@
 #define GrSoftwarePathRenderer_DEFINED
 
 #include "GrPathRenderer.h"
+#include "SkTaskGroup.h"
 
-class GrTextureProvider;
+class GrBatchFlushState;
+class GrResourceProvider;
 
 /**
  * This class uses the software side to render a path to an SkBitmap and
- * then uploads the result to the gpu
+ * then uploads the result to the gpu. The masks are rasterized on SkTaskGroup threads while
+ * recording continues, and are uploaded together when the draws that use them are flushed.
  */
 class GrSoftwarePathRenderer : public GrPathRenderer {
 public:
-    GrSoftwarePathRenderer(GrTextureProvider* texProvider) : fTexProvider(texProvider) { }
+    GrSoftwarePathRenderer(GrResourceProvider* resourceProvider);
+    ~GrSoftwarePathRenderer() override;
+
+    // Waits for the masks drawn since the last flush and schedules their uploads on the flush.
+    // Must be called before the flush prepares its batches.
+    void prepareMaskUploads(GrBatchFlushState*);
+
 private:
     static void DrawNonAARect(GrDrawContext* drawContext,
                               const GrPaint& paint,
@@ -44,7 +53,11 @@ private:
     bool onDrawPath(const DrawPathArgs&) override;
 
 private:
-    GrTextureProvider*     fTexProvider;
+    struct DeferredMask;
+
+    GrResourceProvider*             fResourceProvider;
+    SkTArray<sk_sp<DeferredMask>>   fDeferredMasks;
+    SkTaskGroup                     fMaskTasks;
 
     typedef GrPathRenderer INHERITED;
 };
@@ -37,6 +37,12 @@ public:
         fLastClipSpaceOffset = clipSpaceToStencilOffset;
     }
 
+    // called when the buffer's contents are discarded, so the next clip must be drawn anew.
+    void invalidateLastClip() {
+        fLastClipStackGenID = SkClipStack::kInvalidGenID;
+        fLastClipStackRect.setEmpty();
+    }
+
     // called to determine if we have to render the clip into SB.
     bool mustRenderClip(int32_t clipStackGenID,
                         const SkIRect& clipSpaceRect,
@@ -228,3 +228,25 @@ bool GrTextureToYUVPlanes(GrTexture* texture, const SkISize sizes[3], void* cons
     }
     return false;
 }
+
+bool GrTextureToYUVDrawContexts(GrTexture* texture, const SkISize sizes[3],
+                                SkYUVColorSpace colorSpace, sk_sp<GrDrawContext> planes[3]) {
+    GrContext* context = texture->getContext();
+    if (!context || !context->caps()->isConfigRenderable(kAlpha_8_GrPixelConfig, false)) {
+        return false;
+    }
+    static const MakeFPProc kProcs[3] = {
+        GrYUVEffect::MakeRGBToY, GrYUVEffect::MakeRGBToU, GrYUVEffect::MakeRGBToV
+    };
+    for (int i = 0; i < 3; ++i) {
+        planes[i] = context->newDrawContext(SkBackingFit::kApprox,
+                                            sizes[i].fWidth, sizes[i].fHeight,
+                                            kAlpha_8_GrPixelConfig, 0, kTopLeft_GrSurfaceOrigin);
+        if (!planes[i] ||
+            !convert_texture(texture, planes[i].get(), sizes[i].fWidth, sizes[i].fHeight,
+                             colorSpace, kProcs[i])) {
+            return false;
+        }
+    }
+    return true;
+}
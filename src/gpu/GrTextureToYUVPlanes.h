@@ -9,11 +9,21 @@
 #define GrTextureToYUVPlanes_DEFINED
 
 #include "SkImageInfo.h"
+#include "SkRefCnt.h"
 #include "SkSize.h"
 
+class GrDrawContext;
 class GrTexture;
 
 bool GrTextureToYUVPlanes(GrTexture* texture, const SkISize[3], void* const planes[3],
                           const size_t rowBytes[3], SkYUVColorSpace);
 
+/**
+ * Draws the Y, U, and V planes of a texture into three new kAlpha_8_GrPixelConfig draw contexts
+ * with top-left origins, without reading them back. Fails if kAlpha_8_GrPixelConfig isn't
+ * renderable.
+ */
+bool GrTextureToYUVDrawContexts(GrTexture* texture, const SkISize[3], SkYUVColorSpace,
+                                sk_sp<GrDrawContext> planes[3]);
+
 #endif
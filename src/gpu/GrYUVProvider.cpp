@@ -123,7 +123,8 @@ sk_sp<GrTexture> GrYUVProvider::refAsTexture(GrContext* ctx,
     GrPaint paint;
     sk_sp<GrFragmentProcessor> yuvToRgbProcessor(
         GrYUVEffect::MakeYUVToRGB(yuvTextures[0], yuvTextures[1], yuvTextures[2],
-                                  yuvInfo.fSizeInfo.fSizes, yuvInfo.fColorSpace, false));
+                                  yuvInfo.fSizeInfo.fSizes, yuvInfo.fColorSpace,
+                                  GrYUVEffect::PlaneLayout::kYUV));
     paint.addColorFragmentProcessor(std::move(yuvToRgbProcessor));
 
     // If we're decoding an sRGB image, the result of our linear math on the YUV planes is already
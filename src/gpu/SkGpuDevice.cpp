@@ -672,9 +672,6 @@ void SkGpuDevice::drawStrokedLine(const SkPoint points[2],
     GR_CREATE_TRACE_MARKER_CONTEXT("SkGpuDevice", "drawStrokedLine", fContext);
     CHECK_SHOULD_DRAW(draw);
 
-    // Adding support for round capping would require a GrDrawContext::fillRRectWithLocalMatrix
-    // entry point
-    SkASSERT(SkPaint::kRound_Cap != origPaint.getStrokeCap());
     SkASSERT(SkPaint::kStroke_Style == origPaint.getStyle());
     SkASSERT(!origPaint.getPathEffect());
     SkASSERT(!origPaint.getMaskFilter());
@@ -716,7 +713,29 @@ void SkGpuDevice::drawStrokedLine(const SkPoint points[2],
         return;
     }
 
-    fDrawContext->fillRectWithLocalMatrix(fClip, grPaint, m, rect, local);
+    if (SkPaint::kRound_Cap != origPaint.getStrokeCap()) {
+        fDrawContext->fillRectWithLocalMatrix(fClip, grPaint, m, rect, local);
+        return;
+    }
+
+    SkRRect rrect = SkRRect::MakeRectXY(rect, halfWidth, halfWidth);
+    if (fDrawContext->fillRRectWithLocalMatrix(fClip, grPaint, m, rrect, local)) {
+        return;
+    }
+
+    // Only instanced rendering has an rrect batch that takes a localMatrix, so stroke the line as
+    // a path instead.
+    GrPaint strokePaint;
+    if (!SkPaintToGrPaint(this->context(), origPaint, *draw.fMatrix,
+                          this->surfaceProps().isGammaCorrect(), &strokePaint)) {
+        return;
+    }
+
+    SkPath path;
+    path.setIsVolatile(true);
+    path.moveTo(points[0]);
+    path.lineTo(points[1]);
+    fDrawContext->drawPath(fClip, strokePaint, *draw.fMatrix, path, GrStyle(origPaint));
 }
 
 void SkGpuDevice::drawPath(const SkDraw& draw, const SkPath& origSrcPath,
@@ -726,13 +745,10 @@ void SkGpuDevice::drawPath(const SkDraw& draw, const SkPath& origSrcPath,
     if (!origSrcPath.isInverseFillType() && !paint.getPathEffect() && !prePathMatrix) {
         SkPoint points[2];
         if (SkPaint::kStroke_Style == paint.getStyle() && paint.getStrokeWidth() > 0 &&
-            !paint.getMaskFilter() && SkPaint::kRound_Cap != paint.getStrokeCap() &&
-            draw.fMatrix->preservesRightAngles() && origSrcPath.isLine(points)) {
+            !paint.getMaskFilter() && draw.fMatrix->preservesRightAngles() && origSrcPath.isLine(points)) {
             // Path-based stroking looks better for thin rects
             SkScalar strokeWidth = draw.fMatrix->getMaxScale() * paint.getStrokeWidth();
             if (strokeWidth >= 1.0f) {
-                // Round capping support is currently disabled b.c. it would require
-                // a RRect batch that takes a localMatrix.
                 this->drawStrokedLine(points, draw, paint);
                 return;
             }
@@ -67,17 +67,32 @@ void GrMakeKeyFromImageID(GrUniqueKey* key, uint32_t imageID, const SkIRect& ima
     builder[4] = imageBounds.fBottom;
 }
 
+#ifndef SK_IGNORE_ETC1_SUPPORT
+static GrPixelConfig ktx_pixel_config(const SkKTXFile& ktx) {
+    if (ktx.isCompressedFormat(SkTextureCompressor::kETC1_Format)) {
+        return kETC1_GrPixelConfig;
+    }
+    // ASTC blocks hold RGBA, which we can only sample directly if it was premultiplied.
+    // LATC and R11 EAC are sampled as alpha masks, so they aren't uploaded for gray images.
+    if (ktx.isCompressedFormat(SkTextureCompressor::kASTC_12x12_Format) &&
+        ktx.getValueForKey(SkString("KTXPremultipliedAlpha")).equals("True")) {
+        return kASTC_12x12_GrPixelConfig;
+    }
+    return kUnknown_GrPixelConfig;
+}
+#endif
+
 GrPixelConfig GrIsCompressedTextureDataSupported(GrContext* ctx, SkData* data,
                                                  int expectedW, int expectedH,
                                                  const void** outStartOfDataToUpload) {
     *outStartOfDataToUpload = nullptr;
 #ifndef SK_IGNORE_ETC1_SUPPORT
-    if (!ctx->caps()->isConfigTexturable(kETC1_GrPixelConfig)) {
-        return kUnknown_GrPixelConfig;
-    }
-
     const uint8_t* bytes = data->bytes();
     if (data->size() > ETC_PKM_HEADER_SIZE && etc1_pkm_is_valid(bytes)) {
+        if (!ctx->caps()->isConfigTexturable(kETC1_GrPixelConfig)) {
+            return kUnknown_GrPixelConfig;
+        }
+
         // Does the data match the dimensions of the bitmap? If not,
         // then we don't know how to scale the image to match it...
         if (etc1_pkm_get_width(bytes) != (unsigned)expectedW ||
@@ -91,8 +106,9 @@ GrPixelConfig GrIsCompressedTextureDataSupported(GrContext* ctx, SkData* data,
     } else if (SkKTXFile::is_ktx(bytes, data->size())) {
         SkKTXFile ktx(data);
 
-        // Is it actually an ETC1 texture?
-        if (!ktx.isCompressedFormat(SkTextureCompressor::kETC1_Format)) {
+        // Is it in a format we can sample?
+        const GrPixelConfig config = ktx_pixel_config(ktx);
+        if (kUnknown_GrPixelConfig == config || !ctx->caps()->isConfigTexturable(config)) {
             return kUnknown_GrPixelConfig;
         }
 
@@ -102,8 +118,15 @@ GrPixelConfig GrIsCompressedTextureDataSupported(GrContext* ctx, SkData* data,
             return kUnknown_GrPixelConfig;
         }
 
+        // Is it whole blocks, and is all of it there?
+        const int blockSize = kASTC_12x12_GrPixelConfig == config ? 12 : 4;
+        if ((expectedW % blockSize) || (expectedH % blockSize) ||
+            ktx.pixelDataSize() < GrCompressedFormatDataSize(config, expectedW, expectedH)) {
+            return kUnknown_GrPixelConfig;
+        }
+
         *outStartOfDataToUpload = ktx.pixelData();
-        return kETC1_GrPixelConfig;
+        return config;
     }
 #endif
     return kUnknown_GrPixelConfig;
@@ -235,7 +258,41 @@ GrTexture* GrUploadBitmapToTexture(GrContext* ctx, const SkBitmap& bitmap) {
     return GrUploadPixmapToTexture(ctx, pixmap, SkBudgeted::kYes);
 }
 
+// With GrContextOptions::fCompressUploadedImages, opaque images are uploaded as ETC1.
+static GrTexture* compress_and_upload(GrContext* ctx, const SkPixmap& pixmap,
+                                      SkBudgeted budgeted) {
+#ifndef SK_IGNORE_ETC1_SUPPORT
+    const GrCaps* caps = ctx->caps();
+    if (!caps->compressUploadedImages() || !pixmap.isOpaque() ||
+        !caps->isConfigTexturable(kETC1_GrPixelConfig)) {
+        return nullptr;
+    }
+    if (kN32_SkColorType != pixmap.colorType() && kRGB_565_SkColorType != pixmap.colorType()) {
+        return nullptr;
+    }
+    // ETC1 has no sRGB variant.
+    if (caps->srgbSupport() && pixmap.info().colorSpace() &&
+        pixmap.info().colorSpace()->gammaCloseToSRGB()) {
+        return nullptr;
+    }
+    sk_sp<SkData> data(SkTextureCompressor::CompressBitmapToFormat(
+            pixmap, SkTextureCompressor::kETC1_Format));
+    if (!data) {
+        return nullptr;
+    }
+    GrSurfaceDesc desc = GrImageInfoToSurfaceDesc(pixmap.info(), *caps);
+    desc.fConfig = kETC1_GrPixelConfig;
+    return ctx->textureProvider()->createTexture(desc, budgeted, data->data(), 0);
+#else
+    return nullptr;
+#endif
+}
+
 GrTexture* GrUploadPixmapToTexture(GrContext* ctx, const SkPixmap& pixmap, SkBudgeted budgeted) {
+    if (GrTexture* texture = compress_and_upload(ctx, pixmap, budgeted)) {
+        return texture;
+    }
+
     const SkPixmap* pmap = &pixmap;
     SkPixmap tmpPixmap;
     SkBitmap tmpBitmap;
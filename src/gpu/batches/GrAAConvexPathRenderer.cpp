@@ -796,19 +796,26 @@ private:
                  vertexStride == sizeof(GrDefaultGeoProcFactory::PositionColorAttr) :
                  vertexStride == sizeof(GrDefaultGeoProcFactory::PositionColorCoverageAttr));
 
-        GrAAConvexTessellator tess;
-
         int instanceCount = fGeoData.count();
 
-        for (int i = 0; i < instanceCount; i++) {
-            tess.rewind();
-
+        // Tessellate every path first, spread across threads when there are many of them. Only
+        // the cheap copies into vertex space are left for the serial loop below.
+        SkTArray<GrAAConvexTessellator> tessellators(instanceCount);
+        tessellators.push_back_n(instanceCount);
+        SkAutoTMalloc<bool> tessellated(instanceCount);
+        ForEachGeometry(instanceCount, [&](int i) {
             const Geometry& args = fGeoData[i];
+            tessellated[i] = tessellators[i].tessellate(args.fViewMatrix, args.fPath);
+        });
 
-            if (!tess.tessellate(args.fViewMatrix, args.fPath)) {
+        for (int i = 0; i < instanceCount; i++) {
+            if (!tessellated[i]) {
                 continue;
             }
 
+            const GrAAConvexTessellator& tess = tessellators[i];
+            const Geometry& args = fGeoData[i];
+
             const GrBuffer* vertexBuffer;
             int firstVertex;
 
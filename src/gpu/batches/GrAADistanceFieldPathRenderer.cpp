@@ -64,6 +64,9 @@ void GrAADistanceFieldPathRenderer::HandleEviction(GrBatchAtlas::AtlasID id, voi
 GrAADistanceFieldPathRenderer::GrAADistanceFieldPathRenderer() : fAtlas(nullptr) {}
 
 GrAADistanceFieldPathRenderer::~GrAADistanceFieldPathRenderer() {
+    // The tasks write into the pending fields, so they must finish first.
+    fFieldTasks.wait();
+
     ShapeDataList::Iter iter;
     iter.init(fShapeList, ShapeDataList::Iter::kHead_IterStart);
     ShapeData* shapeData;
@@ -120,6 +123,134 @@ bool GrAADistanceFieldPathRenderer::onCanDrawPath(const CanDrawPathArgs& args) c
 // padding around path bounds to allow for antialiased pixels
 static const SkScalar kAntiAliasPad = 1.0f;
 
+// get mip level
+static uint32_t choose_dimension(const GrShape& shape, const SkMatrix& viewMatrix) {
+    SkScalar maxScale = viewMatrix.getMaxScale();
+    const SkRect& bounds = shape.bounds();
+    SkScalar maxDim = SkMaxScalar(bounds.width(), bounds.height());
+    SkScalar size = maxScale * maxDim;
+    if (size <= kSmallMIP) {
+        return kSmallMIP;
+    } else if (size <= kMediumMIP) {
+        return kMediumMIP;
+    }
+    return kLargeMIP;
+}
+
+// A shape's distance field, generated either by the batch that adds it to the atlas or ahead of
+// time by one of the renderer's tasks.
+struct GrAADistanceFieldPathRenderer::DistanceField : public SkNVRefCnt<DistanceField> {
+    DistanceField(const GrShape& shape, bool antiAlias, uint32_t dimension)
+        : fShape(shape)
+        , fAntiAlias(antiAlias)
+        , fDimension(dimension)
+        , fScale(0)
+        , fWidth(0)
+        , fHeight(0) {}
+
+    // Rasterizes the shape and fills out everything below. fData stays null on failure.
+    void generate();
+
+    GrShape                      fShape;
+    bool                         fAntiAlias;
+    uint32_t                     fDimension;
+
+    SkScalar                     fScale;
+    // The shape's bounds at fScale, inset and offset to match the distance field
+    SkRect                       fBounds;
+    int                          fWidth;
+    int                          fHeight;
+    SkAutoTMalloc<unsigned char> fData;
+};
+
+void GrAADistanceFieldPathRenderer::DistanceField::generate() {
+    const SkRect& bounds = fShape.bounds();
+    SkScalar maxDim = SkMaxScalar(bounds.width(), bounds.height());
+    fScale = fDimension/maxDim;
+
+    // generate bounding rect for bitmap draw
+    SkRect scaledBounds = bounds;
+    // scale to mip level size
+    scaledBounds.fLeft *= fScale;
+    scaledBounds.fTop *= fScale;
+    scaledBounds.fRight *= fScale;
+    scaledBounds.fBottom *= fScale;
+    // move the origin to an integer boundary (gives better results)
+    SkScalar dx = SkScalarFraction(scaledBounds.fLeft);
+    SkScalar dy = SkScalarFraction(scaledBounds.fTop);
+    scaledBounds.offset(-dx, -dy);
+    // get integer boundary
+    SkIRect devPathBounds;
+    scaledBounds.roundOut(&devPathBounds);
+    // pad to allow room for antialiasing
+    const int intPad = SkScalarCeilToInt(kAntiAliasPad);
+    // pre-move origin (after outset, will be 0,0)
+    int width = devPathBounds.width();
+    int height = devPathBounds.height();
+    devPathBounds.fLeft = intPad;
+    devPathBounds.fTop = intPad;
+    devPathBounds.fRight = intPad + width;
+    devPathBounds.fBottom = intPad + height;
+    devPathBounds.outset(intPad, intPad);
+
+    // draw path to bitmap
+    SkMatrix drawMatrix;
+    drawMatrix.setTranslate(-bounds.left(), -bounds.top());
+    drawMatrix.postScale(fScale, fScale);
+    drawMatrix.postTranslate(kAntiAliasPad, kAntiAliasPad);
+
+    // setup bitmap backing
+    SkASSERT(devPathBounds.fLeft == 0);
+    SkASSERT(devPathBounds.fTop == 0);
+    SkAutoPixmapStorage dst;
+    if (!dst.tryAlloc(SkImageInfo::MakeA8(devPathBounds.width(),
+                                          devPathBounds.height()))) {
+        return;
+    }
+    sk_bzero(dst.writable_addr(), dst.getSafeSize());
+
+    // rasterize path
+    SkPaint paint;
+    paint.setStyle(SkPaint::kFill_Style);
+    paint.setAntiAlias(fAntiAlias);
+
+    SkDraw draw;
+    sk_bzero(&draw, sizeof(draw));
+
+    SkRasterClip rasterClip;
+    rasterClip.setRect(devPathBounds);
+    draw.fRC = &rasterClip;
+    draw.fMatrix = &drawMatrix;
+    draw.fDst = dst;
+
+    SkPath path;
+    fShape.asPath(&path);
+    draw.drawPathCoverage(path, paint);
+
+    // generate signed distance field
+    devPathBounds.outset(SK_DistanceFieldPad, SK_DistanceFieldPad);
+    fWidth = devPathBounds.width();
+    fHeight = devPathBounds.height();
+    // TODO We should really generate this directly into the plot somehow
+    fData.reset(fWidth * fHeight);
+
+    // Generate signed distance field
+    SkGenerateDistanceFieldFromA8Image(fData.get(),
+                                       (const unsigned char*)dst.addr(),
+                                       dst.width(), dst.height(), dst.rowBytes());
+
+    // change the scaled rect to match the size of the inset distance field
+    scaledBounds.fRight = scaledBounds.fLeft +
+        SkIntToScalar(fWidth - 2*SK_DistanceFieldInset);
+    scaledBounds.fBottom = scaledBounds.fTop +
+        SkIntToScalar(fHeight - 2*SK_DistanceFieldInset);
+    // shift the origin to the correct place relative to the distance field
+    // need to also restore the fractional translation
+    scaledBounds.offset(-SkIntToScalar(SK_DistanceFieldInset) - kAntiAliasPad + dx,
+                        -SkIntToScalar(SK_DistanceFieldInset) - kAntiAliasPad + dy);
+    fBounds = scaledBounds;
+}
+
 class AADistanceFieldPathBatch : public GrVertexBatch {
 public:
     DEFINE_BATCH_CLASS_ID
@@ -127,6 +258,7 @@ public:
     typedef GrAADistanceFieldPathRenderer::ShapeData ShapeData;
     typedef SkTDynamicHash<ShapeData, ShapeData::Key> ShapeCache;
     typedef GrAADistanceFieldPathRenderer::ShapeDataList ShapeDataList;
+    typedef GrAADistanceFieldPathRenderer::DistanceField DistanceField;
 
     AADistanceFieldPathBatch(GrColor color,
                              const GrShape& shape,
@@ -134,6 +266,7 @@ public:
                              const SkMatrix& viewMatrix,
                              GrBatchAtlas* atlas,
                              ShapeCache* shapeCache, ShapeDataList* shapeList,
+                             SkTaskGroup* fieldTasks,
                              bool gammaCorrect)
             : INHERITED(ClassID()) {
         SkASSERT(shape.hasUnstyledKey());
@@ -143,6 +276,7 @@ public:
         fAtlas = atlas;
         fShapeCache = shapeCache;
         fShapeList = shapeList;
+        fFieldTasks = fieldTasks;
         fGammaCorrect = gammaCorrect;
 
         // Compute bounds
@@ -175,7 +309,12 @@ private:
     struct FlushInfo {
         SkAutoTUnref<const GrBuffer> fVertexBuffer;
         SkAutoTUnref<const GrBuffer> fIndexBuffer;
+        // The processor for the atlas page the pending instances are on, and those made so far for
+        // each page.
         sk_sp<GrGeometryProcessor>   fGeometryProcessor;
+        sk_sp<GrGeometryProcessor>   fPageGeometryProcessors[GrBatchAtlas::kMaxPages];
+        uint32_t fFlags;
+        int fPage;
         int fVertexOffset;
         int fInstancesToFlush;
     };
@@ -195,18 +334,19 @@ private:
         flags |= ctm.isSimilarity() ? kSimilarity_DistanceFieldEffectFlag : 0;
         flags |= fGammaCorrect ? kGammaCorrect_DistanceFieldEffectFlag : 0;
 
-        GrTextureParams params(SkShader::kRepeat_TileMode, GrTextureParams::kBilerp_FilterMode);
-
         FlushInfo flushInfo;
 
         // Setup GrGeometryProcessor
         GrBatchAtlas* atlas = fAtlas;
-        flushInfo.fGeometryProcessor = GrDistanceFieldPathGeoProc::Make(this->color(),
-                                                                        this->viewMatrix(),
-                                                                        atlas->getTexture(),
-                                                                        params,
-                                                                        flags,
-                                                                        this->usesLocalCoords());
+        flushInfo.fFlags = flags;
+        flushInfo.fGeometryProcessor = this->makeGeometryProcessor(atlas->getTexture(0), flags);
+        flushInfo.fPageGeometryProcessors[0] = flushInfo.fGeometryProcessor;
+        flushInfo.fPage = 0;
+
+        // Distance fields generated ahead of time must be finished before we read them
+        if (fFieldTasks) {
+            fFieldTasks->wait();
+        }
 
         // allocate vertices
         size_t vertexStride = flushInfo.fGeometryProcessor->getVertexStride();
@@ -230,46 +370,38 @@ private:
         for (int i = 0; i < instanceCount; i++) {
             const Geometry& args = fGeoData[i];
 
-            // get mip level
-            SkScalar maxScale = this->viewMatrix().getMaxScale();
-            const SkRect& bounds = args.fShape.bounds();
-            SkScalar maxDim = SkMaxScalar(bounds.width(), bounds.height());
-            SkScalar size = maxScale * maxDim;
-            uint32_t desiredDimension;
-            if (size <= kSmallMIP) {
-                desiredDimension = kSmallMIP;
-            } else if (size <= kMediumMIP) {
-                desiredDimension = kMediumMIP;
-            } else {
-                desiredDimension = kLargeMIP;
-            }
+            uint32_t desiredDimension = choose_dimension(args.fShape, this->viewMatrix());
 
             // check to see if path is cached
             ShapeData::Key key(args.fShape, desiredDimension);
             ShapeData* shapeData = fShapeCache->find(key);
             if (nullptr == shapeData || !atlas->hasID(shapeData->fID)) {
-                // Remove the stale cache entry
+                sk_sp<DistanceField> field;
+                // Remove the stale or pending cache entry, keeping any field generated for it
                 if (shapeData) {
+                    field = std::move(shapeData->fPendingField);
                     fShapeCache->remove(shapeData->fKey);
                     fShapeList->remove(shapeData);
                     delete shapeData;
                 }
-                SkScalar scale = desiredDimension/maxDim;
+                if (!field) {
+                    field.reset(new DistanceField(args.fShape, args.fAntiAlias, desiredDimension));
+                    field->generate();
+                }
                 shapeData = new ShapeData;
                 if (!this->addPathToAtlas(target,
                                           &flushInfo,
                                           atlas,
                                           shapeData,
-                                          args.fShape,
-                                          args.fAntiAlias,
-                                          desiredDimension,
-                                          scale)) {
+                                          *field)) {
                     delete shapeData;
                     SkDebugf("Can't rasterize path\n");
                     continue;
                 }
             }
 
+            // Before we take the token, since switching pages may flush
+            this->setPage(target, &flushInfo, GrBatchAtlas::GetPageIndexFromID(shapeData->fID));
             atlas->setLastUseToken(shapeData->fID, target->nextDrawToken());
 
             this->writePathVertices(target,
@@ -290,107 +422,28 @@ private:
                         FlushInfo* flushInfo,
                         GrBatchAtlas* atlas,
                         ShapeData* shapeData,
-                        const GrShape& shape,
-                        bool antiAlias,
-                        uint32_t dimension,
-                        SkScalar scale) const {
-        const SkRect& bounds = shape.bounds();
-
-        // generate bounding rect for bitmap draw
-        SkRect scaledBounds = bounds;
-        // scale to mip level size
-        scaledBounds.fLeft *= scale;
-        scaledBounds.fTop *= scale;
-        scaledBounds.fRight *= scale;
-        scaledBounds.fBottom *= scale;
-        // move the origin to an integer boundary (gives better results)
-        SkScalar dx = SkScalarFraction(scaledBounds.fLeft);
-        SkScalar dy = SkScalarFraction(scaledBounds.fTop);
-        scaledBounds.offset(-dx, -dy);
-        // get integer boundary
-        SkIRect devPathBounds;
-        scaledBounds.roundOut(&devPathBounds);
-        // pad to allow room for antialiasing
-        const int intPad = SkScalarCeilToInt(kAntiAliasPad);
-        // pre-move origin (after outset, will be 0,0)
-        int width = devPathBounds.width();
-        int height = devPathBounds.height();
-        devPathBounds.fLeft = intPad;
-        devPathBounds.fTop = intPad;
-        devPathBounds.fRight = intPad + width;
-        devPathBounds.fBottom = intPad + height;
-        devPathBounds.outset(intPad, intPad);
-
-        // draw path to bitmap
-        SkMatrix drawMatrix;
-        drawMatrix.setTranslate(-bounds.left(), -bounds.top());
-        drawMatrix.postScale(scale, scale);
-        drawMatrix.postTranslate(kAntiAliasPad, kAntiAliasPad);
-
-        // setup bitmap backing
-        SkASSERT(devPathBounds.fLeft == 0);
-        SkASSERT(devPathBounds.fTop == 0);
-        SkAutoPixmapStorage dst;
-        if (!dst.tryAlloc(SkImageInfo::MakeA8(devPathBounds.width(),
-                                              devPathBounds.height()))) {
+                        const DistanceField& field) const {
+        if (nullptr == field.fData.get()) {
             return false;
         }
-        sk_bzero(dst.writable_addr(), dst.getSafeSize());
-
-        // rasterize path
-        SkPaint paint;
-        paint.setStyle(SkPaint::kFill_Style);
-        paint.setAntiAlias(antiAlias);
-
-        SkDraw draw;
-        sk_bzero(&draw, sizeof(draw));
-
-        SkRasterClip rasterClip;
-        rasterClip.setRect(devPathBounds);
-        draw.fRC = &rasterClip;
-        draw.fMatrix = &drawMatrix;
-        draw.fDst = dst;
-
-        SkPath path;
-        shape.asPath(&path);
-        draw.drawPathCoverage(path, paint);
-
-        // generate signed distance field
-        devPathBounds.outset(SK_DistanceFieldPad, SK_DistanceFieldPad);
-        width = devPathBounds.width();
-        height = devPathBounds.height();
-        // TODO We should really generate this directly into the plot somehow
-        SkAutoSMalloc<1024> dfStorage(width * height * sizeof(unsigned char));
-
-        // Generate signed distance field
-        SkGenerateDistanceFieldFromA8Image((unsigned char*)dfStorage.get(),
-                                           (const unsigned char*)dst.addr(),
-                                           dst.width(), dst.height(), dst.rowBytes());
 
         // add to atlas
         SkIPoint16 atlasLocation;
         GrBatchAtlas::AtlasID id;
-       if (!atlas->addToAtlas(&id, target, width, height, dfStorage.get(), &atlasLocation)) {
+        if (!atlas->addToAtlas(&id, target, field.fWidth, field.fHeight, field.fData.get(),
+                               &atlasLocation)) {
             this->flush(target, flushInfo);
-            if (!atlas->addToAtlas(&id, target, width, height, dfStorage.get(), &atlasLocation)) {
+            if (!atlas->addToAtlas(&id, target, field.fWidth, field.fHeight, field.fData.get(),
+                                   &atlasLocation)) {
                 return false;
             }
         }
 
         // add to cache
-        shapeData->fKey.set(shape, dimension);
-        shapeData->fScale = scale;
+        shapeData->fKey.set(field.fShape, field.fDimension);
+        shapeData->fScale = field.fScale;
         shapeData->fID = id;
-        // change the scaled rect to match the size of the inset distance field
-        scaledBounds.fRight = scaledBounds.fLeft +
-            SkIntToScalar(devPathBounds.width() - 2*SK_DistanceFieldInset);
-        scaledBounds.fBottom = scaledBounds.fTop +
-            SkIntToScalar(devPathBounds.height() - 2*SK_DistanceFieldInset);
-        // shift the origin to the correct place relative to the distance field
-        // need to also restore the fractional translation
-        scaledBounds.offset(-SkIntToScalar(SK_DistanceFieldInset) - kAntiAliasPad + dx,
-                            -SkIntToScalar(SK_DistanceFieldInset) - kAntiAliasPad + dy);
-        shapeData->fBounds = scaledBounds;
+        shapeData->fBounds = field.fBounds;
         // origin we render from is inset from distance field edge
         atlasLocation.fX += SK_DistanceFieldInset;
         atlasLocation.fY += SK_DistanceFieldInset;
@@ -411,7 +464,7 @@ private:
                            size_t vertexStride,
                            const SkMatrix& viewMatrix,
                            const ShapeData* shapeData) const {
-        GrTexture* texture = atlas->getTexture();
+        GrTexture* texture = atlas->getTexture(GrBatchAtlas::GetPageIndexFromID(shapeData->fID));
 
         SkScalar dx = shapeData->fBounds.fLeft;
         SkScalar dy = shapeData->fBounds.fTop;
@@ -463,6 +516,33 @@ private:
         }
     }
 
+    // Switches the instances that follow to the given atlas page, flushing the ones before if
+    // needed.
+    void setPage(GrVertexBatch::Target* target, FlushInfo* flushInfo, int page) const {
+        SkASSERT(page >= 0 && page < GrBatchAtlas::kMaxPages);
+        if (page == flushInfo->fPage) {
+            return;
+        }
+        // The instances so far sample the old page's texture
+        this->flush(target, flushInfo);
+        sk_sp<GrGeometryProcessor>& gp = flushInfo->fPageGeometryProcessors[page];
+        if (!gp) {
+            gp = this->makeGeometryProcessor(fAtlas->getTexture(page), flushInfo->fFlags);
+        }
+        flushInfo->fGeometryProcessor = gp;
+        flushInfo->fPage = page;
+    }
+
+    sk_sp<GrGeometryProcessor> makeGeometryProcessor(GrTexture* texture, uint32_t flags) const {
+        GrTextureParams params(SkShader::kRepeat_TileMode, GrTextureParams::kBilerp_FilterMode);
+        return GrDistanceFieldPathGeoProc::Make(this->color(),
+                                                this->viewMatrix(),
+                                                texture,
+                                                params,
+                                                flags,
+                                                this->usesLocalCoords());
+    }
+
     GrColor color() const { return fGeoData[0].fColor; }
     const SkMatrix& viewMatrix() const { return fBatch.fViewMatrix; }
     bool usesLocalCoords() const { return fBatch.fUsesLocalCoords; }
@@ -502,6 +582,7 @@ private:
     GrBatchAtlas* fAtlas;
     ShapeCache* fShapeCache;
     ShapeDataList* fShapeList;
+    SkTaskGroup* fFieldTasks;
     bool fGammaCorrect;
 
     typedef GrVertexBatch INHERITED;
@@ -521,16 +602,46 @@ bool GrAADistanceFieldPathRenderer::onDrawPath(const DrawPathArgs& args) {
                                                      ATLAS_TEXTURE_WIDTH, ATLAS_TEXTURE_HEIGHT,
                                                      NUM_PLOTS_X, NUM_PLOTS_Y,
                                                      &GrAADistanceFieldPathRenderer::HandleEviction,
-                                                     (void*)this);
+                                                     (void*)this, GrBatchAtlas::kMaxPages);
         if (!fAtlas) {
             return false;
         }
     }
 
+    // If the shape isn't cached, start generating its distance field now so the flush only has
+    // to upload it. Later draws of the same shape find the pending entry and share it.
+    uint32_t desiredDimension = choose_dimension(*args.fShape, *args.fViewMatrix);
+    ShapeData::Key key(*args.fShape, desiredDimension);
+    ShapeData* shapeData = fShapeCache.find(key);
+    if (shapeData && !shapeData->fPendingField && !fAtlas->hasID(shapeData->fID)) {
+        fShapeCache.remove(shapeData->fKey);
+        fShapeList.remove(shapeData);
+        delete shapeData;
+        shapeData = nullptr;
+    }
+    if (!shapeData) {
+        shapeData = new ShapeData;
+        shapeData->fKey = key;
+        shapeData->fID = GrBatchAtlas::kInvalidAtlasID;
+        shapeData->fPendingField.reset(new DistanceField(*args.fShape, args.fAntiAlias,
+                                                         desiredDimension));
+        // The task's copy of the path shares its SkPathRef with ours. Compute the bounds it caches
+        // lazily now, so that the task only ever reads it.
+        SkPath path;
+        shapeData->fPendingField->fShape.asPath(&path);
+        path.updateBoundsCache();
+
+        DistanceField* field = shapeData->fPendingField.get();
+        fFieldTasks.add([field] { field->generate(); });
+        fShapeCache.add(shapeData);
+        fShapeList.addToTail(shapeData);
+    }
+
     SkAutoTUnref<GrDrawBatch> batch(new AADistanceFieldPathBatch(args.fPaint->getColor(),
                                                                  *args.fShape,
                                                                  args.fAntiAlias, *args.fViewMatrix,
                                                                  fAtlas, &fShapeCache, &fShapeList,
+                                                                 &fFieldTasks,
                                                                  args.fGammaCorrect));
 
     GrPipelineBuilder pipelineBuilder(*args.fPaint);
@@ -616,6 +727,7 @@ DRAW_BATCH_TEST_DEFINE(AADistanceFieldPathBatch) {
                                         gTestStruct.fAtlas,
                                         &gTestStruct.fShapeCache,
                                         &gTestStruct.fShapeList,
+                                        nullptr,
                                         gammaCorrect);
 }
 
@@ -14,7 +14,9 @@
 #include "GrShape.h"
 
 #include "SkChecksum.h"
+#include "SkRefCnt.h"
 #include "SkTDynamicHash.h"
+#include "SkTaskGroup.h"
 
 class GrContext;
 
@@ -32,6 +34,8 @@ private:
 
     bool onDrawPath(const DrawPathArgs&) override;
 
+    struct DistanceField;
+
     struct ShapeData {
         class Key {
         public:
@@ -74,6 +78,9 @@ private:
         GrBatchAtlas::AtlasID fID;
         SkRect                fBounds;
         SkIPoint16            fAtlasLocation;
+        // Set while the shape's distance field is generated ahead of the flush, until the first
+        // batch drawing it adds it to the atlas. fID is invalid until then.
+        sk_sp<DistanceField>  fPendingField;
         SK_DECLARE_INTERNAL_LLIST_INTERFACE(ShapeData);
 
         static inline const Key& GetKey(const ShapeData& data) {
@@ -93,6 +100,7 @@ private:
     GrBatchAtlas*                      fAtlas;
     ShapeCache                         fShapeCache;
     ShapeDataList                      fShapeList;
+    SkTaskGroup                        fFieldTasks;
 
     typedef GrPathRenderer INHERITED;
 
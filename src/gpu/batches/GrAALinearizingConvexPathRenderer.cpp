@@ -25,8 +25,6 @@
 #include "batches/GrVertexBatch.h"
 #include "glsl/GrGLSLGeometryProcessor.h"
 
-static const int DEFAULT_BUFFER_SIZE = 100;
-
 // The thicker the stroke, the harder it is to produce high-quality results using tessellation. For
 // the time being, we simply drop back to software rendering above this stroke width.
 static const SkScalar kMaxStrokeWidth = 20.0;
@@ -171,21 +169,25 @@ private:
         fBatch.fCanTweakAlphaForCoverage = overrides.canTweakAlphaForCoverage();
     }
 
-    void draw(GrVertexBatch::Target* target, const GrGeometryProcessor* gp, int vertexCount,
-              size_t vertexStride, void* vertices, int indexCount, uint16_t* indices) const {
+    // Draws the tessellations of geometries [start, stop) as one mesh. firstVertices[i] and
+    // firstIndices[i] give each tessellation's place in the mesh, or are -1 if it failed.
+    void draw(GrVertexBatch::Target* target, const GrGeometryProcessor* gp,
+              const GrAAConvexTessellator tessellators[], const int firstVertices[],
+              const int firstIndices[], int start, int stop, int vertexCount,
+              int indexCount) const {
         if (vertexCount == 0 || indexCount == 0) {
             return;
         }
+        size_t vertexStride = gp->getVertexStride();
         const GrBuffer* vertexBuffer;
         GrMesh mesh;
         int firstVertex;
-        void* verts = target->makeVertexSpace(vertexStride, vertexCount, &vertexBuffer,
-                                              &firstVertex);
+        uint8_t* verts = (uint8_t*) target->makeVertexSpace(vertexStride, vertexCount,
+                                                            &vertexBuffer, &firstVertex);
         if (!verts) {
             SkDebugf("Could not allocate vertices\n");
             return;
         }
-        memcpy(verts, vertices, vertexCount * vertexStride);
 
         const GrBuffer* indexBuffer;
         int firstIndex;
@@ -194,7 +196,18 @@ private:
             SkDebugf("Could not allocate indices\n");
             return;
         }
-        memcpy(idxs, indices, indexCount * sizeof(uint16_t));
+
+        bool canTweakAlphaForCoverage = this->canTweakAlphaForCoverage();
+        ForEachGeometry(stop - start, [&](int j) {
+            int i = start + j;
+            if (firstVertices[i] < 0) {
+                return;
+            }
+            extract_verts(tessellators[i], verts + vertexStride * firstVertices[i], vertexStride,
+                          fGeoData[i].fColor, firstVertices[i], idxs + firstIndices[i],
+                          canTweakAlphaForCoverage);
+        });
+
         mesh.initIndexed(kTriangles_GrPrimitiveType, vertexBuffer, indexBuffer, firstVertex,
                          firstIndex, vertexCount, indexCount);
         target->draw(gp, mesh);
@@ -213,56 +226,52 @@ private:
             return;
         }
 
-        size_t vertexStride = gp->getVertexStride();
-
         SkASSERT(canTweakAlphaForCoverage ?
-                 vertexStride == sizeof(GrDefaultGeoProcFactory::PositionColorAttr) :
-                 vertexStride == sizeof(GrDefaultGeoProcFactory::PositionColorCoverageAttr));
+                 gp->getVertexStride() == sizeof(GrDefaultGeoProcFactory::PositionColorAttr) :
+                 gp->getVertexStride() ==
+                         sizeof(GrDefaultGeoProcFactory::PositionColorCoverageAttr));
 
         int instanceCount = fGeoData.count();
 
-        int vertexCount = 0;
-        int indexCount = 0;
-        int maxVertices = DEFAULT_BUFFER_SIZE;
-        int maxIndices = DEFAULT_BUFFER_SIZE;
-        uint8_t* vertices = (uint8_t*) sk_malloc_throw(maxVertices * vertexStride);
-        uint16_t* indices = (uint16_t*) sk_malloc_throw(maxIndices * sizeof(uint16_t));
+        // Tessellating is where the time goes, and every path tessellates independently, so do
+        // them all up front. Their vertices are then written straight into the vertex space.
+        SkTArray<GrAAConvexTessellator> tessellators(instanceCount);
         for (int i = 0; i < instanceCount; i++) {
             const Geometry& args = fGeoData[i];
-            GrAAConvexTessellator tess(args.fStrokeWidth, args.fJoin, args.fMiterLimit);
+            tessellators.emplace_back(args.fStrokeWidth, args.fJoin, args.fMiterLimit);
+        }
+        SkAutoTMalloc<int> firstVertices(instanceCount);
+        SkAutoTMalloc<int> firstIndices(instanceCount);
+        ForEachGeometry(instanceCount, [&](int i) {
+            const Geometry& args = fGeoData[i];
+            firstVertices[i] = tessellators[i].tessellate(args.fViewMatrix, args.fPath) ? 0 : -1;
+        });
 
-            if (!tess.tessellate(args.fViewMatrix, args.fPath)) {
+        int start = 0;
+        int vertexCount = 0;
+        int indexCount = 0;
+        for (int i = 0; i < instanceCount; i++) {
+            if (firstVertices[i] < 0) {
                 continue;
             }
-
-            int currentIndices = tess.numIndices();
+            int currentIndices = tessellators[i].numIndices();
             SkASSERT(currentIndices <= UINT16_MAX);
             if (indexCount + currentIndices > UINT16_MAX) {
                 // if we added the current instance, we would overflow the indices we can store in a
                 // uint16_t. Draw what we've got so far and reset.
-                this->draw(target, gp.get(),
-                           vertexCount, vertexStride, vertices, indexCount, indices);
+                this->draw(target, gp.get(), tessellators.begin(), firstVertices, firstIndices,
+                           start, i, vertexCount, indexCount);
+                start = i;
                 vertexCount = 0;
                 indexCount = 0;
             }
-            int currentVertices = tess.numPts();
-            if (vertexCount + currentVertices > maxVertices) {
-                maxVertices = SkTMax(vertexCount + currentVertices, maxVertices * 2);
-                vertices = (uint8_t*) sk_realloc_throw(vertices, maxVertices * vertexStride);
-            }
-            if (indexCount + currentIndices > maxIndices) {
-                maxIndices = SkTMax(indexCount + currentIndices, maxIndices * 2);
-                indices = (uint16_t*) sk_realloc_throw(indices, maxIndices * sizeof(uint16_t));
-            }
-
-            extract_verts(tess, vertices + vertexStride * vertexCount, vertexStride, args.fColor,
-                    vertexCount, indices + indexCount, canTweakAlphaForCoverage);
-            vertexCount += currentVertices;
+            firstVertices[i] = vertexCount;
+            firstIndices[i] = indexCount;
+            vertexCount += tessellators[i].numPts();
             indexCount += currentIndices;
         }
-        this->draw(target, gp.get(), vertexCount, vertexStride, vertices, indexCount, indices);
-        sk_free(vertices);
-        sk_free(indices);
+        this->draw(target, gp.get(), tessellators.begin(), firstVertices, firstIndices,
+                   start, instanceCount, vertexCount, indexCount);
     }
 
     bool onCombineIfPossible(GrBatch* t, const GrCaps& caps) override {
@@ -99,19 +99,10 @@ void GrAtlasTextBatch::onPrepareDraws(Target* target) const {
     GrMaskFormat maskFormat = this->maskFormat();
 
     FlushInfo flushInfo;
-    if (this->usesDistanceFields()) {
-        flushInfo.fGeometryProcessor =
-            this->setupDfProcessor(this->viewMatrix(), fFilteredColor, this->color(), texture);
-    } else {
-        GrTextureParams params(SkShader::kClamp_TileMode, GrTextureParams::kNone_FilterMode);
-        flushInfo.fGeometryProcessor = GrBitmapTextGeoProc::Make(this->color(),
-                                                                 texture,
-                                                                 params,
-                                                                 maskFormat,
-                                                                 localMatrix,
-                                                                 this->usesLocalCoords());
-    }
-
+    flushInfo.fLocalMatrix = localMatrix;
+    flushInfo.fGeometryProcessor = this->makeGeometryProcessor(texture, localMatrix);
+    flushInfo.fPageGeometryProcessors[0] = flushInfo.fGeometryProcessor;
+    flushInfo.fPage = 0;
     flushInfo.fGlyphsToFlush = 0;
     size_t vertexStride = flushInfo.fGeometryProcessor->getVertexStride();
     SkASSERT(vertexStride == GrAtlasTextBlob::GetVertexStride(maskFormat));
@@ -182,6 +173,39 @@ void GrAtlasTextBatch::flush(GrVertexBatch::Target* target, FlushInfo* flushInfo
     flushInfo->fGlyphsToFlush = 0;
 }
 
+void GrAtlasTextBatch::setPage(GrVertexBatch::Target* target, FlushInfo* flushInfo,
+                               int page) const {
+    SkASSERT(page >= 0 && page < GrBatchAtlas::kMaxPages);
+    if (page == flushInfo->fPage) {
+        return;
+    }
+    // The glyphs so far sample the old page's texture
+    if (flushInfo->fGlyphsToFlush) {
+        this->flush(target, flushInfo);
+    }
+    sk_sp<GrGeometryProcessor>& gp = flushInfo->fPageGeometryProcessors[page];
+    if (!gp) {
+        gp = this->makeGeometryProcessor(fFontCache->getPageTexture(this->maskFormat(), page),
+                                         flushInfo->fLocalMatrix);
+    }
+    flushInfo->fGeometryProcessor = gp;
+    flushInfo->fPage = page;
+}
+
+sk_sp<GrGeometryProcessor> GrAtlasTextBatch::makeGeometryProcessor(
+        GrTexture* texture, const SkMatrix& localMatrix) const {
+    if (this->usesDistanceFields()) {
+        return this->setupDfProcessor(this->viewMatrix(), fFilteredColor, this->color(), texture);
+    }
+    GrTextureParams params(SkShader::kClamp_TileMode, GrTextureParams::kNone_FilterMode);
+    return GrBitmapTextGeoProc::Make(this->color(),
+                                     texture,
+                                     params,
+                                     this->maskFormat(),
+                                     localMatrix,
+                                     this->usesLocalCoords());
+}
+
 bool GrAtlasTextBatch::onCombineIfPossible(GrBatch* t, const GrCaps& caps) {
     GrAtlasTextBatch* that = t->cast<GrAtlasTextBatch>();
     if (!GrPipeline::CanCombine(*this->pipeline(), this->bounds(), *that->pipeline(),
@@ -311,3 +335,7 @@ sk_sp<GrGeometryProcessor> GrAtlasTextBatch::setupDfProcessor(const SkMatrix& vi
 void GrBlobRegenHelper::flush() {
     fBatch->flush(fTarget, fFlushInfo);
 }
+
+void GrBlobRegenHelper::setPage(int page) {
+    fBatch->setPage(fTarget, fFlushInfo, page);
+}
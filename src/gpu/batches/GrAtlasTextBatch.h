@@ -106,7 +106,12 @@ private:
     struct FlushInfo {
         SkAutoTUnref<const GrBuffer> fVertexBuffer;
         SkAutoTUnref<const GrBuffer> fIndexBuffer;
+        // The processor for the atlas page the pending glyphs are on, and those made so far for
+        // each page.
         sk_sp<GrGeometryProcessor>   fGeometryProcessor;
+        sk_sp<GrGeometryProcessor>   fPageGeometryProcessors[GrBatchAtlas::kMaxPages];
+        SkMatrix                     fLocalMatrix;
+        int                          fPage;
         int                          fGlyphsToFlush;
         int                          fVertexOffset;
     };
@@ -146,6 +151,11 @@ private:
     }
 
     inline void flush(GrVertexBatch::Target* target, FlushInfo* flushInfo) const;
+    // Switches the glyphs that follow to the given atlas page, flushing the ones before if needed.
+    void setPage(GrVertexBatch::Target* target, FlushInfo* flushInfo, int page) const;
+
+    sk_sp<GrGeometryProcessor> makeGeometryProcessor(GrTexture* texture,
+                                                     const SkMatrix& localMatrix) const;
 
     GrColor color() const { return fBatch.fColor; }
     const SkMatrix& viewMatrix() const { return fGeoData[0].fViewMatrix; }
@@ -209,6 +219,9 @@ public:
 
     void flush();
 
+    // The glyphs counted after this are on the given page of the atlas
+    void setPage(int page);
+
     void incGlyphCount(int glyphCount = 1) {
         fFlushInfo->fGlyphsToFlush += glyphCount;
     }
@@ -27,8 +27,8 @@ public:
 
     ~MemoryPoolAccessor() { gBatchSpinlock.release(); }
 
-    GrMemoryPool* pool() const {
-        static GrMemoryPool gPool(16384, 16384);
+    GrSizeClassPool* pool() const {
+        static GrSizeClassPool gPool(16384);
         return &gPool;
     }
 };
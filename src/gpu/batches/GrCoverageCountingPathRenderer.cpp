@@ -0,0 +1,623 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrCoverageCountingPathRenderer.h"
+
+#include "GrAuditTrail.h"
+#include "GrBatchFlushState.h"
+#include "GrCaps.h"
+#include "GrContext.h"
+#include "GrDrawContext.h"
+#include "GrGeometryProcessor.h"
+#include "GrGpuResourcePriv.h"
+#include "GrInvariantOutput.h"
+#include "GrPathUtils.h"
+#include "GrPipelineBuilder.h"
+#include "GrRectanizer_skyline.h"
+#include "GrTexture.h"
+#include "SkGeometry.h"
+#include "batches/GrVertexBatch.h"
+#include "effects/GrPorterDuffXferProcessor.h"
+#include "glsl/GrGLSLFragmentShaderBuilder.h"
+#include "glsl/GrGLSLGeometryProcessor.h"
+#include "glsl/GrGLSLVarying.h"
+#include "glsl/GrGLSLVertexShaderBuilder.h"
+
+static const int kAtlasSize = 1024;
+// Larger paths would crowd the atlas, and would count coverage over more pixels than the other
+// renderers touch to draw them.
+static const int kMaxPathSize = 256;
+
+// How far the bars along each edge reach to either side of it.
+static const SkScalar kBloatSize = 1.0f;
+
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Each fragment of the counting pass adds clamp(count.x + 0.5, 0, 1) - count.y to the atlas. Fan
+ * triangles carry (1, 0) or (-1, 1) to add 1 or -1. Edge bars carry the signed distance to their
+ * edge in x. On the edge's left, where crossing it steps the fan's count up by one, they carry 1
+ * in y, so the fan's step is traded for a ramp.
+ */
+struct CountVertex {
+    SkPoint fPos;
+    SkPoint fCount;
+};
+
+class CoverageCountProcessor : public GrGeometryProcessor {
+public:
+    CoverageCountProcessor() {
+        this->initClassID<CoverageCountProcessor>();
+        fInPosition = &this->addVertexAttrib(Attribute("inPosition", kVec2f_GrVertexAttribType,
+                                                       kHigh_GrSLPrecision));
+        fInCount = &this->addVertexAttrib(Attribute("inCount", kVec2f_GrVertexAttribType,
+                                                    kHigh_GrSLPrecision));
+    }
+
+    const char* name() const override { return "CoverageCount"; }
+
+    const Attribute* inPosition() const { return fInPosition; }
+    const Attribute* inCount() const { return fInCount; }
+
+    class GLSLProcessor : public GrGLSLGeometryProcessor {
+    public:
+        void onEmitCode(EmitArgs& args, GrGPArgs* gpArgs) override {
+            const CoverageCountProcessor& proc = args.fGP.cast<CoverageCountProcessor>();
+            GrGLSLVertexBuilder* vsBuilder = args.fVertBuilder;
+            GrGLSLVaryingHandler* varyingHandler = args.fVaryingHandler;
+
+            varyingHandler->emitAttributes(proc);
+
+            this->setupPosition(vsBuilder, gpArgs, proc.inPosition()->fName);
+
+            GrGLSLVertToFrag count(kVec2f_GrSLType);
+            varyingHandler->addVarying("Count", &count, kHigh_GrSLPrecision);
+            vsBuilder->codeAppendf("%s = %s;", count.vsOut(), proc.inCount()->fName);
+
+            this->emitTransforms(vsBuilder, varyingHandler, args.fUniformHandler,
+                                 gpArgs->fPositionVar, proc.inPosition()->fName,
+                                 args.fTransformsIn, args.fTransformsOut);
+
+            GrGLSLPPFragmentBuilder* fsBuilder = args.fFragBuilder;
+            fsBuilder->codeAppendf("float coverageCount = clamp(%s.x + 0.5, 0.0, 1.0) - %s.y;",
+                                   count.fsIn(), count.fsIn());
+            fsBuilder->codeAppendf("%s = vec4(coverageCount);", args.fOutputColor);
+            fsBuilder->codeAppendf("%s = vec4(1);", args.fOutputCoverage);
+        }
+
+        void setData(const GrGLSLProgramDataManager&, const GrPrimitiveProcessor&) override {}
+
+    private:
+        typedef GrGLSLGeometryProcessor INHERITED;
+    };
+
+    void getGLSLProcessorKey(const GrGLSLCaps&, GrProcessorKeyBuilder*) const override {}
+
+    GrGLSLPrimitiveProcessor* createGLSLInstance(const GrGLSLCaps&) const override {
+        return new GLSLProcessor();
+    }
+
+private:
+    const Attribute* fInPosition;
+    const Attribute* fInCount;
+
+    typedef GrGeometryProcessor INHERITED;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct CoverVertex {
+    SkPoint fPos;
+    GrColor fColor;
+    SkPoint fAtlasCoord;
+};
+
+/*
+ * Reads a path's coverage count from the atlas and applies its fill rule. The positions are in
+ * device space, and the atlas coords are normalized.
+ */
+class CoverageCountCoverProcessor : public GrGeometryProcessor {
+public:
+    CoverageCountCoverProcessor(GrTexture* atlas, bool evenOdd, const SkMatrix& localMatrix,
+                                bool usesLocalCoords)
+        : fAtlasAccess(atlas)
+        , fEvenOdd(evenOdd)
+        , fLocalMatrix(localMatrix)
+        , fUsesLocalCoords(usesLocalCoords) {
+        this->initClassID<CoverageCountCoverProcessor>();
+        fInPosition = &this->addVertexAttrib(Attribute("inPosition", kVec2f_GrVertexAttribType,
+                                                       kHigh_GrSLPrecision));
+        fInColor = &this->addVertexAttrib(Attribute("inColor", kVec4ub_GrVertexAttribType));
+        fInAtlasCoord = &this->addVertexAttrib(Attribute("inAtlasCoord",
+                                                         kVec2f_GrVertexAttribType,
+                                                         kHigh_GrSLPrecision));
+        this->addTextureAccess(&fAtlasAccess);
+    }
+
+    const char* name() const override { return "CoverageCountCover"; }
+
+    const Attribute* inPosition() const { return fInPosition; }
+    const Attribute* inColor() const { return fInColor; }
+    const Attribute* inAtlasCoord() const { return fInAtlasCoord; }
+    bool evenOdd() const { return fEvenOdd; }
+    const SkMatrix& localMatrix() const { return fLocalMatrix; }
+    bool usesLocalCoords() const { return fUsesLocalCoords; }
+
+    class GLSLProcessor : public GrGLSLGeometryProcessor {
+    public:
+        void onEmitCode(EmitArgs& args, GrGPArgs* gpArgs) override {
+            const CoverageCountCoverProcessor& proc = args.fGP.cast<CoverageCountCoverProcessor>();
+            GrGLSLVertexBuilder* vsBuilder = args.fVertBuilder;
+            GrGLSLVaryingHandler* varyingHandler = args.fVaryingHandler;
+
+            varyingHandler->emitAttributes(proc);
+
+            varyingHandler->addPassThroughAttribute(proc.inColor(), args.fOutputColor);
+
+            this->setupPosition(vsBuilder, gpArgs, proc.inPosition()->fName);
+
+            GrGLSLVertToFrag atlasCoord(kVec2f_GrSLType);
+            varyingHandler->addVarying("AtlasCoord", &atlasCoord, kHigh_GrSLPrecision);
+            vsBuilder->codeAppendf("%s = %s;", atlasCoord.vsOut(), proc.inAtlasCoord()->fName);
+
+            this->emitTransforms(vsBuilder, varyingHandler, args.fUniformHandler,
+                                 gpArgs->fPositionVar, proc.inPosition()->fName,
+                                 proc.localMatrix(), args.fTransformsIn, args.fTransformsOut);
+
+            GrGLSLPPFragmentBuilder* fsBuilder = args.fFragBuilder;
+            fsBuilder->codeAppend("float coverageCount = abs(");
+            fsBuilder->appendTextureLookup(args.fTexSamplers[0], atlasCoord.fsIn(),
+                                           kVec2f_GrSLType);
+            fsBuilder->codeAppend(".a);");
+            if (proc.evenOdd()) {
+                fsBuilder->codeAppend("coverageCount -= 2.0 * floor(0.5 * coverageCount);");
+                fsBuilder->codeAppend("coverageCount = min(coverageCount, 2.0 - coverageCount);");
+            } else {
+                fsBuilder->codeAppend("coverageCount = min(coverageCount, 1.0);");
+            }
+            fsBuilder->codeAppendf("%s = vec4(coverageCount);", args.fOutputCoverage);
+        }
+
+        static inline void GenKey(const GrGeometryProcessor& gp,
+                                  const GrGLSLCaps&,
+                                  GrProcessorKeyBuilder* b) {
+            const CoverageCountCoverProcessor& proc = gp.cast<CoverageCountCoverProcessor>();
+            uint32_t key = 0;
+            key |= proc.evenOdd() ? 0x1 : 0x0;
+            key |= proc.usesLocalCoords() && proc.localMatrix().hasPerspective() ? 0x2 : 0x0;
+            b->add32(key);
+        }
+
+        void setData(const GrGLSLProgramDataManager&, const GrPrimitiveProcessor&) override {}
+
+        void setTransformData(const GrPrimitiveProcessor& primProc,
+                              const GrGLSLProgramDataManager& pdman,
+                              int index,
+                              const SkTArray<const GrCoordTransform*, true>& transforms) override {
+            this->setTransformDataHelper<CoverageCountCoverProcessor>(primProc, pdman, index,
+                                                                      transforms);
+        }
+
+    private:
+        typedef GrGLSLGeometryProcessor INHERITED;
+    };
+
+    void getGLSLProcessorKey(const GrGLSLCaps& caps, GrProcessorKeyBuilder* b) const override {
+        GLSLProcessor::GenKey(*this, caps, b);
+    }
+
+    GrGLSLPrimitiveProcessor* createGLSLInstance(const GrGLSLCaps&) const override {
+        return new GLSLProcessor();
+    }
+
+private:
+    GrTextureAccess  fAtlasAccess;
+    bool             fEvenOdd;
+    SkMatrix         fLocalMatrix;
+    bool             fUsesLocalCoords;
+    const Attribute* fInPosition;
+    const Attribute* fInColor;
+    const Attribute* fInAtlasCoord;
+
+    typedef GrGeometryProcessor INHERITED;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+static void add_triangle(const SkPoint& p0, const SkPoint& p1, const SkPoint& p2,
+                         const SkPoint& count, SkTDArray<CountVertex>* vertices) {
+    CountVertex* verts = vertices->append(3);
+    verts[0] = { p0, count };
+    verts[1] = { p1, count };
+    verts[2] = { p2, count };
+}
+
+// Adds the bars on either side of the edge from p0 to p1. Both have the edge itself as a side, so
+// they split the pixels along it exactly the way the fan triangle bordering it does.
+static void add_edge(const SkPoint& p0, const SkPoint& p1, SkTDArray<CountVertex>* vertices) {
+    SkVector normal = SkPoint::Make(p0.fY - p1.fY, p1.fX - p0.fX);
+    if (!normal.setLength(kBloatSize)) {
+        return;
+    }
+    const SkPoint left0 = p0 + normal, left1 = p1 + normal,
+                  right0 = p0 - normal, right1 = p1 - normal;
+    CountVertex* verts = vertices->append(12);
+    verts[0]  = { p0,     { 0,           1 } };
+    verts[1]  = { p1,     { 0,           1 } };
+    verts[2]  = { left1,  { kBloatSize,  1 } };
+    verts[3]  = { p0,     { 0,           1 } };
+    verts[4]  = { left1,  { kBloatSize,  1 } };
+    verts[5]  = { left0,  { kBloatSize,  1 } };
+    verts[6]  = { p0,     { 0,           0 } };
+    verts[7]  = { p1,     { 0,           0 } };
+    verts[8]  = { right1, { -kBloatSize, 0 } };
+    verts[9]  = { p0,     { 0,           0 } };
+    verts[10] = { right1, { -kBloatSize, 0 } };
+    verts[11] = { right0, { -kBloatSize, 0 } };
+}
+
+static void add_contour(SkTArray<SkPoint, true>* contour, SkTDArray<CountVertex>* vertices) {
+    // The iterator closes contours with a line back to their start.
+    if (contour->count() > 1 && contour->back() == contour->front()) {
+        contour->pop_back();
+    }
+    const int count = contour->count();
+    if (count < 3) {
+        contour->reset();
+        return;
+    }
+    const SkPoint* pts = contour->begin();
+    for (int i = 1; i < count - 1; ++i) {
+        SkScalar cross = (pts[i] - pts[0]).cross(pts[i + 1] - pts[0]);
+        if (cross > 0) {
+            add_triangle(pts[0], pts[i], pts[i + 1], SkPoint::Make(1, 0), vertices);
+        } else if (cross < 0) {
+            add_triangle(pts[0], pts[i], pts[i + 1], SkPoint::Make(-1, 1), vertices);
+        }
+    }
+    for (int i = 0; i < count; ++i) {
+        add_edge(pts[i], pts[i + 1 < count ? i + 1 : 0], vertices);
+    }
+    contour->reset();
+}
+
+static void add_quad_points(const SkPoint pts[3], SkScalar tol,
+                            SkTArray<SkPoint, true>* contour) {
+    uint32_t maxPts = GrPathUtils::quadraticPointCount(pts, tol);
+    SkPoint* points = contour->push_back_n(maxPts);
+    uint32_t numPts = GrPathUtils::generateQuadraticPoints(pts[0], pts[1], pts[2], tol * tol,
+                                                           &points, maxPts);
+    contour->pop_back_n(maxPts - numPts);
+}
+
+// Flattens a path already in atlas space into fan triangles and edge bars.
+static void add_path(const SkPath& path, SkTDArray<CountVertex>* vertices) {
+    static const SkScalar kTolerance = GrPathUtils::kDefaultTolerance;
+    SkSTArray<64, SkPoint, true> contour;
+    SkPath::Iter iter(path, true);
+    SkPoint pts[4];
+    SkPath::Verb verb;
+    while ((verb = iter.next(pts)) != SkPath::kDone_Verb) {
+        switch (verb) {
+            case SkPath::kMove_Verb:
+                add_contour(&contour, vertices);
+                contour.push_back(pts[0]);
+                break;
+            case SkPath::kLine_Verb:
+                contour.push_back(pts[1]);
+                break;
+            case SkPath::kQuad_Verb:
+                add_quad_points(pts, kTolerance, &contour);
+                break;
+            case SkPath::kConic_Verb: {
+                SkAutoConicToQuads converter;
+                const SkPoint* quads = converter.computeQuads(pts, iter.conicWeight(), kTolerance);
+                for (int i = 0; i < converter.countQuads(); ++i) {
+                    add_quad_points(quads + 2 * i, kTolerance, &contour);
+                }
+                break;
+            }
+            case SkPath::kCubic_Verb: {
+                uint32_t maxPts = GrPathUtils::cubicPointCount(pts, kTolerance);
+                SkPoint* points = contour.push_back_n(maxPts);
+                uint32_t numPts = GrPathUtils::generateCubicPoints(pts[0], pts[1], pts[2], pts[3],
+                                                                   kTolerance * kTolerance,
+                                                                   &points, maxPts);
+                contour.pop_back_n(maxPts - numPts);
+                break;
+            }
+            case SkPath::kClose_Verb:
+                add_contour(&contour, vertices);
+                break;
+            case SkPath::kDone_Verb:
+                break;
+        }
+    }
+    add_contour(&contour, vertices);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+class GrCoverageCountingPathRenderer::AtlasBatch : public GrVertexBatch {
+public:
+    DEFINE_BATCH_CLASS_ID
+
+    AtlasBatch(int atlasSize) : INHERITED(ClassID()) {
+        this->setBounds(SkRect::MakeIWH(atlasSize, atlasSize), HasAABloat::kNo, IsZeroArea::kNo);
+    }
+
+    const char* name() const override { return "CoverageCountingAtlasBatch"; }
+
+    void computePipelineOptimizations(GrInitInvariantOutput* color,
+                                      GrInitInvariantOutput* coverage,
+                                      GrBatchToXPOverrides* overrides) const override {
+        color->setUnknownFourComponents();
+        coverage->setKnownSingleComponent(0xff);
+    }
+
+    /** Adds the counting geometry for a path that has been moved into its spot in the atlas. */
+    void addPath(const SkPath& atlasPath) { add_path(atlasPath, &fVertices); }
+
+private:
+    void initBatchTracker(const GrXPOverridesForBatch&) override {}
+
+    void onPrepareDraws(Target* target) const override {
+        if (fVertices.isEmpty()) {
+            return;
+        }
+        SkAutoTUnref<GrGeometryProcessor> gp(new CoverageCountProcessor);
+        SkASSERT(gp->getVertexStride() == sizeof(CountVertex));
+
+        const GrBuffer* vertexBuffer;
+        int firstVertex;
+        void* verts = target->makeVertexSpace(sizeof(CountVertex), fVertices.count(),
+                                              &vertexBuffer, &firstVertex);
+        if (!verts) {
+            SkDebugf("Could not allocate vertices\n");
+            return;
+        }
+        memcpy(verts, fVertices.begin(), fVertices.count() * sizeof(CountVertex));
+
+        GrMesh mesh;
+        mesh.init(kTriangles_GrPrimitiveType, vertexBuffer, firstVertex, fVertices.count());
+        target->draw(gp, mesh);
+    }
+
+    // Every path lands in the one batch recorded for the atlas.
+    bool onCombineIfPossible(GrBatch*, const GrCaps&) override { return false; }
+
+    SkTDArray<CountVertex> fVertices;
+
+    typedef GrVertexBatch INHERITED;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+class CoverageCountingPathBatch : public GrVertexBatch {
+public:
+    DEFINE_BATCH_CLASS_ID
+
+    CoverageCountingPathBatch(GrColor color, const SkMatrix& viewMatrix, bool evenOdd,
+                              const SkIRect& devBounds, const SkIPoint16& atlasLocation,
+                              GrTexture* atlas)
+        : INHERITED(ClassID())
+        , fViewMatrix(viewMatrix)
+        , fEvenOdd(evenOdd)
+        , fAtlas(SkRef(atlas)) {
+        fPaths.push_back(Path{color, devBounds, atlasLocation});
+        this->setBounds(SkRect::Make(devBounds), HasAABloat::kNo, IsZeroArea::kNo);
+    }
+
+    const char* name() const override { return "CoverageCountingPathBatch"; }
+
+    void computePipelineOptimizations(GrInitInvariantOutput* color,
+                                      GrInitInvariantOutput* coverage,
+                                      GrBatchToXPOverrides* overrides) const override {
+        // When this is called on a batch, there is only one path
+        color->setKnownFourComponents(fPaths[0].fColor);
+        coverage->setUnknownSingleComponent();
+    }
+
+private:
+    void initBatchTracker(const GrXPOverridesForBatch& overrides) override {
+        overrides.getOverrideColorIfSet(&fPaths[0].fColor);
+        fUsesLocalCoords = overrides.readsLocalCoords();
+    }
+
+    void onPrepareDraws(Target* target) const override {
+        SkMatrix invert;
+        if (fUsesLocalCoords && !fViewMatrix.invert(&invert)) {
+            SkDebugf("Could not invert viewmatrix\n");
+            return;
+        }
+
+        SkAutoTUnref<GrGeometryProcessor> gp(new CoverageCountCoverProcessor(fAtlas, fEvenOdd,
+                                                                             invert,
+                                                                             fUsesLocalCoords));
+        size_t vertexStride = gp->getVertexStride();
+        SkASSERT(vertexStride == sizeof(CoverVertex));
+
+        QuadHelper helper;
+        CoverVertex* verts = reinterpret_cast<CoverVertex*>(helper.init(target, vertexStride,
+                                                                        fPaths.count()));
+        if (!verts) {
+            SkDebugf("Could not allocate vertices\n");
+            return;
+        }
+
+        const SkScalar atlasScaleX = 1.0f / fAtlas->width(),
+                       atlasScaleY = 1.0f / fAtlas->height();
+        for (int i = 0; i < fPaths.count(); ++i) {
+            const Path& path = fPaths[i];
+            SkRect bounds = SkRect::Make(path.fDevBounds);
+            verts[0].fPos.setRectFan(bounds.fLeft, bounds.fTop, bounds.fRight, bounds.fBottom,
+                                     vertexStride);
+            SkRect atlasBounds = SkRect::MakeXYWH(SkIntToScalar(path.fAtlasLocation.fX),
+                                                  SkIntToScalar(path.fAtlasLocation.fY),
+                                                  bounds.width(), bounds.height());
+            verts[0].fAtlasCoord.setRectFan(atlasBounds.fLeft * atlasScaleX,
+                                            atlasBounds.fTop * atlasScaleY,
+                                            atlasBounds.fRight * atlasScaleX,
+                                            atlasBounds.fBottom * atlasScaleY,
+                                            vertexStride);
+            for (int j = 0; j < 4; ++j) {
+                verts[j].fColor = path.fColor;
+            }
+            verts += 4;
+        }
+        helper.recordDraw(target, gp);
+    }
+
+    bool onCombineIfPossible(GrBatch* t, const GrCaps& caps) override {
+        CoverageCountingPathBatch* that = t->cast<CoverageCountingPathBatch>();
+        if (!GrPipeline::CanCombine(*this->pipeline(), this->bounds(), *that->pipeline(),
+                                    that->bounds(), caps)) {
+            return false;
+        }
+
+        if (fAtlas.get() != that->fAtlas.get() || fEvenOdd != that->fEvenOdd) {
+            return false;
+        }
+
+        SkASSERT(fUsesLocalCoords == that->fUsesLocalCoords);
+        if (fUsesLocalCoords && !fViewMatrix.cheapEqualTo(that->fViewMatrix)) {
+            return false;
+        }
+
+        fPaths.push_back_n(that->fPaths.count(), that->fPaths.begin());
+        this->joinBounds(*that);
+        return true;
+    }
+
+    struct Path {
+        GrColor    fColor;
+        SkIRect    fDevBounds;
+        SkIPoint16 fAtlasLocation;
+    };
+
+    SkSTArray<1, Path, true> fPaths;
+    SkMatrix                 fViewMatrix;
+    bool                     fEvenOdd;
+    bool                     fUsesLocalCoords;
+    SkAutoTUnref<GrTexture>  fAtlas;
+
+    typedef GrVertexBatch INHERITED;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+GrCoverageCountingPathRenderer* GrCoverageCountingPathRenderer::Create(GrContext* context) {
+    const GrCaps& caps = *context->caps();
+    if (!caps.coverageCountingPathsEnabled()) {
+        return nullptr;
+    }
+    // Counts are signed and fractional, and need a floating point target to add them up in.
+    if (!caps.isConfigRenderable(kAlpha_half_GrPixelConfig, false)) {
+        return nullptr;
+    }
+    int atlasSize = SkTMin(kAtlasSize, caps.maxRenderTargetSize());
+    // The largest path, bloated and rounded out, has to fit.
+    if (atlasSize < kMaxPathSize + 3) {
+        return nullptr;
+    }
+    return new GrCoverageCountingPathRenderer(context, atlasSize);
+}
+
+GrCoverageCountingPathRenderer::GrCoverageCountingPathRenderer(GrContext* context, int atlasSize)
+    : fContext(context)
+    , fAtlasSize(atlasSize) {
+}
+
+GrCoverageCountingPathRenderer::~GrCoverageCountingPathRenderer() {
+}
+
+bool GrCoverageCountingPathRenderer::onCanDrawPath(const CanDrawPathArgs& args) const {
+    // This does non-inverse antialiased fills.
+    if (!args.fAntiAlias || !args.fShape->style().isSimpleFill() ||
+        args.fShape->inverseFilled()) {
+        return false;
+    }
+    // currently don't support perspective
+    if (args.fViewMatrix->hasPerspective()) {
+        return false;
+    }
+    SkRect devBounds;
+    args.fViewMatrix->mapRect(&devBounds, args.fShape->bounds());
+    return devBounds.width() <= kMaxPathSize && devBounds.height() <= kMaxPathSize;
+}
+
+bool GrCoverageCountingPathRenderer::setupAtlas() {
+    fAtlasBatch.reset(nullptr);
+    fAtlas = fContext->newDrawContext(SkBackingFit::kApprox, fAtlasSize, fAtlasSize,
+                                      kAlpha_half_GrPixelConfig, 0, kTopLeft_GrSurfaceOrigin);
+    if (!fAtlas) {
+        return false;
+    }
+    fAtlasTexture = fAtlas->asTexture();
+    fAtlasTexture->resourcePriv().setIsAtlas(true);
+    fAtlas->clear(nullptr, 0x0, true);
+
+    GrPaint paint;
+    paint.setXPFactory(GrPorterDuffXPFactory::Make(SkXfermode::kPlus_Mode));
+    GrPipelineBuilder pipelineBuilder(paint, false);
+    fAtlasBatch.reset(new AtlasBatch(fAtlasSize));
+    fAtlas->drawBatch(pipelineBuilder, GrNoClip(), fAtlasBatch);
+
+    if (fRectanizer) {
+        fRectanizer->reset();
+    } else {
+        fRectanizer.reset(new GrRectanizerSkyline(fAtlasSize, fAtlasSize));
+    }
+    // The atlas's draw target holds a ref on the batch for as long as it means to draw it.
+    return !fAtlasBatch->unique();
+}
+
+bool GrCoverageCountingPathRenderer::onDrawPath(const DrawPathArgs& args) {
+    GR_AUDIT_TRAIL_AUTO_FRAME(args.fDrawContext->auditTrail(),
+                              "GrCoverageCountingPathRenderer::onDrawPath");
+    SkASSERT(!args.fShape->isEmpty());
+
+    SkPath path;
+    args.fShape->asPath(&path);
+    path.transform(*args.fViewMatrix);
+
+    // Leave room for the bars along the edges.
+    SkRect bloatedBounds = path.getBounds();
+    bloatedBounds.outset(kBloatSize, kBloatSize);
+    SkIRect devBounds;
+    bloatedBounds.roundOut(&devBounds);
+
+    SkIRect clipBounds;
+    args.fClip->getConservativeBounds(args.fDrawContext->width(), args.fDrawContext->height(),
+                                      &clipBounds);
+    if (!SkIRect::Intersects(devBounds, clipBounds)) {
+        return true;
+    }
+
+    SkIPoint16 location;
+    if (!fAtlasBatch || fAtlasBatch->unique() ||
+        !fRectanizer->addRect(devBounds.width(), devBounds.height(), &location)) {
+        if (!this->setupAtlas()) {
+            return false;
+        }
+        SkAssertResult(fRectanizer->addRect(devBounds.width(), devBounds.height(), &location));
+    }
+    path.offset(SkIntToScalar(location.fX - devBounds.fLeft),
+                SkIntToScalar(location.fY - devBounds.fTop));
+    fAtlasBatch->addPath(path);
+
+    SkAutoTUnref<GrDrawBatch> batch(new CoverageCountingPathBatch(
+                                                args.fPaint->getColor(), *args.fViewMatrix,
+                                                SkPath::kEvenOdd_FillType == path.getFillType(),
+                                                devBounds, location, fAtlasTexture.get()));
+
+    GrPipelineBuilder pipelineBuilder(*args.fPaint, args.fDrawContext->mustUseHWAA(*args.fPaint));
+    pipelineBuilder.setUserStencil(args.fUserStencilSettings);
+
+    args.fDrawContext->drawBatch(pipelineBuilder, *args.fClip, batch);
+    return true;
+}
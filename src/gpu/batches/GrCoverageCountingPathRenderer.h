@@ -0,0 +1,71 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrCoverageCountingPathRenderer_DEFINED
+#define GrCoverageCountingPathRenderer_DEFINED
+
+#include "GrPathRenderer.h"
+#include "SkRefCnt.h"
+#include "SkTemplates.h"
+
+class GrContext;
+class GrDrawContext;
+class GrRectanizer;
+class GrTexture;
+
+/*
+ * Renders small antialiased fills, convex or not, in two passes that share an atlas among every
+ * path drawn between flushes.
+ *
+ * The first pass counts signed coverage into a floating point atlas with additive blending. Each
+ * contour is flattened to lines and drawn as a triangle fan, whose triangles add +1 or -1 to the
+ * pixels whose centers they cover, for a sum equal to the winding number at each pixel center.
+ * Every edge then draws a thin bar on either side of itself, sharing the edge's vertices with its
+ * fan triangle so both rasterize it the same way. The bars replace the fan's hard step across the
+ * edge with the pixel's analytic coverage of the edge's half plane. All the paths in an atlas land
+ * in a single draw.
+ *
+ * The second pass draws each path's bounds into the destination, reading the count back from the
+ * atlas and turning it into coverage with the path's fill rule.
+ */
+class GrCoverageCountingPathRenderer : public GrPathRenderer {
+public:
+    /** Returns nullptr unless GrContextOptions::fEnableCoverageCountingPaths is set and the
+        context can render to a floating point atlas. */
+    static GrCoverageCountingPathRenderer* Create(GrContext*);
+
+    ~GrCoverageCountingPathRenderer() override;
+
+private:
+    class AtlasBatch;
+
+    GrCoverageCountingPathRenderer(GrContext*, int atlasSize);
+
+    StencilSupport onGetStencilSupport(const GrShape&) const override {
+        return GrPathRenderer::kNoSupport_StencilSupport;
+    }
+
+    bool onCanDrawPath(const CanDrawPathArgs&) const override;
+
+    bool onDrawPath(const DrawPathArgs&) override;
+
+    // Starts a new atlas, recording its batch ahead of any draw that reads from it.
+    bool setupAtlas();
+
+    GrContext*                  fContext;
+    const int                   fAtlasSize;
+    sk_sp<GrDrawContext>        fAtlas;
+    sk_sp<GrTexture>            fAtlasTexture;
+    // Paths are added to this batch until the draw target that recorded it flushes and lets go of
+    // it. Then the next path starts a new atlas.
+    SkAutoTUnref<AtlasBatch>    fAtlasBatch;
+    SkAutoTDelete<GrRectanizer> fRectanizer;
+
+    typedef GrPathRenderer INHERITED;
+};
+
+#endif
@@ -99,6 +99,20 @@ private:
     SkPoint* fVertices;
 };
 
+// Grows rect out to a grid of power-of-two cells about a quarter of its size, so that moving it by
+// less than a cell usually leaves the result unchanged.
+void snap_out_to_grid(SkRect* rect) {
+    SkScalar size = SkTMax(rect->width(), rect->height());
+    if (!(size > 0) || !SkScalarIsFinite(size)) {
+        return;
+    }
+    SkScalar cell = SkScalarPow(2, SkScalarCeilToScalar(SkScalarLog2(size * 0.25f)));
+    rect->setLTRB(SkScalarFloorToScalar(rect->fLeft / cell) * cell,
+                  SkScalarFloorToScalar(rect->fTop / cell) * cell,
+                  SkScalarCeilToScalar(rect->fRight / cell) * cell,
+                  SkScalarCeilToScalar(rect->fBottom / cell) * cell);
+}
+
 }  // namespace
 
 GrTessellatingPathRenderer::GrTessellatingPathRenderer() {
@@ -238,6 +252,13 @@ private:
         // Because the clip bounds are used to add a contour for inverse fills, they must also
         // include the path bounds.
         fClipBounds.join(pathBounds);
+        // That contour makes an inverse fill's tessellation, and its cache key, depend on the clip
+        // bounds. They're in source space, so they change whenever the view translates. Snapping
+        // them out lets content that only scrolls reuse its tessellation. Covering a little more
+        // than the clip is harmless since the clip itself still applies.
+        if (shape.inverseFilled()) {
+            snap_out_to_grid(&fClipBounds);
+        }
         const SkRect& srcBounds = shape.inverseFilled() ? fClipBounds : pathBounds;
         this->setTransformedBounds(srcBounds, viewMatrix, HasAABloat::kNo, IsZeroArea::kNo);
     }
@@ -8,12 +8,33 @@
 #include "GrVertexBatch.h"
 #include "GrBatchFlushState.h"
 #include "GrResourceProvider.h"
+#include "SkTaskGroup.h"
 
 GrVertexBatch::GrVertexBatch(uint32_t classID)
     : INHERITED(classID)
     , fBaseDrawToken(GrBatchDrawToken::AlreadyFlushedToken()) {
 }
 
+// Generating the vertices for a single path is too little work to hand to another thread, so
+// geometries are handed out in groups, and only once a batch has several groups' worth of them.
+static const int kGeometriesPerTask = 16;
+static const int kMinParallelGeometries = 4 * kGeometriesPerTask;
+
+void GrVertexBatch::ForEachGeometry(int count, const std::function<void(int)>& fn) {
+    if (count < kMinParallelGeometries || !SkTaskGroup::Enabled()) {
+        for (int i = 0; i < count; ++i) {
+            fn(i);
+        }
+        return;
+    }
+    const int tasks = count / kGeometriesPerTask;
+    SkTaskGroup().batch(tasks, [&](int t) {
+        for (int i = t * count / tasks; i < (t + 1) * count / tasks; ++i) {
+            fn(i);
+        }
+    });
+}
+
 void GrVertexBatch::onPrepare(GrBatchFlushState* state) {
     Target target(state, this);
     this->onPrepareDraws(&target);
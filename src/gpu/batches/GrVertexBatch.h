@@ -15,6 +15,8 @@
 
 #include "SkTLList.h"
 
+#include <functional>
+
 class GrBatchFlushState;
 
 /**
@@ -44,6 +46,12 @@ protected:
         GrMesh fMesh;
     };
 
+    /** Calls fn(i) for every i in [0, count). When SkTaskGroup has threads and there are enough
+        geometries to be worth it, the calls are spread across those threads, so fn may only
+        write to state owned by geometry i, e.g. its own pre-reserved range of vertex space.
+        Allocating from the Target is not thread safe and must happen before or after. */
+    static void ForEachGeometry(int count, const std::function<void(int)>& fn);
+
     static const int kVerticesPerQuad = 4;
     static const int kIndicesPerQuad = 6;
 
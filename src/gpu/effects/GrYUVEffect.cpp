@@ -64,7 +64,8 @@ class YUVtoRGBEffect : public GrFragmentProcessor {
 public:
     static sk_sp<GrFragmentProcessor> Make(GrTexture* yTexture, GrTexture* uTexture,
                                            GrTexture* vTexture, const SkISize sizes[3],
-                                           SkYUVColorSpace colorSpace, bool nv12) {
+                                           SkYUVColorSpace colorSpace,
+                                           GrYUVEffect::PlaneLayout layout) {
         SkScalar w[3], h[3];
         w[0] = SkIntToScalar(sizes[0].fWidth)  / SkIntToScalar(yTexture->width());
         h[0] = SkIntToScalar(sizes[0].fHeight) / SkIntToScalar(yTexture->height());
@@ -86,16 +87,14 @@ public:
             GrTextureParams::kBilerp_FilterMode :
             GrTextureParams::kNone_FilterMode;
         return sk_sp<GrFragmentProcessor>(new YUVtoRGBEffect(
-            yTexture, uTexture, vTexture, yuvMatrix, uvFilterMode, colorSpace, nv12));
+            yTexture, uTexture, vTexture, yuvMatrix, uvFilterMode, colorSpace, layout));
     }
 
     const char* name() const override { return "YUV to RGB"; }
 
     SkYUVColorSpace getColorSpace() const { return fColorSpace; }
 
-    bool isNV12() const {
-        return fNV12;
-    }
+    GrYUVEffect::PlaneLayout getPlaneLayout() const { return fLayout; }
 
     class GLSLProcessor : public GrGLSLFragmentProcessor {
     public:
@@ -113,8 +112,10 @@ public:
             fragBuilder->codeAppend(".r,");
             fragBuilder->appendTextureLookup(args.fTexSamplers[1], args.fCoords[1].c_str(),
                                              args.fCoords[1].getType());
-            if (effect.fNV12) {
+            if (GrYUVEffect::PlaneLayout::kNV12 == effect.fLayout) {
                 fragBuilder->codeAppendf(".rg,");
+            } else if (GrYUVEffect::PlaneLayout::kNV21 == effect.fLayout) {
+                fragBuilder->codeAppendf(".gr,");
             } else {
                 fragBuilder->codeAppend(".r,");
                 fragBuilder->appendTextureLookup(args.fTexSamplers[2], args.fCoords[2].c_str(),
@@ -150,20 +151,20 @@ public:
 private:
     YUVtoRGBEffect(GrTexture* yTexture, GrTexture* uTexture, GrTexture* vTexture,
                    const SkMatrix yuvMatrix[3], GrTextureParams::FilterMode uvFilterMode,
-                   SkYUVColorSpace colorSpace, bool nv12)
+                   SkYUVColorSpace colorSpace, GrYUVEffect::PlaneLayout layout)
         : fYTransform(kLocal_GrCoordSet, yuvMatrix[0], yTexture, GrTextureParams::kNone_FilterMode)
         , fYAccess(yTexture)
         , fUTransform(kLocal_GrCoordSet, yuvMatrix[1], uTexture, uvFilterMode)
         , fUAccess(uTexture, uvFilterMode)
         , fVAccess(vTexture, uvFilterMode)
         , fColorSpace(colorSpace)
-        , fNV12(nv12) {
+        , fLayout(layout) {
         this->initClassID<YUVtoRGBEffect>();
         this->addCoordTransform(&fYTransform);
         this->addTextureAccess(&fYAccess);
         this->addCoordTransform(&fUTransform);
         this->addTextureAccess(&fUAccess);
-        if (!fNV12) {
+        if (GrYUVEffect::PlaneLayout::kYUV == fLayout) {
             fVTransform = GrCoordTransform(kLocal_GrCoordSet, yuvMatrix[2], vTexture, uvFilterMode);
             this->addCoordTransform(&fVTransform);
             this->addTextureAccess(&fVAccess);
@@ -175,12 +176,12 @@ private:
     }
 
     void onGetGLSLProcessorKey(const GrGLSLCaps& caps, GrProcessorKeyBuilder* b) const override {
-        b->add32(fNV12);
+        b->add32(static_cast<uint32_t>(fLayout));
     }
 
     bool onIsEqual(const GrFragmentProcessor& sBase) const override {
         const YUVtoRGBEffect& s = sBase.cast<YUVtoRGBEffect>();
-        return (fColorSpace == s.getColorSpace()) && (fNV12 == s.isNV12());
+        return (fColorSpace == s.getColorSpace()) && (fLayout == s.getPlaneLayout());
     }
 
     void onComputeInvariantOutput(GrInvariantOutput* inout) const override {
@@ -196,7 +197,7 @@ private:
     GrCoordTransform fVTransform;
     GrTextureAccess fVAccess;
     SkYUVColorSpace fColorSpace;
-    bool fNV12;
+    GrYUVEffect::PlaneLayout fLayout;
 
     typedef GrFragmentProcessor INHERITED;
 };
@@ -363,9 +364,10 @@ private:
 
 sk_sp<GrFragmentProcessor> GrYUVEffect::MakeYUVToRGB(GrTexture* yTexture, GrTexture* uTexture,
                                                      GrTexture* vTexture, const SkISize sizes[3],
-                                                     SkYUVColorSpace colorSpace, bool nv12) {
+                                                     SkYUVColorSpace colorSpace,
+                                                     PlaneLayout layout) {
     SkASSERT(yTexture && uTexture && vTexture && sizes);
-    return YUVtoRGBEffect::Make(yTexture, uTexture, vTexture, sizes, colorSpace, nv12);
+    return YUVtoRGBEffect::Make(yTexture, uTexture, vTexture, sizes, colorSpace, layout);
 }
 
 sk_sp<GrFragmentProcessor>
@@ -14,13 +14,23 @@ class GrFragmentProcessor;
 class GrTexture;
 
 namespace GrYUVEffect {
+    /**
+     * Where MakeYUVToRGB() finds the U and V values. Y is always the red channel of yTexture.
+     */
+    enum class PlaneLayout {
+        kYUV,   // U and V are the red channels of uTexture and vTexture.
+        kNV12,  // U and V are interleaved as the red and green channels of uTexture.
+        kNV21,  // V and U are interleaved as the red and green channels of uTexture.
+    };
+
     /**
      * Creates an effect that performs color conversion from YUV to RGB. The input textures are
-     * assumed to be kA8_GrPixelConfig.
+     * assumed to be kA8_GrPixelConfig, except for the interleaved layouts' uTexture. Those
+     * ignore vTexture and sizes[2].
      */
     sk_sp<GrFragmentProcessor> MakeYUVToRGB(GrTexture* yTexture, GrTexture* uTexture,
                                             GrTexture* vTexture, const SkISize sizes[3],
-                                            SkYUVColorSpace colorSpace, bool nv12);
+                                            SkYUVColorSpace colorSpace, PlaneLayout);
 
     /**
      * Creates a processor that performs color conversion from the passed in processor's RGB
@@ -229,6 +229,11 @@ const GrGLInterface* GrGLAssembleGLInterface(void* ctx, GrGLGetProc get) {
     } else if (extensions.has("GL_NV_texture_barrier")) {
         GET_PROC_SUFFIX(TextureBarrier, NV);
     }
+    if (glVer >= GR_GL_VER(3,2) || extensions.has("GL_ARB_sync")) {
+        GET_PROC(FenceSync);
+        GET_PROC(ClientWaitSync);
+        GET_PROC(DeleteSync);
+    }
     GET_PROC(Uniform1f);
     GET_PROC(Uniform1i);
     GET_PROC(Uniform1fv);
@@ -373,6 +378,18 @@ const GrGLInterface* GrGLAssembleGLInterface(void* ctx, GrGLGetProc get) {
         GET_PROC(GetProgramResourceLocation);
     }
 
+    if (glVer >= GR_GL_VER(4,1) || extensions.has("GL_ARB_get_program_binary")) {
+        GET_PROC(GetProgramBinary);
+        GET_PROC(ProgramBinary);
+        GET_PROC(ProgramParameteri);
+    }
+
+    if (extensions.has("GL_KHR_parallel_shader_compile")) {
+        GET_PROC_SUFFIX(MaxShaderCompilerThreads, KHR);
+    } else if (extensions.has("GL_ARB_parallel_shader_compile")) {
+        GET_PROC_SUFFIX(MaxShaderCompilerThreads, ARB);
+    }
+
     if (extensions.has("GL_NV_bindless_texture")) {
         GET_PROC_SUFFIX(GetTextureHandle, NV);
         GET_PROC_SUFFIX(GetTextureSamplerHandle, NV);
@@ -687,6 +704,29 @@ const GrGLInterface* GrGLAssembleGLESInterface(void* ctx, GrGLGetProc get) {
         GET_PROC_SUFFIX(TextureBarrier, NV);
     }
 
+    if (version >= GR_GL_VER(3,0)) {
+        GET_PROC(FenceSync);
+        GET_PROC(ClientWaitSync);
+        GET_PROC(DeleteSync);
+    } else if (extensions.has("GL_APPLE_sync")) {
+        GET_PROC_SUFFIX(FenceSync, APPLE);
+        GET_PROC_SUFFIX(ClientWaitSync, APPLE);
+        GET_PROC_SUFFIX(DeleteSync, APPLE);
+    }
+
+    if (extensions.has("GL_EXT_disjoint_timer_query")) {
+        GET_PROC_SUFFIX(GenQueries, EXT);
+        GET_PROC_SUFFIX(DeleteQueries, EXT);
+        GET_PROC_SUFFIX(BeginQuery, EXT);
+        GET_PROC_SUFFIX(EndQuery, EXT);
+        GET_PROC_SUFFIX(QueryCounter, EXT);
+        GET_PROC_SUFFIX(GetQueryiv, EXT);
+        GET_PROC_SUFFIX(GetQueryObjectiv, EXT);
+        GET_PROC_SUFFIX(GetQueryObjectuiv, EXT);
+        GET_PROC_SUFFIX(GetQueryObjecti64v, EXT);
+        GET_PROC_SUFFIX(GetQueryObjectui64v, EXT);
+    }
+
     GET_PROC_SUFFIX(DiscardFramebuffer, EXT);
     GET_PROC(Uniform1f);
     GET_PROC(Uniform1i);
@@ -800,6 +840,19 @@ const GrGLInterface* GrGLAssembleGLESInterface(void* ctx, GrGLGetProc get) {
         GET_PROC(GetProgramResourceLocation);
     }
 
+    if (version >= GR_GL_VER(3,0)) {
+        GET_PROC(GetProgramBinary);
+        GET_PROC(ProgramBinary);
+        GET_PROC(ProgramParameteri);
+    } else if (extensions.has("GL_OES_get_program_binary")) {
+        GET_PROC_SUFFIX(GetProgramBinary, OES);
+        GET_PROC_SUFFIX(ProgramBinary, OES);
+    }
+
+    if (extensions.has("GL_KHR_parallel_shader_compile")) {
+        GET_PROC_SUFFIX(MaxShaderCompilerThreads, KHR);
+    }
+
     if (extensions.has("GL_NV_path_rendering")) {
         GET_PROC_SUFFIX(MatrixLoadf, EXT);
         GET_PROC_SUFFIX(MatrixLoadIdentity, EXT);
@@ -50,6 +50,8 @@ GrGLCaps::GrGLCaps(const GrContextOptions& contextOptions,
     fMipMapLevelAndLodControlSupport = false;
     fRGBAToBGRAReadbackConversionsAreSlow = false;
     fDoManualMipmapping = false;
+    fProgramBinarySupport = false;
+    fParallelShaderCompileSupport = false;
 
     fBlitFramebufferSupport = kNone_BlitFramebufferSupport;
 
@@ -110,6 +112,20 @@ void GrGLCaps::init(const GrContextOptions& contextOptions,
         fTextureBarrierSupport = ctxInfo.hasExtension("GL_NV_texture_barrier");
     }
 
+    if (kGL_GrGLStandard == standard) {
+        fFenceSyncSupport = version >= GR_GL_VER(3,2) || ctxInfo.hasExtension("GL_ARB_sync");
+    } else {
+        fFenceSyncSupport = version >= GR_GL_VER(3,0) || ctxInfo.hasExtension("GL_APPLE_sync");
+    }
+
+    if (kGL_GrGLStandard == standard) {
+        fTimerQuerySupport = version >= GR_GL_VER(3,3) ||
+                             ctxInfo.hasExtension("GL_ARB_timer_query") ||
+                             ctxInfo.hasExtension("GL_EXT_timer_query");
+    } else {
+        fTimerQuerySupport = ctxInfo.hasExtension("GL_EXT_disjoint_timer_query");
+    }
+
     if (kGL_GrGLStandard == standard) {
         fSampleLocationsSupport = version >= GR_GL_VER(3,2) ||
                                   ctxInfo.hasExtension("GL_ARB_texture_multisample");
@@ -198,6 +214,23 @@ void GrGLCaps::init(const GrContextOptions& contextOptions,
     fBindUniformLocationSupport = false;
 #endif
 
+    if ((kGL_GrGLStandard == standard &&
+         (version >= GR_GL_VER(4, 1) || ctxInfo.hasExtension("GL_ARB_get_program_binary"))) ||
+        (kGLES_GrGLStandard == standard &&
+         (version >= GR_GL_VER(3, 0) || ctxInfo.hasExtension("GL_OES_get_program_binary")))) {
+        // Drivers may support the API but no binary formats, in which case it's no use to us.
+        GrGLint formatCount = 0;
+        GR_GL_GetIntegerv(gli, GR_GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+        fProgramBinarySupport = formatCount > 0 &&
+                                gli->fFunctions.fGetProgramBinary &&
+                                gli->fFunctions.fProgramBinary;
+    }
+
+    if (ctxInfo.hasExtension("GL_KHR_parallel_shader_compile") ||
+        (kGL_GrGLStandard == standard && ctxInfo.hasExtension("GL_ARB_parallel_shader_compile"))) {
+        fParallelShaderCompileSupport = SkToBool(gli->fFunctions.fMaxShaderCompilerThreads);
+    }
+
     if (kGL_GrGLStandard == standard) {
         if (version >= GR_GL_VER(3, 1) || ctxInfo.hasExtension("GL_ARB_texture_rectangle")) {
             // We also require textureSize() support for rectangle 2D samplers which was added in
@@ -397,6 +430,8 @@ void GrGLCaps::init(const GrContextOptions& contextOptions,
             fTransferBufferType = kChromium_TransferBufferType;
         }
     }
+    // Only standard pixel unpack buffers are used for transferPixels() uploads.
+    fTransferBufferSupport = kPBO_TransferBufferType == fTransferBufferType;
 
     // On many GPUs, map memory is very expensive, so we effectively disable it here by setting the
     // threshold to the maximum unless the client gives us a hint that map memory is cheap.
@@ -1124,6 +1159,9 @@ SkString GrGLCaps::dump() const {
     r.appendf("RGBA 8888 pixel ops are slow: %s\n", (fRGBA8888PixelsOpsAreSlow ? "YES" : "NO"));
     r.appendf("Partial FBO read is slow: %s\n", (fPartialFBOReadIsSlow ? "YES" : "NO"));
     r.appendf("Bind uniform location support: %s\n", (fBindUniformLocationSupport ? "YES" : "NO"));
+    r.appendf("Program binary support: %s\n", (fProgramBinarySupport ? "YES" : "NO"));
+    r.appendf("Parallel shader compile support: %s\n",
+              (fParallelShaderCompileSupport ? "YES" : "NO"));
     r.appendf("Rectangle texture support: %s\n", (fRectangleTextureSupport? "YES" : "NO"));
     r.appendf("Texture swizzle support: %s\n", (fTextureSwizzleSupport ? "YES" : "NO"));
     r.appendf("BGRA to RGBA readback conversions are slow: %s\n",
@@ -325,6 +325,12 @@ public:
 
     bool bindUniformLocationSupport() const { return fBindUniformLocationSupport; }
 
+    /// Can linked programs be retrieved with glGetProgramBinary and restored with glProgramBinary.
+    bool programBinarySupport() const { return fProgramBinarySupport; }
+
+    /// KHR_parallel_shader_compile or ARB_parallel_shader_compile
+    bool parallelShaderCompileSupport() const { return fParallelShaderCompileSupport; }
+
     /// Are textures with GL_TEXTURE_RECTANGLE type supported.
     bool rectangleTextureSupport() const { return fRectangleTextureSupport; }
 
@@ -413,6 +419,8 @@ private:
     bool fMipMapLevelAndLodControlSupport : 1;
     bool fRGBAToBGRAReadbackConversionsAreSlow : 1;
     bool fDoManualMipmapping : 1;
+    bool fProgramBinarySupport : 1;
+    bool fParallelShaderCompileSupport : 1;
 
     BlitFramebufferSupport fBlitFramebufferSupport;
 
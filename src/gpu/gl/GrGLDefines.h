@@ -459,6 +459,10 @@
 #define GR_GL_MAX_FRAGMENT_UNIFORM_COMPONENTS          0x8B49
 #define GR_GL_MAX_VERTEX_UNIFORM_COMPONENTS            0x8B4A
 #define GR_GL_MAX_SHADER_PIXEL_LOCAL_STORAGE_FAST_SIZE 0x8F63
+#define GR_GL_PROGRAM_BINARY_RETRIEVABLE_HINT          0x8257
+#define GR_GL_PROGRAM_BINARY_LENGTH                    0x8741
+#define GR_GL_NUM_PROGRAM_BINARY_FORMATS               0x87FE
+#define GR_GL_COMPLETION_STATUS                        0x91B1
 
 /* StencilFunction */
 #define GR_GL_NEVER                          0x0200
@@ -740,6 +744,14 @@
 #define GR_GL_MAP_FLUSH_EXPLICIT_BIT             0x0010
 #define GR_GL_MAP_UNSYNCHRONIZED_BIT             0x0020
 
+/* Sync objects */
+#define GR_GL_SYNC_GPU_COMMANDS_COMPLETE         0x9117
+#define GR_GL_SYNC_FLUSH_COMMANDS_BIT            0x00000001
+#define GR_GL_ALREADY_SIGNALED                   0x911A
+#define GR_GL_TIMEOUT_EXPIRED                    0x911B
+#define GR_GL_CONDITION_SATISFIED                0x911C
+#define GR_GL_WAIT_FAILED                        0x911D
+
 /* Read Format */
 #define GR_GL_IMPLEMENTATION_COLOR_READ_TYPE   0x8B9A
 #define GR_GL_IMPLEMENTATION_COLOR_READ_FORMAT 0x8B9B
@@ -771,6 +783,7 @@
 #define GR_GL_ANY_SAMPLES_PASSED             0x8C2F
 #define GR_GL_TIME_ELAPSED                   0x88BF
 #define GR_GL_TIMESTAMP                      0x8E28
+#define GR_GL_GPU_DISJOINT                   0x8FBB
 #define GR_GL_PRIMITIVES_GENERATED           0x8C87
 #define GR_GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN 0x8C88
 
@@ -26,6 +26,7 @@
 #include "instanced/GLInstancedRendering.h"
 #include "SkMipMap.h"
 #include "SkPixmap.h"
+#include "SkSLCompiler.h"
 #include "SkStrokeRec.h"
 #include "SkTemplates.h"
 #include "SkTypes.h"
@@ -183,17 +184,20 @@ GrGpu* GrGLGpu::Create(GrBackendContext backendContext, const GrContextOptions&
     }
     GrGLContext* glContext = GrGLContext::Create(glInterface, options);
     if (glContext) {
-        return new GrGLGpu(glContext, context);
+        return new GrGLGpu(glContext, context, options);
     }
     return nullptr;
 }
 
 static bool gPrintStartupSpew;
 
-GrGLGpu::GrGLGpu(GrGLContext* ctx, GrContext* context)
+GrGLGpu::GrGLGpu(GrGLContext* ctx, GrContext* context, const GrContextOptions& options)
     : GrGpu(context)
     , fGLContext(ctx)
     , fProgramCache(new ProgramCache(this))
+    , fProgramBinaryCache(nullptr)
+    , fParallelShaderCompile(false)
+    , fShaderCompiler(nullptr)
     , fHWProgramID(0)
     , fTempSrcFBOID(0)
     , fTempDstFBOID(0)
@@ -239,6 +243,33 @@ GrGLGpu::GrGLGpu(GrGLContext* ctx, GrContext* context)
         fPathRendering.reset(new GrGLPathRendering(this));
     }
 
+    if (options.fPersistentCache && this->glCaps().programBinarySupport()) {
+        // Binaries are only good for the exact driver that made them.
+        const GrGLubyte* vendor;
+        const GrGLubyte* renderer;
+        const GrGLubyte* version;
+        GL_CALL_RET(vendor, GetString(GR_GL_VENDOR));
+        GL_CALL_RET(renderer, GetString(GR_GL_RENDERER));
+        GL_CALL_RET(version, GetString(GR_GL_VERSION));
+        auto str = [](const GrGLubyte* s) { return s ? (const char*)s : ""; };
+        fProgramBinaryDriverID.printf("%s\n%s\n%s", str(vendor), str(renderer), str(version));
+        fProgramBinaryCache = options.fPersistentCache;
+    }
+
+    if (options.fParallelShaderCompile && this->glCaps().parallelShaderCompileSupport()) {
+        // 0xFFFFFFFF lets the driver pick how many threads to use.
+        GL_CALL(MaxShaderCompilerThreads(0xFFFFFFFF));
+        fParallelShaderCompile = true;
+    }
+
+    // SkSL only generates GLSL with 'in' / 'out' variables.
+    GrGLSLGeneration minSkSLGeneration = kGLES_GrGLStandard == this->glStandard()
+                                                 ? k330_GrGLSLGeneration
+                                                 : k140_GrGLSLGeneration;
+    if (options.fCompileGLShadersWithSkSL && this->glslGeneration() >= minSkSLGeneration) {
+        fShaderCompiler = new SkSL::Compiler();
+    }
+
     GrGLClearErr(this->glInterface());
     if (gPrintStartupSpew) {
         const GrGLubyte* vendor;
@@ -267,6 +298,7 @@ GrGLGpu::~GrGLGpu() {
     fMipmapProgramArrayBuffer.reset();
     fWireRectArrayBuffer.reset();
     fPLSSetupProgram.fArrayBuffer.reset();
+    delete fShaderCompiler;
 
     if (0 != fHWProgramID) {
         // detach the current program so there is no confusion on OpenGL's part
@@ -934,8 +966,9 @@ bool GrGLGpu::onTransferPixels(GrSurface* surface,
     this->bindBuffer(kXferCpuToGpu_GrBufferType, glBuffer);
 
     bool success = false;
+    // With a buffer bound the pixel pointer is an offset into it.
     GrMipLevel mipLevel;
-    mipLevel.fPixels = transferBuffer;
+    mipLevel.fPixels = reinterpret_cast<const void*>(offset);
     mipLevel.fRowBytes = rowBytes;
     SkSTArray<1, GrMipLevel> texels;
     texels.push_back(mipLevel);
@@ -1217,6 +1250,10 @@ bool GrGLGpu::uploadTexData(const GrSurfaceDesc& desc,
         SkASSERT(texelsShallowCopy[currentMipLevel].fPixels || kTransfer_UploadType == uploadType);
     }
 
+    if (kTransfer_UploadType != uploadType) {
+        this->unbindCpuToGpuXferBuffer();
+    }
+
     const GrGLInterface* interface = this->glInterface();
     const GrGLCaps& caps = this->glCaps();
 
@@ -1401,6 +1438,8 @@ bool GrGLGpu::uploadCompressedTexData(const GrSurfaceDesc& desc,
     // No support for software flip y, yet...
     SkASSERT(kBottomLeft_GrSurfaceOrigin != desc.fOrigin);
 
+    this->unbindCpuToGpuXferBuffer();
+
     const GrGLInterface* interface = this->glInterface();
     const GrGLCaps& caps = this->glCaps();
 
@@ -1770,6 +1809,7 @@ int GrGLGpu::getCompatibleStencilIndex(GrPixelConfig config) {
         GrGLuint colorID = 0;
         GL_CALL(GenTextures(1, &colorID));
         this->setScratchTextureUnit();
+        this->unbindCpuToGpuXferBuffer();
         GL_CALL(BindTexture(GR_GL_TEXTURE_2D, colorID));
         GL_CALL(TexParameteri(GR_GL_TEXTURE_2D,
                               GR_GL_TEXTURE_MAG_FILTER,
@@ -2014,6 +2054,10 @@ bool GrGLGpu::flushGLState(const GrPipeline& pipeline, const GrPrimitiveProcesso
         GrCapsDebugf(this->caps(), "Failed to create program!\n");
         return false;
     }
+    if (!program->finishLink()) {
+        GrCapsDebugf(this->caps(), "Failed to link program!\n");
+        return false;
+    }
 
     program->generateMipmaps(primProc, pipeline);
 
@@ -2240,6 +2284,50 @@ void GrGLGpu::clearStencilClip(const SkIRect& rect, bool insideClip, GrRenderTar
     fHWStencilSettings.invalidate();
 }
 
+void GrGLGpu::discard(GrRenderTarget* target) {
+    SkASSERT(target);
+    if (!this->caps()->discardRenderTargetSupport()) {
+        return;
+    }
+    this->handleDirtyContext();
+
+    GrGLRenderTarget* glRT = static_cast<GrGLRenderTarget*>(target);
+    this->flushRenderTarget(glRT, &SkIRect::EmptyIRect());
+
+    // The default framebuffer names its attachments differently than FBOs do.
+    const bool hasStencil = SkToBool(target->renderTargetPriv().getStencilAttachment());
+    GrGLenum attachments[2];
+    int attachmentCount = 0;
+    if (0 == glRT->renderFBOID()) {
+        attachments[attachmentCount++] = GR_GL_COLOR;
+        if (hasStencil) {
+            attachments[attachmentCount++] = GR_GL_STENCIL;
+        }
+    } else {
+        attachments[attachmentCount++] = GR_GL_COLOR_ATTACHMENT0;
+        if (hasStencil) {
+            attachments[attachmentCount++] = GR_GL_STENCIL_ATTACHMENT;
+        }
+    }
+
+    switch (this->glCaps().invalidateFBType()) {
+        case GrGLCaps::kNone_InvalidateFBType:
+            SkFAIL("Should never get here.");
+            break;
+        case GrGLCaps::kInvalidate_InvalidateFBType:
+            GL_CALL(InvalidateFramebuffer(GR_GL_FRAMEBUFFER, attachmentCount, attachments));
+            break;
+        case GrGLCaps::kDiscard_InvalidateFBType:
+            GL_CALL(DiscardFramebuffer(GR_GL_FRAMEBUFFER, attachmentCount, attachments));
+            break;
+    }
+
+    if (hasStencil) {
+        // Whatever clip was last drawn into the stencil is gone with it.
+        target->renderTargetPriv().getStencilAttachment()->invalidateLastClip();
+    }
+}
+
 static bool read_pixels_pays_for_y_flip(GrRenderTarget* renderTarget, const GrGLCaps& caps,
                                         int width, int height,  GrPixelConfig config,
                                         size_t rowBytes) {
@@ -2486,22 +2574,12 @@ bool GrGLGpu::onReadPixels(GrSurface* surface,
     }
     bool flipY = kBottomLeft_GrSurfaceOrigin == surface->origin();
 
-    // resolve the render target if necessary
-    switch (renderTarget->getResolveType()) {
-        case GrGLRenderTarget::kCantResolve_ResolveType:
-            return false;
-        case GrGLRenderTarget::kAutoResolves_ResolveType:
-            this->flushRenderTarget(renderTarget, &SkIRect::EmptyIRect());
-            break;
-        case GrGLRenderTarget::kCanResolve_ResolveType:
-            this->onResolveRenderTarget(renderTarget);
-            // we don't track the state of the READ FBO ID.
-            fStats.incRenderTargetBinds();
-            GL_CALL(BindFramebuffer(GR_GL_READ_FRAMEBUFFER, renderTarget->textureFBOID()));
-            break;
-        default:
-            SkFAIL("Unknown resolve type");
+    if (!this->bindRenderTargetForRead(renderTarget)) {
+        return false;
     }
+    // Reads into client memory must not have a transfer buffer bound, or GL writes the pixels
+    // into it instead.
+    this->unbindGpuToCpuXferBuffer();
 
     const GrGLIRect& glvp = renderTarget->getViewport();
 
@@ -2588,6 +2666,174 @@ bool GrGLGpu::onReadPixels(GrSurface* surface,
     return true;
 }
 
+bool GrGLGpu::bindRenderTargetForRead(GrGLRenderTarget* renderTarget) {
+    // resolve the render target if necessary
+    switch (renderTarget->getResolveType()) {
+        case GrGLRenderTarget::kCantResolve_ResolveType:
+            return false;
+        case GrGLRenderTarget::kAutoResolves_ResolveType:
+            this->flushRenderTarget(renderTarget, &SkIRect::EmptyIRect());
+            break;
+        case GrGLRenderTarget::kCanResolve_ResolveType:
+            this->onResolveRenderTarget(renderTarget);
+            // we don't track the state of the READ FBO ID.
+            fStats.incRenderTargetBinds();
+            GL_CALL(BindFramebuffer(GR_GL_READ_FRAMEBUFFER, renderTarget->textureFBOID()));
+            break;
+        default:
+            SkFAIL("Unknown resolve type");
+    }
+    return true;
+}
+
+bool GrGLGpu::onReadPixelsToBuffer(GrSurface* surface,
+                                   int left, int top, int width, int height,
+                                   GrPixelConfig config, GrBuffer* transferBuffer,
+                                   size_t offset, size_t rowBytes) {
+    SkASSERT(surface);
+
+    // The pack buffer is written by the GPU, so there's no chance to flip or repack rows the way
+    // onReadPixels does. Callers draw to a top-left temporary first when the surface needs it.
+    GrGLRenderTarget* renderTarget = static_cast<GrGLRenderTarget*>(surface->asRenderTarget());
+    if (!renderTarget || kTopLeft_GrSurfaceOrigin != surface->origin()) {
+        return false;
+    }
+    if (GrGLCaps::kPBO_TransferBufferType != this->glCaps().transferBufferType()) {
+        return false;
+    }
+
+    // OpenGL doesn't do sRGB <-> linear conversions when reading and writing pixels.
+    if (requires_srgb_conversion(surface->config(), config) ||
+        !this->readPixelsSupported(renderTarget, config)) {
+        return false;
+    }
+
+    GrGLenum externalFormat;
+    GrGLenum externalType;
+    if (!this->glCaps().getReadPixelsFormat(renderTarget->config(), config, &externalFormat,
+                                            &externalType)) {
+        return false;
+    }
+
+    size_t bytesPerPixel = GrBytesPerPixel(config);
+    size_t tightRowBytes = bytesPerPixel * width;
+    if (!rowBytes) {
+        rowBytes = tightRowBytes;
+    }
+    if (rowBytes != tightRowBytes &&
+        (!this->glCaps().packRowLengthSupport() || rowBytes % bytesPerPixel)) {
+        return false;
+    }
+    if (offset + rowBytes * (height - 1) + tightRowBytes > transferBuffer->gpuMemorySize()) {
+        return false;
+    }
+
+    if (!this->bindRenderTargetForRead(renderTarget)) {
+        return false;
+    }
+
+    SkASSERT(!transferBuffer->isMapped());
+    SkASSERT(!transferBuffer->isCPUBacked());
+    const GrGLBuffer* glBuffer = static_cast<const GrGLBuffer*>(transferBuffer);
+    this->bindBuffer(kXferGpuToCpu_GrBufferType, glBuffer);
+
+    // the read rect is viewport-relative
+    GrGLIRect readRect;
+    readRect.setRelativeTo(renderTarget->getViewport(), left, top, width, height,
+                           renderTarget->origin());
+
+    if (rowBytes != tightRowBytes) {
+        GL_CALL(PixelStorei(GR_GL_PACK_ROW_LENGTH,
+                            static_cast<GrGLint>(rowBytes / bytesPerPixel)));
+    }
+    GL_CALL(PixelStorei(GR_GL_PACK_ALIGNMENT, config_alignment(config)));
+
+    // With a buffer bound the pixel pointer is an offset into it.
+    GL_CALL(ReadPixels(readRect.fLeft, readRect.fBottom,
+                       readRect.fWidth, readRect.fHeight,
+                       externalFormat, externalType, reinterpret_cast<void*>(offset)));
+    if (rowBytes != tightRowBytes) {
+        GL_CALL(PixelStorei(GR_GL_PACK_ROW_LENGTH, 0));
+    }
+    return true;
+}
+
+GrFence GrGLGpu::insertFence() {
+    if (!this->caps()->fenceSyncSupport()) {
+        return 0;
+    }
+    GrGLsync sync;
+    GL_CALL_RET(sync, FenceSync(GR_GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+    GR_STATIC_ASSERT(sizeof(GrGLsync) <= sizeof(GrFence));
+    return (GrFence)(uintptr_t)sync;
+}
+
+bool GrGLGpu::waitFence(GrFence fence, uint64_t timeout) {
+    SkASSERT(fence);
+    GrGLenum result;
+    // Flushing makes sure the fence reaches the GPU, or a zero timeout could poll forever.
+    GL_CALL_RET(result, ClientWaitSync((GrGLsync)(uintptr_t)fence, GR_GL_SYNC_FLUSH_COMMANDS_BIT,
+                                       timeout));
+    return GR_GL_ALREADY_SIGNALED == result || GR_GL_CONDITION_SATISFIED == result;
+}
+
+void GrGLGpu::deleteFence(GrFence fence) {
+    SkASSERT(fence);
+    GL_CALL(DeleteSync((GrGLsync)(uintptr_t)fence));
+}
+
+GrTimerQuery GrGLGpu::createTimerQuery() {
+    if (!this->caps()->timerQuerySupport()) {
+        return 0;
+    }
+    GrGLuint id = 0;
+    GL_CALL(GenQueries(1, &id));
+    return id;
+}
+
+void GrGLGpu::beginTimerQuery(GrTimerQuery query) {
+    SkASSERT(query);
+    GL_CALL(BeginQuery(GR_GL_TIME_ELAPSED, (GrGLuint)query));
+}
+
+void GrGLGpu::endTimerQuery(GrTimerQuery query) {
+    SkASSERT(query);
+    GL_CALL(EndQuery(GR_GL_TIME_ELAPSED));
+}
+
+bool GrGLGpu::timerQueryResult(GrTimerQuery query, bool wait, uint64_t* nanoseconds) {
+    SkASSERT(query);
+    GrGLuint id = (GrGLuint)query;
+    if (!wait) {
+        GrGLuint available = 0;
+        GL_CALL(GetQueryObjectuiv(id, GR_GL_QUERY_RESULT_AVAILABLE, &available));
+        if (!available) {
+            return false;
+        }
+    }
+    // Reading the result blocks until it's available.
+    GrGLuint64 result = 0;
+    GL_CALL(GetQueryObjectui64v(id, GR_GL_QUERY_RESULT, &result));
+    *nanoseconds = result;
+    return true;
+}
+
+bool GrGLGpu::timerQueriesDisjoint() {
+    // Only EXT_disjoint_timer_query reports disruptions. Desktop timer queries have no such flag.
+    if (kGLES_GrGLStandard != this->glStandard()) {
+        return false;
+    }
+    GrGLint disjoint = 0;
+    GL_CALL(GetIntegerv(GR_GL_GPU_DISJOINT, &disjoint));
+    return SkToBool(disjoint);
+}
+
+void GrGLGpu::deleteTimerQuery(GrTimerQuery query) {
+    SkASSERT(query);
+    GrGLuint id = (GrGLuint)query;
+    GL_CALL(DeleteQueries(1, &id));
+}
+
 GrGpuCommandBuffer* GrGLGpu::createCommandBuffer(
         GrRenderTarget* target,
         const GrGpuCommandBuffer::LoadAndStoreInfo& colorInfo,
@@ -3400,6 +3646,32 @@ void GrGLGpu::setScratchTextureUnit() {
     fHWBoundTextureUniqueIDs[lastUnitIdx] = SK_InvalidUniqueID;
 }
 
+void GrGLGpu::unbindGpuToCpuXferBuffer() {
+    // Don't bother unbinding if we've never used a transfer buffer.
+    if (!this->glCaps().transferBufferSupport()) {
+        return;
+    }
+    auto& xferBufferState = fHWBufferState[kXferGpuToCpu_GrBufferType];
+    if (!xferBufferState.fBufferZeroKnownBound) {
+        GL_CALL(BindBuffer(xferBufferState.fGLTarget, 0));
+        xferBufferState.fBoundBufferUniqueID = SK_InvalidUniqueID;
+        xferBufferState.fBufferZeroKnownBound = true;
+    }
+}
+
+void GrGLGpu::unbindCpuToGpuXferBuffer() {
+    // Don't bother unbinding if we've never used a transfer buffer.
+    if (!this->glCaps().transferBufferSupport()) {
+        return;
+    }
+    auto& xferBufferState = fHWBufferState[kXferCpuToGpu_GrBufferType];
+    if (!xferBufferState.fBufferZeroKnownBound) {
+        GL_CALL(BindBuffer(xferBufferState.fGLTarget, 0));
+        xferBufferState.fBoundBufferUniqueID = SK_InvalidUniqueID;
+        xferBufferState.fBufferZeroKnownBound = true;
+    }
+}
+
 // Determines whether glBlitFramebuffer could be used between src and dst.
 static inline bool can_blit_framebuffer(const GrSurface* dst,
                                         const GrSurface* src,
@@ -8,6 +8,7 @@
 #ifndef GrGLGpu_DEFINED
 #define GrGLGpu_DEFINED
 
+#include "GrContextOptions.h"
 #include "GrGLContext.h"
 #include "GrGLIRect.h"
 #include "GrGLPathRendering.h"
@@ -30,6 +31,8 @@ class GrSwizzle;
 
 namespace gr_instanced { class GLInstancedRendering; }
 
+namespace SkSL { class Compiler; }
+
 #ifdef SK_DEBUG
 #define PROGRAM_CACHE_STATS
 #endif
@@ -51,6 +54,15 @@ public:
     GrGLSLGeneration glslGeneration() const { return fGLContext->glslGeneration(); }
     const GrGLCaps& glCaps() const { return *fGLContext->caps(); }
 
+    // The client's cache for program binaries, or null if there isn't one or we can't use it.
+    GrContextOptions::PersistentCache* programBinaryCache() const { return fProgramBinaryCache; }
+    // Identifies the driver that made the binaries in programBinaryCache(), for keying them.
+    const SkString& programBinaryDriverID() const { return fProgramBinaryDriverID; }
+    // Whether the driver compiles our shaders on its own threads.
+    bool parallelShaderCompile() const { return fParallelShaderCompile; }
+    // Compiles our vertex and fragment shaders before the driver does, or null if we don't.
+    SkSL::Compiler* shaderCompiler() const { return fShaderCompiler; }
+
     GrGLPathRendering* glPathRendering() {
         SkASSERT(glCaps().shaderCaps()->pathRenderingSupport());
         return static_cast<GrGLPathRendering*>(pathRendering());
@@ -115,6 +127,12 @@ public:
     // function on GrGLGpuCommandBuffer.
     void clearStencilClip(const SkIRect& rect, bool insideClip, GrRenderTarget* renderTarget);
 
+    // The GrGLGpuCommandBuffer does not buffer up draws before submitting them to the gpu.
+    // Thus this is the implementation of the discard call for the corresponding passthrough
+    // function on GrGLGpuCommandBuffer. Invalidates the color and stencil contents so tiled GPUs
+    // needn't load them back in.
+    void discard(GrRenderTarget* renderTarget);
+
     const GrGLContext* glContextForTesting() const override {
         return &this->glContext();
     }
@@ -146,8 +164,21 @@ public:
 
     void finishDrawTarget() override;
 
+    GrFence SK_WARN_UNUSED_RESULT insertFence() override;
+    bool waitFence(GrFence, uint64_t timeout) override;
+    void deleteFence(GrFence) override;
+
+    GrTimerQuery SK_WARN_UNUSED_RESULT createTimerQuery() override;
+    bool timerQueryResult(GrTimerQuery, bool wait, uint64_t* nanoseconds) override;
+    bool timerQueriesDisjoint() override;
+    void deleteTimerQuery(GrTimerQuery) override;
+
+    // Called by GrGLGpuCommandBuffer.
+    void beginTimerQuery(GrTimerQuery);
+    void endTimerQuery(GrTimerQuery);
+
 private:
-    GrGLGpu(GrGLContext* ctx, GrContext* context);
+    GrGLGpu(GrGLContext* ctx, GrContext* context, const GrContextOptions&);
 
     // GrGpu overrides
     void onResetContext(uint32_t resetBits) override;
@@ -213,6 +244,15 @@ private:
                           GrPixelConfig config, GrBuffer* transferBuffer,
                           size_t offset, size_t rowBytes) override;
 
+    bool onReadPixelsToBuffer(GrSurface*,
+                              int left, int top, int width, int height,
+                              GrPixelConfig config, GrBuffer* transferBuffer,
+                              size_t offset, size_t rowBytes) override;
+
+    // Resolves a render target if needed and binds whatever framebuffer should be read from.
+    // Returns false if the render target can't be read.
+    bool bindRenderTargetForRead(GrGLRenderTarget*);
+
     void onResolveRenderTarget(GrRenderTarget* target) override;
 
     bool onCopySurface(GrSurface* dst,
@@ -323,6 +363,12 @@ private:
     // ensures that such operations don't negatively interact with tracking bound textures.
     void setScratchTextureUnit();
 
+    // Texture uploads from client memory must not have a transfer buffer bound, or GL reads the
+    // pixels from it instead.
+    void unbindCpuToGpuXferBuffer();
+    // Likewise, reads into client memory must not have a pack buffer bound.
+    void unbindGpuToCpuXferBuffer();
+
     // bounds is region that may be modified.
     // nullptr means whole target. Can be an empty rect.
     void flushRenderTarget(GrGLRenderTarget*, const SkIRect* bounds, bool disableSRGB = false);
@@ -391,6 +437,10 @@ private:
 
     // GL program-related state
     ProgramCache*               fProgramCache;
+    GrContextOptions::PersistentCache* fProgramBinaryCache;
+    SkString                    fProgramBinaryDriverID;
+    bool                        fParallelShaderCompile;
+    SkSL::Compiler*             fShaderCompiler;
 
     ///////////////////////////////////////////////////////////////////////////
     ///@name Caching of GL State
@@ -25,7 +25,11 @@ public:
 
     void end() override {}
 
-    void discard(GrRenderTarget* rt) override {}
+    void discard(GrRenderTarget* rt) override { fGpu->discard(rt); }
+
+    void beginTimerQuery(GrTimerQuery query) override { fGpu->beginTimerQuery(query); }
+
+    void endTimerQuery(GrTimerQuery query) override { fGpu->endTimerQuery(query); }
 
 private:
     GrGpu* gpu() override { return fGpu; }
@@ -311,6 +311,33 @@ bool GrGLInterface::validate() const {
         }
     }
 
+    // Sync objects are part of desktop 3.2 and ES 3.0. There are also ARB and APPLE extensions.
+    if ((kGL_GrGLStandard == fStandard &&
+         (glVer >= GR_GL_VER(3,2) || fExtensions.has("GL_ARB_sync"))) ||
+        (kGLES_GrGLStandard == fStandard &&
+         (glVer >= GR_GL_VER(3,0) || fExtensions.has("GL_APPLE_sync")))) {
+        if (nullptr == fFunctions.fFenceSync ||
+            nullptr == fFunctions.fClientWaitSync ||
+            nullptr == fFunctions.fDeleteSync) {
+            RETURN_FALSE_INTERFACE
+        }
+    }
+
+    if (kGLES_GrGLStandard == fStandard && fExtensions.has("GL_EXT_disjoint_timer_query")) {
+        if (nullptr == fFunctions.fGenQueries ||
+            nullptr == fFunctions.fDeleteQueries ||
+            nullptr == fFunctions.fBeginQuery ||
+            nullptr == fFunctions.fEndQuery ||
+            nullptr == fFunctions.fQueryCounter ||
+            nullptr == fFunctions.fGetQueryiv ||
+            nullptr == fFunctions.fGetQueryObjectiv ||
+            nullptr == fFunctions.fGetQueryObjectuiv ||
+            nullptr == fFunctions.fGetQueryObjecti64v ||
+            nullptr == fFunctions.fGetQueryObjectui64v) {
+            RETURN_FALSE_INTERFACE
+        }
+    }
+
     if (fExtensions.has("GL_KHR_blend_equation_advanced") ||
         fExtensions.has("GL_NV_blend_equation_advanced")) {
         if (nullptr == fFunctions.fBlendBarrier) {
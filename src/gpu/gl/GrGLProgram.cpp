@@ -35,7 +35,8 @@ GrGLProgram::GrGLProgram(GrGLGpu* gpu,
                          const VaryingInfoArray& pathProcVaryings,
                          GrGLSLPrimitiveProcessor* geometryProcessor,
                          GrGLSLXferProcessor* xferProcessor,
-                         const GrGLSLFragProcs& fragmentProcessors)
+                         const GrGLSLFragProcs& fragmentProcessors,
+                         bool linkPending)
     : fBuiltinUniformHandles(builtinUniforms)
     , fProgramID(programID)
     , fGeometryProcessor(geometryProcessor)
@@ -43,7 +44,19 @@ GrGLProgram::GrGLProgram(GrGLGpu* gpu,
     , fFragmentProcessors(fragmentProcessors)
     , fDesc(desc)
     , fGpu(gpu)
-    , fProgramDataManager(gpu, programID, uniforms, pathProcVaryings) {
+    , fProgramDataManager(gpu, programID, uniforms, pathProcVaryings)
+    , fLinkPending(linkPending)
+    , fLinked(!linkPending) {
+    if (fLinkPending) {
+        // Using the program now would wait for the link.
+        if (!gpu->glCaps().bindUniformLocationSupport()) {
+            for (int i = 0; i < uniforms.count(); ++i) {
+                fPendingUniforms.push_back(uniforms[i]);
+            }
+        }
+        fPendingSamplers = samplers;
+        return;
+    }
     // Assign texture units to sampler uniforms one time up front.
     GL_CALL(UseProgram(fProgramID));
     fProgramDataManager.setSamplers(samplers);
@@ -62,6 +75,41 @@ void GrGLProgram::abandon() {
     fProgramID = 0;
 }
 
+bool GrGLProgram::finishLink() {
+    if (!fLinkPending) {
+        return fLinked;
+    }
+    fLinkPending = false;
+
+    // Polling doesn't wait, so we can count the times the link wasn't done before we needed it.
+    GrGLint complete = GR_GL_TRUE;
+    GL_CALL(GetProgramiv(fProgramID, GR_GL_COMPLETION_STATUS, &complete));
+    if (!complete) {
+        fGpu->stats()->incProgramLinkWaits();
+    }
+
+    fLinked = GrGLProgramBuilder::CheckLinkStatus(fGpu, fProgramID);
+    if (fLinked) {
+        if (!fGpu->glCaps().bindUniformLocationSupport()) {
+            for (UniformInfo& uniform : fPendingUniforms) {
+                GL_CALL_RET(uniform.fLocation,
+                            GetUniformLocation(fProgramID, uniform.fVariable.c_str()));
+            }
+            fProgramDataManager.setUniformLocations(fPendingUniforms);
+            for (GrGLSampler& sampler : fPendingSamplers) {
+                GL_CALL_RET(sampler.fLocation,
+                            GetUniformLocation(fProgramID, sampler.fShaderVar.c_str()));
+            }
+        }
+        // Assign texture units to sampler uniforms one time, now that we can.
+        GL_CALL(UseProgram(fProgramID));
+        fProgramDataManager.setSamplers(fPendingSamplers);
+    }
+    fPendingUniforms.reset();
+    fPendingSamplers.reset();
+    return fLinked;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void GrGLProgram::setData(const GrPrimitiveProcessor& primProc, const GrPipeline& pipeline) {
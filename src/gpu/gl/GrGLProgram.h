@@ -52,6 +52,13 @@ public:
      */
     GrGLuint programID() const { return fProgramID; }
 
+    /**
+     * With parallel shader compilation, the builder may hand over a program whose link is still
+     * running in the driver.  This must be called before the program is first used.  It checks
+     * the link, waiting for it if it hasn't finished, and returns false if it failed.
+     */
+    bool finishLink();
+
     /**
      * We use the RT's size and origin to adjust from Skia device space to OpenGL normalized device
      * space and to make device space positions have the correct origin for processors that require
@@ -104,6 +111,7 @@ public:
 
 protected:
     typedef GrGLSLProgramDataManager::UniformHandle UniformHandle;
+    typedef GrGLProgramDataManager::UniformInfo UniformInfo;
     typedef GrGLProgramDataManager::UniformInfoArray UniformInfoArray;
     typedef GrGLProgramDataManager::VaryingInfoArray VaryingInfoArray;
 
@@ -116,7 +124,8 @@ protected:
                 const VaryingInfoArray&, // used for NVPR only currently
                 GrGLSLPrimitiveProcessor* geometryProcessor,
                 GrGLSLXferProcessor* xferProcessor,
-                const GrGLSLFragProcs& fragmentProcessors);
+                const GrGLSLFragProcs& fragmentProcessors,
+                bool linkPending);
 
     // A helper to loop over effects, set the transforms (via subclass) and bind textures
     void setFragmentData(const GrPrimitiveProcessor&, const GrPipeline&, int* nextSamplerIdx);
@@ -145,6 +154,13 @@ protected:
     GrGLGpu* fGpu;
     GrGLProgramDataManager fProgramDataManager;
 
+    // Until finishLink() checks the link, the samplers wait here to be assigned texture units.
+    // Without bound uniform locations, the uniforms wait here to be looked up too.
+    bool fLinkPending;
+    bool fLinked;
+    SkTArray<UniformInfo> fPendingUniforms;
+    SkTArray<GrGLSampler> fPendingSamplers;
+
     friend class GrGLProgramBuilder;
 
     typedef SkRefCnt INHERITED;
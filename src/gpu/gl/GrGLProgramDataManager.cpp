@@ -14,6 +14,29 @@
          SkASSERT((COUNT) <= (UNI).fArrayCount || \
                   (1 == (COUNT) && GrGLSLShaderVar::kNonArray == (UNI).fArrayCount))
 
+// The number of 32-bit words in one element of a uniform of the given type, or 0 for types we
+// don't upload through the setters below.
+static int uniform_word_count(GrSLType type) {
+    switch (type) {
+        case kFloat_GrSLType:
+        case kInt_GrSLType:
+            return 1;
+        case kVec2f_GrSLType:
+            return 2;
+        case kVec3f_GrSLType:
+            return 3;
+        case kVec4f_GrSLType:
+        case kMat22f_GrSLType:
+            return 4;
+        case kMat33f_GrSLType:
+            return 9;
+        case kMat44f_GrSLType:
+            return 16;
+        default:
+            return 0;
+    }
+}
+
 GrGLProgramDataManager::GrGLProgramDataManager(GrGLGpu* gpu, GrGLuint programID,
                                                const UniformInfoArray& uniforms,
                                                const VaryingInfoArray& pathProcVaryings)
@@ -42,6 +65,15 @@ GrGLProgramDataManager::GrGLProgramDataManager(GrGLGpu* gpu, GrGLuint programID,
         } else {
             uniform.fFSLocation = kUnusedUniform;
         }
+
+        int wordCount = uniform_word_count(builderUniform.fVariable.getType());
+        if (wordCount) {
+            wordCount *= SkTMax(builderUniform.fVariable.getArrayCount(), 1);
+            uniform.fValueOffset = fUniformValues.count();
+            fUniformValues.push_back_n(1 + wordCount, 0u);
+        } else {
+            uniform.fValueOffset = -1;
+        }
     }
 
     // NVPR programs have separable varyings
@@ -61,6 +93,18 @@ GrGLProgramDataManager::GrGLProgramDataManager(GrGLGpu* gpu, GrGLuint programID,
     }
 }
 
+void GrGLProgramDataManager::setUniformLocations(const SkTArray<UniformInfo>& uniforms) {
+    SkASSERT(uniforms.count() == fUniforms.count());
+    for (int i = 0; i < uniforms.count(); ++i) {
+        Uniform& uniform = fUniforms[i];
+        const UniformInfo& builderUniform = uniforms[i];
+        uniform.fVSLocation = (kVertex_GrShaderFlag & builderUniform.fVisibility)
+                                      ? builderUniform.fLocation : kUnusedUniform;
+        uniform.fFSLocation = (kFragment_GrShaderFlag & builderUniform.fVisibility)
+                                      ? builderUniform.fLocation : kUnusedUniform;
+    }
+}
+
 void GrGLProgramDataManager::setSamplers(const SkTArray<GrGLSampler>& samplers) const {
     for (int i = 0; i < samplers.count(); ++i) {
         GrGLint vsLocation;
@@ -94,6 +138,9 @@ void GrGLProgramDataManager::set1i(UniformHandle u, int32_t i) const {
     SkASSERT(uni.fType == kInt_GrSLType);
     SkASSERT(GrGLSLShaderVar::kNonArray == uni.fArrayCount);
     SkDEBUGCODE(this->printUnused(uni));
+    if (!this->valuesChanged(uni, &i, 1)) {
+        return;
+    }
     if (kUnusedUniform != uni.fFSLocation) {
         GR_GL_CALL(fGpu->glInterface(), Uniform1i(uni.fFSLocation, i));
     }
@@ -107,6 +154,9 @@ void GrGLProgramDataManager::set1f(UniformHandle u, float v0) const {
     SkASSERT(uni.fType == kFloat_GrSLType);
     SkASSERT(GrGLSLShaderVar::kNonArray == uni.fArrayCount);
     SkDEBUGCODE(this->printUnused(uni);)
+    if (!this->valuesChanged(uni, &v0, 1)) {
+        return;
+    }
     if (kUnusedUniform != uni.fFSLocation) {
         GR_GL_CALL(fGpu->glInterface(), Uniform1f(uni.fFSLocation, v0));
     }
@@ -126,6 +176,9 @@ void GrGLProgramDataManager::set1fv(UniformHandle u,
     // Once the uniform manager is responsible for inserting the duplicate uniform
     // arrays in VS and FS driver bug workaround, this can be enabled.
     // this->printUni(uni);
+    if (!this->valuesChanged(uni, v, arrayCount)) {
+        return;
+    }
     if (kUnusedUniform != uni.fFSLocation) {
         GR_GL_CALL(fGpu->glInterface(), Uniform1fv(uni.fFSLocation, arrayCount, v));
     }
@@ -139,6 +192,10 @@ void GrGLProgramDataManager::set2f(UniformHandle u, float v0, float v1) const {
     SkASSERT(uni.fType == kVec2f_GrSLType);
     SkASSERT(GrGLSLShaderVar::kNonArray == uni.fArrayCount);
     SkDEBUGCODE(this->printUnused(uni);)
+    const float v[] = { v0, v1 };
+    if (!this->valuesChanged(uni, v, 2)) {
+        return;
+    }
     if (kUnusedUniform != uni.fFSLocation) {
         GR_GL_CALL(fGpu->glInterface(), Uniform2f(uni.fFSLocation, v0, v1));
     }
@@ -155,6 +212,9 @@ void GrGLProgramDataManager::set2fv(UniformHandle u,
     SkASSERT(arrayCount > 0);
     ASSERT_ARRAY_UPLOAD_IN_BOUNDS(uni, arrayCount);
     SkDEBUGCODE(this->printUnused(uni);)
+    if (!this->valuesChanged(uni, v, 2 * arrayCount)) {
+        return;
+    }
     if (kUnusedUniform != uni.fFSLocation) {
         GR_GL_CALL(fGpu->glInterface(), Uniform2fv(uni.fFSLocation, arrayCount, v));
     }
@@ -168,6 +228,10 @@ void GrGLProgramDataManager::set3f(UniformHandle u, float v0, float v1, float v2
     SkASSERT(uni.fType == kVec3f_GrSLType);
     SkASSERT(GrGLSLShaderVar::kNonArray == uni.fArrayCount);
     SkDEBUGCODE(this->printUnused(uni);)
+    const float v[] = { v0, v1, v2 };
+    if (!this->valuesChanged(uni, v, 3)) {
+        return;
+    }
     if (kUnusedUniform != uni.fFSLocation) {
         GR_GL_CALL(fGpu->glInterface(), Uniform3f(uni.fFSLocation, v0, v1, v2));
     }
@@ -184,6 +248,9 @@ void GrGLProgramDataManager::set3fv(UniformHandle u,
     SkASSERT(arrayCount > 0);
     ASSERT_ARRAY_UPLOAD_IN_BOUNDS(uni, arrayCount);
     SkDEBUGCODE(this->printUnused(uni);)
+    if (!this->valuesChanged(uni, v, 3 * arrayCount)) {
+        return;
+    }
     if (kUnusedUniform != uni.fFSLocation) {
         GR_GL_CALL(fGpu->glInterface(), Uniform3fv(uni.fFSLocation, arrayCount, v));
     }
@@ -201,6 +268,10 @@ void GrGLProgramDataManager::set4f(UniformHandle u,
     SkASSERT(uni.fType == kVec4f_GrSLType);
     SkASSERT(GrGLSLShaderVar::kNonArray == uni.fArrayCount);
     SkDEBUGCODE(this->printUnused(uni);)
+    const float v[] = { v0, v1, v2, v3 };
+    if (!this->valuesChanged(uni, v, 4)) {
+        return;
+    }
     if (kUnusedUniform != uni.fFSLocation) {
         GR_GL_CALL(fGpu->glInterface(), Uniform4f(uni.fFSLocation, v0, v1, v2, v3));
     }
@@ -217,6 +288,9 @@ void GrGLProgramDataManager::set4fv(UniformHandle u,
     SkASSERT(arrayCount > 0);
     ASSERT_ARRAY_UPLOAD_IN_BOUNDS(uni, arrayCount);
     SkDEBUGCODE(this->printUnused(uni);)
+    if (!this->valuesChanged(uni, v, 4 * arrayCount)) {
+        return;
+    }
     if (kUnusedUniform != uni.fFSLocation) {
         GR_GL_CALL(fGpu->glInterface(), Uniform4fv(uni.fFSLocation, arrayCount, v));
     }
@@ -259,6 +333,9 @@ template<int N> inline void GrGLProgramDataManager::setMatrices(UniformHandle u,
     SkASSERT(arrayCount > 0);
     ASSERT_ARRAY_UPLOAD_IN_BOUNDS(uni, arrayCount);
     SkDEBUGCODE(this->printUnused(uni);)
+    if (!this->valuesChanged(uni, matrices, N * N * arrayCount)) {
+        return;
+    }
     if (kUnusedUniform != uni.fFSLocation) {
         set_uniform_matrix<N>::set(fGpu->glInterface(), uni.fFSLocation, arrayCount, matrices);
     }
@@ -301,6 +378,21 @@ void GrGLProgramDataManager::setPathFragmentInputTransform(VaryingHandle u,
                                                                   matrix);
 }
 
+bool GrGLProgramDataManager::valuesChanged(const Uniform& uni, const void* values,
+                                           int wordCount) const {
+    if (uni.fValueOffset < 0) {
+        return true;
+    }
+    uint32_t* cached = &fUniformValues[uni.fValueOffset];
+    const size_t bytes = wordCount * sizeof(uint32_t);
+    if (cached[0] && !memcmp(cached + 1, values, bytes)) {
+        return false;
+    }
+    cached[0] = 1;
+    memcpy(cached + 1, values, bytes);
+    return true;
+}
+
 #ifdef SK_DEBUG
 void GrGLProgramDataManager::printUnused(const Uniform& uni) const {
     if (kUnusedUniform == uni.fFSLocation && kUnusedUniform == uni.fVSLocation) {
@@ -50,6 +50,12 @@ public:
 
     void setSamplers(const SkTArray<GrGLSampler>& samplers) const;
 
+    /**
+     * A program whose link was still running when this was created can only look its uniforms up
+     * once the link is done.  It passes their locations in here, in the order they were created.
+     */
+    void setUniformLocations(const SkTArray<UniformInfo>& uniforms);
+
     /** Functions for uploading uniform values. The varities ending in v can be used to upload to an
     *  array of uniforms. arrayCount must be <= the array count of the uniform.
     */
@@ -83,6 +89,7 @@ private:
     struct Uniform {
         GrGLint     fVSLocation;
         GrGLint     fFSLocation;
+        int         fValueOffset;   // into fUniformValues, or -1 if uploads aren't tracked
         SkDEBUGCODE(
             GrSLType    fType;
             int         fArrayCount;
@@ -102,11 +109,19 @@ private:
 
     SkDEBUGCODE(void printUnused(const Uniform&) const;)
 
+    // Returns false if the wordCount 32-bit words at values are what was last uploaded to uni,
+    // so the upload can be skipped. Otherwise remembers them and returns true.
+    bool valuesChanged(const Uniform&, const void* values, int wordCount) const;
+
     template<int N> inline void setMatrices(UniformHandle, int arrayCount,
                                             const float matrices[]) const;
 
     SkTArray<Uniform, true> fUniforms;
     SkTArray<PathProcVarying, true> fPathProcVaryings;
+    // GL keeps uniform values with the program, so we shadow them here and skip uploads that
+    // wouldn't change anything. Each tracked uniform gets a word that is nonzero once it has been
+    // uploaded, followed by room for its values.
+    mutable SkTArray<uint32_t, true> fUniformValues;
     GrGLGpu* fGpu;
     GrGLuint fProgramID;
 
@@ -37,6 +37,7 @@ private:
     GrGLSLShaderVar fShaderVar;
     GrGLint         fLocation;
 
+    friend class GrGLProgram;
     friend class GrGLUniformHandler;
 
     typedef GrGLSLSampler INHERITED;
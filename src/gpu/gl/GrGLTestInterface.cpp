@@ -38,6 +38,7 @@ GrGLTestInterface::GrGLTestInterface() {
     fFunctions.fClear = bind_to_member(this, &GrGLTestInterface::clear);
     fFunctions.fClearColor = bind_to_member(this, &GrGLTestInterface::clearColor);
     fFunctions.fClearStencil = bind_to_member(this, &GrGLTestInterface::clearStencil);
+    fFunctions.fClientWaitSync = bind_to_member(this, &GrGLTestInterface::clientWaitSync);
     fFunctions.fColorMask = bind_to_member(this, &GrGLTestInterface::colorMask);
     fFunctions.fCompileShader = bind_to_member(this, &GrGLTestInterface::compileShader);
     fFunctions.fCompressedTexImage2D = bind_to_member(this, &GrGLTestInterface::compressedTexImage2D);
@@ -52,6 +53,7 @@ GrGLTestInterface::GrGLTestInterface() {
     fFunctions.fDeleteQueries = bind_to_member(this, &GrGLTestInterface::deleteQueries);
     fFunctions.fDeleteRenderbuffers = bind_to_member(this, &GrGLTestInterface::deleteRenderbuffers);
     fFunctions.fDeleteShader = bind_to_member(this, &GrGLTestInterface::deleteShader);
+    fFunctions.fDeleteSync = bind_to_member(this, &GrGLTestInterface::deleteSync);
     fFunctions.fDeleteTextures = bind_to_member(this, &GrGLTestInterface::deleteTextures);
     fFunctions.fDeleteVertexArrays = bind_to_member(this, &GrGLTestInterface::deleteVertexArrays);
     fFunctions.fDepthMask = bind_to_member(this, &GrGLTestInterface::depthMask);
@@ -68,6 +70,7 @@ GrGLTestInterface::GrGLTestInterface() {
     fFunctions.fEnable = bind_to_member(this, &GrGLTestInterface::enable);
     fFunctions.fEnableVertexAttribArray = bind_to_member(this, &GrGLTestInterface::enableVertexAttribArray);
     fFunctions.fEndQuery = bind_to_member(this, &GrGLTestInterface::endQuery);
+    fFunctions.fFenceSync = bind_to_member(this, &GrGLTestInterface::fenceSync);
     fFunctions.fFinish = bind_to_member(this, &GrGLTestInterface::finish);
     fFunctions.fFlush = bind_to_member(this, &GrGLTestInterface::flush);
     fFunctions.fFlushMappedBufferRange = bind_to_member(this, &GrGLTestInterface::flushMappedBufferRange);
@@ -89,6 +92,7 @@ GrGLTestInterface::GrGLTestInterface() {
     fFunctions.fGetMultisamplefv = bind_to_member(this, &GrGLTestInterface::getMultisamplefv);
     fFunctions.fGetProgramInfoLog = bind_to_member(this, &GrGLTestInterface::getProgramInfoLog);
     fFunctions.fGetProgramiv = bind_to_member(this, &GrGLTestInterface::getProgramiv);
+    fFunctions.fGetProgramBinary = bind_to_member(this, &GrGLTestInterface::getProgramBinary);
     fFunctions.fGetQueryiv = bind_to_member(this, &GrGLTestInterface::getQueryiv);
     fFunctions.fGetQueryObjecti64v = bind_to_member(this, &GrGLTestInterface::getQueryObjecti64v);
     fFunctions.fGetQueryObjectiv = bind_to_member(this, &GrGLTestInterface::getQueryObjectiv);
@@ -116,9 +120,12 @@ GrGLTestInterface::GrGLTestInterface() {
     fFunctions.fMapBufferRange = bind_to_member(this, &GrGLTestInterface::mapBufferRange);
     fFunctions.fMapBufferSubData = bind_to_member(this, &GrGLTestInterface::mapBufferSubData);
     fFunctions.fMapTexSubImage2D = bind_to_member(this, &GrGLTestInterface::mapTexSubImage2D);
+    fFunctions.fMaxShaderCompilerThreads = bind_to_member(this, &GrGLTestInterface::maxShaderCompilerThreads);
     fFunctions.fMinSampleShading = bind_to_member(this, &GrGLTestInterface::minSampleShading);
     fFunctions.fPixelStorei = bind_to_member(this, &GrGLTestInterface::pixelStorei);
     fFunctions.fPopGroupMarker = bind_to_member(this, &GrGLTestInterface::popGroupMarker);
+    fFunctions.fProgramBinary = bind_to_member(this, &GrGLTestInterface::programBinary);
+    fFunctions.fProgramParameteri = bind_to_member(this, &GrGLTestInterface::programParameteri);
     fFunctions.fPushGroupMarker = bind_to_member(this, &GrGLTestInterface::pushGroupMarker);
     fFunctions.fQueryCounter = bind_to_member(this, &GrGLTestInterface::queryCounter);
     fFunctions.fRasterSamples = bind_to_member(this, &GrGLTestInterface::rasterSamples);
@@ -12,7 +12,10 @@
 #include "GrGLProgramBuilder.h"
 #include "GrSwizzle.h"
 #include "GrTexture.h"
+#include "SkChecksum.h"
+#include "SkData.h"
 #include "SkRTConf.h"
+#include "SkSLCompiler.h"
 #include "SkTraceEvent.h"
 #include "gl/GrGLGpu.h"
 #include "gl/GrGLProgram.h"
@@ -72,18 +75,64 @@ const GrGLSLCaps* GrGLProgramBuilder::glslCaps() const {
     return fGpu->ctxInfo().caps()->glslCaps();
 }
 
+// The GLSL dialect of the context, which the GrGLGpu only makes a shader compiler for when SkSL
+// can generate it.
+static SkSL::GLCaps sksl_caps(const GrGLGpu* gpu) {
+    bool es = kGLES_GrGLStandard == gpu->glStandard();
+    int version;
+    switch (gpu->glslGeneration()) {
+        case k140_GrGLSLGeneration:   version = 140;            break;
+        case k150_GrGLSLGeneration:   version = 150;            break;
+        case k330_GrGLSLGeneration:   version = es ? 300 : 330; break;
+        case k400_GrGLSLGeneration:   version = 400;            break;
+        case k310es_GrGLSLGeneration: version = 310;            break;
+        case k320es_GrGLSLGeneration: version = 320;            break;
+        default:
+            SkFAIL("GLSL generation is too old for SkSL.");
+            version = 0;
+            break;
+    }
+    return { version, es ? SkSL::GLCaps::kGLES_Standard : SkSL::GLCaps::kGL_Standard };
+}
+
 bool GrGLProgramBuilder::compileAndAttachShaders(GrGLSLShaderBuilder& shader,
                                                  GrGLuint programId,
                                                  GrGLenum type,
                                                  SkTDArray<GrGLuint>* shaderIds) {
     GrGLGpu* gpu = this->gpu();
+    const char** strings = shader.fCompilerStrings.begin();
+    int* lengths = shader.fCompilerStringLengths.begin();
+    int count = shader.fCompilerStrings.count();
+
+    // Let SkSL optimize the shader if we can; anything it rejects goes to the driver as is.
+    std::string optimized;
+    const char* optimizedString;
+    int optimizedLength;
+    if (gpu->shaderCompiler() &&
+        (GR_GL_VERTEX_SHADER == type || GR_GL_FRAGMENT_SHADER == type)) {
+        std::string source;
+        for (int i = 0; i < count; ++i) {
+            source.append(strings[i], lengths[i]);
+        }
+        SkSL::Program::Kind kind = GR_GL_VERTEX_SHADER == type ? SkSL::Program::kVertex_Kind
+                                                               : SkSL::Program::kFragment_Kind;
+        if (gpu->shaderCompiler()->toGLSL(kind, source, sksl_caps(gpu), &optimized)) {
+            optimizedString = optimized.c_str();
+            strings = &optimizedString;
+            optimizedLength = (int) optimized.size();
+            lengths = &optimizedLength;
+            count = 1;
+        }
+    }
+
     GrGLuint shaderId = GrGLCompileAndAttachShader(gpu->glContext(),
                                                    programId,
                                                    type,
-                                                   shader.fCompilerStrings.begin(),
-                                                   shader.fCompilerStringLengths.begin(),
-                                                   shader.fCompilerStrings.count(),
-                                                   gpu->stats());
+                                                   strings,
+                                                   lengths,
+                                                   count,
+                                                   gpu->stats(),
+                                                   gpu->parallelShaderCompile());
 
     if (!shaderId) {
         return false;
@@ -105,6 +154,20 @@ GrGLProgram* GrGLProgramBuilder::finalize() {
 
     this->finalizeShaders();
 
+    // If the client keeps program binaries for us, we may not have to compile or link at all.
+    sk_sp<SkData> binaryKey;
+    uint32_t sourceHash = 0;
+    if (fGpu->programBinaryCache()) {
+        binaryKey = this->programBinaryKey();
+        sourceHash = this->shaderSourceHash();
+        // The binary remembers where things were bound, but we track some of that ourselves.
+        this->bindProgramResourceLocations(programID);
+        if (this->loadProgramBinary(programID, *binaryKey, sourceHash)) {
+            this->resolveProgramResourceLocations(programID);
+            return this->createProgram(programID);
+        }
+    }
+
     // compile shaders and bind attributes / uniforms
     SkTDArray<GrGLuint> shadersToDelete;
     if (!this->compileAndAttachShaders(fVS, programID, GR_GL_VERTEX_SHADER, &shadersToDelete)) {
@@ -130,23 +193,125 @@ GrGLProgram* GrGLProgramBuilder::finalize() {
 
     this->bindProgramResourceLocations(programID);
 
+    if (binaryKey && this->gpu()->glInterface()->fFunctions.fProgramParameteri) {
+        GL_CALL(ProgramParameteri(programID, GR_GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GR_GL_TRUE));
+    }
     GL_CALL(LinkProgram(programID));
 
+    // When the driver compiles and links in parallel, asking whether the link worked waits for it.
+    // Unless we need something out of the linked program right away, leave it running and let the
+    // program check it when it's first used.
+    if (fGpu->parallelShaderCompile() && !binaryKey && !this->needsLinkedProgramResources()) {
+        this->cleanupShaders(shadersToDelete);
+        return this->createProgram(programID, /*linkPending=*/true);
+    }
+
     // Calling GetProgramiv is expensive in Chromium. Assume success in release builds.
-    bool checkLinked = kChromium_GrGLDriver != fGpu->ctxInfo().driver();
+    // We must if the shaders' compiles weren't checked.
+    bool checkLinked = kChromium_GrGLDriver != fGpu->ctxInfo().driver() ||
+                       fGpu->parallelShaderCompile();
 #ifdef SK_DEBUG
     checkLinked = true;
 #endif
+    bool linked = true;
     if (checkLinked) {
-        checkLinkStatus(programID);
+        linked = CheckLinkStatus(fGpu, programID);
+        if (!linked) {
+            GL_CALL(DeleteProgram(programID));
+        }
     }
     this->resolveProgramResourceLocations(programID);
 
+    if (binaryKey && linked) {
+        this->storeProgramBinary(programID, *binaryKey, sourceHash);
+    }
+
     this->cleanupShaders(shadersToDelete);
 
     return this->createProgram(programID);
 }
 
+sk_sp<SkData> GrGLProgramBuilder::programBinaryKey() const {
+    const SkString& driverID = fGpu->programBinaryDriverID();
+    const GrProgramDesc& desc = this->desc();
+    // The driver ID's length comes first so no two IDs and descs can make the same key.
+    uint32_t driverIDLength = SkToU32(driverID.size());
+    sk_sp<SkData> key = SkData::MakeUninitialized(sizeof(driverIDLength) + driverIDLength +
+                                                  desc.keyLength());
+    char* dst = static_cast<char*>(key->writable_data());
+    memcpy(dst, &driverIDLength, sizeof(driverIDLength));
+    dst += sizeof(driverIDLength);
+    memcpy(dst, driverID.c_str(), driverIDLength);
+    dst += driverIDLength;
+    memcpy(dst, desc.asKey(), desc.keyLength());
+    return key;
+}
+
+uint32_t GrGLProgramBuilder::shaderSourceHash() const {
+    uint32_t hash = 0;
+    for (const GrGLSLShaderBuilder* shader : { (const GrGLSLShaderBuilder*)&fVS,
+                                               (const GrGLSLShaderBuilder*)&fFS }) {
+        for (int i = 0; i < shader->fCompilerStrings.count(); ++i) {
+            hash = SkChecksum::Murmur3(shader->fCompilerStrings[i],
+                                       shader->fCompilerStringLengths[i], hash);
+        }
+    }
+    return hash;
+}
+
+// What we store ahead of the driver's binary.
+struct ProgramBinaryHeader {
+    uint32_t fSourceHash;
+    GrGLenum fFormat;
+};
+
+bool GrGLProgramBuilder::loadProgramBinary(GrGLuint programID, const SkData& key,
+                                           uint32_t sourceHash) {
+    sk_sp<SkData> data = fGpu->programBinaryCache()->load(key);
+    if (!data || data->size() <= sizeof(ProgramBinaryHeader)) {
+        return false;
+    }
+    ProgramBinaryHeader header;
+    memcpy(&header, data->data(), sizeof(header));
+    if (header.fSourceHash != sourceHash) {
+        return false;
+    }
+
+    // Drivers are free to reject any binary, e.g. after an update that didn't change their
+    // version string, so we have to check.  Rejection may raise an error, which is fine.
+    GR_GL_CALL_NOERRCHECK(this->gpu()->glInterface(),
+                          ProgramBinary(programID, header.fFormat, data->bytes() + sizeof(header),
+                                        SkToInt(data->size() - sizeof(header))));
+    GrGLClearErr(this->gpu()->glInterface());
+    GrGLint linked = GR_GL_INIT_ZERO;
+    GL_CALL(GetProgramiv(programID, GR_GL_LINK_STATUS, &linked));
+    return SkToBool(linked);
+}
+
+void GrGLProgramBuilder::storeProgramBinary(GrGLuint programID, const SkData& key,
+                                            uint32_t sourceHash) {
+    GrGLint length = GR_GL_INIT_ZERO;
+    GL_CALL(GetProgramiv(programID, GR_GL_PROGRAM_BINARY_LENGTH, &length));
+    if (length <= 0) {
+        return;
+    }
+
+    SkAutoMalloc storage(sizeof(ProgramBinaryHeader) + length);
+    char* dst = static_cast<char*>(storage.get());
+    ProgramBinaryHeader header;
+    header.fSourceHash = sourceHash;
+    header.fFormat = 0;
+    GrGLsizei written = 0;
+    GL_CALL(GetProgramBinary(programID, length, &written, &header.fFormat,
+                             dst + sizeof(ProgramBinaryHeader)));
+    if (written <= 0) {
+        return;
+    }
+    memcpy(dst, &header, sizeof(header));
+    fGpu->programBinaryCache()->store(
+            key, *SkData::MakeWithoutCopy(dst, sizeof(ProgramBinaryHeader) + written));
+}
+
 void GrGLProgramBuilder::bindProgramResourceLocations(GrGLuint programID) {
     fUniformHandler.bindUniformLocations(programID, fGpu->glCaps());
 
@@ -173,30 +338,36 @@ void GrGLProgramBuilder::bindProgramResourceLocations(GrGLuint programID) {
     }
 }
 
-bool GrGLProgramBuilder::checkLinkStatus(GrGLuint programID) {
+bool GrGLProgramBuilder::CheckLinkStatus(GrGLGpu* gpu, GrGLuint programID) {
+    const GrGLInterface* gli = gpu->glInterface();
     GrGLint linked = GR_GL_INIT_ZERO;
-    GL_CALL(GetProgramiv(programID, GR_GL_LINK_STATUS, &linked));
+    GR_GL_CALL(gli, GetProgramiv(programID, GR_GL_LINK_STATUS, &linked));
     if (!linked) {
         GrGLint infoLen = GR_GL_INIT_ZERO;
-        GL_CALL(GetProgramiv(programID, GR_GL_INFO_LOG_LENGTH, &infoLen));
+        GR_GL_CALL(gli, GetProgramiv(programID, GR_GL_INFO_LOG_LENGTH, &infoLen));
         SkAutoMalloc log(sizeof(char)*(infoLen+1));  // outside if for debugger
         if (infoLen > 0) {
             // retrieve length even though we don't need it to workaround
             // bug in chrome cmd buffer param validation.
             GrGLsizei length = GR_GL_INIT_ZERO;
-            GL_CALL(GetProgramInfoLog(programID,
-                                      infoLen+1,
-                                      &length,
-                                      (char*)log.get()));
+            GR_GL_CALL(gli, GetProgramInfoLog(programID,
+                                              infoLen+1,
+                                              &length,
+                                              (char*)log.get()));
             SkDebugf("%s", (char*)log.get());
         }
         SkDEBUGFAIL("Error linking program");
-        GL_CALL(DeleteProgram(programID));
-        programID = 0;
     }
     return SkToBool(linked);
 }
 
+bool GrGLProgramBuilder::needsLinkedProgramResources() const {
+    // GrGLProgram looks up unbound uniform locations itself, but NVPR may have to look up its
+    // fragment inputs.  See resolveProgramResourceLocations().
+    return fGpu->glCaps().shaderCaps()->pathRenderingSupport() &&
+           !fGpu->glPathRendering()->shouldBindFragmentInputs();
+}
+
 void GrGLProgramBuilder::resolveProgramResourceLocations(GrGLuint programID) {
     fUniformHandler.getUniformLocations(programID, fGpu->glCaps());
 
@@ -227,7 +398,7 @@ void GrGLProgramBuilder::cleanupShaders(const SkTDArray<GrGLuint>& shaderIDs) {
     }
 }
 
-GrGLProgram* GrGLProgramBuilder::createProgram(GrGLuint programID) {
+GrGLProgram* GrGLProgramBuilder::createProgram(GrGLuint programID, bool linkPending) {
     return new GrGLProgram(fGpu,
                            this->desc(),
                            fUniformHandles,
@@ -237,5 +408,6 @@ GrGLProgram* GrGLProgramBuilder::createProgram(GrGLuint programID) {
                            fVaryingHandler.fPathProcVaryingInfos,
                            fGeometryProcessor,
                            fXferProcessor,
-                           fFragmentProcessors);
+                           fFragmentProcessors,
+                           linkPending);
 }
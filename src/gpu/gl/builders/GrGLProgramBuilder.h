@@ -40,6 +40,9 @@ public:
 
     GrGLGpu* gpu() const { return fGpu; }
 
+    // Returns whether the program linked, printing the driver's log if it didn't.
+    static bool CheckLinkStatus(GrGLGpu*, GrGLuint programID);
+
 private:
     GrGLProgramBuilder(GrGLGpu*, const GrPipeline&, const GrPrimitiveProcessor&,
                        const GrGLProgramDesc&);
@@ -50,13 +53,21 @@ private:
                                  SkTDArray<GrGLuint>* shaderIds);
     GrGLProgram* finalize();
     void bindProgramResourceLocations(GrGLuint programID);
-    bool checkLinkStatus(GrGLuint programID);
+    // Whether resolveProgramResourceLocations() has to query the linked program for anything the
+    // program can't look up for itself once the link is done.
+    bool needsLinkedProgramResources() const;
     void resolveProgramResourceLocations(GrGLuint programID);
+    // Program binaries are stored under the driver and program descriptor, and checked against a
+    // hash of the shader sources in case Skia has generated different code since.
+    sk_sp<SkData> programBinaryKey() const;
+    uint32_t shaderSourceHash() const;
+    bool loadProgramBinary(GrGLuint programID, const SkData& key, uint32_t sourceHash);
+    void storeProgramBinary(GrGLuint programID, const SkData& key, uint32_t sourceHash);
     void cleanupProgram(GrGLuint programID, const SkTDArray<GrGLuint>& shaderIDs);
     void cleanupShaders(const SkTDArray<GrGLuint>& shaderIDs);
 
     // Subclasses create different programs
-    GrGLProgram* createProgram(GrGLuint programID);
+    GrGLProgram* createProgram(GrGLuint programID, bool linkPending = false);
 
     GrGLSLUniformHandler* uniformHandler() override { return &fUniformHandler; }
     const GrGLSLUniformHandler* uniformHandler() const override { return &fUniformHandler; }
@@ -25,7 +25,8 @@ GrGLuint GrGLCompileAndAttachShader(const GrGLContext& glCtx,
                                     const char** strings,
                                     int* lengths,
                                     int count,
-                                    GrGpu::Stats* stats) {
+                                    GrGpu::Stats* stats,
+                                    bool deferCompileCheck) {
     const GrGLInterface* gli = glCtx.interface();
 
     GrGLuint shaderId;
@@ -56,7 +57,9 @@ GrGLuint GrGLCompileAndAttachShader(const GrGLContext& glCtx,
     GR_GL_CALL(gli, CompileShader(shaderId));
 
     // Calling GetShaderiv in Chromium is quite expensive. Assume success in release builds.
-    bool checkCompiled = kChromium_GrGLDriver != glCtx.driver();
+    // Asking would also wait out a compile the driver is doing in parallel; the caller will
+    // find out whether it worked when it checks the link.
+    bool checkCompiled = kChromium_GrGLDriver != glCtx.driver() && !deferCompileCheck;
 #ifdef SK_DEBUG
     checkCompiled = true;
 #endif
@@ -19,6 +19,7 @@ GrGLuint GrGLCompileAndAttachShader(const GrGLContext& glCtx,
                                     const char** strings,
                                     int* lengths,
                                     int count,
-                                    GrGpu::Stats*);
+                                    GrGpu::Stats*,
+                                    bool deferCompileCheck = false);
 
 #endif
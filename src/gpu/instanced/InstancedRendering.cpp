@@ -46,12 +46,7 @@ GrDrawBatch* InstancedRendering::recordRect(const SkRect& rect, const SkMatrix&
     }
     if (Batch* batch = this->recordShape(ShapeType::kRect, rect, viewMatrix, color, rect, antialias,
                                          info, useHWAA)) {
-        batch->getSingleInstance().fInfo |= kLocalMatrix_InfoFlag;
-        batch->appendParamsTexel(localMatrix.getScaleX(), localMatrix.getSkewX(),
-                                 localMatrix.getTranslateX());
-        batch->appendParamsTexel(localMatrix.getSkewY(), localMatrix.getScaleY(),
-                                 localMatrix.getTranslateY());
-        batch->fInfo.fHasLocalMatrix = true;
+        batch->appendLocalMatrixParams(localMatrix);
         return batch;
     }
     return nullptr;
@@ -75,6 +70,23 @@ GrDrawBatch* InstancedRendering::recordRRect(const SkRRect& rrect, const SkMatri
     return nullptr;
 }
 
+GrDrawBatch* InstancedRendering::recordRRect(const SkRRect& rrect, const SkMatrix& viewMatrix,
+                                             GrColor color, const SkMatrix& localMatrix,
+                                             bool antialias, const GrInstancedPipelineInfo& info,
+                                             bool* useHWAA) {
+    if (localMatrix.hasPerspective()) {
+        return nullptr; // Perspective is not yet supported in the local matrix.
+    }
+    if (Batch* batch = this->recordShape(GetRRectShapeType(rrect), rrect.rect(), viewMatrix, color,
+                                         rrect.rect(), antialias, info, useHWAA)) {
+        // The shader reads the local matrix after the shape's params.
+        batch->appendRRectParams(rrect);
+        batch->appendLocalMatrixParams(localMatrix);
+        return batch;
+    }
+    return nullptr;
+}
+
 GrDrawBatch* InstancedRendering::recordDRRect(const SkRRect& outer, const SkRRect& inner,
                                               const SkMatrix& viewMatrix, GrColor color,
                                               bool antialias, const GrInstancedPipelineInfo& info,
@@ -309,6 +321,17 @@ void InstancedRendering::Batch::appendRRectParams(const SkRRect& rrect) {
     }
 }
 
+void InstancedRendering::Batch::appendLocalMatrixParams(const SkMatrix& localMatrix) {
+    SkASSERT(!fIsTracked);
+    SkASSERT(!localMatrix.hasPerspective());
+    this->getSingleInstance().fInfo |= kLocalMatrix_InfoFlag;
+    this->appendParamsTexel(localMatrix.getScaleX(), localMatrix.getSkewX(),
+                            localMatrix.getTranslateX());
+    this->appendParamsTexel(localMatrix.getSkewY(), localMatrix.getScaleY(),
+                            localMatrix.getTranslateY());
+    fInfo.fHasLocalMatrix = true;
+}
+
 void InstancedRendering::Batch::appendParamsTexel(const SkScalar* vals, int count) {
     SkASSERT(!fIsTracked);
     SkASSERT(count <= 4 && count >= 0);
@@ -64,6 +64,10 @@ public:
                                                    bool antialias, const GrInstancedPipelineInfo&,
                                                    bool* useHWAA);
 
+    GrDrawBatch* SK_WARN_UNUSED_RESULT recordRRect(const SkRRect&, const SkMatrix&, GrColor,
+                                                   const SkMatrix& localMatrix, bool antialias,
+                                                   const GrInstancedPipelineInfo&, bool* useHWAA);
+
     GrDrawBatch* SK_WARN_UNUSED_RESULT recordDRRect(const SkRRect& outer, const SkRRect& inner,
                                                     const SkMatrix&, GrColor, bool antialias,
                                                     const GrInstancedPipelineInfo&, bool* useHWAA);
@@ -109,6 +113,7 @@ protected:
         Instance& getSingleInstance() const { return this->getSingleDraw().fInstance; }
 
         void appendRRectParams(const SkRRect&);
+        void appendLocalMatrixParams(const SkMatrix&);
         void appendParamsTexel(const SkScalar* vals, int count);
         void appendParamsTexel(SkScalar x, SkScalar y, SkScalar z, SkScalar w);
         void appendParamsTexel(SkScalar x, SkScalar y, SkScalar z);
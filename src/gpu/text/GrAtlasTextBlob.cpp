@@ -203,16 +203,7 @@ bool GrAtlasTextBlob::mustRegenerate(const SkPaint& paint,
         return true;
     }
 
-    // Mixed blobs must be regenerated.  We could probably figure out a way to do integer scrolls
-    // for mixed blobs if this becomes an issue.
-    if (this->hasBitmap() && this->hasDistanceField()) {
-        // Identical viewmatrices and we can reuse in all cases
-        if (fInitialViewMatrix.cheapEqualTo(viewMatrix) && x == fInitialX && y == fInitialY) {
-            return false;
-        }
-        return true;
-    }
-
+    // Mixed blobs check both ways below. Each subrun is translated on its own in regenInBatch.
     if (this->hasBitmap()) {
         if (fInitialViewMatrix.getScaleX() != viewMatrix.getScaleX() ||
             fInitialViewMatrix.getScaleY() != viewMatrix.getScaleY() ||
@@ -222,21 +213,14 @@ bool GrAtlasTextBlob::mustRegenerate(const SkPaint& paint,
         }
 
         // We can update the positions in the cachedtextblobs without regenerating the whole blob,
-        // but only for integer translations.
-        // This cool bit of math will determine the necessary translation to apply to the already
-        // generated vertex coordinates to move them to the correct position
-        SkScalar transX = viewMatrix.getTranslateX() +
-                          viewMatrix.getScaleX() * (x - fInitialX) +
-                          viewMatrix.getSkewX() * (y - fInitialY) -
-                          fInitialViewMatrix.getTranslateX();
-        SkScalar transY = viewMatrix.getTranslateY() +
-                          viewMatrix.getSkewY() * (x - fInitialX) +
-                          viewMatrix.getScaleY() * (y - fInitialY) -
-                          fInitialViewMatrix.getTranslateY();
-        if (!SkScalarIsInt(transX) || !SkScalarIsInt(transY)) {
+        // as long as the translation moves every glyph by the same whole number of pixels once
+        // they're snapped to their pixel or subpixel positions.
+        SkVector residual;
+        if (!this->snapBmpTranslation(viewMatrix, x, y, &residual)) {
             return true;
         }
-    } else if (this->hasDistanceField()) {
+    }
+    if (this->hasDistanceField()) {
         // A scale outside of [blob.fMaxMinScale, blob.fMinMaxScale] would result in a different
         // distance field being generated, so we have to regenerate in those cases
         SkScalar newMaxScale = viewMatrix.getMaxScale();
@@ -345,6 +329,60 @@ static void calculate_translation(bool applyVM,
 }
 
 
+// Room left for error in the float math that quantizes glyph positions.
+static const SkScalar kBmpSnapSlop = SK_Scalar1 / 256;
+
+static void update_snap_slack(SkScalar position, SkScalar rounding,
+                              SkScalar* slackDown, SkScalar* slackUp) {
+    // Positions are rounded to the nearest step: a whole pixel with a half pixel of rounding, or
+    // a subpixel bucket with half a bucket of rounding.
+    SkScalar step = 2 * rounding;
+    SkScalar steps = (position + rounding) / step;
+    SkScalar fraction = steps - SkScalarFloorToScalar(steps);
+    *slackDown = SkTMin(*slackDown, fraction * step);
+    *slackUp = SkTMin(*slackUp, (SK_Scalar1 - fraction) * step);
+}
+
+void GrAtlasTextBlob::updateBmpSnapSlack(const SkPoint& position, const SkPoint& rounding) {
+    update_snap_slack(position.fX, rounding.fX, &fBmpSnapSlackDown.fX, &fBmpSnapSlackUp.fX);
+    update_snap_slack(position.fY, rounding.fY, &fBmpSnapSlackDown.fY, &fBmpSnapSlackUp.fY);
+}
+
+static bool snap_translation(SkScalar trans, SkScalar slackDown, SkScalar slackUp,
+                             SkScalar* snapped) {
+    // A whole pixel translation moves every glyph by exactly that much.
+    SkScalar whole = SkScalarFloorToScalar(trans);
+    if (trans == whole) {
+        *snapped = whole;
+        return true;
+    }
+    // Otherwise the glyphs land where a neighboring whole pixel translation would put them, if
+    // the rest of the translation is within every glyph's slack.
+    if (trans - whole < slackUp - kBmpSnapSlop) {
+        *snapped = whole;
+        return true;
+    }
+    if (whole + SK_Scalar1 - trans < slackDown - kBmpSnapSlop) {
+        *snapped = whole + SK_Scalar1;
+        return true;
+    }
+    return false;
+}
+
+bool GrAtlasTextBlob::snapBmpTranslation(const SkMatrix& viewMatrix, SkScalar x, SkScalar y,
+                                         SkVector* residual) const {
+    SkScalar transX, transY;
+    calculate_translation(true, viewMatrix, x, y, fInitialViewMatrix, fInitialX, fInitialY,
+                          &transX, &transY);
+    SkScalar snappedX, snappedY;
+    if (!snap_translation(transX, fBmpSnapSlackDown.fX, fBmpSnapSlackUp.fX, &snappedX) ||
+        !snap_translation(transY, fBmpSnapSlackDown.fY, fBmpSnapSlackUp.fY, &snappedY)) {
+        return false;
+    }
+    residual->set(transX - snappedX, transY - snappedY);
+    return true;
+}
+
 void GrAtlasTextBlob::flushBigGlyphs(GrContext* context, GrDrawContext* dc,
                                      const GrClip& clip, const SkPaint& skPaint,
                                      const SkMatrix& viewMatrix, SkScalar x, SkScalar y,
@@ -134,6 +134,11 @@ public:
         fRuns[runIndex].fDrawAsPaths = true;
     }
 
+    // Called with the device position and rounding SkFindAndPlaceGlyph gives each bitmap glyph,
+    // to track how far the blob can be translated before some glyph would snap to a different
+    // pixel or subpixel position.
+    void updateBmpSnapSlack(const SkPoint& position, const SkPoint& rounding);
+
     void setMinAndMaxScale(SkScalar scaledMax, SkScalar scaledMin) {
         // we init fMaxMinScale and fMinMaxScale in the constructor
         fMaxMinScale = SkMaxScalar(scaledMax, fMaxMinScale);
@@ -286,10 +291,20 @@ public:
 
 private:
     GrAtlasTextBlob()
-        : fMaxMinScale(-SK_ScalarMax)
+        : fBmpSnapSlackDown(SkVector::Make(SK_ScalarMax, SK_ScalarMax))
+        , fBmpSnapSlackUp(SkVector::Make(SK_ScalarMax, SK_ScalarMax))
+        , fMaxMinScale(-SK_ScalarMax)
         , fMinMaxScale(SK_ScalarMax)
         , fTextType(0) {}
 
+    // Bitmap glyphs are rasterized at a quantized position, so a translation that leaves every
+    // glyph's quantized position unchanged, apart from a whole pixel offset, draws the same pixels
+    // as that offset would. Finds that offset for drawing with the view matrix and (x,y), and
+    // returns how far it is from the actual translation of the initial placement. Returns false if
+    // there is no such offset and the bitmap glyphs must be regenerated.
+    bool snapBmpTranslation(const SkMatrix& viewMatrix, SkScalar x, SkScalar y,
+                            SkVector* residual) const;
+
     void appendLargeGlyph(GrGlyph* glyph, SkGlyphCache* cache, const SkGlyph& skGlyph,
                           SkScalar x, SkScalar y, SkScalar scale, bool applyVM);
 
@@ -364,6 +379,7 @@ private:
         struct SubRunInfo {
             SubRunInfo()
                 : fAtlasGeneration(GrBatchAtlas::kInvalidAtlasGeneration)
+                , fAtlasPage(0)
                 , fVertexStartIndex(0)
                 , fVertexEndIndex(0)
                 , fGlyphStartIndex(0)
@@ -380,6 +396,7 @@ private:
                 , fCurrentViewMatrix(that.fCurrentViewMatrix)
                 , fVertexBounds(that.fVertexBounds)
                 , fAtlasGeneration(that.fAtlasGeneration)
+                , fAtlasPage(that.fAtlasPage)
                 , fVertexStartIndex(that.fVertexStartIndex)
                 , fVertexEndIndex(that.fVertexEndIndex)
                 , fGlyphStartIndex(that.fGlyphStartIndex)
@@ -401,6 +418,11 @@ private:
             void setAtlasGeneration(uint64_t atlasGeneration) { fAtlasGeneration = atlasGeneration;}
             uint64_t atlasGeneration() const { return fAtlasGeneration; }
 
+            // The atlas page all of the subrun's glyphs are on.  Only meaningful while the atlas
+            // generation is valid; subruns spanning pages regenerate every time.
+            void setAtlasPage(int atlasPage) { fAtlasPage = atlasPage; }
+            int atlasPage() const { return fAtlasPage; }
+
             size_t byteCount() const { return fVertexEndIndex - fVertexStartIndex; }
             size_t vertexStartIndex() const { return fVertexStartIndex; }
             size_t vertexEndIndex() const { return fVertexEndIndex; }
@@ -455,6 +477,7 @@ private:
             SkMatrix fCurrentViewMatrix;
             SkRect fVertexBounds;
             uint64_t fAtlasGeneration;
+            int fAtlasPage;
             size_t fVertexStartIndex;
             size_t fVertexEndIndex;
             uint32_t fGlyphStartIndex;
@@ -554,6 +577,11 @@ private:
     SkScalar fInitialX;
     SkScalar fInitialY;
 
+    // How far, in device space, the initial placement can move down or up on each axis before any
+    // bitmap glyph snaps to a different position.
+    SkVector fBmpSnapSlackDown;
+    SkVector fBmpSnapSlackUp;
+
     // We can reuse distance field text, but only if the new viewmatrix would not result in
     // a mip change.  Because there can be multiple runs in a blob, we track the overall
     // maximum minimum scale, and minimum maximum scale, we can support before we need to regen
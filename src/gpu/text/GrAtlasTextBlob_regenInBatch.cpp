@@ -170,9 +170,17 @@ void GrAtlasTextBlob::regenInBatch(GrDrawBatch::Target* target,
         } else {
             strike = info->strike();
         }
+    } else {
+        // The glyphs are where they were the last time, and all on one page.  This is only valid
+        // if we have a valid atlas generation
+        helper->setPage(info->atlasPage());
+        fontCache->setUseTokenBulk(*info->bulkUseToken(), target->nextDrawToken(),
+                                   info->maskFormat());
     }
 
     bool brokenRun = false;
+    bool spansPages = false;
+    int atlasPage = 0;
     for (int glyphIdx = 0; glyphIdx < glyphCount; glyphIdx++) {
         GrGlyph* glyph = nullptr;
         int log2Width = 0, log2Height = 0;
@@ -200,6 +208,12 @@ void GrAtlasTextBlob::regenInBatch(GrDrawBatch::Target* target,
                                                                     info->maskFormat());
                 SkASSERT(success);
             }
+            int glyphPage = GrBatchAtlas::GetPageIndexFromID(glyph->fID);
+            spansPages |= glyphIdx > 0 && glyphPage != atlasPage;
+            atlasPage = glyphPage;
+            // Switching pages may flush the glyphs before this one, so do it before taking the
+            // token of the draw this glyph will be in
+            helper->setPage(glyphPage);
             fontCache->addGlyphToBulkAndSetUseToken(info->bulkUseToken(), glyph,
                                                     target->nextDrawToken());
             log2Width = fontCache->log2Width(info->maskFormat());
@@ -221,7 +235,8 @@ void GrAtlasTextBlob::regenInBatch(GrDrawBatch::Target* target,
         if (regenGlyphs) {
             info->setStrike(strike);
         }
-        info->setAtlasGeneration(brokenRun ? GrBatchAtlas::kInvalidAtlasGeneration :
+        info->setAtlasPage(atlasPage);
+        info->setAtlasGeneration(brokenRun || spansPages ? GrBatchAtlas::kInvalidAtlasGeneration :
                                  fontCache->atlasGeneration(info->maskFormat()));
     }
 }
@@ -260,7 +275,18 @@ void GrAtlasTextBlob::regenInBatch(GrDrawBatch::Target* target,
 
     // Compute translation if any
     SkScalar transX, transY;
-    info.computeTranslation(viewMatrix, x, y, &transX, &transY);
+    SkVector residual;
+    if (!info.drawAsDistanceFields() && this->snapBmpTranslation(viewMatrix, x, y, &residual)) {
+        // Bitmap glyphs only move by the whole pixels the translation snaps to, so track the
+        // subrun's position with the residual taken out of the view matrix.
+        SkMatrix snappedViewMatrix = viewMatrix;
+        snappedViewMatrix.postTranslate(-residual.fX, -residual.fY);
+        info.computeTranslation(snappedViewMatrix, x, y, &transX, &transY);
+        transX = SkScalarRoundToScalar(transX);
+        transY = SkScalarRoundToScalar(transY);
+    } else {
+        info.computeTranslation(viewMatrix, x, y, &transX, &transY);
+    }
 
     // Because the GrBatchFontCache may evict the strike a blob depends on using for
     // generating its texture coords, we have to track whether or not the strike has
@@ -300,12 +326,12 @@ void GrAtlasTextBlob::regenInBatch(GrDrawBatch::Target* target,
         case kRegenColTex: this->regenInBatch<false, true, true, false>(REGEN_ARGS); break;
         case kRegenColTexGlyph: this->regenInBatch<false, true, true, true>(REGEN_ARGS); break;
         case kNoRegen:
-            helper->incGlyphCount(*glyphCount);
-
-            // set use tokens for all of the glyphs in our subrun.  This is only valid if we
-            // have a valid atlas generation
+            // set use tokens for all of the glyphs in our subrun, which are all on one page.
+            // This is only valid if we have a valid atlas generation
+            helper->setPage(info.atlasPage());
             fontCache->setUseTokenBulk(*info.bulkUseToken(), target->nextDrawToken(),
                                         info.maskFormat());
+            helper->incGlyphCount(*glyphCount);
             break;
     }
 
@@ -23,12 +23,13 @@ bool GrBatchFontCache::initAtlas(GrMaskFormat format) {
         int height = fAtlasConfigs[index].fHeight;
         int numPlotsX = fAtlasConfigs[index].numPlotsX();
         int numPlotsY = fAtlasConfigs[index].numPlotsY();
+        int maxPages = fAtlasConfigs[index].fMaxPages;
 
         fAtlases[index] =
                 fContext->resourceProvider()->createAtlas(config, width, height,
                                                           numPlotsX, numPlotsY,
                                                           &GrBatchFontCache::HandleEviction,
-                                                          (void*)this);
+                                                          (void*)this, maxPages);
         if (!fAtlases[index]) {
             return false;
         }
@@ -43,13 +44,15 @@ GrBatchFontCache::GrBatchFontCache(GrContext* context)
         fAtlases[i] = nullptr;
     }
 
-    // setup default atlas configs
+    // setup default atlas configs.  Each atlas only grows past its first page when a single flush
+    // needs more glyphs than it holds; the page limits cap A8 and ARGB at 16MB and A565 at 8MB.
     fAtlasConfigs[kA8_GrMaskFormat].fWidth = 2048;
     fAtlasConfigs[kA8_GrMaskFormat].fHeight = 2048;
     fAtlasConfigs[kA8_GrMaskFormat].fLog2Width = 11;
     fAtlasConfigs[kA8_GrMaskFormat].fLog2Height = 11;
     fAtlasConfigs[kA8_GrMaskFormat].fPlotWidth = 512;
     fAtlasConfigs[kA8_GrMaskFormat].fPlotHeight = 256;
+    fAtlasConfigs[kA8_GrMaskFormat].fMaxPages = 4;
 
     fAtlasConfigs[kA565_GrMaskFormat].fWidth = 1024;
     fAtlasConfigs[kA565_GrMaskFormat].fHeight = 2048;
@@ -57,6 +60,7 @@ GrBatchFontCache::GrBatchFontCache(GrContext* context)
     fAtlasConfigs[kA565_GrMaskFormat].fLog2Height = 11;
     fAtlasConfigs[kA565_GrMaskFormat].fPlotWidth = 256;
     fAtlasConfigs[kA565_GrMaskFormat].fPlotHeight = 256;
+    fAtlasConfigs[kA565_GrMaskFormat].fMaxPages = 2;
 
     fAtlasConfigs[kARGB_GrMaskFormat].fWidth = 1024;
     fAtlasConfigs[kARGB_GrMaskFormat].fHeight = 2048;
@@ -64,6 +68,7 @@ GrBatchFontCache::GrBatchFontCache(GrContext* context)
     fAtlasConfigs[kARGB_GrMaskFormat].fLog2Height = 11;
     fAtlasConfigs[kARGB_GrMaskFormat].fPlotWidth = 256;
     fAtlasConfigs[kARGB_GrMaskFormat].fPlotHeight = 256;
+    fAtlasConfigs[kARGB_GrMaskFormat].fMaxPages = 2;
 }
 
 GrBatchFontCache::~GrBatchFontCache() {
@@ -114,15 +119,17 @@ void GrBatchFontCache::dump() const {
     static int gDumpCount = 0;
     for (int i = 0; i < kMaskFormatCount; ++i) {
         if (fAtlases[i]) {
-            GrTexture* texture = fAtlases[i]->getTexture();
-            if (texture) {
-                SkString filename;
+            for (int page = 0; page < fAtlases[i]->numPages(); ++page) {
+                GrTexture* texture = fAtlases[i]->getTexture(page);
+                if (texture) {
+                    SkString filename;
 #ifdef SK_BUILD_FOR_ANDROID
-                filename.printf("/sdcard/fontcache_%d%d.png", gDumpCount, i);
+                    filename.printf("/sdcard/fontcache_%d%d_%d.png", gDumpCount, i, page);
 #else
-                filename.printf("fontcache_%d%d.png", gDumpCount, i);
+                    filename.printf("fontcache_%d%d_%d.png", gDumpCount, i, page);
 #endif
-                texture->surfacePriv().savePixels(filename.c_str());
+                    texture->surfacePriv().savePixels(filename.c_str());
+                }
             }
         }
     }
@@ -137,6 +137,12 @@ public:
         return nullptr;
     }
 
+    // The atlas for a format may spread glyphs across several textures.  getTexture() returns the
+    // first; this returns any page a glyph's GrBatchAtlas::AtlasID refers to.
+    GrTexture* getPageTexture(GrMaskFormat format, int pageIdx) const {
+        return this->getAtlas(format)->getTexture(pageIdx);
+    }
+
     bool hasGlyph(GrGlyph* glyph) {
         SkASSERT(glyph);
         return this->getAtlas(glyph->fMaskFormat)->hasID(glyph->fID);
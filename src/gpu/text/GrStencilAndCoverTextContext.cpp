@@ -624,6 +624,9 @@ void GrStencilAndCoverTextContext::TextRun::draw(GrContext* ctx,
         pipelineBuilder->setUserStencil(&kCoverPass);
 
         SkAutoTUnref<GrPathRange> glyphs(this->createGlyphs(ctx));
+        // The glyphs generate their paths through the shared glyph cache, so give back the strike
+        // we hold before loading them, rather than making them build a second one.
+        this->releaseGlyphCache();
         if (fLastDrawnGlyphsID != glyphs->getUniqueID()) {
             // Either this is the first draw or the glyphs object was purged since last draw.
             glyphs->loadPathsIfNeeded(fInstanceData->indices(), fInstanceData->count());
@@ -35,6 +35,9 @@ static const int kLargeDFFontLimit = 384;
 #else
 static const int kLargeDFFontLimit = 2 * kLargeDFFontSize;
 #endif
+// Runs with at least this many glyphs have their new glyphs rasterized in parallel before the
+// blob is built, rather than one at a time as each glyph is appended.
+static const int kMinPrepareImagesGlyphCount = 64;
 };
 
 void GrTextUtils::DrawBmpText(GrAtlasTextBlob* blob, int runIndex,
@@ -58,11 +61,25 @@ void GrTextUtils::DrawBmpText(GrAtlasTextBlob* blob, int runIndex,
 
     SkGlyphCache* cache = blob->setupCache(runIndex, props, scalerContextFlags, skPaint,
                                            &viewMatrix);
+    if (skPaint.countText(text, byteLength) >= kMinPrepareImagesGlyphCount) {
+        SkTDArray<uint32_t> packedIDs;
+        SkFindAndPlaceGlyph::ProcessText(
+            skPaint.getTextEncoding(), text, byteLength,
+            {x, y}, viewMatrix, skPaint.getTextAlign(),
+            cache,
+            [&](const SkGlyph& glyph, SkPoint, SkPoint) {
+                *packedIDs.append() = glyph.getPackedID();
+            }
+        );
+        cache->prepareImages(packedIDs.begin(), packedIDs.count());
+    }
+
     SkFindAndPlaceGlyph::ProcessText(
         skPaint.getTextEncoding(), text, byteLength,
         {x, y}, viewMatrix, skPaint.getTextAlign(),
         cache,
         [&](const SkGlyph& glyph, SkPoint position, SkPoint rounding) {
+            blob->updateBmpSnapSlack(position, rounding);
             position += rounding;
             BmpAppendGlyph(
                 blob, runIndex, fontCache, &currStrike, glyph,
@@ -97,12 +114,25 @@ void GrTextUtils::DrawBmpPosText(GrAtlasTextBlob* blob, int runIndex,
 
     SkGlyphCache* cache = blob->setupCache(runIndex, props, scalerContextFlags, skPaint,
                                            &viewMatrix);
+    if (skPaint.countText(text, byteLength) >= kMinPrepareImagesGlyphCount) {
+        SkTDArray<uint32_t> packedIDs;
+        SkFindAndPlaceGlyph::ProcessPosText(
+            skPaint.getTextEncoding(), text, byteLength,
+            offset, viewMatrix, pos, scalarsPerPosition,
+            skPaint.getTextAlign(), cache,
+            [&](const SkGlyph& glyph, SkPoint, SkPoint) {
+                *packedIDs.append() = glyph.getPackedID();
+            }
+        );
+        cache->prepareImages(packedIDs.begin(), packedIDs.count());
+    }
 
     SkFindAndPlaceGlyph::ProcessPosText(
         skPaint.getTextEncoding(), text, byteLength,
         offset, viewMatrix, pos, scalarsPerPosition,
         skPaint.getTextAlign(), cache,
         [&](const SkGlyph& glyph, SkPoint position, SkPoint rounding) {
+            blob->updateBmpSnapSlack(position, rounding);
             position += rounding;
             BmpAppendGlyph(
                 blob, runIndex, fontCache, &currStrike, glyph,
@@ -91,6 +91,15 @@ protected:
     void vkAbandon();
     void vkRelease(const GrVkGpu* gpu);
 
+    // Makes the buffer use 'resource' from now on. The caller takes over the ref on the resource
+    // it returns, which was the buffer's previous one.
+    const Resource* vkReplaceResource(const Resource* resource) {
+        SkASSERT(!this->vkIsMapped());
+        const Resource* old = fResource;
+        fResource = resource;
+        return old;
+    }
+
 private:
     void validate() const;
     bool vkIsMapped() const;
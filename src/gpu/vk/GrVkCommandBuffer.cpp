@@ -18,6 +18,7 @@
 #include "SkRect.h"
 
 void GrVkCommandBuffer::invalidateState() {
+    fBoundPipeline = nullptr;
     fBoundVertexBuffer = VK_NULL_HANDLE;
     fBoundVertexBufferIsValid = false;
     fBoundIndexBuffer = VK_NULL_HANDLE;
@@ -77,49 +78,83 @@ void GrVkCommandBuffer::pipelineBarrier(const GrVkGpu* gpu,
                                         VkPipelineStageFlags dstStageMask,
                                         bool byRegion,
                                         BarrierType barrierType,
-                                        void* barrier) const {
+                                        void* barrier) {
     SkASSERT(fIsActive);
     // For images we can have barriers inside of render passes but they require us to add more
     // support in subpasses which need self dependencies to have barriers inside them. Also, we can
     // never have buffer barriers inside of a render pass. For now we will just assert that we are
     // not in a render pass.
     SkASSERT(!fActiveRenderPass);
-    VkDependencyFlags dependencyFlags = byRegion ? VK_DEPENDENCY_BY_REGION_BIT : 0;
 
+    // Barriers in one vkCmdPipelineBarrier are not ordered with respect to each other. So a second
+    // barrier on the same resource, or a global memory barrier next to any other, has to wait for
+    // the ones already pending to be recorded first.
+    bool mustSubmit = !fPendingMemoryBarriers.empty();
     switch (barrierType) {
         case kMemory_BarrierType: {
-            const VkMemoryBarrier* barrierPtr = reinterpret_cast<VkMemoryBarrier*>(barrier);
-            GR_VK_CALL(gpu->vkInterface(), CmdPipelineBarrier(fCmdBuffer, srcStageMask,
-                                                              dstStageMask, dependencyFlags,
-                                                              1, barrierPtr,
-                                                              0, nullptr,
-                                                              0, nullptr));
+            mustSubmit = mustSubmit || !fPendingBufferBarriers.empty() ||
+                         !fPendingImageBarriers.empty();
+            if (mustSubmit) {
+                this->submitPipelineBarriers(gpu);
+            }
+            fPendingMemoryBarriers.push_back(*reinterpret_cast<VkMemoryBarrier*>(barrier));
             break;
         }
 
         case kBufferMemory_BarrierType: {
             const VkBufferMemoryBarrier* barrierPtr =
                                                  reinterpret_cast<VkBufferMemoryBarrier*>(barrier);
-            GR_VK_CALL(gpu->vkInterface(), CmdPipelineBarrier(fCmdBuffer, srcStageMask,
-                                                              dstStageMask, dependencyFlags,
-                                                              0, nullptr,
-                                                              1, barrierPtr,
-                                                              0, nullptr));
+            for (int i = 0; !mustSubmit && i < fPendingBufferBarriers.count(); ++i) {
+                mustSubmit = fPendingBufferBarriers[i].buffer == barrierPtr->buffer;
+            }
+            if (mustSubmit) {
+                this->submitPipelineBarriers(gpu);
+            }
+            fPendingBufferBarriers.push_back(*barrierPtr);
             break;
         }
 
         case kImageMemory_BarrierType: {
             const VkImageMemoryBarrier* barrierPtr =
                                                   reinterpret_cast<VkImageMemoryBarrier*>(barrier);
-            GR_VK_CALL(gpu->vkInterface(), CmdPipelineBarrier(fCmdBuffer, srcStageMask,
-                                                              dstStageMask, dependencyFlags,
-                                                              0, nullptr,
-                                                              0, nullptr,
-                                                              1, barrierPtr));
+            for (int i = 0; !mustSubmit && i < fPendingImageBarriers.count(); ++i) {
+                mustSubmit = fPendingImageBarriers[i].image == barrierPtr->image;
+            }
+            if (mustSubmit) {
+                this->submitPipelineBarriers(gpu);
+            }
+            fPendingImageBarriers.push_back(*barrierPtr);
             break;
         }
     }
 
+    fPendingSrcStageMask |= srcStageMask;
+    fPendingDstStageMask |= dstStageMask;
+    fPendingByRegion = fPendingByRegion && byRegion;
+}
+
+void GrVkCommandBuffer::submitPipelineBarriers(const GrVkGpu* gpu) {
+    SkASSERT(fIsActive);
+    if (fPendingMemoryBarriers.empty() && fPendingBufferBarriers.empty() &&
+        fPendingImageBarriers.empty()) {
+        return;
+    }
+    SkASSERT(!fActiveRenderPass);
+    VkDependencyFlags dependencyFlags = fPendingByRegion ? VK_DEPENDENCY_BY_REGION_BIT : 0;
+    GR_VK_CALL(gpu->vkInterface(), CmdPipelineBarrier(fCmdBuffer, fPendingSrcStageMask,
+                                                      fPendingDstStageMask, dependencyFlags,
+                                                      fPendingMemoryBarriers.count(),
+                                                      fPendingMemoryBarriers.begin(),
+                                                      fPendingBufferBarriers.count(),
+                                                      fPendingBufferBarriers.begin(),
+                                                      fPendingImageBarriers.count(),
+                                                      fPendingImageBarriers.begin()));
+    fPendingMemoryBarriers.reset();
+    fPendingBufferBarriers.reset();
+    fPendingImageBarriers.reset();
+    fPendingSrcStageMask = 0;
+    fPendingDstStageMask = 0;
+    fPendingByRegion = true;
 }
 
 void GrVkCommandBuffer::clearAttachments(const GrVkGpu* gpu,
@@ -169,10 +204,16 @@ void GrVkCommandBuffer::bindDescriptorSets(const GrVkGpu* gpu,
 
 void GrVkCommandBuffer::bindPipeline(const GrVkGpu* gpu, const GrVkPipeline* pipeline) {
     SkASSERT(fIsActive);
+    // Batches that share a GrVkPipelineState draw back to back, so this is often already bound.
+    // We hold a ref on whatever we bound, so it can't have been replaced at the same address.
+    if (pipeline == fBoundPipeline) {
+        return;
+    }
     GR_VK_CALL(gpu->vkInterface(), CmdBindPipeline(fCmdBuffer,
                                                    VK_PIPELINE_BIND_POINT_GRAPHICS,
                                                    pipeline->pipeline()));
     addResource(pipeline);
+    fBoundPipeline = pipeline;
 }
 
 void GrVkCommandBuffer::drawIndexed(const GrVkGpu* gpu,
@@ -289,6 +330,7 @@ void GrVkPrimaryCommandBuffer::begin(const GrVkGpu* gpu) {
 void GrVkPrimaryCommandBuffer::end(const GrVkGpu* gpu) {
     SkASSERT(fIsActive);
     SkASSERT(!fActiveRenderPass);
+    this->submitPipelineBarriers(gpu);
     GR_VK_CALL_ERRCHECK(gpu->vkInterface(), EndCommandBuffer(fCmdBuffer));
     this->invalidateState();
     fIsActive = false;
@@ -304,6 +346,7 @@ void GrVkPrimaryCommandBuffer::beginRenderPass(const GrVkGpu* gpu,
     SkASSERT(fIsActive);
     SkASSERT(!fActiveRenderPass);
     SkASSERT(renderPass->isCompatible(target));
+    this->submitPipelineBarriers(gpu);
 
     VkRenderPassBeginInfo beginInfo;
     VkRect2D renderArea;
@@ -432,6 +475,7 @@ void GrVkPrimaryCommandBuffer::copyImage(const GrVkGpu* gpu,
                                          const VkImageCopy* copyRegions) {
     SkASSERT(fIsActive);
     SkASSERT(!fActiveRenderPass);
+    this->submitPipelineBarriers(gpu);
     this->addResource(srcImage->resource());
     this->addResource(dstImage->resource());
     GR_VK_CALL(gpu->vkInterface(), CmdCopyImage(fCmdBuffer,
@@ -455,6 +499,7 @@ void GrVkPrimaryCommandBuffer::blitImage(const GrVkGpu* gpu,
                                          VkFilter filter) {
     SkASSERT(fIsActive);
     SkASSERT(!fActiveRenderPass);
+    this->submitPipelineBarriers(gpu);
     this->addResource(srcResource);
     this->addResource(dstResource);
     GR_VK_CALL(gpu->vkInterface(), CmdBlitImage(fCmdBuffer,
@@ -475,6 +520,7 @@ void GrVkPrimaryCommandBuffer::copyImageToBuffer(const GrVkGpu* gpu,
                                                  const VkBufferImageCopy* copyRegions) {
     SkASSERT(fIsActive);
     SkASSERT(!fActiveRenderPass);
+    this->submitPipelineBarriers(gpu);
     this->addResource(srcImage->resource());
     this->addResource(dstBuffer->resource());
     GR_VK_CALL(gpu->vkInterface(), CmdCopyImageToBuffer(fCmdBuffer,
@@ -493,6 +539,7 @@ void GrVkPrimaryCommandBuffer::copyBufferToImage(const GrVkGpu* gpu,
                                                  const VkBufferImageCopy* copyRegions) {
     SkASSERT(fIsActive);
     SkASSERT(!fActiveRenderPass);
+    this->submitPipelineBarriers(gpu);
     this->addResource(srcBuffer->resource());
     this->addResource(dstImage->resource());
     GR_VK_CALL(gpu->vkInterface(), CmdCopyBufferToImage(fCmdBuffer,
@@ -510,6 +557,7 @@ void GrVkPrimaryCommandBuffer::updateBuffer(GrVkGpu* gpu,
                                             const void* data) {
     SkASSERT(fIsActive);
     SkASSERT(!fActiveRenderPass);
+    this->submitPipelineBarriers(gpu);
     SkASSERT(0 == (dstOffset & 0x03));   // four byte aligned
     // TODO: handle larger transfer sizes
     SkASSERT(dataSize <= 65536);
@@ -529,6 +577,7 @@ void GrVkPrimaryCommandBuffer::clearColorImage(const GrVkGpu* gpu,
                                                const VkImageSubresourceRange* subRanges) {
     SkASSERT(fIsActive);
     SkASSERT(!fActiveRenderPass);
+    this->submitPipelineBarriers(gpu);
     this->addResource(image->resource());
     GR_VK_CALL(gpu->vkInterface(), CmdClearColorImage(fCmdBuffer,
                                                       image->image(),
@@ -545,6 +594,7 @@ void GrVkPrimaryCommandBuffer::clearDepthStencilImage(const GrVkGpu* gpu,
                                                       const VkImageSubresourceRange* subRanges) {
     SkASSERT(fIsActive);
     SkASSERT(!fActiveRenderPass);
+    this->submitPipelineBarriers(gpu);
     this->addResource(image->resource());
     GR_VK_CALL(gpu->vkInterface(), CmdClearDepthStencilImage(fCmdBuffer,
                                                              image->image(),
@@ -32,12 +32,14 @@ public:
         kImageMemory_BarrierType
     };
 
+    // Barriers are not recorded right away. They are collected and emitted together, in a single
+    // vkCmdPipelineBarrier, right before the next command that has to see their effects.
     void pipelineBarrier(const GrVkGpu* gpu,
                          VkPipelineStageFlags srcStageMask,
                          VkPipelineStageFlags dstStageMask,
                          bool byRegion,
                          BarrierType barrierType,
-                         void* barrier) const;
+                         void* barrier);
 
     void bindVertexBuffer(GrVkGpu* gpu, GrVkVertexBuffer* vbuffer) {
         VkBuffer vkBuffer = vbuffer->buffer();
@@ -125,10 +127,18 @@ protected:
             , fIsActive(false)
             , fActiveRenderPass(rp)
             , fCmdBuffer(cmdBuffer)
+            , fBoundPipeline(nullptr)
             , fBoundVertexBufferIsValid(false)
-            , fBoundIndexBufferIsValid(false) {
+            , fBoundIndexBufferIsValid(false)
+            , fPendingSrcStageMask(0)
+            , fPendingDstStageMask(0)
+            , fPendingByRegion(true) {
             this->invalidateState();
         }
+
+        // Records the barriers collected by pipelineBarrier(), if any.
+        void submitPipelineBarriers(const GrVkGpu* gpu);
+
         SkTArray<const GrVkResource*, true>     fTrackedResources;
 
         // Tracks whether we are in the middle of a command buffer begin/end calls and thus can add
@@ -151,6 +161,8 @@ private:
 
     virtual void onReset(GrVkGpu* gpu) {}
 
+    const GrVkPipeline*                     fBoundPipeline;
+
     VkBuffer                                fBoundVertexBuffer;
     bool                                    fBoundVertexBufferIsValid;
 
@@ -161,6 +173,15 @@ private:
     VkViewport fCachedViewport;
     VkRect2D   fCachedScissor;
     float      fCachedBlendConstant[4];
+
+    // Barriers waiting for submitPipelineBarriers(). The stage masks are the union of theirs, and
+    // they are by region only if all of them are.
+    SkSTArray<2, VkMemoryBarrier, true>       fPendingMemoryBarriers;
+    SkSTArray<2, VkBufferMemoryBarrier, true> fPendingBufferBarriers;
+    SkSTArray<4, VkImageMemoryBarrier, true>  fPendingImageBarriers;
+    VkPipelineStageFlags                      fPendingSrcStageMask;
+    VkPipelineStageFlags                      fPendingDstStageMask;
+    bool                                      fPendingByRegion;
 };
 
 class GrVkSecondaryCommandBuffer;
@@ -126,6 +126,8 @@ GrVkGpu::GrVkGpu(GrContext* context, const GrContextOptions& options,
 
     VK_CALL(GetPhysicalDeviceMemoryProperties(backendCtx->fPhysicalDevice, &fPhysDevMemProps));
 
+    fPersistentCache = options.fPersistentCache;
+
     const VkCommandPoolCreateInfo cmdPoolInfo = {
         VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,      // sType
         nullptr,                                         // pNext
@@ -199,6 +201,34 @@ GrVkGpu::~GrVkGpu() {
 #endif
 }
 
+void GrVkGpu::dumpMemoryStatistics(SkTraceMemoryDump* traceMemoryDump) const {
+    static const char* kHeapNames[kHeapCount] = {
+        "linear_image",
+        "optimal_image",
+        "small_optimal_image",
+        "vertex_buffer",
+        "index_buffer",
+        "uniform_buffer",
+        "copy_read_buffer",
+        "copy_write_buffer",
+    };
+    GR_STATIC_ASSERT(0 == kLinearImage_Heap);
+    GR_STATIC_ASSERT(1 == kOptimalImage_Heap);
+    GR_STATIC_ASSERT(2 == kSmallOptimalImage_Heap);
+    GR_STATIC_ASSERT(3 == kVertexBuffer_Heap);
+    GR_STATIC_ASSERT(4 == kIndexBuffer_Heap);
+    GR_STATIC_ASSERT(5 == kUniformBuffer_Heap);
+    GR_STATIC_ASSERT(6 == kCopyReadBuffer_Heap);
+    GR_STATIC_ASSERT(7 == kCopyWriteBuffer_Heap);
+
+    for (int i = 0; i < kHeapCount; ++i) {
+        // Dump each heap as "skia/gpu_vk_heaps/<name>".
+        SkString dumpName("skia/gpu_vk_heaps/");
+        dumpName.append(kHeapNames[i]);
+        fHeaps[i]->dumpMemoryStatistics(traceMemoryDump, dumpName.c_str());
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 GrGpuCommandBuffer* GrVkGpu::createCommandBuffer(
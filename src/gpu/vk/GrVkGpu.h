@@ -10,6 +10,7 @@
 
 #define USE_SKSL 1
 
+#include "GrContextOptions.h"
 #include "GrGpu.h"
 #include "GrGpuFactory.h"
 #include "vk/GrVkBackendContext.h"
@@ -55,10 +56,14 @@ public:
     VkDevice device() const { return fDevice; }
     VkQueue  queue() const { return fQueue; }
     VkCommandPool cmdPool() const { return fCmdPool; }
+    VkPhysicalDevice physicalDevice() const { return fBackendContext->fPhysicalDevice; }
     VkPhysicalDeviceMemoryProperties physicalDeviceMemoryProperties() const {
         return fPhysDevMemProps;
     }
 
+    // The client's cache for data that outlives the context, or null.
+    GrContextOptions::PersistentCache* persistentCache() const { return fPersistentCache; }
+
     GrVkResourceProvider& resourceProvider() { return fResourceProvider;  }
 
     enum SyncQueue {
@@ -136,6 +141,16 @@ public:
 
     void finishDrawTarget() override;
 
+    GrFence SK_WARN_UNUSED_RESULT insertFence() override { return 0; }
+    bool waitFence(GrFence, uint64_t) override { return false; }
+    void deleteFence(GrFence) override {}
+
+    // Timestamp queries aren't hooked up yet, so GrVkCaps never reports timerQuerySupport().
+    GrTimerQuery SK_WARN_UNUSED_RESULT createTimerQuery() override { return 0; }
+    bool timerQueryResult(GrTimerQuery, bool, uint64_t*) override { return false; }
+    bool timerQueriesDisjoint() override { return false; }
+    void deleteTimerQuery(GrTimerQuery) override {}
+
     void generateMipmap(GrVkTexture* tex);
 
     bool updateBuffer(GrVkBuffer* buffer, const void* src, VkDeviceSize offset, VkDeviceSize size);
@@ -161,6 +176,8 @@ public:
 
     GrVkHeap* getHeap(Heap heap) const { return fHeaps[heap]; }
 
+    void dumpMemoryStatistics(SkTraceMemoryDump*) const override;
+
 private:
     GrVkGpu(GrContext* context, const GrContextOptions& options,
             const GrVkBackendContext* backendContext);
@@ -197,6 +214,11 @@ private:
                           GrPixelConfig config, GrBuffer* transferBuffer,
                           size_t offset, size_t rowBytes) override { return false; }
 
+    bool onReadPixelsToBuffer(GrSurface*,
+                              int left, int top, int width, int height,
+                              GrPixelConfig config, GrBuffer* transferBuffer,
+                              size_t offset, size_t rowBytes) override { return false; }
+
     void onResolveRenderTarget(GrRenderTarget* target) override {}
 
     // Ends and submits the current command buffer to the queue and then creates a new command
@@ -247,6 +269,7 @@ private:
     VkCommandPool                          fCmdPool;
     GrVkPrimaryCommandBuffer*              fCurrentCmdBuffer;
     VkPhysicalDeviceMemoryProperties       fPhysDevMemProps;
+    GrContextOptions::PersistentCache*     fPersistentCache;
 
     SkAutoTDelete<GrVkHeap>                fHeaps[kHeapCount];
 
@@ -167,6 +167,11 @@ void GrVkGpuCommandBuffer::discard(GrRenderTarget* target) {
 
         SkASSERT(fRenderPass->isCompatible(*oldRP));
         oldRP->unref(fGpu);
+
+        // The stencil isn't loaded either, so whatever clip was last drawn into it is gone.
+        if (GrStencilAttachment* sb = vkRT->renderTargetPriv().getStencilAttachment()) {
+            sb->invalidateLastClip();
+        }
     }
 }
 
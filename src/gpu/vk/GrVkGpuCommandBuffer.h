@@ -21,6 +21,11 @@ class GrVkRenderPass;
 class GrVkRenderTarget;
 class GrVkSecondaryCommandBuffer;
 
+// Records one render pass's draws into a single secondary command buffer, in order, on the thread
+// that flushes.  Recording draws into several secondary buffers on worker threads isn't done:
+// every draw goes through GrVkPipelineState::setData(), which rewrites the pipeline state's shared
+// uniform buffers and descriptor sets in place, and through GrVkResourceProvider's caches, and
+// neither is thread-safe.
 class GrVkGpuCommandBuffer : public GrGpuCommandBuffer {
 public:
     GrVkGpuCommandBuffer(GrVkGpu* gpu,
@@ -34,6 +39,10 @@ public:
 
     void discard(GrRenderTarget* rt) override;
 
+    // GrVkGpu doesn't create timer queries yet.
+    void beginTimerQuery(GrTimerQuery) override { SkASSERT(false); }
+    void endTimerQuery(GrTimerQuery) override { SkASSERT(false); }
+
 private:
     GrGpu* gpu() override;
 
@@ -9,6 +9,7 @@
 
 #include "GrVkGpu.h"
 #include "GrVkUtil.h"
+#include "SkTraceMemoryDump.h"
 
 static bool get_valid_memory_type_index(VkPhysicalDeviceMemoryProperties physDevMemProps,
                                         uint32_t typeBits,
@@ -198,11 +199,15 @@ VkPipelineStageFlags GrVkMemory::LayoutToPipelineStageFlags(const VkImageLayout
     } else if (VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL == layout ||
                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL == layout) {
         return VK_PIPELINE_STAGE_TRANSFER_BIT;
-    } else if (VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL == layout ||
-               VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL == layout ||
-               VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL == layout ||
-               VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL == layout) {
-        return VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+    } else if (VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL == layout) {
+        return VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    } else if (VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL == layout ||
+               VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL == layout) {
+        return VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+               VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    } else if (VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL == layout) {
+        // Textures are sampled by our vertex and fragment shaders only.
+        return VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
     } else if (VK_IMAGE_LAYOUT_PREINITIALIZED == layout) {
         return VK_PIPELINE_STAGE_HOST_BIT;
     }
@@ -455,11 +460,13 @@ bool GrVkHeap::subAlloc(VkDeviceSize size, VkDeviceSize alignment,
         return true;
     }
 
-    // first try to find a subheap that fits our allocation request
+    // first try to find a subheap that fits our allocation request. A subheap keeps all its blocks
+    // at multiples of its own alignment, so we can only share one with requests that match it.
     int bestFitIndex = -1;
     VkDeviceSize bestFitSize = 0x7FFFFFFF;
     for (auto i = 0; i < fSubHeaps.count(); ++i) {
-        if (fSubHeaps[i]->memoryTypeIndex() == memoryTypeIndex) {
+        if (fSubHeaps[i]->memoryTypeIndex() == memoryTypeIndex &&
+            fSubHeaps[i]->alignment() == alignment) {
             VkDeviceSize heapSize = fSubHeaps[i]->largestBlockSize();
             if (heapSize >= alignedSize && heapSize < bestFitSize) {
                 bestFitIndex = i;
@@ -485,10 +492,11 @@ bool GrVkHeap::subAlloc(VkDeviceSize size, VkDeviceSize alignment,
         VkDeviceSize alignedSize = align_size(size, alignment);
         subHeap.reset(new GrVkSubHeap(fGpu, memoryTypeIndex, alignedSize, alignment));
         if (subHeap->size() == 0) {
+            fSubHeaps.pop_back();
             return false;
         }
     }
-    fAllocSize += fSubHeapSize;
+    fAllocSize += subHeap->size();
     if (subHeap->alloc(size, alloc)) {
         fUsedSize += alloc->fSize;
         return true;
@@ -505,7 +513,9 @@ bool GrVkHeap::singleAlloc(VkDeviceSize size, VkDeviceSize alignment,
     int bestFitIndex = -1;
     VkDeviceSize bestFitSize = 0x7FFFFFFF;
     for (auto i = 0; i < fSubHeaps.count(); ++i) {
-        if (fSubHeaps[i]->memoryTypeIndex() == memoryTypeIndex && fSubHeaps[i]->unallocated()) {
+        if (fSubHeaps[i]->memoryTypeIndex() == memoryTypeIndex &&
+            fSubHeaps[i]->alignment() == alignment &&
+            fSubHeaps[i]->unallocated()) {
             VkDeviceSize heapSize = fSubHeaps[i]->size();
             if (heapSize >= alignedSize && heapSize < bestFitSize) {
                 bestFitIndex = i;
@@ -526,6 +536,10 @@ bool GrVkHeap::singleAlloc(VkDeviceSize size, VkDeviceSize alignment,
     // need to allocate a new subheap
     SkAutoTDelete<GrVkSubHeap>& subHeap = fSubHeaps.push_back();
     subHeap.reset(new GrVkSubHeap(fGpu, memoryTypeIndex, alignedSize, alignment));
+    if (subHeap->size() == 0) {
+        fSubHeaps.pop_back();
+        return false;
+    }
     fAllocSize += alignedSize;
     if (subHeap->alloc(size, alloc)) {
         fUsedSize += alloc->fSize;
@@ -554,4 +568,20 @@ bool GrVkHeap::free(const GrVkAlloc& alloc) {
     return false;
 }
 
-
+void GrVkHeap::dumpMemoryStatistics(SkTraceMemoryDump* traceMemoryDump,
+                                    const char* dumpName) const {
+    traceMemoryDump->dumpNumericValue(dumpName, "size", "bytes", fAllocSize);
+    traceMemoryDump->dumpNumericValue(dumpName, "used_size", "bytes", fUsedSize);
+    traceMemoryDump->dumpNumericValue(dumpName, "subheap_count", "objects", fSubHeaps.count());
+
+    for (int i = 0; i < fSubHeaps.count(); ++i) {
+        SkString subHeapName(dumpName);
+        subHeapName.appendf("/subheap_%d", i);
+        const GrVkSubHeap* subHeap = fSubHeaps[i];
+        traceMemoryDump->dumpNumericValue(subHeapName.c_str(), "size", "bytes", subHeap->size());
+        traceMemoryDump->dumpNumericValue(subHeapName.c_str(), "free_size", "bytes",
+                                          subHeap->freeSize());
+        traceMemoryDump->dumpNumericValue(subHeapName.c_str(), "largest_free_block", "bytes",
+                                          subHeap->largestBlockSize());
+    }
+}
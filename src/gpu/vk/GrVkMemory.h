@@ -15,6 +15,7 @@
 #include "vk/GrVkTypes.h"
 
 class GrVkGpu;
+class SkTraceMemoryDump;
 
 namespace GrVkMemory {
     /**
@@ -131,6 +132,11 @@ public:
 
     VkDeviceSize allocSize() const { return fAllocSize; }
     VkDeviceSize usedSize() const { return fUsedSize; }
+    int subHeapCount() const { return fSubHeaps.count(); }
+
+    // Reports the device memory held by this heap as "<dumpName>" and each of its subheaps as
+    // "<dumpName>/subheap_#".
+    void dumpMemoryStatistics(SkTraceMemoryDump*, const char* dumpName) const;
 
     bool alloc(VkDeviceSize size, VkDeviceSize alignment, uint32_t memoryTypeIndex, 
                GrVkAlloc* alloc) {
@@ -53,6 +53,8 @@ GrVkPipelineState::GrVkPipelineState(GrVkGpu* gpu,
     fSamplers.setReserve(numSamplers);
     fTextureViews.setReserve(numSamplers);
     fTextures.setReserve(numSamplers);
+    fCachedSamplers.setReserve(numSamplers);
+    fCachedTextureViews.setReserve(numSamplers);
 
     fDescriptorSets[0] = VK_NULL_HANDLE;
     fDescriptorSets[1] = VK_NULL_HANDLE;
@@ -123,6 +125,7 @@ void GrVkPipelineState::freeGPUResources(const GrVkGpu* gpu) {
         fFragmentUniformBuffer->release(gpu);
     }
 
+    this->freeCachedSamplerResources(gpu);
     fSamplerPoolManager.freeGPUResources(gpu);
     if (fCurrentUniformDescPool) {
         fCurrentUniformDescPool->unref(gpu);
@@ -156,6 +159,16 @@ void GrVkPipelineState::abandonGPUResources() {
     }
     fTextures.rewind();
 
+    for (int i = 0; i < fCachedSamplers.count(); ++i) {
+        fCachedSamplers[i]->unrefAndAbandon();
+    }
+    fCachedSamplers.rewind();
+
+    for (int i = 0; i < fCachedTextureViews.count(); ++i) {
+        fCachedTextureViews[i]->unrefAndAbandon();
+    }
+    fCachedTextureViews.rewind();
+
     fSamplerPoolManager.abandonGPUResources();
     if (fCurrentUniformDescPool) {
         fCurrentUniformDescPool->unrefAndAbandon();
@@ -201,8 +214,6 @@ void GrVkPipelineState::setData(GrVkGpu* gpu,
 
     // Get new descriptor sets
     if (fNumSamplers) {
-        fSamplerPoolManager.getNewDescriptorSet(gpu,
-                                             &fDescriptorSets[GrVkUniformHandler::kSamplerDescSet]);
         this->writeSamplers(gpu, textureBindings, pipeline.getAllowSRGBInputs());
     }
 
@@ -305,11 +316,27 @@ void GrVkPipelineState::writeSamplers(GrVkGpu* gpu,
         const GrVkImageView* textureView = texture->textureView(allowSRGBInputs);
         textureView->ref();
         fTextureViews.push(textureView);
+    }
 
+    // Draws of the same atlas or sprite sheet usually come one after another. If this one samples
+    // exactly what the last descriptor set we wrote does, bind that again. We keep refs on the
+    // samplers and views it was written with, so equal pointers really are the same objects.
+    if (fCachedSamplers.count() &&
+        !memcmp(fCachedSamplers.begin(), fSamplers.begin(),
+                fSamplers.count() * sizeof(GrVkSampler*)) &&
+        !memcmp(fCachedTextureViews.begin(), fTextureViews.begin(),
+                fTextureViews.count() * sizeof(GrVkImageView*))) {
+        SkASSERT(VK_NULL_HANDLE != fDescriptorSets[GrVkUniformHandler::kSamplerDescSet]);
+        return;
+    }
+
+    fSamplerPoolManager.getNewDescriptorSet(gpu,
+                                            &fDescriptorSets[GrVkUniformHandler::kSamplerDescSet]);
+    for (int i = 0; i < textureBindings.count(); ++i) {
         VkDescriptorImageInfo imageInfo;
         memset(&imageInfo, 0, sizeof(VkDescriptorImageInfo));
         imageInfo.sampler = fSamplers[i]->sampler();
-        imageInfo.imageView = textureView->imageView();
+        imageInfo.imageView = fTextureViews[i]->imageView();
         imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
         VkWriteDescriptorSet writeInfo;
@@ -331,6 +358,26 @@ void GrVkPipelineState::writeSamplers(GrVkGpu* gpu,
                                                             0,
                                                             nullptr));
     }
+
+    this->freeCachedSamplerResources(gpu);
+    for (int i = 0; i < fSamplers.count(); ++i) {
+        fSamplers[i]->ref();
+        fCachedSamplers.push(fSamplers[i]);
+        fTextureViews[i]->ref();
+        fCachedTextureViews.push(fTextureViews[i]);
+    }
+}
+
+void GrVkPipelineState::freeCachedSamplerResources(const GrVkGpu* gpu) {
+    for (int i = 0; i < fCachedSamplers.count(); ++i) {
+        fCachedSamplers[i]->unref(gpu);
+    }
+    fCachedSamplers.rewind();
+
+    for (int i = 0; i < fCachedTextureViews.count(); ++i) {
+        fCachedTextureViews[i]->unref(gpu);
+    }
+    fCachedTextureViews.rewind();
 }
 
 void GrVkPipelineState::setRenderTargetState(const GrPipeline& pipeline) {
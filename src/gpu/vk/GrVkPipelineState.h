@@ -200,8 +200,10 @@ private:
 
     void writeUniformBuffers(const GrVkGpu* gpu);
 
+    // Binds the textures in a sampler descriptor set, reusing the last one written if it matches.
     void writeSamplers(GrVkGpu* gpu, const SkTArray<const GrTextureAccess*>& textureBindings,
                        bool allowSRGBInputs);
+    void freeCachedSamplerResources(const GrVkGpu* gpu);
 
     /**
     * We use the RT's size and origin to adjust from Skia device space to vulkan normalized device
@@ -268,6 +270,11 @@ private:
     SkTDArray<const GrVkImageView*> fTextureViews;
     SkTDArray<const GrVkResource*> fTextures;
 
+    // What the sampler descriptor set was last written with. We hold refs on these so the set
+    // stays valid to bind again.
+    SkTDArray<GrVkSampler*> fCachedSamplers;
+    SkTDArray<const GrVkImageView*> fCachedTextureViews;
+
     // Tracks the current render target uniforms stored in the vertex buffer.
     RenderTargetState fRenderTargetState;
     BuiltinUniformHandles fBuiltinUniformHandles;
@@ -7,11 +7,13 @@
 
 #include "GrVkResourceProvider.h"
 
+#include "GrContextOptions.h"
 #include "GrTextureParams.h"
 #include "GrVkCommandBuffer.h"
 #include "GrVkPipeline.h"
 #include "GrVkRenderTarget.h"
 #include "GrVkSampler.h"
+#include "GrVkUniformBuffer.h"
 #include "GrVkUtil.h"
 
 #ifdef SK_TRACE_VK_RESOURCES
@@ -66,14 +68,41 @@ void GrVkResourceProvider::initUniformDescObjects() {
                                                                   fCurrMaxUniDescriptors);
 }
 
+sk_sp<SkData> GrVkResourceProvider::pipelineCacheKey() const {
+    VkPhysicalDeviceProperties props;
+    GR_VK_CALL(fGpu->vkInterface(), GetPhysicalDeviceProperties(fGpu->physicalDevice(), &props));
+
+    struct Key {
+        char     fTag[16];
+        uint32_t fVendorID;
+        uint32_t fDeviceID;
+        uint32_t fDriverVersion;
+        uint8_t  fPipelineCacheUUID[VK_UUID_SIZE];
+    } key;
+    memset(&key, 0, sizeof(key));
+    strncpy(key.fTag, "VkPipelineCache", sizeof(key.fTag));
+    key.fVendorID = props.vendorID;
+    key.fDeviceID = props.deviceID;
+    key.fDriverVersion = props.driverVersion;
+    memcpy(key.fPipelineCacheUUID, props.pipelineCacheUUID, VK_UUID_SIZE);
+    return SkData::MakeWithCopy(&key, sizeof(key));
+}
+
 void GrVkResourceProvider::init() {
+    // Start from whatever pipelines a previous context on this device left us.  The driver
+    // checks the data's own header and ignores it if it doesn't match.
+    sk_sp<SkData> initialData;
+    if (GrContextOptions::PersistentCache* cache = fGpu->persistentCache()) {
+        initialData = cache->load(*this->pipelineCacheKey());
+    }
+
     VkPipelineCacheCreateInfo createInfo;
     memset(&createInfo, 0, sizeof(VkPipelineCacheCreateInfo));
     createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
     createInfo.pNext = nullptr;
     createInfo.flags = 0;
-    createInfo.initialDataSize = 0;
-    createInfo.pInitialData = nullptr;
+    createInfo.initialDataSize = initialData ? initialData->size() : 0;
+    createInfo.pInitialData = initialData ? initialData->data() : nullptr;
     VkResult result = GR_VK_CALL(fGpu->vkInterface(),
                                  CreatePipelineCache(fGpu->device(), &createInfo, nullptr,
                                                      &fPipelineCache));
@@ -246,6 +275,15 @@ void GrVkResourceProvider::checkCommandBuffers() {
             fActiveCommandBuffers.removeShuffle(i);
         }
     }
+
+    // Finished command buffers have dropped their refs, so any recycled uniform buffer that's
+    // down to ours can be written again.
+    for (int i = fInFlightUniformBufferResources.count() - 1; i >= 0; --i) {
+        if (fInFlightUniformBufferResources[i]->unique()) {
+            fAvailableUniformBufferResources.push_back(fInFlightUniformBufferResources[i]);
+            fInFlightUniformBufferResources.removeShuffle(i);
+        }
+    }
 }
 
 GrVkSecondaryCommandBuffer* GrVkResourceProvider::findOrCreateSecondaryCommandBuffer() {
@@ -265,6 +303,23 @@ void GrVkResourceProvider::recycleSecondaryCommandBuffer(GrVkSecondaryCommandBuf
     fAvailableSecondaryCommandBuffers.push_back(cb);
 }
 
+const GrVkResource* GrVkResourceProvider::findOrCreateStandardUniformBufferResource() {
+    if (fAvailableUniformBufferResources.count()) {
+        const GrVkResource* resource = fAvailableUniformBufferResources.back();
+        fAvailableUniformBufferResources.pop_back();
+        return resource;
+    }
+    return GrVkUniformBuffer::CreateStandardResource(fGpu);
+}
+
+void GrVkResourceProvider::recycleStandardUniformBufferResource(const GrVkResource* resource) {
+    if (resource->unique()) {
+        fAvailableUniformBufferResources.push_back(resource);
+    } else {
+        fInFlightUniformBufferResources.push_back(resource);
+    }
+}
+
 void GrVkResourceProvider::destroyResources() {
     // release our active command buffers
     for (int i = 0; i < fActiveCommandBuffers.count(); ++i) {
@@ -274,6 +329,17 @@ void GrVkResourceProvider::destroyResources() {
         fActiveCommandBuffers[i]->unref(fGpu);
     }
     fActiveCommandBuffers.reset();
+    // release our recycled uniform buffers, which the command buffers no longer use
+    for (int i = 0; i < fInFlightUniformBufferResources.count(); ++i) {
+        SkASSERT(fInFlightUniformBufferResources[i]->unique());
+        fInFlightUniformBufferResources[i]->unref(fGpu);
+    }
+    fInFlightUniformBufferResources.reset();
+    for (int i = 0; i < fAvailableUniformBufferResources.count(); ++i) {
+        SkASSERT(fAvailableUniformBufferResources[i]->unique());
+        fAvailableUniformBufferResources[i]->unref(fGpu);
+    }
+    fAvailableUniformBufferResources.reset();
     // release our available command buffers
     for (int i = 0; i < fAvailableCommandBuffers.count(); ++i) {
         SkASSERT(fAvailableCommandBuffers[i]->finished(fGpu));
@@ -304,6 +370,7 @@ void GrVkResourceProvider::destroyResources() {
 
     fPipelineStateCache->release();
 
+    this->storePipelineCacheData();
     GR_VK_CALL(fGpu->vkInterface(), DestroyPipelineCache(fGpu->device(), fPipelineCache, nullptr));
     fPipelineCache = VK_NULL_HANDLE;
 
@@ -316,6 +383,28 @@ void GrVkResourceProvider::destroyResources() {
     fUniformDescPool->unref(fGpu);
 }
 
+void GrVkResourceProvider::storePipelineCacheData() {
+    GrContextOptions::PersistentCache* cache = fGpu->persistentCache();
+    if (!cache || VK_NULL_HANDLE == fPipelineCache) {
+        return;
+    }
+
+    size_t size = 0;
+    VkResult result = GR_VK_CALL(fGpu->vkInterface(), GetPipelineCacheData(fGpu->device(),
+                                                                            fPipelineCache,
+                                                                            &size, nullptr));
+    if (VK_SUCCESS != result || 0 == size) {
+        return;
+    }
+    SkAutoMalloc data(size);
+    result = GR_VK_CALL(fGpu->vkInterface(), GetPipelineCacheData(fGpu->device(), fPipelineCache,
+                                                                  &size, data.get()));
+    if (VK_SUCCESS != result) {
+        return;
+    }
+    cache->store(*this->pipelineCacheKey(), *SkData::MakeWithoutCopy(data.get(), size));
+}
+
 void GrVkResourceProvider::abandonResources() {
     // release our active command buffers
     for (int i = 0; i < fActiveCommandBuffers.count(); ++i) {
@@ -324,6 +413,15 @@ void GrVkResourceProvider::abandonResources() {
         fActiveCommandBuffers[i]->unrefAndAbandon();
     }
     fActiveCommandBuffers.reset();
+    // release our recycled uniform buffers
+    for (int i = 0; i < fInFlightUniformBufferResources.count(); ++i) {
+        fInFlightUniformBufferResources[i]->unrefAndAbandon();
+    }
+    fInFlightUniformBufferResources.reset();
+    for (int i = 0; i < fAvailableUniformBufferResources.count(); ++i) {
+        fAvailableUniformBufferResources[i]->unrefAndAbandon();
+    }
+    fAvailableUniformBufferResources.reset();
     // release our available command buffers
     for (int i = 0; i < fAvailableCommandBuffers.count(); ++i) {
         SkASSERT(fAvailableCommandBuffers[i]->finished(fGpu));
@@ -31,6 +31,7 @@ class GrVkPrimaryCommandBuffer;
 class GrVkRenderTarget;
 class GrVkSampler;
 class GrVkSecondaryCommandBuffer;
+class SkData;
 
 class GrVkResourceProvider {
 public:
@@ -112,12 +113,23 @@ public:
     // when the caller needs the layout to create a VkPipelineLayout.
     VkDescriptorSetLayout getUniDSLayout() const { return fUniformDescLayout; }
 
+    // Returns a uniform buffer resource of GrVkUniformBuffer::kStandardSize that no command buffer
+    // is using, creating one if none of the recycled ones are free. The caller owns the ref.
+    const GrVkResource* findOrCreateStandardUniformBufferResource();
+    // Takes over the caller's ref on a standard uniform buffer resource. It's handed out again
+    // once the command buffers using it have finished.
+    void recycleStandardUniformBufferResource(const GrVkResource*);
+
     // Destroy any cached resources. To be called before destroying the VkDevice.
     // The assumption is that all queues are idle and all command buffers are finished.
     // For resource tracing to work properly, this should be called after unrefing all other
     // resource usages.
     void destroyResources();
 
+    // Saves the pipeline cache's contents to the client's persistent cache, if there is one, so
+    // the next context made on this device can start with them.  destroyResources() does this too.
+    void storePipelineCacheData();
+
     // Abandon any cached resources. To be used when the context/VkDevice is lost.
     // For resource tracing to work properly, this should be called after unrefing all other
     // resource usages.
@@ -196,6 +208,9 @@ private:
     // Initialiaze the vkDescriptorSetLayout used for allocating new uniform buffer descritpor sets.
     void initUniformDescObjects();
 
+    // The key our pipeline cache's data is persisted under, identifying the device and driver.
+    sk_sp<SkData> pipelineCacheKey() const;
+
     GrVkGpu* fGpu;
 
     // Central cache for creating pipelines
@@ -211,6 +226,11 @@ private:
     // Array of available secondary command buffers
     SkSTArray<16, GrVkSecondaryCommandBuffer*> fAvailableSecondaryCommandBuffers;
 
+    // Recycled standard uniform buffers that command buffers may still be reading, and ones that
+    // are free to be written again
+    SkTArray<const GrVkResource*, true> fInFlightUniformBufferResources;
+    SkTArray<const GrVkResource*, true> fAvailableUniformBufferResources;
+
     // Stores GrVkSampler objects that we've already created so we can reuse them across multiple
     // GrVkPipelineStates
     SkTDynamicHash<GrVkSampler, uint16_t> fSamplers;
@@ -18,14 +18,48 @@ GrVkUniformBuffer* GrVkUniformBuffer::Create(GrVkGpu* gpu, size_t size, bool dyn
     desc.fType = GrVkBuffer::kUniform_Type;
     desc.fSizeInBytes = size;
 
-    const GrVkBuffer::Resource* bufferResource = GrVkBuffer::Create(gpu, desc);
+    bool standard = dynamic && size <= kStandardSize;
+    const GrVkBuffer::Resource* bufferResource;
+    if (standard) {
+        bufferResource = static_cast<const GrVkBuffer::Resource*>(
+                gpu->resourceProvider().findOrCreateStandardUniformBufferResource());
+    } else {
+        bufferResource = GrVkBuffer::Create(gpu, desc);
+    }
     if (!bufferResource) {
         return nullptr;
     }
 
-    GrVkUniformBuffer* buffer = new GrVkUniformBuffer(desc, bufferResource);
+    GrVkUniformBuffer* buffer = new GrVkUniformBuffer(desc, bufferResource, standard);
     if (!buffer) {
         bufferResource->unref(gpu);
     }
     return buffer;
-}
\ No newline at end of file
+}
+
+const GrVkResource* GrVkUniformBuffer::CreateStandardResource(GrVkGpu* gpu) {
+    GrVkBuffer::Desc desc;
+    desc.fDynamic = true;
+    desc.fType = GrVkBuffer::kUniform_Type;
+    desc.fSizeInBytes = kStandardSize;
+    return GrVkBuffer::Create(gpu, desc);
+}
+
+bool GrVkUniformBuffer::updateData(GrVkGpu* gpu, const void* src, size_t srcSizeInBytes,
+                                   bool* createdNewBuffer) {
+    if (fStandard && !this->resource()->unique()) {
+        // A command buffer still has to read the old contents. Rather than have vkUpdateData()
+        // make a new VkBuffer, trade this one for a recycled one that's free.
+        GrVkResourceProvider& resourceProvider = gpu->resourceProvider();
+        const GrVkResource* resource = resourceProvider.findOrCreateStandardUniformBufferResource();
+        if (!resource) {
+            return false;
+        }
+        resourceProvider.recycleStandardUniformBufferResource(
+                this->vkReplaceResource(static_cast<const GrVkBuffer::Resource*>(resource)));
+        if (createdNewBuffer) {
+            *createdNewBuffer = true;
+        }
+    }
+    return this->vkUpdateData(gpu, src, srcSizeInBytes, createdNewBuffer);
+}
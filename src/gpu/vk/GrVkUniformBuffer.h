@@ -15,8 +15,15 @@ class GrVkGpu;
 class GrVkUniformBuffer : public GrVkBuffer {
 
 public:
+    // Dynamic uniform buffers no larger than this all use VkBuffers of exactly this size, which
+    // GrVkResourceProvider recycles between them once the command buffers reading them finish.
+    static const size_t kStandardSize = 256;
+
     static GrVkUniformBuffer* Create(GrVkGpu* gpu, size_t size, bool dynamic);
 
+    // Makes a new VkBuffer of kStandardSize. Only for use by GrVkResourceProvider.
+    static const GrVkResource* CreateStandardResource(GrVkGpu* gpu);
+
     void* map(const GrVkGpu* gpu) {
         return this->vkMap(gpu);
     }
@@ -26,9 +33,7 @@ public:
     // The output variable createdNewBuffer must be set to true if a new VkBuffer is created in
     // order to upload the data
     bool updateData(GrVkGpu* gpu, const void* src, size_t srcSizeInBytes,
-                    bool* createdNewBuffer) {
-        return this->vkUpdateData(gpu, src, srcSizeInBytes, createdNewBuffer);
-    }
+                    bool* createdNewBuffer);
     void release(const GrVkGpu* gpu) {
         this->vkRelease(gpu);
     }
@@ -37,10 +42,14 @@ public:
     }
 
 private:
-    GrVkUniformBuffer(const GrVkBuffer::Desc& desc, const GrVkBuffer::Resource* resource)
-        : INHERITED(desc, resource) {
+    GrVkUniformBuffer(const GrVkBuffer::Desc& desc, const GrVkBuffer::Resource* resource,
+                      bool standard)
+        : INHERITED(desc, resource)
+        , fStandard(standard) {
     };
 
+    bool fStandard;
+
     typedef GrVkBuffer INHERITED;
 };
 
@@ -7,6 +7,7 @@
 
 #include "SkBitmap.h"
 #include "SkBitmapCache.h"
+#include "SkBitmapScaler.h"
 #include "SkCanvas.h"
 #include "SkData.h"
 #include "SkImageEncoder.h"
@@ -15,14 +16,17 @@
 #include "SkImagePriv.h"
 #include "SkImageShader.h"
 #include "SkImage_Base.h"
+#include "SkMipMap.h"
 #include "SkNextID.h"
 #include "SkPicture.h"
 #include "SkPixelRef.h"
 #include "SkPixelSerializer.h"
 #include "SkReadPixelsRec.h"
+#include "SkResourceCache.h"
 #include "SkSpecialImage.h"
 #include "SkString.h"
 #include "SkSurface.h"
+#include "SkTaskGroup.h"
 
 #if SK_SUPPORT_GPU
 #include "GrTexture.h"
@@ -104,6 +108,66 @@ void SkImage::preroll(GrContext* ctx) const {
     }
 }
 
+// Decodes image into the bitmap cache and, if drawSize differs from its size, prepares the scaled
+// form that SkBitmapController will look for when drawing it at that size.
+static void preroll_at_size(const SkImage* image, const SkISize& drawSize) {
+    SkBitmap bm;
+    if (!as_IB(image)->getROPixels(&bm) || drawSize == image->dimensions() || drawSize.isEmpty() ||
+        kN32_SkColorType != bm.colorType()) {
+        return;
+    }
+
+    const int w = image->width(),
+              h = image->height();
+    if (drawSize.width() <= w && drawSize.height() <= h) {
+        // Drawn smaller: build the mip level it'll sample.
+        SkAutoTUnref<const SkMipMap> mipmap(SkMipMapCache::FindAndRef(
+                SkBitmapCacheDesc::Make(image), SkSourceGammaTreatment::kIgnore));
+        if (!mipmap) {
+            mipmap.reset(SkMipMapCache::AddAndRef(bm, SkSourceGammaTreatment::kIgnore));
+            if (!mipmap) {
+                return;
+            }
+            as_IB(image)->notifyAddedToCache();
+        }
+        SkMipMap::Level level;
+        (void)mipmap->extractLevel(SkSize::Make(SkIntToScalar(drawSize.width())  / w,
+                                                SkIntToScalar(drawSize.height()) / h), &level);
+    } else if (drawSize.width() >= w && drawSize.height() >= h) {
+        // Drawn larger: high quality upscales are cached at their size.
+        const SkBitmapCacheDesc desc = SkBitmapCacheDesc::Make(image, drawSize.width(),
+                                                               drawSize.height());
+        SkBitmap scaled;
+        if (SkBitmapCache::FindWH(desc, &scaled)) {
+            return;
+        }
+        SkAutoPixmapUnlock src;
+        if (!bm.requestLock(&src) ||
+            !SkBitmapScaler::Resize(&scaled, src.pixmap(), SkBitmapScaler::RESIZE_MITCHELL,
+                                    drawSize.width(), drawSize.height(),
+                                    SkResourceCache::GetAllocator())) {
+            return;
+        }
+        scaled.setImmutable();
+        if (SkBitmapCache::AddWH(desc, scaled)) {
+            as_IB(image)->notifyAddedToCache();
+        }
+    }
+}
+
+void SkImage::prerollAsync(const SkISize* drawSize) const {
+    if (!as_IB(this)->peekCacherator()) {
+        return;  // Raster and texture backed images have nothing to decode.
+    }
+
+    // Never waited on; the tasks just hold refs to their images until they're done.
+    static SkTaskGroup* gPrerollTasks = new SkTaskGroup;
+
+    sk_sp<SkImage> image = sk_ref_sp(const_cast<SkImage*>(this));
+    const SkISize size = drawSize ? *drawSize : this->dimensions();
+    gPrerollTasks->add([image, size] { preroll_at_size(image.get(), size); });
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 sk_sp<SkShader> SkImage::makeShader(SkShader::TileMode tileX, SkShader::TileMode tileY,
@@ -427,6 +491,20 @@ sk_sp<SkImage> SkImage::MakeFromYUVTexturesCopy(GrContext* ctx, SkYUVColorSpace
     return nullptr;
 }
 
+sk_sp<SkImage> SkImage::MakeFromNV12TexturesCopy(GrContext* ctx, SkYUVColorSpace space,
+                                                 const GrBackendObject nv12TextureHandles[2],
+                                                 const SkISize nv12Sizes[2],
+                                                 GrSurfaceOrigin origin) {
+    return nullptr;
+}
+
+sk_sp<SkImage> SkImage::MakeFromNV21TexturesCopy(GrContext* ctx, SkYUVColorSpace space,
+                                                 const GrBackendObject nv21TextureHandles[2],
+                                                 const SkISize nv21Sizes[2],
+                                                 GrSurfaceOrigin origin) {
+    return nullptr;
+}
+
 sk_sp<SkImage> SkImage::makeTextureImage(GrContext*) const {
     return nullptr;
 }
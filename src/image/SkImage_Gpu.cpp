@@ -205,11 +205,12 @@ sk_sp<SkImage> SkImage::MakeFromTextureCopy(GrContext* ctx, const GrBackendTextu
 }
 
 static sk_sp<SkImage> make_from_yuv_textures_copy(GrContext* ctx, SkYUVColorSpace colorSpace,
-                                                  bool nv12,
+                                                  GrYUVEffect::PlaneLayout layout,
                                                   const GrBackendObject yuvTextureHandles[],
                                                   const SkISize yuvSizes[],
                                                   GrSurfaceOrigin origin) {
     const SkBudgeted budgeted = SkBudgeted::kYes;
+    const bool nv12 = GrYUVEffect::PlaneLayout::kYUV != layout;
 
     if (yuvSizes[0].fWidth <= 0 || yuvSizes[0].fHeight <= 0 || yuvSizes[1].fWidth <= 0 ||
         yuvSizes[1].fHeight <= 0) {
@@ -276,7 +277,7 @@ static sk_sp<SkImage> make_from_yuv_textures_copy(GrContext* ctx, SkYUVColorSpac
     GrPaint paint;
     paint.setPorterDuffXPFactory(SkXfermode::kSrc_Mode);
     paint.addColorFragmentProcessor(
-        GrYUVEffect::MakeYUVToRGB(yTex.get(), uTex.get(), vTex.get(), yuvSizes, colorSpace, nv12));
+        GrYUVEffect::MakeYUVToRGB(yTex.get(), uTex.get(), vTex.get(), yuvSizes, colorSpace, layout));
 
     const SkRect rect = SkRect::MakeWH(SkIntToScalar(width), SkIntToScalar(height));
 
@@ -290,14 +291,24 @@ static sk_sp<SkImage> make_from_yuv_textures_copy(GrContext* ctx, SkYUVColorSpac
 sk_sp<SkImage> SkImage::MakeFromYUVTexturesCopy(GrContext* ctx, SkYUVColorSpace colorSpace,
                                                 const GrBackendObject yuvTextureHandles[3],
                                                 const SkISize yuvSizes[3], GrSurfaceOrigin origin) {
-    return make_from_yuv_textures_copy(ctx, colorSpace, false, yuvTextureHandles, yuvSizes, origin);
+    return make_from_yuv_textures_copy(ctx, colorSpace, GrYUVEffect::PlaneLayout::kYUV,
+                                       yuvTextureHandles, yuvSizes, origin);
 }
 
 sk_sp<SkImage> SkImage::MakeFromNV12TexturesCopy(GrContext* ctx, SkYUVColorSpace colorSpace,
                                                  const GrBackendObject yuvTextureHandles[2],
                                                  const SkISize yuvSizes[2],
                                                  GrSurfaceOrigin origin) {
-    return make_from_yuv_textures_copy(ctx, colorSpace, true, yuvTextureHandles, yuvSizes, origin);
+    return make_from_yuv_textures_copy(ctx, colorSpace, GrYUVEffect::PlaneLayout::kNV12,
+                                       yuvTextureHandles, yuvSizes, origin);
+}
+
+sk_sp<SkImage> SkImage::MakeFromNV21TexturesCopy(GrContext* ctx, SkYUVColorSpace colorSpace,
+                                                 const GrBackendObject yuvTextureHandles[2],
+                                                 const SkISize yuvSizes[2],
+                                                 GrSurfaceOrigin origin) {
+    return make_from_yuv_textures_copy(ctx, colorSpace, GrYUVEffect::PlaneLayout::kNV21,
+                                       yuvTextureHandles, yuvSizes, origin);
 }
 
 static sk_sp<SkImage> create_image_from_maker(GrTextureMaker* maker, SkAlphaType at, uint32_t id) {
@@ -86,11 +86,20 @@ void SkSurface_Base::onDraw(SkCanvas* canvas, SkScalar x, SkScalar y, const SkPa
     }
 }
 
+bool SkSurface_Base::onPeekPixels(SkPixmap* pmap) {
+    return this->getCachedCanvas()->peekPixels(pmap);
+}
+
+bool SkSurface_Base::onReadPixels(const SkImageInfo& dstInfo, void* dstPixels, size_t dstRowBytes,
+                                  int srcX, int srcY) {
+    return this->getCachedCanvas()->readPixels(dstInfo, dstPixels, dstRowBytes, srcX, srcY);
+}
+
 bool SkSurface_Base::outstandingImageSnapshot() const {
     return fCachedImage && !fCachedImage->unique();
 }
 
-void SkSurface_Base::aboutToDraw(ContentChangeMode mode) {
+void SkSurface_Base::aboutToDraw(ContentChangeMode mode, const SkIRect* dirtyBounds) {
     this->dirtyGenerationID();
 
     SkASSERT(!fCachedCanvas || fCachedCanvas->getSurfaceBase() == this);
@@ -118,6 +127,9 @@ void SkSurface_Base::aboutToDraw(ContentChangeMode mode) {
     } else if (kDiscard_ContentChangeMode == mode) {
         this->onDiscard();
     }
+
+    // Discarded contents are all changed, whatever the draw that follows touches.
+    this->onContentWillChange(kDiscard_ContentChangeMode == mode ? nullptr : dirtyBounds);
 }
 
 uint32_t SkSurface_Base::newGenerationID() {
@@ -183,7 +195,7 @@ void SkSurface::draw(SkCanvas* canvas, SkScalar x, SkScalar y,
 }
 
 bool SkSurface::peekPixels(SkPixmap* pmap) {
-    return this->getCanvas()->peekPixels(pmap);
+    return asSB(this)->onPeekPixels(pmap);
 }
 
 #ifdef SK_SUPPORT_LEGACY_PEEKPIXELS_PARMS
@@ -204,7 +216,7 @@ const void* SkSurface::peekPixels(SkImageInfo* info, size_t* rowBytes) {
 
 bool SkSurface::readPixels(const SkImageInfo& dstInfo, void* dstPixels, size_t dstRowBytes,
                            int srcX, int srcY) {
-    return this->getCanvas()->readPixels(dstInfo, dstPixels, dstRowBytes, srcX, srcY);
+    return asSB(this)->onReadPixels(dstInfo, dstPixels, dstRowBytes, srcX, srcY);
 }
 
 GrBackendObject SkSurface::getTextureHandle(BackendHandleAccess access) {
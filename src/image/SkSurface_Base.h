@@ -75,11 +75,25 @@ public:
      */
     virtual void onRestoreBackingMutability() {}
 
+    /**
+     *  Called before every change to the surface's contents, after any copy-on-write, with
+     *  device-space bounds that the change stays within, or null if it may touch any pixel.
+     */
+    virtual void onContentWillChange(const SkIRect* dirtyBounds) {}
+
     /**
      * Issue any pending surface IO to the current backend 3D API and resolve any surface MSAA.
      */
     virtual void onPrepareForExternalIO() {}
 
+    /**
+     *  Default implementations forward to the cached canvas. Surfaces whose canvas does not
+     *  draw directly into their pixels (e.g. deferred or threaded raster) override these.
+     */
+    virtual bool onPeekPixels(SkPixmap*);
+    virtual bool onReadPixels(const SkImageInfo& dstInfo, void* dstPixels, size_t dstRowBytes,
+                              int srcX, int srcY);
+
     inline SkCanvas* getCachedCanvas();
     inline sk_sp<SkImage> refCachedImage(SkBudgeted, ForceUnique);
 
@@ -92,7 +106,7 @@ private:
     SkCanvas*   fCachedCanvas;
     SkImage*    fCachedImage;
 
-    void aboutToDraw(ContentChangeMode mode);
+    void aboutToDraw(ContentChangeMode mode, const SkIRect* dirtyBounds = nullptr);
 
     // Returns true if there is an outstanding image-snapshot, indicating that a call to aboutToDraw
     // would trigger a copy-on-write.
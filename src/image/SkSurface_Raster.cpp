@@ -28,12 +28,27 @@ public:
     void onDraw(SkCanvas*, SkScalar x, SkScalar y, const SkPaint*) override;
     void onCopyOnWrite(ContentChangeMode) override;
     void onRestoreBackingMutability() override;
+    void onContentWillChange(const SkIRect* dirtyBounds) override;
 
 private:
+    // Copy-on-write is tracked in square tiles of this many pixels.
+    static const int kTileSize = 64;
+
+    int tileCountX() const { return (fBitmap.width()  + kTileSize - 1) / kTileSize; }
+    int tileCountY() const { return (fBitmap.height() + kTileSize - 1) / kTileSize; }
+
+    void copyDirtyTiles(const SkBitmap& src);
+
     SkBitmap    fBitmap;
     size_t      fRowBytes;
     bool        fWeOwnThePixels;
 
+    // After a copy-on-write we hold on to the pixels we left with the snapshot.  Once that
+    // snapshot is gone, the next copy-on-write reuses them, copying only the tiles that have
+    // changed since (those non-zero in fDirtyTiles) rather than every pixel.
+    SkAutoTUnref<SkPixelRef>    fSparePixels;
+    SkAutoTMalloc<uint8_t>      fDirtyTiles;
+
     typedef SkSurface_Base INHERITED;
 };
 
@@ -147,18 +162,36 @@ void SkSurface_Raster::onCopyOnWrite(ContentChangeMode mode) {
     SkASSERT(cached);
     if (SkBitmapImageGetPixelRef(cached.get()) == fBitmap.pixelRef()) {
         SkASSERT(fWeOwnThePixels);
-        if (kDiscard_ContentChangeMode == mode) {
-            fBitmap.allocPixels();
+        SkBitmap prev(fBitmap);
+        prev.lockPixels();
+
+        if (fSparePixels && fSparePixels->unique()) {
+            // The snapshot we last copied away from is gone; its pixels differ from ours only in
+            // the dirty tiles.
+            SkPixelRef* spare = fSparePixels.release();
+            spare->restoreMutability();
+            spare->notifyPixelsChanged();
+            fBitmap.setPixelRef(spare)->unref();
+            fBitmap.lockPixels();
+            if (kRetain_ContentChangeMode == mode) {
+                this->copyDirtyTiles(prev);
+            }
         } else {
-            SkBitmap prev(fBitmap);
             fBitmap.allocPixels();
-            prev.lockPixels();
-            SkASSERT(prev.info() == fBitmap.info());
-            SkASSERT(prev.rowBytes() == fBitmap.rowBytes());
-            memcpy(fBitmap.getPixels(), prev.getPixels(), fBitmap.getSafeSize());
+            if (kRetain_ContentChangeMode == mode) {
+                SkASSERT(prev.info() == fBitmap.info());
+                SkASSERT(prev.rowBytes() == fBitmap.rowBytes());
+                memcpy(fBitmap.getPixels(), prev.getPixels(), fBitmap.getSafeSize());
+            }
         }
         SkASSERT(fBitmap.rowBytes() == fRowBytes);  // be sure we always use the same value
 
+        // Our pixels now match the snapshot's, so nothing is dirty relative to them.
+        fSparePixels.reset(SkRef(prev.pixelRef()));
+        const int tileCount = this->tileCountX() * this->tileCountY();
+        fDirtyTiles.reset(tileCount);
+        sk_bzero(fDirtyTiles.get(), tileCount);
+
         // Now fBitmap is a deep copy of itself (and therefore different from
         // what is being used by the image. Next we update the canvas to use
         // this as its backend, so we can't modify the image's pixels anymore.
@@ -167,6 +200,56 @@ void SkSurface_Raster::onCopyOnWrite(ContentChangeMode mode) {
     }
 }
 
+void SkSurface_Raster::onContentWillChange(const SkIRect* dirtyBounds) {
+    if (!fSparePixels) {
+        return;
+    }
+    const int tilesX = this->tileCountX();
+    SkIRect tiles = SkIRect::MakeWH(tilesX, this->tileCountY());
+    if (dirtyBounds) {
+        SkIRect bounds = *dirtyBounds;
+        if (!bounds.intersect(SkIRect::MakeWH(fBitmap.width(), fBitmap.height()))) {
+            return;
+        }
+        tiles.setLTRB(bounds.fLeft / kTileSize, bounds.fTop / kTileSize,
+                      (bounds.fRight  - 1) / kTileSize + 1,
+                      (bounds.fBottom - 1) / kTileSize + 1);
+    }
+    for (int y = tiles.fTop; y < tiles.fBottom; y++) {
+        memset(&fDirtyTiles[y * tilesX + tiles.fLeft], 1, tiles.width());
+    }
+}
+
+void SkSurface_Raster::copyDirtyTiles(const SkBitmap& src) {
+    SkASSERT(src.info() == fBitmap.info());
+    SkASSERT(src.rowBytes() == fBitmap.rowBytes());
+    const int tilesX = this->tileCountX(),
+              tilesY = this->tileCountY();
+    const size_t bpp = fBitmap.bytesPerPixel();
+    for (int ty = 0; ty < tilesY; ty++) {
+        const uint8_t* dirty = &fDirtyTiles[ty * tilesX];
+        const int top    = ty * kTileSize,
+                  bottom = SkTMin(top + kTileSize, fBitmap.height());
+        // Copy each run of dirty tiles in this row of tiles a scanline at a time.
+        for (int tx = 0; tx < tilesX; ) {
+            if (!dirty[tx]) {
+                tx++;
+                continue;
+            }
+            int end = tx + 1;
+            while (end < tilesX && dirty[end]) {
+                end++;
+            }
+            const int left  = tx * kTileSize,
+                      right = SkTMin(end * kTileSize, fBitmap.width());
+            for (int y = top; y < bottom; y++) {
+                memcpy(fBitmap.getAddr(left, y), src.getAddr(left, y), (right - left) * bpp);
+            }
+            tx = end;
+        }
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 sk_sp<SkSurface> SkSurface::MakeRasterDirectReleaseProc(const SkImageInfo& info, void* pixels,
@@ -0,0 +1,254 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkSurface_Base.h"
+#include "SkClipStack.h"
+#include "SkImagePriv.h"
+#include "SkMallocPixelRef.h"
+#include "SkRTree.h"
+#include "SkRecord.h"
+#include "SkRecordDraw.h"
+#include "SkRecorder.h"
+#include "SkTaskGroup.h"
+
+// A raster surface whose canvas is an SkRecorder.  Draws are buffered in an SkRecord and only
+// rasterized when someone needs the pixels.  At that point we compute bounds for every op, load
+// them into an SkRTree, and replay each tile of the surface on its own SkTaskGroup worker with
+// its own canvas (and so its own blitters) over a subset of the surface's pixels.
+class SkSurface_ThreadedRaster : public SkSurface_Base {
+public:
+    SkSurface_ThreadedRaster(SkPixelRef*, int tileSize, const SkSurfaceProps*);
+
+    SkCanvas* onNewCanvas() override;
+    sk_sp<SkSurface> onNewSurface(const SkImageInfo&) override;
+    sk_sp<SkImage> onNewImageSnapshot(SkBudgeted, ForceCopyMode) override;
+    void onDraw(SkCanvas*, SkScalar x, SkScalar y, const SkPaint*) override;
+    void onCopyOnWrite(ContentChangeMode) override;
+    void onRestoreBackingMutability() override;
+    void onPrepareForExternalIO() override;
+    bool onPeekPixels(SkPixmap*) override;
+    bool onReadPixels(const SkImageInfo&, void*, size_t, int, int) override;
+
+private:
+    // Rasterize everything recorded since the last flush into fBitmap.
+    void flushPendingDraws();
+
+    SkRecorder* recorder() { return static_cast<SkRecorder*>(this->getCachedCanvas()); }
+
+    SkBitmap           fBitmap;
+    const int          fTileSize;
+    sk_sp<SkRecord>    fRecord;
+
+    // When a flush happens with saves outstanding we can't start a fresh SkRecord without losing
+    // the save stack, so we keep recording into the same one.  Draws before fFlushedOps have
+    // already landed in fBitmap; only the state ops (save, restore, matrix, clip) among them
+    // are replayed on the next flush.
+    int                fFlushedOps;
+
+    typedef SkSurface_Base INHERITED;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// Replays clips, already in device space, onto a fresh recorder.
+class ClipReplayer : public SkCanvasClipVisitor {
+public:
+    explicit ClipReplayer(SkCanvas* canvas) : fCanvas(canvas) {}
+
+    void clipRect(const SkRect& r, SkRegion::Op op, bool aa) override {
+        fCanvas->clipRect(r, op, aa);
+    }
+    void clipRRect(const SkRRect& rr, SkRegion::Op op, bool aa) override {
+        fCanvas->clipRRect(rr, op, aa);
+    }
+    void clipPath(const SkPath& path, SkRegion::Op op, bool aa) override {
+        fCanvas->clipPath(path, op, aa);
+    }
+
+private:
+    SkCanvas* fCanvas;
+};
+
+struct IsDraw {
+    template <typename T>
+    bool operator()(const T&) { return SkToBool(T::kTags & SkRecords::kDraw_Tag); }
+};
+
+}  // namespace
+
+SkSurface_ThreadedRaster::SkSurface_ThreadedRaster(SkPixelRef* pr, int tileSize,
+                                                   const SkSurfaceProps* props)
+    : INHERITED(pr->info().width(), pr->info().height(), props)
+    , fTileSize(tileSize)
+    , fRecord(new SkRecord)
+    , fFlushedOps(0) {
+    fBitmap.setInfo(pr->info(), pr->rowBytes());
+    fBitmap.setPixelRef(pr);
+    // Keep our pixels locked for our lifetime, as SkSurface_Raster's canvas does.
+    fBitmap.lockPixels();
+}
+
+SkCanvas* SkSurface_ThreadedRaster::onNewCanvas() {
+    return new SkRecorder(fRecord.get(), SkRect::MakeIWH(this->width(), this->height()));
+}
+
+sk_sp<SkSurface> SkSurface_ThreadedRaster::onNewSurface(const SkImageInfo& info) {
+    return SkSurface::MakeRasterThreaded(info, fTileSize, &this->props());
+}
+
+void SkSurface_ThreadedRaster::flushPendingDraws() {
+    const int count = fRecord->count();
+    if (count == fFlushedOps) {
+        return;
+    }
+
+    SkRecorder* recorder = this->recorder();
+
+    // Drawables may not be thread safe, so we draw immutable snapshots of them instead.
+    SkAutoTDelete<SkBigPicture::SnapshotArray> drawablePicts;
+    if (recorder->getDrawableList()) {
+        drawablePicts.reset(recorder->getDrawableList()->newDrawableSnapshot());
+    }
+    SkPicture const* const* picts = drawablePicts ? drawablePicts->begin() : nullptr;
+    const int pictCount = drawablePicts ? drawablePicts->count() : 0;
+
+    const SkRect bounds = SkRect::MakeIWH(this->width(), this->height());
+    SkAutoTMalloc<SkRect> opBounds(count);
+    SkRecordFillBounds(bounds, *fRecord, opBounds.get());
+    SkRTree rtree;
+    rtree.insert(opBounds.get(), count);
+
+    const int tilesX = (this->width()  + fTileSize - 1) / fTileSize,
+              tilesY = (this->height() + fTileSize - 1) / fTileSize;
+
+    SkTaskGroup().batch(tilesX * tilesY, [&](int i) {
+        SkIRect tile = SkIRect::MakeXYWH((i % tilesX) * fTileSize, (i / tilesX) * fTileSize,
+                                         fTileSize, fTileSize);
+        SkBitmap subset;
+        if (!tile.intersect(fBitmap.bounds()) || !fBitmap.extractSubset(&subset, tile)) {
+            return;
+        }
+        SkCanvas canvas(subset, this->props());
+        canvas.translate(-SkIntToScalar(tile.fLeft), -SkIntToScalar(tile.fTop));
+
+        SkTDArray<int> ops;
+        rtree.search(SkRect::Make(tile), &ops);
+
+        SkAutoCanvasRestore acr(&canvas, true);
+        SkRecords::Draw draw(&canvas, picts, nullptr, pictCount);
+        for (int j = 0; j < ops.count(); j++) {
+            if (ops[j] < fFlushedOps && fRecord->visit(ops[j], IsDraw())) {
+                continue;
+            }
+            fRecord->visit(ops[j], draw);
+        }
+    });
+
+    if (recorder->getSaveCount() > 1) {
+        fFlushedOps = count;
+        return;
+    }
+
+    // No saves outstanding, so start over with an empty record carrying just the current
+    // base-level matrix and clip.
+    const SkMatrix ctm = recorder->getTotalMatrix();
+    const SkClipStack clips(*recorder->getClipStack());
+
+    fRecord.reset(new SkRecord);
+    fFlushedOps = 0;
+    recorder->reset(fRecord.get(), bounds, SkRecorder::Record_DrawPictureMode);
+
+    ClipReplayer replayer(recorder);
+    SkClipStack::B2TIter iter(clips);
+    while (const SkClipStack::Element* element = iter.next()) {
+        element->replay(&replayer);
+    }
+    recorder->setMatrix(ctm);
+}
+
+sk_sp<SkImage> SkSurface_ThreadedRaster::onNewImageSnapshot(SkBudgeted, ForceCopyMode mode) {
+    this->flushPendingDraws();
+    // Like SkSurface_Raster, share our pixels with the snapshot until we draw again.
+    if (SkPixelRef* pr = fBitmap.pixelRef()) {
+        pr->setTemporarilyImmutable();
+    }
+    return SkMakeImageFromRasterBitmap(fBitmap, mode);
+}
+
+void SkSurface_ThreadedRaster::onDraw(SkCanvas* canvas, SkScalar x, SkScalar y,
+                                      const SkPaint* paint) {
+    this->flushPendingDraws();
+    canvas->drawBitmap(fBitmap, x, y, paint);
+}
+
+void SkSurface_ThreadedRaster::onRestoreBackingMutability() {
+    SkASSERT(!this->hasCachedImage());
+    if (SkPixelRef* pr = fBitmap.pixelRef()) {
+        pr->restoreMutability();
+    }
+}
+
+void SkSurface_ThreadedRaster::onCopyOnWrite(ContentChangeMode mode) {
+    // Nothing has been rasterized since the snapshot, so all we need is a private copy of the
+    // pixels for the next flush to draw into.  Our canvas holds no reference to them.
+    sk_sp<SkImage> cached(this->refCachedImage(SkBudgeted::kNo, kNo_ForceUnique));
+    SkASSERT(cached);
+    if (SkBitmapImageGetPixelRef(cached.get()) == fBitmap.pixelRef()) {
+        SkBitmap prev(fBitmap);
+        fBitmap.allocPixels();
+        if (kRetain_ContentChangeMode == mode) {
+            prev.lockPixels();
+            SkASSERT(prev.info() == fBitmap.info());
+            SkASSERT(prev.rowBytes() == fBitmap.rowBytes());
+            memcpy(fBitmap.getPixels(), prev.getPixels(), fBitmap.getSafeSize());
+        }
+    }
+}
+
+void SkSurface_ThreadedRaster::onPrepareForExternalIO() {
+    this->flushPendingDraws();
+}
+
+bool SkSurface_ThreadedRaster::onPeekPixels(SkPixmap* pmap) {
+    this->flushPendingDraws();
+    return fBitmap.peekPixels(pmap);
+}
+
+bool SkSurface_ThreadedRaster::onReadPixels(const SkImageInfo& dstInfo, void* dstPixels,
+                                            size_t dstRowBytes, int srcX, int srcY) {
+    this->flushPendingDraws();
+    return fBitmap.readPixels(dstInfo, dstPixels, dstRowBytes, srcX, srcY);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+sk_sp<SkSurface> SkSurface::MakeRasterThreaded(const SkImageInfo& info, int tileSize,
+                                               const SkSurfaceProps* props) {
+    if (info.isEmpty() || tileSize <= 0) {
+        return nullptr;
+    }
+    switch (info.colorType()) {
+        case kAlpha_8_SkColorType:
+        case kRGB_565_SkColorType:
+        case kN32_SkColorType:
+        case kRGBA_F16_SkColorType:
+            break;
+        default:
+            return nullptr;
+    }
+    if (sk_64_mul(info.height(), info.minRowBytes()) > SK_MaxS32) {
+        return nullptr;
+    }
+
+    SkAutoTUnref<SkPixelRef> pr(SkMallocPixelRef::NewZeroed(info, 0, nullptr));
+    if (nullptr == pr.get()) {
+        return nullptr;
+    }
+    return sk_make_sp<SkSurface_ThreadedRaster>(pr, tileSize, props);
+}
@@ -45,6 +45,20 @@ static void Write_32_RGB(uint8_t* SK_RESTRICT dst,
     }
 }
 
+// The 8888 color type that isn't N32 has R and B the other way around.
+static void Write_32_BGR(uint8_t* SK_RESTRICT dst,
+                         const void* SK_RESTRICT srcRow, int width,
+                         const SkPMColor*) {
+    const uint32_t* SK_RESTRICT src = (const uint32_t*)srcRow;
+    while (--width >= 0) {
+        uint32_t c = *src++;
+        dst[0] = SkGetPackedB32(c);
+        dst[1] = SkGetPackedG32(c);
+        dst[2] = SkGetPackedR32(c);
+        dst += 3;
+    }
+}
+
 static void Write_4444_RGB(uint8_t* SK_RESTRICT dst,
                            const void* SK_RESTRICT srcRow, int width,
                            const SkPMColor*) {
@@ -84,16 +98,32 @@ static void Write_Index_RGB(uint8_t* SK_RESTRICT dst,
     }
 }
 
+static void Write_Gray_RGB(uint8_t* SK_RESTRICT dst,
+                           const void* SK_RESTRICT srcRow, int width,
+                           const SkPMColor*) {
+    const uint8_t* SK_RESTRICT src = (const uint8_t*)srcRow;
+    while (--width >= 0) {
+        uint8_t g = *src++;
+        dst[0] = g;
+        dst[1] = g;
+        dst[2] = g;
+        dst += 3;
+    }
+}
+
 static WriteScanline ChooseWriter(const SkBitmap& bm) {
     switch (bm.colorType()) {
-        case kN32_SkColorType:
-            return Write_32_RGB;
+        case kRGBA_8888_SkColorType:
+        case kBGRA_8888_SkColorType:
+            return kN32_SkColorType == bm.colorType() ? Write_32_RGB : Write_32_BGR;
         case kRGB_565_SkColorType:
             return Write_16_RGB;
         case kARGB_4444_SkColorType:
             return Write_4444_RGB;
         case kIndex_8_SkColorType:
             return Write_Index_RGB;
+        case kGray_8_SkColorType:
+            return Write_Gray_RGB;
         default:
             return nullptr;
     }
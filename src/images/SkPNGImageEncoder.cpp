@@ -9,14 +9,18 @@
 #include "SkColor.h"
 #include "SkColorPriv.h"
 #include "SkDither.h"
+#include "SkEndian.h"
 #include "SkMath.h"
+#include "SkPNGEncoder.h"
 #include "SkRTConf.h"
 #include "SkStream.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 #include "SkUtils.h"
 #include "transform_scanline.h"
 
 #include "png.h"
+#include "zlib.h"
 
 /* These were dropped in libpng >= 1.4 */
 #ifndef png_infopp_NULL
@@ -61,33 +65,31 @@ static void sk_write_fn(png_structp png_ptr, png_bytep data, png_size_t len) {
     }
 }
 
-static transform_scanline_proc choose_proc(SkColorType ct, bool hasAlpha) {
-    // we don't care about search on alpha if we're kIndex8, since only the
-    // colortable packing cares about that distinction, not the pixels
-    if (kIndex_8_SkColorType == ct) {
-        hasAlpha = false;   // we store false in the table entries for kIndex8
-    }
-
-    static const struct {
-        SkColorType             fColorType;
-        bool                    fHasAlpha;
-        transform_scanline_proc fProc;
-    } gMap[] = {
-        { kRGB_565_SkColorType,     false,  transform_scanline_565 },
-        { kN32_SkColorType,         false,  transform_scanline_888 },
-        { kN32_SkColorType,         true,   transform_scanline_8888 },
-        { kARGB_4444_SkColorType,   false,  transform_scanline_444 },
-        { kARGB_4444_SkColorType,   true,   transform_scanline_4444 },
-        { kIndex_8_SkColorType,     false,  transform_scanline_memcpy },
-    };
-
-    for (int i = SK_ARRAY_COUNT(gMap) - 1; i >= 0; --i) {
-        if (gMap[i].fColorType == ct && gMap[i].fHasAlpha == hasAlpha) {
-            return gMap[i].fProc;
-        }
+// Rows are converted one at a time, so no color type needs a full copy of the image.
+static transform_scanline_proc choose_proc(SkColorType ct, SkAlphaType at) {
+    const bool opaque = kOpaque_SkAlphaType == at;
+    const bool premul = kPremul_SkAlphaType == at;
+    switch (ct) {
+        case kRGB_565_SkColorType:
+            return transform_scanline_565;
+        case kRGBA_8888_SkColorType:
+            return opaque ? transform_scanline_RGBX
+                          : premul ? transform_scanline_rgbA : transform_scanline_RGBA;
+        case kBGRA_8888_SkColorType:
+            return opaque ? transform_scanline_BGRX
+                          : premul ? transform_scanline_bgrA : transform_scanline_BGRA;
+        case kARGB_4444_SkColorType:
+            return opaque ? transform_scanline_444 : transform_scanline_4444;
+        case kIndex_8_SkColorType:
+            // Only the colortable packing cares about alpha, not the pixels.
+            return transform_scanline_memcpy;
+        case kGray_8_SkColorType:
+            return transform_scanline_gray;
+        case kAlpha_8_SkColorType:
+            return opaque ? nullptr : transform_scanline_A8_to_RGBA;
+        default:
+            return nullptr;
     }
-    sk_throw();
-    return nullptr;
 }
 
 // return the minimum legal bitdepth (by png standards) for this many colortable
@@ -162,102 +164,22 @@ static inline int pack_palette(SkColorTable* ctable,
     return num_trans;
 }
 
-class SkPNGImageEncoder : public SkImageEncoder {
-protected:
-    bool onEncode(SkWStream* stream, const SkBitmap& bm, int quality) override;
-private:
-    bool doEncode(SkWStream* stream, const SkBitmap& bm,
-                  const bool& hasAlpha, int colorType,
-                  int bitDepth, SkColorType ct,
-                  png_color_8& sig_bit);
-
-    typedef SkImageEncoder INHERITED;
-};
-
-bool SkPNGImageEncoder::onEncode(SkWStream* stream,
-                                 const SkBitmap& originalBitmap,
-                                 int /*quality*/) {
-    SkBitmap copy;
-    const SkBitmap* bitmap = &originalBitmap;
-    switch (originalBitmap.colorType()) {
-        case kIndex_8_SkColorType:
-        case kN32_SkColorType:
-        case kARGB_4444_SkColorType:
-        case kRGB_565_SkColorType:
-            break;
-        default:
-            // TODO(scroggo): support 8888-but-not-N32 natively.
-            // TODO(scroggo): support kGray_8 directly.
-            // TODO(scroggo): support Alpha_8 as Grayscale(black)+Alpha
-            if (originalBitmap.copyTo(&copy, kN32_SkColorType)) {
-                bitmap = &copy;
-            }
-    }
-    SkColorType ct = bitmap->colorType();
-
-    const bool hasAlpha = !bitmap->isOpaque();
-    int colorType = PNG_COLOR_MASK_COLOR;
-    int bitDepth = 8;   // default for color
-    png_color_8 sig_bit;
-
-    switch (ct) {
-        case kIndex_8_SkColorType:
-            colorType |= PNG_COLOR_MASK_PALETTE;
-            // fall through to the ARGB_8888 case
-        case kN32_SkColorType:
-            sig_bit.red = 8;
-            sig_bit.green = 8;
-            sig_bit.blue = 8;
-            sig_bit.alpha = 8;
-            break;
-        case kARGB_4444_SkColorType:
-            sig_bit.red = 4;
-            sig_bit.green = 4;
-            sig_bit.blue = 4;
-            sig_bit.alpha = 4;
-            break;
-        case kRGB_565_SkColorType:
-            sig_bit.red = 5;
-            sig_bit.green = 6;
-            sig_bit.blue = 5;
-            sig_bit.alpha = 0;
-            break;
-        default:
-            return false;
-    }
-
-    if (hasAlpha) {
-        // don't specify alpha if we're a palette, even if our ctable has alpha
-        if (!(colorType & PNG_COLOR_MASK_PALETTE)) {
-            colorType |= PNG_COLOR_MASK_ALPHA;
-        }
-    } else {
-        sig_bit.alpha = 0;
-    }
-
-    SkAutoLockPixels alp(*bitmap);
-    // readyToDraw checks for pixels (and colortable if that is required)
-    if (!bitmap->readyToDraw()) {
-        return false;
-    }
-
-    // we must do this after we have locked the pixels
-    SkColorTable* ctable = bitmap->getColorTable();
-    if (ctable) {
-        if (ctable->count() == 0) {
-            return false;
-        }
-        // check if we can store in fewer than 8 bits
-        bitDepth = computeBitDepth(ctable->count());
+static int zlib_strategy(SkPNGEncoder::Strategy strategy, bool filtered) {
+    switch (strategy) {
+        case SkPNGEncoder::kAuto_Strategy:        return filtered ? Z_FILTERED
+                                                                  : Z_DEFAULT_STRATEGY;
+        case SkPNGEncoder::kDefault_Strategy:     return Z_DEFAULT_STRATEGY;
+        case SkPNGEncoder::kFiltered_Strategy:    return Z_FILTERED;
+        case SkPNGEncoder::kHuffmanOnly_Strategy: return Z_HUFFMAN_ONLY;
+        case SkPNGEncoder::kRLE_Strategy:         return Z_RLE;
     }
-
-    return doEncode(stream, *bitmap, hasAlpha, colorType, bitDepth, ct, sig_bit);
+    return Z_DEFAULT_STRATEGY;
 }
 
-bool SkPNGImageEncoder::doEncode(SkWStream* stream, const SkBitmap& bitmap,
-                  const bool& hasAlpha, int colorType,
-                  int bitDepth, SkColorType ct,
-                  png_color_8& sig_bit) {
+static bool libpng_encode(SkWStream* stream, const SkPixmap& pixmap,
+                          transform_scanline_proc proc, const bool& hasAlpha, int colorType,
+                          int bitDepth, png_color_8& sig_bit,
+                          const SkPNGEncoder::Options& options) {
 
     png_structp png_ptr;
     png_infop info_ptr;
@@ -283,6 +205,10 @@ bool SkPNGImageEncoder::doEncode(SkWStream* stream, const SkBitmap& bitmap,
     }
 
     png_set_write_fn(png_ptr, (void*)stream, sk_write_fn, png_flush_ptr_NULL);
+    png_set_compression_level(png_ptr, options.fZLibLevel);
+    if (SkPNGEncoder::kAuto_Strategy != options.fStrategy) {
+        png_set_compression_strategy(png_ptr, zlib_strategy(options.fStrategy, true));
+    }
 
     /* Set the image information here.  Width and height are up to 2^31,
     * bit_depth is one of 1, 2, 4, 8, or 16, but valid values also depend on
@@ -293,7 +219,7 @@ bool SkPNGImageEncoder::doEncode(SkWStream* stream, const SkBitmap& bitmap,
     * currently be PNG_COMPRESSION_TYPE_BASE and PNG_FILTER_TYPE_BASE. REQUIRED
     */
 
-    png_set_IHDR(png_ptr, info_ptr, bitmap.width(), bitmap.height(),
+    png_set_IHDR(png_ptr, info_ptr, pixmap.width(), pixmap.height(),
                  bitDepth, colorType,
                  PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_BASE,
                  PNG_FILTER_TYPE_BASE);
@@ -301,8 +227,8 @@ bool SkPNGImageEncoder::doEncode(SkWStream* stream, const SkBitmap& bitmap,
     // set our colortable/trans arrays if needed
     png_color paletteColors[256];
     png_byte trans[256];
-    if (kIndex_8_SkColorType == ct) {
-        SkColorTable* ct = bitmap.getColorTable();
+    if (kIndex_8_SkColorType == pixmap.colorType()) {
+        SkColorTable* ct = pixmap.ctable();
         int numTrans = pack_palette(ct, paletteColors, trans, hasAlpha);
         png_set_PLTE(png_ptr, info_ptr, paletteColors, ct->count());
         if (numTrans > 0) {
@@ -314,16 +240,15 @@ bool SkPNGImageEncoder::doEncode(SkWStream* stream, const SkBitmap& bitmap,
 #endif
     png_write_info(png_ptr, info_ptr);
 
-    const char* srcImage = (const char*)bitmap.getPixels();
-    SkAutoSTMalloc<1024, char> rowStorage(bitmap.width() << 2);
+    const char* srcImage = (const char*)pixmap.addr();
+    SkAutoSTMalloc<1024, char> rowStorage(pixmap.width() << 2);
     char* storage = rowStorage.get();
-    transform_scanline_proc proc = choose_proc(ct, hasAlpha);
 
-    for (int y = 0; y < bitmap.height(); y++) {
+    for (int y = 0; y < pixmap.height(); y++) {
         png_bytep row_ptr = (png_bytep)storage;
-        proc(srcImage, bitmap.width(), storage);
+        proc(srcImage, pixmap.width(), storage);
         png_write_rows(png_ptr, &row_ptr, 1);
-        srcImage += bitmap.rowBytes();
+        srcImage += pixmap.rowBytes();
     }
 
     png_write_end(png_ptr, info_ptr);
@@ -333,6 +258,351 @@ bool SkPNGImageEncoder::doEncode(SkWStream* stream, const SkBitmap& bitmap,
     return true;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Banded encoding: rows are filtered and deflated in independent bands on
+// SkTaskGroup threads, and we write the chunks ourselves.  Each band but the
+// last ends with a sync flush, so the raw deflate streams concatenate into one.
+
+// Roughly how many filtered bytes each band compresses; images smaller than
+// two bands are left to libpng.
+static const size_t kBandBytes = 256 * 1024;
+// Deflate can refer back this far, so each band is primed with this much of the last.
+static const size_t kDeflateWindow = 32 * 1024;
+
+enum {
+    kNone_Filter,
+    kSub_Filter,
+    kUp_Filter,
+    kAverage_Filter,
+    kPaeth_Filter,
+    kFilterCount
+};
+
+static inline uint8_t paeth(int a, int b, int c) {
+    int p = a + b - c;
+    int pa = SkAbs32(p - a);
+    int pb = SkAbs32(p - b);
+    int pc = SkAbs32(p - c);
+    if (pa <= pb && pa <= pc) {
+        return a;
+    }
+    return pb <= pc ? b : c;
+}
+
+// Filter row into dst with the given filter.  Returns the sum of the filtered bytes taken
+// as signed values, the cost libpng's heuristic minimizes.  The loops are simple enough
+// for the compiler to vectorize.
+static uint32_t filter_row(int filter, const uint8_t* SK_RESTRICT row,
+                           const uint8_t* SK_RESTRICT prev, size_t rowBytes, int bpp,
+                           uint8_t* SK_RESTRICT dst) {
+    size_t i = 0;
+    switch (filter) {
+        case kNone_Filter:
+            memcpy(dst, row, rowBytes);
+            break;
+        case kSub_Filter:
+            for (; i < (size_t)bpp; ++i) { dst[i] = row[i]; }
+            for (; i < rowBytes; ++i) { dst[i] = row[i] - row[i - bpp]; }
+            break;
+        case kUp_Filter:
+            for (; i < rowBytes; ++i) { dst[i] = row[i] - prev[i]; }
+            break;
+        case kAverage_Filter:
+            for (; i < (size_t)bpp; ++i) { dst[i] = row[i] - (prev[i] >> 1); }
+            for (; i < rowBytes; ++i) { dst[i] = row[i] - ((row[i - bpp] + prev[i]) >> 1); }
+            break;
+        case kPaeth_Filter:
+            for (; i < (size_t)bpp; ++i) { dst[i] = row[i] - prev[i]; }
+            for (; i < rowBytes; ++i) {
+                dst[i] = row[i] - paeth(row[i - bpp], prev[i], prev[i - bpp]);
+            }
+            break;
+    }
+    uint32_t cost = 0;
+    for (i = 0; i < rowBytes; ++i) {
+        cost += SkAbs32((int8_t)dst[i]);
+    }
+    return cost;
+}
+
+static bool write_chunk(SkWStream* stream, const char type[4],
+                        const void* data, size_t length) {
+    uint32_t header[2] = { SkEndian_SwapBE32(SkToU32(length)), 0 };
+    memcpy(&header[1], type, 4);
+    uLong crc = crc32(0, (const Bytef*)type, 4);
+    crc = crc32(crc, (const Bytef*)data, SkToU32(length));
+    uint32_t trailer = SkEndian_SwapBE32(SkToU32(crc));
+    return stream->write(header, sizeof(header)) &&
+           stream->write(data, length) &&
+           stream->write(&trailer, sizeof(trailer));
+}
+
+static bool banded_encode(SkWStream* stream, const SkPixmap& pixmap,
+                          transform_scanline_proc proc, const bool& hasAlpha, int colorType,
+                          int bitDepth, png_color_8& sig_bit,
+                          const SkPNGEncoder::Options& options) {
+    SkASSERT(8 == bitDepth);
+    const bool isPalette = SkToBool(colorType & PNG_COLOR_MASK_PALETTE);
+    const int bpp = isPalette ? 1 : (colorType & PNG_COLOR_MASK_ALPHA) ? 4 : 3;
+    const int width = pixmap.width();
+    const int height = pixmap.height();
+    const size_t rowBytes = width * bpp;
+    const size_t filteredRowBytes = rowBytes + 1;   // Each row leads with its filter type.
+    const int rowsPerBand = SkTMax<int>(1, SkToInt(kBandBytes / filteredRowBytes));
+    const int bandCount = (height + rowsPerBand - 1) / rowsPerBand;
+
+    // First filter all the rows, each band on its own.  As libpng does, palette images are
+    // left unfiltered, and other rows get whichever filter costs least.
+    SkAutoTMalloc<uint8_t> filtered(filteredRowBytes * height);
+    SkTaskGroup().batch(bandCount, [&](int band) {
+        SkAutoTMalloc<uint8_t> storage((width << 2) * 2 + rowBytes * kFilterCount);
+        uint8_t* row = storage.get();
+        uint8_t* prev = row + (width << 2);
+        uint8_t* candidates = prev + (width << 2);
+
+        const int top = band * rowsPerBand;
+        const int bottom = SkTMin(height, top + rowsPerBand);
+        if (top > 0) {
+            proc((const char*)pixmap.addr(0, top - 1), width, (char*)prev);
+        } else {
+            memset(prev, 0, rowBytes);
+        }
+        for (int y = top; y < bottom; ++y) {
+            proc((const char*)pixmap.addr(0, y), width, (char*)row);
+            uint8_t* dst = filtered.get() + y * filteredRowBytes;
+            if (isPalette) {
+                dst[0] = kNone_Filter;
+                memcpy(dst + 1, row, rowBytes);
+            } else {
+                int best = kNone_Filter;
+                uint32_t bestCost = filter_row(kNone_Filter, row, prev, rowBytes, bpp,
+                                               candidates);
+                for (int filter = kSub_Filter; filter < kFilterCount; ++filter) {
+                    uint32_t cost = filter_row(filter, row, prev, rowBytes, bpp,
+                                               candidates + filter * rowBytes);
+                    if (cost < bestCost) {
+                        best = filter;
+                        bestCost = cost;
+                    }
+                }
+                dst[0] = best;
+                memcpy(dst + 1, candidates + best * rowBytes, rowBytes);
+            }
+            SkTSwap(row, prev);
+        }
+    });
+
+    // Then deflate each band, primed with the end of the band before it.
+    struct Band {
+        SkAutoTMalloc<uint8_t> fData;
+        size_t                 fSize;
+        uLong                  fAdler;
+        bool                   fGood;
+    };
+    SkAutoTArray<Band> bands(bandCount);
+    const int strategy = zlib_strategy(options.fStrategy, !isPalette);
+    SkTaskGroup().batch(bandCount, [&](int index) {
+        Band& band = bands[index];
+        band.fGood = false;
+        const size_t start = index * rowsPerBand * filteredRowBytes;
+        const size_t end = SkTMin<size_t>(start + rowsPerBand * filteredRowBytes,
+                                          filteredRowBytes * height);
+        const uint8_t* src = filtered.get() + start;
+
+        z_stream z;
+        memset(&z, 0, sizeof(z));
+        if (Z_OK != deflateInit2(&z, options.fZLibLevel, Z_DEFLATED, -MAX_WBITS, 8,
+                                 strategy)) {
+            return;
+        }
+        if (start > 0) {
+            size_t dictionary = SkTMin(start, kDeflateWindow);
+            deflateSetDictionary(&z, src - dictionary, SkToU32(dictionary));
+        }
+        // A sync flush adds an empty stored block: 5 bytes, plus whatever was pending.
+        const size_t capacity = deflateBound(&z, SkToU32(end - start)) + 16;
+        band.fData.reset(capacity);
+        z.next_in = const_cast<Bytef*>(src);
+        z.avail_in = SkToU32(end - start);
+        z.next_out = band.fData.get();
+        z.avail_out = SkToU32(capacity);
+        const bool last = index == bandCount - 1;
+        int result = deflate(&z, last ? Z_FINISH : Z_SYNC_FLUSH);
+        band.fGood = (last ? Z_STREAM_END == result : Z_OK == result) &&
+                     0 == z.avail_in && z.avail_out > 0;
+        band.fSize = capacity - z.avail_out;
+        band.fAdler = adler32(adler32(0, nullptr, 0), src, SkToU32(end - start));
+        deflateEnd(&z);
+    });
+
+    uLong adler = adler32(0, nullptr, 0);
+    for (int i = 0; i < bandCount; ++i) {
+        if (!bands[i].fGood) {
+            return false;
+        }
+        size_t bandLength = SkTMin<size_t>(rowsPerBand, height - i * rowsPerBand) *
+                            filteredRowBytes;
+        adler = adler32_combine(adler, bands[i].fAdler, bandLength);
+    }
+
+    // Now write it all out, in the order libpng would.
+    static const uint8_t kSignature[] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+    bool good = stream->write(kSignature, sizeof(kSignature));
+
+    uint8_t ihdr[13];
+    uint32_t w = SkEndian_SwapBE32(width),
+             h = SkEndian_SwapBE32(height);
+    memcpy(ihdr + 0, &w, 4);
+    memcpy(ihdr + 4, &h, 4);
+    ihdr[8] = bitDepth;
+    ihdr[9] = colorType;
+    ihdr[10] = PNG_COMPRESSION_TYPE_BASE;
+    ihdr[11] = PNG_FILTER_TYPE_BASE;
+    ihdr[12] = PNG_INTERLACE_NONE;
+    good = good && write_chunk(stream, "IHDR", ihdr, sizeof(ihdr));
+
+    const uint8_t sbit[] = { sig_bit.red, sig_bit.green, sig_bit.blue, sig_bit.alpha };
+    good = good && write_chunk(stream, "sBIT", sbit,
+                               (colorType & PNG_COLOR_MASK_ALPHA) ? 4 : 3);
+
+    if (kIndex_8_SkColorType == pixmap.colorType()) {
+        png_color paletteColors[256];
+        png_byte trans[256];
+        SkColorTable* ctable = pixmap.ctable();
+        int numTrans = pack_palette(ctable, paletteColors, trans, hasAlpha);
+        good = good && write_chunk(stream, "PLTE", paletteColors,
+                                   ctable->count() * sizeof(png_color));
+        if (numTrans > 0) {
+            good = good && write_chunk(stream, "tRNS", trans, numTrans);
+        }
+    }
+
+    // The zlib header goes in front of the first band, and the checksum after the last.
+    static const int kLevelFlags[] = { 0, 0, 1, 1, 1, 1, 2, 3, 3, 3 };
+    uint8_t zlibHeader[2] = { 0x78, (uint8_t)(kLevelFlags[options.fZLibLevel] << 6) };
+    zlibHeader[1] += 31 - ((zlibHeader[0] << 8) + zlibHeader[1]) % 31;
+    uint32_t zlibTrailer = SkEndian_SwapBE32(SkToU32(adler));
+    for (int i = 0; i < bandCount && good; ++i) {
+        const Band& band = bands[i];
+        if (0 == i || i == bandCount - 1) {
+            SkAutoTMalloc<uint8_t> idat(band.fSize + sizeof(zlibHeader) + sizeof(zlibTrailer));
+            uint8_t* dst = idat.get();
+            if (0 == i) {
+                memcpy(dst, zlibHeader, sizeof(zlibHeader));
+                dst += sizeof(zlibHeader);
+            }
+            memcpy(dst, band.fData.get(), band.fSize);
+            dst += band.fSize;
+            if (i == bandCount - 1) {
+                memcpy(dst, &zlibTrailer, sizeof(zlibTrailer));
+                dst += sizeof(zlibTrailer);
+            }
+            good = write_chunk(stream, "IDAT", idat.get(), dst - idat.get());
+        } else {
+            good = write_chunk(stream, "IDAT", band.fData.get(), band.fSize);
+        }
+    }
+    return good && write_chunk(stream, "IEND", nullptr, 0);
+}
+
+bool SkPNGEncoder::Encode(SkWStream* stream, const SkPixmap& pixmap, const Options& options) {
+    if (!pixmap.addr() || pixmap.width() <= 0 || pixmap.height() <= 0) {
+        return false;
+    }
+    transform_scanline_proc proc = choose_proc(pixmap.colorType(), pixmap.alphaType());
+    if (!proc) {
+        // Anything we can't convert a row at a time (e.g. F16) is encoded from an N32 copy.
+        SkBitmap original, copy;
+        if (!original.installPixels(pixmap) || !original.copyTo(&copy, kN32_SkColorType)) {
+            return false;
+        }
+        SkAutoLockPixels alp(copy);
+        SkPixmap copyPixmap;
+        return copy.peekPixels(&copyPixmap) && Encode(stream, copyPixmap, options);
+    }
+
+    const bool hasAlpha = !pixmap.isOpaque();
+    int colorType = PNG_COLOR_MASK_COLOR;
+    int bitDepth = 8;   // default for color
+    png_color_8 sig_bit;
+
+    switch (pixmap.colorType()) {
+        case kIndex_8_SkColorType:
+            colorType |= PNG_COLOR_MASK_PALETTE;
+            // fall through to the ARGB_8888 case
+        case kRGBA_8888_SkColorType:
+        case kBGRA_8888_SkColorType:
+        case kGray_8_SkColorType:
+        case kAlpha_8_SkColorType:
+            sig_bit.red = 8;
+            sig_bit.green = 8;
+            sig_bit.blue = 8;
+            sig_bit.alpha = 8;
+            break;
+        case kARGB_4444_SkColorType:
+            sig_bit.red = 4;
+            sig_bit.green = 4;
+            sig_bit.blue = 4;
+            sig_bit.alpha = 4;
+            break;
+        case kRGB_565_SkColorType:
+            sig_bit.red = 5;
+            sig_bit.green = 6;
+            sig_bit.blue = 5;
+            sig_bit.alpha = 0;
+            break;
+        default:
+            return false;
+    }
+
+    if (hasAlpha) {
+        // don't specify alpha if we're a palette, even if our ctable has alpha
+        if (!(colorType & PNG_COLOR_MASK_PALETTE)) {
+            colorType |= PNG_COLOR_MASK_ALPHA;
+        }
+    } else {
+        sig_bit.alpha = 0;
+    }
+
+    SkColorTable* ctable = pixmap.ctable();
+    if (kIndex_8_SkColorType == pixmap.colorType()) {
+        if (!ctable || ctable->count() == 0) {
+            return false;
+        }
+        // check if we can store in fewer than 8 bits
+        bitDepth = computeBitDepth(ctable->count());
+    }
+
+    SkPNGEncoder::Options clamped = options;
+    clamped.fZLibLevel = SkTPin(options.fZLibLevel, 0, 9);
+
+    const size_t filteredBytes = (size_t)pixmap.height() * (pixmap.width() * 4 + 1);
+    if (options.fMultiThreaded && 8 == bitDepth && filteredBytes >= 2 * kBandBytes) {
+        return banded_encode(stream, pixmap, proc, hasAlpha, colorType, bitDepth, sig_bit,
+                             clamped);
+    }
+    return libpng_encode(stream, pixmap, proc, hasAlpha, colorType, bitDepth, sig_bit,
+                         clamped);
+}
+
+bool SkPNGEncoder::Encode(SkWStream* stream, const SkBitmap& bitmap, const Options& options) {
+    SkAutoPixmapUnlock src;
+    if (!bitmap.requestLock(&src)) {
+        return false;
+    }
+    return Encode(stream, src.pixmap(), options);
+}
+
+class SkPNGImageEncoder : public SkImageEncoder {
+protected:
+    bool onEncode(SkWStream* stream, const SkBitmap& bm, int /*quality*/) override {
+        return SkPNGEncoder::Encode(stream, bm, SkPNGEncoder::Options());
+    }
+
+private:
+    typedef SkImageEncoder INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 DEFINE_ENCODER_CREATOR(PNGImageEncoder);
 ///////////////////////////////////////////////////////////////////////////////
@@ -12,6 +12,7 @@
 #include "SkBitmap.h"
 #include "SkColor.h"
 #include "SkColorPriv.h"
+#include "SkOpts.h"
 #include "SkPreConfig.h"
 #include "SkUnPreMultiply.h"
 
@@ -48,17 +49,45 @@ static void transform_scanline_565(const char* SK_RESTRICT src, int width,
 }
 
 /**
- * Transform from kARGB_8888_Config to 3-bytes-per-pixel RGB.
+ * Transform from kRGBA_8888_SkColorType to 3-bytes-per-pixel RGB.
  * Alpha channel data, if any, is abandoned.
  */
-static void transform_scanline_888(const char* SK_RESTRICT src, int width,
-                                   char* SK_RESTRICT dst) {
-    const SkPMColor* SK_RESTRICT srcP = (const SkPMColor*)src;
+static void transform_scanline_RGBX(const char* SK_RESTRICT src, int width,
+                                    char* SK_RESTRICT dst) {
+    const uint32_t* SK_RESTRICT srcP = (const uint32_t*)src;
+    for (int i = 0; i < width; i++) {
+        uint32_t c = *srcP++;
+        *dst++ = (c >>  0) & 0xFF;
+        *dst++ = (c >>  8) & 0xFF;
+        *dst++ = (c >> 16) & 0xFF;
+    }
+}
+
+/**
+ * Transform from kBGRA_8888_SkColorType to 3-bytes-per-pixel RGB.
+ * Alpha channel data, if any, is abandoned.
+ */
+static void transform_scanline_BGRX(const char* SK_RESTRICT src, int width,
+                                    char* SK_RESTRICT dst) {
+    const uint32_t* SK_RESTRICT srcP = (const uint32_t*)src;
+    for (int i = 0; i < width; i++) {
+        uint32_t c = *srcP++;
+        *dst++ = (c >> 16) & 0xFF;
+        *dst++ = (c >>  8) & 0xFF;
+        *dst++ = (c >>  0) & 0xFF;
+    }
+}
+
+/**
+ * Transform from kGray_8_SkColorType to 3-bytes-per-pixel RGB.
+ */
+static void transform_scanline_gray(const char* SK_RESTRICT src, int width,
+                                    char* SK_RESTRICT dst) {
     for (int i = 0; i < width; i++) {
-        SkPMColor c = *srcP++;
-        *dst++ = SkGetPackedR32(c);
-        *dst++ = SkGetPackedG32(c);
-        *dst++ = SkGetPackedB32(c);
+        const char g = *src++;
+        *dst++ = g;
+        *dst++ = g;
+        *dst++ = g;
     }
 }
 
@@ -78,33 +107,52 @@ static void transform_scanline_444(const char* SK_RESTRICT src, int width,
 }
 
 /**
- * Transform from kARGB_8888_Config to 4-bytes-per-pixel RGBA.
- * (This would be the identity transformation, except for byte-order and
- * scaling of RGB based on alpha channel).
+ * Transform from premultiplied kRGBA_8888_SkColorType to 4-bytes-per-pixel
+ * unpremultiplied RGBA.
  */
-static void transform_scanline_8888(const char* SK_RESTRICT src, int width,
+static void transform_scanline_rgbA(const char* SK_RESTRICT src, int width,
                                     char* SK_RESTRICT dst) {
-    const SkPMColor* SK_RESTRICT srcP = (const SkPMColor*)src;
-    const SkUnPreMultiply::Scale* SK_RESTRICT table =
-                                              SkUnPreMultiply::GetScaleTable();
+    SkOpts::rgbA_to_RGBA((uint32_t*)dst, src, width);
+}
 
-    for (int i = 0; i < width; i++) {
-        SkPMColor c = *srcP++;
-        unsigned a = SkGetPackedA32(c);
-        unsigned r = SkGetPackedR32(c);
-        unsigned g = SkGetPackedG32(c);
-        unsigned b = SkGetPackedB32(c);
+/**
+ * Transform from premultiplied kBGRA_8888_SkColorType to 4-bytes-per-pixel
+ * unpremultiplied RGBA.
+ */
+static void transform_scanline_bgrA(const char* SK_RESTRICT src, int width,
+                                    char* SK_RESTRICT dst) {
+    SkOpts::rgbA_to_BGRA((uint32_t*)dst, src, width);
+}
 
-        if (0 != a && 255 != a) {
-            SkUnPreMultiply::Scale scale = table[a];
-            r = SkUnPreMultiply::ApplyScale(scale, r);
-            g = SkUnPreMultiply::ApplyScale(scale, g);
-            b = SkUnPreMultiply::ApplyScale(scale, b);
-        }
-        *dst++ = r;
-        *dst++ = g;
-        *dst++ = b;
-        *dst++ = a;
+/**
+ * Transform from unpremultiplied kRGBA_8888_SkColorType to 4-bytes-per-pixel
+ * RGBA: just copy the bytes.
+ */
+static void transform_scanline_RGBA(const char* SK_RESTRICT src, int width,
+                                    char* SK_RESTRICT dst) {
+    memcpy(dst, src, width * 4);
+}
+
+/**
+ * Transform from unpremultiplied kBGRA_8888_SkColorType to 4-bytes-per-pixel
+ * RGBA: just swap R and B.
+ */
+static void transform_scanline_BGRA(const char* SK_RESTRICT src, int width,
+                                    char* SK_RESTRICT dst) {
+    SkOpts::RGBA_to_BGRA((uint32_t*)dst, src, width);
+}
+
+/**
+ * Transform from kAlpha_8_SkColorType to 4-bytes-per-pixel RGBA, as black
+ * with that alpha.
+ */
+static void transform_scanline_A8_to_RGBA(const char* SK_RESTRICT src, int width,
+                                          char* SK_RESTRICT dst) {
+    for (int i = 0; i < width; i++) {
+        *dst++ = 0;
+        *dst++ = 0;
+        *dst++ = 0;
+        *dst++ = *src++;
     }
 }
 
@@ -10,7 +10,13 @@
 #include "SkImageGenerator.h"
 #include "SkMutex.h"
 #include "SkOnce.h"
+#include "SkSemaphore.h"
+#include "SkString.h"
 #include "SkTInternalLList.h"
+#include "SkThreadUtils.h"
+#include "SkTraceMemoryDump.h"
+
+#include <atomic>
 
 // Note:
 // A PoolDiscardableMemory is memory that is counted in a pool.
@@ -29,36 +35,54 @@ public:
     /**
      *  Without mutex, will be not be thread safe.
      */
-    DiscardableMemoryPool(size_t budget, SkBaseMutex* mutex = nullptr);
+    DiscardableMemoryPool(size_t budget, SkBaseMutex* mutex = nullptr,
+                          bool purgeInBackground = false);
     virtual ~DiscardableMemoryPool();
 
     SkDiscardableMemory* create(size_t bytes) override;
 
     size_t getRAMUsed() override;
     void setRAMBudget(size_t budget) override;
-    size_t getRAMBudget() override { return fBudget; }
+    size_t getRAMBudget() override { return fBudget.load(std::memory_order_relaxed); }
 
     /** purges all unlocked DMs */
     void dumpPool() override;
 
     #if SK_LAZY_CACHE_STATS  // Defined in SkDiscardableMemoryPool.h
-    int getCacheHits() override { return fCacheHits; }
-    int getCacheMisses() override { return fCacheMisses; }
+    int getCacheHits() override { return fCacheHits.load(std::memory_order_relaxed); }
+    int getCacheMisses() override { return fCacheMisses.load(std::memory_order_relaxed); }
     void resetCacheHitsAndMisses() override {
-        fCacheHits = fCacheMisses = 0;
+        fCacheHits.store(0, std::memory_order_relaxed);
+        fCacheMisses.store(0, std::memory_order_relaxed);
     }
-    int          fCacheHits;
-    int          fCacheMisses;
+    std::atomic<int> fCacheHits;
+    std::atomic<int> fCacheMisses;
     #endif  // SK_LAZY_CACHE_STATS
 
+    void dumpMemoryStatistics(SkTraceMemoryDump*, const char* dumpName) override;
+
 private:
     SkBaseMutex* fMutex;
-    size_t       fBudget;
-    size_t       fUsed;
+    // Only changed while holding fMutex, but read without it to decide whether to purge.
+    std::atomic<size_t> fBudget;
+    std::atomic<size_t> fUsed;
+    // Roughly least recently used at the tail.  Locking a DM only marks it as recently used;
+    // dumpDownTo() moves it back to the head when it comes across it.
     SkTInternalLList<PoolDiscardableMemory> fList;
+    int          fCount;
+
+    // Set while the purge thread has been asked to run but hasn't yet.
+    std::atomic<bool> fPurgePending;
+    std::atomic<bool> fStopPurging;
+    SkSemaphore       fPurgeRequested;
+    SkAutoTDelete<SkThread> fPurgeThread;
+
+    static void PurgeThreadProc(void* pool);
 
     /** Function called to free memory if needed */
     void dumpDownTo(size_t budget);
+    /** Purges down to budget now, or has the purge thread do it, if we're over budget */
+    void purgeIfNeeded();
     /** called by DiscardableMemoryPool upon destruction */
     void free(PoolDiscardableMemory* dm);
     /** called by DiscardableMemoryPool::lock() */
@@ -85,9 +109,18 @@ public:
     void unlock() override;
     friend class DiscardableMemoryPool;
 private:
+    // A DM goes from locked to unlocked and back on its own.  Only the pool, holding its mutex,
+    // takes an unlocked DM to purged, which it never leaves.
+    enum State {
+        kLocked_State,
+        kUnlocked_State,
+        kPurged_State,
+    };
+
     SK_DECLARE_INTERNAL_LLIST_INTERFACE(PoolDiscardableMemory);
     DiscardableMemoryPool* const fPool;
-    bool                         fLocked;
+    std::atomic<int>             fState;
+    std::atomic<bool>            fRecentlyUsed;
     void*                        fPointer;
     const size_t                 fBytes;
 };
@@ -96,7 +129,8 @@ PoolDiscardableMemory::PoolDiscardableMemory(DiscardableMemoryPool* pool,
                                              void* pointer,
                                              size_t bytes)
     : fPool(pool)
-    , fLocked(true)
+    , fState(kLocked_State)
+    , fRecentlyUsed(false)
     , fPointer(pointer)
     , fBytes(bytes) {
     SkASSERT(fPool != nullptr);
@@ -106,71 +140,116 @@ PoolDiscardableMemory::PoolDiscardableMemory(DiscardableMemoryPool* pool,
 }
 
 PoolDiscardableMemory::~PoolDiscardableMemory() {
-    SkASSERT(!fLocked); // contract for SkDiscardableMemory
+    SkASSERT(kLocked_State != fState.load()); // contract for SkDiscardableMemory
     fPool->free(this);
     fPool->unref();
 }
 
 bool PoolDiscardableMemory::lock() {
-    SkASSERT(!fLocked); // contract for SkDiscardableMemory
+    SkASSERT(kLocked_State != fState.load()); // contract for SkDiscardableMemory
     return fPool->lock(this);
 }
 
 void* PoolDiscardableMemory::data() {
-    SkASSERT(fLocked); // contract for SkDiscardableMemory
+    SkASSERT(kLocked_State == fState.load()); // contract for SkDiscardableMemory
     return fPointer;
 }
 
 void PoolDiscardableMemory::unlock() {
-    SkASSERT(fLocked); // contract for SkDiscardableMemory
+    SkASSERT(kLocked_State == fState.load()); // contract for SkDiscardableMemory
     fPool->unlock(this);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 DiscardableMemoryPool::DiscardableMemoryPool(size_t budget,
-                                             SkBaseMutex* mutex)
+                                             SkBaseMutex* mutex,
+                                             bool purgeInBackground)
     : fMutex(mutex)
     , fBudget(budget)
-    , fUsed(0) {
+    , fUsed(0)
+    , fCount(0)
+    , fPurgePending(false)
+    , fStopPurging(false) {
     #if SK_LAZY_CACHE_STATS
-    fCacheHits = 0;
-    fCacheMisses = 0;
+    fCacheHits.store(0);
+    fCacheMisses.store(0);
     #endif  // SK_LAZY_CACHE_STATS
+    // Without a mutex the purge thread can't safely touch the list.
+    SkASSERT(!purgeInBackground || fMutex);
+    if (purgeInBackground && fMutex) {
+        fPurgeThread.reset(new SkThread(PurgeThreadProc, this));
+        if (!fPurgeThread->start()) {
+            fPurgeThread.reset(nullptr);
+        }
+    }
 }
 DiscardableMemoryPool::~DiscardableMemoryPool() {
+    if (fPurgeThread) {
+        fStopPurging.store(true);
+        fPurgeRequested.signal();
+        fPurgeThread->join();
+    }
     // PoolDiscardableMemory objects that belong to this pool are
     // always deleted before deleting this pool since each one has a
     // ref to the pool.
     SkASSERT(fList.isEmpty());
 }
 
+void DiscardableMemoryPool::PurgeThreadProc(void* p) {
+    DiscardableMemoryPool* pool = static_cast<DiscardableMemoryPool*>(p);
+    for (;;) {
+        pool->fPurgeRequested.wait();
+        if (pool->fStopPurging.load()) {
+            return;
+        }
+        // Clear this first, so going over budget again during the purge asks for another.
+        pool->fPurgePending.store(false);
+        SkAutoMutexAcquire autoMutexAcquire(pool->fMutex);
+        pool->dumpDownTo(pool->fBudget.load(std::memory_order_relaxed));
+    }
+}
+
 void DiscardableMemoryPool::dumpDownTo(size_t budget) {
     if (fMutex != nullptr) {
         fMutex->assertHeld();
     }
-    if (fUsed <= budget) {
+    // Each DM gets a second chance if it was locked since we last saw it, so we look at each at
+    // most twice.  DMs that are locked are in use, so they go back to the head too.
+    for (int i = 2 * fCount; i > 0 && fUsed.load(std::memory_order_relaxed) > budget; --i) {
+        PoolDiscardableMemory* dm = fList.tail();
+        int unlocked = PoolDiscardableMemory::kUnlocked_State;
+        if (dm->fRecentlyUsed.exchange(false, std::memory_order_relaxed) ||
+            !dm->fState.compare_exchange_strong(unlocked, PoolDiscardableMemory::kPurged_State,
+                                                std::memory_order_acquire)) {
+            fList.remove(dm);
+            fList.addToHead(dm);
+            continue;
+        }
+        SkASSERT(dm->fPointer != nullptr);
+        sk_free(dm->fPointer);
+        dm->fPointer = nullptr;
+        SkASSERT(fUsed.load() >= dm->fBytes);
+        fUsed.fetch_sub(dm->fBytes, std::memory_order_relaxed);
+        // Purged DMs are taken out of the list.  This saves times
+        // looking them up.  Purged DMs are NOT deleted.
+        fList.remove(dm);
+        fCount--;
+    }
+}
+
+void DiscardableMemoryPool::purgeIfNeeded() {
+    if (fUsed.load(std::memory_order_relaxed) <= fBudget.load(std::memory_order_relaxed)) {
         return;
     }
-    typedef SkTInternalLList<PoolDiscardableMemory>::Iter Iter;
-    Iter iter;
-    PoolDiscardableMemory* cur = iter.init(fList, Iter::kTail_IterStart);
-    while ((fUsed > budget) && (cur)) {
-        if (!cur->fLocked) {
-            PoolDiscardableMemory* dm = cur;
-            SkASSERT(dm->fPointer != nullptr);
-            sk_free(dm->fPointer);
-            dm->fPointer = nullptr;
-            SkASSERT(fUsed >= dm->fBytes);
-            fUsed -= dm->fBytes;
-            cur = iter.prev();
-            // Purged DMs are taken out of the list.  This saves times
-            // looking them up.  Purged DMs are NOT deleted.
-            fList.remove(dm);
-        } else {
-            cur = iter.prev();
+    if (fPurgeThread) {
+        if (!fPurgePending.exchange(true)) {
+            fPurgeRequested.signal();
         }
+        return;
     }
+    SkAutoMutexAcquire autoMutexAcquire(fMutex);
+    this->dumpDownTo(fBudget.load(std::memory_order_relaxed));
 }
 
 SkDiscardableMemory* DiscardableMemoryPool::create(size_t bytes) {
@@ -179,10 +258,13 @@ SkDiscardableMemory* DiscardableMemoryPool::create(size_t bytes) {
         return nullptr;
     }
     PoolDiscardableMemory* dm = new PoolDiscardableMemory(this, addr, bytes);
-    SkAutoMutexAcquire autoMutexAcquire(fMutex);
-    fList.addToHead(dm);
-    fUsed += bytes;
-    this->dumpDownTo(fBudget);
+    {
+        SkAutoMutexAcquire autoMutexAcquire(fMutex);
+        fList.addToHead(dm);
+        fCount++;
+        fUsed.fetch_add(bytes, std::memory_order_relaxed);
+    }
+    this->purgeIfNeeded();
     return dm;
 }
 
@@ -192,9 +274,10 @@ void DiscardableMemoryPool::free(PoolDiscardableMemory* dm) {
     if (dm->fPointer != nullptr) {
         sk_free(dm->fPointer);
         dm->fPointer = nullptr;
-        SkASSERT(fUsed >= dm->fBytes);
-        fUsed -= dm->fBytes;
+        SkASSERT(fUsed.load() >= dm->fBytes);
+        fUsed.fetch_sub(dm->fBytes, std::memory_order_relaxed);
         fList.remove(dm);
+        fCount--;
     } else {
         SkASSERT(!fList.isInList(dm));
     }
@@ -202,57 +285,77 @@ void DiscardableMemoryPool::free(PoolDiscardableMemory* dm) {
 
 bool DiscardableMemoryPool::lock(PoolDiscardableMemory* dm) {
     SkASSERT(dm != nullptr);
-    SkAutoMutexAcquire autoMutexAcquire(fMutex);
-    if (nullptr == dm->fPointer) {
+    int unlocked = PoolDiscardableMemory::kUnlocked_State;
+    if (!dm->fState.compare_exchange_strong(unlocked, PoolDiscardableMemory::kLocked_State,
+                                            std::memory_order_acquire)) {
         // May have been purged while waiting for lock.
+        SkASSERT(PoolDiscardableMemory::kPurged_State == unlocked);
         #if SK_LAZY_CACHE_STATS
-        ++fCacheMisses;
+        fCacheMisses.fetch_add(1, std::memory_order_relaxed);
         #endif  // SK_LAZY_CACHE_STATS
         return false;
     }
-    dm->fLocked = true;
-    fList.remove(dm);
-    fList.addToHead(dm);
+    dm->fRecentlyUsed.store(true, std::memory_order_relaxed);
     #if SK_LAZY_CACHE_STATS
-    ++fCacheHits;
+    fCacheHits.fetch_add(1, std::memory_order_relaxed);
     #endif  // SK_LAZY_CACHE_STATS
     return true;
 }
 
 void DiscardableMemoryPool::unlock(PoolDiscardableMemory* dm) {
     SkASSERT(dm != nullptr);
-    SkAutoMutexAcquire autoMutexAcquire(fMutex);
-    dm->fLocked = false;
-    this->dumpDownTo(fBudget);
+    dm->fState.store(PoolDiscardableMemory::kUnlocked_State, std::memory_order_release);
+    this->purgeIfNeeded();
 }
 
 size_t DiscardableMemoryPool::getRAMUsed() {
-    return fUsed;
+    return fUsed.load(std::memory_order_relaxed);
 }
 void DiscardableMemoryPool::setRAMBudget(size_t budget) {
     SkAutoMutexAcquire autoMutexAcquire(fMutex);
-    fBudget = budget;
-    this->dumpDownTo(fBudget);
+    fBudget.store(budget, std::memory_order_relaxed);
+    this->dumpDownTo(budget);
 }
 void DiscardableMemoryPool::dumpPool() {
     SkAutoMutexAcquire autoMutexAcquire(fMutex);
     this->dumpDownTo(0);
 }
 
+void DiscardableMemoryPool::dumpMemoryStatistics(SkTraceMemoryDump* dump, const char* dumpName) {
+    SkAutoMutexAcquire autoMutexAcquire(fMutex);
+    // These don't use the "size" value name, so they don't double count the blocks' bytes.
+    dump->dumpNumericValue(dumpName, "ram_used", "bytes", fUsed.load(std::memory_order_relaxed));
+    dump->dumpNumericValue(dumpName, "ram_budget", "bytes",
+                           fBudget.load(std::memory_order_relaxed));
+    dump->dumpNumericValue(dumpName, "count", "objects", fCount);
+    #if SK_LAZY_CACHE_STATS
+    dump->dumpNumericValue(dumpName, "lock_hits", "objects", this->getCacheHits());
+    dump->dumpNumericValue(dumpName, "lock_misses", "objects", this->getCacheMisses());
+    #endif  // SK_LAZY_CACHE_STATS
+}
+
 }  // namespace
 
-SkDiscardableMemoryPool* SkDiscardableMemoryPool::Create(size_t size, SkBaseMutex* mutex) {
-    return new DiscardableMemoryPool(size, mutex);
+SkDiscardableMemoryPool* SkDiscardableMemoryPool::Create(size_t size, SkBaseMutex* mutex,
+                                                         bool purgeInBackground) {
+    return new DiscardableMemoryPool(size, mutex, purgeInBackground);
 }
 
 SK_DECLARE_STATIC_MUTEX(gMutex);
 
+static std::atomic<SkDiscardableMemoryPool*> gGlobalPool{nullptr};
+
 SkDiscardableMemoryPool* SkGetGlobalDiscardableMemoryPool() {
     static SkOnce once;
-    static SkDiscardableMemoryPool* global;
     once([]{
-        global = SkDiscardableMemoryPool::Create(SK_DEFAULT_GLOBAL_DISCARDABLE_MEMORY_POOL_SIZE,
-                                                 &gMutex);
+        gGlobalPool.store(SkDiscardableMemoryPool::Create(
+                SK_DEFAULT_GLOBAL_DISCARDABLE_MEMORY_POOL_SIZE, &gMutex, true));
     });
-    return global;
+    return gGlobalPool.load();
+}
+
+void SkDumpGlobalDiscardableMemoryPoolStatistics(SkTraceMemoryDump* dump) {
+    if (SkDiscardableMemoryPool* pool = gGlobalPool.load()) {
+        pool->dumpMemoryStatistics(dump, "skia/sk_discardable_memory_pool");
+    }
 }
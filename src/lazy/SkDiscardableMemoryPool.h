@@ -11,6 +11,8 @@
 #include "SkDiscardableMemory.h"
 #include "SkMutex.h"
 
+class SkTraceMemoryDump;
+
 #ifndef SK_LAZY_CACHE_STATS
     #ifdef SK_DEBUG
         #define SK_LAZY_CACHE_STATS 1
@@ -24,6 +26,11 @@
  *  budget of memory.  When the allocated memory exceeds this size,
  *  unlocked blocks of memory are purged.  If all memory is locked, it
  *  can exceed the memory-use budget.
+ *
+ *  Locking and unlocking a block only touches that block, so threads
+ *  using different blocks don't contend.  Purging can be left to a
+ *  background thread, in which case the pool may briefly exceed its
+ *  budget.
  */
 class SkDiscardableMemoryPool : public SkDiscardableMemory::Factory {
 public:
@@ -47,21 +54,32 @@ public:
     virtual void resetCacheHitsAndMisses() = 0;
     #endif
 
+    /** Reports the pool's usage, budget and block count under dumpName. */
+    virtual void dumpMemoryStatistics(SkTraceMemoryDump*, const char* dumpName) = 0;
+
     /**
      *  This non-global pool can be used for unit tests to verify that
      *  the pool works.
      *  Without mutex, will be not be thread safe.
+     *  If purgeInBackground is true (which requires a mutex), a thread owned
+     *  by the pool trims it to budget instead of the thread that went over.
      */
     static SkDiscardableMemoryPool* Create(
-            size_t size, SkBaseMutex* mutex = nullptr);
+            size_t size, SkBaseMutex* mutex = nullptr, bool purgeInBackground = false);
 };
 
 /**
  *  Returns (and creates if needed) a threadsafe global
- *  SkDiscardableMemoryPool.
+ *  SkDiscardableMemoryPool, which purges in the background.
  */
 SkDiscardableMemoryPool* SkGetGlobalDiscardableMemoryPool();
 
+/**
+ *  Dumps the global SkDiscardableMemoryPool's statistics, if it has been
+ *  created.
+ */
+void SkDumpGlobalDiscardableMemoryPoolStatistics(SkTraceMemoryDump*);
+
 #if !defined(SK_DEFAULT_GLOBAL_DISCARDABLE_MEMORY_POOL_SIZE)
 #define SK_DEFAULT_GLOBAL_DISCARDABLE_MEMORY_POOL_SIZE (128 * 1024 * 1024)
 #endif
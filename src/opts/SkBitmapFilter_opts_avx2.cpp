@@ -0,0 +1,209 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include <immintrin.h>
+#include "SkBitmapFilter_opts_avx2.h"
+#include "SkConvolver.h"
+
+// Where the SSE2 code widens each 8-bit channel, multiplies it by one coefficient with
+// mullo/mulhi and adds up 32-bit products, we interleave the channels of two taps and let
+// _mm256_madd_epi16() multiply and add them both at once.  Every product and sum is exact,
+// so the results are identical.
+
+// Packs two taps' coefficients into each 32-bit lane, as _mm256_madd_epi16() wants them.
+static inline __m256i coefficient_pair(SkConvolutionFilter1D::ConvolutionFixed c0,
+                                       SkConvolutionFilter1D::ConvolutionFixed c1) {
+    return _mm256_set1_epi32((uint16_t)c0 | ((uint32_t)(uint16_t)c1 << 16));
+}
+
+// Makes each pixel's alpha at least as large as its color channels, or opaque.
+template <bool has_alpha>
+static inline __m256i fix_alpha(__m256i px) {
+    if (has_alpha) {
+        __m256i max = _mm256_max_epu8(_mm256_srli_epi32(px, 8), px);
+        max = _mm256_max_epu8(_mm256_srli_epi32(px, 16), max);
+        return _mm256_max_epu8(_mm256_slli_epi32(max, 24), px);
+    }
+    return _mm256_or_si256(px, _mm256_set1_epi32(0xff000000));
+}
+
+// Convolves 8 pixels, reading all 8 from each row even if fewer are needed.
+template <bool has_alpha>
+static inline __m256i convolve8_vertically(
+        const SkConvolutionFilter1D::ConvolutionFixed* filter_values, int filter_length,
+        unsigned char* const* source_data_rows, int x) {
+    const __m256i zero = _mm256_setzero_si256();
+    // Each holds 2 pixels' channels as 32-bit sums: pixels 0 and 4 in accum0, 1 and 5 in
+    // accum1, and so on, which is the order the in-lane packs below want them in.
+    __m256i accum0 = zero,
+            accum1 = zero,
+            accum2 = zero,
+            accum3 = zero;
+
+    auto accumulate = [&](__m256i r0, __m256i r1, __m256i coeffs) {
+        // [8] lane 0: pixels 0 and 1 of both rows interleaved, lane 1: pixels 4 and 5.
+        __m256i lo = _mm256_unpacklo_epi8(r0, r1),
+        // [8] lane 0: pixels 2 and 3, lane 1: pixels 6 and 7.
+                hi = _mm256_unpackhi_epi8(r0, r1);
+        accum0 = _mm256_add_epi32(accum0, _mm256_madd_epi16(_mm256_unpacklo_epi8(lo, zero),
+                                                            coeffs));
+        accum1 = _mm256_add_epi32(accum1, _mm256_madd_epi16(_mm256_unpackhi_epi8(lo, zero),
+                                                            coeffs));
+        accum2 = _mm256_add_epi32(accum2, _mm256_madd_epi16(_mm256_unpacklo_epi8(hi, zero),
+                                                            coeffs));
+        accum3 = _mm256_add_epi32(accum3, _mm256_madd_epi16(_mm256_unpackhi_epi8(hi, zero),
+                                                            coeffs));
+    };
+
+    int filter_y = 0;
+    for (; filter_y + 2 <= filter_length; filter_y += 2) {
+        accumulate(_mm256_loadu_si256((const __m256i*)&source_data_rows[filter_y    ][x << 2]),
+                   _mm256_loadu_si256((const __m256i*)&source_data_rows[filter_y + 1][x << 2]),
+                   coefficient_pair(filter_values[filter_y], filter_values[filter_y + 1]));
+    }
+    if (filter_y < filter_length) {
+        accumulate(_mm256_loadu_si256((const __m256i*)&source_data_rows[filter_y][x << 2]),
+                   zero,
+                   coefficient_pair(filter_values[filter_y], 0));
+    }
+
+    accum0 = _mm256_srai_epi32(accum0, SkConvolutionFilter1D::kShiftBits);
+    accum1 = _mm256_srai_epi32(accum1, SkConvolutionFilter1D::kShiftBits);
+    accum2 = _mm256_srai_epi32(accum2, SkConvolutionFilter1D::kShiftBits);
+    accum3 = _mm256_srai_epi32(accum3, SkConvolutionFilter1D::kShiftBits);
+
+    // [8] lane 0: pixels 0-3, lane 1: pixels 4-7.
+    __m256i px = _mm256_packus_epi16(_mm256_packs_epi32(accum0, accum1),
+                                     _mm256_packs_epi32(accum2, accum3));
+    return fix_alpha<has_alpha>(px);
+}
+
+template <bool has_alpha>
+static void convolveVertically_avx2(const SkConvolutionFilter1D::ConvolutionFixed* filter_values,
+                                    int filter_length,
+                                    unsigned char* const* source_data_rows,
+                                    int pixel_width,
+                                    unsigned char* out_row) {
+    int width = pixel_width & ~7;
+    for (int out_x = 0; out_x < width; out_x += 8) {
+        __m256i px = convolve8_vertically<has_alpha>(filter_values, filter_length,
+                                                     source_data_rows, out_x);
+        _mm256_storeu_si256((__m256i*)out_row, px);
+        out_row += 32;
+    }
+
+    // The rows we're given are padded out to a multiple of 16 pixels, so we can convolve a whole
+    // 8 more, but we must only write what's left.
+    if (width < pixel_width) {
+        __m256i px = convolve8_vertically<has_alpha>(filter_values, filter_length,
+                                                     source_data_rows, width);
+        uint32_t tail[8];
+        _mm256_storeu_si256((__m256i*)tail, px);
+        memcpy(out_row, tail, (pixel_width - width) * 4);
+    }
+}
+
+void convolveVertically_avx2(const SkConvolutionFilter1D::ConvolutionFixed* filter_values,
+                             int filter_length,
+                             unsigned char* const* source_data_rows,
+                             int pixel_width,
+                             unsigned char* out_row,
+                             bool has_alpha) {
+    if (has_alpha) {
+        convolveVertically_avx2<true>(filter_values, filter_length, source_data_rows,
+                                      pixel_width, out_row);
+    } else {
+        convolveVertically_avx2<false>(filter_values, filter_length, source_data_rows,
+                                       pixel_width, out_row);
+    }
+}
+
+// Two rows go in each register, one per lane.  For each group of 4 taps we shuffle the 4 pixels
+// under them so the same channel of neighboring taps sits side by side, then madd them.
+void convolve4RowsHorizontally_avx2(const unsigned char* src_data[4],
+                                    const SkConvolutionFilter1D& filter,
+                                    unsigned char* out_row[4],
+                                    size_t outRowBytes) {
+    SkDEBUGCODE(const unsigned char* out_row_0_start = out_row[0];)
+
+    const int num_values = filter.numValues();
+    const __m256i zero = _mm256_setzero_si256();
+    // [8] p0 and p1's first channel, then their second, ... then the same for p2 and p3.
+    const __m256i pair_taps = _mm256_setr_epi8(0,4,1,5,2,6,3,7, 8,12,9,13,10,14,11,15,
+                                               0,4,1,5,2,6,3,7, 8,12,9,13,10,14,11,15);
+    // |mask| zeroes the extra coefficients loaded when |filter_length| isn't a multiple of 4.
+    const __m128i mask[4] = {
+        _mm_setzero_si128(),
+        _mm_set_epi16(0, 0, 0, 0, 0, 0, 0, -1),
+        _mm_set_epi16(0, 0, 0, 0, 0, 0, -1, -1),
+        _mm_set_epi16(0, 0, 0, 0, 0, -1, -1, -1),
+    };
+
+    auto load2 = [](const unsigned char* a, const unsigned char* b) {
+        return _mm256_inserti128_si256(
+                _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)a)),
+                _mm_loadu_si128((const __m128i*)b), 1);
+    };
+
+    for (int out_x = 0; out_x < num_values; out_x++) {
+        int filter_offset, filter_length;
+        const SkConvolutionFilter1D::ConvolutionFixed* filter_values =
+            filter.FilterForValue(out_x, &filter_offset, &filter_length);
+
+        // Rows 0 and 1 in accum01, rows 2 and 3 in accum23.
+        __m256i accum01 = zero,
+                accum23 = zero;
+
+        auto accumulate = [&](int start, __m128i coeff) {
+            // [16] c1 c0 repeated, and c3 c2 repeated.
+            __m256i c01 = _mm256_broadcastd_epi32(coeff),
+                    c23 = _mm256_broadcastd_epi32(_mm_srli_si128(coeff, 4));
+            auto madd = [&](__m256i src8) {
+                src8 = _mm256_shuffle_epi8(src8, pair_taps);
+                return _mm256_add_epi32(
+                        _mm256_madd_epi16(_mm256_unpacklo_epi8(src8, zero), c01),
+                        _mm256_madd_epi16(_mm256_unpackhi_epi8(src8, zero), c23));
+            };
+            accum01 = _mm256_add_epi32(accum01, madd(load2(src_data[0] + start,
+                                                           src_data[1] + start)));
+            accum23 = _mm256_add_epi32(accum23, madd(load2(src_data[2] + start,
+                                                           src_data[3] + start)));
+        };
+
+        int start = filter_offset << 2;
+        for (int filter_x = 0; filter_x < (filter_length >> 2); filter_x++) {
+            accumulate(start, _mm_loadl_epi64((const __m128i*)filter_values));
+            start += 16;
+            filter_values += 4;
+        }
+        if (int r = filter_length & 3) {
+            // Note: filter_values must be padded to align_up(filter_offset, 8).
+            accumulate(start, _mm_and_si128(_mm_loadl_epi64((const __m128i*)filter_values),
+                                            mask[r]));
+        }
+
+        accum01 = _mm256_srai_epi32(accum01, SkConvolutionFilter1D::kShiftBits);
+        accum23 = _mm256_srai_epi32(accum23, SkConvolutionFilter1D::kShiftBits);
+        // [8] lane 0: row 0 then row 2, lane 1: row 1 then row 3, in the low 8 bytes.
+        __m256i px = _mm256_packs_epi32(accum01, accum23);
+        px = _mm256_packus_epi16(px, zero);
+
+        SkASSERT(((size_t)out_row[0] - (size_t)out_row_0_start) < outRowBytes);
+
+        __m128i lo = _mm256_castsi256_si128(px),
+                hi = _mm256_extracti128_si256(px, 1);
+        *(reinterpret_cast<int*>(out_row[0])) = _mm_cvtsi128_si32(lo);
+        *(reinterpret_cast<int*>(out_row[1])) = _mm_cvtsi128_si32(hi);
+        *(reinterpret_cast<int*>(out_row[2])) = _mm_cvtsi128_si32(_mm_srli_si128(lo, 4));
+        *(reinterpret_cast<int*>(out_row[3])) = _mm_cvtsi128_si32(_mm_srli_si128(hi, 4));
+
+        out_row[0] += 4;
+        out_row[1] += 4;
+        out_row[2] += 4;
+        out_row[3] += 4;
+    }
+}
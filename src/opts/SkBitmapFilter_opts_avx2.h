@@ -0,0 +1,27 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkBitmapFilter_opts_avx2_DEFINED
+#define SkBitmapFilter_opts_avx2_DEFINED
+
+#include "SkConvolver.h"
+
+// These produce exactly what their _SSE2 counterparts do, and make the same assumptions about
+// how far past the end of their rows and filter values they may read.
+
+void convolveVertically_avx2(const SkConvolutionFilter1D::ConvolutionFixed* filter_values,
+                             int filter_length,
+                             unsigned char* const* source_data_rows,
+                             int pixel_width,
+                             unsigned char* out_row,
+                             bool has_alpha);
+void convolve4RowsHorizontally_avx2(const unsigned char* src_data[4],
+                                    const SkConvolutionFilter1D& filter,
+                                    unsigned char* out_row[4],
+                                    size_t outRowBytes);
+
+#endif
@@ -9,6 +9,7 @@
 #include "SkBitmapProcState_opts_SSE2.h"
 #include "SkColorPriv.h"
 #include "SkPaint.h"
+#include "SkPerspIter.h"
 #include "SkUtils.h"
 
 void S32_opaque_D32_filter_DX_SSE2(const SkBitmapProcState& s,
@@ -619,3 +620,114 @@ void ClampX_ClampY_nofilter_affine_SSE2(const SkBitmapProcState& s,
         fy += dy;
     }
 }
+
+/*  SSE version of ClampX_ClampY_filter_persp()
+ *  portable version is in core/SkBitmapProcState_matrix.h
+ */
+void ClampX_ClampY_filter_persp_SSE2(const SkBitmapProcState& s,
+                                     uint32_t xy[], int count, int x, int y) {
+    SkASSERT(s.fInvType & SkMatrix::kPerspective_Mask);
+
+    SkFixed oneX = s.fFilterOneX;
+    SkFixed oneY = s.fFilterOneY;
+    unsigned maxX = s.fPixmap.width() - 1;
+    unsigned maxY = s.fPixmap.height() - 1;
+
+    SkPerspIter iter(s.fInvMatrix,
+                     SkIntToScalar(x) + SK_ScalarHalf,
+                     SkIntToScalar(y) + SK_ScalarHalf, count);
+
+    // _mm_{min,max}_epi16 clamp correctly only while max fits in a signed 16-bit lane.
+    const bool wide = (maxX | maxY) <= 0x7FFF;
+
+    __m128i wide_half = _mm_set_epi32(oneX >> 1, oneY >> 1, oneX >> 1, oneY >> 1);
+    __m128i wide_one  = _mm_set_epi32(oneX, oneY, oneX, oneY);
+    __m128i wide_max  = _mm_set_epi32(maxX, maxY, maxX, maxY);
+    __m128i wide_mask = _mm_set1_epi32(0xF);
+
+    while ((count = iter.next()) != 0) {
+        const SkFixed* SK_RESTRICT srcXY = iter.getXY();
+
+        while (wide && count >= 2) {
+            // srcXY holds x0 y0 x1 y1; we write y0 x0 y1 x1.
+            __m128i wide_f = _mm_loadu_si128(reinterpret_cast<const __m128i*>(srcXY));
+            wide_f = _mm_shuffle_epi32(wide_f, _MM_SHUFFLE(2, 3, 0, 1));
+            wide_f = _mm_sub_epi32(wide_f, wide_half);
+
+            // i = SkClampMax(f>>16,max)
+            __m128i wide_i = _mm_max_epi16(_mm_srli_epi32(wide_f, 16),
+                                           _mm_setzero_si128());
+            wide_i = _mm_min_epi16(wide_i, wide_max);
+
+            // (i<<4 | TILE_LOW_BITS(f)) << 14
+            __m128i wide_lo = _mm_and_si128(_mm_srli_epi32(wide_f, 12), wide_mask);
+            wide_i = _mm_or_si128(_mm_slli_epi32(wide_i, 4), wide_lo);
+            wide_i = _mm_slli_epi32(wide_i, 14);
+
+            // SkClampMax(((f+one))>>16,max)
+            __m128i wide_f1 = _mm_add_epi32(wide_f, wide_one);
+            wide_f1 = _mm_max_epi16(_mm_srli_epi32(wide_f1, 16),
+                                    _mm_setzero_si128());
+            wide_f1 = _mm_min_epi16(wide_f1, wide_max);
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(xy), _mm_or_si128(wide_i, wide_f1));
+
+            srcXY += 4;
+            xy += 4;
+            count -= 2;
+        }
+
+        while (count-- > 0) {
+            *xy++ = ClampX_ClampY_pack_filter(srcXY[1] - (oneY >> 1), maxY, oneY);
+            *xy++ = ClampX_ClampY_pack_filter(srcXY[0] - (oneX >> 1), maxX, oneX);
+            srcXY += 2;
+        }
+    }
+}
+
+/*  SSE version of ClampX_ClampY_nofilter_persp()
+ *  portable version is in core/SkBitmapProcState_matrix_template.h
+ */
+void ClampX_ClampY_nofilter_persp_SSE2(const SkBitmapProcState& s,
+                                       uint32_t xy[], int count, int x, int y) {
+    SkASSERT(s.fInvType & SkMatrix::kPerspective_Mask);
+
+    int maxX = s.fPixmap.width() - 1;
+    int maxY = s.fPixmap.height() - 1;
+
+    SkPerspIter iter(s.fInvMatrix,
+                     SkIntToScalar(x) + SK_ScalarHalf,
+                     SkIntToScalar(y) + SK_ScalarHalf, count);
+
+    // Clamped values must fit a signed 16-bit lane for _mm_{min,max}_epi16 and _mm_packs_epi32.
+    const bool wide = (maxX | maxY) <= 0x7FFF;
+
+    __m128i wide_max = _mm_set_epi32(maxY, maxX, maxY, maxX);
+
+    while ((count = iter.next()) != 0) {
+        const SkFixed* SK_RESTRICT srcXY = iter.getXY();
+
+        while (wide && count >= 4) {
+            // SkClampMax(f>>16,max) for x0 y0 x1 y1 and x2 y2 x3 y3
+            __m128i wide_a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(srcXY + 0));
+            __m128i wide_b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(srcXY + 4));
+            wide_a = _mm_min_epi16(_mm_max_epi16(_mm_srli_epi32(wide_a, 16),
+                                                 _mm_setzero_si128()), wide_max);
+            wide_b = _mm_min_epi16(_mm_max_epi16(_mm_srli_epi32(wide_b, 16),
+                                                 _mm_setzero_si128()), wide_max);
+
+            // Packing to 16-bit lanes leaves each pixel as (y << 16) | x.
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(xy), _mm_packs_epi32(wide_a, wide_b));
+
+            srcXY += 8;
+            xy += 4;
+            count -= 4;
+        }
+
+        while (count-- > 0) {
+            *xy++ = (SkClampMax(srcXY[1] >> 16, maxY) << 16) |
+                     SkClampMax(srcXY[0] >> 16, maxX);
+            srcXY += 2;
+        }
+    }
+}
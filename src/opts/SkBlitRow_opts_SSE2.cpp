@@ -993,3 +993,259 @@ void S32A_D565_Opaque_Dither_SSE2(uint16_t* SK_RESTRICT dst,
         } while (--count != 0);
     }
 }
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Builds the dither values for 8 pixels starting at (x,y).  The matrix repeats every 4 pixels,
+// so the same vector serves every 8-pixel step along the row.
+static __m128i dither_565_x8(int x, int y) {
+    unsigned short dither_value[8];
+    DITHER_565_SCAN(y);
+    for (int i = 0; i < 4; i++) {
+        dither_value[i] = dither_value[i + 4] = DITHER_VALUE(x + i);
+    }
+    return _mm_loadu_si128((const __m128i*) dither_value);
+}
+
+// Extracts the 8-bit channel at kShift from 8 pixels into 16-bit lanes.
+template <int kShift>
+static inline __m128i get_channel_x8(const __m128i& src_pixel1, const __m128i& src_pixel2) {
+    __m128i c1 = _mm_srli_epi32(_mm_slli_epi32(src_pixel1, 24 - kShift), 24);
+    __m128i c2 = _mm_srli_epi32(_mm_slli_epi32(src_pixel2, 24 - kShift), 24);
+    return _mm_packs_epi32(c1, c2);
+}
+
+// SkAlphaBlend(s, d, scale) on 16-bit lanes: d + ((s - d) * scale >> 8), with s - d signed.
+static inline __m128i alpha_blend_x8(const __m128i& s, const __m128i& d, const __m128i& scale) {
+    return _mm_add_epi16(d, _mm_srai_epi16(_mm_mullo_epi16(_mm_sub_epi16(s, d), scale), 8));
+}
+
+// Blends the 565 channels sr, sg, sb into the 8 dst pixels at d with SkAlphaBlend.
+static inline __m128i blend_565_x8(const __m128i& sr, const __m128i& sg, const __m128i& sb,
+                                   const __m128i& dst_pixel, const __m128i& scale) {
+    __m128i dr = _mm_and_si128(_mm_srli_epi16(dst_pixel, SK_R16_SHIFT),
+                               _mm_set1_epi16(SK_R16_MASK));
+    __m128i dg = _mm_and_si128(_mm_srli_epi16(dst_pixel, SK_G16_SHIFT),
+                               _mm_set1_epi16(SK_G16_MASK));
+    __m128i db = _mm_and_si128(_mm_srli_epi16(dst_pixel, SK_B16_SHIFT),
+                               _mm_set1_epi16(SK_B16_MASK));
+    return SkPackRGB16_SSE2(alpha_blend_x8(sr, dr, scale),
+                            alpha_blend_x8(sg, dg, scale),
+                            alpha_blend_x8(sb, db, scale));
+}
+
+/* SSE2 version of S32_D565_Blend()
+ * portable version is in core/SkBlitRow_D16.cpp
+ */
+void S32_D565_Blend_SSE2(uint16_t* SK_RESTRICT dst,
+                         const SkPMColor* SK_RESTRICT src, int count,
+                         U8CPU alpha, int /*x*/, int /*y*/) {
+    SkASSERT(255 > alpha);
+
+    const int scale = SkAlpha255To256(alpha);
+    const __m128i scale_x8 = _mm_set1_epi16(scale);
+    while (count >= 8) {
+        __m128i src_pixel1 = _mm_loadu_si128((const __m128i*)(src + 0));
+        __m128i src_pixel2 = _mm_loadu_si128((const __m128i*)(src + 4));
+        __m128i dst_pixel  = _mm_loadu_si128((const __m128i*)dst);
+
+        // SkPacked32ToR16() and friends.
+        __m128i sr = _mm_srli_epi16(get_channel_x8<SK_R32_SHIFT>(src_pixel1, src_pixel2),
+                                    8 - SK_R16_BITS);
+        __m128i sg = _mm_srli_epi16(get_channel_x8<SK_G32_SHIFT>(src_pixel1, src_pixel2),
+                                    8 - SK_G16_BITS);
+        __m128i sb = _mm_srli_epi16(get_channel_x8<SK_B32_SHIFT>(src_pixel1, src_pixel2),
+                                    8 - SK_B16_BITS);
+
+        _mm_storeu_si128((__m128i*)dst, blend_565_x8(sr, sg, sb, dst_pixel, scale_x8));
+        src += 8;
+        dst += 8;
+        count -= 8;
+    }
+
+    while (count --> 0) {
+        SkPMColor c = *src++;
+        SkPMColorAssert(c);
+        uint16_t d = *dst;
+        *dst++ = SkPackRGB16(SkAlphaBlend(SkPacked32ToR16(c), SkGetPackedR16(d), scale),
+                             SkAlphaBlend(SkPacked32ToG16(c), SkGetPackedG16(d), scale),
+                             SkAlphaBlend(SkPacked32ToB16(c), SkGetPackedB16(d), scale));
+    }
+}
+
+/* SSE2 version of S32A_D565_Blend()
+ * portable version is in core/SkBlitRow_D16.cpp
+ */
+void S32A_D565_Blend_SSE2(uint16_t* SK_RESTRICT dst,
+                          const SkPMColor* SK_RESTRICT src, int count,
+                          U8CPU alpha, int /*x*/, int /*y*/) {
+    SkASSERT(255 > alpha);
+
+    while (count >= 8) {
+        __m128i src_pixel1 = _mm_loadu_si128((const __m128i*)(src + 0));
+        __m128i src_pixel2 = _mm_loadu_si128((const __m128i*)(src + 4));
+
+        // Blending with a transparent src pixel leaves dst as it was, so we needn't
+        // special-case them like the portable code does, only skip all-transparent runs.
+        __m128i zero = _mm_setzero_si128();
+        if (0xFFFF == _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi32(src_pixel1, zero),
+                                                      _mm_cmpeq_epi32(src_pixel2, zero)))) {
+            src += 8;
+            dst += 8;
+            count -= 8;
+            continue;
+        }
+
+        // Same as SkPixel32ToPixel16(SkBlendARGB32(src, SkPixel16ToPixel32(dst), alpha)).
+        __m128i dst_pixel = _mm_loadu_si128((const __m128i*)dst);
+        __m128i dst_pixel1 = SkPixel16ToPixel32_SSE2(_mm_unpacklo_epi16(dst_pixel, zero));
+        __m128i dst_pixel2 = SkPixel16ToPixel32_SSE2(_mm_unpackhi_epi16(dst_pixel, zero));
+        __m128i res1 = SkBlendARGB32_SSE2(src_pixel1, dst_pixel1, alpha);
+        __m128i res2 = SkBlendARGB32_SSE2(src_pixel2, dst_pixel2, alpha);
+
+        _mm_storeu_si128((__m128i*)dst, SkPixel32ToPixel16_ToU16_SSE2(res1, res2));
+        src += 8;
+        dst += 8;
+        count -= 8;
+    }
+
+    while (count --> 0) {
+        SkPMColor sc = *src++;
+        SkPMColorAssert(sc);
+        if (sc) {
+            SkPMColor res = SkBlendARGB32(sc, SkPixel16ToPixel32(*dst), alpha);
+            *dst = SkPixel32ToPixel16(res);
+        }
+        dst += 1;
+    }
+}
+
+/* SSE2 version of S32_D565_Blend_Dither()
+ * portable version is in core/SkBlitRow_D16.cpp
+ */
+void S32_D565_Blend_Dither_SSE2(uint16_t* SK_RESTRICT dst,
+                                const SkPMColor* SK_RESTRICT src,
+                                int count, U8CPU alpha, int x, int y) {
+    SkASSERT(255 > alpha);
+
+    const int scale = SkAlpha255To256(alpha);
+    const __m128i scale_x8 = _mm_set1_epi16(scale);
+    const __m128i dither = dither_565_x8(x, y);
+    while (count >= 8) {
+        __m128i src_pixel1 = _mm_loadu_si128((const __m128i*)(src + 0));
+        __m128i src_pixel2 = _mm_loadu_si128((const __m128i*)(src + 4));
+        __m128i dst_pixel  = _mm_loadu_si128((const __m128i*)dst);
+
+        // SkDITHER_R32To565() and friends: (c + dither - (c >> bits)) >> (8 - bits).
+        __m128i sr = get_channel_x8<SK_R32_SHIFT>(src_pixel1, src_pixel2);
+        __m128i sg = get_channel_x8<SK_G32_SHIFT>(src_pixel1, src_pixel2);
+        __m128i sb = get_channel_x8<SK_B32_SHIFT>(src_pixel1, src_pixel2);
+        sr = _mm_srli_epi16(_mm_sub_epi16(_mm_add_epi16(sr, dither), _mm_srli_epi16(sr, 5)), 3);
+        sg = _mm_srli_epi16(_mm_sub_epi16(_mm_add_epi16(sg, _mm_srli_epi16(dither, 1)),
+                                          _mm_srli_epi16(sg, 6)), 2);
+        sb = _mm_srli_epi16(_mm_sub_epi16(_mm_add_epi16(sb, dither), _mm_srli_epi16(sb, 5)), 3);
+
+        _mm_storeu_si128((__m128i*)dst, blend_565_x8(sr, sg, sb, dst_pixel, scale_x8));
+        src += 8;
+        dst += 8;
+        count -= 8;
+        x += 8;
+    }
+
+    if (count > 0) {
+        DITHER_565_SCAN(y);
+        do {
+            SkPMColor c = *src++;
+            SkPMColorAssert(c);
+
+            int dither = DITHER_VALUE(x);
+            int sr = SkDITHER_R32To565(SkGetPackedR32(c), dither);
+            int sg = SkDITHER_G32To565(SkGetPackedG32(c), dither);
+            int sb = SkDITHER_B32To565(SkGetPackedB32(c), dither);
+
+            uint16_t d = *dst;
+            *dst++ = SkPackRGB16(SkAlphaBlend(sr, SkGetPackedR16(d), scale),
+                                 SkAlphaBlend(sg, SkGetPackedG16(d), scale),
+                                 SkAlphaBlend(sb, SkGetPackedB16(d), scale));
+            DITHER_INC_X(x);
+        } while (--count != 0);
+    }
+}
+
+/* SSE2 version of S32A_D565_Blend_Dither()
+ * portable version is in core/SkBlitRow_D16.cpp
+ */
+void S32A_D565_Blend_Dither_SSE2(uint16_t* SK_RESTRICT dst,
+                                 const SkPMColor* SK_RESTRICT src,
+                                 int count, U8CPU alpha, int x, int y) {
+    SkASSERT(255 > alpha);
+
+    const int src_scale = SkAlpha255To256(alpha);
+    const __m128i src_scale_x8 = _mm_set1_epi16(src_scale);
+    const __m128i dither = dither_565_x8(x, y);
+    while (count >= 8) {
+        __m128i src_pixel1 = _mm_loadu_si128((const __m128i*)(src + 0));
+        __m128i src_pixel2 = _mm_loadu_si128((const __m128i*)(src + 4));
+        __m128i dst_pixel  = _mm_loadu_si128((const __m128i*)dst);
+
+        // As in the portable code, but there's no need to skip transparent src pixels:
+        // they dither to 0 and get a dst_scale of 256, leaving dst as it was.
+        __m128i sa = get_channel_x8<SK_A32_SHIFT>(src_pixel1, src_pixel2);
+        __m128i sr = get_channel_x8<SK_R32_SHIFT>(src_pixel1, src_pixel2);
+        __m128i sg = get_channel_x8<SK_G32_SHIFT>(src_pixel1, src_pixel2);
+        __m128i sb = get_channel_x8<SK_B32_SHIFT>(src_pixel1, src_pixel2);
+        sr = _mm_srli_epi16(_mm_sub_epi16(_mm_add_epi16(sr, dither), _mm_srli_epi16(sr, 5)), 3);
+        sg = _mm_srli_epi16(_mm_sub_epi16(_mm_add_epi16(sg, _mm_srli_epi16(dither, 1)),
+                                          _mm_srli_epi16(sg, 6)), 2);
+        sb = _mm_srli_epi16(_mm_sub_epi16(_mm_add_epi16(sb, dither), _mm_srli_epi16(sb, 5)), 3);
+
+        // dst_scale = SkAlpha255To256(255 - SkAlphaMul(sa, src_scale))
+        __m128i dst_scale = _mm_sub_epi16(_mm_set1_epi16(256),
+                                          _mm_srli_epi16(_mm_mullo_epi16(sa, src_scale_x8), 8));
+
+        __m128i dr = _mm_and_si128(_mm_srli_epi16(dst_pixel, SK_R16_SHIFT),
+                                   _mm_set1_epi16(SK_R16_MASK));
+        __m128i dg = _mm_and_si128(_mm_srli_epi16(dst_pixel, SK_G16_SHIFT),
+                                   _mm_set1_epi16(SK_G16_MASK));
+        __m128i db = _mm_and_si128(_mm_srli_epi16(dst_pixel, SK_B16_SHIFT),
+                                   _mm_set1_epi16(SK_B16_MASK));
+        dr = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(sr, src_scale_x8),
+                                          _mm_mullo_epi16(dr, dst_scale)), 8);
+        dg = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(sg, src_scale_x8),
+                                          _mm_mullo_epi16(dg, dst_scale)), 8);
+        db = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(sb, src_scale_x8),
+                                          _mm_mullo_epi16(db, dst_scale)), 8);
+
+        _mm_storeu_si128((__m128i*)dst, SkPackRGB16_SSE2(dr, dg, db));
+        src += 8;
+        dst += 8;
+        count -= 8;
+        x += 8;
+    }
+
+    if (count > 0) {
+        DITHER_565_SCAN(y);
+        do {
+            SkPMColor c = *src++;
+            SkPMColorAssert(c);
+            if (c) {
+                unsigned d = *dst;
+                int sa = SkGetPackedA32(c);
+                int dst_scale = SkAlpha255To256(255 - SkAlphaMul(sa, src_scale));
+                int dither = DITHER_VALUE(x);
+
+                int sr = SkDITHER_R32To565(SkGetPackedR32(c), dither);
+                int sg = SkDITHER_G32To565(SkGetPackedG32(c), dither);
+                int sb = SkDITHER_B32To565(SkGetPackedB32(c), dither);
+
+                int dr = (sr * src_scale + SkGetPackedR16(d) * dst_scale) >> 8;
+                int dg = (sg * src_scale + SkGetPackedG16(d) * dst_scale) >> 8;
+                int db = (sb * src_scale + SkGetPackedB16(d) * dst_scale) >> 8;
+
+                *dst = SkPackRGB16(dr, dg, db);
+            }
+            dst += 1;
+            DITHER_INC_X(x);
+        } while (--count != 0);
+    }
+}
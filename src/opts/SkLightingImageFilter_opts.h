@@ -0,0 +1,61 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkLightingImageFilter_opts_DEFINED
+#define SkLightingImageFilter_opts_DEFINED
+
+#include "SkColorPriv.h"
+#include "SkNx.h"
+
+namespace SK_OPTS_NS {
+
+static inline Sk4i alphas(const SkPMColor* p) {
+    return (Sk4i::Load(p) >> SK_A32_SHIFT) & 0xFF;
+}
+
+static inline void normals(const SkPMColor* above, const SkPMColor* row, const SkPMColor* below,
+                           const Sk4f& negSurfaceScale, float* nx, float* ny, float* nz) {
+    // The same Sobel filter and normalization as SkLightingImageFilter's interiorNormal().
+    Sk4i m0 = alphas(above - 1), m1 = alphas(above), m2 = alphas(above + 1),
+         m3 = alphas(row   - 1),                     m5 = alphas(row   + 1),
+         m6 = alphas(below - 1), m7 = alphas(below), m8 = alphas(below + 1);
+    Sk4f x = SkNx_cast<float>(m2 - m0 + ((m5 - m3) << 1) + m8 - m6) * 0.25f,
+         y = SkNx_cast<float>(m6 - m0 + ((m7 - m1) << 1) + m8 - m2) * 0.25f;
+    x = x * negSurfaceScale;
+    y = y * negSurfaceScale;
+    Sk4f scale = (x*x + y*y + 1.0f + SK_ScalarNearlyZero).rsqrt();
+    (x * scale).store(nx);
+    (y * scale).store(ny);
+    scale.store(nz);
+}
+
+static void lighting_normals(const SkPMColor* above, const SkPMColor* row,
+                             const SkPMColor* below, int count, float surfaceScale,
+                             float* nx, float* ny, float* nz) {
+    const Sk4f scale(-surfaceScale);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        normals(above + i, row + i, below + i, scale, nx + i, ny + i, nz + i);
+    }
+    if (i < count) {
+        // Do the last few in a padded copy, rather than reading past the end of the rows.
+        SkPMColor tail[3][6] = {{0}};
+        const int n = count - i;
+        memcpy(tail[0], above + i - 1, (n + 2) * sizeof(SkPMColor));
+        memcpy(tail[1], row   + i - 1, (n + 2) * sizeof(SkPMColor));
+        memcpy(tail[2], below + i - 1, (n + 2) * sizeof(SkPMColor));
+        float x[4], y[4], z[4];
+        normals(tail[0] + 1, tail[1] + 1, tail[2] + 1, scale, x, y, z);
+        memcpy(nx + i, x, n * sizeof(float));
+        memcpy(ny + i, y, n * sizeof(float));
+        memcpy(nz + i, z, n * sizeof(float));
+    }
+}
+
+}  // namespace SK_OPTS_NS
+
+#endif//SkLightingImageFilter_opts_DEFINED
@@ -0,0 +1,53 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMatrixConvolutionImageFilter_opts_DEFINED
+#define SkMatrixConvolutionImageFilter_opts_DEFINED
+
+#include "SkColorPriv.h"
+#include "SkNx.h"
+
+namespace SK_OPTS_NS {
+
+// We convolve all four channels of a pixel at once, in the same order and with the same float
+// math as SkMatrixConvolutionImageFilter's per-channel code, so the results match it exactly.
+static void matrix_convolve(SkPMColor* dst, const SkPMColor* src, size_t srcRowBytes, int count,
+                            const float* kernel, int kernelWidth, int kernelHeight,
+                            float gain, float bias, const SkPMColor* alphaSrc) {
+#ifdef SK_CPU_BENDIAN
+    const int kA = 3 - SK_A32_SHIFT / 8;
+#else
+    const int kA = SK_A32_SHIFT / 8;
+#endif
+    for (int i = 0; i < count; i++) {
+        Sk4f sum(0.0f);
+        const float* k = kernel;
+        const char* row = (const char*)(src + i);
+        for (int cy = 0; cy < kernelHeight; cy++, row += srcRowBytes) {
+            const SkPMColor* p = (const SkPMColor*)row;
+            for (int cx = 0; cx < kernelWidth; cx++) {
+                sum = sum + SkNx_cast<float>(Sk4b::Load(p + cx)) * *k++;
+            }
+        }
+
+        // Every value is a whole number from here on, so the casts below are exact.
+        Sk4f c = Sk4f::Min(Sk4f::Max((sum * gain + bias).floor(), 0.0f), 255.0f);
+        if (alphaSrc) {
+            // Color isn't capped by a convolved alpha: we premultiply by the original one.
+            SkPMColor unpremul;
+            SkNx_cast<uint8_t>(c).store(&unpremul);
+            dst[i] = SkPreMultiplyARGB(SkGetPackedA32(alphaSrc[i]), SkGetPackedR32(unpremul),
+                                       SkGetPackedG32(unpremul), SkGetPackedB32(unpremul));
+        } else {
+            SkNx_cast<uint8_t>(Sk4f::Min(c, c[kA])).store(dst + i);
+        }
+    }
+}
+
+}  // namespace SK_OPTS_NS
+
+#endif//SkMatrixConvolutionImageFilter_opts_DEFINED
@@ -0,0 +1,160 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMipMap_opts_DEFINED
+#define SkMipMap_opts_DEFINED
+
+#include "SkTypes.h"
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    #include <emmintrin.h>
+#elif defined(SK_ARM_HAS_NEON)
+    #include <arm_neon.h>
+#endif
+
+// Each of these box filters one row of count dst pixels from the 2x2 blocks of src pixels under
+// them, src's two rows srcRB bytes apart.  Like the rest of SkMipMap, each channel's sum of 4 is
+// truncated, not rounded, when divided back down.
+
+namespace SK_OPTS_NS {
+
+static void downsample_2_2_8888_portable(void* dst, const void* src, size_t srcRB, int count) {
+    auto p0 = static_cast<const uint8_t*>(src),
+         p1 = p0 + srcRB;
+    auto d = static_cast<uint8_t*>(dst);
+    for (int i = 0; i < 4*count; i += 4) {
+        for (int c = 0; c < 4; c++) {
+            d[i+c] = (p0[2*i+c] + p0[2*i+4+c] + p1[2*i+c] + p1[2*i+4+c]) >> 2;
+        }
+    }
+}
+
+static void downsample_2_2_8_portable(void* dst, const void* src, size_t srcRB, int count) {
+    auto p0 = static_cast<const uint8_t*>(src),
+         p1 = p0 + srcRB;
+    auto d = static_cast<uint8_t*>(dst);
+    for (int i = 0; i < count; i++) {
+        d[i] = (p0[2*i] + p0[2*i+1] + p1[2*i] + p1[2*i+1]) >> 2;
+    }
+}
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+
+// 4 dst pixels at a time.  Shuffling 8 src pixels into the even and odd ones lets us add them
+// up vertically as well as horizontally, in 16-bit lanes.
+static void downsample_2_2_8888(void* dst, const void* src, size_t srcRB, int count) {
+    auto p0 = static_cast<const uint32_t*>(src),
+         p1 = (const uint32_t*)((const char*)src + srcRB);
+    auto d = static_cast<uint32_t*>(dst);
+    const __m128i zero = _mm_setzero_si128();
+
+    auto add_row = [&](const uint32_t* p, __m128i* lo, __m128i* hi) {
+        __m128 a = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)(p + 0))),
+               b = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)(p + 4)));
+        __m128i even = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2,0,2,0))),
+                odd  = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(3,1,3,1)));
+        *lo = _mm_add_epi16(*lo, _mm_add_epi16(_mm_unpacklo_epi8(even, zero),
+                                               _mm_unpacklo_epi8(odd,  zero)));
+        *hi = _mm_add_epi16(*hi, _mm_add_epi16(_mm_unpackhi_epi8(even, zero),
+                                               _mm_unpackhi_epi8(odd,  zero)));
+    };
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i lo = zero,
+                hi = zero;
+        add_row(p0 + 2*i, &lo, &hi);
+        add_row(p1 + 2*i, &lo, &hi);
+        _mm_storeu_si128((__m128i*)(d + i), _mm_packus_epi16(_mm_srli_epi16(lo, 2),
+                                                             _mm_srli_epi16(hi, 2)));
+    }
+    if (i < count) {
+        downsample_2_2_8888_portable(d + i, p0 + 2*i, srcRB, count - i);
+    }
+}
+
+// 16 dst pixels at a time, adding each byte to its odd neighbor in 16-bit lanes.
+static void downsample_2_2_8(void* dst, const void* src, size_t srcRB, int count) {
+    auto p0 = static_cast<const uint8_t*>(src),
+         p1 = p0 + srcRB;
+    auto d = static_cast<uint8_t*>(dst);
+    const __m128i lowBytes = _mm_set1_epi16(0xFF);
+
+    auto add_pairs = [&](const uint8_t* p) {
+        __m128i v = _mm_loadu_si128((const __m128i*)p);
+        return _mm_add_epi16(_mm_and_si128(v, lowBytes), _mm_srli_epi16(v, 8));
+    };
+
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i lo = _mm_add_epi16(add_pairs(p0 + 2*i +  0), add_pairs(p1 + 2*i +  0)),
+                hi = _mm_add_epi16(add_pairs(p0 + 2*i + 16), add_pairs(p1 + 2*i + 16));
+        _mm_storeu_si128((__m128i*)(d + i), _mm_packus_epi16(_mm_srli_epi16(lo, 2),
+                                                             _mm_srli_epi16(hi, 2)));
+    }
+    if (i < count) {
+        downsample_2_2_8_portable(d + i, p0 + 2*i, srcRB, count - i);
+    }
+}
+
+#elif defined(SK_ARM_HAS_NEON)
+
+// 4 dst pixels at a time.  vld2q_u32() splits 8 src pixels into the even and odd ones for us.
+static void downsample_2_2_8888(void* dst, const void* src, size_t srcRB, int count) {
+    auto p0 = static_cast<const uint32_t*>(src),
+         p1 = (const uint32_t*)((const char*)src + srcRB);
+    auto d = static_cast<uint32_t*>(dst);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        uint32x4x2_t r0 = vld2q_u32(p0 + 2*i),
+                     r1 = vld2q_u32(p1 + 2*i);
+        uint8x16_t e0 = vreinterpretq_u8_u32(r0.val[0]), o0 = vreinterpretq_u8_u32(r0.val[1]),
+                   e1 = vreinterpretq_u8_u32(r1.val[0]), o1 = vreinterpretq_u8_u32(r1.val[1]);
+        uint16x8_t lo = vaddq_u16(vaddl_u8(vget_low_u8(e0), vget_low_u8(o0)),
+                                  vaddl_u8(vget_low_u8(e1), vget_low_u8(o1))),
+                   hi = vaddq_u16(vaddl_u8(vget_high_u8(e0), vget_high_u8(o0)),
+                                  vaddl_u8(vget_high_u8(e1), vget_high_u8(o1)));
+        vst1q_u32(d + i, vreinterpretq_u32_u8(vcombine_u8(vshrn_n_u16(lo, 2),
+                                                          vshrn_n_u16(hi, 2))));
+    }
+    if (i < count) {
+        downsample_2_2_8888_portable(d + i, p0 + 2*i, srcRB, count - i);
+    }
+}
+
+// 16 dst pixels at a time, with pairwise widening adds.
+static void downsample_2_2_8(void* dst, const void* src, size_t srcRB, int count) {
+    auto p0 = static_cast<const uint8_t*>(src),
+         p1 = p0 + srcRB;
+    auto d = static_cast<uint8_t*>(dst);
+
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        uint16x8_t lo = vpadalq_u8(vpaddlq_u8(vld1q_u8(p0 + 2*i +  0)), vld1q_u8(p1 + 2*i +  0)),
+                   hi = vpadalq_u8(vpaddlq_u8(vld1q_u8(p0 + 2*i + 16)), vld1q_u8(p1 + 2*i + 16));
+        vst1q_u8(d + i, vcombine_u8(vshrn_n_u16(lo, 2), vshrn_n_u16(hi, 2)));
+    }
+    if (i < count) {
+        downsample_2_2_8_portable(d + i, p0 + 2*i, srcRB, count - i);
+    }
+}
+
+#else
+
+static void downsample_2_2_8888(void* dst, const void* src, size_t srcRB, int count) {
+    downsample_2_2_8888_portable(dst, src, srcRB, count);
+}
+static void downsample_2_2_8(void* dst, const void* src, size_t srcRB, int count) {
+    downsample_2_2_8_portable(dst, src, srcRB, count);
+}
+
+#endif
+
+}  // namespace SK_OPTS_NS
+
+#endif//SkMipMap_opts_DEFINED
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkNx_avx_DEFINED
+#define SkNx_avx_DEFINED
+
+#include "SkNx.h"
+#include <immintrin.h>
+
+#if SK_CPU_SSE_LEVEL < SK_CPU_SSE_LEVEL_AVX
+    #error "SkNx_avx.h is only for files compiled for AVX."
+#endif
+
+// Sk8f_avx is 8 floats in one AVX register, with SkNx<8,float>'s interface.
+//
+// It can't just specialize SkNx<8,float> the way SkNx_sse.h specializes Sk4f: our SkOpts AVX
+// files share SkNx.h with files compiled for SSE2, and a specialization only they could see would
+// give SkNx<8,float> two definitions in the same binary.  So it lives in SK_OPTS_NS instead, and
+// code compiled for AVX picks it over Sk8f by name.
+
+namespace SK_OPTS_NS {
+
+class Sk8f_avx {
+public:
+    Sk8f_avx(const __m256& vec) : fVec(vec) {}
+
+    Sk8f_avx() {}
+    Sk8f_avx(float val) : fVec(_mm256_set1_ps(val)) {}
+    Sk8f_avx(float a, float b, float c, float d, float e, float f, float g, float h)
+        : fVec(_mm256_setr_ps(a,b,c,d, e,f,g,h)) {}
+
+    static Sk8f_avx Load(const void* ptr) { return _mm256_loadu_ps((const float*)ptr); }
+    void store(void* ptr) const { _mm256_storeu_ps((float*)ptr, fVec); }
+
+    // Non-member friends, so a float converts on either side: 1.0f - a, r * 255.0f.
+    friend Sk8f_avx operator+(const Sk8f_avx& x, const Sk8f_avx& y) {
+        return _mm256_add_ps(x.fVec, y.fVec);
+    }
+    friend Sk8f_avx operator-(const Sk8f_avx& x, const Sk8f_avx& y) {
+        return _mm256_sub_ps(x.fVec, y.fVec);
+    }
+    friend Sk8f_avx operator*(const Sk8f_avx& x, const Sk8f_avx& y) {
+        return _mm256_mul_ps(x.fVec, y.fVec);
+    }
+    friend Sk8f_avx operator/(const Sk8f_avx& x, const Sk8f_avx& y) {
+        return _mm256_div_ps(x.fVec, y.fVec);
+    }
+
+    friend Sk8f_avx operator==(const Sk8f_avx& x, const Sk8f_avx& y) {
+        return _mm256_cmp_ps(x.fVec, y.fVec, _CMP_EQ_OQ);
+    }
+    friend Sk8f_avx operator!=(const Sk8f_avx& x, const Sk8f_avx& y) {
+        return _mm256_cmp_ps(x.fVec, y.fVec, _CMP_NEQ_UQ);
+    }
+    friend Sk8f_avx operator< (const Sk8f_avx& x, const Sk8f_avx& y) {
+        return _mm256_cmp_ps(x.fVec, y.fVec, _CMP_LT_OS);
+    }
+    friend Sk8f_avx operator> (const Sk8f_avx& x, const Sk8f_avx& y) {
+        return _mm256_cmp_ps(x.fVec, y.fVec, _CMP_GT_OS);
+    }
+    friend Sk8f_avx operator<=(const Sk8f_avx& x, const Sk8f_avx& y) {
+        return _mm256_cmp_ps(x.fVec, y.fVec, _CMP_LE_OS);
+    }
+    friend Sk8f_avx operator>=(const Sk8f_avx& x, const Sk8f_avx& y) {
+        return _mm256_cmp_ps(x.fVec, y.fVec, _CMP_GE_OS);
+    }
+
+    Sk8f_avx& operator+=(const Sk8f_avx& y) { return (*this = *this + y); }
+    Sk8f_avx& operator-=(const Sk8f_avx& y) { return (*this = *this - y); }
+    Sk8f_avx& operator*=(const Sk8f_avx& y) { return (*this = *this * y); }
+    Sk8f_avx& operator/=(const Sk8f_avx& y) { return (*this = *this / y); }
+
+    static Sk8f_avx Min(const Sk8f_avx& l, const Sk8f_avx& r) {
+        return _mm256_min_ps(l.fVec, r.fVec);
+    }
+    static Sk8f_avx Max(const Sk8f_avx& l, const Sk8f_avx& r) {
+        return _mm256_max_ps(l.fVec, r.fVec);
+    }
+
+    Sk8f_avx    abs() const { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), fVec); }
+    Sk8f_avx  floor() const { return _mm256_floor_ps(fVec); }
+    Sk8f_avx   sqrt() const { return _mm256_sqrt_ps (fVec); }
+    Sk8f_avx  rsqrt() const { return _mm256_rsqrt_ps(fVec); }
+    Sk8f_avx invert() const { return _mm256_rcp_ps  (fVec); }
+
+    float operator[](int k) const {
+        SkASSERT(0 <= k && k < 8);
+        union { __m256 v; float fs[8]; } pun = {fVec};
+        return pun.fs[k&7];
+    }
+
+    bool allTrue() const { return 0xff == _mm256_movemask_ps(fVec); }
+    bool anyTrue() const { return 0x00 != _mm256_movemask_ps(fVec); }
+
+    // Our masks are all 1s or all 0s, so and/andnot/or works as well as blendv, and some
+    // compilers turn _mm256_blendv_ps() of a comparison into a branch per lane.
+    Sk8f_avx thenElse(const Sk8f_avx& t, const Sk8f_avx& e) const {
+        return _mm256_or_ps(_mm256_and_ps   (fVec, t.fVec),
+                            _mm256_andnot_ps(fVec, e.fVec));
+    }
+
+    __m256 fVec;
+};
+
+}  // namespace SK_OPTS_NS
+
+#endif//SkNx_avx_DEFINED
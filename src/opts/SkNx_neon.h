@@ -274,6 +274,12 @@ public:
     SkNx operator + (const SkNx& o) const { return vaddq_u16(fVec, o.fVec); }
     SkNx operator - (const SkNx& o) const { return vsubq_u16(fVec, o.fVec); }
     SkNx operator * (const SkNx& o) const { return vmulq_u16(fVec, o.fVec); }
+    SkNx operator & (const SkNx& o) const { return vandq_u16(fVec, o.fVec); }
+
+    SkNx mulHi(const SkNx& o) const {
+        return vcombine_u16(vshrn_n_u32(vmull_u16(vget_low_u16 (fVec), vget_low_u16 (o.fVec)), 16),
+                            vshrn_n_u32(vmull_u16(vget_high_u16(fVec), vget_high_u16(o.fVec)), 16));
+    }
 
     SkNx operator << (int bits) const { SHIFT16(vshlq_n_u16, fVec, bits); }
     SkNx operator >> (int bits) const { SHIFT16(vshrq_n_u16, fVec, bits); }
@@ -451,11 +457,24 @@ template<> inline Sk4b SkNx_cast<uint8_t, uint16_t>(const Sk4h& src) {
     return vmovn_u16(vcombine_u16(src.fVec, src.fVec));
 }
 
+template<> inline Sk16h SkNx_cast<uint16_t, uint8_t>(const Sk16b& src) {
+    return { vmovl_u8(vget_low_u8(src.fVec)), vmovl_u8(vget_high_u8(src.fVec)) };
+}
+
+template<> inline Sk16b SkNx_cast<uint8_t, uint16_t>(const Sk16h& src) {
+    return vcombine_u8(vmovn_u16(src.fLo.fVec), vmovn_u16(src.fHi.fVec));
+}
+
 template<> inline Sk4b SkNx_cast<uint8_t, int>(const Sk4i& src) {
     uint16x4_t _16 = vqmovun_s32(src.fVec);
     return vqmovn_u16(vcombine_u16(_16, _16));
 }
 
+template<> inline Sk4i SkNx_cast<int, uint8_t>(const Sk4b& src) {
+    uint16x4_t _16 = vget_low_u16(vmovl_u8(src.fVec));
+    return vreinterpretq_s32_u32(vmovl_u16(_16));
+}
+
 static inline Sk4i Sk4f_round(const Sk4f& x) {
     return vcvtq_s32_f32((x + 0.5f).fVec);
 }
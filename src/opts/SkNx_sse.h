@@ -209,6 +209,9 @@ public:
     SkNx operator + (const SkNx& o) const { return _mm_add_epi16(fVec, o.fVec); }
     SkNx operator - (const SkNx& o) const { return _mm_sub_epi16(fVec, o.fVec); }
     SkNx operator * (const SkNx& o) const { return _mm_mullo_epi16(fVec, o.fVec); }
+    SkNx operator & (const SkNx& o) const { return _mm_and_si128(fVec, o.fVec); }
+
+    SkNx mulHi(const SkNx& o) const { return _mm_mulhi_epu16(fVec, o.fVec); }
 
     SkNx operator << (int bits) const { return _mm_slli_epi16(fVec, bits); }
     SkNx operator >> (int bits) const { return _mm_srli_epi16(fVec, bits); }
@@ -376,6 +379,20 @@ template<> inline Sk4b SkNx_cast<uint8_t, int>(const Sk4i& src) {
     return _mm_packus_epi16(_mm_packus_epi16(src.fVec, src.fVec), src.fVec);
 }
 
+template<> /*static*/ inline Sk16h SkNx_cast<uint16_t, uint8_t>(const Sk16b& src) {
+    return { _mm_unpacklo_epi8(src.fVec, _mm_setzero_si128()),
+             _mm_unpackhi_epi8(src.fVec, _mm_setzero_si128()) };
+}
+
+template<> /*static*/ inline Sk16b SkNx_cast<uint8_t, uint16_t>(const Sk16h& src) {
+    return _mm_packus_epi16(src.fLo.fVec, src.fHi.fVec);
+}
+
+template<> inline Sk4i SkNx_cast<int, uint8_t>(const Sk4b& src) {
+    __m128i _16 = _mm_unpacklo_epi8(src.fVec, _mm_setzero_si128());
+    return _mm_unpacklo_epi16(_16, _mm_setzero_si128());
+}
+
 static inline Sk4i Sk4f_round(const Sk4f& x) {
     return _mm_cvtps_epi32(x.fVec);
 }
@@ -8,7 +8,10 @@
 #include "SkOpts.h"
 
 #define SK_OPTS_NS avx
+#include "SkRasterPipeline_opts.h"
 
 namespace SkOpts {
-    void Init_avx() { }
+    void Init_avx() {
+        compile_pipeline_8 = avx::compile_pipeline_8;
+    }
 }
@@ -0,0 +1,33 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkOpts.h"
+
+#define SK_OPTS_NS avx2
+#include "SkBlend_opts.h"
+#include "SkBlitMask_opts.h"
+#include "SkBlitRow_opts.h"
+#include "SkBlurImageFilter_opts.h"
+#include "SkSwizzler_opts.h"
+
+namespace SkOpts {
+    void Init_avx2() {
+        // These have 256-bit AVX2 code paths.
+        blit_row_s32a_opaque = avx2::blit_row_s32a_opaque;
+        RGBA_to_BGRA         = avx2::RGBA_to_BGRA;
+        RGBA_to_rgbA         = avx2::RGBA_to_rgbA;
+        RGBA_to_bgrA         = avx2::RGBA_to_bgrA;
+        index8_to_8888       = avx2::index8_to_8888;
+
+        // These are just their SSE4.1 code, recompiled to take advantage of VEX encoding.
+        blit_mask_d32_a8     = avx2::blit_mask_d32_a8;
+        box_blur_xx          = avx2::box_blur_xx;
+        box_blur_xy          = avx2::box_blur_xy;
+        box_blur_yx          = avx2::box_blur_yx;
+        srcover_srgb_srgb    = avx2::srcover_srgb_srgb;
+    }
+}
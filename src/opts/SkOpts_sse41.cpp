@@ -12,6 +12,7 @@
 #include "SkBlitRow_opts.h"
 #include "SkBlend_opts.h"
 #include "SkColorXform_opts.h"
+#include "SkMatrixConvolutionImageFilter_opts.h"
 
 namespace SkOpts {
     void Init_sse41() {
@@ -20,6 +21,7 @@ namespace SkOpts {
         box_blur_yx          = sse41::box_blur_yx;
         srcover_srgb_srgb    = sse41::srcover_srgb_srgb;
         blit_row_s32a_opaque = sse41::blit_row_s32a_opaque;
+        matrix_convolve      = sse41::matrix_convolve;
 
         color_xform_RGB1_to_2dot2  = sse41::color_xform_RGB1_to_2dot2;
         color_xform_RGB1_to_srgb   = sse41::color_xform_RGB1_to_srgb;
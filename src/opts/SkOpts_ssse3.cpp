@@ -28,5 +28,7 @@ namespace SkOpts {
         grayA_to_rgbA         = ssse3::grayA_to_rgbA;
         inverted_CMYK_to_RGB1 = ssse3::inverted_CMYK_to_RGB1;
         inverted_CMYK_to_BGR1 = ssse3::inverted_CMYK_to_BGR1;
+        rgbA_to_RGBA          = ssse3::rgbA_to_RGBA;
+        rgbA_to_BGRA          = ssse3::rgbA_to_BGRA;
     }
 }
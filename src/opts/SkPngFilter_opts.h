@@ -0,0 +1,269 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPngFilter_opts_DEFINED
+#define SkPngFilter_opts_DEFINED
+
+#include "SkTypes.h"
+#include <string.h>
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    #include <emmintrin.h>
+#elif defined(SK_ARM_HAS_NEON)
+    #include <arm_neon.h>
+#endif
+
+// Each of these undoes one of PNG's row filters, in place.  row holds rowBytes bytes of a
+// filtered row (without its filter type byte), prev the previous row already unfiltered
+// (all zeros for the first row), and bpp is the number of bytes per pixel, 1 to 4.
+
+namespace SK_OPTS_NS {
+
+static void png_unfilter_sub_portable(uint8_t* row, const uint8_t*, size_t rowBytes, int bpp) {
+    for (size_t i = bpp; i < rowBytes; i++) {
+        row[i] += row[i - bpp];
+    }
+}
+
+static void png_unfilter_up_portable(uint8_t* row, const uint8_t* prev, size_t rowBytes, int) {
+    for (size_t i = 0; i < rowBytes; i++) {
+        row[i] += prev[i];
+    }
+}
+
+static void png_unfilter_avg_portable(uint8_t* row, const uint8_t* prev, size_t rowBytes,
+                                      int bpp) {
+    for (int i = 0; i < bpp; i++) {
+        row[i] += prev[i] >> 1;
+    }
+    for (size_t i = bpp; i < rowBytes; i++) {
+        row[i] += (row[i - bpp] + prev[i]) >> 1;
+    }
+}
+
+static inline uint8_t paeth_predictor(int a, int b, int c) {
+    int pa = SkAbs32(b - c),
+        pb = SkAbs32(a - c),
+        pc = SkAbs32(a + b - 2*c);
+    return pa <= pb && pa <= pc ? a
+         : pb <= pc             ? b
+         :                        c;
+}
+
+static void png_unfilter_paeth_portable(uint8_t* row, const uint8_t* prev, size_t rowBytes,
+                                        int bpp) {
+    for (int i = 0; i < bpp; i++) {
+        row[i] += prev[i];
+    }
+    for (size_t i = bpp; i < rowBytes; i++) {
+        row[i] += paeth_predictor(row[i - bpp], prev[i], prev[i - bpp]);
+    }
+}
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2 || defined(SK_ARM_HAS_NEON)
+
+// Sub, Avg, and Paeth depend on the pixel to the left, so we vectorize them across the 3 or 4
+// bytes of one pixel at a time.  Up has no such dependency, and we go 16 bytes at a time.
+
+// These are templated on bpp so the memcpy()s compile to plain loads and stores.  We build
+// 3-byte pixels up in a register: memcpy()ing 3 bytes into a zeroed uint32_t goes through
+// the stack, and the wide reload of those narrow stores can't be forwarded.
+template <int kBpp>
+static inline uint32_t load_pixel(const uint8_t* p) {
+    static_assert(kBpp == 4, "");
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+template <>
+inline uint32_t load_pixel<3>(const uint8_t* p) {
+    uint16_t lo;
+    memcpy(&lo, p, 2);
+    return lo | (uint32_t)p[2] << 16;
+}
+
+template <int kBpp>
+static inline void store_pixel(uint8_t* p, uint32_t v) {
+    memcpy(p, &v, kBpp);
+}
+
+// Calls fn<3> or fn<4> for 3 or 4 bytes per pixel, and the portable fallback otherwise.
+#define DISPATCH_BPP(fn, row, prev, rowBytes, bpp)                      \
+    switch (bpp) {                                                      \
+        case 3:  return fn<3>(row, prev, rowBytes);                     \
+        case 4:  return fn<4>(row, prev, rowBytes);                     \
+        default: return png_##fn##_portable(row, prev, rowBytes, bpp);  \
+    }
+
+#endif
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+
+template <int kBpp>
+static void unfilter_sub(uint8_t* row, const uint8_t*, size_t rowBytes) {
+    __m128i a = _mm_setzero_si128();
+    for (size_t i = 0; i < rowBytes; i += kBpp) {
+        __m128i x = _mm_cvtsi32_si128(load_pixel<kBpp>(row + i));
+        a = _mm_add_epi8(a, x);
+        store_pixel<kBpp>(row + i, _mm_cvtsi128_si32(a));
+    }
+}
+
+template <int kBpp>
+static void unfilter_avg(uint8_t* row, const uint8_t* prev, size_t rowBytes) {
+    const __m128i one = _mm_set1_epi8(1);
+    __m128i a = _mm_setzero_si128();
+    for (size_t i = 0; i < rowBytes; i += kBpp) {
+        __m128i b = _mm_cvtsi32_si128(load_pixel<kBpp>(prev + i)),
+                x = _mm_cvtsi32_si128(load_pixel<kBpp>(row  + i));
+        // _mm_avg_epu8() rounds up, where PNG wants to round down.
+        __m128i avg = _mm_sub_epi8(_mm_avg_epu8(a, b),
+                                   _mm_and_si128(_mm_xor_si128(a, b), one));
+        a = _mm_add_epi8(x, avg);
+        store_pixel<kBpp>(row + i, _mm_cvtsi128_si32(a));
+    }
+}
+
+template <int kBpp>
+static void unfilter_paeth(uint8_t* row, const uint8_t* prev, size_t rowBytes) {
+    // We work in 16-bit lanes so the differences can go negative.
+    const __m128i zero = _mm_setzero_si128();
+    auto abs = [&](__m128i v) { return _mm_max_epi16(v, _mm_sub_epi16(zero, v)); };
+
+    __m128i a = zero,
+            c = zero;
+    for (size_t i = 0; i < rowBytes; i += kBpp) {
+        __m128i b = _mm_unpacklo_epi8(_mm_cvtsi32_si128(load_pixel<kBpp>(prev + i)), zero),
+                x = _mm_unpacklo_epi8(_mm_cvtsi32_si128(load_pixel<kBpp>(row  + i)), zero);
+
+        __m128i pa = abs(_mm_sub_epi16(b, c)),
+                pb = abs(_mm_sub_epi16(a, c)),
+                pc = abs(_mm_sub_epi16(_mm_add_epi16(a, b), _mm_add_epi16(c, c)));
+        __m128i smallest = _mm_min_epi16(pa, _mm_min_epi16(pb, pc));
+
+        // Pick a where pa is smallest, otherwise b where pb is, otherwise c.
+        __m128i useA = _mm_cmpeq_epi16(pa, smallest),
+                useB = _mm_andnot_si128(useA, _mm_cmpeq_epi16(pb, smallest));
+        __m128i nearest = _mm_or_si128(_mm_and_si128(useA, a),
+                          _mm_or_si128(_mm_and_si128(useB, b),
+                                       _mm_andnot_si128(_mm_or_si128(useA, useB), c)));
+
+        a = _mm_and_si128(_mm_add_epi16(x, nearest), _mm_set1_epi16(0xFF));
+        c = b;
+        store_pixel<kBpp>(row + i, _mm_cvtsi128_si32(_mm_packus_epi16(a, zero)));
+    }
+}
+
+static void png_unfilter_up(uint8_t* row, const uint8_t* prev, size_t rowBytes, int bpp) {
+    size_t i = 0;
+    for (; i + 16 <= rowBytes; i += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(row  + i)),
+                b = _mm_loadu_si128((const __m128i*)(prev + i));
+        _mm_storeu_si128((__m128i*)(row + i), _mm_add_epi8(x, b));
+    }
+    png_unfilter_up_portable(row + i, prev + i, rowBytes - i, bpp);
+}
+
+#elif defined(SK_ARM_HAS_NEON)
+
+template <int kBpp>
+static inline uint8x8_t load_pixel_u8(const uint8_t* p) {
+    return vreinterpret_u8_u32(vdup_n_u32(load_pixel<kBpp>(p)));
+}
+
+template <int kBpp>
+static inline void store_pixel_u8(uint8_t* p, uint8x8_t v) {
+    store_pixel<kBpp>(p, vget_lane_u32(vreinterpret_u32_u8(v), 0));
+}
+
+template <int kBpp>
+static void unfilter_sub(uint8_t* row, const uint8_t*, size_t rowBytes) {
+    uint8x8_t a = vdup_n_u8(0);
+    for (size_t i = 0; i < rowBytes; i += kBpp) {
+        a = vadd_u8(a, load_pixel_u8<kBpp>(row + i));
+        store_pixel_u8<kBpp>(row + i, a);
+    }
+}
+
+template <int kBpp>
+static void unfilter_avg(uint8_t* row, const uint8_t* prev, size_t rowBytes) {
+    uint8x8_t a = vdup_n_u8(0);
+    for (size_t i = 0; i < rowBytes; i += kBpp) {
+        // vhadd_u8() rounds down, just like PNG.
+        a = vadd_u8(load_pixel_u8<kBpp>(row + i), vhadd_u8(a, load_pixel_u8<kBpp>(prev + i)));
+        store_pixel_u8<kBpp>(row + i, a);
+    }
+}
+
+template <int kBpp>
+static void unfilter_paeth(uint8_t* row, const uint8_t* prev, size_t rowBytes) {
+    uint8x8_t a = vdup_n_u8(0),
+              c = vdup_n_u8(0);
+    for (size_t i = 0; i < rowBytes; i += kBpp) {
+        uint8x8_t b = load_pixel_u8<kBpp>(prev + i);
+
+        uint16x8_t pa = vabdl_u8(b, c),
+                   pb = vabdl_u8(a, c),
+                   pc = vabdq_u16(vaddl_u8(a, b), vaddl_u8(c, c));
+        uint16x8_t smallest = vminq_u16(pa, vminq_u16(pb, pc));
+
+        // Pick a where pa is smallest, otherwise b where pb is, otherwise c.
+        uint8x8_t useA = vmovn_u16(vceqq_u16(pa, smallest)),
+                  useB = vmovn_u16(vceqq_u16(pb, smallest));
+        uint8x8_t nearest = vbsl_u8(useA, a, vbsl_u8(useB, b, c));
+
+        a = vadd_u8(load_pixel_u8<kBpp>(row + i), nearest);
+        c = b;
+        store_pixel_u8<kBpp>(row + i, a);
+    }
+}
+
+static void png_unfilter_up(uint8_t* row, const uint8_t* prev, size_t rowBytes, int bpp) {
+    size_t i = 0;
+    for (; i + 16 <= rowBytes; i += 16) {
+        vst1q_u8(row + i, vaddq_u8(vld1q_u8(row + i), vld1q_u8(prev + i)));
+    }
+    png_unfilter_up_portable(row + i, prev + i, rowBytes - i, bpp);
+}
+
+#endif
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2 || defined(SK_ARM_HAS_NEON)
+
+static void png_unfilter_sub(uint8_t* row, const uint8_t* prev, size_t rowBytes, int bpp) {
+    DISPATCH_BPP(unfilter_sub, row, prev, rowBytes, bpp);
+}
+static void png_unfilter_avg(uint8_t* row, const uint8_t* prev, size_t rowBytes, int bpp) {
+    DISPATCH_BPP(unfilter_avg, row, prev, rowBytes, bpp);
+}
+static void png_unfilter_paeth(uint8_t* row, const uint8_t* prev, size_t rowBytes, int bpp) {
+    DISPATCH_BPP(unfilter_paeth, row, prev, rowBytes, bpp);
+}
+
+#undef DISPATCH_BPP
+
+#else
+
+static void png_unfilter_sub(uint8_t* row, const uint8_t* prev, size_t rowBytes, int bpp) {
+    png_unfilter_sub_portable(row, prev, rowBytes, bpp);
+}
+static void png_unfilter_up(uint8_t* row, const uint8_t* prev, size_t rowBytes, int bpp) {
+    png_unfilter_up_portable(row, prev, rowBytes, bpp);
+}
+static void png_unfilter_avg(uint8_t* row, const uint8_t* prev, size_t rowBytes, int bpp) {
+    png_unfilter_avg_portable(row, prev, rowBytes, bpp);
+}
+static void png_unfilter_paeth(uint8_t* row, const uint8_t* prev, size_t rowBytes, int bpp) {
+    png_unfilter_paeth_portable(row, prev, rowBytes, bpp);
+}
+
+#endif
+
+}  // namespace SK_OPTS_NS
+
+#endif//SkPngFilter_opts_DEFINED
@@ -0,0 +1,521 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkRasterPipeline_opts_DEFINED
+#define SkRasterPipeline_opts_DEFINED
+
+#include "SkHalf.h"
+#include "SkPM4f.h"
+#include "SkRasterPipeline.h"
+#include "SkSRGB.h"
+#include <functional>
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX
+    #include "SkNx_avx.h"
+#endif
+
+// SkRasterPipeline's stock stages, written once for any float vector type F with SkNx's
+// interface.  SkRasterPipeline.cpp runs them on SkNx<N,float>, and our AVX SkOpts runs them on
+// Sk8f_avx, so every width shares the same arithmetic and draws the same pixels.
+
+namespace SK_OPTS_NS {
+
+typedef SkRasterPipelineStockStages::StockStage StockStage;
+
+template <typename F>
+struct Lanes { static const int N = sizeof(F) / sizeof(float); };
+
+// Stock stages are written as kernels, which do a stage's work but leave what runs next to the
+// caller.  That lets us use one kernel both as an ordinary chained stage and as one step of a
+// fused chain.  kTail kernels work on a single pixel, the rest on a full vector.
+#define KERNEL(name)                                                                           \
+    struct name {                                                                              \
+        template <typename F, bool kTail>                                                      \
+        static SK_ALWAYS_INLINE void Apply(void* ctx, size_t x, F&  r, F&  g, F&  b, F&  a,    \
+                                                                F& dr, F& dg, F& db, F& da);   \
+    };                                                                                         \
+    template <typename F, bool kTail>                                                          \
+    SK_ALWAYS_INLINE void name::Apply(void* ctx, size_t x, F&  r, F&  g, F&  b, F&  a,         \
+                                                           F& dr, F& dg, F& db, F& da)
+
+template <bool kTail, typename F>
+static SK_ALWAYS_INLINE void load_srgb(const uint32_t* ptr, F* r, F* g, F* b, F* a) {
+    const int N = Lanes<F>::N;
+    const int n = kTail ? 1 : N;
+    float R[N] = {0}, G[N] = {0}, B[N] = {0}, A[N] = {0};
+    for (int i = 0; i < n; i++) {
+        R[i] = sk_linear_from_srgb[(ptr[i] >>  0) & 0xff];
+        G[i] = sk_linear_from_srgb[(ptr[i] >>  8) & 0xff];
+        B[i] = sk_linear_from_srgb[(ptr[i] >> 16) & 0xff];
+        A[i] =                    (ptr[i] >> 24) * (1/255.0f);
+    }
+    *r = F::Load(R);
+    *g = F::Load(G);
+    *b = F::Load(B);
+    *a = F::Load(A);
+}
+
+// Transposes 4 pixels of 4 channels each into 4 channels of 4 pixels each, or back.
+static inline void transpose(Sk4f* a, Sk4f* b, Sk4f* c, Sk4f* d) {
+#if !defined(SKNX_NO_SIMD) && SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    _MM_TRANSPOSE4_PS(a->fVec, b->fVec, c->fVec, d->fVec);
+#else
+    float m[16];
+    a->store(m+0);
+    b->store(m+4);
+    c->store(m+8);
+    d->store(m+12);
+    *a = Sk4f{m[0], m[4], m[ 8], m[12]};
+    *b = Sk4f{m[1], m[5], m[ 9], m[13]};
+    *c = Sk4f{m[2], m[6], m[10], m[14]};
+    *d = Sk4f{m[3], m[7], m[11], m[15]};
+#endif
+}
+
+// SkHalfToFloat_01() and SkFloatToHalf_01() convert a pixel's 4 channels at once, 4 pixels at a
+// time we transpose those to and from our planar vectors.
+template <typename F, bool kTail>
+static SK_ALWAYS_INLINE void load_f16(const uint64_t* ptr, F* r, F* g, F* b, F* a) {
+    if (kTail) {
+        Sk4f px = SkHalfToFloat_01(*ptr);
+        *r = px[0];
+        *g = px[1];
+        *b = px[2];
+        *a = px[3];
+        return;
+    }
+    const int N = Lanes<F>::N;
+    float R[N], G[N], B[N], A[N];
+    for (int i = 0; i < N; i += 4) {
+        Sk4f p0 = SkHalfToFloat_01(ptr[i+0]),
+             p1 = SkHalfToFloat_01(ptr[i+1]),
+             p2 = SkHalfToFloat_01(ptr[i+2]),
+             p3 = SkHalfToFloat_01(ptr[i+3]);
+        transpose(&p0, &p1, &p2, &p3);
+        p0.store(R+i);
+        p1.store(G+i);
+        p2.store(B+i);
+        p3.store(A+i);
+    }
+    *r = F::Load(R);
+    *g = F::Load(G);
+    *b = F::Load(B);
+    *a = F::Load(A);
+}
+
+// Loads a vector's worth of coverage bytes, or just one for the tail, as floats in [0,1].
+template <typename F>
+static SK_ALWAYS_INLINE void load_u8(const uint8_t* ptr, bool tail, F* c) {
+    if (tail) {
+        *c = *ptr * (1/255.0f);
+        return;
+    }
+    *c = SkNx_cast<float>(SkNx<Lanes<F>::N, uint8_t>::Load(ptr)) * (1/255.0f);
+}
+
+// Rounds r,g,b,a, already in [0,255], to bytes, and stores a vector's worth of 8888 pixels, or
+// just one for the tail.
+template <typename F>
+static SK_ALWAYS_INLINE void store_8888(uint32_t* ptr, bool tail,
+                                        const F& r, const F& g, const F& b, const F& a) {
+    auto px = SkNx_cast<int>(r + 0.5f)
+            | SkNx_cast<int>(g + 0.5f) << 8
+            | SkNx_cast<int>(b + 0.5f) << 16
+            | SkNx_cast<int>(a + 0.5f) << 24;
+    if (tail) {
+        *ptr = px[0];
+    } else {
+        px.store(ptr);
+    }
+}
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX
+    // Building each vector in registers avoids a store-forwarding stall on the 8 float array.
+    template <bool kTail>
+    static SK_ALWAYS_INLINE void load_srgb(const uint32_t* ptr, Sk8f_avx* r, Sk8f_avx* g,
+                                                                Sk8f_avx* b, Sk8f_avx* a) {
+        if (kTail) {
+            *r = sk_linear_from_srgb[(*ptr >>  0) & 0xff];
+            *g = sk_linear_from_srgb[(*ptr >>  8) & 0xff];
+            *b = sk_linear_from_srgb[(*ptr >> 16) & 0xff];
+            *a =                    (*ptr >> 24) * (1/255.0f);
+            return;
+        }
+        #define LOOKUP(s) _mm256_setr_ps(sk_linear_from_srgb[(ptr[0] >> s) & 0xff],            \
+                                         sk_linear_from_srgb[(ptr[1] >> s) & 0xff],            \
+                                         sk_linear_from_srgb[(ptr[2] >> s) & 0xff],            \
+                                         sk_linear_from_srgb[(ptr[3] >> s) & 0xff],            \
+                                         sk_linear_from_srgb[(ptr[4] >> s) & 0xff],            \
+                                         sk_linear_from_srgb[(ptr[5] >> s) & 0xff],            \
+                                         sk_linear_from_srgb[(ptr[6] >> s) & 0xff],            \
+                                         sk_linear_from_srgb[(ptr[7] >> s) & 0xff])
+        *r = LOOKUP( 0);
+        *g = LOOKUP( 8);
+        *b = LOOKUP(16);
+        #undef LOOKUP
+        __m256i px = _mm256_loadu_si256((const __m256i*)ptr);
+        __m128i lo = _mm_srli_epi32(_mm256_castsi256_si128(px), 24),
+                hi = _mm_srli_epi32(_mm256_extractf128_si256(px, 1), 24);
+        *a = Sk8f_avx(_mm256_cvtepi32_ps(_mm256_insertf128_si256(_mm256_castsi128_si256(lo),
+                                                                 hi, 1))) * (1/255.0f);
+    }
+
+    static SK_ALWAYS_INLINE void load_u8(const uint8_t* ptr, bool tail, Sk8f_avx* c) {
+        if (tail) {
+            *c = *ptr * (1/255.0f);
+            return;
+        }
+        __m128i bytes = _mm_loadl_epi64((const __m128i*)ptr),
+                lo    = _mm_cvtepu8_epi32(bytes),
+                hi    = _mm_cvtepu8_epi32(_mm_srli_si128(bytes, 4));
+        __m256i ints  = _mm256_insertf128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        *c = Sk8f_avx(_mm256_cvtepi32_ps(ints)) * (1/255.0f);
+    }
+
+    static SK_ALWAYS_INLINE void store_8888(uint32_t* ptr, bool tail,
+                                            const Sk8f_avx& r, const Sk8f_avx& g,
+                                            const Sk8f_avx& b, const Sk8f_avx& a) {
+        __m256i R = _mm256_cvttps_epi32((r + 0.5f).fVec),
+                G = _mm256_cvttps_epi32((g + 0.5f).fVec),
+                B = _mm256_cvttps_epi32((b + 0.5f).fVec),
+                A = _mm256_cvttps_epi32((a + 0.5f).fVec);
+        // AVX has no 256-bit integer shifts, so each half is packed with SSE.
+        auto pack = [](__m128i r, __m128i g, __m128i b, __m128i a) {
+            return _mm_or_si128(_mm_or_si128(                r    , _mm_slli_epi32(g,  8)),
+                                _mm_or_si128(_mm_slli_epi32(b, 16), _mm_slli_epi32(a, 24)));
+        };
+        __m128i lo = pack(_mm256_castsi256_si128(R), _mm256_castsi256_si128(G),
+                          _mm256_castsi256_si128(B), _mm256_castsi256_si128(A));
+        if (tail) {
+            *ptr = _mm_cvtsi128_si32(lo);
+            return;
+        }
+        __m128i hi = pack(_mm256_extractf128_si256(R, 1), _mm256_extractf128_si256(G, 1),
+                          _mm256_extractf128_si256(B, 1), _mm256_extractf128_si256(A, 1));
+        _mm_storeu_si128((__m128i*)ptr + 0, lo);
+        _mm_storeu_si128((__m128i*)ptr + 1, hi);
+    }
+#endif
+
+template <typename F>
+static SK_ALWAYS_INLINE F clamp_255(const F& x) {
+    return F::Min(F::Max(x, 0.0f), 255.0f);
+}
+
+KERNEL(constant_color_kernel) {
+    auto color = static_cast<const SkPM4f*>(ctx);
+    r = color->r();
+    g = color->g();
+    b = color->b();
+    a = color->a();
+}
+
+KERNEL(load_s_srgb_kernel) {
+    load_srgb<kTail>(static_cast<const uint32_t*>(ctx) + x, &r,&g,&b,&a);
+}
+
+KERNEL(load_d_srgb_kernel) {
+    load_srgb<kTail>(static_cast<const uint32_t*>(ctx) + x, &dr,&dg,&db,&da);
+}
+
+KERNEL(load_s_f16_kernel) {
+    load_f16<F,kTail>(static_cast<const uint64_t*>(ctx) + x, &r,&g,&b,&a);
+}
+
+KERNEL(load_d_f16_kernel) {
+    load_f16<F,kTail>(static_cast<const uint64_t*>(ctx) + x, &dr,&dg,&db,&da);
+}
+
+KERNEL(swap_rb_kernel) {
+    SkTSwap(r, b);
+}
+
+KERNEL(swap_rb_d_kernel) {
+    SkTSwap(dr, db);
+}
+
+KERNEL(scale_1_float_kernel) {
+    auto c = *static_cast<const float*>(ctx);
+    r *= c;
+    g *= c;
+    b *= c;
+    a *= c;
+}
+
+KERNEL(scale_u8_kernel) {
+    F c;
+    load_u8(static_cast<const uint8_t*>(ctx) + x, kTail, &c);
+    r *= c;
+    g *= c;
+    b *= c;
+    a *= c;
+}
+
+KERNEL(unpremul_kernel) {
+    auto scale = (a == 0.0f).thenElse(0.0f, 1.0f / a);
+    r *= scale;
+    g *= scale;
+    b *= scale;
+}
+
+KERNEL(matrix_4x5_kernel) {
+    auto m = static_cast<const float*>(ctx);
+    auto R = r*m[0] + g*m[4] + b*m[ 8] + a*m[12] + m[16],
+         G = r*m[1] + g*m[5] + b*m[ 9] + a*m[13] + m[17],
+         B = r*m[2] + g*m[6] + b*m[10] + a*m[14] + m[18],
+         A = r*m[3] + g*m[7] + b*m[11] + a*m[15] + m[19];
+    r = R;
+    g = G;
+    b = B;
+    a = A;
+}
+
+KERNEL(clamp_0_1_kernel) {
+    r = F::Min(F::Max(r, 0.0f), 1.0f);
+    g = F::Min(F::Max(g, 0.0f), 1.0f);
+    b = F::Min(F::Max(b, 0.0f), 1.0f);
+    a = F::Min(F::Max(a, 0.0f), 1.0f);
+}
+
+KERNEL(premul_kernel) {
+    r *= a;
+    g *= a;
+    b *= a;
+}
+
+KERNEL(srcover_kernel) {
+    auto A = 1.0f - a;
+    r += dr * A;
+    g += dg * A;
+    b += db * A;
+    a += da * A;
+}
+
+KERNEL(lerp_u8_kernel) {
+    F c;
+    load_u8(static_cast<const uint8_t*>(ctx) + x, kTail, &c);
+    r = dr + (r - dr) * c;
+    g = dg + (g - dg) * c;
+    b = db + (b - db) * c;
+    a = da + (a - da) * c;
+}
+
+KERNEL(store_srgb_kernel) {
+    store_8888(static_cast<uint32_t*>(ctx) + x, kTail, clamp_255(sk_linear_to_srgb_any(r)),
+                                                       clamp_255(sk_linear_to_srgb_any(g)),
+                                                       clamp_255(sk_linear_to_srgb_any(b)),
+                                                       clamp_255(255.0f * a));
+}
+
+KERNEL(store_f16_kernel) {
+    auto ptr = static_cast<uint64_t*>(ctx) + x;
+    if (kTail) {
+        *ptr = SkFloatToHalf_01(Sk4f{r[0], g[0], b[0], a[0]});
+        return;
+    }
+    const int N = Lanes<F>::N;
+    float R[N], G[N], B[N], A[N];
+    r.store(R);
+    g.store(G);
+    b.store(B);
+    a.store(A);
+    for (int i = 0; i < N; i += 4) {
+        Sk4f p0 = Sk4f::Load(R+i),
+             p1 = Sk4f::Load(G+i),
+             p2 = Sk4f::Load(B+i),
+             p3 = Sk4f::Load(A+i);
+        transpose(&p0, &p1, &p2, &p3);
+        ptr[i+0] = SkFloatToHalf_01(p0);
+        ptr[i+1] = SkFloatToHalf_01(p1);
+        ptr[i+2] = SkFloatToHalf_01(p2);
+        ptr[i+3] = SkFloatToHalf_01(p3);
+    }
+}
+
+#undef KERNEL
+
+// Stock stages, and fused chains of them, for pipelines whose stages hold F vectors.
+template <typename F>
+struct StockPipeline {
+    typedef SkRasterPipelineStage<F> Stage;
+    typedef typename Stage::Fn       Fn;
+
+    // Runs kernels K, Ks... in order, each with the next stage's context.
+    template <bool kTail>
+    static SK_ALWAYS_INLINE void Apply(Stage*, size_t, F&, F&, F&, F&, F&, F&, F&, F&) {}
+
+    template <bool kTail, typename K, typename... Ks>
+    static SK_ALWAYS_INLINE void Apply(Stage* st, size_t x, F&  r, F&  g, F&  b, F&  a,
+                                                            F& dr, F& dg, F& db, F& da) {
+        K::template Apply<F,kTail>(st->template ctx<void*>(), x, r,g,b,a, dr,dg,db,da);
+        Apply<kTail, Ks...>(st+1, x, r,g,b,a, dr,dg,db,da);
+    }
+
+    // A chain of kernels Ks... as a single stage.  With one kernel this is just an ordinary
+    // stage; with more they run back to back with no indirect calls between them.  Each kernel
+    // gets the context of its own stage, starting with st.
+    template <bool kTail, typename... Ks>
+    static void SK_VECTORCALL Fused(Stage* st, size_t x, F  r, F  g, F  b, F  a,
+                                                         F dr, F dg, F db, F da) {
+        Apply<kTail, Ks...>(st, x, r,g,b,a, dr,dg,db,da);
+        (st + sizeof...(Ks) - 1)->next(x, r,g,b,a, dr,dg,db,da);
+    }
+
+    static void StockFns(StockStage stage, Fn* body, Fn* tail) {
+        switch (stage) {
+        #define CASE(name) case SkRasterPipelineStockStages::name:                             \
+                               *body = Fused<false, name##_kernel>;                            \
+                               *tail = Fused<true,  name##_kernel>; return
+            CASE(constant_color);
+            CASE(load_s_srgb);
+            CASE(load_d_srgb);
+            CASE(load_s_f16);
+            CASE(load_d_f16);
+            CASE(swap_rb);
+            CASE(swap_rb_d);
+            CASE(scale_1_float);
+            CASE(scale_u8);
+            CASE(unpremul);
+            CASE(matrix_4x5);
+            CASE(clamp_0_1);
+            CASE(premul);
+            CASE(srcover);
+            CASE(lerp_u8);
+            CASE(store_srgb);
+            CASE(store_f16);
+        #undef CASE
+            case SkRasterPipelineStockStages::kExternal_StockStage: break;
+        }
+        SkFAIL("Not a stock stage.");
+    }
+
+    // Wherever stock[] has one of a few common chains of stock stages, points the stage before
+    // it (or *bodyStart and *tailStart) at a single kernel fusing that whole chain together.
+    static void Fuse(const StockStage* stock, int count,
+                     Stage* body, Stage* tail, Fn* bodyStart, Fn* tailStart) {
+        struct Fusion {
+            StockStage chain[5];
+            int        len;
+            Fn         body, tail;
+        };
+
+        // Common chains, most specific first.
+        #define K(name) name##_kernel
+        typedef SkRasterPipelineStockStages S;
+        static const Fusion kFusions[] = {
+            { {S::constant_color, S::load_d_srgb, S::lerp_u8, S::store_srgb}, 4,
+              Fused<false, K(constant_color), K(load_d_srgb), K(lerp_u8), K(store_srgb)>,
+              Fused<true,  K(constant_color), K(load_d_srgb), K(lerp_u8), K(store_srgb)> },
+            { {S::load_d_srgb, S::srcover, S::lerp_u8, S::store_srgb}, 4,
+              Fused<false, K(load_d_srgb), K(srcover), K(lerp_u8), K(store_srgb)>,
+              Fused<true,  K(load_d_srgb), K(srcover), K(lerp_u8), K(store_srgb)> },
+            { {S::load_d_srgb, S::srcover, S::store_srgb}, 3,
+              Fused<false, K(load_d_srgb), K(srcover), K(store_srgb)>,
+              Fused<true,  K(load_d_srgb), K(srcover), K(store_srgb)> },
+            { {S::load_s_f16, S::scale_1_float, S::load_d_f16, S::srcover, S::store_f16}, 5,
+              Fused<false, K(load_s_f16), K(scale_1_float), K(load_d_f16), K(srcover),
+                           K(store_f16)>,
+              Fused<true,  K(load_s_f16), K(scale_1_float), K(load_d_f16), K(srcover),
+                           K(store_f16)> },
+            { {S::load_s_f16, S::load_d_f16, S::srcover, S::store_f16}, 4,
+              Fused<false, K(load_s_f16), K(load_d_f16), K(srcover), K(store_f16)>,
+              Fused<true,  K(load_s_f16), K(load_d_f16), K(srcover), K(store_f16)> },
+            { {S::load_d_f16, S::srcover, S::store_f16}, 3,
+              Fused<false, K(load_d_f16), K(srcover), K(store_f16)>,
+              Fused<true,  K(load_d_f16), K(srcover), K(store_f16)> },
+            // SkColorMatrixFilterRowMajor255's stages.
+            { {S::unpremul, S::matrix_4x5, S::clamp_0_1, S::premul}, 4,
+              Fused<false, K(unpremul), K(matrix_4x5), K(clamp_0_1), K(premul)>,
+              Fused<true,  K(unpremul), K(matrix_4x5), K(clamp_0_1), K(premul)> },
+        };
+        #undef K
+
+        // Fused kernels finish by calling the last fused stage's next(), so a chain fused here
+        // works just as well in the middle of the pipeline as at its end, and stays correct if
+        // more stages are appended after it.  We walk back from the end, fusing the first chain
+        // that ends at each stage, and otherwise moving on to the stage before it.
+        int end = count;
+        while (end > 0) {
+            int len = 1;
+            for (const Fusion& fusion : kFusions) {
+                const int at = end - fusion.len;
+                if (at < 0 || 0 != memcmp(stock + at, fusion.chain,
+                                          fusion.len * sizeof(StockStage))) {
+                    continue;
+                }
+                (at == 0 ? *bodyStart : body[at-1].fNext) = fusion.body;
+                (at == 0 ? *tailStart : tail[at-1].fNext) = fusion.tail;
+                len = fusion.len;
+                break;
+            }
+            end -= len;
+        }
+    }
+
+    // Walks x through [0,n), a full vector of pixels at a time through body, then the rest one
+    // pixel at a time through tail.
+    static void Run(Fn bodyStart, Stage* body, Fn tailStart, Stage* tail, size_t n) {
+        const size_t N = Lanes<F>::N;
+
+        // It's fastest to start uninitialized if the compilers all let us.  If not, next fastest
+        // is 0.
+        F v;
+
+        size_t x = 0;
+        while (n >= N) {
+            bodyStart(body, x, v,v,v,v, v,v,v,v);
+            x += N;
+            n -= N;
+        }
+        while (n > 0) {
+            tailStart(tail, x, v,v,v,v, v,v,v,v);
+            x += 1;
+            n -= 1;
+        }
+    }
+};
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX
+    // A pipeline of stock stages, built once and run 8 pixels at a time in AVX registers.
+    class StockProgram8 {
+    public:
+        typedef StockPipeline<Sk8f_avx> P;
+
+        StockProgram8(const StockStage* stock, void* const* ctxs, int count) {
+            for (int i = 0; i < count; i++) {
+                P::Fn body, tail;
+                P::StockFns(stock[i], &body, &tail);
+                (fBody.empty() ? fBodyStart : fBody.back().fNext) = body;
+                (fTail.empty() ? fTailStart : fTail.back().fNext) = tail;
+                fBody.push_back({ &JustReturn, ctxs[i] });
+                fTail.push_back({ &JustReturn, ctxs[i] });
+            }
+            P::Fuse(stock, count, fBody.begin(), fTail.begin(), &fBodyStart, &fTailStart);
+        }
+
+        void operator()(size_t n) {
+            P::Run(fBodyStart, fBody.begin(), fTailStart, fTail.begin(), n);
+        }
+
+    private:
+        static void SK_VECTORCALL JustReturn(P::Stage*, size_t, Sk8f_avx, Sk8f_avx, Sk8f_avx,
+                                             Sk8f_avx, Sk8f_avx, Sk8f_avx, Sk8f_avx, Sk8f_avx) {}
+
+        SkSTArray<10, P::Stage, /*MEM_COPY=*/true> fBody, fTail;
+        P::Fn fBodyStart = &JustReturn,
+              fTailStart = &JustReturn;
+    };
+
+    static inline std::function<void(size_t)> compile_pipeline_8(const StockStage* stock,
+                                                                 void* const* ctxs, int count) {
+        return StockProgram8(stock, ctxs, count);
+    }
+#endif
+
+}  // namespace SK_OPTS_NS
+
+#endif//SkRasterPipeline_opts_DEFINED
@@ -9,6 +9,7 @@
 #define SkSwizzler_opts_DEFINED
 
 #include "SkColorPriv.h"
+#include "SkUnPreMultiply.h"
 
 #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSSE3
     #include <immintrin.h>
@@ -66,6 +67,39 @@ static void RGBA_to_BGRA_portable(uint32_t* dst, const void* vsrc, int count) {
     }
 }
 
+template <bool kSwapRB>
+static void unpremul_should_swapRB_portable(uint32_t* dst, const void* vsrc, int count) {
+    auto src = (const uint32_t*)vsrc;
+    const SkUnPreMultiply::Scale* table = SkUnPreMultiply::GetScaleTable();
+    for (int i = 0; i < count; i++) {
+        uint8_t a = src[i] >> 24,
+                b = src[i] >> 16,
+                g = src[i] >>  8,
+                r = src[i] >>  0;
+        if (0 != a && 255 != a) {
+            SkUnPreMultiply::Scale scale = table[a];
+            b = SkUnPreMultiply::ApplyScale(scale, b);
+            g = SkUnPreMultiply::ApplyScale(scale, g);
+            r = SkUnPreMultiply::ApplyScale(scale, r);
+        }
+        if (kSwapRB) {
+            SkTSwap(r, b);
+        }
+        dst[i] = (uint32_t)a << 24
+               | (uint32_t)b << 16
+               | (uint32_t)g <<  8
+               | (uint32_t)r <<  0;
+    }
+}
+
+static void rgbA_to_RGBA_portable(uint32_t* dst, const void* src, int count) {
+    unpremul_should_swapRB_portable<false>(dst, src, count);
+}
+
+static void rgbA_to_BGRA_portable(uint32_t* dst, const void* src, int count) {
+    unpremul_should_swapRB_portable<true>(dst, src, count);
+}
+
 static void RGB_to_RGB1_portable(uint32_t dst[], const void* vsrc, int count) {
     const uint8_t* src = (const uint8_t*)vsrc;
     for (int i = 0; i < count; i++) {
@@ -166,6 +200,22 @@ static void inverted_CMYK_to_BGR1_portable(uint32_t* dst, const void* vsrc, int
     }
 }
 
+static void index8_to_8888_portable(uint32_t* dst, const uint8_t* src, int count,
+                                    const uint32_t table[256]) {
+    while (count >= 4) {
+        dst[0] = table[src[0]];
+        dst[1] = table[src[1]];
+        dst[2] = table[src[2]];
+        dst[3] = table[src[3]];
+        src += 4;
+        dst += 4;
+        count -= 4;
+    }
+    for (int i = 0; i < count; i++) {
+        dst[i] = table[src[i]];
+    }
+}
+
 #if defined(SK_ARM_HAS_NEON)
 
 // Rounded divide by 255, (x + 127) / 255
@@ -276,6 +326,43 @@ static void RGBA_to_BGRA(uint32_t* dst, const void* vsrc, int count) {
     RGBA_to_BGRA_portable(dst, src, count);
 }
 
+template <bool kSwapRB>
+static void unpremul_should_swapRB(uint32_t* dst, const void* vsrc, int count) {
+    auto src = (const uint32_t*)vsrc;
+    auto proc = kSwapRB ? rgbA_to_BGRA_portable : rgbA_to_RGBA_portable;
+    while (count >= 8) {
+        // Load 8 pixels.
+        uint8x8x4_t rgba = vld4_u8((const uint8_t*) src);
+
+        // Opaque and transparent pixels need no division, so when all 8 are one or the
+        // other we only have to swizzle.  Otherwise fall back to the table.
+        uint8x8_t a = rgba.val[3];
+        uint8x8_t trivial = vorr_u8(vceq_u8(a, vdup_n_u8(0)), vceq_u8(a, vdup_n_u8(0xFF)));
+        if (~0ULL == vget_lane_u64(vreinterpret_u64_u8(trivial), 0)) {
+            if (kSwapRB) {
+                SkTSwap(rgba.val[0], rgba.val[2]);
+            }
+            vst4_u8((uint8_t*) dst, rgba);
+        } else {
+            proc(dst, src, 8);
+        }
+        src += 8;
+        dst += 8;
+        count -= 8;
+    }
+
+    // Call portable code to finish up the tail of [0,8) pixels.
+    proc(dst, src, count);
+}
+
+static void rgbA_to_RGBA(uint32_t* dst, const void* src, int count) {
+    unpremul_should_swapRB<false>(dst, src, count);
+}
+
+static void rgbA_to_BGRA(uint32_t* dst, const void* src, int count) {
+    unpremul_should_swapRB<true>(dst, src, count);
+}
+
 template <bool kSwapRB>
 static void insert_alpha_should_swaprb(uint32_t dst[], const void* vsrc, int count) {
     const uint8_t* src = (const uint8_t*) vsrc;
@@ -490,6 +577,11 @@ static void inverted_CMYK_to_BGR1(uint32_t dst[], const void* src, int count) {
     inverted_cmyk_to<kBGR1>(dst, src, count);
 }
 
+static void index8_to_8888(uint32_t* dst, const uint8_t* src, int count,
+                           const uint32_t table[256]) {
+    index8_to_8888_portable(dst, src, count, table);
+}
+
 #elif SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSSE3
 
 // Scale a byte by another.
@@ -502,10 +594,69 @@ static __m128i scale(__m128i x, __m128i y) {
     return _mm_mulhi_epu16(_mm_add_epi16(_mm_mullo_epi16(x, y), _128), _257);
 }
 
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+// scale(), 16 lanes at a time.
+static __m256i scale(__m256i x, __m256i y) {
+    const __m256i _128 = _mm256_set1_epi16(128);
+    const __m256i _257 = _mm256_set1_epi16(257);
+
+    return _mm256_mulhi_epu16(_mm256_add_epi16(_mm256_mullo_epi16(x, y), _128), _257);
+}
+#endif
+
 template <bool kSwapRB>
 static void premul_should_swapRB(uint32_t* dst, const void* vsrc, int count) {
     auto src = (const uint32_t*)vsrc;
 
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    // This is premul8() below, run on each 128-bit half of lo and hi at once.  Every step
+    // stays within its half, and each half of the output lines up with the same input pixels.
+    auto premul16 = [](__m256i* lo, __m256i* hi) {
+        const __m256i zeros = _mm256_setzero_si256();
+        __m256i planar;
+        if (kSwapRB) {
+            planar = _mm256_setr_epi8(2,6,10,14, 1,5,9,13, 0,4,8,12, 3,7,11,15,
+                                      2,6,10,14, 1,5,9,13, 0,4,8,12, 3,7,11,15);
+        } else {
+            planar = _mm256_setr_epi8(0,4,8,12, 1,5,9,13, 2,6,10,14, 3,7,11,15,
+                                      0,4,8,12, 1,5,9,13, 2,6,10,14, 3,7,11,15);
+        }
+
+        *lo = _mm256_shuffle_epi8(*lo, planar);
+        *hi = _mm256_shuffle_epi8(*hi, planar);
+        __m256i rg = _mm256_unpacklo_epi32(*lo, *hi),
+                ba = _mm256_unpackhi_epi32(*lo, *hi);
+
+        __m256i r = _mm256_unpacklo_epi8(rg, zeros),
+                g = _mm256_unpackhi_epi8(rg, zeros),
+                b = _mm256_unpacklo_epi8(ba, zeros),
+                a = _mm256_unpackhi_epi8(ba, zeros);
+
+        r = scale(r, a);
+        g = scale(g, a);
+        b = scale(b, a);
+
+        rg = _mm256_or_si256(r, _mm256_slli_epi16(g, 8));
+        ba = _mm256_or_si256(b, _mm256_slli_epi16(a, 8));
+        *lo = _mm256_unpacklo_epi16(rg, ba);
+        *hi = _mm256_unpackhi_epi16(rg, ba);
+    };
+
+    while (count >= 16) {
+        __m256i lo = _mm256_loadu_si256((const __m256i*) (src + 0)),
+                hi = _mm256_loadu_si256((const __m256i*) (src + 8));
+
+        premul16(&lo, &hi);
+
+        _mm256_storeu_si256((__m256i*) (dst + 0), lo);
+        _mm256_storeu_si256((__m256i*) (dst + 8), hi);
+
+        src += 16;
+        dst += 16;
+        count -= 16;
+    }
+#endif
+
     auto premul8 = [](__m128i* lo, __m128i* hi) {
         const __m128i zeros = _mm_setzero_si128();
         __m128i planar;
@@ -583,6 +734,19 @@ static void RGBA_to_BGRA(uint32_t* dst, const void* vsrc, int count) {
     auto src = (const uint32_t*)vsrc;
     const __m128i swapRB = _mm_setr_epi8(2,1,0,3, 6,5,4,7, 10,9,8,11, 14,13,12,15);
 
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    const __m256i swapRB8 = _mm256_broadcastsi128_si256(swapRB);
+    while (count >= 8) {
+        __m256i rgba = _mm256_loadu_si256((const __m256i*) src);
+        __m256i bgra = _mm256_shuffle_epi8(rgba, swapRB8);
+        _mm256_storeu_si256((__m256i*) dst, bgra);
+
+        src += 8;
+        dst += 8;
+        count -= 8;
+    }
+#endif
+
     while (count >= 4) {
         __m128i rgba = _mm_loadu_si128((const __m128i*) src);
         __m128i bgra = _mm_shuffle_epi8(rgba, swapRB);
@@ -596,6 +760,45 @@ static void RGBA_to_BGRA(uint32_t* dst, const void* vsrc, int count) {
     RGBA_to_BGRA_portable(dst, src, count);
 }
 
+template <bool kSwapRB>
+static void unpremul_should_swapRB(uint32_t* dst, const void* vsrc, int count) {
+    auto src = (const uint32_t*)vsrc;
+    auto proc = kSwapRB ? rgbA_to_BGRA_portable : rgbA_to_RGBA_portable;
+    const __m128i swapRB = _mm_setr_epi8(2,1,0,3, 6,5,4,7, 10,9,8,11, 14,13,12,15);
+    const __m128i alphaMask = _mm_set1_epi32(0xFF000000);
+    while (count >= 4) {
+        __m128i rgba = _mm_loadu_si128((const __m128i*) src);
+
+        // Opaque and transparent pixels need no division, so when all 4 are one or the
+        // other we only have to swizzle.  Otherwise fall back to the table.
+        __m128i a = _mm_and_si128(rgba, alphaMask);
+        __m128i trivial = _mm_or_si128(_mm_cmpeq_epi32(a, _mm_setzero_si128()),
+                                       _mm_cmpeq_epi32(a, alphaMask));
+        if (0xFFFF == _mm_movemask_epi8(trivial)) {
+            if (kSwapRB) {
+                rgba = _mm_shuffle_epi8(rgba, swapRB);
+            }
+            _mm_storeu_si128((__m128i*) dst, rgba);
+        } else {
+            proc(dst, src, 4);
+        }
+        src += 4;
+        dst += 4;
+        count -= 4;
+    }
+
+    // Call portable code to finish up the tail of [0,4) pixels.
+    proc(dst, src, count);
+}
+
+static void rgbA_to_RGBA(uint32_t* dst, const void* src, int count) {
+    unpremul_should_swapRB<false>(dst, src, count);
+}
+
+static void rgbA_to_BGRA(uint32_t* dst, const void* src, int count) {
+    unpremul_should_swapRB<true>(dst, src, count);
+}
+
 template <bool kSwapRB>
 static void insert_alpha_should_swaprb(uint32_t dst[], const void* vsrc, int count) {
     const uint8_t* src = (const uint8_t*) vsrc;
@@ -797,6 +1000,22 @@ static void inverted_CMYK_to_BGR1(uint32_t dst[], const void* src, int count) {
     inverted_cmyk_to<kBGR1>(dst, src, count);
 }
 
+static void index8_to_8888(uint32_t* dst, const uint8_t* src, int count,
+                           const uint32_t table[256]) {
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    // Widen 8 indices to 32-bit lanes and look them all up with one gather.
+    while (count >= 8) {
+        __m256i indices = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*) src));
+        _mm256_storeu_si256((__m256i*) dst,
+                            _mm256_i32gather_epi32((const int*) table, indices, 4));
+        src += 8;
+        dst += 8;
+        count -= 8;
+    }
+#endif
+    index8_to_8888_portable(dst, src, count, table);
+}
+
 #else
 
 static void RGBA_to_rgbA(uint32_t* dst, const void* src, int count) {
@@ -811,6 +1030,14 @@ static void RGBA_to_BGRA(uint32_t* dst, const void* src, int count) {
     RGBA_to_BGRA_portable(dst, src, count);
 }
 
+static void rgbA_to_RGBA(uint32_t* dst, const void* src, int count) {
+    rgbA_to_RGBA_portable(dst, src, count);
+}
+
+static void rgbA_to_BGRA(uint32_t* dst, const void* src, int count) {
+    rgbA_to_BGRA_portable(dst, src, count);
+}
+
 static void RGB_to_RGB1(uint32_t dst[], const void* src, int count) {
     RGB_to_RGB1_portable(dst, src, count);
 }
@@ -839,6 +1066,11 @@ static void inverted_CMYK_to_BGR1(uint32_t dst[], const void* src, int count) {
     inverted_CMYK_to_BGR1_portable(dst, src, count);
 }
 
+static void index8_to_8888(uint32_t* dst, const uint8_t* src, int count,
+                           const uint32_t table[256]) {
+    index8_to_8888_portable(dst, src, count, table);
+}
+
 #endif
 
 }
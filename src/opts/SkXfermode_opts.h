@@ -11,6 +11,7 @@
 #include "Sk4px.h"
 #include "SkMSAN.h"
 #include "SkNx.h"
+#include "SkXfermode4x4f.h"
 #include "SkXfermode_proccoeff.h"
 
 namespace {
@@ -112,76 +113,21 @@ XFERMODE(Lighten) {
 }
 #undef XFERMODE
 
-// Some xfermodes use math like divide or sqrt that's best done in floats 1 pixel at a time.
-#define XFERMODE(Xfermode) \
-    struct Xfermode { Sk4f operator()(const Sk4f&, const Sk4f&) const; }; \
-    inline Sk4f Xfermode::operator()(const Sk4f& d, const Sk4f& s) const
+// Some xfermodes use math like divide or sqrt that's best done in floats, 4 pixels at a time.
+#define XFERMODE(Xfermode, proc) \
+    struct Xfermode { \
+        Sk4x4f operator()(const Sk4x4f& d, const Sk4x4f& s) const { return proc(s, d); } \
+    }
 
-static inline Sk4f a_rgb(const Sk4f& a, const Sk4f& rgb) {
-    static_assert(SK_A32_SHIFT == 24, "");
-    return a * Sk4f(0,0,0,1) + rgb * Sk4f(1,1,1,0);
-}
-static inline Sk4f alphas(const Sk4f& f) {
-    return f[SK_A32_SHIFT/8];
-}
+XFERMODE(ColorDodge, colordodge_4x4f);
+XFERMODE(ColorBurn,  colorburn_4x4f);
+XFERMODE(SoftLight,  softlight_4x4f);
 
-XFERMODE(ColorDodge) {
-    auto sa = alphas(s),
-         da = alphas(d),
-         isa = Sk4f(1)-sa,
-         ida = Sk4f(1)-da;
-
-    auto srcover = s + d*isa,
-         dstover = d + s*ida,
-         otherwise = sa * Sk4f::Min(da, (d*sa)*(sa-s).invert()) + s*ida + d*isa;
-
-    // Order matters here, preferring d==0 over s==sa.
-    auto colors = (d == Sk4f(0)).thenElse(dstover,
-                  (s ==      sa).thenElse(srcover,
-                                          otherwise));
-    return a_rgb(srcover, colors);
-}
-XFERMODE(ColorBurn) {
-    auto sa = alphas(s),
-         da = alphas(d),
-         isa = Sk4f(1)-sa,
-         ida = Sk4f(1)-da;
-
-    auto srcover = s + d*isa,
-         dstover = d + s*ida,
-         otherwise = sa*(da-Sk4f::Min(da, (da-d)*sa*s.invert())) + s*ida + d*isa;
-
-    // Order matters here, preferring d==da over s==0.
-    auto colors = (d ==      da).thenElse(dstover,
-                  (s == Sk4f(0)).thenElse(srcover,
-                                          otherwise));
-    return a_rgb(srcover, colors);
-}
-XFERMODE(SoftLight) {
-    auto sa = alphas(s),
-         da = alphas(d),
-         isa = Sk4f(1)-sa,
-         ida = Sk4f(1)-da;
-
-    // Some common terms.
-    auto m  = (da > Sk4f(0)).thenElse(d / da, Sk4f(0)),
-         s2 = Sk4f(2)*s,
-         m4 = Sk4f(4)*m;
-
-    // The logic forks three ways:
-    //    1. dark src?
-    //    2. light src, dark dst?
-    //    3. light src, light dst?
-    auto darkSrc = d*(sa + (s2 - sa)*(Sk4f(1) - m)),        // Used in case 1.
-         darkDst = (m4*m4 + m4)*(m - Sk4f(1)) + Sk4f(7)*m,  // Used in case 2.
-         liteDst = m.sqrt() - m,                            // Used in case 3.
-         liteSrc = d*sa + da*(s2-sa)*(Sk4f(4)*d <= da).thenElse(darkDst, liteDst); // Case 2 or 3?
-
-    auto alpha  = s + d*isa;
-    auto colors = s*ida + d*isa + (s2 <= sa).thenElse(darkSrc, liteSrc);           // Case 1 or 2/3?
-
-    return a_rgb(alpha, colors);
-}
+// Non-separable modes use Rec. 601 luminance here, to match the fixed point procs they replace.
+XFERMODE(Hue,        hue_4x4f<SkLum601_4x4f>);
+XFERMODE(Saturation, saturation_4x4f<SkLum601_4x4f>);
+XFERMODE(Color,      color_4x4f<SkLum601_4x4f>);
+XFERMODE(Luminosity, luminosity_4x4f<SkLum601_4x4f>);
 #undef XFERMODE
 
 // A reasonable fallback mode for doing AA is to simply apply the transfermode first,
@@ -267,45 +213,82 @@ private:
 };
 
 template <typename Xfermode>
-class Sk4fXfermode : public SkProcCoeffXfermode {
+class Sk4x4fXfermode : public SkProcCoeffXfermode {
 public:
-    Sk4fXfermode(const ProcCoeff& rec, SkXfermode::Mode mode)
+    Sk4x4fXfermode(const ProcCoeff& rec, SkXfermode::Mode mode)
         : INHERITED(rec, mode) {}
 
     void xfer32(SkPMColor dst[], const SkPMColor src[], int n, const SkAlpha aa[]) const override {
-        for (int i = 0; i < n; i++) {
-            dst[i] = Xfer32_1(dst[i], src[i], aa ? aa+i : nullptr);
+        while (n >= 4) {
+            Xfer32_4(dst, src, aa);
+            dst += 4;
+            src += 4;
+            aa  += aa ? 4 : 0;
+            n   -= 4;
+        }
+        if (n > 0) {
+            // Blend the last few pixels as 4, from padded copies.
+            SkPMColor dst4[4] = { 0, 0, 0, 0 },
+                      src4[4] = { 0, 0, 0, 0 };
+            SkAlpha    aa4[4] = { 0, 0, 0, 0 };
+            memcpy(dst4, dst, n * sizeof(SkPMColor));
+            memcpy(src4, src, n * sizeof(SkPMColor));
+            if (aa) {
+                memcpy(aa4, aa, n * sizeof(SkAlpha));
+            }
+            Xfer32_4(dst4, src4, aa ? aa4 : nullptr);
+            memcpy(dst, dst4, n * sizeof(SkPMColor));
         }
     }
 
     void xfer16(uint16_t dst[], const SkPMColor src[], int n, const SkAlpha aa[]) const override {
-        for (int i = 0; i < n; i++) {
-            SkPMColor dst32 = SkPixel16ToPixel32(dst[i]);
-            dst32 = Xfer32_1(dst32, src[i], aa ? aa+i : nullptr);
-            dst[i] = SkPixel32ToPixel16(dst32);
+        SkPMColor dst32[4];
+        while (n > 0) {
+            const int k = SkTMin(n, 4);
+            for (int i = 0; i < k; i++) {
+                dst32[i] = SkPixel16ToPixel32(dst[i]);
+            }
+            this->xfer32(dst32, src, k, aa);
+            for (int i = 0; i < k; i++) {
+                dst[i] = SkPixel32ToPixel16(dst32[i]);
+            }
+            dst += k;
+            src += k;
+            aa  += aa ? k : 0;
+            n   -= k;
         }
     }
 
 private:
-    static SkPMColor Xfer32_1(SkPMColor dst, const SkPMColor src, const SkAlpha* aa) {
-        Sk4f d = Load(dst),
-             s = Load(src),
-             b = Xfermode()(d, s);
+    static void Xfer32_4(SkPMColor dst[4], const SkPMColor src[4], const SkAlpha* aa) {
+        Sk4x4f d = Load(dst),
+               s = Load(src),
+               b = Xfermode()(d, s);
         if (aa) {
-            Sk4f a = Sk4f(*aa) * Sk4f(1.0f/255);
-            b = b*a + d*(Sk4f(1)-a);
+            Sk4f a = SkNx_cast<float>(Sk4b::Load(aa)) * Sk4f(1.0f/255),
+                 ia = Sk4f(1) - a;
+            b = { b.r*a + d.r*ia, b.g*a + d.g*ia, b.b*a + d.b*ia, b.a*a + d.a*ia };
         }
-        return Round(b);
+        Store(dst, pin_4x4f(b));
     }
 
-    static Sk4f Load(SkPMColor c) {
-        return SkNx_cast<float>(Sk4b::Load(&c)) * Sk4f(1.0f/255);
+    // SkPMColors to and from RGBA floats in [0,1].
+    static Sk4x4f Load(const SkPMColor px[4]) {
+        auto p = Sk4x4f::Transpose((const uint8_t*)px);
+    #if defined(SK_PMCOLOR_IS_BGRA)
+        SkTSwap(p.r, p.b);
+    #endif
+        return { p.r * (1.0f/255), p.g * (1.0f/255), p.b * (1.0f/255), p.a * (1.0f/255) };
     }
 
-    static SkPMColor Round(const Sk4f& f) {
-        SkPMColor c;
-        SkNx_cast<uint8_t>(f * Sk4f(255) + Sk4f(0.5f)).store(&c);
-        return c;
+    static void Store(SkPMColor px[4], Sk4x4f p) {
+    #if defined(SK_PMCOLOR_IS_BGRA)
+        SkTSwap(p.r, p.b);
+    #endif
+        Sk4x4f{ p.r * 255.0f + 0.5f,
+                p.g * 255.0f + 0.5f,
+                p.b * 255.0f + 0.5f,
+                p.a * 255.0f + 0.5f }.transpose((uint8_t*)px);
     }
 
     typedef SkProcCoeffXfermode INHERITED;
@@ -344,10 +327,14 @@ static SkXfermode* create_xfermode(const ProcCoeff& rec, SkXfermode::Mode mode)
     #undef CASE
 
 #define CASE(Xfermode) \
-    case SkXfermode::k##Xfermode##_Mode: return new Sk4fXfermode<Xfermode>(rec, mode)
+    case SkXfermode::k##Xfermode##_Mode: return new Sk4x4fXfermode<Xfermode>(rec, mode)
         CASE(ColorDodge);
         CASE(ColorBurn);
         CASE(SoftLight);
+        CASE(Hue);
+        CASE(Saturation);
+        CASE(Color);
+        CASE(Luminosity);
     #undef CASE
 
         default: break;
@@ -6,6 +6,7 @@
  */
 
 #include "SkBitmapFilter_opts_SSE2.h"
+#include "SkBitmapFilter_opts_avx2.h"
 #include "SkBitmapProcState_opts_SSE2.h"
 #include "SkBitmapProcState_opts_SSSE3.h"
 #include "SkBitmapScaler.h"
@@ -44,6 +45,10 @@ void SkBitmapScaler::PlatformConvolutionProcs(SkConvolutionProcs* procs) {
         procs->fConvolveHorizontally = &convolveHorizontally_SSE2;
         procs->fApplySIMDPadding = &applySIMDPadding_SSE2;
     }
+    if (SkCpu::Supports(SkCpu::AVX2)) {
+        procs->fConvolveVertically = &convolveVertically_avx2;
+        procs->fConvolve4RowsHorizontally = &convolve4RowsHorizontally_avx2;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -87,6 +92,10 @@ void SkBitmapProcState::platformProcs() {
         fMatrixProc = ClampX_ClampY_filter_affine_SSE2;
     } else if (fMatrixProc == ClampX_ClampY_nofilter_affine) {
         fMatrixProc = ClampX_ClampY_nofilter_affine_SSE2;
+    } else if (fMatrixProc == ClampX_ClampY_filter_persp) {
+        fMatrixProc = ClampX_ClampY_filter_persp_SSE2;
+    } else if (fMatrixProc == ClampX_ClampY_nofilter_persp) {
+        fMatrixProc = ClampX_ClampY_nofilter_persp_SSE2;
     }
 }
 
@@ -94,13 +103,13 @@ void SkBitmapProcState::platformProcs() {
 
 static const SkBlitRow::Proc16 platform_16_procs[] = {
     S32_D565_Opaque_SSE2,               // S32_D565_Opaque
-    nullptr,                               // S32_D565_Blend
+    S32_D565_Blend_SSE2,                // S32_D565_Blend
     S32A_D565_Opaque_SSE2,              // S32A_D565_Opaque
-    nullptr,                               // S32A_D565_Blend
+    S32A_D565_Blend_SSE2,               // S32A_D565_Blend
     S32_D565_Opaque_Dither_SSE2,        // S32_D565_Opaque_Dither
-    nullptr,                               // S32_D565_Blend_Dither
+    S32_D565_Blend_Dither_SSE2,         // S32_D565_Blend_Dither
     S32A_D565_Opaque_Dither_SSE2,       // S32A_D565_Opaque_Dither
-    nullptr,                               // S32A_D565_Blend_Dither
+    S32A_D565_Blend_Dither_SSE2,        // S32A_D565_Blend_Dither
 };
 
 SkBlitRow::Proc16 SkBlitRow::PlatformFactory565(unsigned flags) {
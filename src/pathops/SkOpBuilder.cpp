@@ -103,45 +103,17 @@ void SkOpBuilder::reset() {
     fOps.reset();
 }
 
-/* OPTIMIZATION: Union doesn't need to be all-or-nothing. A run of three or more convex
-   paths with union ops could be locally resolved and still improve over doing the
-   ops one at a time. */
+/* OPTIMIZATION: Union doesn't need to be all-or-nothing. A run of three or more
+   union ops could be locally resolved and still improve over doing the ops one at a time. */
 bool SkOpBuilder::resolve(SkPath* result) {
     SkPath original = *result;
     int count = fOps.count();
     bool allUnion = true;
-    SkPathPriv::FirstDirection firstDir = SkPathPriv::kUnknown_FirstDirection;
     for (int index = 0; index < count; ++index) {
-        SkPath* test = &fPathRefs[index];
-        if (kUnion_SkPathOp != fOps[index] || test->isInverseFillType()) {
+        if (kUnion_SkPathOp != fOps[index] || fPathRefs[index].isInverseFillType()) {
             allUnion = false;
             break;
         }
-        // If all paths are convex, track direction, reversing as needed.
-        if (test->isConvex()) {
-            SkPathPriv::FirstDirection dir;
-            if (!SkPathPriv::CheapComputeFirstDirection(*test, &dir)) {
-                allUnion = false;
-                break;
-            }
-            if (firstDir == SkPathPriv::kUnknown_FirstDirection) {
-                firstDir = dir;
-            } else if (firstDir != dir) {
-                SkPath temp;
-                temp.reverseAddPath(*test);
-                *test = temp;
-            }
-            continue;
-        }
-        // If the path is not convex but its bounds do not intersect the others, simplify is enough.
-        const SkRect& testBounds = test->getBounds();
-        for (int inner = 0; inner < index; ++inner) {
-            // OPTIMIZE: check to see if the contour bounds do not intersect other contour bounds?
-            if (SkRect::Intersects(fPathRefs[inner].getBounds(), testBounds)) {
-                allUnion = false;
-                break;
-            }
-        }
     }
     if (!allUnion) {
         *result = fPathRefs[0];
@@ -155,20 +127,40 @@ bool SkOpBuilder::resolve(SkPath* result) {
         reset();
         return true;
     }
+    // Union all of the paths in a single pass: once each path is simplified and wound the same
+    // way, the winding sum of all of them is nonzero exactly where any one of them is filled.
+    SkPathPriv::FirstDirection firstDir = SkPathPriv::kUnknown_FirstDirection;
     SkPath sum;
     for (int index = 0; index < count; ++index) {
-        if (!Simplify(fPathRefs[index], &fPathRefs[index])) {
+        SkPath* test = &fPathRefs[index];
+        if (!Simplify(*test, test)) {
             reset();
             *result = original;
             return false;
         }
-        if (!fPathRefs[index].isEmpty()) {
+        if (!test->isEmpty()) {
             // convert the even odd result back to winding form before accumulating it
-            if (!FixWinding(&fPathRefs[index])) {
+            if (!FixWinding(test)) {
+                reset();
+                *result = original;
+                return false;
+            }
+            // FixWinding may leave the outer contours running either way; reverse the ones that
+            // disagree with the first path so that overlaps add up instead of cancelling out.
+            SkPathPriv::FirstDirection dir;
+            if (!SkPathPriv::CheapComputeFirstDirection(*test, &dir)) {
+                reset();
                 *result = original;
                 return false;
             }
-            sum.addPath(fPathRefs[index]);
+            if (firstDir == SkPathPriv::kUnknown_FirstDirection) {
+                firstDir = dir;
+            } else if (firstDir != dir) {
+                SkPath temp;
+                temp.reverseAddPath(*test);
+                *test = temp;
+            }
+            sum.addPath(*test);
         }
     }
     reset();
@@ -0,0 +1,663 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "SkGeometry.h"
+#include "SkPath.h"
+#include "SkPathOps.h"
+#include "SkTDArray.h"
+#include "SkTSort.h"
+
+/*  ApproximateSimplify works on a grid whose spacing is the tolerance, so all of its geometry is
+    exact integer arithmetic:
+    - curves are flattened to lines, and all points are snapped to the grid;
+    - crossing and touching lines are split at their (snapped) intersections, until no two lines
+      cross except at their ends;
+    - the lines are merged into the edges of a planar graph, and the winding of every face of
+      the graph is found by walking across edges from the outside in;
+    - the edges between filled and unfilled faces are linked into the result's contours.
+ */
+
+namespace {
+
+// Keeps cross products of point differences within 64 bits.
+static const SkScalar kMaxGridCoord = 1 << 29;
+
+// Caps how finely a single curve is flattened.
+static const int kMaxCurveLines = 256;
+
+// Snapping split points to the grid can bend lines into new crossings; give up if splitting
+// keeps finding them.
+static const int kMaxSplitPasses = 8;
+
+static int64_t cross(const SkIPoint& a, const SkIPoint& b) {
+    return (int64_t) a.fX * b.fY - (int64_t) a.fY * b.fX;
+}
+
+static int64_t dot(const SkIPoint& a, const SkIPoint& b) {
+    return (int64_t) a.fX * b.fX + (int64_t) a.fY * b.fY;
+}
+
+// Directions with angles in [0, 180), measured from +x toward +y.
+static bool is_upper_half(const SkIPoint& v) {
+    return v.fY > 0 || (v.fY == 0 && v.fX > 0);
+}
+
+static int sign(int64_t value) {
+    return (value > 0) - (value < 0);
+}
+
+struct Line {
+    SkIPoint fStart;
+    SkIPoint fEnd;
+
+    int32_t top() const { return SkTMin(fStart.fY, fEnd.fY); }
+    int32_t bottom() const { return SkTMax(fStart.fY, fEnd.fY); }
+    int32_t left() const { return SkTMin(fStart.fX, fEnd.fX); }
+    int32_t right() const { return SkTMax(fStart.fX, fEnd.fX); }
+
+    // True if pt, known to be on this line's infinite extension, is strictly between its ends.
+    bool interiorContains(const SkIPoint& pt) const {
+        SkIPoint dir = fEnd - fStart;
+        int64_t along = dot(pt - fStart, dir);
+        return along > 0 && along < dot(dir, dir);
+    }
+};
+
+struct Split {
+    int      fLine;
+    int64_t  fAlong;    // orders the splits of one line from its start
+    SkIPoint fPt;
+
+    bool operator<(const Split& other) const {
+        return fLine < other.fLine || (fLine == other.fLine && fAlong < other.fAlong);
+    }
+};
+
+class Flattener {
+public:
+    Flattener(SkScalar tolerance, SkTDArray<Line>* lines)
+        : fTolerance(tolerance)
+        , fInvTolerance(SkScalarInvert(tolerance))
+        , fLines(lines) {}
+
+    bool flatten(const SkPath& path) {
+        SkPath::Iter iter(path, true);
+        SkPoint pts[4];
+        SkPath::Verb verb;
+        SkAutoConicToQuads quadder;
+        while ((verb = iter.next(pts, false)) != SkPath::kDone_Verb) {
+            switch (verb) {
+                case SkPath::kMove_Verb:
+                    if (!this->snap(pts[0], &fLast)) {
+                        return false;
+                    }
+                    break;
+                case SkPath::kLine_Verb:
+                    if (!this->lineTo(pts[1])) {
+                        return false;
+                    }
+                    break;
+                case SkPath::kQuad_Verb:
+                    if (!this->quadTo(pts)) {
+                        return false;
+                    }
+                    break;
+                case SkPath::kConic_Verb: {
+                    const SkPoint* quadPts = quadder.computeQuads(pts, iter.conicWeight(),
+                                                                  fTolerance);
+                    for (int index = 0; index < quadder.countQuads(); ++index) {
+                        if (!this->quadTo(&quadPts[index * 2])) {
+                            return false;
+                        }
+                    }
+                } break;
+                case SkPath::kCubic_Verb:
+                    if (!this->cubicTo(pts)) {
+                        return false;
+                    }
+                    break;
+                default:
+                    // the iterator has already closed the contour with a line
+                    break;
+            }
+        }
+        return true;
+    }
+
+private:
+    bool snap(const SkPoint& pt, SkIPoint* result) const {
+        SkScalar x = pt.fX * fInvTolerance;
+        SkScalar y = pt.fY * fInvTolerance;
+        if (!(SkScalarAbs(x) < kMaxGridCoord && SkScalarAbs(y) < kMaxGridCoord)) {
+            return false;
+        }
+        result->set(SkScalarRoundToInt(x), SkScalarRoundToInt(y));
+        return true;
+    }
+
+    bool lineTo(const SkPoint& pt) {
+        SkIPoint next;
+        if (!this->snap(pt, &next)) {
+            return false;
+        }
+        if (next != fLast) {
+            Line* line = fLines->append();
+            line->fStart = fLast;
+            line->fEnd = next;
+            fLast = next;
+        }
+        return true;
+    }
+
+    // Splitting a curve with second differences dd into n lines is off by at most dd/(8*n*n).
+    int lineCount(SkScalar secondDiff) const {
+        SkScalar count = SkScalarCeilToScalar(SkScalarSqrt(secondDiff * fInvTolerance / 8));
+        return count < 1 ? 1 : count > kMaxCurveLines ? kMaxCurveLines : (int) count;
+    }
+
+    bool quadTo(const SkPoint pts[3]) {
+        SkVector dd = pts[0] - pts[1] - pts[1] + pts[2];
+        int count = this->lineCount(2 * dd.length());
+        SkScalar dt = SK_Scalar1 / count;
+        for (int index = 1; index < count; ++index) {
+            if (!this->lineTo(SkEvalQuadAt(pts, index * dt))) {
+                return false;
+            }
+        }
+        return this->lineTo(pts[2]);
+    }
+
+    bool cubicTo(const SkPoint pts[4]) {
+        SkVector dd0 = pts[0] - pts[1] - pts[1] + pts[2];
+        SkVector dd1 = pts[1] - pts[2] - pts[2] + pts[3];
+        int count = this->lineCount(6 * SkMaxScalar(dd0.length(), dd1.length()));
+        SkScalar dt = SK_Scalar1 / count;
+        for (int index = 1; index < count; ++index) {
+            SkPoint pt;
+            SkEvalCubicAt(pts, index * dt, &pt, nullptr, nullptr);
+            if (!this->lineTo(pt)) {
+                return false;
+            }
+        }
+        return this->lineTo(pts[3]);
+    }
+
+    SkScalar         fTolerance;
+    SkScalar         fInvTolerance;
+    SkTDArray<Line>* fLines;
+    SkIPoint         fLast;
+};
+
+static void add_split(int line, const Line& l, const SkIPoint& pt, SkTDArray<Split>* splits) {
+    if (pt == l.fStart || pt == l.fEnd) {
+        return;
+    }
+    Split* split = splits->append();
+    split->fLine = line;
+    split->fAlong = dot(pt - l.fStart, l.fEnd - l.fStart);
+    split->fPt = pt;
+}
+
+static void intersect(const SkTDArray<Line>& lines, int aIndex, int bIndex,
+                      SkTDArray<Split>* splits) {
+    const Line& a = lines[aIndex];
+    const Line& b = lines[bIndex];
+    SkIPoint aDir = a.fEnd - a.fStart;
+    SkIPoint bDir = b.fEnd - b.fStart;
+    int aStartSide = sign(cross(bDir, a.fStart - b.fStart));
+    int aEndSide = sign(cross(bDir, a.fEnd - b.fStart));
+    if (aStartSide * aEndSide > 0) {
+        return;
+    }
+    int bStartSide = sign(cross(aDir, b.fStart - a.fStart));
+    int bEndSide = sign(cross(aDir, b.fEnd - a.fStart));
+    if (bStartSide * bEndSide > 0) {
+        return;
+    }
+    if (aStartSide * aEndSide < 0 && bStartSide * bEndSide < 0) {
+        // the lines cross; split both where they meet
+        double t = (double) cross(bDir, a.fStart - b.fStart) /
+                   ((double) cross(bDir, a.fStart - b.fStart) - cross(bDir, a.fEnd - b.fStart));
+        SkIPoint pt;
+        pt.set((int32_t) floor(a.fStart.fX + t * aDir.fX + 0.5),
+               (int32_t) floor(a.fStart.fY + t * aDir.fY + 0.5));
+        add_split(aIndex, a, pt, splits);
+        add_split(bIndex, b, pt, splits);
+        return;
+    }
+    // an end of one line touching the other splits it there; this also covers collinear overlaps
+    if (!aStartSide && b.interiorContains(a.fStart)) {
+        add_split(bIndex, b, a.fStart, splits);
+    }
+    if (!aEndSide && b.interiorContains(a.fEnd)) {
+        add_split(bIndex, b, a.fEnd, splits);
+    }
+    if (!bStartSide && a.interiorContains(b.fStart)) {
+        add_split(aIndex, a, b.fStart, splits);
+    }
+    if (!bEndSide && a.interiorContains(b.fEnd)) {
+        add_split(aIndex, a, b.fEnd, splits);
+    }
+}
+
+struct LineTopLessThan {
+    bool operator()(const Line& a, const Line& b) const {
+        return a.top() < b.top();
+    }
+};
+
+// Splits lines until none cross or touch except at their ends. Returns false if that does
+// not settle down.
+static bool split_lines(SkTDArray<Line>* lines) {
+    SkTDArray<Split> splits;
+    for (int pass = 0; pass < kMaxSplitPasses; ++pass) {
+        int count = lines->count();
+        if (count > 1) {
+            SkTQSort(lines->begin(), lines->end() - 1, LineTopLessThan());
+        }
+        // sweep down, only comparing lines whose vertical spans overlap
+        splits.rewind();
+        for (int index = 0; index < count; ++index) {
+            const Line& line = (*lines)[index];
+            int32_t bottom = line.bottom();
+            int32_t left = line.left();
+            int32_t right = line.right();
+            for (int other = index + 1; other < count && (*lines)[other].top() <= bottom;
+                    ++other) {
+                const Line& o = (*lines)[other];
+                if (o.left() <= right && left <= o.right()) {
+                    intersect(*lines, index, other, &splits);
+                }
+            }
+        }
+        if (splits.isEmpty()) {
+            return true;
+        }
+        SkTQSort(splits.begin(), splits.end() - 1);
+        SkTDArray<Line> splitLines;
+        splitLines.setReserve(count + splits.count());
+        const Split* split = splits.begin();
+        for (int index = 0; index < count; ++index) {
+            SkIPoint start = (*lines)[index].fStart;
+            for (; split < splits.end() && split->fLine == index; ++split) {
+                if (split->fPt != start) {
+                    Line* piece = splitLines.append();
+                    piece->fStart = start;
+                    piece->fEnd = split->fPt;
+                    start = split->fPt;
+                }
+            }
+            if ((*lines)[index].fEnd != start) {
+                Line* piece = splitLines.append();
+                piece->fStart = start;
+                piece->fEnd = (*lines)[index].fEnd;
+            }
+        }
+        lines->swap(splitLines);
+    }
+    return false;
+}
+
+// A line's start (fIndex even) or end (fIndex odd).
+struct Endpoint {
+    SkIPoint fPt;
+    int      fIndex;
+
+    // top to bottom, then left to right
+    bool operator<(const Endpoint& other) const {
+        return fPt.fY < other.fPt.fY || (fPt.fY == other.fPt.fY && fPt.fX < other.fPt.fX);
+    }
+};
+
+struct Edge {
+    int fLo;        // vertex indices, fLo < fHi
+    int fHi;
+    int fWinding;   // winding to the left of fLo->fHi minus winding to its right
+
+    bool operator<(const Edge& other) const {
+        return fLo < other.fLo || (fLo == other.fLo && fHi < other.fHi);
+    }
+};
+
+// Half edge h runs along edge h/2, from fLo to fHi if h is even, and back if it is odd.
+class Graph {
+public:
+    Graph(const SkTDArray<Line>& lines) {
+        // number the distinct points, and find the vertices at the ends of each line
+        SkTDArray<Endpoint> ends;
+        ends.setCount(lines.count() * 2);
+        for (int index = 0; index < lines.count(); ++index) {
+            ends[index * 2].fPt = lines[index].fStart;
+            ends[index * 2].fIndex = index * 2;
+            ends[index * 2 + 1].fPt = lines[index].fEnd;
+            ends[index * 2 + 1].fIndex = index * 2 + 1;
+        }
+        if (ends.count() > 1) {
+            SkTQSort(ends.begin(), ends.end() - 1);
+        }
+        SkTDArray<int> endVert;
+        endVert.setCount(ends.count());
+        fVerts.setReserve(ends.count());
+        for (const Endpoint& end : ends) {
+            if (fVerts.isEmpty() || fVerts.top() != end.fPt) {
+                *fVerts.append() = end.fPt;
+            }
+            endVert[end.fIndex] = fVerts.count() - 1;
+        }
+
+        // merge lines that run between the same vertices, and drop the ones that cancel out
+        SkTDArray<Edge> edges;
+        edges.setReserve(lines.count());
+        for (int index = 0; index < lines.count(); ++index) {
+            int start = endVert[index * 2];
+            int end = endVert[index * 2 + 1];
+            Edge* edge = edges.append();
+            edge->fLo = SkTMin(start, end);
+            edge->fHi = SkTMax(start, end);
+            edge->fWinding = start < end ? 1 : -1;
+        }
+        if (edges.count() > 1) {
+            SkTQSort(edges.begin(), edges.end() - 1);
+        }
+        for (const Edge& edge : edges) {
+            if (fEdges.count() && fEdges.top().fLo == edge.fLo && fEdges.top().fHi == edge.fHi) {
+                fEdges.top().fWinding += edge.fWinding;
+            } else {
+                *fEdges.append() = edge;
+            }
+        }
+        int kept = 0;
+        for (const Edge& edge : fEdges) {
+            if (edge.fWinding) {
+                fEdges[kept++] = edge;
+            }
+        }
+        fEdges.setCount(kept);
+
+        this->sortHalfEdges();
+        this->findFaces();
+    }
+
+    int halfEdgeCount() const { return fEdges.count() * 2; }
+    static int Twin(int h) { return h ^ 1; }
+    int origin(int h) const { return h & 1 ? fEdges[h >> 1].fHi : fEdges[h >> 1].fLo; }
+    int dest(int h) const { return this->origin(Twin(h)); }
+    int winding(int h) const { return h & 1 ? -fEdges[h >> 1].fWinding : fEdges[h >> 1].fWinding; }
+    SkIPoint vector(int h) const { return fVerts[this->dest(h)] - fVerts[this->origin(h)]; }
+    const SkIPoint& point(int vert) const { return fVerts[vert]; }
+    int face(int h) const { return fFace[h]; }
+    int faceCount() const { return fFaceStart.count(); }
+    int faceStart(int face) const { return fFaceStart[face]; }
+    int vertCount() const { return fVerts.count(); }
+    int slot(int h) const { return fSlot[h]; }
+
+    // The half edges leaving a vertex, in increasing angle.
+    int outCount(int vert) const { return fOutStart[vert + 1] - fOutStart[vert]; }
+    int out(int vert, int index) const { return fOut[fOutStart[vert] + index]; }
+
+    // Turning from the reverse of h as little as possible clockwise keeps the same face on
+    // the left.
+    int next(int h) const {
+        int vert = this->dest(h);
+        int count = this->outCount(vert);
+        return this->out(vert, (fSlot[Twin(h)] + count - 1) % count);
+    }
+
+private:
+    struct AngleLessThan {
+        const Graph* fGraph;
+
+        bool operator()(int a, int b) const {
+            SkIPoint va = fGraph->vector(a);
+            SkIPoint vb = fGraph->vector(b);
+            bool upperA = is_upper_half(va);
+            bool upperB = is_upper_half(vb);
+            if (upperA != upperB) {
+                return upperA;
+            }
+            return cross(va, vb) > 0;
+        }
+    };
+
+    void sortHalfEdges() {
+        int vertCount = fVerts.count();
+        fOutStart.setCount(vertCount + 1);
+        sk_bzero(fOutStart.begin(), fOutStart.bytes());
+        for (int h = 0; h < this->halfEdgeCount(); ++h) {
+            fOutStart[this->origin(h) + 1] += 1;
+        }
+        for (int vert = 0; vert < vertCount; ++vert) {
+            fOutStart[vert + 1] += fOutStart[vert];
+        }
+        fOut.setCount(this->halfEdgeCount());
+        SkTDArray<int> fill;
+        fill.append(vertCount, fOutStart.begin());
+        for (int h = 0; h < this->halfEdgeCount(); ++h) {
+            fOut[fill[this->origin(h)]++] = h;
+        }
+        AngleLessThan lessThan = { this };
+        fSlot.setCount(this->halfEdgeCount());
+        for (int vert = 0; vert < vertCount; ++vert) {
+            int* start = &fOut[fOutStart[vert]];
+            int count = this->outCount(vert);
+            // most vertices just join two lines
+            if (count == 2) {
+                if (lessThan(start[1], start[0])) {
+                    SkTSwap(start[0], start[1]);
+                }
+            } else if (count > 2) {
+                SkTQSort(start, start + count - 1, lessThan);
+            }
+            for (int index = 0; index < count; ++index) {
+                fSlot[start[index]] = index;
+            }
+        }
+    }
+
+    void findFaces() {
+        fFace.setCount(this->halfEdgeCount());
+        memset(fFace.begin(), 0xFF, fFace.bytes());
+        for (int h = 0; h < this->halfEdgeCount(); ++h) {
+            if (fFace[h] >= 0) {
+                continue;
+            }
+            int face = fFaceStart.count();
+            *fFaceStart.append() = h;
+            int walk = h;
+            do {
+                fFace[walk] = face;
+                walk = this->next(walk);
+            } while (walk != h);
+        }
+    }
+
+    SkTDArray<SkIPoint> fVerts;     // sorted top to bottom, then left to right
+    SkTDArray<Edge>     fEdges;
+    SkTDArray<int>      fOutStart;  // per vertex, its first entry in fOut
+    SkTDArray<int>      fOut;
+    SkTDArray<int>      fSlot;      // per half edge, its index among its origin's fOut entries
+    SkTDArray<int>      fFace;      // per half edge, the face on its left
+    SkTDArray<int>      fFaceStart; // per face, one of its half edges
+};
+
+// The winding just to the left of vertex vert, found by counting the edges that cross a ray
+// from there to the left.
+static int winding_left_of(const Graph& graph, int vert) {
+    const SkIPoint& pt = graph.point(vert);
+    int winding = 0;
+    for (int h = 0; h < graph.halfEdgeCount(); h += 2) {
+        const SkIPoint& a = graph.point(graph.origin(h));
+        const SkIPoint& b = graph.point(graph.dest(h));
+        bool upward = a.fY < b.fY;
+        const SkIPoint& lo = upward ? a : b;
+        const SkIPoint& hi = upward ? b : a;
+        if (lo.fY <= pt.fY && pt.fY < hi.fY && cross(hi - lo, pt - lo) < 0) {
+            // going right across an upward edge goes from its left to its right
+            winding -= upward ? graph.winding(h) : -graph.winding(h);
+        }
+    }
+    return winding;
+}
+
+static bool is_filled(int winding, bool evenOdd) {
+    return evenOdd ? SkToBool(winding & 1) : winding != 0;
+}
+
+static int find_root(SkTDArray<int>* parent, int vert) {
+    while ((*parent)[vert] != vert) {
+        vert = (*parent)[vert] = (*parent)[(*parent)[vert]];
+    }
+    return vert;
+}
+
+// Sets the winding of every face, one connected piece of the graph at a time. The outside of
+// a piece is the face to the left of its leftmost vertex, and gets its winding from the pieces
+// around it; the other faces follow by walking across edges.
+static void find_face_windings(const Graph& graph, SkTDArray<int>* faceWinding) {
+    int vertCount = graph.vertCount();
+    SkTDArray<int> parent;
+    parent.setCount(vertCount);
+    for (int vert = 0; vert < vertCount; ++vert) {
+        parent[vert] = vert;
+    }
+    for (int h = 0; h < graph.halfEdgeCount(); h += 2) {
+        int a = find_root(&parent, graph.origin(h));
+        int b = find_root(&parent, graph.dest(h));
+        if (a != b) {
+            parent[SkTMax(a, b)] = SkTMin(a, b);
+        }
+    }
+    SkTDArray<int> leftmost;
+    leftmost.setCount(vertCount);
+    memset(leftmost.begin(), 0xFF, leftmost.bytes());
+    for (int vert = 0; vert < vertCount; ++vert) {
+        if (!graph.outCount(vert)) {
+            continue;
+        }
+        int root = find_root(&parent, vert);
+        // vertices are sorted top to bottom, so the first one found wins ties
+        if (leftmost[root] < 0 || graph.point(vert).fX < graph.point(leftmost[root]).fX) {
+            leftmost[root] = vert;
+        }
+    }
+
+    faceWinding->setCount(graph.faceCount());
+    SkTDArray<bool> known;
+    known.setCount(graph.faceCount());
+    memset(known.begin(), 0, known.bytes());
+    SkTDArray<int> stack;
+    for (int vert : leftmost) {
+        if (vert < 0) {
+            continue;
+        }
+        // Every half edge leaves the leftmost vertex rightward, or straight up. In increasing
+        // angle, the ones going up (or right) come first; the outside is left of the last one.
+        int count = graph.outCount(vert);
+        int upward = 0;
+        while (upward < count && is_upper_half(graph.vector(graph.out(vert, upward)))) {
+            ++upward;
+        }
+        int outside = graph.face(graph.out(vert, (upward + count - 1) % count));
+        (*faceWinding)[outside] = winding_left_of(graph, vert);
+        known[outside] = true;
+        *stack.append() = outside;
+        while (!stack.isEmpty()) {
+            int face;
+            stack.pop(&face);
+            int start = graph.faceStart(face);
+            int h = start;
+            do {
+                int twinFace = graph.face(Graph::Twin(h));
+                if (!known[twinFace]) {
+                    (*faceWinding)[twinFace] = (*faceWinding)[face] - graph.winding(h);
+                    known[twinFace] = true;
+                    *stack.append() = twinFace;
+                }
+                h = graph.next(h);
+            } while (h != start);
+        }
+    }
+}
+
+}  // namespace
+
+bool ApproximateSimplify(const SkPath& path, SkScalar tolerance, SkPath* result) {
+    if (!(tolerance > 0) || !path.isFinite()) {
+        return false;
+    }
+    SkPath::FillType fillType = path.isInverseFillType() ? SkPath::kInverseEvenOdd_FillType
+            : SkPath::kEvenOdd_FillType;
+    bool evenOdd = path.getFillType() == SkPath::kEvenOdd_FillType
+            || path.getFillType() == SkPath::kInverseEvenOdd_FillType;
+
+    SkTDArray<Line> lines;
+    Flattener flattener(tolerance, &lines);
+    if (!flattener.flatten(path) || !split_lines(&lines)) {
+        return false;
+    }
+    Graph graph(lines);
+    SkTDArray<int> faceWinding;
+    find_face_windings(graph, &faceWinding);
+
+    // Keep the half edges with the filled side on their left, and link them into contours.
+    int halfEdgeCount = graph.halfEdgeCount();
+    SkTDArray<bool> kept;
+    kept.setCount(halfEdgeCount);
+    for (int h = 0; h < halfEdgeCount; ++h) {
+        kept[h] = is_filled(faceWinding[graph.face(h)], evenOdd)
+                && !is_filled(faceWinding[graph.face(Graph::Twin(h))], evenOdd);
+    }
+    SkPath simple;
+    simple.setFillType(fillType);
+    SkTDArray<SkIPoint> contour;
+    for (int start = 0; start < halfEdgeCount; ++start) {
+        if (!kept[start]) {
+            continue;
+        }
+        contour.rewind();
+        int h = start;
+        do {
+            kept[h] = false;
+            *contour.append() = graph.point(graph.origin(h));
+            // turn as little as possible clockwise onto the next kept half edge
+            int vert = graph.dest(h);
+            int count = graph.outCount(vert);
+            int slot = graph.slot(Graph::Twin(h));
+            int turn = 1;
+            while (turn < count && !kept[graph.out(vert, (slot + count - turn) % count)]
+                    && graph.out(vert, (slot + count - turn) % count) != start) {
+                ++turn;
+            }
+            if (turn == count) {
+                return false;
+            }
+            h = graph.out(vert, (slot + count - turn) % count);
+        } while (h != start);
+        // leave out points in the middle of straight runs
+        int count = contour.count();
+        bool moved = false;
+        for (int index = 0; index < count; ++index) {
+            const SkIPoint& prev = contour[(index + count - 1) % count];
+            const SkIPoint& pt = contour[index];
+            const SkIPoint& next = contour[(index + 1) % count];
+            if (!cross(pt - prev, next - pt) && dot(pt - prev, next - pt) > 0) {
+                continue;
+            }
+            SkPoint scaled = SkPoint::Make(pt.fX * tolerance, pt.fY * tolerance);
+            if (moved) {
+                simple.lineTo(scaled);
+            } else {
+                simple.moveTo(scaled);
+                moved = true;
+            }
+        }
+        if (moved) {
+            simple.close();
+        }
+    }
+    result->swap(simple);
+    return true;
+}
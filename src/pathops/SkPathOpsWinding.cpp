@@ -281,6 +281,7 @@ bool SkOpSpan::sortableTop(SkOpContour* contourHead) {
     const SkPoint* last = nullptr;
     int wind = 0;
     int oppWind = 0;
+    bool fixWinding = this->globalState()->phase() == SkOpGlobalState::kFixWinding;
     for (int index = 0; index < count; ++index) {
         hit = sorted[index];
         if (!hit->fValid) {
@@ -305,6 +306,16 @@ bool SkOpSpan::sortableTop(SkOpContour* contourHead) {
                 return false;
             }
         }
+        if (fixWinding) {
+            // Only the ray's own contour learns its direction; the hit count so far is its
+            // nesting. Other contours crossed here cast their own rays later.
+            if (span == this) {
+                hitSegment->contour()->setCcw(ccw);
+            }
+            last = &hit->fPt;
+            this->globalState()->bumpNested();
+            continue;
+        }
         bool operand = hitSegment->operand();
         if (operand) {
             SkTSwap(wind, oppWind);
@@ -342,12 +353,8 @@ bool SkOpSpan::sortableTop(SkOpContour* contourHead) {
 #endif
         }
         if (sumSet) {
-            if (this->globalState()->phase() == SkOpGlobalState::kFixWinding) {
-                hitSegment->contour()->setCcw(ccw);
-            } else {
-                (void) hitSegment->markAndChaseWinding(span, span->next(), windSum, oppSum, nullptr);
-                (void) hitSegment->markAndChaseWinding(span->next(), span, windSum, oppSum, nullptr);
-            }
+            (void) hitSegment->markAndChaseWinding(span, span->next(), windSum, oppSum, nullptr);
+            (void) hitSegment->markAndChaseWinding(span->next(), span, windSum, oppSum, nullptr);
         }
         if (operand) {
             SkTSwap(wind, oppWind);
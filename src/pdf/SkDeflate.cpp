@@ -8,6 +8,8 @@
 
 #include "SkData.h"
 #include "SkDeflate.h"
+#include "SkTArray.h"
+#include "SkTaskGroup.h"
 
 #ifdef ZLIB_INCLUDE
     #include ZLIB_INCLUDE
@@ -27,11 +29,18 @@ void skia_free_func(void*, void* address) { sk_free(address); }
 
 }  // namespace
 
-#define SKDEFLATEWSTREAM_INPUT_BUFFER_SIZE 4096
 #define SKDEFLATEWSTREAM_OUTPUT_BUFFER_SIZE 4224  // 4096 + 128, usually big
                                                   // enough to always do a
                                                   // single loop.
 
+// Input past the first block is compressed pigz-style: each block on its own
+// thread, primed with the 32K of input before it so ratio hardly suffers, and
+// the pieces concatenated into one deflate stream.
+#define SKDEFLATEWSTREAM_BLOCK_SIZE (128 * 1024)
+#define SKDEFLATEWSTREAM_DICTIONARY_SIZE (32 * 1024)
+// At most this many blocks are compressed (and held in memory) at once.
+#define SKDEFLATEWSTREAM_MAX_PENDING_BLOCKS 8
+
 // called by both write() and finalize()
 static void do_deflate(int flush,
                        z_stream* zStream,
@@ -55,12 +64,117 @@ static void do_deflate(int flush,
                  : returnValue == Z_OK);
 }
 
+namespace {
+
+// One block of input, preceded by up to 32K of the input before it.
+struct Block {
+    Block() : fCapacity(0), fDictionarySize(0), fSize(0), fCheck(0) {}
+
+    unsigned char* input() { return fData.get() + fDictionarySize; }
+
+    // Most streams are small, so the first block grows as needed.
+    void reserve(size_t size) {
+        if (fDictionarySize + size > fCapacity) {
+            fCapacity = SkTMin(SkTMax(SkTMax(fDictionarySize + size, 2 * fCapacity),
+                                      (size_t)SKDEFLATEWSTREAM_OUTPUT_BUFFER_SIZE),
+                               (size_t)(SKDEFLATEWSTREAM_DICTIONARY_SIZE +
+                                        SKDEFLATEWSTREAM_BLOCK_SIZE));
+            fData.realloc(fCapacity);
+        }
+    }
+
+    SkAutoTMalloc<unsigned char> fData;
+    size_t fCapacity;
+    size_t fDictionarySize;
+    size_t fSize;
+    SkDynamicMemoryWStream fOut;
+    uLong fCheck;  // Adler-32 (zlib) or CRC-32 (gzip) of the input.
+};
+
+}  // namespace
+
+// windowBits picks a zlib or gzip header for the first block, and none for the rest.
+static void deflate_block(Block* block, int compressionLevel, int windowBits, bool gzip,
+                          int flush) {
+    z_stream zStream;
+    zStream.next_in = nullptr;
+    zStream.zalloc = &skia_alloc_func;
+    zStream.zfree = &skia_free_func;
+    zStream.opaque = nullptr;
+    SkDEBUGCODE(int r =) deflateInit2(&zStream, compressionLevel, Z_DEFLATED, windowBits,
+                                      8, Z_DEFAULT_STRATEGY);
+    SkASSERT(Z_OK == r);
+    if (block->fDictionarySize) {
+        deflateSetDictionary(&zStream, block->fData.get(), SkToUInt(block->fDictionarySize));
+    }
+    do_deflate(flush, &zStream, &block->fOut, block->input(), block->fSize);
+    (void)deflateEnd(&zStream);
+
+    block->fCheck = gzip ? crc32(crc32(0, nullptr, 0), block->input(), SkToUInt(block->fSize))
+                         : adler32(adler32(0, nullptr, 0), block->input(),
+                                   SkToUInt(block->fSize));
+}
+
+static void write_u32(SkWStream* out, uint32_t v, bool bigEndian) {
+    uint8_t bytes[4];
+    for (int i = 0; i < 4; i++) {
+        bytes[bigEndian ? 3 - i : i] = (v >> (8 * i)) & 0xFF;
+    }
+    out->write(bytes, sizeof(bytes));
+}
+
 // Hide all zlib impl details.
 struct SkDeflateWStream::Impl {
     SkWStream* fOut;
-    unsigned char fInBuffer[SKDEFLATEWSTREAM_INPUT_BUFFER_SIZE];
-    size_t fInBufferIndex;
-    z_stream fZStream;
+    int fCompressionLevel;
+    bool fGzip;
+    size_t fTotalIn;
+    int fBlocksStarted;  // Including fBlock.
+    std::unique_ptr<Block> fBlock;
+    SkTArray<SkAutoTDelete<Block>, true> fPending;
+    SkTaskGroup fPendingGroup;
+    uLong fCheck;  // Of all blocks written to fOut so far.
+
+    int windowBits(int blockIndex) const {
+        return 0 == blockIndex ? (fGzip ? 0x1F : 0x0F) : -0x0F;
+    }
+
+    // Start compressing fBlock, which is not the last, and begin the next block.
+    void startBlock() {
+        Block* block = fBlock.release();
+        const int level = fCompressionLevel,
+                  windowBits = this->windowBits(fBlocksStarted - 1);
+        const bool gzip = fGzip;
+        fPending.push_back().reset(block);
+        fPendingGroup.add([block, level, windowBits, gzip] {
+            deflate_block(block, level, windowBits, gzip, Z_SYNC_FLUSH);
+        });
+
+        fBlock.reset(new Block);
+        fBlock->fDictionarySize = SkTMin(block->fSize, (size_t)SKDEFLATEWSTREAM_DICTIONARY_SIZE);
+        fBlock->reserve(SKDEFLATEWSTREAM_BLOCK_SIZE);
+        memcpy(fBlock->fData.get(), block->input() + block->fSize - fBlock->fDictionarySize,
+               fBlock->fDictionarySize);
+        fBlocksStarted++;
+
+        if (fPending.count() >= SKDEFLATEWSTREAM_MAX_PENDING_BLOCKS) {
+            this->writePending();
+        }
+    }
+
+    void writePending() {
+        fPendingGroup.wait();
+        for (int i = 0; i < fPending.count(); i++) {
+            this->writeBlock(fPending[i].get());
+        }
+        fPending.reset();
+    }
+
+    void writeBlock(Block* block) {
+        block->fOut.writeToStream(fOut);
+        fCheck = fGzip ? crc32_combine(fCheck, block->fCheck, block->fSize)
+                       : adler32_combine(fCheck, block->fCheck, block->fSize);
+    }
 };
 
 SkDeflateWStream::SkDeflateWStream(SkWStream* out,
@@ -68,19 +182,16 @@ SkDeflateWStream::SkDeflateWStream(SkWStream* out,
                                    bool gzip)
     : fImpl(new SkDeflateWStream::Impl) {
     fImpl->fOut = out;
-    fImpl->fInBufferIndex = 0;
+    fImpl->fTotalIn = 0;
     if (!fImpl->fOut) {
         return;
     }
-    fImpl->fZStream.next_in = nullptr;
-    fImpl->fZStream.zalloc = &skia_alloc_func;
-    fImpl->fZStream.zfree = &skia_free_func;
-    fImpl->fZStream.opaque = nullptr;
     SkASSERT(compressionLevel <= 9 && compressionLevel >= -1);
-    SkDEBUGCODE(int r =) deflateInit2(&fImpl->fZStream, compressionLevel,
-                                      Z_DEFLATED, gzip ? 0x1F : 0x0F,
-                                      8, Z_DEFAULT_STRATEGY);
-    SkASSERT(Z_OK == r);
+    fImpl->fCompressionLevel = compressionLevel;
+    fImpl->fGzip = gzip;
+    fImpl->fBlocksStarted = 1;
+    fImpl->fBlock.reset(new Block);
+    fImpl->fCheck = gzip ? crc32(0, nullptr, 0) : adler32(0, nullptr, 0);
 }
 
 SkDeflateWStream::~SkDeflateWStream() { this->finalize(); }
@@ -89,9 +200,25 @@ void SkDeflateWStream::finalize() {
     if (!fImpl->fOut) {
         return;
     }
-    do_deflate(Z_FINISH, &fImpl->fZStream, fImpl->fOut, fImpl->fInBuffer,
-               fImpl->fInBufferIndex);
-    (void)deflateEnd(&fImpl->fZStream);
+    Block* last = fImpl->fBlock.get();
+    const bool single = 1 == fImpl->fBlocksStarted;
+    // The last block finishes the stream.  If it is the only one, zlib writes the
+    // trailer too, and the output is just what a single deflate() would give.
+    deflate_block(last, fImpl->fCompressionLevel, fImpl->windowBits(fImpl->fBlocksStarted - 1),
+                  fImpl->fGzip, Z_FINISH);
+    if (single) {
+        last->fOut.writeToStream(fImpl->fOut);
+    } else {
+        fImpl->writePending();
+        fImpl->writeBlock(last);
+        if (fImpl->fGzip) {
+            write_u32(fImpl->fOut, SkToU32(fImpl->fCheck), false);
+            write_u32(fImpl->fOut, SkToU32(fImpl->fTotalIn & 0xFFFFFFFF), false);
+        } else {
+            write_u32(fImpl->fOut, SkToU32(fImpl->fCheck), true);
+        }
+    }
+    fImpl->fBlock.reset();
     fImpl->fOut = nullptr;
 }
 
@@ -101,24 +228,23 @@ bool SkDeflateWStream::write(const void* void_buffer, size_t len) {
     }
     const char* buffer = (const char*)void_buffer;
     while (len > 0) {
-        size_t tocopy =
-                SkTMin(len, sizeof(fImpl->fInBuffer) - fImpl->fInBufferIndex);
-        memcpy(fImpl->fInBuffer + fImpl->fInBufferIndex, buffer, tocopy);
+        // Only start the full block once there's more input, so the last block
+        // is never an empty one.
+        if (SKDEFLATEWSTREAM_BLOCK_SIZE == fImpl->fBlock->fSize) {
+            fImpl->startBlock();
+        }
+        Block* block = fImpl->fBlock.get();
+        size_t tocopy = SkTMin(len, SKDEFLATEWSTREAM_BLOCK_SIZE - block->fSize);
+        block->reserve(block->fSize + tocopy);
+        memcpy(block->input() + block->fSize, buffer, tocopy);
         len -= tocopy;
         buffer += tocopy;
-        fImpl->fInBufferIndex += tocopy;
-        SkASSERT(fImpl->fInBufferIndex <= sizeof(fImpl->fInBuffer));
-
-        // if the buffer isn't filled, don't call into zlib yet.
-        if (sizeof(fImpl->fInBuffer) == fImpl->fInBufferIndex) {
-            do_deflate(Z_NO_FLUSH, &fImpl->fZStream, fImpl->fOut,
-                       fImpl->fInBuffer, fImpl->fInBufferIndex);
-            fImpl->fInBufferIndex = 0;
-        }
+        block->fSize += tocopy;
+        fImpl->fTotalIn += tocopy;
     }
     return true;
 }
 
 size_t SkDeflateWStream::bytesWritten() const {
-    return fImpl->fZStream.total_in + fImpl->fInBufferIndex;
+    return fImpl->fTotalIn;
 }
@@ -16,6 +16,10 @@
   * this stream using the Deflate algorithm.
   *
   * See http://en.wikipedia.org/wiki/DEFLATE
+  *
+  * Streams longer than 128K are compressed in independent 128K blocks on
+  * SkTaskGroup threads, each primed with the 32K of input before it, and
+  * concatenated into one valid stream, as pigz does.
   */
 class SkDeflateWStream final : public SkWStream {
 public:
@@ -8,12 +8,14 @@
 #include "SkColorPriv.h"
 #include "SkData.h"
 #include "SkDeflate.h"
+#include "SkImageEncoder.h"
 #include "SkImage_Base.h"
 #include "SkJpegInfo.h"
 #include "SkPDFBitmap.h"
 #include "SkPDFCanon.h"
 #include "SkPDFTypes.h"
 #include "SkStream.h"
+#include "SkTHash.h"
 #include "SkUnPreMultiply.h"
 
 void image_get_ro_pixels(const SkImage* image, SkBitmap* dst) {
@@ -348,14 +350,15 @@ static void emit_image_xobject(SkWStream* stream,
                                bool alpha,
                                const sk_sp<SkPDFObject>& smask,
                                const SkPDFObjNumMap& objNumMap,
-                               const SkPDFSubstituteMap& substitutes) {
+                               const SkPDFSubstituteMap& substitutes,
+                               int compressionLevel) {
     SkBitmap bitmap;
     image_get_ro_pixels(image, &bitmap);      // TODO(halcanary): test
     SkAutoLockPixels autoLockPixels(bitmap);  // with malformed images.
 
     // Write to a temporary buffer to get the compressed length.
     SkDynamicMemoryWStream buffer;
-    SkDeflateWStream deflateWStream(&buffer);
+    SkDeflateWStream deflateWStream(&buffer, compressionLevel);
     if (alpha) {
         bitmap_alpha_to_a8(bitmap, &deflateWStream);
     } else {
@@ -399,17 +402,20 @@ namespace {
 // This SkPDFObject only outputs the alpha layer of the given bitmap.
 class PDFAlphaBitmap final : public SkPDFObject {
 public:
-    PDFAlphaBitmap(sk_sp<SkImage> image) : fImage(std::move(image)) { SkASSERT(fImage); }
+    PDFAlphaBitmap(sk_sp<SkImage> image, int compressionLevel)
+        : fImage(std::move(image)), fCompressionLevel(compressionLevel) { SkASSERT(fImage); }
     void emitObject(SkWStream*  stream,
                     const SkPDFObjNumMap& objNumMap,
                     const SkPDFSubstituteMap& subs) const override {
         SkASSERT(fImage);
-        emit_image_xobject(stream, fImage.get(), true, nullptr, objNumMap, subs);
+        emit_image_xobject(stream, fImage.get(), true, nullptr, objNumMap, subs,
+                           fCompressionLevel);
     }
     void drop() override { fImage = nullptr; }
 
 private:
     sk_sp<SkImage> fImage;
+    int fCompressionLevel;
 };
 
 }  // namespace
@@ -423,7 +429,8 @@ public:
                     const SkPDFObjNumMap& objNumMap,
                     const SkPDFSubstituteMap& subs) const override {
         SkASSERT(fImage);
-        emit_image_xobject(stream, fImage.get(), false, fSMask, objNumMap, subs);
+        emit_image_xobject(stream, fImage.get(), false, fSMask, objNumMap, subs,
+                           fCompressionLevel);
     }
     void addResources(SkPDFObjNumMap* catalog,
                       const SkPDFSubstituteMap& subs) const override {
@@ -435,12 +442,14 @@ public:
         }
     }
     void drop() override { fImage = nullptr; fSMask = nullptr; }
-    PDFDefaultBitmap(sk_sp<SkImage> image, sk_sp<SkPDFObject> smask)
-        : fImage(std::move(image)), fSMask(std::move(smask)) { SkASSERT(fImage); }
+    PDFDefaultBitmap(sk_sp<SkImage> image, sk_sp<SkPDFObject> smask, int compressionLevel)
+        : fImage(std::move(image)), fSMask(std::move(smask))
+        , fCompressionLevel(compressionLevel) { SkASSERT(fImage); }
 
 private:
     sk_sp<SkImage> fImage;
     sk_sp<SkPDFObject> fSMask;
+    int fCompressionLevel;
 };
 }  // namespace
 
@@ -491,8 +500,35 @@ void PDFJpegBitmap::emitObject(SkWStream* stream,
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// Photographs have many distinct colors even among a sparse sample of their
+// pixels, where text, charts, and other artwork, which JPEG blurs, have few.
+static bool looks_photographic(const SkBitmap& bm) {
+    static const int kMinPixels = 32 * 32;
+    static const int kSamplesPerSide = 64;
+    if (bm.width() * bm.height() < kMinPixels || bm.colorType() == kIndex_8_SkColorType) {
+        return false;  // Too small to be worth it, or already paletted.
+    }
+    SkAutoLockPixels autoLockPixels(bm);
+    if (!bm.getPixels()) {
+        return false;
+    }
+    int stepX = SkTMax(1, bm.width() / kSamplesPerSide),
+        stepY = SkTMax(1, bm.height() / kSamplesPerSide);
+    int samples = 0;
+    SkTHashSet<SkColor> colors;
+    for (int y = stepY / 2; y < bm.height(); y += stepY) {
+        for (int x = stepX / 2; x < bm.width(); x += stepX) {
+            colors.add(bm.getColor(x, y));
+            ++samples;
+        }
+    }
+    return colors.count() * 4 > samples;
+}
+
 sk_sp<SkPDFObject> SkPDFCreateBitmapObject(sk_sp<SkImage> image,
-                                           SkPixelSerializer* pixelSerializer) {
+                                           SkPixelSerializer* pixelSerializer,
+                                           int compressionLevel,
+                                           int jpegQuality) {
     SkASSERT(image);
     sk_sp<SkData> data(image->refEncoded());
     SkJFIFInfo info;
@@ -526,12 +562,67 @@ sk_sp<SkPDFObject> SkPDFCreateBitmapObject(sk_sp<SkImage> image,
         }
     }
 
+    bool isOpaque = image_compute_is_opaque(image.get());
+    if (!pixelSerializer && jpegQuality >= 0 && jpegQuality <= 100 && isOpaque) {
+        SkBitmap bm;
+        if (as_IB(image.get())->getROPixels(&bm) && looks_photographic(bm)) {
+            data.reset(SkImageEncoder::EncodeData(bm, SkImageEncoder::kJPEG_Type, jpegQuality));
+            if (data && SkIsJFIF(data.get(), &info)) {
+                bool yuv = info.fType == SkJFIFInfo::kYCbCr;
+                if (info.fSize == image->dimensions()) {  // Sanity check.
+                    #ifdef SK_PDF_IMAGE_STATS
+                    gJpegImageObjects.fetch_add(1);
+                    #endif
+                    return sk_make_sp<PDFJpegBitmap>(info.fSize, data.get(), yuv);
+                }
+            }
+        }
+    }
+
     sk_sp<SkPDFObject> smask;
-    if (!image_compute_is_opaque(image.get())) {
-        smask = sk_make_sp<PDFAlphaBitmap>(image);
+    if (!isOpaque) {
+        smask = sk_make_sp<PDFAlphaBitmap>(image, compressionLevel);
     }
     #ifdef SK_PDF_IMAGE_STATS
     gRegularImageObjects.fetch_add(1);
     #endif
-    return sk_make_sp<PDFDefaultBitmap>(std::move(image), std::move(smask));
+    return sk_make_sp<PDFDefaultBitmap>(std::move(image), std::move(smask), compressionLevel);
+}
+
+bool SkPDFImageDigest(const SkImage* image, SkMD5::Digest* digest) {
+    SkASSERT(image);
+    SkMD5 md5;
+    int32_t dimensions[2] = { image->width(), image->height() };
+    sk_sp<SkData> data(image->refEncoded());
+    SkJFIFInfo info;
+    if (data && SkIsJFIF(data.get(), &info) && info.fSize == image->dimensions()) {
+        // Hashing JPEG data is much cheaper than decoding it.
+        md5.write("J", 1);
+        md5.write(dimensions, sizeof(dimensions));
+        md5.write(data->data(), data->size());
+        md5.finish(*digest);
+        return true;
+    }
+
+    SkBitmap bm;
+    if (!as_IB(image)->getROPixels(&bm) || bm.dimensions() != image->dimensions()) {
+        return false;
+    }
+    SkAutoLockPixels autoLockPixels(bm);
+    if (!bm.getPixels()) {
+        return false;
+    }
+    int32_t types[2] = { bm.colorType(), bm.alphaType() };
+    md5.write("P", 1);
+    md5.write(dimensions, sizeof(dimensions));
+    md5.write(types, sizeof(types));
+    if (SkColorTable* ctable = bm.getColorTable()) {
+        md5.write(ctable->readColors(), ctable->count() * sizeof(SkPMColor));
+    }
+    size_t rowBytes = bm.width() * bm.bytesPerPixel();
+    for (int y = 0; y < bm.height(); ++y) {
+        md5.write(bm.getAddr(0, y), rowBytes);
+    }
+    md5.finish(*digest);
+    return true;
 }
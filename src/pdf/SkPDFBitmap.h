@@ -7,6 +7,7 @@
 #ifndef SkPDFBitmap_DEFINED
 #define SkPDFBitmap_DEFINED
 
+#include "SkMD5.h"
 #include "SkRefCnt.h"
 
 class SkImage;
@@ -17,8 +18,20 @@ class SkPDFObject;
  * SkPDFBitmap wraps a SkImage and serializes it as an image Xobject.
  * It is designed to use a minimal amout of memory, aside from refing
  * the image, and its emitObject() does not cache any data.
+ * If jpegQuality is between 0 and 100, opaque photographic images are
+ * encoded as JPEGs of that quality instead.
  */
 sk_sp<SkPDFObject> SkPDFCreateBitmapObject(sk_sp<SkImage>,
-                                           SkPixelSerializer*);
+                                           SkPixelSerializer*,
+                                           int compressionLevel = -1,
+                                           int jpegQuality = -1);
+
+/**
+ * Computes a digest of the image's contents: its JPEG data, if that
+ * is what SkPDFCreateBitmapObject() would pass through, and otherwise its
+ * pixels.  Images with equal digests make identical PDF objects.
+ * Returns false if the image's pixels can not be read.
+ */
+bool SkPDFImageDigest(const SkImage*, SkMD5::Digest*);
 
 #endif  // SkPDFBitmap_DEFINED
@@ -28,6 +28,8 @@ void SkPDFCanon::reset() {
 
     fPDFBitmapMap.foreach([](SkBitmapKey, SkPDFObject** p) { (*p)->unref(); });
     fPDFBitmapMap.reset();
+    fPDFBitmapDigestMap.foreach([](const SkMD5::Digest&, SkPDFObject** p) { (*p)->unref(); });
+    fPDFBitmapDigestMap.reset();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -131,6 +133,15 @@ void SkPDFCanon::addPDFBitmap(SkBitmapKey key, sk_sp<SkPDFObject> pdfBitmap) {
     fPDFBitmapMap.set(key, pdfBitmap.release());
 }
 
+sk_sp<SkPDFObject> SkPDFCanon::findPDFBitmap(const SkMD5::Digest& digest) const {
+    SkPDFObject** ptr = fPDFBitmapDigestMap.find(digest);
+    return ptr ? sk_ref_sp(*ptr) : sk_sp<SkPDFObject>();
+}
+
+void SkPDFCanon::addPDFBitmap(const SkMD5::Digest& digest, sk_sp<SkPDFObject> pdfBitmap) {
+    fPDFBitmapDigestMap.set(digest, pdfBitmap.release());
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 sk_sp<SkPDFStream> SkPDFCanon::makeInvertFunction() {
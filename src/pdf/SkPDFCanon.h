@@ -13,6 +13,7 @@
 #include "SkTDArray.h"
 #include "SkTHash.h"
 #include "SkBitmapKey.h"
+#include "SkMD5.h"
 
 class SkPDFFont;
 
@@ -35,6 +36,8 @@ class SkPDFFont;
  */
 class SkPDFCanon : SkNoncopyable {
 public:
+    SkPDFCanon()
+        : fCompressionLevel(-1), fDeduplicateImages(false), fJpegQuality(-1) {}
     ~SkPDFCanon() { this->reset(); }
 
     // reset to original setting, unrefs all objects.
@@ -63,6 +66,10 @@ public:
     sk_sp<SkPDFObject> findPDFBitmap(SkBitmapKey key) const;
     void addPDFBitmap(SkBitmapKey key, sk_sp<SkPDFObject>);
 
+    // Images by content, see SkPDFImageDigest().
+    sk_sp<SkPDFObject> findPDFBitmap(const SkMD5::Digest&) const;
+    void addPDFBitmap(const SkMD5::Digest&, sk_sp<SkPDFObject>);
+
     SkTHashMap<uint32_t, bool> fCanEmbedTypeface;
 
     SkPixelSerializer* getPixelSerializer() const { return fPixelSerializer.get(); }
@@ -70,6 +77,18 @@ public:
         fPixelSerializer = std::move(ps);
     }
 
+    // The zlib level for page contents and images, see SkDocument::PDFMetadata.
+    int getCompressionLevel() const { return fCompressionLevel; }
+    void setCompressionLevel(int level) { fCompressionLevel = level; }
+
+    // Whether to look images up by content too, see SkDocument::PDFMetadata.
+    bool getDeduplicateImages() const { return fDeduplicateImages; }
+    void setDeduplicateImages(bool dedupe) { fDeduplicateImages = dedupe; }
+
+    // The quality of JPEGs made from photographs, see SkDocument::PDFMetadata.
+    int getJpegQuality() const { return fJpegQuality; }
+    void setJpegQuality(int quality) { fJpegQuality = quality; }
+
     sk_sp<SkPDFStream> makeInvertFunction();
     sk_sp<SkPDFDict> makeNoSmaskGraphicState();
     sk_sp<SkPDFArray> makeRangeObject();
@@ -107,8 +126,12 @@ private:
 
     // TODO(halcanary): make SkTHashMap<K, sk_sp<V>> work correctly.
     SkTHashMap<SkBitmapKey, SkPDFObject*> fPDFBitmapMap;
+    SkTHashMap<SkMD5::Digest, SkPDFObject*> fPDFBitmapDigestMap;
 
     sk_sp<SkPixelSerializer> fPixelSerializer;
+    int fCompressionLevel;
+    bool fDeduplicateImages;
+    int fJpegQuality;
     sk_sp<SkPDFStream> fInvertFunction;
     sk_sp<SkPDFDict> fNoSmaskGraphicState;
     sk_sp<SkPDFArray> fRangeObject;
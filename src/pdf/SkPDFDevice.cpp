@@ -2110,20 +2110,34 @@ void SkPDFDevice::internalDrawImage(const SkMatrix& origMatrix,
         // (maybe in the resource cache?)
     }
 
+    SkPDFCanon* canon = fDocument->canon();
     SkBitmapKey key = imageBitmap.getKey();
-    sk_sp<SkPDFObject> pdfimage = fDocument->canon()->findPDFBitmap(key);
+    sk_sp<SkPDFObject> pdfimage = canon->findPDFBitmap(key);
     if (!pdfimage) {
         auto img = imageBitmap.makeImage();
         if (!img) {
             return;
         }
-        pdfimage = SkPDFCreateBitmapObject(
-                std::move(img), fDocument->canon()->getPixelSerializer());
+        // Another image may have the same contents.  Either way, the key
+        // remembers what we find, so we digest each image once.
+        SkMD5::Digest digest;
+        bool digested = canon->getDeduplicateImages() && SkPDFImageDigest(img.get(), &digest);
+        if (digested) {
+            pdfimage = canon->findPDFBitmap(digest);
+        }
         if (!pdfimage) {
-            return;
+            pdfimage = SkPDFCreateBitmapObject(
+                    std::move(img), canon->getPixelSerializer(),
+                    canon->getCompressionLevel(), canon->getJpegQuality());
+            if (!pdfimage) {
+                return;
+            }
+            fDocument->serialize(pdfimage);  // serialize images early.
+            if (digested) {
+                canon->addPDFBitmap(digest, pdfimage);
+            }
         }
-        fDocument->serialize(pdfimage);  // serialize images early.
-        fDocument->canon()->addPDFBitmap(key, pdfimage);
+        canon->addPDFBitmap(key, pdfimage);
     }
     // TODO(halcanary): addXObjectResource() should take a sk_sp<SkPDFObject>
     SkPDFUtils::DrawFormXObject(this->addXObjectResource(pdfimage.get()),
@@ -48,7 +48,19 @@ void SkPDFObjectSerializer::serializeHeader(SkWStream* wStream,
 }
 #undef SKPDF_MAGIC
 
-// Serialize all objects in the fObjNumMap that have not yet been serialized;
+void SkPDFObjectSerializer::emitObject(SkWStream* wStream,
+                                       int32_t objectNumber,
+                                       SkPDFObject* object) {
+    fOffsets[objectNumber - 1] = this->offset(wStream);
+    wStream->writeDecAsText(objectNumber);
+    wStream->writeText(" 0 obj\n");  // Generation number is always 0.
+    object->emitObject(wStream, fObjNumMap, fSubstituteMap);
+    wStream->writeText("\nendobj\n");
+    object->drop();
+}
+
+// Serialize all objects in the fObjNumMap that have not yet been serialized,
+// except for deferred ones, whose offsets are filled in later.
 void SkPDFObjectSerializer::serializeObjects(SkWStream* wStream) {
     const SkTArray<sk_sp<SkPDFObject>>& objects = fObjNumMap.objects();
     while (fNextToBeSerialized < objects.count()) {
@@ -58,17 +70,28 @@ void SkPDFObjectSerializer::serializeObjects(SkWStream* wStream) {
         // always free and has a generation number of 65,535; it is
         // the head of the linked list of free objects."
         SkASSERT(fOffsets.count() == fNextToBeSerialized);
-        fOffsets.push(this->offset(wStream));
-        SkASSERT(object == fSubstituteMap.getSubstitute(object));
-        wStream->writeDecAsText(index);
-        wStream->writeText(" 0 obj\n");  // Generation number is always 0.
-        object->emitObject(wStream, fObjNumMap, fSubstituteMap);
-        wStream->writeText("\nendobj\n");
-        object->drop();
+        fOffsets.push(0);
         ++fNextToBeSerialized;
+        if (fObjNumMap.isDeferred(object)) {
+            continue;
+        }
+        SkASSERT(object == fSubstituteMap.getSubstitute(object));
+        this->emitObject(wStream, index, object);
     }
 }
 
+void SkPDFObjectSerializer::serializeDeferred(SkWStream* wStream,
+                                              SkPDFObject* object,
+                                              SkPDFObject* standIn) {
+    SkASSERT(fObjNumMap.isDeferred(object));
+    // The stand-in's dependencies need numbers before it can refer to them.
+    standIn->addResources(&fObjNumMap, fSubstituteMap);
+    int32_t index = fObjNumMap.getObjectNumber(object);
+    SkASSERT(0 == fOffsets[index - 1]);
+    this->emitObject(wStream, index, standIn);
+    this->serializeObjects(wStream);
+}
+
 // Xref table and footer
 void SkPDFObjectSerializer::serializeFooter(SkWStream* wStream,
                                             const sk_sp<SkPDFObject> docCatalog,
@@ -81,6 +104,7 @@ void SkPDFObjectSerializer::serializeFooter(SkWStream* wStream,
     wStream->writeDecAsText(objCount);
     wStream->writeText("\n0000000000 65535 f \n");
     for (int i = 0; i < fOffsets.count(); i++) {
+        SkASSERT(fOffsets[i] > 0);  // Every deferred object was serialized.
         wStream->writeBigDecAsText(fOffsets[i], 10);
         wStream->writeText(" 00000 n \n");
     }
@@ -107,25 +131,27 @@ int32_t SkPDFObjectSerializer::offset(SkWStream* wStream) {
 }
 
 
+// PDF wants a tree describing all the pages in the document.  We arbitrary
+// choose 8 (kNodeSize) as the number of allowed children.
+static const int kNodeSize = 8;
+
 // return root node.
-static sk_sp<SkPDFDict> generate_page_tree(SkTArray<sk_sp<SkPDFDict>>* pages) {
-    // PDF wants a tree describing all the pages in the document.  We arbitrary
-    // choose 8 (kNodeSize) as the number of allowed children.  The internal
-    // nodes have type "Pages" with an array of children, a parent pointer, and
-    // the number of leaves below the node as "Count."  The leaves are passed
-    // into the method, have type "Page" and need a parent pointer. This method
-    // builds the tree bottom up, skipping internal nodes that would have only
-    // one child.
-    static const int kNodeSize = 8;
+static sk_sp<SkPDFDict> generate_page_tree(SkTArray<sk_sp<SkPDFDict>>* leaves,
+                                           int totalPageCount) {
+    // The internal nodes have type "Pages" with an array of children, a
+    // parent pointer, and the number of pages below the node as "Count."
+    // The lowest level of them is passed into the method, complete but for
+    // their parent pointers; all but the last hold kNodeSize pages.  This
+    // method builds the rest of the tree bottom up, skipping internal nodes
+    // that would have only one child.
 
     // curNodes takes a reference to its items, which it passes to pageTree.
-    int totalPageCount = pages->count();
     SkTArray<sk_sp<SkPDFDict>> curNodes;
-    curNodes.swap(pages);
+    curNodes.swap(leaves);
 
     // nextRoundNodes passes its references to nodes on to curNodes.
-    int treeCapacity = kNodeSize;
-    do {
+    int treeCapacity = kNodeSize * kNodeSize;
+    while (curNodes.count() > 1) {
         SkTArray<sk_sp<SkPDFDict>> nextRoundNodes;
         for (int i = 0; i < curNodes.count(); ) {
             if (i > 0 && i + 1 == curNodes.count()) {
@@ -145,8 +171,8 @@ static sk_sp<SkPDFDict> generate_page_tree(SkTArray<sk_sp<SkPDFDict>>* pages) {
                 kids->appendObjRef(std::move(curNodes[i]));
             }
 
-            // treeCapacity is the number of leaf nodes possible for the
-            // current set of subtrees being generated. (i.e. 8, 64, 512, ...).
+            // treeCapacity is the number of pages possible for the
+            // current set of subtrees being generated. (i.e. 64, 512, ...).
             // It is hard to count the number of leaf nodes in the current
             // subtree. However, by construction, we know that unless it's the
             // last subtree for the current depth, the leaf count will be
@@ -165,7 +191,7 @@ static sk_sp<SkPDFDict> generate_page_tree(SkTArray<sk_sp<SkPDFDict>>* pages) {
         curNodes.swap(&nextRoundNodes);
         nextRoundNodes.reset();
         treeCapacity *= kNodeSize;
-    } while (curNodes.count() > 1);
+    }
     return std::move(curNodes[0]);
 }
 
@@ -212,6 +238,17 @@ void GetCountOfFontTypes(
 template <typename T> static T* clone(const T* o) { return o ? new T(*o) : nullptr; }
 ////////////////////////////////////////////////////////////////////////////////
 
+namespace {
+// A page's content stream, compressed after it is created, and off the calling thread.
+// Compressing touches only the stream itself, so it needs nothing from the SkPDFCanon.
+class PDFPageContent final : public SkPDFStream {
+public:
+    void compress(SkStreamAsset* content, int compressionLevel) {
+        this->setData(content, compressionLevel);
+    }
+};
+}  // namespace
+
 SkPDFDocument::SkPDFDocument(SkWStream* stream,
                              void (*doneProc)(SkWStream*, bool),
                              SkScalar rasterDpi,
@@ -223,6 +260,9 @@ SkPDFDocument::SkPDFDocument(SkWStream* stream,
     , fMetadata(metadata)
     , fPDFA(pdfa) {
     fCanon.setPixelSerializer(std::move(jpegEncoder));
+    fCanon.setCompressionLevel(fMetadata.fCompressionLevel);
+    fCanon.setDeduplicateImages(fMetadata.fDeduplicateImages);
+    fCanon.setJpegQuality(fMetadata.fJpegQuality);
 }
 
 SkPDFDocument::~SkPDFDocument() {
@@ -230,6 +270,22 @@ SkPDFDocument::~SkPDFDocument() {
     this->close();
 }
 
+void SkPDFDocument::serializePendingPage() {
+    fContentTask.wait();
+    if (fPendingPage) {
+        // Fonts are subset once we know all the glyphs used, so they wait
+        // for close(), along with all they refer to.
+        for (const auto& entry : fGlyphUsage) {
+            if (!fObjectSerializer.fObjNumMap.isDeferred(entry.fFont)) {
+                fObjectSerializer.fObjNumMap.defer(entry.fFont);
+            }
+        }
+        this->serialize(fPendingPage);
+        fPendingPage = nullptr;
+        fPendingContent = nullptr;
+    }
+}
+
 void SkPDFDocument::serialize(const sk_sp<SkPDFObject>& object) {
     fObjectSerializer.addObjectRecursively(object);
     fObjectSerializer.serializeObjects(this->getStream());
@@ -278,18 +334,40 @@ void SkPDFDocument::onEndPage() {
     if (annotations->size() > 0) {
         page->insertObject("Annots", std::move(annotations));
     }
-    auto contentData = fPageDevice->content();
-    auto contentObject = sk_make_sp<SkPDFStream>(contentData.get());
-    this->serialize(contentObject);
+
+    // Compress this page's content while the next page draws, then write out
+    // the whole page.  Only one page is ever in flight, so memory stays
+    // proportional to a couple of pages plus the resources they share.
+    this->serializePendingPage();
+    auto contentObject = sk_make_sp<PDFPageContent>();
+    PDFPageContent* content = contentObject.get();
+    SkStreamAsset* contentData = fPageDevice->content().release();
+    const int compressionLevel = fCanon.getCompressionLevel();
+    fContentTask.add([content, contentData, compressionLevel] {
+        content->compress(contentData, compressionLevel);
+        delete contentData;
+    });
+    fPendingContent = contentObject;
     page->insertObjRef("Contents", std::move(contentObject));
+    if (fPages.count() % kNodeSize == 0) {
+        auto leaf = sk_make_sp<SkPDFDict>("Pages");
+        fObjectSerializer.fObjNumMap.defer(leaf.get());
+        fPageTreeLeaves.emplace_back(std::move(leaf));
+    }
+    page->insertObjRef("Parent", fPageTreeLeaves.back());
     fPageDevice->appendDestinations(fDests.get(), page.get());
+    fPendingPage = page;
     fPages.emplace_back(std::move(page));
     fPageDevice.reset(nullptr);
 }
 
 void SkPDFDocument::onAbort() {
+    fContentTask.wait();
+    fPendingPage = nullptr;
+    fPendingContent = nullptr;
     fCanvas.reset(nullptr);
     fPages.reset();
+    fPageTreeLeaves.reset();
     fCanon.reset();
     renew(&fObjectSerializer);
     renew(&fGlyphUsage);
@@ -354,11 +432,13 @@ bool SkPDFDocument::onClose(SkWStream* stream) {
     SkASSERT(!fCanvas.get());
     if (fPages.empty()) {
         fPages.reset();
+        fPageTreeLeaves.reset();
         fCanon.reset();
         renew(&fObjectSerializer);
         renew(&fGlyphUsage);
         return false;
     }
+    this->serializePendingPage();
     auto docCatalog = sk_make_sp<SkPDFDict>("Catalog");
     if (fPDFA) {
         SkASSERT(fXMP);
@@ -368,25 +448,46 @@ bool SkPDFDocument::onClose(SkWStream* stream) {
         docCatalog->insertObject("OutputIntents", make_srgb_output_intents());
     }
     SkASSERT(!fPages.empty());
-    docCatalog->insertObjRef("Pages", generate_page_tree(&fPages));
-    SkASSERT(fPages.empty());
+    for (int i = 0; i < fPageTreeLeaves.count(); ++i) {
+        auto kids = sk_make_sp<SkPDFArray>();
+        kids->reserve(kNodeSize);
+        int end = SkTMin(fPages.count(), (i + 1) * kNodeSize);
+        for (int j = i * kNodeSize; j < end; ++j) {
+            kids->appendObjRef(std::move(fPages[j]));
+        }
+        fPageTreeLeaves[i]->insertInt("Count", end - i * kNodeSize);
+        fPageTreeLeaves[i]->insertObject("Kids", std::move(kids));
+    }
+    int pageCount = fPages.count();
+    fPages.reset();
+    docCatalog->insertObjRef("Pages", generate_page_tree(&fPageTreeLeaves, pageCount));
+    SkASSERT(fPageTreeLeaves.empty());
 
     if (fDests->size() > 0) {
         docCatalog->insertObjRef("Dests", std::move(fDests));
     }
 
-    // Build font subsetting info before calling addObjectRecursively().
+    fObjectSerializer.addObjectRecursively(docCatalog);
+    fObjectSerializer.serializeObjects(this->getStream());
+
+    // The pages already refer to each font by its object number, so its
+    // subset, if any, takes that number.
+    SkPDFSubstituteMap subsetFonts;
     for (const auto& entry : fGlyphUsage) {
         sk_sp<SkPDFFont> subsetFont(
                 entry.fFont->getFontSubset(&entry.fGlyphSet));
         if (subsetFont) {
-            fObjectSerializer.fSubstituteMap.setSubstitute(
-                    entry.fFont, subsetFont.get());
+            subsetFonts.setSubstitute(entry.fFont, subsetFont.get());
+        }
+    }
+    const SkTArray<sk_sp<SkPDFObject>>& objects = fObjectSerializer.fObjNumMap.objects();
+    for (int i = 0, count = objects.count(); i < count; ++i) {
+        SkPDFObject* object = objects[i].get();
+        if (fObjectSerializer.fObjNumMap.isDeferred(object)) {
+            fObjectSerializer.serializeDeferred(this->getStream(), object,
+                                                subsetFonts.getSubstitute(object));
         }
     }
-
-    fObjectSerializer.addObjectRecursively(docCatalog);
-    fObjectSerializer.serializeObjects(this->getStream());
     fObjectSerializer.serializeFooter(this->getStream(), docCatalog, fID);
     fCanon.reset();
     renew(&fObjectSerializer);
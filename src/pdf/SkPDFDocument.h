@@ -11,8 +11,10 @@
 #include "SkPDFCanon.h"
 #include "SkPDFMetadata.h"
 #include "SkPDFFont.h"
+#include "SkTaskGroup.h"
 
 class SkPDFDevice;
+class SkPDFStream;
 
 sk_sp<SkDocument> SkPDFMakeDocument(SkWStream* stream,
                                     void (*doneProc)(SkWStream*, bool),
@@ -26,7 +28,7 @@ sk_sp<SkDocument> SkPDFMakeDocument(SkWStream* stream,
 struct SkPDFObjectSerializer : SkNoncopyable {
     SkPDFObjNumMap fObjNumMap;
     SkPDFSubstituteMap fSubstituteMap;
-    SkTDArray<int32_t> fOffsets;
+    SkTDArray<int32_t> fOffsets;  // indexed by object number - 1
     sk_sp<SkPDFObject> fInfoDict;
     size_t fBaseOffset;
     int32_t fNextToBeSerialized;  // index in fObjNumMap
@@ -36,13 +38,21 @@ struct SkPDFObjectSerializer : SkNoncopyable {
     void addObjectRecursively(const sk_sp<SkPDFObject>&);
     void serializeHeader(SkWStream*, const SkDocument::PDFMetadata&);
     void serializeObjects(SkWStream*);
+    // Serialize an object deferred by fObjNumMap under its object number,
+    // writing standIn (possibly the object itself) in its place.
+    void serializeDeferred(SkWStream*, SkPDFObject* object, SkPDFObject* standIn);
     void serializeFooter(SkWStream*, const sk_sp<SkPDFObject>, sk_sp<SkPDFObject>);
     int32_t offset(SkWStream*);
+
+private:
+    void emitObject(SkWStream*, int32_t objectNumber, SkPDFObject*);
 };
 
 /** Concrete implementation of SkDocument that creates PDF files. This
     class does not produced linearized or optimized PDFs; instead it
-    it attempts to use a minimum amount of RAM. */
+    it attempts to use a minimum amount of RAM.  Each page is written out
+    once the next page ends; only fonts (which are subset at the end) and
+    the page tree wait for close(). */
 class SkPDFDocument : public SkDocument {
 public:
     SkPDFDocument(SkWStream*,
@@ -78,10 +88,18 @@ public:
     SkPDFGlyphSetMap* getGlyphUsage() { return &fGlyphUsage; }
 
 private:
+    // Waits for the last page's content stream to compress, and serializes
+    // it along with the rest of that page.
+    void serializePendingPage();
+
     SkPDFObjectSerializer fObjectSerializer;
     SkPDFCanon fCanon;
     SkPDFGlyphSetMap fGlyphUsage;
+    // Every page, already serialized but for the last one.
     SkTArray<sk_sp<SkPDFDict>> fPages;
+    // The leaves of the page tree, each the parent of up to 8 pages.  They
+    // are deferred, and completed and serialized at close.
+    SkTArray<sk_sp<SkPDFDict>> fPageTreeLeaves;
     sk_sp<SkPDFDict> fDests;
     sk_sp<SkPDFDevice> fPageDevice;
     sk_sp<SkCanvas> fCanvas;
@@ -90,6 +108,11 @@ private:
     SkScalar fRasterDpi;
     SkDocument::PDFMetadata fMetadata;
     bool fPDFA;
+    // The last page and its content stream, compressed by fContentTask while
+    // we draw the next page.
+    sk_sp<SkPDFDict> fPendingPage;
+    sk_sp<SkPDFStream> fPendingContent;
+    SkTaskGroup fContentTask;
 };
 
 #endif  // SkPDFDocument_DEFINED
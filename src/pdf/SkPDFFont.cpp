@@ -9,6 +9,7 @@
 
 #include "SkData.h"
 #include "SkGlyphCache.h"
+#include "SkMD5.h"
 #include "SkPaint.h"
 #include "SkPDFCanon.h"
 #include "SkPDFDevice.h"
@@ -17,6 +18,7 @@
 #include "SkPDFStream.h"
 #include "SkPDFUtils.h"
 #include "SkRefCnt.h"
+#include "SkResourceCache.h"
 #include "SkScalar.h"
 #include "SkStream.h"
 #include "SkTypefacePriv.h"
@@ -596,10 +598,59 @@ static void sk_delete_array(const void* ptr, void*) {
 #endif
 
 #if defined(SK_SFNTLY_SUBSETTER)
+// Subsetting reads and rewrites the whole font, and documents made one after
+// another (invoices, say) tend to use the same fonts for the same glyphs, so
+// we keep the subset font programs in the process-wide SkResourceCache.
+namespace {
+static unsigned gSubsetFontKeyNamespaceLabel;
+
+struct SubsetFontKey : public SkResourceCache::Key {
+    SubsetFontKey(uint32_t fontID, const SkTDArray<uint32_t>& glyphIDs)
+        : fFontID(fontID)
+        , fGlyphCount(glyphIDs.count()) {
+        SkMD5 md5;
+        md5.write(glyphIDs.begin(), glyphIDs.bytes());
+        md5.finish(fGlyphsDigest);
+        this->init(&gSubsetFontKeyNamespaceLabel, fontID,
+                   sizeof(fFontID) + sizeof(fGlyphCount) + sizeof(fGlyphsDigest));
+    }
+
+    uint32_t      fFontID;
+    int32_t       fGlyphCount;
+    SkMD5::Digest fGlyphsDigest;
+};
+
+struct SubsetFontRec : public SkResourceCache::Rec {
+    SubsetFontRec(const SubsetFontKey& key, sk_sp<SkData> data)
+        : fKey(key), fData(std::move(data)) {}
+
+    SubsetFontKey fKey;
+    sk_sp<SkData> fData;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fData->size(); }
+    const char* getCategory() const override { return "pdf-subset-font"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override { return nullptr; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const SubsetFontRec& rec = static_cast<const SubsetFontRec&>(baseRec);
+        *static_cast<sk_sp<SkData>*>(contextData) = rec.fData;
+        return true;
+    }
+};
+}  // namespace
+
 static size_t get_subset_font_stream(const char* fontName,
                                      const SkTypeface* typeface,
                                      const SkTDArray<uint32_t>& subset,
                                      SkPDFStream** fontStream) {
+    SubsetFontKey key(typeface->uniqueID(), subset);
+    sk_sp<SkData> cached;
+    if (SkResourceCache::Find(key, SubsetFontRec::Visitor, &cached)) {
+        *fontStream = new SkPDFStream(cached.get());
+        return cached->size();
+    }
+
     int ttcIndex;
     std::unique_ptr<SkStreamAsset> fontData(typeface->openStream(&ttcIndex));
     SkASSERT(fontData);
@@ -625,12 +676,13 @@ static size_t get_subset_font_stream(const char* fontName,
                                                        subset.count(),
                                                        &subsetFont);
         if (subsetFontSize > 0 && subsetFont != nullptr) {
-            SkAutoDataUnref data(SkData::NewWithProc(subsetFont,
-                                                     subsetFontSize,
-                                                     sk_delete_array,
-                                                     nullptr));
+            sk_sp<SkData> data(SkData::MakeWithProc(subsetFont,
+                                                   subsetFontSize,
+                                                   sk_delete_array,
+                                                   nullptr));
             subsetFontStream = new SkPDFStream(data.get());
             fontSize = subsetFontSize;
+            SkResourceCache::Add(new SubsetFontRec(key, std::move(data)));
         }
     }
     if (subsetFontStream) {
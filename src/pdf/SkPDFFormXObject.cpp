@@ -9,6 +9,7 @@
 #include "SkPDFFormXObject.h"
 
 #include "SkMatrix.h"
+#include "SkPDFCanon.h"
 #include "SkPDFDevice.h"
 #include "SkPDFUtils.h"
 #include "SkStream.h"
@@ -21,7 +22,7 @@ SkPDFFormXObject::SkPDFFormXObject(SkPDFDevice* device) {
     auto resourceDict = device->makeResourceDict();
 
     auto content = device->content();
-    this->setData(content.get());
+    this->setData(content.get(), device->getCanon()->getCompressionLevel());
 
     sk_sp<SkPDFArray> bboxArray(device->copyMediaBox());
     this->init(nullptr, resourceDict.get(), bboxArray.get());
@@ -1211,7 +1211,7 @@ SkPDFImageShader* SkPDFImageShader::Create(
     auto content = patternDevice->content();
 
     SkPDFImageShader* imageShader = new SkPDFImageShader(autoState->release());
-    imageShader->setData(content.get());
+    imageShader->setData(content.get(), doc->canon()->getCompressionLevel());
 
     auto resourceDict = patternDevice->makeResourceDict();
     populate_tiling_pattern_dict(imageShader, patternBBox,
@@ -32,7 +32,7 @@ void SkPDFStream::emitObject(SkWStream* stream,
     stream->writeText("\nendstream");
 }
 
-void SkPDFStream::setData(SkStreamAsset* stream) {
+void SkPDFStream::setData(SkStreamAsset* stream, int compressionLevel) {
     SkASSERT(!fCompressedData);  // Only call this function once.
     SkASSERT(stream);
     // Code assumes that the stream starts at the beginning.
@@ -45,7 +45,7 @@ void SkPDFStream::setData(SkStreamAsset* stream) {
 
     SkASSERT(stream->hasLength());
     SkDynamicMemoryWStream compressedData;
-    SkDeflateWStream deflateWStream(&compressedData);
+    SkDeflateWStream deflateWStream(&compressedData, compressionLevel);
     SkStreamCopy(&deflateWStream, stream);
     deflateWStream.finalize();
     size_t compressedLength = compressedData.bytesWritten();
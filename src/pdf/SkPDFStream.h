@@ -23,14 +23,20 @@ public:
     /** Create a PDF stream. A Length entry is automatically added to the
      *  stream dictionary.
      *  @param data   The data part of the stream.  Will not take ownership.
+     *  @param compressionLevel The zlib level, -1 for zlib's default.
      */
-    explicit SkPDFStream(SkData* data) { this->setData(data); }
+    explicit SkPDFStream(SkData* data, int compressionLevel = -1) {
+        this->setData(data, compressionLevel);
+    }
 
     /** Create a PDF stream. A Length entry is automatically added to the
      *  stream dictionary.
      *  @param stream The data part of the stream.  Will not take ownership.
+     *  @param compressionLevel The zlib level, -1 for zlib's default.
      */
-    explicit SkPDFStream(SkStreamAsset* stream) { this->setData(stream); }
+    explicit SkPDFStream(SkStreamAsset* stream, int compressionLevel = -1) {
+        this->setData(stream, compressionLevel);
+    }
 
     virtual ~SkPDFStream();
 
@@ -47,10 +53,10 @@ protected:
     SkPDFStream() {}
 
     /** Only call this function once. */
-    void setData(SkStreamAsset* stream);
-    void setData(SkData* data) {
+    void setData(SkStreamAsset* stream, int compressionLevel = -1);
+    void setData(SkData* data, int compressionLevel = -1) {
         SkMemoryStream memoryStream(data);
-        this->setData(&memoryStream);
+        this->setData(&memoryStream, compressionLevel);
     }
 
 private:
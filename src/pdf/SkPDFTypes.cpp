@@ -546,11 +546,16 @@ bool SkPDFObjNumMap::addObject(SkPDFObject* obj) {
 
 void SkPDFObjNumMap::addObjectRecursively(SkPDFObject* obj,
                                           const SkPDFSubstituteMap& subs) {
-    if (obj && this->addObject(obj)) {
+    if (obj && this->addObject(obj) && !this->isDeferred(obj)) {
         obj->addResources(this, subs);
     }
 }
 
+void SkPDFObjNumMap::defer(SkPDFObject* obj) {
+    SkASSERT(!fObjectNumbers.find(obj));
+    fDeferred.add(obj);
+}
+
 int32_t SkPDFObjNumMap::getObjectNumber(SkPDFObject* obj) const {
     int32_t* objectNumberFound = fObjectNumbers.find(obj);
     SkASSERT(objectNumberFound);
@@ -342,6 +342,15 @@ public:
      */
     void addObjectRecursively(SkPDFObject* obj, const SkPDFSubstituteMap& subs);
 
+    /** Defer the passed object: once added, it has an object number, but
+     *  addObjectRecursively() does not add its dependencies, and it is
+     *  left for the owner of the map to serialize later.  Must be called
+     *  before the object is added.
+     */
+    void defer(SkPDFObject* obj);
+
+    bool isDeferred(SkPDFObject* obj) const { return fDeferred.contains(obj); }
+
     /** Get the object number for the passed object.
      *  @param obj         The object of interest.
      */
@@ -352,6 +361,7 @@ public:
 private:
     SkTArray<sk_sp<SkPDFObject>> fObjects;
     SkTHashMap<SkPDFObject*, int32_t> fObjectNumbers;
+    SkTHashSet<SkPDFObject*> fDeferred;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -79,12 +79,21 @@ FT_MemoryRec_ gFTMemory = { nullptr, sk_ft_alloc, sk_ft_free, sk_ft_realloc };
 
 class FreeTypeLibrary : SkNoncopyable {
 public:
-    FreeTypeLibrary() : fLibrary(nullptr), fIsLCDSupported(false), fLCDExtra(0) {
+    FreeTypeLibrary()
+        : fLibrary(nullptr), fIsLCDSupported(false), fLCDExtra(0)
+        , fCanUseFacesConcurrently(false) {
         if (FT_New_Library(&gFTMemory, &fLibrary)) {
             return;
         }
         FT_Add_Default_Modules(fLibrary);
 
+        // Since 2.5.6, different faces of one library may be used on different threads at once,
+        // as long as creating and destroying faces is serialized.
+        FT_Int major, minor, patch;
+        FT_Library_Version(fLibrary, &major, &minor, &patch);
+        fCanUseFacesConcurrently = major > 2 || (major == 2 && (minor > 5 ||
+                                                                (minor == 5 && patch >= 6)));
+
         // Setup LCD filtering. This reduces color fringes for LCD smoothed glyphs.
         // Default { 0x10, 0x40, 0x70, 0x40, 0x10 } adds up to 0x110, simulating ink spread.
         // SetLcdFilter must be called before SetLcdFilterWeights.
@@ -125,11 +134,13 @@ public:
     FT_Library library() { return fLibrary; }
     bool isLCDSupported() { return fIsLCDSupported; }
     int lcdExtra() { return fLCDExtra; }
+    bool canUseFacesConcurrently() { return fCanUseFacesConcurrently; }
 
 private:
     FT_Library fLibrary;
     bool fIsLCDSupported;
     int fLCDExtra;
+    bool fCanUseFacesConcurrently;
 
     // FT_Library_SetLcdFilterWeights was introduced in FreeType 2.4.0.
     // The following platforms provide FreeType of at least 2.4.0.
@@ -197,7 +208,8 @@ protected:
     SkUnichar generateGlyphToChar(uint16_t glyph) override;
 
 private:
-    FT_Face     fFace;              // reference to shared face in gFaceRecHead
+    FT_Face     fFace;              // the face we use, our own or fSharedFace
+    FT_Face     fSharedFace;        // reference to shared face in gFaceRecHead
     FT_Size     fFTSize;            // our own copy
     FT_Int      fStrikeIndex;
     FT_F26Dot6  fScaleX, fScaleY;
@@ -210,13 +222,16 @@ private:
     SkVector    fScale;
     SkMatrix    fMatrix22Scalar;
 
+    // Returns the mutex to hold while using fFace, or nullptr if we have a face to ourselves.
+    SkBaseMutex* faceMutex() const { return fFace == fSharedFace ? &gFTMutex : nullptr; }
+
     FT_Error setupSize();
     void getBBoxForCurrentGlyph(SkGlyph* glyph, FT_BBox* bbox,
                                 bool snapToPixelBoundary = false);
     bool getCBoxForLetter(char letter, FT_BBox* bbox);
-    // Caller must lock gFTMutex before calling this function.
+    // Caller must hold faceMutex(), if there is one, before calling this function.
     void updateGlyphIfLCD(SkGlyph* glyph);
-    // Caller must lock gFTMutex before calling this function.
+    // Caller must hold faceMutex(), if there is one, before calling this function.
     // update FreeType2 glyph slot with glyph emboldened
     void emboldenIfNeeded(FT_Face face, FT_GlyphSlot glyph);
 };
@@ -231,6 +246,15 @@ struct SkFaceRec {
     SkAutoTDelete<SkStreamAsset> fSkStream;
     uint32_t fRefCnt;
     uint32_t fFontID;
+    FT_Long fFaceIndex;
+    SkAutoSTMalloc<4, FT_Fixed> fAxes;
+    int fAxisCount;
+
+    // More faces of the same font, each used by one scaler context at a time so that contexts on
+    // different threads don't wait on each other. fExclusiveFaceCount counts the free faces and
+    // the ones in use.
+    SkTDArray<FT_Face> fFreeFaces;
+    int fExclusiveFaceCount;
 
     // assumes ownership of the stream, will delete when its done
     SkFaceRec(SkStreamAsset* strm, uint32_t fontID);
@@ -257,7 +281,8 @@ extern "C" {
 }
 
 SkFaceRec::SkFaceRec(SkStreamAsset* stream, uint32_t fontID)
-        : fNext(nullptr), fSkStream(stream), fRefCnt(1), fFontID(fontID)
+        : fNext(nullptr), fSkStream(stream), fRefCnt(1), fFontID(fontID), fFaceIndex(0)
+        , fAxisCount(0), fExclusiveFaceCount(0)
 {
     sk_bzero(&fFTStream, sizeof(fFTStream));
     fFTStream.size = fSkStream->getLength();
@@ -266,7 +291,7 @@ SkFaceRec::SkFaceRec(SkStreamAsset* stream, uint32_t fontID)
     fFTStream.close = sk_ft_stream_close;
 }
 
-static void ft_face_setup_axes(FT_Face face, const SkFontData& data) {
+static void ft_face_setup_axes(FT_Face face, const FT_Fixed coords[], int axisCount) {
     if (!(face->face_flags & FT_FACE_FLAG_MULTIPLE_MASTERS)) {
         return;
     }
@@ -279,24 +304,57 @@ static void ft_face_setup_axes(FT_Face face, const SkFontData& data) {
         }
         SkAutoFree autoFreeVariations(variations);
 
-        if (static_cast<FT_UInt>(data.getAxisCount()) != variations->num_axis) {
+        if (static_cast<FT_UInt>(axisCount) != variations->num_axis) {
             SkDEBUGF(("INFO: font %s has %d variations, but %d were specified.\n",
-                    face->family_name, variations->num_axis, data.getAxisCount()));
+                    face->family_name, variations->num_axis, axisCount));
             return;
         }
     )
 
-    SkAutoSTMalloc<4, FT_Fixed> coords(data.getAxisCount());
-    for (int i = 0; i < data.getAxisCount(); ++i) {
-        coords[i] = data.getAxis()[i];
-    }
-    if (FT_Set_Var_Design_Coordinates(face, data.getAxisCount(), coords.get())) {
+    if (FT_Set_Var_Design_Coordinates(face, axisCount, const_cast<FT_Fixed*>(coords))) {
         SkDEBUGF(("INFO: font %s has variations, but specified variations could not be set.\n",
                   face->family_name));
         return;
     }
 }
 
+// Opens another face of the rec's font. Will return 0 on failure.
+// Caller must lock gFTMutex before calling this function.
+static FT_Face open_ft_face(SkFaceRec* rec) {
+    gFTMutex.assertHeld();
+
+    FT_Open_Args args;
+    memset(&args, 0, sizeof(args));
+    const void* memoryBase = rec->fSkStream->getMemoryBase();
+    if (memoryBase) {
+        args.flags = FT_OPEN_MEMORY;
+        args.memory_base = (const FT_Byte*)memoryBase;
+        args.memory_size = rec->fSkStream->getLength();
+    } else {
+        args.flags = FT_OPEN_STREAM;
+        args.stream = &rec->fFTStream;
+    }
+
+    FT_Face face;
+    if (FT_Open_Face(gFTLibrary->library(), &args, rec->fFaceIndex, &face)) {
+        return nullptr;
+    }
+    SkASSERT(face);
+
+    ft_face_setup_axes(face, rec->fAxes.get(), rec->fAxisCount);
+
+    // FreeType will set the charmap to the "most unicode" cmap if it exists.
+    // If there are no unicode cmaps, the charmap is set to nullptr.
+    // However, "symbol" cmaps should also be considered "fallback unicode" cmaps
+    // because they are effectively private use area only (even if they aren't).
+    // This is the last on the fallback list at
+    // https://developer.apple.com/fonts/TrueType-Reference-Manual/RM06/Chap6cmap.html
+    if (!face->charmap) {
+        FT_Select_Charmap(face, FT_ENCODING_MS_SYMBOL);
+    }
+    return face;
+}
+
 // Will return 0 on failure
 // Caller must lock gFTMutex before calling this function.
 static FT_Face ref_ft_face(const SkTypeface* typeface) {
@@ -320,38 +378,19 @@ static FT_Face ref_ft_face(const SkTypeface* typeface) {
 
     // this passes ownership of stream to the rec
     rec = new SkFaceRec(data->detachStream(), fontID);
-
-    FT_Open_Args args;
-    memset(&args, 0, sizeof(args));
-    const void* memoryBase = rec->fSkStream->getMemoryBase();
-    if (memoryBase) {
-        args.flags = FT_OPEN_MEMORY;
-        args.memory_base = (const FT_Byte*)memoryBase;
-        args.memory_size = rec->fSkStream->getLength();
-    } else {
-        args.flags = FT_OPEN_STREAM;
-        args.stream = &rec->fFTStream;
+    rec->fFaceIndex = data->getIndex();
+    rec->fAxisCount = data->getAxisCount();
+    rec->fAxes.reset(rec->fAxisCount);
+    for (int i = 0; i < rec->fAxisCount; ++i) {
+        rec->fAxes[i] = data->getAxis()[i];
     }
 
-    FT_Error err = FT_Open_Face(gFTLibrary->library(), &args, data->getIndex(), &rec->fFace);
-    if (err) {
+    rec->fFace = open_ft_face(rec);
+    if (!rec->fFace) {
         SkDEBUGF(("ERROR: unable to open font '%x'\n", fontID));
         delete rec;
         return nullptr;
     }
-    SkASSERT(rec->fFace);
-
-    ft_face_setup_axes(rec->fFace, *data);
-
-    // FreeType will set the charmap to the "most unicode" cmap if it exists.
-    // If there are no unicode cmaps, the charmap is set to nullptr.
-    // However, "symbol" cmaps should also be considered "fallback unicode" cmaps
-    // because they are effectively private use area only (even if they aren't).
-    // This is the last on the fallback list at
-    // https://developer.apple.com/fonts/TrueType-Reference-Manual/RM06/Chap6cmap.html
-    if (!rec->fFace->charmap) {
-        FT_Select_Charmap(rec->fFace, FT_ENCODING_MS_SYMBOL);
-    }
 
     rec->fNext = gFaceRecHead;
     gFaceRecHead = rec;
@@ -374,6 +413,10 @@ void unref_ft_face(FT_Face face) {
                 } else {
                     gFaceRecHead = next;
                 }
+                SkASSERT(rec->fFreeFaces.count() == rec->fExclusiveFaceCount);
+                for (FT_Face freeFace : rec->fFreeFaces) {
+                    FT_Done_Face(freeFace);
+                }
                 FT_Done_Face(face);
                 delete rec;
             }
@@ -385,6 +428,58 @@ void unref_ft_face(FT_Face face) {
     SkDEBUGFAIL("shouldn't get here, face not in list");
 }
 
+// Each typeface opens at most this many faces for scaler contexts to have to themselves. Once
+// they're all in use, further contexts share the typeface's face under gFTMutex.
+static const int kMaxExclusiveFaces = 8;
+
+// Returns a face of the same font as 'face' for the caller to use without holding gFTMutex, or
+// nullptr if there isn't one to be had. There isn't for fonts read from a stream, as the stream
+// would be shared, or with a FreeType that can't use faces concurrently.
+// Caller must lock gFTMutex before calling this function.
+static FT_Face acquire_exclusive_ft_face(FT_Face face) {
+    gFTMutex.assertHeld();
+
+    SkFaceRec* rec = gFaceRecHead;
+    while (rec && rec->fFace != face) {
+        rec = rec->fNext;
+    }
+    if (!rec) {
+        SkDEBUGFAIL("shouldn't get here, face not in list");
+        return nullptr;
+    }
+    if (rec->fFreeFaces.count()) {
+        FT_Face exclusive;
+        rec->fFreeFaces.pop(&exclusive);
+        return exclusive;
+    }
+    if (rec->fExclusiveFaceCount >= kMaxExclusiveFaces || !rec->fSkStream->getMemoryBase() ||
+        !gFTLibrary->canUseFacesConcurrently()) {
+        return nullptr;
+    }
+    FT_Face exclusive = open_ft_face(rec);
+    if (exclusive) {
+        rec->fExclusiveFaceCount += 1;
+    }
+    return exclusive;
+}
+
+// Returns a face from acquire_exclusive_ft_face for another scaler context to use. Its sizes
+// must all have been freed.
+// Caller must lock gFTMutex before calling this function.
+static void release_exclusive_ft_face(FT_Face face, FT_Face exclusive) {
+    gFTMutex.assertHeld();
+
+    SkFaceRec* rec = gFaceRecHead;
+    while (rec && rec->fFace != face) {
+        rec = rec->fNext;
+    }
+    if (!rec) {
+        SkDEBUGFAIL("shouldn't get here, face not in list");
+        return;
+    }
+    *rec->fFreeFaces.append() = exclusive;
+}
+
 class AutoFTAccess {
 public:
     AutoFTAccess(const SkTypeface* tf) : fFace(nullptr) {
@@ -796,6 +891,7 @@ SkScalerContext_FreeType::SkScalerContext_FreeType(SkTypeface* typeface,
                                                    const SkDescriptor* desc)
     : SkScalerContext_FreeType_Base(typeface, effects, desc)
     , fFace(nullptr)
+    , fSharedFace(nullptr)
     , fFTSize(nullptr)
     , fStrikeIndex(-1)
 {
@@ -806,12 +902,18 @@ SkScalerContext_FreeType::SkScalerContext_FreeType(SkTypeface* typeface,
     }
 
     // load the font file
-    using UnrefFTFace = SkFunctionWrapper<void, skstd::remove_pointer_t<FT_Face>, unref_ft_face>;
-    std::unique_ptr<skstd::remove_pointer_t<FT_Face>, UnrefFTFace> ftFace(ref_ft_face(typeface));
-    if (nullptr == ftFace) {
+    fSharedFace = ref_ft_face(typeface);
+    if (nullptr == fSharedFace) {
         SkDEBUGF(("Could not create FT_Face.\n"));
         return;
     }
+    // Try for a face of our own, so we can generate glyphs without holding gFTMutex.
+    // The destructor gives back whichever face we end up with, even if we fail below.
+    FT_Face ftFace = acquire_exclusive_ft_face(fSharedFace);
+    if (nullptr == ftFace) {
+        ftFace = fSharedFace;
+    }
+    fFace = ftFace;
 
     fRec.computeMatrices(SkScalerContextRec::kFull_PreMatrixScale, &fScale, &fMatrix22Scalar);
     fMatrix22Scalar.setSkewX(-fMatrix22Scalar.getSkewX());
@@ -896,9 +998,9 @@ SkScalerContext_FreeType::SkScalerContext_FreeType(SkTypeface* typeface,
     }
 
     using DoneFTSize = SkFunctionWrapper<FT_Error, skstd::remove_pointer_t<FT_Size>, FT_Done_Size>;
-    std::unique_ptr<skstd::remove_pointer_t<FT_Size>, DoneFTSize> ftSize([&ftFace]() -> FT_Size {
+    std::unique_ptr<skstd::remove_pointer_t<FT_Size>, DoneFTSize> ftSize([ftFace]() -> FT_Size {
         FT_Size size;
-        FT_Error err = FT_New_Size(ftFace.get(), &size);
+        FT_Error err = FT_New_Size(ftFace, &size);
         if (err != 0) {
             SkDEBUGF(("FT_New_Size returned %x for face %s\n", err, ftFace->family_name));
             return nullptr;
@@ -913,20 +1015,20 @@ SkScalerContext_FreeType::SkScalerContext_FreeType(SkTypeface* typeface,
     FT_Error err = FT_Activate_Size(ftSize.get());
     if (err != 0) {
         SkDEBUGF(("FT_Activate_Size(%08x, 0x%x, 0x%x) returned 0x%x\n",
-                         ftFace.get(), fScaleX,   fScaleY,       err));
+                         ftFace, fScaleX,   fScaleY,       err));
         return;
     }
 
     if (FT_IS_SCALABLE(ftFace)) {
-        err = FT_Set_Char_Size(ftFace.get(), fScaleX, fScaleY, 72, 72);
+        err = FT_Set_Char_Size(ftFace, fScaleX, fScaleY, 72, 72);
         if (err != 0) {
             SkDEBUGF(("FT_Set_CharSize(%08x, 0x%x, 0x%x) returned 0x%x\n",
-                               ftFace.get(), fScaleX, fScaleY,      err));
+                               ftFace, fScaleX, fScaleY,      err));
             return;
         }
-        FT_Set_Transform(ftFace.get(), &fMatrix22, nullptr);
+        FT_Set_Transform(ftFace, &fMatrix22, nullptr);
     } else if (FT_HAS_FIXED_SIZES(ftFace)) {
-        fStrikeIndex = chooseBitmapStrike(ftFace.get(), fScaleY);
+        fStrikeIndex = chooseBitmapStrike(ftFace, fScaleY);
         if (fStrikeIndex == -1) {
             SkDEBUGF(("no glyphs for font \"%s\" size %f?\n",
                             ftFace->family_name,      SkFDot6ToScalar(fScaleY)));
@@ -948,7 +1050,6 @@ SkScalerContext_FreeType::SkScalerContext_FreeType(SkTypeface* typeface,
     }
 
     fFTSize = ftSize.release();
-    fFace = ftFace.release();
     fDoLinearMetrics = linearMetrics;
 }
 
@@ -959,8 +1060,11 @@ SkScalerContext_FreeType::~SkScalerContext_FreeType() {
         FT_Done_Size(fFTSize);
     }
 
-    if (fFace != nullptr) {
-        unref_ft_face(fFace);
+    if (fFace != nullptr && fFace != fSharedFace) {
+        release_exclusive_ft_face(fSharedFace, fFace);
+    }
+    if (fSharedFace != nullptr) {
+        unref_ft_face(fSharedFace);
     }
 
     unref_ft_library();
@@ -970,7 +1074,9 @@ SkScalerContext_FreeType::~SkScalerContext_FreeType() {
     this face with other context (at different sizes).
 */
 FT_Error SkScalerContext_FreeType::setupSize() {
-    gFTMutex.assertHeld();
+    if (this->faceMutex()) {
+        gFTMutex.assertHeld();
+    }
     FT_Error err = FT_Activate_Size(fFTSize);
     if (err != 0) {
         SkDEBUGF(("SkScalerContext_FreeType::FT_Activate_Size(%s %s, 0x%x, 0x%x) returned 0x%x\n",
@@ -990,12 +1096,12 @@ unsigned SkScalerContext_FreeType::generateGlyphCount() {
 }
 
 uint16_t SkScalerContext_FreeType::generateCharToGlyph(SkUnichar uni) {
-    SkAutoMutexAcquire  ac(gFTMutex);
+    SkAutoMutexAcquire  ac(this->faceMutex());
     return SkToU16(FT_Get_Char_Index( fFace, uni ));
 }
 
 SkUnichar SkScalerContext_FreeType::generateGlyphToChar(uint16_t glyph) {
-    SkAutoMutexAcquire  ac(gFTMutex);
+    SkAutoMutexAcquire  ac(this->faceMutex());
     // iterate through each cmap entry, looking for matching glyph indices
     FT_UInt glyphIndex;
     SkUnichar charCode = FT_Get_First_Char( fFace, &glyphIndex );
@@ -1019,7 +1125,7 @@ void SkScalerContext_FreeType::generateAdvance(SkGlyph* glyph) {
     * which are very cheap to compute with some font formats...
     */
     if (fDoLinearMetrics) {
-        SkAutoMutexAcquire  ac(gFTMutex);
+        SkAutoMutexAcquire  ac(this->faceMutex());
 
         if (this->setupSize()) {
             glyph->zeroMetrics();
@@ -1123,7 +1229,7 @@ inline void scaleGlyphMetrics(SkGlyph& glyph, SkScalar scale) {
 }
 
 void SkScalerContext_FreeType::generateMetrics(SkGlyph* glyph) {
-    SkAutoMutexAcquire  ac(gFTMutex);
+    SkAutoMutexAcquire  ac(this->faceMutex());
 
     glyph->fRsbDelta = 0;
     glyph->fLsbDelta = 0;
@@ -1231,7 +1337,7 @@ static void clear_glyph_image(const SkGlyph& glyph) {
 }
 
 void SkScalerContext_FreeType::generateImage(const SkGlyph& glyph) {
-    SkAutoMutexAcquire  ac(gFTMutex);
+    SkAutoMutexAcquire  ac(this->faceMutex());
 
     if (this->setupSize()) {
         clear_glyph_image(glyph);
@@ -1252,7 +1358,7 @@ void SkScalerContext_FreeType::generateImage(const SkGlyph& glyph) {
 
 
 void SkScalerContext_FreeType::generatePath(const SkGlyph& glyph, SkPath* path) {
-    SkAutoMutexAcquire  ac(gFTMutex);
+    SkAutoMutexAcquire  ac(this->faceMutex());
 
     SkASSERT(path);
 
@@ -1293,7 +1399,7 @@ void SkScalerContext_FreeType::generateFontMetrics(SkPaint::FontMetrics* metrics
         return;
     }
 
-    SkAutoMutexAcquire ac(gFTMutex);
+    SkAutoMutexAcquire ac(this->faceMutex());
 
     if (this->setupSize()) {
         sk_bzero(metrics, sizeof(*metrics));
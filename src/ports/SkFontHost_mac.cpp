@@ -494,6 +494,11 @@ static bool find_by_CTFontRef(SkTypeface* cached, void* context) {
     return CFEqual(self, other);
 }
 
+// Fonts are cached under their CFHash(), which agrees with CFEqual().
+static uint32_t CTFontRef_key(CTFontRef font) {
+    return (uint32_t)CFHash(font);
+}
+
 /** Creates a typeface from a name, searching the cache. */
 static SkTypeface* NewFromName(const char familyName[], const SkFontStyle& theStyle) {
     CTFontSymbolicTraits ctFontTraits = 0;
@@ -542,12 +547,14 @@ static SkTypeface* NewFromName(const char familyName[], const SkFontStyle& theSt
         return nullptr;
     }
 
-    SkTypeface* face = SkTypefaceCache::FindByProcAndRef(find_by_CTFontRef, (void*)ctFont.get());
+    const uint32_t key = CTFontRef_key(ctFont.get());
+    SkTypeface* face = SkTypefaceCache::FindByKeyAndRef(key, find_by_CTFontRef,
+                                                        (void*)ctFont.get());
     if (face) {
         return face;
     }
     face = NewFromFontRef(ctFont.release(), nullptr, false);
-    SkTypefaceCache::Add(face);
+    SkTypefaceCache::Add(face, key);
     return face;
 }
 
@@ -575,7 +582,8 @@ CTFontRef SkTypeface_GetCTFontRef(const SkTypeface* face) {
  *  not found, returns a new entry (after adding it to the cache).
  */
 SkTypeface* SkCreateTypefaceFromCTFont(CTFontRef fontRef, CFTypeRef resourceRef) {
-    SkTypeface* face = SkTypefaceCache::FindByProcAndRef(find_by_CTFontRef, (void*)fontRef);
+    const uint32_t key = CTFontRef_key(fontRef);
+    SkTypeface* face = SkTypefaceCache::FindByKeyAndRef(key, find_by_CTFontRef, (void*)fontRef);
     if (face) {
         return face;
     }
@@ -584,7 +592,7 @@ SkTypeface* SkCreateTypefaceFromCTFont(CTFontRef fontRef, CFTypeRef resourceRef)
         CFRetain(resourceRef);
     }
     face = NewFromFontRef(fontRef, resourceRef, false);
-    SkTypefaceCache::Add(face);
+    SkTypefaceCache::Add(face, key);
     return face;
 }
 
@@ -2162,13 +2170,15 @@ static SkTypeface* createFromDesc(CTFontDescriptorRef desc) {
         return nullptr;
     }
 
-    SkTypeface* face = SkTypefaceCache::FindByProcAndRef(find_by_CTFontRef, (void*)ctFont.get());
+    const uint32_t key = CTFontRef_key(ctFont.get());
+    SkTypeface* face = SkTypefaceCache::FindByKeyAndRef(key, find_by_CTFontRef,
+                                                        (void*)ctFont.get());
     if (face) {
         return face;
     }
 
     face = NewFromFontRef(ctFont.release(), nullptr, false);
-    SkTypefaceCache::Add(face);
+    SkTypefaceCache::Add(face, key);
     return face;
 }
 
@@ -18,6 +18,7 @@
 #include "SkStream.h"
 #include "SkString.h"
 #include "SkTDArray.h"
+#include "SkTHash.h"
 #include "SkTemplates.h"
 #include "SkTypeface.h"
 #include "SkTypefaceCache.h"
@@ -630,12 +631,13 @@ class SkFontMgr_fontconfig : public SkFontMgr {
     SkTypeface* createTypefaceFromFcPattern(FcPattern* pattern) const {
         FCLocker::AssertHeld();
         SkAutoMutexAcquire ama(fTFCacheMutex);
-        SkTypeface* face = fTFCache.findByProcAndRef(FindByFcPattern, pattern);
+        const uint32_t key = FcPatternHash(pattern);
+        SkTypeface* face = fTFCache.findByKeyAndRef(key, FindByFcPattern, pattern);
         if (nullptr == face) {
             FcPatternReference(pattern);
             face = SkTypeface_fontconfig::Create(pattern);
             if (face) {
-                fTFCache.add(face);
+                fTFCache.add(face, key);
             }
         }
         return face;
@@ -775,6 +777,90 @@ protected:
     virtual SkTypeface* onMatchFamilyStyle(const char familyName[],
                                            const SkFontStyle& style) const override
     {
+        SkString key = MatchKey(familyName, style, nullptr, 0);
+        {
+            SkAutoMutexAcquire ama(fMatchCacheMutex);
+            if (sk_sp<SkTypeface>* match = fFamilyStyleMatches.find(key)) {
+                return SkSafeRef(match->get());
+            }
+        }
+
+        sk_sp<SkTypeface> typeface(this->matchFamilyStyleFromFC(familyName, style));
+        SkAutoMutexAcquire ama(fMatchCacheMutex);
+        if (fFamilyStyleMatches.count() >= kMaxCachedMatches) {
+            fFamilyStyleMatches.reset();
+        }
+        fFamilyStyleMatches.set(key, typeface);
+        return typeface.release();
+    }
+
+    virtual SkTypeface* onMatchFamilyStyleCharacter(const char familyName[],
+                                                    const SkFontStyle& style,
+                                                    const char* bcp47[],
+                                                    int bcp47Count,
+                                                    SkUnichar character) const override
+    {
+        // A face found for a character is tried first for the rest of its block, so that runs of
+        // text in one script come from one face and mostly skip fontconfig.
+        SkString key = MatchKey(familyName, style, bcp47, bcp47Count);
+        key.appendf("\x1f%x", character >> kCoverageBlockBits);
+        const int bit = character & ((1 << kCoverageBlockBits) - 1);
+        {
+            SkAutoMutexAcquire ama(fMatchCacheMutex);
+            CharacterMatch* match = fCharacterMatches.find(key);
+            if (match && (match->fCoverage[bit >> 5] & (1u << (bit & 31)))) {
+                return SkRef(match->fTypeface.get());
+            }
+        }
+
+        CharacterMatch match;
+        match.fTypeface.reset(this->matchFamilyStyleCharacterFromFC(familyName, style,
+                                                                    bcp47, bcp47Count, character,
+                                                                    match.fCoverage));
+        if (!match.fTypeface) {
+            return nullptr;
+        }
+        SkTypeface* typeface = SkRef(match.fTypeface.get());
+        SkAutoMutexAcquire ama(fMatchCacheMutex);
+        if (fCharacterMatches.count() >= kMaxCachedMatches) {
+            fCharacterMatches.reset();
+        }
+        fCharacterMatches.set(key, std::move(match));
+        return typeface;
+    }
+
+private:
+    // Each cache is cleared when it grows to this many matches.
+    static const int kMaxCachedMatches = 512;
+    // Characters share a cached match with the rest of their 256 character block.
+    static const int kCoverageBlockBits = 8;
+
+    struct CharacterMatch {
+        sk_sp<SkTypeface> fTypeface;
+        // The characters of the block that fTypeface has.
+        uint32_t          fCoverage[(1 << kCoverageBlockBits) / 32];
+    };
+
+    // Spells out a match request as a cache key.
+    static SkString MatchKey(const char familyName[], const SkFontStyle& style,
+                             const char* bcp47[], int bcp47Count) {
+        SkString key;
+        key.printf("%d\x1f%d\x1f%d\x1f%s", style.weight(), style.width(), style.slant(),
+                   familyName ? familyName : "\x1e");
+        for (int i = 0; i < bcp47Count; ++i) {
+            key.appendf("\x1f%s", bcp47[i]);
+        }
+        return key;
+    }
+
+    // These cache the results of onMatchFamilyStyle and onMatchFamilyStyleCharacter, which
+    // would otherwise call into fontconfig for every lookup. They are looked up without the
+    // fontconfig lock, and typefaces are never unreffed while holding it.
+    mutable SkMutex fMatchCacheMutex;
+    mutable SkTHashMap<SkString, sk_sp<SkTypeface>> fFamilyStyleMatches;
+    mutable SkTHashMap<SkString, CharacterMatch> fCharacterMatches;
+
+    SkTypeface* matchFamilyStyleFromFC(const char familyName[], const SkFontStyle& style) const {
         FCLocker lock;
 
         SkAutoFcPattern pattern;
@@ -810,12 +896,10 @@ protected:
         return createTypefaceFromFcPattern(font);
     }
 
-    virtual SkTypeface* onMatchFamilyStyleCharacter(const char familyName[],
-                                                    const SkFontStyle& style,
-                                                    const char* bcp47[],
-                                                    int bcp47Count,
-                                                    SkUnichar character) const override
-    {
+    // Also fills coverage with the characters of the character's block that the match has.
+    SkTypeface* matchFamilyStyleCharacterFromFC(const char familyName[], const SkFontStyle& style,
+                                                const char* bcp47[], int bcp47Count,
+                                                SkUnichar character, uint32_t coverage[]) const {
         FCLocker lock;
 
         SkAutoFcPattern pattern;
@@ -849,9 +933,18 @@ protected:
             return nullptr;
         }
 
+        const SkUnichar blockStart = character & ~((1 << kCoverageBlockBits) - 1);
+        sk_bzero(coverage, sizeof(CharacterMatch::fCoverage));
+        for (int i = 0; i < (1 << kCoverageBlockBits); ++i) {
+            if (FontContainsCharacter(font, blockStart + i)) {
+                coverage[i >> 5] |= 1u << (i & 31);
+            }
+        }
         return createTypefaceFromFcPattern(font);
     }
 
+protected:
+
     virtual SkTypeface* onMatchFaceStyle(const SkTypeface* typeface,
                                          const SkFontStyle& style) const override
     {
@@ -5,10 +5,31 @@
  * found in the LICENSE file.
  */
 
+#include "SkMallocStats.h"
 #include "SkTypes.h"
 
 #include <stdlib.h>
 
+#if defined(SK_BUILD_FOR_MAC) || defined(SK_BUILD_FOR_IOS)
+    #include <malloc/malloc.h>
+    static size_t usable_size(void* p) { return malloc_size(p); }
+#elif defined(SK_BUILD_FOR_UNIX) || defined(SK_BUILD_FOR_ANDROID)
+    #include <malloc.h>
+    static size_t usable_size(void* p) { return malloc_usable_size(p); }
+#elif defined(SK_BUILD_FOR_WIN)
+    #include <malloc.h>
+    static size_t usable_size(void* p) { return _msize(p); }
+#else
+    static size_t usable_size(void*) { return 0; }
+#endif
+
+static inline void* count_alloc(void* p) {
+    if (p && SkMallocStats::Enabled()) {
+        SkMallocStats::Allocated(usable_size(p));
+    }
+    return p;
+}
+
 #define SK_DEBUGFAILF(fmt, ...) \
     SkASSERT((SkDebugf(fmt"\n", __VA_ARGS__), false))
 
@@ -44,17 +65,25 @@ void* sk_malloc_throw(size_t size) {
 }
 
 void* sk_realloc_throw(void* addr, size_t size) {
-    return throw_on_failure(size, realloc(addr, size));
+    if (addr && SkMallocStats::Enabled()) {
+        // Count this as freeing the old block.  If realloc fails, the old block lives on
+        // uncounted, which is fine since we're about to abort anyway.
+        SkMallocStats::Freed(usable_size(addr));
+    }
+    return throw_on_failure(size, count_alloc(realloc(addr, size)));
 }
 
 void sk_free(void* p) {
     if (p) {
+        if (SkMallocStats::Enabled()) {
+            SkMallocStats::Freed(usable_size(p));
+        }
         free(p);
     }
 }
 
 void* sk_malloc_flags(size_t size, unsigned flags) {
-    void* p = malloc(size);
+    void* p = count_alloc(malloc(size));
     if (flags & SK_MALLOC_THROW) {
         return throw_on_failure(size, p);
     } else {
@@ -63,7 +92,7 @@ void* sk_malloc_flags(size_t size, unsigned flags) {
 }
 
 void* sk_calloc(size_t size) {
-    return calloc(size, 1);
+    return count_alloc(calloc(size, 1));
 }
 
 void* sk_calloc_throw(size_t size) {
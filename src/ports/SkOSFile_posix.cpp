@@ -11,7 +11,9 @@
 #include "SkTemplates.h"
 #include "SkTypes.h"
 
+#include <atomic>
 #include <dirent.h>
+#include <fcntl.h>
 #include <stdio.h>
 #include <string.h>
 #include <sys/mman.h>
@@ -19,6 +21,13 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#if defined(SK_BUILD_FOR_ANDROID)
+    #include <linux/ashmem.h>
+    #include <sys/ioctl.h>
+#elif defined(SK_BUILD_FOR_UNIX)
+    #include <sys/syscall.h>
+#endif
+
 bool sk_exists(const char *path, SkFILE_Flags flags) {
     int mode = F_OK;
     if (flags & kRead_SkFILE_Flag) {
@@ -95,6 +104,85 @@ void* sk_fmmap(FILE* f, size_t* size) {
     return sk_fdmmap(fd, size);
 }
 
+void* sk_shmmap(int fd, bool writable, size_t* length) {
+    size_t size;
+#if defined(SK_BUILD_FOR_ANDROID)
+    int ashmemSize = ioctl(fd, ASHMEM_GET_SIZE, nullptr);
+    if (ashmemSize <= 0) {
+        return nullptr;
+    }
+    size = static_cast<size_t>(ashmemSize);
+#else
+    struct stat status;
+    if (0 != fstat(fd, &status) || status.st_size <= 0 || !SkTFitsIn<size_t>(status.st_size)) {
+        return nullptr;
+    }
+    size = static_cast<size_t>(status.st_size);
+#endif
+
+    void* addr = mmap(nullptr, size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED,
+                      fd, 0);
+    if (MAP_FAILED == addr) {
+        return nullptr;
+    }
+
+    *length = size;
+    return addr;
+}
+
+static int shm_open_anonymous(size_t length) {
+    if (!SkTFitsIn<off_t>(length)) {
+        return -1;
+    }
+#if defined(SK_BUILD_FOR_ANDROID)
+    int fd = open("/dev/ashmem", O_RDWR | O_CLOEXEC);
+    if (fd >= 0 && ioctl(fd, ASHMEM_SET_SIZE, length) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+#else
+    int fd = -1;
+    #if defined(SK_BUILD_FOR_UNIX)
+        #if defined(SYS_memfd_create)
+            const unsigned kMemfdCloexec = 1;  // MFD_CLOEXEC
+            fd = static_cast<int>(syscall(SYS_memfd_create, "skia", kMemfdCloexec));
+        #endif
+    #else
+        // Make a POSIX shared memory object, and unlink it right away so it only lives
+        // on through its descriptors.
+        static std::atomic<unsigned> gNextID{0};
+        SkString name;
+        name.printf("/skia.%d.%u", (int)getpid(), gNextID++);
+        fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+        if (fd >= 0) {
+            shm_unlink(name.c_str());
+        }
+    #endif
+    if (fd >= 0 && 0 != ftruncate(fd, static_cast<off_t>(length))) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+#endif
+}
+
+void* sk_shm_create(size_t length, int* fd) {
+    int shm = shm_open_anonymous(length);
+    if (shm < 0) {
+        return nullptr;
+    }
+    size_t size;
+    void* addr = sk_shmmap(shm, true, &size);
+    if (nullptr == addr) {
+        close(shm);
+        return nullptr;
+    }
+    SkASSERT(size == length);
+    *fd = shm;
+    return addr;
+}
+
 ////////////////////////////////////////////////////////////////////////////
 
 struct SkOSFileIterData {
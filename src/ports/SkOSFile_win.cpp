@@ -124,6 +124,16 @@ void* sk_fmmap(FILE* f, size_t* length) {
     return sk_fdmmap(fileno, length);
 }
 
+// Shared memory on Windows is a section handle rather than a file descriptor, which this API
+// has no way to hand out.
+void* sk_shm_create(size_t, int*) {
+    return nullptr;
+}
+
+void* sk_shmmap(int, bool, size_t*) {
+    return nullptr;
+}
+
 ////////////////////////////////////////////////////////////////////////////
 
 struct SkOSFileIterData {
@@ -7,16 +7,39 @@
  
 #include "SkSLCompiler.h"
 
+#include <algorithm>
 #include <fstream>
+#include <sstream>
 #include <streambuf>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "SkSLIRGenerator.h"
 #include "SkSLParser.h"
 #include "SkSLSPIRVCodeGenerator.h"
+#include "ir/SkSLBinaryExpression.h"
+#include "ir/SkSLBlock.h"
+#include "ir/SkSLConstructor.h"
+#include "ir/SkSLDoStatement.h"
 #include "ir/SkSLExpression.h"
+#include "ir/SkSLExpressionStatement.h"
+#include "ir/SkSLFieldAccess.h"
+#include "ir/SkSLForStatement.h"
+#include "ir/SkSLFunctionCall.h"
+#include "ir/SkSLFunctionDefinition.h"
+#include "ir/SkSLIfStatement.h"
+#include "ir/SkSLIndexExpression.h"
 #include "ir/SkSLIntLiteral.h"
+#include "ir/SkSLInterfaceBlock.h"
+#include "ir/SkSLPostfixExpression.h"
+#include "ir/SkSLPrefixExpression.h"
+#include "ir/SkSLReturnStatement.h"
+#include "ir/SkSLSwizzle.h"
 #include "ir/SkSLSymbolTable.h"
+#include "ir/SkSLTernaryExpression.h"
 #include "ir/SkSLVarDeclaration.h"
+#include "ir/SkSLVarDeclarationStatement.h"
+#include "ir/SkSLWhileStatement.h"
 #include "SkMutex.h"
 
 #define STRINGIFY(x) #x
@@ -37,6 +60,9 @@ static std::string SKSL_FRAG_INCLUDE =
 
 namespace SkSL {
 
+// the number of programs whose generated code is remembered
+static const size_t kCacheLimit = 256;
+
 Compiler::Compiler() 
 : fErrorCount(0) {
     auto types = std::shared_ptr<SymbolTable>(new SymbolTable(*this));
@@ -127,6 +153,8 @@ Compiler::Compiler()
     std::vector<std::unique_ptr<ProgramElement>> ignored;
     this->internalConvertProgram(SKSL_INCLUDE, &ignored);
     ASSERT(!fErrorCount);
+    this->loadModule(SKSL_VERT_INCLUDE, &fVertexSymbols, &fVertexElements);
+    this->loadModule(SKSL_FRAG_INCLUDE, &fFragmentSymbols, &fFragmentElements);
 }
 
 Compiler::~Compiler() {
@@ -147,7 +175,8 @@ void Compiler::internalConvertProgram(std::string text,
                 std::unique_ptr<VarDeclaration> s = fIRGenerator->convertVarDeclaration(
                                                                          (ASTVarDeclaration&) decl, 
                                                                          Variable::kGlobal_Storage);
-                if (s) {
+                // declarations consisting only of constants, which were folded away, are dropped
+                if (s && s->fVars.size()) {
                     result->push_back(std::move(s));
                 }
                 break;
@@ -181,21 +210,240 @@ void Compiler::internalConvertProgram(std::string text,
     }
 }
 
+typedef std::unordered_set<const FunctionDeclaration*> FunctionSet;
+
+static void find_calls(const Statement& s, FunctionSet* calls);
+
+static void find_calls(const Expression& e, FunctionSet* calls) {
+    switch (e.fKind) {
+        case Expression::kFunctionCall_Kind: {
+            const FunctionCall& c = (const FunctionCall&) e;
+            calls->insert(c.fFunction.get());
+            for (const auto& arg : c.fArguments) {
+                find_calls(*arg, calls);
+            }
+            break;
+        }
+        case Expression::kBinary_Kind:
+            find_calls(*((const BinaryExpression&) e).fLeft, calls);
+            find_calls(*((const BinaryExpression&) e).fRight, calls);
+            break;
+        case Expression::kConstructor_Kind:
+            for (const auto& arg : ((const Constructor&) e).fArguments) {
+                find_calls(*arg, calls);
+            }
+            break;
+        case Expression::kFieldAccess_Kind:
+            find_calls(*((const FieldAccess&) e).fBase, calls);
+            break;
+        case Expression::kIndex_Kind:
+            find_calls(*((const IndexExpression&) e).fBase, calls);
+            find_calls(*((const IndexExpression&) e).fIndex, calls);
+            break;
+        case Expression::kPrefix_Kind:
+            find_calls(*((const PrefixExpression&) e).fOperand, calls);
+            break;
+        case Expression::kPostfix_Kind:
+            find_calls(*((const PostfixExpression&) e).fOperand, calls);
+            break;
+        case Expression::kSwizzle_Kind:
+            find_calls(*((const Swizzle&) e).fBase, calls);
+            break;
+        case Expression::kTernary_Kind:
+            find_calls(*((const TernaryExpression&) e).fTest, calls);
+            find_calls(*((const TernaryExpression&) e).fIfTrue, calls);
+            find_calls(*((const TernaryExpression&) e).fIfFalse, calls);
+            break;
+        default:
+            break;
+    }
+}
+
+static void find_calls(const VarDeclaration& decl, FunctionSet* calls) {
+    for (const auto& sizes : decl.fSizes) {
+        for (const auto& size : sizes) {
+            if (size) {
+                find_calls(*size, calls);
+            }
+        }
+    }
+    for (const auto& value : decl.fValues) {
+        if (value) {
+            find_calls(*value, calls);
+        }
+    }
+}
+
+static void find_calls(const Statement& s, FunctionSet* calls) {
+    switch (s.fKind) {
+        case Statement::kBlock_Kind:
+            for (const auto& child : ((const Block&) s).fStatements) {
+                find_calls(*child, calls);
+            }
+            break;
+        case Statement::kDo_Kind:
+            find_calls(*((const DoStatement&) s).fStatement, calls);
+            find_calls(*((const DoStatement&) s).fTest, calls);
+            break;
+        case Statement::kExpression_Kind:
+            find_calls(*((const ExpressionStatement&) s).fExpression, calls);
+            break;
+        case Statement::kFor_Kind: {
+            const ForStatement& f = (const ForStatement&) s;
+            if (f.fInitializer) {
+                find_calls(*f.fInitializer, calls);
+            }
+            if (f.fTest) {
+                find_calls(*f.fTest, calls);
+            }
+            if (f.fNext) {
+                find_calls(*f.fNext, calls);
+            }
+            find_calls(*f.fStatement, calls);
+            break;
+        }
+        case Statement::kIf_Kind: {
+            const IfStatement& i = (const IfStatement&) s;
+            find_calls(*i.fTest, calls);
+            find_calls(*i.fIfTrue, calls);
+            if (i.fIfFalse) {
+                find_calls(*i.fIfFalse, calls);
+            }
+            break;
+        }
+        case Statement::kReturn_Kind:
+            if (((const ReturnStatement&) s).fExpression) {
+                find_calls(*((const ReturnStatement&) s).fExpression, calls);
+            }
+            break;
+        case Statement::kVarDeclaration_Kind:
+            find_calls(*((const VarDeclarationStatement&) s).fDeclaration, calls);
+            break;
+        case Statement::kWhile_Kind:
+            find_calls(*((const WhileStatement&) s).fTest, calls);
+            find_calls(*((const WhileStatement&) s).fStatement, calls);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * Removes the definitions of functions which can't be reached from main(), such as those which
+ * were inlined at every call site.
+ */
+static void remove_unused_functions(std::vector<std::unique_ptr<ProgramElement>>* elements) {
+    FunctionSet used;
+    std::unordered_map<const FunctionDeclaration*, const FunctionDefinition*> definitions;
+    bool foundMain = false;
+    for (const auto& e : *elements) {
+        if (e->fKind == ProgramElement::kFunction_Kind) {
+            const FunctionDefinition& f = (const FunctionDefinition&) *e;
+            definitions[f.fDeclaration.get()] = &f;
+            if (f.fDeclaration->fName == "main") {
+                used.insert(f.fDeclaration.get());
+                foundMain = true;
+            }
+        } else if (e->fKind == ProgramElement::kVar_Kind) {
+            find_calls((const VarDeclaration&) *e, &used);
+        }
+    }
+    if (!foundMain) {
+        return;
+    }
+    std::vector<const FunctionDeclaration*> worklist(used.begin(), used.end());
+    while (worklist.size()) {
+        auto found = definitions.find(worklist.back());
+        worklist.pop_back();
+        if (found == definitions.end()) {
+            continue;
+        }
+        FunctionSet calls;
+        find_calls(*found->second->fBody, &calls);
+        for (const FunctionDeclaration* f : calls) {
+            if (used.insert(f).second) {
+                worklist.push_back(f);
+            }
+        }
+    }
+    auto unused = [&used] (const std::unique_ptr<ProgramElement>& e) {
+        return e->fKind == ProgramElement::kFunction_Kind &&
+               !used.count(((const FunctionDefinition&) *e).fDeclaration.get());
+    };
+    elements->erase(std::remove_if(elements->begin(), elements->end(), unused), elements->end());
+}
+
+/**
+ * Parses the built-in declarations for one kind of program into their own symbol table, which the
+ * symbol table of each program of that kind will descend from.
+ */
+void Compiler::loadModule(std::string text, std::shared_ptr<SymbolTable>* symbols,
+                          std::vector<std::unique_ptr<ProgramElement>>* elements) {
+    fIRGenerator->pushSymbolTable();
+    this->internalConvertProgram(text, elements);
+    *symbols = fIRGenerator->fSymbolTable;
+    fIRGenerator->popSymbolTable();
+    ASSERT(!fErrorCount);
+}
+
+/**
+ * Returns a copy of a built-in declaration for a new program. The variables are shared with every
+ * other program, so their usage flags are reset.
+ */
+static std::unique_ptr<ProgramElement> copy_module_element(const ProgramElement& e) {
+    switch (e.fKind) {
+        case ProgramElement::kVar_Kind: {
+            const VarDeclaration& decl = (const VarDeclaration&) e;
+            std::vector<std::vector<std::unique_ptr<Expression>>> sizes(decl.fVars.size());
+            std::vector<std::unique_ptr<Expression>> values(decl.fVars.size());
+            for (size_t i = 0; i < decl.fVars.size(); i++) {
+                ASSERT(!decl.fSizes[i].size() && !decl.fValues[i]);
+                decl.fVars[i]->fIsReadFrom = false;
+                decl.fVars[i]->fIsWrittenTo = false;
+            }
+            return std::unique_ptr<ProgramElement>(new VarDeclaration(decl.fPosition, decl.fVars,
+                                                                      std::move(sizes),
+                                                                      std::move(values)));
+        }
+        case ProgramElement::kInterfaceBlock_Kind: {
+            const InterfaceBlock& block = (const InterfaceBlock&) e;
+            block.fVariable->fIsReadFrom = false;
+            block.fVariable->fIsWrittenTo = false;
+            return std::unique_ptr<ProgramElement>(new InterfaceBlock(block.fPosition,
+                                                                      block.fVariable));
+        }
+        default:
+            ABORT("unsupported built-in declaration: %s\n", e.description().c_str());
+    }
+}
+
 std::unique_ptr<Program> Compiler::convertProgram(Program::Kind kind, std::string text) {
     fErrorText = "";
     fErrorCount = 0;
-    fIRGenerator->pushSymbolTable();
-    std::vector<std::unique_ptr<ProgramElement>> result;
+    std::shared_ptr<SymbolTable> builtins = fIRGenerator->fSymbolTable;
+    const std::vector<std::unique_ptr<ProgramElement>>* module = nullptr;
     switch (kind) {
         case Program::kVertex_Kind:
-            this->internalConvertProgram(SKSL_VERT_INCLUDE, &result);
+            fIRGenerator->fSymbolTable = fVertexSymbols;
+            module = &fVertexElements;
             break;
         case Program::kFragment_Kind:
-            this->internalConvertProgram(SKSL_FRAG_INCLUDE, &result);
+            fIRGenerator->fSymbolTable = fFragmentSymbols;
+            module = &fFragmentElements;
             break;
     }
+    std::vector<std::unique_ptr<ProgramElement>> result;
+    for (const auto& e : *module) {
+        result.push_back(copy_module_element(*e));
+    }
+    fIRGenerator->pushSymbolTable();
     this->internalConvertProgram(text, &result);
-    fIRGenerator->popSymbolTable();
+    fIRGenerator->fSymbolTable = builtins;
+    fIRGenerator->fConstantValues.clear();
+    fIRGenerator->fInlineFunctions.clear();
+    if (!fErrorCount) {
+        remove_unused_functions(&result);
+    }
     this->writeErrorCount();
     return std::unique_ptr<Program>(new Program(kind, std::move(result)));;
 }
@@ -221,16 +469,41 @@ void Compiler::writeErrorCount() {
 }
 
 #include <fstream>
-bool Compiler::toSPIRV(Program::Kind kind, std::string text, std::ostream& out) {
+/**
+ * Converts the program and writes it out with the generator, unless the output for the same key is
+ * already in the cache.
+ */
+bool Compiler::generateCode(const std::string& key, Program::Kind kind, const std::string& text,
+                            CodeGenerator* generator, std::ostream& out) {
+    auto found = fCache.find(key);
+    if (found != fCache.end()) {
+        fErrorText = "";
+        fErrorCount = 0;
+        out << found->second;
+        ASSERT(!out.rdstate());
+        return true;
+    }
     auto program = this->convertProgram(kind, text);
     if (fErrorCount == 0) {
-        SkSL::SPIRVCodeGenerator cg;
-        cg.generateCode(*program.get(), out);
+        std::stringstream buffer;
+        generator->generateCode(*program.get(), buffer);
+        if (fCache.size() >= kCacheLimit) {
+            fCache.clear();
+        }
+        std::string& code = fCache[key];
+        code = buffer.str();
+        out << code;
         ASSERT(!out.rdstate());
     }
     return fErrorCount == 0;
 }
 
+bool Compiler::toSPIRV(Program::Kind kind, std::string text, std::ostream& out) {
+    SkSL::SPIRVCodeGenerator cg;
+    return this->generateCode("spirv:" + to_string((int) kind) + ":" + text, kind, text, &cg, 
+                              out);
+}
+
 bool Compiler::toSPIRV(Program::Kind kind, std::string text, std::string* out) {
     std::stringstream buffer;
     bool result = this->toSPIRV(kind, text, buffer);
@@ -240,4 +513,21 @@ bool Compiler::toSPIRV(Program::Kind kind, std::string text, std::string* out) {
     return fErrorCount == 0;
 }
 
+bool Compiler::toGLSL(Program::Kind kind, std::string text, GLCaps caps, std::ostream& out) {
+    SkSL::GLSLCodeGenerator cg(caps);
+    std::string key = "glsl " + to_string(caps.fVersion) + 
+                      (caps.fStandard == GLCaps::kGLES_Standard ? " es:" : ":") + 
+                      to_string((int) kind) + ":" + text;
+    return this->generateCode(key, kind, text, &cg, out);
+}
+
+bool Compiler::toGLSL(Program::Kind kind, std::string text, GLCaps caps, std::string* out) {
+    std::stringstream buffer;
+    bool result = this->toGLSL(kind, text, caps, buffer);
+    if (result) {
+        *out = buffer.str();
+    }
+    return result;
+}
+
 } // namespace
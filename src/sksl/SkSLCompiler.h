@@ -8,10 +8,12 @@
 #ifndef SKSL_COMPILER
 #define SKSL_COMPILER
 
+#include <unordered_map>
 #include <vector>
 #include "ir/SkSLProgram.h"
 #include "ir/SkSLSymbolTable.h"
 #include "SkSLErrorReporter.h"
+#include "SkSLGLSLCodeGenerator.h"
 
 namespace SkSL {
 
@@ -21,7 +23,10 @@ class IRGenerator;
  * Main compiler entry point. This is a traditional compiler design which first parses the .sksl
  * file into an abstract syntax tree (a tree of ASTNodes), then performs semantic analysis to 
  * produce a Program (a tree of IRNodes), then feeds the Program into a CodeGenerator to produce
- * compiled output.
+ * compiled output: SPIR-V for Vulkan, or GLSL for OpenGL.
+ *
+ * The built-in declarations are parsed once, when the compiler is created, and SPIR-V is remembered
+ * for the most recently compiled sources, so a Compiler should be kept around and reused.
  */
 class Compiler : public ErrorReporter {
 public:
@@ -35,6 +40,10 @@ public:
 	
 	bool toSPIRV(Program::Kind kind, std::string text, std::string* out);
 
+    bool toGLSL(Program::Kind kind, std::string text, GLCaps caps, std::ostream& out);
+
+    bool toGLSL(Program::Kind kind, std::string text, GLCaps caps, std::string* out);
+
     void error(Position position, std::string msg) override;
 
     std::string errorText();
@@ -46,9 +55,21 @@ private:
     void internalConvertProgram(std::string text,
     							std::vector<std::unique_ptr<ProgramElement>>* result);
 
+    bool generateCode(const std::string& key, Program::Kind kind, const std::string& text,
+                      CodeGenerator* generator, std::ostream& out);
+
+    void loadModule(std::string text, std::shared_ptr<SymbolTable>* symbols,
+                    std::vector<std::unique_ptr<ProgramElement>>* elements);
+
     std::shared_ptr<SymbolTable> fTypes;
     IRGenerator* fIRGenerator;
-    std::string fSkiaVertText; // FIXME store parsed version instead
+    // the vertex and fragment shader built-ins, shared by every program of that kind
+    std::shared_ptr<SymbolTable> fVertexSymbols;
+    std::vector<std::unique_ptr<ProgramElement>> fVertexElements;
+    std::shared_ptr<SymbolTable> fFragmentSymbols;
+    std::vector<std::unique_ptr<ProgramElement>> fFragmentElements;
+    // output for recently compiled programs, keyed by target, kind and source
+    std::unordered_map<std::string, std::string> fCache;
 
     int fErrorCount;
     std::string fErrorText;
@@ -0,0 +1,617 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkSLGLSLCodeGenerator.h"
+
+#include "limits.h"
+#include "stdio.h"
+
+#include "ir/SkSLExpressionStatement.h"
+
+namespace SkSL {
+
+static bool is_negative_literal(const Expression& expr) {
+    switch (expr.fKind) {
+        case Expression::kIntLiteral_Kind:
+            return ((IntLiteral&) expr).fValue < 0;
+        case Expression::kFloatLiteral_Kind:
+            return ((FloatLiteral&) expr).fValue < 0;
+        default:
+            return false;
+    }
+}
+
+static GLSLCodeGenerator::Precedence get_binary_precedence(Token::Kind op) {
+    switch (op) {
+        case Token::STAR:         // fall through
+        case Token::SLASH:        // fall through
+        case Token::PERCENT:      return GLSLCodeGenerator::kMultiplicative_Precedence;
+        case Token::PLUS:         // fall through
+        case Token::MINUS:        return GLSLCodeGenerator::kAdditive_Precedence;
+        case Token::SHL:          // fall through
+        case Token::SHR:          return GLSLCodeGenerator::kShift_Precedence;
+        case Token::LT:           // fall through
+        case Token::GT:           // fall through
+        case Token::LTEQ:         // fall through
+        case Token::GTEQ:         return GLSLCodeGenerator::kRelational_Precedence;
+        case Token::EQEQ:         // fall through
+        case Token::NEQ:          return GLSLCodeGenerator::kEquality_Precedence;
+        case Token::BITWISEAND:   return GLSLCodeGenerator::kBitwiseAnd_Precedence;
+        case Token::BITWISEXOR:   return GLSLCodeGenerator::kBitwiseXor_Precedence;
+        case Token::BITWISEOR:    return GLSLCodeGenerator::kBitwiseOr_Precedence;
+        case Token::LOGICALAND:   return GLSLCodeGenerator::kLogicalAnd_Precedence;
+        case Token::LOGICALXOR:   return GLSLCodeGenerator::kLogicalXor_Precedence;
+        case Token::LOGICALOR:    return GLSLCodeGenerator::kLogicalOr_Precedence;
+        case Token::EQ:           // fall through
+        case Token::PLUSEQ:       // fall through
+        case Token::MINUSEQ:      // fall through
+        case Token::STAREQ:       // fall through
+        case Token::SLASHEQ:      // fall through
+        case Token::PERCENTEQ:    // fall through
+        case Token::SHLEQ:        // fall through
+        case Token::SHREQ:        // fall through
+        case Token::LOGICALANDEQ: // fall through
+        case Token::LOGICALXOREQ: // fall through
+        case Token::LOGICALOREQ:  // fall through
+        case Token::BITWISEANDEQ: // fall through
+        case Token::BITWISEXOREQ: // fall through
+        case Token::BITWISEOREQ:  return GLSLCodeGenerator::kAssignment_Precedence;
+        default: ABORT("unsupported binary operator");
+    }
+}
+
+static GLSLCodeGenerator::Precedence next(GLSLCodeGenerator::Precedence precedence) {
+    return (GLSLCodeGenerator::Precedence) (precedence + 1);
+}
+
+void GLSLCodeGenerator::write(const std::string& s) {
+    if (s.empty()) {
+        return;
+    }
+    if (fAtLineStart) {
+        for (int i = 0; i < fIndentation; i++) {
+            *fOut << "    ";
+        }
+    }
+    *fOut << s;
+    fAtLineStart = false;
+}
+
+void GLSLCodeGenerator::writeLine(const std::string& s) {
+    this->write(s);
+    *fOut << "\n";
+    fAtLineStart = true;
+}
+
+void GLSLCodeGenerator::writeType(const Type& type) {
+    if (type.kind() == Type::kStruct_Kind) {
+        this->writeStruct(type);
+    }
+    this->write(type.fName);
+}
+
+/**
+ * Defines a struct type in the header, the first time it is used.
+ */
+void GLSLCodeGenerator::writeStruct(const Type& type) {
+    if (fWrittenStructs.count(&type)) {
+        return;
+    }
+    fWrittenStructs.insert(&type);
+    for (const auto& f : type.fields()) {
+        if (f.fType->kind() == Type::kStruct_Kind) {
+            this->writeStruct(*f.fType);
+        }
+    }
+    std::ostream* oldOut = fOut;
+    int oldIndentation = fIndentation;
+    bool oldAtLineStart = fAtLineStart;
+    fOut = &fHeader;
+    fIndentation = 0;
+    fAtLineStart = true;
+    this->writeLine("struct " + type.fName + " {");
+    fIndentation++;
+    for (const auto& f : type.fields()) {
+        this->writeModifiers(f.fModifiers);
+        this->writeType(*f.fType);
+        this->writeLine(" " + f.fName + ";");
+    }
+    fIndentation--;
+    this->writeLine("};");
+    fOut = oldOut;
+    fIndentation = oldIndentation;
+    fAtLineStart = oldAtLineStart;
+}
+
+void GLSLCodeGenerator::writeModifiers(const Modifiers& modifiers) {
+    // layout qualifiers arrived with GLSL 3.30 and GLSL ES 3.00, and only GL has output indices;
+    // binding and set are Vulkan's business, and built-ins aren't declared at all
+    const Layout& layout = modifiers.fLayout;
+    bool explicitLocations = fCaps.fStandard == GLCaps::kGLES_Standard ? fCaps.fVersion >= 300
+                                                                        : fCaps.fVersion >= 330;
+    if (explicitLocations && layout.fLocation >= 0) {
+        std::string qualifiers = "location = " + to_string(layout.fLocation);
+        if (layout.fIndex >= 0 && fCaps.fStandard == GLCaps::kGL_Standard) {
+            qualifiers += ", index = " + to_string(layout.fIndex);
+        }
+        this->write("layout (" + qualifiers + ") ");
+    }
+    if (modifiers.fFlags & Modifiers::kConst_Flag) {
+        this->write("const ");
+    }
+    if (modifiers.fFlags & Modifiers::kUniform_Flag) {
+        this->write("uniform ");
+    }
+    if ((modifiers.fFlags & Modifiers::kIn_Flag) && (modifiers.fFlags & Modifiers::kOut_Flag)) {
+        this->write("inout ");
+    } else if (modifiers.fFlags & Modifiers::kIn_Flag) {
+        this->write("in ");
+    } else if (modifiers.fFlags & Modifiers::kOut_Flag) {
+        this->write("out ");
+    }
+    // precision qualifiers only mean something to GLSL ES
+    if (fCaps.fStandard == GLCaps::kGLES_Standard) {
+        if (modifiers.fFlags & Modifiers::kLowp_Flag) {
+            this->write("lowp ");
+        }
+        if (modifiers.fFlags & Modifiers::kMediump_Flag) {
+            this->write("mediump ");
+        }
+        if (modifiers.fFlags & Modifiers::kHighp_Flag) {
+            this->write("highp ");
+        }
+    }
+}
+
+void GLSLCodeGenerator::writeExtension(const Extension& ext, std::ostream& out) {
+    out << ext.description() << "\n";
+}
+
+void GLSLCodeGenerator::writeInterfaceBlock(const InterfaceBlock& intf) {
+    fInterfaceBlocks.insert(intf.fVariable.get());
+    if (intf.fVariable->fName.compare(0, 3, "gl_") == 0) {
+        // gl_PerVertex and friends are predeclared
+        return;
+    }
+    this->writeModifiers(intf.fVariable->fModifiers);
+    this->writeLine(intf.fVariable->fName + " {");
+    fIndentation++;
+    for (const auto& f : intf.fVariable->fType->fields()) {
+        this->writeModifiers(f.fModifiers);
+        this->writeType(*f.fType);
+        this->writeLine(" " + f.fName + ";");
+    }
+    fIndentation--;
+    this->writeLine("};");
+}
+
+void GLSLCodeGenerator::writeFunctionDeclaration(const FunctionDeclaration& f) {
+    this->writeType(*f.fReturnType);
+    this->write(" " + f.fName + "(");
+    const char* separator = "";
+    for (const auto& param : f.fParameters) {
+        this->write(separator);
+        separator = ", ";
+        this->writeModifiers(param->fModifiers);
+        this->writeType(*param->fType);
+        this->write(" " + param->fName);
+    }
+    this->write(")");
+}
+
+void GLSLCodeGenerator::writeFunction(const FunctionDefinition& f) {
+    fWrittenFunctions.insert(f.fDeclaration.get());
+    this->writeFunctionDeclaration(*f.fDeclaration);
+    this->write(" ");
+    this->writeBlock(*f.fBody);
+    this->writeLine();
+}
+
+void GLSLCodeGenerator::writeVarDeclaration(const VarDeclaration& decl) {
+    ASSERT(decl.fVars.size() > 0);
+    this->writeModifiers(decl.fVars[0]->fModifiers);
+    const Type* baseType = decl.fVars[0]->fType.get();
+    while (baseType->kind() == Type::kArray_Kind) {
+        baseType = baseType->componentType().get();
+    }
+    this->writeType(*baseType);
+    const char* separator = " ";
+    for (size_t i = 0; i < decl.fVars.size(); i++) {
+        this->write(separator);
+        separator = ", ";
+        this->write(decl.fVars[i]->fName);
+        for (const auto& size : decl.fSizes[i]) {
+            this->write("[");
+            if (size) {
+                this->writeExpression(*size, kTopLevel_Precedence);
+            }
+            this->write("]");
+        }
+        if (decl.fValues[i]) {
+            this->write(" = ");
+            this->writeExpression(*decl.fValues[i], kSequence_Precedence);
+        }
+    }
+    this->write(";");
+}
+
+void GLSLCodeGenerator::writeExpression(const Expression& expr, Precedence parentPrecedence) {
+    switch (expr.fKind) {
+        case Expression::kBinary_Kind:
+            this->writeBinaryExpression((BinaryExpression&) expr, parentPrecedence);
+            break;
+        case Expression::kBoolLiteral_Kind:
+            this->writeBoolLiteral((BoolLiteral&) expr);
+            break;
+        case Expression::kConstructor_Kind:
+            this->writeConstructor((Constructor&) expr);
+            break;
+        case Expression::kIntLiteral_Kind:
+            this->writeIntLiteral((IntLiteral&) expr);
+            break;
+        case Expression::kFieldAccess_Kind:
+            this->writeFieldAccess(((FieldAccess&) expr));
+            break;
+        case Expression::kFloatLiteral_Kind:
+            this->writeFloatLiteral(((FloatLiteral&) expr));
+            break;
+        case Expression::kFunctionCall_Kind:
+            this->writeFunctionCall((FunctionCall&) expr);
+            break;
+        case Expression::kPrefix_Kind:
+            this->writePrefixExpression((PrefixExpression&) expr, parentPrecedence);
+            break;
+        case Expression::kPostfix_Kind:
+            this->writePostfixExpression((PostfixExpression&) expr, parentPrecedence);
+            break;
+        case Expression::kSwizzle_Kind:
+            this->writeSwizzle((Swizzle&) expr);
+            break;
+        case Expression::kVariableReference_Kind:
+            this->write(((VariableReference&) expr).fVariable->fName);
+            break;
+        case Expression::kTernary_Kind:
+            this->writeTernaryExpression((TernaryExpression&) expr, parentPrecedence);
+            break;
+        case Expression::kIndex_Kind:
+            this->writeIndexExpression((IndexExpression&) expr);
+            break;
+        default:
+            ABORT("unsupported expression: %s", expr.description().c_str());
+    }
+}
+
+void GLSLCodeGenerator::writeFunctionCall(const FunctionCall& c) {
+    if (c.fFunction->fDefined && !fWrittenFunctions.count(c.fFunction.get()) &&
+        !fPrototypedFunctions.count(c.fFunction.get())) {
+        // called before its definition, so it needs a prototype
+        fPrototypedFunctions.insert(c.fFunction.get());
+        std::ostream* oldOut = fOut;
+        int oldIndentation = fIndentation;
+        bool oldAtLineStart = fAtLineStart;
+        fOut = &fHeader;
+        fIndentation = 0;
+        fAtLineStart = true;
+        this->writeFunctionDeclaration(*c.fFunction);
+        this->writeLine(";");
+        fOut = oldOut;
+        fIndentation = oldIndentation;
+        fAtLineStart = oldAtLineStart;
+    }
+    this->write(c.fFunction->fName + "(");
+    const char* separator = "";
+    for (const auto& arg : c.fArguments) {
+        this->write(separator);
+        separator = ", ";
+        this->writeExpression(*arg, kSequence_Precedence);
+    }
+    this->write(")");
+}
+
+void GLSLCodeGenerator::writeConstructor(const Constructor& c) {
+    this->writeType(*c.fType);
+    this->write("(");
+    const char* separator = "";
+    for (const auto& arg : c.fArguments) {
+        this->write(separator);
+        separator = ", ";
+        this->writeExpression(*arg, kSequence_Precedence);
+    }
+    this->write(")");
+}
+
+void GLSLCodeGenerator::writeFieldAccess(const FieldAccess& f) {
+    const std::string& name = f.fBase->fType->fields()[f.fFieldIndex].fName;
+    if (f.fBase->fKind == Expression::kVariableReference_Kind &&
+        fInterfaceBlocks.count(((VariableReference&) *f.fBase).fVariable.get())) {
+        // interface block fields are in the global scope
+        this->write(name);
+        return;
+    }
+    this->writeExpression(*f.fBase, kPostfix_Precedence);
+    this->write("." + name);
+}
+
+void GLSLCodeGenerator::writeSwizzle(const Swizzle& swizzle) {
+    this->writeExpression(*swizzle.fBase, kPostfix_Precedence);
+    std::string components = ".";
+    for (int c : swizzle.fComponents) {
+        components += "xyzw"[c];
+    }
+    this->write(components);
+}
+
+void GLSLCodeGenerator::writeBinaryExpression(const BinaryExpression& b,
+                                              Precedence parentPrecedence) {
+    Precedence precedence = get_binary_precedence(b.fOperator);
+    if (precedence >= parentPrecedence) {
+        this->write("(");
+    }
+    switch (b.fOperator) {
+        case Token::LOGICALANDEQ: // fall through
+        case Token::LOGICALXOREQ: // fall through
+        case Token::LOGICALOREQ: {
+            // GLSL has no logical assignment operators, so 'x &&= y' is written as 'x = x && y'
+            Token::Kind op = b.fOperator == Token::LOGICALANDEQ ? Token::LOGICALAND :
+                             b.fOperator == Token::LOGICALXOREQ ? Token::LOGICALXOR :
+                                                                  Token::LOGICALOR;
+            Precedence opPrecedence = get_binary_precedence(op);
+            this->writeExpression(*b.fLeft, precedence);
+            this->write(" = ");
+            this->writeExpression(*b.fLeft, next(opPrecedence));
+            this->write(" " + Token::OperatorName(op) + " ");
+            this->writeExpression(*b.fRight, opPrecedence);
+            break;
+        }
+        default:
+            if (precedence == kAssignment_Precedence) {
+                // right associative
+                this->writeExpression(*b.fLeft, precedence);
+                this->write(" " + Token::OperatorName(b.fOperator) + " ");
+                this->writeExpression(*b.fRight, next(precedence));
+            } else {
+                this->writeExpression(*b.fLeft, next(precedence));
+                this->write(" " + Token::OperatorName(b.fOperator) + " ");
+                this->writeExpression(*b.fRight, precedence);
+            }
+            break;
+    }
+    if (precedence >= parentPrecedence) {
+        this->write(")");
+    }
+}
+
+void GLSLCodeGenerator::writeTernaryExpression(const TernaryExpression& t,
+                                               Precedence parentPrecedence) {
+    if (kTernary_Precedence >= parentPrecedence) {
+        this->write("(");
+    }
+    this->writeExpression(*t.fTest, kTernary_Precedence);
+    this->write(" ? ");
+    this->writeExpression(*t.fIfTrue, kTernary_Precedence);
+    this->write(" : ");
+    this->writeExpression(*t.fIfFalse, kTernary_Precedence);
+    if (kTernary_Precedence >= parentPrecedence) {
+        this->write(")");
+    }
+}
+
+void GLSLCodeGenerator::writeIndexExpression(const IndexExpression& expr) {
+    this->writeExpression(*expr.fBase, kPostfix_Precedence);
+    this->write("[");
+    this->writeExpression(*expr.fIndex, kTopLevel_Precedence);
+    this->write("]");
+}
+
+void GLSLCodeGenerator::writePrefixExpression(const PrefixExpression& p,
+                                              Precedence parentPrecedence) {
+    if (kPrefix_Precedence >= parentPrecedence) {
+        this->write("(");
+    }
+    this->write(Token::OperatorName(p.fOperator));
+    // keeps '-(-x)' from becoming the decrement '--x'
+    if (p.fOperand->fKind == Expression::kPrefix_Kind || is_negative_literal(*p.fOperand)) {
+        this->write("(");
+        this->writeExpression(*p.fOperand, kTopLevel_Precedence);
+        this->write(")");
+    } else {
+        this->writeExpression(*p.fOperand, kPrefix_Precedence);
+    }
+    if (kPrefix_Precedence >= parentPrecedence) {
+        this->write(")");
+    }
+}
+
+void GLSLCodeGenerator::writePostfixExpression(const PostfixExpression& p,
+                                               Precedence parentPrecedence) {
+    if (kPostfix_Precedence >= parentPrecedence) {
+        this->write("(");
+    }
+    this->writeExpression(*p.fOperand, kPostfix_Precedence);
+    this->write(Token::OperatorName(p.fOperator));
+    if (kPostfix_Precedence >= parentPrecedence) {
+        this->write(")");
+    }
+}
+
+void GLSLCodeGenerator::writeBoolLiteral(const BoolLiteral& b) {
+    this->write(b.fValue ? "true" : "false");
+}
+
+void GLSLCodeGenerator::writeIntLiteral(const IntLiteral& i) {
+    if (i.fValue == INT_MIN) {
+        // 2147483648 is out of range, so it can't be negated
+        this->write("(-2147483647 - 1)");
+        return;
+    }
+    this->write(to_string(i.fValue));
+}
+
+void GLSLCodeGenerator::writeFloatLiteral(const FloatLiteral& f) {
+    // the shortest text which rounds to the same float
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.9g", f.fValue);
+    std::string result = buffer;
+    if (result.find_first_of(".e") == std::string::npos) {
+        result += ".0";
+    }
+    this->write(result);
+}
+
+void GLSLCodeGenerator::writeStatement(const Statement& s) {
+    switch (s.fKind) {
+        case Statement::kBlock_Kind:
+            this->writeBlock((Block&) s);
+            break;
+        case Statement::kExpression_Kind:
+            this->writeExpression(*((ExpressionStatement&) s).fExpression, kTopLevel_Precedence);
+            this->write(";");
+            break;
+        case Statement::kReturn_Kind:
+            this->writeReturnStatement((ReturnStatement&) s);
+            break;
+        case Statement::kVarDeclaration_Kind:
+            this->writeVarDeclaration(*((VarDeclarationStatement&) s).fDeclaration);
+            break;
+        case Statement::kIf_Kind:
+            this->writeIfStatement((IfStatement&) s);
+            break;
+        case Statement::kFor_Kind:
+            this->writeForStatement((ForStatement&) s);
+            break;
+        case Statement::kWhile_Kind:
+            this->writeWhileStatement((WhileStatement&) s);
+            break;
+        case Statement::kDo_Kind:
+            this->writeDoStatement((DoStatement&) s);
+            break;
+        case Statement::kBreak_Kind:
+            this->write("break;");
+            break;
+        case Statement::kContinue_Kind:
+            this->write("continue;");
+            break;
+        case Statement::kDiscard_Kind:
+            this->write("discard;");
+            break;
+        default:
+            ABORT("unsupported statement: %s", s.description().c_str());
+    }
+}
+
+void GLSLCodeGenerator::writeBlock(const Block& b) {
+    this->writeLine("{");
+    fIndentation++;
+    for (const auto& s : b.fStatements) {
+        this->writeStatement(*s);
+        this->writeLine();
+    }
+    fIndentation--;
+    this->write("}");
+}
+
+void GLSLCodeGenerator::writeIfStatement(const IfStatement& stmt) {
+    this->write("if (");
+    this->writeExpression(*stmt.fTest, kTopLevel_Precedence);
+    this->write(") ");
+    this->writeStatement(*stmt.fIfTrue);
+    if (stmt.fIfFalse) {
+        this->write(" else ");
+        this->writeStatement(*stmt.fIfFalse);
+    }
+}
+
+void GLSLCodeGenerator::writeForStatement(const ForStatement& f) {
+    this->write("for (");
+    if (f.fInitializer && f.fInitializer->fKind != Statement::kBlock_Kind) {
+        this->writeStatement(*f.fInitializer);
+    } else {
+        this->write(";");
+    }
+    this->write(" ");
+    if (f.fTest) {
+        this->writeExpression(*f.fTest, kTopLevel_Precedence);
+    }
+    this->write("; ");
+    if (f.fNext) {
+        this->writeExpression(*f.fNext, kTopLevel_Precedence);
+    }
+    this->write(") ");
+    this->writeStatement(*f.fStatement);
+}
+
+void GLSLCodeGenerator::writeWhileStatement(const WhileStatement& w) {
+    this->write("while (");
+    this->writeExpression(*w.fTest, kTopLevel_Precedence);
+    this->write(") ");
+    this->writeStatement(*w.fStatement);
+}
+
+void GLSLCodeGenerator::writeDoStatement(const DoStatement& d) {
+    this->write("do ");
+    this->writeStatement(*d.fStatement);
+    this->write(" while (");
+    this->writeExpression(*d.fTest, kTopLevel_Precedence);
+    this->write(");");
+}
+
+void GLSLCodeGenerator::writeReturnStatement(const ReturnStatement& r) {
+    this->write("return");
+    if (r.fExpression) {
+        this->write(" ");
+        this->writeExpression(*r.fExpression, kTopLevel_Precedence);
+    }
+    this->write(";");
+}
+
+void GLSLCodeGenerator::generateCode(Program& program, std::ostream& out) {
+    std::stringstream body;
+    fOut = &body;
+    for (const auto& e : program.fElements) {
+        switch (e->fKind) {
+            case ProgramElement::kExtension_Kind:
+                break;
+            case ProgramElement::kVar_Kind: {
+                const VarDeclaration& decl = (VarDeclaration&) *e;
+                if (decl.fVars[0]->fModifiers.fLayout.fBuiltin >= 0) {
+                    // predeclared by GLSL
+                    break;
+                }
+                this->writeVarDeclaration(decl);
+                this->writeLine();
+                break;
+            }
+            case ProgramElement::kInterfaceBlock_Kind:
+                this->writeInterfaceBlock((InterfaceBlock&) *e);
+                break;
+            case ProgramElement::kFunction_Kind:
+                this->writeFunction((FunctionDefinition&) *e);
+                break;
+            default:
+                ABORT("unsupported program element %s\n", e->description().c_str());
+        }
+    }
+    fOut = nullptr;
+
+    out << "#version " << fCaps.fVersion;
+    if (fCaps.fStandard == GLCaps::kGLES_Standard) {
+        out << " es";
+    }
+    out << "\n";
+    for (const auto& e : program.fElements) {
+        if (e->fKind == ProgramElement::kExtension_Kind) {
+            this->writeExtension((Extension&) *e, out);
+        }
+    }
+    if (fCaps.fStandard == GLCaps::kGLES_Standard && program.fKind == Program::kFragment_Kind) {
+        // GLSL ES fragment shaders have no default float precision; this is the one Ganesh uses
+        out << "precision mediump float;\n";
+    }
+    out << fHeader.str() << body.str();
+}
+
+}
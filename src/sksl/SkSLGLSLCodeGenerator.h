@@ -0,0 +1,169 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SKSL_GLSLCODEGENERATOR
+#define SKSL_GLSLCODEGENERATOR
+
+#include <sstream>
+#include <unordered_set>
+#include <vector>
+
+#include "SkSLCodeGenerator.h"
+#include "ir/SkSLBinaryExpression.h"
+#include "ir/SkSLBlock.h"
+#include "ir/SkSLBoolLiteral.h"
+#include "ir/SkSLConstructor.h"
+#include "ir/SkSLDoStatement.h"
+#include "ir/SkSLExtension.h"
+#include "ir/SkSLFloatLiteral.h"
+#include "ir/SkSLIfStatement.h"
+#include "ir/SkSLIndexExpression.h"
+#include "ir/SkSLInterfaceBlock.h"
+#include "ir/SkSLIntLiteral.h"
+#include "ir/SkSLFieldAccess.h"
+#include "ir/SkSLForStatement.h"
+#include "ir/SkSLFunctionCall.h"
+#include "ir/SkSLFunctionDeclaration.h"
+#include "ir/SkSLFunctionDefinition.h"
+#include "ir/SkSLPrefixExpression.h"
+#include "ir/SkSLPostfixExpression.h"
+#include "ir/SkSLProgramElement.h"
+#include "ir/SkSLReturnStatement.h"
+#include "ir/SkSLStatement.h"
+#include "ir/SkSLSwizzle.h"
+#include "ir/SkSLTernaryExpression.h"
+#include "ir/SkSLVarDeclaration.h"
+#include "ir/SkSLVarDeclarationStatement.h"
+#include "ir/SkSLVariableReference.h"
+#include "ir/SkSLWhileStatement.h"
+
+namespace SkSL {
+
+/**
+ * The GLSL dialect to generate. Only versions with 'in' / 'out' variables are supported, which is
+ * 1.40 and above for desktop GL and 3.00 and above for GLES.
+ */
+struct GLCaps {
+    int fVersion;
+    enum {
+        kGL_Standard,
+        kGLES_Standard
+    } fStandard;
+};
+
+/**
+ * Converts a Program into GLSL source code.
+ */
+class GLSLCodeGenerator : public CodeGenerator {
+public:
+    enum Precedence {
+        kParentheses_Precedence    =  1,
+        kPostfix_Precedence        =  2,
+        kPrefix_Precedence         =  3,
+        kMultiplicative_Precedence =  4,
+        kAdditive_Precedence       =  5,
+        kShift_Precedence          =  6,
+        kRelational_Precedence     =  7,
+        kEquality_Precedence       =  8,
+        kBitwiseAnd_Precedence     =  9,
+        kBitwiseXor_Precedence     = 10,
+        kBitwiseOr_Precedence      = 11,
+        kLogicalAnd_Precedence     = 12,
+        kLogicalXor_Precedence     = 13,
+        kLogicalOr_Precedence      = 14,
+        kTernary_Precedence        = 15,
+        kAssignment_Precedence     = 16,
+        kSequence_Precedence       = 17,
+        kTopLevel_Precedence       = 18
+    };
+
+    GLSLCodeGenerator(GLCaps caps)
+    : fCaps(caps)
+    , fOut(nullptr)
+    , fIndentation(0)
+    , fAtLineStart(true) {}
+
+    void generateCode(Program& program, std::ostream& out) override;
+
+private:
+    void write(const std::string& s);
+
+    void writeLine(const std::string& s = "");
+
+    void writeType(const Type& type);
+
+    void writeStruct(const Type& type);
+
+    void writeModifiers(const Modifiers& modifiers);
+
+    void writeExtension(const Extension& ext, std::ostream& out);
+
+    void writeInterfaceBlock(const InterfaceBlock& intf);
+
+    void writeFunctionDeclaration(const FunctionDeclaration& f);
+
+    void writeFunction(const FunctionDefinition& f);
+
+    void writeVarDeclaration(const VarDeclaration& decl);
+
+    void writeExpression(const Expression& expr, Precedence parentPrecedence);
+
+    void writeFunctionCall(const FunctionCall& c);
+
+    void writeConstructor(const Constructor& c);
+
+    void writeFieldAccess(const FieldAccess& f);
+
+    void writeSwizzle(const Swizzle& swizzle);
+
+    void writeBinaryExpression(const BinaryExpression& b, Precedence parentPrecedence);
+
+    void writeTernaryExpression(const TernaryExpression& t, Precedence parentPrecedence);
+
+    void writeIndexExpression(const IndexExpression& expr);
+
+    void writePrefixExpression(const PrefixExpression& p, Precedence parentPrecedence);
+
+    void writePostfixExpression(const PostfixExpression& p, Precedence parentPrecedence);
+
+    void writeBoolLiteral(const BoolLiteral& b);
+
+    void writeIntLiteral(const IntLiteral& i);
+
+    void writeFloatLiteral(const FloatLiteral& f);
+
+    void writeStatement(const Statement& s);
+
+    void writeBlock(const Block& b);
+
+    void writeIfStatement(const IfStatement& stmt);
+
+    void writeForStatement(const ForStatement& f);
+
+    void writeWhileStatement(const WhileStatement& w);
+
+    void writeDoStatement(const DoStatement& d);
+
+    void writeReturnStatement(const ReturnStatement& r);
+
+    const GLCaps fCaps;
+    // the stream currently being written to
+    std::ostream* fOut;
+    // struct definitions and function prototypes, which must precede the code using them
+    std::stringstream fHeader;
+    int fIndentation;
+    bool fAtLineStart;
+    std::unordered_set<const Type*> fWrittenStructs;
+    std::unordered_set<const FunctionDeclaration*> fWrittenFunctions;
+    std::unordered_set<const FunctionDeclaration*> fPrototypedFunctions;
+    // variables standing for interface blocks, whose fields are referred to directly
+    std::unordered_set<const Variable*> fInterfaceBlocks;
+};
+
+}
+
+#endif
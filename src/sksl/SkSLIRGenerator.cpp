@@ -66,6 +66,83 @@ public:
     std::shared_ptr<SymbolTable> fPrevious;
 };
 
+static bool is_literal(const Expression& expr) {
+    switch (expr.fKind) {
+        case Expression::kBoolLiteral_Kind:  // fall through
+        case Expression::kIntLiteral_Kind:   // fall through
+        case Expression::kFloatLiteral_Kind:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool is_assignment(Token::Kind op) {
+    switch (op) {
+        case Token::EQ:           // fall through
+        case Token::PLUSEQ:       // fall through
+        case Token::MINUSEQ:      // fall through
+        case Token::STAREQ:       // fall through
+        case Token::SLASHEQ:      // fall through
+        case Token::PERCENTEQ:    // fall through
+        case Token::SHLEQ:        // fall through
+        case Token::SHREQ:        // fall through
+        case Token::BITWISEOREQ:  // fall through
+        case Token::BITWISEXOREQ: // fall through
+        case Token::BITWISEANDEQ: // fall through
+        case Token::LOGICALOREQ:  // fall through
+        case Token::LOGICALXOREQ: // fall through
+        case Token::LOGICALANDEQ: 
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * Returns true if evaluating the expression has no side effects, so it may be evaluated any number
+ * of times (including zero) without changing the program's behavior. Function calls are assumed to
+ * have side effects.
+ */
+static bool is_pure(const Expression& expr) {
+    switch (expr.fKind) {
+        case Expression::kBoolLiteral_Kind:        // fall through
+        case Expression::kIntLiteral_Kind:         // fall through
+        case Expression::kFloatLiteral_Kind:       // fall through
+        case Expression::kVariableReference_Kind:
+            return true;
+        case Expression::kBinary_Kind: {
+            const BinaryExpression& b = (const BinaryExpression&) expr;
+            return !is_assignment(b.fOperator) && is_pure(*b.fLeft) && is_pure(*b.fRight);
+        }
+        case Expression::kConstructor_Kind:
+            for (const auto& arg : ((const Constructor&) expr).fArguments) {
+                if (!is_pure(*arg)) {
+                    return false;
+                }
+            }
+            return true;
+        case Expression::kFieldAccess_Kind:
+            return is_pure(*((const FieldAccess&) expr).fBase);
+        case Expression::kIndex_Kind:
+            return is_pure(*((const IndexExpression&) expr).fBase) &&
+                   is_pure(*((const IndexExpression&) expr).fIndex);
+        case Expression::kPrefix_Kind: {
+            const PrefixExpression& p = (const PrefixExpression&) expr;
+            return p.fOperator != Token::PLUSPLUS && p.fOperator != Token::MINUSMINUS &&
+                   is_pure(*p.fOperand);
+        }
+        case Expression::kSwizzle_Kind:
+            return is_pure(*((const Swizzle&) expr).fBase);
+        case Expression::kTernary_Kind: {
+            const TernaryExpression& t = (const TernaryExpression&) expr;
+            return is_pure(*t.fTest) && is_pure(*t.fIfTrue) && is_pure(*t.fIfFalse);
+        }
+        default:
+            return false;
+    }
+}
+
 IRGenerator::IRGenerator(std::shared_ptr<SymbolTable> symbolTable, 
                          ErrorReporter& errorReporter)
 : fSymbolTable(std::move(symbolTable))
@@ -113,14 +190,38 @@ std::unique_ptr<Statement> IRGenerator::convertStatement(const ASTStatement& sta
     }
 }
 
+static bool is_empty_block(const Statement& s) {
+    return s.fKind == Statement::kBlock_Kind && ((Block&) s).fStatements.empty();
+}
+
+static std::unique_ptr<Statement> empty_block(Position position) {
+    return std::unique_ptr<Statement>(new Block(position, 
+                                                std::vector<std::unique_ptr<Statement>>()));
+}
+
 std::unique_ptr<Block> IRGenerator::convertBlock(const ASTBlock& block) {
     AutoSymbolTable table(this);
     std::vector<std::unique_ptr<Statement>> statements;
+    bool reachable = true;
     for (size_t i = 0; i < block.fStatements.size(); i++) {
         std::unique_ptr<Statement> statement = this->convertStatement(*block.fStatements[i]);
         if (!statement) {
             return nullptr;
         }
+        // statements following a jump are still checked for errors, but are never emitted
+        if (!reachable || is_empty_block(*statement)) {
+            continue;
+        }
+        switch (statement->fKind) {
+            case Statement::kBreak_Kind:    // fall through
+            case Statement::kContinue_Kind: // fall through
+            case Statement::kDiscard_Kind:  // fall through
+            case Statement::kReturn_Kind:
+                reachable = false;
+                break;
+            default:
+                break;
+        }
         statements.push_back(std::move(statement));
     }
     return std::unique_ptr<Block>(new Block(block.fPosition, std::move(statements)));
@@ -132,6 +233,10 @@ std::unique_ptr<Statement> IRGenerator::convertVarDeclarationStatement(
     if (!decl) {
         return nullptr;
     }
+    if (decl->fVars.empty()) {
+        // every variable was a constant
+        return empty_block(s.fPosition);
+    }
     return std::unique_ptr<Statement>(new VarDeclarationStatement(std::move(decl)));
 }
 
@@ -183,7 +288,6 @@ std::unique_ptr<VarDeclaration> IRGenerator::convertVarDeclaration(const ASTVarD
         sizes.push_back(std::move(currentVarSizes));
         auto var = std::make_shared<Variable>(decl.fPosition, modifiers, decl.fNames[i], type, 
                                               storage);
-        variables.push_back(var);
         std::unique_ptr<Expression> value;
         if (decl.fValues[i]) {
             value = this->convertExpression(*decl.fValues[i]);
@@ -193,6 +297,13 @@ std::unique_ptr<VarDeclaration> IRGenerator::convertVarDeclaration(const ASTVarD
             value = this->coerce(std::move(value), type);
         }
         fSymbolTable->add(var->fName, var);
+        if (value && is_literal(*value) && (modifiers.fFlags & Modifiers::kConst_Flag)) {
+            // references to the variable become copies of its value, so it needn't exist
+            sizes.pop_back();
+            fConstantValues[var] = std::move(value);
+            continue;
+        }
+        variables.push_back(var);
         values.push_back(std::move(value));
     }
     return std::unique_ptr<VarDeclaration>(new VarDeclaration(decl.fPosition, std::move(variables), 
@@ -215,6 +326,13 @@ std::unique_ptr<Statement> IRGenerator::convertIf(const ASTIfStatement& s) {
             return nullptr;
         }
     }
+    if (test->fKind == Expression::kBoolLiteral_Kind) {
+        // only the branch which will be taken is kept
+        if (((BoolLiteral&) *test).fValue) {
+            return ifTrue;
+        }
+        return ifFalse ? std::move(ifFalse) : empty_block(s.fPosition);
+    }
     return std::unique_ptr<Statement>(new IfStatement(s.fPosition, std::move(test), 
                                                       std::move(ifTrue), std::move(ifFalse)));
 }
@@ -238,6 +356,12 @@ std::unique_ptr<Statement> IRGenerator::convertFor(const ASTForStatement& f) {
     if (!statement) {
         return nullptr;
     }
+    if (test->fKind == Expression::kBoolLiteral_Kind && !((BoolLiteral&) *test).fValue) {
+        // the loop never runs, but the initializer still does
+        std::vector<std::unique_ptr<Statement>> statements;
+        statements.push_back(std::move(initializer));
+        return std::unique_ptr<Statement>(new Block(f.fPosition, std::move(statements)));
+    }
     return std::unique_ptr<Statement>(new ForStatement(f.fPosition, std::move(initializer), 
                                                        std::move(test), std::move(next),
                                                        std::move(statement)));
@@ -252,6 +376,9 @@ std::unique_ptr<Statement> IRGenerator::convertWhile(const ASTWhileStatement& w)
     if (!statement) {
         return nullptr;
     }
+    if (test->fKind == Expression::kBoolLiteral_Kind && !((BoolLiteral&) *test).fValue) {
+        return empty_block(w.fPosition);
+    }
     return std::unique_ptr<Statement>(new WhileStatement(w.fPosition, std::move(test),
                                                          std::move(statement)));
 }
@@ -276,6 +403,10 @@ std::unique_ptr<Statement> IRGenerator::convertExpressionStatement(
         return nullptr;
     }
     this->checkValid(*e);
+    if (is_pure(*e)) {
+        // the result is unused, and computing it has no effect
+        return empty_block(s.fPosition);
+    }
     return std::unique_ptr<Statement>(new ExpressionStatement(std::move(e)));
 }
 
@@ -345,6 +476,70 @@ static void expand_generics(FunctionDeclaration& decl,
     }
 }
 
+/**
+ * Returns the number of times the expression refers to the variable.
+ */
+static int count_references(const Expression& expr, const Variable& var) {
+    switch (expr.fKind) {
+        case Expression::kVariableReference_Kind:
+            return ((const VariableReference&) expr).fVariable.get() == &var ? 1 : 0;
+        case Expression::kBinary_Kind: {
+            const BinaryExpression& b = (const BinaryExpression&) expr;
+            return count_references(*b.fLeft, var) + count_references(*b.fRight, var);
+        }
+        case Expression::kConstructor_Kind: {
+            int result = 0;
+            for (const auto& arg : ((const Constructor&) expr).fArguments) {
+                result += count_references(*arg, var);
+            }
+            return result;
+        }
+        case Expression::kFunctionCall_Kind: {
+            int result = 0;
+            for (const auto& arg : ((const FunctionCall&) expr).fArguments) {
+                result += count_references(*arg, var);
+            }
+            return result;
+        }
+        case Expression::kFieldAccess_Kind:
+            return count_references(*((const FieldAccess&) expr).fBase, var);
+        case Expression::kIndex_Kind:
+            return count_references(*((const IndexExpression&) expr).fBase, var) +
+                   count_references(*((const IndexExpression&) expr).fIndex, var);
+        case Expression::kPrefix_Kind:
+            return count_references(*((const PrefixExpression&) expr).fOperand, var);
+        case Expression::kPostfix_Kind:
+            return count_references(*((const PostfixExpression&) expr).fOperand, var);
+        case Expression::kSwizzle_Kind:
+            return count_references(*((const Swizzle&) expr).fBase, var);
+        case Expression::kTernary_Kind: {
+            const TernaryExpression& t = (const TernaryExpression&) expr;
+            return count_references(*t.fTest, var) + count_references(*t.fIfTrue, var) +
+                   count_references(*t.fIfFalse, var);
+        }
+        default:
+            return 0;
+    }
+}
+
+/**
+ * Returns true if the function's body consists of nothing but a return statement, and none of its
+ * parameters are written to, so that calls to it may be replaced by the returned expression.
+ */
+static bool is_inlinable(const FunctionDeclaration& decl, const Block& body) {
+    if (body.fStatements.size() != 1 || 
+        body.fStatements[0]->fKind != Statement::kReturn_Kind ||
+        !((ReturnStatement&) *body.fStatements[0]).fExpression) {
+        return false;
+    }
+    for (const auto& param : decl.fParameters) {
+        if ((param->fModifiers.fFlags & Modifiers::kOut_Flag) || param->fIsWrittenTo) {
+            return false;
+        }
+    }
+    return true;
+}
+
 std::unique_ptr<FunctionDefinition> IRGenerator::convertFunction(const ASTFunction& f) {
     std::shared_ptr<SymbolTable> old = fSymbolTable;
     AutoSymbolTable table(this);
@@ -456,6 +651,10 @@ std::unique_ptr<FunctionDefinition> IRGenerator::convertFunction(const ASTFuncti
             if (!body) {
                 return nullptr;
             }
+            if (is_inlinable(*decl, *body)) {
+                const Expression& value = *((ReturnStatement&) *body->fStatements[0]).fExpression;
+                fInlineFunctions[decl] = this->copy(value, {});
+            }
             return std::unique_ptr<FunctionDefinition>(new FunctionDefinition(f.fPosition, decl, 
                                                                               std::move(body)));
         }
@@ -562,6 +761,10 @@ std::unique_ptr<Expression> IRGenerator::convertIdentifier(const ASTIdentifier&
         }
         case Symbol::kVariable_Kind: {
             std::shared_ptr<Variable> var = std::static_pointer_cast<Variable>(result);
+            auto constant = fConstantValues.find(var);
+            if (constant != fConstantValues.end()) {
+                return this->copy(*constant->second, {});
+            }
             this->markReadFrom(var);
             return std::unique_ptr<VariableReference>(new VariableReference(identifier.fPosition,
                                                                             std::move(var)));
@@ -724,30 +927,22 @@ std::unique_ptr<Expression> IRGenerator::convertBinaryExpression(
                                             "', '" + right->fType->fName + "'");
         return nullptr;
     }
-    switch (expression.fOperator) {
-        case Token::EQ:           // fall through
-        case Token::PLUSEQ:       // fall through
-        case Token::MINUSEQ:      // fall through
-        case Token::STAREQ:       // fall through
-        case Token::SLASHEQ:      // fall through
-        case Token::PERCENTEQ:    // fall through
-        case Token::SHLEQ:        // fall through
-        case Token::SHREQ:        // fall through
-        case Token::BITWISEOREQ:  // fall through
-        case Token::BITWISEXOREQ: // fall through
-        case Token::BITWISEANDEQ: // fall through
-        case Token::LOGICALOREQ:  // fall through
-        case Token::LOGICALXOREQ: // fall through
-        case Token::LOGICALANDEQ: 
-            this->markWrittenTo(*left);
-        default:
-            break;
+    if (is_assignment(expression.fOperator)) {
+        this->markWrittenTo(*left);
+    }
+    left = this->coerce(std::move(left), leftType);
+    right = this->coerce(std::move(right), rightType);
+    if (!left || !right) {
+        return nullptr;
+    }
+    std::unique_ptr<Expression> folded = this->constantFold(*left, expression.fOperator, *right);
+    if (folded) {
+        return folded;
     }
     return std::unique_ptr<Expression>(new BinaryExpression(expression.fPosition, 
-                                                            this->coerce(std::move(left), leftType), 
+                                                            std::move(left), 
                                                             expression.fOperator, 
-                                                            this->coerce(std::move(right), 
-                                                                         rightType), 
+                                                            std::move(right), 
                                                             resultType));
 }
 
@@ -779,6 +974,10 @@ std::unique_ptr<Expression> IRGenerator::convertTernaryExpression(
     ASSERT(trueType == falseType);
     ifTrue = this->coerce(std::move(ifTrue), trueType);
     ifFalse = this->coerce(std::move(ifFalse), falseType);
+    if (test->fKind == Expression::kBoolLiteral_Kind) {
+        // only the side which will be evaluated is kept
+        return ((BoolLiteral&) *test).fValue ? std::move(ifTrue) : std::move(ifFalse);
+    }
     return std::unique_ptr<Expression>(new TernaryExpression(expression.fPosition, 
                                                              std::move(test),
                                                              std::move(ifTrue), 
@@ -802,14 +1001,292 @@ std::unique_ptr<Expression> IRGenerator::call(
     }
     for (size_t i = 0; i < arguments.size(); i++) {
         arguments[i] = this->coerce(std::move(arguments[i]), function->fParameters[i]->fType);
-        if (arguments[i] && (function->fParameters[i]->fModifiers.fFlags & Modifiers::kOut_Flag)) {
+        if (!arguments[i]) {
+            return nullptr;
+        }
+        if (function->fParameters[i]->fModifiers.fFlags & Modifiers::kOut_Flag) {
             this->markWrittenTo(*arguments[i]);
         }
     }
+    std::unique_ptr<Expression> inlined = this->inlineCall(function, arguments);
+    if (inlined) {
+        return inlined;
+    }
     return std::unique_ptr<FunctionCall>(new FunctionCall(position, std::move(function),
                                                           std::move(arguments)));
 }
 
+std::unique_ptr<Expression> IRGenerator::constantFold(const Expression& left, Token::Kind op,
+                                                      const Expression& right) {
+    // && and || with a literal operand, where skipping the other operand doesn't lose any side
+    // effects
+    if (left.fKind == Expression::kBoolLiteral_Kind) {
+        bool value = ((BoolLiteral&) left).fValue;
+        if ((op == Token::LOGICALAND && value) || (op == Token::LOGICALOR && !value)) {
+            return this->copy(right, {});
+        }
+        if (op == Token::LOGICALAND || op == Token::LOGICALOR) {
+            return std::unique_ptr<Expression>(new BoolLiteral(left.fPosition, value));
+        }
+    }
+    if (right.fKind == Expression::kBoolLiteral_Kind) {
+        bool value = ((BoolLiteral&) right).fValue;
+        if ((op == Token::LOGICALAND && value) || (op == Token::LOGICALOR && !value)) {
+            return this->copy(left, {});
+        }
+    }
+    if (left.fKind != right.fKind) {
+        return nullptr;
+    }
+    #define RESULT(t, op) std::unique_ptr<Expression>(new t ## Literal(left.fPosition, \
+                                                                       leftVal op rightVal))
+    switch (left.fKind) {
+        case Expression::kBoolLiteral_Kind: {
+            bool leftVal = ((BoolLiteral&) left).fValue;
+            bool rightVal = ((BoolLiteral&) right).fValue;
+            switch (op) {
+                case Token::LOGICALXOR: return RESULT(Bool, !=);
+                case Token::EQEQ:       return RESULT(Bool, ==);
+                case Token::NEQ:        return RESULT(Bool, !=);
+                default:                return nullptr;
+            }
+        }
+        case Expression::kIntLiteral_Kind: {
+            int32_t leftVal = (int32_t) ((IntLiteral&) left).fValue;
+            int32_t rightVal = (int32_t) ((IntLiteral&) right).fValue;
+            // ints wrap around on overflow, which signed C++ arithmetic does not
+            uint32_t leftBits = (uint32_t) leftVal;
+            uint32_t rightBits = (uint32_t) rightVal;
+            switch (op) {
+                case Token::PLUS:       return std::unique_ptr<Expression>(new IntLiteral(
+                                                   left.fPosition, (int32_t) (leftBits + rightBits)));
+                case Token::MINUS:      return std::unique_ptr<Expression>(new IntLiteral(
+                                                   left.fPosition, (int32_t) (leftBits - rightBits)));
+                case Token::STAR:       return std::unique_ptr<Expression>(new IntLiteral(
+                                                   left.fPosition, (int32_t) (leftBits * rightBits)));
+                case Token::SLASH:
+                    if (rightVal == 0 || (leftVal == INT_MIN && rightVal == -1)) {
+                        return nullptr;
+                    }
+                    return RESULT(Int, /);
+                case Token::PERCENT:
+                    if (rightVal == 0 || (leftVal == INT_MIN && rightVal == -1)) {
+                        return nullptr;
+                    }
+                    return RESULT(Int, %);
+                case Token::BITWISEAND: return RESULT(Int, &);
+                case Token::BITWISEOR:  return RESULT(Int, |);
+                case Token::BITWISEXOR: return RESULT(Int, ^);
+                case Token::SHL:
+                    if (rightVal < 0 || rightVal > 31) {
+                        return nullptr;
+                    }
+                    return std::unique_ptr<Expression>(new IntLiteral(left.fPosition, 
+                                                                      (int32_t) (leftBits << 
+                                                                                 rightVal)));
+                case Token::SHR:
+                    if (rightVal < 0 || rightVal > 31) {
+                        return nullptr;
+                    }
+                    return RESULT(Int, >>);
+                case Token::EQEQ:       return RESULT(Bool, ==);
+                case Token::NEQ:        return RESULT(Bool, !=);
+                case Token::GT:         return RESULT(Bool, >);
+                case Token::GTEQ:       return RESULT(Bool, >=);
+                case Token::LT:         return RESULT(Bool, <);
+                case Token::LTEQ:       return RESULT(Bool, <=);
+                default:                return nullptr;
+            }
+        }
+        case Expression::kFloatLiteral_Kind: {
+            double leftVal = ((FloatLiteral&) left).fValue;
+            double rightVal = ((FloatLiteral&) right).fValue;
+            switch (op) {
+                case Token::PLUS:       return RESULT(Float, +);
+                case Token::MINUS:      return RESULT(Float, -);
+                case Token::STAR:       return RESULT(Float, *);
+                case Token::SLASH:
+                    if (rightVal == 0) {
+                        return nullptr;
+                    }
+                    return RESULT(Float, /);
+                case Token::EQEQ:       return RESULT(Bool, ==);
+                case Token::NEQ:        return RESULT(Bool, !=);
+                case Token::GT:         return RESULT(Bool, >);
+                case Token::GTEQ:       return RESULT(Bool, >=);
+                case Token::LT:         return RESULT(Bool, <);
+                case Token::LTEQ:       return RESULT(Bool, <=);
+                default:                return nullptr;
+            }
+        }
+        default:
+            return nullptr;
+    }
+    #undef RESULT
+}
+
+std::unique_ptr<Expression> IRGenerator::copy(
+                            const Expression& expr,
+                            const std::unordered_map<const Variable*, const Expression*>& substitutions) {
+    switch (expr.fKind) {
+        case Expression::kBoolLiteral_Kind:
+            return std::unique_ptr<Expression>(new BoolLiteral(expr.fPosition, 
+                                                               ((BoolLiteral&) expr).fValue));
+        case Expression::kIntLiteral_Kind:
+            return std::unique_ptr<Expression>(new IntLiteral(expr.fPosition, 
+                                                              ((IntLiteral&) expr).fValue));
+        case Expression::kFloatLiteral_Kind:
+            return std::unique_ptr<Expression>(new FloatLiteral(expr.fPosition, 
+                                                                ((FloatLiteral&) expr).fValue));
+        case Expression::kVariableReference_Kind: {
+            const std::shared_ptr<Variable>& var = ((VariableReference&) expr).fVariable;
+            auto found = substitutions.find(var.get());
+            if (found != substitutions.end()) {
+                return this->copy(*found->second, {});
+            }
+            return std::unique_ptr<Expression>(new VariableReference(expr.fPosition, var));
+        }
+        case Expression::kBinary_Kind: {
+            const BinaryExpression& b = (BinaryExpression&) expr;
+            std::unique_ptr<Expression> left = this->copy(*b.fLeft, substitutions);
+            std::unique_ptr<Expression> right = this->copy(*b.fRight, substitutions);
+            if (!left || !right) {
+                return nullptr;
+            }
+            std::unique_ptr<Expression> folded = this->constantFold(*left, b.fOperator, *right);
+            if (folded) {
+                return folded;
+            }
+            return std::unique_ptr<Expression>(new BinaryExpression(expr.fPosition, 
+                                                                    std::move(left), 
+                                                                    b.fOperator, 
+                                                                    std::move(right), 
+                                                                    expr.fType));
+        }
+        case Expression::kPrefix_Kind: {
+            const PrefixExpression& p = (PrefixExpression&) expr;
+            std::unique_ptr<Expression> operand = this->copy(*p.fOperand, substitutions);
+            if (!operand) {
+                return nullptr;
+            }
+            if (p.fOperator == Token::MINUS && operand->fKind == Expression::kIntLiteral_Kind) {
+                return std::unique_ptr<Expression>(new IntLiteral(
+                                                            expr.fPosition, 
+                                                            -((IntLiteral&) *operand).fValue));
+            }
+            if (p.fOperator == Token::MINUS && operand->fKind == Expression::kFloatLiteral_Kind) {
+                return std::unique_ptr<Expression>(new FloatLiteral(
+                                                            expr.fPosition, 
+                                                            -((FloatLiteral&) *operand).fValue));
+            }
+            if (p.fOperator == Token::NOT && operand->fKind == Expression::kBoolLiteral_Kind) {
+                return std::unique_ptr<Expression>(new BoolLiteral(
+                                                            expr.fPosition, 
+                                                            !((BoolLiteral&) *operand).fValue));
+            }
+            return std::unique_ptr<Expression>(new PrefixExpression(p.fOperator, 
+                                                                    std::move(operand)));
+        }
+        case Expression::kConstructor_Kind: {
+            std::vector<std::unique_ptr<Expression>> args;
+            for (const auto& arg : ((Constructor&) expr).fArguments) {
+                args.push_back(this->copy(*arg, substitutions));
+                if (!args.back()) {
+                    return nullptr;
+                }
+            }
+            return std::unique_ptr<Expression>(new Constructor(expr.fPosition, expr.fType, 
+                                                               std::move(args)));
+        }
+        case Expression::kFunctionCall_Kind: {
+            const FunctionCall& c = (FunctionCall&) expr;
+            std::vector<std::unique_ptr<Expression>> args;
+            for (const auto& arg : c.fArguments) {
+                args.push_back(this->copy(*arg, substitutions));
+                if (!args.back()) {
+                    return nullptr;
+                }
+            }
+            return std::unique_ptr<Expression>(new FunctionCall(expr.fPosition, c.fFunction, 
+                                                                std::move(args)));
+        }
+        case Expression::kSwizzle_Kind: {
+            const Swizzle& s = (Swizzle&) expr;
+            std::unique_ptr<Expression> base = this->copy(*s.fBase, substitutions);
+            if (!base) {
+                return nullptr;
+            }
+            return std::unique_ptr<Expression>(new Swizzle(std::move(base), s.fComponents));
+        }
+        case Expression::kFieldAccess_Kind: {
+            const FieldAccess& f = (FieldAccess&) expr;
+            std::unique_ptr<Expression> base = this->copy(*f.fBase, substitutions);
+            if (!base) {
+                return nullptr;
+            }
+            return std::unique_ptr<Expression>(new FieldAccess(std::move(base), f.fFieldIndex));
+        }
+        case Expression::kIndex_Kind: {
+            const IndexExpression& i = (IndexExpression&) expr;
+            std::unique_ptr<Expression> base = this->copy(*i.fBase, substitutions);
+            std::unique_ptr<Expression> index = this->copy(*i.fIndex, substitutions);
+            if (!base || !index) {
+                return nullptr;
+            }
+            return std::unique_ptr<Expression>(new IndexExpression(std::move(base), 
+                                                                   std::move(index)));
+        }
+        case Expression::kTernary_Kind: {
+            const TernaryExpression& t = (TernaryExpression&) expr;
+            std::unique_ptr<Expression> test = this->copy(*t.fTest, substitutions);
+            std::unique_ptr<Expression> ifTrue = this->copy(*t.fIfTrue, substitutions);
+            std::unique_ptr<Expression> ifFalse = this->copy(*t.fIfFalse, substitutions);
+            if (!test || !ifTrue || !ifFalse) {
+                return nullptr;
+            }
+            if (test->fKind == Expression::kBoolLiteral_Kind) {
+                return ((BoolLiteral&) *test).fValue ? std::move(ifTrue) : std::move(ifFalse);
+            }
+            return std::unique_ptr<Expression>(new TernaryExpression(expr.fPosition, 
+                                                                     std::move(test),
+                                                                     std::move(ifTrue), 
+                                                                     std::move(ifFalse)));
+        }
+        default:
+            // anything else (assignments through postfix operators, for instance) is not copied,
+            // which also keeps the function containing it from being inlined
+            return nullptr;
+    }
+}
+
+/**
+ * Replaces a call to a function whose body is a single return statement with the returned
+ * expression. Each argument must be free of side effects, and unless it is trivial to evaluate it
+ * may only be used once, so that inlining neither changes behavior nor duplicates work.
+ */
+std::unique_ptr<Expression> IRGenerator::inlineCall(
+                                      std::shared_ptr<FunctionDeclaration> function,
+                                      const std::vector<std::unique_ptr<Expression>>& args) {
+    auto found = fInlineFunctions.find(function);
+    if (found == fInlineFunctions.end()) {
+        return nullptr;
+    }
+    const Expression& body = *found->second;
+    std::unordered_map<const Variable*, const Expression*> substitutions;
+    for (size_t i = 0; i < args.size(); i++) {
+        const Variable& param = *function->fParameters[i];
+        if (!is_pure(*args[i])) {
+            return nullptr;
+        }
+        if (!is_literal(*args[i]) && args[i]->fKind != Expression::kVariableReference_Kind &&
+            count_references(body, param) > 1) {
+            return nullptr;
+        }
+        substitutions[&param] = args[i].get();
+    }
+    return this->copy(body, substitutions);
+}
+
 /**
  * Determines the cost of coercing the arguments of a function to the required types. Returns true 
  * if the cost could be computed, false if the call is not valid. Cost has no particular meaning 
@@ -1002,6 +1479,10 @@ std::unique_ptr<Expression> IRGenerator::convertPrefixExpression(
                               "' cannot operate on '" + base->fType->description() + "'");
                 return nullptr;
             }
+            if (base->fKind == Expression::kBoolLiteral_Kind) {
+                return std::unique_ptr<Expression>(new BoolLiteral(base->fPosition,
+                                                                   !((BoolLiteral&) *base).fValue));
+            }
             break;
         default: 
             ABORT("unsupported prefix operator\n");
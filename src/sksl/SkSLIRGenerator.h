@@ -8,6 +8,8 @@
 #ifndef SKSL_IRGENERATOR
 #define SKSL_IRGENERATOR
 
+#include <unordered_map>
+
 #include "SkSLErrorReporter.h"
 #include "ast/SkSLASTBinaryExpression.h"
 #include "ast/SkSLASTBlock.h"
@@ -49,7 +51,11 @@ namespace SkSL {
 
 /**
  * Performs semantic analysis on an abstract syntax tree (AST) and produces the corresponding 
- * (unoptimized) intermediate representation (IR).
+ * intermediate representation (IR).
+ *
+ * The IR is optimized as it is built: constant expressions are folded, const variables with literal
+ * values are replaced by those values, branches on constants and unreachable statements are dropped,
+ * and calls to functions whose bodies are a single return statement are inlined.
  */
 class IRGenerator {
 public:
@@ -105,11 +111,24 @@ private:
     std::unique_ptr<Statement> convertVarDeclarationStatement(const ASTVarDeclarationStatement& s);
     std::unique_ptr<Statement> convertWhile(const ASTWhileStatement& w);
 
+    std::unique_ptr<Expression> constantFold(const Expression& left, Token::Kind op,
+                                             const Expression& right);
+    std::unique_ptr<Expression> inlineCall(std::shared_ptr<FunctionDeclaration> function,
+                                           const std::vector<std::unique_ptr<Expression>>& args);
+    std::unique_ptr<Expression> copy(const Expression& expr,
+                                     const std::unordered_map<const Variable*,
+                                                              const Expression*>& substitutions);
+
     void checkValid(const Expression& expr);
     void markReadFrom(std::shared_ptr<Variable> var);
     void markWrittenTo(const Expression& expr);
 
     std::shared_ptr<FunctionDeclaration> fCurrentFunction;
+    // literal values of const variables, which replace references to them
+    std::unordered_map<std::shared_ptr<Variable>, std::unique_ptr<Expression>> fConstantValues;
+    // returned expressions of functions which are simple enough to inline
+    std::unordered_map<std::shared_ptr<FunctionDeclaration>, 
+                       std::unique_ptr<Expression>> fInlineFunctions;
     std::shared_ptr<SymbolTable> fSymbolTable;
     ErrorReporter& fErrors;
 
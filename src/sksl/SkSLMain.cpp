@@ -14,7 +14,8 @@
  */
 int main(int argc, const char** argv) {
     if (argc != 3) {
-        printf("usage: skslc <input> <output>\n");
+        printf("usage: skslc <input> <output>\n"
+               "output is GLSL if its filename ends in '.glsl', SPIR-V otherwise\n");
         exit(1);
     }
     SkSL::Program::Kind kind;
@@ -37,7 +38,14 @@ int main(int argc, const char** argv) {
     }
     std::ofstream out(argv[2], std::ofstream::binary);
     SkSL::Compiler compiler;
-    if (!compiler.toSPIRV(kind, text, out)) {
+    len = strlen(argv[2]);
+    bool result;
+    if (len > 5 && !strcmp(argv[2] + len - 5, ".glsl")) {
+        result = compiler.toGLSL(kind, text, { 400, SkSL::GLCaps::kGL_Standard }, out);
+    } else {
+        result = compiler.toSPIRV(kind, text, out);
+    }
+    if (!result) {
         printf("%s", compiler.errorText().c_str());
         exit(3);
     }
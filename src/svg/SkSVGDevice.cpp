@@ -244,29 +244,55 @@ private:
 
 }
 
-// For now all this does is serve unique serial IDs, but it will eventually evolve to track
-// and deduplicate resources.
+// Serves the IDs of the resources written to <defs>, and remembers them so that each one is
+// written only once and shared by every draw that uses it.
 class SkSVGDevice::ResourceBucket : ::SkNoncopyable {
 public:
     ResourceBucket() : fGradientCount(0), fClipCount(0), fPathCount(0), fImageCount(0) {}
 
-    SkString addLinearGradient() {
-        return SkStringPrintf("gradient_%d", fGradientCount++);
+    // Each of these finds the ID of the resource with the given key and returns true if it has
+    // already been written.  If not, it gives the resource a new ID and returns false, and the
+    // caller must write it.
+    bool findOrAddLinearGradient(const SkString& key, SkString* id) {
+        return FindOrAdd(&fGradients, key, "gradient", &fGradientCount, id);
     }
 
-    SkString addClip() {
-        return SkStringPrintf("clip_%d", fClipCount++);
+    bool findOrAddClip(const SkString& key, SkString* id) {
+        return FindOrAdd(&fClips, key, "clip", &fClipCount, id);
     }
 
-    SkString addPath() {
-        return SkStringPrintf("path_%d", fPathCount++);
+    bool findOrAddPath(uint32_t genID, SkString* id) {
+        return FindOrAdd(&fPaths, genID, "path", &fPathCount, id);
     }
 
-    SkString addImage() {
-        return SkStringPrintf("img_%d", fImageCount++);
+    bool findOrAddImage(const SkString& key, SkString* id) {
+        return FindOrAdd(&fImages, key, "img", &fImageCount, id);
     }
 
+    // Clips are looked up by their clip stack's generation ID first, which spares building the
+    // key for draws made under the same clip.
+    const SkString* findClip(int32_t clipGenID) const { return fClipsByGenID.find(clipGenID); }
+    void setClip(int32_t clipGenID, const SkString& id) { fClipsByGenID.set(clipGenID, id); }
+
 private:
+    template <typename K>
+    static bool FindOrAdd(SkTHashMap<K, SkString>* ids, const K& key, const char prefix[],
+                          uint32_t* count, SkString* id) {
+        if (const SkString* found = ids->find(key)) {
+            *id = *found;
+            return true;
+        }
+        id->printf("%s_%u", prefix, (*count)++);
+        ids->set(key, *id);
+        return false;
+    }
+
+    SkTHashMap<SkString, SkString> fGradients;
+    SkTHashMap<SkString, SkString> fClips;
+    SkTHashMap<int32_t, SkString>  fClipsByGenID;
+    SkTHashMap<uint32_t, SkString> fPaths;
+    SkTHashMap<SkString, SkString> fImages;
+
     uint32_t fGradientCount;
     uint32_t fClipCount;
     uint32_t fPathCount;
@@ -393,20 +419,12 @@ void SkSVGDevice::AutoElement::addPaint(const SkPaint& paint, const Resources& r
 Resources SkSVGDevice::AutoElement::addResources(const SkDraw& draw, const SkPaint& paint) {
     Resources resources(paint);
 
-    // FIXME: this is a weak heuristic and we end up with LOTS of redundant clips.
-    bool hasClip   = !draw.fClipStack->isWideOpen();
-    bool hasShader = SkToBool(paint.getShader());
-
-    if (hasClip || hasShader) {
-        AutoElement defs("defs", fWriter);
-
-        if (hasClip) {
-            this->addClipResources(draw, &resources);
-        }
+    if (!draw.fClipStack->isWideOpen()) {
+        this->addClipResources(draw, &resources);
+    }
 
-        if (hasShader) {
-            this->addShaderResources(paint, &resources);
-        }
+    if (paint.getShader()) {
+        this->addShaderResources(paint, &resources);
     }
 
     return resources;
@@ -440,29 +458,48 @@ void SkSVGDevice::AutoElement::addShaderResources(const SkPaint& paint, Resource
 void SkSVGDevice::AutoElement::addClipResources(const SkDraw& draw, Resources* resources) {
     SkASSERT(!draw.fClipStack->isWideOpen());
 
+    const int32_t clipGenID = draw.fClipStack->getTopmostGenID();
+    if (const SkString* clipID = fResourceBucket->findClip(clipGenID)) {
+        resources->fClip.printf("url(#%s)", clipID->c_str());
+        return;
+    }
+
     SkPath clipPath;
     (void) draw.fClipStack->asPath(&clipPath);
 
-    SkString clipID = fResourceBucket->addClip();
+    // The clip is keyed by what we'd write for it: its rect or path data, and its fill rule.
     const char* clipRule = clipPath.getFillType() == SkPath::kEvenOdd_FillType ?
                            "evenodd" : "nonzero";
-    {
+    SkRect clipRect = SkRect::MakeEmpty();
+    const bool isRect = clipPath.isEmpty() || clipPath.isRect(&clipRect);
+    SkString key(clipRule);
+    if (isRect) {
+        key.append(reinterpret_cast<const char*>(&clipRect), sizeof(clipRect));
+    } else {
+        SkString pathData;
+        SkParsePath::ToSVGString(clipPath, &pathData);
+        key.append(pathData);
+    }
+
+    SkString clipID;
+    if (!fResourceBucket->findOrAddClip(key, &clipID)) {
         // clipPath is in device space, but since we're only pushing transform attributes
         // to the leaf nodes, so are all our elements => SVG userSpaceOnUse == device space.
+        AutoElement defs("defs", fWriter);
         AutoElement clipPathElement("clipPath", fWriter);
         clipPathElement.addAttribute("id", clipID);
 
-        SkRect clipRect = SkRect::MakeEmpty();
-        if (clipPath.isEmpty() || clipPath.isRect(&clipRect)) {
+        if (isRect) {
             AutoElement rectElement("rect", fWriter);
             rectElement.addRectAttributes(clipRect);
             rectElement.addAttribute("clip-rule", clipRule);
         } else {
             AutoElement pathElement("path", fWriter);
-            pathElement.addPathAttributes(clipPath);
+            pathElement.addAttribute("d", key.c_str() + strlen(clipRule));
             pathElement.addAttribute("clip-rule", clipRule);
         }
     }
+    fResourceBucket->setClip(clipGenID, clipID);
 
     resources->fClip.printf("url(#%s)", clipID.c_str());
 }
@@ -470,9 +507,25 @@ void SkSVGDevice::AutoElement::addClipResources(const SkDraw& draw, Resources* r
 SkString SkSVGDevice::AutoElement::addLinearGradientDef(const SkShader::GradientInfo& info,
                                                         const SkShader* shader) {
     SkASSERT(fResourceBucket);
-    SkString id = fResourceBucket->addLinearGradient();
+
+    // Gradients are keyed by everything we write for them.
+    const SkMatrix& localMatrix = shader->getLocalMatrix();
+    SkScalar matrix[9];
+    localMatrix.get9(matrix);
+    SkString key;
+    key.append(reinterpret_cast<const char*>(info.fPoint), 2 * sizeof(SkPoint));
+    key.append(reinterpret_cast<const char*>(matrix), sizeof(matrix));
+    key.append(reinterpret_cast<const char*>(info.fColors), info.fColorCount * sizeof(SkColor));
+    key.append(reinterpret_cast<const char*>(info.fColorOffsets),
+               info.fColorCount * sizeof(SkScalar));
+
+    SkString id;
+    if (fResourceBucket->findOrAddLinearGradient(key, &id)) {
+        return id;
+    }
 
     {
+        AutoElement defs("defs", fWriter);
         AutoElement gradient("linearGradient", fWriter);
 
         gradient.addAttribute("id", id);
@@ -482,8 +535,8 @@ SkString SkSVGDevice::AutoElement::addLinearGradientDef(const SkShader::Gradient
         gradient.addAttribute("x2", info.fPoint[1].x());
         gradient.addAttribute("y2", info.fPoint[1].y());
 
-        if (!shader->getLocalMatrix().isIdentity()) {
-            this->addAttribute("gradientTransform", svg_transform(shader->getLocalMatrix()));
+        if (!localMatrix.isIdentity()) {
+            gradient.addAttribute("gradientTransform", svg_transform(localMatrix));
         }
 
         SkASSERT(info.fColorCount >= 2);
@@ -664,28 +717,38 @@ void SkSVGDevice::drawPath(const SkDraw& draw, const SkPath& path, const SkPaint
 
 void SkSVGDevice::drawBitmapCommon(const SkDraw& draw, const SkBitmap& bm,
                                    const SkPaint& paint) {
-    SkAutoTUnref<const SkData> pngData(
-        SkImageEncoder::EncodeData(bm, SkImageEncoder::kPNG_Type, SkImageEncoder::kDefaultQuality));
-    if (!pngData) {
-        return;
-    }
-
-    size_t b64Size = SkBase64::Encode(pngData->data(), pngData->size(), nullptr);
-    SkAutoTMalloc<char> b64Data(b64Size);
-    SkBase64::Encode(pngData->data(), pngData->size(), b64Data.get());
+    // Bitmaps are keyed by their pixels: the pixel ref's generation ID, and the subset of it.
+    const SkIPoint origin = bm.pixelRefOrigin();
+    const uint32_t key[] = {
+        bm.getGenerationID(), (uint32_t)origin.x(), (uint32_t)origin.y(),
+        (uint32_t)bm.width(), (uint32_t)bm.height(),
+    };
+
+    SkString imageID;
+    if (!fResourceBucket->findOrAddImage(SkString(reinterpret_cast<const char*>(key),
+                                                  sizeof(key)), &imageID)) {
+        SkAutoTUnref<const SkData> pngData(
+            SkImageEncoder::EncodeData(bm, SkImageEncoder::kPNG_Type,
+                                       SkImageEncoder::kDefaultQuality));
+        if (!pngData) {
+            return;
+        }
 
-    SkString svgImageData("data:image/png;base64,");
-    svgImageData.append(b64Data.get(), b64Size);
+        // Base64 encode straight into the attribute value, after its prefix.
+        static const char kPrefix[] = "data:image/png;base64,";
+        const size_t prefixSize = sizeof(kPrefix) - 1;
+        size_t b64Size = SkBase64::Encode(pngData->data(), pngData->size(), nullptr);
+        SkAutoTMalloc<char> svgImageData(prefixSize + b64Size);
+        memcpy(svgImageData.get(), kPrefix, prefixSize);
+        SkBase64::Encode(pngData->data(), pngData->size(), svgImageData.get() + prefixSize);
 
-    SkString imageID = fResourceBucket->addImage();
-    {
         AutoElement defs("defs", fWriter);
         {
             AutoElement image("image", fWriter);
             image.addAttribute("id", imageID);
             image.addAttribute("width", bm.width());
             image.addAttribute("height", bm.height());
-            image.addAttribute("xlink:href", svgImageData);
+            fWriter->addAttributeLen("xlink:href", svgImageData.get(), prefixSize + b64Size);
         }
     }
 
@@ -767,14 +830,12 @@ void SkSVGDevice::drawPosText(const SkDraw& draw, const void* text, size_t len,
 
 void SkSVGDevice::drawTextOnPath(const SkDraw&, const void* text, size_t len, const SkPath& path,
                                  const SkMatrix* matrix, const SkPaint& paint) {
-    SkString pathID = fResourceBucket->addPath();
-
-    {
+    SkString pathID;
+    if (!fResourceBucket->findOrAddPath(path.getGenerationID(), &pathID)) {
         AutoElement defs("defs", fWriter);
         AutoElement pathElement("path", fWriter);
         pathElement.addAttribute("id", pathID);
         pathElement.addPathAttributes(path);
-
     }
 
     {
@@ -72,7 +72,8 @@ int SkSVGParser::findAttribute(SkSVGBase* element, const char* attrValue,
     while (result < count) {
         if (strncmp(attributes->fName, attrValue, len) == 0 && strlen(attributes->fName) == len) {
             SkASSERT(result == (attributes->fOffset -
-                (isPaint ? sizeof(SkString) : sizeof(SkSVGElement))) / sizeof(SkString));
+                (isPaint ? SK_OFFSETOF(SkSVGPaint, f_clipPath) : sizeof(SkSVGElement))) /
+                    sizeof(SkString));
             return result;
         }
         attributes++;
@@ -81,8 +82,7 @@ int SkSVGParser::findAttribute(SkSVGBase* element, const char* attrValue,
     return -1;
 }
 
-#if 0
-const char* SkSVGParser::getFinal() {
+sk_sp<SkData> SkSVGParser::getFinal() {
     _startElement("screenplay");
     // generate defs
     SkSVGElement** ptr;
@@ -103,10 +103,9 @@ const char* SkSVGParser::getFinal() {
     _endElement(); // event
     _endElement(); // screenplay
     Delete(fChildren);
-    fStream.write("", 1);
-    return fStream.getStream();
+    fChildren.reset();
+    return sk_sp<SkData>(fStream.copyToData());
 }
-#endif
 
 SkString& SkSVGParser::getPaintLast(SkSVGPaint::Field field) {
     SkSVGPaint* state = fHead;
@@ -0,0 +1,65 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkSVGPicture.h"
+#include "SkAnimator.h"
+#include "SkBBHFactory.h"
+#include "SkCanvas.h"
+#include "SkData.h"
+#include "SkPictureRecorder.h"
+#include "SkSVGParser.h"
+
+std::unique_ptr<SkSVGPicture> SkSVGPicture::Make(SkStream* stream, const SkSize& size) {
+    if (!stream || size.isEmpty()) {
+        return nullptr;
+    }
+
+    SkSVGParser parser;
+    if (!parser.parse(*stream)) {
+        return nullptr;
+    }
+
+    sk_sp<SkData> translated(parser.getFinal());
+    std::unique_ptr<SkAnimator> animator(new SkAnimator);
+    if (!animator->decodeMemory(translated->data(), translated->size())) {
+        return nullptr;
+    }
+
+    return std::unique_ptr<SkSVGPicture>(new SkSVGPicture(std::move(animator), size));
+}
+
+SkSVGPicture::SkSVGPicture(std::unique_ptr<SkAnimator> animator, const SkSize& size)
+    : fAnimator(std::move(animator))
+    , fSize(size) {}
+
+SkSVGPicture::~SkSVGPicture() {}
+
+sk_sp<SkPicture> SkSVGPicture::picture() {
+    if (!fPicture) {
+        SkRTreeFactory factory;
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(SkRect::MakeSize(fSize), &factory);
+        fAnimator->draw(canvas, 0);
+        fPicture = recorder.finishRecordingAsPicture();
+    }
+    return fPicture;
+}
+
+void SkSVGPicture::draw(SkCanvas* canvas, const SkRect& dst) {
+    const SkMatrix matrix = SkMatrix::MakeRectToRect(SkRect::MakeSize(fSize), dst,
+                                                     SkMatrix::kFill_ScaleToFit);
+    canvas->drawPicture(this->picture(), &matrix, nullptr);
+}
+
+bool SkSVGPicture::setAttribute(const char elementID[], const char attribute[],
+                                const char value[]) {
+    if (!fAnimator->setString(elementID, attribute, value)) {
+        return false;
+    }
+    fPicture.reset();
+    return true;
+}
@@ -8,6 +8,7 @@
 #include "SkDashPathPriv.h"
 #include "SkPathMeasure.h"
 #include "SkStrokeRec.h"
+#include "SkTDArray.h"
 
 static inline int is_even(int x) {
     return !(x & 1);
@@ -144,6 +145,118 @@ static bool cull_path(const SkPath& srcPath, const SkStrokeRec& rec,
     return true;
 }
 
+// Culls polylines that cull_path() can't: for each contour of a line-only path, finds the
+// stretches of distance that pass near the cull rect, so that dashes elsewhere can
+// be skipped a whole interval length at a time (keeping the visible ones in phase). Contours
+// are walked the same way SkPathMeasure walks them, so their lengths line up.
+class VisibleRanges {
+public:
+    bool init(const SkPath& src, const SkStrokeRec& rec, const SkRect* cullRect) {
+        if (nullptr == cullRect || SkPath::kLine_SegmentMask != src.getSegmentMasks()) {
+            return false;
+        }
+        fBounds = *cullRect;
+        outset_for_stroke(&fBounds, rec);
+        // Leave room for antialiasing and for rounding in the distances we compute.
+        fBounds.outset(SK_Scalar1, SK_Scalar1);
+        fIter.setPath(src, false);
+        fFirstMoveTo = true;
+        return true;
+    }
+
+    // Measures the next contour, returning its length.
+    SkScalar nextContour() {
+        fRanges.rewind();
+        fRangeIndex = 0;
+        fVisibleLength = 0;
+
+        SkPoint  pts[4];
+        SkScalar distance = 0;
+        bool     done = false;
+        do {
+            switch (fIter.next(pts)) {
+                case SkPath::kMove_Verb:
+                    if (!fFirstMoveTo) {
+                        done = true;
+                    }
+                    fFirstMoveTo = false;
+                    break;
+                case SkPath::kLine_Verb: {
+                    SkScalar prevD = distance;
+                    SkScalar d = SkPoint::Distance(pts[0], pts[1]);
+                    distance += d;
+                    SkScalar t0, t1;
+                    if (distance > prevD && this->clipToBounds(pts, &t0, &t1)) {
+                        this->addRange(prevD + t0 * d, SkTMin(prevD + t1 * d, distance));
+                    }
+                } break;
+                case SkPath::kDone_Verb:
+                    done = true;
+                    break;
+                default:
+                    break;
+            }
+        } while (!done);
+        return distance;
+    }
+
+    SkScalar visibleLength() const { return fVisibleLength; }
+
+    // Returns the start of the first visible stretch that ends after distance, or a negative
+    // number if there are none left. Calls must not go backwards.
+    double nextVisible(double distance) {
+        while (fRangeIndex < fRanges.count() && fRanges[fRangeIndex].fEnd <= distance) {
+            ++fRangeIndex;
+        }
+        return fRangeIndex < fRanges.count() ? fRanges[fRangeIndex].fStart : -1;
+    }
+
+private:
+    struct Range {
+        SkScalar fStart, fEnd;
+    };
+
+    // Finds the part [t0, t1] of the line that lies within fBounds, returning false if none does.
+    bool clipToBounds(const SkPoint pts[2], SkScalar* t0, SkScalar* t1) const {
+        SkVector delta = pts[1] - pts[0];
+        const SkScalar p[4] = { -delta.fX, delta.fX, -delta.fY, delta.fY };
+        const SkScalar q[4] = { pts[0].fX - fBounds.fLeft, fBounds.fRight - pts[0].fX,
+                                pts[0].fY - fBounds.fTop, fBounds.fBottom - pts[0].fY };
+        *t0 = 0;
+        *t1 = 1;
+        for (int i = 0; i < 4; ++i) {
+            if (0 == p[i]) {
+                if (q[i] < 0) {
+                    return false;
+                }
+            } else if (p[i] < 0) {
+                *t0 = SkTMax(*t0, q[i] / p[i]);
+            } else {
+                *t1 = SkTMin(*t1, q[i] / p[i]);
+            }
+        }
+        return *t0 <= *t1;
+    }
+
+    void addRange(SkScalar start, SkScalar end) {
+        fVisibleLength += end - start;
+        if (fRanges.count() && fRanges.top().fEnd >= start) {
+            fRanges.top().fEnd = end;
+        } else {
+            Range* range = fRanges.append();
+            range->fStart = start;
+            range->fEnd = end;
+        }
+    }
+
+    SkRect            fBounds;
+    SkPath::Iter      fIter;
+    bool              fFirstMoveTo;
+    SkTDArray<Range>  fRanges;
+    int               fRangeIndex;
+    SkScalar          fVisibleLength;
+};
+
 class SpecialLineRec {
 public:
     bool init(const SkPath& src, SkPath* dst, SkStrokeRec* rec,
@@ -231,8 +344,12 @@ bool SkDashPath::InternalFilter(SkPath* dst, const SkPath& src, SkStrokeRec* rec
 
     SkPath cullPathStorage;
     const SkPath* srcPtr = &src;
+    VisibleRanges visibleRanges;
+    bool cullRanges = false;
     if (cull_path(src, *rec, cullRect, intervalLength, &cullPathStorage)) {
         srcPtr = &cullPathStorage;
+    } else {
+        cullRanges = visibleRanges.init(src, *rec, cullRect);
     }
 
     SpecialLineRec lineRec;
@@ -247,6 +364,9 @@ bool SkDashPath::InternalFilter(SkPath* dst, const SkPath& src, SkStrokeRec* rec
         SkScalar    length = meas.getLength();
         int         index = initialDashIndex;
 
+        // If we ever lose track of the measured contours, stop culling rather than guess.
+        cullRanges = cullRanges && visibleRanges.nextContour() == length;
+
         // Since the path length / dash length ratio may be arbitrarily large, we can exert
         // significant memory pressure while attempting to build the filtered path. To avoid this,
         // we simply give up dashing beyond a certain threshold.
@@ -256,7 +376,8 @@ bool SkDashPath::InternalFilter(SkPath* dst, const SkPath& src, SkStrokeRec* rec
         // segments seems reasonable: at 2 verbs per segment * 9 bytes per verb, this caps the
         // maximum dash memory overhead at roughly 17MB per path.
         static const SkScalar kMaxDashCount = 1000000;
-        dashCount += length * (count >> 1) / intervalLength;
+        SkScalar dashedLength = cullRanges ? visibleRanges.visibleLength() : length;
+        dashCount += dashedLength * (count >> 1) / intervalLength;
         if (dashCount > kMaxDashCount) {
             dst->reset();
             return false;
@@ -270,6 +391,19 @@ bool SkDashPath::InternalFilter(SkPath* dst, const SkPath& src, SkStrokeRec* rec
         while (distance < length) {
             SkASSERT(dlen >= 0);
             addedSegment = false;
+
+            if (cullRanges) {
+                // Skip whole intervals that end before the next visible stretch.
+                double visible = visibleRanges.nextVisible(distance);
+                if (visible < 0) {
+                    break;
+                }
+                if (visible - distance >= intervalLength) {
+                    distance += floor((visible - distance) / intervalLength) * intervalLength;
+                    skipFirstSegment = false;
+                    continue;
+                }
+            }
             if (is_even(index) && !skipFirstSegment) {
                 addedSegment = true;
                 ++segCount;
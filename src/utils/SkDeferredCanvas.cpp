@@ -7,10 +7,16 @@
 
 #include "SkDeferredCanvas.h"
 #include "SkDrawable.h"
+#include "SkMutex.h"
 #include "SkPath.h"
+#include "SkPictureRecorder.h"
 #include "SkRRect.h"
+#include "SkSemaphore.h"
 #include "SkSurface.h"
 #include "SkTextBlob.h"
+#include "SkThreadUtils.h"
+
+#include <deque>
 
 bool SkDeferredCanvas::Rec::isConcat(SkMatrix* m) const {
     switch (fType) {
@@ -44,12 +50,112 @@ void SkDeferredCanvas::Rec::setConcat(const SkMatrix& m) {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Plays frames back to the target, in order, on its own thread.
+class SkDeferredCanvas::PlaybackThread {
+public:
+    PlaybackThread(SkCanvas* target, int maxPendingFrames)
+        : fTarget(target)
+        , fMaxPendingFrames(maxPendingFrames)
+        , fFreeSlots(maxPendingFrames)
+        , fThread(Run, this) {
+        fThread.start();
+    }
+
+    ~PlaybackThread() {
+        // A null frame tells the thread to stop once it has played everything before it.
+        this->push(nullptr);
+        fThread.join();
+    }
+
+    void submit(sk_sp<SkPicture> frame) {
+        fFreeSlots.wait();
+        this->push(std::move(frame));
+    }
+
+    void wait() {
+        // Every slot is free only when no frames are waiting or playing.
+        for (int i = 0; i < fMaxPendingFrames; i++) {
+            fFreeSlots.wait();
+        }
+        fFreeSlots.signal(fMaxPendingFrames);
+    }
+
+private:
+    void push(sk_sp<SkPicture> frame) {
+        {
+            SkAutoMutexAcquire lock(fMutex);
+            fFrames.push_back(std::move(frame));
+        }
+        fPendingFrames.signal();
+    }
+
+    static void Run(void* ctx) {
+        PlaybackThread* self = (PlaybackThread*)ctx;
+        for (;;) {
+            self->fPendingFrames.wait();
+            sk_sp<SkPicture> frame;
+            {
+                SkAutoMutexAcquire lock(self->fMutex);
+                frame = std::move(self->fFrames.front());
+                self->fFrames.pop_front();
+            }
+            if (!frame) {
+                return;
+            }
+            self->fTarget->drawPicture(frame);
+            self->fTarget->flush();
+            frame.reset();
+            self->fFreeSlots.signal();
+        }
+    }
+
+    SkCanvas*                    fTarget;
+    const int                    fMaxPendingFrames;
+    SkSemaphore                  fFreeSlots;      // Frames we may still hand off before blocking.
+    SkSemaphore                  fPendingFrames;  // Frames handed off but not yet started.
+    SkMutex                      fMutex;          // Guards fFrames.
+    std::deque<sk_sp<SkPicture>> fFrames;
+    SkThread                     fThread;
+};
+
 SkDeferredCanvas::SkDeferredCanvas(SkCanvas* canvas)
     : INHERITED(canvas->getBaseLayerSize().width(), canvas->getBaseLayerSize().height())
     , fCanvas(canvas)
+    , fTarget(nullptr)
 {}
 
-SkDeferredCanvas::~SkDeferredCanvas() {}
+SkDeferredCanvas::SkDeferredCanvas(SkCanvas* target, int maxPendingFrames)
+    : INHERITED(target->getBaseLayerSize().width(), target->getBaseLayerSize().height())
+    , fCanvas(nullptr)
+    , fTarget(target)
+    , fRecorder(new SkPictureRecorder)
+    , fPlayback(new PlaybackThread(target, SkTMax(maxPendingFrames, 1)))
+{
+    SkISize size = target->getBaseLayerSize();
+    this->beginThreadedFrame(SkIRect::MakeWH(size.width(), size.height()));
+}
+
+SkDeferredCanvas::~SkDeferredCanvas() {
+    // Finish playing every flushed frame before the recorder goes away.  Draws since the last
+    // flush() are dropped.
+    fPlayback.reset(nullptr);
+}
+
+void SkDeferredCanvas::beginThreadedFrame(const SkIRect& clip) {
+    SkISize size = fTarget->getBaseLayerSize();
+    fCanvas = fRecorder->beginRecording(SkIntToScalar(size.width()),
+                                        SkIntToScalar(size.height()));
+    if (clip != SkIRect::MakeWH(size.width(), size.height())) {
+        fCanvas->clipRect(SkRect::Make(clip));
+    }
+    fCanvas->setMatrix(this->getTotalMatrix());
+}
+
+void SkDeferredCanvas::waitForPlayback() {
+    if (fPlayback) {
+        fPlayback->wait();
+    }
+}
 
 void SkDeferredCanvas::push_save() {
     Rec* r = fRecs.append();
@@ -537,9 +643,23 @@ bool SkDeferredCanvas::onAccessTopLayerPixels(SkPixmap* pixmap) {
     }
     return false;
 }
-SkImageInfo SkDeferredCanvas::onImageInfo() const { return fCanvas->imageInfo(); }
-bool SkDeferredCanvas::onGetProps(SkSurfaceProps* props) const { return fCanvas->getProps(props); }
+SkImageInfo SkDeferredCanvas::onImageInfo() const {
+    return (fTarget ? fTarget : fCanvas)->imageInfo();
+}
+bool SkDeferredCanvas::onGetProps(SkSurfaceProps* props) const {
+    return (fTarget ? fTarget : fCanvas)->getProps(props);
+}
 void SkDeferredCanvas::onFlush() {
     this->flush_all();
+    if (fPlayback) {
+        SkASSERT(1 == this->getSaveCount());
+        SkIRect clip;
+        if (!fCanvas->getClipDeviceBounds(&clip)) {
+            clip.setEmpty();
+        }
+        fPlayback->submit(fRecorder->finishRecordingAsPicture());
+        this->beginThreadedFrame(clip);
+        return;
+    }
     return fCanvas->flush();
 }
@@ -10,13 +10,31 @@
 #define SkDeferredCanvas_DEFINED
 
 #include "../private/SkTDArray.h"
+#include "../private/SkTemplates.h"
 #include "SkCanvas.h"
 
+class SkPictureRecorder;
+
 class SK_API SkDeferredCanvas : public SkCanvas {
 public:
     SkDeferredCanvas(SkCanvas*);
+
+    /**
+     *  Like SkDeferredCanvas(target), but the optimized draws are played back to target on a
+     *  dedicated thread.  Each flush() hands the frame drawn since the last flush() to that
+     *  thread, which draws and flushes it into target while the caller records the next frame.
+     *
+     *  At most maxPendingFrames frames wait for or are in playback at once: flush() blocks until
+     *  one is done when there are more.  target is used only by the playback thread until
+     *  waitForPlayback() returns or this canvas is deleted.  Only the matrix and the bounds of
+     *  the clip carry over from one frame to the next, so flush() with no saves outstanding.
+     */
+    SkDeferredCanvas(SkCanvas* target, int maxPendingFrames);
     ~SkDeferredCanvas() override;
 
+    /** Block until every frame handed to the playback thread has been drawn and flushed. */
+    void waitForPlayback();
+
 #ifdef SK_SUPPORT_LEGACY_DRAWFILTER
     SkDrawFilter* setDrawFilter(SkDrawFilter*) override;
 #endif
@@ -97,8 +115,17 @@ protected:
     class Iter;
 
 private:
+    class PlaybackThread;
+
+    void beginThreadedFrame(const SkIRect& clip);
+
     SkCanvas* fCanvas;
 
+    // Only used when playing back on a dedicated thread; fCanvas then records the next frame.
+    SkCanvas*                       fTarget;
+    SkAutoTDelete<SkPictureRecorder> fRecorder;
+    SkAutoTDelete<PlaybackThread>    fPlayback;
+
     enum Type {
         kSave_Type,
         kClipRect_Type,
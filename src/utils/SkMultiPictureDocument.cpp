@@ -18,12 +18,6 @@
       BEGINNING_OF_FILE:
         kMagic
         uint32_t version_number
-        uint32_t page_count
-        {
-          uint64_t offset
-          float sizeX
-          float sizeY
-        } * page_count
       FIRST_OFFSET:
         skp file
       SECOND_OFFSET:
@@ -31,7 +25,19 @@
       ...
       LAST_OFFSET:
         skp file
+      INDEX_OFFSET:
+        {
+          uint64_t offset
+          float sizeX
+          float sizeY
+        } * page_count
+        uint64_t index_offset
+        uint32_t page_count
+        uint32_t reserved
         "\nEndOfMultiPicture\n"
+
+  Version 1 files have the page count and index right after the version
+  number instead, and no footer.
 */
 
 namespace {
@@ -48,72 +54,53 @@ static SkCanvas* trim(SkCanvas* canvas,
     return canvas;
 }
 
-struct NullWStream : public SkWStream {
-    NullWStream() : fN(0) {}
-    bool write(const void*, size_t n) override {
-        fN += n;
-        return true;
-    }
-    size_t bytesWritten() const override { return fN; }
-    size_t fN;
-};
-
-struct Page {
-  Page(SkSize s, sk_sp<SkPicture> c) : fSize(s), fContent(std::move(c)) {}
-  Page(Page&& that) : fSize(that.fSize), fContent(std::move(that.fContent)) {}
-  Page(const Page&) = default;
-  Page& operator=(const Page&) = default;
-  Page& operator=(Page&& that) {
-    fSize = that.fSize;
-    fContent = std::move(that.fContent);
-    return *this;
-  }
-  SkSize fSize;
-  sk_sp<SkPicture> fContent;
-};
-
 struct MultiPictureDocument final : public SkDocument {
     SkPictureRecorder fPictureRecorder;
     SkSize fCurrentPageSize;
-    std::vector<Page> fPages;
+    std::vector<SkMultiPictureDocumentProtocol::Entry> fIndex;
+    bool fWroteHeader;
+    bool fGood;
     MultiPictureDocument(SkWStream* s, void (*d)(SkWStream*, bool))
-        : SkDocument(s, d) {}
+        : SkDocument(s, d), fWroteHeader(false), fGood(true) {}
     ~MultiPictureDocument() { this->close(); }
 
+    void writeHeader(SkWStream* wStream) {
+        if (!fWroteHeader) {
+            SkASSERT(wStream->bytesWritten() == 0);
+            fGood &= wStream->writeText(SkMultiPictureDocumentProtocol::kMagic);
+            fGood &= wStream->write32(SkMultiPictureDocumentProtocol::kIndexInFooter_Version);
+            fWroteHeader = true;
+        }
+    }
+
     SkCanvas* onBeginPage(SkScalar w, SkScalar h, const SkRect& c) override {
         fCurrentPageSize.set(w, h);
         return trim(fPictureRecorder.beginRecording(w, h), w, h, c);
     }
     void onEndPage() override {
-        fPages.emplace_back(fCurrentPageSize,
-                            fPictureRecorder.finishRecordingAsPicture());
+        // Each page goes straight to the stream, so it is serialized once and
+        // never held onto.
+        sk_sp<SkPicture> page(fPictureRecorder.finishRecordingAsPicture());
+        SkWStream* wStream = this->getStream();
+        this->writeHeader(wStream);
+        fIndex.push_back({wStream->bytesWritten(),
+                          fCurrentPageSize.width(), fCurrentPageSize.height()});
+        page->serialize(wStream);
     }
     bool onClose(SkWStream* wStream) override {
         SkASSERT(wStream);
-        SkASSERT(wStream->bytesWritten() == 0);
-        bool good = true;
-        good &= wStream->writeText(SkMultiPictureDocumentProtocol::kMagic);
-        good &= wStream->write32(SkToU32(1));  // version
-        good &= wStream->write32(SkToU32(fPages.size()));
-        uint64_t offset = wStream->bytesWritten();
-        offset += fPages.size() * sizeof(SkMultiPictureDocumentProtocol::Entry);
-        for (const auto& page : fPages) {
-            SkMultiPictureDocumentProtocol::Entry entry{
-                    offset, page.fSize.width(), page.fSize.height()};
-            good &= wStream->write(&entry, sizeof(entry));
-            NullWStream buffer;
-            page.fContent->serialize(&buffer);
-            offset += buffer.bytesWritten();
-        }
-        for (const auto& page : fPages) {
-            page.fContent->serialize(wStream);
+        this->writeHeader(wStream);
+        SkMultiPictureDocumentProtocol::Footer footer{
+                wStream->bytesWritten(), SkToU32(fIndex.size()), 0};
+        for (const auto& entry : fIndex) {
+            fGood &= wStream->write(&entry, sizeof(entry));
         }
-        SkASSERT(wStream->bytesWritten() == offset);
-        good &= wStream->writeText("\nEndOfMultiPicture\n");
-        fPages.clear();
-        return good;
+        fGood &= wStream->write(&footer, sizeof(footer));
+        fGood &= wStream->writeText(SkMultiPictureDocumentProtocol::kEndMarker);
+        fIndex.clear();
+        return fGood;
     }
-    void onAbort() override { fPages.clear(); }
+    void onAbort() override { fIndex.clear(); }
 };
 }
 
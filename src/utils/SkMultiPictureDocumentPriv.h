@@ -12,12 +12,24 @@
 
 namespace SkMultiPictureDocumentProtocol {
 static constexpr char kMagic[] = "Skia Multi-Picture Doc\n\n";
+static constexpr char kEndMarker[] = "\nEndOfMultiPicture\n";
+
+// Version 1 puts the page index at the front of the file; version 2 puts it in a footer,
+// so pages can be written as they are finished.
+static constexpr uint32_t kIndexInHeader_Version = 1;
+static constexpr uint32_t kIndexInFooter_Version = 2;
 
 struct Entry {
     uint64_t offset;
     float sizeX;
     float sizeY;
 };
+
+struct Footer {
+    uint64_t indexOffset;
+    uint32_t pageCount;
+    uint32_t reserved;
+};
 }
 
 #endif  // SkMultiPictureDocumentPriv_DEFINED
@@ -10,7 +10,25 @@
 #include "SkPicture.h"
 #include "SkStream.h"
 
+namespace {
+bool read_index(SkStream* stream, uint32_t pageCount,
+                SkTArray<SkSize>* sizes, SkTArray<size_t>* offsets) {
+    bool good = true;
+    sizes->reset(pageCount);
+    offsets->reset(pageCount);
+    for (uint32_t i = 0; i < pageCount; ++i) {
+        SkMultiPictureDocumentProtocol::Entry entry;
+        good &= sizeof(entry) == stream->read(&entry, sizeof(entry));
+        (*sizes)[i] = SkSize::Make(entry.sizeX, entry.sizeY);
+        good &= SkTFitsIn<size_t>(entry.offset);
+        (*offsets)[i] = static_cast<size_t>(entry.offset);
+    }
+    return good;
+}
+}
+
 bool SkMultiPictureDocumentReader::init(SkStreamSeekable* stream) {
+    this->reset();
     if (!stream) {
         return false;
     }
@@ -24,18 +42,42 @@ bool SkMultiPictureDocumentReader::init(SkStreamSeekable* stream) {
     }
     bool good = true;
     uint32_t versionNumber = stream->readU32();
-    if (versionNumber != 1) {
+    size_t indexOffset = 0;
+    if (versionNumber == SkMultiPictureDocumentProtocol::kIndexInHeader_Version) {
+        uint32_t pageCount = stream->readU32();
+        good &= read_index(stream, pageCount, &fSizes, &fOffsets);
+    } else if (versionNumber == SkMultiPictureDocumentProtocol::kIndexInFooter_Version) {
+        // The index is at the end: jump straight to it, skipping the pages.
+        const size_t markerSize = sizeof(SkMultiPictureDocumentProtocol::kEndMarker) - 1;
+        const size_t tailSize = sizeof(SkMultiPictureDocumentProtocol::Footer) + markerSize;
+        if (!stream->hasLength() || stream->getLength() < size + sizeof(uint32_t) + tailSize ||
+            !stream->seek(stream->getLength() - tailSize)) {
+            return false;
+        }
+        SkMultiPictureDocumentProtocol::Footer footer;
+        char marker[markerSize];
+        if (sizeof(footer) != stream->read(&footer, sizeof(footer)) ||
+            markerSize != stream->read(marker, markerSize) ||
+            0 != memcmp(SkMultiPictureDocumentProtocol::kEndMarker, marker, markerSize) ||
+            !SkTFitsIn<size_t>(footer.indexOffset) ||
+            footer.pageCount > (stream->getLength() - tailSize) /
+                               sizeof(SkMultiPictureDocumentProtocol::Entry) ||
+            !stream->seek(static_cast<size_t>(footer.indexOffset))) {
+            return false;
+        }
+        indexOffset = static_cast<size_t>(footer.indexOffset);
+        good &= read_index(stream, footer.pageCount, &fSizes, &fOffsets);
+    } else {
         return false;
     }
-    uint32_t pageCount = stream->readU32();
-    fSizes.reset(pageCount);
-    fOffsets.reset(pageCount);
-    for (uint32_t i = 0; i < pageCount; ++i) {
-        SkMultiPictureDocumentProtocol::Entry entry;
-        good &= sizeof(entry) == stream->read(&entry, sizeof(entry));
-        fSizes[i] = SkSize::Make(entry.sizeX, entry.sizeY);
-        good &= SkTFitsIn<size_t>(entry.offset);
-        fOffsets[i] = static_cast<size_t>(entry.offset);
+    // Each page ends where the next one (or the footer's index) begins.
+    fEnds.reset(fOffsets.count());
+    for (int i = 0; i < fOffsets.count(); ++i) {
+        fEnds[i] = i + 1 < fOffsets.count() ? fOffsets[i + 1] : indexOffset;
+        good &= fEnds[i] == 0 || fOffsets[i] <= fEnds[i];
+    }
+    if (!good) {
+        this->reset();
     }
     return good;
 }
@@ -47,3 +89,15 @@ sk_sp<SkPicture> SkMultiPictureDocumentReader::readPage(SkStreamSeekable* stream
     SkAssertResult(stream->seek(fOffsets[pageNumber]));
     return SkPicture::MakeFromStream(stream);
 }
+
+sk_sp<SkPicture> SkMultiPictureDocumentReader::readPage(const sk_sp<SkData>& data,
+                                                        int pageNumber) const {
+    SkASSERT(pageNumber >= 0);
+    SkASSERT(pageNumber < fOffsets.count());
+    size_t offset = fOffsets[pageNumber];
+    size_t end = fEnds[pageNumber] ? fEnds[pageNumber] : data->size();
+    if (end > data->size() || offset > end) {
+        return nullptr;
+    }
+    return SkPicture::MakeFromData(SkData::MakeSubset(data.get(), offset, end - offset));
+}
@@ -8,6 +8,7 @@
 #define SkMultiPictureDocumentReader_DEFINED
 
 #include "../private/SkTArray.h"
+#include "SkData.h"
 #include "SkPicture.h"
 #include "SkSize.h"
 #include "SkStream.h"
@@ -16,13 +17,15 @@
 class SkMultiPictureDocumentReader {
 public:
     /** Initialize the MultiPictureDocument.  Does not take ownership
-        of the SkStreamSeekable. */
+        of the SkStreamSeekable.  Only the page index is read, not the
+        pages themselves. */
     bool init(SkStreamSeekable*);
 
     /** Return to factory settings. */
     void reset() {
         fSizes.reset();
         fOffsets.reset();
+        fEnds.reset();
     }
 
     /** Call this after calling init() */
@@ -33,6 +36,12 @@ public:
         should point to the same information as before. */
     sk_sp<SkPicture> readPage(SkStreamSeekable*, int) const;
 
+    /** Deserialize a page from the document's data, e.g. a file mapped
+        into memory by SkData::MakeFromFileName(), without copying its
+        ops.  Call init() first.  Pages share nothing but the data, so
+        several may be read at once on different threads. */
+    sk_sp<SkPicture> readPage(const sk_sp<SkData>&, int) const;
+
     /** Fetch the size of the given page, without deserializing the
         entire page. */
     SkSize pageSize(int i) const { return fSizes[i]; }
@@ -40,6 +49,7 @@ public:
 private:
     SkTArray<SkSize> fSizes;
     SkTArray<size_t> fOffsets;
+    SkTArray<size_t> fEnds;    // 0 if the page runs to the end of the file.
 };
 
 #endif  // SkMultiPictureDocumentReader_DEFINED
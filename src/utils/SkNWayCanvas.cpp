@@ -5,15 +5,80 @@
  * found in the LICENSE file.
  */
 #include "SkNWayCanvas.h"
+#include "SkRecordDraw.h"
+#include "SkRecorder.h"
+#include "SkTaskGroup.h"
+
+// Enough ops to keep the tasks of a playback busy, while bounding what a long run of draws
+// without a flush() can hold on to.
+static const int kMaxRecordedOps = 4096;
+
+// Plays the recording back when it reaches kMaxRecordedOps, and hands it back to be reused.
+class SkNWayCanvas::Flusher : public SkRecorder::Flusher {
+public:
+    explicit Flusher(SkNWayCanvas* canvas) : fCanvas(canvas) {}
+
+    SkRecord* flush(SkRecord* record) override {
+        fCanvas->playback();
+        return record;
+    }
+
+private:
+    SkNWayCanvas* fCanvas;
+};
 
 SkNWayCanvas::SkNWayCanvas(int width, int height)
         : INHERITED(width, height) {}
 
 SkNWayCanvas::~SkNWayCanvas() {
+    this->setParallel(false);
     this->removeAll();
 }
 
+void SkNWayCanvas::setParallel(bool parallel) {
+    if (parallel == this->isParallel()) {
+        return;
+    }
+    if (parallel) {
+        const SkRect bounds = SkRect::Make(SkIRect::MakeSize(this->getBaseLayerSize()));
+        fRecord = sk_make_sp<SkRecord>();
+        fRecorder.reset(new SkRecorder(fRecord.get(), bounds));
+        // Expand pictures and drawables, so the recording stands on its own.
+        fRecorder->reset(fRecord.get(), bounds, SkRecorder::Playback_DrawPictureMode);
+        fFlusher.reset(new Flusher(this));
+        fRecorder->setFlusher(fFlusher.get(), kMaxRecordedOps);
+        *fRecorderList.append() = fRecorder.get();
+    } else {
+        this->playback();
+        fRecorderList.reset();
+        fFlusher.reset(nullptr);
+        fRecorder.reset(nullptr);
+        fRecord.reset(nullptr);
+    }
+}
+
+void SkNWayCanvas::playback() {
+    if (!fRecord || 0 == fRecord->count()) {
+        return;
+    }
+    const SkRecord& record = *fRecord;
+    SkTaskGroup().batch(fList.count(), [&](int i) {
+        // The recording's setMatrix() calls are absolute, just as they'd have been forwarded.
+        SkRecords::Draw draw(fList[i], nullptr, nullptr, 0, &SkMatrix::I());
+        for (int j = 0; j < record.count(); j++) {
+            record.visit(j, draw);
+        }
+    });
+    fRecord->reset();
+}
+
+void SkNWayCanvas::onFlush() {
+    this->playback();
+    this->INHERITED::onFlush();
+}
+
 void SkNWayCanvas::addCanvas(SkCanvas* canvas) {
+    this->playback();
     if (canvas) {
         canvas->ref();
         *fList.append() = canvas;
@@ -21,6 +86,7 @@ void SkNWayCanvas::addCanvas(SkCanvas* canvas) {
 }
 
 void SkNWayCanvas::removeCanvas(SkCanvas* canvas) {
+    this->playback();
     int index = fList.find(canvas);
     if (index >= 0) {
         canvas->unref();
@@ -29,6 +95,7 @@ void SkNWayCanvas::removeCanvas(SkCanvas* canvas) {
 }
 
 void SkNWayCanvas::removeAll() {
+    this->playback();
     fList.unrefAll();
     fList.reset();
 }
@@ -57,7 +124,7 @@ private:
 };
 
 void SkNWayCanvas::willSave() {
-    Iter iter(fList);
+    Iter iter(this->targets());
     while (iter.next()) {
         iter->save();
     }
@@ -66,7 +133,7 @@ void SkNWayCanvas::willSave() {
 }
 
 SkCanvas::SaveLayerStrategy SkNWayCanvas::getSaveLayerStrategy(const SaveLayerRec& rec) {
-    Iter iter(fList);
+    Iter iter(this->targets());
     while (iter.next()) {
         iter->saveLayer(rec);
     }
@@ -77,7 +144,7 @@ SkCanvas::SaveLayerStrategy SkNWayCanvas::getSaveLayerStrategy(const SaveLayerRe
 }
 
 void SkNWayCanvas::willRestore() {
-    Iter iter(fList);
+    Iter iter(this->targets());
     while (iter.next()) {
         iter->restore();
     }
@@ -85,7 +152,7 @@ void SkNWayCanvas::willRestore() {
 }
 
 void SkNWayCanvas::didConcat(const SkMatrix& matrix) {
-    Iter iter(fList);
+    Iter iter(this->targets());
     while (iter.next()) {
         iter->concat(matrix);
     }
@@ -93,7 +160,7 @@ void SkNWayCanvas::didConcat(const SkMatrix& matrix) {
 }
 
 void SkNWayCanvas::didSetMatrix(const SkMatrix& matrix) {
-    Iter iter(fList);
+    Iter iter(this->targets());
     while (iter.next()) {
         iter->setMatrix(matrix);
     }
@@ -101,7 +168,7 @@ void SkNWayCanvas::didSetMatrix(const SkMatrix& matrix) {
 }
 
 void SkNWayCanvas::onClipRect(const SkRect& rect, SkRegion::Op op, ClipEdgeStyle edgeStyle) {
-    Iter iter(fList);
+    Iter iter(this->targets());
     while (iter.next()) {
         iter->clipRect(rect, op, kSoft_ClipEdgeStyle == edgeStyle);
     }
@@ -109,7 +176,7 @@ void SkNWayCanvas::onClipRect(const SkRect& rect, SkRegion::Op op, ClipEdgeStyle
 }
 
 void SkNWayCanvas::onClipRRect(const SkRRect& rrect, SkRegion::Op op, ClipEdgeStyle edgeStyle) {
-    Iter iter(fList);
+    Iter iter(this->targets());
     while (iter.next()) {
         iter->clipRRect(rrect, op, kSoft_ClipEdgeStyle == edgeStyle);
     }
@@ -117,7 +184,7 @@ void SkNWayCanvas::onClipRRect(const SkRRect& rrect, SkRegion::Op op, ClipEdgeSt
 }
 
 void SkNWayCanvas::onClipPath(const SkPath& path, SkRegion::Op op, ClipEdgeStyle edgeStyle) {
-    Iter iter(fList);
+    Iter iter(this->targets());
     while (iter.next()) {
         iter->clipPath(path, op, kSoft_ClipEdgeStyle == edgeStyle);
     }
@@ -125,7 +192,7 @@ void SkNWayCanvas::onClipPath(const SkPath& path, SkRegion::Op op, ClipEdgeStyle
 }
 
 void SkNWayCanvas::onClipRegion(const SkRegion& deviceRgn, SkRegion::Op op) {
-    Iter iter(fList);
+    Iter iter(this->targets());
     while (iter.next()) {
         iter->clipRegion(deviceRgn, op);
     }
@@ -133,7 +200,7 @@ void SkNWayCanvas::onClipRegion(const SkRegion& deviceRgn, SkRegion::Op op) {
 }
 
 void SkNWayCanvas::onDrawPaint(const SkPaint& paint) {
-    Iter iter(fList);
+    Iter iter(this->targets());
     while (iter.next()) {
         iter->drawPaint(paint);
     }
@@ -141,42 +208,42 @@ void SkNWayCanvas::onDrawPaint(const SkPaint& paint) {
 
 void SkNWayCanvas::onDrawPoints(PointMode mode, size_t count, const SkPoint pts[],
                                 const SkPaint& paint) {
-    Iter iter(fList);
+    Iter iter(this->targets());
     while (iter.next()) {
         iter->drawPoints(mode, count, pts, paint);
     }
 }
 
 void SkNWayCanvas::onDrawRect(const SkRect& rect, const SkPaint& paint) {
-    Iter iter(fList);
+    Iter iter(this->targets());
     while (iter.next()) {
         iter->drawRect(rect, paint);
     }
 }
 
 void SkNWayCanvas::onDrawOval(const SkRect& rect, const SkPaint& paint) {
-    Iter iter(fList);
+    Iter iter(this->targets());
     while (iter.next()) {
         iter->drawOval(rect, paint);
     }
 }
 
 void SkNWayCanvas::onDrawRRect(const SkRRect& rrect, const SkPaint& paint) {
-    Iter iter(fList);
+    Iter iter(this->targets());
     while (iter.next()) {
         iter->drawRRect(rrect, paint);
     }
 }
 
 void SkNWayCanvas::onDrawDRRect(const SkRRect& outer, const SkRRect& inner, const SkPaint& paint) {
-    Iter iter(fList);
+    Iter iter(this->targets());
     while (iter.next()) {
         iter->drawDRRect(outer, inner, paint);
     }
 }
 
 void SkNWayCanvas::onDrawPath(const SkPath& path, const SkPaint& paint) {
-    Iter iter(fList);
+    Iter iter(this->targets());
     while (iter.next()) {
         iter->drawPath(path, paint);
     }
@@ -184,7 +251,7 @@ void SkNWayCanvas::onDrawPath(const SkPath& path, const SkPaint& paint) {
 
 void SkNWayCanvas::onDrawBitmap(const SkBitmap& bitmap, SkScalar x, SkScalar y,
                                 const SkPaint* paint) {
-    Iter iter(fList);
+    Iter iter(this->targets());
     while (iter.next()) {
         iter->drawBitmap(bitmap, x, y, paint);
     }
@@ -192,7 +259,7 @@ void SkNWayCanvas::onDrawBitmap(const SkBitmap& bitmap, SkScalar x, SkScalar y,
 
 void SkNWayCanvas::onDrawBitmapRect(const SkBitmap& bitmap, const SkRect* src, const SkRect& dst,
                                     const SkPaint* paint, SrcRectConstraint constraint) {
-    Iter iter(fList);
+    Iter iter(this->targets());
     while (iter.next()) {
         iter->legacy_drawBitmapRect(bitmap, src, dst, paint, (SrcRectConstraint)constraint);
     }
@@ -200,7 +267,7 @@ void SkNWayCanvas::onDrawBitmapRect(const SkBitmap& bitmap, const SkRect* src, c
 
 void SkNWayCanvas::onDrawBitmapNine(const SkBitmap& bitmap, const SkIRect& center,
                                     const SkRect& dst, const SkPaint* paint) {
-    Iter iter(fList);
+    Iter iter(this->targets());
     while (iter.next()) {
         iter->drawBitmapNine(bitmap, center, dst, paint);
     }
@@ -208,7 +275,7 @@ void SkNWayCanvas::onDrawBitmapNine(const SkBitmap& bitmap, const SkIRect& cente
 
 void SkNWayCanvas::onDrawImage(const SkImage* image, SkScalar left, SkScalar top,
                                const SkPaint* paint) {
-    Iter iter(fList);
+    Iter iter(this->targets());
     while (iter.next()) {
         iter->drawImage(image, left, top, paint);
     }
@@ -216,7 +283,7 @@ void SkNWayCanvas::onDrawImage(const SkImage* image, SkScalar left, SkScalar top
 
 void SkNWayCanvas::onDrawImageRect(const SkImage* image, const SkRect* src, const SkRect& dst,
                                    const SkPaint* paint, SrcRectConstraint constraint) {
-    Iter iter(fList);
+    Iter iter(this->targets());
     while (iter.next()) {
         iter->legacy_drawImageRect(image, src, dst, paint, constraint);
     }
@@ -224,7 +291,7 @@ void SkNWayCanvas::onDrawImageRect(const SkImage* image, const SkRect* src, cons
 
 void SkNWayCanvas::onDrawText(const void* text, size_t byteLength, SkScalar x, SkScalar y,
                               const SkPaint& paint) {
-    Iter iter(fList);
+    Iter iter(this->targets());
     while (iter.next()) {
         iter->drawText(text, byteLength, x, y, paint);
     }
@@ -232,7 +299,7 @@ void SkNWayCanvas::onDrawText(const void* text, size_t byteLength, SkScalar x, S
 
 void SkNWayCanvas::onDrawPosText(const void* text, size_t byteLength, const SkPoint pos[],
                                  const SkPaint& paint) {
-    Iter iter(fList);
+    Iter iter(this->targets());
     while (iter.next()) {
         iter->drawPosText(text, byteLength, pos, paint);
     }
@@ -240,7 +307,7 @@ void SkNWayCanvas::onDrawPosText(const void* text, size_t byteLength, const SkPo
 
 void SkNWayCanvas::onDrawPosTextH(const void* text, size_t byteLength, const SkScalar xpos[],
                                   SkScalar constY, const SkPaint& paint) {
-    Iter iter(fList);
+    Iter iter(this->targets());
     while (iter.next()) {
         iter->drawPosTextH(text, byteLength, xpos, constY, paint);
     }
@@ -248,7 +315,7 @@ void SkNWayCanvas::onDrawPosTextH(const void* text, size_t byteLength, const SkS
 
 void SkNWayCanvas::onDrawTextOnPath(const void* text, size_t byteLength, const SkPath& path,
                                     const SkMatrix* matrix, const SkPaint& paint) {
-    Iter iter(fList);
+    Iter iter(this->targets());
     while (iter.next()) {
         iter->drawTextOnPath(text, byteLength, path, matrix, paint);
     }
@@ -256,7 +323,7 @@ void SkNWayCanvas::onDrawTextOnPath(const void* text, size_t byteLength, const S
 
 void SkNWayCanvas::onDrawTextRSXform(const void* text, size_t byteLength, const SkRSXform xform[],
                                      const SkRect* cull, const SkPaint& paint) {
-    Iter iter(fList);
+    Iter iter(this->targets());
     while (iter.next()) {
         iter->drawTextRSXform(text, byteLength, xform, cull, paint);
     }
@@ -264,7 +331,7 @@ void SkNWayCanvas::onDrawTextRSXform(const void* text, size_t byteLength, const
 
 void SkNWayCanvas::onDrawTextBlob(const SkTextBlob* blob, SkScalar x, SkScalar y,
                                   const SkPaint &paint) {
-    Iter iter(fList);
+    Iter iter(this->targets());
     while (iter.next()) {
         iter->drawTextBlob(blob, x, y, paint);
     }
@@ -272,7 +339,7 @@ void SkNWayCanvas::onDrawTextBlob(const SkTextBlob* blob, SkScalar x, SkScalar y
 
 void SkNWayCanvas::onDrawPicture(const SkPicture* picture, const SkMatrix* matrix,
                                  const SkPaint* paint) {
-    Iter iter(fList);
+    Iter iter(this->targets());
     while (iter.next()) {
         iter->drawPicture(picture, matrix, paint);
     }
@@ -283,7 +350,7 @@ void SkNWayCanvas::onDrawVertices(VertexMode vmode, int vertexCount,
                                   const SkColor colors[], SkXfermode* xmode,
                                   const uint16_t indices[], int indexCount,
                                   const SkPaint& paint) {
-    Iter iter(fList);
+    Iter iter(this->targets());
     while (iter.next()) {
         iter->drawVertices(vmode, vertexCount, vertices, texs, colors, xmode,
                            indices, indexCount, paint);
@@ -293,14 +360,14 @@ void SkNWayCanvas::onDrawVertices(VertexMode vmode, int vertexCount,
 void SkNWayCanvas::onDrawPatch(const SkPoint cubics[12], const SkColor colors[4],
                                const SkPoint texCoords[4], SkXfermode* xmode,
                                const SkPaint& paint) {
-    Iter iter(fList);
+    Iter iter(this->targets());
     while (iter.next()) {
         iter->drawPatch(cubics, colors, texCoords, xmode, paint);
     }
 }
 
 void SkNWayCanvas::onDrawAnnotation(const SkRect& rect, const char key[], SkData* data) {
-    Iter iter(fList);
+    Iter iter(this->targets());
     while (iter.next()) {
         iter->drawAnnotation(rect, key, data);
     }
@@ -308,7 +375,7 @@ void SkNWayCanvas::onDrawAnnotation(const SkRect& rect, const char key[], SkData
 
 #ifdef SK_SUPPORT_LEGACY_DRAWFILTER
 SkDrawFilter* SkNWayCanvas::setDrawFilter(SkDrawFilter* filter) {
-    Iter iter(fList);
+    Iter iter(this->targets());
     while (iter.next()) {
         iter->setDrawFilter(filter);
     }
@@ -17,7 +17,10 @@ SkPatchGrid::SkPatchGrid(int rows, int cols, VertexType flags, SkXfermode* xfer)
     , fTexCoords(nullptr)
     , fHrzCtrlPts(nullptr)
     , fVrtCtrlPts(nullptr)
-    , fXferMode(nullptr) {
+    , fXferMode(nullptr)
+    , fCache(nullptr)
+    , fColLods(nullptr)
+    , fRowLods(nullptr) {
         this->reset(rows, cols, flags, xfer);
 }
 
@@ -27,6 +30,18 @@ SkPatchGrid::~SkPatchGrid() {
     delete[] fTexCoords;
     delete[] fHrzCtrlPts;
     delete[] fVrtCtrlPts;
+    delete[] fCache;
+    delete[] fColLods;
+    delete[] fRowLods;
+}
+
+void SkPatchGrid::invalidateCache(int x, int y) {
+    // The patch shares its corners, edges, colors and texture coordinates with its neighbors.
+    for (int j = SkMax32(0, y - 1); j <= SkMin32(fRows - 1, y + 1); j++) {
+        for (int i = SkMax32(0, x - 1); i <= SkMin32(fCols - 1, x + 1); i++) {
+            fCache[j * fCols + i].fData.reset();
+        }
+    }
 }
 
 bool SkPatchGrid::setPatch(int x, int y, const SkPoint cubics[12], const SkColor colors[4],
@@ -73,6 +88,7 @@ bool SkPatchGrid::setPatch(int x, int y, const SkPoint cubics[12], const SkColor
         fTexCoords[cornerPos + (fCols + 1) + 1] = texCoords[2];
     }
 
+    this->invalidateCache(x, y);
     return true;
 }
 
@@ -125,6 +141,11 @@ void SkPatchGrid::reset(int rows, int cols, VertexType flags, SkXfermode* xMode)
     delete[] fTexCoords;
     delete[] fHrzCtrlPts;
     delete[] fVrtCtrlPts;
+    delete[] fCache;
+    delete[] fColLods;
+    delete[] fRowLods;
+    fCornerColors = nullptr;
+    fTexCoords = nullptr;
 
     fCols = cols;
     fRows = rows;
@@ -147,6 +168,18 @@ void SkPatchGrid::reset(int rows, int cols, VertexType flags, SkXfermode* xMode)
         fTexCoords = new SkPoint[(fRows + 1) * (fCols + 1)];
         memset(fTexCoords, 0, (fRows + 1) * (fCols + 1) * sizeof(SkPoint));
     }
+
+    fCache = new CachedPatch[fRows * fCols];
+    fColLods = new int[fCols];
+    fRowLods = new int[fRows];
+    memset(fColLods, 0, fCols * sizeof(int));
+    memset(fRowLods, 0, fRows * sizeof(int));
+}
+
+// Keeps the level of detail a column or row was tessellated at while it is at least what is needed
+// and no more than twice that, so zooming doesn't retessellate the grid every frame.
+static int update_lod(int cachedLod, int neededLod) {
+    return cachedLod >= neededLod && cachedLod <= 2 * neededLod ? cachedLod : neededLod;
 }
 
 void SkPatchGrid::draw(SkCanvas* canvas, SkPaint& paint) {
@@ -156,28 +189,46 @@ void SkPatchGrid::draw(SkCanvas* canvas, SkPaint& paint) {
     memset(maxRows, 0, fRows * sizeof(int));
 
     // Get the maximum level of detail per axis for each row and column
+    const SkMatrix& matrix = canvas->getTotalMatrix();
     for (int y = 0; y < fRows; y++) {
         for (int x = 0; x < fCols; x++) {
             SkPoint cubics[12];
             this->getPatch(x, y, cubics, nullptr, nullptr);
-            SkMatrix matrix = canvas->getTotalMatrix();
             SkISize lod = SkPatchUtils::GetLevelOfDetail(cubics, &matrix);
             maxCols[x] = SkMax32(maxCols[x], lod.width());
             maxRows[y] = SkMax32(maxRows[y], lod.height());
         }
     }
-    // Draw the patches by generating their geometry with the maximum level of detail per axis.
+    for (int x = 0; x < fCols; x++) {
+        fColLods[x] = update_lod(fColLods[x], maxCols[x]);
+    }
+    for (int y = 0; y < fRows; y++) {
+        fRowLods[y] = update_lod(fRowLods[y], maxRows[y]);
+    }
+
+    // Draw the patches, generating the geometry of those that changed with the level of detail of
+    // their row and column.
     for (int x = 0; x < fCols; x++) {
         for (int y = 0; y < fRows; y++) {
-            SkPoint cubics[12];
-            SkPoint texCoords[4];
-            SkColor colors[4];
-            this->getPatch(x, y, cubics, colors, texCoords);
-            SkPatchUtils::VertexData data;
-            if (SkPatchUtils::getVertexData(&data, cubics,
-                                            fModeFlags & kColors_VertexType ? colors : nullptr,
-                                            fModeFlags & kTexs_VertexType ? texCoords : nullptr,
-                                            maxCols[x], maxRows[y])) {
+            CachedPatch& cached = fCache[y * fCols + x];
+            if (!cached.fData || cached.fLodX != fColLods[x] || cached.fLodY != fRowLods[y]) {
+                SkPoint cubics[12];
+                SkPoint texCoords[4];
+                SkColor colors[4];
+                this->getPatch(x, y, cubics, colors, texCoords);
+                cached.fData.reset(new SkPatchUtils::VertexData);
+                cached.fLodX = fColLods[x];
+                cached.fLodY = fRowLods[y];
+                if (!SkPatchUtils::getVertexData(
+                            cached.fData.get(), cubics,
+                            fModeFlags & kColors_VertexType ? colors : nullptr,
+                            fModeFlags & kTexs_VertexType ? texCoords : nullptr,
+                            cached.fLodX, cached.fLodY)) {
+                    cached.fData.reset(new SkPatchUtils::VertexData);
+                }
+            }
+            const SkPatchUtils::VertexData& data = *cached.fData;
+            if (data.fVertexCount > 0) {
                 canvas->drawVertices(SkCanvas::kTriangles_VertexMode, data.fVertexCount,
                                      data.fPoints, data.fTexCoords, data.fColors, fXferMode,
                                      data.fIndices, data.fIndexCount, paint);
@@ -12,6 +12,8 @@
 #include "SkPatchUtils.h"
 #include "SkXfermode.h"
 
+#include <memory>
+
 /**
  * Class that represents a grid of patches. Adjacent patches share their corners and a color is
  * specified at each one of them. The colors are bilinearly interpolated across the patch.
@@ -119,6 +121,8 @@ public:
      * Draws the grid of patches. The patches are drawn starting at patch (0,0) drawing columns, so
      * for a 2x2 grid the order would be (0,0)->(0,1)->(1,0)->(1,1). The order follows the order
      * of the parametric coordinates of the coons patch.
+     * The tessellation of each patch is kept for the following draws until setPatch() or reset()
+     * changes it, or the canvas' matrix calls for a level of detail too far from the kept one.
      */
     void draw(SkCanvas* canvas, SkPaint& paint);
 
@@ -130,6 +134,15 @@ public:
     }
 
 private:
+    struct CachedPatch {
+        CachedPatch() : fLodX(0), fLodY(0) {}
+
+        std::unique_ptr<SkPatchUtils::VertexData> fData;
+        int fLodX, fLodY;
+    };
+
+    void invalidateCache(int x, int y);
+
     int fRows, fCols;
     VertexType fModeFlags;
     SkPoint* fCornerPts;
@@ -138,6 +151,12 @@ private:
     SkPoint* fHrzCtrlPts;
     SkPoint* fVrtCtrlPts;
     SkXfermode* fXferMode;
+
+    // Tessellations from previous draws, one per patch, and the level of detail each column and
+    // row is tessellated at. Patches in a column or row share it, so their shared edges match.
+    CachedPatch* fCache;
+    int* fColLods;
+    int* fRowLods;
 };
 
 
@@ -9,94 +9,49 @@
 
 #include "SkColorPriv.h"
 #include "SkGeometry.h"
+#include "SkNx.h"
+#include "SkTemplates.h"
 
 /**
- * Evaluator to sample the values of a cubic bezier using forward differences.
- * Forward differences is a method for evaluating a nth degree polynomial at a uniform step by only
- * adding precalculated values.
- * For a linear example we have the function f(t) = m*t+b, then the value of that function at t+h
- * would be f(t+h) = m*(t+h)+b. If we want to know the uniform step that we must add to the first
- * evaluation f(t) then we need to substract f(t+h) - f(t) = m*t + m*h + b - m*t + b = mh. After
- * obtaining this value (mh) we could just add this constant step to our first sampled point
- * to compute the next one.
- *
- * For the cubic case the first difference gives as a result a quadratic polynomial to which we can
- * apply again forward differences and get linear function to which we can apply again forward
- * differences to get a constant difference. This is why we keep an array of size 4, the 0th
- * position keeps the sampled value while the next ones keep the quadratic, linear and constant
- * difference values.
+ * Evaluates two cubic beziers at once. Lanes 0 and 1 hold the x and y of the first cubic, lanes 2
+ * and 3 those of the second, so a single Horner evaluation in Sk4f samples both curves.
  */
-
-class FwDCubicEvaluator {
+class CubicPairEvaluator {
 
 public:
-
-    /**
-     * Receives the 4 control points of the cubic bezier.
-     */
-
-    explicit FwDCubicEvaluator(const SkPoint points[4])
-            : fCoefs(points) {
-        memcpy(fPoints, points, 4 * sizeof(SkPoint));
-
-        this->restart(1);
+    CubicPairEvaluator(const SkPoint first[4], const SkPoint second[4]) {
+        SkCubicCoeff a(first), b(second);
+        fA = Sk4f(a.fA[0], a.fA[1], b.fA[0], b.fA[1]);
+        fB = Sk4f(a.fB[0], a.fB[1], b.fB[0], b.fB[1]);
+        fC = Sk4f(a.fC[0], a.fC[1], b.fC[0], b.fC[1]);
+        fD = Sk4f(a.fD[0], a.fD[1], b.fD[0], b.fD[1]);
     }
 
-    /**
-     * Restarts the forward differences evaluator to the first value of t = 0.
-     */
-    void restart(int divisions)  {
-        fDivisions = divisions;
-        fCurrent    = 0;
-        fMax        = fDivisions + 1;
-        Sk2s h  = Sk2s(1.f / fDivisions);
-        Sk2s h2 = h * h;
-        Sk2s h3 = h2 * h;
-        Sk2s fwDiff3 = Sk2s(6) * fCoefs.fA * h3;
-        fFwDiff[3] = to_point(fwDiff3);
-        fFwDiff[2] = to_point(fwDiff3 + times_2(fCoefs.fB) * h2);
-        fFwDiff[1] = to_point(fCoefs.fA * h3 + fCoefs.fB * h2 + fCoefs.fC * h);
-        fFwDiff[0] = to_point(fCoefs.fD);
-    }
-
-    /**
-     * Check if the evaluator is still within the range of 0<=t<=1
-     */
-    bool done() const {
-        return fCurrent > fMax;
-    }
-
-    /**
-     * Call next to obtain the SkPoint sampled and move to the next one.
-     */
-    SkPoint next() {
-        SkPoint point = fFwDiff[0];
-        fFwDiff[0]    += fFwDiff[1];
-        fFwDiff[1]    += fFwDiff[2];
-        fFwDiff[2]    += fFwDiff[3];
-        fCurrent++;
-        return point;
-    }
-
-    const SkPoint* getCtrlPoints() const {
-        return fPoints;
+    Sk4f eval(SkScalar t) const {
+        Sk4f tt(t);
+        return ((fA * tt + fB) * tt + fC) * tt + fD;
     }
 
 private:
-    SkCubicCoeff fCoefs;
-    int fMax, fCurrent, fDivisions;
-    SkPoint fFwDiff[4], fPoints[4];
+    Sk4f fA, fB, fC, fD;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
 
-// size in pixels of each partition per axis, adjust this knob
-static const int kPartitionSize = 10;
+// Screen-space distance, in pixels, the triangles may stray from the patch, adjust this knob.
+static const SkScalar kTolerance = 1;
+
+// Largest screen-space size of each partition per axis. Colors and texture coordinates are only
+// interpolated linearly across each triangle, so even flat patches get split this often.
+static const SkScalar kMaxPartitionSize = 32;
+
+// Keeps huge or non-finite estimates finite; getVertexData() scales the detail back down anyway.
+static const SkScalar kMaxLevelOfDetail = 10000;
 
 /**
  * Calculate the approximate arc length given a bezier curve's control points.
  */
-static SkScalar approx_arc_length(SkPoint* points, int count) {
+static SkScalar approx_arc_length(const SkPoint* points, int count) {
     if (count < 2) {
         return 0;
     }
@@ -107,38 +62,66 @@ static SkScalar approx_arc_length(SkPoint* points, int count) {
     return arcLength;
 }
 
-static SkScalar bilerp(SkScalar tx, SkScalar ty, SkScalar c00, SkScalar c10, SkScalar c01,
-                      SkScalar c11) {
-    SkScalar a = c00 * (1.f - tx) + c10 * tx;
-    SkScalar b = c01 * (1.f - tx) + c11 * tx;
-    return a * (1.f - ty) + b * ty;
+/**
+ * Bound on the length of a cubic's second derivative: it is a line between 6 * (p0 - 2p1 + p2)
+ * and 6 * (p1 - 2p2 + p3).
+ */
+static SkScalar max_second_derivative(const SkPoint pts[4]) {
+    SkVector d0 = pts[0] - pts[1] - pts[1] + pts[2];
+    SkVector d1 = pts[1] - pts[2] - pts[2] + pts[3];
+    return 6 * SkMaxScalar(d0.length(), d1.length());
 }
 
-SkISize SkPatchUtils::GetLevelOfDetail(const SkPoint cubics[12], const SkMatrix* matrix) {
-
-    // Approximate length of each cubic.
-    SkPoint pts[kNumPtsCubic];
-    SkPatchUtils::getTopCubic(cubics, pts);
-    matrix->mapPoints(pts, kNumPtsCubic);
-    SkScalar topLength = approx_arc_length(pts, kNumPtsCubic);
-
-    SkPatchUtils::getBottomCubic(cubics, pts);
-    matrix->mapPoints(pts, kNumPtsCubic);
-    SkScalar bottomLength = approx_arc_length(pts, kNumPtsCubic);
-
-    SkPatchUtils::getLeftCubic(cubics, pts);
-    matrix->mapPoints(pts, kNumPtsCubic);
-    SkScalar leftLength = approx_arc_length(pts, kNumPtsCubic);
-
-    SkPatchUtils::getRightCubic(cubics, pts);
-    matrix->mapPoints(pts, kNumPtsCubic);
-    SkScalar rightLength = approx_arc_length(pts, kNumPtsCubic);
+/**
+ * Bound on the length of the difference of the first derivatives of two cubics, which is a
+ * quadratic with control points 3 * ((b[i+1] - b[i]) - (a[i+1] - a[i])).
+ */
+static SkScalar max_derivative_difference(const SkPoint a[4], const SkPoint b[4]) {
+    SkScalar maxLength = 0;
+    for (int i = 0; i < 3; i++) {
+        SkVector d = (b[i + 1] - b[i]) - (a[i + 1] - a[i]);
+        maxLength = SkMaxScalar(maxLength, d.length());
+    }
+    return 3 * maxLength;
+}
 
-    // Level of detail per axis, based on the larger side between top and bottom or left and right
-    int lodX = static_cast<int>(SkMaxScalar(topLength, bottomLength) / kPartitionSize);
-    int lodY = static_cast<int>(SkMaxScalar(leftLength, rightLength) / kPartitionSize);
+static int level_of_detail(SkScalar curvature, SkScalar twist, SkScalar arcLength) {
+    SkScalar lod = SkMaxScalar(SkScalarSqrt((curvature + twist) / (4 * kTolerance)),
+                               arcLength / kMaxPartitionSize);
+    if (!(lod < kMaxLevelOfDetail)) {
+        lod = kMaxLevelOfDetail;
+    }
+    return SkMax32(1, SkScalarCeilToInt(lod));
+}
 
-    return SkISize::Make(SkMax32(8, lodX), SkMax32(8, lodY));
+SkISize SkPatchUtils::GetLevelOfDetail(const SkPoint cubics[12], const SkMatrix* matrix) {
+    SkPoint devCubics[kNumCtrlPts];
+    matrix->mapPoints(devCubics, cubics, kNumCtrlPts);
+
+    SkPoint top[kNumPtsCubic], bottom[kNumPtsCubic], left[kNumPtsCubic], right[kNumPtsCubic];
+    SkPatchUtils::getTopCubic(devCubics, top);
+    SkPatchUtils::getBottomCubic(devCubics, bottom);
+    SkPatchUtils::getLeftCubic(devCubics, left);
+    SkPatchUtils::getRightCubic(devCubics, right);
+
+    // Triangulating a surface S(u, v) with steps of hu and hv misses it by at most
+    // (hu^2 |Suu| + 2 hu hv |Suv| + hv^2 |Svv|) / 8. For a coons patch Suu blends the second
+    // derivatives of the top and bottom cubics, Svv those of the left and right ones, and Suv is
+    // the twist left by the difference of opposite sides and the corners. Splitting each axis
+    // into sqrt((curvature + twist) / (4 * tolerance)) steps keeps that below the tolerance.
+    SkScalar curvatureX = SkMaxScalar(max_second_derivative(top), max_second_derivative(bottom));
+    SkScalar curvatureY = SkMaxScalar(max_second_derivative(left), max_second_derivative(right));
+    SkVector corners = (bottom[3] - bottom[0]) - (top[3] - top[0]);
+    SkScalar twist = max_derivative_difference(top, bottom) +
+                     max_derivative_difference(left, right) + corners.length();
+
+    SkScalar lengthX = SkMaxScalar(approx_arc_length(top, kNumPtsCubic),
+                                   approx_arc_length(bottom, kNumPtsCubic));
+    SkScalar lengthY = SkMaxScalar(approx_arc_length(left, kNumPtsCubic),
+                                   approx_arc_length(right, kNumPtsCubic));
+
+    return SkISize::Make(level_of_detail(curvatureX, twist, lengthX),
+                         level_of_detail(curvatureY, twist, lengthY));
 }
 
 void SkPatchUtils::getTopCubic(const SkPoint cubics[12], SkPoint points[4]) {
@@ -169,6 +152,7 @@ void SkPatchUtils::getRightCubic(const SkPoint cubics[12], SkPoint points[4]) {
     points[3] = cubics[kRightP3_CubicCtrlPts];
 }
 
+
 bool SkPatchUtils::getVertexData(SkPatchUtils::VertexData* data, const SkPoint cubics[12],
                    const SkColor colors[4], const SkPoint texCoords[4], int lodX, int lodY) {
     if (lodX < 1 || lodY < 1 || nullptr == cubics || nullptr == data) {
@@ -192,8 +176,8 @@ bool SkPatchUtils::getVertexData(SkPatchUtils::VertexData* data, const SkPoint c
 
         // 200 comes from the 100 * 2 which is the max value of vertices because of the limit of
         // 60000 indices ( sqrt(60000 / 6) that comes from data->fIndexCount = lodX * lodY * 6)
-        lodX = static_cast<int>(weightX * 200);
-        lodY = static_cast<int>(weightY * 200);
+        lodX = SkMax32(1, static_cast<int>(weightX * 200));
+        lodY = SkMax32(1, static_cast<int>(weightY * 200));
         data->fVertexCount = (lodX + 1) * (lodY + 1);
     }
     data->fIndexCount = lodX * lodY * 6;
@@ -202,11 +186,12 @@ bool SkPatchUtils::getVertexData(SkPatchUtils::VertexData* data, const SkPoint c
     data->fIndices = new uint16_t[data->fIndexCount];
 
     // if colors is not null then create array for colors
-    SkPMColor colorsPM[kNumCorners];
+    Sk4f colorsPM[kNumCorners];
     if (colors) {
         // premultiply colors to avoid color bleeding.
         for (int i = 0; i < kNumCorners; i++) {
-            colorsPM[i] = SkPreMultiplyColor(colors[i]);
+            SkPMColor pm = SkPreMultiplyColor(colors[i]);
+            colorsPM[i] = SkNx_cast<float>(Sk4b::Load(&pm));
         }
         data->fColors = new uint32_t[data->fVertexCount];
     }
@@ -216,84 +201,89 @@ bool SkPatchUtils::getVertexData(SkPatchUtils::VertexData* data, const SkPoint c
         data->fTexCoords = new SkPoint[data->fVertexCount];
     }
 
-    SkPoint pts[kNumPtsCubic];
-    SkPatchUtils::getBottomCubic(cubics, pts);
-    FwDCubicEvaluator fBottom(pts);
-    SkPatchUtils::getTopCubic(cubics, pts);
-    FwDCubicEvaluator fTop(pts);
-    SkPatchUtils::getLeftCubic(cubics, pts);
-    FwDCubicEvaluator fLeft(pts);
-    SkPatchUtils::getRightCubic(cubics, pts);
-    FwDCubicEvaluator fRight(pts);
-
-    fBottom.restart(lodX);
-    fTop.restart(lodX);
-
-    SkScalar u = 0.0f;
+    SkPoint top[kNumPtsCubic], bottom[kNumPtsCubic], left[kNumPtsCubic], right[kNumPtsCubic];
+    SkPatchUtils::getTopCubic(cubics, top);
+    SkPatchUtils::getBottomCubic(cubics, bottom);
+    SkPatchUtils::getLeftCubic(cubics, left);
+    SkPatchUtils::getRightCubic(cubics, right);
+    const CubicPairEvaluator topBottom(top, bottom), leftRight(left, right);
+
+    // The coons patch is
+    //   S(u, v) = (1 - v) T(u) + v B(u) + (1 - u) L(v) + u R(v) - bilerp of the corners.
+    // Folding the corners into the top and bottom cubics leaves
+    //   S(u, v) = T'(u) + v (B'(u) - T'(u)) + L(v) + u (R(v) - L(v)),
+    // so the left and right cubics are sampled once for the whole patch, the top and bottom ones
+    // once per column, and each vertex costs a couple of multiply-adds. The per row values are
+    // laid out as a point per row, so the vertices are computed two at a time in Sk4f.
     int stride = lodY + 1;
+    int paddedStride = SkAlign2(stride);
+    SkAutoSTMalloc<3 * 2 * 64, SkScalar> rowStorage(3 * 2 * paddedStride);
+    SkScalar* rowV = rowStorage.get();
+    SkScalar* rowLeft = rowV + 2 * paddedStride;
+    SkScalar* rowDelta = rowLeft + 2 * paddedStride;
+    for (int y = 0; y < paddedStride; y++) {
+        SkScalar v = SkTMin(SkIntToScalar(y) / lodY, 1.f);
+        SkScalar lr[4];
+        leftRight.eval(v).store(lr);
+        rowV[2 * y] = rowV[2 * y + 1] = v;
+        rowLeft[2 * y] = lr[0];
+        rowLeft[2 * y + 1] = lr[1];
+        rowDelta[2 * y] = lr[2] - lr[0];
+        rowDelta[2 * y + 1] = lr[3] - lr[1];
+    }
+
+    const Sk4f cornersLeft(top[0].x(), top[0].y(), bottom[0].x(), bottom[0].y());
+    const Sk4f cornersRight(top[3].x(), top[3].y(), bottom[3].x(), bottom[3].y());
     for (int x = 0; x <= lodX; x++) {
-        SkPoint bottom = fBottom.next(), top = fTop.next();
-        fLeft.restart(lodY);
-        fRight.restart(lodY);
-        SkScalar v = 0.f;
-        for (int y = 0; y <= lodY; y++) {
-            int dataIndex = x * (lodY + 1) + y;
-
-            SkPoint left = fLeft.next(), right = fRight.next();
-
-            SkPoint s0 = SkPoint::Make((1.0f - v) * top.x() + v * bottom.x(),
-                                       (1.0f - v) * top.y() + v * bottom.y());
-            SkPoint s1 = SkPoint::Make((1.0f - u) * left.x() + u * right.x(),
-                                       (1.0f - u) * left.y() + u * right.y());
-            SkPoint s2 = SkPoint::Make(
-                                       (1.0f - v) * ((1.0f - u) * fTop.getCtrlPoints()[0].x()
-                                                     + u * fTop.getCtrlPoints()[3].x())
-                                       + v * ((1.0f - u) * fBottom.getCtrlPoints()[0].x()
-                                              + u * fBottom.getCtrlPoints()[3].x()),
-                                       (1.0f - v) * ((1.0f - u) * fTop.getCtrlPoints()[0].y()
-                                                     + u * fTop.getCtrlPoints()[3].y())
-                                       + v * ((1.0f - u) * fBottom.getCtrlPoints()[0].y()
-                                              + u * fBottom.getCtrlPoints()[3].y()));
-            data->fPoints[dataIndex] = s0 + s1 - s2;
-
-            if (colors) {
-                uint8_t a = uint8_t(bilerp(u, v,
-                                   SkScalar(SkColorGetA(colorsPM[kTopLeft_Corner])),
-                                   SkScalar(SkColorGetA(colorsPM[kTopRight_Corner])),
-                                   SkScalar(SkColorGetA(colorsPM[kBottomLeft_Corner])),
-                                   SkScalar(SkColorGetA(colorsPM[kBottomRight_Corner]))));
-                uint8_t r = uint8_t(bilerp(u, v,
-                                   SkScalar(SkColorGetR(colorsPM[kTopLeft_Corner])),
-                                   SkScalar(SkColorGetR(colorsPM[kTopRight_Corner])),
-                                   SkScalar(SkColorGetR(colorsPM[kBottomLeft_Corner])),
-                                   SkScalar(SkColorGetR(colorsPM[kBottomRight_Corner]))));
-                uint8_t g = uint8_t(bilerp(u, v,
-                                   SkScalar(SkColorGetG(colorsPM[kTopLeft_Corner])),
-                                   SkScalar(SkColorGetG(colorsPM[kTopRight_Corner])),
-                                   SkScalar(SkColorGetG(colorsPM[kBottomLeft_Corner])),
-                                   SkScalar(SkColorGetG(colorsPM[kBottomRight_Corner]))));
-                uint8_t b = uint8_t(bilerp(u, v,
-                                   SkScalar(SkColorGetB(colorsPM[kTopLeft_Corner])),
-                                   SkScalar(SkColorGetB(colorsPM[kTopRight_Corner])),
-                                   SkScalar(SkColorGetB(colorsPM[kBottomLeft_Corner])),
-                                   SkScalar(SkColorGetB(colorsPM[kBottomRight_Corner]))));
-                data->fColors[dataIndex] = SkPackARGB32(a,r,g,b);
+        SkScalar u = SkIntToScalar(x) / lodX;
+        Sk4f uu(u);
+        SkScalar tb[4];
+        (topBottom.eval(u) - (cornersLeft + uu * (cornersRight - cornersLeft))).store(tb);
+        Sk4f topPt(tb[0], tb[1], tb[0], tb[1]);
+        Sk4f deltaPt(tb[2] - tb[0], tb[3] - tb[1], tb[2] - tb[0], tb[3] - tb[1]);
+
+        SkScalar* dst = &data->fPoints[x * stride].fX;
+        for (int y = 0; y < stride; y += 2) {
+            Sk4f pts = topPt + Sk4f::Load(rowV + 2 * y) * deltaPt +
+                       Sk4f::Load(rowLeft + 2 * y) + uu * Sk4f::Load(rowDelta + 2 * y);
+            if (y + 1 < stride) {
+                pts.store(dst + 2 * y);
+            } else {
+                SkScalar last[4];
+                pts.store(last);
+                dst[2 * y] = last[0];
+                dst[2 * y + 1] = last[1];
             }
+        }
 
-            if (texCoords) {
-                data->fTexCoords[dataIndex] = SkPoint::Make(
-                                            bilerp(u, v, texCoords[kTopLeft_Corner].x(),
-                                                   texCoords[kTopRight_Corner].x(),
-                                                   texCoords[kBottomLeft_Corner].x(),
-                                                   texCoords[kBottomRight_Corner].x()),
-                                            bilerp(u, v, texCoords[kTopLeft_Corner].y(),
-                                                   texCoords[kTopRight_Corner].y(),
-                                                   texCoords[kBottomLeft_Corner].y(),
-                                                   texCoords[kBottomRight_Corner].y()));
+        if (colors) {
+            Sk4f colorTop = colorsPM[kTopLeft_Corner] +
+                            uu * (colorsPM[kTopRight_Corner] - colorsPM[kTopLeft_Corner]);
+            Sk4f colorBottom = colorsPM[kBottomLeft_Corner] +
+                               uu * (colorsPM[kBottomRight_Corner] - colorsPM[kBottomLeft_Corner]);
+            Sk4f colorDelta = colorBottom - colorTop;
+            uint32_t* dstColors = data->fColors + x * stride;
+            for (int y = 0; y < stride; y++) {
+                SkNx_cast<uint8_t>(colorTop + Sk4f(rowV[2 * y]) * colorDelta).store(dstColors + y);
+            }
+        }
 
+        if (texCoords) {
+            Sk2s texTop = from_point(texCoords[kTopLeft_Corner]) +
+                          Sk2s(u) * (from_point(texCoords[kTopRight_Corner]) -
+                                     from_point(texCoords[kTopLeft_Corner]));
+            Sk2s texBottom = from_point(texCoords[kBottomLeft_Corner]) +
+                             Sk2s(u) * (from_point(texCoords[kBottomRight_Corner]) -
+                                        from_point(texCoords[kBottomLeft_Corner]));
+            Sk2s texDelta = texBottom - texTop;
+            SkPoint* dstTexs = data->fTexCoords + x * stride;
+            for (int y = 0; y < stride; y++) {
+                dstTexs[y] = to_point(texTop + Sk2s(rowV[2 * y]) * texDelta);
             }
+        }
 
-            if(x < lodX && y < lodY) {
+        if (x < lodX) {
+            for (int y = 0; y < lodY; y++) {
                 int i = 6 * (x * lodY + y);
                 data->fIndices[i] = x * stride + y;
                 data->fIndices[i + 1] = x * stride + 1 + y;
@@ -302,10 +292,7 @@ bool SkPatchUtils::getVertexData(SkPatchUtils::VertexData* data, const SkPoint c
                 data->fIndices[i + 4] = data->fIndices[i + 2];
                 data->fIndices[i + 5] = (x + 1) * stride + y;
             }
-            v = SkScalarClampMax(v + 1.f / lodY, 1);
         }
-        u = SkScalarClampMax(u + 1.f / lodX, 1);
     }
     return true;
-
 }
@@ -0,0 +1,569 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkData.h"
+#include "SkImage.h"
+#include "SkImageFilter.h"
+#include "SkPipe.h"
+#include "SkPipeFormat.h"
+#include "SkPixelSerializer.h"
+#include "SkPtrRecorder.h"
+#include "SkRRect.h"
+#include "SkRSXform.h"
+#include "SkStream.h"
+#include "SkTHash.h"
+#include "SkTemplates.h"
+#include "SkTextBlob.h"
+#include "SkTypeface.h"
+#include "SkWriteBuffer.h"
+
+class SkPipeWriter;
+
+// Hands the images a paint refers to (e.g. through an SkImageShader) to the writer to define,
+// so the flattened paint names them by ID instead of carrying their pixels.
+class SkPipeImageRecorder : public SkPixelSerializer {
+public:
+    explicit SkPipeImageRecorder(SkPipeWriter* writer) : fWriter(writer) {}
+
+protected:
+    bool onUseEncodedData(const void*, size_t) override { return true; }
+    SkData* onEncode(const SkPixmap&) override { return nullptr; }
+    SkData* onRefImageReference(const SkImage* image) override;
+
+private:
+    SkPipeWriter* fWriter;
+};
+
+// Writes the commands of the current frame, and remembers the resources sent so far.  The
+// ID of a resource defines it first, if this is the first time it's been used.
+class SkPipeWriter {
+public:
+    SkPipeWriter()
+        : fTypefacesDefined(0)
+        , fImageRecorder(new SkPipeImageRecorder(this))
+        , fResetPending(false) {}
+
+    SkBinaryWriteBuffer* beginFrame() {
+        fBuffer.reset(new SkBinaryWriteBuffer);
+        if (fResetPending) {
+            this->write(SkPipeVerb::kReset);
+            fResetPending = false;
+        }
+        return fBuffer.get();
+    }
+
+    void endFrame(SkWStream* stream) {
+        const size_t size = fBuffer->bytesWritten();
+        SkAutoTMalloc<char> storage(size);
+        fBuffer->writeToMemory(storage.get());
+        stream->write32(SkToU32(size));
+        stream->write(storage.get(), size);
+        fBuffer.reset(nullptr);
+    }
+
+    void resetCache() {
+        fTypefaces.reset();
+        fTypefacesDefined = 0;
+        fImageIDs.reset();
+        fPathIDs.reset();
+        fPaintIDs.reset();
+        fTextBlobIDs.reset();
+        fResetPending = true;
+    }
+
+    void write(SkPipeVerb verb, unsigned arg = 0) { fBuffer->writeUInt(SkPipePack(verb, arg)); }
+
+    unsigned imageID(const SkImage* image) {
+        if (const unsigned* id = fImageIDs.find(image->uniqueID())) {
+            return *id;
+        }
+        this->write(SkPipeVerb::kDefineImage);
+        fBuffer->writeImage(image);
+        return *fImageIDs.set(image->uniqueID(), NextID(fImageIDs.count()));
+    }
+
+    unsigned paintID(const SkPaint& paint) {
+        sk_sp<SkData> flat(this->flattenResource([&](SkWriteBuffer& buffer) {
+            buffer.writePaint(paint);
+        }));
+        const SkString key(static_cast<const char*>(flat->data()), flat->size());
+        if (const unsigned* id = fPaintIDs.find(key)) {
+            return *id;
+        }
+        this->write(SkPipeVerb::kDefinePaint);
+        fBuffer->writeDataAsByteArray(flat.get());
+        return *fPaintIDs.set(key, NextID(fPaintIDs.count()));
+    }
+
+    unsigned paintID(const SkPaint* paint) { return paint ? this->paintID(*paint) : 0; }
+
+    unsigned pathID(const SkPath& path) {
+        // The generation ID doesn't cover the fill type on every platform.
+        const uint64_t key = (uint64_t)path.getGenerationID() << 32 | path.getFillType();
+        if (const unsigned* id = fPathIDs.find(key)) {
+            return *id;
+        }
+        this->write(SkPipeVerb::kDefinePath);
+        fBuffer->writePath(path);
+        return *fPathIDs.set(key, NextID(fPathIDs.count()));
+    }
+
+    unsigned textBlobID(const SkTextBlob* blob) {
+        if (const unsigned* id = fTextBlobIDs.find(blob->uniqueID())) {
+            return *id;
+        }
+        sk_sp<SkData> flat(this->flattenResource([&](SkWriteBuffer& buffer) {
+            blob->flatten(buffer);
+        }));
+        this->write(SkPipeVerb::kDefineTextBlob);
+        fBuffer->writeDataAsByteArray(flat.get());
+        return *fTextBlobIDs.set(blob->uniqueID(), NextID(fTextBlobIDs.count()));
+    }
+
+    // Flattens an object the way flatten writes it into a buffer of its own, defining any
+    // typefaces and images it uses that the reader doesn't have yet.
+    template <typename Fn>
+    sk_sp<SkData> flattenResource(Fn&& flatten) {
+        SkBinaryWriteBuffer buffer;
+        buffer.setTypefaceRecorder(&fTypefaces);
+        buffer.setPixelSerializer(fImageRecorder.get());
+        flatten(buffer);
+
+        if (fTypefaces.count() > fTypefacesDefined) {
+            SkAutoTArray<SkRefCnt*> typefaces(fTypefaces.count());
+            fTypefaces.copyToArray(typefaces.get());
+            for (; fTypefacesDefined < fTypefaces.count(); fTypefacesDefined++) {
+                SkDynamicMemoryWStream stream;
+                static_cast<SkTypeface*>(typefaces[fTypefacesDefined])->serialize(&stream);
+                sk_sp<SkData> data(stream.copyToData());
+                this->write(SkPipeVerb::kDefineTypeface);
+                fBuffer->writeDataAsByteArray(data.get());
+            }
+        }
+
+        sk_sp<SkData> data(SkData::MakeUninitialized(buffer.bytesWritten()));
+        buffer.writeToMemory(data->writable_data());
+        return data;
+    }
+
+private:
+    static unsigned NextID(int count) {
+        SkASSERT((unsigned)count < kPipeMaxID);
+        return count + 1;
+    }
+
+    std::unique_ptr<SkBinaryWriteBuffer>    fBuffer;
+
+    SkRefCntSet                             fTypefaces;
+    int                                     fTypefacesDefined;
+    SkTHashMap<uint32_t, unsigned>          fImageIDs;      // by SkImage::uniqueID()
+    SkTHashMap<uint64_t, unsigned>          fPathIDs;       // by generation ID and fill type
+    SkTHashMap<SkString, unsigned>          fPaintIDs;      // by flattened paint
+    SkTHashMap<uint32_t, unsigned>          fTextBlobIDs;   // by SkTextBlob::uniqueID()
+    sk_sp<SkPipeImageRecorder>              fImageRecorder;
+    bool                                    fResetPending;
+};
+
+SkData* SkPipeImageRecorder::onRefImageReference(const SkImage* image) {
+    const uint32_t id = fWriter->imageID(image);
+    return SkData::NewWithCopy(&id, sizeof(id));
+}
+
+// Records one frame.  Its bounds start at the origin, as SkCanvas' public constructors' do,
+// so they cover the cull rect unless it reaches into negative coordinates.
+class SkPipeCanvas : public SkCanvas {
+public:
+    SkPipeCanvas(const SkRect& cullBounds, SkPipeWriter* pipe)
+        : INHERITED(SkScalarCeilToInt(cullBounds.right()),
+                    SkScalarCeilToInt(cullBounds.bottom()))
+        , fPipe(pipe)
+        , fWriter(pipe->beginFrame()) {}
+
+protected:
+    void willSave() override;
+    SaveLayerStrategy getSaveLayerStrategy(const SaveLayerRec&) override;
+    void willRestore() override;
+
+    void didConcat(const SkMatrix&) override;
+    void didSetMatrix(const SkMatrix&) override;
+
+    void onDrawAnnotation(const SkRect&, const char[], SkData*) override;
+    void onDrawDRRect(const SkRRect&, const SkRRect&, const SkPaint&) override;
+    void onDrawText(const void* text, size_t byteLength, SkScalar x, SkScalar y,
+                    const SkPaint&) override;
+    void onDrawPosText(const void* text, size_t byteLength, const SkPoint pos[],
+                       const SkPaint&) override;
+    void onDrawPosTextH(const void* text, size_t byteLength, const SkScalar xpos[],
+                        SkScalar constY, const SkPaint&) override;
+    void onDrawTextOnPath(const void* text, size_t byteLength, const SkPath& path,
+                          const SkMatrix* matrix, const SkPaint&) override;
+    void onDrawTextRSXform(const void* text, size_t byteLength, const SkRSXform xform[],
+                           const SkRect* cull, const SkPaint&) override;
+    void onDrawTextBlob(const SkTextBlob* blob, SkScalar x, SkScalar y,
+                        const SkPaint& paint) override;
+    void onDrawPatch(const SkPoint cubics[12], const SkColor colors[4],
+                     const SkPoint texCoords[4], SkXfermode* xmode, const SkPaint&) override;
+
+    void onDrawPaint(const SkPaint&) override;
+    void onDrawPoints(PointMode, size_t count, const SkPoint pts[], const SkPaint&) override;
+    void onDrawRect(const SkRect&, const SkPaint&) override;
+    void onDrawOval(const SkRect&, const SkPaint&) override;
+    void onDrawRRect(const SkRRect&, const SkPaint&) override;
+    void onDrawPath(const SkPath&, const SkPaint&) override;
+    void onDrawImage(const SkImage*, SkScalar left, SkScalar top, const SkPaint*) override;
+    void onDrawImageRect(const SkImage*, const SkRect* src, const SkRect& dst, const SkPaint*,
+                         SrcRectConstraint) override;
+    void onDrawImageNine(const SkImage*, const SkIRect& center, const SkRect& dst,
+                         const SkPaint*) override;
+    void onDrawBitmap(const SkBitmap&, SkScalar left, SkScalar top, const SkPaint*) override;
+    void onDrawBitmapRect(const SkBitmap&, const SkRect* src, const SkRect& dst, const SkPaint*,
+                          SrcRectConstraint) override;
+    void onDrawBitmapNine(const SkBitmap&, const SkIRect& center, const SkRect& dst,
+                          const SkPaint*) override;
+    void onDrawAtlas(const SkImage*, const SkRSXform[], const SkRect[], const SkColor[],
+                     int count, SkXfermode::Mode, const SkRect* cull, const SkPaint*) override;
+    void onDrawVertices(VertexMode, int vertexCount, const SkPoint vertices[],
+                        const SkPoint texs[], const SkColor colors[], SkXfermode*,
+                        const uint16_t indices[], int indexCount, const SkPaint&) override;
+
+    void onClipRect(const SkRect&, SkRegion::Op, ClipEdgeStyle) override;
+    void onClipRRect(const SkRRect&, SkRegion::Op, ClipEdgeStyle) override;
+    void onClipPath(const SkPath&, SkRegion::Op, ClipEdgeStyle) override;
+    void onClipRegion(const SkRegion&, SkRegion::Op) override;
+
+private:
+    void write(SkPipeVerb verb, unsigned arg = 0) { fPipe->write(verb, arg); }
+
+    void writeRRect(const SkRRect& rrect) {
+        char storage[SkRRect::kSizeInMemory];
+        rrect.writeToMemory(storage);
+        fWriter->writeByteArray(storage, sizeof(storage));
+    }
+
+    void writeOptionalRect(const SkRect* rect) {
+        fWriter->writeBool(rect != nullptr);
+        if (rect) {
+            fWriter->writeRect(*rect);
+        }
+    }
+
+    // Begins a draw of an image or bitmap, which may have no paint.  The image is defined
+    // first, and so is the paint, so that neither lands in the middle of the draw's arguments.
+    void writeImageDraw(SkPipeVerb verb, const SkImage* image, const SkPaint* paint) {
+        const unsigned imageID = fPipe->imageID(image);
+        this->write(verb, fPipe->paintID(paint));
+        fWriter->writeUInt(imageID);
+    }
+
+    static unsigned ClipArg(SkRegion::Op op, ClipEdgeStyle edgeStyle) {
+        return op | (edgeStyle << 8);
+    }
+
+    SkPipeWriter*           fPipe;
+    SkBinaryWriteBuffer*    fWriter;
+
+    typedef SkCanvas INHERITED;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SkPipeCanvas::willSave() {
+    this->write(SkPipeVerb::kSave);
+    this->INHERITED::willSave();
+}
+
+SkCanvas::SaveLayerStrategy SkPipeCanvas::getSaveLayerStrategy(const SaveLayerRec& rec) {
+    sk_sp<SkData> backdrop;
+    if (rec.fBackdrop) {
+        backdrop = fPipe->flattenResource([&](SkWriteBuffer& buffer) {
+            buffer.writeFlattenable(rec.fBackdrop);
+        });
+    }
+    this->write(SkPipeVerb::kSaveLayer, fPipe->paintID(rec.fPaint));
+    fWriter->writeUInt(rec.fSaveLayerFlags);
+    this->writeOptionalRect(rec.fBounds);
+    fWriter->writeBool(backdrop != nullptr);
+    if (backdrop) {
+        fWriter->writeDataAsByteArray(backdrop.get());
+    }
+    this->INHERITED::getSaveLayerStrategy(rec);
+    return kNoLayer_SaveLayerStrategy;
+}
+
+void SkPipeCanvas::willRestore() {
+    this->write(SkPipeVerb::kRestore);
+    this->INHERITED::willRestore();
+}
+
+void SkPipeCanvas::didConcat(const SkMatrix& matrix) {
+    this->write(SkPipeVerb::kConcat);
+    fWriter->writeMatrix(matrix);
+    this->INHERITED::didConcat(matrix);
+}
+
+void SkPipeCanvas::didSetMatrix(const SkMatrix& matrix) {
+    this->write(SkPipeVerb::kSetMatrix);
+    fWriter->writeMatrix(matrix);
+    this->INHERITED::didSetMatrix(matrix);
+}
+
+void SkPipeCanvas::onClipRect(const SkRect& rect, SkRegion::Op op, ClipEdgeStyle edgeStyle) {
+    this->write(SkPipeVerb::kClipRect, ClipArg(op, edgeStyle));
+    fWriter->writeRect(rect);
+    this->INHERITED::onClipRect(rect, op, edgeStyle);
+}
+
+void SkPipeCanvas::onClipRRect(const SkRRect& rrect, SkRegion::Op op, ClipEdgeStyle edgeStyle) {
+    this->write(SkPipeVerb::kClipRRect, ClipArg(op, edgeStyle));
+    this->writeRRect(rrect);
+    this->INHERITED::onClipRRect(rrect, op, edgeStyle);
+}
+
+void SkPipeCanvas::onClipPath(const SkPath& path, SkRegion::Op op, ClipEdgeStyle edgeStyle) {
+    const unsigned id = fPipe->pathID(path);
+    this->write(SkPipeVerb::kClipPath, ClipArg(op, edgeStyle));
+    fWriter->writeUInt(id);
+    this->INHERITED::onClipPath(path, op, edgeStyle);
+}
+
+void SkPipeCanvas::onClipRegion(const SkRegion& region, SkRegion::Op op) {
+    this->write(SkPipeVerb::kClipRegion, op);
+    fWriter->writeRegion(region);
+    this->INHERITED::onClipRegion(region, op);
+}
+
+void SkPipeCanvas::onDrawPaint(const SkPaint& paint) {
+    this->write(SkPipeVerb::kDrawPaint, fPipe->paintID(paint));
+}
+
+void SkPipeCanvas::onDrawPoints(PointMode mode, size_t count, const SkPoint pts[],
+                                const SkPaint& paint) {
+    this->write(SkPipeVerb::kDrawPoints, fPipe->paintID(paint));
+    fWriter->writeUInt(mode);
+    fWriter->writePointArray(pts, SkToU32(count));
+}
+
+void SkPipeCanvas::onDrawRect(const SkRect& rect, const SkPaint& paint) {
+    this->write(SkPipeVerb::kDrawRect, fPipe->paintID(paint));
+    fWriter->writeRect(rect);
+}
+
+void SkPipeCanvas::onDrawOval(const SkRect& rect, const SkPaint& paint) {
+    this->write(SkPipeVerb::kDrawOval, fPipe->paintID(paint));
+    fWriter->writeRect(rect);
+}
+
+void SkPipeCanvas::onDrawRRect(const SkRRect& rrect, const SkPaint& paint) {
+    this->write(SkPipeVerb::kDrawRRect, fPipe->paintID(paint));
+    this->writeRRect(rrect);
+}
+
+void SkPipeCanvas::onDrawDRRect(const SkRRect& outer, const SkRRect& inner,
+                                const SkPaint& paint) {
+    this->write(SkPipeVerb::kDrawDRRect, fPipe->paintID(paint));
+    this->writeRRect(outer);
+    this->writeRRect(inner);
+}
+
+void SkPipeCanvas::onDrawPath(const SkPath& path, const SkPaint& paint) {
+    const unsigned id = fPipe->pathID(path);
+    this->write(SkPipeVerb::kDrawPath, fPipe->paintID(paint));
+    fWriter->writeUInt(id);
+}
+
+void SkPipeCanvas::onDrawText(const void* text, size_t byteLength, SkScalar x, SkScalar y,
+                              const SkPaint& paint) {
+    this->write(SkPipeVerb::kDrawText, fPipe->paintID(paint));
+    fWriter->writeByteArray(text, byteLength);
+    fWriter->writeScalar(x);
+    fWriter->writeScalar(y);
+}
+
+void SkPipeCanvas::onDrawPosText(const void* text, size_t byteLength, const SkPoint pos[],
+                                 const SkPaint& paint) {
+    this->write(SkPipeVerb::kDrawPosText, fPipe->paintID(paint));
+    fWriter->writeByteArray(text, byteLength);
+    fWriter->writePointArray(pos, paint.countText(text, byteLength));
+}
+
+void SkPipeCanvas::onDrawPosTextH(const void* text, size_t byteLength, const SkScalar xpos[],
+                                  SkScalar constY, const SkPaint& paint) {
+    this->write(SkPipeVerb::kDrawPosTextH, fPipe->paintID(paint));
+    fWriter->writeByteArray(text, byteLength);
+    fWriter->writeScalarArray(xpos, paint.countText(text, byteLength));
+    fWriter->writeScalar(constY);
+}
+
+void SkPipeCanvas::onDrawTextOnPath(const void* text, size_t byteLength, const SkPath& path,
+                                    const SkMatrix* matrix, const SkPaint& paint) {
+    const unsigned id = fPipe->pathID(path);
+    this->write(SkPipeVerb::kDrawTextOnPath, fPipe->paintID(paint));
+    fWriter->writeByteArray(text, byteLength);
+    fWriter->writeUInt(id);
+    fWriter->writeBool(matrix != nullptr);
+    if (matrix) {
+        fWriter->writeMatrix(*matrix);
+    }
+}
+
+void SkPipeCanvas::onDrawTextRSXform(const void* text, size_t byteLength,
+                                     const SkRSXform xform[], const SkRect* cull,
+                                     const SkPaint& paint) {
+    this->write(SkPipeVerb::kDrawTextRSXform, fPipe->paintID(paint));
+    fWriter->writeByteArray(text, byteLength);
+    fWriter->writeScalarArray(&xform[0].fSCos, paint.countText(text, byteLength) * 4);
+    this->writeOptionalRect(cull);
+}
+
+void SkPipeCanvas::onDrawTextBlob(const SkTextBlob* blob, SkScalar x, SkScalar y,
+                                  const SkPaint& paint) {
+    const unsigned id = fPipe->textBlobID(blob);
+    this->write(SkPipeVerb::kDrawTextBlob, fPipe->paintID(paint));
+    fWriter->writeUInt(id);
+    fWriter->writeScalar(x);
+    fWriter->writeScalar(y);
+}
+
+void SkPipeCanvas::onDrawImage(const SkImage* image, SkScalar left, SkScalar top,
+                               const SkPaint* paint) {
+    this->writeImageDraw(SkPipeVerb::kDrawImage, image, paint);
+    fWriter->writeScalar(left);
+    fWriter->writeScalar(top);
+}
+
+void SkPipeCanvas::onDrawImageRect(const SkImage* image, const SkRect* src, const SkRect& dst,
+                                   const SkPaint* paint, SrcRectConstraint constraint) {
+    this->writeImageDraw(SkPipeVerb::kDrawImageRect, image, paint);
+    this->writeOptionalRect(src);
+    fWriter->writeRect(dst);
+    fWriter->writeUInt(constraint);
+}
+
+void SkPipeCanvas::onDrawImageNine(const SkImage* image, const SkIRect& center,
+                                   const SkRect& dst, const SkPaint* paint) {
+    this->writeImageDraw(SkPipeVerb::kDrawImageNine, image, paint);
+    fWriter->writeIRect(center);
+    fWriter->writeRect(dst);
+}
+
+void SkPipeCanvas::onDrawBitmap(const SkBitmap& bitmap, SkScalar left, SkScalar top,
+                                const SkPaint* paint) {
+    if (sk_sp<SkImage> image = SkImage::MakeFromBitmap(bitmap)) {
+        this->onDrawImage(image.get(), left, top, paint);
+    }
+}
+
+void SkPipeCanvas::onDrawBitmapRect(const SkBitmap& bitmap, const SkRect* src,
+                                    const SkRect& dst, const SkPaint* paint,
+                                    SrcRectConstraint constraint) {
+    if (sk_sp<SkImage> image = SkImage::MakeFromBitmap(bitmap)) {
+        this->onDrawImageRect(image.get(), src, dst, paint, constraint);
+    }
+}
+
+void SkPipeCanvas::onDrawBitmapNine(const SkBitmap& bitmap, const SkIRect& center,
+                                    const SkRect& dst, const SkPaint* paint) {
+    if (sk_sp<SkImage> image = SkImage::MakeFromBitmap(bitmap)) {
+        this->onDrawImageNine(image.get(), center, dst, paint);
+    }
+}
+
+void SkPipeCanvas::onDrawAtlas(const SkImage* atlas, const SkRSXform xform[], const SkRect tex[],
+                               const SkColor colors[], int count, SkXfermode::Mode mode,
+                               const SkRect* cull, const SkPaint* paint) {
+    this->writeImageDraw(SkPipeVerb::kDrawAtlas, atlas, paint);
+    fWriter->writeScalarArray(&xform[0].fSCos, count * 4);
+    fWriter->writeScalarArray(&tex[0].fLeft, count * 4);
+    fWriter->writeBool(colors != nullptr);
+    if (colors) {
+        fWriter->writeColorArray(colors, count);
+    }
+    fWriter->writeUInt(mode);
+    this->writeOptionalRect(cull);
+}
+
+void SkPipeCanvas::onDrawVertices(VertexMode vmode, int vertexCount, const SkPoint vertices[],
+                                  const SkPoint texs[], const SkColor colors[],
+                                  SkXfermode* xmode, const uint16_t indices[], int indexCount,
+                                  const SkPaint& paint) {
+    SkXfermode::Mode mode = SkXfermode::kModulate_Mode;
+    if (xmode) {
+        SkAssertResult(xmode->asMode(&mode));
+    }
+    this->write(SkPipeVerb::kDrawVertices, fPipe->paintID(paint));
+    fWriter->writeUInt(vmode);
+    fWriter->writePointArray(vertices, vertexCount);
+    fWriter->writeBool(texs != nullptr);
+    if (texs) {
+        fWriter->writePointArray(texs, vertexCount);
+    }
+    fWriter->writeBool(colors != nullptr);
+    if (colors) {
+        fWriter->writeColorArray(colors, vertexCount);
+    }
+    fWriter->writeUInt(mode);
+    fWriter->writeByteArray(indices, indexCount * sizeof(uint16_t));
+}
+
+void SkPipeCanvas::onDrawPatch(const SkPoint cubics[12], const SkColor colors[4],
+                               const SkPoint texCoords[4], SkXfermode* xmode,
+                               const SkPaint& paint) {
+    SkXfermode::Mode mode = SkXfermode::kModulate_Mode;
+    if (xmode) {
+        SkAssertResult(xmode->asMode(&mode));
+    }
+    this->write(SkPipeVerb::kDrawPatch, fPipe->paintID(paint));
+    fWriter->writePointArray(cubics, 12);
+    fWriter->writeBool(colors != nullptr);
+    if (colors) {
+        fWriter->writeColorArray(colors, 4);
+    }
+    fWriter->writeBool(texCoords != nullptr);
+    if (texCoords) {
+        fWriter->writePointArray(texCoords, 4);
+    }
+    fWriter->writeUInt(mode);
+}
+
+void SkPipeCanvas::onDrawAnnotation(const SkRect& rect, const char key[], SkData* value) {
+    this->write(SkPipeVerb::kDrawAnnotation);
+    fWriter->writeRect(rect);
+    fWriter->writeString(key);
+    fWriter->writeBool(value != nullptr);
+    if (value) {
+        fWriter->writeDataAsByteArray(value);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SkPipeSerializer::SkPipeSerializer() : fWriter(new SkPipeWriter), fStream(nullptr) {}
+
+SkPipeSerializer::~SkPipeSerializer() {
+    SkASSERT(!fStream);
+}
+
+SkCanvas* SkPipeSerializer::beginWrite(const SkRect& cullBounds, SkWStream* stream) {
+    SkASSERT(!fStream && stream);
+    fCanvas.reset(new SkPipeCanvas(cullBounds, fWriter.get()));
+    fStream = stream;
+    return fCanvas.get();
+}
+
+void SkPipeSerializer::endWrite() {
+    SkASSERT(fStream);
+    fCanvas->restoreToCount(1);
+    fCanvas.reset(nullptr);
+    fWriter->endFrame(fStream);
+    fStream = nullptr;
+}
+
+void SkPipeSerializer::resetCache() {
+    SkASSERT(!fStream);
+    fWriter->resetCache();
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPipeFormat_DEFINED
+#define SkPipeFormat_DEFINED
+
+#include "SkTypes.h"
+
+// A frame is a uint32_t byte count followed by that many bytes of commands.  Each command
+// starts with a uint32_t whose top 8 bits are its verb and whose low 24 bits are an argument,
+// usually the ID of the paint it draws with (0 for none).  The rest is written with an
+// SkBinaryWriteBuffer.
+//
+// The Define verbs send a resource, giving it the next ID of its kind: IDs start at 1 and
+// count up, for the life of the stream or until a Reset.  Paints are sent already flattened,
+// as a byte array of their own, which refers to typefaces and images by their IDs.
+enum class SkPipeVerb : uint8_t {
+    kSave,
+    kSaveLayer,         // arg: paint ID
+    kRestore,
+    kConcat,
+    kSetMatrix,
+
+    kClipRect,          // arg: SkRegion::Op | ClipEdgeStyle << 8
+    kClipRRect,         // arg: SkRegion::Op | ClipEdgeStyle << 8
+    kClipPath,          // arg: SkRegion::Op | ClipEdgeStyle << 8
+    kClipRegion,        // arg: SkRegion::Op
+
+    kDrawPaint,         // arg: paint ID, for this and every draw below
+    kDrawPoints,
+    kDrawRect,
+    kDrawOval,
+    kDrawRRect,
+    kDrawDRRect,
+    kDrawPath,
+    kDrawText,
+    kDrawPosText,
+    kDrawPosTextH,
+    kDrawTextOnPath,
+    kDrawTextRSXform,
+    kDrawTextBlob,
+    kDrawImage,
+    kDrawImageRect,
+    kDrawImageNine,
+    kDrawAtlas,
+    kDrawVertices,
+    kDrawPatch,
+    kDrawAnnotation,    // arg: unused
+
+    kDefineTypeface,
+    kDefineImage,
+    kDefinePath,
+    kDefinePaint,
+    kDefineTextBlob,
+
+    kReset,             // Forget every resource defined so far.
+
+    kLast = kReset,
+};
+
+static const unsigned kPipeMaxID = (1 << 24) - 1;
+
+static inline uint32_t SkPipePack(SkPipeVerb verb, unsigned arg) {
+    SkASSERT(arg <= kPipeMaxID);
+    return ((uint32_t)verb << 24) | arg;
+}
+
+static inline SkPipeVerb SkPipeUnpackVerb(uint32_t packed) { return (SkPipeVerb)(packed >> 24); }
+static inline unsigned SkPipeUnpackArg(uint32_t packed) { return packed & kPipeMaxID; }
+
+#endif
@@ -0,0 +1,635 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkData.h"
+#include "SkImage.h"
+#include "SkImageFilter.h"
+#include "SkImageReferenceResolver.h"
+#include "SkPipe.h"
+#include "SkPipeFormat.h"
+#include "SkRRect.h"
+#include "SkRSXform.h"
+#include "SkStream.h"
+#include "SkTArray.h"
+#include "SkTemplates.h"
+#include "SkTextBlob.h"
+#include "SkTypeface.h"
+#include "SkValidatingReadBuffer.h"
+
+// Resolves the image IDs that flattened paints refer to, as recorded by SkPipeImageRecorder.
+class SkPipeImageResolver : public SkImageReferenceResolver {
+public:
+    explicit SkPipeImageResolver(const SkTArray<sk_sp<SkImage>>* images) : fImages(images) {}
+
+protected:
+    sk_sp<SkImage> onResolve(const void* reference, size_t length) override {
+        uint32_t id;
+        if (length != sizeof(id)) {
+            return nullptr;
+        }
+        memcpy(&id, reference, sizeof(id));
+        if (0 == id || id > (uint32_t)fImages->count()) {
+            return nullptr;
+        }
+        return (*fImages)[id - 1];
+    }
+
+private:
+    const SkTArray<sk_sp<SkImage>>* fImages;
+};
+
+// Frames come from another process, so every read is checked.  This also looks typefaces up
+// by the IDs the serializer gave them, which the validating buffer can't do on its own.
+class SkPipeReadBuffer : public SkValidatingReadBuffer {
+public:
+    SkPipeReadBuffer(const void* data, size_t size, const SkTArray<sk_sp<SkTypeface>>* typefaces,
+                     SkImageReferenceResolver* images)
+        : INHERITED(data, size)
+        , fTypefaces(typefaces) {
+        this->setImageReferenceResolver(images);
+    }
+
+    SkTypeface* readTypeface() override {
+        const uint32_t id = this->readUInt();
+        if (!this->validate(id <= (uint32_t)fTypefaces->count())) {
+            return nullptr;
+        }
+        return id ? (*fTypefaces)[id - 1].get() : nullptr;
+    }
+
+private:
+    const SkTArray<sk_sp<SkTypeface>>* fTypefaces;
+
+    typedef SkValidatingReadBuffer INHERITED;
+};
+
+class SkPipePlayer {
+public:
+    SkPipePlayer() : fImageResolver(new SkPipeImageResolver(&fImages)) {}
+
+    bool playFrame(const void* data, size_t size, SkCanvas* canvas) {
+        SkPipeReadBuffer buffer(data, size, &fTypefaces, fImageResolver.get());
+        SkAutoCanvasRestore acr(canvas, true);
+        const int saveCount = canvas->getSaveCount();
+        while (buffer.isValid() && !buffer.eof()) {
+            const uint32_t packed = buffer.readUInt();
+            if (!buffer.isValid() || SkPipeUnpackVerb(packed) > SkPipeVerb::kLast) {
+                return false;
+            }
+            if (!this->playCommand(SkPipeUnpackVerb(packed), SkPipeUnpackArg(packed), &buffer,
+                                   canvas, saveCount)) {
+                return false;
+            }
+        }
+        return buffer.isValid();
+    }
+
+private:
+    template <typename T>
+    static const T* Lookup(const SkTArray<T>& table, unsigned id, SkReadBuffer* buffer) {
+        return buffer->validate(id > 0 && id <= (unsigned)table.count()) ? &table[id - 1]
+                                                                         : nullptr;
+    }
+
+    // Reads an array written with one of SkWriteBuffer's write*Array() calls.
+    template <typename T>
+    static bool ReadArray(SkReadBuffer* buffer, bool (SkReadBuffer::*read)(T*, size_t),
+                          SkAutoTMalloc<T>* array, uint32_t* count) {
+        *count = buffer->getArrayCount();
+        if (!buffer->validateAvailable((uint64_t)*count * sizeof(T))) {
+            return false;
+        }
+        array->reset(*count);
+        return (buffer->*read)(array->get(), *count);
+    }
+
+    static bool ReadRRect(SkReadBuffer* buffer, SkRRect* rrect) {
+        char storage[SkRRect::kSizeInMemory];
+        return buffer->readByteArray(storage, sizeof(storage)) &&
+               buffer->validate(SkRRect::kSizeInMemory ==
+                                rrect->readFromMemory(storage, sizeof(storage)));
+    }
+
+    static bool ReadOptionalRect(SkReadBuffer* buffer, SkRect* storage, const SkRect** rect) {
+        *rect = nullptr;
+        if (buffer->readBool()) {
+            buffer->readRect(storage);
+            *rect = storage;
+        }
+        return buffer->isValid();
+    }
+
+    static bool ReadXfermode(SkReadBuffer* buffer, sk_sp<SkXfermode>* xfermode) {
+        const uint32_t mode = buffer->readUInt();
+        if (!buffer->validate(mode <= SkXfermode::kLastMode)) {
+            return false;
+        }
+        *xfermode = SkXfermode::Make((SkXfermode::Mode)mode);
+        return true;
+    }
+
+    // Reads the text of a text draw, and returns how many glyphs paint makes of it.
+    static int ReadText(SkReadBuffer* buffer, const SkPaint& paint, sk_sp<SkData>* text) {
+        *text = buffer->readByteArrayAsData();
+        return buffer->isValid() ? paint.countText((*text)->data(), (*text)->size()) : 0;
+    }
+
+    // Reads a nested buffer of flattened data, e.g. a paint.
+    sk_sp<SkData> readFlat(SkReadBuffer* buffer) {
+        sk_sp<SkData> data(buffer->readByteArrayAsData());
+        return buffer->validate(SkIsAlign4(data->size())) ? data : nullptr;
+    }
+
+    bool playCommand(SkPipeVerb verb, unsigned arg, SkReadBuffer* buffer, SkCanvas* canvas,
+                     int saveCount);
+
+    SkTArray<sk_sp<SkTypeface>>         fTypefaces;
+    SkTArray<sk_sp<SkImage>>            fImages;
+    SkTArray<SkPath>                    fPaths;
+    SkTArray<SkPaint>                   fPaints;
+    SkTArray<sk_sp<const SkTextBlob>>   fTextBlobs;
+    sk_sp<SkPipeImageResolver>          fImageResolver;
+};
+
+bool SkPipePlayer::playCommand(SkPipeVerb verb, unsigned arg, SkReadBuffer* buffer,
+                               SkCanvas* canvas, int saveCount) {
+    // Draws name their paint with arg.  Image draws and saveLayer() may have none.
+    const bool imageDraw = SkPipeVerb::kDrawImage == verb || SkPipeVerb::kDrawImageRect == verb ||
+                           SkPipeVerb::kDrawImageNine == verb || SkPipeVerb::kDrawAtlas == verb;
+    const bool usesPaint = verb >= SkPipeVerb::kDrawPaint && verb <= SkPipeVerb::kDrawPatch;
+    const SkPaint* paint = nullptr;
+    if (usesPaint || SkPipeVerb::kSaveLayer == verb) {
+        if (arg || !(imageDraw || SkPipeVerb::kSaveLayer == verb)) {
+            paint = Lookup(fPaints, arg, buffer);
+            if (!paint) {
+                return false;
+            }
+        }
+    }
+
+    // Image draws name their image next.
+    const SkImage* image = nullptr;
+    if (imageDraw) {
+        const sk_sp<SkImage>* entry = Lookup(fImages, buffer->readUInt(), buffer);
+        if (!entry) {
+            return false;
+        }
+        image = entry->get();
+    }
+
+    switch (verb) {
+        case SkPipeVerb::kSave:
+            canvas->save();
+            break;
+        case SkPipeVerb::kSaveLayer: {
+            const uint32_t flags = buffer->readUInt();
+            SkRect storage;
+            const SkRect* bounds;
+            if (!ReadOptionalRect(buffer, &storage, &bounds)) {
+                return false;
+            }
+            sk_sp<SkImageFilter> backdrop;
+            if (buffer->readBool()) {
+                sk_sp<SkData> flat(this->readFlat(buffer));
+                if (!flat) {
+                    return false;
+                }
+                SkPipeReadBuffer nested(flat->data(), flat->size(), &fTypefaces,
+                                        fImageResolver.get());
+                backdrop = nested.readImageFilter();
+                if (!nested.isValid()) {
+                    return false;
+                }
+            }
+            canvas->saveLayer(SkCanvas::SaveLayerRec(bounds, paint, backdrop.get(), flags));
+            break;
+        }
+        case SkPipeVerb::kRestore:
+            if (!buffer->validate(canvas->getSaveCount() > saveCount)) {
+                return false;
+            }
+            canvas->restore();
+            break;
+        case SkPipeVerb::kConcat:
+        case SkPipeVerb::kSetMatrix: {
+            SkMatrix matrix;
+            buffer->readMatrix(&matrix);
+            if (!buffer->isValid()) {
+                return false;
+            }
+            if (SkPipeVerb::kConcat == verb) {
+                canvas->concat(matrix);
+            } else {
+                canvas->setMatrix(matrix);
+            }
+            break;
+        }
+
+        case SkPipeVerb::kClipRect:
+        case SkPipeVerb::kClipRRect:
+        case SkPipeVerb::kClipPath:
+        case SkPipeVerb::kClipRegion: {
+            const SkRegion::Op op = (SkRegion::Op)(arg & 0xFF);
+            const bool doAA = (arg >> 8) != 0;   // a soft ClipEdgeStyle
+            if (!buffer->validate(op <= SkRegion::kLastOp && (arg >> 8) <= 1)) {
+                return false;
+            }
+            if (SkPipeVerb::kClipRect == verb) {
+                SkRect rect;
+                buffer->readRect(&rect);
+                if (!buffer->isValid()) {
+                    return false;
+                }
+                canvas->clipRect(rect, op, doAA);
+            } else if (SkPipeVerb::kClipRRect == verb) {
+                SkRRect rrect;
+                if (!ReadRRect(buffer, &rrect)) {
+                    return false;
+                }
+                canvas->clipRRect(rrect, op, doAA);
+            } else if (SkPipeVerb::kClipPath == verb) {
+                const SkPath* path = Lookup(fPaths, buffer->readUInt(), buffer);
+                if (!path) {
+                    return false;
+                }
+                canvas->clipPath(*path, op, doAA);
+            } else {
+                SkRegion region;
+                buffer->readRegion(&region);
+                if (!buffer->isValid()) {
+                    return false;
+                }
+                canvas->clipRegion(region, op);
+            }
+            break;
+        }
+
+        case SkPipeVerb::kDrawPaint:
+            canvas->drawPaint(*paint);
+            break;
+        case SkPipeVerb::kDrawPoints: {
+            const uint32_t mode = buffer->readUInt();
+            SkAutoTMalloc<SkPoint> pts;
+            uint32_t count;
+            if (!buffer->validate(mode <= SkCanvas::kPolygon_PointMode) ||
+                !ReadArray(buffer, &SkReadBuffer::readPointArray, &pts, &count)) {
+                return false;
+            }
+            canvas->drawPoints((SkCanvas::PointMode)mode, count, pts.get(), *paint);
+            break;
+        }
+        case SkPipeVerb::kDrawRect:
+        case SkPipeVerb::kDrawOval: {
+            SkRect rect;
+            buffer->readRect(&rect);
+            if (!buffer->isValid()) {
+                return false;
+            }
+            if (SkPipeVerb::kDrawRect == verb) {
+                canvas->drawRect(rect, *paint);
+            } else {
+                canvas->drawOval(rect, *paint);
+            }
+            break;
+        }
+        case SkPipeVerb::kDrawRRect: {
+            SkRRect rrect;
+            if (!ReadRRect(buffer, &rrect)) {
+                return false;
+            }
+            canvas->drawRRect(rrect, *paint);
+            break;
+        }
+        case SkPipeVerb::kDrawDRRect: {
+            SkRRect outer, inner;
+            if (!ReadRRect(buffer, &outer) || !ReadRRect(buffer, &inner)) {
+                return false;
+            }
+            canvas->drawDRRect(outer, inner, *paint);
+            break;
+        }
+        case SkPipeVerb::kDrawPath: {
+            const SkPath* path = Lookup(fPaths, buffer->readUInt(), buffer);
+            if (!path) {
+                return false;
+            }
+            canvas->drawPath(*path, *paint);
+            break;
+        }
+        case SkPipeVerb::kDrawText: {
+            sk_sp<SkData> text;
+            ReadText(buffer, *paint, &text);
+            const SkScalar x = buffer->readScalar(),
+                           y = buffer->readScalar();
+            if (!buffer->isValid()) {
+                return false;
+            }
+            canvas->drawText(text->data(), text->size(), x, y, *paint);
+            break;
+        }
+        case SkPipeVerb::kDrawPosText: {
+            sk_sp<SkData> text;
+            const int glyphs = ReadText(buffer, *paint, &text);
+            SkAutoTMalloc<SkPoint> pos;
+            uint32_t count;
+            if (!ReadArray(buffer, &SkReadBuffer::readPointArray, &pos, &count) ||
+                !buffer->validate(count == (uint32_t)glyphs)) {
+                return false;
+            }
+            canvas->drawPosText(text->data(), text->size(), pos.get(), *paint);
+            break;
+        }
+        case SkPipeVerb::kDrawPosTextH: {
+            sk_sp<SkData> text;
+            const int glyphs = ReadText(buffer, *paint, &text);
+            SkAutoTMalloc<SkScalar> xpos;
+            uint32_t count;
+            if (!ReadArray(buffer, &SkReadBuffer::readScalarArray, &xpos, &count) ||
+                !buffer->validate(count == (uint32_t)glyphs)) {
+                return false;
+            }
+            const SkScalar constY = buffer->readScalar();
+            if (!buffer->isValid()) {
+                return false;
+            }
+            canvas->drawPosTextH(text->data(), text->size(), xpos.get(), constY, *paint);
+            break;
+        }
+        case SkPipeVerb::kDrawTextOnPath: {
+            sk_sp<SkData> text;
+            ReadText(buffer, *paint, &text);
+            const SkPath* path = Lookup(fPaths, buffer->readUInt(), buffer);
+            SkMatrix matrix;
+            const bool hasMatrix = buffer->readBool();
+            if (hasMatrix) {
+                buffer->readMatrix(&matrix);
+            }
+            if (!path || !buffer->isValid()) {
+                return false;
+            }
+            canvas->drawTextOnPath(text->data(), text->size(), *path,
+                                   hasMatrix ? &matrix : nullptr, *paint);
+            break;
+        }
+        case SkPipeVerb::kDrawTextRSXform: {
+            sk_sp<SkData> text;
+            const int glyphs = ReadText(buffer, *paint, &text);
+            SkAutoTMalloc<SkScalar> xform;
+            uint32_t count;
+            SkRect storage;
+            const SkRect* cull;
+            if (!ReadArray(buffer, &SkReadBuffer::readScalarArray, &xform, &count) ||
+                !buffer->validate(count == 4 * (uint32_t)glyphs) ||
+                !ReadOptionalRect(buffer, &storage, &cull)) {
+                return false;
+            }
+            canvas->drawTextRSXform(text->data(), text->size(),
+                                    reinterpret_cast<const SkRSXform*>(xform.get()), cull,
+                                    *paint);
+            break;
+        }
+        case SkPipeVerb::kDrawTextBlob: {
+            const sk_sp<const SkTextBlob>* blob = Lookup(fTextBlobs, buffer->readUInt(), buffer);
+            const SkScalar x = buffer->readScalar(),
+                           y = buffer->readScalar();
+            if (!blob || !buffer->isValid()) {
+                return false;
+            }
+            canvas->drawTextBlob(blob->get(), x, y, *paint);
+            break;
+        }
+        case SkPipeVerb::kDrawImage: {
+            const SkScalar left = buffer->readScalar(),
+                           top  = buffer->readScalar();
+            if (!buffer->isValid()) {
+                return false;
+            }
+            canvas->drawImage(image, left, top, paint);
+            break;
+        }
+        case SkPipeVerb::kDrawImageRect: {
+            SkRect storage, dst;
+            const SkRect* src;
+            if (!ReadOptionalRect(buffer, &storage, &src)) {
+                return false;
+            }
+            buffer->readRect(&dst);
+            const uint32_t constraint = buffer->readUInt();
+            if (!buffer->validate(constraint <= SkCanvas::kFast_SrcRectConstraint)) {
+                return false;
+            }
+            const auto c = (SkCanvas::SrcRectConstraint)constraint;
+            if (src) {
+                canvas->drawImageRect(image, *src, dst, paint, c);
+            } else {
+                canvas->drawImageRect(image, dst, paint, c);
+            }
+            break;
+        }
+        case SkPipeVerb::kDrawImageNine: {
+            SkIRect center;
+            SkRect dst;
+            buffer->readIRect(&center);
+            buffer->readRect(&dst);
+            if (!buffer->isValid()) {
+                return false;
+            }
+            canvas->drawImageNine(image, center, dst, paint);
+            break;
+        }
+        case SkPipeVerb::kDrawAtlas: {
+            SkAutoTMalloc<SkScalar> xform, tex;
+            SkAutoTMalloc<SkColor> colors;
+            uint32_t xformCount, texCount, colorCount;
+            if (!ReadArray(buffer, &SkReadBuffer::readScalarArray, &xform, &xformCount) ||
+                !ReadArray(buffer, &SkReadBuffer::readScalarArray, &tex, &texCount) ||
+                !buffer->validate(xformCount == texCount && 0 == xformCount % 4)) {
+                return false;
+            }
+            const bool hasColors = buffer->readBool();
+            if (hasColors &&
+                (!ReadArray(buffer, &SkReadBuffer::readColorArray, &colors, &colorCount) ||
+                 !buffer->validate(4 * colorCount == xformCount))) {
+                return false;
+            }
+            const uint32_t mode = buffer->readUInt();
+            SkRect storage;
+            const SkRect* cull;
+            if (!buffer->validate(mode <= SkXfermode::kLastMode) ||
+                !ReadOptionalRect(buffer, &storage, &cull)) {
+                return false;
+            }
+            canvas->drawAtlas(image, reinterpret_cast<const SkRSXform*>(xform.get()),
+                              reinterpret_cast<const SkRect*>(tex.get()),
+                              hasColors ? colors.get() : nullptr, xformCount / 4,
+                              (SkXfermode::Mode)mode, cull, paint);
+            break;
+        }
+        case SkPipeVerb::kDrawVertices: {
+            const uint32_t vmode = buffer->readUInt();
+            SkAutoTMalloc<SkPoint> vertices, texs;
+            SkAutoTMalloc<SkColor> colors;
+            uint32_t count, texCount, colorCount;
+            if (!buffer->validate(vmode <= SkCanvas::kTriangleFan_VertexMode) ||
+                !ReadArray(buffer, &SkReadBuffer::readPointArray, &vertices, &count)) {
+                return false;
+            }
+            const bool hasTexs = buffer->readBool();
+            if (hasTexs &&
+                (!ReadArray(buffer, &SkReadBuffer::readPointArray, &texs, &texCount) ||
+                 !buffer->validate(texCount == count))) {
+                return false;
+            }
+            const bool hasColors = buffer->readBool();
+            if (hasColors &&
+                (!ReadArray(buffer, &SkReadBuffer::readColorArray, &colors, &colorCount) ||
+                 !buffer->validate(colorCount == count))) {
+                return false;
+            }
+            sk_sp<SkXfermode> xfermode;
+            if (!ReadXfermode(buffer, &xfermode)) {
+                return false;
+            }
+            sk_sp<SkData> indices(buffer->readByteArrayAsData());
+            const int indexCount = SkToInt(indices->size() / sizeof(uint16_t));
+            const uint16_t* index = static_cast<const uint16_t*>(indices->data());
+            if (!buffer->validate(0 == indices->size() % sizeof(uint16_t))) {
+                return false;
+            }
+            for (int i = 0; i < indexCount; i++) {
+                if (!buffer->validate(index[i] < count)) {
+                    return false;
+                }
+            }
+            canvas->drawVertices((SkCanvas::VertexMode)vmode, count, vertices.get(),
+                                 hasTexs ? texs.get() : nullptr,
+                                 hasColors ? colors.get() : nullptr, xfermode.get(),
+                                 indexCount ? index : nullptr, indexCount, *paint);
+            break;
+        }
+        case SkPipeVerb::kDrawPatch: {
+            SkPoint cubics[12], texCoords[4];
+            SkColor colors[4];
+            if (!buffer->readPointArray(cubics, 12)) {
+                return false;
+            }
+            const bool hasColors = buffer->readBool();
+            if (hasColors && !buffer->readColorArray(colors, 4)) {
+                return false;
+            }
+            const bool hasTexCoords = buffer->readBool();
+            if (hasTexCoords && !buffer->readPointArray(texCoords, 4)) {
+                return false;
+            }
+            sk_sp<SkXfermode> xfermode;
+            if (!ReadXfermode(buffer, &xfermode)) {
+                return false;
+            }
+            canvas->drawPatch(cubics, hasColors ? colors : nullptr,
+                              hasTexCoords ? texCoords : nullptr, xfermode.get(), *paint);
+            break;
+        }
+        case SkPipeVerb::kDrawAnnotation: {
+            SkRect rect;
+            SkString key;
+            buffer->readRect(&rect);
+            buffer->readString(&key);
+            sk_sp<SkData> value;
+            if (buffer->readBool()) {
+                value = buffer->readByteArrayAsData();
+            }
+            if (!buffer->isValid()) {
+                return false;
+            }
+            canvas->drawAnnotation(rect, key.c_str(), value.get());
+            break;
+        }
+
+        case SkPipeVerb::kDefineTypeface: {
+            sk_sp<SkData> data(buffer->readByteArrayAsData());
+            if (!buffer->isValid()) {
+                return false;
+            }
+            SkMemoryStream stream(data);
+            fTypefaces.push_back(SkTypeface::MakeDeserialize(&stream));
+            break;
+        }
+        case SkPipeVerb::kDefineImage: {
+            sk_sp<SkImage> defined(buffer->readImage());
+            if (!buffer->validate(defined != nullptr)) {
+                return false;
+            }
+            fImages.push_back(std::move(defined));
+            break;
+        }
+        case SkPipeVerb::kDefinePath: {
+            SkPath path;
+            buffer->readPath(&path);
+            if (!buffer->isValid()) {
+                return false;
+            }
+            fPaths.push_back(path);
+            break;
+        }
+        case SkPipeVerb::kDefinePaint:
+        case SkPipeVerb::kDefineTextBlob: {
+            sk_sp<SkData> flat(this->readFlat(buffer));
+            if (!flat) {
+                return false;
+            }
+            SkPipeReadBuffer nested(flat->data(), flat->size(), &fTypefaces,
+                                    fImageResolver.get());
+            if (SkPipeVerb::kDefinePaint == verb) {
+                SkPaint defined;
+                nested.readPaint(&defined);
+                if (!nested.isValid()) {
+                    return false;
+                }
+                fPaints.push_back(defined);
+            } else {
+                sk_sp<const SkTextBlob> defined(SkTextBlob::CreateFromBuffer(nested));
+                if (!defined || !nested.isValid()) {
+                    return false;
+                }
+                fTextBlobs.push_back(std::move(defined));
+            }
+            break;
+        }
+
+        case SkPipeVerb::kReset:
+            fTypefaces.reset();
+            fImages.reset();
+            fPaths.reset();
+            fPaints.reset();
+            fTextBlobs.reset();
+            break;
+    }
+    return buffer->isValid();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SkPipeDeserializer::SkPipeDeserializer() : fPlayer(new SkPipePlayer) {}
+
+SkPipeDeserializer::~SkPipeDeserializer() {}
+
+bool SkPipeDeserializer::playback(SkStream* stream, SkCanvas* canvas) {
+    uint32_t size;
+    if (sizeof(size) != stream->read(&size, sizeof(size)) || !SkIsAlign4(size)) {
+        return false;
+    }
+    if (stream->hasLength() && stream->hasPosition() &&
+        size > stream->getLength() - stream->getPosition()) {
+        return false;
+    }
+    SkAutoTMalloc<char> data(size);
+    if (size != stream->read(data.get(), size)) {
+        return false;
+    }
+    return fPlayer->playFrame(data.get(), size, canvas);
+}
@@ -0,0 +1,198 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkPrefetchingStream.h"
+#include "SkSemaphore.h"
+#include "SkStream.h"
+#include "SkTemplates.h"
+#include "SkThreadUtils.h"
+
+#include <atomic>
+
+class PrefetchingStream : public SkStream {
+public:
+    // Called by Create.
+    PrefetchingStream(SkStream*, size_t blockSize, int blockCount);
+
+    ~PrefetchingStream() override;
+
+    size_t read(void* buffer, size_t size) override;
+
+    size_t peek(void* buffer, size_t size) const override;
+
+    bool isAtEnd() const override;
+
+    bool hasPosition() const override { return true; }
+
+    size_t getPosition() const override { return fPosition; }
+
+    bool hasLength() const override { return fHasLength; }
+
+    size_t getLength() const override { return fLength; }
+
+    // Starts reading ahead.  Returns false if the thread could not be started.
+    bool start() { return fThread.start(); }
+
+    // Gives up the wrapped stream.  Only valid before start().
+    SkStream* releaseStream() { return fStream.release(); }
+
+private:
+    struct Block {
+        SkAutoTMalloc<char> fData;
+        // Every block is full but the last, which ends the stream.
+        size_t              fSize;
+    };
+
+    // The prefetch thread's entry point: fills each empty block in turn until
+    // the wrapped stream runs out.
+    static void Prefetch(void* stream);
+
+    // Returns the block the caller is reading from, waiting for it to be filled.
+    const Block& currentBlock() const;
+
+    // Owned by the prefetch thread once it has started.
+    SkAutoTDelete<SkStream> fStream;
+    const bool              fHasLength;
+    const size_t            fLength;
+    const size_t            fBlockSize;
+    const int               fBlockCount;
+    SkAutoTArray<Block>     fBlocks;
+
+    SkSemaphore             fEmptyBlocks;
+    mutable SkSemaphore     fFullBlocks;
+    std::atomic<bool>       fStopping;
+    SkThread                fThread;
+
+    // Only used by the caller.  fReadIndex is the block it is reading from,
+    // fReadOffset the offset into it, and fHaveBlock whether that block has
+    // been waited for.
+    mutable int             fReadIndex;
+    mutable bool            fHaveBlock;
+    size_t                  fReadOffset;
+    size_t                  fPosition;
+
+    typedef SkStream INHERITED;
+};
+
+SkStream* SkPrefetchingStream::Create(SkStream* stream, size_t blockSize, int blockCount) {
+    if (nullptr == stream) {
+        return nullptr;
+    }
+    SkASSERT(blockSize > 0 && blockCount > 0);
+    SkAutoTDelete<PrefetchingStream> prefetching(
+            new PrefetchingStream(stream, blockSize, blockCount));
+    if (!prefetching->start()) {
+        return prefetching->releaseStream();
+    }
+    return prefetching.release();
+}
+
+PrefetchingStream::PrefetchingStream(SkStream* stream, size_t blockSize, int blockCount)
+    : fStream(stream)
+    , fHasLength(stream->hasPosition() && stream->hasLength())
+    , fLength(stream->getLength() - stream->getPosition())
+    , fBlockSize(blockSize)
+    , fBlockCount(blockCount)
+    , fBlocks(blockCount)
+    , fEmptyBlocks(blockCount)
+    , fFullBlocks(0)
+    , fStopping(false)
+    , fThread(Prefetch, this)
+    , fReadIndex(0)
+    , fHaveBlock(false)
+    , fReadOffset(0)
+    , fPosition(0) {
+    for (int i = 0; i < blockCount; i++) {
+        fBlocks[i].fData.reset(blockSize);
+        fBlocks[i].fSize = 0;
+    }
+}
+
+PrefetchingStream::~PrefetchingStream() {
+    // Wake the prefetch thread if it is waiting for an empty block, and wait
+    // for it to finish whatever read it is in the middle of.
+    fStopping.store(true);
+    fEmptyBlocks.signal();
+    fThread.join();
+}
+
+void PrefetchingStream::Prefetch(void* ctx) {
+    PrefetchingStream* self = static_cast<PrefetchingStream*>(ctx);
+    for (int i = 0; ; i = (i + 1) % self->fBlockCount) {
+        self->fEmptyBlocks.wait();
+        if (self->fStopping.load()) {
+            return;
+        }
+
+        // Streams may return less than asked for before the end, so keep
+        // reading until the block is full or nothing more comes.
+        Block& block = self->fBlocks[i];
+        block.fSize = 0;
+        while (block.fSize < self->fBlockSize) {
+            const size_t bytesRead = self->fStream->read(block.fData.get() + block.fSize,
+                                                         self->fBlockSize - block.fSize);
+            if (0 == bytesRead) {
+                break;
+            }
+            block.fSize += bytesRead;
+        }
+        const bool atEnd = block.fSize < self->fBlockSize;
+        self->fFullBlocks.signal();
+        if (atEnd) {
+            return;
+        }
+    }
+}
+
+const PrefetchingStream::Block& PrefetchingStream::currentBlock() const {
+    if (!fHaveBlock) {
+        fFullBlocks.wait();
+        fHaveBlock = true;
+    }
+    return fBlocks[fReadIndex];
+}
+
+size_t PrefetchingStream::read(void* buffer, size_t size) {
+    char* dst = static_cast<char*>(buffer);
+    size_t bytesRead = 0;
+    while (bytesRead < size) {
+        const Block& block = this->currentBlock();
+        const size_t bytesToCopy = SkTMin(size - bytesRead, block.fSize - fReadOffset);
+        if (dst) {
+            memcpy(dst + bytesRead, block.fData.get() + fReadOffset, bytesToCopy);
+        }
+        bytesRead += bytesToCopy;
+        fReadOffset += bytesToCopy;
+
+        if (fReadOffset < block.fSize) {
+            continue;
+        }
+        if (block.fSize < fBlockSize) {
+            // The last block.  Hold on to it, so later reads find the end.
+            break;
+        }
+        // Hand the block back to be refilled, and move on to the next one.
+        fReadIndex = (fReadIndex + 1) % fBlockCount;
+        fHaveBlock = false;
+        fReadOffset = 0;
+        fEmptyBlocks.signal();
+    }
+    fPosition += bytesRead;
+    return bytesRead;
+}
+
+size_t PrefetchingStream::peek(void* buffer, size_t size) const {
+    const Block& block = this->currentBlock();
+    const size_t bytesToCopy = SkTMin(size, block.fSize - fReadOffset);
+    memcpy(buffer, block.fData.get() + fReadOffset, bytesToCopy);
+    return bytesToCopy;
+}
+
+bool PrefetchingStream::isAtEnd() const {
+    const Block& block = this->currentBlock();
+    return block.fSize < fBlockSize && fReadOffset == block.fSize;
+}
@@ -0,0 +1,309 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkRingBufferEventTracer.h"
+
+#include "SkAtomics.h"
+#include "SkStream.h"
+#include "SkString.h"
+#include "SkTLS.h"
+#include "SkTemplates.h"
+#include "SkTime.h"
+#include "SkTraceEventCommon.h"
+
+#include <atomic>
+
+static const int kMaxArgs = 2;
+
+namespace {
+
+// Events are written only by their thread, and read by dumps under a sequence count: the count is
+// odd while an event is being written, so a reader that sees an odd or changed count skips it.
+struct Event {
+    std::atomic<uint32_t> fSeq;
+    uint64_t    fPosition;   // Which event of the thread this is, to spot overwrites.
+    char        fPhase;
+    uint8_t     fCategory;
+    uint8_t     fFlags;
+    uint8_t     fNumArgs;
+    uint8_t     fArgTypes[kMaxArgs];
+    const char* fName;
+    const char* fArgNames[kMaxArgs];
+    uint64_t    fArgValues[kMaxArgs];
+    uint64_t    fID;
+    uint64_t    fStartNs;
+    uint64_t    fDurationNs;
+};
+
+// Each thread keeps a short list of the tracers it has written to, keyed by unique ID rather
+// than pointer so that a tracer allocated where a dead one was is never confused with it.
+struct ThreadSlot {
+    uint32_t fTracerID;
+    void*    fBuffer;
+};
+
+}  // namespace
+
+struct SkRingBufferEventTracer::ThreadBuffer {
+    ThreadBuffer(int threadID, int capacity)
+        : fThreadID(threadID), fCapacity(capacity), fEvents(capacity), fNext(0) {
+        for (int i = 0; i < capacity; i++) {
+            fEvents[i].fSeq.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // Called only on the owning thread.
+    Event* beginWrite(uint64_t position) {
+        Event* e = &fEvents[position % fCapacity];
+        e->fSeq.store(e->fSeq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        return e;
+    }
+    void endWrite(Event* e) {
+        e->fSeq.store(e->fSeq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Copies the event at position into *copy, returning false if it has been overwritten or is
+    // being written right now.
+    bool read(uint64_t position, Event* copy) const {
+        const Event& e = fEvents[position % fCapacity];
+        uint32_t seq = e.fSeq.load(std::memory_order_acquire);
+        if (seq & 1) {
+            return false;
+        }
+        copy->fPosition   = e.fPosition;
+        copy->fPhase      = e.fPhase;
+        copy->fCategory   = e.fCategory;
+        copy->fFlags      = e.fFlags;
+        copy->fNumArgs    = e.fNumArgs;
+        copy->fName       = e.fName;
+        copy->fID         = e.fID;
+        copy->fStartNs    = e.fStartNs;
+        copy->fDurationNs = e.fDurationNs;
+        for (int i = 0; i < kMaxArgs; i++) {
+            copy->fArgTypes[i]  = e.fArgTypes[i];
+            copy->fArgNames[i]  = e.fArgNames[i];
+            copy->fArgValues[i] = e.fArgValues[i];
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return seq == e.fSeq.load(std::memory_order_relaxed) && copy->fPosition == position;
+    }
+
+    const int                  fThreadID;
+    const int                  fCapacity;
+    SkAutoTArray<Event>        fEvents;
+    std::atomic<uint64_t>      fNext;  // Position of the next event to write.
+};
+
+static void* create_thread_slots() { return new SkTDArray<ThreadSlot>; }
+static void delete_thread_slots(void* slots) { delete (SkTDArray<ThreadSlot>*)slots; }
+
+static uint32_t next_tracer_id() {
+    static std::atomic<uint32_t> gNextID{1};
+    return gNextID.fetch_add(1, std::memory_order_relaxed);
+}
+
+SkRingBufferEventTracer::SkRingBufferEventTracer(int eventsPerThread)
+    : fEventsPerThread(SkTMax(eventsPerThread, 1))
+    , fUniqueID(next_tracer_id())
+    , fCategoryCount(0)
+    , fEnabled(false) {}
+
+SkRingBufferEventTracer::~SkRingBufferEventTracer() {
+    fThreads.deleteAll();
+}
+
+void SkRingBufferEventTracer::setEnabled(bool enabled) {
+    SkAutoMutexAcquire lock(fMutex);
+    fEnabled = enabled;
+    uint8_t flag = enabled ? kEnabledForRecording_CategoryGroupEnabledFlags : 0;
+    for (int i = 0; i < fCategoryCount; i++) {
+        sk_atomic_store(&fCategoryFlags[i], flag, sk_memory_order_relaxed);
+    }
+}
+
+const uint8_t* SkRingBufferEventTracer::getCategoryGroupEnabled(const char* name) {
+    // Each call site looks its category up once and caches the pointer we return.
+    SkAutoMutexAcquire lock(fMutex);
+    for (int i = 0; i < fCategoryCount; i++) {
+        if (0 == strcmp(fCategoryNames[i], name)) {
+            return &fCategoryFlags[i];
+        }
+    }
+    if (fCategoryCount == kMaxCategories) {
+        // Lump any extras in with the last category.
+        return &fCategoryFlags[kMaxCategories - 1];
+    }
+    fCategoryNames[fCategoryCount] = name;
+    fCategoryFlags[fCategoryCount] = fEnabled ? kEnabledForRecording_CategoryGroupEnabledFlags
+                                              : 0;
+    return &fCategoryFlags[fCategoryCount++];
+}
+
+const char* SkRingBufferEventTracer::getCategoryGroupName(const uint8_t* categoryEnabledFlag) {
+    int index = SkToInt(categoryEnabledFlag - fCategoryFlags);
+    SkASSERT(0 <= index && index < kMaxCategories);
+    return fCategoryNames[index];
+}
+
+SkRingBufferEventTracer::ThreadBuffer* SkRingBufferEventTracer::threadBuffer() {
+    auto slots = (SkTDArray<ThreadSlot>*)SkTLS::Get(create_thread_slots, delete_thread_slots);
+    for (const ThreadSlot& slot : *slots) {
+        if (slot.fTracerID == fUniqueID) {
+            return static_cast<ThreadBuffer*>(slot.fBuffer);
+        }
+    }
+
+    // The first event from this thread.  The buffer belongs to us, so it outlives the thread
+    // and its events can still be dumped.
+    SkAutoMutexAcquire lock(fMutex);
+    ThreadBuffer* buffer = new ThreadBuffer(fThreads.count(), fEventsPerThread);
+    *fThreads.append() = buffer;
+    *slots->append() = { fUniqueID, buffer };
+    return buffer;
+}
+
+SkEventTracer::Handle SkRingBufferEventTracer::addTraceEvent(char phase,
+                                                             const uint8_t* categoryEnabledFlag,
+                                                             const char* name,
+                                                             uint64_t id,
+                                                             int32_t numArgs,
+                                                             const char** argNames,
+                                                             const uint8_t* argTypes,
+                                                             const uint64_t* argValues,
+                                                             uint8_t flags) {
+    ThreadBuffer* buffer = this->threadBuffer();
+    uint64_t position = buffer->fNext.load(std::memory_order_relaxed);
+
+    Event* e = buffer->beginWrite(position);
+    e->fPosition   = position;
+    e->fPhase      = phase;
+    e->fCategory   = SkToU8(categoryEnabledFlag - fCategoryFlags);
+    e->fFlags      = flags;
+    e->fName       = name;
+    e->fID         = id;
+    e->fStartNs    = (uint64_t)SkTime::GetNSecs();
+    e->fDurationNs = 0;
+    e->fNumArgs    = 0;
+    for (int i = 0; i < numArgs && e->fNumArgs < kMaxArgs; i++) {
+        if (TRACE_VALUE_TYPE_COPY_STRING == argTypes[i]) {
+            continue;  // We can't hold on to it.
+        }
+        e->fArgNames [e->fNumArgs] = argNames[i];
+        e->fArgTypes [e->fNumArgs] = argTypes[i];
+        e->fArgValues[e->fNumArgs] = argValues[i];
+        e->fNumArgs++;
+    }
+    buffer->endWrite(e);
+
+    buffer->fNext.store(position + 1, std::memory_order_release);
+    return position + 1;
+}
+
+void SkRingBufferEventTracer::updateTraceEventDuration(const uint8_t*, const char*,
+                                                       SkEventTracer::Handle handle) {
+    if (0 == handle) {
+        return;
+    }
+    uint64_t now = (uint64_t)SkTime::GetNSecs();
+    ThreadBuffer* buffer = this->threadBuffer();
+    uint64_t position = handle - 1;
+    if (buffer->fNext.load(std::memory_order_relaxed) - position > (uint64_t)buffer->fCapacity) {
+        return;  // Already overwritten.
+    }
+
+    Event* e = buffer->beginWrite(position);
+    e->fDurationNs = now - e->fStartNs;
+    buffer->endWrite(e);
+}
+
+static void write_escaped(SkWStream* out, const char* str) {
+    out->write("\"", 1);
+    for (const char* c = str; *c; c++) {
+        if ('"' == *c || '\\' == *c) {
+            out->write("\\", 1);
+        }
+        if ((unsigned char)*c < 0x20) {
+            continue;
+        }
+        out->write(c, 1);
+    }
+    out->write("\"", 1);
+}
+
+static void write_arg(SkWStream* out, uint8_t type, uint64_t value) {
+    switch (type) {
+        case TRACE_VALUE_TYPE_BOOL:
+            out->writeText(value ? "true" : "false");
+            break;
+        case TRACE_VALUE_TYPE_UINT:
+            out->writeText(SkStringPrintf("%llu", (unsigned long long)value).c_str());
+            break;
+        case TRACE_VALUE_TYPE_INT:
+            out->writeText(SkStringPrintf("%lld", (long long)value).c_str());
+            break;
+        case TRACE_VALUE_TYPE_DOUBLE: {
+            double d;
+            memcpy(&d, &value, sizeof(d));
+            out->writeText(SkStringPrintf("%g", d).c_str());
+            break;
+        }
+        case TRACE_VALUE_TYPE_STRING:
+            write_escaped(out, value ? reinterpret_cast<const char*>(value) : "");
+            break;
+        default:
+            out->writeText(SkStringPrintf("\"0x%llx\"", (unsigned long long)value).c_str());
+            break;
+    }
+}
+
+void SkRingBufferEventTracer::dumpChromeTraceJSON(SkWStream* out) const {
+    SkAutoMutexAcquire lock(fMutex);
+    out->writeText("{\"traceEvents\":[");
+    bool first = true;
+    for (const ThreadBuffer* buffer : fThreads) {
+        uint64_t next  = buffer->fNext.load(std::memory_order_acquire);
+        uint64_t start = next > (uint64_t)buffer->fCapacity ? next - buffer->fCapacity : 0;
+        for (uint64_t position = start; position < next; position++) {
+            Event e;
+            if (!buffer->read(position, &e)) {
+                continue;
+            }
+            out->writeText(first ? "\n" : ",\n");
+            first = false;
+
+            out->writeText("{\"name\":");
+            write_escaped(out, e.fName);
+            out->writeText(",\"cat\":");
+            write_escaped(out, fCategoryNames[e.fCategory]);
+            out->writeText(SkStringPrintf(",\"ph\":\"%c\",\"pid\":0,\"tid\":%d,\"ts\":%.3f",
+                                          e.fPhase, buffer->fThreadID,
+                                          e.fStartNs * 1e-3).c_str());
+            if (TRACE_EVENT_PHASE_COMPLETE == e.fPhase) {
+                out->writeText(SkStringPrintf(",\"dur\":%.3f", e.fDurationNs * 1e-3).c_str());
+            }
+            if (e.fFlags & TRACE_EVENT_FLAG_HAS_ID) {
+                out->writeText(SkStringPrintf(",\"id\":\"0x%llx\"",
+                                              (unsigned long long)e.fID).c_str());
+            }
+            if (e.fNumArgs) {
+                out->writeText(",\"args\":{");
+                for (int i = 0; i < e.fNumArgs; i++) {
+                    if (i) {
+                        out->writeText(",");
+                    }
+                    write_escaped(out, e.fArgNames[i]);
+                    out->writeText(":");
+                    write_arg(out, e.fArgTypes[i], e.fArgValues[i]);
+                }
+                out->writeText("}");
+            }
+            out->writeText("}");
+        }
+    }
+    out->writeText("\n]}\n");
+}
@@ -7,15 +7,19 @@
 
 #include "SkTextureCompressor.h"
 #include "SkTextureCompressor_ASTC.h"
+#include "SkTextureCompressor_BC.h"
+#include "SkTextureCompressor_ETC2.h"
 #include "SkTextureCompressor_LATC.h"
 #include "SkTextureCompressor_R11EAC.h"
 
+#include "SkAtomics.h"
 #include "SkBitmap.h"
 #include "SkBitmapProcShader.h"
 #include "SkData.h"
 #include "SkEndian.h"
 #include "SkMathPriv.h"
 #include "SkOpts.h"
+#include "SkTaskGroup.h"
 
 #ifndef SK_IGNORE_ETC1_SUPPORT
 #  include "etc1.h"
@@ -25,12 +29,69 @@
 static bool compress_etc1_565(uint8_t* dst, const uint8_t* src,
                               int width, int height, size_t rowBytes) {
 #ifndef SK_IGNORE_ETC1_SUPPORT
-    return 0 == etc1_encode_image(src, width, height, 2, SkToInt(rowBytes), dst);
+    if ((width % 4) != 0 || (height % 4) != 0) {
+        return 0 == etc1_encode_image(src, width, height, 2, SkToInt(rowBytes), dst);
+    }
+    // Each row of blocks is independent, so encode them in parallel.
+    const size_t dstRowBytes = (width / 4) * ETC1_ENCODED_BLOCK_SIZE;
+    SkAtomic<bool> ok(true);
+    SkTaskGroup().batch(height / 4, [&](int y) {
+        if (0 != etc1_encode_image(src + 4 * y * rowBytes, width, 4, 2, SkToInt(rowBytes),
+                                   dst + y * dstRowBytes)) {
+            ok.store(false);
+        }
+    });
+    return ok.load();
 #else
     return false;
 #endif
 }
 
+typedef void (*CompressBlockProc)(uint8_t* dst, const uint8_t* src, size_t rowBytes);
+
+// Compress 4x4 blocks of N32 pixels, each row of blocks in parallel.
+static bool compress_n32_blocks(uint8_t* dst, const uint8_t* src, int width, int height,
+                                size_t rowBytes, int blockSize, CompressBlockProc proc) {
+    if ((width % 4) != 0 || (height % 4) != 0) {
+        return false;
+    }
+    const int blocksX = width / 4;
+    SkTaskGroup().batch(height / 4, [&](int y) {
+        const uint8_t* srcRow = src + 4 * y * rowBytes;
+        uint8_t* dstRow = dst + y * blocksX * blockSize;
+        for (int x = 0; x < blocksX; ++x) {
+            proc(dstRow + x * blockSize, srcRow + x * 4 * sizeof(SkPMColor), rowBytes);
+        }
+    });
+    return true;
+}
+
+#ifndef SK_IGNORE_ETC1_SUPPORT
+static bool compress_etc1_n32(uint8_t* dst, const uint8_t* src,
+                              int width, int height, size_t rowBytes) {
+    return compress_n32_blocks(dst, src, width, height, rowBytes, ETC1_ENCODED_BLOCK_SIZE,
+                               SkTextureCompressor::CompressN32BlockToETC1);
+}
+
+static bool compress_etc2_rgba8_n32(uint8_t* dst, const uint8_t* src,
+                                    int width, int height, size_t rowBytes) {
+    return compress_n32_blocks(dst, src, width, height, rowBytes, 16,
+                               SkTextureCompressor::CompressN32BlockToETC2RGBA8);
+}
+#endif
+
+static bool compress_bc1_n32(uint8_t* dst, const uint8_t* src,
+                             int width, int height, size_t rowBytes) {
+    return compress_n32_blocks(dst, src, width, height, rowBytes, 8,
+                               SkTextureCompressor::CompressN32BlockToBC1);
+}
+
+static bool compress_bc3_n32(uint8_t* dst, const uint8_t* src,
+                             int width, int height, size_t rowBytes) {
+    return compress_n32_blocks(dst, src, width, height, rowBytes, 16,
+                               SkTextureCompressor::CompressN32BlockToBC3);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 namespace SkTextureCompressor {
@@ -66,6 +127,9 @@ void GetBlockDimensions(Format format, int* dimX, int* dimY, bool matchSpec) {
         { 10, 10 }, // kASTC_10x10_Format
         { 12, 10 }, // kASTC_12x10_Format
         { 12, 12 }, // kASTC_12x12_Format
+        { 4, 4 }, // kETC2_RGBA8_Format
+        { 4, 4 }, // kBC1_Format
+        { 4, 4 }, // kBC3_Format
     };
 
     *dimX = kFormatDimensions[format].fBlockSizeX;
@@ -83,10 +147,13 @@ int GetCompressedDataSize(Format fmt, int width, int height) {
         case kLATC_Format:
         case kR11_EAC_Format:
         case kETC1_Format:
+        case kBC1_Format:
             encodedBlockSize = 8;
             break;
 
-        // This format is 128 bits.
+        // These formats are 128 bits.
+        case kETC2_RGBA8_Format:
+        case kBC3_Format:
         case kASTC_4x4_Format:
         case kASTC_5x4_Format:
         case kASTC_5x5_Format:
@@ -135,6 +202,14 @@ bool CompressBufferToFormat(uint8_t* dst, const uint8_t* src, SkColorType srcCol
         case kRGB_565_SkColorType:
             if (format == kETC1_Format) { proc = compress_etc1_565; }
             break;
+        case kN32_SkColorType:
+#ifndef SK_IGNORE_ETC1_SUPPORT
+            if (format == kETC1_Format)       { proc = compress_etc1_n32;       }
+            if (format == kETC2_RGBA8_Format) { proc = compress_etc2_rgba8_n32; }
+#endif
+            if (format == kBC1_Format)        { proc = compress_bc1_n32;        }
+            if (format == kBC3_Format)        { proc = compress_bc3_n32;        }
+            break;
         default:
             break;
     }
@@ -202,8 +277,19 @@ bool DecompressBufferFromFormat(uint8_t* dst, int dstRowBytes, const uint8_t* sr
 #ifndef SK_IGNORE_ETC1_SUPPORT
         case kETC1_Format:
             return 0 == etc1_decode_image(src, dst, width, height, 3, dstRowBytes);
+
+        case kETC2_RGBA8_Format:
+            return DecompressETC2RGBA8(dst, dstRowBytes, src, width, height);
 #endif
 
+        case kBC1_Format:
+            DecompressBC1(dst, dstRowBytes, src, width, height);
+            return true;
+
+        case kBC3_Format:
+            DecompressBC3(dst, dstRowBytes, src, width, height);
+            return true;
+
         case kASTC_4x4_Format:
         case kASTC_5x4_Format:
         case kASTC_5x5_Format:
@@ -23,11 +23,9 @@ namespace SkTextureCompressor {
         kR11_EAC_Format,    // 4x4 blocks, (de)compresses A8
 
         // RGB only formats
-        kETC1_Format,       // 4x4 blocks, compresses RGB 565, decompresses 8-bit RGB
-                            //    NOTE: ETC1 supports 8-bit RGB compression, but we
-                            //    currently don't have any RGB8 SkColorTypes. We could
-                            //    support 8-bit RGBA but we would have to preprocess the
-                            //    bitmap to insert alphas.
+        kETC1_Format,       // 4x4 blocks, compresses RGB 565 or N32 (ignoring alpha),
+                            //    decompresses 8-bit RGB. The blocks are also valid
+                            //    ETC2 RGB8 blocks.
 
         // Multi-purpose formats
         kASTC_4x4_Format,   // 4x4 blocks, no compression, decompresses RGBA
@@ -45,7 +43,12 @@ namespace SkTextureCompressor {
         kASTC_12x10_Format, // 12x10 blocks, no compression, decompresses RGBA
         kASTC_12x12_Format, // 12x12 blocks, compresses A8, decompresses RGBA
 
-        kLast_Format = kASTC_12x12_Format
+        // RGBA formats. These compress N32 and decompress RGBA.
+        kETC2_RGBA8_Format, // 4x4 blocks, EAC alpha plus ETC2 (in practice ETC1) color
+        kBC1_Format,        // 4x4 blocks, a.k.a. DXT1, opaque
+        kBC3_Format,        // 4x4 blocks, a.k.a. DXT5
+
+        kLast_Format = kBC3_Format
     };
     static const int kFormatCnt = kLast_Format + 1;
 
@@ -63,6 +66,8 @@ namespace SkTextureCompressor {
     // Compresses the given src data into dst. The src data is assumed to be
     // large enough to hold width*height pixels. The dst data is expected to
     // be large enough to hold the compressed data according to the format.
+    // Formats that compress N32 work on rows of blocks in parallel, on
+    // SkTaskGroup threads.
     bool CompressBufferToFormat(uint8_t* dst, const uint8_t* src, SkColorType srcColorType,
                                 int width, int height, size_t rowBytes, Format format);
 
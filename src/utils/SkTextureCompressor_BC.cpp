@@ -0,0 +1,353 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkTextureCompressor_BC.h"
+
+#include "SkColorPriv.h"
+#include "SkEndian.h"
+#include "SkNx.h"
+
+// BC1 (a.k.a. DXT1) blocks are 64 bits:
+// |       color0 (565)       |       color1 (565)       | 16 2-bit indices |
+//
+// color0 and color1 are little endian, and the indices run from the low bits
+// up, in row major order. When color0 > color1, index 2 is 2/3 color0 + 1/3
+// color1 and index 3 the reverse. Otherwise index 2 is their average and index
+// 3 is transparent black, which we never use.
+//
+// BC3 (a.k.a. DXT5) blocks are 128 bits: 64 bits of alpha followed by a BC1
+// block, whose colors are always read in the four color mode.
+// |  alpha0  |  alpha1  |               16 3-bit indices                |
+//
+// When alpha0 > alpha1, index 0 is alpha0, 1 is alpha1, and 2 through 7 step
+// from alpha0 to alpha1 in sevenths.
+//
+// We find color endpoints as most encoders do: take the pixels at either end
+// of the block's principal axis, pick each pixel's nearest palette entry, then
+// refit the endpoints to those choices by least squares and keep whichever
+// encoding is closer. Distances to all four palette entries are measured at
+// once with Sk4f.
+
+struct ColorBlock {
+    float fR[16], fG[16], fB[16];
+};
+
+static inline uint16_t pack_565(float r, float g, float b) {
+    int r5 = SkTPin(static_cast<int>(r * (31 / 255.0f) + 0.5f), 0, 31),
+        g6 = SkTPin(static_cast<int>(g * (63 / 255.0f) + 0.5f), 0, 63),
+        b5 = SkTPin(static_cast<int>(b * (31 / 255.0f) + 0.5f), 0, 31);
+    return static_cast<uint16_t>((r5 << 11) | (g6 << 5) | b5);
+}
+
+static inline void unpack_565(uint16_t c, int rgb[3]) {
+    const int r5 = c >> 11, g6 = (c >> 5) & 0x3F, b5 = c & 0x1F;
+    rgb[0] = (r5 << 3) | (r5 >> 2);
+    rgb[1] = (g6 << 2) | (g6 >> 4);
+    rgb[2] = (b5 << 3) | (b5 >> 2);
+}
+
+// The four color palette for color0 > color1, as the decoder computes it.
+static void four_color_palette(uint16_t c0, uint16_t c1, int palette[4][3]) {
+    unpack_565(c0, palette[0]);
+    unpack_565(c1, palette[1]);
+    for (int i = 0; i < 3; ++i) {
+        palette[2][i] = (2 * palette[0][i] + palette[1][i]) / 3;
+        palette[3][i] = (palette[0][i] + 2 * palette[1][i]) / 3;
+    }
+}
+
+// Choose the nearest of the four palette entries for each pixel, returning the
+// packed indices and adding the squared error to *error.
+static uint32_t pick_indices(const ColorBlock& block, uint16_t c0, uint16_t c1, float* error) {
+    int palette[4][3];
+    four_color_palette(c0, c1, palette);
+    const Sk4f r(palette[0][0], palette[1][0], palette[2][0], palette[3][0]),
+               g(palette[0][1], palette[1][1], palette[2][1], palette[3][1]),
+               b(palette[0][2], palette[1][2], palette[2][2], palette[3][2]);
+
+    uint32_t indices = 0;
+    float total = 0;
+    for (int i = 0; i < 16; ++i) {
+        const Sk4f dr = r - Sk4f(block.fR[i]),
+                   dg = g - Sk4f(block.fG[i]),
+                   db = b - Sk4f(block.fB[i]);
+        float dist[4];
+        (dr * dr + dg * dg + db * db).store(dist);
+        int best = 0;
+        for (int j = 1; j < 4; ++j) {
+            if (dist[j] < dist[best]) {
+                best = j;
+            }
+        }
+        total += dist[best];
+        indices |= best << (2 * i);
+    }
+    *error += total;
+    return indices;
+}
+
+// Encode the colors with the given endpoints, ordered so the block uses the
+// four color mode.
+static uint64_t encode_endpoints(const ColorBlock& block, uint16_t c0, uint16_t c1,
+                                 float* error) {
+    if (c0 < c1) {
+        SkTSwap(c0, c1);
+    }
+    uint32_t indices = 0;
+    if (c0 == c1) {
+        // Every pixel uses color0, whichever mode this is.
+        int rgb[3];
+        unpack_565(c0, rgb);
+        for (int i = 0; i < 16; ++i) {
+            const float dr = rgb[0] - block.fR[i],
+                        dg = rgb[1] - block.fG[i],
+                        db = rgb[2] - block.fB[i];
+            *error += dr * dr + dg * dg + db * db;
+        }
+    } else {
+        indices = pick_indices(block, c0, c1, error);
+    }
+    return static_cast<uint64_t>(c0) |
+           static_cast<uint64_t>(c1) << 16 |
+           static_cast<uint64_t>(indices) << 32;
+}
+
+// Least squares endpoints for the palette choices in indices. Returns false if
+// the choices don't determine two endpoints.
+static bool refit_endpoints(const ColorBlock& block, uint32_t indices,
+                            uint16_t* c0, uint16_t* c1) {
+    static const float kWeights[4] = { 1, 0, 2 / 3.0f, 1 / 3.0f };
+    float aa = 0, ab = 0, bb = 0;
+    Sk4f ax(0), bx(0);
+    for (int i = 0; i < 16; ++i) {
+        const float a = kWeights[(indices >> (2 * i)) & 3],
+                    b = 1 - a;
+        const Sk4f x(block.fR[i], block.fG[i], block.fB[i], 0);
+        aa += a * a;
+        ab += a * b;
+        bb += b * b;
+        ax = ax + x * Sk4f(a);
+        bx = bx + x * Sk4f(b);
+    }
+    const float det = aa * bb - ab * ab;
+    if (SkScalarNearlyZero(det)) {
+        return false;
+    }
+    const float invDet = 1 / det;
+    float e0[4], e1[4];
+    ((ax * Sk4f(bb) - bx * Sk4f(ab)) * Sk4f(invDet)).store(e0);
+    ((bx * Sk4f(aa) - ax * Sk4f(ab)) * Sk4f(invDet)).store(e1);
+    *c0 = pack_565(e0[0], e0[1], e0[2]);
+    *c1 = pack_565(e1[0], e1[1], e1[2]);
+    return true;
+}
+
+static uint64_t compress_color_block(const uint8_t* src, size_t rowBytes) {
+    ColorBlock block;
+    float mean[3] = { 0, 0, 0 };
+    for (int y = 0; y < 4; ++y) {
+        const SkPMColor* row = reinterpret_cast<const SkPMColor*>(src + y * rowBytes);
+        for (int x = 0; x < 4; ++x) {
+            const int i = y * 4 + x;
+            block.fR[i] = static_cast<float>(SkGetPackedR32(row[x]));
+            block.fG[i] = static_cast<float>(SkGetPackedG32(row[x]));
+            block.fB[i] = static_cast<float>(SkGetPackedB32(row[x]));
+            mean[0] += block.fR[i];
+            mean[1] += block.fG[i];
+            mean[2] += block.fB[i];
+        }
+    }
+    for (int c = 0; c < 3; ++c) {
+        mean[c] *= 1 / 16.0f;
+    }
+
+    // Covariance, then a few rounds of power iteration for the principal axis.
+    float cov[6] = { 0, 0, 0, 0, 0, 0 };
+    for (int i = 0; i < 16; ++i) {
+        const float r = block.fR[i] - mean[0],
+                    g = block.fG[i] - mean[1],
+                    b = block.fB[i] - mean[2];
+        cov[0] += r * r;
+        cov[1] += r * g;
+        cov[2] += r * b;
+        cov[3] += g * g;
+        cov[4] += g * b;
+        cov[5] += b * b;
+    }
+    float axis[3] = { 1, 1, 1 };
+    for (int iter = 0; iter < 4; ++iter) {
+        const float r = axis[0] * cov[0] + axis[1] * cov[1] + axis[2] * cov[2],
+                    g = axis[0] * cov[1] + axis[1] * cov[3] + axis[2] * cov[4],
+                    b = axis[0] * cov[2] + axis[1] * cov[4] + axis[2] * cov[5];
+        const float m = SkTMax(SkTMax(SkScalarAbs(r), SkScalarAbs(g)), SkScalarAbs(b));
+        if (m < 1e-6f) {
+            break;
+        }
+        axis[0] = r / m;
+        axis[1] = g / m;
+        axis[2] = b / m;
+    }
+
+    int minIndex = 0, maxIndex = 0;
+    float minDot = SK_FloatInfinity, maxDot = -SK_FloatInfinity;
+    for (int i = 0; i < 16; ++i) {
+        const float dot = block.fR[i] * axis[0] + block.fG[i] * axis[1] + block.fB[i] * axis[2];
+        if (dot < minDot) {
+            minDot = dot;
+            minIndex = i;
+        }
+        if (dot > maxDot) {
+            maxDot = dot;
+            maxIndex = i;
+        }
+    }
+
+    float error = 0;
+    uint64_t encoded = encode_endpoints(
+            block,
+            pack_565(block.fR[maxIndex], block.fG[maxIndex], block.fB[maxIndex]),
+            pack_565(block.fR[minIndex], block.fG[minIndex], block.fB[minIndex]),
+            &error);
+
+    uint16_t c0, c1;
+    if (error > 0 && refit_endpoints(block, static_cast<uint32_t>(encoded >> 32), &c0, &c1)) {
+        float refitError = 0;
+        const uint64_t refit = encode_endpoints(block, c0, c1, &refitError);
+        if (refitError < error) {
+            encoded = refit;
+        }
+    }
+    return encoded;
+}
+
+static uint64_t compress_alpha_block(const uint8_t* src, size_t rowBytes) {
+    uint8_t alpha[16];
+    int minA = 255, maxA = 0;
+    for (int y = 0; y < 4; ++y) {
+        const SkPMColor* row = reinterpret_cast<const SkPMColor*>(src + y * rowBytes);
+        for (int x = 0; x < 4; ++x) {
+            const int a = SkGetPackedA32(row[x]);
+            alpha[y * 4 + x] = a;
+            minA = SkTMin(minA, a);
+            maxA = SkTMax(maxA, a);
+        }
+    }
+    if (minA == maxA) {
+        // Every index is zero, for alpha0.
+        return static_cast<uint64_t>(maxA) | static_cast<uint64_t>(minA) << 8;
+    }
+
+    // Eight step mode: step s of seven from minA to maxA has index 1 for s == 0,
+    // 0 for s == 7, and 8 - s otherwise.
+    const float scale = 7.0f / (maxA - minA);
+    uint64_t indices = 0;
+    for (int i = 0; i < 16; ++i) {
+        const int step = static_cast<int>((alpha[i] - minA) * scale + 0.5f);
+        const uint64_t index = 0 == step ? 1 : 7 == step ? 0 : 8 - step;
+        indices |= index << (3 * i);
+    }
+    return static_cast<uint64_t>(maxA) | static_cast<uint64_t>(minA) << 8 | indices << 16;
+}
+
+static void decompress_color_block(uint8_t* dst, int dstRowBytes, const uint8_t* src,
+                                   bool allowThreeColor) {
+    const uint64_t block = SkEndian_SwapLE64(*reinterpret_cast<const uint64_t*>(src));
+    const uint16_t c0 = block & 0xFFFF,
+                   c1 = (block >> 16) & 0xFFFF;
+    int palette[4][4];
+    unpack_565(c0, palette[0]);
+    unpack_565(c1, palette[1]);
+    palette[0][3] = palette[1][3] = palette[2][3] = palette[3][3] = 0xFF;
+    if (c0 > c1 || !allowThreeColor) {
+        for (int i = 0; i < 3; ++i) {
+            palette[2][i] = (2 * palette[0][i] + palette[1][i]) / 3;
+            palette[3][i] = (palette[0][i] + 2 * palette[1][i]) / 3;
+        }
+    } else {
+        for (int i = 0; i < 3; ++i) {
+            palette[2][i] = (palette[0][i] + palette[1][i]) / 2;
+            palette[3][i] = 0;
+        }
+        palette[3][3] = 0;
+    }
+
+    const uint32_t indices = static_cast<uint32_t>(block >> 32);
+    for (int y = 0; y < 4; ++y) {
+        for (int x = 0; x < 4; ++x) {
+            const int* color = palette[(indices >> (2 * (y * 4 + x))) & 3];
+            for (int c = 0; c < 4; ++c) {
+                dst[x * 4 + c] = color[c];
+            }
+        }
+        dst += dstRowBytes;
+    }
+}
+
+static void decompress_alpha_block(uint8_t* dst, int dstRowBytes, const uint8_t* src) {
+    const uint64_t block = SkEndian_SwapLE64(*reinterpret_cast<const uint64_t*>(src));
+    const int a0 = block & 0xFF,
+              a1 = (block >> 8) & 0xFF;
+    int palette[8] = { a0, a1 };
+    if (a0 > a1) {
+        for (int i = 2; i < 8; ++i) {
+            palette[i] = ((8 - i) * a0 + (i - 1) * a1) / 7;
+        }
+    } else {
+        for (int i = 2; i < 6; ++i) {
+            palette[i] = ((6 - i) * a0 + (i - 1) * a1) / 5;
+        }
+        palette[6] = 0;
+        palette[7] = 0xFF;
+    }
+    for (int y = 0; y < 4; ++y) {
+        for (int x = 0; x < 4; ++x) {
+            dst[x * 4 + 3] = palette[(block >> (16 + 3 * (y * 4 + x))) & 7];
+        }
+        dst += dstRowBytes;
+    }
+}
+
+static inline void store_le64(uint8_t* dst, uint64_t x) {
+    x = SkEndian_SwapLE64(x);
+    memcpy(dst, &x, sizeof(x));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace SkTextureCompressor {
+
+void CompressN32BlockToBC1(uint8_t* dst, const uint8_t* src, size_t rowBytes) {
+    store_le64(dst, compress_color_block(src, rowBytes));
+}
+
+void CompressN32BlockToBC3(uint8_t* dst, const uint8_t* src, size_t rowBytes) {
+    store_le64(dst, compress_alpha_block(src, rowBytes));
+    store_le64(dst + 8, compress_color_block(src, rowBytes));
+}
+
+void DecompressBC1(uint8_t* dst, int dstRowBytes, const uint8_t* src, int width, int height) {
+    for (int j = 0; j < height; j += 4) {
+        for (int i = 0; i < width; i += 4) {
+            decompress_color_block(dst + i * 4, dstRowBytes, src, true);
+            src += 8;
+        }
+        dst += 4 * dstRowBytes;
+    }
+}
+
+void DecompressBC3(uint8_t* dst, int dstRowBytes, const uint8_t* src, int width, int height) {
+    for (int j = 0; j < height; j += 4) {
+        for (int i = 0; i < width; i += 4) {
+            decompress_color_block(dst + i * 4, dstRowBytes, src + 8, false);
+            decompress_alpha_block(dst + i * 4, dstRowBytes, src);
+            src += 16;
+        }
+        dst += 4 * dstRowBytes;
+    }
+}
+
+}  // namespace SkTextureCompressor
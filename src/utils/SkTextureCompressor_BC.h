@@ -0,0 +1,24 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkTextureCompressor_BC_DEFINED
+#define SkTextureCompressor_BC_DEFINED
+
+#include "SkTypes.h"
+
+namespace SkTextureCompressor {
+
+    // Compress one 4x4 block of N32 pixels. BC1 ignores alpha; BC3 keeps it.
+    void CompressN32BlockToBC1(uint8_t* dst, const uint8_t* src, size_t rowBytes);
+    void CompressN32BlockToBC3(uint8_t* dst, const uint8_t* src, size_t rowBytes);
+
+    // Decompress into 4-byte RGBA pixels.
+    void DecompressBC1(uint8_t* dst, int dstRB, const uint8_t* src, int width, int height);
+    void DecompressBC3(uint8_t* dst, int dstRB, const uint8_t* src, int width, int height);
+}
+
+#endif  // SkTextureCompressor_BC_DEFINED
@@ -0,0 +1,238 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkTextureCompressor_ETC2.h"
+
+#include "SkColorPriv.h"
+#include "SkEndian.h"
+#include "SkNx.h"
+
+#ifndef SK_IGNORE_ETC1_SUPPORT
+
+#include "etc1.h"
+
+// ETC2 RGBA8 blocks are 128 bits: an EAC alpha block followed by an ETC2 RGB
+// block. Both are big endian. The alpha block is laid out like R11 EAC:
+// |  base  | mul | tbl |               16 3-bit indices                |
+//
+// with the indices in column major order, and each alpha is
+// clamp[0, 255](base + modifier[tbl][index] * mul).
+//
+// The color block comes from the ETC1 encoder. ETC2 gives the differential
+// mode's out of range colors new meanings (the T, H and planar modes), but the
+// ETC1 encoder never writes those, so its blocks mean the same to either.
+//
+// For alpha we try each modifier table with the multipliers and base values
+// that best span the block's range, measuring each pixel's distance to all
+// eight palette entries with a pair of Sk4fs.
+
+static const int kNumEACTables = 16;
+static const int kEACTableSize = 8;
+// These are the same modifiers as R11 EAC's.
+static const int kEACModifierTables[kNumEACTables][kEACTableSize] = {
+    {-3, -6, -9, -15, 2, 5, 8, 14},
+    {-3, -7, -10, -13, 2, 6, 9, 12},
+    {-2, -5, -8, -13, 1, 4, 7, 12},
+    {-2, -4, -6, -13, 1, 3, 5, 12},
+    {-3, -6, -8, -12, 2, 5, 7, 11},
+    {-3, -7, -9, -11, 2, 6, 8, 10},
+    {-4, -7, -8, -11, 3, 6, 7, 10},
+    {-3, -5, -8, -11, 2, 4, 7, 10},
+    {-2, -6, -8, -10, 1, 5, 7, 9},
+    {-2, -5, -8, -10, 1, 4, 7, 9},
+    {-2, -4, -8, -10, 1, 3, 7, 9},
+    {-2, -5, -7, -10, 1, 4, 6, 9},
+    {-3, -4, -7, -10, 2, 3, 6, 9},
+    {-1, -2, -3, -10, 0, 1, 2, 9},
+    {-4, -6, -8, -9, 3, 5, 7, 8},
+    {-3, -5, -7, -9, 2, 4, 6, 8}
+};
+
+// Table 13 has a zero modifier, at index 4.
+static const int kZeroModifierTable = 13;
+static const int kZeroModifierIndex = 4;
+
+static inline int eac_alpha(int base, int modifier, int multiplier) {
+    return SkTPin(base + modifier * multiplier, 0, 255);
+}
+
+static void eac_palette(int base, int table, int multiplier, Sk4f* lo, Sk4f* hi) {
+    const int* m = kEACModifierTables[table];
+    *lo = Sk4f(static_cast<float>(eac_alpha(base, m[0], multiplier)),
+               static_cast<float>(eac_alpha(base, m[1], multiplier)),
+               static_cast<float>(eac_alpha(base, m[2], multiplier)),
+               static_cast<float>(eac_alpha(base, m[3], multiplier)));
+    *hi = Sk4f(static_cast<float>(eac_alpha(base, m[4], multiplier)),
+               static_cast<float>(eac_alpha(base, m[5], multiplier)),
+               static_cast<float>(eac_alpha(base, m[6], multiplier)),
+               static_cast<float>(eac_alpha(base, m[7], multiplier)));
+}
+
+// Squared error of the best palette entry for each pixel, giving up once it
+// reaches limit.
+static float eac_error(const float alpha[16], const Sk4f& lo, const Sk4f& hi, float limit) {
+    float error = 0;
+    for (int i = 0; i < 16 && error < limit; ++i) {
+        const Sk4f a(alpha[i]);
+        const Sk4f dl = lo - a, dh = hi - a;
+        const Sk4f d = Sk4f::Min(dl * dl, dh * dh);
+        error += SkTMin(SkTMin(d[0], d[1]), SkTMin(d[2], d[3]));
+    }
+    return error;
+}
+
+static uint64_t compress_eac_alpha_block(const uint8_t* src, size_t rowBytes) {
+    // Column major, as the indices are stored.
+    float alpha[16];
+    int minA = 255, maxA = 0;
+    for (int y = 0; y < 4; ++y) {
+        const SkPMColor* row = reinterpret_cast<const SkPMColor*>(src + y * rowBytes);
+        for (int x = 0; x < 4; ++x) {
+            const int a = SkGetPackedA32(row[x]);
+            alpha[x * 4 + y] = static_cast<float>(a);
+            minA = SkTMin(minA, a);
+            maxA = SkTMax(maxA, a);
+        }
+    }
+
+    int bestBase = minA, bestTable = kZeroModifierTable, bestMultiplier = 1;
+    if (minA != maxA) {
+        float bestError = SK_FloatInfinity;
+        for (int table = 0; table < kNumEACTables && bestError > 0; ++table) {
+            const int* m = kEACModifierTables[table];
+            const int span = m[7] - m[3];
+            const int mul = SkTPin((maxA - minA + span / 2) / span, 1, 15);
+            for (int multiplier = SkTMax(mul - 1, 1); multiplier <= SkTMin(mul + 1, 15);
+                 ++multiplier) {
+                const int center = (maxA + minA - (m[7] + m[3]) * multiplier + 1) >> 1;
+                for (int base = SkTMax(center - 1, 0); base <= SkTMin(center + 1, 255); ++base) {
+                    Sk4f lo, hi;
+                    eac_palette(base, table, multiplier, &lo, &hi);
+                    const float error = eac_error(alpha, lo, hi, bestError);
+                    if (error < bestError) {
+                        bestError = error;
+                        bestBase = base;
+                        bestTable = table;
+                        bestMultiplier = multiplier;
+                    }
+                }
+            }
+        }
+    }
+
+    const int* m = kEACModifierTables[bestTable];
+    uint64_t indices = 0;
+    for (int i = 0; i < 16; ++i) {
+        int best = kZeroModifierIndex;
+        if (minA != maxA) {
+            int bestDist = SK_MaxS32;
+            for (int j = 0; j < kEACTableSize; ++j) {
+                const int d = SkAbs32(eac_alpha(bestBase, m[j], bestMultiplier) -
+                                      static_cast<int>(alpha[i]));
+                if (d < bestDist) {
+                    bestDist = d;
+                    best = j;
+                }
+            }
+        }
+        indices |= static_cast<uint64_t>(best) << ((15 - i) * 3);
+    }
+    return static_cast<uint64_t>(bestBase) << 56 |
+           static_cast<uint64_t>(bestMultiplier) << 52 |
+           static_cast<uint64_t>(bestTable) << 48 |
+           indices;
+}
+
+static void decompress_eac_alpha_block(uint8_t* dst, int dstRowBytes, const uint8_t* src) {
+    uint64_t block;
+    memcpy(&block, src, sizeof(block));
+    block = SkEndian_SwapBE64(block);
+
+    const int base = (block >> 56) & 0xFF;
+    const int multiplier = (block >> 52) & 0xF;
+    const int* m = kEACModifierTables[(block >> 48) & 0xF];
+    for (int y = 0; y < 4; ++y) {
+        for (int x = 0; x < 4; ++x) {
+            const int index = (block >> ((15 - (x * 4 + y)) * 3)) & 0x7;
+            dst[x * 4 + 3] = eac_alpha(base, m[index], multiplier);
+        }
+        dst += dstRowBytes;
+    }
+}
+
+// True if the differential mode's base color plus its delta leaves [0, 31] in
+// any channel, which ETC2 reads as one of its new modes.
+static bool uses_etc2_only_mode(const uint8_t* block) {
+    if (!(block[3] & 0x2)) {
+        return false;
+    }
+    for (int c = 0; c < 3; ++c) {
+        const int base = block[c] >> 3;
+        const int delta = (static_cast<int>(block[c] & 0x7) ^ 0x4) - 0x4;
+        if (base + delta < 0 || base + delta > 31) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void load_rgb_block(etc1_byte rgb[ETC1_DECODED_BLOCK_SIZE], const uint8_t* src,
+                           size_t rowBytes) {
+    for (int y = 0; y < 4; ++y) {
+        const SkPMColor* row = reinterpret_cast<const SkPMColor*>(src + y * rowBytes);
+        for (int x = 0; x < 4; ++x) {
+            etc1_byte* p = rgb + 3 * (y * 4 + x);
+            p[0] = SkGetPackedR32(row[x]);
+            p[1] = SkGetPackedG32(row[x]);
+            p[2] = SkGetPackedB32(row[x]);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace SkTextureCompressor {
+
+void CompressN32BlockToETC1(uint8_t* dst, const uint8_t* src, size_t rowBytes) {
+    etc1_byte rgb[ETC1_DECODED_BLOCK_SIZE];
+    load_rgb_block(rgb, src, rowBytes);
+    etc1_encode_block(rgb, 0xFFFF, dst);
+}
+
+void CompressN32BlockToETC2RGBA8(uint8_t* dst, const uint8_t* src, size_t rowBytes) {
+    const uint64_t alpha = SkEndian_SwapBE64(compress_eac_alpha_block(src, rowBytes));
+    memcpy(dst, &alpha, sizeof(alpha));
+    CompressN32BlockToETC1(dst + 8, src, rowBytes);
+}
+
+bool DecompressETC2RGBA8(uint8_t* dst, int dstRowBytes, const uint8_t* src,
+                         int width, int height) {
+    etc1_byte rgb[ETC1_DECODED_BLOCK_SIZE];
+    for (int j = 0; j < height; j += 4) {
+        for (int i = 0; i < width; i += 4) {
+            if (uses_etc2_only_mode(src + 8)) {
+                return false;
+            }
+            etc1_decode_block(src + 8, rgb);
+            uint8_t* row = dst + i * 4;
+            for (int y = 0; y < 4; ++y) {
+                for (int x = 0; x < 4; ++x) {
+                    memcpy(row + x * 4, rgb + 3 * (y * 4 + x), 3);
+                }
+                row += dstRowBytes;
+            }
+            decompress_eac_alpha_block(dst + i * 4, dstRowBytes, src);
+            src += 16;
+        }
+        dst += 4 * dstRowBytes;
+    }
+    return true;
+}
+
+}  // namespace SkTextureCompressor
+
+#endif  // SK_IGNORE_ETC1_SUPPORT
@@ -0,0 +1,25 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkTextureCompressor_ETC2_DEFINED
+#define SkTextureCompressor_ETC2_DEFINED
+
+#include "SkTypes.h"
+
+namespace SkTextureCompressor {
+
+    // Compress one 4x4 block of N32 pixels. Colors only use the modes ETC2
+    // inherits from ETC1, so the ETC1 block is also a valid ETC2 RGB8 block.
+    void CompressN32BlockToETC1(uint8_t* dst, const uint8_t* src, size_t rowBytes);
+    void CompressN32BlockToETC2RGBA8(uint8_t* dst, const uint8_t* src, size_t rowBytes);
+
+    // Decompress into 4-byte RGBA pixels. Returns false if any block uses one of
+    // the color modes new to ETC2 (T, H or planar), which we don't decode.
+    bool DecompressETC2RGBA8(uint8_t* dst, int dstRB, const uint8_t* src, int width, int height);
+}
+
+#endif  // SkTextureCompressor_ETC2_DEFINED
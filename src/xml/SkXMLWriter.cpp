@@ -30,9 +30,9 @@ void SkXMLWriter::addAttribute(const char name[], const char value[])
 
 void SkXMLWriter::addS32Attribute(const char name[], int32_t value)
 {
-    SkString    tmp;
-    tmp.appendS32(value);
-    this->addAttribute(name, tmp.c_str());
+    char    buffer[SkStrAppendS32_MaxSize];
+    char*   stop = SkStrAppendS32(buffer, value);
+    this->addAttributeLen(name, buffer, stop - buffer);
 }
 
 void SkXMLWriter::addHexAttribute(const char name[], uint32_t value, int minDigits)
@@ -44,9 +44,9 @@ void SkXMLWriter::addHexAttribute(const char name[], uint32_t value, int minDigi
 
 void SkXMLWriter::addScalarAttribute(const char name[], SkScalar value)
 {
-    SkString    tmp;
-    tmp.appendScalar(value);
-    this->addAttribute(name, tmp.c_str());
+    char    buffer[SkStrAppendScalar_MaxSize];
+    char*   stop = SkStrAppendScalar(buffer, value);
+    this->addAttributeLen(name, buffer, stop - buffer);
 }
 
 void SkXMLWriter::addText(const char text[], size_t length) {
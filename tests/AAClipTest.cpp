@@ -409,6 +409,38 @@ static void test_crbug_422693(skiatest::Reporter* reporter) {
     rc.op(path, rc.getBounds(), SkRegion::kIntersect_Op, true);
 }
 
+// Clips built through the cache must match the ones built directly, and must not be
+// confused with clips built from the same path under a different matrix.
+static void test_cached_path(skiatest::Reporter* reporter) {
+    SkPath path;
+    path.addRoundRect(SkRect::MakeLTRB(10.5f, 10.5f, 90.5f, 60.5f), 8, 8);
+    SkRegion clip(SkIRect::MakeWH(100, 100));
+
+    SkAAClip expected, first, second;
+    expected.setPath(path, &clip, true);
+    const SkAAClip::PathID id(path, SkMatrix::I());
+    first.setPath(path, &clip, true, id);
+    second.setPath(path, &clip, true, id);
+    REPORTER_ASSERT(reporter, expected == first);
+    REPORTER_ASSERT(reporter, expected == second);
+
+    SkMatrix matrix;
+    matrix.setTranslate(5.25f, 3);
+    SkPath devPath;
+    path.transform(matrix, &devPath);
+    expected.setPath(devPath, &clip, true);
+    second.setPath(devPath, &clip, true, SkAAClip::PathID(path, matrix));
+    REPORTER_ASSERT(reporter, expected == second);
+    REPORTER_ASSERT(reporter, !(first == second));
+
+    SkRRect rrect;
+    rrect.setRectXY(SkRect::MakeLTRB(10.5f, 10.5f, 90.5f, 60.5f), 8, 8);
+    SkRasterClip rc(SkIRect::MakeWH(100, 100)), rc2(SkIRect::MakeWH(100, 100));
+    rc.op(rrect, rc.getBounds(), SkRegion::kIntersect_Op, true);
+    rc2.op(rrect, rc2.getBounds(), SkRegion::kIntersect_Op, true);
+    REPORTER_ASSERT(reporter, rc == rc2);
+}
+
 DEF_TEST(AAClip, reporter) {
     test_empty(reporter);
     test_path_bounds(reporter);
@@ -419,4 +451,5 @@ DEF_TEST(AAClip, reporter) {
     test_nearly_integral(reporter);
     test_really_a_rect(reporter);
     test_crbug_422693(reporter);
+    test_cached_path(reporter);
 }
@@ -0,0 +1,191 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkPath.h"
+#include "SkRegion.h"
+#include "SkScan.h"
+#include "Test.h"
+
+namespace {
+
+// Flips gSkUseAnalyticAA for its lifetime.
+class AutoAnalyticAA {
+public:
+    explicit AutoAnalyticAA(bool analytic) : fPrev(gSkUseAnalyticAA) {
+        gSkUseAnalyticAA = analytic;
+    }
+    ~AutoAnalyticAA() { gSkUseAnalyticAA = fPrev; }
+
+private:
+    bool fPrev;
+};
+
+}  // namespace
+
+static const int kSize = 64;
+
+static SkBitmap draw(const SkPath& path, bool analytic, const SkRegion* clip = nullptr) {
+    AutoAnalyticAA aaa(analytic);
+
+    SkBitmap bm;
+    bm.allocPixels(SkImageInfo::MakeA8(kSize, kSize));
+    bm.eraseColor(SK_ColorTRANSPARENT);
+
+    SkCanvas canvas(bm);
+    if (clip) {
+        canvas.clipRegion(*clip);
+    }
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    canvas.drawPath(path, paint);
+    return bm;
+}
+
+static int total_alpha(const SkBitmap& bm) {
+    int sum = 0;
+    for (int y = 0; y < bm.height(); y++) {
+        for (int x = 0; x < bm.width(); x++) {
+            sum += *bm.getAddr8(x, y);
+        }
+    }
+    return sum;
+}
+
+static int max_diff(const SkBitmap& a, const SkBitmap& b) {
+    int diff = 0;
+    for (int y = 0; y < a.height(); y++) {
+        for (int x = 0; x < a.width(); x++) {
+            diff = SkTMax(diff, SkAbs32(*a.getAddr8(x, y) - *b.getAddr8(x, y)));
+        }
+    }
+    return diff;
+}
+
+DEF_TEST(AnalyticAA_Exact, r) {
+    // A right triangle on pixel corners covers whole pixels inside, nothing outside,
+    // and exactly half of each pixel along its diagonal.
+    SkPath path;
+    path.moveTo(10, 10);
+    path.lineTo(30, 10);
+    path.lineTo(10, 30);
+    path.close();
+
+    SkBitmap bm = draw(path, true);
+    for (int y = 0; y < kSize; y++) {
+        for (int x = 0; x < kSize; x++) {
+            int expected = 0;
+            if (x >= 10 && y >= 10) {
+                int d = (x - 10) + (y - 10);
+                expected = d < 19 ? 0xFF : d == 19 ? 0x80 : 0;
+            }
+            REPORTER_ASSERT(r, *bm.getAddr8(x, y) == expected);
+        }
+    }
+
+    // A circle's coverage should be close to exact everywhere, here measured by brute-force
+    // point sampling 32x32 times per pixel, which itself is only accurate to a few bits.
+    path.reset();
+    path.addCircle(31.3f, 32.6f, 20);
+    SkBitmap circle = draw(path, true),
+             sampled;
+    sampled.allocPixels(SkImageInfo::MakeA8(kSize, kSize));
+    for (int y = 0; y < kSize; y++) {
+        for (int x = 0; x < kSize; x++) {
+            int inside = 0;
+            for (int j = 0; j < 32; j++) {
+                for (int i = 0; i < 32; i++) {
+                    SkScalar dx = x + (i + 0.5f) / 32 - 31.3f,
+                             dy = y + (j + 0.5f) / 32 - 32.6f;
+                    inside += dx*dx + dy*dy < 20*20;
+                }
+            }
+            *sampled.getAddr8(x, y) = (inside * 255 + 512) / 1024;
+        }
+    }
+    REPORTER_ASSERT(r, max_diff(circle, sampled) <= 8);
+
+    const float area = 255 * SK_ScalarPI * 20 * 20;
+    REPORTER_ASSERT(r, SkScalarAbs(total_alpha(circle) - area) < area * 0.005f);
+}
+
+DEF_TEST(AnalyticAA_MatchesSupersampling, r) {
+    SkPath circle;
+    circle.addCircle(31.3f, 32.6f, 20);
+
+    SkPath star;
+    star.moveTo(32, 2);
+    for (int i = 1; i < 5; i++) {
+        SkScalar angle = i * 4 * SK_ScalarPI / 5;
+        star.lineTo(32 + 30 * SkScalarSin(angle), 32 - 30 * SkScalarCos(angle));
+    }
+    star.close();
+
+    SkPath cubic;
+    cubic.moveTo(3, 60);
+    cubic.cubicTo(10, -20, 50, 80, 61, 4);
+    cubic.lineTo(40, 60);
+    cubic.close();
+
+    // Partly off the canvas on every side.
+    SkPath big;
+    big.addCircle(32, 32, 40);
+    big.addCircle(32, 32, 10, SkPath::kCCW_Direction);
+
+    SkPath inverse(circle);
+    inverse.setFillType(SkPath::kInverseWinding_FillType);
+
+    SkPath evenOdd(star);
+    evenOdd.setFillType(SkPath::kEvenOdd_FillType);
+
+    SkPath inverseEvenOdd(star);
+    inverseEvenOdd.setFillType(SkPath::kInverseEvenOdd_FillType);
+
+    SkRegion clip;
+    clip.op(SkIRect::MakeLTRB(4, 4, 30, 50), SkRegion::kUnion_Op);
+    clip.op(SkIRect::MakeLTRB(20, 20, 60, 40), SkRegion::kUnion_Op);
+
+    const SkRegion* clips[] = { nullptr, &clip };
+
+    // Where a path crosses itself within a pixel, we apply the fill rule to that pixel's
+    // coverage as a whole, so those pixels can differ a good bit from supersampling.
+    // Elsewhere we should be within supersampling's own error.
+    struct {
+        const SkPath& path;
+        bool          crossesItself;
+    } tests[] = {
+        { circle,         false },
+        { big,            false },
+        { inverse,        false },
+        { star,           true  },
+        { cubic,          true  },
+        { evenOdd,        true  },
+        { inverseEvenOdd, true  },
+    };
+
+    for (const auto& test : tests) {
+        for (const SkRegion* rgn : clips) {
+            SkBitmap analytic = draw(test.path, true,  rgn),
+                     super    = draw(test.path, false, rgn);
+            if (!test.crossesItself) {
+                REPORTER_ASSERT(r, max_diff(analytic, super) <= 48);
+            }
+            int a = total_alpha(analytic),
+                s = total_alpha(super);
+            REPORTER_ASSERT(r, SkAbs32(a - s) <= SkTMax(a, s) / 100);
+
+            // Nothing lands outside the clip.
+            for (int y = 0; rgn && y < kSize; y++) {
+                for (int x = 0; x < kSize; x++) {
+                    if (!rgn->contains(x, y)) {
+                        REPORTER_ASSERT(r, *analytic.getAddr8(x, y) == 0);
+                    }
+                }
+            }
+        }
+    }
+}
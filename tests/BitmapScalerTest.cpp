@@ -0,0 +1,109 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmapScaler.h"
+#include "SkColorPriv.h"
+#include "SkConvolver.h"
+#include "SkRandom.h"
+#include "SkUnPreMultiply.h"
+#include "Test.h"
+
+// Builds a filter mapping srcSize pixels to dstSize with taps of varying lengths, some
+// negative, normalized to exactly one like SkBitmapScaler's.
+static void make_filter(SkConvolutionFilter1D* filter, int srcSize, int dstSize,
+                        const SkConvolutionProcs& procs, SkRandom* rand) {
+    for (int x = 0; x < dstSize; x++) {
+        const int length = 2 + x % 6;
+        const int offset = SkTPin(x * srcSize / dstSize - length / 2, 0, srcSize - length);
+        SkConvolutionFilter1D::ConvolutionFixed values[8];
+        int sum = 0;
+        for (int i = 0; i < length; i++) {
+            values[i] = SkConvolutionFilter1D::FloatToFixed(rand->nextRangeF(-0.1f, 0.5f));
+            sum += values[i];
+        }
+        values[length / 2] += SkConvolutionFilter1D::FloatToFixed(1) - sum;
+        filter->AddFilter(offset, values, length);
+    }
+    if (procs.fApplySIMDPadding) {
+        procs.fApplySIMDPadding(filter);
+    }
+}
+
+DEF_TEST(BitmapScaler_SIMDAndBandsMatchPortable, r) {
+    SkConvolutionProcs portable = { 0, nullptr, nullptr, nullptr, nullptr },
+                       platform = { 0, nullptr, nullptr, nullptr, nullptr };
+    SkBitmapScaler::PlatformConvolutionProcs(&platform);
+
+    SkRandom rand;
+    // Odd sizes, so the SIMD code has tails to deal with.
+    const int srcW = 67, srcH = 53, dstW = 29, dstH = 25;
+    for (bool hasAlpha : { true, false }) {
+        SkAutoTMalloc<uint32_t> src(srcW * srcH);
+        for (int i = 0; i < srcW * srcH; i++) {
+            src[i] = SkPreMultiplyColor(rand.nextU() | (hasAlpha ? 0 : 0xFF000000));
+        }
+
+        SkConvolutionFilter1D filterX, filterY;
+        make_filter(&filterX, srcW, dstW, platform, &rand);
+        make_filter(&filterY, srcH, dstH, platform, &rand);
+
+        const int dstRB = dstW * 4;
+        SkAutoTMalloc<uint32_t> expected(dstW * dstH),
+                                actual(dstW * dstH),
+                                banded(dstW * dstH);
+        REPORTER_ASSERT(r, BGRAConvolve2D((const unsigned char*)src.get(), srcW * 4, hasAlpha,
+                                          filterX, filterY, dstRB,
+                                          (unsigned char*)expected.get(), portable, false));
+        REPORTER_ASSERT(r, BGRAConvolve2D((const unsigned char*)src.get(), srcW * 4, hasAlpha,
+                                          filterX, filterY, dstRB,
+                                          (unsigned char*)actual.get(), platform, true));
+        const int bandEdges[] = { 0, 6, 7, 19, dstH };
+        for (int i = 0; i + 1 < (int)SK_ARRAY_COUNT(bandEdges); i++) {
+            REPORTER_ASSERT(r, BGRAConvolve2DRows((const unsigned char*)src.get(), srcW * 4,
+                                                  hasAlpha, filterX, filterY, dstRB,
+                                                  (unsigned char*)banded.get(), platform, true,
+                                                  bandEdges[i], bandEdges[i + 1]));
+        }
+        REPORTER_ASSERT(r, 0 == memcmp(expected.get(), actual.get(), dstW * dstH * 4));
+        REPORTER_ASSERT(r, 0 == memcmp(expected.get(), banded.get(), dstW * dstH * 4));
+    }
+}
+
+DEF_TEST(BitmapScaler_ReusedFilters, r) {
+    // Resizing different images between the same sizes reuses the same filters, which must not
+    // remember anything about the first image.  The last size is big enough to go in bands.
+    const SkISize sizes[][2] = {
+        { { 100,  80 }, {  35,  20 } },
+        { { 100,  80 }, { 201, 161 } },
+        { { 1200, 1000 }, { 700, 600 } },
+    };
+    for (const auto& size : sizes) {
+        for (int m = SkBitmapScaler::RESIZE_FirstMethod; m <= SkBitmapScaler::RESIZE_LastMethod;
+             m++) {
+            for (SkPMColor color : { SkPackARGB32(0xFF, 0xFF, 0, 0), SkPackARGB32(0xFF, 0, 0, 0xFF),
+                                     SkPackARGB32(0x80, 0x40, 0x80, 0) }) {
+                SkBitmap src;
+                src.allocN32Pixels(size[0].width(), size[0].height());
+                src.eraseColor(SkUnPreMultiply::PMColorToColor(color));
+                SkPixmap srcPM;
+                REPORTER_ASSERT(r, src.peekPixels(&srcPM));
+
+                SkBitmap dst;
+                REPORTER_ASSERT(r, SkBitmapScaler::Resize(&dst, srcPM,
+                                                          (SkBitmapScaler::ResizeMethod)m,
+                                                          size[1].width(), size[1].height()));
+                int wrong = 0;
+                for (int y = 0; y < dst.height(); y++) {
+                    for (int x = 0; x < dst.width(); x++) {
+                        wrong += *dst.getAddr32(x, y) != color;
+                    }
+                }
+                REPORTER_ASSERT(r, 0 == wrong);
+            }
+        }
+    }
+}
@@ -9,6 +9,8 @@
 #include "SkCanvas.h"
 #include "SkColorPriv.h"
 #include "SkGradientShader.h"
+#include "SkOpts.h"
+#include "SkRandom.h"
 #include "SkRect.h"
 #include "Test.h"
 
@@ -260,3 +262,34 @@ DEF_TEST(BlitRow, reporter) {
     test_00_FF(reporter);
     test_diagonal(reporter);
 }
+
+DEF_TEST(BlitRow_S32A_Opaque, r) {
+    // SIMD code blends 16 pixels at a time, with fast paths when all 16 are opaque or all are
+    // transparent.  Mix all three kinds of source pixels, and check every length and offset.
+    static const int N = 67;
+    SkPMColor src[N], dst[N], expected[N];
+    SkRandom rand;
+    for (int i = 0; i < N; i++) {
+        switch (rand.nextULessThan(3)) {
+            case 0:  src[i] = 0; break;
+            case 1:  src[i] = rand.nextU() | 0xFF000000; break;
+            default: src[i] = SkPreMultiplyColor(rand.nextU()); break;
+        }
+    }
+    // Runs of all-opaque and all-transparent pixels, to hit those fast paths.
+    for (int i = 0; i < 16; i++) {
+        src[i]      = 0;
+        src[i + 16] = SkPackARGB32(0xFF, i, 2*i, 3*i);
+    }
+
+    for (int count = 0; count <= N; count++) {
+        for (int i = 0; i < N; i++) {
+            dst[i] = expected[i] = SkPreMultiplyColor(rand.nextU());
+            if (i < count && (src[i] >> SK_A32_SHIFT)) {
+                expected[i] = SkPMSrcOver(src[i], expected[i]);
+            }
+        }
+        SkOpts::blit_row_s32a_opaque(dst, src, count, 0xFF);
+        REPORTER_ASSERT(r, 0 == memcmp(dst, expected, sizeof(dst)));
+    }
+}
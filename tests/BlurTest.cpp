@@ -9,8 +9,10 @@
 #include "SkBlurMaskFilter.h"
 #include "SkBlurDrawLooper.h"
 #include "SkCanvas.h"
+#include "SkEdgeCache.h"
 #include "SkEmbossMaskFilter.h"
 #include "SkLayerDrawLooper.h"
+#include "SkMaskCache.h"
 #include "SkMath.h"
 #include "SkPaint.h"
 #include "SkPath.h"
@@ -375,6 +377,169 @@ DEF_TEST(BlurSigmaRange, reporter) {
     }
 }
 
+// For very large sigmas, BoxBlur() blurs a downsampled copy of the mask unless forced to
+// keep quality.  The two should look alike.
+DEF_TEST(BlurMask_Downsampled, reporter) {
+    static const int kWidth = 251, kHeight = 197;
+    SkMask src;
+    src.fBounds.set(0, 0, kWidth, kHeight);
+    src.fFormat = SkMask::kA8_Format;
+    src.fRowBytes = src.fBounds.width();
+    src.fImage = SkMask::AllocImage(src.computeImageSize());
+    SkAutoMaskFreeImage autoSrc(src.fImage);
+    for (int y = 0; y < kHeight; ++y) {
+        for (int x = 0; x < kWidth; ++x) {
+            src.fImage[y * kWidth + x] = (x > 100 && y > 50) || x % 7 == 0 ? 0xFF : 0x00;
+        }
+    }
+
+    for (SkScalar sigma : { 150.0f, 300.0f }) {
+        SkMask downsampled, direct;
+        SkIPoint downsampledMargin, directMargin;
+        REPORTER_ASSERT(reporter, SkBlurMask::BoxBlur(&downsampled, src, sigma,
+                                                      kNormal_SkBlurStyle, kHigh_SkBlurQuality,
+                                                      &downsampledMargin, false));
+        REPORTER_ASSERT(reporter, SkBlurMask::BoxBlur(&direct, src, sigma,
+                                                      kNormal_SkBlurStyle, kHigh_SkBlurQuality,
+                                                      &directMargin, true));
+        SkAutoMaskFreeImage autoDownsampled(downsampled.fImage),
+                            autoDirect(direct.fImage);
+        REPORTER_ASSERT(reporter, downsampledMargin == directMargin);
+        REPORTER_ASSERT(reporter, downsampled.fBounds == direct.fBounds);
+
+        int maxDiff = 0;
+        for (int y = 0; y < direct.fBounds.height(); ++y) {
+            for (int x = 0; x < direct.fBounds.width(); ++x) {
+                int d = downsampled.fImage[y * downsampled.fRowBytes + x] -
+                        direct.fImage[y * direct.fRowBytes + x];
+                maxDiff = SkTMax(maxDiff, SkAbs32(d));
+            }
+        }
+        REPORTER_ASSERT(reporter, maxDiff <= 2);
+    }
+}
+
+static SkBitmap draw_blurred_rect(const SkRect& rect) {
+    SkBitmap bm;
+    bm.allocPixels(SkImageInfo::MakeA8(256, 256));
+    bm.eraseColor(SK_ColorTRANSPARENT);
+
+    SkCanvas canvas(bm);
+    SkPaint paint;
+    paint.setMaskFilter(SkBlurMaskFilter::Make(kNormal_SkBlurStyle, 4));
+    canvas.drawRect(rect, paint);
+    return bm;
+}
+
+// Blurred rects share cached nine-patch masks across sizes and positions, as long as their
+// edges fall at the same place within a pixel.  Each corner should come out the same.
+DEF_TEST(BlurRectNinePatch_Shared, reporter) {
+    const SkRect rect = SkRect::MakeLTRB(20.25f, 30.5f, 100, 90.75f);
+    const int dx = 61, dy = 37,   // Move by whole pixels...
+              dw = 23, dh = 9;    // ...and grow by whole pixels.
+    const SkRect moved = SkRect::MakeLTRB(rect.left() + dx, rect.top() + dy,
+                                          rect.right() + dx + dw, rect.bottom() + dy + dh);
+
+    SkBitmap a = draw_blurred_rect(rect),
+             b = draw_blurred_rect(moved);
+    const int cx = SkScalarRoundToInt(rect.centerX()),
+              cy = SkScalarRoundToInt(rect.centerY());
+    bool same = true;
+    for (int y = 0; y < 140; ++y) {
+        for (int x = 0; x < 140; ++x) {
+            int bx = x + dx + (x < cx ? 0 : dw),
+                by = y + dy + (y < cy ? 0 : dh);
+            same &= *a.getAddr8(x, y) == *b.getAddr8(bx, by);
+        }
+    }
+    REPORTER_ASSERT(reporter, same);
+}
+
+// Draws path with three blurred shadows under it, two of them sharing a sigma.
+static SkBitmap draw_shadowed_path(const SkPath& path) {
+    SkLayerDrawLooper::Builder builder;
+    const struct {
+        SkScalar fDX, fDY, fSigma;
+        SkColor  fColor;
+    } shadows[] = {
+        { 3, 3, 2, 0x80000000 },
+        { 9, 2, 2, 0x80FF0000 },
+        { -2, 7, 5, 0x800000FF },
+    };
+    for (const auto& shadow : shadows) {
+        SkLayerDrawLooper::LayerInfo info;
+        info.fPaintBits = SkLayerDrawLooper::kMaskFilter_Bit;
+        info.fColorMode = SkXfermode::kSrc_Mode;
+        info.fOffset.set(shadow.fDX, shadow.fDY);
+        SkPaint* paint = builder.addLayer(info);
+        paint->setColor(shadow.fColor);
+        paint->setMaskFilter(SkBlurMaskFilter::Make(kNormal_SkBlurStyle, shadow.fSigma));
+    }
+    builder.addLayerOnTop(SkLayerDrawLooper::LayerInfo());
+
+    SkBitmap bm;
+    bm.allocN32Pixels(120, 120);
+    SkCanvas canvas(bm);
+    canvas.clear(SK_ColorWHITE);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(SK_ColorGREEN);
+    paint.setLooper(builder.detach());
+    canvas.translate(10.25f, 20.5f);
+    canvas.drawPath(path, paint);
+    return bm;
+}
+
+// The shadows of a persistent path share a coverage mask, and those with the same sigma share a
+// blurred mask, cached from draw to draw.  They should draw just what a volatile path, which is
+// never cached, does.  (The path's points are chosen so moving them by whole pixels is exact.)
+DEF_TEST(BlurPath_CachedShadows, reporter) {
+    SkPath path;
+    path.moveTo(20, 0.5f);
+    path.lineTo(40.25f, 60);
+    path.quadTo(20, 40, 0.75f, 60);
+    path.close();
+    path.addCircle(60, 30, 20);
+    path.addCircle(60, 30, 10);   // Filled with winding, a hole with even-odd.
+
+    // Copies of a path share its generation ID, whatever their fill types, so each fill type must
+    // be kept apart in the cache.
+    for (SkPath::FillType fillType : { SkPath::kWinding_FillType, SkPath::kEvenOdd_FillType }) {
+        path.setFillType(fillType);
+        SkPath volatilePath(path);
+        volatilePath.setIsVolatile(true);
+        SkBitmap expected = draw_shadowed_path(volatilePath);
+
+        for (int i = 0; i < 2; i++) {
+            SkBitmap actual = draw_shadowed_path(path);
+            SkAutoLockPixels lockE(expected), lockA(actual);
+            REPORTER_ASSERT(reporter, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                                  expected.getSize()));
+        }
+    }
+}
+
+DEF_TEST(BlurPath_CachedSimpleShadow, reporter) {
+    // Too simple a path for SkEdgeCache to bother with, but its shadows are still worth caching.
+    SkPath path;
+    path.moveTo(20, 0.5f);
+    path.lineTo(40.25f, 60);
+    path.lineTo(0.75f, 60);
+    path.close();
+    REPORTER_ASSERT(reporter, !SkEdgeCache::ShouldCache(path));
+    draw_shadowed_path(path);
+
+    // draw_shadowed_path() translates by (10.25, 20.5), and only the fraction is in the key.
+    SkScanPathID id = { path.getGenerationID(), SkMatrix::MakeTrans(0.25f, 0.5f),
+                        path.getFillType() };
+    SkMask coverage;
+    SkAutoTUnref<SkCachedData> data(SkMaskCache::FindAndRef(0, kNormal_SkBlurStyle,
+                                                            kLow_SkBlurQuality, id,
+                                                            SkStrokeRec::kFill_InitStyle,
+                                                            &coverage));
+    REPORTER_ASSERT(reporter, data);
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 
 static SkBlurQuality blurMaskFilterFlags_as_quality(uint32_t blurMaskFilterFlags) {
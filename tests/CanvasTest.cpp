@@ -888,3 +888,90 @@ DEF_TEST(DeferredCanvas, r) {
     canvas.restore();
 }
 
+
+DEF_TEST(DeferredCanvas_threaded, r) {
+    sk_sp<SkSurface> surface = SkSurface::MakeRasterN32Premul(10, 10);
+    surface->getCanvas()->clear(SK_ColorTRANSPARENT);
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(10, 10);
+
+    const SkColor colors[] = { SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE, SK_ColorWHITE };
+    {
+        SkDeferredCanvas canvas(surface->getCanvas(), 2);
+
+        // Frames are played back in order, carrying the matrix from one to the next.
+        canvas.translate(5, 0);
+        for (SkColor color : colors) {
+            SkPaint paint;
+            paint.setColor(color);
+            canvas.drawRect(SkRect::MakeWH(5, 10), paint);
+            canvas.flush();
+        }
+        canvas.waitForPlayback();
+        REPORTER_ASSERT(r, surface->getCanvas()->readPixels(&bitmap, 0, 0));
+        REPORTER_ASSERT(r, SK_ColorTRANSPARENT == bitmap.getColor(2, 5));
+        REPORTER_ASSERT(r, SK_ColorWHITE == bitmap.getColor(7, 5));
+
+        // Draws after the last flush() are never played back.
+        SkPaint paint;
+        paint.setColor(SK_ColorBLACK);
+        canvas.drawPaint(paint);
+    }
+    REPORTER_ASSERT(r, surface->getCanvas()->readPixels(&bitmap, 0, 0));
+    REPORTER_ASSERT(r, SK_ColorWHITE == bitmap.getColor(7, 5));
+}
+
+static void draw_nway_content(SkCanvas* canvas) {
+    SkPictureRecorder recorder;
+    SkPaint paint;
+    paint.setColor(SK_ColorGREEN);
+    recorder.beginRecording(20, 20)->drawOval(SkRect::MakeWH(20, 20), paint);
+    sk_sp<SkPicture> picture(recorder.finishRecordingAsPicture());
+
+    canvas->clear(SK_ColorWHITE);
+    canvas->save();
+    canvas->translate(4, 4);
+    canvas->clipRect(SkRect::MakeWH(40, 40));
+    // More draws than the parallel mode records before it plays them back on its own.
+    for (int i = 0; i < 5000; i++) {
+        paint.setColor(0xFF000000 | i * 0x10203);
+        canvas->drawRect(SkRect::MakeXYWH(i % 50, i / 100, 3, 3), paint);
+    }
+    canvas->setMatrix(SkMatrix::MakeScale(2));
+    canvas->drawPicture(picture);
+    canvas->restore();
+    canvas->drawPicture(picture, nullptr, &paint);
+}
+
+DEF_TEST(NWayCanvas_Parallel, r) {
+    SkBitmap expected;
+    expected.allocN32Pixels(50, 50);
+    SkCanvas canvas(expected);
+    draw_nway_content(&canvas);
+
+    SkBitmap bitmaps[3];
+    SkAutoTUnref<SkCanvas> canvases[3];
+    SkNWayCanvas nway(50, 50);
+    for (int i = 0; i < 3; i++) {
+        bitmaps[i].allocN32Pixels(50, 50);
+        bitmaps[i].eraseColor(SK_ColorTRANSPARENT);
+        canvases[i].reset(new SkCanvas(bitmaps[i]));
+        nway.addCanvas(canvases[i]);
+    }
+    nway.setParallel(true);
+    REPORTER_ASSERT(r, nway.isParallel());
+    draw_nway_content(&nway);
+    nway.flush();
+
+    for (const SkBitmap& bitmap : bitmaps) {
+        SkAutoLockPixels lockExpected(expected), lock(bitmap);
+        REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), bitmap.getPixels(),
+                                       expected.getSize()));
+    }
+
+    // Nothing is drawn until the recording is played back.
+    nway.drawColor(SK_ColorBLACK);
+    REPORTER_ASSERT(r, SK_ColorWHITE == bitmaps[0].getColor(0, 0));
+    nway.setParallel(false);
+    REPORTER_ASSERT(r, SK_ColorBLACK == bitmaps[0].getColor(0, 0));
+}
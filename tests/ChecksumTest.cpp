@@ -6,19 +6,21 @@
  */
 
 #include "SkChecksum.h"
+#include "SkOpts.h"
 #include "SkRandom.h"
 #include "Test.h"
 
 
 // Murmur3 has an optional third seed argument, so we wrap it to fit a uniform type.
 static uint32_t murmur_noseed(const uint32_t* d, size_t l) { return SkChecksum::Murmur3(d, l); }
+static uint32_t opts_noseed(const uint32_t* d, size_t l) { return SkOpts::hash(d, l); }
 
 #define ASSERT(x) REPORTER_ASSERT(r, x)
 
 DEF_TEST(Checksum, r) {
     // Algorithms to test.  They're currently all uint32_t(const uint32_t*, size_t).
     typedef uint32_t(*algorithmProc)(const uint32_t*, size_t);
-    const algorithmProc kAlgorithms[] = { &murmur_noseed };
+    const algorithmProc kAlgorithms[] = { &murmur_noseed, &opts_noseed };
 
     // Put 128 random bytes into two identical buffers.  Any multiple of 4 will do.
     const size_t kBytes = SkAlign4(128);
@@ -63,3 +65,25 @@ DEF_TEST(GoodHash, r) {
     // Tests SkString is correctly specialized.
     ASSERT(SkGoodHash()(SkString("Hi")) == 55667557);
 }
+
+DEF_TEST(Checksum_OptsHashTails, r) {
+    // SkOpts::hash works in chunks; every length and alignment of the tail must be hashed.
+    uint8_t data[67];
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)(i * 37 + 11);
+    }
+    for (size_t offset = 0; offset < 8; offset++) {
+        for (size_t len = 1; offset + len <= sizeof(data); len++) {
+            const uint32_t hash = SkOpts::hash(data + offset, len);
+            ASSERT(hash == SkOpts::hash(data + offset, len));
+
+            // Flipping the last byte, wherever the tail ends, should change the hash.
+            data[offset + len - 1] ^= 0x80;
+            ASSERT(hash != SkOpts::hash(data + offset, len));
+            data[offset + len - 1] ^= 0x80;
+
+            // So should the seed.
+            ASSERT(hash != SkOpts::hash(data + offset, len, 1));
+        }
+    }
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+#if SK_SUPPORT_GPU
+#include "GrContext.h"
+#include "SkCanvas.h"
+#include "SkPath.h"
+#include "SkSurface.h"
+
+static SkBitmap draw_clipped(SkSurface* surface, const SkPath& clip) {
+    SkCanvas* canvas = surface->getCanvas();
+    canvas->clear(SK_ColorWHITE);
+    canvas->save();
+    canvas->clipPath(clip, SkRegion::kIntersect_Op, true);
+    canvas->drawColor(SK_ColorBLACK);
+    canvas->restore();
+
+    SkBitmap bm;
+    bm.allocN32Pixels(surface->width(), surface->height());
+    surface->readPixels(bm.info(), bm.getPixels(), bm.rowBytes(), 0, 0);
+    return bm;
+}
+
+// Clip masks are cached by the path's generation ID, which copies of a path share whatever their
+// fill types.  Each fill type must still get its own mask.
+DEF_GPUTEST_FOR_RENDERING_CONTEXTS(ClipMaskCache_FillType, reporter, ctxInfo) {
+    SkImageInfo info = SkImageInfo::MakeN32Premul(64, 64);
+    sk_sp<SkSurface> gpu(SkSurface::MakeRenderTarget(ctxInfo.grContext(), SkBudgeted::kNo, info));
+    sk_sp<SkSurface> raster(SkSurface::MakeRaster(info));
+    if (!gpu) {
+        return;
+    }
+
+    // Two overlapping circles, so the middle is in with winding and out with even-odd.
+    SkPath winding;
+    winding.addCircle(24, 32, 16);
+    winding.addCircle(40, 32, 16);
+    SkPath evenOdd(winding), inverse(winding);
+    evenOdd.setFillType(SkPath::kEvenOdd_FillType);
+    inverse.setFillType(SkPath::kInverseWinding_FillType);
+    REPORTER_ASSERT(reporter, evenOdd.getGenerationID() == winding.getGenerationID());
+
+    for (const SkPath* path : { &winding, &evenOdd, &inverse, &winding }) {
+        SkBitmap actual   = draw_clipped(gpu.get(), *path),
+                 expected = draw_clipped(raster.get(), *path);
+        // Compare well inside and well outside the circles, away from anti-aliased edges.
+        for (SkIPoint p : { SkIPoint::Make(32, 32), SkIPoint::Make(16, 32),
+                            SkIPoint::Make(2, 2) }) {
+            REPORTER_ASSERT(reporter,
+                            *actual.getAddr32(p.fX, p.fY) == *expected.getAddr32(p.fX, p.fY));
+        }
+    }
+}
+
+#endif
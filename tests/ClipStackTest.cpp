@@ -1158,6 +1158,62 @@ static void test_reduced_clip_stack_no_aa_crash(skiatest::Reporter* reporter) {
     REPORTER_ASSERT(reporter, 0 == reducedClips.count());
 }
 
+static SkRegion stack_to_region(const SkClipStack& stack, const SkIRect& bounds) {
+    SkRegion region(bounds);
+    SkClipStack::Iter iter(stack, SkClipStack::Iter::kBottom_IterStart);
+    while (const SkClipStack::Element* element = iter.next()) {
+        add_elem_to_region(*element, bounds, &region);
+    }
+    return region;
+}
+
+// Small draws through one stack share reductions made for larger bounds. What they get back
+// must still clip exactly like the stack does inside each draw's bounds.
+static void test_reduced_clip_cache(skiatest::Reporter* reporter) {
+    SkClipStack stack;
+    add_round_rect(SkRect::MakeLTRB(10, 10, 290, 190), false, SkRegion::kIntersect_Op, &stack);
+    add_oval(SkRect::MakeLTRB(40, 30, 120, 90), false, SkRegion::kDifference_Op, &stack);
+    add_rect(SkRect::MakeLTRB(200, 100, 250, 170), true, SkRegion::kIntersect_Op, &stack);
+
+    GrReducedClipCache cache;
+    SkRandom r;
+    for (int i = 0; i < 200; ++i) {
+        SkIRect queryBounds = SkIRect::MakeXYWH(r.nextULessThan(300), r.nextULessThan(200),
+                                                1 + r.nextULessThan(40), 1 + r.nextULessThan(40));
+        const GrReducedClip::ElementList* reducedClips;
+        int32_t reducedGenID;
+        GrReducedClip::InitialState initial;
+        SkIRect tighterBounds;
+        bool requiresAA;
+        bool drawn = cache.reduceClipStack(stack, queryBounds, &reducedClips, &reducedGenID,
+                                           &initial, &tighterBounds, &requiresAA);
+
+        SkRegion region = stack_to_region(stack, queryBounds);
+        if (!drawn) {
+            REPORTER_ASSERT(reporter, region.isEmpty());
+            continue;
+        }
+        REPORTER_ASSERT(reporter, queryBounds.contains(tighterBounds));
+
+        SkClipStack reducedStack;
+        if (GrReducedClip::kAllOut_InitialState == initial) {
+            reducedStack.clipEmpty();
+        }
+        for (auto iter = reducedClips->headIter(); iter.get(); iter.next()) {
+            add_elem_to_stack(*iter.get(), &reducedStack);
+        }
+        reducedStack.clipDevRect(tighterBounds, SkRegion::kIntersect_Op);
+        region.op(tighterBounds, SkRegion::kIntersect_Op);
+        REPORTER_ASSERT(reporter, region == stack_to_region(reducedStack, queryBounds));
+
+        // The same query again must be answered from the cache.
+        const GrReducedClip::ElementList* cachedClips;
+        cache.reduceClipStack(stack, queryBounds, &cachedClips, &reducedGenID, &initial,
+                              &tighterBounds, &requiresAA);
+        REPORTER_ASSERT(reporter, cachedClips == reducedClips);
+    }
+}
+
 #endif
 
 DEF_TEST(ClipStack, reporter) {
@@ -1208,5 +1264,6 @@ DEF_TEST(ClipStack, reporter) {
     test_reduced_clip_stack(reporter);
     test_reduced_clip_stack_genid(reporter);
     test_reduced_clip_stack_no_aa_crash(reporter);
+    test_reduced_clip_cache(reporter);
 #endif
 }
@@ -7,15 +7,19 @@
 
 #include "Resources.h"
 #include "SkAndroidCodec.h"
+#include "SkAutoPixmapStorage.h"
 #include "SkBitmap.h"
 #include "SkCodec.h"
 #include "SkCodecImageGenerator.h"
+#include "SkColorSpace.h"
+#include "SkColorSpaceXform.h"
 #include "SkData.h"
 #include "SkFrontBufferedStream.h"
 #include "SkMD5.h"
 #include "SkRandom.h"
 #include "SkStream.h"
 #include "SkStreamPriv.h"
+#include "SkTextureCompressor.h"
 #include "SkPngChunkReader.h"
 #include "Test.h"
 
@@ -316,9 +320,9 @@ static void check(skiatest::Reporter* r,
 
         if (supportsSubsetDecoding) {
             REPORTER_ASSERT(r, result == expectedResult);
-            // Webp is the only codec that supports subsets, and it will have modified the subset
-            // to have even left/top.
-            REPORTER_ASSERT(r, SkIsAlign2(subset.fLeft) && SkIsAlign2(subset.fTop));
+            // Webp will have modified the subset to have even left/top.
+            REPORTER_ASSERT(r, kWEBP_SkEncodedFormat != codec->getEncodedFormat() ||
+                               (SkIsAlign2(subset.fLeft) && SkIsAlign2(subset.fTop)));
         } else {
             // No subsets will work.
             REPORTER_ASSERT(r, result == SkCodec::kUnimplemented);
@@ -415,25 +419,26 @@ DEF_TEST(Codec, r) {
     // grayscale.jpg is too small to test incomplete
     check(r, "grayscale.jpg", SkISize::Make(128, 128), true, false, false);
     check(r, "mandrill_512_q075.jpg", SkISize::Make(512, 512), true, false);
+    check(r, "mandrill_512_restart.jpg", SkISize::Make(512, 512), true, false);
     // randPixels.jpg is too small to test incomplete
     check(r, "randPixels.jpg", SkISize::Make(8, 8), true, false, false);
 
     // PNG
-    check(r, "arrow.png", SkISize::Make(187, 312), true, false, false);
-    check(r, "baby_tux.png", SkISize::Make(240, 246), true, false, false);
-    check(r, "color_wheel.png", SkISize::Make(128, 128), true, false, false);
-    check(r, "half-transparent-white-pixel.png", SkISize::Make(1, 1), true, false, false);
-    check(r, "mandrill_128.png", SkISize::Make(128, 128), true, false, false);
-    check(r, "mandrill_16.png", SkISize::Make(16, 16), true, false, false);
-    check(r, "mandrill_256.png", SkISize::Make(256, 256), true, false, false);
-    check(r, "mandrill_32.png", SkISize::Make(32, 32), true, false, false);
-    check(r, "mandrill_512.png", SkISize::Make(512, 512), true, false, false);
-    check(r, "mandrill_64.png", SkISize::Make(64, 64), true, false, false);
-    check(r, "plane.png", SkISize::Make(250, 126), true, false, false);
+    check(r, "arrow.png", SkISize::Make(187, 312), true, true, false);
+    check(r, "baby_tux.png", SkISize::Make(240, 246), true, true, false);
+    check(r, "color_wheel.png", SkISize::Make(128, 128), true, true, false);
+    check(r, "half-transparent-white-pixel.png", SkISize::Make(1, 1), true, true, false);
+    check(r, "mandrill_128.png", SkISize::Make(128, 128), true, true, false);
+    check(r, "mandrill_16.png", SkISize::Make(16, 16), true, true, false);
+    check(r, "mandrill_256.png", SkISize::Make(256, 256), true, true, false);
+    check(r, "mandrill_32.png", SkISize::Make(32, 32), true, true, false);
+    check(r, "mandrill_512.png", SkISize::Make(512, 512), true, true, false);
+    check(r, "mandrill_64.png", SkISize::Make(64, 64), true, true, false);
+    check(r, "plane.png", SkISize::Make(250, 126), true, true, false);
     // FIXME: We are not ready to test incomplete interlaced pngs
     check(r, "plane_interlaced.png", SkISize::Make(250, 126), true, false, false);
-    check(r, "randPixels.png", SkISize::Make(8, 8), true, false, false);
-    check(r, "yellow_rose.png", SkISize::Make(400, 301), true, false, false);
+    check(r, "randPixels.png", SkISize::Make(8, 8), true, true, false);
+    check(r, "yellow_rose.png", SkISize::Make(400, 301), true, true, false);
 
     // RAW
 // Disable RAW tests for Win32.
@@ -1012,3 +1017,601 @@ DEF_TEST(Codec_wbmp_max_size, r) {
 
     REPORTER_ASSERT(r, !codec);
 }
+
+// SkJpegCodec decodes jpegs with restart markers in parallel bands when their data is in
+// memory.  That should match a serial decode of the same data from a stream.
+DEF_TEST(Codec_jpeg_restart_bands, r) {
+    const char* path = "mandrill_512_restart.jpg";
+    SkString fullPath(GetResourcePath(path));
+    auto data = SkData::MakeFromFileName(fullPath.c_str());
+    if (!data) {
+        SkDebugf("Missing resource '%s'\n", path);
+        return;
+    }
+
+    for (SkColorType colorType : { kRGBA_8888_SkColorType, kBGRA_8888_SkColorType,
+                                   kGray_8_SkColorType }) {
+        SkAutoTDelete<SkCodec> serial(SkCodec::NewFromStream(new NotAssetMemStream(data.get())));
+        REPORTER_ASSERT(r, serial);
+        if (!serial) {
+            return;
+        }
+        const SkImageInfo info = serial->getInfo().makeColorType(colorType);
+        SkBitmap bm;
+        bm.allocPixels(info);
+        REPORTER_ASSERT(r, SkCodec::kSuccess == serial->getPixels(info, bm.getPixels(),
+                                                                  bm.rowBytes()));
+        SkMD5::Digest digest;
+        md5(bm, &digest);
+
+        SkAutoTDelete<SkCodec> parallel(SkCodec::NewFromData(data.get()));
+        test_info(r, parallel.get(), info, SkCodec::kSuccess, &digest);
+    }
+
+    // When the data is cut short, the bands cannot all be decoded, and we should fall back
+    // to a serial decode of as much as is there.
+    sk_sp<SkData> truncated = SkData::MakeSubset(data.get(), 0, data->size() / 2);
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(truncated.get()));
+    REPORTER_ASSERT(r, codec);
+    if (codec) {
+        test_info(r, codec.get(), codec->getInfo(), SkCodec::kIncompleteInput, nullptr);
+    }
+
+    // Likewise when a restart marker is out of order.
+    sk_sp<SkData> shuffled = SkData::MakeWithCopy(data->data(), data->size());
+    uint8_t* bytes = (uint8_t*) shuffled->writable_data();
+    for (size_t i = 1; i < shuffled->size(); i++) {
+        if (0xFF == bytes[i - 1] && 0xD1 == bytes[i]) {  // RST1
+            bytes[i] = 0xD2;                                // RST2
+            break;
+        }
+    }
+    codec.reset(SkCodec::NewFromData(shuffled.get()));
+    REPORTER_ASSERT(r, codec);
+    if (codec) {
+        SkBitmap bm;
+        bm.allocPixels(codec->getInfo());
+        SkCodec::Result result = codec->getPixels(codec->getInfo(), bm.getPixels(),
+                                                  bm.rowBytes());
+        REPORTER_ASSERT(r, SkCodec::kSuccess == result || SkCodec::kIncompleteInput == result);
+    }
+}
+
+// A progressive jpeg cut off part way through should still decode every row, as refined by
+// the scans that arrived, and the more data there is the closer it should come to the full image.
+DEF_TEST(Codec_jpeg_progressive_incomplete, r) {
+    const char* path = "brickwork-texture.jpg";
+    SkString fullPath(GetResourcePath(path));
+    auto data = SkData::MakeFromFileName(fullPath.c_str());
+    if (!data) {
+        SkDebugf("Missing resource '%s'\n", path);
+        return;
+    }
+
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(data.get()));
+    REPORTER_ASSERT(r, codec);
+    if (!codec) {
+        return;
+    }
+    const SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType);
+    SkBitmap full;
+    full.allocPixels(info);
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(info, full.getPixels(),
+                                                             full.rowBytes()));
+
+    double prevDiff = 256;
+    for (int percent : { 25, 50, 75 }) {
+        sk_sp<SkData> truncated = SkData::MakeSubset(data.get(), 0, data->size() * percent / 100);
+        codec.reset(SkCodec::NewFromData(truncated.get()));
+        REPORTER_ASSERT(r, codec);
+        if (!codec) {
+            return;
+        }
+        SkBitmap bm;
+        bm.allocPixels(info);
+        REPORTER_ASSERT(r, SkCodec::kIncompleteInput == codec->getPixels(info, bm.getPixels(),
+                                                                         bm.rowBytes()));
+
+        // Mean difference from the full decode, per channel.
+        double diff = 0;
+        for (int y = 0; y < info.height(); y++) {
+            for (int x = 0; x < info.width(); x++) {
+                SkColor c0 = full.getColor(x, y),
+                        c1 = bm.getColor(x, y);
+                diff += SkTAbs((int)SkColorGetR(c0) - (int)SkColorGetR(c1)) +
+                        SkTAbs((int)SkColorGetG(c0) - (int)SkColorGetG(c1)) +
+                        SkTAbs((int)SkColorGetB(c0) - (int)SkColorGetB(c1));
+            }
+        }
+        diff /= 3.0 * info.width() * info.height();
+        REPORTER_ASSERT(r, diff < 16);
+        REPORTER_ASSERT(r, diff < prevDiff);
+        prevDiff = diff;
+    }
+}
+
+DEF_TEST(Codec_png_pipelined, r) {
+    // Large PNGs in memory are inflated on one thread and unfiltered on another.
+    // That should decode exactly as libpng does from a stream.
+    for (const char* path : { "mandrill_512.png", "yellow_rose.png" }) {
+        SkString fullPath(GetResourcePath(path));
+        auto data = SkData::MakeFromFileName(fullPath.c_str());
+        if (!data) {
+            SkDebugf("Missing resource '%s'\n", path);
+            continue;
+        }
+
+        SkAutoTDelete<SkCodec> serial(SkCodec::NewFromStream(new NotAssetMemStream(data.get())));
+        REPORTER_ASSERT(r, serial);
+        if (!serial) {
+            continue;
+        }
+        const SkImageInfo info = serial->getInfo();
+        SkBitmap bm;
+        bm.allocPixels(info);
+        REPORTER_ASSERT(r, SkCodec::kSuccess == serial->getPixels(info, bm.getPixels(),
+                                                                  bm.rowBytes()));
+        SkMD5::Digest digest;
+        md5(bm, &digest);
+
+        SkAutoTDelete<SkCodec> pipelined(SkCodec::NewFromData(data.get()));
+        test_info(r, pipelined.get(), info, SkCodec::kSuccess, &digest);
+
+        // Cut short, we should still decode the rows that are there.
+        sk_sp<SkData> truncated = SkData::MakeSubset(data.get(), 0, data->size() / 2);
+        pipelined.reset(SkCodec::NewFromData(truncated.get()));
+        REPORTER_ASSERT(r, pipelined);
+        if (pipelined) {
+            test_info(r, pipelined.get(), info, SkCodec::kIncompleteInput, nullptr);
+        }
+    }
+}
+
+// Averages each sampleSize by sampleSize box of full, which must be 8888.
+static void box_filter(const SkBitmap& full, int sampleSize, SkBitmap* scaled) {
+    for (int y = 0; y < scaled->height(); y++) {
+        for (int x = 0; x < scaled->width(); x++) {
+            const int sampleX = full.width()  / scaled->width(),
+                      sampleY = full.height() / scaled->height();
+            uint32_t sums[4] = { 0, 0, 0, 0 };
+            for (int j = 0; j < sampleY; j++) {
+                for (int i = 0; i < sampleX; i++) {
+                    const uint8_t* p = (const uint8_t*) full.getAddr32(x*sampleX + i,
+                                                                       y*sampleY + j);
+                    for (int c = 0; c < 4; c++) {
+                        sums[c] += p[c];
+                    }
+                }
+            }
+            uint8_t* dst = (uint8_t*) scaled->getAddr32(x, y);
+            for (int c = 0; c < 4; c++) {
+                dst[c] = (sums[c] + sampleX*sampleY/2) / (sampleX*sampleY);
+            }
+        }
+    }
+}
+
+DEF_TEST(Codec_png_scaled, r) {
+    for (const char* path : { "mandrill_512.png", "yellow_rose.png", "plane_interlaced.png",
+                              "3x3.png" }) {
+        SkString fullPath(GetResourcePath(path));
+        auto data = SkData::MakeFromFileName(fullPath.c_str());
+        if (!data) {
+            SkDebugf("Missing resource '%s'\n", path);
+            continue;
+        }
+        SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(data.get()));
+        REPORTER_ASSERT(r, codec);
+        if (!codec) {
+            continue;
+        }
+        const SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType)
+                                                 .makeAlphaType(kPremul_SkAlphaType);
+        SkBitmap full;
+        full.allocPixels(info);
+        REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(info, full.getPixels(),
+                                                                 full.rowBytes()));
+
+        for (int sampleSize : { 2, 3, 8, 1000 }) {
+            const SkISize size = codec->getScaledDimensions(1.0f / sampleSize);
+            REPORTER_ASSERT(r, size.width()  == SkTMax(1, info.width()  / sampleSize));
+            REPORTER_ASSERT(r, size.height() == SkTMax(1, info.height() / sampleSize));
+            const SkImageInfo scaledInfo = info.makeWH(size.width(), size.height());
+
+            SkBitmap scaled, expected;
+            scaled.allocPixels(scaledInfo);
+            expected.allocPixels(scaledInfo);
+            REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(scaledInfo,
+                    scaled.getPixels(), scaled.rowBytes()));
+            box_filter(full, sampleSize, &expected);
+            REPORTER_ASSERT(r, 0 == memcmp(scaled.getPixels(), expected.getPixels(),
+                                           scaled.getSafeSize()));
+
+            // Color types we can't average are point sampled instead.
+            SkBitmap sampled;
+            sampled.allocPixels(scaledInfo.makeColorType(kRGB_565_SkColorType)
+                                          .makeAlphaType(kOpaque_SkAlphaType));
+            const SkCodec::Result result = codec->getPixels(sampled.info(),
+                    sampled.getPixels(), sampled.rowBytes());
+            REPORTER_ASSERT(r, SkCodec::kSuccess == result ||
+                               (SkCodec::kInvalidConversion == result &&
+                                kOpaque_SkAlphaType != info.alphaType()));
+        }
+
+        // Mismatched scales, and scanline decoding, are not supported.
+        const SkImageInfo squashed = info.makeWH(SkTMax(1, info.width() / 4), info.height());
+        REPORTER_ASSERT(r, SkCodec::kInvalidScale == codec->getPixels(squashed,
+                full.getPixels(), full.rowBytes()));
+        REPORTER_ASSERT(r, SkCodec::kInvalidScale ==
+                codec->startScanlineDecode(info.makeWH(info.width() / 2, info.height() / 2)));
+    }
+
+    // Cut short, a scaled decode is incomplete, and the rest of the image is filled.
+    const char* path = "mandrill_512.png";
+    auto data = SkData::MakeFromFileName(GetResourcePath(path).c_str());
+    if (!data) {
+        SkDebugf("Missing resource '%s'\n", path);
+        return;
+    }
+    sk_sp<SkData> truncated = SkData::MakeSubset(data.get(), 0, data->size() / 2);
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(truncated.get()));
+    REPORTER_ASSERT(r, codec);
+    if (codec) {
+        const SkImageInfo info = codec->getInfo().makeWH(128, 128);
+        test_info(r, codec.get(), info, SkCodec::kIncompleteInput, nullptr);
+    }
+}
+
+// PNG scales natively only for whole images, so SkAndroidCodec must sample a scaled subset.
+DEF_TEST(Codec_png_sampled_subset, r) {
+    auto data = SkData::MakeFromFileName(GetResourcePath("mandrill_512.png").c_str());
+    if (!data) {
+        SkDebugf("Missing resource 'mandrill_512.png'\n");
+        return;
+    }
+    SkAutoTDelete<SkAndroidCodec> codec(SkAndroidCodec::NewFromData(data.get()));
+    REPORTER_ASSERT(r, codec);
+    if (!codec) {
+        return;
+    }
+    const SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType)
+                                             .makeAlphaType(kPremul_SkAlphaType);
+    SkBitmap full;
+    full.allocPixels(info);
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getAndroidPixels(info, full.getPixels(),
+                                                                    full.rowBytes()));
+
+    SkIRect subset = SkIRect::MakeLTRB(100, 300, 200, 400);
+    for (int sampleSize : { 2, 3, 8 }) {
+        const SkISize size = codec->getSampledSubsetDimensions(sampleSize, subset);
+        SkBitmap bm;
+        bm.allocPixels(info.makeWH(size.width(), size.height()));
+        SkAndroidCodec::AndroidOptions opts;
+        opts.fSubset = &subset;
+        opts.fSampleSize = sampleSize;
+        REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getAndroidPixels(bm.info(),
+                bm.getPixels(), bm.rowBytes(), &opts));
+
+        // Each pixel is the center of its sample box.
+        for (int y = 0; y < size.height(); y++) {
+            for (int x = 0; x < size.width(); x++) {
+                REPORTER_ASSERT(r, *bm.getAddr32(x, y) == *full.getAddr32(
+                        subset.left() + sampleSize / 2 + x * sampleSize,
+                        subset.top()  + sampleSize / 2 + y * sampleSize));
+            }
+        }
+    }
+}
+
+DEF_TEST(Codec_png_subset, r) {
+    for (const char* path : { "mandrill_512.png", "yellow_rose.png", "arrow.png" }) {
+        auto data = SkData::MakeFromFileName(GetResourcePath(path).c_str());
+        if (!data) {
+            SkDebugf("Missing resource '%s'\n", path);
+            continue;
+        }
+        SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(data.get()));
+        REPORTER_ASSERT(r, codec);
+        if (!codec) {
+            continue;
+        }
+        const SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType)
+                                                 .makeAlphaType(kPremul_SkAlphaType);
+        SkBitmap full;
+        full.allocPixels(info);
+        REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(info, full.getPixels(),
+                                                                 full.rowBytes()));
+
+        // Bottom first, then back up past the checkpoints that leaves behind, and back down
+        // onto and between them.
+        const int w = info.width(),
+                  h = info.height();
+        const SkIRect subsets[] = {
+            SkIRect::MakeLTRB(w / 2, h - 10, w,     h),
+            SkIRect::MakeLTRB(0,     0,      w / 3, 7),
+            SkIRect::MakeLTRB(1,     h / 2,  w - 1, h / 2 + 1),
+            SkIRect::MakeLTRB(5,     64,     6,     h - 64),
+            SkIRect::MakeLTRB(0,     h - 1,  w,     h),
+            SkIRect::MakeWH(w, h),
+        };
+        for (SkIRect subset : subsets) {
+            SkIRect valid = subset;
+            REPORTER_ASSERT(r, codec->getValidSubset(&valid) && valid == subset);
+
+            SkCodec::Options opts;
+            opts.fSubset = &subset;
+            SkBitmap bm;
+            bm.allocPixels(info.makeWH(subset.width(), subset.height()));
+            REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(bm.info(), bm.getPixels(),
+                    bm.rowBytes(), &opts, nullptr, nullptr));
+            for (int y = 0; y < subset.height(); y++) {
+                REPORTER_ASSERT(r, 0 == memcmp(bm.getAddr32(0, y),
+                                               full.getAddr32(subset.left(), subset.top() + y),
+                                               subset.width() * sizeof(SkPMColor)));
+            }
+        }
+
+        // Subsets cannot be scaled.
+        SkIRect subset = SkIRect::MakeWH(w / 2, h / 2);
+        SkCodec::Options opts;
+        opts.fSubset = &subset;
+        REPORTER_ASSERT(r, SkCodec::kInvalidScale == codec->getPixels(
+                info.makeWH(w / 4, h / 4), full.getPixels(), full.rowBytes(), &opts,
+                nullptr, nullptr));
+    }
+
+    // SkAndroidCodec decodes subsets the same way, when it is not sampling.
+    auto data = SkData::MakeFromFileName(GetResourcePath("mandrill_512.png").c_str());
+    if (!data) {
+        return;
+    }
+    SkAutoTDelete<SkAndroidCodec> androidCodec(SkAndroidCodec::NewFromData(data.get()));
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(data.get()));
+    REPORTER_ASSERT(r, androidCodec && codec);
+    if (!androidCodec || !codec) {
+        return;
+    }
+    SkIRect subset = SkIRect::MakeLTRB(100, 300, 200, 400);
+    const SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType)
+                                             .makeWH(subset.width(), subset.height());
+    SkBitmap viaAndroid, direct;
+    viaAndroid.allocPixels(info);
+    direct.allocPixels(info);
+    SkAndroidCodec::AndroidOptions androidOpts;
+    androidOpts.fSubset = &subset;
+    REPORTER_ASSERT(r, SkCodec::kSuccess == androidCodec->getAndroidPixels(info,
+            viaAndroid.getPixels(), viaAndroid.rowBytes(), &androidOpts));
+    SkCodec::Options opts;
+    opts.fSubset = &subset;
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(info, direct.getPixels(),
+            direct.rowBytes(), &opts, nullptr, nullptr));
+    REPORTER_ASSERT(r, 0 == memcmp(viaAndroid.getPixels(), direct.getPixels(),
+                                   direct.getSafeSize()));
+
+    // Cut short, a subset below the end of the data is incomplete.
+    sk_sp<SkData> truncated = SkData::MakeSubset(data.get(), 0, data->size() / 2);
+    codec.reset(SkCodec::NewFromData(truncated.get()));
+    REPORTER_ASSERT(r, codec);
+    if (codec) {
+        subset = SkIRect::MakeLTRB(0, 400, 512, 512);
+        SkBitmap bottom;
+        bottom.allocPixels(info.makeWH(subset.width(), subset.height()));
+        REPORTER_ASSERT(r, SkCodec::kIncompleteInput == codec->getPixels(bottom.info(),
+                bottom.getPixels(), bottom.rowBytes(), &opts, nullptr, nullptr));
+    }
+}
+
+DEF_TEST(Codec_fused_color_xform, r) {
+    sk_sp<SkData> dstData = SkData::MakeFromFileName(
+            GetResourcePath("monitor_profiles/HP_ZR30w.icc").c_str());
+    if (!dstData) {
+        SkDebugf("Missing resource 'monitor_profiles/HP_ZR30w.icc'\n");
+        return;
+    }
+    sk_sp<SkColorSpace> dstSpace = SkColorSpace::NewICC(dstData->data(), dstData->size());
+    REPORTER_ASSERT(r, dstSpace);
+
+    // The color xform only handles opaque images, and this is our only opaque one with a profile.
+    auto data = SkData::MakeFromFileName(GetResourcePath("icc-v2-gbr.jpg").c_str());
+    if (!data) {
+        SkDebugf("Missing resource 'icc-v2-gbr.jpg'\n");
+        return;
+    }
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(data.get()));
+    REPORTER_ASSERT(r, codec && codec->getColorSpace());
+    if (!codec || !codec->getColorSpace()) {
+        return;
+    }
+    std::unique_ptr<SkColorSpaceXform> xform =
+            SkColorSpaceXform::New(sk_ref_sp(codec->getColorSpace()), dstSpace);
+    REPORTER_ASSERT(r, xform);
+    if (!xform) {
+        return;
+    }
+
+    // Decode to RGBA, then convert the whole image in a second pass.
+    const SkImageInfo info = codec->getInfo().makeColorType(kRGBA_8888_SkColorType)
+                                             .makeAlphaType(kOpaque_SkAlphaType);
+    SkBitmap twoPass;
+    twoPass.allocPixels(info);
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(info, twoPass.getPixels(),
+                                                             twoPass.rowBytes()));
+    for (int y = 0; y < info.height(); y++) {
+        xform->xform_RGB1_8888(twoPass.getAddr32(0, y), twoPass.getAddr32(0, y),
+                               info.width());
+    }
+
+    // Asking for the dst color space converts each row during the decode instead.
+    const SkImageInfo fusedInfo = info.makeColorType(kN32_SkColorType)
+                                      .makeColorSpace(dstSpace);
+    SkBitmap fused;
+    fused.allocPixels(fusedInfo);
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(fusedInfo, fused.getPixels(),
+                                                             fused.rowBytes()));
+    REPORTER_ASSERT(r, 0 == memcmp(fused.getPixels(), twoPass.getPixels(),
+                                   twoPass.getSafeSize()));
+
+    // Scanline decodes convert too.
+    SkBitmap scanlines;
+    scanlines.allocPixels(fusedInfo);
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->startScanlineDecode(fusedInfo));
+    REPORTER_ASSERT(r, info.height() == codec->getScanlines(scanlines.getPixels(),
+            info.height(), scanlines.rowBytes()));
+    REPORTER_ASSERT(r, 0 == memcmp(scanlines.getPixels(), twoPass.getPixels(),
+                                   twoPass.getSafeSize()));
+}
+
+// Writes a KTX file holding one image, with no key/value data.
+static sk_sp<SkData> make_ktx(uint32_t glInternalFormat, int width, int height,
+                              const void* pixels, size_t size) {
+    static const uint8_t kIdentifier[] = {
+        0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+    };
+    // endianness, glType, glTypeSize, glFormat, glInternalFormat, glBaseInternalFormat,
+    // width, height, depth, array elements, faces, mipmap levels, key/value bytes, image size
+    const uint32_t header[] = {
+        0x04030201, 0, 1, 0, glInternalFormat, 0,
+        (uint32_t)width, (uint32_t)height, 0, 0, 1, 1, 0, (uint32_t)size
+    };
+
+    SkDynamicMemoryWStream stream;
+    stream.write(kIdentifier, sizeof(kIdentifier));
+    stream.write(header, sizeof(header));
+    stream.write(pixels, size);
+    return sk_sp<SkData>(stream.copyToData());
+}
+
+DEF_TEST(Codec_KTX, r) {
+    static const uint32_t kGL_RGBA8 = 0x8058;
+    static const uint32_t kGL_ETC1_RGB8 = 0x8D64;
+
+    // Uncompressed, unpremultiplied RGBA.
+    {
+        const int kWidth = 5, kHeight = 3;
+        uint8_t rgba[kWidth * kHeight * 4];
+        for (int i = 0; i < kWidth * kHeight * 4; i++) {
+            rgba[i] = (uint8_t)(i * 17);
+        }
+        sk_sp<SkData> data = make_ktx(kGL_RGBA8, kWidth, kHeight, rgba, sizeof(rgba));
+        SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(data.get()));
+        REPORTER_ASSERT(r, codec);
+        if (!codec) {
+            return;
+        }
+        REPORTER_ASSERT(r, kKTX_SkEncodedFormat == codec->getEncodedFormat());
+        REPORTER_ASSERT(r, kUnpremul_SkAlphaType == codec->getInfo().alphaType());
+
+        SkBitmap bm;
+        bm.allocPixels(codec->getInfo().makeColorType(kN32_SkColorType)
+                                       .makeAlphaType(kPremul_SkAlphaType));
+        REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(bm.info(), bm.getPixels(),
+                                                                 bm.rowBytes()));
+        for (int y = 0; y < kHeight; y++) {
+            for (int x = 0; x < kWidth; x++) {
+                const uint8_t* p = rgba + (y * kWidth + x) * 4;
+                REPORTER_ASSERT(r, *bm.getAddr32(x, y) ==
+                                   SkPreMultiplyARGB(p[3], p[0], p[1], p[2]));
+            }
+        }
+    }
+
+#ifndef SK_IGNORE_ETC1_SUPPORT
+    // ETC1, whose blocks run past the right and bottom edges.
+    {
+        const int kWidth = 18, kHeight = 10;
+        SkAutoPixmapStorage src;
+        src.alloc(SkImageInfo::MakeN32(20, 12, kOpaque_SkAlphaType));
+        for (int y = 0; y < src.height(); y++) {
+            for (int x = 0; x < src.width(); x++) {
+                *src.writable_addr32(x, y) = SkPackARGB32(0xFF, x * 12, y * 20, 0x80);
+            }
+        }
+        sk_sp<SkData> etc1(SkTextureCompressor::CompressBitmapToFormat(
+                src, SkTextureCompressor::kETC1_Format));
+        REPORTER_ASSERT(r, etc1);
+        if (!etc1) {
+            return;
+        }
+        uint8_t expected[20 * 12 * 3];
+        REPORTER_ASSERT(r, SkTextureCompressor::DecompressBufferFromFormat(
+                expected, 20 * 3, etc1->bytes(), 20, 12, SkTextureCompressor::kETC1_Format));
+
+        sk_sp<SkData> data = make_ktx(kGL_ETC1_RGB8, kWidth, kHeight,
+                                      etc1->data(), etc1->size());
+        SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(data.get()));
+        REPORTER_ASSERT(r, codec);
+        if (!codec) {
+            return;
+        }
+        REPORTER_ASSERT(r, SkISize::Make(kWidth, kHeight) == codec->getInfo().dimensions());
+        REPORTER_ASSERT(r, kOpaque_SkAlphaType == codec->getInfo().alphaType());
+
+        SkBitmap bm;
+        bm.allocPixels(codec->getInfo().makeColorType(kN32_SkColorType));
+        REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(bm.info(), bm.getPixels(),
+                                                                 bm.rowBytes()));
+        for (int y = 0; y < kHeight; y++) {
+            for (int x = 0; x < kWidth; x++) {
+                const uint8_t* p = expected + (y * 20 + x) * 3;
+                REPORTER_ASSERT(r, *bm.getAddr32(x, y) == SkPackARGB32(0xFF, p[0], p[1], p[2]));
+            }
+        }
+
+        // Truncated data is rejected up front.
+        sk_sp<SkData> truncated = make_ktx(kGL_ETC1_RGB8, kWidth, kHeight,
+                                           etc1->data(), etc1->size() - 8);
+        SkAutoTDelete<SkCodec> truncatedCodec(SkCodec::NewFromData(truncated.get()));
+        REPORTER_ASSERT(r, !truncatedCodec);
+    }
+#endif
+}
+
+// Decoding a gif frame from scratch decompresses every frame it depends on in parallel, then
+// draws them in order.  Building each frame serially instead, by drawing it alone on top of the
+// frame it requires, should give the same pixels for every frame.
+DEF_TEST(Codec_gif_parallel_frames, r) {
+    for (const char* path : { "test640x479.gif", "color_wheel.gif" }) {
+        SkAutoTDelete<SkCodec> codec(SkCodec::NewFromStream(resource(path)));
+        REPORTER_ASSERT(r, codec);
+        if (!codec) {
+            continue;
+        }
+
+        const std::vector<SkCodec::FrameInfo> frames = codec->getFrameInfo();
+        const SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType);
+        SkAutoTArray<SkBitmap> serial(SkToInt(frames.size()));
+        for (size_t i = 0; i < frames.size(); i++) {
+            SkCodec::Options opts;
+            opts.fFrameIndex = i;
+
+            SkBitmap parallel;
+            parallel.allocPixels(info);
+            REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(info, parallel.getPixels(),
+                                                                     parallel.rowBytes(), &opts,
+                                                                     nullptr, nullptr));
+
+            serial[i].allocPixels(info);
+            const size_t required = frames[i].fRequiredFrame;
+            if (SkCodec::kNone != required) {
+                REPORTER_ASSERT(r, required < i);
+                if (required >= i) {
+                    break;
+                }
+                memcpy(serial[i].getPixels(), serial[required].getPixels(),
+                       serial[i].getSafeSize());
+                opts.fHasPriorFrame = true;
+            }
+            REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(info, serial[i].getPixels(),
+                                                                     serial[i].rowBytes(), &opts,
+                                                                     nullptr, nullptr));
+
+            SkMD5::Digest parallelDigest, serialDigest;
+            md5(parallel, &parallelDigest);
+            md5(serial[i], &serialDigest);
+            if (parallelDigest != serialDigest) {
+                ERRORF(r, "%s frame %d decoded in parallel differs from serial decode",
+                       path, SkToInt(i));
+            }
+        }
+    }
+}
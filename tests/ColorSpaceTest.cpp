@@ -9,6 +9,7 @@
 #include "SkCodec.h"
 #include "SkColorSpace.h"
 #include "SkColorSpace_Base.h"
+#include "SkColorSpaceXform.h"
 #include "Test.h"
 
 #include "png.h"
@@ -203,3 +204,35 @@ DEF_TEST(ColorSpace_Serialize, r) {
     test_serialize(r, SkColorSpace::NewICC(monitorData->data(), monitorData->size()).get(), false);
 }
 
+
+DEF_TEST(ColorSpace_ICCCache, r) {
+    sk_sp<SkData> monitorData = SkData::MakeFromFileName(
+            GetResourcePath("monitor_profiles/HP_ZR30w.icc").c_str());
+    REPORTER_ASSERT(r, monitorData);
+    if (!monitorData) {
+        return;
+    }
+
+    // Identical profiles, even in different memory, share one SkColorSpace.
+    sk_sp<SkData> copy = SkData::MakeWithCopy(monitorData->data(), monitorData->size());
+    sk_sp<SkColorSpace> space = SkColorSpace::NewICC(monitorData->data(), monitorData->size());
+    sk_sp<SkColorSpace> same = SkColorSpace::NewICC(copy->data(), copy->size());
+    REPORTER_ASSERT(r, space && space == same);
+
+    // A different profile doesn't.
+    sk_sp<SkData> adobeData = as_CSB(SkColorSpace::NewNamed(SkColorSpace::kAdobeRGB_Named))
+                                     ->writeToICC();
+    sk_sp<SkColorSpace> other = SkColorSpace::NewICC(adobeData->data(), adobeData->size());
+    REPORTER_ASSERT(r, other && other != space);
+
+    // Xforms between the same spaces share their tables, and so convert identically.
+    sk_sp<SkColorSpace> srgb = SkColorSpace::NewNamed(SkColorSpace::kSRGB_Named);
+    std::unique_ptr<SkColorSpaceXform> xform0 = SkColorSpaceXform::New(space, srgb),
+                                       xform1 = SkColorSpaceXform::New(same, srgb);
+    REPORTER_ASSERT(r, xform0 && xform1);
+    const uint32_t src[] = { 0xFF102030, 0xFF808080, 0xFFF0E0D0, 0xFF000000 };
+    uint32_t dst0[4], dst1[4];
+    xform0->xform_RGB1_8888(dst0, src, 4);
+    xform1->xform_RGB1_8888(dst1, src, 4);
+    REPORTER_ASSERT(r, 0 == memcmp(dst0, dst1, sizeof(dst0)));
+}
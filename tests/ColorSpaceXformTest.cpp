@@ -11,6 +11,7 @@
 #include "SkColorSpace.h"
 #include "SkColorSpace_Base.h"
 #include "SkColorSpaceXform.h"
+#include "SkHalf.h"
 #include "Test.h"
 
 class ColorSpaceXformTest {
@@ -59,6 +60,17 @@ static void test_xform(skiatest::Reporter* r, const sk_sp<SkGammas>& gammas) {
         REPORTER_ASSERT(r, almost_equal(((srcPixels[i] >> 24) & 0xFF),
                                         SkGetPackedA32(dstPixels[i])));
     }
+
+    // The pipeline should agree, storing RGBA.
+    REPORTER_ASSERT(r, xform->apply(dstPixels, srcPixels, width,
+                                    SkColorSpaceXform::kRGBA_8888_ColorFormat,
+                                    kUnpremul_SkAlphaType));
+    for (int i = 0; i < width; i++) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            REPORTER_ASSERT(r, almost_equal((srcPixels[i] >> shift) & 0xFF,
+                                            (dstPixels[i] >> shift) & 0xFF));
+        }
+    }
 }
 
 DEF_TEST(ColorSpaceXform_TableGamma, r) {
@@ -113,3 +125,31 @@ DEF_TEST(ColorSpaceXform_ExponentialGamma, r) {
             sk_make_sp<SkGammas>(std::move(red), std::move(green), std::move(blue));
     test_xform(r, gammas);
 }
+
+DEF_TEST(ColorSpaceXform_ApplyPremulAndF16, r) {
+    sk_sp<SkColorSpace> srgb = SkColorSpace::NewNamed(SkColorSpace::kSRGB_Named);
+    std::unique_ptr<SkColorSpaceXform> xform = SkColorSpaceXform::New(srgb, srgb);
+    const uint32_t src = 0x80FF8040;  // a=0x80, b=0xFF, g=0x80, r=0x40
+
+    uint32_t rgba, bgra;
+    REPORTER_ASSERT(r, xform->apply(&rgba, &src, 1, SkColorSpaceXform::kRGBA_8888_ColorFormat,
+                                    kPremul_SkAlphaType));
+    REPORTER_ASSERT(r, xform->apply(&bgra, &src, 1, SkColorSpaceXform::kBGRA_8888_ColorFormat,
+                                    kPremul_SkAlphaType));
+    REPORTER_ASSERT(r, almost_equal(0x20, (rgba >>  0) & 0xFF));
+    REPORTER_ASSERT(r, almost_equal(0x40, (rgba >>  8) & 0xFF));
+    REPORTER_ASSERT(r, almost_equal(0x80, (rgba >> 16) & 0xFF));
+    REPORTER_ASSERT(r, almost_equal(0x80, (rgba >> 24) & 0xFF));
+    REPORTER_ASSERT(r, rgba == SkSwizzle_RB(bgra));
+
+    // F16 is linear.  sRGB 0x40, 0x80 and 0xFF are about 0.0513, 0.2158 and 1.0 linear.
+    uint64_t f16;
+    REPORTER_ASSERT(r, xform->apply(&f16, &src, 1, SkColorSpaceXform::kRGBA_F16_ColorFormat,
+                                    kPremul_SkAlphaType));
+    const float alpha = 0x80 / 255.0f;
+    const float expected[] = { 0.0513f * alpha, 0.2158f * alpha, 1.0f * alpha, alpha };
+    for (int i = 0; i < 4; i++) {
+        float actual = SkHalfToFloat((f16 >> (16 * i)) & 0xFFFF);
+        REPORTER_ASSERT(r, SkTAbs(expected[i] - actual) < 0.002f);
+    }
+}
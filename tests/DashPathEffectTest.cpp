@@ -7,6 +7,7 @@
 
 #include "Test.h"
 
+#include "SkCanvas.h"
 #include "SkDashPathEffect.h"
 #include "SkWriteBuffer.h"
 #include "SkStrokeRec.h"
@@ -99,3 +100,42 @@ DEF_TEST(DashPath_bug4871, r) {
     SkPath fill;
     paint.getFillPath(path, &fill);
 }
+
+// Dashing a long polyline against a cull rect should only produce the dashes near the rect,
+// and those should land exactly where they would without culling.
+DEF_TEST(DashPath_cullPolyline, r) {
+    SkPath path;
+    path.moveTo(0, 50);
+    for (int i = 1; i <= 2000; ++i) {
+        path.lineTo(SkIntToScalar(i * 5), SkIntToScalar(40 + (i % 3) * 10));
+    }
+    path.moveTo(20, 20);
+    path.lineTo(10000, 30);
+
+    SkScalar intervals[] = { 4, 3 };
+    SkPaint paint;
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(2);
+    paint.setPathEffect(SkDashPathEffect::Make(intervals, 2, 1));
+
+    const SkRect cull = SkRect::MakeXYWH(5000, 0, 100, 100);
+    SkPath culled, unculled;
+    REPORTER_ASSERT(r, paint.getFillPath(path, &culled, &cull));
+    REPORTER_ASSERT(r, paint.getFillPath(path, &unculled));
+    REPORTER_ASSERT(r, culled.countPoints() > 0);
+    REPORTER_ASSERT(r, culled.countPoints() * 10 < unculled.countPoints());
+
+    SkBitmap culledBitmap, unculledBitmap;
+    culledBitmap.allocN32Pixels(100, 100);
+    unculledBitmap.allocN32Pixels(100, 100);
+    SkPaint fill;
+    fill.setAntiAlias(true);
+    for (SkBitmap* bitmap : { &culledBitmap, &unculledBitmap }) {
+        SkCanvas canvas(*bitmap);
+        canvas.clear(SK_ColorWHITE);
+        canvas.translate(-cull.fLeft, -cull.fTop);
+        canvas.drawPath(bitmap == &culledBitmap ? culled : unculled, fill);
+    }
+    REPORTER_ASSERT(r, !memcmp(culledBitmap.getPixels(), unculledBitmap.getPixels(),
+                               culledBitmap.getSize()));
+}
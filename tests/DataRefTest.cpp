@@ -204,6 +204,37 @@ static void test_files(skiatest::Reporter* reporter) {
     REPORTER_ASSERT(reporter, strncmp(static_cast<const char*>(r2->data()), s, 26) == 0);
 }
 
+#if !defined(SK_BUILD_FOR_WIN)
+#include <unistd.h>
+
+// Shared memory written through one SkData shows up in another made from its descriptor.
+static void test_shared(skiatest::Reporter* reporter) {
+    const size_t kLength = 10000;
+    int fd;
+    sk_sp<SkData> writer = SkData::MakeShared(kLength, &fd);
+    if (!writer) {
+        return;  // Shared memory isn't available here.
+    }
+    REPORTER_ASSERT(reporter, kLength == writer->size());
+    REPORTER_ASSERT(reporter, 0 == writer->bytes()[0] && 0 == writer->bytes()[kLength - 1]);
+
+    uint8_t* bytes = static_cast<uint8_t*>(writer->writable_data());
+    for (size_t i = 0; i < kLength; i++) {
+        bytes[i] = (uint8_t) i;
+    }
+
+    sk_sp<SkData> reader = SkData::MakeFromSharedFD(fd);
+    close(fd);
+    REPORTER_ASSERT(reporter, reader && reader->size() == kLength);
+    REPORTER_ASSERT(reporter, reader->data() != writer->data());
+    REPORTER_ASSERT(reporter, reader->equals(writer.get()));
+
+    REPORTER_ASSERT(reporter, nullptr == SkData::MakeFromSharedFD(-1));
+}
+#else
+static void test_shared(skiatest::Reporter*) {}
+#endif
+
 DEF_TEST(Data, reporter) {
     const char* str = "We the people, in order to form a more perfect union.";
     const int N = 10;
@@ -231,6 +262,7 @@ DEF_TEST(Data, reporter) {
 
     test_cstring(reporter);
     test_files(reporter);
+    test_shared(reporter);
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -381,3 +413,77 @@ DEF_TEST(RWBuffer_noAppend, r) {
         REPORTER_ASSERT(r, stream->skip(10) == 0);
     }
 }
+
+// Tests that preallocated storage is used in place, by appends and by stream snapshots.
+DEF_TEST(RWBuffer_initialCapacity, r) {
+    const int N = 1000;
+    SkRWBuffer buffer(N * 26);
+    REPORTER_ASSERT(r, 0 == buffer.size());
+    SkAutoTDelete<SkStream> empty(buffer.newStreamSnapshot());
+    REPORTER_ASSERT(r, 0 == empty->getLength());
+    REPORTER_ASSERT(r, !empty->getMemoryBase());
+
+    for (int i = 0; i < N; ++i) {
+        buffer.append(gABC, 26);
+    }
+    sk_sp<SkROBuffer> reader(buffer.newRBufferSnapshot());
+    SkROBuffer::Iter iter(reader.get());
+    REPORTER_ASSERT(r, N * 26U == iter.size());
+    REPORTER_ASSERT(r, !iter.next());
+
+    SkAutoTDelete<SkStream> stream(buffer.newStreamSnapshot());
+    const char* base = static_cast<const char*>(stream->getMemoryBase());
+    REPORTER_ASSERT(r, base);
+    if (base) {
+        check_abcs(r, base, N * 26);
+    }
+    check_alphabet_stream(r, stream);
+
+    // Spilling into a second block means the stream is no longer contiguous.
+    buffer.append(gABC, 26);
+    stream.reset(buffer.newStreamSnapshot());
+    REPORTER_ASSERT(r, !stream->getMemoryBase());
+    check_alphabet_stream(r, stream);
+}
+
+// Tests that reset() reuses storage nobody can see, and leaves snapshots alone.
+DEF_TEST(RWBuffer_reset, r) {
+    // Enough to need several blocks.
+    const int N = 1000;
+    SkRWBuffer buffer;
+    for (int i = 0; i < N; ++i) {
+        buffer.append(gABC, 26);
+    }
+    sk_sp<SkROBuffer> first(buffer.newRBufferSnapshot());
+    const void* firstBlock = SkROBuffer::Iter(first.get()).data();
+
+    // The snapshot still refers to the blocks, so they must not be reused.
+    buffer.reset();
+    REPORTER_ASSERT(r, 0 == buffer.size());
+    buffer.append(gABC, 26);
+    sk_sp<SkROBuffer> second(buffer.newRBufferSnapshot());
+    REPORTER_ASSERT(r, SkROBuffer::Iter(second.get()).data() != firstBlock);
+    REPORTER_ASSERT(r, N * 26U == first->size());
+    check_alphabet_buffer(r, first.get());
+    check_alphabet_buffer(r, second.get());
+    first.reset();
+
+    // Once nothing else can see them, the blocks are appended into again.
+    for (int i = 1; i < N; ++i) {
+        buffer.append(gABC, 26);
+    }
+    const void* secondBlock = SkROBuffer::Iter(second.get()).data();
+    second.reset();
+    buffer.reset();
+    for (int j = 0; j < 2; ++j) {
+        for (int i = 0; i < N; ++i) {
+            buffer.append(gABC, 26);
+        }
+    }
+    sk_sp<SkROBuffer> third(buffer.newRBufferSnapshot());
+    REPORTER_ASSERT(r, SkROBuffer::Iter(third.get()).data() == secondBlock);
+    REPORTER_ASSERT(r, 2 * N * 26U == third->size());
+    check_alphabet_buffer(r, third.get());
+    SkAutoTDelete<SkStream> stream(buffer.newStreamSnapshot());
+    check_alphabet_stream(r, stream);
+}
@@ -5,6 +5,8 @@
  * found in the LICENSE file.
  */
 #include "SkDiscardableMemoryPool.h"
+#include "SkTaskGroup.h"
+#include "SkTraceMemoryDump.h"
 
 #include "Test.h"
 
@@ -33,3 +35,70 @@ DEF_TEST(DiscardableMemoryPool, reporter) {
     REPORTER_ASSERT(reporter, !dm2->lock());
     REPORTER_ASSERT(reporter, 0 == pool->getRAMUsed());
 }
+
+namespace {
+class PoolStatsDump : public SkTraceMemoryDump {
+public:
+    PoolStatsDump() : fUsed(~0ull), fBudget(~0ull) {}
+
+    void dumpNumericValue(const char*, const char* valueName, const char*,
+                          uint64_t value) override {
+        if (0 == strcmp(valueName, "ram_used")) {
+            fUsed = value;
+        }
+        if (0 == strcmp(valueName, "ram_budget")) {
+            fBudget = value;
+        }
+    }
+    void setMemoryBacking(const char*, const char*, const char*) override {}
+    void setDiscardableMemoryBacking(const char*, const SkDiscardableMemory&) override {}
+    LevelOfDetail getRequestedDetails() const override {
+        return SkTraceMemoryDump::kLight_LevelOfDetail;
+    }
+
+    uint64_t fUsed;
+    uint64_t fBudget;
+};
+}
+
+DEF_TEST(DiscardableMemoryPool_Background, reporter) {
+    SK_DECLARE_STATIC_MUTEX(mutex);
+    SkAutoTUnref<SkDiscardableMemoryPool> pool(
+        SkDiscardableMemoryPool::Create(1000, &mutex, true));
+
+    SkAutoTDelete<SkDiscardableMemory> dm1(pool->create(100));
+    dm1->unlock();
+    REPORTER_ASSERT(reporter, dm1->lock());
+    dm1->unlock();
+
+    PoolStatsDump dump;
+    pool->dumpMemoryStatistics(&dump, "pool");
+    REPORTER_ASSERT(reporter, 100 == dump.fUsed);
+    REPORTER_ASSERT(reporter, 1000 == dump.fBudget);
+
+    // Setting the budget and dumping the pool still purge right away.
+    pool->setRAMBudget(0);
+    REPORTER_ASSERT(reporter, 0 == pool->getRAMUsed());
+    REPORTER_ASSERT(reporter, !dm1->lock());
+    pool->setRAMBudget(1000);
+
+    // Blocks locked and unlocked on many threads at once, while the pool is over budget, are
+    // never purged while they're locked.
+    const int kCount = 64;
+    SkAutoTDelete<SkDiscardableMemory> dms[kCount];
+    for (int i = 0; i < kCount; i++) {
+        dms[i].reset(pool->create(100));
+        *(int*)dms[i]->data() = i;
+        dms[i]->unlock();
+    }
+    SkTaskGroup().batch(kCount, [&](int i) {
+        for (int j = 0; j < 16; j++) {
+            if (dms[i]->lock()) {
+                REPORTER_ASSERT(reporter, i == *(int*)dms[i]->data());
+                dms[i]->unlock();
+            }
+        }
+    });
+    pool->dumpPool();
+    REPORTER_ASSERT(reporter, 0 == pool->getRAMUsed());
+}
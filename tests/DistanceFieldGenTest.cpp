@@ -0,0 +1,62 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkDistanceFieldGen.h"
+#include "SkTemplates.h"
+#include "Test.h"
+
+// A disk centered in the image should give a distance field that's (nearly) symmetric, all the
+// way out to the padding, and a 1-bit mask should give the same field as the same 8-bit one.
+DEF_TEST(DistanceFieldGen, reporter) {
+    const int kSize = 37;
+    const int kDFSize = kSize + 2*SK_DistanceFieldPad;
+    const float kCenter = kSize * 0.5f,
+                kRadius = kSize * 0.5f - 1;
+
+    const size_t bwRowBytes = (kSize + 7) / 8;
+    unsigned char a8[kSize * kSize], aa[kSize * kSize], bw[bwRowBytes * kSize];
+    sk_bzero(bw, sizeof(bw));
+    for (int y = 0; y < kSize; ++y) {
+        for (int x = 0; x < kSize; ++x) {
+            float dx = x + 0.5f - kCenter,
+                  dy = y + 0.5f - kCenter;
+            float d = sqrtf(dx*dx + dy*dy) - kRadius;
+            bool inside = d < 0;
+            a8[y*kSize + x] = inside ? 0xFF : 0;
+            aa[y*kSize + x] = (unsigned char)SkScalarRoundToInt(255*SkScalarPin(0.5f - d, 0, 1));
+            if (inside) {
+                bw[y*bwRowBytes + x/8] |= 0x80 >> (x & 7);
+            }
+        }
+    }
+
+    SkAutoTMalloc<unsigned char> fromA8(SkComputeDistanceFieldSize(kSize, kSize)),
+                                 fromBW(SkComputeDistanceFieldSize(kSize, kSize)),
+                                 fromAA(SkComputeDistanceFieldSize(kSize, kSize));
+    REPORTER_ASSERT(reporter, SkGenerateDistanceFieldFromA8Image(fromA8.get(), a8,
+                                                                 kSize, kSize, kSize));
+    REPORTER_ASSERT(reporter, SkGenerateDistanceFieldFromBWImage(fromBW.get(), bw,
+                                                                 kSize, kSize, bwRowBytes));
+    REPORTER_ASSERT(reporter, SkGenerateDistanceFieldFromA8Image(fromAA.get(), aa,
+                                                                 kSize, kSize, kSize));
+    REPORTER_ASSERT(reporter, 0 == memcmp(fromA8.get(), fromBW.get(),
+                                          SkComputeDistanceFieldSize(kSize, kSize)));
+
+    for (int y = 0; y < kDFSize; ++y) {
+        for (int x = 0; x < kDFSize; ++x) {
+            int v = fromAA[y*kDFSize + x];
+            int mirrorX = fromAA[y*kDFSize + kDFSize-1 - x],
+                mirrorY = fromAA[(kDFSize-1 - y)*kDFSize + x];
+            REPORTER_ASSERT(reporter, SkTAbs(v - mirrorX) <= 2);
+            REPORTER_ASSERT(reporter, SkTAbs(v - mirrorY) <= 2);
+        }
+    }
+    // The center is far inside, and the corners far outside.
+    REPORTER_ASSERT(reporter, 255 == fromAA[(kDFSize/2)*kDFSize + kDFSize/2]);
+    REPORTER_ASSERT(reporter, 0 == fromAA[0]);
+    REPORTER_ASSERT(reporter, 0 == fromAA[kDFSize*kDFSize - 1]);
+}
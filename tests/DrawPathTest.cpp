@@ -8,6 +8,7 @@
 #include "SkBitmap.h"
 #include "SkCanvas.h"
 #include "SkDashPathEffect.h"
+#include "SkRandom.h"
 #include "SkStrokeRec.h"
 #include "SkSurface.h"
 #include "Test.h"
@@ -345,6 +346,55 @@ static void test_crbug_472147_actual(skiatest::Reporter* reporter) {
     canvas->drawRect(r2, p);
 }
 
+// An AA hairline polyline should draw exactly like its segments drawn one at a time, whether the
+// clip trims it or not.  (Segments are drawn as a polyline in one go when none need clipping.)
+static void test_aa_polyline_hairline(skiatest::Reporter* reporter) {
+    const int kPts = 200;
+    SkPoint pts[kPts];
+    SkRandom rand;
+    for (int i = 0; i < kPts; i++) {
+        pts[i].set(rand.nextRangeScalar(-20, 120), rand.nextRangeScalar(-20, 120));
+    }
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setColor(0x80402010);
+
+    const SkRect clips[] = {
+        SkRect::MakeWH(100, 100),        // Everything inside the device, no clipping needed.
+        SkRect::MakeLTRB(10, 10, 90, 90),
+    };
+    for (const SkRect& clip : clips) {
+        SkBitmap polyline, segments;
+        polyline.allocN32Pixels(100, 100);
+        segments.allocN32Pixels(100, 100);
+        polyline.eraseColor(SK_ColorWHITE);
+        segments.eraseColor(SK_ColorWHITE);
+
+        SkCanvas polylineCanvas(polyline), segmentsCanvas(segments);
+        polylineCanvas.clipRect(clip);
+        segmentsCanvas.clipRect(clip);
+
+        // Inset the points for the unclipped case.
+        SkPoint drawn[kPts];
+        for (int i = 0; i < kPts; i++) {
+            drawn[i] = pts[i];
+            if (clip.width() == 100) {
+                drawn[i].set(SkScalarPin(pts[i].fX, 2, 98), SkScalarPin(pts[i].fY, 2, 98));
+            }
+        }
+
+        polylineCanvas.drawPoints(SkCanvas::kPolygon_PointMode, kPts, drawn, paint);
+        for (int i = 0; i < kPts - 1; i++) {
+            segmentsCanvas.drawPoints(SkCanvas::kLines_PointMode, 2, &drawn[i], paint);
+        }
+
+        REPORTER_ASSERT(reporter, 0 == memcmp(polyline.getPixels(), segments.getPixels(),
+                                              polyline.getSize()));
+    }
+}
+
 DEF_TEST(DrawPath, reporter) {
     test_giantaa();
     test_bug533();
@@ -361,4 +411,5 @@ DEF_TEST(DrawPath, reporter) {
     test_crbug_472147_actual(reporter);
     test_big_aa_rect(reporter);
     test_halfway();
+    test_aa_polyline_hairline(reporter);
 }
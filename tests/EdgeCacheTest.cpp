@@ -0,0 +1,149 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkEdge.h"
+#include "SkEdgeBuilder.h"
+#include "SkEdgeCache.h"
+#include "SkPath.h"
+#include "SkResourceCache.h"
+#include "Test.h"
+
+// Complex enough for SkDraw to cache its edges.
+static SkPath make_path() {
+    SkPath path;
+    path.moveTo(5, 40);
+    path.quadTo(30, -10, 60, 30);
+    path.cubicTo(40, 70, 20, 10, 10, 60);
+    path.lineTo(45, 5);
+    for (int i = 0; i < 6; i++) {
+        path.quadTo(50 - 4 * i, 10 + 6 * i, 40 - 5 * i, 20 + 6 * i);
+        path.lineTo(30 + 2 * i, 15 + 5 * i);
+    }
+    path.close();
+    return path;
+}
+
+DEF_TEST(EdgeCache_FindAndAdd, r) {
+    SkResourceCache cache(1024 * 1024);
+
+    SkPath path = make_path();
+    SkScanPathID id = { path.getGenerationID(), SkMatrix::I() };
+    const SkIRect clip = SkIRect::MakeLTRB(0, 0, 64 << 2, 64 << 2);
+
+    SkEdgeBuilder builder;
+    int count = builder.build(path, &clip, 2, true);
+    REPORTER_ASSERT(r, count > 0);
+    SkEdge** list = builder.edgeList();
+
+    SkEdgeCache::Edges edges;
+    REPORTER_ASSERT(r, !SkEdgeCache::Find(id, &clip, 2, true, &edges, &cache));
+    SkEdgeCache::Add(id, &clip, 2, true, list, count, &cache);
+    REPORTER_ASSERT(r, SkEdgeCache::Find(id, &clip, 2, true, &edges, &cache));
+
+    // We get back the same edges, in the same order, linked together.
+    REPORTER_ASSERT(r, edges.count() == count);
+    SkEdge* edge = edges.first();
+    for (int i = 0; i < count; i++) {
+        REPORTER_ASSERT(r, edge->fX          == list[i]->fX);
+        REPORTER_ASSERT(r, edge->fDX         == list[i]->fDX);
+        REPORTER_ASSERT(r, edge->fFirstY     == list[i]->fFirstY);
+        REPORTER_ASSERT(r, edge->fLastY      == list[i]->fLastY);
+        REPORTER_ASSERT(r, edge->fCurveCount == list[i]->fCurveCount);
+        REPORTER_ASSERT(r, edge->fWinding    == list[i]->fWinding);
+        REPORTER_ASSERT(r, (i == 0) == (edge->fPrev == nullptr));
+        REPORTER_ASSERT(r, (i == count - 1) == (edge == edges.last()));
+        edge = edge->fNext;
+    }
+    REPORTER_ASSERT(r, edge == nullptr);
+
+    // Any difference in the key is a miss.
+    SkScanPathID translated = id;
+    translated.fMatrix.setTranslate(0.25f, 0);
+    const SkIRect smaller = SkIRect::MakeLTRB(0, 0, 32 << 2, 64 << 2);
+    REPORTER_ASSERT(r, !SkEdgeCache::Find(translated, &clip, 2, true, &edges, &cache));
+    REPORTER_ASSERT(r, !SkEdgeCache::Find(id, &smaller, 2, true, &edges, &cache));
+    REPORTER_ASSERT(r, !SkEdgeCache::Find(id, nullptr, 2, true, &edges, &cache));
+    REPORTER_ASSERT(r, !SkEdgeCache::Find(id, &clip, 0, true, &edges, &cache));
+    REPORTER_ASSERT(r, !SkEdgeCache::Find(id, &clip, 2, false, &edges, &cache));
+}
+
+DEF_TEST(EdgeCache_PurgeOnEdit, r) {
+    SkResourceCache cache(1024 * 1024);
+
+    SkPath path = make_path();
+    SkScanPathID id = { path.getGenerationID(), SkMatrix::I(), path.getFillType(), &path };
+
+    SkEdgeBuilder builder;
+    int count = builder.build(path, nullptr, 0, true);
+    SkEdgeCache::Add(id, nullptr, 0, true, builder.edgeList(), count, &cache);
+
+    SkEdgeCache::Edges edges;
+    REPORTER_ASSERT(r, SkEdgeCache::Find(id, nullptr, 0, true, &edges, &cache));
+    size_t used = cache.getTotalBytesUsed();
+
+    // Editing the path changes its generation ID, so its old edges can never be found again.
+    // They shouldn't sit in the cache until they're the least recently used.
+    path.lineTo(60, 60);
+    REPORTER_ASSERT(r, !SkEdgeCache::Find(id, nullptr, 0, true, &edges, &cache));
+    REPORTER_ASSERT(r, cache.getTotalBytesUsed() < used);
+}
+
+static SkBitmap draw(const SkPath& path, const SkMatrix& matrix) {
+    SkBitmap bm;
+    bm.allocN32Pixels(64, 64);
+    bm.eraseColor(SK_ColorTRANSPARENT);
+
+    SkCanvas canvas(bm);
+    canvas.clipRect(SkRect::MakeLTRB(2, 3, 50, 61));
+    canvas.concat(matrix);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    canvas.drawPath(path, paint);
+    return bm;
+}
+
+static bool equal(const SkBitmap& a, const SkBitmap& b) {
+    return 0 == memcmp(a.getPixels(), b.getPixels(), a.getSafeSize());
+}
+
+DEF_TEST(EdgeCache_ShouldCache, r) {
+    REPORTER_ASSERT(r, SkEdgeCache::ShouldCache(make_path()));
+
+    // Simple paths build their edges about as fast as we could fetch them.
+    SkPath oval;
+    oval.addOval(SkRect::MakeWH(20, 30));
+    REPORTER_ASSERT(r, !SkEdgeCache::ShouldCache(oval));
+}
+
+DEF_TEST(EdgeCache_Draw, r) {
+    SkPath path = make_path(),
+           inverse = make_path();
+    inverse.setFillType(SkPath::kInverseWinding_FillType);
+
+    SkMatrix matrices[3];
+    matrices[0].reset();
+    matrices[1].setTranslate(0.3f, 0.6f);
+    matrices[2].setRotate(20, 32, 32);
+
+    for (SkPath* p : { &path, &inverse }) {
+        SkPath uncached(*p);
+        uncached.setIsVolatile(true);
+
+        for (const SkMatrix& m : matrices) {
+            SkBitmap expected = draw(uncached, m);
+            // Draw twice, once to populate the cache, once to use it.
+            REPORTER_ASSERT(r, equal(draw(*p, m), expected));
+            REPORTER_ASSERT(r, equal(draw(*p, m), expected));
+        }
+
+        // Editing the path changes its generation ID, so we don't draw stale edges.
+        p->lineTo(60, 60);
+        uncached.lineTo(60, 60);
+        REPORTER_ASSERT(r, equal(draw(*p, matrices[1]), draw(uncached, matrices[1])));
+    }
+}
@@ -93,3 +93,36 @@ DEF_TEST(UnflattenWithCustomFactory, r) {
     REPORTER_ASSERT(r, 6 == out3->c());
     REPORTER_ASSERT(r, 7 == out3->d());
 }
+
+static sk_sp<SkFlattenable> custom_create_proc_10(SkReadBuffer& buffer) {
+    uint32_t a = buffer.readUInt();
+    uint32_t b = buffer.readUInt();
+    uint32_t c = buffer.readUInt();
+    uint32_t d = buffer.readUInt();
+    return sk_sp<SkFlattenable>(new IntFlattenable(a + 10, b + 10, c + 10, d + 10));
+}
+
+// The read buffer looks up each flattenable name once, but must notice a custom factory set
+// after it has already seen the name.
+DEF_TEST(UnflattenWithChangedCustomFactory, r) {
+    SkBinaryWriteBuffer writeBuffer;
+    SkAutoTUnref<SkFlattenable> flattenable1(new IntFlattenable(1, 2, 3, 4));
+    writeBuffer.writeFlattenable(flattenable1);
+    writeBuffer.writeFlattenable(flattenable1);
+
+    sk_sp<SkData> data = SkData::MakeUninitialized(writeBuffer.bytesWritten());
+    writeBuffer.writeToMemory(data->writable_data());
+    SkReadBuffer readBuffer(data->data(), data->size());
+
+    readBuffer.setCustomFactory(SkString("IntFlattenable"), &custom_create_proc);
+    SkAutoTUnref<IntFlattenable> out1((IntFlattenable*) readBuffer.readFlattenable(
+            SkFlattenable::kSkUnused_Type));
+    REPORTER_ASSERT(r, out1);
+    REPORTER_ASSERT(r, 2 == out1->a());
+
+    readBuffer.setCustomFactory(SkString("IntFlattenable"), &custom_create_proc_10);
+    SkAutoTUnref<IntFlattenable> out2((IntFlattenable*) readBuffer.readFlattenable(
+            SkFlattenable::kSkUnused_Type));
+    REPORTER_ASSERT(r, out2);
+    REPORTER_ASSERT(r, 11 == out2->a());
+}
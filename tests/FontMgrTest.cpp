@@ -701,6 +701,24 @@ static void test_matchStyleCSS3(skiatest::Reporter* reporter) {
     }
 }
 
+static void test_matchCharacter(skiatest::Reporter* reporter) {
+    SkAutoTUnref<SkFontMgr> fm(SkFontMgr::RefDefault());
+    // Go through the characters twice, so the second time round can be answered from a cache.
+    static const SkUnichar characters[] = { 'A', 'B', 'z', 0x4E2D, 0x4E2E };
+    for (int pass = 0; pass < 2; ++pass) {
+        for (SkUnichar character : characters) {
+            SkAutoTUnref<SkTypeface> typeface(fm->matchFamilyStyleCharacter(
+                    nullptr, SkFontStyle(), nullptr, 0, character));
+            if (!typeface) {
+                continue;
+            }
+            uint16_t glyph = 0;
+            typeface->charsToGlyphs(&character, SkTypeface::kUTF32_Encoding, &glyph, 1);
+            REPORTER_ASSERT(reporter, glyph != 0);
+        }
+    }
+}
+
 DEFINE_bool(verboseFontMgr, false, "run verbose fontmgr tests.");
 
 DEF_TEST(FontMgr, reporter) {
@@ -708,4 +726,5 @@ DEF_TEST(FontMgr, reporter) {
     test_fontiter(reporter, FLAGS_verboseFontMgr);
     test_alias_names(reporter);
     test_font(reporter);
+    test_matchCharacter(reporter);
 }
@@ -467,4 +467,14 @@ DEF_GPUTEST(GLPrograms, reporter, /*factory*/) {
                                      &is_other_rendering_gl_context_type, reporter, &debugFactory);
 }
 
+// Programs whose links finish in parallel are only checked when they're first drawn with.
+DEF_GPUTEST(GLPrograms_ParallelShaderCompile, reporter, /*factory*/) {
+    GrContextOptions opts;
+    opts.fSuppressPrints = true;
+    opts.fParallelShaderCompile = true;
+    sk_gpu_test::GrContextFactory parallelFactory(opts);
+    skiatest::RunWithGPUTestContexts(test_glprograms_native, &is_native_gl_context_type,
+                                     reporter, &parallelFactory);
+}
+
 #endif
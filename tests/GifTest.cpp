@@ -227,3 +227,50 @@ DEF_TEST(Gif_Sampled, r) {
             bm.rowBytes(), &options);
     REPORTER_ASSERT(r, result == SkCodec::kSuccess);
 }
+
+DEF_TEST(Gif_Frames, r) {
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromStream(GetResourceAsStream("test640x479.gif")));
+    REPORTER_ASSERT(r, codec);
+    if (!codec) {
+        return;
+    }
+
+    // Four full size frames, each partly transparent and drawn on top of the last.
+    std::vector<SkCodec::FrameInfo> frames = codec->getFrameInfo();
+    REPORTER_ASSERT(r, 4 == frames.size() && 4 == codec->getFrameCount());
+    for (size_t i = 0; i < frames.size(); i++) {
+        REPORTER_ASSERT(r, 200 == frames[i].fDuration);
+        REPORTER_ASSERT(r, (0 == i ? SkCodec::kNone : i - 1) == frames[i].fRequiredFrame);
+    }
+
+    const SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType);
+    SkAutoTMalloc<SkPMColor> scratch(info.width() * info.height()),
+                             prior(info.width() * info.height());
+    const size_t rowBytes = info.minRowBytes();
+
+    // Decoding the last frame from scratch should match drawing it on top of the frame before.
+    SkCodec::Options opts;
+    opts.fFrameIndex = 3;
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(info, scratch.get(), rowBytes, &opts,
+                                                             nullptr, nullptr));
+    opts.fFrameIndex = 2;
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(info, prior.get(), rowBytes, &opts,
+                                                             nullptr, nullptr));
+    REPORTER_ASSERT(r, 0 != memcmp(scratch.get(), prior.get(), info.getSafeSize(rowBytes)));
+    opts.fFrameIndex = 3;
+    opts.fHasPriorFrame = true;
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(info, prior.get(), rowBytes, &opts,
+                                                             nullptr, nullptr));
+    REPORTER_ASSERT(r, 0 == memcmp(scratch.get(), prior.get(), info.getSafeSize(rowBytes)));
+
+    opts.fFrameIndex = 4;
+    REPORTER_ASSERT(r, SkCodec::kInvalidParameters == codec->getPixels(info, prior.get(),
+                                                                       rowBytes, &opts,
+                                                                       nullptr, nullptr));
+
+    // Only the first frame can be decoded by scanline.
+    opts.fFrameIndex = 1;
+    opts.fHasPriorFrame = false;
+    REPORTER_ASSERT(r, SkCodec::kUnimplemented == codec->startScanlineDecode(info, &opts,
+                                                                        nullptr, nullptr));
+}
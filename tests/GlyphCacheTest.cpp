@@ -0,0 +1,143 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkGlyphCache.h"
+#include "SkGraphics.h"
+#include "SkStream.h"
+#include "SkSurface.h"
+#include "SkTaskGroup.h"
+#include "SkTraceMemoryDump.h"
+#include "Test.h"
+
+static const int kSizes = 8;
+
+static void draw_text(SkCanvas* canvas, int size) {
+    static const char text[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setTextSize(SkIntToScalar(10 + size));
+    canvas->clear(SK_ColorWHITE);
+    canvas->drawText(text, strlen(text), 0, 30, paint);
+}
+
+static sk_sp<SkImage> render(int size) {
+    auto surface(SkSurface::MakeRasterN32Premul(400, 40));
+    draw_text(surface->getCanvas(), size);
+    return surface->makeImageSnapshot();
+}
+
+static bool equal(SkImage* a, SkImage* b) {
+    SkBitmap bmA, bmB;
+    SkImageInfo info = SkImageInfo::MakeN32Premul(a->width(), a->height());
+    bmA.allocPixels(info);
+    bmB.allocPixels(info);
+    if (!a->readPixels(bmA.info(), bmA.getPixels(), bmA.rowBytes(), 0, 0) ||
+        !b->readPixels(bmB.info(), bmB.getPixels(), bmB.rowBytes(), 0, 0)) {
+        return false;
+    }
+    return 0 == memcmp(bmA.getPixels(), bmB.getPixels(), bmA.getSafeSize());
+}
+
+namespace {
+class LockStatsDump : public SkTraceMemoryDump {
+public:
+    LockStatsDump() : fSawContendedCount(false), fSawWaitTime(false) {}
+
+    void dumpNumericValue(const char*, const char* valueName, const char*, uint64_t) override {
+        fSawContendedCount |= 0 == strcmp(valueName, "lock_contended_count");
+        fSawWaitTime       |= 0 == strcmp(valueName, "lock_wait_time");
+    }
+    void setMemoryBacking(const char*, const char*, const char*) override {}
+    void setDiscardableMemoryBacking(const char*, const SkDiscardableMemory&) override {}
+    LevelOfDetail getRequestedDetails() const override {
+        return SkTraceMemoryDump::kLight_LevelOfDetail;
+    }
+
+    bool fSawContendedCount;
+    bool fSawWaitTime;
+};
+}
+
+DEF_TEST(GlyphCache_Threaded, r) {
+    sk_sp<SkImage> expected[kSizes];
+    for (int i = 0; i < kSizes; i++) {
+        expected[i] = render(i);
+    }
+
+    // Each thread keeps a few caches to itself.  Drawing the same text from many threads,
+    // cycling through more fonts than any one thread keeps, should draw just the same.
+    SkTaskGroup().batch(kSizes * 16, [&](int i) {
+        sk_sp<SkImage> image = render(i % kSizes);
+        REPORTER_ASSERT(r, equal(image.get(), expected[i % kSizes].get()));
+    });
+
+    // Purging frees the calling thread's caches too, and we can keep drawing after that.
+    SkGraphics::PurgeFontCache();
+    REPORTER_ASSERT(r, equal(render(0).get(), expected[0].get()));
+
+    LockStatsDump dump;
+    SkGlyphCache::DumpMemoryStatistics(&dump);
+    REPORTER_ASSERT(r, dump.fSawContendedCount);
+    REPORTER_ASSERT(r, dump.fSawWaitTime);
+}
+
+DEF_TEST(GlyphCache_Snapshot, r) {
+    static const char text[] = "Snapshots";
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setTextSize(20);
+    uint16_t glyphs[sizeof(text)];
+    int count = paint.textToGlyphs(text, strlen(text), glyphs);
+
+    SkDynamicMemoryWStream stream;
+    SkAutoTMalloc<uint8_t> expected;
+    size_t expectedSize = 0;
+    {
+        SkAutoGlyphCache cache(paint, nullptr, nullptr);
+        for (int i = 0; i < count; ++i) {
+            cache->findImage(cache->getGlyphIDMetrics(glyphs[i]));
+        }
+        cache->findPath(cache->getGlyphIDMetrics(glyphs[0]));
+        for (int i = 0; i < count; ++i) {
+            const SkGlyph& glyph = cache->getGlyphIDMetrics(glyphs[i]);
+            expected.realloc(expectedSize + glyph.computeImageSize());
+            memcpy(expected.get() + expectedSize, glyph.fImage, glyph.computeImageSize());
+            expectedSize += glyph.computeImageSize();
+        }
+        cache->writeSnapshot(&stream);
+    }
+    sk_sp<SkData> snapshot(stream.copyToData());
+
+    // A fresh strike starts out with the snapshot's glyphs.
+    SkGraphics::PurgeFontCache();
+    {
+        SkAutoGlyphCache cache(paint, nullptr, nullptr);
+        REPORTER_ASSERT(r, 0 == cache->countCachedGlyphs());
+        REPORTER_ASSERT(r, cache->loadSnapshot(snapshot));
+        REPORTER_ASSERT(r, cache->countCachedGlyphs() > 0);
+
+        size_t offset = 0;
+        for (int i = 0; i < count; ++i) {
+            const SkGlyph& glyph = cache->getGlyphIDMetrics(glyphs[i]);
+            REPORTER_ASSERT(r, !glyph.fWidth || glyph.fImage);
+            REPORTER_ASSERT(r, 0 == memcmp(expected.get() + offset, cache->findImage(glyph),
+                                           glyph.computeImageSize()));
+            offset += glyph.computeImageSize();
+        }
+        REPORTER_ASSERT(r, offset == expectedSize);
+        REPORTER_ASSERT(r, cache->findPath(cache->getGlyphIDMetrics(glyphs[0])));
+    }
+
+    // Snapshots only load into the strike they were written for.
+    paint.setTextSize(21);
+    {
+        SkAutoGlyphCache cache(paint, nullptr, nullptr);
+        REPORTER_ASSERT(r, !cache->loadSnapshot(snapshot));
+        REPORTER_ASSERT(r, !cache->loadSnapshot(SkData::MakeSubset(snapshot.get(), 0, 8)));
+    }
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkTypes.h"
+
+#if SK_SUPPORT_GPU
+
+#include "GrAuditTrail.h"
+#include "GrContext.h"
+#include "SkCanvas.h"
+#include "SkPaint.h"
+#include "SkRRect.h"
+#include "SkSurface.h"
+#include "Test.h"
+
+// Interleaved circles and rounded rects, stroked or not, like a chart's dots and bars, should all
+// land in a single batch. Fills would be taken by instanced rendering where it is supported, so
+// every shape here is at least stroked.
+DEF_GPUTEST_FOR_RENDERING_CONTEXTS(GpuOvalRendererCombinesShapes, reporter, ctxInfo) {
+    GrContext* context = ctxInfo.grContext();
+    SkImageInfo info = SkImageInfo::MakeN32Premul(256, 256);
+    auto surface(SkSurface::MakeRenderTarget(context, SkBudgeted::kNo, info, 0, nullptr));
+    if (!surface) {
+        return;
+    }
+    SkCanvas* canvas = surface->getCanvas();
+    canvas->clear(SK_ColorWHITE);
+    canvas->flush();
+
+    GrAuditTrail* auditTrail = context->getAuditTrail();
+    auditTrail->setEnabled(true);
+    auditTrail->fullReset();
+
+    SkPaint strokeAndFill;
+    strokeAndFill.setAntiAlias(true);
+    strokeAndFill.setStyle(SkPaint::kStrokeAndFill_Style);
+    strokeAndFill.setStrokeWidth(2);
+    strokeAndFill.setColor(SK_ColorBLUE);
+
+    SkPaint stroke(strokeAndFill);
+    stroke.setStyle(SkPaint::kStroke_Style);
+    stroke.setColor(SK_ColorRED);
+
+    static const int kColumns = 8;
+    for (int i = 0; i < kColumns; ++i) {
+        SkScalar x = SkIntToScalar(8 + 30 * i);
+        canvas->drawCircle(x + 10, 20, 8, strokeAndFill);
+        canvas->drawRRect(SkRRect::MakeRectXY(SkRect::MakeXYWH(x, 40, 20, 60), 5, 5), stroke);
+        canvas->drawCircle(x + 10, 120, 8, stroke);
+        canvas->drawRRect(SkRRect::MakeRectXY(SkRect::MakeXYWH(x, 140, 20, 60), 4, 8),
+                          strokeAndFill);
+    }
+
+    const GrAuditTrail::CombineStats& stats = auditTrail->combineStats();
+    REPORTER_ASSERT(reporter, 4 * kColumns == stats.fBatchesAdded);
+    REPORTER_ASSERT(reporter, stats.fBatchesAdded - 1 == stats.combined());
+
+    canvas->flush();
+    auditTrail->fullReset();
+    auditTrail->setEnabled(false);
+}
+
+#endif
@@ -30,18 +30,31 @@ static void test_rectanizer_basic(skiatest::Reporter* reporter, GrRectanizer* re
     REPORTER_ASSERT(reporter, rectanizer->percentFull() == 0.0f);
 }
 
-static void test_rectanizer_inserts(skiatest::Reporter*,
-                                    GrRectanizer* rectanizer,
-                                    const SkTDArray<SkISize>& rects) {
-    int i;
-    for (i = 0; i < rects.count(); ++i) {
+// Insert rects until the first failure (or, like an atlas, past failures when keepGoing),
+// checking that every placement is in bounds and disjoint from the others. Returns how full
+// the rectanizer got.
+static float test_rectanizer_inserts(skiatest::Reporter* reporter,
+                                     GrRectanizer* rectanizer,
+                                     const SkTDArray<SkISize>& rects,
+                                     bool keepGoing = false) {
+    const SkIRect bounds = SkIRect::MakeWH(rectanizer->width(), rectanizer->height());
+    SkTDArray<SkIRect> placed;
+    for (int i = 0; i < rects.count(); ++i) {
         SkIPoint16 loc;
         if (!rectanizer->addRect(rects[i].fWidth, rects[i].fHeight, &loc)) {
+            if (keepGoing) {
+                continue;
+            }
             break;
         }
+        SkIRect r = SkIRect::MakeXYWH(loc.fX, loc.fY, rects[i].fWidth, rects[i].fHeight);
+        REPORTER_ASSERT(reporter, bounds.contains(r));
+        for (int j = 0; j < placed.count(); ++j) {
+            REPORTER_ASSERT(reporter, !SkIRect::Intersects(r, placed[j]));
+        }
+        *placed.append() = r;
     }
-
-    //SkDebugf("\n***%d %f\n", i, rectanizer->percentFull());
+    return rectanizer->percentFull();
 }
 
 static void test_skyline(skiatest::Reporter* reporter, const SkTDArray<SkISize>& rects) {
@@ -58,6 +71,20 @@ static void test_pow2(skiatest::Reporter* reporter, const SkTDArray<SkISize>& re
     test_rectanizer_inserts(reporter, &pow2Rectanizer, rects);
 }
 
+// Glyph-sized rects of mixed heights leave holes under the skyline; reusing them should let
+// the skyline rectanizer fill most of a glyph-atlas-sized plot.
+static void test_skyline_density(skiatest::Reporter* reporter) {
+    SkTDArray<SkISize> rects;
+    SkRandom rand;
+    for (int i = 0; i < 1000; i++) {
+        rects.push(SkISize::Make(rand.nextRangeU(4, 40), rand.nextRangeU(8, 40)));
+    }
+
+    GrRectanizerSkyline skylineRectanizer(256, 256);
+    float full = test_rectanizer_inserts(reporter, &skylineRectanizer, rects, true);
+    REPORTER_ASSERT(reporter, full > 0.92f);
+}
+
 DEF_GPUTEST(GpuRectanizer, reporter, factory) {
     SkTDArray<SkISize> rects;
     SkRandom rand;
@@ -69,6 +96,7 @@ DEF_GPUTEST(GpuRectanizer, reporter, factory) {
 
     test_skyline(reporter, rects);
     test_pow2(reporter, rects);
+    test_skyline_density(reporter);
 }
 
 #endif
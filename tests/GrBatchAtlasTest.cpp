@@ -0,0 +1,99 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+
+// This is a GPU-backend specific test
+#if SK_SUPPORT_GPU
+#include "GrBatchAtlas.h"
+#include "GrBatchFlushState.h"
+#include "GrContext.h"
+#include "GrResourceProvider.h"
+#include "SkTemplates.h"
+
+static const int kPlotSize = 32;
+static const int kNumPlotsXY = 2;
+static const int kNumPlots = kNumPlotsXY * kNumPlotsXY;
+static const int kAtlasSize = kPlotSize * kNumPlotsXY;
+
+static void count_evictions(GrBatchAtlas::AtlasID, void* data) {
+    ++*static_cast<int*>(data);
+}
+
+// Each entry fills a whole plot, so the atlas can only take a new one by sharing nothing.
+static bool add_plot_sized_entry(GrBatchAtlas* atlas, GrDrawBatch::Target* target,
+                                 const uint8_t* image, GrBatchAtlas::AtlasID* id) {
+    SkIPoint16 loc;
+    if (!atlas->addToAtlas(id, target, kPlotSize, kPlotSize, image, &loc)) {
+        return false;
+    }
+    // Claim the plot for the draw being prepared, so it can't be evicted before that draw flushes.
+    atlas->setLastUseToken(*id, target->nextDrawToken());
+    return true;
+}
+
+DEF_GPUTEST_FOR_RENDERING_CONTEXTS(BatchAtlas_MultiplePages, reporter, ctxInfo) {
+    GrContext* context = ctxInfo.grContext();
+    GrResourceProvider* resourceProvider = context->resourceProvider();
+
+    int evictions = 0;
+    SkAutoTDelete<GrBatchAtlas> atlas(resourceProvider->createAtlas(kAlpha_8_GrPixelConfig,
+                                                                    kAtlasSize, kAtlasSize,
+                                                                    kNumPlotsXY, kNumPlotsXY,
+                                                                    count_evictions, &evictions,
+                                                                    2));
+    if (!atlas) {
+        ERRORF(reporter, "Could not create atlas.");
+        return;
+    }
+
+    GrBatchFlushState flushState(context->getGpu(), resourceProvider);
+    // The atlas only touches the batch to schedule inline uploads, and every plot here stays
+    // claimed by the draw being prepared, so the atlas never reaches that path.
+    GrDrawBatch::Target target(&flushState, nullptr);
+
+    SkAutoTMalloc<uint8_t> image(kPlotSize * kPlotSize);
+    memset(image.get(), 0xff, kPlotSize * kPlotSize);
+
+    // Fill every plot of the first page.
+    GrBatchAtlas::AtlasID ids[2 * kNumPlots];
+    for (int i = 0; i < kNumPlots; ++i) {
+        REPORTER_ASSERT(reporter, add_plot_sized_entry(atlas, &target, image.get(), &ids[i]));
+        REPORTER_ASSERT(reporter, 0 == GrBatchAtlas::GetPageIndexFromID(ids[i]));
+    }
+    REPORTER_ASSERT(reporter, 1 == atlas->numPages());
+
+    // Nothing on the first page has been flushed, so the next entry must go on a second page
+    // rather than evicting anything.
+    for (int i = kNumPlots; i < 2 * kNumPlots; ++i) {
+        REPORTER_ASSERT(reporter, add_plot_sized_entry(atlas, &target, image.get(), &ids[i]));
+        REPORTER_ASSERT(reporter, 1 == GrBatchAtlas::GetPageIndexFromID(ids[i]));
+    }
+    REPORTER_ASSERT(reporter, 2 == atlas->numPages());
+    REPORTER_ASSERT(reporter, 0 == evictions);
+    for (int i = 0; i < 2 * kNumPlots; ++i) {
+        REPORTER_ASSERT(reporter, atlas->hasID(ids[i]));
+    }
+
+    // Both pages are full and still in use, and the atlas may not grow a third.
+    GrBatchAtlas::AtlasID id;
+    REPORTER_ASSERT(reporter, !add_plot_sized_entry(atlas, &target, image.get(), &id));
+    REPORTER_ASSERT(reporter, 2 == atlas->numPages());
+
+    // Once the draw using them has flushed, the least recently used plot (the first page's first
+    // entry) is evicted and reused, and no page is added.
+    flushState.issueDrawToken();
+    flushState.flushToken();
+    REPORTER_ASSERT(reporter, add_plot_sized_entry(atlas, &target, image.get(), &id));
+    REPORTER_ASSERT(reporter, 0 == GrBatchAtlas::GetPageIndexFromID(id));
+    REPORTER_ASSERT(reporter, 2 == atlas->numPages());
+    REPORTER_ASSERT(reporter, 1 == evictions);
+    REPORTER_ASSERT(reporter, !atlas->hasID(ids[0]));
+    REPORTER_ASSERT(reporter, atlas->hasID(id));
+}
+
+#endif
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+#if SK_SUPPORT_GPU
+
+#include "GrBatchBoundsIndex.h"
+#include "SkRandom.h"
+
+#include <climits>
+
+static SkRect random_rect(SkRandom* rand) {
+    // Mostly on a typical render target, with some off of it and some larger than the grid.
+    SkScalar x = rand->nextRangeScalar(-200, 3000),
+             y = rand->nextRangeScalar(-200, 3000);
+    SkScalar w = rand->nextBool() ? rand->nextRangeScalar(0, 64) : rand->nextRangeScalar(0, 6000),
+             h = rand->nextBool() ? rand->nextRangeScalar(0, 64) : rand->nextRangeScalar(0, 6000);
+    return SkRect::MakeXYWH(x, y, w, h);
+}
+
+DEF_TEST(GrBatchBoundsIndex, reporter) {
+    SkRandom rand;
+    GrBatchBoundsIndex index;
+    SkTDArray<SkRect> bounds;
+
+    for (int round = 0; round < 2; round++) {
+        index.reset();
+        bounds.rewind();
+        for (int i = 0; i < 300; i++) {
+            // Now and then grow an earlier batch, like combining does.
+            if (i > 0 && rand.nextU() % 4 == 0) {
+                int grown = rand.nextULessThan(bounds.count());
+                bounds[grown].join(random_rect(&rand));
+                index.set(grown, bounds[grown]);
+            } else {
+                *bounds.append() = random_rect(&rand);
+                index.set(bounds.count() - 1, bounds.top());
+            }
+
+            SkRect query = random_rect(&rand);
+            int after = rand.nextULessThan(bounds.count());
+
+            int last = -1,
+                first = INT_MAX;
+            for (int j = 0; j < bounds.count(); j++) {
+                if (GrBatchBoundsIndex::Overlap(bounds[j], query)) {
+                    last = j;
+                    if (j > after && first == INT_MAX) {
+                        first = j;
+                    }
+                }
+            }
+            REPORTER_ASSERT(reporter, last == index.lastOverlap(query));
+            REPORTER_ASSERT(reporter, first == index.firstOverlapAfter(after, query));
+        }
+    }
+}
+
+#endif
@@ -227,4 +227,54 @@ DEF_TEST(GrMemoryPool, reporter) {
     }
 }
 
+DEF_TEST(GrSizeClassPool, reporter) {
+    GrSizeClassPool pool(4096);
+    SkRandom r;
+
+    // Fill allocations of assorted sizes, including ones too big for a size class, with a value
+    // derived from their index, release them in random order, and do it again.
+    static const int kCount = 1000;
+    void* allocs[kCount];
+    size_t sizes[kCount];
+    size_t reserved = 0;
+    for (int pass = 0; pass < 3; ++pass) {
+        for (int i = 0; i < kCount; ++i) {
+            sizes[i] = 0 == i % 100 ? r.nextRangeU(2049, 10000) : r.nextRangeU(0, 300);
+            allocs[i] = pool.allocate(sizes[i]);
+            REPORTER_ASSERT(reporter, !(reinterpret_cast<intptr_t>(allocs[i]) % 8));
+            memset(allocs[i], i & 0xFF, sizes[i]);
+        }
+        REPORTER_ASSERT(reporter, !pool.isEmpty());
+        REPORTER_ASSERT(reporter, pool.liveBytes() <= pool.highWaterBytes());
+        const size_t peakReserved = pool.reservedBytes();
+        for (int i = 0; i < kCount; ++i) {
+            int j = r.nextRangeU(i, kCount - 1);
+            SkTSwap(allocs[i], allocs[j]);
+            SkTSwap(sizes[i], sizes[j]);
+        }
+        for (int i = 0; i < kCount; ++i) {
+            const uint8_t* bytes = static_cast<const uint8_t*>(allocs[i]);
+            for (size_t b = 0; b < sizes[i]; ++b) {
+                if (bytes[b] != bytes[0]) {
+                    ERRORF(reporter, "Allocation %d was overwritten.", i);
+                    break;
+                }
+            }
+            pool.release(allocs[i]);
+        }
+        REPORTER_ASSERT(reporter, pool.isEmpty());
+        REPORTER_ASSERT(reporter, 0 == pool.liveBytes());
+        // Emptying the pool frees all but a few of the slabs it grew to.
+        reserved = pool.reservedBytes();
+        REPORTER_ASSERT(reporter, reserved > 0 && reserved < peakReserved);
+    }
+
+    // Once warmed up, allocating what was allocated before reuses freed memory.
+    void* a = pool.allocate(100);
+    void* b = pool.allocate(200);
+    REPORTER_ASSERT(reporter, reserved == pool.reservedBytes());
+    pool.release(a);
+    pool.release(b);
+}
+
 #endif
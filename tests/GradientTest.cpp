@@ -9,6 +9,7 @@
 #include "SkColorPriv.h"
 #include "SkColorShader.h"
 #include "SkGradientShader.h"
+#include "SkGradientShaderPriv.h"
 #include "SkShader.h"
 #include "SkSurface.h"
 #include "SkTemplates.h"
@@ -253,6 +254,109 @@ static void test_clamping_overflow(skiatest::Reporter*) {
     // Passes if we don't trigger asserts.
 }
 
+// The 4f contexts compute t in floats, four pixels at a time, where the legacy contexts look
+// colors up in a 256 entry cache, a few levels apart on steep ramps.  Apart from tiling seams
+// and the edges of a two point conical's cone, where a pixel can land on either side, they
+// should agree closely.
+static void test_4f_matches_legacy(skiatest::Reporter* reporter) {
+    const int kSize = 64;
+    static const SkColor colors[] = { SK_ColorRED, 0x8000FF00, SK_ColorBLUE, SK_ColorBLACK };
+    static const SkScalar pos[] = { 0, 0.4f, 0.6f, 1 };
+    const SkPoint center = { 30.3f, 33.7f };
+
+    typedef sk_sp<SkShader> (*MakeProc)(SkShader::TileMode, uint32_t flags, const SkMatrix*);
+    const MakeProc makers[] = {
+        [](SkShader::TileMode mode, uint32_t flags, const SkMatrix* lm) {
+            return SkGradientShader::MakeRadial({ 30.3f, 33.7f }, 20, colors, pos, 4, mode,
+                                                flags, lm);
+        },
+        [](SkShader::TileMode, uint32_t flags, const SkMatrix* lm) {
+            return SkGradientShader::MakeSweep(30.3f, 33.7f, colors, pos, 4, flags, lm);
+        },
+        // Well-behaved: one circle inside the other.
+        [](SkShader::TileMode mode, uint32_t flags, const SkMatrix* lm) {
+            return SkGradientShader::MakeTwoPointConical({ 28, 30 }, 3, { 34, 36 }, 25, colors,
+                                                         pos, 4, mode, flags, lm);
+        },
+        // A cone, leaving part of the plane undrawn, and flipped.
+        [](SkShader::TileMode mode, uint32_t flags, const SkMatrix* lm) {
+            return SkGradientShader::MakeTwoPointConical({ 10, 20 }, 12, { 40, 44 }, 4, colors,
+                                                         pos, 4, mode, flags, lm);
+        },
+    };
+    const SkShader::TileMode modes[] = {
+        SkShader::kClamp_TileMode, SkShader::kRepeat_TileMode, SkShader::kMirror_TileMode,
+    };
+    SkMatrix rotate;
+    rotate.setRotate(30, center.x(), center.y());
+    const SkMatrix* localMatrices[] = { nullptr, &rotate };
+
+    for (const MakeProc& make : makers) {
+        for (SkShader::TileMode mode : modes) {
+            for (const SkMatrix* lm : localMatrices) {
+                SkBitmap bitmaps[2];
+                for (int i = 0; i < 2; ++i) {
+                    bitmaps[i].allocN32Pixels(kSize, kSize);
+                    bitmaps[i].eraseColor(SK_ColorTRANSPARENT);
+                    SkCanvas canvas(bitmaps[i]);
+                    SkPaint paint;
+                    paint.setShader(make(mode,
+                                         i ? SkGradientShaderBase::kForce4fContext_PrivateFlag : 0,
+                                         lm));
+                    canvas.drawPaint(paint);
+                }
+
+                int offPixels = 0;
+                for (int y = 0; y < kSize; ++y) {
+                    for (int x = 0; x < kSize; ++x) {
+                        SkPMColor a = *bitmaps[0].getAddr32(x, y),
+                                  b = *bitmaps[1].getAddr32(x, y);
+                        int diff = 0;
+                        for (int shift = 0; shift < 32; shift += 8) {
+                            diff = SkTMax(diff, SkAbs32((int)((a >> shift) & 0xFF) -
+                                                        (int)((b >> shift) & 0xFF)));
+                        }
+                        offPixels += diff > 8;
+                    }
+                }
+                REPORTER_ASSERT(reporter, offPixels <= kSize * kSize / 100);
+            }
+        }
+    }
+}
+
+static uint32_t table_gen_id(SkColor c) {
+    const SkPoint pts[] = {{ 0, 0 }, { 10, 0 }};
+    const SkColor colors[] = { c, SK_ColorWHITE, SK_ColorBLACK, c };
+    sk_sp<SkShader> shader(SkGradientShader::MakeLinear(pts, colors, nullptr, 4,
+                                                        SkShader::kClamp_TileMode));
+    SkBitmap table;
+    static_cast<SkGradientShaderBase*>(shader.get())->getGradientTableBitmap(&table);
+    return table.getGenerationID();
+}
+
+// Well past the old fixed budget of 32, distinct gradients built again find their old tables.
+static void test_table_cache(skiatest::Reporter* reporter) {
+    const int kCount = 100;
+    const int prevLimit = SkGradientShader::SetTableCacheCountLimit(kCount);
+
+    uint32_t ids[kCount];
+    for (int i = 0; i < kCount; ++i) {
+        ids[i] = table_gen_id(SkColorSetARGB(0xFF, i, 0x80, 0x40));
+    }
+    for (int i = 0; i < kCount; ++i) {
+        REPORTER_ASSERT(reporter, ids[i] == table_gen_id(SkColorSetARGB(0xFF, i, 0x80, 0x40)));
+    }
+
+    // Shrinking the limit purges the least recently used tables.
+    REPORTER_ASSERT(reporter, kCount == SkGradientShader::SetTableCacheCountLimit(8));
+    REPORTER_ASSERT(reporter, ids[0] != table_gen_id(SkColorSetARGB(0xFF, 0, 0x80, 0x40)));
+    REPORTER_ASSERT(reporter, ids[kCount - 1] ==
+                              table_gen_id(SkColorSetARGB(0xFF, kCount - 1, 0x80, 0x40)));
+
+    SkGradientShader::SetTableCacheCountLimit(prevLimit);
+}
+
 DEF_TEST(Gradient, reporter) {
     TestGradientShaders(reporter);
     TestConstantGradient(reporter);
@@ -261,4 +365,6 @@ DEF_TEST(Gradient, reporter) {
     test_linear_fuzz(reporter);
     test_two_point_conical_zero_radius(reporter);
     test_clamping_overflow(reporter);
+    test_4f_matches_legacy(reporter);
+    test_table_cache(reporter);
 }
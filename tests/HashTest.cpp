@@ -7,6 +7,7 @@
 
 #include "SkChecksum.h"
 #include "SkString.h"
+#include "SkTFlatHash.h"
 #include "SkTHash.h"
 #include "Test.h"
 
@@ -154,3 +155,79 @@ DEF_TEST(HashSetCopyCounter, r) {
     // We allow copies for same-value adds for now.
     REPORTER_ASSERT(r, globalCounter == 5);
 }
+
+namespace {
+
+struct FlatEntry {
+    int fKey;
+    int fVal;
+
+    static int GetKey(const FlatEntry& e) { return e.fKey; }
+    // Only 5 distinct hashes, so keys share groups and spill into later ones.
+    static uint32_t Hash(int key) { return SkChecksum::Mix(key % 5); }
+};
+
+}
+
+DEF_TEST(FlatHashTable, r) {
+    SkTFlatHashTable<FlatEntry, int> table;
+    const SkTFlatHashTable<FlatEntry, int>& constTable = table;
+    REPORTER_ASSERT(r, !table.find(0));
+
+    // Checks the table against a plain SkTHashMap.
+    SkTHashMap<int, int> expected;
+    auto check = [&] {
+        REPORTER_ASSERT(r, table.count() == expected.count());
+        for (int key = -1; key < 300; key++) {
+            FlatEntry* found = table.find(key);
+            int* want = expected.find(key);
+            REPORTER_ASSERT(r, SkToBool(found) == SkToBool(want));
+            if (found && want) {
+                REPORTER_ASSERT(r, found->fKey == key && found->fVal == *want);
+            }
+        }
+        int n = 0;
+        constTable.foreach([&](const FlatEntry& e) {
+            REPORTER_ASSERT(r, expected.find(e.fKey) && *expected.find(e.fKey) == e.fVal);
+            n++;
+        });
+        REPORTER_ASSERT(r, n == expected.count());
+    };
+
+    for (int key = 0; key < 200; key++) {
+        FlatEntry* e = table.set({key, key * 3});
+        REPORTER_ASSERT(r, e->fKey == key);
+        expected.set(key, key * 3);
+    }
+    check();
+    REPORTER_ASSERT(r, table.approxBytesUsed() > 0);
+
+    // Overwriting keeps one entry per key.
+    for (int key = 0; key < 200; key += 7) {
+        table.set({key, -key});
+        expected.set(key, -key);
+    }
+    check();
+
+    // Churn through removes and re-adds, which leave removed slots behind to be reused.
+    for (int round = 0; round < 10; round++) {
+        for (int key = round; key < 200; key += 3) {
+            if (expected.find(key)) {
+                table.remove(key);
+                expected.remove(key);
+            }
+        }
+        for (int key = 100 + round * 10; key < 110 + round * 10; key++) {
+            table.set({key, round});
+            expected.set(key, round);
+        }
+        check();
+    }
+
+    table.foreach([](FlatEntry* e) { e->fVal = 0; });
+    constTable.foreach([&](const FlatEntry& e) { REPORTER_ASSERT(r, 0 == e.fVal); });
+
+    table.reset();
+    REPORTER_ASSERT(r, table.count() == 0);
+    REPORTER_ASSERT(r, !table.find(0));
+}
@@ -137,6 +137,25 @@ DEF_TEST(ImageCache, reporter) {
     }
 }
 
+DEF_TEST(ImageCache_purgeToBytes, r) {
+    SkResourceCache cache(4096);
+    for (int i = 0; i < COUNT; ++i) {
+        cache.add(new TestingRec(TestingKey(i), i));
+    }
+    const size_t recBytes = cache.getTotalBytesUsed() / COUNT;
+
+    // The least recently used Recs go first, and the limit is unchanged.
+    cache.purgeToBytes(recBytes * COUNT / 2);
+    REPORTER_ASSERT(r, recBytes * COUNT / 2 == cache.getTotalBytesUsed());
+    REPORTER_ASSERT(r, 4096 == cache.getTotalByteLimit());
+    intptr_t value;
+    REPORTER_ASSERT(r, !cache.find(TestingKey(0), TestingRec::Visitor, &value));
+    REPORTER_ASSERT(r, cache.find(TestingKey(COUNT - 1), TestingRec::Visitor, &value));
+
+    cache.purgeToBytes(0);
+    REPORTER_ASSERT(r, 0 == cache.getTotalBytesUsed());
+}
+
 DEF_TEST(ImageCache_doubleAdd, r) {
     // Adding the same key twice should be safe.
     SkResourceCache cache(4096);
@@ -151,3 +170,51 @@ DEF_TEST(ImageCache_doubleAdd, r) {
     REPORTER_ASSERT(r, cache.find(key, TestingRec::Visitor, &value));
     REPORTER_ASSERT(r, 2 == value || 3 == value);
 }
+
+#include "SkTaskGroup.h"
+#include "SkTraceMemoryDump.h"
+
+namespace {
+// Adds up the find_hits SkShardedResourceCache::dumpMemoryStatistics() reports for each shard.
+class ShardStatsDump : public SkTraceMemoryDump {
+public:
+    ShardStatsDump() : fFindHits(0) {}
+
+    void dumpNumericValue(const char* dumpName, const char* valueName, const char* units,
+                          uint64_t value) override {
+        if (strstr(dumpName, "/shard_") && 0 == strcmp(valueName, "find_hits")) {
+            fFindHits += value;
+        }
+    }
+    void setMemoryBacking(const char*, const char*, const char*) override {}
+    void setDiscardableMemoryBacking(const char*, const SkDiscardableMemory&) override {}
+    LevelOfDetail getRequestedDetails() const override {
+        return SkTraceMemoryDump::kObjectsBreakdowns_LevelOfDetail;
+    }
+
+    uint64_t fFindHits;
+};
+}
+
+DEF_TEST(ImageCache_sharded, r) {
+    // A sharded cache should behave just like one cache, even when used from many threads at
+    // once.  This uses its own, so nothing else can purge it out from under us.
+    static const int N = 64;
+    SkShardedResourceCache cache(1024 * 1024);
+
+    SkTaskGroup().batch(N, [&](int i) {
+        cache.add(new TestingRec(TestingKey(i), i));
+
+        intptr_t value = -1;
+        REPORTER_ASSERT(r, cache.find(TestingKey(i), TestingRec::Visitor, &value));
+        REPORTER_ASSERT(r, i == value);
+    });
+    REPORTER_ASSERT(r, N * TestingRec(TestingKey(0), 0).bytesUsed() == cache.getTotalBytesUsed());
+
+    ShardStatsDump dump;
+    cache.dumpMemoryStatistics(&dump);
+    REPORTER_ASSERT(r, N == dump.fFindHits);
+
+    cache.purgeAll();
+    REPORTER_ASSERT(r, 0 == cache.getTotalBytesUsed());
+}
@@ -8,6 +8,7 @@
 #include "Test.h"
 
 #include "SkBitmap.h"
+#include "SkBlurImageFilter.h"
 #include "SkImage.h"
 #include "SkImageFilter.h"
 #include "SkImageFilterCache.h"
@@ -175,6 +176,74 @@ DEF_TEST(ImageFilterCache_ImageBackedRaster, reporter) {
     test_image_backed(reporter, srcImage);
 }
 
+// Results filtered from one raster image are found again for another with the same pixels, as
+// when a layer is redrawn next frame, even if the clip moves while it still holds the whole blur.
+DEF_TEST(ImageFilterCache_ContentKeyed, reporter) {
+    static const size_t kCacheSize = 1000000;
+    SkAutoTUnref<SkImageFilterCache> cache(SkImageFilterCache::Create(kCacheSize));
+    sk_sp<SkImageFilter> blur(SkBlurImageFilter::Make(2, 2, nullptr));
+
+    auto make_image = [](SkColor color) {
+        SkBitmap bm = create_bm();
+        bm.eraseArea(SkIRect::MakeXYWH(kPad, kPad, kSmallerSize, kSmallerSize), color);
+        return SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(kFullSize, kFullSize), bm);
+    };
+    sk_sp<SkSpecialImage> frame1(make_image(SK_ColorRED)),
+                          frame2(make_image(SK_ColorRED)),
+                          other(make_image(SK_ColorBLUE));
+    REPORTER_ASSERT(reporter, frame1->uniqueID() != frame2->uniqueID());
+
+    const SkIRect clip = SkIRect::MakeLTRB(-50, -50, 100, 100);
+    SkImageFilter::Context ctx(SkMatrix::I(), clip, cache);
+    SkIPoint offset1, offset2;
+    sk_sp<SkSpecialImage> result1(blur->filterImageTiled(frame1.get(), ctx, &offset1));
+    REPORTER_ASSERT(reporter, result1);
+    REPORTER_ASSERT(reporter, 0 == cache->hitCount() && 1 == cache->missCount());
+
+    SkImageFilter::Context moved(SkMatrix::I(), SkIRect::MakeLTRB(-70, -20, 80, 130), cache);
+    sk_sp<SkSpecialImage> result2(blur->filterImageTiled(frame2.get(), moved, &offset2));
+    REPORTER_ASSERT(reporter, 1 == cache->hitCount() && 1 == cache->missCount());
+    REPORTER_ASSERT(reporter, result1 == result2 && offset1 == offset2);
+
+    // Different content, a different scale, or a clip cutting into the blur all miss.
+    SkImageFilter::Context scaled(SkMatrix::MakeScale(2), clip, cache),
+                           cut(SkMatrix::I(), SkIRect::MakeWH(10, 10), cache);
+    blur->filterImageTiled(other.get(), ctx, &offset2);
+    blur->filterImageTiled(frame2.get(), scaled, &offset2);
+    blur->filterImageTiled(frame2.get(), cut, &offset2);
+    REPORTER_ASSERT(reporter, 1 == cache->hitCount() && 4 == cache->missCount());
+}
+
+// Immutable sources keep their IDs, so their results are keyed by ID and subset, sharing
+// filterImage()'s entries, and the same pixels under another ID aren't found.
+DEF_TEST(ImageFilterCache_IDKeyed, reporter) {
+    static const size_t kCacheSize = 1000000;
+    SkAutoTUnref<SkImageFilterCache> cache(SkImageFilterCache::Create(kCacheSize));
+    sk_sp<SkImageFilter> blur(SkBlurImageFilter::Make(2, 2, nullptr));
+
+    auto make_image = []() {
+        SkBitmap bm = create_bm();
+        bm.setImmutable();
+        return SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(kFullSize, kFullSize), bm);
+    };
+    sk_sp<SkSpecialImage> image(make_image()),
+                          copy(make_image());
+    REPORTER_ASSERT(reporter, image->uniqueID() != copy->uniqueID());
+
+    SkImageFilter::Context ctx(SkMatrix::I(), SkIRect::MakeLTRB(-50, -50, 100, 100), cache);
+    SkIPoint offset1, offset2;
+    sk_sp<SkSpecialImage> result1(blur->filterImageTiled(image.get(), ctx, &offset1));
+    REPORTER_ASSERT(reporter, result1);
+    REPORTER_ASSERT(reporter, 0 == cache->hitCount() && 1 == cache->missCount());
+
+    sk_sp<SkSpecialImage> result2(blur->filterImage(image.get(), ctx, &offset2));
+    REPORTER_ASSERT(reporter, 1 == cache->hitCount() && 1 == cache->missCount());
+    REPORTER_ASSERT(reporter, result1 == result2 && offset1 == offset2);
+
+    blur->filterImageTiled(copy.get(), ctx, &offset2);
+    REPORTER_ASSERT(reporter, 1 == cache->hitCount() && 2 == cache->missCount());
+}
+
 #if SK_SUPPORT_GPU
 #include "GrContext.h"
 
@@ -28,6 +28,7 @@
 #include "SkPictureImageFilter.h"
 #include "SkPictureRecorder.h"
 #include "SkPoint3.h"
+#include "SkRandom.h"
 #include "SkReadBuffer.h"
 #include "SkRect.h"
 #include "SkSpecialImage.h"
@@ -35,6 +36,7 @@
 #include "SkSurface.h"
 #include "SkTableColorFilter.h"
 #include "SkTileImageFilter.h"
+#include "SkUnPreMultiply.h"
 #include "SkXfermodeImageFilter.h"
 #include "Test.h"
 
@@ -1861,3 +1863,246 @@ DEF_TEST(ImageFilterComplexCTM, reporter) {
         REPORTER_ASSERT(reporter, canHandle == rec.fExpectCanHandle);
     }
 }
+
+// Counts the pixels in "area" (in the images' common space) where a and b differ, treating
+// anything outside an image as transparent black.
+static int count_mismatches(SkSpecialImage* a, const SkIPoint& aOffset,
+                            SkSpecialImage* b, const SkIPoint& bOffset, const SkIRect& area) {
+    SkBitmap abm, bbm;
+    if (!a->getROPixels(&abm) || !b->getROPixels(&bbm)) {
+        return area.width() * area.height();
+    }
+    SkAutoLockPixels lockA(abm), lockB(bbm);
+    auto pixel = [](const SkBitmap& bm, int x, int y) -> SkPMColor {
+        return x >= 0 && y >= 0 && x < bm.width() && y < bm.height() ? *bm.getAddr32(x, y) : 0;
+    };
+    int mismatches = 0;
+    for (int y = area.fTop; y < area.fBottom; y++) {
+        for (int x = area.fLeft; x < area.fRight; x++) {
+            mismatches += pixel(abm, x - aOffset.x(), y - aOffset.y()) !=
+                          pixel(bbm, x - bOffset.x(), y - bOffset.y());
+        }
+    }
+    return mismatches;
+}
+
+// Tiled evaluation should match evaluating the whole DAG at once, pixel for pixel, including
+// for filters like lighting that treat the edges of their clip specially.
+DEF_TEST(ImageFilterTiledMatchesUntiled, reporter) {
+    const int kWidth = 1300, kHeight = 1100;
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(kWidth, kHeight);
+    bitmap.eraseColor(SK_ColorTRANSPARENT);
+    {
+        SkCanvas canvas(bitmap);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        SkRandom rand;
+        for (int i = 0; i < 200; i++) {
+            paint.setColor(rand.nextU() | 0xFF000000);
+            canvas.drawCircle(rand.nextRangeF(0, kWidth), rand.nextRangeF(0, kHeight),
+                              rand.nextRangeF(5, 60), paint);
+        }
+    }
+    sk_sp<SkSpecialImage> src(SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(kWidth, kHeight),
+                                                             bitmap));
+
+    sk_sp<SkImageFilter> blur(SkBlurImageFilter::Make(6, 4, nullptr));
+    sk_sp<SkImageFilter> filters[] = {
+        blur,
+        SkDilateImageFilter::Make(3, 5, blur),
+        SkLightingImageFilter::MakeDistantLitDiffuse(SkPoint3::Make(1, 1, 1), SK_ColorWHITE,
+                                                     2, 1, nullptr),
+        SkBlurImageFilter::Make(3, 3, SkLightingImageFilter::MakePointLitSpecular(
+                SkPoint3::Make(600, 500, 80), SK_ColorWHITE, 1, 1, 4, blur)),
+        SkOffsetImageFilter::Make(40, -30, blur),
+    };
+
+    // A clip that doesn't start or end on a tile boundary.
+    const SkIRect clip = SkIRect::MakeLTRB(7, 13, kWidth - 3, kHeight - 21);
+    SkImageFilter::Context ctx(SkMatrix::I(), clip, nullptr);
+    for (const sk_sp<SkImageFilter>& filter : filters) {
+        SkIPoint offset, tiledOffset;
+        sk_sp<SkSpecialImage> whole(filter->filterImage(src.get(), ctx, &offset)),
+                              tiled(filter->filterImageTiled(src.get(), ctx, &tiledOffset));
+        REPORTER_ASSERT(reporter, whole && tiled);
+        if (!whole || !tiled) {
+            continue;
+        }
+
+        // Compare within the clip; outside it the untiled result may hold anything.
+        REPORTER_ASSERT(reporter, 0 == count_mismatches(whole.get(), offset,
+                                                        tiled.get(), tiledOffset, clip));
+    }
+}
+
+// Color filter nodes feeding an xfermode or merge are applied as those draw their inputs.
+// That should look just the same as running them as nodes of their own, which we force by
+// giving them a crop rect that doesn't crop anything.
+DEF_TEST(ImageFilterFusedColorFilter, reporter) {
+    const int kSize = 64;
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(kSize, kSize);
+    bitmap.eraseColor(SK_ColorTRANSPARENT);
+    {
+        SkCanvas canvas(bitmap);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        paint.setColor(0xFF3377CC);
+        canvas.drawCircle(24, 30, 20, paint);
+        paint.setColor(0x80CC3311);
+        canvas.drawRect(SkRect::MakeLTRB(30, 10, 60, 50), paint);
+    }
+    sk_sp<SkSpecialImage> src(SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(kSize, kSize),
+                                                             bitmap));
+
+    SkImageFilter::CropRect noCrop(SkRect::MakeLTRB(-1000, -1000, 1000, 1000));
+    sk_sp<SkImageFilter> offset(SkOffsetImageFilter::Make(9, -5, nullptr));
+    sk_sp<SkXfermode> multiply(SkXfermode::Make(SkXfermode::kMultiply_Mode));
+    auto xfermode = [&](const SkImageFilter::CropRect* crop) {
+        return SkXfermodeImageFilter::Make(multiply,
+                                           make_grayscale(nullptr, crop),
+                                           make_blue(offset, crop), nullptr);
+    };
+    auto merge = [&](const SkImageFilter::CropRect* crop) {
+        return SkMergeImageFilter::Make(make_blue(nullptr, crop), make_grayscale(offset, crop));
+    };
+
+    const SkIRect clip = SkIRect::MakeLTRB(2, 3, kSize - 4, kSize - 1);
+    SkImageFilter::Context ctx(SkMatrix::I(), clip, nullptr);
+    const sk_sp<SkImageFilter> filters[][2] = {
+        { xfermode(nullptr), xfermode(&noCrop) },
+        { merge(nullptr),    merge(&noCrop)    },
+    };
+    for (const auto& pair : filters) {
+        SkIPoint fusedOffset, separateOffset;
+        sk_sp<SkSpecialImage> fused(pair[0]->filterImage(src.get(), ctx, &fusedOffset)),
+                              separate(pair[1]->filterImage(src.get(), ctx, &separateOffset));
+        REPORTER_ASSERT(reporter, fused && separate);
+        if (fused && separate) {
+            REPORTER_ASSERT(reporter, 0 == count_mismatches(fused.get(), fusedOffset,
+                                                            separate.get(), separateOffset,
+                                                            clip));
+        }
+    }
+}
+
+static SkBitmap make_random_premul_bitmap(int width, int height) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(width, height);
+    SkRandom rand;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            *bitmap.getAddr32(x, y) = SkPreMultiplyColor(rand.nextU());
+        }
+    }
+    return bitmap;
+}
+
+// The vectorized interior should match this straightforward per-channel convolution.
+DEF_TEST(ImageFilterMatrixConvolutionMatchesScalar, reporter) {
+    const int kWidth = 37, kHeight = 23;
+    SkBitmap bitmap = make_random_premul_bitmap(kWidth, kHeight);
+    sk_sp<SkSpecialImage> src(SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(kWidth, kHeight),
+                                                             bitmap));
+
+    SkRandom rand;
+    const SkISize kernelSizes[] = { SkISize::Make(3, 3), SkISize::Make(5, 2) };
+    for (const SkISize& size : kernelSizes) {
+        SkScalar kernel[10];
+        for (int i = 0; i < size.width() * size.height(); i++) {
+            kernel[i] = rand.nextRangeF(-0.5f, 0.7f);
+        }
+        const SkScalar gain = 0.9f, bias = 12;
+        const SkIPoint kernelOffset = SkIPoint::Make(1, 1);
+        for (bool convolveAlpha : { true, false }) {
+            // Cropped to the source, so clamping happens at its edges.
+            SkImageFilter::CropRect cropRect(SkRect::MakeWH(kWidth, kHeight));
+            sk_sp<SkImageFilter> filter(SkMatrixConvolutionImageFilter::Make(
+                    size, kernel, gain, bias, kernelOffset,
+                    SkMatrixConvolutionImageFilter::kClamp_TileMode, convolveAlpha, nullptr,
+                    &cropRect));
+            SkImageFilter::Context ctx(SkMatrix::I(), SkIRect::MakeWH(kWidth, kHeight), nullptr);
+            SkIPoint offset;
+            sk_sp<SkSpecialImage> result(filter->filterImage(src.get(), ctx, &offset));
+            SkBitmap resultBM;
+            REPORTER_ASSERT(reporter, result && result->getROPixels(&resultBM));
+            if (!result) {
+                continue;
+            }
+            SkAutoLockPixels lock(resultBM);
+
+            int mismatches = 0;
+            for (int y = 0; y < kHeight; y++) {
+                for (int x = 0; x < kWidth; x++) {
+                    float sum[4] = { 0, 0, 0, 0 };
+                    for (int cy = 0; cy < size.height(); cy++) {
+                        for (int cx = 0; cx < size.width(); cx++) {
+                            int sx = SkTPin(x + cx - kernelOffset.x(), 0, kWidth - 1),
+                                sy = SkTPin(y + cy - kernelOffset.y(), 0, kHeight - 1);
+                            SkPMColor s = *bitmap.getAddr32(sx, sy);
+                            if (!convolveAlpha) {
+                                // Color is convolved unpremultiplied, then premultiplied again.
+                                s = SkUnPreMultiply::PMColorToColor(s);
+                            }
+                            float k = kernel[cy * size.width() + cx];
+                            sum[0] += SkGetPackedA32(s) * k;
+                            sum[1] += SkGetPackedR32(s) * k;
+                            sum[2] += SkGetPackedG32(s) * k;
+                            sum[3] += SkGetPackedB32(s) * k;
+                        }
+                    }
+                    int c[4];
+                    for (int i = 0; i < 4; i++) {
+                        c[i] = SkTPin(SkScalarFloorToInt(sum[i] * gain + bias), 0, 255);
+                    }
+                    SkPMColor expected;
+                    if (convolveAlpha) {
+                        expected = SkPackARGB32(c[0], SkTMin(c[1], c[0]), SkTMin(c[2], c[0]),
+                                                SkTMin(c[3], c[0]));
+                    } else {
+                        expected = SkPreMultiplyARGB(SkGetPackedA32(*bitmap.getAddr32(x, y)),
+                                                     c[1], c[2], c[3]);
+                    }
+                    mismatches += expected != *resultBM.getAddr32(x - offset.x(),
+                                                                  y - offset.y());
+                }
+            }
+            REPORTER_ASSERT(reporter, 0 == mismatches);
+        }
+    }
+}
+
+// Cropping beyond the input sends lighting down its edge-checking path.  Away from the edges
+// of either result, that should agree with the vectorized unchecked path.
+DEF_TEST(ImageFilterLightingInteriorMatchesChecked, reporter) {
+    const int kWidth = 41, kHeight = 29;
+    SkBitmap bitmap = make_random_premul_bitmap(kWidth, kHeight);
+    sk_sp<SkSpecialImage> src(SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(kWidth, kHeight),
+                                                             bitmap));
+
+    SkImageFilter::CropRect beyond(SkRect::MakeLTRB(-3, -3, kWidth + 3, kHeight + 3));
+    const SkPoint3 location = SkPoint3::Make(20, 10, 30);
+    sk_sp<SkImageFilter> filters[][2] = {
+        { SkLightingImageFilter::MakePointLitDiffuse(location, SK_ColorWHITE, 2, 1, nullptr),
+          SkLightingImageFilter::MakePointLitDiffuse(location, SK_ColorWHITE, 2, 1, nullptr,
+                                                     &beyond) },
+        { SkLightingImageFilter::MakeDistantLitSpecular(location, SK_ColorCYAN, 3, 1, 8, nullptr),
+          SkLightingImageFilter::MakeDistantLitSpecular(location, SK_ColorCYAN, 3, 1, 8, nullptr,
+                                                        &beyond) },
+    };
+
+    const SkIRect interior = SkIRect::MakeLTRB(1, 1, kWidth - 1, kHeight - 1);
+    SkImageFilter::Context ctx(SkMatrix::I(), SkIRect::MakeLTRB(-10, -10, 100, 100), nullptr);
+    for (const auto& pair : filters) {
+        SkIPoint uncheckedOffset, checkedOffset;
+        sk_sp<SkSpecialImage> unchecked(pair[0]->filterImage(src.get(), ctx, &uncheckedOffset)),
+                              checked(pair[1]->filterImage(src.get(), ctx, &checkedOffset));
+        REPORTER_ASSERT(reporter, unchecked && checked);
+        if (unchecked && checked) {
+            REPORTER_ASSERT(reporter, 0 == count_mismatches(unchecked.get(), uncheckedOffset,
+                                                            checked.get(), checkedOffset,
+                                                            interior));
+        }
+    }
+}
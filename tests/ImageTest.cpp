@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include <atomic>
 #include <functional>
 #include <initializer_list>
 #include <vector>
@@ -23,6 +24,7 @@
 #include "SkRRect.h"
 #include "SkStream.h"
 #include "SkSurface.h"
+#include "SkTaskGroup.h"
 #include "SkUtils.h"
 #include "Test.h"
 
@@ -542,6 +544,46 @@ DEF_TEST(ImageEmpty, reporter) {
     REPORTER_ASSERT(reporter, nullptr == SkImage::MakeFromGenerator(new EmptyGenerator));
 }
 
+// Fills with red, and counts how many times it's asked to.
+class CountingGenerator : public SkImageGenerator {
+public:
+    CountingGenerator(std::atomic<int>* decodes)
+        : SkImageGenerator(SkImageInfo::MakeN32Premul(20, 20)), fDecodes(decodes) {}
+
+protected:
+    bool onGetPixels(const SkImageInfo& info, void* pixels, size_t rowBytes, SkPMColor[],
+                     int*) override {
+        fDecodes->fetch_add(1);
+        for (int y = 0; y < info.height(); y++) {
+            sk_memset32((uint32_t*)((char*)pixels + y * rowBytes), SkPreMultiplyColor(SK_ColorRED),
+                        info.width());
+        }
+        return true;
+    }
+
+private:
+    std::atomic<int>* fDecodes;
+};
+
+DEF_TEST(Image_PrerollAsync, reporter) {
+    // Outlives any preroll still holding a ref on the image when we return.
+    static std::atomic<int> gDecodes;
+    gDecodes.store(0);
+
+    sk_sp<SkImage> image = SkImage::MakeFromGenerator(new CountingGenerator(&gDecodes));
+    const SkISize drawSize = SkISize::Make(7, 7);
+    image->prerollAsync(&drawSize);
+
+    // However the preroll and these threads interleave, only one of them should decode.
+    SkTaskGroup().batch(8, [&](int) {
+        SkBitmap bm;
+        REPORTER_ASSERT(reporter, as_IB(image)->getROPixels(&bm));
+        SkAutoLockPixels alp(bm);
+        REPORTER_ASSERT(reporter, SkPreMultiplyColor(SK_ColorRED) == *bm.getAddr32(19, 19));
+    });
+    REPORTER_ASSERT(reporter, 1 == gDecodes.load());
+}
+
 DEF_TEST(ImageDataRef, reporter) {
     SkImageInfo info = SkImageInfo::MakeN32Premul(1, 1);
     size_t rowBytes = info.minRowBytes();
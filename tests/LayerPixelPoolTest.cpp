@@ -0,0 +1,53 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkLayerPixelPool.h"
+#include "Test.h"
+
+// Draws red into a layer, then restores another layer that draws nothing.  If that second
+// layer reused the first's pixels, it must still have started out transparent.
+static void draw_layers(skiatest::Reporter* reporter, SkCanvas* canvas, const SkBitmap& bitmap) {
+    canvas->clear(SK_ColorWHITE);
+
+    canvas->saveLayer(nullptr, nullptr);
+        canvas->saveLayer(nullptr, nullptr);
+            canvas->drawColor(SK_ColorRED);
+        canvas->restore();
+        canvas->clear(SK_ColorWHITE);
+    canvas->restore();
+
+    canvas->saveLayer(nullptr, nullptr);
+        canvas->saveLayer(nullptr, nullptr);
+        canvas->restore();
+    canvas->restore();
+
+    REPORTER_ASSERT(reporter, SK_ColorWHITE == bitmap.getColor(0, 0));
+    REPORTER_ASSERT(reporter, SK_ColorWHITE == bitmap.getColor(31, 31));
+}
+
+DEF_TEST(LayerPixelPool, reporter) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(32, 32);
+    SkCanvas canvas(bitmap);
+
+    const size_t limit = SkLayerPixelPool::GetTotalByteLimit();
+
+    // Room for both layers.
+    SkLayerPixelPool::SetTotalByteLimit(2 * 32 * 32 * 4);
+    draw_layers(reporter, &canvas, bitmap);
+    REPORTER_ASSERT(reporter, SkLayerPixelPool::GetTotalBytesUsed() <= 2 * 32 * 32 * 4);
+
+    // Room for neither: nothing is kept.
+    SkLayerPixelPool::SetTotalByteLimit(0);
+    REPORTER_ASSERT(reporter, 0 == SkLayerPixelPool::GetTotalBytesUsed());
+    draw_layers(reporter, &canvas, bitmap);
+    REPORTER_ASSERT(reporter, 0 == SkLayerPixelPool::GetTotalBytesUsed());
+
+    SkLayerPixelPool::SetTotalByteLimit(limit);
+    SkLayerPixelPool::PurgeAll();
+}
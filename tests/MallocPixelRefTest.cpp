@@ -9,6 +9,10 @@
 #include "SkMallocPixelRef.h"
 #include "Test.h"
 
+#if !defined(SK_BUILD_FOR_WIN)
+#include <unistd.h>
+#endif
+
 static void delete_uint8_proc(void* ptr, void*) {
     delete[] static_cast<uint8_t*>(ptr);
 }
@@ -103,4 +107,21 @@ DEF_TEST(MallocPixelRef, reporter) {
         REPORTER_ASSERT(reporter, dataPtr->unique());
         REPORTER_ASSERT(reporter, dataPtr->data() == pr->pixels());
     }
+#if !defined(SK_BUILD_FOR_WIN)
+    {
+        int fd;
+        SkAutoTUnref<SkMallocPixelRef> pr(
+            SkMallocPixelRef::NewShared(info, rowBytes, nullptr, &fd));
+        if (pr) {  // Shared memory may not be available.
+            REPORTER_ASSERT(reporter, !pr->isImmutable());
+            memset(pr->pixels(), 0x42, size);
+            SkAutoTUnref<SkMallocPixelRef> shared(
+                SkMallocPixelRef::NewWithData(info, rowBytes, nullptr,
+                                              SkData::MakeFromSharedFD(fd).get()));
+            close(fd);
+            REPORTER_ASSERT(reporter, shared && shared->pixels() != pr->pixels());
+            REPORTER_ASSERT(reporter, 0 == memcmp(shared->pixels(), pr->pixels(), size));
+        }
+    }
+#endif
 }
@@ -8,6 +8,7 @@
 #include "SkCachedData.h"
 #include "SkMaskCache.h"
 #include "SkResourceCache.h"
+#include "SkScan.h"
 #include "Test.h"
 
 enum LockedState {
@@ -104,3 +105,56 @@ DEF_TEST(RectsMaskCache, reporter) {
     check_data(reporter, data, 1, kNotInCache, kLocked);
     data->unref();
 }
+
+DEF_TEST(PathMaskCache, reporter) {
+    SkResourceCache cache(1024);
+
+    SkScalar sigma = 0.8f;
+    SkScanPathID path = { 42, SkMatrix::MakeTrans(0.5f, 0.25f) };
+    SkStrokeRec::InitStyle pathStyle = SkStrokeRec::kFill_InitStyle;
+    SkBlurStyle style = kNormal_SkBlurStyle;
+    SkBlurQuality quality = kLow_SkBlurQuality;
+    SkMask mask;
+
+    SkCachedData* data = SkMaskCache::FindAndRef(sigma, style, quality, path, pathStyle, &mask,
+                                                 &cache);
+    REPORTER_ASSERT(reporter, nullptr == data);
+
+    size_t size = 256;
+    data = cache.newCachedData(size);
+    memset(data->writable_data(), 0xff, size);
+    mask.fBounds.setXYWH(0, 0, 100, 100);
+    mask.fRowBytes = 100;
+    mask.fFormat = SkMask::kBW_Format;
+    SkMaskCache::Add(sigma, style, quality, path, pathStyle, mask, data, &cache);
+    check_data(reporter, data, 2, kInCache, kLocked);
+
+    data->unref();
+    check_data(reporter, data, 1, kInCache, kUnlocked);
+
+    // Neither another path, nor the same path with another fill type or hairlined, nor its
+    // unblurred mask is this mask.
+    SkScanPathID other = { 43, path.fMatrix };
+    REPORTER_ASSERT(reporter, !SkMaskCache::FindAndRef(sigma, style, quality, other, pathStyle,
+                                                       &mask, &cache));
+    SkScanPathID evenOdd = { 42, path.fMatrix, SkPath::kEvenOdd_FillType };
+    REPORTER_ASSERT(reporter, !SkMaskCache::FindAndRef(sigma, style, quality, evenOdd, pathStyle,
+                                                       &mask, &cache));
+    REPORTER_ASSERT(reporter, !SkMaskCache::FindAndRef(sigma, style, quality, path,
+                                                       SkStrokeRec::kHairline_InitStyle,
+                                                       &mask, &cache));
+    REPORTER_ASSERT(reporter, !SkMaskCache::FindAndRef(0, style, quality, path, pathStyle,
+                                                       &mask, &cache));
+
+    sk_bzero(&mask, sizeof(mask));
+    data = SkMaskCache::FindAndRef(sigma, style, quality, path, pathStyle, &mask, &cache);
+    REPORTER_ASSERT(reporter, data);
+    REPORTER_ASSERT(reporter, data->size() == size);
+    REPORTER_ASSERT(reporter, mask.fBounds.top() == 0 && mask.fBounds.bottom() == 100);
+    REPORTER_ASSERT(reporter, data->data() == (const void*)mask.fImage);
+    check_data(reporter, data, 2, kInCache, kLocked);
+
+    cache.purgeAll();
+    check_data(reporter, data, 1, kNotInCache, kLocked);
+    data->unref();
+}
@@ -202,3 +202,101 @@ DEF_TEST(MipMap_ComputeLevelSize, reporter) {
         REPORTER_ASSERT(reporter, currentTest.fExpectedMipMapLevelSize == levelSize);
     }
 }
+
+static void make_random_bitmap(SkBitmap* bm, const SkImageInfo& info, SkRandom* rand) {
+    bm->allocPixels(info);
+    for (int y = 0; y < info.height(); y++) {
+        uint8_t* row = (uint8_t*)bm->getPixels() + y * bm->rowBytes();
+        for (size_t i = 0; i < info.minRowBytes(); i++) {
+            row[i] = rand->nextU();
+        }
+    }
+}
+
+static bool levels_equal(const SkMipMap::Level& a, const SkMipMap::Level& b) {
+    const SkPixmap& pa = a.fPixmap;
+    const SkPixmap& pb = b.fPixmap;
+    if (pa.info() != pb.info()) {
+        return false;
+    }
+    for (int y = 0; y < pa.height(); y++) {
+        if (memcmp(pa.addr(0, y), pb.addr(0, y), pa.info().minRowBytes())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+DEF_TEST(MipMap_BoxFilterMatchesReference, reporter) {
+    SkRandom rand;
+    // Widths that leave the SIMD kernels a tail to deal with.
+    for (int width : { 2, 10, 38, 70 }) {
+        for (SkColorType ct : { kN32_SkColorType, kAlpha_8_SkColorType }) {
+            SkBitmap bm;
+            make_random_bitmap(&bm, SkImageInfo::Make(width, 6, ct, kPremul_SkAlphaType), &rand);
+            SkAutoTUnref<SkMipMap> mm(SkMipMap::Build(bm, SkSourceGammaTreatment::kIgnore,
+                                                      nullptr));
+            SkMipMap::Level level;
+            REPORTER_ASSERT(reporter, mm->getLevel(0, &level));
+
+            const size_t bpp = bm.bytesPerPixel();
+            for (int y = 0; y < level.fPixmap.height(); y++) {
+                const uint8_t* p0 = (const uint8_t*)bm.getAddr(0, 2*y);
+                const uint8_t* p1 = (const uint8_t*)bm.getAddr(0, 2*y + 1);
+                const uint8_t* d  = (const uint8_t*)level.fPixmap.addr(0, y);
+                for (size_t i = 0; i < level.fPixmap.width() * bpp; i++) {
+                    const size_t x = i / bpp * 2 * bpp + i % bpp;
+                    const int expected = (p0[x] + p0[x + bpp] + p1[x] + p1[x + bpp]) >> 2;
+                    if (d[i] != expected) {
+                        ERRORF(reporter, "width %d, ct %d: byte %d of row %d is %d, not %d",
+                               width, ct, (int)i, y, d[i], expected);
+                        return;
+                    }
+                }
+            }
+        }
+    }
+}
+
+DEF_TEST(MipMap_OnDemand, reporter) {
+    SkRandom rand;
+    // Big enough that the first level is filtered in parallel bands when built all at once.
+    const SkImageInfo infos[] = {
+        SkImageInfo::MakeN32Premul(1030, 1027),
+        SkImageInfo::MakeA8(1030, 1027),
+        SkImageInfo::Make(99, 131, kRGBA_F16_SkColorType, kPremul_SkAlphaType),
+    };
+    for (const SkImageInfo& info : infos) {
+        SkBitmap bm;
+        make_random_bitmap(&bm, info, &rand);
+        if (kRGBA_F16_SkColorType == info.colorType()) {
+            bm.eraseColor(0xFF336699);    // Random bits aren't necessarily finite halfs.
+        }
+        bm.setImmutable();
+
+        SkAutoTUnref<SkMipMap> all(SkMipMap::Build(bm, SkSourceGammaTreatment::kIgnore, nullptr));
+        SkAutoTUnref<SkMipMap> lazy(SkMipMap::Build(bm, SkSourceGammaTreatment::kIgnore, nullptr,
+                                                    SkMipMap::kOnDemand_LevelGeneration));
+        REPORTER_ASSERT(reporter, all->testing_only_countBuiltLevels() == all->countLevels());
+        REPORTER_ASSERT(reporter, lazy->testing_only_countBuiltLevels() == 0);
+        REPORTER_ASSERT(reporter, lazy->countLevels() == all->countLevels());
+
+        // Asking whether a level exists doesn't build it.
+        REPORTER_ASSERT(reporter, lazy->extractLevel(SkSize::Make(0.2f, 0.2f), nullptr));
+        REPORTER_ASSERT(reporter, lazy->testing_only_countBuiltLevels() == 0);
+
+        // Scaling by 0.2 uses the 1/4 level, so only it and the 1/2 level above it are built.
+        SkMipMap::Level lazyLevel, allLevel;
+        REPORTER_ASSERT(reporter, lazy->extractLevel(SkSize::Make(0.2f, 0.2f), &lazyLevel));
+        REPORTER_ASSERT(reporter, lazy->testing_only_countBuiltLevels() == 2);
+        REPORTER_ASSERT(reporter, all->extractLevel(SkSize::Make(0.2f, 0.2f), &allLevel));
+        REPORTER_ASSERT(reporter, levels_equal(lazyLevel, allLevel));
+
+        for (int i = lazy->countLevels() - 1; i >= 0; i--) {
+            REPORTER_ASSERT(reporter, lazy->getLevel(i, &lazyLevel));
+            REPORTER_ASSERT(reporter, all->getLevel(i, &allLevel));
+            REPORTER_ASSERT(reporter, levels_equal(lazyLevel, allLevel));
+        }
+        REPORTER_ASSERT(reporter, lazy->testing_only_countBuiltLevels() == lazy->countLevels());
+    }
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkData.h"
+#include "SkMultiPictureDocument.h"
+#include "SkMultiPictureDocumentPriv.h"
+#include "SkMultiPictureDocumentReader.h"
+#include "SkPictureRecorder.h"
+#include "SkStream.h"
+#include "SkTaskGroup.h"
+#include "Test.h"
+
+static const SkColor kPageColors[] = { SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE, SK_ColorCYAN };
+static const int kPageCount = SK_ARRAY_COUNT(kPageColors);
+
+static SkColor draw_page(const sk_sp<SkPicture>& page) {
+    if (!page) {
+        return SK_ColorTRANSPARENT;
+    }
+    SkBitmap bm;
+    bm.allocN32Pixels(1, 1);
+    bm.eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas canvas(bm);
+    canvas.drawPicture(page);
+    return bm.getColor(0, 0);
+}
+
+DEF_TEST(MultiPictureDocument_Pages, r) {
+    SkDynamicMemoryWStream wStream;
+    sk_sp<SkDocument> doc(SkMakeMultiPictureDocument(&wStream));
+    for (int i = 0; i < kPageCount; ++i) {
+        doc->beginPage(SkIntToScalar(10 + i), 20)->drawColor(kPageColors[i]);
+        doc->endPage();
+    }
+    REPORTER_ASSERT(r, doc->close());
+    sk_sp<SkData> data(wStream.copyToData());
+
+    SkMultiPictureDocumentReader reader;
+    SkMemoryStream stream(data);
+    REPORTER_ASSERT(r, reader.init(&stream));
+    REPORTER_ASSERT(r, kPageCount == reader.pageCount());
+    for (int i = 0; i < reader.pageCount(); ++i) {
+        REPORTER_ASSERT(r, SkSize::Make(SkIntToScalar(10 + i), 20) == reader.pageSize(i));
+    }
+
+    // Any page can be read from the stream on its own, in any order.
+    for (int i = kPageCount - 1; i >= 0; --i) {
+        REPORTER_ASSERT(r, kPageColors[i] == draw_page(reader.readPage(&stream, i)));
+    }
+
+    // Or from the data, several at once.
+    SkColor colors[kPageCount];
+    SkTaskGroup().batch(kPageCount, [&](int i) {
+        colors[i] = draw_page(reader.readPage(data, i));
+    });
+    for (int i = 0; i < kPageCount; ++i) {
+        REPORTER_ASSERT(r, kPageColors[i] == colors[i]);
+    }
+
+    // A truncated document has lost its index.
+    SkMemoryStream truncated(data->data(), data->size() - 1);
+    REPORTER_ASSERT(r, !reader.init(&truncated));
+    REPORTER_ASSERT(r, 0 == reader.pageCount());
+}
+
+// Documents written with the index at the front should still be readable.
+DEF_TEST(MultiPictureDocument_IndexInHeader, r) {
+    SkPictureRecorder recorder;
+    recorder.beginRecording(10, 20)->drawColor(SK_ColorBLUE);
+    sk_sp<SkPicture> picture(recorder.finishRecordingAsPicture());
+
+    SkDynamicMemoryWStream wStream;
+    wStream.writeText(SkMultiPictureDocumentProtocol::kMagic);
+    wStream.write32(SkMultiPictureDocumentProtocol::kIndexInHeader_Version);
+    wStream.write32(1);
+    SkMultiPictureDocumentProtocol::Entry entry{
+            wStream.bytesWritten() + sizeof(entry), 10, 20};
+    wStream.write(&entry, sizeof(entry));
+    picture->serialize(&wStream);
+    wStream.writeText(SkMultiPictureDocumentProtocol::kEndMarker);
+    sk_sp<SkData> data(wStream.copyToData());
+
+    SkMultiPictureDocumentReader reader;
+    SkMemoryStream stream(data);
+    REPORTER_ASSERT(r, reader.init(&stream));
+    REPORTER_ASSERT(r, 1 == reader.pageCount());
+    REPORTER_ASSERT(r, SkSize::Make(10, 20) == reader.pageSize(0));
+    REPORTER_ASSERT(r, SK_ColorBLUE == draw_page(reader.readPage(&stream, 0)));
+    REPORTER_ASSERT(r, SK_ColorBLUE == draw_page(reader.readPage(data, 0)));
+}
@@ -29,7 +29,7 @@ void skia_free_func(void*, void* address) { sk_free(address); }
  *  Use the un-deflate compression algorithm to decompress the data in src,
  *  returning the result.  Returns nullptr if an error occurs.
  */
-SkStreamAsset* stream_inflate(skiatest::Reporter* reporter, SkStream* src) {
+SkStreamAsset* stream_inflate(skiatest::Reporter* reporter, SkStream* src, bool gzip = false) {
     SkDynamicMemoryWStream decompressedDynamicMemoryWStream;
     SkWStream* dst = &decompressedDynamicMemoryWStream;
 
@@ -45,7 +45,7 @@ SkStreamAsset* stream_inflate(skiatest::Reporter* reporter, SkStream* src) {
     flateData.next_out = outputBuffer;
     flateData.avail_out = kBufferSize;
     int rc;
-    rc = inflateInit(&flateData);
+    rc = inflateInit2(&flateData, gzip ? 0x1F : 0x0F);
     if (rc != Z_OK) {
         ERRORF(reporter, "Zlib: inflateInit failed");
         return nullptr;
@@ -164,3 +164,49 @@ DEF_TEST(SkDeflateWStream, r) {
         }
     }
 }
+
+DEF_TEST(SkDeflateWStream_Blocks, r) {
+    // Words from a small vocabulary, so matches reach back across block boundaries.
+    static const char* kWords[] = { "moveTo ", "lineTo ", "0 0 1 rg\n", "BT ", "ET\n",
+                                    "/F1 12 Tf ", "q ", "Q\n", "re f\n", "cm " };
+    SkRandom random(654321);
+    const size_t kBlock = 128 * 1024;
+    // Just the first block, one more byte, and more blocks than are ever in flight at once.
+    for (size_t size : { kBlock, kBlock + 1, 9 * kBlock + 17 }) {
+        SkAutoTMalloc<char> buffer(size);
+        for (size_t i = 0; i < size;) {
+            const char* word = kWords[random.nextULessThan(SK_ARRAY_COUNT(kWords))];
+            for (; *word && i < size; word++) {
+                buffer[i++] = *word;
+            }
+        }
+
+        for (bool gzip : { false, true }) {
+            for (int level : { -1, 0, 9 }) {
+                SkDynamicMemoryWStream compressedStream;
+                {
+                    SkDeflateWStream deflateWStream(&compressedStream, level, gzip);
+                    for (size_t i = 0; i < size;) {
+                        size_t writeSize = SkTMin(size - i, (size_t)random.nextRangeU(1, 70000));
+                        REPORTER_ASSERT(r, deflateWStream.write(&buffer[i], writeSize));
+                        i += writeSize;
+                    }
+                    REPORTER_ASSERT(r, deflateWStream.bytesWritten() == size);
+                }
+                SkAutoTDelete<SkStreamAsset> compressed(compressedStream.detachAsStream());
+                if (level != 0) {
+                    REPORTER_ASSERT(r, compressed->getLength() < size / 4);
+                }
+                SkAutoTDelete<SkStreamAsset> decompressed(
+                        stream_inflate(r, compressed, gzip));
+                REPORTER_ASSERT(r, decompressed && decompressed->getLength() == size);
+                if (!decompressed || decompressed->getLength() != size) {
+                    continue;
+                }
+                SkAutoTMalloc<char> roundTrip(size);
+                decompressed->read(roundTrip.get(), size);
+                REPORTER_ASSERT(r, 0 == memcmp(roundTrip.get(), buffer.get(), size));
+            }
+        }
+    }
+}
@@ -8,7 +8,10 @@
 
 #include "Resources.h"
 #include "SkCanvas.h"
+#include "SkColorPriv.h"
 #include "SkDocument.h"
+#include "SkImage.h"
+#include "SkImageEncoder.h"
 #include "SkOSFile.h"
 #include "SkStream.h"
 #include "SkPixelSerializer.h"
@@ -167,3 +170,195 @@ DEF_TEST(document_skbug_4734, r) {
     const char text[] = "HELLO";
     canvas->drawText(text, strlen(text), 0, 0, SkPaint());
 }
+
+static size_t pdf_size(int compressionLevel) {
+    SkDocument::PDFMetadata metadata;
+    metadata.fCompressionLevel = compressionLevel;
+    SkDynamicMemoryWStream stream;
+    sk_sp<SkDocument> doc(SkDocument::MakePDF(&stream, SK_ScalarDefaultRasterDPI,
+                                              metadata, nullptr, false));
+    SkCanvas* canvas = doc->beginPage(612, 792);
+    SkPaint paint;
+    for (int i = 0; i < 1000; i++) {
+        paint.setColor(0xFF000000 | (i * 997));
+        canvas->drawRect(SkRect::MakeXYWH(i % 600, i / 2, 10, 10), paint);
+    }
+    SkBitmap bm;
+    bm.allocN32Pixels(256, 256);
+    bm.eraseColor(SK_ColorBLUE);
+    canvas->drawBitmap(bm, 0, 0);
+    doc->close();
+    return stream.bytesWritten();
+}
+
+DEF_TEST(document_compression_level, r) {
+    REQUIRE_PDF_DOCUMENT(document_compression_level, r);
+    // Page contents and images are stored, or squeezed harder, as asked.
+    const size_t none = pdf_size(0),
+                 fast = pdf_size(1),
+                 best = pdf_size(9);
+    REPORTER_ASSERT(r, none > fast);
+    REPORTER_ASSERT(r, fast >= best);
+}
+
+static sk_sp<SkData> make_pages(int pageCount) {
+    SkDynamicMemoryWStream stream;
+    sk_sp<SkDocument> doc(SkDocument::MakePDF(&stream));
+    SkPaint paint;
+    for (int page = 0; page < pageCount; page++) {
+        SkCanvas* canvas = doc->beginPage(612, 792);
+        for (int i = 0; i < 500; i++) {
+            paint.setColor(0xFF000000 | ((page + i) * 997));
+            canvas->drawRect(SkRect::MakeXYWH(i % 600, (i + page) % 780, 10, 10), paint);
+        }
+        doc->endPage();
+    }
+    doc->close();
+    return sk_sp<SkData>(stream.copyToData());
+}
+
+static int count_occurrences(const SkData* data, const char* str) {
+    const size_t len = strlen(str);
+    int count = 0;
+    for (size_t i = 0; i + len <= data->size(); i++) {
+        count += 0 == memcmp(data->bytes() + i, str, len);
+    }
+    return count;
+}
+
+DEF_TEST(document_background_page_content, r) {
+    REQUIRE_PDF_DOCUMENT(document_background_page_content, r);
+    // Pages' content is compressed on other threads, but we should still write
+    // each page's content exactly once, and the same bytes every time.
+    sk_sp<SkData> pdf = make_pages(12);
+    REPORTER_ASSERT(r, 12 == count_occurrences(pdf.get(), "/Contents "));
+    REPORTER_ASSERT(r, count_occurrences(pdf.get(), " stream\n") ==
+                       count_occurrences(pdf.get(), "\nendstream"));
+    REPORTER_ASSERT(r, pdf->equals(make_pages(12).get()));
+}
+
+// Checks that every xref entry points at the start of its object.
+static bool xref_matches_objects(const SkData* data) {
+    const char* pdf = (const char*)data->bytes();
+    const char* startxref = nullptr;
+    for (size_t i = 0; i + 10 <= data->size(); i++) {
+        if (0 == memcmp(pdf + i, "startxref\n", 10)) {
+            startxref = pdf + i + 10;
+        }
+    }
+    if (!startxref) {
+        return false;
+    }
+    const char* xref = pdf + atoi(startxref);
+    int objCount;
+    if (1 != sscanf(xref, "xref\n0 %d\n", &objCount) || objCount < 2) {
+        return false;
+    }
+    const char* entry = strstr(xref, " f \n") + 4;
+    for (int i = 1; i < objCount; i++, entry += 20) {
+        SkString expected;
+        expected.printf("%d 0 obj\n", i);
+        if (0 != strncmp(pdf + atoi(entry), expected.c_str(), expected.size())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+DEF_TEST(document_streaming_pages, r) {
+    SkDynamicMemoryWStream stream;
+    sk_sp<SkDocument> doc(SkDocument::MakePDF(&stream));
+    SkPaint paint;
+    paint.setTextSize(24);
+    // More than 64 pages, for a page tree three levels deep.
+    const int kPageCount = 70;
+    size_t written = 0;
+    for (int page = 0; page < kPageCount; page++) {
+        SkCanvas* canvas = doc->beginPage(612, 792);
+        SkString text;
+        text.printf("Page %d", page);
+        canvas->drawText(text.c_str(), text.size(), 72, 72, paint);
+        doc->endPage();
+        // Each page is written out as the next one ends.
+        if (page > 0) {
+            REPORTER_ASSERT(r, stream.bytesWritten() > written);
+        }
+        written = stream.bytesWritten();
+    }
+    doc->close();
+    sk_sp<SkData> pdf(stream.copyToData());
+
+    REPORTER_ASSERT(r, xref_matches_objects(pdf.get()));
+    REPORTER_ASSERT(r, kPageCount == count_occurrences(pdf.get(), "/Contents "));
+    REPORTER_ASSERT(r, 1 == count_occurrences(pdf.get(), "/Count 70\n"));
+    // 9 leaves of up to 8 pages, one node over the first 8 of them, and the root.
+    REPORTER_ASSERT(r, 11 == count_occurrences(pdf.get(), "/Type /Pages\n"));
+}
+
+static sk_sp<SkData> pdf_with_logos(bool deduplicate) {
+    SkBitmap bm;
+    bm.allocN32Pixels(64, 64, true);
+    for (int y = 0; y < 64; ++y) {
+        for (int x = 0; x < 64; ++x) {
+            *bm.getAddr32(x, y) = SkPackARGB32(0xFF, x * 4, y * 4, (x ^ y) * 4);
+        }
+    }
+    SkDynamicMemoryWStream stream;
+    SkDocument::PDFMetadata metadata;
+    metadata.fDeduplicateImages = deduplicate;
+    sk_sp<SkDocument> doc(SkDocument::MakePDF(&stream, SK_ScalarDefaultRasterDPI, metadata,
+                                              nullptr, false));
+    for (int page = 0; page < 3; ++page) {
+        // A new SkImage each time, as if decoded anew for each page.
+        sk_sp<SkImage> logo(SkImage::MakeRasterCopy(SkPixmap(bm.info(), bm.getPixels(), bm.rowBytes())));
+        doc->beginPage(612, 792)->drawImage(logo, 36, 36);
+        doc->endPage();
+    }
+    doc->close();
+    return sk_sp<SkData>(stream.copyToData());
+}
+
+DEF_TEST(document_deduplicate_images, r) {
+    sk_sp<SkData> dupes = pdf_with_logos(false),
+                  deduped = pdf_with_logos(true);
+    REPORTER_ASSERT(r, 3 == count_occurrences(dupes.get(), "/Subtype /Image"));
+    REPORTER_ASSERT(r, 1 == count_occurrences(deduped.get(), "/Subtype /Image"));
+    REPORTER_ASSERT(r, deduped->size() < dupes->size());
+    REPORTER_ASSERT(r, xref_matches_objects(deduped.get()));
+}
+
+static sk_sp<SkData> pdf_with_image(const SkBitmap& bm, int jpegQuality) {
+    SkDynamicMemoryWStream stream;
+    SkDocument::PDFMetadata metadata;
+    metadata.fJpegQuality = jpegQuality;
+    sk_sp<SkDocument> doc(SkDocument::MakePDF(&stream, SK_ScalarDefaultRasterDPI, metadata,
+                                              nullptr, false));
+    doc->beginPage(612, 792)->drawBitmap(bm, 0, 0);
+    doc->endPage();
+    doc->close();
+    return sk_sp<SkData>(stream.copyToData());
+}
+
+DEF_TEST(document_jpeg_quality, r) {
+    SkBitmap photo;
+    if (!GetResourceAsBitmap("mandrill_128.png", &photo)) {
+        return;
+    }
+    sk_sp<SkData> jpeg(SkImageEncoder::EncodeData(photo, SkImageEncoder::kJPEG_Type, 50));
+    if (!jpeg) {
+        INFOF(r, "no JPEG encoder; skipping document_jpeg_quality.");
+        return;
+    }
+    sk_sp<SkData> deflated = pdf_with_image(photo, -1),
+                  encoded = pdf_with_image(photo, 50);
+    REPORTER_ASSERT(r, 0 == count_occurrences(deflated.get(), "/DCTDecode"));
+    REPORTER_ASSERT(r, 1 == count_occurrences(encoded.get(), "/DCTDecode"));
+    REPORTER_ASSERT(r, encoded->size() < deflated->size());
+
+    // Flat artwork stays lossless.
+    SkBitmap flat;
+    flat.allocN32Pixels(128, 128);
+    flat.eraseColor(SK_ColorWHITE);
+    flat.eraseArea(SkIRect::MakeXYWH(32, 32, 64, 64), SK_ColorBLUE);
+    REPORTER_ASSERT(r, 0 == count_occurrences(pdf_with_image(flat, 50).get(), "/DCTDecode"));
+}
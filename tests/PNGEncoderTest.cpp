@@ -0,0 +1,190 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkCodec.h"
+#include "SkColorPriv.h"
+#include "SkData.h"
+#include "SkImageEncoder.h"
+#include "SkPNGEncoder.h"
+#include "SkRandom.h"
+#include "SkStream.h"
+#include "Test.h"
+
+// SkPNGEncoder is only built where libpng does our PNG encoding; see images.gyp.
+#if !defined(SK_BUILD_FOR_MAC) && !defined(SK_BUILD_FOR_WIN) && !defined(SK_BUILD_FOR_IOS) && \
+    defined(SK_HAS_PNG_LIBRARY)
+
+static bool decode(const SkData* data, const SkImageInfo& info, SkBitmap* dst) {
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(const_cast<SkData*>(data)));
+    if (!codec || codec->getInfo().dimensions() != info.dimensions()) {
+        return false;
+    }
+    dst->allocPixels(info.makeColorType(kN32_SkColorType));
+    return SkCodec::kSuccess == codec->getPixels(dst->info(), dst->getPixels(),
+                                                 dst->rowBytes());
+}
+
+static bool equal_pixels(const SkBitmap& a, const SkBitmap& b) {
+    for (int y = 0; y < a.height(); ++y) {
+        if (memcmp(a.getAddr(0, y), b.getAddr(0, y), a.width() * a.bytesPerPixel())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static SkData* encode(const SkBitmap& bm, const SkPNGEncoder::Options& options) {
+    SkDynamicMemoryWStream stream;
+    return SkPNGEncoder::Encode(&stream, bm, options) ? stream.copyToData() : nullptr;
+}
+
+// Images big enough to be encoded in bands should decode exactly like the serial encode.
+static void test_banded(skiatest::Reporter* r, const SkBitmap& bm) {
+    SkPNGEncoder::Options serialOptions;
+    serialOptions.fMultiThreaded = false;
+    SkAutoTUnref<SkData> serial(encode(bm, serialOptions));
+    REPORTER_ASSERT(r, serial);
+    SkBitmap expected;
+    REPORTER_ASSERT(r, serial && decode(serial, bm.info(), &expected));
+    if (!expected.getPixels()) {
+        return;
+    }
+
+    for (int level : { 0, 1, 6, 9 }) {
+        for (auto strategy : { SkPNGEncoder::kAuto_Strategy, SkPNGEncoder::kRLE_Strategy }) {
+            SkPNGEncoder::Options options;
+            options.fZLibLevel = level;
+            options.fStrategy = strategy;
+            SkAutoTUnref<SkData> banded(encode(bm, options));
+            SkBitmap actual;
+            REPORTER_ASSERT(r, banded && decode(banded, bm.info(), &actual));
+            REPORTER_ASSERT(r, actual.getPixels() && equal_pixels(expected, actual));
+            if (6 == level && SkPNGEncoder::kAuto_Strategy == strategy) {
+                // Priming each band with its predecessor keeps the size close to serial.
+                REPORTER_ASSERT(r, banded->size() < serial->size() * 11 / 10);
+            }
+        }
+    }
+}
+
+DEF_TEST(PNGEncoder_Banded, r) {
+    // Gradients with some noise, so every filter type gets a turn.
+    SkRandom rand;
+    SkBitmap bm;
+    bm.allocN32Pixels(640, 480);
+    for (int y = 0; y < bm.height(); ++y) {
+        for (int x = 0; x < bm.width(); ++x) {
+            U8CPU a = y < 40 ? 0 : (x + y) & 0xFF;
+            *bm.getAddr32(x, y) = SkPreMultiplyARGB(a, x & 0xFF, y & 0xFF,
+                                                    rand.nextU() & 0x1F);
+        }
+    }
+    test_banded(r, bm);
+
+    // An opaque image is written without alpha.
+    SkBitmap opaque;
+    opaque.allocPixels(SkImageInfo::Make(640, 480, kRGB_565_SkColorType, kOpaque_SkAlphaType));
+    for (int y = 0; y < opaque.height(); ++y) {
+        for (int x = 0; x < opaque.width(); ++x) {
+            *opaque.getAddr16(x, y) = SkPackRGB16(x & 0x1F, y & 0x3F, (x ^ y) & 0x1F);
+        }
+    }
+    test_banded(r, opaque);
+
+    // Small images are unaffected.
+    bm.extractSubset(&bm, SkIRect::MakeWH(16, 16));
+    test_banded(r, bm);
+}
+
+static SkData* encode(const SkPixmap& pixmap, bool multiThreaded) {
+    SkPNGEncoder::Options options;
+    options.fMultiThreaded = multiThreaded;
+    SkDynamicMemoryWStream stream;
+    return SkPNGEncoder::Encode(&stream, pixmap, options) ? stream.copyToData() : nullptr;
+}
+
+static void check_pixmap(skiatest::Reporter* r, const SkPixmap& pixmap,
+                         const SkImageInfo& decodeInfo, const SkBitmap& expected) {
+    for (bool multiThreaded : { false, true }) {
+        SkAutoTUnref<SkData> data(encode(pixmap, multiThreaded));
+        REPORTER_ASSERT(r, data);
+        SkAutoTDelete<SkCodec> codec(data ? SkCodec::NewFromData(data) : nullptr);
+        REPORTER_ASSERT(r, codec);
+        if (!codec) {
+            continue;
+        }
+        SkBitmap actual;
+        actual.allocPixels(decodeInfo);
+        REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(actual.info(),
+                                                                 actual.getPixels(),
+                                                                 actual.rowBytes()));
+        REPORTER_ASSERT(r, equal_pixels(expected, actual));
+    }
+}
+
+// Color types other than N32 are converted a row at a time, and should encode the same
+// pixels as their N32 equivalents.
+DEF_TEST(PNGEncoder_ColorTypes, r) {
+    const SkColorType otherCT = kN32_SkColorType == kRGBA_8888_SkColorType
+                              ? kBGRA_8888_SkColorType : kRGBA_8888_SkColorType;
+    SkRandom rand;
+    SkBitmap unpremul;
+    unpremul.allocPixels(SkImageInfo::MakeN32(640, 480, kUnpremul_SkAlphaType));
+    for (int y = 0; y < unpremul.height(); ++y) {
+        for (int x = 0; x < unpremul.width(); ++x) {
+            U8CPU a = y < 40 ? 0xFF : (x + y) & 0xFF;
+            *unpremul.getAddr32(x, y) = SkPackARGB32NoCheck(a, x & 0xFF, y & 0xFF,
+                                                            rand.nextU() & 0xFF);
+        }
+    }
+    SkAutoLockPixels alp(unpremul);
+
+    // Unpremul pixels survive exactly, in either byte order.
+    SkPixmap pixmap;
+    REPORTER_ASSERT(r, unpremul.peekPixels(&pixmap));
+    check_pixmap(r, pixmap, unpremul.info(), unpremul);
+    SkBitmap swapped;
+    swapped.allocPixels(unpremul.info().makeColorType(otherCT));
+    REPORTER_ASSERT(r, unpremul.readPixels(swapped.info(), swapped.getPixels(),
+                                           swapped.rowBytes(), 0, 0));
+    SkAutoLockPixels alpSwapped(swapped);
+    REPORTER_ASSERT(r, swapped.peekPixels(&pixmap));
+    check_pixmap(r, pixmap, unpremul.info(), unpremul);
+
+    // Premul pixels decode to what the N32 encode does.
+    SkBitmap premul;
+    premul.allocPixels(unpremul.info().makeAlphaType(kPremul_SkAlphaType));
+    REPORTER_ASSERT(r, unpremul.readPixels(premul.info(), premul.getPixels(),
+                                           premul.rowBytes(), 0, 0));
+    SkAutoTUnref<SkData> n32Data(encode(premul, SkPNGEncoder::Options()));
+    SkBitmap expected;
+    REPORTER_ASSERT(r, n32Data && decode(n32Data, premul.info(), &expected));
+    SkBitmap premulSwapped;
+    REPORTER_ASSERT(r, premul.copyTo(&premulSwapped, otherCT));
+    SkAutoLockPixels alpPremulSwapped(premulSwapped);
+    REPORTER_ASSERT(r, premulSwapped.peekPixels(&pixmap));
+    check_pixmap(r, pixmap, expected.info(), expected);
+
+    // Gray is written as opaque RGB.
+    SkBitmap gray;
+    gray.allocPixels(SkImageInfo::Make(640, 480, kGray_8_SkColorType, kOpaque_SkAlphaType));
+    SkBitmap grayExpected;
+    grayExpected.allocPixels(gray.info().makeColorType(kN32_SkColorType));
+    for (int y = 0; y < gray.height(); ++y) {
+        for (int x = 0; x < gray.width(); ++x) {
+            U8CPU g = (x ^ y) & 0xFF;
+            *gray.getAddr8(x, y) = g;
+            *grayExpected.getAddr32(x, y) = SkPackARGB32(0xFF, g, g, g);
+        }
+    }
+    SkAutoLockPixels alpGray(gray);
+    REPORTER_ASSERT(r, gray.peekPixels(&pixmap));
+    check_pixmap(r, pixmap, grayExpected.info(), grayExpected);
+}
+
+#endif
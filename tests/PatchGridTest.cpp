@@ -0,0 +1,119 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkPatchGrid.h"
+#include "SkPatchUtils.h"
+#include "Test.h"
+
+static const int kSize = 100;
+
+// Builds the patch spanning (x0, y0) - (x1, y1), with its top and bottom cubics bowed by bow.
+static void make_patch(SkScalar x0, SkScalar y0, SkScalar x1, SkScalar y1, SkScalar bow,
+                       SkPoint cubics[12]) {
+    SkScalar dx = (x1 - x0) / 3, dy = (y1 - y0) / 3;
+    cubics[SkPatchUtils::kTopP0_CubicCtrlPts].set(x0, y0);
+    cubics[SkPatchUtils::kTopP1_CubicCtrlPts].set(x0 + dx, y0 - bow);
+    cubics[SkPatchUtils::kTopP2_CubicCtrlPts].set(x0 + 2 * dx, y0 + bow);
+    cubics[SkPatchUtils::kTopP3_CubicCtrlPts].set(x1, y0);
+    cubics[SkPatchUtils::kRightP1_CubicCtrlPts].set(x1, y0 + dy);
+    cubics[SkPatchUtils::kRightP2_CubicCtrlPts].set(x1, y0 + 2 * dy);
+    cubics[SkPatchUtils::kBottomP3_CubicCtrlPts].set(x1, y1);
+    cubics[SkPatchUtils::kBottomP2_CubicCtrlPts].set(x0 + 2 * dx, y1 + bow);
+    cubics[SkPatchUtils::kBottomP1_CubicCtrlPts].set(x0 + dx, y1 - bow);
+    cubics[SkPatchUtils::kBottomP0_CubicCtrlPts].set(x0, y1);
+    cubics[SkPatchUtils::kLeftP2_CubicCtrlPts].set(x0, y0 + 2 * dy);
+    cubics[SkPatchUtils::kLeftP1_CubicCtrlPts].set(x0, y0 + dy);
+}
+
+DEF_TEST(PatchUtils_LevelOfDetail, reporter) {
+    SkPoint flat[12], curved[12];
+    make_patch(0, 0, 20, 20, 0, flat);
+    make_patch(0, 0, 20, 20, 10, curved);
+
+    // A flat patch only needs splitting to interpolate its colors; curves need more.
+    SkISize flatLod = SkPatchUtils::GetLevelOfDetail(flat, &SkMatrix::I());
+    SkISize curvedLod = SkPatchUtils::GetLevelOfDetail(curved, &SkMatrix::I());
+    REPORTER_ASSERT(reporter, 1 == flatLod.width() && 1 == flatLod.height());
+    REPORTER_ASSERT(reporter, curvedLod.width() > flatLod.width());
+    REPORTER_ASSERT(reporter, curvedLod.width() > curvedLod.height());
+
+    // The error is measured on screen.
+    SkMatrix zoom = SkMatrix::MakeScale(10);
+    SkISize zoomedLod = SkPatchUtils::GetLevelOfDetail(curved, &zoom);
+    REPORTER_ASSERT(reporter, zoomedLod.width() > curvedLod.width());
+
+    // The tessellation goes through the corners and along the edges.
+    SkPatchUtils::VertexData data;
+    REPORTER_ASSERT(reporter, SkPatchUtils::getVertexData(&data, curved, nullptr, nullptr,
+                                                          curvedLod.width(), curvedLod.height()));
+    REPORTER_ASSERT(reporter, (curvedLod.width() + 1) * (curvedLod.height() + 1) ==
+                              data.fVertexCount);
+    REPORTER_ASSERT(reporter, data.fPoints[0] == curved[SkPatchUtils::kTopP0_CubicCtrlPts]);
+    REPORTER_ASSERT(reporter, data.fPoints[data.fVertexCount - 1] ==
+                              curved[SkPatchUtils::kBottomP3_CubicCtrlPts]);
+    for (int i = 0; i < data.fVertexCount; i++) {
+        REPORTER_ASSERT(reporter, data.fPoints[i].x() >= 0 && data.fPoints[i].x() <= 20);
+    }
+}
+
+static void draw_grid(SkPatchGrid* grid, SkBitmap* bitmap) {
+    bitmap->allocN32Pixels(kSize, kSize);
+    bitmap->eraseColor(SK_ColorWHITE);
+    SkCanvas canvas(*bitmap);
+    SkPaint paint;
+    grid->draw(&canvas, paint);
+}
+
+static bool equal_pixels(const SkBitmap& a, const SkBitmap& b) {
+    SkAutoLockPixels lockA(a), lockB(b);
+    return 0 == memcmp(a.getPixels(), b.getPixels(), a.getSize());
+}
+
+static void set_grid(SkPatchGrid* grid, SkScalar bow) {
+    const SkColor colors[4] = { SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE, SK_ColorBLACK };
+    for (int y = 0; y < 2; y++) {
+        for (int x = 0; x < 2; x++) {
+            SkPoint cubics[12];
+            make_patch(10 + 40 * x, 10 + 40 * y, 50 + 40 * x, 50 + 40 * y, bow, cubics);
+            grid->setPatch(x, y, cubics, colors, nullptr);
+        }
+    }
+}
+
+DEF_TEST(PatchGrid_Cache, reporter) {
+    SkPatchGrid grid(2, 2, SkPatchGrid::kColors_VertexType);
+    set_grid(&grid, 5);
+    SkBitmap first, again;
+    draw_grid(&grid, &first);
+    draw_grid(&grid, &again);
+    REPORTER_ASSERT(reporter, equal_pixels(first, again));
+
+    // Moving a patch's shared points retessellates its neighbors too.
+    SkPoint cubics[12];
+    grid.getPatch(0, 0, cubics, nullptr, nullptr);
+    cubics[SkPatchUtils::kBottomP3_CubicCtrlPts].offset(8, 8);
+    grid.setPatch(0, 0, cubics, nullptr, nullptr);
+    SkBitmap moved, expected;
+    draw_grid(&grid, &moved);
+    REPORTER_ASSERT(reporter, !equal_pixels(first, moved));
+
+    SkPatchGrid fresh(2, 2, SkPatchGrid::kColors_VertexType);
+    set_grid(&fresh, 5);
+    fresh.setPatch(0, 0, cubics, nullptr, nullptr);
+    draw_grid(&fresh, &expected);
+    REPORTER_ASSERT(reporter, equal_pixels(expected, moved));
+
+    // Resetting drops the tessellations along with the patches.
+    grid.reset(2, 2, SkPatchGrid::kNone_VertexType, nullptr);
+    set_grid(&grid, 0);
+    SkPatchGrid flat(2, 2, SkPatchGrid::kNone_VertexType);
+    set_grid(&flat, 0);
+    draw_grid(&grid, &moved);
+    draw_grid(&flat, &expected);
+    REPORTER_ASSERT(reporter, equal_pixels(expected, moved));
+}
@@ -217,3 +217,67 @@ DEF_TEST(PathMeasureConic, reporter) {
     REPORTER_ASSERT(reporter, 19.5f < stdP.fX && stdP.fX < 20.5f);
     REPORTER_ASSERT(reporter, 19.5f < hiP.fX && hiP.fX < 20.5f);
 }
+
+// Long non-volatile paths share their segment tables through the resource cache. Measuring
+// through the cache, and through the batch getPosTan(), must match measuring from scratch.
+DEF_TEST(PathMeasureCachedAndBatch, reporter) {
+    SkPath path;
+    path.moveTo(0, 0);
+    for (int i = 0; i < 20; ++i) {
+        path.quadTo(i * 10 + 5, (i & 1) ? 10 : -10, i * 10 + 10, 0);
+    }
+    path.moveTo(0, 50);
+    for (int i = 0; i < 10; ++i) {
+        path.cubicTo(i * 10 + 3, 60, i * 10 + 6, 40, i * 10 + 10, 50);
+    }
+    path.close();
+
+    SkPath volatilePath(path);
+    volatilePath.setIsVolatile(true);
+
+    for (int pass = 0; pass < 2; ++pass) {  // the second pass hits the cache
+        SkPathMeasure cached(path, false);
+        SkPathMeasure fresh(volatilePath, false);
+        int contours = 0;
+        for (;;) {
+            SkScalar length = cached.getLength();
+            REPORTER_ASSERT(reporter, length == fresh.getLength());
+            REPORTER_ASSERT(reporter, cached.isClosed() == fresh.isClosed());
+
+            SkScalar distances[8];
+            for (int i = 0; i < 8; ++i) {
+                distances[i] = length * (i - 1) / 5;  // includes values to pin on both ends
+            }
+            SkPoint positions[8];
+            SkVector tangents[8];
+            REPORTER_ASSERT(reporter, cached.getPosTan(distances, 8, positions, tangents));
+            for (int i = 0; i < 8; ++i) {
+                SkPoint pos;
+                SkVector tan;
+                REPORTER_ASSERT(reporter, fresh.getPosTan(distances[i], &pos, &tan));
+                REPORTER_ASSERT(reporter, pos == positions[i]);
+                REPORTER_ASSERT(reporter, tan == tangents[i]);
+            }
+            ++contours;
+
+            bool more = cached.nextContour();
+            REPORTER_ASSERT(reporter, more == fresh.nextContour());
+            if (!more) {
+                break;
+            }
+        }
+        REPORTER_ASSERT(reporter, 2 == contours);
+        REPORTER_ASSERT(reporter, !cached.nextContour());
+    }
+
+    // Out of order distances still land on the right segments.
+    SkPathMeasure meas(path, false);
+    const SkScalar distances[] = { 150, 20, 90 };
+    SkPoint positions[3];
+    REPORTER_ASSERT(reporter, meas.getPosTan(distances, 3, positions, nullptr));
+    for (int i = 0; i < 3; ++i) {
+        SkPoint pos;
+        REPORTER_ASSERT(reporter, meas.getPosTan(distances[i], &pos, nullptr));
+        REPORTER_ASSERT(reporter, pos == positions[i]);
+    }
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "PathOpsExtendedTest.h"
+#include "SkRandom.h"
+#include "Test.h"
+
+static void testApproximate(skiatest::Reporter* reporter, const char* name, const SkPath& path,
+                            SkScalar tolerance) {
+    SkPath result;
+    if (!ApproximateSimplify(path, tolerance, &result)) {
+        ERRORF(reporter, "%s: ApproximateSimplify failed", name);
+        return;
+    }
+    REPORTER_ASSERT(reporter, result.getFillType() == (path.isInverseFillType()
+            ? SkPath::kInverseEvenOdd_FillType : SkPath::kEvenOdd_FillType));
+    REPORTER_ASSERT(reporter, !comparePaths(reporter, name, path, result));
+}
+
+DEF_TEST(PathOpsApproximateSimplify, reporter) {
+    SkPath path, result;
+    REPORTER_ASSERT(reporter, ApproximateSimplify(path, 0.25f, &result));
+    REPORTER_ASSERT(reporter, result.isEmpty());
+    REPORTER_ASSERT(reporter, !ApproximateSimplify(path, 0, &result));
+    REPORTER_ASSERT(reporter, !ApproximateSimplify(path, -1, &result));
+
+    // a bowtie: the two lobes wind in opposite directions
+    path.moveTo(0, 0);
+    path.lineTo(10, 10);
+    path.lineTo(10, 0);
+    path.lineTo(0, 10);
+    path.close();
+    testApproximate(reporter, "approximateBowtie", path, 0.25f);
+    path.setFillType(SkPath::kInverseWinding_FillType);
+    testApproximate(reporter, "approximateInverseBowtie", path, 0.25f);
+
+    // overlapping circles, the same and opposite ways around
+    path.reset();
+    path.addCircle(10, 10, 8, SkPath::kCW_Direction);
+    path.addCircle(16, 12, 8, SkPath::kCW_Direction);
+    path.addCircle(13, 18, 6, SkPath::kCCW_Direction);
+    testApproximate(reporter, "approximateCircles", path, 0.25f);
+    path.setFillType(SkPath::kEvenOdd_FillType);
+    testApproximate(reporter, "approximateCirclesEvenOdd", path, 0.25f);
+
+    // a rect covered twice, once exactly on top of itself, once backwards
+    path.reset();
+    path.addRect(0, 0, 10, 10, SkPath::kCW_Direction);
+    path.addRect(0, 0, 10, 10, SkPath::kCW_Direction);
+    path.addRect(5, 0, 15, 10, SkPath::kCCW_Direction);
+    testApproximate(reporter, "approximateCoincident", path, 0.25f);
+    REPORTER_ASSERT(reporter, ApproximateSimplify(path, 0.25f, &result));
+    SkRect bounds = result.getBounds();
+    REPORTER_ASSERT(reporter, bounds == SkRect::MakeWH(15, 10));
+
+    // a closed scribble of cubics that crosses itself many times
+    SkRandom rand;
+    for (int index = 0; index < 10; ++index) {
+        path.reset();
+        path.moveTo(rand.nextRangeF(0, 100), rand.nextRangeF(0, 100));
+        for (int curve = 0; curve < 8; ++curve) {
+            path.cubicTo(rand.nextRangeF(0, 100), rand.nextRangeF(0, 100),
+                         rand.nextRangeF(0, 100), rand.nextRangeF(0, 100),
+                         rand.nextRangeF(0, 100), rand.nextRangeF(0, 100));
+        }
+        path.close();
+        testApproximate(reporter, "approximateScribble", path, 0.1f);
+    }
+}
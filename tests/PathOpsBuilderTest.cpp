@@ -344,3 +344,41 @@ DEF_TEST(SkOpBuilder618991, reporter) {
     builder.add(path1, SkPathOp::kUnion_SkPathOp);
     builder.resolve(&path0);
 }
+
+// Overlapping non-convex paths, wound either way, are unioned in a single pass.
+DEF_TEST(BuilderOverlappingUnion, reporter) {
+    SkOpBuilder builder;
+    SkPath expected;
+    for (int index = 0; index < 12; ++index) {
+        SkScalar x = (index % 4) * 15.f;
+        SkScalar y = (index / 4) * 15.f;
+        SkPath path;
+        if (index & 1) {
+            // L-shaped footprint
+            path.moveTo(x, y);
+            path.lineTo(x + 24, y);
+            path.lineTo(x + 24, y + 10);
+            path.lineTo(x + 10, y + 10);
+            path.lineTo(x + 10, y + 24);
+            path.lineTo(x, y + 24);
+            path.close();
+        } else {
+            // footprint with a courtyard
+            path.setFillType(SkPath::kEvenOdd_FillType);
+            path.addRect(x, y, x + 22, y + 22, SkPath::kCW_Direction);
+            path.addRect(x + 6, y + 6, x + 16, y + 16, SkPath::kCW_Direction);
+        }
+        if (index % 3 == 0) {
+            SkPath reversed;
+            reversed.setFillType(path.getFillType());
+            reversed.reverseAddPath(path);
+            path = reversed;
+        }
+        builder.add(path, kUnion_SkPathOp);
+        REPORTER_ASSERT(reporter, Op(expected, path, kUnion_SkPathOp, &expected));
+    }
+    SkPath result;
+    REPORTER_ASSERT(reporter, builder.resolve(&result));
+    int pixelDiff = comparePaths(reporter, __FUNCTION__, expected, result);
+    REPORTER_ASSERT(reporter, pixelDiff == 0);
+}
@@ -2796,6 +2796,74 @@ static void test_iter(skiatest::Reporter* reporter) {
     REPORTER_ASSERT(reporter, SK_ScalarRoot2Over2 == iter.conicWeight());
 }
 
+// Runs should hold the same segments that next() returns one at a time.
+static void test_raw_iter_runs(skiatest::Reporter* reporter) {
+    SkPath p;
+    p.moveTo(0, 0);
+    p.lineTo(1, 0);
+    p.lineTo(1, 1);
+    p.lineTo(0, 1);
+    p.close();
+    p.moveTo(5, 5);
+    p.quadTo(6, 5, 6, 6);
+    p.quadTo(6, 7, 5, 7);
+    p.lineTo(4, 6);
+    p.conicTo(3, 4, 5, 5, SK_ScalarRoot2Over2);
+    p.conicTo(7, 6, 8, 8, SK_ScalarHalf);
+    p.cubicTo(9, 8, 9, 9, 8, 9);
+    p.cubicTo(7, 9, 7, 8, 8, 8);
+    p.moveTo(10, 10);
+
+    const SkPath::Verb expectedVerbs[] = {
+        SkPath::kMove_Verb, SkPath::kLine_Verb, SkPath::kClose_Verb, SkPath::kMove_Verb,
+        SkPath::kQuad_Verb, SkPath::kLine_Verb, SkPath::kConic_Verb, SkPath::kConic_Verb,
+        SkPath::kCubic_Verb, SkPath::kMove_Verb,
+    };
+    const int expectedCounts[] = { 1, 3, 1, 1, 2, 1, 1, 1, 2, 1 };
+
+    SkPath::RawIter iter(p);
+    SkPath::RawIter runIter(p);
+    const SkPoint* runPts;
+    int count;
+    SkPath::Verb verb;
+    int runs = 0;
+    while ((verb = runIter.nextRun(&runPts, &count)) != SkPath::kDone_Verb) {
+        REPORTER_ASSERT(reporter, runs < (int)SK_ARRAY_COUNT(expectedVerbs));
+        if (runs >= (int)SK_ARRAY_COUNT(expectedVerbs)) {
+            return;
+        }
+        REPORTER_ASSERT(reporter, expectedVerbs[runs] == verb);
+        REPORTER_ASSERT(reporter, expectedCounts[runs] == count);
+        for (int i = 0; i < count; ++i) {
+            SkPoint pts[4];
+            REPORTER_ASSERT(reporter, verb == iter.next(pts));
+            switch (verb) {
+                case SkPath::kMove_Verb:
+                    REPORTER_ASSERT(reporter, pts[0] == runPts[0]);
+                    break;
+                case SkPath::kLine_Verb:
+                    REPORTER_ASSERT(reporter, !memcmp(pts, &runPts[i], 2 * sizeof(SkPoint)));
+                    break;
+                case SkPath::kConic_Verb:
+                    REPORTER_ASSERT(reporter, iter.conicWeight() == runIter.conicWeight());
+                    // fall-through
+                case SkPath::kQuad_Verb:
+                    REPORTER_ASSERT(reporter, !memcmp(pts, &runPts[2 * i], 3 * sizeof(SkPoint)));
+                    break;
+                case SkPath::kCubic_Verb:
+                    REPORTER_ASSERT(reporter, !memcmp(pts, &runPts[3 * i], 4 * sizeof(SkPoint)));
+                    break;
+                default:
+                    break;
+            }
+        }
+        ++runs;
+    }
+    REPORTER_ASSERT(reporter, (int)SK_ARRAY_COUNT(expectedVerbs) == runs);
+    SkPoint pts[4];
+    REPORTER_ASSERT(reporter, SkPath::kDone_Verb == iter.next(pts));
+}
+
 static void test_raw_iter(skiatest::Reporter* reporter) {
     SkPath p;
     SkPoint pts[4];
@@ -4286,6 +4354,7 @@ DEF_TEST(Paths, reporter) {
     test_bounds(reporter);
     test_iter(reporter);
     test_raw_iter(reporter);
+    test_raw_iter_runs(reporter);
     test_circle(reporter);
     test_oval(reporter);
     test_strokerec(reporter);
@@ -8,6 +8,7 @@
 #include "SkCanvas.h"
 #include "SkPicture.h"
 #include "SkPictureRecorder.h"
+#include "SkResourceCache.h"
 #include "SkShader.h"
 #include "Test.h"
 
@@ -38,3 +39,42 @@ DEF_TEST(PictureShader_empty, reporter) {
     canvas.drawRect(SkRect::MakeWH(1,1), paint);
     REPORTER_ASSERT(reporter, *bitmap.getAddr32(0,0) == SK_ColorGREEN);
 }
+
+static int count_tiles() {
+    int count = 0;
+    SkResourceCache::VisitAll([](const SkResourceCache::Rec& rec, void* context) {
+        if (0 == strcmp(rec.getCategory(), "bitmap-shader")) {
+            (*static_cast<int*>(context))++;
+        }
+    }, &count);
+    return count;
+}
+
+// While the scale changes from draw to draw, filtered draws share a tile rendered at a nearby
+// scale, and only once the scale holds still do we render a tile at the exact scale.
+DEF_TEST(PictureShader_scaleChanging, reporter) {
+    SkPictureRecorder recorder;
+    recorder.beginRecording(100, 100)->drawColor(SK_ColorBLUE);
+    SkPaint paint;
+    paint.setShader(SkShader::MakePictureShader(recorder.finishRecordingAsPicture(),
+                                                SkShader::kRepeat_TileMode,
+                                                SkShader::kRepeat_TileMode, nullptr, nullptr));
+    paint.setFilterQuality(kLow_SkFilterQuality);
+
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(20, 20);
+    SkCanvas canvas(bitmap);
+
+    const int tiles = count_tiles();
+    const SkScalar scales[]   = { 1.0f, 1.05f, 1.1f, 1.15f, 1.15f };
+    const int      newTiles[] = {    1,     2,    2,     2,     3 };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(scales); i++) {
+        canvas.clear(SK_ColorWHITE);
+        canvas.save();
+        canvas.scale(scales[i], scales[i]);
+        canvas.drawPaint(paint);
+        canvas.restore();
+        REPORTER_ASSERT(reporter, SK_ColorBLUE == bitmap.getColor(10, 10));
+        REPORTER_ASSERT(reporter, tiles + newTiles[i] == count_tiles());
+    }
+}
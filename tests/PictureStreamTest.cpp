@@ -0,0 +1,211 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkData.h"
+#include "SkPath.h"
+#include "SkPictureRecorder.h"
+#include "SkPictureStream.h"
+#include "SkRandom.h"
+#include "SkStream.h"
+#include "Test.h"
+
+static const int kW = 200, kH = 150;
+
+// Lots of nesting and state changes, so chunks are cut at all sorts of depths.
+static void draw_content(SkCanvas* canvas) {
+    SkPictureRecorder nestedRecorder;
+    SkPaint paint;
+    paint.setColor(0xFF336699);
+    nestedRecorder.beginRecording(20, 20)->drawOval(SkRect::MakeWH(20, 20), paint);
+    sk_sp<SkPicture> nested(nestedRecorder.finishRecordingAsPicture());
+
+    SkRandom rand;
+    int depth = 0;
+    for (int i = 0; i < 300; i++) {
+        paint.setColor(rand.nextU() | 0xFF000000);
+        switch (rand.nextULessThan(10)) {
+            case 0: canvas->save(); depth++; break;
+            case 1: {
+                SkPaint layerPaint;
+                layerPaint.setAlpha(0x80);
+                canvas->saveLayer(nullptr, &layerPaint);
+                depth++;
+            } break;
+            case 2: if (depth > 0) { canvas->restore(); depth--; } break;
+            case 3: canvas->translate(rand.nextRangeScalar(-10, 10), rand.nextRangeScalar(-10, 10));
+                    break;
+            case 4: canvas->clipRect(SkRect::MakeXYWH(rand.nextRangeScalar(0, 100),
+                                                      rand.nextRangeScalar(0, 75), 120, 90));
+                    break;
+            case 5: {
+                SkMatrix m;
+                m.setRotate(rand.nextRangeScalar(-20, 20), kW/2, kH/2);
+                canvas->setMatrix(m);
+            } break;
+            case 6: canvas->drawPicture(nested.get()); break;
+            case 7: canvas->drawText("Hamburgefons", 12, rand.nextRangeScalar(0, kW),
+                                     rand.nextRangeScalar(0, kH), paint);
+                    break;
+            default:
+                canvas->drawRect(SkRect::MakeXYWH(rand.nextRangeScalar(0, kW),
+                                                  rand.nextRangeScalar(0, kH), 15, 15), paint);
+                break;
+        }
+    }
+    // Leave a few saves open for the writer and reader to deal with.
+    canvas->save();
+    canvas->translate(5, 5);
+    canvas->saveLayer(nullptr, nullptr);
+    canvas->drawRect(SkRect::MakeWH(10, 10), paint);
+}
+
+static SkBitmap make_bitmap() {
+    SkBitmap bm;
+    bm.allocN32Pixels(kW, kH);
+    bm.eraseColor(SK_ColorWHITE);
+    return bm;
+}
+
+static bool equal(const SkBitmap& a, const SkBitmap& b) {
+    return 0 == memcmp(a.getPixels(), b.getPixels(), a.getSafeSize());
+}
+
+DEF_TEST(PictureStream_MatchesPicture, r) {
+    const SkRect bounds = SkRect::MakeWH(kW, kH);
+
+    SkPictureRecorder recorder;
+    draw_content(recorder.beginRecording(bounds));
+    sk_sp<SkPicture> picture(recorder.finishRecordingAsPicture());
+
+    // SetMatrix ops are relative to the matrix we start playback with.
+    SkMatrix matrix;
+    matrix.setScale(0.75f, 1.25f);
+    matrix.postTranslate(10, -3);
+
+    SkBitmap expected = make_bitmap();
+    {
+        SkCanvas canvas(expected);
+        canvas.concat(matrix);
+        picture->playback(&canvas);
+    }
+
+    for (int chunkOpCount : { 1, 2, 3, 7, 64, SkPictureStreamWriter::kDefaultChunkOpCount }) {
+        SkDynamicMemoryWStream stream;
+        {
+            SkPictureStreamWriter writer(&stream, bounds, chunkOpCount);
+            draw_content(writer.getRecordingCanvas());
+
+            // Chunks go out as we record, not all at the end.
+            if (chunkOpCount < 64) {
+                REPORTER_ASSERT(r, stream.bytesWritten() > 1024);
+            }
+            writer.finish();
+            REPORTER_ASSERT(r, !writer.getRecordingCanvas());
+        }
+        sk_sp<SkData> data(stream.copyToData());
+
+        SkMemoryStream input(data);
+        SkPictureStreamReader reader(&input);
+        REPORTER_ASSERT(r, reader.isValid());
+        REPORTER_ASSERT(r, reader.cullRect() == bounds);
+
+        SkBitmap actual = make_bitmap();
+        SkCanvas canvas(actual);
+        canvas.concat(matrix);
+        REPORTER_ASSERT(r, reader.playback(&canvas));
+        REPORTER_ASSERT(r, equal(expected, actual));
+
+        // Playback leaves the canvas as it found it.
+        REPORTER_ASSERT(r, 1 == canvas.getSaveCount());
+        REPORTER_ASSERT(r, canvas.getTotalMatrix() == matrix);
+
+        // A stream can only be played back once.
+        REPORTER_ASSERT(r, !reader.playback(&canvas));
+    }
+}
+
+DEF_TEST(PictureStream_Invalid, r) {
+    SkDynamicMemoryWStream stream;
+    {
+        SkPictureStreamWriter writer(&stream, SkRect::MakeWH(kW, kH), 8);
+        draw_content(writer.getRecordingCanvas());
+        // Finished by the destructor.
+    }
+    sk_sp<SkData> data(stream.copyToData());
+
+    // A truncated stream draws what it can, then fails.
+    sk_sp<SkData> truncated(SkData::MakeSubset(data.get(), 0, data->size() / 2));
+    SkMemoryStream truncatedStream(truncated);
+    SkPictureStreamReader truncatedReader(&truncatedStream);
+    REPORTER_ASSERT(r, truncatedReader.isValid());
+    SkBitmap bm = make_bitmap();
+    SkCanvas canvas(bm);
+    REPORTER_ASSERT(r, !truncatedReader.playback(&canvas));
+    REPORTER_ASSERT(r, 1 == canvas.getSaveCount());
+
+    // So does a regular picture.
+    SkPictureRecorder recorder;
+    draw_content(recorder.beginRecording(SkRect::MakeWH(kW, kH)));
+    SkDynamicMemoryWStream pictureStream;
+    recorder.finishRecordingAsPicture()->serialize(&pictureStream);
+    SkAutoTDelete<SkStreamAsset> pictureInput(pictureStream.detachAsStream());
+    SkPictureStreamReader pictureReader(pictureInput);
+    REPORTER_ASSERT(r, !pictureReader.isValid());
+    REPORTER_ASSERT(r, !pictureReader.playback(&canvas));
+
+    SkPictureStreamReader nullReader(nullptr);
+    REPORTER_ASSERT(r, !nullReader.isValid());
+}
+
+// An empty clip skips ahead to the restore of its save level.  When that restore is in a later
+// chunk, playback must not skip past the end of this one.
+DEF_TEST(PictureStream_EmptyClipAcrossChunks, r) {
+    const SkRect bounds = SkRect::MakeWH(kW, kH);
+    auto draw = [](SkCanvas* canvas) {
+        SkPaint paint;
+        canvas->save();
+        canvas->translate(50, 50);
+        canvas->save();
+        canvas->clipRect(SkRect::MakeEmpty());
+        canvas->save();
+        canvas->translate(10, 10);
+        canvas->drawRect(SkRect::MakeWH(20, 20), paint);
+        canvas->restore();
+        canvas->restore();
+        canvas->drawRect(SkRect::MakeWH(20, 20), paint);   // Still translated by (50, 50).
+        canvas->restore();
+        canvas->drawRect(SkRect::MakeWH(10, 10), paint);
+    };
+
+    SkPictureRecorder recorder;
+    draw(recorder.beginRecording(bounds));
+    sk_sp<SkPicture> picture(recorder.finishRecordingAsPicture());
+    SkBitmap expected = make_bitmap();
+    {
+        SkCanvas canvas(expected);
+        picture->playback(&canvas);
+    }
+
+    // Cut the chunks after each op in turn.
+    for (int chunkOpCount = 1; chunkOpCount <= 10; chunkOpCount++) {
+        SkDynamicMemoryWStream stream;
+        {
+            SkPictureStreamWriter writer(&stream, bounds, chunkOpCount);
+            draw(writer.getRecordingCanvas());
+        }
+        sk_sp<SkData> data(stream.copyToData());
+        SkMemoryStream input(data);
+        SkPictureStreamReader reader(&input);
+
+        SkBitmap actual = make_bitmap();
+        SkCanvas canvas(actual);
+        REPORTER_ASSERT(r, reader.playback(&canvas));
+        REPORTER_ASSERT(r, equal(expected, actual));
+        REPORTER_ASSERT(r, 1 == canvas.getSaveCount());
+    }
+}
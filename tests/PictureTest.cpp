@@ -17,6 +17,7 @@
 #include "SkError.h"
 #include "SkImageEncoder.h"
 #include "SkImageGenerator.h"
+#include "SkImageReferenceResolver.h"
 #include "SkMD5.h"
 #include "SkPaint.h"
 #include "SkPicture.h"
@@ -31,10 +32,13 @@
 #include "SkRecord.h"
 #include "SkShader.h"
 #include "SkStream.h"
+#include "SkTaskGroup.h"
 #include "sk_tool_utils.h"
 
 #include "Test.h"
 
+#include <functional>
+
 #include "SkLumaColorFilter.h"
 #include "SkColorFilterImageFilter.h"
 
@@ -715,6 +719,80 @@ DEF_TEST(Picture_EncodedData, reporter) {
     REPORTER_ASSERT(reporter, referenceDigest == digest2);
 }
 
+namespace {
+
+// Serializes images by their unique ID, as if they were kept in a cache shared with the reader.
+class ImageReferenceSerializer : public SkPixelSerializer {
+public:
+    int fReferences = 0;
+
+protected:
+    bool onUseEncodedData(const void*, size_t) override { return true; }
+    SkData* onEncode(const SkPixmap&) override { return nullptr; }
+    SkData* onRefImageReference(const SkImage* image) override {
+        fReferences++;
+        uint32_t id = image->uniqueID();
+        return SkData::NewWithCopy(&id, sizeof(id));
+    }
+};
+
+class ImageReferenceResolver : public SkImageReferenceResolver {
+public:
+    ImageReferenceResolver(sk_sp<SkImage> image) : fImage(std::move(image)) {}
+
+protected:
+    sk_sp<SkImage> onResolve(const void* reference, size_t length) override {
+        uint32_t id;
+        if (length != sizeof(id)) {
+            return nullptr;
+        }
+        memcpy(&id, reference, sizeof(id));
+        return id == fImage->uniqueID() ? fImage : nullptr;
+    }
+
+private:
+    sk_sp<SkImage> fImage;
+};
+
+}  // namespace
+
+DEF_TEST(Picture_ImageReferences, reporter) {
+    SkBitmap bm;
+    make_bm(&bm, 10, 10, SK_ColorBLUE, true);
+    sk_sp<SkImage> image(SkImage::MakeFromBitmap(bm));
+
+    SkPictureRecorder recorder;
+    recorder.beginRecording(10, 10)->drawImage(image.get(), 0, 0);
+    sk_sp<SkPicture> picture(recorder.finishRecordingAsPicture());
+
+    ImageReferenceSerializer serializer;
+    SkDynamicMemoryWStream wStream;
+    picture->serialize(&wStream, &serializer);
+    REPORTER_ASSERT(reporter, 1 == serializer.fReferences);
+    sk_sp<SkData> data(wStream.copyToData());
+    // Only the reference was written, not the pixels.
+    REPORTER_ASSERT(reporter, data->size() < bm.getSize());
+
+    // With the resolver, the picture draws the very same image.
+    ImageReferenceResolver resolver(image);
+    sk_sp<SkPicture> copy(SkPicture::MakeFromData(data, nullptr, &resolver));
+    REPORTER_ASSERT(reporter, copy);
+    SkBitmap dst;
+    dst.allocN32Pixels(10, 10);
+    dst.eraseColor(SK_ColorRED);
+    SkCanvas canvas(dst);
+    canvas.drawPicture(copy);
+    REPORTER_ASSERT(reporter, SK_ColorBLUE == dst.getColor(5, 5));
+
+    // Without it, the picture still loads, with a blank placeholder in the image's place.
+    SkMemoryStream stream(data);
+    copy = SkPicture::MakeFromStream(&stream);
+    REPORTER_ASSERT(reporter, copy);
+    dst.eraseColor(SK_ColorRED);
+    canvas.drawPicture(copy);
+    REPORTER_ASSERT(reporter, SK_ColorRED == dst.getColor(5, 5));
+}
+
 static void test_clip_bound_opt(skiatest::Reporter* reporter) {
     // Test for crbug.com/229011
     SkRect rect1 = SkRect::MakeXYWH(SkIntToScalar(4), SkIntToScalar(4),
@@ -810,8 +888,9 @@ static void test_cull_rect_reset(skiatest::Reporter* reporter) {
     SkCanvas* canvas = recorder.beginRecording(bounds, &factory);
     bounds = SkRect::MakeWH(100, 100);
     SkPaint paint;
-    canvas->drawRect(bounds, paint);
-    canvas->drawRect(bounds, paint);
+    for (int i = 0; i <= SkMiniRecorder::kMaxOps; i++) {  // Any fewer would be an SkMiniPicture.
+        canvas->drawRect(bounds, paint);
+    }
     sk_sp<SkPicture> p(recorder.finishRecordingAsPictureWithCull(bounds));
     const SkBigPicture* picture = p->asSkBigPicture();
     REPORTER_ASSERT(reporter, picture);
@@ -1105,8 +1184,9 @@ DEF_TEST(Picture_SkipBBH, r) {
     SkPictureRecorder recorder;
     SkCanvas* c = recorder.beginRecording(bound, &factory);
     // Record a few ops so we don't hit a small- or empty- picture optimization.
+    for (int i = 0; i <= SkMiniRecorder::kMaxOps; i++) {
         c->drawRect(bound, SkPaint());
-        c->drawRect(bound, SkPaint());
+    }
     sk_sp<SkPicture> picture(recorder.finishRecordingAsPicture());
 
     SkCanvas big(640, 480), small(300, 200);
@@ -1118,6 +1198,158 @@ DEF_TEST(Picture_SkipBBH, r) {
     REPORTER_ASSERT(r, bbh.searchCalls == 1);
 }
 
+// Antialiased paths can rasterize slightly differently when clipped to band boundaries, so like
+// SurfaceThreadedRaster we stick to rects, which are exact however they're clipped.  The blur
+// does round a little differently on layers of different sizes.
+static void draw_band_test_content(SkCanvas* c) {
+    SkRandom rand;
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    for (int i = 0; i < 50; i++) {
+        paint.setColor(rand.nextU() | 0xFF000000);
+        c->drawRect(SkRect::MakeXYWH(rand.nextRangeScalar(0, 300), rand.nextRangeScalar(0, 200),
+                                     rand.nextRangeScalar(2, 60), rand.nextRangeScalar(2, 60)),
+                    paint);
+    }
+
+    // A blur reads pixels from beyond its own band.
+    SkPaint layerPaint;
+    layerPaint.setImageFilter(SkBlurImageFilter::Make(4, 4, nullptr));
+    c->saveLayer(nullptr, &layerPaint);
+        paint.setColor(0x8033CC66);
+        c->drawRect(SkRect::MakeXYWH(60.5f, 40.25f, 120, 90.5f), paint);
+        paint.setTextSize(24);
+        paint.setColor(SK_ColorBLACK);
+        c->drawText("Hamburgefons", 12, 40, 100, paint);
+    c->restore();
+}
+
+static int max_channel_diff(const SkBitmap& a, const SkBitmap& b) {
+    int diff = 0;
+    for (int y = 0; y < a.height(); y++) {
+        for (int x = 0; x < a.width(); x++) {
+            SkPMColor pa = *a.getAddr32(x, y),
+                      pb = *b.getAddr32(x, y);
+            for (int shift = 0; shift < 32; shift += 8) {
+                diff = SkTMax(diff, SkAbs32((int)((pa >> shift) & 0xFF) -
+                                            (int)((pb >> shift) & 0xFF)));
+            }
+        }
+    }
+    return diff;
+}
+
+DEF_TEST(Picture_playbackInBands, r) {
+    const SkRect bounds = SkRect::MakeWH(300, 200);
+    SkRTreeFactory factory;
+    SkBBHFactory* factories[] = { &factory, nullptr };
+    for (SkBBHFactory* bbh : factories) {
+        SkPictureRecorder recorder;
+        draw_band_test_content(recorder.beginRecording(bounds, bbh));
+        sk_sp<SkPicture> picture(recorder.finishRecordingAsPicture());
+
+        SkMatrix matrix;
+        matrix.setScale(0.75f, 1.25f);
+        matrix.postTranslate(10, -3);
+
+        const SkMatrix* matrices[] = { nullptr, &matrix };
+        for (const SkMatrix* m : matrices) {
+            SkBitmap expected;
+            expected.allocN32Pixels(300, 200);
+            expected.eraseColor(SK_ColorWHITE);
+            {
+                SkCanvas canvas(expected);
+                if (m) {
+                    canvas.concat(*m);
+                }
+                picture->playback(&canvas);
+            }
+
+            for (int bands : { 0, 1, 3, 7, 200, 1000 }) {
+                SkBitmap banded;
+                banded.allocN32Pixels(300, 200);
+                banded.eraseColor(SK_ColorWHITE);
+                picture->playbackInBands(banded, m, bands);
+                REPORTER_ASSERT(r, max_channel_diff(expected, banded) <= 2);
+            }
+        }
+    }
+}
+
+DEF_TEST(Picture_MakeFromData, r) {
+    const SkRect bounds = SkRect::MakeWH(300, 200);
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(bounds);
+    draw_band_test_content(canvas);
+    {
+        SkPath path;
+        path.addCircle(150, 100, 40);
+        path.addOval(SkRect::MakeXYWH(20, 120, 80, 40), SkPath::kCCW_Direction);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        paint.setColor(0xFF4488CC);
+        canvas->drawPath(path, paint);
+
+        SkBitmap bitmap;
+        make_bm(&bitmap, 20, 20, SK_ColorRED, true);
+        canvas->drawImage(SkImage::MakeFromBitmap(bitmap), 250, 150);
+
+        SkPictureRecorder nested;
+        nested.beginRecording(50, 50)->drawRect(SkRect::MakeWH(50, 50), paint);
+        canvas->drawPicture(nested.finishRecordingAsPicture());
+    }
+    sk_sp<SkPicture> picture(recorder.finishRecordingAsPicture());
+
+    SkDynamicMemoryWStream stream;
+    picture->serialize(&stream);
+    sk_sp<SkData> data(stream.copyToData());
+
+    SkMemoryStream copy(data);
+    sk_sp<SkPicture> streamed(SkPicture::MakeFromStream(&copy)),
+                     mapped(SkPicture::MakeFromData(data));
+    REPORTER_ASSERT(r, streamed && mapped);
+    if (!streamed || !mapped) {
+        return;
+    }
+    REPORTER_ASSERT(r, mapped->cullRect() == picture->cullRect());
+    REPORTER_ASSERT(r, mapped->approximateOpCount() > 0);
+    REPORTER_ASSERT(r, mapped->willPlayBackBitmaps());
+
+    auto draw = [](const SkPicture* pic) {
+        SkBitmap bm;
+        bm.allocN32Pixels(300, 200);
+        bm.eraseColor(SK_ColorWHITE);
+        SkCanvas canvas(bm);
+        canvas.drawPicture(pic);
+        return bm;
+    };
+    SkBitmap expected = draw(streamed.get());
+    REPORTER_ASSERT(r, 0 == max_channel_diff(expected, draw(mapped.get())));
+
+    // Many threads can play back from the same op data at once.
+    SkTaskGroup().batch(8, [&](int) {
+        REPORTER_ASSERT(r, 0 == max_channel_diff(expected, draw(mapped.get())));
+    });
+
+    // Serializing it again should round trip.
+    SkDynamicMemoryWStream again;
+    mapped->serialize(&again);
+    sk_sp<SkData> reserialized(again.copyToData());
+    sk_sp<SkPicture> roundTrip(SkPicture::MakeFromData(reserialized));
+    REPORTER_ASSERT(r, roundTrip && 0 == max_channel_diff(expected, draw(roundTrip.get())));
+
+    // The loaded picture keeps its data alive.
+    data.reset();
+    REPORTER_ASSERT(r, 0 == max_channel_diff(expected, draw(mapped.get())));
+
+    // Truncated data is rejected rather than read past.
+    for (size_t size : { (size_t)0, (size_t)16, reserialized->size() / 2 }) {
+        sk_sp<SkData> truncated(SkData::MakeSubset(reserialized.get(), 0, size));
+        REPORTER_ASSERT(r, !SkPicture::MakeFromData(truncated));
+    }
+    REPORTER_ASSERT(r, !SkPicture::MakeFromData(nullptr));
+}
+
 DEF_TEST(Picture_BitmapLeak, r) {
     SkBitmap mut, immut;
     mut.allocN32Pixels(300, 200);
@@ -1170,9 +1402,62 @@ DEF_TEST(MiniRecorderLeftHanging, r) {
 
     SkMiniRecorder rec;
     REPORTER_ASSERT(r, rec.drawRect(SkRect::MakeWH(20,30), paint));
+    REPORTER_ASSERT(r, rec.drawOval(SkRect::MakeWH(30,20), paint));
     // Don't call rec.detachPicture().  Test succeeds by not asserting or leaking the shader.
 }
 
+DEF_TEST(MiniRecorder_SmallPictures, r) {
+    SkPath path;
+    path.addCircle(30, 30, 10);
+    auto draw = [&](SkCanvas* canvas, int ops) {
+        SkPaint paint;
+        for (int i = 0; i < ops; i++) {
+            paint.setColor(0xFF000000 | i * 0x203040);
+            switch (i % 4) {
+                case 0: canvas->drawRect(SkRect::MakeXYWH(i, i, 20, 10), paint); break;
+                case 1: canvas->drawPath(path, paint); break;
+                case 2: canvas->drawOval(SkRect::MakeXYWH(40, i, 20, 30), paint); break;
+                case 3: canvas->drawRRect(SkRRect::MakeRectXY(SkRect::MakeXYWH(i, 50, 30, 20),
+                                                              4, 4), paint); break;
+            }
+        }
+    };
+    auto rasterize = [](const std::function<void(SkCanvas*)>& fn) {
+        SkBitmap bm;
+        bm.allocN32Pixels(64, 64);
+        bm.eraseColor(SK_ColorWHITE);
+        SkCanvas canvas(bm);
+        fn(&canvas);
+        return bm;
+    };
+
+    for (int ops = 1; ops <= SkMiniRecorder::kMaxOps + 1; ops++) {
+        SkPictureRecorder recorder;
+        draw(recorder.beginRecording(SkRect::MakeWH(64, 64)), ops);
+        sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+        // Only pictures too big for the mini recorder need an SkRecord.
+        REPORTER_ASSERT(r, (ops > SkMiniRecorder::kMaxOps) == !!picture->asSkBigPicture());
+        REPORTER_ASSERT(r, ops == picture->approximateOpCount());
+        REPORTER_ASSERT(r, !picture->willPlayBackBitmaps());
+
+        SkBitmap expected = rasterize([&](SkCanvas* canvas) { draw(canvas, ops); }),
+                 actual   = rasterize([&](SkCanvas* canvas) { canvas->drawPicture(picture); });
+        REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                       expected.getSafeSize()));
+    }
+
+    // Anything the mini recorder can't hold flushes what it has into the SkRecord, in order.
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(64, 64));
+    draw(canvas, 3);
+    canvas->translate(5, 5);
+    draw(canvas, 2);
+    sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+    REPORTER_ASSERT(r, picture->asSkBigPicture());
+    REPORTER_ASSERT(r, 6 == picture->approximateOpCount());
+}
+
 DEF_TEST(Picture_preserveCullRect, r) {
     SkPictureRecorder recorder;
 
@@ -1242,6 +1527,67 @@ DEF_TEST(PictureGpuAnalyzer, r) {
     REPORTER_ASSERT(r, !analyzer.suitableForGpuRasterization());
 }
 
+DEF_TEST(PictureGpuAnalyzer_Cost, r) {
+    SkPath path;
+    path.addCircle(50, 50, 20);
+    const uint32_t verbs = path.countVerbs();
+
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(100, 100);
+    canvas->drawRect(SkRect::MakeWH(100, 100), SkPaint());
+    canvas->saveLayerAlpha(nullptr, 0x80);
+    canvas->drawPath(path, SkPaint());
+    canvas->drawPath(path, SkPaint());
+    canvas->restore();
+    sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+    SkPictureGpuAnalyzer analyzer(picture);
+    REPORTER_ASSERT(r, 2 * verbs == analyzer.numPathVerbs());
+    REPORTER_ASSERT(r, 1 == analyzer.numLayers());
+    REPORTER_ASSERT(r, SkTAbs(analyzer.pixelCoverage() - (100*100 + 2*40*40)) < 1);
+
+    // Nested pictures count as often as they're drawn, their coverage scaled to how they're drawn.
+    canvas = recorder.beginRecording(100, 100);
+    canvas->drawPicture(picture);
+    const SkMatrix half = SkMatrix::MakeScale(0.5f);
+    canvas->drawPicture(picture, &half, nullptr);
+    sk_sp<SkPicture> nested = recorder.finishRecordingAsPicture();
+
+    analyzer.reset();
+    analyzer.analyzePicture(nested.get());
+    REPORTER_ASSERT(r, 4 * verbs == analyzer.numPathVerbs());
+    REPORTER_ASSERT(r, 2 == analyzer.numLayers());
+    REPORTER_ASSERT(r, SkTAbs(analyzer.pixelCoverage() - 1.25 * (100*100 + 2*40*40)) < 1);
+
+    // Small pictures are costed too, clipped to their cull rect.
+    canvas = recorder.beginRecording(100, 100);
+    canvas->drawRect(SkRect::MakeWH(200, 50), SkPaint());
+    canvas->drawPath(path, SkPaint());
+    sk_sp<SkPicture> mini = recorder.finishRecordingAsPicture();
+    REPORTER_ASSERT(r, !mini->asSkBigPicture());
+
+    analyzer.reset();
+    analyzer.analyzeClipPath(path, SkRegion::kIntersect_Op, true);
+    analyzer.analyzePicture(mini.get());
+    REPORTER_ASSERT(r, 2 * verbs == analyzer.numPathVerbs());
+    REPORTER_ASSERT(r, 0 == analyzer.numLayers());
+    REPORTER_ASSERT(r, SkTAbs(analyzer.pixelCoverage() - (100*50 + 40*40)) < 1);
+
+    // Drawables cost what the snapshots we play back for them cost.
+    recorder.beginRecording(100, 100)->drawPicture(picture);
+    sk_sp<SkDrawable> drawable = recorder.finishRecordingAsDrawable();
+    canvas = recorder.beginRecording(100, 100);
+    canvas->drawDrawable(drawable.get());
+    canvas->drawDrawable(drawable.get());
+    sk_sp<SkPicture> withDrawables = recorder.finishRecordingAsPicture();
+
+    analyzer.reset();
+    analyzer.analyzePicture(withDrawables.get());
+    REPORTER_ASSERT(r, 4 * verbs == analyzer.numPathVerbs());
+    REPORTER_ASSERT(r, 2 == analyzer.numLayers());
+    REPORTER_ASSERT(r, SkTAbs(analyzer.pixelCoverage() - 2 * (100*100 + 2*40*40)) < 1);
+}
+
 #endif // SK_SUPPORT_GPU
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1303,3 +1649,56 @@ DEF_TEST(Picture_RecordEmpty, r) {
         }
     }
 }
+
+DEF_TEST(PictureRecorder_ReuseRecordMemory, r) {
+    auto record_frame = [](SkPictureRecorder* recorder, int frame) {
+        SkCanvas* canvas = recorder->beginRecording(SkRect::MakeWH(100, 100), nullptr,
+                                                    SkPictureRecorder::kReuseRecordMemory_RecordFlag);
+        SkPaint paint;
+        for (int i = 0; i < 500; i++) {
+            paint.setColor(0xFF000000 | (frame * 0x111111 + i * 0x010203));
+            canvas->drawRect(SkRect::MakeXYWH(i % 90, (i / 10) % 90, 10, 10), paint);
+        }
+        return recorder->finishRecordingAsPicture();
+    };
+    auto mallocs = [](const SkPicture* picture) {
+        return picture->asSkBigPicture()->record()->mallocCount();
+    };
+    auto draw = [](const SkPicture* picture) {
+        SkBitmap bm;
+        bm.allocN32Pixels(100, 100);
+        bm.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas(bm).drawPicture(picture);
+        return bm;
+    };
+
+    SkPictureRecorder recorder;
+    sk_sp<SkPicture> first = record_frame(&recorder, 0);
+    const int firstMallocs = mallocs(first.get());
+    REPORTER_ASSERT(r, firstMallocs > 2);
+
+    // While the last picture is alive, we can only make room up front to record as much again.
+    sk_sp<SkPicture> second = record_frame(&recorder, 1);
+    REPORTER_ASSERT(r, mallocs(second.get()) <= 2);
+
+    // Once it's gone, we record into its memory without mallocing at all.
+    SkBitmap expected = draw(second.get());
+    second.reset(nullptr);
+    sk_sp<SkPicture> third = record_frame(&recorder, 1);
+    REPORTER_ASSERT(r, mallocs(third.get()) == 0);
+
+    SkBitmap actual = draw(third.get());
+    REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                   expected.getSafeSize()));
+
+    // Dropping the flag stops holding on to the last record.
+    first.reset(nullptr);
+    third.reset(nullptr);
+    SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(100, 100));
+    for (int i = 0; i <= SkMiniRecorder::kMaxOps; i++) {  // Any fewer would be an SkMiniPicture.
+        canvas->drawRect(SkRect::MakeWH(10, 10), SkPaint());
+    }
+    sk_sp<SkPicture> fourth = recorder.finishRecordingAsPicture();
+    // A fresh record has to malloc room for that many ops, where a reused one wouldn't.
+    REPORTER_ASSERT(r, fourth->asSkBigPicture()->record()->mallocCount() > 0);
+}
@@ -0,0 +1,158 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkImage.h"
+#include "SkPath.h"
+#include "SkPipe.h"
+#include "SkShader.h"
+#include "SkStream.h"
+#include "SkSurface.h"
+#include "SkTextBlob.h"
+#include "Test.h"
+
+#include <functional>
+
+static const int kSize = 64;
+
+static sk_sp<SkImage> make_image() {
+    auto surface(SkSurface::MakeRasterN32Premul(8, 8));
+    surface->getCanvas()->clear(SK_ColorGREEN);
+    SkPaint paint;
+    paint.setColor(SK_ColorRED);
+    surface->getCanvas()->drawRect(SkRect::MakeWH(4, 4), paint);
+    return surface->makeImageSnapshot();
+}
+
+// Draws a frame using every kind of resource the pipe caches.  frame changes some of the draws,
+// and the paint of one of them.
+static void draw_frame(SkCanvas* canvas, int frame, const SkImage* image, const SkPath& path,
+                       const SkTextBlob* blob) {
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(SK_ColorBLUE);
+    canvas->drawRect(SkRect::MakeXYWH(2, 2, 20, 20), paint);
+    canvas->drawPath(path, paint);
+
+    canvas->save();
+    canvas->translate(SkIntToScalar(frame), 0);
+    canvas->clipPath(path, SkRegion::kIntersect_Op, true);
+    canvas->drawImage(image, 10, 10);
+    canvas->restore();
+
+    SkPaint shaderPaint;
+    shaderPaint.setShader(image->makeShader(SkShader::kRepeat_TileMode,
+                                            SkShader::kRepeat_TileMode));
+    canvas->drawOval(SkRect::MakeXYWH(30, 30, 30, 20), shaderPaint);
+
+    paint.setAlpha(0x80);
+    canvas->saveLayer(nullptr, &paint);
+    canvas->drawText("pipe", 4, 4, 60, paint);
+    canvas->drawTextBlob(blob, SkIntToScalar(frame), 40, paint);
+    canvas->restore();
+
+    paint.setColor(0xFF000000 | frame * 0x102030);
+    canvas->drawCircle(50, 10, 8, paint);
+}
+
+static void draw_to_bitmap(SkBitmap* bitmap, const std::function<void(SkCanvas*)>& draw) {
+    bitmap->allocN32Pixels(kSize, kSize);
+    bitmap->eraseColor(SK_ColorWHITE);
+    SkCanvas canvas(*bitmap);
+    draw(&canvas);
+}
+
+static bool equal_pixels(const SkBitmap& a, const SkBitmap& b) {
+    SkAutoLockPixels lockA(a), lockB(b);
+    return 0 == memcmp(a.getPixels(), b.getPixels(), a.getSize());
+}
+
+DEF_TEST(Pipe, reporter) {
+    sk_sp<SkImage> image(make_image());
+    SkPath path;
+    path.addCircle(32, 32, 20);
+    path.addRect(SkRect::MakeXYWH(5, 40, 20, 10));
+
+    SkPaint font;
+    font.setTextSize(12);
+    uint16_t glyphs[3];
+    font.textToGlyphs("abc", 3, glyphs);
+    font.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+    SkTextBlobBuilder builder;
+    const SkTextBlobBuilder::RunBuffer& run = builder.allocRun(font, 3, 0, 0);
+    memcpy(run.glyphs, glyphs, sizeof(glyphs));
+    SkAutoTUnref<const SkTextBlob> blob(builder.build());
+
+    SkPipeSerializer serializer;
+    SkPipeDeserializer deserializer;
+    const SkRect bounds = SkRect::MakeWH(kSize, kSize);
+
+    size_t firstFrameSize = 0;
+    for (int frame = 0; frame < 4; frame++) {
+        if (3 == frame) {
+            serializer.resetCache();
+        }
+
+        SkDynamicMemoryWStream stream;
+        draw_frame(serializer.beginWrite(bounds, &stream), frame, image.get(), path, blob.get());
+        serializer.endWrite();
+        const size_t frameSize = stream.bytesWritten();
+
+        // After the first frame, only the new paint and the draws themselves are sent.
+        if (0 == frame || 3 == frame) {
+            firstFrameSize = SkTMax(firstFrameSize, frameSize);
+        } else {
+            REPORTER_ASSERT(reporter, frameSize * 2 < firstFrameSize);
+        }
+
+        SkBitmap expected, actual;
+        draw_to_bitmap(&expected, [&](SkCanvas* canvas) {
+            draw_frame(canvas, frame, image.get(), path, blob.get());
+        });
+        std::unique_ptr<SkStreamAsset> data(stream.detachAsStream());
+        draw_to_bitmap(&actual, [&](SkCanvas* canvas) {
+            REPORTER_ASSERT(reporter, deserializer.playback(data.get(), canvas));
+            REPORTER_ASSERT(reporter, 1 == canvas->getSaveCount());
+            // The stream holds just the one frame.
+            REPORTER_ASSERT(reporter, !deserializer.playback(data.get(), canvas));
+        });
+        REPORTER_ASSERT(reporter, equal_pixels(expected, actual));
+    }
+
+    // A frame that refers to resources the deserializer never got is rejected.
+    {
+        SkPipeSerializer other;
+        SkDynamicMemoryWStream stream;
+        SkCanvas* canvas = other.beginWrite(bounds, &stream);
+        canvas->drawPath(path, SkPaint());
+        other.endWrite();
+        SkDynamicMemoryWStream again;
+        canvas = other.beginWrite(bounds, &again);
+        canvas->drawPath(path, SkPaint());
+        other.endWrite();
+
+        SkPipeDeserializer fresh;
+        std::unique_ptr<SkStreamAsset> data(again.detachAsStream());
+        SkBitmap bitmap;
+        draw_to_bitmap(&bitmap, [&](SkCanvas* canvas) {
+            REPORTER_ASSERT(reporter, !fresh.playback(data.get(), canvas));
+        });
+    }
+
+    // So is a truncated one.
+    {
+        SkDynamicMemoryWStream stream;
+        draw_frame(serializer.beginWrite(bounds, &stream), 0, image.get(), path, blob.get());
+        serializer.endWrite();
+        sk_sp<SkData> data(stream.copyToData());
+        SkMemoryStream truncated(data->data(), data->size() - 4);
+        SkBitmap bitmap;
+        draw_to_bitmap(&bitmap, [&](SkCanvas* canvas) {
+            REPORTER_ASSERT(reporter, !deserializer.playback(&truncated, canvas));
+        });
+    }
+}
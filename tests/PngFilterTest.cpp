@@ -0,0 +1,72 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkOpts.h"
+#include "SkRandom.h"
+#include "Test.h"
+
+// Straight from the PNG spec, one byte at a time.
+static void brute_force_unfilter(int filter, uint8_t* row, const uint8_t* prev,
+                                 size_t rowBytes, int bpp) {
+    for (size_t i = 0; i < rowBytes; i++) {
+        int a = i >= (size_t)bpp ? row[i - bpp]  : 0,
+            b = prev[i],
+            c = i >= (size_t)bpp ? prev[i - bpp] : 0;
+        int p = a + b - c,
+            pa = SkAbs32(p - a),
+            pb = SkAbs32(p - b),
+            pc = SkAbs32(p - c);
+        switch (filter) {
+            case 1: row[i] += a;                                                  break;
+            case 2: row[i] += b;                                                  break;
+            case 3: row[i] += (a + b) / 2;                                        break;
+            case 4: row[i] += pa <= pb && pa <= pc ? a : pb <= pc ? b : c;        break;
+        }
+    }
+}
+
+DEF_TEST(PngFilter_Unfilter, r) {
+    const SkOpts::PngUnfilter unfilters[] = {
+        nullptr,
+        SkOpts::png_unfilter_sub,
+        SkOpts::png_unfilter_up,
+        SkOpts::png_unfilter_avg,
+        SkOpts::png_unfilter_paeth,
+    };
+
+    SkRandom rand;
+    for (int bpp = 1; bpp <= 4; bpp++) {
+        // Odd pixel counts, so the SIMD code has tails to deal with.
+        for (int width : { 1, 5, 17, 63 }) {
+            const size_t rowBytes = width * bpp;
+            uint8_t prev[256], row[256], expected[256];
+            for (size_t i = 0; i < rowBytes; i++) {
+                prev[i] = rand.nextU();
+                row[i]  = rand.nextU();
+            }
+            // Lean on the extremes too, where Paeth has ties and averaging can round wrong.
+            if (width == 63) {
+                for (size_t i = 0; i < rowBytes; i += 2) {
+                    prev[i] = rand.nextBool() ? 0xFF : 0x00;
+                    row[i]  = rand.nextBool() ? 0xFF : 0x01;
+                }
+            }
+
+            for (int filter = 1; filter <= 4; filter++) {
+                memcpy(expected, row, rowBytes);
+                brute_force_unfilter(filter, expected, prev, rowBytes, bpp);
+
+                uint8_t actual[256];
+                memcpy(actual, row, rowBytes);
+                unfilters[filter](actual, prev, rowBytes, bpp);
+                if (0 != memcmp(actual, expected, rowBytes)) {
+                    ERRORF(r, "filter %d, bpp %d, width %d doesn't match", filter, bpp, width);
+                }
+            }
+        }
+    }
+}
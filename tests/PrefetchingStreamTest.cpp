@@ -0,0 +1,92 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkPrefetchingStream.h"
+#include "SkStream.h"
+#include "SkTemplates.h"
+#include "Test.h"
+
+// A stream that never returns more than a few bytes from a read, like a slow
+// network stream might.
+class DribblingStream : public SkMemoryStream {
+public:
+    DribblingStream(const void* data, size_t length) : INHERITED(data, length, false) {}
+
+    size_t read(void* buffer, size_t size) override {
+        return this->INHERITED::read(buffer, SkTMin<size_t>(size, 7));
+    }
+
+    bool hasPosition() const override { return false; }
+
+private:
+    typedef SkMemoryStream INHERITED;
+};
+
+static void test_stream(skiatest::Reporter* reporter, const uint8_t* data, size_t length,
+                        SkStream* wrapped, size_t blockSize, int blockCount) {
+    SkAutoTDelete<SkStream> stream(SkPrefetchingStream::Create(wrapped, blockSize, blockCount));
+    REPORTER_ASSERT(reporter, stream);
+
+    uint8_t peeked[16];
+    const size_t bytesPeeked = stream->peek(peeked, sizeof(peeked));
+    REPORTER_ASSERT(reporter, bytesPeeked == SkTMin(sizeof(peeked), SkTMin(blockSize, length)));
+    REPORTER_ASSERT(reporter, 0 == memcmp(peeked, data, bytesPeeked));
+
+    // Read in uneven pieces that straddle the blocks, skipping some of them.
+    SkAutoTMalloc<uint8_t> storage(length);
+    size_t offset = 0;
+    for (size_t piece = 1; offset < length; piece = piece * 3 + 1) {
+        const bool skip = 0 == piece % 2;
+        const size_t bytesRead = stream->read(skip ? nullptr : storage.get() + offset, piece);
+        REPORTER_ASSERT(reporter, bytesRead == SkTMin(piece, length - offset));
+        if (!skip) {
+            REPORTER_ASSERT(reporter, 0 == memcmp(storage.get() + offset, data + offset,
+                                                  bytesRead));
+        }
+        offset += bytesRead;
+        REPORTER_ASSERT(reporter, stream->getPosition() == offset);
+    }
+    REPORTER_ASSERT(reporter, stream->isAtEnd());
+    REPORTER_ASSERT(reporter, 0 == stream->read(storage.get(), 1));
+}
+
+DEF_TEST(PrefetchingStream, reporter) {
+    const size_t kLength = 5000;
+    uint8_t data[kLength];
+    for (size_t i = 0; i < kLength; i++) {
+        data[i] = (uint8_t) (i * 31 + (i >> 8));
+    }
+
+    // Block sizes that divide the data evenly, and that don't.
+    const size_t blockSizes[] = { 1, 64, 1000, 1024, kLength, 8192 };
+    for (size_t blockSize : blockSizes) {
+        for (int blockCount = 1; blockCount <= 3; blockCount++) {
+            test_stream(reporter, data, kLength, new SkMemoryStream(data, kLength, false),
+                        blockSize, blockCount);
+            test_stream(reporter, data, kLength, new DribblingStream(data, kLength),
+                        blockSize, blockCount);
+        }
+    }
+
+    // An empty stream ends right away.
+    SkAutoTDelete<SkStream> empty(SkPrefetchingStream::Create(new SkMemoryStream()));
+    REPORTER_ASSERT(reporter, empty->isAtEnd());
+    uint8_t byte;
+    REPORTER_ASSERT(reporter, 0 == empty->read(&byte, 1));
+
+    // The length comes from the wrapped stream, when it knows it.
+    SkAutoTDelete<SkStream> withLength(SkPrefetchingStream::Create(
+            new SkMemoryStream(data, kLength, false)));
+    REPORTER_ASSERT(reporter, withLength->hasLength() && kLength == withLength->getLength());
+
+    // Stop a stream that is still reading ahead.
+    SkAutoTDelete<SkStream> abandoned(SkPrefetchingStream::Create(
+            new DribblingStream(data, kLength), 16, 2));
+    REPORTER_ASSERT(reporter, 1 == abandoned->read(&byte, 1) && data[0] == byte);
+
+    REPORTER_ASSERT(reporter, nullptr == SkPrefetchingStream::Create(nullptr));
+}
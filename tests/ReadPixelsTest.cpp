@@ -459,3 +459,61 @@ DEF_GPUTEST_FOR_RENDERING_CONTEXTS(ReadPixels_Texture, reporter, ctxInfo) {
     }
 }
 #endif
+
+#if SK_SUPPORT_GPU
+static void async_readback_finished(void* finishedContext, GrAsyncReadback*) {
+    ++*static_cast<int*>(finishedContext);
+}
+
+DEF_GPUTEST_FOR_RENDERING_CONTEXTS(ReadPixels_Async, reporter, ctxInfo) {
+    GrContext* context = ctxInfo.grContext();
+    SkAutoTMalloc<uint32_t> srcPixels(DEV_W * DEV_H);
+    for (int y = 0; y < DEV_H; ++y) {
+        for (int x = 0; x < DEV_W; ++x) {
+            srcPixels[y * DEV_W + x] = get_src_color(x, y);
+        }
+    }
+    for (auto& origin : {kBottomLeft_GrSurfaceOrigin, kTopLeft_GrSurfaceOrigin}) {
+        GrSurfaceDesc desc;
+        desc.fFlags = kRenderTarget_GrSurfaceFlag;
+        desc.fWidth = DEV_W;
+        desc.fHeight = DEV_H;
+        desc.fConfig = kSkia8888_GrPixelConfig;
+        desc.fOrigin = origin;
+        SkAutoTUnref<GrTexture> texture(context->textureProvider()->createTexture(
+                desc, SkBudgeted::kNo, srcPixels.get(), 0));
+        if (!texture) {
+            continue;
+        }
+
+        const SkIRect rect = SkIRect::MakeXYWH(10, 20, 50, 40);
+        int finishedCount = 0;
+        sk_sp<GrAsyncReadback> readback(context->readSurfacePixelsAsync(
+                texture, rect.fLeft, rect.fTop, rect.width(), rect.height(),
+                kSkia8888_GrPixelConfig, async_readback_finished, &finishedCount));
+        if (!readback) {
+            // Not every backend can read back asynchronously.
+            continue;
+        }
+        REPORTER_ASSERT(reporter, 1 == readback->numPlanes());
+        REPORTER_ASSERT(reporter, rect.size() == readback->planeSize(0));
+
+        SkAutoTMalloc<uint32_t> asyncPixels(rect.width() * rect.height());
+        REPORTER_ASSERT(reporter, readback->readPixels(0, asyncPixels.get(), 0));
+        REPORTER_ASSERT(reporter, readback->isFinished() && !readback->failed());
+        REPORTER_ASSERT(reporter, 1 == finishedCount);
+
+        // The readback was already finished, so checking again mustn't call the proc again.
+        context->checkAsyncReadbacks();
+        REPORTER_ASSERT(reporter, 1 == finishedCount);
+
+        SkAutoTMalloc<uint32_t> syncPixels(rect.width() * rect.height());
+        REPORTER_ASSERT(reporter, context->readSurfacePixels(texture, rect.fLeft, rect.fTop,
+                                                             rect.width(), rect.height(),
+                                                             kSkia8888_GrPixelConfig,
+                                                             syncPixels.get()));
+        REPORTER_ASSERT(reporter, !memcmp(asyncPixels.get(), syncPixels.get(),
+                                          rect.width() * rect.height() * sizeof(uint32_t)));
+    }
+}
+#endif
@@ -305,3 +305,43 @@ DEF_TEST(RecordDraw_drawImage, r){
     REPORTER_ASSERT(r, canvas.fDrawImageRectCalled);
 
 }
+
+// Long records have their bounds filled in span by span, each span starting at the top level
+// with the matrix and clip the ops before it left behind.
+DEF_TEST(RecordDraw_LongRecordBounds, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    const int kBlocks = 2000;
+    for (int i = 0; i < kBlocks; i++) {
+        // Every tenth block moves things down and changes the clip, outside any Save.
+        if (0 == i % 10) {
+            recorder.translate(0, 2);
+            recorder.clipRect(SkRect::MakeWH(SkIntToScalar(200 - 2 * (i / 10 % 5)), H),
+                              SkRegion::kReplace_Op);
+        }
+        recorder.save();
+            recorder.rotate(90);
+            recorder.drawRect(SkRect::MakeXYWH(0, -200, 10, 10), SkPaint());
+        recorder.restore();
+    }
+
+    SkAutoTMalloc<SkRect> bounds(record.count());
+    SkRecordFillBounds(SkRect::MakeWH(SkIntToScalar(W), SkIntToScalar(H)), record, bounds);
+
+    int op = 0;
+    for (int i = 0; i < kBlocks; i++) {
+        const SkScalar dy = SkIntToScalar(2 * (i / 10 + 1));
+        if (0 == i % 10) {
+            // The translate and clip are outside any Save block, so they draw everywhere.
+            REPORTER_ASSERT(r, sloppy_rect_eq(SkRect::MakeWH(W, H), bounds[op++]));
+            REPORTER_ASSERT(r, sloppy_rect_eq(SkRect::MakeWH(W, H), bounds[op++]));
+        }
+        const SkRect expected =
+                SkRect::MakeLTRB(190, dy, SkIntToScalar(200 - 2 * (i / 10 % 5)), dy + 10);
+        for (int j = 0; j < 4; j++) {
+            REPORTER_ASSERT(r, sloppy_rect_eq(expected, bounds[op++]));
+        }
+    }
+    REPORTER_ASSERT(r, op == record.count());
+}
@@ -185,7 +185,7 @@ DEF_TEST(RecordOpts_NoopSaveLayerDrawRestore, r) {
 
     const SkRecords::DrawRect* drawRect = assert_type<SkRecords::DrawRect>(r, record, 16);
     REPORTER_ASSERT(r, drawRect != nullptr);
-    REPORTER_ASSERT(r, drawRect->paint.getColor() == 0x03020202);
+    REPORTER_ASSERT(r, drawRect->paint->getColor() == 0x03020202);
 
     // saveLayer w/ backdrop should NOT go away
     sk_sp<SkImageFilter> filter(SkBlurImageFilter::Make(3, 3, nullptr));
@@ -343,3 +343,194 @@ DEF_TEST(RecordOpts_MergeSvgOpacityAndFilterLayers, r) {
     assert_type<SkRecords::Restore>(r, record, index + 3);
     index += 4;
 }
+
+static SkPath circle(SkScalar x, SkScalar y, SkScalar radius) {
+    SkPath path;
+    path.addCircle(x, y, radius);
+    return path;
+}
+
+DEF_TEST(RecordOpts_SimplifyClips, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkPath triangle;
+    triangle.moveTo(-10, -10);
+    triangle.lineTo(500, -10);
+    triangle.lineTo(-10, 500);
+    const SkRect fractional = SkRect::MakeLTRB(0, 0, 100.5f, 100.5f);
+
+    recorder.clipRect(SkRect::MakeWH(300, 300));                          // 0
+    recorder.clipRect(SkRect::MakeWH(400, 400));                          // 1: can't shrink clip.
+    recorder.clipRect(fractional, SkRegion::kIntersect_Op, true);         // 2: can.
+    recorder.clipRect(SkRect::MakeWH(101, 101));                          // 3: fits rounded clip.
+    recorder.clipRRect(SkRRect::MakeRectXY(SkRect::MakeLTRB(-50, -50, 150, 150),
+                                           50, 50));                      // 4: fits too.
+    recorder.clipRRect(SkRRect::MakeRectXY(SkRect::MakeWH(110, 110), 50, 50));  // 5: cuts corners.
+    recorder.clipPath(triangle);                                          // 6: fits.
+    recorder.clipRect(SkRect::MakeWH(300, 300), SkRegion::kUnion_Op);     // 7: grows the clip.
+    recorder.clipRect(SkRect::MakeWH(300, 300));                          // 8: might shrink it.
+
+    SkRecordSimplifyClips(&record);
+
+    assert_type<SkRecords::ClipRect> (r, record, 0);
+    assert_type<SkRecords::NoOp>     (r, record, 1);
+    assert_type<SkRecords::ClipRect> (r, record, 2);
+    assert_type<SkRecords::NoOp>     (r, record, 3);
+    assert_type<SkRecords::NoOp>     (r, record, 4);
+    assert_type<SkRecords::ClipRRect>(r, record, 5);
+    assert_type<SkRecords::NoOp>     (r, record, 6);
+    assert_type<SkRecords::ClipRect> (r, record, 7);
+    assert_type<SkRecords::ClipRect> (r, record, 8);
+}
+
+DEF_TEST(RecordOpts_NoopOccludedDraws, r) {
+    const SkRect cull = SkRect::MakeWH(W, H);
+    SkPaint opaque, translucent;
+    translucent.setAlpha(0x80);
+
+    {   // Draws are occluded by opaque rects drawn later, but not by translucent ones.
+        SkRecord record;
+        SkRecorder recorder(&record, W, H);
+        recorder.drawRect(SkRect::MakeLTRB(10, 10, 50, 50), translucent);  // 0: occluded by 2.
+        recorder.drawRect(SkRect::MakeLTRB(10, 10, 99.5f, 50), opaque);    // 1: too close to 2's edge.
+        recorder.drawRect(SkRect::MakeWH(100, 100), opaque);               // 2
+        recorder.drawRect(SkRect::MakeLTRB(20, 20, 30, 30), opaque);       // 3: drawn after 2.
+        recorder.drawRect(SkRect::MakeLTRB(20, 20, 30, 30), translucent);  // 4: 5 is translucent.
+        recorder.drawRect(SkRect::MakeWH(100, 100), translucent);          // 5
+
+        SkRecordNoopOccludedDraws(&record, cull);
+        assert_type<SkRecords::NoOp>    (r, record, 0);
+        assert_type<SkRecords::DrawRect>(r, record, 1);
+        assert_type<SkRecords::DrawRect>(r, record, 2);
+        assert_type<SkRecords::DrawRect>(r, record, 3);
+        assert_type<SkRecords::DrawRect>(r, record, 4);
+        assert_type<SkRecords::DrawRect>(r, record, 5);
+    }
+
+    {   // Occluders account for the matrix and clip, but give up on clips that aren't rects.
+        SkRecord record;
+        SkRecorder recorder(&record, W, H);
+        recorder.drawRect(SkRect::MakeLTRB(10, 10, 50, 50), opaque);   // 0: occluded by 9.
+        recorder.drawRect(SkRect::MakeLTRB(60, 60, 80, 80), opaque);   // 1: not by 4 or 9.
+        recorder.save();
+            recorder.clipPath(circle(30, 30, 100));
+            recorder.drawPaint(opaque);                                // 4
+        recorder.restore();
+        recorder.save();
+            recorder.translate(5, 5);
+            recorder.clipRect(SkRect::MakeWH(50, 50));
+            recorder.drawPaint(opaque);                                // 9
+        recorder.restore();
+
+        SkRecordNoopOccludedDraws(&record, cull);
+        assert_type<SkRecords::NoOp>     (r, record, 0);
+        assert_type<SkRecords::DrawRect> (r, record, 1);
+        assert_type<SkRecords::DrawPaint>(r, record, 4);
+        assert_type<SkRecords::DrawPaint>(r, record, 9);
+    }
+
+    {   // Draws in a layer are occluded by later draws in the same layer or its parent, but not
+        // after something that might read them back, like a picture with a backdrop filter.
+        SkPictureRecorder pictureRecorder;
+        SkCanvas* canvas = pictureRecorder.beginRecording(W, H);
+        canvas->drawRect(SkRect::MakeLTRB(500, 500, 510, 510), opaque);
+        canvas->drawRect(SkRect::MakeLTRB(520, 500, 530, 510), opaque);
+        sk_sp<SkPicture> picture = pictureRecorder.finishRecordingAsPicture();
+
+        SkRecord record;
+        SkRecorder recorder(&record, W, H);
+        recorder.saveLayer(nullptr, &translucent);
+            recorder.drawRect(SkRect::MakeLTRB(10, 10, 50, 50), opaque);  // 1: occluded by 3.
+        recorder.restore();
+        recorder.drawRect(SkRect::MakeWH(100, 100), opaque);          // 3
+        recorder.drawRect(SkRect::MakeLTRB(10, 10, 50, 50), opaque);  // 4: not by 7.
+        recorder.saveLayer(nullptr, nullptr);
+            recorder.drawRect(SkRect::MakeLTRB(10, 10, 50, 50), opaque);  // 6: occluded by 7.
+            recorder.drawRect(SkRect::MakeWH(100, 100), opaque);      // 7
+        recorder.restore();
+        recorder.drawRect(SkRect::MakeLTRB(10, 10, 50, 50), opaque);  // 9: not by 11.
+        recorder.drawPicture(picture.get(), nullptr, nullptr);        // 10
+        recorder.drawRect(SkRect::MakeWH(100, 100), opaque);          // 11
+
+        SkRecordNoopOccludedDraws(&record, cull);
+        assert_type<SkRecords::NoOp>       (r, record, 1);
+        assert_type<SkRecords::DrawRect>   (r, record, 3);
+        assert_type<SkRecords::DrawRect>   (r, record, 4);
+        assert_type<SkRecords::NoOp>       (r, record, 6);
+        assert_type<SkRecords::DrawRect>   (r, record, 7);
+        assert_type<SkRecords::DrawRect>   (r, record, 9);
+        assert_type<SkRecords::DrawPicture>(r, record, 10);
+    }
+}
+
+DEF_TEST(RecordOpts_MergeDrawPaths, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkPaint paint, other;
+    paint.setAntiAlias(true);
+    other.setColor(SK_ColorRED);
+
+    recorder.drawPath(circle( 10, 10, 5), paint);       // 0: merges 1 and 2.
+    recorder.drawPath(circle( 30, 10, 5), paint);
+    recorder.drawPath(circle( 50, 10, 5), paint);
+    recorder.drawPath(circle( 54, 10, 5), paint);       // 3: overlaps 2.
+    recorder.drawPath(circle(100, 10, 5), other);       // 4: paint differs.
+    recorder.drawRect(SkRect::MakeWH(5, 5), paint);     // 5: ends the run.
+    recorder.drawPath(circle(200, 10, 5), other);       // 6: not merged into 4.
+
+    SkRecordMergeDrawPaths(&record);
+
+    const SkRecords::DrawPath* merged = assert_type<SkRecords::DrawPath>(r, record, 0);
+    REPORTER_ASSERT(r, merged && merged->path.getBounds() == SkRect::MakeLTRB(5, 5, 55, 15));
+    assert_type<SkRecords::NoOp>    (r, record, 1);
+    assert_type<SkRecords::NoOp>    (r, record, 2);
+    assert_type<SkRecords::DrawPath>(r, record, 3);
+    assert_type<SkRecords::DrawPath>(r, record, 4);
+    assert_type<SkRecords::DrawRect>(r, record, 5);
+    assert_type<SkRecords::DrawPath>(r, record, 6);
+}
+
+DEF_TEST(RecordOpts_OptimizeOverdrawDrawsTheSame, r) {
+    auto draw = [](SkCanvas* canvas) {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        canvas->clear(SK_ColorWHITE);
+        for (int i = 0; i < 20; i++) {
+            paint.setColor(0xFF000000 | (i * 0x0C1E3F));
+            canvas->drawPath(circle(15 + 30 * i, 20, 10), paint);
+        }
+        canvas->save();
+            canvas->clipRect(SkRect::MakeLTRB(0, 0, 300, 400));
+            canvas->clipRRect(SkRRect::MakeRectXY(SkRect::MakeLTRB(-20, -20, 320, 420), 5, 5));
+            canvas->drawRect(SkRect::MakeLTRB(0, 40, 300, 400), paint);
+            canvas->saveLayer(nullptr, nullptr);
+                canvas->drawOval(SkRect::MakeLTRB(50, 50, 250, 250), SkPaint());
+            canvas->restore();
+            paint.setColor(SK_ColorBLUE);
+            canvas->drawRect(SkRect::MakeLTRB(40.5f, 40.5f, 260.5f, 260.5f), paint);
+        canvas->restore();
+        canvas->rotate(10);
+        canvas->drawRect(SkRect::MakeLTRB(300, 100, 500, 300), paint);
+        paint.setAlpha(0x80);
+        canvas->drawRect(SkRect::MakeLTRB(300, 100, 500, 300), paint);
+    };
+
+    SkBitmap bitmaps[2];
+    int opCounts[2];
+    const uint32_t flags[] = { 0, SkPictureRecorder::kOptimizeOverdraw_RecordFlag };
+    for (int i = 0; i < 2; i++) {
+        SkPictureRecorder recorder;
+        draw(recorder.beginRecording(600, 400, nullptr, flags[i]));
+        sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+        opCounts[i] = picture->approximateOpCount();
+
+        bitmaps[i].allocN32Pixels(600, 400);
+        SkCanvas canvas(bitmaps[i]);
+        canvas.drawPicture(picture);
+    }
+    REPORTER_ASSERT(r, opCounts[1] < opCounts[0]);
+    REPORTER_ASSERT(r, 0 == memcmp(bitmaps[0].getPixels(), bitmaps[1].getPixels(),
+                                   bitmaps[0].getSafeSize()));
+}
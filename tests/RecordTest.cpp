@@ -61,7 +61,7 @@ DEF_TEST(Record, r) {
     // Add a simple DrawRect command.
     SkRect rect = SkRect::MakeWH(10, 10);
     SkPaint paint;
-    APPEND(record, SkRecords::DrawRect, paint, rect);
+    APPEND(record, SkRecords::DrawRect, record.internPaint(paint), rect);
 
     // Its area should be 100.
     AreaSummer summer;
@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "RecordTestUtils.h"
 #include "Test.h"
 
 #include "SkPictureRecorder.h"
@@ -70,6 +71,40 @@ DEF_TEST(Recorder_RefLeaking, r) {
     REPORTER_ASSERT(r, paint.getShader()->unique());
 }
 
+// Ops with equal paints should share one copy, and so one ref on the paint's effects.
+DEF_TEST(Recorder_SharesPaints, r) {
+    SkPaint paint;
+    paint.setShader(SkShader::MakeEmptyShader());
+    SkPaint blue;
+    blue.setColor(SK_ColorBLUE);
+
+    {
+        SkRecord record;
+        SkRecorder recorder(&record, 1920, 1080);
+        for (int i = 0; i < 4; i++) {
+            recorder.drawRect(SkRect::MakeWH(10, 10), paint);
+            recorder.drawOval(SkRect::MakeWH(10, 10), blue);
+            recorder.saveLayer(nullptr, &paint);
+            recorder.restore();
+        }
+        REPORTER_ASSERT(r, 2 == record.paintCount());
+
+        const SkPaint* shared = assert_type<SkRecords::DrawRect>(r, record, 0)->paint;
+        REPORTER_ASSERT(r, shared != &paint && *shared == paint);
+        REPORTER_ASSERT(r, shared == assert_type<SkRecords::SaveLayer>(r, record, 2)->paint);
+        REPORTER_ASSERT(r, shared == assert_type<SkRecords::DrawRect>(r, record, 12)->paint);
+        REPORTER_ASSERT(r, blue == *assert_type<SkRecords::DrawOval>(r, record, 13)->paint);
+
+        record.reset();
+        REPORTER_ASSERT(r, 0 == record.paintCount());
+        REPORTER_ASSERT(r, paint.getShader()->unique());
+
+        recorder.drawRect(SkRect::MakeWH(10, 10), paint);
+        REPORTER_ASSERT(r, 1 == record.paintCount());
+    }
+    REPORTER_ASSERT(r, paint.getShader()->unique());
+}
+
 DEF_TEST(Recorder_drawImage_takeReference, reporter) {
 
     sk_sp<SkImage> image;
@@ -22,6 +22,7 @@
 #include "GrTest.h"
 #include "SkCanvas.h"
 #include "SkGr.h"
+#include "SkMemoryPressure.h"
 #include "SkMessageBus.h"
 #include "SkSurface.h"
 #include "Test.h"
@@ -1198,6 +1199,140 @@ static void test_flush(skiatest::Reporter* reporter) {
     REPORTER_ASSERT(reporter, 0 == cache->getResourceCount());
 }
 
+static void test_flush_purging_disabled(skiatest::Reporter* reporter) {
+    Mock mock(1000000, 1000000);
+    GrContext* context = mock.context();
+    GrResourceCache* cache = mock.cache();
+
+    context->setResourceCacheMaxUnusedFlushes(0);
+    REPORTER_ASSERT(reporter, 0 == cache->getMaxUnusedFlushes());
+
+    // Changing the count and byte limits leaves the flush limit alone.
+    context->setResourceCacheLimits(100000, 100000);
+    REPORTER_ASSERT(reporter, 0 == cache->getMaxUnusedFlushes());
+
+    TestResource* r = new TestResource(context->getGpu());
+    GrUniqueKey k;
+    make_unique_key<1>(&k, 0);
+    r->resourcePriv().setUniqueKey(k);
+    r->unref();
+    for (int i = 0; i < 300; ++i) {
+        cache->notifyFlushOccurred();
+    }
+    REPORTER_ASSERT(reporter, 1 == cache->getResourceCount());
+
+    context->setResourceCacheMaxUnusedFlushes(3);
+    REPORTER_ASSERT(reporter, 4 == cache->getMaxUnusedFlushes());
+    for (int i = 0; i < 4; ++i) {
+        cache->notifyFlushOccurred();
+    }
+    REPORTER_ASSERT(reporter, 0 == cache->getResourceCount());
+}
+
+static void test_purge_to_bytes(skiatest::Reporter* reporter) {
+    Mock mock(10, 30000);
+    GrContext* context = mock.context();
+    GrResourceCache* cache = mock.cache();
+
+    // Three unlocked resources, oldest first, and a locked one.
+    GrUniqueKey keys[4];
+    GrGpuResource* locked = nullptr;
+    for (int i = 0; i < 4; ++i) {
+        TestResource* r = new TestResource(context->getGpu());
+        make_unique_key<0>(&keys[i], i);
+        r->resourcePriv().setUniqueKey(keys[i]);
+        if (3 == i) {
+            locked = r;
+        } else {
+            r->unref();
+        }
+    }
+    REPORTER_ASSERT(reporter, 4 * TestResource::kDefaultSize == cache->getResourceBytes());
+
+    cache->purgeUnlockedToBytes(2 * TestResource::kDefaultSize + 50);
+    REPORTER_ASSERT(reporter, 2 * TestResource::kDefaultSize == cache->getResourceBytes());
+    REPORTER_ASSERT(reporter, !cache->hasUniqueKey(keys[0]));
+    REPORTER_ASSERT(reporter, !cache->hasUniqueKey(keys[1]));
+    REPORTER_ASSERT(reporter, cache->hasUniqueKey(keys[2]));
+    REPORTER_ASSERT(reporter, cache->hasUniqueKey(keys[3]));
+    // The budget is unchanged.
+    REPORTER_ASSERT(reporter, 30000 == cache->getMaxResourceBytes());
+
+    // Locked resources are never purged.
+    context->purgeUnlockedResourcesToBytes(0);
+    REPORTER_ASSERT(reporter, 1 == cache->getResourceCount());
+    REPORTER_ASSERT(reporter, cache->hasUniqueKey(keys[3]));
+
+    locked->unref();
+}
+
+static void test_memory_pressure(skiatest::Reporter* reporter) {
+    Mock mock(10, 30000);
+    GrContext* context = mock.context();
+    GrResourceCache* cache = mock.cache();
+
+    for (int i = 0; i < 4; ++i) {
+        TestResource* r = new TestResource(context->getGpu());
+        GrUniqueKey key;
+        make_unique_key<0>(&key, i);
+        r->resourcePriv().setUniqueKey(key);
+        r->unref();
+    }
+    REPORTER_ASSERT(reporter, 4 == cache->getResourceCount());
+
+    // The cache trims itself the next time it looks for something to purge, and only the
+    // harshest of the messages waiting for it matters.
+    SkMessageBus<SkMemoryPressureMessage>::Post(SkMemoryPressureMessage(0.75f));
+    SkMessageBus<SkMemoryPressureMessage>::Post(SkMemoryPressureMessage(0.5f));
+    REPORTER_ASSERT(reporter, 4 == cache->getResourceCount());
+    cache->purgeAsNeeded();
+    REPORTER_ASSERT(reporter, 2 == cache->getResourceCount());
+
+    SkMessageBus<SkMemoryPressureMessage>::Post(SkMemoryPressureMessage(0));
+    cache->purgeAsNeeded();
+    REPORTER_ASSERT(reporter, 0 == cache->getResourceCount());
+}
+
+static void test_memory_categories(skiatest::Reporter* reporter) {
+    Mock mock(10, 30000);
+    GrContext* context = mock.context();
+    GrResourceCache* cache = mock.cache();
+
+    TestResource* atlas = new TestResource(context->getGpu());
+    TestResource* other = new TestResource(context->getGpu(), SkBudgeted::kYes, 300);
+    GrUniqueKey atlasKey, otherKey;
+    make_unique_key<0>(&atlasKey, 0);
+    make_unique_key<0>(&otherKey, 1);
+    atlas->resourcePriv().setUniqueKey(atlasKey);
+    other->resourcePriv().setUniqueKey(otherKey);
+    atlas->resourcePriv().setIsAtlas(true);
+    other->unref();
+
+    GrResourceCache::CategoryUsage usage[GrGpuResource::kMemoryCategoryCount];
+    cache->getCategoryUsage(usage);
+    const GrResourceCache::CategoryUsage& atlases = usage[GrGpuResource::kAtlas_MemoryCategory];
+    const GrResourceCache::CategoryUsage& others = usage[GrGpuResource::kOther_MemoryCategory];
+    REPORTER_ASSERT(reporter, 1 == atlases.fCount);
+    REPORTER_ASSERT(reporter, TestResource::kDefaultSize == atlases.fBytes);
+    REPORTER_ASSERT(reporter, 0 == atlases.fPurgeableBytes);
+    REPORTER_ASSERT(reporter, 1 == others.fCount);
+    REPORTER_ASSERT(reporter, 300 == others.fBytes);
+    REPORTER_ASSERT(reporter, 300 == others.fPurgeableBytes);
+    for (int i = 0; i < GrGpuResource::kMemoryCategoryCount; ++i) {
+        if (GrGpuResource::kAtlas_MemoryCategory != i &&
+            GrGpuResource::kOther_MemoryCategory != i) {
+            REPORTER_ASSERT(reporter, 0 == usage[i].fCount && 0 == usage[i].fBytes);
+        }
+    }
+
+    // Once the atlas lets go of it, it's no longer counted as one.
+    atlas->unref();
+    cache->getCategoryUsage(usage);
+    REPORTER_ASSERT(reporter, 0 == atlases.fCount);
+    REPORTER_ASSERT(reporter, 2 == others.fCount);
+    REPORTER_ASSERT(reporter, TestResource::kDefaultSize + 300 == others.fPurgeableBytes);
+}
+
 static void test_large_resource_count(skiatest::Reporter* reporter) {
     // Set the cache size to double the resource count because we're going to create 2x that number
     // resources, using two different key domains. Add a little slop to the bytes because we resize
@@ -1319,6 +1454,10 @@ DEF_GPUTEST(ResourceCacheMisc, reporter, factory) {
     test_resource_size_changed(reporter);
     test_timestamp_wrap(reporter);
     test_flush(reporter);
+    test_flush_purging_disabled(reporter);
+    test_purge_to_bytes(reporter);
+    test_memory_pressure(reporter);
+    test_memory_categories(reporter);
     test_large_resource_count(reporter);
     test_custom_data(reporter);
     test_abandoned(reporter);
@@ -0,0 +1,88 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkRingBufferEventTracer.h"
+#include "SkStream.h"
+#include "SkTaskGroup.h"
+#include "SkTraceEventCommon.h"
+#include "Test.h"
+
+#include <string>
+
+static std::string dump(const SkRingBufferEventTracer& tracer) {
+    SkDynamicMemoryWStream stream;
+    tracer.dumpChromeTraceJSON(&stream);
+    std::string json(stream.bytesWritten(), '\0');
+    stream.copyTo(&json[0]);
+    return json;
+}
+
+static int count(const std::string& str, const char* sub) {
+    int n = 0;
+    for (size_t i = str.find(sub); i != std::string::npos; i = str.find(sub, i + 1)) {
+        n++;
+    }
+    return n;
+}
+
+static SkEventTracer::Handle add(SkRingBufferEventTracer* tracer, const uint8_t* category,
+                                 const char* name) {
+    return tracer->addTraceEvent(TRACE_EVENT_PHASE_COMPLETE, category, name, 0, 0, nullptr,
+                                 nullptr, nullptr, TRACE_EVENT_FLAG_NONE);
+}
+
+DEF_TEST(RingBufferEventTracer, r) {
+    SkRingBufferEventTracer tracer(4);
+    const uint8_t* skia = tracer.getCategoryGroupEnabled("skia");
+    const uint8_t* gpu  = tracer.getCategoryGroupEnabled("disabled-by-default-skia.gpu");
+    REPORTER_ASSERT(r, skia == tracer.getCategoryGroupEnabled("skia"));
+    REPORTER_ASSERT(r, 0 == strcmp("skia", tracer.getCategoryGroupName(skia)));
+    REPORTER_ASSERT(r, !*skia && !*gpu);
+
+    tracer.setEnabled(true);
+    REPORTER_ASSERT(r, *skia && *gpu);
+    REPORTER_ASSERT(r, *tracer.getCategoryGroupEnabled("new"));
+
+    // Arguments, including a string we can keep and a copied one we can't.
+    const char*   argNames[]  = { "count", "label", "copied" };
+    const uint8_t argTypes[]  = { TRACE_VALUE_TYPE_INT, TRACE_VALUE_TYPE_STRING,
+                                  TRACE_VALUE_TYPE_COPY_STRING };
+    const char* label = "a \"quoted\" label";
+    const uint64_t argValues[] = { 7, (uint64_t)(uintptr_t)label, (uint64_t)(uintptr_t)"x" };
+    SkEventTracer::Handle h = tracer.addTraceEvent(TRACE_EVENT_PHASE_COMPLETE, gpu, "flush", 0,
+                                                   3, argNames, argTypes, argValues,
+                                                   TRACE_EVENT_FLAG_NONE);
+    tracer.updateTraceEventDuration(gpu, "flush", h);
+
+    std::string json = dump(tracer);
+    REPORTER_ASSERT(r, 0 == json.find("{\"traceEvents\":["));
+    REPORTER_ASSERT(r, 1 == count(json, "\"name\":\"flush\""));
+    REPORTER_ASSERT(r, 1 == count(json, "\"cat\":\"disabled-by-default-skia.gpu\""));
+    REPORTER_ASSERT(r, 1 == count(json, "\"dur\":"));
+    REPORTER_ASSERT(r, 1 == count(json, "\"args\":{\"count\":7,"
+                                        "\"label\":\"a \\\"quoted\\\" label\"}"));
+    REPORTER_ASSERT(r, 0 == count(json, "copied"));
+
+    // Only the most recent events are kept, and updating an overwritten one does nothing.
+    for (int i = 0; i < 10; i++) {
+        add(&tracer, skia, "draw");
+    }
+    tracer.updateTraceEventDuration(gpu, "flush", h);
+    json = dump(tracer);
+    REPORTER_ASSERT(r, 0 == count(json, "\"name\":\"flush\""));
+    REPORTER_ASSERT(r, 4 == count(json, "\"name\":\"draw\""));
+
+    // Events from any number of threads are kept.
+    SkRingBufferEventTracer threaded(64);
+    threaded.setEnabled(true);
+    const uint8_t* category = threaded.getCategoryGroupEnabled("skia");
+    SkTaskGroup().batch(64, [&](int) {
+        add(&threaded, category, "threaded");
+    });
+    json = dump(threaded);
+    REPORTER_ASSERT(r, 64 == count(json, "\"name\":\"threaded\""));
+}
@@ -7,8 +7,10 @@
 
 #include "SkCanvas.h"
 #include "SkData.h"
+#include "SkGradientShader.h"
 #include "SkDOM.h"
 #include "SkParse.h"
+#include "SkPath.h"
 #include "SkStream.h"
 #include "SkSVGCanvas.h"
 #include "SkXMLWriter.h"
@@ -147,3 +149,55 @@ DEF_TEST(SVGDevice_whitespace_pos, reporter) {
         test_whitespace_pos(reporter, tests[i].tst_in, tests[i].tst_out);
     }
 }
+
+static int count_elements(const SkDOM& dom, const SkDOM::Node* node, const char name[]) {
+    int count = 0;
+    for (const SkDOM::Node* child = dom.getFirstChild(node); child;
+         child = dom.getNextSibling(child)) {
+        if (dom.getType(child) == SkDOM::kElement_Type) {
+            count += !strcmp(name, dom.getName(child)) + count_elements(dom, child, name);
+        }
+    }
+    return count;
+}
+
+DEF_TEST(SVGDevice_shared_defs, reporter) {
+    const SkPoint pts[] = { { 0, 0 }, { 100, 100 } };
+    const SkColor colors[] = { SK_ColorRED, SK_ColorBLUE };
+    SkPath clip;
+    clip.addCircle(50, 50, 40);
+
+    SkDOM dom;
+    {
+        SkXMLParserWriter writer(dom.beginParsing());
+        SkAutoTUnref<SkCanvas> svgCanvas(SkSVGCanvas::Create(SkRect::MakeWH(100, 100),
+                                                             &writer));
+        svgCanvas->save();
+        svgCanvas->clipPath(clip);
+        for (int i = 0; i < 3; ++i) {
+            // A new but identical shader each time.
+            SkPaint paint;
+            paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 2,
+                                                         SkShader::kClamp_TileMode));
+            svgCanvas->drawRect(SkRect::MakeXYWH(10.0f * i, 0, 10, 10), paint);
+        }
+
+        // The same clip, set up again, is shared too.
+        svgCanvas->restore();
+        svgCanvas->save();
+        svgCanvas->clipPath(clip);
+        svgCanvas->drawRect(SkRect::MakeWH(10, 10), SkPaint());
+
+        // A different gradient is not.
+        SkPaint paint;
+        const SkColor otherColors[] = { SK_ColorRED, SK_ColorGREEN };
+        paint.setShader(SkGradientShader::MakeLinear(pts, otherColors, nullptr, 2,
+                                                     SkShader::kClamp_TileMode));
+        svgCanvas->drawRect(SkRect::MakeWH(10, 10), paint);
+    }
+    const SkDOM::Node* root = dom.finishParsing();
+    REPORTER_ASSERT(reporter, root);
+    REPORTER_ASSERT(reporter, 2 == count_elements(dom, root, "linearGradient"));
+    REPORTER_ASSERT(reporter, 1 == count_elements(dom, root, "clipPath"));
+    REPORTER_ASSERT(reporter, 5 == count_elements(dom, root, "rect"));
+}
@@ -11,6 +11,8 @@
 #include <vector>
 #include "SkLinearBitmapPipeline.h"
 #include "SkColor.h"
+#include "SkColorPriv.h"
+#include "SkColorSpace.h"
 #include "SkNx.h"
 #include "SkPoint.h"
 #include "SkPM4f.h"
@@ -255,3 +257,56 @@ DEF_TEST(LBPStrategyRepeatTile, reporter) {
 #endif
 }
 */
+
+// The fused stages must produce exactly what the general stages they stand in for do.
+DEF_TEST(LBPFusedStagesMatchGeneral, reporter) {
+    const int kWidth = 13,
+              kHeight = 7;
+    uint32_t pixels[kWidth * kHeight];
+    for (int i = 0; i < kWidth * kHeight; i++) {
+        // Premultiplied, with a different alpha for each pixel.
+        uint32_t a = 0x80 + 3 * i;
+        pixels[i] = SkPackARGB32(a, (5 * i) % a, (11 * i) % a, (17 * i) % a);
+    }
+
+    const SkMatrix matrices[] = {
+        SkMatrix::I(),
+        SkMatrix::MakeTrans(-3.25f, 2.5f),
+        SkMatrix::MakeScale(2.7f, 2.7f),
+        SkMatrix::MakeScale(0.6f, 1.0f),
+        SkMatrix::MakeScale(-1.5f, 0.75f),
+    };
+
+    for (bool isSRGB : {false, true}) {
+        SkImageInfo info = SkImageInfo::MakeN32Premul(
+            kWidth, kHeight,
+            isSRGB ? SkColorSpace::NewNamed(SkColorSpace::kSRGB_Named) : nullptr);
+        SkPixmap srcPixmap{info, pixels, sizeof(pixels[0]) * kWidth};
+        for (SkMatrix matrix : matrices) {
+            matrix.postTranslate(-4.0f, -2.0f);
+            SkMatrix inverse;
+            SkAssertResult(matrix.invert(&inverse));
+            for (auto tile : {SkShader::kClamp_TileMode, SkShader::kRepeat_TileMode}) {
+                for (auto quality : {kNone_SkFilterQuality, kLow_SkFilterQuality}) {
+                    SkLinearBitmapPipeline fused{
+                        inverse, quality, tile, tile, SK_ColorBLACK, srcPixmap, true};
+                    SkLinearBitmapPipeline general{
+                        inverse, quality, tile, tile, SK_ColorBLACK, srcPixmap, false};
+                    for (int y = 0; y < 3 * kHeight; y++) {
+                        SkPM4f fusedSpan[50], generalSpan[50];
+                        // Spans of many lengths, starting left of, on and right of the source,
+                        // so the tilers' and samplers' edge cases all get covered.
+                        int count = 1 + (7 * y) % 50;
+                        fused.shadeSpan4f(y - 10, y, fusedSpan, count);
+                        general.shadeSpan4f(y - 10, y, generalSpan, count);
+                        if (0 != memcmp(fusedSpan, generalSpan, count * sizeof(SkPM4f))) {
+                            ERRORF(reporter, "sRGB %d, matrix type %d, tile %d, quality %d, "
+                                   "row %d doesn't match", isSRGB, matrix.getType(), tile,
+                                   quality, y);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
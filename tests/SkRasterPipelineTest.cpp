@@ -6,6 +6,10 @@
  */
 
 #include "Test.h"
+#include "SkColorFilter.h"
+#include "SkHalf.h"
+#include "SkOpts.h"
+#include "SkPM4f.h"
 #include "SkRasterPipeline.h"
 
 // load needs two variants, one to load 4 values...
@@ -99,3 +103,277 @@ DEF_TEST(SkRasterPipeline_nonsense, r) {
     p.append(square);
     p.run(20);
 }
+
+// The same load, square, store pipeline, 8 values at a time.
+static void SK_VECTORCALL load8(SkRasterPipelineN<8>::Stage* st, size_t x,
+                                Sk8f v0, Sk8f v1, Sk8f v2, Sk8f v3,
+                                Sk8f v4, Sk8f v5, Sk8f v6, Sk8f v7) {
+    v0 = Sk8f::Load(st->ctx<const float*>() + x);
+    st->next(x, v0,v1,v2,v3, v4,v5,v6,v7);
+}
+
+static void SK_VECTORCALL load8_tail(SkRasterPipelineN<8>::Stage* st, size_t x,
+                                     Sk8f v0, Sk8f v1, Sk8f v2, Sk8f v3,
+                                     Sk8f v4, Sk8f v5, Sk8f v6, Sk8f v7) {
+    v0 = Sk8f{st->ctx<const float*>()[x]};
+    st->next(x, v0,v1,v2,v3, v4,v5,v6,v7);
+}
+
+static void SK_VECTORCALL square8(SkRasterPipelineN<8>::Stage* st, size_t x,
+                                  Sk8f v0, Sk8f v1, Sk8f v2, Sk8f v3,
+                                  Sk8f v4, Sk8f v5, Sk8f v6, Sk8f v7) {
+    v0 *= v0;
+    st->next(x, v0,v1,v2,v3, v4,v5,v6,v7);
+}
+
+static void SK_VECTORCALL store8(SkRasterPipelineN<8>::Stage* st, size_t x,
+                                 Sk8f v0, Sk8f v1, Sk8f v2, Sk8f v3,
+                                 Sk8f v4, Sk8f v5, Sk8f v6, Sk8f v7) {
+    v0.store(st->ctx<float*>() + x);
+}
+
+static void SK_VECTORCALL store8_tail(SkRasterPipelineN<8>::Stage* st, size_t x,
+                                      Sk8f v0, Sk8f v1, Sk8f v2, Sk8f v3,
+                                      Sk8f v4, Sk8f v5, Sk8f v6, Sk8f v7) {
+    st->ctx<float*>()[x] = v0[0];
+}
+
+DEF_TEST(SkRasterPipeline_wide, r) {
+    // 11 values makes for one 8 pixel body call and three 1 pixel tail calls.
+    float vals[11];
+    for (int i = 0; i < 11; i++) {
+        vals[i] = (float)i;
+    }
+
+    SkRasterPipelineN<8> p;
+    p.append(load8, load8_tail, vals);
+    p.append(square8);
+    p.append(store8, store8_tail, vals);
+
+    p.run(11);
+
+    for (int i = 0; i < 11; i++) {
+        REPORTER_ASSERT(r, vals[i] == (float)(i*i));
+    }
+}
+
+static void SK_VECTORCALL noop(SkRasterPipeline::Stage* st, size_t x,
+                               Sk4f v0, Sk4f v1, Sk4f v2, Sk4f v3,
+                               Sk4f v4, Sk4f v5, Sk4f v6, Sk4f v7) {
+    st->next(x, v0,v1,v2,v3, v4,v5,v6,v7);
+}
+
+DEF_TEST(SkRasterPipeline_fused, r) {
+    // A few common chains of stock stages are fused into a single stage.  They should draw
+    // exactly what the same stages draw chained together, which we get by putting a no-op stage
+    // that's not part of any fused chain after every stage.
+    const SkPM4f color = {{ 0.25f, 0.5f, 0.0f, 0.5f }};
+    const float matrix[20] = { 0.5f, 0.25f, 0.0f,  0.0f,
+                               0.5f, 0.25f, 0.0f,  0.0f,
+                               0.0f, 0.5f,  1.0f,  0.0f,
+                               0.0f, 0.0f,  0.0f,  0.75f,
+                               0.1f, 0.0f, -0.2f,  0.25f };
+    uint32_t src[11];
+    uint8_t  coverage[11];
+    for (int i = 0; i < 11; i++) {
+        src[i]      = 0x80402010 + i * 0x01020304;
+        coverage[i] = (uint8_t)(i * 25);
+    }
+
+    auto draw = [&](int chain, bool fused, uint32_t* dst) {
+        for (int i = 0; i < 11; i++) {
+            dst[i] = 0xff00ff00 + i;
+        }
+        SkRasterPipeline p;
+        auto append = [&](SkRasterPipeline::StockStage stage, const void* ctx) {
+            p.append(stage, ctx);
+            if (!fused) {
+                p.append(noop);
+            }
+        };
+        switch (chain) {
+            case 0:
+                append(SkRasterPipeline::load_s_srgb, src);
+                append(SkRasterPipeline::load_d_srgb, dst);
+                append(SkRasterPipeline::srcover, nullptr);
+                break;
+            case 1:
+                append(SkRasterPipeline::load_s_srgb, src);
+                append(SkRasterPipeline::load_d_srgb, dst);
+                append(SkRasterPipeline::srcover, nullptr);
+                append(SkRasterPipeline::lerp_u8, coverage);
+                break;
+            case 2:
+                append(SkRasterPipeline::constant_color, &color);
+                append(SkRasterPipeline::load_d_srgb, dst);
+                append(SkRasterPipeline::lerp_u8, coverage);
+                break;
+            case 3:
+                // Fused in the middle of the pipeline, then again at its end.
+                append(SkRasterPipeline::load_s_srgb, src);
+                append(SkRasterPipeline::unpremul, nullptr);
+                append(SkRasterPipeline::matrix_4x5, matrix);
+                append(SkRasterPipeline::clamp_0_1, nullptr);
+                append(SkRasterPipeline::premul, nullptr);
+                append(SkRasterPipeline::load_d_srgb, dst);
+                append(SkRasterPipeline::srcover, nullptr);
+                break;
+        }
+        append(SkRasterPipeline::store_srgb, dst);
+        p.run(11);
+    };
+
+    for (int chain = 0; chain < 4; chain++) {
+        uint32_t fused[11], chained[11];
+        draw(chain, true, fused);
+        draw(chain, false, chained);
+        REPORTER_ASSERT(r, 0 == memcmp(fused, chained, sizeof(fused)));
+    }
+
+    // Stages appended after a fused chain still run, just as if nothing had been fused.
+    uint32_t fused[11], chained[11];
+    for (int i = 0; i < 11; i++) {
+        fused[i] = chained[i] = 0xff00ff00 + i;
+    }
+    SkRasterPipeline p, q;
+    for (SkRasterPipeline* pipe : { &p, &q }) {
+        uint32_t* dst = pipe == &p ? fused : chained;
+        pipe->append(SkRasterPipeline::load_s_srgb, src);
+        pipe->append(SkRasterPipeline::load_d_srgb, dst);
+        pipe->append(SkRasterPipeline::srcover);
+        if (pipe == &q) {
+            pipe->append(noop);
+        }
+        pipe->append(SkRasterPipeline::store_srgb, dst);
+    }
+    p.run(0);
+    for (SkRasterPipeline* pipe : { &p, &q }) {
+        pipe->append(SkRasterPipeline::constant_color, &color);
+        pipe->append(SkRasterPipeline::store_srgb, pipe == &p ? fused : chained);
+    }
+    p.run(11);
+    q.run(11);
+    REPORTER_ASSERT(r, 0 == memcmp(fused, chained, sizeof(fused)));
+}
+
+DEF_TEST(SkRasterPipeline_colorFilterStages, r) {
+    // A color matrix filter's stages should filter just like its filterSpan4f(), including
+    // transparent sources, which unpremultiply to nothing but the translate.
+    const float rowMajor255[20] = { 0.5f,  0.5f, 0.0f, 0.0f,  25.0f,
+                                    0.25f, 0.25f, 0.5f, 0.0f,  0.0f,
+                                    0.0f,  0.0f, 1.0f, 0.0f, -50.0f,
+                                    0.0f,  0.0f, 0.0f, 0.75f, 64.0f };
+    sk_sp<SkColorFilter> filter(SkColorFilter::MakeMatrixFilterRowMajor255(rowMajor255));
+
+    SkPM4f src[11], expected[11], actual[11];
+    for (int i = 0; i < 11; i++) {
+        float a = i / 10.0f;
+        src[i] = {{ a * 0.25f, a * 0.5f, a, a }};
+    }
+    filter->filterSpan4f(src, 11, expected);
+
+    // Both widths, f16 in and f16 out.
+    uint64_t pixels[11], filtered[11];
+    for (int i = 0; i < 11; i++) {
+        pixels[i] = SkFloatToHalf_01(src[i].to4f());
+    }
+    SkRasterPipeline p4;
+    p4.append(SkRasterPipeline::load_s_f16, pixels);
+    REPORTER_ASSERT(r, filter->appendStages(&p4));
+    p4.append(SkRasterPipeline::store_f16, filtered);
+    p4.run(11);
+
+    SkRasterPipelineN<8> p8;
+    p8.append(SkRasterPipelineN<8>::load_s_f16, pixels);
+    REPORTER_ASSERT(r, filter->appendStages(&p8));
+    p8.append(SkRasterPipelineN<8>::store_f16, pixels);
+    p8.run(11);
+
+    for (int i = 0; i < 11; i++) {
+        REPORTER_ASSERT(r, pixels[i] == filtered[i]);
+        actual[i] = SkPM4f::From4f(SkHalfToFloat_01(filtered[i]));
+        for (int c = 0; c < 4; c++) {
+            // Half floats hold about 3 decimal digits.
+            REPORTER_ASSERT(r, SkScalarNearlyEqual(actual[i].fVec[c], expected[i].fVec[c],
+                                                   1/512.0f));
+        }
+    }
+}
+
+// Appends one of a few chains of stock stages to p, and runs it over kCount pixels.
+static const int kCount = 19;  // Two full 8 pixel steps (four full 4 pixel steps), and 3 more.
+
+template <typename P>
+static void draw_stock_chain(P* p, int chain, const uint32_t* src, const uint64_t* srcF16,
+                             const uint8_t* coverage, uint32_t* dst, uint64_t* dstF16) {
+    static const SkPM4f color = {{ 0.25f, 0.5f, 0.0f, 0.5f }};
+    static const float scale = 0.75f;
+    static const float matrix[20] = { 0.5f, 0.25f, 0.0f,  0.0f,
+                                      0.5f, 0.25f, 0.0f,  0.0f,
+                                      0.0f, 0.5f,  1.0f,  0.0f,
+                                      0.0f, 0.0f,  0.0f,  0.75f,
+                                      0.1f, 0.0f, -0.2f,  0.25f };
+    for (int i = 0; i < kCount; i++) {
+        dst[i]    = 0xff00ff00 + i;
+        dstF16[i] = SkFloatToHalf_01(Sk4f(0.0f, 0.5f, 1.0f, 1.0f));
+    }
+    switch (chain) {
+        case 0:
+            p->append(P::load_s_srgb, src);
+            p->append(P::scale_u8, coverage);
+            p->append(P::load_d_srgb, dst);
+            p->append(P::srcover);
+            p->append(P::store_srgb, dst);
+            break;
+        case 1:
+            p->append(P::constant_color, &color);
+            p->append(P::load_d_srgb, dst);
+            p->append(P::lerp_u8, coverage);
+            p->append(P::store_srgb, dst);
+            break;
+        case 2:
+            p->append(P::load_s_srgb, src);
+            p->append(P::swap_rb);
+            p->append(P::unpremul);
+            p->append(P::matrix_4x5, matrix);
+            p->append(P::clamp_0_1);
+            p->append(P::premul);
+            p->append(P::swap_rb);
+            p->append(P::store_srgb, dst);
+            break;
+        case 3:
+            p->append(P::load_s_f16, srcF16);
+            p->append(P::scale_1_float, &scale);
+            p->append(P::load_d_f16, dstF16);
+            p->append(P::srcover);
+            p->append(P::store_f16, dstF16);
+            break;
+    }
+    p->run(kCount);
+}
+
+DEF_TEST(SkRasterPipeline_wideStock, r) {
+    // Where the CPU has AVX, 8-wide pipelines of stock stages run through SkOpts in AVX
+    // registers.  They should draw exactly what the 4-wide pipeline draws.
+    SkOpts::Init();
+
+    uint32_t src[kCount];
+    uint64_t srcF16[kCount];
+    uint8_t  coverage[kCount];
+    for (int i = 0; i < kCount; i++) {
+        src[i]      = 0x80402010 + i * 0x01020304;
+        srcF16[i]   = SkFloatToHalf_01(Sk4f(0.5f, 0.25f, 0.125f, 0.5f) * (i / (kCount - 1.0f)));
+        coverage[i] = (uint8_t)(i * 13);
+    }
+
+    for (int chain = 0; chain < 4; chain++) {
+        uint32_t dst4[kCount], dst8[kCount];
+        uint64_t dstF16_4[kCount], dstF16_8[kCount];
+        SkRasterPipeline     p4;
+        SkRasterPipelineN<8> p8;
+        draw_stock_chain(&p4, chain, src, srcF16, coverage, dst4, dstF16_4);
+        draw_stock_chain(&p8, chain, src, srcF16, coverage, dst8, dstF16_8);
+        REPORTER_ASSERT(r, 0 == memcmp(dst4, dst8, sizeof(dst4)));
+        REPORTER_ASSERT(r, 0 == memcmp(dstF16_4, dstF16_8, sizeof(dstF16_4)));
+    }
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkSLCompiler.h"
+
+#include "Test.h"
+
+static std::string to_spirv(skiatest::Reporter* r, SkSL::Compiler* compiler,
+                            SkSL::Program::Kind kind, const char* src) {
+    std::string spirv;
+    REPORTER_ASSERT(r, compiler->toSPIRV(kind, src, &spirv));
+    REPORTER_ASSERT(r, spirv.size() > 0);
+    return spirv;
+}
+
+DEF_TEST(SkSLCompilerReuse, r) {
+    static const char* kFragCoord = "out vec4 color; void main() { color = gl_FragCoord; }";
+    static const char* kSolid = "out vec4 color; void main() { color = vec4(1); }";
+    static const char* kVertex = "in vec4 pos; void main() { gl_Position = pos; }";
+
+    SkSL::Compiler fresh;
+    const std::string fragCoord = to_spirv(r, &fresh, SkSL::Program::kFragment_Kind, kFragCoord);
+    SkSL::Compiler freshSolid;
+    const std::string solid = to_spirv(r, &freshSolid, SkSL::Program::kFragment_Kind, kSolid);
+    SkSL::Compiler freshVertex;
+    const std::string vertex = to_spirv(r, &freshVertex, SkSL::Program::kVertex_Kind, kVertex);
+    REPORTER_ASSERT(r, fragCoord != solid);
+
+    // A reused compiler produces the same code as a new one, whether or not the built-ins were
+    // used by an earlier program, and whether or not the result was cached.
+    SkSL::Compiler compiler;
+    for (int i = 0; i < 2; i++) {
+        REPORTER_ASSERT(r, to_spirv(r, &compiler, SkSL::Program::kFragment_Kind,
+                                    kFragCoord) == fragCoord);
+        REPORTER_ASSERT(r, to_spirv(r, &compiler, SkSL::Program::kFragment_Kind, kSolid) == solid);
+        REPORTER_ASSERT(r, to_spirv(r, &compiler, SkSL::Program::kVertex_Kind, kVertex) == vertex);
+    }
+
+    // Errors aren't cached, and don't linger once a cached program is requested.
+    std::string spirv;
+    REPORTER_ASSERT(r, !compiler.toSPIRV(SkSL::Program::kFragment_Kind, "void main() { x; }",
+                                         &spirv));
+    REPORTER_ASSERT(r, compiler.errorText() != "");
+    REPORTER_ASSERT(r, compiler.toSPIRV(SkSL::Program::kFragment_Kind, kSolid, &spirv));
+    REPORTER_ASSERT(r, spirv == solid);
+    REPORTER_ASSERT(r, compiler.errorText() == "");
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkSLCompiler.h"
+
+#include "Test.h"
+
+static void test(skiatest::Reporter* r, const char* src, SkSL::GLCaps caps,
+                 const char* expected) {
+    SkSL::Compiler compiler;
+    std::string output;
+    bool result = compiler.toGLSL(SkSL::Program::kFragment_Kind, src, caps, &output);
+    if (!result) {
+        SkDebugf("Unexpected error compiling %s\n%s", src, compiler.errorText().c_str());
+    }
+    REPORTER_ASSERT(r, result);
+    if (result) {
+        if (output != expected) {
+            SkDebugf("GLSL MISMATCH:\nsource:\n%s\n\nexpected:\n'%s'\n\nreceived:\n'%s'", src,
+                     expected, output.c_str());
+        }
+        REPORTER_ASSERT(r, output == expected);
+    }
+}
+
+static const SkSL::GLCaps kGL400 = { 400, SkSL::GLCaps::kGL_Standard };
+static const SkSL::GLCaps kGLES300 = { 300, SkSL::GLCaps::kGLES_Standard };
+
+DEF_TEST(SkSLGLSLHelloWorld, r) {
+    test(r,
+         "out vec4 color; void main() { color = vec4(0.75); }",
+         kGL400,
+         "#version 400\n"
+         "out vec4 color;\n"
+         "void main() {\n"
+         "    color = vec4(0.75);\n"
+         "}\n");
+    test(r,
+         "out vec4 color; void main() { color = vec4(0.75); }",
+         kGLES300,
+         "#version 300 es\n"
+         "precision mediump float;\n"
+         "out vec4 color;\n"
+         "void main() {\n"
+         "    color = vec4(0.75);\n"
+         "}\n");
+}
+
+DEF_TEST(SkSLGLSLPrecedence, r) {
+    test(r,
+         "uniform vec4 u;"
+         "out vec4 color;"
+         "void main() {"
+         "    float a = -(-u.x);"
+         "    color = vec4(a * (a + 1), (a * a) + 1, a - (a - 1), (a - a) - 1);"
+         "}",
+         kGL400,
+         "#version 400\n"
+         "uniform vec4 u;\n"
+         "out vec4 color;\n"
+         "void main() {\n"
+         "    float a = -(-u.x);\n"
+         "    color = vec4(a * (a + 1.0), a * a + 1.0, a - (a - 1.0), a - a - 1.0);\n"
+         "}\n");
+}
+
+DEF_TEST(SkSLGLSLOptimized, r) {
+    test(r,
+         "uniform float u;"
+         "out vec4 color;"
+         "float half(float x) { return x * 0.5; }"
+         "float unused() { return 1; }"
+         "void main() {"
+         "    const int k = 2;"
+         "    if (k > 3) { color = vec4(1); }"
+         "    else { int m = -2147483647 - 1; color = vec4(half(u), k * 3, m, 0.5); }"
+         "}",
+         kGL400,
+         "#version 400\n"
+         "uniform float u;\n"
+         "out vec4 color;\n"
+         "void main() {\n"
+         "    {\n"
+         "        int m = (-2147483647 - 1);\n"
+         "        color = vec4(u * 0.5, 6.0, float(m), 0.5);\n"
+         "    }\n"
+         "}\n");
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkSLCompiler.h"
+#include "ir/SkSLFunctionDefinition.h"
+
+#include "Test.h"
+
+// Checks the optimized IR of the source's main function, which must be its last element, and that
+// the program still compiles to SPIR-V.
+static void test(skiatest::Reporter* r, const char* src, const char* expectedMain,
+                 int expectedFunctions = 1) {
+    SkSL::Compiler compiler;
+    std::unique_ptr<SkSL::Program> program = compiler.convertProgram(SkSL::Program::kFragment_Kind,
+                                                                     src);
+    REPORTER_ASSERT(r, compiler.errorText() == "");
+    int functions = 0;
+    for (const auto& e : program->fElements) {
+        if (e->fKind == SkSL::ProgramElement::kFunction_Kind) {
+            functions++;
+        }
+    }
+    std::string main = program->fElements.back()->description();
+    if (main != expectedMain) {
+        SkDebugf("SKSL OPTIMIZER:\n    source: %s\n    expected: %s\n    received: %s\n", src,
+                 expectedMain, main.c_str());
+    }
+    REPORTER_ASSERT(r, main == expectedMain);
+    REPORTER_ASSERT(r, functions == expectedFunctions);
+
+    std::stringstream out;
+    REPORTER_ASSERT(r, compiler.toSPIRV(SkSL::Program::kFragment_Kind, src, out));
+}
+
+DEF_TEST(SkSLConstantFolding, r) {
+    test(r,
+         "out vec4 color;"
+         "void main() {"
+         "    const float k = 2.0 * 3.0;"
+         "    int i = (1 + 2) * 4 - 7 / 2 % 2;"
+         "    int j = 2147483647 + 1;"
+         "    int z = 1 / 0;"
+         "    bool b = !(3 > 2) || 1.5 <= 1.0;"
+         "    color = vec4(k, i, j, z);"
+         "}",
+         "void main() {\n"
+         "int i = 11;\n"
+         "int j = -2147483648;\n"
+         "int z = (1 / 0);\n"
+         "bool b = false;\n"
+         "(color = vec4(6.000000, float(i), float(j), float(z)));\n"
+         "}\n");
+}
+
+DEF_TEST(SkSLDeadCodeElimination, r) {
+    test(r,
+         "out vec4 color;"
+         "uniform float u;"
+         "void main() {"
+         "    float a = u;"
+         "    if (false) { a = 1; } else { a = a + 1; }"
+         "    while (false) { a = 2; }"
+         "    a;"
+         "    color = vec4(true ? a : 0.0);"
+         "    return;"
+         "    color = vec4(1);"
+         "}",
+         "void main() {\n"
+         "float a = u;\n"
+         "{\n"
+         "(a = (a + 1.000000));\n"
+         "}\n"
+         "\n"
+         "(color = vec4(a));\n"
+         "return;\n"
+         "}\n");
+}
+
+DEF_TEST(SkSLInlining, r) {
+    test(r,
+         "out vec4 color;"
+         "uniform float u;"
+         "float twice(float x) { return x + x; }"
+         "float scale(float x) { return x * u; }"
+         "float unused(float x) { return x; }"
+         "void main() {"
+         "    float a = twice(u);"
+         "    float b = twice(u * 2);"
+         "    float c = scale(a * 2);"
+         "    color = vec4(a, b, c, twice(3));"
+         "}",
+         "void main() {\n"
+         "float a = (u + u);\n"
+         "float b = twice((u * 2.000000));\n"
+         "float c = ((a * 2.000000) * u);\n"
+         "(color = vec4(a, b, c, 6.000000));\n"
+         "}\n",
+         2);
+}
+
+DEF_TEST(SkSLOptimizerErrors, r) {
+    // unreachable code is still checked for errors
+    SkSL::Compiler compiler;
+    std::stringstream out;
+    REPORTER_ASSERT(r, !compiler.toSPIRV(SkSL::Program::kFragment_Kind,
+                                         "void main() { return; x = 1; }", out));
+    REPORTER_ASSERT(r, compiler.errorText() == "error: 1: unknown identifier 'x'\n1 error\n");
+}
@@ -10,8 +10,9 @@
 
 #include "Test.h"
 
-DEF_TEST(SkSharedMutexBasic, r) {
-    SkSharedMutex sm;
+template <typename Mutex>
+static void test_basic() {
+    Mutex sm;
     sm.acquire();
     sm.assertHeld();
     sm.release();
@@ -20,8 +21,14 @@ DEF_TEST(SkSharedMutexBasic, r) {
     sm.releaseShared();
 }
 
-DEF_TEST(SkSharedMutexMultiThreaded, r) {
-    SkSharedMutex sm;
+DEF_TEST(SkSharedMutexBasic, r) {
+    test_basic<SkSharedMutex>();
+    test_basic<SkStripedSharedMutex>();
+}
+
+template <typename Mutex>
+static void test_multithreaded(skiatest::Reporter* r) {
+    Mutex sm;
     static const int kSharedSize = 10;
     int shared[kSharedSize];
     int value = 0;
@@ -52,3 +59,11 @@ DEF_TEST(SkSharedMutexMultiThreaded, r) {
         }
     });
 }
+
+DEF_TEST(SkSharedMutexMultiThreaded, r) {
+    test_multithreaded<SkSharedMutex>(r);
+}
+
+DEF_TEST(SkStripedSharedMutexMultiThreaded, r) {
+    test_multithreaded<SkStripedSharedMutex>(r);
+}
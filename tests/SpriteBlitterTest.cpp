@@ -0,0 +1,131 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkColorMatrixFilter.h"
+#include "SkColorSpace.h"
+#include "SkHalf.h"
+#include "SkPM4f.h"
+#include "SkPM4fPriv.h"
+#include "SkRandom.h"
+#include "Test.h"
+
+static SkImageInfo make_info(SkColorType ct, int w, int h) {
+    if (ct == kRGBA_F16_SkColorType) {
+        return SkImageInfo::Make(w, h, ct, kPremul_SkAlphaType);
+    }
+    return SkImageInfo::MakeN32Premul(w, h, SkColorSpace::NewNamed(SkColorSpace::kSRGB_Named));
+}
+
+// SkBitmap::getAddr() doesn't know about 8-byte pixels.
+static uint64_t* addr64(const SkBitmap& bm, int x, int y) {
+    return (uint64_t*)((char*)bm.getPixels() + y * bm.rowBytes()) + x;
+}
+
+static Sk4f load(const SkBitmap& bm, int x, int y) {
+    if (bm.colorType() == kRGBA_F16_SkColorType) {
+        return SkHalfToFloat_01(*addr64(bm, x, y));
+    }
+    return exact_srgb_to_linear(to_4f_rgba(*bm.getAddr32(x, y)) * (1/255.0f));
+}
+
+static void store(const SkBitmap& bm, int x, int y, const Sk4f& px) {
+    if (bm.colorType() == kRGBA_F16_SkColorType) {
+        *addr64(bm, x, y) = SkFloatToHalf_01(px);
+    } else {
+        Sk4f srgb = exact_linear_to_srgb(Sk4f::Min(Sk4f::Max(px, 0.0f), 1.0f));
+        *bm.getAddr32(x, y) = to_4b(swizzle_rb_if_bgra(srgb * 255.0f + 0.5f));
+    }
+}
+
+static void fill_random(const SkBitmap& bm, SkRandom* rand) {
+    for (int y = 0; y < bm.height(); y++) {
+        for (int x = 0; x < bm.width(); x++) {
+            // Premultiplied, with both opaque and translucent pixels.
+            float a = rand->nextBool() ? 1.0f : rand->nextF();
+            store(bm, x, y, Sk4f{rand->nextF(), rand->nextF(), rand->nextF(), 1.0f} * a);
+        }
+    }
+}
+
+// Returns the largest difference between any channels of a and b, in 8-bit units.
+static float max_diff(const SkBitmap& a, const SkBitmap& b) {
+    float diff = 0;
+    for (int y = 0; y < a.height(); y++) {
+        for (int x = 0; x < a.width(); x++) {
+            Sk4f pa, pb;
+            if (a.colorType() == kRGBA_F16_SkColorType) {
+                pa = SkHalfToFloat_01(*addr64(a, x, y)) * 255.0f;
+                pb = SkHalfToFloat_01(*addr64(b, x, y)) * 255.0f;
+            } else {
+                pa = SkNx_cast<float>(Sk4b::Load(a.getAddr32(x, y)));
+                pb = SkNx_cast<float>(Sk4b::Load(b.getAddr32(x, y)));
+            }
+            Sk4f d = (pa - pb).abs();
+            diff = SkTMax(diff, SkTMax(SkTMax(d[0], d[1]), SkTMax(d[2], d[3])));
+        }
+    }
+    return diff;
+}
+
+// Unscaled drawBitmap()s from sRGB or F16 sources into sRGB or F16 destinations take the sprite
+// blitters.  Check them against the same math done one pixel at a time.
+DEF_TEST(SpriteBlitter_sRGBAndF16, r) {
+    const int kW = 37, kH = 5;
+    SkRandom rand;
+
+    for (SkColorType srcCT : {kN32_SkColorType, kRGBA_F16_SkColorType})
+    for (SkColorType dstCT : {kN32_SkColorType, kRGBA_F16_SkColorType})
+    for (SkXfermode::Mode mode : {SkXfermode::kSrc_Mode, SkXfermode::kSrcOver_Mode})
+    for (U8CPU alpha : {0xFF, 0x80})
+    for (bool filter : {false, true}) {
+        if (srcCT == kN32_SkColorType && dstCT == kN32_SkColorType) {
+            continue;  // Sprite_sRGB and SkSpriteBlitter_Src_SrcOver approximate the sRGB curve.
+        }
+        SkBitmap src;
+        src.allocPixels(make_info(srcCT, kW, kH));
+        fill_random(src, &rand);
+
+        SkBitmap dst;
+        dst.allocPixels(make_info(dstCT, kW + 2, kH + 2));
+        fill_random(dst, &rand);
+        SkBitmap expected;
+        expected.allocPixels(dst.info());
+        memcpy(expected.getPixels(), dst.getPixels(), dst.getSize());
+
+        SkPaint paint;
+        paint.setXfermodeMode(mode);
+        paint.setAlpha(alpha);
+        if (filter) {
+            paint.setColorFilter(SkColorMatrixFilter::MakeLightingFilter(0xFF80C0FF, 0x00102000));
+        }
+
+        SkCanvas(dst).drawBitmap(src, 1, 1, &paint);
+
+        for (int y = 0; y < kH; y++) {
+            for (int x = 0; x < kW; x++) {
+                SkPM4f s = SkPM4f::From4f(load(src, x, y) * (alpha * (1/255.0f)));
+                if (filter) {
+                    paint.getColorFilter()->filterSpan4f(&s, 1, &s);
+                }
+                Sk4f px = s.to4f();
+                if (mode == SkXfermode::kSrcOver_Mode) {
+                    px = px + load(expected, x + 1, y + 1) * (1.0f - s.a());
+                }
+                store(expected, x + 1, y + 1, px);
+            }
+        }
+
+        // Allow for rounding, and for the pipeline converting to F16 a little short.
+        float diff = max_diff(dst, expected);
+        if (diff > 1.0f) {
+            ERRORF(r, "src %d, dst %d, mode %d, alpha %d, filter %d: off by %g",
+                   srcCT, dstCT, mode, alpha, filter, diff);
+        }
+    }
+}
@@ -160,8 +160,55 @@ static void test_strokerec_equality(skiatest::Reporter* reporter) {
     }
 }
 
+// Strokes of long, non-volatile paths are cached; they must match freshly computed ones.
+static void test_stroke_cache(skiatest::Reporter* reporter) {
+    SkPath path;
+    path.moveTo(0, 0);
+    for (int i = 1; i < 100; ++i) {
+        path.lineTo(SkIntToScalar(i * 5), SkIntToScalar((i * 37) % 23));
+    }
+
+    SkStroke stroke;
+    stroke.setWidth(3);
+    stroke.setJoin(SkPaint::kMiter_Join);
+
+    SkPath volatilePath(path);
+    volatilePath.setIsVolatile(true);
+    SkPath expected;
+    stroke.strokePath(volatilePath, &expected);
+
+    SkPath first, second;
+    stroke.strokePath(path, &first);
+    stroke.strokePath(path, &second);
+    REPORTER_ASSERT(reporter, expected == first);
+    REPORTER_ASSERT(reporter, expected == second);
+
+    // Different stroke params must not hit the same entry.
+    stroke.setJoin(SkPaint::kRound_Join);
+    SkPath rounded;
+    stroke.strokePath(path, &rounded);
+    REPORTER_ASSERT(reporter, rounded != first);
+
+    // Nor may the path once it has changed.
+    stroke.setJoin(SkPaint::kMiter_Join);
+    path.lineTo(0, 100);
+    volatilePath.lineTo(0, 100);
+    stroke.strokePath(volatilePath, &expected);
+    SkPath changed;
+    stroke.strokePath(path, &changed);
+    REPORTER_ASSERT(reporter, expected == changed);
+    REPORTER_ASSERT(reporter, changed != first);
+
+    // Nor an inverse fill of the same points.
+    path.toggleInverseFillType();
+    SkPath inverse;
+    stroke.strokePath(path, &inverse);
+    REPORTER_ASSERT(reporter, inverse.isInverseFillType());
+}
+
 DEF_TEST(Stroke, reporter) {
     test_strokecubic(reporter);
     test_strokerect(reporter);
     test_strokerec_equality(reporter);
+    test_stroke_cache(reporter);
 }
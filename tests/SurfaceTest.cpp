@@ -547,6 +547,57 @@ static void test_writable_after_snapshot_release(skiatest::Reporter* reporter,
 DEF_TEST(SurfaceWriteableAfterSnapshotRelease, reporter) {
     test_writable_after_snapshot_release(reporter, create_surface().get());
 }
+
+// Copy-on-write reuses the pixels of a released snapshot, copying over only the tiles drawn to since.
+// Each snapshot, and the surface, must still see exactly what was drawn before them.
+DEF_TEST(SurfaceCopyOnWrite_Incremental, reporter) {
+    auto surface(SkSurface::MakeRasterN32Premul(300, 200));
+    SkCanvas* canvas = surface->getCanvas();
+    canvas->clear(SK_ColorWHITE);
+
+    auto check = [&](SkImage* image, SkColor expected[3]) {
+        SkBitmap bm;
+        bm.allocN32Pixels(300, 200);
+        REPORTER_ASSERT(reporter, image->readPixels(bm.info(), bm.getPixels(), bm.rowBytes(), 0,0));
+        REPORTER_ASSERT(reporter, expected[0] == bm.getColor( 10,  10));
+        REPORTER_ASSERT(reporter, expected[1] == bm.getColor(150, 100));
+        REPORTER_ASSERT(reporter, expected[2] == bm.getColor(290, 190));
+    };
+
+    sk_sp<SkImage> image1(surface->makeImageSnapshot());
+    SkPaint paint;
+    paint.setColor(SK_ColorRED);
+    canvas->drawRect(SkRect::MakeXYWH(0, 0, 20, 20), paint);     // Copies everything.
+
+    sk_sp<SkImage> image2(surface->makeImageSnapshot());
+    image1.reset();
+    canvas->save();
+    canvas->clipRect(SkRect::MakeXYWH(140, 90, 20, 20));
+    paint.setColor(SK_ColorBLUE);
+    canvas->drawPaint(paint);                                     // Copies just the dirty tiles.
+    canvas->restore();
+
+    sk_sp<SkImage> image3(surface->makeImageSnapshot());
+    image2.reset();
+    paint.setColor(SK_ColorGREEN);
+    canvas->drawRect(SkRect::MakeXYWH(280, 180, 20, 20), paint);
+
+    SkColor before3[] = { SK_ColorRED, SK_ColorBLUE, SK_ColorWHITE },
+            after[]   = { SK_ColorRED, SK_ColorBLUE, SK_ColorGREEN };
+    check(image3.get(), before3);
+    sk_sp<SkImage> image4(surface->makeImageSnapshot());
+    check(image4.get(), after);
+
+    // writePixels() isn't bound by the clip.
+    image3.reset();
+    canvas->clipRect(SkRect::MakeWH(1, 1));
+    SkPMColor black = SkPreMultiplyColor(SK_ColorBLACK);
+    canvas->writePixels(SkImageInfo::MakeN32Premul(1, 1), &black, 4, 150, 100);
+    SkColor afterWrite[] = { SK_ColorRED, SK_ColorBLACK, SK_ColorGREEN };
+    check(surface->makeImageSnapshot().get(), afterWrite);
+    check(image4.get(), after);
+}
+
 #if SK_SUPPORT_GPU
 DEF_GPUTEST_FOR_RENDERING_CONTEXTS(SurfaceWriteableAfterSnapshotRelease_Gpu, reporter, ctxInfo) {
     for (auto& surface_func : { &create_gpu_surface, &create_gpu_scratch_surface }) {
@@ -763,6 +814,87 @@ DEF_TEST(surface_raster_zeroinitialized, reporter) {
     }
 }
 
+// Antialiased paths can rasterize slightly differently when clipped to tile boundaries, so we
+// stick to rects (which are exact however they're clipped) to compare against SkSurface_Raster.
+static void draw_threaded_raster_content(SkCanvas* canvas, int step) {
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(SK_ColorBLUE);
+    canvas->drawRect(SkRect::MakeXYWH(60.5f + step * 10, 20.25f, 170, 150.5f), paint);
+
+    canvas->save();
+        canvas->clipRect(SkRect::MakeLTRB(30, 20, 170, 150));
+        canvas->scale(1.5f, 1.25f);
+        paint.setColor(0x8000FF00);
+        canvas->drawRect(SkRect::MakeXYWH(20.3f, 10.7f, 250, 60), paint);
+    canvas->restore();
+
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(5);
+    paint.setColor(0xC0FF0000);
+    canvas->drawRect(SkRect::MakeXYWH(10.5f, 40.5f, 275, 100), paint);
+}
+
+static bool surfaces_match(SkSurface* a, SkSurface* b) {
+    SkBitmap bmA, bmB;
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(a->width(), a->height());
+    bmA.allocPixels(info);
+    bmB.allocPixels(info);
+    if (!a->readPixels(info, bmA.getPixels(), bmA.rowBytes(), 0, 0) ||
+        !b->readPixels(info, bmB.getPixels(), bmB.rowBytes(), 0, 0)) {
+        return false;
+    }
+    for (int y = 0; y < info.height(); ++y) {
+        if (memcmp(bmA.getAddr32(0, y), bmB.getAddr32(0, y), info.width() * 4)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+DEF_TEST(SurfaceThreadedRaster, reporter) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(300, 200);
+    REPORTER_ASSERT(reporter, !SkSurface::MakeRasterThreaded(info, 0));
+
+    sk_sp<SkSurface> reference(SkSurface::MakeRaster(info));
+    sk_sp<SkSurface> threaded(SkSurface::MakeRasterThreaded(info, 64));
+    REPORTER_ASSERT(reporter, threaded);
+
+    SkPixmap pixmap;
+    REPORTER_ASSERT(reporter, threaded->peekPixels(&pixmap));
+    REPORTER_ASSERT(reporter, *pixmap.addr32(10, 10) == 0);
+
+    for (auto surface : { reference.get(), threaded.get() }) {
+        draw_threaded_raster_content(surface->getCanvas(), 0);
+    }
+    REPORTER_ASSERT(reporter, surfaces_match(reference.get(), threaded.get()));
+
+    // Snapshots must not see later draws, even though those draws are deferred.
+    sk_sp<SkImage> refSnap(reference->makeImageSnapshot()),
+                   threadedSnap(threaded->makeImageSnapshot());
+
+    // Flush with a save and base-level matrix outstanding, then keep drawing.
+    for (auto surface : { reference.get(), threaded.get() }) {
+        surface->getCanvas()->translate(5, 7);
+        surface->getCanvas()->save();
+        surface->getCanvas()->scale(0.5f, 0.5f);
+        draw_threaded_raster_content(surface->getCanvas(), 1);
+    }
+    REPORTER_ASSERT(reporter, surfaces_match(reference.get(), threaded.get()));
+    for (auto surface : { reference.get(), threaded.get() }) {
+        draw_threaded_raster_content(surface->getCanvas(), 2);
+        surface->getCanvas()->restore();
+        draw_threaded_raster_content(surface->getCanvas(), 3);
+    }
+    REPORTER_ASSERT(reporter, surfaces_match(reference.get(), threaded.get()));
+
+    sk_sp<SkSurface> refFromSnap(SkSurface::MakeRaster(info)),
+                     threadedFromSnap(SkSurface::MakeRaster(info));
+    refFromSnap->getCanvas()->drawImage(refSnap, 0, 0);
+    threadedFromSnap->getCanvas()->drawImage(threadedSnap, 0, 0);
+    REPORTER_ASSERT(reporter, surfaces_match(refFromSnap.get(), threadedFromSnap.get()));
+}
+
 #if SK_SUPPORT_GPU
 static sk_sp<SkSurface> create_gpu_surface_backend_texture(
     GrContext* context, int sampleCnt, uint32_t color, GrBackendObject* outTexture) {
@@ -167,3 +167,100 @@ DEF_TEST(PublicSwizzleOpts, r) {
     SkSwapRB(&dst, &src, 1);
     REPORTER_ASSERT(r, dst == 0xFA04B0CE);
 }
+
+#include "SkRandom.h"
+
+DEF_TEST(SwizzleOpts_Lengths, r) {
+    // SIMD code handles 4, 8 or 16 pixels at a time, so try every length up to a few multiples
+    // of that and make sure every pixel is converted the same way, no matter where it falls.
+    static const int N = 67;
+    uint32_t src[N], dst[N];
+    SkRandom rand;
+    for (int i = 0; i < N; i++) {
+        src[i] = rand.nextU();
+    }
+
+    for (int count = 0; count <= N; count++) {
+        for (int i = 0; i < N; i++) { dst[i] = 0x12345678; }
+        SkOpts::RGBA_to_BGRA(dst, src, count);
+        for (int i = 0; i < N; i++) {
+            uint32_t expected;
+            SkOpts::RGBA_to_BGRA(&expected, src + i, 1);
+            REPORTER_ASSERT(r, dst[i] == (i < count ? expected : 0x12345678));
+        }
+
+        SkOpts::RGBA_to_rgbA(dst, src, count);
+        for (int i = 0; i < count; i++) {
+            uint32_t expected;
+            SkOpts::RGBA_to_rgbA(&expected, src + i, 1);
+            REPORTER_ASSERT(r, dst[i] == expected);
+        }
+
+        SkOpts::RGBA_to_bgrA(dst, src, count);
+        for (int i = 0; i < count; i++) {
+            uint32_t expected;
+            SkOpts::RGBA_to_bgrA(&expected, src + i, 1);
+            REPORTER_ASSERT(r, dst[i] == expected);
+        }
+    }
+}
+
+DEF_TEST(SwizzleOpts_Unpremul, r) {
+    uint32_t dst, src;
+
+    // Opaque pixels are left alone, apart from the swap.
+    src = 0xFFCEB004;
+    SkOpts::rgbA_to_RGBA(&dst, &src, 1);
+    REPORTER_ASSERT(r, dst == src);
+    SkOpts::rgbA_to_BGRA(&dst, &src, 1);
+    REPORTER_ASSERT(r, dst == 0xFF04B0CE);
+
+    // Unpremultiplying undoes premultiplying, to within rounding.
+    for (int a = 1; a <= 255; a++) {
+        uint32_t premul;
+        src = ((uint32_t)a << 24) | 0xCEB004;
+        SkOpts::RGBA_to_rgbA(&premul, &src, 1);
+        SkOpts::rgbA_to_RGBA(&dst, &premul, 1);
+        REPORTER_ASSERT(r, (dst >> 24) == (uint32_t)a);
+        for (int shift = 0; shift < 24; shift += 8) {
+            int expected = (src >> shift) & 0xFF,
+                actual   = (dst >> shift) & 0xFF;
+            // Small alphas keep few bits of color.
+            REPORTER_ASSERT(r, SkTAbs(expected - actual) <= 255 / a + 1);
+        }
+        uint32_t swapped;
+        SkOpts::rgbA_to_BGRA(&swapped, &premul, 1);
+        SkOpts::RGBA_to_BGRA(&dst, &dst, 1);
+        REPORTER_ASSERT(r, swapped == dst);
+    }
+
+    // SIMD code skips the division when a whole group of pixels is opaque or transparent,
+    // so mix runs of those with translucent pixels, and check every length.
+    static const int N = 67;
+    uint32_t premul[N], dsts[N];
+    SkRandom rand;
+    for (int i = 0; i < N; i++) {
+        uint32_t c = rand.nextU();
+        switch ((i / 8) % 3) {
+            case 0:  c |= 0xFF000000; break;
+            case 1:  c  = 0;          break;
+            default:                  break;
+        }
+        SkOpts::RGBA_to_rgbA(premul + i, &c, 1);
+    }
+    for (int count = 0; count <= N; count++) {
+        SkOpts::rgbA_to_RGBA(dsts, premul, count);
+        for (int i = 0; i < count; i++) {
+            uint32_t expected;
+            SkOpts::rgbA_to_RGBA(&expected, premul + i, 1);
+            REPORTER_ASSERT(r, dsts[i] == expected);
+        }
+
+        SkOpts::rgbA_to_BGRA(dsts, premul, count);
+        for (int i = 0; i < count; i++) {
+            uint32_t expected;
+            SkOpts::rgbA_to_BGRA(&expected, premul + i, 1);
+            REPORTER_ASSERT(r, dsts[i] == expected);
+        }
+    }
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkAtomics.h"
+#include "SkData.h"
+#include "SkTaskGroup.h"
+#include "Test.h"
+
+DEF_TEST(SkTaskGroup_Add, r) {
+    SkAtomic<int> count(0);
+    SkTaskGroup tg;
+    for (int i = 0; i < 1000; i++) {
+        tg.add([&] { count.fetch_add(1); });
+    }
+    tg.wait();
+    REPORTER_ASSERT(r, 1000 == count.load());
+}
+
+DEF_TEST(SkTaskGroup_Batch, r) {
+    static const int N = 1021;
+    SkAtomic<int> seen[N];
+    for (int i = 0; i < N; i++) {
+        seen[i].store(0);
+    }
+    SkTaskGroup().batch(N, [&](int i) { seen[i].fetch_add(1); });
+
+    // Every index should have run exactly once.
+    for (int i = 0; i < N; i++) {
+        REPORTER_ASSERT(r, 1 == seen[i].load());
+    }
+
+    // An empty batch is a no-op.
+    SkTaskGroup().batch(0, [&](int) { REPORTER_ASSERT(r, false); });
+}
+
+DEF_TEST(SkTaskGroup_Nested, r) {
+    // Tasks that start and wait on their own SkTaskGroups must not deadlock,
+    // even when there are more of them than there are threads.
+    SkAtomic<int> count(0);
+    SkTaskGroup outer;
+    outer.batch(64, [&](int) {
+        SkTaskGroup middle;
+        middle.batch(16, [&](int) {
+            SkTaskGroup inner;
+            for (int k = 0; k < 4; k++) {
+                inner.add([&] { count.fetch_add(1); });
+            }
+            inner.wait();
+        });
+        middle.wait();
+    });
+    outer.wait();
+    REPORTER_ASSERT(r, 64*16*4 == count.load());
+}
+
+DEF_TEST(SkTaskGroup_BigAndOwningTasks, r) {
+    // Functions that don't fit in a Task are moved to the heap.  Either way, a task's captures
+    // are destroyed once it has run.
+    struct Big {
+        char bytes[SkTaskGroup::Task::kStorageSize + 1];
+    };
+    Big big;
+    for (size_t i = 0; i < sizeof(big.bytes); i++) {
+        big.bytes[i] = (char)i;
+    }
+    sk_sp<SkData> data = SkData::MakeUninitialized(1);
+
+    SkAtomic<int> sum(0);
+    SkTaskGroup tg;
+    for (int i = 0; i < 100; i++) {
+        tg.add([&sum, data] { sum.fetch_add(1); });
+        tg.add([&sum, big, data] { sum.fetch_add(big.bytes[sizeof(big.bytes) - 1]); });
+    }
+    tg.wait();
+    REPORTER_ASSERT(r, 100 * (1 + SkTaskGroup::Task::kStorageSize) == (size_t)sum.load());
+    REPORTER_ASSERT(r, data->unique());
+}
@@ -174,6 +174,38 @@ public:
     }
 
     // Verify that text-related properties are captured in run paints.
+    // Runs allocated into reserved storage should come out the same as unreserved ones.
+    static void TestReserve(skiatest::Reporter* reporter) {
+        SkTextBlobBuilder builder;
+
+        // reserved but unused storage
+        builder.reserveRuns(4, 512, SkTextBlob::kFull_Positioning);
+        RunBuilderTest(reporter, builder, nullptr, 0, nullptr, 0);
+
+        RunDef set1[] = {
+            { 128, SkTextBlob::kDefault_Positioning, 100, 100 },
+            { 128, SkTextBlob::kHorizontal_Positioning, 100, 150 },
+            { 128, SkTextBlob::kFull_Positioning, 100, 200 },
+            { 128, SkTextBlob::kDefault_Positioning, 100, 250 },
+        };
+        builder.reserveRuns(SK_ARRAY_COUNT(set1), 512, SkTextBlob::kFull_Positioning);
+        RunBuilderTest(reporter, builder, set1, SK_ARRAY_COUNT(set1), set1, SK_ARRAY_COUNT(set1));
+
+        // more runs than were reserved
+        RunDef set2[] = {
+            { 128, SkTextBlob::kFull_Positioning, 100, 100 },
+            { 128, SkTextBlob::kFull_Positioning, 100, 100 },
+            { 128, SkTextBlob::kDefault_Positioning, 100, 150 },
+        };
+        RunDef mergedSet2[] = {
+            { 256, SkTextBlob::kFull_Positioning, 100, 100 },
+            { 128, SkTextBlob::kDefault_Positioning, 100, 150 },
+        };
+        builder.reserveRuns(1, 64, SkTextBlob::kHorizontal_Positioning);
+        RunBuilderTest(reporter, builder, set2, SK_ARRAY_COUNT(set2), mergedSet2,
+                       SK_ARRAY_COUNT(mergedSet2));
+    }
+
     static void TestPaintProps(skiatest::Reporter* reporter) {
         SkPaint font;
         font.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
@@ -344,6 +376,7 @@ private:
 DEF_TEST(TextBlob_builder, reporter) {
     TextBlobTester::TestBuilder(reporter);
     TextBlobTester::TestBounds(reporter);
+    TextBlobTester::TestReserve(reporter);
 }
 
 DEF_TEST(TextBlob_paint, reporter) {
@@ -275,3 +275,95 @@ DEF_TEST(CompressLATC, reporter) {
         }
     }
 }
+
+static bool compresses_n32(SkTextureCompressor::Format fmt) {
+    switch (fmt) {
+        case SkTextureCompressor::kBC1_Format:
+        case SkTextureCompressor::kBC3_Format:
+#ifndef SK_IGNORE_ETC1_SUPPORT
+        case SkTextureCompressor::kETC1_Format:
+        case SkTextureCompressor::kETC2_RGBA8_Format:
+#endif
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+static bool keeps_alpha(SkTextureCompressor::Format fmt) {
+    return SkTextureCompressor::kBC3_Format == fmt ||
+           SkTextureCompressor::kETC2_RGBA8_Format == fmt;
+}
+
+/**
+ * Compress N32 gradients and make sure they decompress to something close. Solid
+ * blocks whose colors 565 can represent should come back exactly.
+ */
+DEF_TEST(CompressN32, reporter) {
+    static const int kWidth = 64;
+    static const int kHeight = 64;
+
+    SkAutoPixmapStorage pixmap;
+    pixmap.alloc(SkImageInfo::MakeN32Premul(kWidth, kHeight));
+    for (int y = 0; y < kHeight; ++y) {
+        for (int x = 0; x < kWidth; ++x) {
+            // The bottom right quarter is solid: opaque red, or half transparent.
+            U8CPU a = (y * 4) | 3;
+            SkPMColor c = SkPreMultiplyARGB(a, x * 4, y * 4, 255 - x * 2);
+            if (x >= kWidth / 2 && y >= kHeight / 2) {
+                c = SkPackARGB32(y >= 3 * kHeight / 4 ? 0x80 : 0xFF, 0x80, 0, 0);
+            }
+            *pixmap.writable_addr32(x, y) = c;
+        }
+    }
+
+    SkAutoTMalloc<uint8_t> decompressed(kWidth * kHeight * 4);
+    for (int i = 0; i < SkTextureCompressor::kFormatCnt; ++i) {
+        const SkTextureCompressor::Format fmt = static_cast<SkTextureCompressor::Format>(i);
+        if (!compresses_n32(fmt)) {
+            continue;
+        }
+        const bool alpha = keeps_alpha(fmt);
+        // ETC1 decompresses to 3 byte RGB, the others to RGBA.
+        const int bpp = SkTextureCompressor::kETC1_Format == fmt ? 3 : 4;
+
+        SkAutoDataUnref data(SkTextureCompressor::CompressBitmapToFormat(pixmap, fmt));
+        REPORTER_ASSERT(reporter, data);
+        if (nullptr == data) {
+            continue;
+        }
+        REPORTER_ASSERT(reporter, data->size() ==
+                        (size_t)SkTextureCompressor::GetCompressedDataSize(fmt, kWidth, kHeight));
+        REPORTER_ASSERT(reporter, SkTextureCompressor::DecompressBufferFromFormat(
+                decompressed.get(), kWidth * bpp, data->bytes(), kWidth, kHeight, fmt));
+
+        double colorError = 0, alphaError = 0;
+        for (int y = 0; y < kHeight; ++y) {
+            for (int x = 0; x < kWidth; ++x) {
+                const SkPMColor c = *pixmap.addr32(x, y);
+                const uint8_t* d = decompressed.get() + (y * kWidth + x) * bpp;
+                const int expected[4] = {
+                    (int)SkGetPackedR32(c), (int)SkGetPackedG32(c), (int)SkGetPackedB32(c),
+                    alpha ? (int)SkGetPackedA32(c) : 0xFF
+                };
+                const bool solid = x >= kWidth / 2 && y >= kHeight / 2;
+                for (int j = 0; j < bpp; ++j) {
+                    const int diff = expected[j] - d[j];
+                    if (solid && (alpha || SkGetPackedA32(c) == 0xFF)) {
+                        // 0x80 isn't a 565 value, so ETC and BC may round it.
+                        REPORTER_ASSERT(reporter, SkTAbs(diff) <= (3 == j ? 0 : 4));
+                    }
+                    (3 == j ? alphaError : colorError) += diff * diff;
+                }
+            }
+        }
+        // Root mean square error, per channel.
+        const double rmsColor = sqrt(colorError / (kWidth * kHeight * 3));
+        REPORTER_ASSERT(reporter, rmsColor < 6);
+        if (alpha) {
+            const double rmsAlpha = sqrt(alphaError / (kWidth * kHeight));
+            REPORTER_ASSERT(reporter, rmsAlpha < 2);
+        }
+    }
+}
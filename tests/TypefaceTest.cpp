@@ -95,3 +95,63 @@ DEF_TEST(TypefaceCache, reporter) {
     }
     REPORTER_ASSERT(reporter, t1->unique());
 }
+
+static bool is_face(SkTypeface* face, void* ctx) {
+    return face == ctx;
+}
+
+DEF_TEST(TypefaceCache_Keyed, reporter) {
+    sk_sp<SkTypeface> a(SkEmptyTypeface::Create()),
+                      b(SkEmptyTypeface::Create()),
+                      c(SkEmptyTypeface::Create());
+    SkTypefaceCache cache;
+    cache.add(a.get(), 1);
+    cache.add(b.get(), 1);  // Keys may collide; the proc decides.
+    cache.add(c.get());
+
+    sk_sp<SkTypeface> found(cache.findByKeyAndRef(1, is_face, b.get()));
+    REPORTER_ASSERT(reporter, found == b);
+    found.reset(cache.findByKeyAndRef(2, is_face, a.get()));
+    REPORTER_ASSERT(reporter, !found);
+    found.reset(cache.findByKeyAndRef(1, is_face, c.get()));
+    REPORTER_ASSERT(reporter, !found);
+
+    // Keyed typefaces can still be found by proc, as can unkeyed ones.
+    found.reset(cache.findByProcAndRef(is_face, a.get()));
+    REPORTER_ASSERT(reporter, found == a);
+    found.reset(cache.findByProcAndRef(is_face, c.get()));
+    REPORTER_ASSERT(reporter, found == c);
+    REPORTER_ASSERT(reporter, count(reporter, cache) == 3);
+
+    // Purging keeps the index in step.
+    a.reset();
+    cache.purgeAll();
+    REPORTER_ASSERT(reporter, count(reporter, cache) == 2);
+    found.reset(cache.findByKeyAndRef(1, is_face, b.get()));
+    REPORTER_ASSERT(reporter, found == b);
+}
+
+DEF_TEST(TypefaceCache_PurgesLeastRecentlyUsed, reporter) {
+    // Fill the cache with typefaces only it owns, remembering the first.
+    SkTypefaceCache cache;
+    SkTypeface* first = nullptr;
+    int added = 0;
+    for (; added < 1024; added++) {
+        sk_sp<SkTypeface> face(SkEmptyTypeface::Create());
+        cache.add(face.get(), added);
+        if (!first) {
+            first = face.get();
+        }
+    }
+
+    // Use the first typeface, then overflow the cache.  It should outlive the ones never used.
+    sk_sp<SkTypeface> found(cache.findByKeyAndRef(0, is_face, first));
+    REPORTER_ASSERT(reporter, found.get() == first);
+    found.reset();
+    sk_sp<SkTypeface> overflow(SkEmptyTypeface::Create());
+    cache.add(overflow.get(), added);
+
+    found.reset(cache.findByKeyAndRef(0, is_face, first));
+    REPORTER_ASSERT(reporter, found.get() == first);
+    REPORTER_ASSERT(reporter, count(reporter, cache) == 1024 - 256 + 1);
+}
@@ -18,3 +18,31 @@ DEF_TEST(VarAlloc, r) {
     REPORTER_ASSERT(r, va.approxBytesAllocated() >= 128);
 #endif
 }
+
+DEF_TEST(VarAlloc_Reset, r) {
+    SkVarAlloc va(4);
+    va.alloc(1000);
+    va.alloc(16);
+    REPORTER_ASSERT(r, va.mallocCount() == 2);
+
+    // We keep our last block, and can fill it without mallocing again.
+    va.reset(nullptr, 0);
+    REPORTER_ASSERT(r, va.mallocCount() == 0);
+    sk_bzero(va.alloc(1000), 1000);
+    REPORTER_ASSERT(r, va.mallocCount() == 0);
+
+    // reserve() makes room all at once.
+    va.reserve(5000);
+    REPORTER_ASSERT(r, va.mallocCount() == 1);
+    for (int i = 0; i < 50; i++) {
+        va.alloc(100);
+    }
+    REPORTER_ASSERT(r, va.mallocCount() == 1);
+
+    // Without any blocks, we start over in the storage we're given.
+    char storage[64];
+    SkVarAlloc empty(4);
+    empty.reset(storage, sizeof(storage));
+    REPORTER_ASSERT(r, empty.alloc(32) == storage);
+    REPORTER_ASSERT(r, empty.mallocCount() == 0);
+}
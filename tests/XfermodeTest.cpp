@@ -6,6 +6,9 @@
  */
 
 #include "SkColor.h"
+#include "SkHalf.h"
+#include "SkPM4f.h"
+#include "SkRandom.h"
 #include "SkXfermode.h"
 #include "Test.h"
 
@@ -53,3 +56,146 @@ DEF_TEST(Xfermode, reporter) {
     test_asMode(reporter);
     test_IsMode(reporter);
 }
+
+// The single color LCD procs and the sRGB A8 procs blend several pixels at a time.  They should match
+// blending one at a time, and leave pixels with no coverage alone.
+DEF_TEST(Xfermode_CoverageProcs, reporter) {
+    const int N = 67;
+    SkRandom rand;
+    uint32_t dst[N];
+    uint16_t lcd[N];
+    SkAlpha  aa[N];
+    for (int i = 0; i < N; i++) {
+        dst[i] = rand.nextU();
+        // Mostly no coverage or full coverage, as in text masks.
+        switch (rand.nextULessThan(4)) {
+            case 0:  lcd[i] = 0;      aa[i] = 0;    break;
+            case 1:  lcd[i] = 0xFFFF; aa[i] = 0xFF; break;
+            default: lcd[i] = rand.nextU() & 0xFFFF; aa[i] = rand.nextU() & 0xFF; break;
+        }
+    }
+    // Whole runs of 4 with no coverage, or full coverage, take shortcuts.
+    for (int i = 8; i < 16; i++) {
+        lcd[i] = aa[i] = 0;
+    }
+    for (int i = 16; i < 20; i++) {
+        lcd[i] = 0xFFFF;
+        aa[i]  = 0xFF;
+    }
+
+    for (SkColor color : { SK_ColorBLACK, (SkColor)0xFF3050E0, (SkColor)0x80306090 }) {
+        const SkPM4f src = SkColor4f::FromColor(color).premul();
+
+        for (uint32_t flags = 0; flags < 8; flags++) {
+            if (!(flags & SkXfermode::kSrcIsSingle_LCDFlag) ||
+                ((flags & SkXfermode::kSrcIsOpaque_LCDFlag) && SkColorGetA(color) != 0xFF)) {
+                continue;
+            }
+            auto proc = SkXfermode::GetLCD32Proc(flags);
+            uint32_t all[N], each[N];
+            memcpy(all,  dst, sizeof(dst));
+            memcpy(each, dst, sizeof(dst));
+            proc(all, &src, N, lcd);
+            for (int i = 0; i < N; i++) {
+                proc(each + i, &src, 1, lcd + i);
+            }
+            REPORTER_ASSERT(reporter, 0 == memcmp(all, each, sizeof(all)));
+        }
+
+        uint32_t flags = SkXfermode::kDstIsSRGB_D32Flag | SkXfermode::kSrcIsSingle_D32Flag;
+        if (SkColorGetA(color) == 0xFF) {
+            flags |= SkXfermode::kSrcIsOpaque_D32Flag;
+        }
+        auto proc = SkXfermode::GetD32Proc(nullptr, flags);
+        uint32_t all[N], each[N];
+        memcpy(all,  dst, sizeof(dst));
+        memcpy(each, dst, sizeof(dst));
+        proc(nullptr, all, &src, N, aa);
+        for (int i = 0; i < N; i++) {
+            proc(nullptr, each + i, &src, 1, aa + i);
+        }
+        REPORTER_ASSERT(reporter, 0 == memcmp(all, each, sizeof(all)));
+        for (int i = 0; i < N; i++) {
+            if (0 == aa[i]) {
+                REPORTER_ASSERT(reporter, all[i] == dst[i]);
+            }
+        }
+    }
+}
+
+// Modes without their own procs share ones that blend 4 pixels at a time.  Those should match
+// blending one at a time, leave pixels with no coverage alone, and (for the separable modes)
+// agree with the single pixel SkXfermodeProc4f.
+DEF_TEST(Xfermode_ModeProcs, reporter) {
+    const int N = 67;
+    SkRandom rand;
+    uint32_t dst[N];
+    uint64_t dst16[N];
+    SkPM4f   src[N];
+    SkAlpha  aa[N];
+    for (int i = 0; i < N; i++) {
+        SkColor s = rand.nextU(),
+                d = rand.nextU();
+        src[i] = SkColor4f::FromColor(s).premul();
+        dst[i] = SkPreMultiplyColor(d);
+        dst16[i] = SkFloatToHalf_01(SkColor4f::FromColor(d).premul().to4f());
+        aa[i] = rand.nextULessThan(3) ? rand.nextU() & 0xFF : 0;
+    }
+
+    for (int m = SkXfermode::kSrcOver_Mode + 1; m <= SkXfermode::kLastMode; m++) {
+        const SkXfermode::Mode mode = (SkXfermode::Mode)m;
+        auto xfer = SkXfermode::Make(mode);
+
+        // Every flag combination but kSrcIsOpaque_D32Flag, as src isn't.
+        for (uint32_t flags = 0; flags < 8; flags += 2) {
+            auto proc = SkXfermode::GetD32Proc(xfer.get(), flags);
+            const int step = (flags & SkXfermode::kSrcIsSingle_D32Flag) ? 0 : 1;
+            for (const SkAlpha* cov : { (const SkAlpha*)nullptr, (const SkAlpha*)aa }) {
+                uint32_t all[N], each[N];
+                memcpy(all,  dst, sizeof(dst));
+                memcpy(each, dst, sizeof(dst));
+                proc(xfer.get(), all, src, N, cov);
+                for (int i = 0; i < N; i++) {
+                    proc(xfer.get(), each + i, src + i*step, 1, cov ? cov + i : nullptr);
+                }
+                REPORTER_ASSERT(reporter, 0 == memcmp(all, each, sizeof(all)));
+                for (int i = 0; cov && i < N; i++) {
+                    if (0 == cov[i]) {
+                        REPORTER_ASSERT(reporter, all[i] == dst[i]);
+                    }
+                }
+
+                if (0 == flags && !cov && mode <= SkXfermode::kLastSeparableMode) {
+                    SkXfermodeProc4f proc4f = SkXfermode::GetProc4f(mode);
+                    for (int i = 0; i < N; i++) {
+                        SkPMColor expected = proc4f(src[i], SkPM4f::FromPMColor(dst[i]))
+                                                 .toPMColor();
+                        for (int shift = 0; shift < 32; shift += 8) {
+                            int diff = (int)((all[i] >> shift) & 0xFF) -
+                                       (int)((expected >> shift) & 0xFF);
+                            REPORTER_ASSERT(reporter, SkTAbs(diff) <= 1);
+                        }
+                    }
+                }
+            }
+        }
+
+        for (uint32_t flags = 0; flags < 4; flags += 2) {
+            auto proc = SkXfermode::GetF16Proc(xfer.get(), flags);
+            const int step = (flags & SkXfermode::kSrcIsSingle_F16Flag) ? 0 : 1;
+            uint64_t all[N], each[N];
+            memcpy(all,  dst16, sizeof(dst16));
+            memcpy(each, dst16, sizeof(dst16));
+            proc(xfer.get(), all, src, N, aa);
+            for (int i = 0; i < N; i++) {
+                proc(xfer.get(), each + i, src + i*step, 1, aa + i);
+            }
+            REPORTER_ASSERT(reporter, 0 == memcmp(all, each, sizeof(all)));
+            for (int i = 0; i < N; i++) {
+                if (0 == aa[i]) {
+                    REPORTER_ASSERT(reporter, all[i] == dst16[i]);
+                }
+            }
+        }
+    }
+}
@@ -19,7 +19,8 @@ static SkStreamAsset* resource(const char path[]) {
 
 static void codec_yuv(skiatest::Reporter* reporter,
                   const char path[],
-                  SkISize expectedSizes[3]) {
+                  SkISize expectedSizes[3],
+                  SkYUVColorSpace expectedColorSpace = kJPEG_SkYUVColorSpace) {
     SkAutoTDelete<SkStream> stream(resource(path));
     if (!stream) {
         INFOF(reporter, "Missing resource '%s'\n", path);
@@ -58,7 +59,7 @@ static void codec_yuv(skiatest::Reporter* reporter,
             (uint32_t) SkAlign8(info.fSizes[SkYUVSizeInfo::kU].width()));
     REPORTER_ASSERT(reporter, info.fWidthBytes[SkYUVSizeInfo::kV] ==
             (uint32_t) SkAlign8(info.fSizes[SkYUVSizeInfo::kV].width()));
-    REPORTER_ASSERT(reporter, kJPEG_SkYUVColorSpace == colorSpace);
+    REPORTER_ASSERT(reporter, expectedColorSpace == colorSpace);
 
     // Allocate the memory for the YUV decode
     size_t totalBytes =
@@ -129,3 +130,19 @@ DEF_TEST(Jpeg_YUV_Codec, r) {
     // A PNG should fail.
     codec_yuv(r, "arrow.png", nullptr);
 }
+
+DEF_TEST(Webp_YUV_Codec, r) {
+    // Lossy, with odd dimensions.
+    SkISize sizes[3];
+    sizes[0].set(400, 301);
+    sizes[1].set(200, 151);
+    sizes[2].set(200, 151);
+    codec_yuv(r, "yellow_rose_opaque.webp", sizes, kRec601_SkYUVColorSpace);
+
+    // Only lossy images without alpha are YUV all the way through.  Lossless images are RGB,
+    // and these lossy images have alpha.
+    codec_yuv(r, "color_wheel.webp", nullptr);
+    codec_yuv(r, "randPixels.webp", nullptr);
+    codec_yuv(r, "yellow_rose.webp", nullptr);
+    codec_yuv(r, "baby_tux.webp", nullptr);
+}
@@ -34,6 +34,9 @@ static inline uint32_t compressed_fmt_to_gl_define(SkTextureCompressor::Format f
         GR_GL_COMPRESSED_RGBA_ASTC_10x10,      // kASTC_10x10_Format
         GR_GL_COMPRESSED_RGBA_ASTC_12x10,      // kASTC_12x10_Format
         GR_GL_COMPRESSED_RGBA_ASTC_12x12,      // kASTC_12x12_Format
+        GR_GL_COMPRESSED_RGBA8_ETC2,           // kETC2_RGBA8_Format
+        GR_GL_COMPRESSED_RGB_S3TC_DXT1_EXT,    // kBC1_Format
+        GR_GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,   // kBC3_Format
     };
 
     GR_STATIC_ASSERT(0 == SkTextureCompressor::kLATC_Format);
@@ -53,6 +56,9 @@ static inline uint32_t compressed_fmt_to_gl_define(SkTextureCompressor::Format f
     GR_STATIC_ASSERT(14 == SkTextureCompressor::kASTC_10x10_Format);
     GR_STATIC_ASSERT(15 == SkTextureCompressor::kASTC_12x10_Format);
     GR_STATIC_ASSERT(16 == SkTextureCompressor::kASTC_12x12_Format);
+    GR_STATIC_ASSERT(17 == SkTextureCompressor::kETC2_RGBA8_Format);
+    GR_STATIC_ASSERT(18 == SkTextureCompressor::kBC1_Format);
+    GR_STATIC_ASSERT(19 == SkTextureCompressor::kBC3_Format);
     GR_STATIC_ASSERT(SK_ARRAY_COUNT(kGLDefineMap) == SkTextureCompressor::kFormatCnt);
 
     return kGLDefineMap[fmt];
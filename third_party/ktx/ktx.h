@@ -49,6 +49,11 @@ public:
         return this->valid() ? fPixelData[mipmap].data() : NULL;
     }
 
+    size_t pixelDataSize(int mipmap = 0) const {
+        SkASSERT(!this->valid() || mipmap < fPixelData.count());
+        return this->valid() ? fPixelData[mipmap].dataSize() : 0;
+    }
+
     // If the decoded KTX file has the following key, then it will
     // return the associated value. If not found, the empty string
     // is returned.
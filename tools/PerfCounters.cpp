@@ -0,0 +1,114 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "PerfCounters.h"
+
+#ifdef PERF_COUNTERS_SUPPORTED
+
+#include <linux/perf_event.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+static int open_counter(uint32_t type, uint64_t config, int groupFD) {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size           = sizeof(attr);
+    attr.type           = type;
+    attr.config         = config;
+    attr.disabled       = groupFD < 0;  // Members follow the leader.
+    attr.exclude_kernel = 1;            // Usually all we're allowed, and all we care about.
+    attr.exclude_hv     = 1;
+    attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // pid 0, cpu -1: this thread, on whichever CPU it runs.
+    return (int)syscall(__NR_perf_event_open, &attr, 0, -1, groupFD, 0);
+}
+
+static uint64_t cache_config(uint64_t cache) {
+    return cache
+         | (PERF_COUNT_HW_CACHE_OP_READ     <<  8)
+         | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+PerfCounters::PerfCounters() {
+    struct { uint32_t type; uint64_t config; } kEvents[kCounterCount] = {
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES                },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS              },
+        { PERF_TYPE_HW_CACHE, cache_config(PERF_COUNT_HW_CACHE_L1D)   },
+        { PERF_TYPE_HW_CACHE, cache_config(PERF_COUNT_HW_CACHE_LL)    },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES             },
+    };
+    // Everything is opened as one group led by the cycle counter, so all counters are scheduled
+    // onto the PMU together and describe the same stretch of execution.
+    for (int i = 0; i < kCounterCount; i++) {
+        fValue[i] = -1;
+        fFD[i] = -1;
+        if (i == kCycles_Counter || this->isValid()) {
+            fFD[i] = open_counter(kEvents[i].type, kEvents[i].config, fFD[kCycles_Counter]);
+        }
+    }
+}
+
+PerfCounters::~PerfCounters() {
+    for (int i = 0; i < kCounterCount; i++) {
+        if (fFD[i] >= 0) {
+            close(fFD[i]);
+        }
+    }
+}
+
+void PerfCounters::start() {
+    if (!this->isValid()) {
+        return;
+    }
+    ioctl(fFD[kCycles_Counter], PERF_EVENT_IOC_RESET,  PERF_IOC_FLAG_GROUP);
+    ioctl(fFD[kCycles_Counter], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+void PerfCounters::stop() {
+    if (!this->isValid()) {
+        return;
+    }
+    ioctl(fFD[kCycles_Counter], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    for (int i = 0; i < kCounterCount; i++) {
+        fValue[i] = -1;
+        // value, time enabled, time running
+        uint64_t buf[3];
+        if (fFD[i] < 0 ||
+            (ssize_t)sizeof(buf) != read(fFD[i], buf, sizeof(buf)) ||
+            0 == buf[2]) {
+            continue;
+        }
+        fValue[i] = (double)buf[0] * ((double)buf[1] / (double)buf[2]);
+    }
+}
+
+#else
+
+PerfCounters::PerfCounters() {
+    for (int i = 0; i < kCounterCount; i++) {
+        fFD[i] = -1;
+        fValue[i] = -1;
+    }
+}
+PerfCounters::~PerfCounters() {}
+void PerfCounters::start() {}
+void PerfCounters::stop() {}
+
+#endif
+
+const char* PerfCounters::Name(Counter c) {
+    static const char* kNames[kCounterCount] = {
+        "cycles",
+        "instructions",
+        "l1d_read_misses",
+        "llc_read_misses",
+        "branch_misses",
+    };
+    return kNames[c];
+}
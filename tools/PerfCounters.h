@@ -0,0 +1,63 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef PerfCounters_DEFINED
+#define PerfCounters_DEFINED
+
+#include "SkTypes.h"
+
+#if defined(SK_BUILD_FOR_UNIX) || defined(SK_BUILD_FOR_ANDROID)
+#    define PERF_COUNTERS_SUPPORTED
+#endif
+
+/*
+ * Hardware performance counters for the calling thread, read through perf_event_open on Linux
+ * and Android.  Elsewhere, or when the kernel refuses us (e.g. perf_event_paranoid, or running
+ * in a VM without a PMU), every counter simply reports as unavailable.
+ *
+ * Only user space is counted, and only on the thread that called start(); work farmed out to
+ * SkTaskGroup threads is not included.
+ */
+class PerfCounters {
+public:
+    enum Counter {
+        kCycles_Counter,
+        kInstructions_Counter,
+        kL1DMisses_Counter,
+        kLLCMisses_Counter,
+        kBranchMisses_Counter,
+
+        kLast_Counter = kBranchMisses_Counter
+    };
+    static const int kCounterCount = kLast_Counter + 1;
+
+    PerfCounters();
+    ~PerfCounters();
+
+    // A name suitable for use as a ResultsWriter metric.
+    static const char* Name(Counter);
+
+    // Is the counter available on this machine?
+    bool has(Counter c) const { return fFD[c] >= 0; }
+    // Are any counters available?
+    bool isValid() const { return this->has(kCycles_Counter); }
+
+    // Zero and start all counters.
+    void start();
+    // Stop all counters.  Values are then available from value().
+    void stop();
+
+    // The count since the last start(), scaled up if the kernel had to multiplex the counters.
+    // Returns -1 if the counter is unavailable.
+    double value(Counter c) const { return fValue[c]; }
+
+private:
+    int    fFD[kCounterCount];
+    double fValue[kCounterCount];
+};
+
+#endif
@@ -9,6 +9,9 @@
 
 #include "SkShaper.h"
 #include "SkStream.h"
+#include "SkString.h"
+#include "SkTHash.h"
+#include "SkTInternalLList.h"
 #include "SkTextBlob.h"
 #include "SkTypeface.h"
 
@@ -50,9 +53,90 @@ struct SkShaper::Impl {
     };
     std::unique_ptr<hb_buffer_t, HBBufDel> fBuffer;
     sk_sp<SkTypeface> fTypeface;
+
+    // The result of shaping some text, in FONT_SIZE_SCALE units.
+    struct Shaped {
+        SK_DECLARE_INTERNAL_LLIST_INTERFACE(Shaped);
+
+        SkString                    fText;
+        int                         fCount;
+        SkAutoTMalloc<uint16_t>     fGlyphs;
+        SkAutoTMalloc<uint32_t>     fClusters;
+        SkAutoTMalloc<SkIPoint>     fOffsets;
+        SkAutoTMalloc<SkIPoint>     fAdvances;
+    };
+
+    ~Impl() {
+        while (Shaped* shaped = fLRU.head()) {
+            fLRU.remove(shaped);
+            delete shaped;
+        }
+    }
+
+    // Returns the shaping of the text, shaping it if it isn't cached.
+    const Shaped* shape(const char* utf8text, size_t textBytes);
+
+    // Most recently used first.
+    SkTInternalLList<Shaped>        fLRU;
+    SkTHashMap<SkString, Shaped*>   fCache;
+    int                             fCacheCount;
 };
 
-SkShaper::SkShaper(sk_sp<SkTypeface> tf) : fImpl(new Impl) {
+const SkShaper::Impl::Shaped* SkShaper::Impl::shape(const char* utf8text, size_t textBytes) {
+    SkString key(utf8text, textBytes);
+    if (Shaped** cached = fCache.find(key)) {
+        fLRU.remove(*cached);
+        fLRU.addToHead(*cached);
+        return *cached;
+    }
+
+    hb_buffer_t* buffer = fBuffer.get();
+    hb_buffer_add_utf8(buffer, utf8text, SkToInt(textBytes), 0, SkToInt(textBytes));
+    hb_buffer_guess_segment_properties(buffer);
+    hb_shape(fHarfBuzzFont.get(), buffer, nullptr, 0);
+    unsigned len = hb_buffer_get_length(buffer);
+    hb_glyph_info_t* info = hb_buffer_get_glyph_infos(buffer, nullptr);
+    hb_glyph_position_t* pos = hb_buffer_get_glyph_positions(buffer, nullptr);
+
+    Shaped* shaped;
+    if (fCacheCount > 0 && fCache.count() >= fCacheCount) {
+        // Reuse the least recently used entry.
+        shaped = fLRU.tail();
+        fLRU.remove(shaped);
+        fCache.remove(shaped->fText);
+    } else {
+        shaped = new Shaped;
+    }
+    shaped->fText = key;
+    shaped->fCount = SkToInt(len);
+    shaped->fGlyphs.reset(len);
+    shaped->fClusters.reset(len);
+    shaped->fOffsets.reset(len);
+    shaped->fAdvances.reset(len);
+    for (unsigned i = 0; i < len; i++) {
+        shaped->fGlyphs[i] = SkToU16(info[i].codepoint);
+        shaped->fClusters[i] = info[i].cluster;
+        shaped->fOffsets[i].set(pos[i].x_offset, pos[i].y_offset);
+        shaped->fAdvances[i].set(pos[i].x_advance, pos[i].y_advance);
+    }
+    hb_buffer_clear_contents(buffer);
+
+    fLRU.addToHead(shaped);
+    fCache.set(key, shaped);
+    if (fCacheCount <= 0) {
+        // Not caching, so only hold on to the last result.
+        while (fLRU.tail() != shaped) {
+            Shaped* old = fLRU.tail();
+            fLRU.remove(old);
+            fCache.remove(old->fText);
+            delete old;
+        }
+    }
+    return shaped;
+}
+
+SkShaper::SkShaper(sk_sp<SkTypeface> tf, int cacheCount) : fImpl(new Impl) {
+    fImpl->fCacheCount = cacheCount;
     fImpl->fTypeface = tf ? std::move(tf) : SkTypeface::MakeDefault();
     int index;
     std::unique_ptr<hb_blob_t, HBFBlobDel> blob(
@@ -92,20 +176,14 @@ SkScalar SkShaper::shape(SkTextBlobBuilder* builder,
     paint.setTypeface(fImpl->fTypeface);
 
     SkASSERT(builder);
-    hb_buffer_t* buffer = fImpl->fBuffer.get();
-    hb_buffer_add_utf8(buffer, utf8text, -1, 0, -1);
-    hb_buffer_guess_segment_properties(buffer);
-    hb_shape(fImpl->fHarfBuzzFont.get(), buffer, nullptr, 0);
-    unsigned len = hb_buffer_get_length(buffer);
+    const Impl::Shaped* shaped = fImpl->shape(utf8text, textBytes);
+    int len = shaped->fCount;
     if (len == 0) {
-        hb_buffer_clear_contents(buffer);
         return 0;
     }
 
-    hb_glyph_info_t* info = hb_buffer_get_glyph_infos(buffer, NULL);
-    hb_glyph_position_t* pos =
-            hb_buffer_get_glyph_positions(buffer, NULL);
     auto runBuffer = builder->allocRunPos(paint, len);
+    memcpy(runBuffer.glyphs, shaped->fGlyphs.get(), len * sizeof(uint16_t));
 
     double x = point.x();
     double y = point.y();
@@ -113,14 +191,12 @@ SkScalar SkShaper::shape(SkTextBlobBuilder* builder,
     double textSizeY = paint.getTextSize() / (double)FONT_SIZE_SCALE;
     double textSizeX = textSizeY * paint.getTextScaleX();
 
-    for (unsigned i = 0; i < len; i++) {
-        runBuffer.glyphs[i] = info[i].codepoint;
+    for (int i = 0; i < len; i++) {
         reinterpret_cast<SkPoint*>(runBuffer.pos)[i] =
-                SkPoint::Make(x + pos[i].x_offset * textSizeX,
-                              y - pos[i].y_offset * textSizeY);
-        x += pos[i].x_advance * textSizeX;
-        y += pos[i].y_advance * textSizeY;
+                SkPoint::Make(x + shaped->fOffsets[i].fX * textSizeX,
+                              y - shaped->fOffsets[i].fY * textSizeY);
+        x += shaped->fAdvances[i].fX * textSizeX;
+        y += shaped->fAdvances[i].fY * textSizeY;
     }
-    hb_buffer_clear_contents(buffer);
     return (SkScalar)x;
 }
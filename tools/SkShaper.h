@@ -19,10 +19,16 @@ class SkTextBlobBuilder;
 /**
    Shapes text using harfbuzz and places the shaped text into a
    TextBlob.
+
+   Shaping results don't depend on the paint, so the shaper keeps the most recently shaped
+   texts and reshapes only text that isn't among them.
  */
 class SkShaper {
 public:
-    SkShaper(sk_sp<SkTypeface> face);
+    /** The number of shaped texts kept by default. */
+    static const int kDefaultCacheCount = 128;
+
+    SkShaper(sk_sp<SkTypeface> face, int cacheCount = kDefaultCacheCount);
     ~SkShaper();
 
     bool good() const;
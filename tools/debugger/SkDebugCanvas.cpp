@@ -11,6 +11,7 @@
 #include "SkDrawCommand.h"
 #include "SkPaintFilterCanvas.h"
 #include "SkOverdrawMode.h"
+#include "SkTime.h"
 
 #if SK_SUPPORT_GPU
 #include "GrAuditTrail.h"
@@ -67,6 +68,54 @@ private:
     typedef SkPaintFilterCanvas INHERITED;
 };
 
+// Draws nothing, but records the features of the paints it is asked to draw with.
+class PaintFeatureCanvas : public SkPaintFilterCanvas {
+public:
+    PaintFeatureCanvas(int width, int height) : INHERITED(width, height) {}
+
+    const SkTArray<const char*>& features() const { return fFeatures; }
+    void reset() { fFeatures.reset(); }
+
+protected:
+    bool onFilter(SkTCopyOnFirstWrite<SkPaint>* paint, Type) const override {
+        if (*paint) {
+            const SkPaint& p = **paint;
+            this->add(p.isAntiAlias(), "antialias");
+            this->add(p.getStyle() != SkPaint::kFill_Style,
+                      0 == p.getStrokeWidth() ? "hairline" : "stroke");
+            this->add(p.getAlpha() != 0xFF, "alpha");
+            this->add(!SkXfermode::IsMode(p.getXfermode(), SkXfermode::kSrcOver_Mode),
+                      "xfermode");
+            this->add(p.getFilterQuality() != kNone_SkFilterQuality, "filterQuality");
+            this->add(SkToBool(p.getShader()), "shader");
+            this->add(SkToBool(p.getColorFilter()), "colorFilter");
+            this->add(SkToBool(p.getMaskFilter()), "maskFilter");
+            this->add(SkToBool(p.getImageFilter()), "imageFilter");
+            this->add(SkToBool(p.getPathEffect()), "pathEffect");
+            this->add(SkToBool(p.getLooper()), "looper");
+            this->add(SkToBool(p.getRasterizer()), "rasterizer");
+        }
+        return false;
+    }
+
+private:
+    void add(bool present, const char* feature) const {
+        if (!present) {
+            return;
+        }
+        for (const char* f : fFeatures) {
+            if (f == feature) {
+                return;
+            }
+        }
+        fFeatures.push_back(feature);
+    }
+
+    mutable SkTArray<const char*> fFeatures;
+
+    typedef SkPaintFilterCanvas INHERITED;
+};
+
 SkDebugCanvas::SkDebugCanvas(int width, int height)
         : INHERITED(width, height)
         , fPicture(nullptr)
@@ -501,6 +550,98 @@ Json::Value SkDebugCanvas::toJSONBatchList(int n, SkCanvas* canvas) {
     return parsedFromString;
 }
 
+static bool is_draw(SkDrawCommand::OpType type) {
+    return type >= SkDrawCommand::kDrawAnnotation_OpType &&
+           type <= SkDrawCommand::kDrawVertices_OpType;
+}
+
+static void add_cost(Json::Value* totals, const char* key, double ms) {
+    Json::Value& total = (*totals)[key];
+    total["count"] = total["count"].asInt() + 1;
+    total["ms"] = total["ms"].asDouble() + ms;
+}
+
+Json::Value SkDebugCanvas::toJSONProfile(int n, int repeats, SkCanvas* canvas,
+                                         const std::function<void()>& finish) {
+    SkASSERT(n < this->getSize());
+    repeats = SkTMax(repeats, 1);
+
+    auto sync = [&] {
+        canvas->flush();
+        finish();
+    };
+    auto now_ms = [] { return SkTime::GetNSecs() * 1e-6; };
+
+    // Every measurement includes one flush and finish; estimate that overhead so we can remove it.
+    sync();
+    double overhead = SK_ScalarMax;
+    for (int i = 0; i < 5; i++) {
+        double start = now_ms();
+        sync();
+        overhead = SkTMin(overhead, now_ms() - start);
+    }
+
+    int saveCount = canvas->save();
+    canvas->clear(SK_ColorWHITE);
+    canvas->resetMatrix();
+    SkRect windowRect = SkRect::MakeWH(SkIntToScalar(canvas->getBaseLayerSize().width()),
+                                       SkIntToScalar(canvas->getBaseLayerSize().height()));
+    if (!windowRect.isEmpty()) {
+        canvas->clipRect(windowRect, SkRegion::kReplace_Op);
+    }
+    this->applyUserTransform(canvas);
+    sync();
+
+    PaintFeatureCanvas featureCanvas(canvas->getBaseLayerSize().width(),
+                                     canvas->getBaseLayerSize().height());
+    Json::Value commands(Json::arrayValue);
+    Json::Value byType(Json::objectValue);
+    Json::Value byFeature(Json::objectValue);
+    for (int i = 0; i <= n; i++) {
+        SkDrawCommand* command = fCommandVector[i];
+        if (!command->isVisible()) {
+            continue;
+        }
+        command->setUserMatrix(fUserMatrix);
+
+        // Repeating a state command would change the state, so those run once.
+        bool draw = is_draw(command->getType());
+        int executions = draw ? repeats : 1;
+        double start = now_ms();
+        for (int r = 0; r < executions; r++) {
+            command->execute(canvas);
+        }
+        sync();
+        double ms = SkTMax(0.0, now_ms() - start - overhead) / executions;
+
+        Json::Value profile;
+        profile["index"] = i;
+        profile["command"] = SkDrawCommand::GetCommandString(command->getType());
+        profile["ms"] = ms;
+        profile["features"] = Json::Value(Json::arrayValue);
+        add_cost(&byType, SkDrawCommand::GetCommandString(command->getType()), ms);
+        if (draw) {
+            featureCanvas.reset();
+            command->execute(&featureCanvas);
+            for (const char* feature : featureCanvas.features()) {
+                profile["features"].append(feature);
+                add_cost(&byFeature, feature, ms);
+            }
+        }
+        commands.append(profile);
+    }
+    canvas->restoreToCount(saveCount);
+    sync();
+
+    Json::Value result;
+    result["repeats"] = repeats;
+    result["overheadMs"] = overhead;
+    result["commands"] = commands;
+    result["byType"] = byType;
+    result["byFeature"] = byFeature;
+    return result;
+}
+
 void SkDebugCanvas::updatePaintFilterCanvas() {
     if (!fOverdrawViz && !fOverrideFilterQuality) {
         fPaintFilterCanvas.reset(nullptr);
@@ -18,6 +18,8 @@
 #include "SkTArray.h"
 #include "UrlDataManager.h"
 
+#include <functional>
+
 class GrAuditTrail;
 class SkNWayCanvas;
 
@@ -162,6 +164,16 @@ public:
 
     Json::Value toJSONBatchList(int n, SkCanvas*);
 
+    /**
+        Returns a JSON object with the cost of each of the first N+1 commands when played back to
+        the canvas.  Each draw is executed repeats times on its own, between flushes, and the
+        average time per execution is reported along with the paint features it used; state
+        commands (save, clip, concat, ...) are executed and timed once.  Costs are also totalled
+        by command type and by paint feature.  finish is called after each flush and should wait
+        for the backend to complete the work, e.g. with a GPU finish().
+     */
+    Json::Value toJSONProfile(int n, int repeats, SkCanvas*, const std::function<void()>& finish);
+
 ////////////////////////////////////////////////////////////////////////////////
 // Inherited from SkCanvas
 ////////////////////////////////////////////////////////////////////////////////
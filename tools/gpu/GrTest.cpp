@@ -34,6 +34,7 @@ void SetupAlwaysEvictAtlas(GrContext* context) {
     configs[kA8_GrMaskFormat].fLog2Height = SkNextLog2(dim);
     configs[kA8_GrMaskFormat].fPlotWidth = dim;
     configs[kA8_GrMaskFormat].fPlotHeight = dim;
+    configs[kA8_GrMaskFormat].fMaxPages = 1;
 
     configs[kA565_GrMaskFormat].fWidth = dim;
     configs[kA565_GrMaskFormat].fHeight = dim;
@@ -41,6 +42,7 @@ void SetupAlwaysEvictAtlas(GrContext* context) {
     configs[kA565_GrMaskFormat].fLog2Height = SkNextLog2(dim);
     configs[kA565_GrMaskFormat].fPlotWidth = dim;
     configs[kA565_GrMaskFormat].fPlotHeight = dim;
+    configs[kA565_GrMaskFormat].fMaxPages = 1;
 
     configs[kARGB_GrMaskFormat].fWidth = dim;
     configs[kARGB_GrMaskFormat].fHeight = dim;
@@ -48,6 +50,7 @@ void SetupAlwaysEvictAtlas(GrContext* context) {
     configs[kARGB_GrMaskFormat].fLog2Height = SkNextLog2(dim);
     configs[kARGB_GrMaskFormat].fPlotWidth = dim;
     configs[kARGB_GrMaskFormat].fPlotHeight = dim;
+    configs[kARGB_GrMaskFormat].fMaxPages = 1;
 
     context->setTextContextAtlasSizes_ForTesting(configs);
 }
@@ -159,6 +162,7 @@ void SkGpuDevice::drawTexture(GrTexture* tex, const SkRect& dst, const SkPaint&
 void GrGpu::Stats::dump(SkString* out) {
     out->appendf("Render Target Binds: %d\n", fRenderTargetBinds);
     out->appendf("Shader Compilations: %d\n", fShaderCompilations);
+    out->appendf("Program Link Waits: %d\n", fProgramLinkWaits);
     out->appendf("Textures Created: %d\n", fTextureCreates);
     out->appendf("Texture Uploads: %d\n", fTextureUploads);
     out->appendf("Transfers to Texture: %d\n", fTransfersToTexture);
@@ -311,6 +315,15 @@ public:
 
     void drawDebugWireRect(GrRenderTarget*, const SkIRect&, GrColor) override {};
 
+    GrFence SK_WARN_UNUSED_RESULT insertFence() override { return 0; }
+    bool waitFence(GrFence, uint64_t) override { return true; }
+    void deleteFence(GrFence) override {}
+
+    GrTimerQuery SK_WARN_UNUSED_RESULT createTimerQuery() override { return 0; }
+    bool timerQueryResult(GrTimerQuery, bool, uint64_t*) override { return false; }
+    bool timerQueriesDisjoint() override { return false; }
+    void deleteTimerQuery(GrTimerQuery) override {}
+
 private:
     void onResetContext(uint32_t resetBits) override {}
 
@@ -363,6 +376,13 @@ private:
         return false;
     }
 
+    bool onReadPixelsToBuffer(GrSurface* surface,
+                              int left, int top, int width, int height,
+                              GrPixelConfig config, GrBuffer* transferBuffer,
+                              size_t offset, size_t rowBytes) override {
+        return false;
+    }
+
     void onResolveRenderTarget(GrRenderTarget* target) override { return; }
 
     GrStencilAttachment* createStencilAttachmentForRenderTarget(const GrRenderTarget*,
@@ -272,6 +272,33 @@ SkData* Request::getJsonBatchList(int n) {
     return stream.copyToData();
 }
 
+SkData* Request::getJsonProfile(int n, int repeats) {
+    SkCanvas* canvas = this->getCanvas();
+    std::function<void()> finish = [] {};
+#if SK_SUPPORT_GPU
+    if (fGPUEnabled) {
+        ContextInfo info = fContextFactory->getContextInfo(GrContextFactory::kNativeGL_ContextType,
+                                                           GrContextFactory::kNone_ContextOptions);
+        if (!info.testContext()) {
+            info = fContextFactory->getContextInfo(GrContextFactory::kMESA_ContextType,
+                                                   GrContextFactory::kNone_ContextOptions);
+        }
+        TestContext* testContext = info.testContext();
+        if (testContext) {
+            finish = [testContext] { testContext->finish(); };
+        }
+    }
+#endif
+
+    Json::Value result = fDebugCanvas->toJSONProfile(n, repeats, canvas, finish);
+    result["mode"] = Json::Value(fGPUEnabled ? "gpu" : "cpu");
+
+    SkDynamicMemoryWStream stream;
+    stream.writeText(Json::FastWriter().write(result).c_str());
+
+    return stream.copyToData();
+}
+
 SkData* Request::getJsonInfo(int n) {
     // drawTo
     SkAutoTUnref<SkSurface> surface(this->createCPUSurface());
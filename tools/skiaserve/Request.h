@@ -53,6 +53,9 @@ struct Request {
     // Returns a json list of batches as an SkData
     SkData* getJsonBatchList(int n);
 
+    // Returns json with the cost of each op up to N, executing each draw repeats times
+    SkData* getJsonProfile(int n, int repeats);
+
     // Returns json with the viewMatrix and clipRect
     SkData* getJsonInfo(int n);
 
@@ -0,0 +1,45 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "UrlHandler.h"
+
+#include "microhttpd.h"
+#include "../Request.h"
+#include "../Response.h"
+
+using namespace Response;
+
+static const int kDefaultRepeats = 10;
+
+bool ProfileHandler::canHandle(const char* method, const char* url) {
+    const char* kBasePath = "/profile";
+    return 0 == strcmp(method, MHD_HTTP_METHOD_GET) &&
+           0 == strncmp(url, kBasePath, strlen(kBasePath));
+}
+
+int ProfileHandler::handle(Request* request, MHD_Connection* connection,
+                           const char* url, const char* method,
+                           const char* upload_data, size_t* upload_data_size) {
+    SkTArray<SkString> commands;
+    SkStrSplit(url, "/", &commands);
+
+    if (!request->hasPicture() || commands.count() > 2) {
+        return MHD_NO;
+    }
+
+    // /profile or /profile/N
+    int repeats = kDefaultRepeats;
+    if (2 == commands.count()) {
+        sscanf(commands[1].c_str(), "%d", &repeats);
+        if (repeats < 1) {
+            return MHD_NO;
+        }
+    }
+
+    SkAutoTUnref<SkData> data(request->getJsonProfile(request->getLastOp(), repeats));
+    return SendData(connection, data, "application/json");
+}
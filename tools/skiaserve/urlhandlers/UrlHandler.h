@@ -110,6 +110,18 @@ public:
                const char* upload_data, size_t* upload_data_size) override;
 };
 
+/*
+ * Returns a json profile of the cost of each command, and of each command type and paint feature.
+ * GET /profile executes each draw 10 times, /profile/N executes each N times.
+ */
+class ProfileHandler : public UrlHandler {
+public:
+    bool canHandle(const char* method, const char* url) override;
+    int handle(Request* request, MHD_Connection* connection,
+               const char* url, const char* method,
+               const char* upload_data, size_t* upload_data_size) override;
+};
+
 /*
  * Enables drawing of batch bounds
  */
@@ -6,21 +6,37 @@
  */
 
 #include "SkCommandLineFlags.h"
+#include "SkColorFilter.h"
+#include "SkDrawLooper.h"
+#include "SkImageFilter.h"
+#include "SkMaskFilter.h"
+#include "SkPathEffect.h"
 #include "SkPicture.h"
 #include "SkPictureData.h"
+#include "SkRecord.h"
+#include "SkRecordDraw.h"
+#include "SkRecorder.h"
+#include "SkShader.h"
 #include "SkStream.h"
 #include "SkFontDescriptor.h"
+#include "SkTaskGroup.h"
+#include "SkXfermode.h"
+#include <stdio.h>
 
-DEFINE_string2(input, i, "", "skp on which to report");
+DEFINE_string2(input, i, "", "skp on which to report; --stats takes any number of them");
 DEFINE_bool2(version, v, true, "version");
 DEFINE_bool2(cullRect, c, true, "cullRect");
 DEFINE_bool2(flags, f, true, "flags");
 DEFINE_bool2(tags, t, true, "tags");
 DEFINE_bool2(quiet, q, false, "quiet");
+DEFINE_bool2(stats, s, false, "print op, paint, path and raster cost statistics as JSON, one "
+                              "line per input");
+DEFINE_int32(threads, -1, "threads to analyze --stats inputs on; -1 means one per core");
 
 // This tool can print simple information about an SKP but its main use
 // is just to check if an SKP has been truncated during the recording
-// process.
+// process. With --stats it instead loads each SKP and walks its SkRecord
+// to report statistics, which is much faster than scripting SkLuaCanvas.
 // return codes:
 static const int kSuccess = 0;
 static const int kTruncatedFile = 1;
@@ -29,11 +45,282 @@ static const int kInvalidTag = 3;
 static const int kMissingInput = 4;
 static const int kIOError = 5;
 
+static void append_json_string(SkString* json, const char* str) {
+    json->append("\"");
+    for (; *str; ++str) {
+        if ('"' == *str || '\\' == *str) {
+            json->appendf("\\%c", *str);
+        } else if ((unsigned char)*str < 0x20) {
+            json->appendf("\\u%04x", *str);
+        } else {
+            json->append(str, 1);
+        }
+    }
+    json->append("\"");
+}
+
+#define OP_NAME(T) #T,
+static const char* gOpNames[] = { SK_RECORD_TYPES(OP_NAME) };
+#undef OP_NAME
+
+// Gathers the --stats numbers for one picture by visiting each op of its SkRecord.
+class StatsVisitor {
+public:
+    StatsVisitor(const SkRect& cullRect, const SkRecord& record)
+        : fCullRect(cullRect)
+        , fBounds(record.count()) {
+        SkRecordFillBounds(cullRect, record, fBounds.get());
+        sk_bzero(fOpCounts, sizeof(fOpCounts));
+        sk_bzero(&fPaints, sizeof(fPaints));
+        sk_bzero(&fDrawPaths, sizeof(fDrawPaths));
+        sk_bzero(&fClipPaths, sizeof(fClipPaths));
+        for (int i = 0; i < record.count(); ++i) {
+            fCurrentOp = i;
+            record.visit(i, *this);
+        }
+    }
+
+    template <typename T>
+    void operator()(const T& op) {
+        fOpCounts[T::kType]++;
+        if (T::kTags & SkRecords::kDraw_Tag) {
+            this->countDraw(PaintOf(op, 0));
+        }
+        this->countPaths(op);
+    }
+
+    void operator()(const SkRecords::SaveLayer& op) {
+        fOpCounts[SkRecords::SaveLayer::kType]++;
+        // Clearing the layer and compositing it back each touch every pixel of it.
+        fRasterCost += 2 * this->currentArea();
+    }
+
+    void appendJSON(SkString* json) const {
+        json->append(", \"ops\": {");
+        const char* separator = "";
+        for (int i = 0; i < kOpTypeCount; ++i) {
+            if (fOpCounts[i]) {
+                json->appendf("%s\"%s\": %d", separator, gOpNames[i], fOpCounts[i]);
+                separator = ", ";
+            }
+        }
+        json->appendf("}, \"paints\": {\"count\": %d, \"antiAlias\": %d, \"stroke\": %d, "
+                      "\"hairline\": %d, \"translucent\": %d, \"gradient\": %d, "
+                      "\"bitmapShader\": %d, \"otherShader\": %d, \"colorFilter\": %d, "
+                      "\"maskFilter\": %d, \"pathEffect\": %d, \"imageFilter\": %d, "
+                      "\"looper\": %d, \"nonSrcOverXfermode\": %d}",
+                      fPaints.fCount, fPaints.fAntiAlias, fPaints.fStroke, fPaints.fHairline,
+                      fPaints.fTranslucent, fPaints.fGradient, fPaints.fBitmapShader,
+                      fPaints.fOtherShader, fPaints.fColorFilter, fPaints.fMaskFilter,
+                      fPaints.fPathEffect, fPaints.fImageFilter, fPaints.fLooper,
+                      fPaints.fNonSrcOverXfermode);
+        AppendPathJSON(json, "drawPaths", fDrawPaths);
+        AppendPathJSON(json, "clipPaths", fClipPaths);
+        double cullArea = SkTMax<double>(1, (double)fCullRect.width() * fCullRect.height());
+        json->appendf(", \"coveredPixels\": %.0f, \"overdraw\": %.3f, \"rasterCost\": %.0f",
+                      fCoveredPixels, fCoveredPixels / cullArea, fRasterCost);
+    }
+
+private:
+    struct PaintStats {
+        int fCount;
+        int fAntiAlias;
+        int fStroke;
+        int fHairline;
+        int fTranslucent;
+        int fGradient;
+        int fBitmapShader;
+        int fOtherShader;
+        int fColorFilter;
+        int fMaskFilter;
+        int fPathEffect;
+        int fImageFilter;
+        int fLooper;
+        int fNonSrcOverXfermode;
+    };
+
+    struct PathStats {
+        int fCount;
+        int fAntiAlias;
+        int fConvex;
+        int fCurved;
+        int fMaxVerbs;
+        int64_t fVerbs;
+        int64_t fPoints;
+    };
+
+    static const int kOpTypeCount = SK_ARRAY_COUNT(gOpNames);
+
+    template <typename T>
+    static auto PaintOf(const T& op, int) -> decltype(op.paint) { return op.paint; }
+    template <typename T>
+    static const SkPaint* PaintOf(const T&, ...) { return nullptr; }
+
+    double currentArea() const {
+        SkRect bounds = fBounds[fCurrentOp];
+        if (!bounds.intersect(fCullRect)) {
+            return 0;
+        }
+        return (double)bounds.width() * bounds.height();
+    }
+
+    // A rough cost model for rasterizing a draw: each pixel it covers costs 1, plus 1 for each
+    // shader, color filter or non-src-over xfermode stage, plus 4 for a mask or image filter,
+    // which render to and blur an offscreen mask or layer first.
+    void countDraw(const SkPaint* paint) {
+        double area = this->currentArea();
+        fCoveredPixels += area;
+        int cost = 1;
+        if (paint) {
+            fPaints.fCount++;
+            fPaints.fAntiAlias += paint->isAntiAlias();
+            if (SkPaint::kFill_Style != paint->getStyle()) {
+                fPaints.fStroke++;
+                fPaints.fHairline += 0 == paint->getStrokeWidth();
+            }
+            fPaints.fTranslucent += 0xFF != paint->getAlpha();
+            if (const SkShader* shader = paint->getShader()) {
+                if (SkShader::kNone_GradientType != shader->asAGradient(nullptr)) {
+                    fPaints.fGradient++;
+                } else if (shader->isABitmap()) {
+                    fPaints.fBitmapShader++;
+                } else {
+                    fPaints.fOtherShader++;
+                }
+                cost += 1;
+            }
+            if (paint->getColorFilter()) {
+                fPaints.fColorFilter++;
+                cost += 1;
+            }
+            if (paint->getMaskFilter()) {
+                fPaints.fMaskFilter++;
+                cost += 4;
+            }
+            fPaints.fPathEffect += nullptr != paint->getPathEffect();
+            if (paint->getImageFilter()) {
+                fPaints.fImageFilter++;
+                cost += 4;
+            }
+            fPaints.fLooper += nullptr != paint->getLooper();
+            if (!SkXfermode::IsMode(paint->getXfermode(), SkXfermode::kSrcOver_Mode)) {
+                fPaints.fNonSrcOverXfermode++;
+                cost += 1;
+            }
+        }
+        fRasterCost += cost * area;
+    }
+
+    template <typename T>
+    void countPaths(const T&) {}
+    void countPaths(const SkRecords::DrawPath& op) {
+        CountPath(op.path, op.paint && op.paint->isAntiAlias(), &fDrawPaths);
+    }
+    void countPaths(const SkRecords::ClipPath& op) {
+        CountPath(op.path, op.opAA.aa, &fClipPaths);
+    }
+
+    static void CountPath(const SkPath& path, bool antiAlias, PathStats* stats) {
+        stats->fCount++;
+        stats->fAntiAlias += antiAlias;
+        stats->fConvex += path.isConvex();
+        stats->fCurved += SkToBool(path.getSegmentMasks() & ~SkPath::kLine_SegmentMask);
+        stats->fMaxVerbs = SkTMax(stats->fMaxVerbs, path.countVerbs());
+        stats->fVerbs += path.countVerbs();
+        stats->fPoints += path.countPoints();
+    }
+
+    static void AppendPathJSON(SkString* json, const char* name, const PathStats& stats) {
+        json->appendf(", \"%s\": {\"count\": %d, \"antiAlias\": %d, \"convex\": %d, "
+                      "\"curved\": %d, \"verbs\": %lld, \"maxVerbs\": %d, \"points\": %lld}",
+                      name, stats.fCount, stats.fAntiAlias, stats.fConvex, stats.fCurved,
+                      (long long)stats.fVerbs, stats.fMaxVerbs, (long long)stats.fPoints);
+    }
+
+    const SkRect          fCullRect;
+    SkAutoTMalloc<SkRect> fBounds;
+    int                   fCurrentOp;
+    int                   fOpCounts[kOpTypeCount];
+    PaintStats            fPaints;
+    PathStats             fDrawPaths;
+    PathStats             fClipPaths;
+    double                fCoveredPixels = 0;
+    double                fRasterCost = 0;
+};
+
+// Writes one line of JSON about the SKP at path. Returns false if it could not be read.
+static bool analyze_skp(const char* path, SkString* json) {
+    json->append("{\"file\": ");
+    append_json_string(json, path);
+
+    SkFILEStream stream(path);
+    if (!stream.isValid()) {
+        json->append(", \"error\": \"Couldn't open file\"}");
+        return false;
+    }
+    SkPictInfo info;
+    if (!SkPicture::InternalOnly_StreamIsSKP(&stream, &info) || !stream.rewind()) {
+        json->append(", \"error\": \"Not an SKP\"}");
+        return false;
+    }
+    sk_sp<SkPicture> picture(SkPicture::MakeFromStream(&stream));
+    if (!picture) {
+        json->append(", \"error\": \"Couldn't parse SKP\"}");
+        return false;
+    }
+
+    const SkRect& cull = picture->cullRect();
+    SkRecord record;
+    SkRecorder recorder(&record, cull);
+    picture->playback(&recorder);
+
+    json->appendf(", \"version\": %d, \"cullRect\": [%g, %g, %g, %g], \"opCount\": %d",
+                  info.fVersion, cull.fLeft, cull.fTop, cull.fRight, cull.fBottom,
+                  record.count());
+    StatsVisitor(cull, record).appendJSON(json);
+    json->append("}");
+    return true;
+}
+
+static int stats_main() {
+    if (FLAGS_input.count() < 1) {
+        if (!FLAGS_quiet) {
+            SkDebugf("Missing input file\n");
+        }
+        return kMissingInput;
+    }
+
+    // Analyze a chunk of inputs at a time, so that huge input lists stream their results out
+    // instead of holding them all until the end.
+    static const int kInputsPerChunk = 256;
+    SkTaskGroup::Enabler enabled(FLAGS_threads);
+    int failures = 0;
+    for (int start = 0; start < FLAGS_input.count(); start += kInputsPerChunk) {
+        const int count = SkTMin(kInputsPerChunk, FLAGS_input.count() - start);
+        SkTArray<SkString> json(count);
+        json.push_back_n(count);
+        SkAutoTMalloc<bool> ok(count);
+        SkTaskGroup().batch(count, [&](int i) {
+            ok[i] = analyze_skp(FLAGS_input[start + i], &json[i]);
+        });
+        for (int i = 0; i < count; ++i) {
+            printf("%s\n", json[i].c_str());
+            failures += !ok[i];
+        }
+    }
+    fflush(stdout);
+    return failures ? kNotAnSKP : kSuccess;
+}
+
 int tool_main(int argc, char** argv);
 int tool_main(int argc, char** argv) {
     SkCommandLineFlags::SetUsage("Prints information about an skp file");
     SkCommandLineFlags::Parse(argc, argv);
 
+    if (FLAGS_stats) {
+        return stats_main();
+    }
+
     if (FLAGS_input.count() != 1) {
         if (!FLAGS_quiet) {
             SkDebugf("Missing input file\n");
@@ -93,6 +380,9 @@ int tool_main(int argc, char** argv) {
         // reading the file.
         return kSuccess;
     }
+    if (info.fVersion >= SkReadBuffer::kPaddedPictureHeader_Version) {
+        stream.skip(3);
+    }
 
     for (;;) {
         uint32_t tag = stream.readU32();
@@ -0,0 +1,282 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkCommandLineFlags.h"
+#include "SkGraphics.h"
+#include "SkJSONCPP.h"
+#include "SkOSFile.h"
+#include "SkPicture.h"
+#include "SkStream.h"
+#include "SkSurface.h"
+#include "SkTArray.h"
+#include "SkTSort.h"
+#include "SkTime.h"
+
+#if SK_SUPPORT_GPU
+#include "GrContext.h"
+#include "GrContextFactory.h"
+#include "SkGpuFenceSync.h"
+#endif
+
+#include <chrono>
+#include <thread>
+
+/*
+ * Plays a sequence of SKPs as frames the way an app would: one picture per frame, each frame
+ * starting on a simulated vsync.  For every frame we measure the CPU time to issue the draw and
+ * to flush it, and, on the GPU, the time until a fence after the flush completes.  We report the
+ * 50th, 90th and 99th percentiles of each, and how many frames missed their vsync (jank).
+ *
+ * Frames are measured one at a time: we wait for each frame's fence before pacing to the next
+ * vsync, so the GPU time is that frame's alone rather than overlapped with the next.
+ */
+
+DEFINE_string(skps, "skps", "SKPs, and/or directories of them, to play in order as frames.");
+DEFINE_bool(gpu, true, "Replay on the native GL context?  If false, replay into a raster surface.");
+DEFINE_int32(frames, 300, "Frames to play, cycling through the SKPs.");
+DEFINE_int32(warmupFrames, 10, "Frames to play and discard before measuring.");
+DEFINE_double(vsyncMs, 1000.0 / 60, "Interval between simulated vsyncs in milliseconds.");
+DEFINE_string(outResultsFile, "", "If given, write results here as JSON.");
+DEFINE_string(key, "", "Space-separated key/value pairs to add to JSON identifying this run.");
+DEFINE_string(properties, "",
+              "Space-separated key/value pairs to add to JSON identifying this builder.");
+
+static double now_ms() { return SkTime::GetNSecs() * 1e-6; }
+
+struct Frame {
+    double recordMs;  // CPU time issuing the draw.
+    double flushMs;   // CPU time flushing it.
+    double gpuMs;     // After the flush, until the GPU finished.
+    double totalMs;
+};
+
+static bool collect_pictures(SkTArray<sk_sp<SkPicture>>* pictures, SkTArray<SkString>* names) {
+    SkTArray<SkString> paths;
+    for (int i = 0; i < FLAGS_skps.count(); i++) {
+        if (SkStrEndsWith(FLAGS_skps[i], ".skp")) {
+            paths.push_back() = FLAGS_skps[i];
+        } else {
+            SkOSFile::Iter it(FLAGS_skps[i], ".skp");
+            SkString path;
+            SkTArray<SkString> dirPaths;
+            while (it.next(&path)) {
+                dirPaths.push_back() = SkOSPath::Join(FLAGS_skps[i], path.c_str());
+            }
+            // Directory order is arbitrary; play them sorted so runs are comparable.
+            if (!dirPaths.empty()) {
+                SkTQSort(dirPaths.begin(), dirPaths.end() - 1,
+                         [](const SkString& a, const SkString& b) {
+                             return strcmp(a.c_str(), b.c_str()) < 0;
+                         });
+            }
+            paths.push_back_n(dirPaths.count(), dirPaths.begin());
+        }
+    }
+
+    for (const SkString& path : paths) {
+        SkAutoTDelete<SkStream> stream(SkStream::NewFromFile(path.c_str()));
+        sk_sp<SkPicture> pic = stream ? SkPicture::MakeFromStream(stream.get()) : nullptr;
+        if (!pic) {
+            SkDebugf("Could not read %s.\n", path.c_str());
+            return false;
+        }
+        pictures->push_back(std::move(pic));
+        names->push_back(SkOSPath::Basename(path.c_str()));
+    }
+    return !pictures->empty();
+}
+
+// Nearest-rank percentile of already sorted values.
+static double percentile(const SkTArray<double>& sorted, double p) {
+    int rank = SkTMin(sorted.count() - 1, (int)(p / 100 * sorted.count()));
+    return sorted[SkTMax(rank, 0)];
+}
+
+// Sorts values and reports their distribution.
+static void summarize(const char* label, SkTArray<double>* unsorted, Json::Value* json) {
+    SkTArray<double>& values = *unsorted;
+    if (!values.empty()) {
+        SkTQSort(values.begin(), values.end() - 1);
+    }
+    double p50 = values.empty() ? 0 : percentile(values, 50),
+           p90 = values.empty() ? 0 : percentile(values, 90),
+           p99 = values.empty() ? 0 : percentile(values, 99),
+           max = values.empty() ? 0 : values.back();
+    SkDebugf("%-8s p50 %8.3fms  p90 %8.3fms  p99 %8.3fms  max %8.3fms\n",
+             label, p50, p90, p99, max);
+    (*json)[SkStringPrintf("%s_p50_ms", label).c_str()] = p50;
+    (*json)[SkStringPrintf("%s_p90_ms", label).c_str()] = p90;
+    (*json)[SkStringPrintf("%s_p99_ms", label).c_str()] = p99;
+    (*json)[SkStringPrintf("%s_max_ms", label).c_str()] = max;
+}
+
+int tool_main(int argc, char** argv);
+int tool_main(int argc, char** argv) {
+    SkCommandLineFlags::SetUsage("Replays SKPs as paced frames and reports frame time "
+                                 "distributions.");
+    SkCommandLineFlags::Parse(argc, argv);
+    SkAutoGraphics ag;
+
+    if (1 == FLAGS_key.count() % 2 || 1 == FLAGS_properties.count() % 2) {
+        SkDebugf("--key and --properties must be passed with an even number of arguments.\n");
+        return 1;
+    }
+
+    SkTArray<sk_sp<SkPicture>> pictures;
+    SkTArray<SkString> names;
+    if (!collect_pictures(&pictures, &names)) {
+        SkDebugf("No SKPs to replay; pass some with --skps.\n");
+        return 1;
+    }
+
+    // Every frame goes to a surface big enough for the largest picture.
+    SkIRect bounds = SkIRect::MakeEmpty();
+    for (const sk_sp<SkPicture>& pic : pictures) {
+        bounds.join(pic->cullRect().roundOut());
+    }
+    SkImageInfo info = SkImageInfo::MakeN32Premul(SkTMax(bounds.width(),  1),
+                                                  SkTMax(bounds.height(), 1));
+
+    sk_sp<SkSurface> surface;
+#if SK_SUPPORT_GPU
+    GrContextOptions grContextOpts;
+    sk_gpu_test::GrContextFactory factory(grContextOpts);
+    SkGpuFenceSync* fenceSync = nullptr;
+    if (FLAGS_gpu) {
+        sk_gpu_test::ContextInfo ctxInfo =
+                factory.getContextInfo(sk_gpu_test::GrContextFactory::kNativeGL_ContextType);
+        if (!ctxInfo.grContext()) {
+            SkDebugf("Could not create a GL context.\n");
+            return 1;
+        }
+        fenceSync = ctxInfo.testContext()->fenceSync();
+        if (!fenceSync) {
+            SkDebugf("No fence sync support; GPU times will include a full finish().\n");
+        }
+        surface = SkSurface::MakeRenderTarget(ctxInfo.grContext(), SkBudgeted::kNo, info);
+    }
+#else
+    if (FLAGS_gpu) {
+        SkDebugf("This build has no GPU support.\n");
+        return 1;
+    }
+#endif
+    if (!FLAGS_gpu) {
+        surface = SkSurface::MakeRaster(info);
+    }
+    if (!surface) {
+        SkDebugf("Could not create a %dx%d surface.\n", info.width(), info.height());
+        return 1;
+    }
+    SkCanvas* canvas = surface->getCanvas();
+
+    SkTArray<Frame> frames;
+    int jank = 0,
+        missedVsyncs = 0;
+    const double vsync = FLAGS_vsyncMs;
+    double nextVsync = now_ms();
+
+    for (int f = 0; f < FLAGS_warmupFrames + FLAGS_frames; f++) {
+        // Wait for this frame's vsync.
+        std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(
+                SkTMax(0.0, nextVsync - now_ms())));
+
+        Frame frame;
+        double start = now_ms();
+        canvas->clear(SK_ColorWHITE);
+        canvas->drawPicture(pictures[f % pictures.count()]);
+        double recorded = now_ms();
+        canvas->flush();
+        double flushed = now_ms();
+        frame.gpuMs = 0;
+#if SK_SUPPORT_GPU
+        if (FLAGS_gpu) {
+            if (fenceSync) {
+                SkPlatformGpuFence fence = fenceSync->insertFence();
+                fenceSync->waitFence(fence);
+                fenceSync->deleteFence(fence);
+            } else {
+                factory.getContextInfo(sk_gpu_test::GrContextFactory::kNativeGL_ContextType)
+                       .testContext()->finish();
+            }
+            frame.gpuMs = now_ms() - flushed;
+        }
+#endif
+        double end = now_ms();
+        frame.recordMs = recorded - start;
+        frame.flushMs  = flushed - recorded;
+        frame.totalMs  = end - start;
+
+        // The next frame starts on the first vsync after this one finishes.
+        int vsyncsUsed = SkTMax(1, (int)ceil((end - nextVsync) / vsync));
+        nextVsync += vsyncsUsed * vsync;
+
+        if (f >= FLAGS_warmupFrames) {
+            frames.push_back(frame);
+            if (vsyncsUsed > 1) {
+                jank++;
+                missedVsyncs += vsyncsUsed - 1;
+            }
+        }
+    }
+
+    SkTArray<double> record, flush, cpu, gpu, total;
+    for (const Frame& frame : frames) {
+        record.push_back(frame.recordMs);
+        flush .push_back(frame.flushMs);
+        cpu   .push_back(frame.recordMs + frame.flushMs);
+        gpu   .push_back(frame.gpuMs);
+        total .push_back(frame.totalMs);
+    }
+
+    Json::Value results;
+    SkDebugf("%d frames of %d SKPs on %s, %.2fms vsync\n",
+             frames.count(), pictures.count(), FLAGS_gpu ? "gpu" : "8888", vsync);
+    summarize("record", &record, &results);
+    summarize("flush",  &flush,  &results);
+    summarize("cpu",    &cpu,    &results);
+    if (FLAGS_gpu) {
+        summarize("gpu", &gpu, &results);
+    }
+    summarize("frame",  &total,  &results);
+    SkDebugf("jank: %d frames (%.1f%%) missed %d vsyncs\n",
+             jank, 100.0 * jank / SkTMax(frames.count(), 1), missedVsyncs);
+    results["jank_frames"]   = jank;
+    results["missed_vsyncs"] = missedVsyncs;
+    results["frames"]        = frames.count();
+
+    if (!FLAGS_outResultsFile.isEmpty()) {
+        Json::Value root;
+        for (int i = 1; i < FLAGS_properties.count(); i += 2) {
+            root[FLAGS_properties[i-1]] = FLAGS_properties[i];
+        }
+        for (int i = 1; i < FLAGS_key.count(); i += 2) {
+            root["key"][FLAGS_key[i-1]] = FLAGS_key[i];
+        }
+        for (const SkString& name : names) {
+            root["skps"].append(name.c_str());
+        }
+        root["vsync_ms"] = vsync;
+        root["results"][FLAGS_gpu ? "gpu" : "8888"] = results;
+
+        SkFILEWStream stream(FLAGS_outResultsFile[0]);
+        if (!stream.isValid()) {
+            SkDebugf("Could not write %s.\n", FLAGS_outResultsFile[0]);
+            return 1;
+        }
+        stream.writeText(Json::StyledWriter().write(root).c_str());
+        stream.flush();
+    }
+    return 0;
+}
+
+#if !defined SK_BUILD_FOR_IOS
+int main(int argc, char * const argv[]) {
+    return tool_main(argc, (char**) argv);
+}
+#endif